@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <vector>
+#include <Snapd/Client>
+
+#include "mock-snapd.h"
+#include "benchmark-stats.h"
+
+static gint n_requests = 1000;
+static gint concurrency = 8;
+static gchar *mix = NULL;
+static gint n_snaps = 100;
+
+static GOptionEntry options[] = {
+    { "requests", 'n', 0, G_OPTION_ARG_INT, &n_requests, "Number of requests to make", "COUNT" },
+    { "concurrency", 'c', 0, G_OPTION_ARG_INT, &concurrency, "Number of requests to have in progress at once", "COUNT" },
+    { "mix", 'm', 0, G_OPTION_ARG_STRING, &mix, "Comma separated requests to cycle through: system-info, snaps, snap, find, apps", "REQUESTS" },
+    { "snaps", 's', 0, G_OPTION_ARG_INT, &n_snaps, "Number of snaps installed and in the store, which sets the size of responses", "COUNT" },
+    { NULL }
+};
+
+class Benchmark
+{
+public:
+    QSnapdClient client;
+    GMainLoop *loop;
+    QStringList mix;
+    int n_started = 0;
+    int n_completed = 0;
+    int n_failed = 0;
+    std::vector<gint64> latencies;
+
+    QSnapdRequest *makeRequest (const QString &type)
+    {
+        if (type == "system-info")
+            return client.getSystemInformation ();
+        else if (type == "snaps")
+            return client.getSnaps ();
+        else if (type == "snap")
+            return client.getSnap ("snap0");
+        else if (type == "find")
+            return client.find ("snap");
+        else if (type == "apps")
+            return client.getApps ();
+        else
+            return NULL;
+    }
+
+    void startRequest ()
+    {
+        if (n_started >= n_requests)
+            return;
+
+        int index = n_started++;
+        QString type = mix[index % mix.size ()];
+        QSnapdRequest *request = makeRequest (type);
+        gint64 start_time = g_get_monotonic_time ();
+        QObject::connect (request, &QSnapdRequest::complete, [this, request, type, index, start_time] () {
+            if (request->error () != QSnapdRequest::NoError) {
+                g_printerr ("%s request failed: %s\n", type.toUtf8 ().constData (), request->errorString ().toUtf8 ().constData ());
+                n_failed++;
+            }
+            latencies[index] = g_get_monotonic_time () - start_time;
+            request->deleteLater ();
+
+            n_completed++;
+            if (n_completed == n_requests)
+                g_main_loop_quit (loop);
+            else
+                startRequest ();
+        });
+        request->runAsync ();
+    }
+};
+
+int
+main (int argc, char **argv)
+{
+    g_autoptr(GOptionContext) option_context = g_option_context_new ("- measure QSnapdClient throughput against a mock snapd");
+    g_option_context_add_main_entries (option_context, options, NULL);
+    g_autoptr(GError) error = NULL;
+    if (!g_option_context_parse (option_context, &argc, &argv, &error)) {
+        g_printerr ("%s\n", error->message);
+        return EXIT_FAILURE;
+    }
+    if (n_requests <= 0 || concurrency <= 0) {
+        g_printerr ("Number of requests and concurrency must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_generated_snaps (snapd, n_snaps, 4, 1, 2, 2);
+    if (!mock_snapd_start (snapd, &error)) {
+        g_printerr ("Failed to start mock snapd: %s\n", error->message);
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    Benchmark benchmark;
+    benchmark.client.setSocketPath (mock_snapd_get_socket_path (snapd));
+    benchmark.loop = loop;
+    benchmark.mix = QString (mix != NULL ? mix : "system-info,snaps,snap,find,apps").split (",");
+    for (const QString &type : benchmark.mix) {
+        if (type != "system-info" && type != "snaps" && type != "snap" && type != "find" && type != "apps") {
+            g_printerr ("Unknown request '%s'\n", type.toUtf8 ().constData ());
+            return EXIT_FAILURE;
+        }
+    }
+    if (benchmark.mix.isEmpty ()) {
+        g_printerr ("No requests in mix\n");
+        return EXIT_FAILURE;
+    }
+    benchmark.latencies.resize (n_requests);
+
+    gint64 start_time = g_get_monotonic_time ();
+    for (gint i = 0; i < concurrency; i++)
+        benchmark.startRequest ();
+    g_main_loop_run (loop);
+    gint64 elapsed = g_get_monotonic_time () - start_time;
+
+    g_autofree gchar *name = g_strdup_printf ("qt x%d", concurrency);
+    print_latency_report (name, benchmark.latencies.data (), n_requests, benchmark.n_failed, elapsed);
+
+    return benchmark.n_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <stdlib.h>
+#include <snapd-glib/snapd-glib.h>
+
+#include "mock-snapd.h"
+#include "benchmark-stats.h"
+
+typedef enum
+{
+    REQUEST_SYSTEM_INFO,
+    REQUEST_SNAPS,
+    REQUEST_SNAP,
+    REQUEST_FIND,
+    REQUEST_APPS
+} RequestType;
+
+static const gchar *request_names[] = { "system-info", "snaps", "snap", "find", "apps" };
+
+static gint n_requests = 1000;
+static gint concurrency = 8;
+static gchar *mix = NULL;
+static gint n_snaps = 100;
+static gboolean use_sync = FALSE;
+static gboolean use_io_thread = FALSE;
+static gint max_connections = 0;
+static gint max_pipeline_depth = 0;
+static gint latency = 0;
+static gint bandwidth = 0;
+static gboolean use_chunked = FALSE;
+
+static GOptionEntry options[] = {
+    { "requests", 'n', 0, G_OPTION_ARG_INT, &n_requests, "Number of requests to make", "COUNT" },
+    { "concurrency", 'c', 0, G_OPTION_ARG_INT, &concurrency, "Number of requests to have in progress at once", "COUNT" },
+    { "mix", 'm', 0, G_OPTION_ARG_STRING, &mix, "Comma separated requests to cycle through: system-info, snaps, snap, find, apps", "REQUESTS" },
+    { "snaps", 's', 0, G_OPTION_ARG_INT, &n_snaps, "Number of snaps installed and in the store, which sets the size of responses", "COUNT" },
+    { "sync", 0, 0, G_OPTION_ARG_NONE, &use_sync, "Use the sync API, with one thread per concurrent request", NULL },
+    { "io-thread", 0, 0, G_OPTION_ARG_NONE, &use_io_thread, "Communicate with snapd from a separate thread", NULL },
+    { "max-connections", 0, 0, G_OPTION_ARG_INT, &max_connections, "Maximum number of connections to snapd", "COUNT" },
+    { "pipeline-depth", 0, 0, G_OPTION_ARG_INT, &max_pipeline_depth, "Maximum number of requests waiting for a response on each connection", "COUNT" },
+    { "latency", 0, 0, G_OPTION_ARG_INT, &latency, "Delay before snapd responds, in milliseconds", "MS" },
+    { "bandwidth", 0, 0, G_OPTION_ARG_INT, &bandwidth, "Limit the rate snapd sends responses, in bytes per second", "BYTES" },
+    { "chunked", 0, 0, G_OPTION_ARG_NONE, &use_chunked, "Send responses with chunked encoding", NULL },
+    { NULL }
+};
+
+typedef struct
+{
+    SnapdClient *client;
+    GMainLoop *loop;
+    GArray *mix;
+    guint n_started;
+    guint n_completed;
+    gint n_failed;
+    gint64 *latencies;
+} Benchmark;
+
+typedef struct
+{
+    Benchmark *benchmark;
+    RequestType type;
+    guint index;
+    gint64 start_time;
+} RequestContext;
+
+static GArray *
+parse_mix (const gchar *text, GError **error)
+{
+    g_autoptr(GArray) types = g_array_new (FALSE, FALSE, sizeof (RequestType));
+    g_auto(GStrv) names = g_strsplit (text, ",", -1);
+    for (guint i = 0; names[i] != NULL; i++) {
+        gboolean found = FALSE;
+        for (RequestType type = REQUEST_SYSTEM_INFO; type <= REQUEST_APPS; type++) {
+            if (g_strcmp0 (g_strstrip (names[i]), request_names[type]) == 0) {
+                g_array_append_val (types, type);
+                found = TRUE;
+            }
+        }
+        if (!found) {
+            g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE, "Unknown request '%s'", names[i]);
+            return NULL;
+        }
+    }
+    if (types->len == 0) {
+        g_set_error_literal (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE, "No requests in mix");
+        return NULL;
+    }
+
+    return g_steal_pointer (&types);
+}
+
+static gboolean
+run_request_sync (SnapdClient *client, RequestType type, GError **error)
+{
+    switch (type) {
+    case REQUEST_SYSTEM_INFO:
+        {
+            g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, error);
+            return info != NULL;
+        }
+    case REQUEST_SNAPS:
+        {
+            g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, error);
+            return snaps != NULL;
+        }
+    case REQUEST_SNAP:
+        {
+            g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap0", NULL, error);
+            return snap != NULL;
+        }
+    case REQUEST_FIND:
+        {
+            g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, error);
+            return snaps != NULL;
+        }
+    case REQUEST_APPS:
+        {
+            g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, error);
+            return apps != NULL;
+        }
+    }
+
+    return FALSE;
+}
+
+static gboolean
+finish_request (SnapdClient *client, RequestType type, GAsyncResult *result, GError **error)
+{
+    switch (type) {
+    case REQUEST_SYSTEM_INFO:
+        {
+            g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (client, result, error);
+            return info != NULL;
+        }
+    case REQUEST_SNAPS:
+        {
+            g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (client, result, error);
+            return snaps != NULL;
+        }
+    case REQUEST_SNAP:
+        {
+            g_autoptr(SnapdSnap) snap = snapd_client_get_snap_finish (client, result, error);
+            return snap != NULL;
+        }
+    case REQUEST_FIND:
+        {
+            g_autoptr(GPtrArray) snaps = snapd_client_find_finish (client, result, NULL, error);
+            return snaps != NULL;
+        }
+    case REQUEST_APPS:
+        {
+            g_autoptr(GPtrArray) apps = snapd_client_get_apps2_finish (client, result, error);
+            return apps != NULL;
+        }
+    }
+
+    return FALSE;
+}
+
+static void start_request (Benchmark *benchmark);
+
+static void
+request_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    RequestContext *context = user_data;
+    Benchmark *benchmark = context->benchmark;
+
+    g_autoptr(GError) error = NULL;
+    if (!finish_request (SNAPD_CLIENT (object), context->type, result, &error)) {
+        g_printerr ("%s request failed: %s\n", request_names[context->type], error->message);
+        benchmark->n_failed++;
+    }
+    benchmark->latencies[context->index] = g_get_monotonic_time () - context->start_time;
+    g_free (context);
+
+    benchmark->n_completed++;
+    if (benchmark->n_completed == (guint) n_requests)
+        g_main_loop_quit (benchmark->loop);
+    else
+        start_request (benchmark);
+}
+
+static void
+start_request (Benchmark *benchmark)
+{
+    if (benchmark->n_started >= (guint) n_requests)
+        return;
+
+    RequestContext *context = g_new0 (RequestContext, 1);
+    context->benchmark = benchmark;
+    context->index = benchmark->n_started++;
+    context->type = g_array_index (benchmark->mix, RequestType, context->index % benchmark->mix->len);
+    context->start_time = g_get_monotonic_time ();
+
+    switch (context->type) {
+    case REQUEST_SYSTEM_INFO:
+        snapd_client_get_system_information_async (benchmark->client, NULL, request_cb, context);
+        break;
+    case REQUEST_SNAPS:
+        snapd_client_get_snaps_async (benchmark->client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, request_cb, context);
+        break;
+    case REQUEST_SNAP:
+        snapd_client_get_snap_async (benchmark->client, "snap0", NULL, request_cb, context);
+        break;
+    case REQUEST_FIND:
+        snapd_client_find_async (benchmark->client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, request_cb, context);
+        break;
+    case REQUEST_APPS:
+        snapd_client_get_apps2_async (benchmark->client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, request_cb, context);
+        break;
+    }
+}
+
+static gpointer
+sync_thread_func (gpointer user_data)
+{
+    Benchmark *benchmark = user_data;
+
+    while (TRUE) {
+        guint index = (guint) g_atomic_int_add ((gint *) &benchmark->n_started, 1);
+        if (index >= (guint) n_requests)
+            break;
+
+        RequestType type = g_array_index (benchmark->mix, RequestType, index % benchmark->mix->len);
+        gint64 start_time = g_get_monotonic_time ();
+        g_autoptr(GError) error = NULL;
+        if (!run_request_sync (benchmark->client, type, &error)) {
+            g_printerr ("%s request failed: %s\n", request_names[type], error->message);
+            g_atomic_int_inc (&benchmark->n_failed);
+        }
+        benchmark->latencies[index] = g_get_monotonic_time () - start_time;
+    }
+
+    return NULL;
+}
+
+int
+main (int argc, char **argv)
+{
+    g_autoptr(GOptionContext) option_context = g_option_context_new ("- measure SnapdClient throughput against a mock snapd");
+    g_option_context_add_main_entries (option_context, options, NULL);
+    g_autoptr(GError) error = NULL;
+    if (!g_option_context_parse (option_context, &argc, &argv, &error)) {
+        g_printerr ("%s\n", error->message);
+        return EXIT_FAILURE;
+    }
+    if (n_requests <= 0 || concurrency <= 0) {
+        g_printerr ("Number of requests and concurrency must be positive\n");
+        return EXIT_FAILURE;
+    }
+    if (latency < 0 || bandwidth < 0) {
+        g_printerr ("Latency and bandwidth must not be negative\n");
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(GArray) request_mix = parse_mix (mix != NULL ? mix : "system-info,snaps,snap,find,apps", &error);
+    if (request_mix == NULL) {
+        g_printerr ("%s\n", error->message);
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_generated_snaps (snapd, n_snaps, 4, 1, 2, 2);
+    if (latency > 0)
+        mock_snapd_set_endpoint_latency (snapd, "/", latency);
+    if (bandwidth > 0)
+        mock_snapd_set_endpoint_bandwidth (snapd, "/", bandwidth);
+    if (use_chunked)
+        mock_snapd_set_endpoint_chunked (snapd, "/", TRUE);
+    if (!mock_snapd_start (snapd, &error)) {
+        g_printerr ("Failed to start mock snapd: %s\n", error->message);
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    /* Sync requests from many threads share the client, so use the I/O thread to serialize access to the connections */
+    snapd_client_set_use_io_thread (client, use_io_thread || (use_sync && concurrency > 1));
+    if (max_connections > 0)
+        snapd_client_set_max_connections (client, max_connections);
+    if (max_pipeline_depth > 0)
+        snapd_client_set_max_pipeline_depth (client, max_pipeline_depth);
+
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autofree gint64 *latencies = g_new0 (gint64, n_requests);
+    Benchmark benchmark = { client, loop, request_mix, 0, 0, 0, latencies };
+
+    gint64 start_time = g_get_monotonic_time ();
+    if (use_sync) {
+        g_autoptr(GPtrArray) threads = g_ptr_array_new ();
+        for (gint i = 0; i < concurrency; i++)
+            g_ptr_array_add (threads, g_thread_new ("benchmark", sync_thread_func, &benchmark));
+        for (guint i = 0; i < threads->len; i++)
+            g_thread_join (g_ptr_array_index (threads, i));
+    }
+    else {
+        for (gint i = 0; i < concurrency; i++)
+            start_request (&benchmark);
+        g_main_loop_run (loop);
+    }
+    gint64 elapsed = g_get_monotonic_time () - start_time;
+
+    g_autofree gchar *name = g_strdup_printf ("%s x%d", use_sync ? "sync" : "async", concurrency);
+    print_latency_report (name, latencies, n_requests, benchmark.n_failed, elapsed);
+
+    return benchmark.n_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
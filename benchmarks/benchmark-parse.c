@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapd-markdown-parser.h"
+#include "requests/snapd-get-assertions.h"
+#include "requests/snapd-get-find.h"
+#include "requests/snapd-get-snaps.h"
+#include "requests/snapd-json.h"
+
+/* Minimum time to run each benchmark for, in microseconds */
+#define MIN_BENCHMARK_TIME 500000
+
+static guint64 n_allocations = 0;
+
+#ifdef __GLIBC__
+/* Count allocations by wrapping the glibc allocator */
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+    n_allocations++;
+    return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+    n_allocations++;
+    return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+    n_allocations++;
+    return __libc_realloc (ptr, size);
+}
+#endif
+
+typedef void (*BenchmarkFunc) (gconstpointer data);
+
+static void
+run_benchmark (const gchar *name, BenchmarkFunc func, gconstpointer data)
+{
+    /* Warm up caches before measuring */
+    func (data);
+
+    guint64 n_iterations = 0;
+    guint64 start_allocations = n_allocations;
+    gint64 start_time = g_get_monotonic_time ();
+    gint64 elapsed;
+    do {
+        func (data);
+        n_iterations++;
+        elapsed = g_get_monotonic_time () - start_time;
+    } while (elapsed < MIN_BENCHMARK_TIME);
+    guint64 allocations = n_allocations - start_allocations;
+
+    g_print ("%-32s %14.0f ns/op %12.1f allocs/op\n",
+             name,
+             elapsed * 1000.0 / n_iterations,
+             (gdouble) allocations / n_iterations);
+}
+
+static void
+append_snap (GString *json, guint index)
+{
+    g_string_append_printf (json,
+                            "{\"id\":\"id%u\",\"name\":\"snap%u\",\"title\":\"Snap %u\",\"summary\":\"A snap for benchmarking\","
+                            "\"description\":\"This snap is used to measure how long it takes to parse snaps.\\n\\n* It has a list\\n* Of features\","
+                            "\"type\":\"app\",\"version\":\"1.%u\",\"revision\":\"%u\",\"channel\":\"stable\",\"tracking-channel\":\"latest/stable\","
+                            "\"confinement\":\"strict\",\"status\":\"active\",\"developer\":\"publisher\",\"license\":\"GPL-3.0\","
+                            "\"install-date\":\"2017-01-02T11:23:58Z\",\"installed-size\":1024000,\"download-size\":65536,"
+                            "\"publisher\":{\"id\":\"publisher-id\",\"username\":\"publisher\",\"display-name\":\"Publisher\",\"validation\":\"verified\"},"
+                            "\"apps\":[{\"name\":\"snap%u\",\"snap\":\"snap%u\",\"desktop-file\":\"/var/lib/snapd/desktop/applications/snap%u.desktop\"}],"
+                            "\"media\":[{\"type\":\"icon\",\"url\":\"https://example.com/icon%u.png\",\"width\":256,\"height\":256},"
+                            "{\"type\":\"screenshot\",\"url\":\"https://example.com/screenshot%u.png\",\"width\":1024,\"height\":768}],"
+                            "\"channels\":{\"latest/stable\":{\"revision\":\"%u\",\"version\":\"1.%u\",\"channel\":\"stable\",\"confinement\":\"strict\","
+                            "\"epoch\":{\"read\":[0],\"write\":[0]},\"size\":65536,\"released-at\":\"2017-01-02T11:23:58Z\"}},"
+                            "\"tracks\":[\"latest\"],\"common-ids\":[\"com.example.Snap%u\"],\"contact\":\"mailto:snap%u@example.com\","
+                            "\"website\":\"https://example.com/snap%u\",\"devmode\":false,\"jailmode\":false,\"private\":false,\"trymode\":false}",
+                            index, index, index, index, index, index, index, index, index, index, index, index, index, index, index);
+}
+
+static gchar *
+make_snaps_response (guint n_snaps)
+{
+    g_autoptr(GString) json = g_string_new ("{\"type\":\"sync\",\"status-code\":200,\"status\":\"OK\",\"result\":[");
+    for (guint i = 0; i < n_snaps; i++) {
+        if (i != 0)
+            g_string_append_c (json, ',');
+        append_snap (json, i);
+    }
+    g_string_append (json, "],\"sources\":[\"store\"],\"suggested-currency\":\"NZD\"}");
+
+    return g_string_free (g_steal_pointer (&json), FALSE);
+}
+
+static gchar *
+make_change_response (guint n_tasks)
+{
+    g_autoptr(GString) json = g_string_new ("{\"type\":\"sync\",\"status-code\":200,\"status\":\"OK\",\"result\":"
+                                            "{\"id\":\"1\",\"kind\":\"install-snap\",\"summary\":\"Install snap\",\"status\":\"Doing\","
+                                            "\"ready\":false,\"spawn-time\":\"2017-01-02T11:23:58Z\",\"tasks\":[");
+    for (guint i = 0; i < n_tasks; i++) {
+        if (i != 0)
+            g_string_append_c (json, ',');
+        g_string_append_printf (json,
+                                "{\"id\":\"%u\",\"kind\":\"download-snap\",\"summary\":\"Download snap %u\",\"status\":\"Done\","
+                                "\"progress\":{\"label\":\"snap%u\",\"done\":65536,\"total\":65536},"
+                                "\"spawn-time\":\"2017-01-02T11:23:58Z\",\"ready-time\":\"2017-01-03T00:00:00Z\"}",
+                                i, i, i);
+    }
+    g_string_append (json, "]}}");
+
+    return g_string_free (g_steal_pointer (&json), FALSE);
+}
+
+static gchar *
+make_assertions_response (guint n_assertions)
+{
+    g_autoptr(GString) text = g_string_new (NULL);
+    for (guint i = 0; i < n_assertions; i++) {
+        if (i != 0)
+            g_string_append (text, "\n\n");
+        g_string_append_printf (text,
+                                "type: account\n"
+                                "authority-id: canonical\n"
+                                "account-id: account%u\n"
+                                "display-name: Account %u\n"
+                                "timestamp: 2016-04-01T00:00:00.0Z\n"
+                                "username: user%u\n"
+                                "validation: unproven\n"
+                                "sign-key-sha3-384: BWDEoaqyr25nF5SNCvEv2v7QnM9QsfCc0PBMYD_i2NGSQ32EF2d4D0hqUel3m8ul\n"
+                                "\n"
+                                "AcLBUgQAAQoABgUCV8Pm5gAAqFYQAEgPjdRQkc9mxB5ukjfTw6p0lmMtc85OJRTRbenqVgH5ty6y\n"
+                                "PqFVwBwZwFkgUtCRr3cCZ2SF2KlqEn4ybQWjBFDnAqgWjHbHEN4tL7CYcnqvBnXQOfmdp9mqBeE6\n"
+                                "4isMVcJ3ELCQnc4pdTqnI6o4s5Ay8Ws6Ml5Hy9BSPzCvnXS5zr7v5zlnTSfSadAxNoeBHCoYpOe4",
+                                i, i, i);
+    }
+
+    return g_string_free (g_steal_pointer (&text), FALSE);
+}
+
+static gchar *
+make_markdown (guint n_sections)
+{
+    g_autoptr(GString) text = g_string_new (NULL);
+    for (guint i = 0; i < n_sections; i++)
+        g_string_append_printf (text,
+                                "**Section %u** describes _what_ the snap does, with `code` and a link to https://example.com/%u.\n"
+                                "The paragraph continues on a second line with some more words to wrap.\n"
+                                "\n"
+                                "* First feature\n"
+                                "* Second feature with *emphasis*\n"
+                                "  * Nested feature\n"
+                                "\n"
+                                "1. Step one\n"
+                                "2. Step two\n"
+                                "\n"
+                                "    $ snap install example\n"
+                                "\n",
+                                i, i);
+
+    return g_string_free (g_steal_pointer (&text), FALSE);
+}
+
+typedef struct
+{
+    gchar *name;
+    GBytes *body;
+    JsonNode *result;
+    gchar *text;
+} BenchmarkData;
+
+static BenchmarkData *
+benchmark_data_new (const gchar *name, gchar *body)
+{
+    BenchmarkData *data = g_new0 (BenchmarkData, 1);
+    data->name = g_strdup (name);
+    if (body != NULL)
+        data->body = g_bytes_new_take (body, strlen (body));
+    return data;
+}
+
+/* Parse the JSON once, for benchmarks of parsing objects that are already in JSON form */
+static void
+benchmark_data_parse_result (BenchmarkData *data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(JsonObject) response = _snapd_json_parse_response ("application/json", data->body, NULL, NULL, &error);
+    g_assert_no_error (error);
+    data->result = _snapd_json_get_sync_result (response, &error);
+    g_assert_no_error (error);
+}
+
+static void
+benchmark_data_free (BenchmarkData *data)
+{
+    g_free (data->name);
+    g_clear_pointer (&data->body, g_bytes_unref);
+    g_clear_pointer (&data->result, json_node_unref);
+    g_free (data->text);
+    g_free (data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (BenchmarkData, benchmark_data_free)
+
+static void
+parse_response (SnapdRequest *request, const gchar *content_type, GBytes *body)
+{
+    g_autoptr(SnapdMaintenance) maintenance = NULL;
+    g_autoptr(GError) error = NULL;
+    gboolean parsed = SNAPD_REQUEST_GET_CLASS (request)->parse_response (request, 200, content_type, body, &maintenance, &error);
+    g_assert_no_error (error);
+    g_assert_true (parsed);
+}
+
+static void
+benchmark_get_snaps (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    g_autoptr(SnapdGetSnaps) request = _snapd_get_snaps_new (NULL, NULL, NULL, NULL);
+    parse_response (SNAPD_REQUEST (request), "application/json", data->body);
+}
+
+static void
+benchmark_find (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    g_autoptr(SnapdGetFind) request = _snapd_get_find_new (NULL, NULL, NULL);
+    parse_response (SNAPD_REQUEST (request), "application/json", data->body);
+}
+
+static void
+benchmark_parse_snap (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    JsonArray *array = json_node_get_array (data->result);
+    for (guint i = 0; i < json_array_get_length (array); i++) {
+        g_autoptr(GError) error = NULL;
+        g_autoptr(SnapdSnap) snap = _snapd_json_parse_snap (json_array_get_element (array, i), &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (snap);
+    }
+}
+
+static void
+benchmark_parse_change (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = _snapd_json_parse_change (data->result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+}
+
+static void
+benchmark_get_assertions (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    g_autoptr(SnapdGetAssertions) request = _snapd_get_assertions_new ("account", NULL, NULL, NULL);
+    parse_response (SNAPD_REQUEST (request), "application/x.ubuntu.assertion", data->body);
+}
+
+static void
+benchmark_markdown (gconstpointer user_data)
+{
+    const BenchmarkData *data = user_data;
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (parser, data->text);
+    g_assert_nonnull (nodes);
+}
+
+int
+main (int argc, char **argv)
+{
+    const guint snap_counts[] = { 100, 1000, 5000 };
+    for (gsize i = 0; i < G_N_ELEMENTS (snap_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("get-snaps/%u", snap_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, make_snaps_response (snap_counts[i]));
+        run_benchmark (data->name, benchmark_get_snaps, data);
+    }
+    for (gsize i = 0; i < G_N_ELEMENTS (snap_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("find/%u", snap_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, make_snaps_response (snap_counts[i]));
+        run_benchmark (data->name, benchmark_find, data);
+    }
+    for (gsize i = 0; i < G_N_ELEMENTS (snap_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("parse-snap/%u", snap_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, make_snaps_response (snap_counts[i]));
+        benchmark_data_parse_result (data);
+        run_benchmark (data->name, benchmark_parse_snap, data);
+    }
+
+    const guint task_counts[] = { 10, 100, 1000 };
+    for (gsize i = 0; i < G_N_ELEMENTS (task_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("parse-change/%u-tasks", task_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, make_change_response (task_counts[i]));
+        benchmark_data_parse_result (data);
+        run_benchmark (data->name, benchmark_parse_change, data);
+    }
+
+    const guint assertion_counts[] = { 100, 1000, 10000 };
+    for (gsize i = 0; i < G_N_ELEMENTS (assertion_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("get-assertions/%u", assertion_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, make_assertions_response (assertion_counts[i]));
+        run_benchmark (data->name, benchmark_get_assertions, data);
+    }
+
+    const guint section_counts[] = { 1, 10, 100 };
+    for (gsize i = 0; i < G_N_ELEMENTS (section_counts); i++) {
+        g_autofree gchar *name = g_strdup_printf ("markdown/%u-sections", section_counts[i]);
+        g_autoptr(BenchmarkData) data = benchmark_data_new (name, NULL);
+        data->text = make_markdown (section_counts[i]);
+        run_benchmark (data->name, benchmark_markdown, data);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+#include <QtTest/QtTest>
+#include <Snapd/MarkdownParser>
+
+#include "benchmark-qt.h"
+#include "variant.h"
+
+/* Number of snaps to generate, each with this many apps, channels, media and plugs */
+#define N_SNAPS 1000
+#define N_CHILDREN 4
+
+/* Number of keys in the generated configuration */
+#define N_CONFIGURATION_KEYS 1000
+
+/* Number of sections in the generated markdown */
+#define N_MARKDOWN_SECTIONS 100
+
+static GVariant *
+make_configuration (void)
+{
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    for (int i = 0; i < N_CONFIGURATION_KEYS; i++) {
+        g_autofree gchar *key = g_strdup_printf ("key%d", i);
+
+        GVariantBuilder child_builder;
+        g_variant_builder_init (&child_builder, G_VARIANT_TYPE ("a{sv}"));
+        g_variant_builder_add (&child_builder, "{sv}", "enabled", g_variant_new_boolean (i % 2 == 0));
+        g_variant_builder_add (&child_builder, "{sv}", "count", g_variant_new_int64 (i));
+        g_variant_builder_add (&child_builder, "{sv}", "ratio", g_variant_new_double (i / 10.0));
+        g_variant_builder_add (&child_builder, "{sv}", "name", g_variant_new_string (key));
+        GVariantBuilder list_builder;
+        g_variant_builder_init (&list_builder, G_VARIANT_TYPE ("av"));
+        for (int j = 0; j < 4; j++)
+            g_variant_builder_add (&list_builder, "v", g_variant_new_int64 (j));
+        g_variant_builder_add (&child_builder, "{sv}", "values", g_variant_builder_end (&list_builder));
+
+        g_variant_builder_add (&builder, "{sv}", key, g_variant_builder_end (&child_builder));
+    }
+
+    return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+static QString
+make_markdown (void)
+{
+    QString text;
+    for (int i = 0; i < N_MARKDOWN_SECTIONS; i++)
+        text += QString ("**Section %1** describes _what_ the snap does, with `code` and a link to https://example.com/%1.\n"
+                         "The paragraph continues on a second line with some more words to wrap.\n"
+                         "\n"
+                         "* First feature\n"
+                         "* Second feature with *emphasis*\n"
+                         "  * Nested feature\n"
+                         "\n"
+                         "1. Step one\n"
+                         "2. Step two\n"
+                         "\n"
+                         "    $ snap install example\n"
+                         "\n").arg (i);
+
+    return text;
+}
+
+void
+WrapperBenchmark::initTestCase ()
+{
+    snapd = mock_snapd_new ();
+    mock_snapd_add_generated_snaps (snapd, N_SNAPS, N_CHILDREN, N_CHILDREN, N_CHILDREN, N_CHILDREN);
+    g_autoptr(GError) error = NULL;
+    QVERIFY (mock_snapd_start (snapd, &error));
+
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    getSnapsRequest.reset (client.getSnaps ());
+    getSnapsRequest->runSync ();
+    QCOMPARE (getSnapsRequest->error (), QSnapdRequest::NoError);
+    QCOMPARE (getSnapsRequest->snapCount (), N_SNAPS);
+
+    findRequest.reset (client.find ("snap"));
+    findRequest->runSync ();
+    QCOMPARE (findRequest->error (), QSnapdRequest::NoError);
+    QCOMPARE (findRequest->snapCount (), N_SNAPS);
+
+    g_autoptr(SnapdClient) raw_client = snapd_client_new ();
+    snapd_client_set_socket_path (raw_client, mock_snapd_get_socket_path (snapd));
+    rawSnaps = snapd_client_get_snaps_sync (raw_client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    QVERIFY (rawSnaps != NULL);
+
+    configuration = make_configuration ();
+    markdown = make_markdown ();
+}
+
+void
+WrapperBenchmark::cleanupTestCase ()
+{
+    g_clear_pointer (&rawSnaps, g_ptr_array_unref);
+    g_clear_pointer (&configuration, g_variant_unref);
+    getSnapsRequest.reset ();
+    findRequest.reset ();
+    g_clear_object (&snapd);
+}
+
+/* The cost of reading the same fields directly from the GLib objects, to compare the wrappers against */
+void
+WrapperBenchmark::getSnapsRaw ()
+{
+    gsize total = 0;
+    QBENCHMARK {
+        for (guint i = 0; i < rawSnaps->len; i++) {
+            SnapdSnap *snap = SNAPD_SNAP (rawSnaps->pdata[i]);
+            total += strlen (snapd_snap_get_name (snap));
+            total += strlen (snapd_snap_get_summary (snap));
+            total += strlen (snapd_snap_get_description (snap));
+            GPtrArray *apps = snapd_snap_get_apps (snap);
+            for (guint j = 0; j < apps->len; j++)
+                total += strlen (snapd_app_get_name (SNAPD_APP (apps->pdata[j])));
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+void
+WrapperBenchmark::getSnapsWrapped ()
+{
+    int total = 0;
+    QBENCHMARK {
+        for (int i = 0; i < getSnapsRequest->snapCount (); i++) {
+            QScopedPointer<QSnapdSnap> snap (getSnapsRequest->snap (i));
+            total += snap->name ().size ();
+            total += snap->summary ().size ();
+            total += snap->description ().size ();
+            for (int j = 0; j < snap->appCount (); j++)
+                total += snap->app (j)->name ().size ();
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+/* Reading through the meta-object system, as QML does */
+void
+WrapperBenchmark::getSnapsProperties ()
+{
+    int total = 0;
+    QBENCHMARK {
+        for (int i = 0; i < getSnapsRequest->snapCount (); i++) {
+            QScopedPointer<QSnapdSnap> snap (getSnapsRequest->snap (i));
+            total += snap->property ("name").toString ().size ();
+            total += snap->property ("summary").toString ().size ();
+            total += snap->property ("description").toString ().size ();
+            total += snap->property ("appCount").toInt ();
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+void
+WrapperBenchmark::getSnapsSnapInfos ()
+{
+    int total = 0;
+    QBENCHMARK {
+        for (const QSnapdSnapInfo &snap : getSnapsRequest->snapInfos ()) {
+            total += snap.name ().size ();
+            total += snap.summary ().size ();
+            total += snap.description ().size ();
+            for (const QSnapdAppInfo &app : snap.apps ())
+                total += app.name ().size ();
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+void
+WrapperBenchmark::findWrapped ()
+{
+    int total = 0;
+    QBENCHMARK {
+        for (int i = 0; i < findRequest->snapCount (); i++) {
+            QScopedPointer<QSnapdSnap> snap (findRequest->snap (i));
+            total += snap->name ().size ();
+            total += snap->summary ().size ();
+            for (int j = 0; j < snap->channelCount (); j++)
+                total += snap->channel (j)->name ().size ();
+            for (int j = 0; j < snap->mediaCount (); j++)
+                total += snap->media (j)->url ().size ();
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+void
+WrapperBenchmark::findSnapInfos ()
+{
+    int total = 0;
+    QBENCHMARK {
+        for (const QSnapdSnapInfo &snap : findRequest->snapInfos ()) {
+            total += snap.name ().size ();
+            total += snap.summary ().size ();
+            for (const QSnapdChannelInfo &channel : snap.channels ())
+                total += channel.name ().size ();
+        }
+    }
+    QVERIFY (total > 0);
+}
+
+void
+WrapperBenchmark::configurationToQVariant ()
+{
+    QVariant value;
+    QBENCHMARK {
+        value = gvariant_to_qvariant (configuration);
+    }
+    QCOMPARE (value.toHash ().size (), N_CONFIGURATION_KEYS);
+}
+
+void
+WrapperBenchmark::markdownRaw ()
+{
+    QByteArray text = markdown.toUtf8 ();
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    guint n_nodes = 0;
+    QBENCHMARK {
+        g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (parser, text.constData ());
+        n_nodes = nodes->len;
+    }
+    QVERIFY (n_nodes > 0);
+}
+
+void
+WrapperBenchmark::markdownWrapped ()
+{
+    QSnapdMarkdownParser parser (QSnapdMarkdownParser::MarkdownVersion0);
+    int n_nodes = 0;
+    QBENCHMARK {
+        n_nodes = parser.parse (markdown).size ();
+    }
+    QVERIFY (n_nodes > 0);
+}
+
+QTEST_GUILESS_MAIN (WrapperBenchmark)
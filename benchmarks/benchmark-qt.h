@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "mock-snapd.h"
+#include <snapd-glib/snapd-glib.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <Snapd/Client>
+
+class WrapperBenchmark: public QObject
+{
+    Q_OBJECT
+
+private:
+    MockSnapd *snapd = NULL;
+    QSnapdClient client;
+    QScopedPointer<QSnapdGetSnapsRequest> getSnapsRequest;
+    QScopedPointer<QSnapdFindRequest> findRequest;
+    GPtrArray *rawSnaps = NULL;
+    GVariant *configuration = NULL;
+    QString markdown;
+
+private Q_SLOTS:
+    void initTestCase ();
+    void cleanupTestCase ();
+
+    void getSnapsRaw ();
+    void getSnapsWrapped ();
+    void getSnapsProperties ();
+    void getSnapsSnapInfos ();
+    void findWrapped ();
+    void findSnapInfos ();
+    void configurationToQVariant ();
+    void markdownRaw ();
+    void markdownWrapped ();
+};
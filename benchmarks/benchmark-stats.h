@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __BENCHMARK_STATS_H__
+#define __BENCHMARK_STATS_H__
+
+#include <stdlib.h>
+#include <glib.h>
+
+static int
+compare_latency (const void *a, const void *b)
+{
+    gint64 latency_a = *((const gint64 *) a), latency_b = *((const gint64 *) b);
+    return latency_a < latency_b ? -1 : latency_a > latency_b ? 1 : 0;
+}
+
+/* Print the request rate and latency percentiles for @n_requests requests that took @elapsed microseconds.
+ * @latencies are in microseconds and are sorted in place */
+static void
+print_latency_report (const gchar *name, gint64 *latencies, guint n_requests, guint n_failed, gint64 elapsed)
+{
+    if (n_requests == 0) {
+        g_print ("%s: no requests\n", name);
+        return;
+    }
+
+    qsort (latencies, n_requests, sizeof (gint64), compare_latency);
+    gint64 p50 = latencies[n_requests * 50 / 100];
+    gint64 p99 = latencies[MIN (n_requests - 1, n_requests * 99 / 100)];
+    gint64 max = latencies[n_requests - 1];
+
+    g_print ("%s: %u requests (%u failed) in %.3fs, %.0f requests/s, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+             name, n_requests, n_failed, elapsed / 1e6, n_requests * 1e6 / elapsed,
+             p50 / 1000.0, p99 / 1000.0, max / 1000.0);
+}
+
+#endif /* __BENCHMARK_STATS_H__ */
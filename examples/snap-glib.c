@@ -9,6 +9,41 @@
 
 #include <snapd-glib/snapd-glib.h>
 
+static gboolean profile = FALSE;
+
+static void print_phase (const gchar *label, SnapdRequestTimings *timings, SnapdRequestPhase start, SnapdRequestPhase end)
+{
+    gint64 duration = snapd_request_timings_get_duration (timings, start, end);
+    if (duration < 0) {
+        g_printerr (" %s –", label);
+    }
+    else {
+        g_printerr (" %s %.2fms", label, duration / 1000.0);
+    }
+}
+
+static void request_finished_cb (SnapdClient *client, SnapdRequestTimings *timings)
+{
+    g_printerr ("profile: %s %s %u", snapd_request_timings_get_method (timings), snapd_request_timings_get_path (timings), snapd_request_timings_get_status_code (timings));
+    print_phase ("total", timings, SNAPD_REQUEST_PHASE_STARTED, SNAPD_REQUEST_PHASE_COMPLETED);
+    g_printerr (":");
+    print_phase ("write", timings, SNAPD_REQUEST_PHASE_STARTED, SNAPD_REQUEST_PHASE_WRITTEN);
+    print_phase ("snapd", timings, SNAPD_REQUEST_PHASE_WRITTEN, SNAPD_REQUEST_PHASE_FIRST_BYTE);
+    print_phase ("receive", timings, SNAPD_REQUEST_PHASE_FIRST_BYTE, SNAPD_REQUEST_PHASE_BODY);
+    print_phase ("parse", timings, SNAPD_REQUEST_PHASE_BODY, SNAPD_REQUEST_PHASE_PARSED);
+    print_phase ("callback", timings, SNAPD_REQUEST_PHASE_PARSED, SNAPD_REQUEST_PHASE_COMPLETED);
+    g_printerr (", %" G_GSIZE_FORMAT " bytes sent, %" G_GSIZE_FORMAT " bytes received\n", snapd_request_timings_get_bytes_sent (timings), snapd_request_timings_get_bytes_received (timings));
+}
+
+static SnapdClient *make_client (void)
+{
+    SnapdClient *client = snapd_client_new ();
+    if (profile) {
+        g_signal_connect (client, "request-finished", G_CALLBACK (request_finished_cb), NULL);
+    }
+    return client;
+}
+
 static void print_table (GPtrArray *columns)
 {
     g_autofree size_t *column_widths = g_malloc0 (sizeof (size_t) * columns->len);
@@ -58,7 +93,7 @@ static int find (int argc, char **argv)
     }
     const gchar *query = argc > 0 ? argv[0] : NULL;
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autoptr(SnapdClient) client = make_client ();
     g_autoptr(GError) error = NULL;
     g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, query, NULL, NULL, &error);
     if (snaps == NULL) {
@@ -103,7 +138,7 @@ static int info (int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autoptr(SnapdClient) client = make_client ();
     for (int i = 0; i < argc; i++) {
         const char *name = argv[i];
 
@@ -151,7 +186,7 @@ static int install (int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autoptr(SnapdClient) client = make_client ();
     for (int i = 0; i < argc; i++) {
         const char *name = argv[i];
 
@@ -182,7 +217,7 @@ static int remove (int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autoptr(SnapdClient) client = make_client ();
     for (int i = 0; i < argc; i++) {
         const char *name = argv[i];
 
@@ -207,7 +242,7 @@ static int list (int argc, char **argv)
     const gchar *name = argc > 0 ? argv[0] : NULL;
     gchar *names[2] = { (gchar*) name, NULL };
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autoptr(SnapdClient) client = make_client ();
     g_autoptr(GError) error = NULL;
     g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, names, NULL, &error);
     if (snaps == NULL) {
@@ -244,16 +279,201 @@ static int list (int argc, char **argv)
     return EXIT_SUCCESS;
 }
 
+typedef struct {
+    SnapdClient *client;
+    GMainLoop *loop;
+    const gchar *operation;
+    const gchar *arg;
+    guint n_requests;
+    guint n_started;
+    guint n_completed;
+    guint n_failed;
+    gint64 *latencies;
+} Bench;
+
+typedef struct {
+    Bench *bench;
+    gint64 start_time;
+} BenchRequest;
+
+static void bench_start_request (Bench *bench);
+
+static void bench_request_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    BenchRequest *request = user_data;
+    Bench *bench = request->bench;
+    SnapdClient *client = SNAPD_CLIENT (object);
+
+    g_autoptr(GError) error = NULL;
+    gboolean ok;
+    if (strcmp (bench->operation, "find") == 0) {
+        g_autoptr(GPtrArray) snaps = snapd_client_find_section_finish (client, result, NULL, &error);
+        ok = snaps != NULL;
+    }
+    else if (strcmp (bench->operation, "list") == 0) {
+        g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (client, result, &error);
+        ok = snaps != NULL;
+    }
+    else if (strcmp (bench->operation, "info") == 0) {
+        g_autoptr(SnapdSnap) snap = snapd_client_get_snap_finish (client, result, &error);
+        ok = snap != NULL;
+    }
+    else {
+        g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (client, result, &error);
+        ok = info != NULL;
+    }
+
+    if (ok) {
+        bench->latencies[bench->n_completed - bench->n_failed] = g_get_monotonic_time () - request->start_time;
+    }
+    else {
+        if (bench->n_failed == 0) {
+            g_printerr ("error: %s request failed: %s\n", bench->operation, error->message);
+        }
+        bench->n_failed++;
+    }
+    bench->n_completed++;
+    g_free (request);
+
+    if (bench->n_started < bench->n_requests) {
+        bench_start_request (bench);
+    }
+    else if (bench->n_completed == bench->n_requests) {
+        g_main_loop_quit (bench->loop);
+    }
+}
+
+static void bench_start_request (Bench *bench)
+{
+    BenchRequest *request = g_new0 (BenchRequest, 1);
+    request->bench = bench;
+    request->start_time = g_get_monotonic_time ();
+    bench->n_started++;
+
+    if (strcmp (bench->operation, "find") == 0) {
+        snapd_client_find_section_async (bench->client, SNAPD_FIND_FLAGS_NONE, NULL, bench->arg, NULL, bench_request_cb, request);
+    }
+    else if (strcmp (bench->operation, "list") == 0) {
+        snapd_client_get_snaps_async (bench->client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, bench_request_cb, request);
+    }
+    else if (strcmp (bench->operation, "info") == 0) {
+        snapd_client_get_snap_async (bench->client, bench->arg, NULL, bench_request_cb, request);
+    }
+    else {
+        snapd_client_get_system_information_async (bench->client, NULL, bench_request_cb, request);
+    }
+}
+
+static int compare_latencies (const void *a, const void *b)
+{
+    gint64 latency_a = *((const gint64 *) a);
+    gint64 latency_b = *((const gint64 *) b);
+    return latency_a < latency_b ? -1 : latency_a > latency_b ? 1 : 0;
+}
+
+static gint64 get_percentile (gint64 *latencies, guint n_latencies, guint percentile)
+{
+    guint index = (n_latencies * percentile + 99) / 100;
+    return latencies[index > 0 ? index - 1 : 0];
+}
+
+static int bench (int argc, char **argv)
+{
+    guint n_requests = 100;
+    guint concurrency = 1;
+    int i = 0;
+    for (; i < argc && g_str_has_prefix (argv[i], "-"); i++) {
+        if ((strcmp (argv[i], "-n") == 0 || strcmp (argv[i], "-c") == 0) && i + 1 < argc) {
+            guint64 value;
+            if (!g_ascii_string_to_unsigned (argv[i + 1], 10, 1, G_MAXUINT, &value, NULL)) {
+                g_printerr ("error: invalid value \"%s\" for %s\n", argv[i + 1], argv[i]);
+                return EXIT_FAILURE;
+            }
+            if (strcmp (argv[i], "-n") == 0) {
+                n_requests = value;
+            }
+            else {
+                concurrency = value;
+            }
+            i++;
+        }
+        else {
+            g_printerr ("error: unknown option \"%s\" for bench\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (i >= argc) {
+        g_printerr ("error: missing operation, one of find, list, info, version\n");
+        return EXIT_FAILURE;
+    }
+    const gchar *operation = argv[i];
+    const gchar *arg = i + 1 < argc ? argv[i + 1] : NULL;
+    if (i + 2 < argc) {
+        g_printerr ("error: too many arguments for command\n");
+        return EXIT_FAILURE;
+    }
+    if (strcmp (operation, "find") == 0 || strcmp (operation, "info") == 0) {
+        if (arg == NULL) {
+            g_printerr ("error: %s needs a %s\n", operation, strcmp (operation, "find") == 0 ? "query" : "snap name");
+            return EXIT_FAILURE;
+        }
+    }
+    else if (strcmp (operation, "list") != 0 && strcmp (operation, "version") != 0) {
+        g_printerr ("error: unknown operation \"%s\", one of find, list, info, version\n", operation);
+        return EXIT_FAILURE;
+    }
+
+    g_autoptr(SnapdClient) client = make_client ();
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autofree gint64 *latencies = g_new0 (gint64, n_requests);
+    Bench b = { client, loop, operation, arg, n_requests, 0, 0, 0, latencies };
+
+    gint64 start_time = g_get_monotonic_time ();
+    for (guint j = 0; j < concurrency && b.n_started < n_requests; j++) {
+        bench_start_request (&b);
+    }
+    g_main_loop_run (loop);
+    gint64 elapsed = g_get_monotonic_time () - start_time;
+
+    guint n_succeeded = b.n_completed - b.n_failed;
+    g_printerr ("%u requests, %u concurrent, %u failed in %.3fs (%.1f requests/s)\n",
+                n_requests, concurrency, b.n_failed, elapsed / 1e6, elapsed > 0 ? b.n_completed * 1e6 / elapsed : 0.0);
+    if (n_succeeded == 0) {
+        return EXIT_FAILURE;
+    }
+
+    qsort (latencies, n_succeeded, sizeof (gint64), compare_latencies);
+    g_printerr ("latency: min %.2fms, p50 %.2fms, p90 %.2fms, p99 %.2fms, max %.2fms\n",
+                latencies[0] / 1000.0,
+                get_percentile (latencies, n_succeeded, 50) / 1000.0,
+                get_percentile (latencies, n_succeeded, 90) / 1000.0,
+                get_percentile (latencies, n_succeeded, 99) / 1000.0,
+                latencies[n_succeeded - 1] / 1000.0);
+
+    return b.n_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 static int usage()
 {
-    g_printerr ("Usage snap-glib <command> [<options>...]\n");
-    g_printerr ("Commands: find, info, install, remove, list, help\n");
+    g_printerr ("Usage snap-glib [--profile] <command> [<options>...]\n");
+    g_printerr ("Commands: find, info, install, remove, list, bench, help\n");
+    g_printerr ("\n");
+    g_printerr ("  bench [-n <requests>] [-c <concurrency>] <find|list|info|version> [<query|name>]\n");
+    g_printerr ("\n");
+    g_printerr ("Options:\n");
+    g_printerr ("  --profile  Print the time spent in each phase of every request\n");
 
     return EXIT_SUCCESS;
 }
 
 int main (int argc, char **argv)
 {
+    while (argc > 1 && strcmp (argv[1], "--profile") == 0) {
+        profile = TRUE;
+        argc--;
+        argv++;
+    }
+
     if (argc < 2) {
         return usage ();
     }
@@ -276,6 +496,9 @@ int main (int argc, char **argv)
     else if (strcmp (command, "list") == 0) {
         return list (command_argc, command_argv);
     }
+    else if (strcmp (command, "bench") == 0) {
+        return bench (command_argc, command_argv);
+    }
     else if (strcmp (command, "help") == 0) {
         return usage ();
     }
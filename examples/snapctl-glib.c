@@ -8,10 +8,133 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include <glib.h>
 #include <snapd-glib/snapd-glib.h>
 
+/* Usage:
+ *
+ *   snapctl-glib ARGS...
+ *     Run a single snapctl command.
+ *
+ *   snapctl-glib --batch < commands
+ *     Run one command per line of stdin, all sent together over one
+ *     connection. The output of each command is written in order and the exit
+ *     code is that of the first command that failed.
+ *
+ *   snapctl-glib --helper
+ *     Stay running and run each command as its line arrives on stdin, reusing
+ *     the connection. After each command a line with the exit code and the
+ *     length of the stdout is written, followed by the stdout. stderr is passed
+ *     through. For example, from a hook:
+ *
+ *       coproc SNAPCTL { snapctl-glib --helper; }
+ *       echo "get key" >&${SNAPCTL[1]}
+ *       read -r code length <&${SNAPCTL[0]}
+ *       read -r -N "$length" value <&${SNAPCTL[0]}
+ */
+
+typedef struct
+{
+    GMainLoop *loop;
+    gboolean result;
+    GError *error;
+} BatchData;
+
+static void
+batch_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    BatchData *data = user_data;
+
+    data->result = snapd_request_batch_run_finish (SNAPD_REQUEST_BATCH (object), result, &data->error);
+    g_main_loop_quit (data->loop);
+}
+
+static int
+run_batch (SnapdClient *client, const char *context)
+{
+    g_autoptr(SnapdRequestBatch) batch = snapd_request_batch_new (client);
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    BatchData data = { loop, FALSE, NULL };
+    char line[4096];
+    int exit_code = 0;
+    guint i;
+
+    while (fgets (line, sizeof (line), stdin) != NULL) {
+        g_auto(GStrv) args = NULL;
+        g_autoptr(GError) error = NULL;
+
+        g_strstrip (line);
+        if (line[0] == '\0')
+            continue;
+        if (!g_shell_parse_argv (line, NULL, &args, &error)) {
+            fprintf (stderr, "error: %s\n", error->message);
+            return 1;
+        }
+        snapd_request_batch_add_run_snapctl (batch, context, args);
+    }
+
+    snapd_request_batch_run_async (batch, NULL, batch_cb, &data);
+    g_main_loop_run (loop);
+
+    for (i = 0; i < snapd_request_batch_get_n_requests (batch); i++) {
+        g_autoptr(GError) error = NULL;
+        const gchar *stdout_output = NULL, *stderr_output = NULL;
+        int code = 0;
+
+        if (!snapd_request_batch_get_error (batch, i, &error)) {
+            fprintf (stderr, "error: %s\n", error->message);
+            code = 1;
+        }
+        else {
+            snapd_request_batch_get_snapctl_output (batch, i, &stdout_output, &stderr_output, &code);
+            if (stdout_output)
+                fputs (stdout_output, stdout);
+            if (stderr_output)
+                fputs (stderr_output, stderr);
+        }
+        if (exit_code == 0)
+            exit_code = code;
+    }
+    g_clear_error (&data.error);
+
+    return exit_code;
+}
+
+static int
+run_helper (SnapdClient *client, const char *context)
+{
+    char line[4096];
+
+    while (fgets (line, sizeof (line), stdin) != NULL) {
+        g_auto(GStrv) args = NULL;
+        g_autoptr(GError) error = NULL;
+        g_autofree gchar *stdout_output = NULL;
+        g_autofree gchar *stderr_output = NULL;
+        int exit_code = 0;
+
+        g_strstrip (line);
+        if (line[0] == '\0')
+            continue;
+        if (!g_shell_parse_argv (line, NULL, &args, &error) ||
+            !snapd_client_run_snapctl2_sync (client, context, args, &stdout_output, &stderr_output, &exit_code, NULL, &error)) {
+            fprintf (stderr, "error: %s\n", error->message);
+            exit_code = 1;
+        }
+        if (stderr_output) {
+            fputs (stderr_output, stderr);
+        }
+        printf ("%d %zu\n", exit_code, stdout_output ? strlen (stdout_output) : 0);
+        if (stdout_output) {
+            fputs (stdout_output, stdout);
+        }
+        fflush (stdout);
+    }
+
+    return 0;
+}
+
 int main (int argc, char **argv)
 {
     g_autoptr(SnapdClient) client = snapd_client_new ();
@@ -31,6 +154,11 @@ int main (int argc, char **argv)
     if (!context)
         context = "";
 
+    if (argc == 2 && strcmp (argv[1], "--batch") == 0)
+        return run_batch (client, context);
+    if (argc == 2 && strcmp (argv[1], "--helper") == 0)
+        return run_helper (client, context);
+
     /* run_snapctl expects a NULL terminated argument array */
     args = g_new0 (char *, argc);
     for (i = 0; i < argc-1; i++)
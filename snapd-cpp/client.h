@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CPP_CLIENT_H
+#define SNAPD_CPP_CLIENT_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <snapd-glib/snapd-glib.h>
+#include <snapd-cpp/object.h>
+#include <snapd-cpp/result.h>
+#include <snapd-cpp/values.h>
+
+namespace snapd {
+
+// An asynchronous request, which is cancelled if destroyed before it completes.
+// Call detach() to let the request complete without keeping this object.
+class [[nodiscard]] Request
+{
+public:
+    Request () : cancellable (ObjectRef<GCancellable>::adopt (g_cancellable_new ())) {}
+    Request (const Request &) = delete;
+    Request &operator= (const Request &) = delete;
+    Request (Request &&) noexcept = default;
+    Request &operator= (Request &&) noexcept = default;
+
+    ~Request ()
+    {
+        cancel ();
+    }
+
+    void cancel () noexcept
+    {
+        if (cancellable)
+            g_cancellable_cancel (cancellable.get ());
+    }
+
+    void detach () noexcept
+    {
+        cancellable = ObjectRef<GCancellable> ();
+    }
+
+    GCancellable *get_cancellable () const noexcept
+    {
+        return cancellable.get ();
+    }
+
+private:
+    ObjectRef<GCancellable> cancellable;
+};
+
+namespace detail {
+
+// NULL terminated array of strings borrowed from @list, or NULL if it is empty
+class Strv
+{
+public:
+    explicit Strv (const std::vector<std::string> &list)
+    {
+        strings.reserve (list.size () + 1);
+        for (const std::string &s : list)
+            strings.push_back (s.c_str ());
+        strings.push_back (nullptr);
+    }
+
+    gchar **get () noexcept
+    {
+        return strings.size () > 1 ? const_cast<gchar **> (strings.data ()) : nullptr;
+    }
+
+private:
+    std::vector<const gchar *> strings;
+};
+
+template <class T> std::vector<T> list (GPtrArray *array)
+{
+    using Object = std::remove_pointer_t<decltype (std::declval<T> ().get ())>;
+
+    std::vector<T> result;
+    if (array == nullptr)
+        return result;
+    result.reserve (array->len);
+    for (guint i = 0; i < array->len; i++)
+        result.emplace_back (ObjectRef<Object>::ref (static_cast<Object *> (array->pdata[i])));
+    g_ptr_array_unref (array);
+    return result;
+}
+
+// Make a result from the return value of a snapd_client_*() call that returns a new object or array
+template <class T, class V> Result<T> result (V *value, GError *error)
+{
+    std::unique_ptr<GError, decltype (&g_error_free)> e (error, g_error_free);
+    if (error != nullptr)
+        return Error (error);
+    if constexpr (std::is_same_v<V, GPtrArray>)
+        return list<typename T::value_type> (value);
+    else
+        return T (ObjectRef<V>::adopt (value));
+}
+
+inline Result<void> result (gboolean, GError *error)
+{
+    std::unique_ptr<GError, decltype (&g_error_free)> e (error, g_error_free);
+    if (error != nullptr)
+        return Error (error);
+    return Result<void> ();
+}
+
+template <class Callback, class Finish> struct AsyncData
+{
+    Callback callback;
+    Finish finish;
+};
+
+template <class Callback, class Finish> void ready_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    std::unique_ptr<AsyncData<Callback, Finish>> data (static_cast<AsyncData<Callback, Finish> *> (user_data));
+    data->callback (data->finish (object, result));
+}
+
+// Start an asynchronous call.
+// @start is called with the cancellable, callback and data to pass to a snapd_client_*_async() function.
+// @finish is called with the result and returns the Result passed to @callback.
+template <class Callback, class Start, class Finish> Request call (Callback &&callback, Start &&start, Finish &&finish)
+{
+    using C = std::decay_t<Callback>;
+    using F = std::decay_t<Finish>;
+
+    Request request;
+    start (request.get_cancellable (), ready_cb<C, F>, new AsyncData<C, F> { std::forward<Callback> (callback), std::forward<Finish> (finish) });
+    return request;
+}
+
+// Run an asynchronous call, returning a future for the result.
+// The future is completed in the GMainContext the call was made from, so that context must be running.
+template <class T, class Start> std::future<T> future (Start &&start)
+{
+    auto promise = std::make_shared<std::promise<T>> ();
+    std::future<T> f = promise->get_future ();
+    start ([promise] (T result) {
+        promise->set_value (std::move (result));
+    }).detach ();
+    return f;
+}
+
+}
+
+// Connection to snapd.
+// Synchronous calls return a Result, asynchronous calls take a callback that receives a Result,
+// and *_future() calls return a std::future of the Result.
+class Client
+{
+public:
+    Client () : client (ObjectRef<SnapdClient>::adopt (snapd_client_new ())) {}
+    explicit Client (ObjectRef<SnapdClient> client) noexcept : client (std::move (client)) {}
+
+    SnapdClient *get () const noexcept { return client.get (); }
+
+    void set_socket_path (const char *socket_path) { snapd_client_set_socket_path (get (), socket_path); }
+    void set_allow_interaction (bool allow_interaction) { snapd_client_set_allow_interaction (get (), allow_interaction); }
+
+    Result<SystemInformation> get_system_information (GCancellable *cancellable = nullptr) const
+    {
+        GError *error = nullptr;
+        SnapdSystemInformation *information = snapd_client_get_system_information_sync (get (), cancellable, &error);
+        return detail::result<SystemInformation> (information, error);
+    }
+
+    template <class Callback> Request get_system_information_async (Callback &&callback) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_get_system_information_async (get (), cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            SnapdSystemInformation *information = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result<SystemInformation> (information, error);
+        });
+    }
+
+    Result<std::vector<Snap>> get_snaps (SnapdGetSnapsFlags flags = SNAPD_GET_SNAPS_FLAGS_NONE, const std::vector<std::string> &names = {}, GCancellable *cancellable = nullptr) const
+    {
+        detail::Strv strv (names);
+        GError *error = nullptr;
+        GPtrArray *snaps = snapd_client_get_snaps_sync (get (), flags, strv.get (), cancellable, &error);
+        return detail::result<std::vector<Snap>> (snaps, error);
+    }
+
+    template <class Callback> Request get_snaps_async (Callback &&callback, SnapdGetSnapsFlags flags = SNAPD_GET_SNAPS_FLAGS_NONE, const std::vector<std::string> &names = {}) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, flags, &names] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            detail::Strv strv (names);
+            snapd_client_get_snaps_async (get (), flags, strv.get (), cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            GPtrArray *snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result<std::vector<Snap>> (snaps, error);
+        });
+    }
+
+    std::future<Result<std::vector<Snap>>> get_snaps_future (SnapdGetSnapsFlags flags = SNAPD_GET_SNAPS_FLAGS_NONE, const std::vector<std::string> &names = {}) const
+    {
+        return detail::future<Result<std::vector<Snap>>> ([&] (auto callback) {
+            return get_snaps_async (std::move (callback), flags, names);
+        });
+    }
+
+    Result<std::vector<Snap>> find (SnapdFindFlags flags, const char *query, GCancellable *cancellable = nullptr) const
+    {
+        GError *error = nullptr;
+        GPtrArray *snaps = snapd_client_find_section_sync (get (), flags, nullptr, query, nullptr, cancellable, &error);
+        return detail::result<std::vector<Snap>> (snaps, error);
+    }
+
+    template <class Callback> Request find_async (Callback &&callback, SnapdFindFlags flags, const char *query) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, flags, query] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_find_section_async (get (), flags, nullptr, query, cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            GPtrArray *snaps = snapd_client_find_section_finish (SNAPD_CLIENT (object), result, nullptr, &error);
+            return detail::result<std::vector<Snap>> (snaps, error);
+        });
+    }
+
+    std::future<Result<std::vector<Snap>>> find_future (SnapdFindFlags flags, const char *query) const
+    {
+        return detail::future<Result<std::vector<Snap>>> ([&] (auto callback) {
+            return find_async (std::move (callback), flags, query);
+        });
+    }
+
+    Result<std::vector<App>> get_apps (SnapdGetAppsFlags flags = SNAPD_GET_APPS_FLAGS_NONE, const std::vector<std::string> &snaps = {}, GCancellable *cancellable = nullptr) const
+    {
+        detail::Strv strv (snaps);
+        GError *error = nullptr;
+        GPtrArray *apps = snapd_client_get_apps2_sync (get (), flags, strv.get (), cancellable, &error);
+        return detail::result<std::vector<App>> (apps, error);
+    }
+
+    template <class Callback> Request get_apps_async (Callback &&callback, SnapdGetAppsFlags flags = SNAPD_GET_APPS_FLAGS_NONE, const std::vector<std::string> &snaps = {}) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, flags, &snaps] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            detail::Strv strv (snaps);
+            snapd_client_get_apps2_async (get (), flags, strv.get (), cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            GPtrArray *apps = snapd_client_get_apps2_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result<std::vector<App>> (apps, error);
+        });
+    }
+
+    Result<Icon> get_icon (const char *name, GCancellable *cancellable = nullptr) const
+    {
+        GError *error = nullptr;
+        SnapdIcon *icon = snapd_client_get_icon_sync (get (), name, cancellable, &error);
+        return detail::result<Icon> (icon, error);
+    }
+
+    template <class Callback> Request get_icon_async (Callback &&callback, const char *name, const char *revision = nullptr) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, name, revision] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_get_icon2_async (get (), name, revision, cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            SnapdIcon *icon = snapd_client_get_icon2_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result<Icon> (icon, error);
+        });
+    }
+
+    std::future<Result<Icon>> get_icon_future (const char *name, const char *revision = nullptr) const
+    {
+        return detail::future<Result<Icon>> ([&] (auto callback) {
+            return get_icon_async (std::move (callback), name, revision);
+        });
+    }
+
+    template <class Callback> Request install_async (Callback &&callback, SnapdInstallFlags flags, const char *name, const char *channel = nullptr, const char *revision = nullptr) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, flags, name, channel, revision] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_install2_async (get (), flags, name, channel, revision, nullptr, nullptr, cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            gboolean ok = snapd_client_install2_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result (ok, error);
+        });
+    }
+
+    template <class Callback> Request refresh_async (Callback &&callback, const char *name, const char *channel = nullptr) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, name, channel] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_refresh_async (get (), name, channel, nullptr, nullptr, cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            gboolean ok = snapd_client_refresh_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result (ok, error);
+        });
+    }
+
+    template <class Callback> Request remove_async (Callback &&callback, SnapdRemoveFlags flags, const char *name) const
+    {
+        return detail::call (std::forward<Callback> (callback), [this, flags, name] (GCancellable *cancellable, GAsyncReadyCallback cb, gpointer data) {
+            snapd_client_remove2_async (get (), flags, name, nullptr, nullptr, cancellable, cb, data);
+        }, [] (GObject *object, GAsyncResult *result) {
+            GError *error = nullptr;
+            gboolean ok = snapd_client_remove2_finish (SNAPD_CLIENT (object), result, &error);
+            return detail::result (ok, error);
+        });
+    }
+
+private:
+    ObjectRef<SnapdClient> client;
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CPP_OBJECT_H
+#define SNAPD_CPP_OBJECT_H
+
+#include <string_view>
+#include <utility>
+
+#include <glib-object.h>
+
+namespace snapd {
+
+// Owning reference to a GObject, released when destroyed
+template <class T> class ObjectRef
+{
+public:
+    ObjectRef () noexcept = default;
+
+    // Take ownership of a reference, e.g. one returned from a snapd_client_*() call
+    static ObjectRef adopt (T *object) noexcept
+    {
+        ObjectRef ref;
+        ref.object = object;
+        return ref;
+    }
+
+    // Take a new reference, e.g. to an object owned by a container
+    static ObjectRef ref (T *object) noexcept
+    {
+        return adopt (object != nullptr ? static_cast<T *> (g_object_ref (object)) : nullptr);
+    }
+
+    ObjectRef (const ObjectRef &other) noexcept : object (other.object)
+    {
+        if (object != nullptr)
+            g_object_ref (object);
+    }
+
+    ObjectRef (ObjectRef &&other) noexcept : object (std::exchange (other.object, nullptr)) {}
+
+    ~ObjectRef ()
+    {
+        if (object != nullptr)
+            g_object_unref (object);
+    }
+
+    ObjectRef &operator= (ObjectRef other) noexcept
+    {
+        std::swap (object, other.object);
+        return *this;
+    }
+
+    T *get () const noexcept
+    {
+        return object;
+    }
+
+    T *release () noexcept
+    {
+        return std::exchange (object, nullptr);
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return object != nullptr;
+    }
+
+private:
+    T *object = nullptr;
+};
+
+// Borrow a string owned by a GObject, which is valid as long as the object is
+inline std::string_view borrow (const gchar *value) noexcept
+{
+    return value != nullptr ? std::string_view (value) : std::string_view ();
+}
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CPP_RESULT_H
+#define SNAPD_CPP_RESULT_H
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <glib.h>
+
+namespace snapd {
+
+// Error returned from a request, e.g. SNAPD_ERROR / SNAPD_ERROR_NOT_FOUND
+class Error
+{
+public:
+    Error () = default;
+    explicit Error (const GError *error) : domain (error->domain), code (error->code), message (error->message) {}
+
+    GQuark domain = 0;
+    int code = 0;
+    std::string message;
+
+    bool matches (GQuark d, int c) const noexcept
+    {
+        return domain == d && code == c;
+    }
+};
+
+// Result of a request, which is either a value or an error
+template <class T> class Result
+{
+public:
+    Result (T value) : result_value (std::move (value)) {}
+    Result (Error error) : result_error (std::move (error)) {}
+
+    bool ok () const noexcept { return result_value.has_value (); }
+    explicit operator bool () const noexcept { return ok (); }
+    // Only valid if ok()
+    const T &value () const & noexcept { return *result_value; }
+    T &&value () && noexcept { return std::move (*result_value); }
+    const Error &error () const noexcept { return result_error; }
+
+private:
+    std::optional<T> result_value;
+    Error result_error;
+};
+
+template <> class Result<void>
+{
+public:
+    Result () = default;
+    Result (Error error) : is_ok (false), result_error (std::move (error)) {}
+
+    bool ok () const noexcept { return is_ok; }
+    explicit operator bool () const noexcept { return is_ok; }
+    const Error &error () const noexcept { return result_error; }
+
+private:
+    bool is_ok = true;
+    Error result_error;
+};
+
+}
+
+#endif
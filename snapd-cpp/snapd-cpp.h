@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CPP_H
+#define SNAPD_CPP_H
+
+// Header-only C++17 binding for libsnapd-glib, with no dependencies other than snapd-glib
+#include <snapd-cpp/client.h>
+#include <snapd-cpp/object.h>
+#include <snapd-cpp/result.h>
+#include <snapd-cpp/values.h>
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CPP_VALUES_H
+#define SNAPD_CPP_VALUES_H
+
+#include <string_view>
+#include <vector>
+
+#include <snapd-glib/snapd-glib.h>
+#include <snapd-cpp/object.h>
+
+namespace snapd {
+
+// The accessors below borrow strings from the underlying object, so they are only valid while it is
+
+class App
+{
+public:
+    explicit App (ObjectRef<SnapdApp> app) noexcept : app (std::move (app)) {}
+
+    SnapdApp *get () const noexcept { return app.get (); }
+    std::string_view name () const noexcept { return borrow (snapd_app_get_name (get ())); }
+    std::string_view snap () const noexcept { return borrow (snapd_app_get_snap (get ())); }
+    std::string_view common_id () const noexcept { return borrow (snapd_app_get_common_id (get ())); }
+    std::string_view desktop_file () const noexcept { return borrow (snapd_app_get_desktop_file (get ())); }
+    bool active () const noexcept { return snapd_app_get_active (get ()); }
+    bool enabled () const noexcept { return snapd_app_get_enabled (get ()); }
+
+private:
+    ObjectRef<SnapdApp> app;
+};
+
+class Snap
+{
+public:
+    explicit Snap (ObjectRef<SnapdSnap> snap) noexcept : snap (std::move (snap)) {}
+
+    SnapdSnap *get () const noexcept { return snap.get (); }
+    std::string_view name () const noexcept { return borrow (snapd_snap_get_name (get ())); }
+    std::string_view id () const noexcept { return borrow (snapd_snap_get_id (get ())); }
+    std::string_view title () const noexcept { return borrow (snapd_snap_get_title (get ())); }
+    std::string_view summary () const noexcept { return borrow (snapd_snap_get_summary (get ())); }
+    std::string_view description () const noexcept { return borrow (snapd_snap_get_description (get ())); }
+    std::string_view version () const noexcept { return borrow (snapd_snap_get_version (get ())); }
+    std::string_view revision () const noexcept { return borrow (snapd_snap_get_revision (get ())); }
+    std::string_view channel () const noexcept { return borrow (snapd_snap_get_channel (get ())); }
+    std::string_view tracking_channel () const noexcept { return borrow (snapd_snap_get_tracking_channel (get ())); }
+    std::string_view icon () const noexcept { return borrow (snapd_snap_get_icon (get ())); }
+    std::string_view publisher_display_name () const noexcept { return borrow (snapd_snap_get_publisher_display_name (get ())); }
+    SnapdSnapStatus status () const noexcept { return snapd_snap_get_status (get ()); }
+    SnapdConfinement confinement () const noexcept { return snapd_snap_get_confinement (get ()); }
+    gint64 installed_size () const noexcept { return snapd_snap_get_installed_size (get ()); }
+    gint64 download_size () const noexcept { return snapd_snap_get_download_size (get ()); }
+
+    std::vector<App> apps () const
+    {
+        std::vector<App> result;
+        GPtrArray *apps = snapd_snap_get_apps (get ());
+        if (apps == nullptr)
+            return result;
+        result.reserve (apps->len);
+        for (guint i = 0; i < apps->len; i++)
+            result.emplace_back (ObjectRef<SnapdApp>::ref (SNAPD_APP (apps->pdata[i])));
+        return result;
+    }
+
+private:
+    ObjectRef<SnapdSnap> snap;
+};
+
+class Icon
+{
+public:
+    explicit Icon (ObjectRef<SnapdIcon> icon) noexcept : icon (std::move (icon)) {}
+
+    SnapdIcon *get () const noexcept { return icon.get (); }
+    std::string_view mime_type () const noexcept { return borrow (snapd_icon_get_mime_type (get ())); }
+
+    std::string_view data () const noexcept
+    {
+        gsize length;
+        const gchar *data = static_cast<const gchar *> (g_bytes_get_data (snapd_icon_get_data (get ()), &length));
+        return std::string_view (data, length);
+    }
+
+private:
+    ObjectRef<SnapdIcon> icon;
+};
+
+class SystemInformation
+{
+public:
+    explicit SystemInformation (ObjectRef<SnapdSystemInformation> information) noexcept : information (std::move (information)) {}
+
+    SnapdSystemInformation *get () const noexcept { return information.get (); }
+    std::string_view version () const noexcept { return borrow (snapd_system_information_get_version (get ())); }
+    std::string_view series () const noexcept { return borrow (snapd_system_information_get_series (get ())); }
+    std::string_view kernel_version () const noexcept { return borrow (snapd_system_information_get_kernel_version (get ())); }
+    std::string_view build_id () const noexcept { return borrow (snapd_system_information_get_build_id (get ())); }
+    bool on_classic () const noexcept { return snapd_system_information_get_on_classic (get ()); }
+    bool managed () const noexcept { return snapd_system_information_get_managed (get ()); }
+
+private:
+    ObjectRef<SnapdSystemInformation> information;
+};
+
+}
+
+#endif
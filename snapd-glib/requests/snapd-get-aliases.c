@@ -39,10 +39,10 @@ _snapd_get_aliases_get_aliases (SnapdGetAliases *self)
     return self->aliases;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_aliases_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/aliases");
+    return _snapd_http_request_new ("GET", "/v2/aliases");
 }
 
 static gboolean
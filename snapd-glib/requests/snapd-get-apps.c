@@ -48,7 +48,7 @@ _snapd_get_apps_get_apps (SnapdGetApps *self)
     return self->apps;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_apps_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetApps *self = SNAPD_GET_APPS (request);
@@ -69,7 +69,7 @@ generate_get_apps_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup (attr->str));
     }
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/apps");
+    g_autoptr(GString) path = g_string_new ("/v2/apps");
     if (query_attributes->len > 0) {
         g_string_append_c (path, '?');
         for (guint i = 0; i < query_attributes->len; i++) {
@@ -79,7 +79,7 @@ generate_get_apps_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -7,7 +7,7 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
-#include <stdlib.h>
+#include <string.h>
 
 #include "snapd-get-assertions.h"
 
@@ -19,7 +19,11 @@ struct _SnapdGetAssertions
 {
     SnapdRequest parent_instance;
     gchar *type;
-    GStrv assertions;
+    GPtrArray *assertions;
+
+    /* Data received but not yet reported when streaming */
+    gboolean streaming;
+    GByteArray *pending;
 };
 
 G_DEFINE_TYPE (SnapdGetAssertions, snapd_get_assertions, snapd_request_get_type ())
@@ -37,21 +41,139 @@ _snapd_get_assertions_new (const gchar *type, GCancellable *cancellable, GAsyncR
     return self;
 }
 
-GStrv
+GPtrArray *
 _snapd_get_assertions_get_assertions (SnapdGetAssertions *self)
 {
     return self->assertions;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_assertions_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetAssertions *self = SNAPD_GET_ASSERTIONS (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/assertions/");
+    g_autoptr(GString) path = g_string_new ("/v2/assertions/");
     g_string_append_uri_escaped (path, self->type, NULL, TRUE);
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
+}
+
+/* Find the next double newline, or the end of the data */
+static gsize
+find_divider (const gchar *data, gsize offset, gsize data_length)
+{
+    while (offset < data_length) {
+        const gchar *newline = memchr (data + offset, '\n', data_length - offset);
+        if (newline == NULL)
+            break;
+        offset = newline - data;
+        if (offset + 1 < data_length && data[offset + 1] == '\n')
+            return offset;
+        offset++;
+    }
+
+    return data_length;
+}
+
+/* Get the value of the body-length header without decoding the other headers */
+static gsize
+get_body_length (const gchar *data, gsize headers_start, gsize headers_end)
+{
+    const gchar *name = "body-length:";
+    gsize name_length = strlen (name);
+
+    gsize line_start = headers_start;
+    while (line_start < headers_end) {
+        if (headers_end - line_start > name_length && memcmp (data + line_start, name, name_length) == 0) {
+            gsize offset = line_start + name_length;
+            while (offset < headers_end && data[offset] != '\n' && g_ascii_isspace (data[offset]))
+                offset++;
+            gsize body_length = 0;
+            while (offset < headers_end && g_ascii_isdigit (data[offset])) {
+                body_length = body_length * 10 + (data[offset] - '0');
+                offset++;
+            }
+            return body_length;
+        }
+
+        const gchar *newline = memchr (data + line_start, '\n', headers_end - line_start);
+        if (newline == NULL)
+            break;
+        line_start = newline - data + 1;
+    }
+
+    return 0;
+}
+
+/* Find the end of the assertion starting at @offset and where the next one starts.
+ * If @complete is %FALSE more data may follow, so an assertion is only found once the divider after it has been received */
+static gboolean
+find_assertion (const gchar *data, gsize data_length, gsize offset, gboolean complete, gsize *assertion_end, gsize *next_offset)
+{
+    if (offset >= data_length)
+        return FALSE;
+
+    /* Headers terminated by double newline */
+    gsize headers_end = find_divider (data, offset, data_length);
+    if (headers_end == data_length && !complete)
+        return FALSE;
+    gsize signature_start = headers_end + 2;
+
+    /* Skip over body */
+    gsize body_length = get_body_length (data, offset, headers_end);
+    if (body_length > 0)
+        signature_start += body_length + 2;
+
+    /* Find end of signature */
+    gsize signature_end = find_divider (data, MIN (signature_start, data_length), data_length);
+    if (signature_end == data_length && !complete)
+        return FALSE;
+
+    *assertion_end = signature_end;
+    *next_offset = signature_end + 2;
+    return TRUE;
+}
+
+/* Report the assertions received so far, keeping any incomplete assertion until more data arrives */
+static void
+report_pending_assertions (SnapdGetAssertions *self, gboolean complete)
+{
+    const gchar *data = (const gchar *) self->pending->data;
+    gsize data_length = self->pending->len, offset = 0, assertion_end, next_offset;
+    while (find_assertion (data, data_length, offset, complete, &assertion_end, &next_offset)) {
+        g_autofree gchar *content = g_strndup (data + offset, assertion_end - offset);
+        g_autoptr(SnapdAssertion) assertion = snapd_assertion_new (content);
+        _snapd_request_report_item (SNAPD_REQUEST (self), G_OBJECT (assertion));
+        offset = next_offset;
+    }
+
+    g_byte_array_remove_range (self->pending, 0, MIN (offset, data_length));
+}
+
+static void
+parse_get_assertions_headers (SnapdRequest *request, guint status_code, SoupMessageHeaders *headers)
+{
+    SnapdGetAssertions *self = SNAPD_GET_ASSERTIONS (request);
+
+    /* Assertions are reported as they arrive rather than waiting for the whole response */
+    const gchar *content_type = soup_message_headers_get_content_type (headers, NULL);
+    self->streaming = _snapd_request_has_item_callback (request) &&
+                      status_code == SOUP_STATUS_OK &&
+                      g_strcmp0 (content_type, "application/x.ubuntu.assertion") == 0;
+    _snapd_request_set_write_response (request, self->streaming);
+}
+
+static gboolean
+write_get_assertions_response (SnapdRequest *request, const guint8 *data, gsize length, GError **error)
+{
+    SnapdGetAssertions *self = SNAPD_GET_ASSERTIONS (request);
+
+    if (self->pending == NULL)
+        self->pending = g_byte_array_new ();
+    g_byte_array_append (self->pending, data, length);
+    report_pending_assertions (self, FALSE);
+
+    return TRUE;
 }
 
 static gboolean
@@ -90,37 +212,22 @@ parse_get_assertions_response (SnapdRequest *request, guint status_code, const g
         return FALSE;
     }
 
-    g_autoptr(GPtrArray) assertions = g_ptr_array_new ();
-    gsize data_length, offset = 0;
-    const gchar *data = g_bytes_get_data (body, &data_length);
-    while (offset < data_length) {
-        /* Headers terminated by double newline */
-        gsize assertion_start = offset;
-        while (offset < data_length && !g_str_has_prefix (data + offset, "\n\n"))
-            offset++;
-        offset += 2;
-
-        /* Make a temporary assertion object to decode body length header */
-        g_autofree gchar *content = g_strndup (data + assertion_start, offset - assertion_start);
-        g_autoptr(SnapdAssertion) assertion = snapd_assertion_new (content);
-        g_autofree gchar *body_length_header = snapd_assertion_get_header (assertion, "body-length");
-
-        /* Skip over body */
-        gsize body_length = body_length_header != NULL ? strtoul (body_length_header, NULL, 10) : 0;
-        if (body_length > 0)
-            offset += body_length + 2;
-
-        /* Find end of signature */
-        while (offset < data_length && !g_str_has_prefix (data + offset, "\n\n"))
-            offset++;
-        gsize assertion_end = offset;
-        offset += 2;
+    /* Report the last assertion, which has no divider after it */
+    if (self->streaming) {
+        if (self->pending != NULL)
+            report_pending_assertions (self, TRUE);
+        return TRUE;
+    }
 
-        g_ptr_array_add (assertions, g_strndup (data + assertion_start, assertion_end - assertion_start));
+    g_autoptr(GPtrArray) assertions = g_ptr_array_new_with_free_func ((GDestroyNotify) g_bytes_unref);
+    gsize data_length, offset = 0, assertion_end, next_offset;
+    const gchar *data = g_bytes_get_data (body, &data_length);
+    while (find_assertion (data, data_length, offset, TRUE, &assertion_end, &next_offset)) {
+        g_ptr_array_add (assertions, g_bytes_new_from_bytes (body, offset, assertion_end - offset));
+        offset = next_offset;
     }
-    g_ptr_array_add (assertions, NULL);
 
-    self->assertions = g_steal_pointer ((GStrv *)&assertions->pdata);
+    self->assertions = g_steal_pointer (&assertions);
 
     return TRUE;
 }
@@ -131,7 +238,8 @@ snapd_get_assertions_finalize (GObject *object)
     SnapdGetAssertions *self = SNAPD_GET_ASSERTIONS (object);
 
     g_clear_pointer (&self->type, g_free);
-    g_clear_pointer (&self->assertions, g_strfreev);
+    g_clear_pointer (&self->assertions, g_ptr_array_unref);
+    g_clear_pointer (&self->pending, g_byte_array_unref);
 
     G_OBJECT_CLASS (snapd_get_assertions_parent_class)->finalize (object);
 }
@@ -143,7 +251,9 @@ snapd_get_assertions_class_init (SnapdGetAssertionsClass *klass)
    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
    request_class->generate_request = generate_get_assertions_request;
+   request_class->parse_headers = parse_get_assertions_headers;
    request_class->parse_response = parse_get_assertions_response;
+   request_class->write_response = write_get_assertions_response;
    gobject_class->finalize = snapd_get_assertions_finalize;
 }
 
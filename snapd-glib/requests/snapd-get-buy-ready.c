@@ -28,10 +28,10 @@ _snapd_get_buy_ready_new (GCancellable *cancellable, GAsyncReadyCallback callbac
                                               NULL));
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_buy_ready_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/buy/ready");
+    return _snapd_http_request_new ("GET", "/v2/buy/ready");
 }
 
 static gboolean
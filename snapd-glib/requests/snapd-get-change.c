@@ -19,6 +19,9 @@ struct _SnapdGetChange
     SnapdChange *change;
     JsonNode *data;
     gchar *api_path;
+
+    /* Change from the last poll, so unchanged tasks can be reused */
+    SnapdChange *previous;
 };
 
 G_DEFINE_TYPE (SnapdGetChange, snapd_get_change, snapd_request_get_type ())
@@ -61,13 +64,19 @@ _snapd_get_change_set_api_path (SnapdGetChange *self, const gchar *api_path)
     self->api_path = g_strdup (api_path);
 }
 
-static SoupMessage *
+void
+_snapd_get_change_set_previous (SnapdGetChange *self, SnapdChange *change)
+{
+    g_set_object (&self->previous, change);
+}
+
+static SnapdHttpRequest *
 generate_get_change_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetChange *self = SNAPD_GET_CHANGE (request);
 
-    g_autofree gchar *path = g_strdup_printf ("http://snapd%s/%s", self->api_path ? self->api_path : "/v2/changes", self->change_id);
-    return soup_message_new ("GET", path);
+    g_autofree gchar *path = g_strdup_printf ("%s/%s", self->api_path ? self->api_path : "/v2/changes", self->change_id);
+    return _snapd_http_request_new ("GET", path);
 }
 
 static gboolean
@@ -84,7 +93,7 @@ parse_get_change_response (SnapdRequest *request, guint status_code, const gchar
     if (result == NULL)
         return FALSE;
 
-    self->change = _snapd_json_parse_change (result, error);
+    self->change = _snapd_json_parse_change_update (result, self->previous, error);
     json_node_unref (result);
     if (self->change == NULL)
         return FALSE;
@@ -112,6 +121,7 @@ snapd_get_change_finalize (GObject *object)
     g_clear_object (&self->change);
     g_clear_pointer (&self->data, json_node_unref);
     g_clear_pointer (&self->api_path, g_free);
+    g_clear_object (&self->previous);
 
     G_OBJECT_CLASS (snapd_get_change_parent_class)->finalize (object);
 }
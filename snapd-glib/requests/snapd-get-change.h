@@ -32,6 +32,9 @@ JsonNode       *_snapd_get_change_get_data      (SnapdGetChange *request);
 
 void            _snapd_get_change_set_api_path  (SnapdGetChange *request,
                                                  const gchar    *api_path);
+
+void            _snapd_get_change_set_previous  (SnapdGetChange *request,
+                                                 SnapdChange    *change);
 G_END_DECLS
 
 #endif /* __SNAPD_GET_CHANGE_H__ */
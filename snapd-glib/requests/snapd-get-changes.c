@@ -42,7 +42,7 @@ _snapd_get_changes_get_changes (SnapdGetChanges *self)
     return self->changes;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_changes_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetChanges *self = SNAPD_GET_CHANGES (request);
@@ -59,7 +59,7 @@ generate_get_changes_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup (attr->str));
     }
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/changes");
+    g_autoptr(GString) path = g_string_new ("/v2/changes");
     if (query_attributes->len > 0) {
         g_string_append_c (path, '?');
         for (guint i = 0; i < query_attributes->len; i++) {
@@ -69,33 +69,38 @@ generate_get_changes_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
-parse_get_changes_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+parse_change (JsonNode *node, gpointer user_data, GError **error)
 {
-    SnapdGetChanges *self = SNAPD_GET_CHANGES (request);
+    SnapdGetChanges *self = user_data;
 
-    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
-    if (response == NULL)
-        return FALSE;
-    g_autoptr(JsonArray) result = _snapd_json_get_sync_result_a (response, error);
-    if (result == NULL)
+    g_autoptr(SnapdChange) change = _snapd_json_parse_change (node, error);
+    if (change == NULL)
         return FALSE;
 
-    g_autoptr(GPtrArray) changes = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (result); i++) {
-        JsonNode *node = json_array_get_element (result, i);
+    if (_snapd_request_has_item_callback (SNAPD_REQUEST (self)))
+        _snapd_request_report_item (SNAPD_REQUEST (self), G_OBJECT (change));
+    else
+        g_ptr_array_add (self->changes, g_steal_pointer (&change));
 
-        SnapdChange *change = _snapd_json_parse_change (node, error);
-        if (change == NULL)
-            return FALSE;
+    return TRUE;
+}
 
-        g_ptr_array_add (changes, change);
-    }
+static gboolean
+parse_get_changes_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    SnapdGetChanges *self = SNAPD_GET_CHANGES (request);
 
-    self->changes = g_steal_pointer (&changes);
+    g_clear_pointer (&self->changes, g_ptr_array_unref);
+    self->changes = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(JsonObject) response = _snapd_json_parse_array_response (content_type, body, maintenance, parse_change, self, error);
+    if (response == NULL) {
+        g_clear_pointer (&self->changes, g_ptr_array_unref);
+        return FALSE;
+    }
 
     return TRUE;
 }
@@ -71,7 +71,7 @@ _snapd_get_connections_get_undesired (SnapdGetConnections *self)
     return self->undesired;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_connections_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetConnections *self = SNAPD_GET_CONNECTIONS (request);
@@ -84,7 +84,7 @@ generate_get_connections_request (SnapdRequest *request, GBytes **body)
     if (self->select != NULL)
         g_ptr_array_add (query_attributes, g_strdup_printf ("select=%s", self->select));
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/connections");
+    g_autoptr(GString) path = g_string_new ("/v2/connections");
     if (query_attributes->len > 0) {
         g_string_append_c (path, '?');
         for (guint i = 0; i < query_attributes->len; i++) {
@@ -94,7 +94,7 @@ generate_get_connections_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -11,6 +11,8 @@
 
 #include "snapd-error.h"
 #include "snapd-json.h"
+#include "snapd-markdown-parser.h"
+#include "snapd-snap-private.h"
 
 struct _SnapdGetFind
 {
@@ -22,6 +24,17 @@ struct _SnapdGetFind
     gchar *section;
     gchar *scope;
     gchar *suggested_currency;
+    SnapdSnapFields fields;
+    guint offset;
+    guint limit;
+    guint total;
+    /* Parser for descriptions while a response is parsed, if they are requested as markdown */
+    gboolean parse_descriptions;
+    SnapdMarkdownParser *markdown_parser;
+    /* Response kept for paged requests, so other pages can be parsed from it */
+    gchar *content_type;
+    GBytes *body;
+    SnapdArena *arena;
     GPtrArray *snaps;
 };
 
@@ -81,19 +94,66 @@ _snapd_get_find_set_scope (SnapdGetFind *self, const gchar *scope)
     self->scope = g_strdup (scope);
 }
 
+void
+_snapd_get_find_set_fields (SnapdGetFind *self, SnapdSnapFields fields)
+{
+    self->fields = fields;
+    _snapd_request_set_partial_response (SNAPD_REQUEST (self), fields != SNAPD_SNAP_FIELDS_ALL);
+}
+
+void
+_snapd_get_find_set_range (SnapdGetFind *self, guint offset, guint limit)
+{
+    self->offset = offset;
+    self->limit = limit;
+}
+
+void
+_snapd_get_find_set_parse_descriptions (SnapdGetFind *self, gboolean parse_descriptions)
+{
+    self->parse_descriptions = parse_descriptions;
+}
+
+SnapdSnapFields
+_snapd_get_find_get_fields (SnapdGetFind *self)
+{
+    return self->fields;
+}
+
+static gboolean parse_page (SnapdGetFind *self, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error);
+
 GPtrArray *
 _snapd_get_find_get_snaps (SnapdGetFind *self)
+{
+    /* Responses copied from a paged request are only parsed when used */
+    if (self->snaps == NULL && self->body != NULL) {
+        if (!parse_page (self, self->content_type, self->body, NULL, NULL))
+            self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    }
+
+    return self->snaps;
+}
+
+/* Get the snaps without parsing a copied response, or %NULL if they haven't been parsed */
+GPtrArray *
+_snapd_get_find_get_parsed_snaps (SnapdGetFind *self)
 {
     return self->snaps;
 }
 
+guint
+_snapd_get_find_get_total (SnapdGetFind *self)
+{
+    return self->total;
+}
+
 const gchar *
 _snapd_get_find_get_suggested_currency (SnapdGetFind *self)
 {
     return self->suggested_currency;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_find_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetFind *self = SNAPD_GET_FIND (request);
@@ -130,7 +190,7 @@ generate_get_find_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup (attr->str));
     }
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/find");
+    g_autoptr(GString) path = g_string_new ("/v2/find");
     if (query_attributes->len > 0) {
         g_string_append_c (path, '?');
         for (guint i = 0; i < query_attributes->len; i++) {
@@ -140,7 +200,62 @@ generate_get_find_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
+}
+
+/* Snaps shared between requests may already have been parsed by another one */
+static void
+parse_description (SnapdMarkdownParser *parser, SnapdSnap *snap)
+{
+    if (snapd_snap_get_description_nodes (snap) != NULL)
+        return;
+
+    const gchar *description = snapd_snap_get_description (snap);
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (parser, description != NULL ? description : "");
+    _snapd_snap_set_description_nodes (snap, nodes);
+}
+
+static gboolean
+parse_snap (JsonNode *node, gpointer user_data, GError **error)
+{
+    SnapdGetFind *self = user_data;
+
+    g_autoptr(SnapdSnap) snap = _snapd_request_parse_snap (SNAPD_REQUEST (self), node, self->fields, self->arena, error);
+    if (snap == NULL)
+        return FALSE;
+
+    if (self->markdown_parser != NULL)
+        parse_description (self->markdown_parser, snap);
+
+    if (_snapd_request_has_item_callback (SNAPD_REQUEST (self)))
+        _snapd_request_report_item (SNAPD_REQUEST (self), G_OBJECT (snap));
+    else
+        g_ptr_array_add (self->snaps, g_steal_pointer (&snap));
+
+    return TRUE;
+}
+
+/* Parse the snaps in the requested range of @body */
+static gboolean
+parse_page (SnapdGetFind *self, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    /* The snaps share one arena for their strings, each holding a reference */
+    self->arena = _snapd_arena_new ();
+    if (self->parse_descriptions)
+        self->markdown_parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    g_autoptr(JsonObject) response = _snapd_json_parse_array_response_range (content_type, body, maintenance, self->offset, self->limit, &self->total, parse_snap, self, error);
+    g_clear_pointer (&self->arena, _snapd_arena_unref);
+    g_clear_object (&self->markdown_parser);
+    if (response == NULL) {
+        g_clear_pointer (&self->snaps, g_ptr_array_unref);
+        return FALSE;
+    }
+    g_free (self->suggested_currency);
+    self->suggested_currency = g_strdup (_snapd_json_get_string (response, "suggested-currency", NULL));
+
+    return TRUE;
 }
 
 static gboolean
@@ -148,29 +263,50 @@ parse_get_find_response (SnapdRequest *request, guint status_code, const gchar *
 {
     SnapdGetFind *self = SNAPD_GET_FIND (request);
 
-    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
-    if (response == NULL)
-        return FALSE;
-    g_autoptr(JsonArray) result = _snapd_json_get_sync_result_a (response, error);
-    if (result == NULL)
+    if (!parse_page (self, content_type, body, maintenance, error))
         return FALSE;
+    _snapd_request_store_response (request, body);
+
+    /* snapd returns every result, so keep them for the other pages */
+    if (self->limit > 0) {
+        self->content_type = g_strdup (content_type);
+        self->body = g_bytes_ref (body);
+    }
+
+    return TRUE;
+}
 
-    g_autoptr(GPtrArray) snaps = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (result); i++) {
-        JsonNode *node = json_array_get_element (result, i);
-        SnapdSnap *snap;
+static void
+copy_get_find_response (SnapdRequest *request, SnapdRequest *source_request)
+{
+    SnapdGetFind *self = SNAPD_GET_FIND (request);
+    SnapdGetFind *source = SNAPD_GET_FIND (source_request);
 
-        snap = _snapd_json_parse_snap (node, error);
-        if (snap == NULL)
-            return FALSE;
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    g_free (self->suggested_currency);
+    self->suggested_currency = g_strdup (source->suggested_currency);
+    self->total = source->total;
 
-        g_ptr_array_add (snaps, snap);
+    if (source->body != NULL) {
+        g_free (self->content_type);
+        self->content_type = g_strdup (source->content_type);
+        g_clear_pointer (&self->body, g_bytes_unref);
+        self->body = g_bytes_ref (source->body);
+        return;
     }
 
-    self->snaps = g_steal_pointer (&snaps);
-    self->suggested_currency = g_strdup (_snapd_json_get_string (response, "suggested-currency", NULL));
+    /* The source has every result */
+    self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    guint limit = self->limit > 0 ? self->limit : G_MAXUINT;
+    for (guint i = self->offset; source->snaps != NULL && i < source->snaps->len && i - self->offset < limit; i++)
+        g_ptr_array_add (self->snaps, g_object_ref (g_ptr_array_index (source->snaps, i)));
 
-    return TRUE;
+    /* The source may not have parsed the descriptions */
+    if (self->parse_descriptions) {
+        g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+        for (guint i = 0; i < self->snaps->len; i++)
+            parse_description (parser, g_ptr_array_index (self->snaps, i));
+    }
 }
 
 static void
@@ -185,6 +321,8 @@ snapd_get_find_finalize (GObject *object)
     g_free (self->section);
     g_free (self->scope);
     g_free (self->suggested_currency);
+    g_free (self->content_type);
+    g_clear_pointer (&self->body, g_bytes_unref);
     g_clear_pointer (&self->snaps, g_ptr_array_unref);
 
     G_OBJECT_CLASS (snapd_get_find_parent_class)->finalize (object);
@@ -198,10 +336,12 @@ snapd_get_find_class_init (SnapdGetFindClass *klass)
 
    request_class->generate_request = generate_get_find_request;
    request_class->parse_response = parse_get_find_response;
+   request_class->copy_response = copy_get_find_response;
    gobject_class->finalize = snapd_get_find_finalize;
 }
 
 static void
 snapd_get_find_init (SnapdGetFind *self)
 {
+    self->fields = SNAPD_SNAP_FIELDS_ALL;
 }
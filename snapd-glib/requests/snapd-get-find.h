@@ -12,6 +12,8 @@
 
 #include "snapd-request.h"
 
+#include "snapd-snap.h"
+
 G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (SnapdGetFind, snapd_get_find, SNAPD, GET_FIND, SnapdRequest)
@@ -38,8 +40,24 @@ void          _snapd_get_find_set_section            (SnapdGetFind        *reque
 void          _snapd_get_find_set_scope              (SnapdGetFind        *request,
                                                       const gchar         *scope);
 
+void          _snapd_get_find_set_fields             (SnapdGetFind        *request,
+                                                      SnapdSnapFields      fields);
+
+void          _snapd_get_find_set_range              (SnapdGetFind        *request,
+                                                      guint                offset,
+                                                      guint                limit);
+
+void          _snapd_get_find_set_parse_descriptions (SnapdGetFind        *request,
+                                                      gboolean             parse_descriptions);
+
+SnapdSnapFields _snapd_get_find_get_fields           (SnapdGetFind        *request);
+
 GPtrArray    *_snapd_get_find_get_snaps              (SnapdGetFind        *request);
 
+GPtrArray    *_snapd_get_find_get_parsed_snaps       (SnapdGetFind        *request);
+
+guint         _snapd_get_find_get_total              (SnapdGetFind        *request);
+
 const gchar  *_snapd_get_find_get_suggested_currency (SnapdGetFind        *request);
 
 G_END_DECLS
@@ -7,6 +7,9 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <string.h>
+#include <glib/gstdio.h>
+
 #include "snapd-get-icon.h"
 
 #include "snapd-error.h"
@@ -17,8 +20,15 @@ struct _SnapdGetIcon
     SnapdRequest parent_instance;
     gchar *name;
     SnapdIcon *icon;
+
+    /* Directory icons for this snap are cached in, and the file for this revision of the snap */
+    gchar *cache_dir;
+    gchar *cache_file;
 };
 
+/* Suffix of cached icon files, so only those are removed from the cache directory */
+#define CACHE_FILE_SUFFIX ".icon"
+
 G_DEFINE_TYPE (SnapdGetIcon, snapd_get_icon, snapd_request_get_type ())
 
 SnapdGetIcon *
@@ -34,22 +44,103 @@ _snapd_get_icon_new (const gchar *name, GCancellable *cancellable, GAsyncReadyCa
     return self;
 }
 
+/* Check a name can be used as a path component without leaving the cache directory */
+static gboolean
+is_valid_cache_name (const gchar *name)
+{
+    return name != NULL && name[0] != '\0' && name[0] != '.' && strchr (name, '/') == NULL;
+}
+
+void
+_snapd_get_icon_set_cache (SnapdGetIcon *self, const gchar *cache_path, const gchar *revision)
+{
+    g_clear_pointer (&self->cache_dir, g_free);
+    g_clear_pointer (&self->cache_file, g_free);
+    if (cache_path == NULL || !is_valid_cache_name (self->name) || !is_valid_cache_name (revision))
+        return;
+
+    self->cache_dir = g_build_filename (cache_path, self->name, NULL);
+    self->cache_file = g_strconcat (revision, CACHE_FILE_SUFFIX, NULL);
+}
+
+/* Cached icons are stored as the MIME type on the first line followed by the icon data */
+gboolean
+_snapd_get_icon_load_cache (SnapdGetIcon *self)
+{
+    if (self->cache_dir == NULL)
+        return FALSE;
+
+    g_autofree gchar *path = g_build_filename (self->cache_dir, self->cache_file, NULL);
+    g_autoptr(GMappedFile) file = g_mapped_file_new (path, FALSE, NULL);
+    if (file == NULL)
+        return FALSE;
+
+    const gchar *contents = g_mapped_file_get_contents (file);
+    gsize length = g_mapped_file_get_length (file);
+    const gchar *line_end = contents != NULL ? memchr (contents, '\n', length) : NULL;
+    if (line_end == NULL)
+        return FALSE;
+
+    g_autofree gchar *mime_type = g_strndup (contents, line_end - contents);
+    g_autoptr(GBytes) file_data = g_mapped_file_get_bytes (file);
+    gsize offset = line_end - contents + 1;
+    g_autoptr(GBytes) data = g_bytes_new_from_bytes (file_data, offset, length - offset);
+    self->icon = g_object_new (SNAPD_TYPE_ICON,
+                               "mime-type", mime_type,
+                               "data", data,
+                               NULL);
+
+    return TRUE;
+}
+
+/* Store an icon, removing icons for other revisions and leaving any other files. Failures are ignored as the icon can be retrieved again */
+static void
+save_cache (SnapdGetIcon *self, const gchar *mime_type, GBytes *data)
+{
+    if (self->cache_dir == NULL || mime_type == NULL)
+        return;
+
+    if (g_mkdir_with_parents (self->cache_dir, 0700) != 0)
+        return;
+
+    g_autoptr(GDir) dir = g_dir_open (self->cache_dir, 0, NULL);
+    if (dir != NULL) {
+        const gchar *name;
+        while ((name = g_dir_read_name (dir)) != NULL) {
+            if (g_str_has_suffix (name, CACHE_FILE_SUFFIX) && strcmp (name, self->cache_file) != 0) {
+                g_autofree gchar *old_path = g_build_filename (self->cache_dir, name, NULL);
+                g_unlink (old_path);
+            }
+        }
+    }
+
+    gsize data_length;
+    const gchar *data_contents = g_bytes_get_data (data, &data_length);
+    g_autoptr(GString) contents = g_string_sized_new (strlen (mime_type) + 1 + data_length);
+    g_string_append (contents, mime_type);
+    g_string_append_c (contents, '\n');
+    g_string_append_len (contents, data_contents, data_length);
+
+    g_autofree gchar *path = g_build_filename (self->cache_dir, self->cache_file, NULL);
+    g_file_set_contents (path, contents->str, contents->len, NULL);
+}
+
 SnapdIcon *
 _snapd_get_icon_get_icon (SnapdGetIcon *self)
 {
     return self->icon;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_icon_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetIcon *self = SNAPD_GET_ICON (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/icons/");
+    g_autoptr(GString) path = g_string_new ("/v2/icons/");
     g_string_append_uri_escaped (path, self->name, NULL, TRUE);
     g_string_append (path, "/icon");
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -84,12 +175,22 @@ parse_get_icon_response (SnapdRequest *request, guint status_code, const gchar *
                                               "mime-type", content_type,
                                               "data", body,
                                               NULL);
+    save_cache (self, content_type, body);
 
     self->icon = g_steal_pointer (&icon);
 
     return TRUE;
 }
 
+static void
+copy_get_icon_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetIcon *self = SNAPD_GET_ICON (request);
+    SnapdGetIcon *s = SNAPD_GET_ICON (source);
+
+    g_set_object (&self->icon, s->icon);
+}
+
 static void
 snapd_get_icon_finalize (GObject *object)
 {
@@ -97,6 +198,8 @@ snapd_get_icon_finalize (GObject *object)
 
     g_clear_pointer (&self->name, g_free);
     g_clear_object (&self->icon);
+    g_clear_pointer (&self->cache_dir, g_free);
+    g_clear_pointer (&self->cache_file, g_free);
 
     G_OBJECT_CLASS (snapd_get_icon_parent_class)->finalize (object);
 }
@@ -109,6 +212,7 @@ snapd_get_icon_class_init (SnapdGetIconClass *klass)
 
    request_class->generate_request = generate_get_icon_request;
    request_class->parse_response = parse_get_icon_response;
+   request_class->copy_response = copy_get_icon_response;
    gobject_class->finalize = snapd_get_icon_finalize;
 }
 
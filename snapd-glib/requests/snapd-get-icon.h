@@ -23,6 +23,12 @@ SnapdGetIcon *_snapd_get_icon_new      (const gchar         *name,
                                         GAsyncReadyCallback  callback,
                                         gpointer             user_data);
 
+void          _snapd_get_icon_set_cache (SnapdGetIcon *request,
+                                         const gchar  *cache_path,
+                                         const gchar  *revision);
+
+gboolean      _snapd_get_icon_load_cache (SnapdGetIcon *request);
+
 SnapdIcon    *_snapd_get_icon_get_icon (SnapdGetIcon *request);
 
 G_END_DECLS
@@ -47,10 +47,10 @@ _snapd_get_interfaces_legacy_get_slots (SnapdGetInterfacesLegacy *self)
     return self->slots;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_interfaces_legacy_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/interfaces");
+    return _snapd_http_request_new ("GET", "/v2/interfaces");
 }
 
 static gboolean
@@ -94,6 +94,28 @@ parse_get_interfaces_legacy_response (SnapdRequest *request, guint status_code,
     return TRUE;
 }
 
+static GPtrArray *
+copy_object_array (GPtrArray *array)
+{
+    GPtrArray *copy = g_ptr_array_new_full (array->len, g_object_unref);
+    for (guint i = 0; i < array->len; i++)
+        g_ptr_array_add (copy, g_object_ref (g_ptr_array_index (array, i)));
+    return copy;
+}
+
+static void
+copy_get_interfaces_legacy_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetInterfacesLegacy *self = SNAPD_GET_INTERFACES_LEGACY (request);
+    SnapdGetInterfacesLegacy *s = SNAPD_GET_INTERFACES_LEGACY (source);
+
+    /* Share the plugs and slots, but not the arrays as callers can modify them */
+    g_clear_pointer (&self->plugs, g_ptr_array_unref);
+    self->plugs = copy_object_array (s->plugs);
+    g_clear_pointer (&self->slots, g_ptr_array_unref);
+    self->slots = copy_object_array (s->slots);
+}
+
 static void
 snapd_get_interfaces_legacy_finalize (GObject *object)
 {
@@ -113,6 +135,7 @@ snapd_get_interfaces_legacy_class_init (SnapdGetInterfacesLegacyClass *klass)
 
    request_class->generate_request = generate_get_interfaces_legacy_request;
    request_class->parse_response = parse_get_interfaces_legacy_response;
+   request_class->copy_response = copy_get_interfaces_legacy_response;
    gobject_class->finalize = snapd_get_interfaces_legacy_finalize;
 }
 
@@ -24,6 +24,9 @@ struct _SnapdGetInterfaces
     gboolean include_slots;
     gboolean only_connected;
 
+    /* TRUE if the client adds documentation from its cache instead of requesting it */
+    gboolean fill_docs;
+
     GPtrArray *interfaces;
 };
 
@@ -68,13 +71,43 @@ _snapd_get_interfaces_set_only_connected (SnapdGetInterfaces *self, gboolean onl
     self->only_connected = only_connected;
 }
 
+gchar **
+_snapd_get_interfaces_get_names (SnapdGetInterfaces *self)
+{
+    return self->names;
+}
+
+gboolean
+_snapd_get_interfaces_get_include_docs (SnapdGetInterfaces *self)
+{
+    return self->include_docs;
+}
+
+gboolean
+_snapd_get_interfaces_get_only_connected (SnapdGetInterfaces *self)
+{
+    return self->only_connected;
+}
+
+void
+_snapd_get_interfaces_set_fill_docs (SnapdGetInterfaces *self, gboolean fill_docs)
+{
+    self->fill_docs = fill_docs;
+}
+
+gboolean
+_snapd_get_interfaces_get_fill_docs (SnapdGetInterfaces *self)
+{
+    return self->fill_docs;
+}
+
 GPtrArray *
 _snapd_get_interfaces_get_interfaces (SnapdGetInterfaces *self)
 {
     return self->interfaces;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_interfaces_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetInterfaces *self = SNAPD_GET_INTERFACES (request);
@@ -92,14 +125,14 @@ generate_get_interfaces_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup ("slots=true"));
     g_ptr_array_add (query_attributes, g_strdup_printf ("select=%s", self->only_connected ? "connected" : "all"));
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/interfaces?");
+    g_autoptr(GString) path = g_string_new ("/v2/interfaces?");
     for (guint i = 0; i < query_attributes->len; i++) {
         if (i != 0)
             g_string_append_c (path, '&');
         g_string_append (path, (gchar *) query_attributes->pdata[i]);
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -131,6 +164,19 @@ parse_get_interfaces_response (SnapdRequest *request, guint status_code, const g
     return TRUE;
 }
 
+static void
+copy_get_interfaces_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetInterfaces *self = SNAPD_GET_INTERFACES (request);
+    SnapdGetInterfaces *s = SNAPD_GET_INTERFACES (source);
+
+    /* Share the interfaces, but not the array as callers can modify it */
+    g_clear_pointer (&self->interfaces, g_ptr_array_unref);
+    self->interfaces = g_ptr_array_new_full (s->interfaces->len, g_object_unref);
+    for (guint i = 0; i < s->interfaces->len; i++)
+        g_ptr_array_add (self->interfaces, g_object_ref (g_ptr_array_index (s->interfaces, i)));
+}
+
 static void
 snapd_get_interfaces_finalize (GObject *object)
 {
@@ -150,6 +196,7 @@ snapd_get_interfaces_class_init (SnapdGetInterfacesClass *klass)
 
    request_class->generate_request = generate_get_interfaces_request;
    request_class->parse_response = parse_get_interfaces_response;
+   request_class->copy_response = copy_get_interfaces_response;
    gobject_class->finalize = snapd_get_interfaces_finalize;
 }
 
@@ -33,6 +33,17 @@ void                _snapd_get_interfaces_set_include_slots  (SnapdGetInterfaces
 void                _snapd_get_interfaces_set_only_connected (SnapdGetInterfaces  *request,
                                                               gboolean             only_connected);
 
+gchar             **_snapd_get_interfaces_get_names          (SnapdGetInterfaces  *request);
+
+gboolean            _snapd_get_interfaces_get_include_docs   (SnapdGetInterfaces  *request);
+
+gboolean            _snapd_get_interfaces_get_only_connected (SnapdGetInterfaces  *request);
+
+void                _snapd_get_interfaces_set_fill_docs      (SnapdGetInterfaces  *request,
+                                                              gboolean             fill_docs);
+
+gboolean            _snapd_get_interfaces_get_fill_docs      (SnapdGetInterfaces  *request);
+
 GPtrArray          *_snapd_get_interfaces_get_interfaces     (SnapdGetInterfaces  *request);
 
 G_END_DECLS
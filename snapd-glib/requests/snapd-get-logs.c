@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-get-logs.h"
+
+#include "snapd-error.h"
+#include "snapd-json.h"
+
+/* Longest log record accepted, so a stream without record separators can't use unbounded memory */
+#define MAX_RECORD_SIZE (1024 * 1024)
+
+/* Start of each record in a application/json-seq stream (RFC 7464) */
+#define RECORD_SEPARATOR '\x1e'
+
+struct _SnapdGetLogs
+{
+    SnapdRequest parent_instance;
+    GStrv names;
+    gint n;
+    gboolean follow;
+    GPtrArray *logs;
+
+    /* Data received but not yet reported when streaming, and how much of it has been checked for the end of a record */
+    gboolean streaming;
+    GByteArray *pending;
+    gsize pending_scanned;
+};
+
+G_DEFINE_TYPE (SnapdGetLogs, snapd_get_logs, snapd_request_get_type ())
+
+SnapdGetLogs *
+_snapd_get_logs_new (GStrv names, gint n, gboolean follow, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (g_object_new (snapd_get_logs_get_type (),
+                                                       "cancellable", cancellable,
+                                                       "ready-callback", callback,
+                                                       "ready-callback-data", user_data,
+                                                       NULL));
+    if (names != NULL && names[0] != NULL)
+        self->names = g_strdupv (names);
+    self->n = n;
+    self->follow = follow;
+
+    return self;
+}
+
+gboolean
+_snapd_get_logs_get_follow (SnapdGetLogs *self)
+{
+    return self->follow;
+}
+
+GPtrArray *
+_snapd_get_logs_get_logs (SnapdGetLogs *self)
+{
+    return self->logs;
+}
+
+static SnapdHttpRequest *
+generate_get_logs_request (SnapdRequest *request, GBytes **body)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (request);
+
+    g_autoptr(GPtrArray) query_attributes = g_ptr_array_new_with_free_func (g_free);
+    if (self->names != NULL) {
+        g_autoptr(GString) attr = g_string_new ("names=");
+        for (guint i = 0; self->names[i] != NULL; i++) {
+            if (i != 0)
+                g_string_append (attr, ",");
+            g_string_append_uri_escaped (attr, self->names[i], NULL, TRUE);
+        }
+        g_ptr_array_add (query_attributes, g_strdup (attr->str));
+    }
+    if (self->n != 0)
+        g_ptr_array_add (query_attributes, g_strdup_printf ("n=%d", self->n));
+    if (self->follow)
+        g_ptr_array_add (query_attributes, g_strdup ("follow=true"));
+
+    g_autoptr(GString) path = g_string_new ("/v2/logs");
+    if (query_attributes->len > 0) {
+        g_string_append_c (path, '?');
+        for (guint i = 0; i < query_attributes->len; i++) {
+            if (i != 0)
+                g_string_append_c (path, '&');
+            g_string_append (path, (gchar *) query_attributes->pdata[i]);
+        }
+    }
+
+    return _snapd_http_request_new ("GET", path->str);
+}
+
+/* Parse one record, which may be surrounded by separators and whitespace.
+ * Returns %NULL without setting @error if the record is empty */
+static SnapdLog *
+parse_record (const gchar *data, gsize length, GError **error)
+{
+    while (length > 0 && (data[0] == RECORD_SEPARATOR || g_ascii_isspace (data[0]))) {
+        data++;
+        length--;
+    }
+    while (length > 0 && g_ascii_isspace (data[length - 1]))
+        length--;
+    if (length == 0)
+        return NULL;
+
+    g_autoptr(JsonParser) parser = json_parser_new ();
+    g_autoptr(GError) error_local = NULL;
+    if (!json_parser_load_from_data (parser, data, length, &error_local)) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_BAD_RESPONSE,
+                     "Unable to parse log record: %s", error_local->message);
+        return NULL;
+    }
+
+    return _snapd_json_parse_log (json_parser_get_root (parser), error);
+}
+
+/* Parse all the records in @data, which are each ended by a newline */
+static gboolean
+parse_records (const gchar *data, gsize data_length, gsize *n_used, GPtrArray *logs, SnapdRequest *request, GError **error)
+{
+    gsize offset = 0;
+    while (offset < data_length) {
+        const gchar *newline = memchr (data + offset, '\n', data_length - offset);
+        if (newline == NULL)
+            break;
+        gsize record_end = newline - data;
+
+        g_autoptr(GError) error_local = NULL;
+        g_autoptr(SnapdLog) log = parse_record (data + offset, record_end - offset, &error_local);
+        if (error_local != NULL) {
+            g_propagate_error (error, g_steal_pointer (&error_local));
+            return FALSE;
+        }
+        if (log != NULL) {
+            if (logs != NULL)
+                g_ptr_array_add (logs, g_object_ref (log));
+            else
+                _snapd_request_report_item (request, G_OBJECT (log));
+        }
+
+        offset = record_end + 1;
+    }
+
+    *n_used = offset;
+    return TRUE;
+}
+
+static void
+parse_get_logs_headers (SnapdRequest *request, guint status_code, SoupMessageHeaders *headers)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (request);
+
+    /* Records are reported as they arrive, as a followed stream never ends */
+    const gchar *content_type = soup_message_headers_get_content_type (headers, NULL);
+    self->streaming = _snapd_request_has_item_callback (request) &&
+                      status_code == SOUP_STATUS_OK &&
+                      g_strcmp0 (content_type, "application/json-seq") == 0;
+    _snapd_request_set_write_response (request, self->streaming);
+}
+
+static gboolean
+write_get_logs_response (SnapdRequest *request, const guint8 *data, gsize length, GError **error)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (request);
+
+    if (self->pending == NULL)
+        self->pending = g_byte_array_new ();
+    g_byte_array_append (self->pending, data, length);
+
+    /* Only search the new data for the end of a record */
+    if (memchr (self->pending->data + self->pending_scanned, '\n', self->pending->len - self->pending_scanned) == NULL) {
+        self->pending_scanned = self->pending->len;
+        if (self->pending->len > MAX_RECORD_SIZE) {
+            g_set_error (error,
+                         SNAPD_ERROR,
+                         SNAPD_ERROR_BAD_RESPONSE,
+                         "Log record exceeds %d bytes", MAX_RECORD_SIZE);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    gsize n_used = 0;
+    if (!parse_records ((const gchar *) self->pending->data, self->pending->len, &n_used, NULL, request, error))
+        return FALSE;
+    g_byte_array_remove_range (self->pending, 0, n_used);
+    self->pending_scanned = self->pending->len;
+
+    return TRUE;
+}
+
+static gboolean
+parse_get_logs_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (request);
+
+    if (g_strcmp0 (content_type, "application/json-seq") != 0) {
+        g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+        if (response == NULL)
+            return FALSE;
+        g_autoptr(JsonNode) result = _snapd_json_get_sync_result (response, error);
+        if (result == NULL)
+            return FALSE;
+
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "Unknown response");
+        return FALSE;
+    }
+
+    /* Report the last record, which may not have a newline after it */
+    if (self->streaming) {
+        if (self->pending != NULL && self->pending->len > 0) {
+            g_autoptr(GError) error_local = NULL;
+            g_autoptr(SnapdLog) log = parse_record ((const gchar *) self->pending->data, self->pending->len, &error_local);
+            if (error_local != NULL) {
+                g_propagate_error (error, g_steal_pointer (&error_local));
+                return FALSE;
+            }
+            if (log != NULL)
+                _snapd_request_report_item (request, G_OBJECT (log));
+        }
+        return TRUE;
+    }
+
+    g_autoptr(GPtrArray) logs = g_ptr_array_new_with_free_func (g_object_unref);
+    gsize data_length, n_used = 0;
+    const gchar *data = g_bytes_get_data (body, &data_length);
+    if (!parse_records (data, data_length, &n_used, logs, request, error))
+        return FALSE;
+    if (n_used < data_length) {
+        g_autoptr(GError) error_local = NULL;
+        g_autoptr(SnapdLog) log = parse_record (data + n_used, data_length - n_used, &error_local);
+        if (error_local != NULL) {
+            g_propagate_error (error, g_steal_pointer (&error_local));
+            return FALSE;
+        }
+        if (log != NULL)
+            g_ptr_array_add (logs, g_steal_pointer (&log));
+    }
+
+    if (_snapd_request_has_item_callback (request)) {
+        for (guint i = 0; i < logs->len; i++)
+            _snapd_request_report_item (request, g_ptr_array_index (logs, i));
+    }
+    else
+        self->logs = g_steal_pointer (&logs);
+
+    return TRUE;
+}
+
+static void
+snapd_get_logs_finalize (GObject *object)
+{
+    SnapdGetLogs *self = SNAPD_GET_LOGS (object);
+
+    g_clear_pointer (&self->names, g_strfreev);
+    g_clear_pointer (&self->logs, g_ptr_array_unref);
+    g_clear_pointer (&self->pending, g_byte_array_unref);
+
+    G_OBJECT_CLASS (snapd_get_logs_parent_class)->finalize (object);
+}
+
+static void
+snapd_get_logs_class_init (SnapdGetLogsClass *klass)
+{
+   SnapdRequestClass *request_class = SNAPD_REQUEST_CLASS (klass);
+   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+   request_class->generate_request = generate_get_logs_request;
+   request_class->parse_headers = parse_get_logs_headers;
+   request_class->parse_response = parse_get_logs_response;
+   request_class->write_response = write_get_logs_response;
+   gobject_class->finalize = snapd_get_logs_finalize;
+}
+
+static void
+snapd_get_logs_init (SnapdGetLogs *self)
+{
+}
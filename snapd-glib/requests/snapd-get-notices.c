@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-get-notices.h"
+
+#include "snapd-error.h"
+#include "snapd-json.h"
+
+struct _SnapdGetNotices
+{
+    SnapdRequest parent_instance;
+    gchar *types;
+    gchar *after;
+    gchar *timeout;
+    GPtrArray *notices;
+    gchar *last_repeated;
+};
+
+G_DEFINE_TYPE (SnapdGetNotices, snapd_get_notices, snapd_request_get_type ())
+
+SnapdGetNotices *
+_snapd_get_notices_new (const gchar *types, const gchar *after, const gchar *timeout, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdGetNotices *self = SNAPD_GET_NOTICES (g_object_new (snapd_get_notices_get_type (),
+                                                             "cancellable", cancellable,
+                                                             "ready-callback", callback,
+                                                             "ready-callback-data", user_data,
+                                                             NULL));
+    self->types = g_strdup (types);
+    self->after = g_strdup (after);
+    self->timeout = g_strdup (timeout);
+
+    return self;
+}
+
+GPtrArray *
+_snapd_get_notices_get_notices (SnapdGetNotices *self)
+{
+    return self->notices;
+}
+
+const gchar *
+_snapd_get_notices_get_last_repeated (SnapdGetNotices *self)
+{
+    return self->last_repeated;
+}
+
+static void
+add_query_attribute (GPtrArray *query_attributes, const gchar *name, const gchar *value)
+{
+    if (value == NULL)
+        return;
+
+    g_autoptr(GString) attr = g_string_new (name);
+    g_string_append_c (attr, '=');
+    g_string_append_uri_escaped (attr, value, NULL, TRUE);
+    g_ptr_array_add (query_attributes, g_strdup (attr->str));
+}
+
+static SnapdHttpRequest *
+generate_get_notices_request (SnapdRequest *request, GBytes **body)
+{
+    SnapdGetNotices *self = SNAPD_GET_NOTICES (request);
+
+    g_autoptr(GPtrArray) query_attributes = g_ptr_array_new_with_free_func (g_free);
+    add_query_attribute (query_attributes, "types", self->types);
+    add_query_attribute (query_attributes, "after", self->after);
+    add_query_attribute (query_attributes, "timeout", self->timeout);
+
+    g_autoptr(GString) path = g_string_new ("/v2/notices");
+    for (guint i = 0; i < query_attributes->len; i++) {
+        g_string_append_c (path, i == 0 ? '?' : '&');
+        g_string_append (path, (gchar *) query_attributes->pdata[i]);
+    }
+
+    return _snapd_http_request_new ("GET", path->str);
+}
+
+static gboolean
+parse_get_notices_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    SnapdGetNotices *self = SNAPD_GET_NOTICES (request);
+
+    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+    if (response == NULL)
+        return FALSE;
+    g_autoptr(JsonArray) result = _snapd_json_get_sync_result_a (response, error);
+    if (result == NULL)
+        return FALSE;
+
+    g_autoptr(GPtrArray) notices = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autofree gchar *last_repeated = NULL;
+    for (guint i = 0; i < json_array_get_length (result); i++) {
+        JsonNode *node = json_array_get_element (result, i);
+
+        SnapdNotice *notice = _snapd_json_parse_notice (node, error);
+        if (notice == NULL)
+            return FALSE;
+        g_ptr_array_add (notices, notice);
+
+        /* Keep the original timestamp as it has more precision than a GDateTime.
+         * Timestamps are in RFC 3339 format so the latest sorts last */
+        const gchar *repeated = _snapd_json_get_string (json_node_get_object (node), "last-repeated", NULL);
+        if (repeated != NULL && g_strcmp0 (repeated, last_repeated) > 0) {
+            g_free (last_repeated);
+            last_repeated = g_strdup (repeated);
+        }
+    }
+
+    self->notices = g_steal_pointer (&notices);
+    self->last_repeated = g_steal_pointer (&last_repeated);
+
+    return TRUE;
+}
+
+static void
+snapd_get_notices_finalize (GObject *object)
+{
+    SnapdGetNotices *self = SNAPD_GET_NOTICES (object);
+
+    g_clear_pointer (&self->types, g_free);
+    g_clear_pointer (&self->after, g_free);
+    g_clear_pointer (&self->timeout, g_free);
+    g_clear_pointer (&self->notices, g_ptr_array_unref);
+    g_clear_pointer (&self->last_repeated, g_free);
+
+    G_OBJECT_CLASS (snapd_get_notices_parent_class)->finalize (object);
+}
+
+static void
+snapd_get_notices_class_init (SnapdGetNoticesClass *klass)
+{
+   SnapdRequestClass *request_class = SNAPD_REQUEST_CLASS (klass);
+   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+   request_class->generate_request = generate_get_notices_request;
+   request_class->parse_response = parse_get_notices_response;
+   gobject_class->finalize = snapd_get_notices_finalize;
+}
+
+static void
+snapd_get_notices_init (SnapdGetNotices *self)
+{
+}
@@ -36,10 +36,10 @@ _snapd_get_sections_get_sections (SnapdGetSections *self)
     return self->sections;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_sections_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/sections");
+    return _snapd_http_request_new ("GET", "/v2/sections");
 }
 
 static gboolean
@@ -70,10 +70,21 @@ parse_get_sections_response (SnapdRequest *request, guint status_code, const gch
     g_ptr_array_add (sections, NULL);
 
     self->sections = g_steal_pointer ((GStrv *)&sections->pdata);
+    _snapd_request_store_response (request, body);
 
     return TRUE;
 }
 
+static void
+copy_get_sections_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetSections *self = SNAPD_GET_SECTIONS (request);
+    SnapdGetSections *s = SNAPD_GET_SECTIONS (source);
+
+    g_clear_pointer (&self->sections, g_strfreev);
+    self->sections = g_strdupv (s->sections);
+}
+
 static void
 snapd_get_sections_finalize (GObject *object)
 {
@@ -92,6 +103,7 @@ snapd_get_sections_class_init (SnapdGetSectionsClass *klass)
 
    request_class->generate_request = generate_get_sections_request;
    request_class->parse_response = parse_get_sections_response;
+   request_class->copy_response = copy_get_sections_response;
    gobject_class->finalize = snapd_get_sections_finalize;
 }
 
@@ -10,12 +10,16 @@
 #include "snapd-get-snap-conf.h"
 
 #include "snapd-json.h"
+#include "snapd-snap-config-private.h"
 
 struct _SnapdGetSnapConf
 {
     SnapdRequest parent_instance;
     gchar *name;
     GStrv keys;
+    SnapdSnapConfig *config;
+
+    /* Values converted from the config when first requested */
     GHashTable *conf;
 };
 
@@ -37,12 +41,20 @@ _snapd_get_snap_conf_new (const gchar *name, GStrv keys, GCancellable *cancellab
 }
 
 GHashTable *
-_snapd_get_snap_conf_get_conf (SnapdGetSnapConf *self)
+_snapd_get_snap_conf_get_conf (SnapdGetSnapConf *self, GError **error)
 {
+    if (self->conf == NULL)
+        self->conf = _snapd_json_parse_object (_snapd_snap_config_get_object (self->config), error);
     return self->conf;
 }
 
-static SoupMessage *
+SnapdSnapConfig *
+_snapd_get_snap_conf_get_config (SnapdGetSnapConf *self)
+{
+    return self->config;
+}
+
+static SnapdHttpRequest *
 generate_get_snap_conf_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetSnapConf *self = SNAPD_GET_SNAP_CONF (request);
@@ -53,7 +65,7 @@ generate_get_snap_conf_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup_printf ("keys=%s", keys_list));
     }
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/snaps/");
+    g_autoptr(GString) path = g_string_new ("/v2/snaps/");
     g_string_append_uri_escaped (path, self->name, NULL, TRUE);
     g_string_append (path, "/conf");
     if (query_attributes->len > 0) {
@@ -65,7 +77,7 @@ generate_get_snap_conf_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -80,13 +92,22 @@ parse_get_snap_conf_response (SnapdRequest *request, guint status_code, const gc
     if (result == NULL)
         return FALSE;
 
-    self->conf = _snapd_json_parse_object (result, error);
-    if (self->conf == NULL)
-        return FALSE;
+    self->config = _snapd_snap_config_new (result);
 
     return TRUE;
 }
 
+static void
+copy_get_snap_conf_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetSnapConf *self = SNAPD_GET_SNAP_CONF (request);
+    SnapdGetSnapConf *s = SNAPD_GET_SNAP_CONF (source);
+
+    /* Share the config, the table callers can modify is made from it when needed */
+    g_clear_pointer (&self->conf, g_hash_table_unref);
+    g_set_object (&self->config, s->config);
+}
+
 static void
 snapd_get_snap_conf_finalize (GObject *object)
 {
@@ -94,6 +115,7 @@ snapd_get_snap_conf_finalize (GObject *object)
 
     g_clear_pointer (&self->name, g_free);
     g_clear_pointer (&self->keys, g_strfreev);
+    g_clear_object (&self->config);
     g_clear_pointer (&self->conf, g_hash_table_unref);
 
     G_OBJECT_CLASS (snapd_get_snap_conf_parent_class)->finalize (object);
@@ -107,6 +129,7 @@ snapd_get_snap_conf_class_init (SnapdGetSnapConfClass *klass)
 
    request_class->generate_request = generate_get_snap_conf_request;
    request_class->parse_response = parse_get_snap_conf_response;
+   request_class->copy_response = copy_get_snap_conf_response;
    gobject_class->finalize = snapd_get_snap_conf_finalize;
 }
 
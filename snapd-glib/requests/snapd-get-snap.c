@@ -33,21 +33,34 @@ _snapd_get_snap_new (const gchar *name, GCancellable *cancellable, GAsyncReadyCa
     return self;
 }
 
+const gchar *
+_snapd_get_snap_get_name (SnapdGetSnap *self)
+{
+    return self->name;
+}
+
+/* Use @snap as the response, e.g. from a cache */
+void
+_snapd_get_snap_set_snap (SnapdGetSnap *self, SnapdSnap *snap)
+{
+    g_set_object (&self->snap, snap);
+}
+
 SnapdSnap *
 _snapd_get_snap_get_snap (SnapdGetSnap *self)
 {
     return self->snap;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_snap_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetSnap *self = SNAPD_GET_SNAP (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/snaps/");
+    g_autoptr(GString) path = g_string_new ("/v2/snaps/");
     g_string_append_uri_escaped (path, self->name, NULL, TRUE);
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
@@ -64,7 +77,7 @@ parse_get_snap_response (SnapdRequest *request, guint status_code, const gchar *
     if (result == NULL)
         return FALSE;
 
-    g_autoptr(SnapdSnap) snap = _snapd_json_parse_snap (result, error);
+    g_autoptr(SnapdSnap) snap = _snapd_request_parse_snap (request, result, SNAPD_SNAP_FIELDS_ALL, NULL, error);
     json_node_unref (result);
     if (snap == NULL)
         return FALSE;
@@ -23,7 +23,12 @@ SnapdGetSnap *_snapd_get_snap_new      (const gchar         *name,
                                         GAsyncReadyCallback  callback,
                                         gpointer             user_data);
 
-SnapdSnap    *_snapd_get_snap_get_snap (SnapdGetSnap *request);
+const gchar  *_snapd_get_snap_get_name (SnapdGetSnap        *request);
+
+void          _snapd_get_snap_set_snap (SnapdGetSnap        *request,
+                                        SnapdSnap           *snap);
+
+SnapdSnap    *_snapd_get_snap_get_snap (SnapdGetSnap        *request);
 
 G_END_DECLS
 
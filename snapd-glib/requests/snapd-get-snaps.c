@@ -16,6 +16,8 @@ struct _SnapdGetSnaps
     SnapdRequest parent_instance;
     gchar *select;
     GStrv names;
+    SnapdSnapFields fields;
+    SnapdArena *arena;
     GPtrArray *snaps;
 };
 
@@ -42,13 +44,32 @@ _snapd_get_snaps_set_select (SnapdGetSnaps *self, const gchar *select)
     self->select = g_strdup (select);
 }
 
+void
+_snapd_get_snaps_set_fields (SnapdGetSnaps *self, SnapdSnapFields fields)
+{
+    self->fields = fields;
+    _snapd_request_set_partial_response (SNAPD_REQUEST (self), fields != SNAPD_SNAP_FIELDS_ALL);
+}
+
+const gchar *
+_snapd_get_snaps_get_select (SnapdGetSnaps *self)
+{
+    return self->select;
+}
+
+SnapdSnapFields
+_snapd_get_snaps_get_fields (SnapdGetSnaps *self)
+{
+    return self->fields;
+}
+
 GPtrArray *
 _snapd_get_snaps_get_snaps (SnapdGetSnaps *self)
 {
     return self->snaps;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_snaps_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetSnaps *self = SNAPD_GET_SNAPS (request);
@@ -61,7 +82,7 @@ generate_get_snaps_request (SnapdRequest *request, GBytes **body)
         g_ptr_array_add (query_attributes, g_strdup_printf ("snaps=%s", names_list));
     }
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/snaps");
+    g_autoptr(GString) path = g_string_new ("/v2/snaps");
     if (query_attributes->len > 0) {
         g_string_append_c (path, '?');
         for (guint i = 0; i < query_attributes->len; i++) {
@@ -71,38 +92,58 @@ generate_get_snaps_request (SnapdRequest *request, GBytes **body)
         }
     }
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static gboolean
-parse_get_snaps_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+parse_snap (JsonNode *node, gpointer user_data, GError **error)
 {
-    SnapdGetSnaps *self = SNAPD_GET_SNAPS (request);
+    SnapdGetSnaps *self = user_data;
 
-    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
-    if (response == NULL)
-        return FALSE;
-    g_autoptr(JsonArray) result = _snapd_json_get_sync_result_a (response, error);
-    if (result == NULL)
+    g_autoptr(SnapdSnap) snap = _snapd_request_parse_snap (SNAPD_REQUEST (self), node, self->fields, self->arena, error);
+    if (snap == NULL)
         return FALSE;
 
-    g_autoptr(GPtrArray) snaps = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (result); i++) {
-        JsonNode *node = json_array_get_element (result, i);
-        SnapdSnap *snap;
+    if (_snapd_request_has_item_callback (SNAPD_REQUEST (self)))
+        _snapd_request_report_item (SNAPD_REQUEST (self), G_OBJECT (snap));
+    else
+        g_ptr_array_add (self->snaps, g_steal_pointer (&snap));
+
+    return TRUE;
+}
 
-        snap = _snapd_json_parse_snap (node, error);
-        if (snap == NULL)
-            return FALSE;
+static gboolean
+parse_get_snaps_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    SnapdGetSnaps *self = SNAPD_GET_SNAPS (request);
 
-        g_ptr_array_add (snaps, snap);
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    /* The snaps share one arena for their strings, each holding a reference */
+    self->arena = _snapd_arena_new ();
+    g_autoptr(JsonObject) response = _snapd_json_parse_array_response (content_type, body, maintenance, parse_snap, self, error);
+    g_clear_pointer (&self->arena, _snapd_arena_unref);
+    if (response == NULL) {
+        g_clear_pointer (&self->snaps, g_ptr_array_unref);
+        return FALSE;
     }
 
-    self->snaps = g_steal_pointer (&snaps);
-
     return TRUE;
 }
 
+static void
+copy_get_snaps_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetSnaps *self = SNAPD_GET_SNAPS (request);
+    SnapdGetSnaps *s = SNAPD_GET_SNAPS (source);
+
+    /* Share the snaps, but not the array as callers can modify it */
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    self->snaps = g_ptr_array_new_full (s->snaps->len, g_object_unref);
+    for (guint i = 0; i < s->snaps->len; i++)
+        g_ptr_array_add (self->snaps, g_object_ref (g_ptr_array_index (s->snaps, i)));
+}
+
 static void
 snapd_get_snaps_finalize (GObject *object)
 {
@@ -123,10 +164,12 @@ snapd_get_snaps_class_init (SnapdGetSnapsClass *klass)
 
    request_class->generate_request = generate_get_snaps_request;
    request_class->parse_response = parse_get_snaps_response;
+   request_class->copy_response = copy_get_snaps_response;
    gobject_class->finalize = snapd_get_snaps_finalize;
 }
 
 static void
 snapd_get_snaps_init (SnapdGetSnaps *self)
 {
+    self->fields = SNAPD_SNAP_FIELDS_ALL;
 }
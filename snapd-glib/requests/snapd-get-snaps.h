@@ -12,6 +12,8 @@
 
 #include "snapd-request.h"
 
+#include "snapd-snap.h"
+
 G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (SnapdGetSnaps, snapd_get_snaps, SNAPD, GET_SNAPS, SnapdRequest)
@@ -24,7 +26,14 @@ SnapdGetSnaps *_snapd_get_snaps_new       (GCancellable        *cancellable,
 void          _snapd_get_snaps_set_select (SnapdGetSnaps       *request,
                                            const gchar         *select);
 
-GPtrArray    *_snapd_get_snaps_get_snaps  (SnapdGetSnaps *request);
+void          _snapd_get_snaps_set_fields (SnapdGetSnaps       *request,
+                                           SnapdSnapFields      fields);
+
+const gchar  *_snapd_get_snaps_get_select (SnapdGetSnaps       *request);
+
+SnapdSnapFields _snapd_get_snaps_get_fields (SnapdGetSnaps     *request);
+
+GPtrArray    *_snapd_get_snaps_get_snaps  (SnapdGetSnaps       *request);
 
 G_END_DECLS
 
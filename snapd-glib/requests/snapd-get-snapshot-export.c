@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-get-snapshot-export.h"
+
+#include "snapd-error.h"
+#include "snapd-json.h"
+
+#define SNAPSHOT_CONTENT_TYPE "application/x.snapd.snapshot"
+
+struct _SnapdGetSnapshotExport
+{
+    SnapdRequest parent_instance;
+    gint64 set_id;
+};
+
+G_DEFINE_TYPE (SnapdGetSnapshotExport, snapd_get_snapshot_export, snapd_request_get_type ())
+
+SnapdGetSnapshotExport *
+_snapd_get_snapshot_export_new (gint64 set_id, GOutputStream *stream,
+                                GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdGetSnapshotExport *self = SNAPD_GET_SNAPSHOT_EXPORT (g_object_new (snapd_get_snapshot_export_get_type (),
+                                                                            "cancellable", cancellable,
+                                                                            "ready-callback", callback,
+                                                                            "ready-callback-data", user_data,
+                                                                            NULL));
+    self->set_id = set_id;
+
+    /* The archive is written to the stream as it arrives so it never has to fit in memory */
+    _snapd_request_set_response_stream (SNAPD_REQUEST (self), stream, progress_callback, progress_callback_data);
+    _snapd_request_set_response_stream_content_type (SNAPD_REQUEST (self), SNAPSHOT_CONTENT_TYPE);
+
+    return self;
+}
+
+static SnapdHttpRequest *
+generate_get_snapshot_export_request (SnapdRequest *request, GBytes **body)
+{
+    SnapdGetSnapshotExport *self = SNAPD_GET_SNAPSHOT_EXPORT (request);
+
+    g_autofree gchar *path = g_strdup_printf ("/v2/snapshots/%" G_GINT64_FORMAT "/export", self->set_id);
+    return _snapd_http_request_new ("GET", path);
+}
+
+static gboolean
+parse_get_snapshot_export_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    /* Errors are reported in the usual JSON form */
+    if (g_strcmp0 (content_type, "application/json") == 0) {
+        g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+        if (response == NULL)
+            return FALSE;
+    }
+
+    if (g_strcmp0 (content_type, SNAPSHOT_CONTENT_TYPE) != 0) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "Unknown response");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+snapd_get_snapshot_export_class_init (SnapdGetSnapshotExportClass *klass)
+{
+    SnapdRequestClass *request_class = SNAPD_REQUEST_CLASS (klass);
+
+    request_class->generate_request = generate_get_snapshot_export_request;
+    request_class->parse_response = parse_get_snapshot_export_response;
+}
+
+static void
+snapd_get_snapshot_export_init (SnapdGetSnapshotExport *self)
+{
+}
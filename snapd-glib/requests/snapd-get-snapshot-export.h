@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_GET_SNAPSHOT_EXPORT_H__
+#define __SNAPD_GET_SNAPSHOT_EXPORT_H__
+
+#include "snapd-request.h"
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE (SnapdGetSnapshotExport, snapd_get_snapshot_export, SNAPD, GET_SNAPSHOT_EXPORT, SnapdRequest)
+
+SnapdGetSnapshotExport *_snapd_get_snapshot_export_new (gint64                 set_id,
+                                                        GOutputStream         *stream,
+                                                        GFileProgressCallback  progress_callback,
+                                                        gpointer               progress_callback_data,
+                                                        GCancellable          *cancellable,
+                                                        GAsyncReadyCallback    callback,
+                                                        gpointer               user_data);
+
+G_END_DECLS
+
+#endif /* __SNAPD_GET_SNAPSHOT_EXPORT_H__ */
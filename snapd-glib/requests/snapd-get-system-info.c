@@ -38,10 +38,10 @@ _snapd_get_system_info_get_system_information (SnapdGetSystemInfo *self)
     return self->system_information;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_system_info_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/system-info");
+    return _snapd_http_request_new ("GET", "/v2/system-info");
 }
 
 static gboolean
@@ -64,10 +64,20 @@ parse_get_system_info_response (SnapdRequest *request, guint status_code, const
         return FALSE;
 
     self->system_information = g_steal_pointer (&system_information);
+    _snapd_request_store_response (request, body);
 
     return TRUE;
 }
 
+static void
+copy_get_system_info_response (SnapdRequest *request, SnapdRequest *source)
+{
+    SnapdGetSystemInfo *self = SNAPD_GET_SYSTEM_INFO (request);
+    SnapdGetSystemInfo *s = SNAPD_GET_SYSTEM_INFO (source);
+
+    g_set_object (&self->system_information, s->system_information);
+}
+
 static void
 snapd_get_system_info_finalize (GObject *object)
 {
@@ -86,6 +96,7 @@ snapd_get_system_info_class_init (SnapdGetSystemInfoClass *klass)
 
    request_class->generate_request = generate_get_system_info_request;
    request_class->parse_response = parse_get_system_info_response;
+   request_class->copy_response = copy_get_system_info_response;
    gobject_class->finalize = snapd_get_system_info_finalize;
 }
 
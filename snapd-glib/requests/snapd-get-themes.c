@@ -75,19 +75,19 @@ add_theme_names (GString *path, gboolean *first_param, const char *theme_type, G
     }
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_themes_request (SnapdRequest *request, GBytes **body)
 {
     SnapdGetThemes *self = SNAPD_GET_THEMES (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/accessories/themes");
+    g_autoptr(GString) path = g_string_new ("/v2/accessories/themes");
     gboolean first_param = TRUE;
 
     add_theme_names (path, &first_param, "gtk-theme=", self->gtk_theme_names);
     add_theme_names (path, &first_param, "icon-theme=", self->icon_theme_names);
     add_theme_names (path, &first_param, "sound-theme=", self->sound_theme_names);
 
-    return soup_message_new ("GET", path->str);
+    return _snapd_http_request_new ("GET", path->str);
 }
 
 static GHashTable *
@@ -36,10 +36,10 @@ _snapd_get_users_get_users_information (SnapdGetUsers *self)
     return self->users_information;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_get_users_request (SnapdRequest *request, GBytes **body)
 {
-    return soup_message_new ("GET", "http://snapd/v2/users");
+    return _snapd_http_request_new ("GET", "/v2/users");
 }
 
 static gboolean
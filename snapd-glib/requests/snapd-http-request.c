@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-http-request.h"
+
+/* @path is the already escaped path to request, with an optional query after a '?' */
+SnapdHttpRequest *
+_snapd_http_request_new (const gchar *method, const gchar *path)
+{
+    SnapdHttpRequest *request = g_slice_new0 (SnapdHttpRequest);
+    request->method = g_strdup (method);
+    const gchar *query = strchr (path, '?');
+    if (query != NULL) {
+        request->path = g_strndup (path, query - path);
+        request->query = g_strdup (query + 1);
+    }
+    else
+        request->path = g_strdup (path);
+    request->header_names = g_ptr_array_new_with_free_func (g_free);
+    request->header_values = g_ptr_array_new_with_free_func (g_free);
+
+    return request;
+}
+
+void
+_snapd_http_request_add_header (SnapdHttpRequest *request, const gchar *name, const gchar *value)
+{
+    g_ptr_array_add (request->header_names, g_strdup (name));
+    g_ptr_array_add (request->header_values, g_strdup (value));
+}
+
+void
+_snapd_http_request_free (SnapdHttpRequest *request)
+{
+    g_clear_pointer (&request->method, g_free);
+    g_clear_pointer (&request->path, g_free);
+    g_clear_pointer (&request->query, g_free);
+    g_clear_pointer (&request->header_names, g_ptr_array_unref);
+    g_clear_pointer (&request->header_values, g_ptr_array_unref);
+    g_slice_free (SnapdHttpRequest, request);
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_HTTP_REQUEST_H__
+#define __SNAPD_HTTP_REQUEST_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* An HTTP request to send to snapd */
+typedef struct
+{
+    gchar *method;
+    gchar *path;
+    gchar *query;
+
+    /* Headers specific to this request */
+    GPtrArray *header_names;
+    GPtrArray *header_values;
+} SnapdHttpRequest;
+
+SnapdHttpRequest *_snapd_http_request_new        (const gchar      *method,
+                                                  const gchar      *path);
+
+void              _snapd_http_request_add_header (SnapdHttpRequest *request,
+                                                  const gchar      *name,
+                                                  const gchar      *value);
+
+void              _snapd_http_request_free       (SnapdHttpRequest *request);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdHttpRequest, _snapd_http_request_free)
+
+G_END_DECLS
+
+#endif /* __SNAPD_HTTP_REQUEST_H__ */
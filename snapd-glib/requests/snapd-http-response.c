@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-http-response.h"
+
+static gboolean
+is_space (gchar c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/* Remove leading and trailing whitespace from the range @start to @end */
+static void
+trim (const gchar **start, const gchar **end)
+{
+    while (*start < *end && is_space (**start))
+        (*start)++;
+    while (*end > *start && is_space (*(*end - 1)))
+        (*end)--;
+}
+
+static gboolean
+name_matches (const gchar *name, gsize name_length, const gchar *expected)
+{
+    return name_length == strlen (expected) && g_ascii_strncasecmp (name, expected, name_length) == 0;
+}
+
+static gboolean
+parse_content_length (const gchar *value, const gchar *value_end, gsize *content_length)
+{
+    if (value == value_end)
+        return FALSE;
+
+    gsize length = 0;
+    for (const gchar *c = value; c < value_end; c++) {
+        if (!g_ascii_isdigit (*c))
+            return FALSE;
+        gsize digit = *c - '0';
+        if (length > (G_MAXSIZE - digit) / 10)
+            return FALSE;
+        length = length * 10 + digit;
+    }
+
+    *content_length = length;
+    return TRUE;
+}
+
+/* The last coding applied decides how the body is framed */
+static SnapdHttpEncoding
+parse_transfer_encoding (const gchar *value, const gchar *value_end)
+{
+    const gchar *coding = value;
+    for (const gchar *c = value; c < value_end; c++) {
+        if (*c == ',')
+            coding = c + 1;
+    }
+    trim (&coding, &value_end);
+
+    if (value_end - coding == 7 && g_ascii_strncasecmp (coding, "chunked", 7) == 0)
+        return SNAPD_HTTP_ENCODING_CHUNKED;
+    else if (value_end - coding == 8 && g_ascii_strncasecmp (coding, "identity", 8) == 0)
+        return SNAPD_HTTP_ENCODING_EOF;
+    else
+        return SNAPD_HTTP_ENCODING_UNRECOGNIZED;
+}
+
+static void
+parse_content_type (const gchar *value, const gchar *value_end, gchar *content_type)
+{
+    const gchar *parameters = memchr (value, ';', value_end - value);
+    if (parameters != NULL)
+        value_end = parameters;
+    trim (&value, &value_end);
+
+    gsize length = value_end - value;
+    if (length >= SNAPD_HTTP_CONTENT_TYPE_SIZE)
+        length = 0;
+    memcpy (content_type, value, length);
+    content_type[length] = '\0';
+}
+
+/* Parse the status line and headers of a response in @data, which ends with
+ * the empty line that separates them from the body. Only the fields in
+ * #SnapdHttpResponseHeaders are extracted, nothing is allocated */
+gboolean
+_snapd_http_response_parse_headers (const gchar *data, gsize length, SnapdHttpResponseHeaders *headers)
+{
+    memset (headers, 0, sizeof (SnapdHttpResponseHeaders));
+
+    const gchar *end = data + length;
+    const gchar *line_end = g_strstr_len (data, length, "\r\n");
+    if (line_end == NULL)
+        return FALSE;
+
+    /* Status line, e.g. "HTTP/1.1 200 OK" */
+    if (line_end - data < 12 || strncmp (data, "HTTP/1.", 7) != 0 || !g_ascii_isdigit (data[7]) || data[8] != ' ' ||
+        !g_ascii_isdigit (data[9]) || !g_ascii_isdigit (data[10]) || !g_ascii_isdigit (data[11]) ||
+        (line_end - data > 12 && data[12] != ' '))
+        return FALSE;
+    headers->status_code = (data[9] - '0') * 100 + (data[10] - '0') * 10 + (data[11] - '0');
+
+    gboolean have_content_length = FALSE;
+    SnapdHttpEncoding transfer_encoding = SNAPD_HTTP_ENCODING_EOF;
+    const gchar *line = line_end + 2;
+    while (TRUE) {
+        line_end = g_strstr_len (line, end - line, "\r\n");
+        if (line_end == NULL)
+            return FALSE;
+        if (line_end == line)
+            break;
+
+        const gchar *colon = memchr (line, ':', line_end - line);
+        if (colon == NULL || colon == line)
+            return FALSE;
+        const gchar *value = colon + 1, *value_end = line_end;
+        trim (&value, &value_end);
+        gsize name_length = colon - line;
+
+        if (name_matches (line, name_length, "Content-Length")) {
+            gsize content_length;
+            if (!parse_content_length (value, value_end, &content_length))
+                return FALSE;
+            if (have_content_length && content_length != headers->content_length)
+                return FALSE;
+            headers->content_length = content_length;
+            have_content_length = TRUE;
+        }
+        else if (name_matches (line, name_length, "Transfer-Encoding"))
+            transfer_encoding = parse_transfer_encoding (value, value_end);
+        else if (name_matches (line, name_length, "Content-Type"))
+            parse_content_type (value, value_end, headers->content_type);
+
+        line = line_end + 2;
+    }
+
+    /* A transfer coding overrides any length, identity means there is none */
+    if (transfer_encoding != SNAPD_HTTP_ENCODING_EOF)
+        headers->encoding = transfer_encoding;
+    else if (have_content_length)
+        headers->encoding = SNAPD_HTTP_ENCODING_CONTENT_LENGTH;
+    else
+        headers->encoding = SNAPD_HTTP_ENCODING_EOF;
+
+    return TRUE;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_HTTP_RESPONSE_H__
+#define __SNAPD_HTTP_RESPONSE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* How the end of a response body is found */
+typedef enum
+{
+    SNAPD_HTTP_ENCODING_EOF,
+    SNAPD_HTTP_ENCODING_CONTENT_LENGTH,
+    SNAPD_HTTP_ENCODING_CHUNKED,
+    SNAPD_HTTP_ENCODING_UNRECOGNIZED
+} SnapdHttpEncoding;
+
+/* Longest media type kept from the Content-Type header, including the nul terminator */
+#define SNAPD_HTTP_CONTENT_TYPE_SIZE 128
+
+/* The fields of an HTTP response header that snapd-glib uses */
+typedef struct
+{
+    guint status_code;
+    SnapdHttpEncoding encoding;
+    gsize content_length;
+
+    /* Media type without parameters, or an empty string if not provided */
+    gchar content_type[SNAPD_HTTP_CONTENT_TYPE_SIZE];
+} SnapdHttpResponseHeaders;
+
+gboolean _snapd_http_response_parse_headers (const gchar              *data,
+                                             gsize                     length,
+                                             SnapdHttpResponseHeaders *headers);
+
+G_END_DECLS
+
+#endif /* __SNAPD_HTTP_RESPONSE_H__ */
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string>
+
+#include <simdjson.h>
+
+#include "snapd-json-simd.h"
+#include "snapd-error.h"
+
+/* Elements nested deeper than this are rejected rather than recursed into */
+#define MAX_ELEMENT_DEPTH 64
+
+/* Build a json-glib tree from a parsed element, so the existing decoders can be used on it */
+static JsonNode *
+element_to_node (simdjson::dom::element element, guint depth, GError **error)
+{
+    if (depth > MAX_ELEMENT_DEPTH) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: nested more than %d deep", MAX_ELEMENT_DEPTH);
+        return NULL;
+    }
+
+    JsonNode *node = json_node_alloc ();
+
+    switch (element.type ()) {
+    case simdjson::dom::element_type::ARRAY: {
+        JsonArray *array = json_array_new ();
+        for (simdjson::dom::element child : element.get_array ().value_unsafe ()) {
+            JsonNode *child_node = element_to_node (child, depth + 1, error);
+            if (child_node == NULL) {
+                json_array_unref (array);
+                json_node_unref (node);
+                return NULL;
+            }
+            json_array_add_element (array, child_node);
+        }
+        json_node_init_array (node, array);
+        json_array_unref (array);
+        break;
+    }
+    case simdjson::dom::element_type::OBJECT: {
+        JsonObject *object = json_object_new ();
+        for (simdjson::dom::key_value_pair member : element.get_object ().value_unsafe ()) {
+            JsonNode *member_node = element_to_node (member.value, depth + 1, error);
+            if (member_node == NULL) {
+                json_object_unref (object);
+                json_node_unref (node);
+                return NULL;
+            }
+            std::string name (member.key.data (), member.key.size ());
+            json_object_set_member (object, name.c_str (), member_node);
+        }
+        json_node_init_object (node, object);
+        json_object_unref (object);
+        break;
+    }
+    case simdjson::dom::element_type::STRING: {
+        std::string value (element.get_string ().value_unsafe ());
+        json_node_init_string (node, value.c_str ());
+        break;
+    }
+    case simdjson::dom::element_type::INT64:
+        json_node_init_int (node, element.get_int64 ().value_unsafe ());
+        break;
+    /* json-glib stores integers that don't fit in 64 bit signed as doubles */
+    case simdjson::dom::element_type::UINT64:
+        json_node_init_double (node, (gdouble) element.get_uint64 ().value_unsafe ());
+        break;
+    case simdjson::dom::element_type::DOUBLE:
+        json_node_init_double (node, element.get_double ().value_unsafe ());
+        break;
+    case simdjson::dom::element_type::BOOL:
+        json_node_init_boolean (node, element.get_bool ().value_unsafe ());
+        break;
+    case simdjson::dom::element_type::NULL_VALUE:
+        json_node_init_null (node);
+        break;
+    }
+
+    return node;
+}
+
+/* Parse a result array in one pass, then convert each element in @offset and @limit
+ * to a tree in turn, so only one element is held in memory as a JSON tree */
+gboolean
+_snapd_json_simd_parse_array (const gchar *data, gsize length, guint offset, guint limit, guint *n_elements,
+                              gboolean (*element_func) (JsonNode *element, gpointer user_data, GError **error),
+                              gpointer user_data, GError **error)
+{
+    /* The parser keeps its buffers between calls, responses may be parsed in several threads */
+    static thread_local simdjson::dom::parser parser;
+
+    simdjson::dom::element root;
+    simdjson::error_code parse_error = parser.parse (data, length).get (root);
+    if (parse_error != simdjson::SUCCESS) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: %s", simdjson::error_message (parse_error));
+        return FALSE;
+    }
+
+    simdjson::dom::array array;
+    if (root.get_array ().get (array) != simdjson::SUCCESS) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: result is not an array");
+        return FALSE;
+    }
+
+    guint index = 0;
+    for (simdjson::dom::element element : array) {
+        if (index >= offset && index - offset < limit) {
+            JsonNode *node = element_to_node (element, 1, error);
+            if (node == NULL)
+                return FALSE;
+            gboolean result = element_func (node, user_data, error);
+            json_node_unref (node);
+            if (!result)
+                return FALSE;
+        }
+        index++;
+    }
+    if (n_elements != NULL)
+        *n_elements = index;
+
+    return TRUE;
+}
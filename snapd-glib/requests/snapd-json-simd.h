@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_JSON_SIMD_H__
+#define __SNAPD_JSON_SIMD_H__
+
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+gboolean _snapd_json_simd_parse_array (const gchar  *data,
+                                       gsize         length,
+                                       guint         offset,
+                                       guint         limit,
+                                       guint        *n_elements,
+                                       gboolean    (*element_func) (JsonNode *element, gpointer user_data, GError **error),
+                                       gpointer      user_data,
+                                       GError      **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_JSON_SIMD_H__ */
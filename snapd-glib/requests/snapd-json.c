@@ -7,183 +7,310 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "snapd-json.h"
 
 #include "snapd-error.h"
+#include "snapd-identity-map.h"
 #include "snapd-app.h"
+#include "snapd-app-private.h"
+#include "snapd-change-private.h"
+#include "snapd-channel-private.h"
+#include "snapd-connection-private.h"
 #include "snapd-media.h"
+#include "snapd-media-private.h"
+#include "snapd-plug-private.h"
+#include "snapd-price-private.h"
 #include "snapd-screenshot.h"
+#include "snapd-slot-private.h"
 #include "snapd-task.h"
+#include "snapd-task-private.h"
+#include "snapd-timestamp.h"
+
+#ifdef HAVE_SIMDJSON
+#include "snapd-json-simd.h"
+#endif
+
+/* Writes compact JSON directly into the request body, instead of building
+ * a tree with JsonBuilder and then serializing it */
+struct _SnapdJsonWriter
+{
+    GString *data;
+
+    /* TRUE if the next member or element needs to be separated from the previous one */
+    gboolean need_comma;
+};
+
+SnapdJsonWriter *
+_snapd_json_writer_new (void)
+{
+    SnapdJsonWriter *writer = g_slice_new0 (SnapdJsonWriter);
+    writer->data = g_string_sized_new (256);
+    return writer;
+}
 
 void
-_snapd_json_set_body (SoupMessage *message, JsonBuilder *builder, GBytes **body)
+_snapd_json_writer_free (SnapdJsonWriter *writer)
 {
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    SoupMessageHeaders *request_headers = soup_message_get_request_headers (message);
-#else
-    SoupMessageHeaders *request_headers = message->request_headers;
-#endif
-    soup_message_headers_set_content_type (request_headers, "application/json", NULL);
+    if (writer->data != NULL)
+        g_string_free (writer->data, TRUE);
+    g_slice_free (SnapdJsonWriter, writer);
+}
+
+/* Start a new value, a member name has already written any separator needed */
+static void
+begin_value (SnapdJsonWriter *writer)
+{
+    if (writer->need_comma)
+        g_string_append_c (writer->data, ',');
+    writer->need_comma = TRUE;
+}
+
+static void
+append_string (GString *data, const gchar *value)
+{
+    g_string_append_c (data, '"');
+    for (const gchar *c = value; *c != '\0'; c++) {
+        switch (*c) {
+        case '"':
+            g_string_append (data, "\\\"");
+            break;
+        case '\\':
+            g_string_append (data, "\\\\");
+            break;
+        case '\b':
+            g_string_append (data, "\\b");
+            break;
+        case '\f':
+            g_string_append (data, "\\f");
+            break;
+        case '\n':
+            g_string_append (data, "\\n");
+            break;
+        case '\r':
+            g_string_append (data, "\\r");
+            break;
+        case '\t':
+            g_string_append (data, "\\t");
+            break;
+        default:
+            if ((guchar) *c < 0x20)
+                g_string_append_printf (data, "\\u%04x", (guchar) *c);
+            else
+                g_string_append_c (data, *c);
+            break;
+        }
+    }
+    g_string_append_c (data, '"');
+}
+
+void
+_snapd_json_writer_begin_object (SnapdJsonWriter *writer)
+{
+    begin_value (writer);
+    g_string_append_c (writer->data, '{');
+    writer->need_comma = FALSE;
+}
+
+void
+_snapd_json_writer_end_object (SnapdJsonWriter *writer)
+{
+    g_string_append_c (writer->data, '}');
+    writer->need_comma = TRUE;
+}
+
+void
+_snapd_json_writer_begin_array (SnapdJsonWriter *writer)
+{
+    begin_value (writer);
+    g_string_append_c (writer->data, '[');
+    writer->need_comma = FALSE;
+}
+
+void
+_snapd_json_writer_end_array (SnapdJsonWriter *writer)
+{
+    g_string_append_c (writer->data, ']');
+    writer->need_comma = TRUE;
+}
+
+void
+_snapd_json_writer_set_member_name (SnapdJsonWriter *writer, const gchar *name)
+{
+    if (writer->need_comma)
+        g_string_append_c (writer->data, ',');
+    append_string (writer->data, name);
+    g_string_append_c (writer->data, ':');
+    writer->need_comma = FALSE;
+}
+
+void
+_snapd_json_writer_add_string_value (SnapdJsonWriter *writer, const gchar *value)
+{
+    begin_value (writer);
+    if (value != NULL)
+        append_string (writer->data, value);
+    else
+        g_string_append (writer->data, "null");
+}
+
+void
+_snapd_json_writer_add_boolean_value (SnapdJsonWriter *writer, gboolean value)
+{
+    begin_value (writer);
+    g_string_append (writer->data, value ? "true" : "false");
+}
+
+void
+_snapd_json_writer_add_int_value (SnapdJsonWriter *writer, gint64 value)
+{
+    begin_value (writer);
+    g_string_append_printf (writer->data, "%" G_GINT64_FORMAT, value);
+}
+
+void
+_snapd_json_writer_add_double_value (SnapdJsonWriter *writer, gdouble value)
+{
+    begin_value (writer);
+
+    /* JSON has no representation for infinity or NaN */
+    if (!isfinite (value)) {
+        g_string_append (writer->data, "null");
+        return;
+    }
+
+    gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+    g_string_append (writer->data, g_ascii_dtostr (buffer, sizeof (buffer), value));
+}
+
+/* Add a value that is already a JSON tree. Takes ownership of @value, like json_builder_add_value() */
+void
+_snapd_json_writer_add_value (SnapdJsonWriter *writer, JsonNode *value)
+{
+    g_autoptr(JsonNode) node = value;
 
-    g_autoptr(JsonNode) json_root = json_builder_get_root (builder);
+    begin_value (writer);
     g_autoptr(JsonGenerator) json_generator = json_generator_new ();
-    json_generator_set_pretty (json_generator, TRUE);
-    json_generator_set_root (json_generator, json_root);
+    json_generator_set_root (json_generator, node);
     gsize data_length;
-    g_autofree guchar *data = (guchar *) json_generator_to_data (json_generator, &data_length);
-    *body = g_bytes_new_take (g_steal_pointer (&data), data_length);
+    g_autofree gchar *data = json_generator_to_data (json_generator, &data_length);
+    g_string_append_len (writer->data, data, data_length);
 }
 
-gboolean
-_snapd_json_get_bool (JsonObject *object, const gchar *name, gboolean default_value)
+void
+_snapd_json_set_body (SnapdHttpRequest *message, SnapdJsonWriter *writer, GBytes **body)
+{
+    _snapd_http_request_add_header (message, "Content-Type", "application/json");
+
+    *body = g_string_free_to_bytes (g_steal_pointer (&writer->data));
+}
+
+static gboolean
+node_get_bool (JsonNode *node, gboolean default_value)
 {
-    JsonNode *node = json_object_get_member (object, name);
     if (node != NULL && json_node_get_value_type (node) == G_TYPE_BOOLEAN)
         return json_node_get_boolean (node);
     else
         return default_value;
 }
 
-gint64
-_snapd_json_get_int (JsonObject *object, const gchar *name, gint64 default_value)
+static gint64
+node_get_int (JsonNode *node, gint64 default_value)
 {
-    JsonNode *node = json_object_get_member (object, name);
     if (node != NULL && json_node_get_value_type (node) == G_TYPE_INT64)
         return json_node_get_int (node);
     else
         return default_value;
 }
 
-const gchar *
-_snapd_json_get_string (JsonObject *object, const gchar *name, const gchar *default_value)
+static const gchar *
+node_get_string (JsonNode *node, const gchar *default_value)
 {
-    JsonNode *node = json_object_get_member (object, name);
     if (node != NULL && json_node_get_value_type (node) == G_TYPE_STRING)
         return json_node_get_string (node);
     else
         return default_value;
 }
 
-JsonArray *
-_snapd_json_get_array (JsonObject *object, const gchar *name)
+static JsonArray *
+node_get_array (JsonNode *node)
 {
-    JsonNode *node = json_object_get_member (object, name);
     if (node != NULL && json_node_get_value_type (node) == JSON_TYPE_ARRAY)
         return json_array_ref (json_node_get_array (node));
     else
         return json_array_new ();
 }
 
-JsonObject *
-_snapd_json_get_object (JsonObject *object, const gchar *name)
+static JsonObject *
+node_get_object (JsonNode *node)
 {
-    JsonNode *node = json_object_get_member (object, name);
     if (node != NULL && json_node_get_value_type (node) == JSON_TYPE_OBJECT)
         return json_node_get_object (node);
     else
         return NULL;
 }
 
-static gboolean
-parse_date (const gchar *date_string, gint *year, gint *month, gint *day)
+gboolean
+_snapd_json_get_bool (JsonObject *object, const gchar *name, gboolean default_value)
 {
-    /* Example: 2016-05-17 */
-    if (strchr (date_string, '-') != NULL) {
-        g_auto(GStrv) tokens = g_strsplit (date_string, "-", -1);
-        if (g_strv_length (tokens) != 3)
-            return FALSE;
-
-        *year = atoi (tokens[0]);
-        *month = atoi (tokens[1]);
-        *day = atoi (tokens[2]);
+    return node_get_bool (json_object_get_member (object, name), default_value);
+}
 
-        return TRUE;
-    }
-    /* Example: 20160517 */
-    else if (strlen (date_string) == 8) {
-        // FIXME: Implement
-        return FALSE;
-    }
-    else
-        return FALSE;
+gint64
+_snapd_json_get_int (JsonObject *object, const gchar *name, gint64 default_value)
+{
+    return node_get_int (json_object_get_member (object, name), default_value);
 }
 
-static gboolean
-parse_time (const gchar *time_string, gint *hour, gint *minute, gdouble *seconds)
+const gchar *
+_snapd_json_get_string (JsonObject *object, const gchar *name, const gchar *default_value)
 {
-    /* Example: 09:36:53.682 or 09:36:53 or 09:36 */
-    if (strchr (time_string, ':') != NULL) {
-        g_auto(GStrv) tokens = g_strsplit (time_string, ":", 3);
-        *hour = atoi (tokens[0]);
-        if (tokens[1] == NULL)
-            return FALSE;
-        *minute = atoi (tokens[1]);
-        if (tokens[2] != NULL)
-            *seconds = g_ascii_strtod (tokens[2], NULL);
-        else
-            *seconds = 0.0;
+    return node_get_string (json_object_get_member (object, name), default_value);
+}
 
-        return TRUE;
-    }
-    /* Example: 093653.682 or 093653 or 0936 */
-    else {
-        // FIXME: Implement
-        return FALSE;
-    }
+JsonArray *
+_snapd_json_get_array (JsonObject *object, const gchar *name)
+{
+    return node_get_array (json_object_get_member (object, name));
 }
 
-static gboolean
-is_timezone_prefix (gchar c)
+JsonObject *
+_snapd_json_get_object (JsonObject *object, const gchar *name)
 {
-    return c == '+' || c == '-' || c == 'Z';
+    return node_get_object (json_object_get_member (object, name));
 }
 
-GDateTime *
-_snapd_json_get_date_time (JsonObject *object, const gchar *name)
+static gboolean
+node_get_timestamp (JsonNode *node, SnapdTimestamp *timestamp)
 {
-    const gchar *value = _snapd_json_get_string (object, name, NULL);
-    if (value == NULL)
-        return NULL;
+    _snapd_timestamp_clear (timestamp);
 
-    /* Example: 2016-05-17T09:36:53+12:00 */
-    g_auto(GStrv) tokens = g_strsplit (value, "T", 2);
-    gint year = 0, month = 0, day = 0;
-    if (!parse_date (tokens[0], &year, &month, &day))
-        return NULL;
-    g_autoptr(GTimeZone) timezone = NULL;
-    gint hour = 0, minute = 0;
-    gdouble seconds = 0.0;
-    if (tokens[1] != NULL) {
-        gchar *timezone_start;
-
-        /* Timezone is either Z (UTC) +hh:mm or -hh:mm */
-        timezone_start = tokens[1];
-        while (*timezone_start != '\0' && !is_timezone_prefix (*timezone_start))
-            timezone_start++;
-        if (*timezone_start != '\0') {
-#ifdef GLIB_VERSION_2_68
-            timezone = g_time_zone_new_identifier (timezone_start);
-            if (timezone == NULL)
-                timezone = g_time_zone_new_utc ();
-#else
-            timezone = g_time_zone_new (timezone_start);
-#endif
-        }
+    const gchar *value = node_get_string (node, NULL);
+    if (value == NULL)
+        return FALSE;
 
-        /* Strip off timezone */
-        *timezone_start = '\0';
+    return _snapd_timestamp_parse (timestamp, value);
+}
 
-        if (!parse_time (tokens[1], &hour, &minute, &seconds))
-            return NULL;
-    }
+static GDateTime *
+node_get_date_time (JsonNode *node)
+{
+    SnapdTimestamp timestamp = { 0 };
+    if (!node_get_timestamp (node, &timestamp))
+        return NULL;
 
-    if (timezone == NULL)
-        timezone = g_time_zone_new_local ();
+    GDateTime *date_time = g_date_time_ref (_snapd_timestamp_get_date_time (&timestamp));
+    _snapd_timestamp_clear (&timestamp);
+    return date_time;
+}
 
-    return g_date_time_new (timezone, year, month, day, hour, minute, seconds);
+GDateTime *
+_snapd_json_get_date_time (JsonObject *object, const gchar *name)
+{
+    return node_get_date_time (json_object_get_member (object, name));
 }
 
 static void
@@ -482,6 +609,228 @@ _snapd_json_get_sync_result_a (JsonObject *response, GError **error)
     return r;
 }
 
+static gboolean
+is_json_space (gchar c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static gsize
+skip_json_space (const gchar *data, gsize length, gsize offset)
+{
+    while (offset < length && is_json_space (data[offset]))
+        offset++;
+    return offset;
+}
+
+/* Find the end of the JSON string starting at @offset.
+ * Returns the offset after the closing quote or 0 if not terminated */
+static gsize
+skip_json_string (const gchar *data, gsize length, gsize offset)
+{
+    for (offset++; offset < length; offset++) {
+        if (data[offset] == '\\')
+            offset++;
+        else if (data[offset] == '"')
+            return offset + 1;
+    }
+    return 0;
+}
+
+/* Find the end of the JSON value starting at @offset without checking its contents.
+ * Returns the offset after the value or 0 if it is not complete */
+static gsize
+skip_json_value (const gchar *data, gsize length, gsize offset)
+{
+    if (offset >= length)
+        return 0;
+
+    if (data[offset] == '"')
+        return skip_json_string (data, length, offset);
+
+    if (data[offset] == '{' || data[offset] == '[') {
+        gsize depth = 0;
+        while (offset < length) {
+            gchar c = data[offset];
+            if (c == '"') {
+                offset = skip_json_string (data, length, offset);
+                if (offset == 0)
+                    return 0;
+                continue;
+            }
+            if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']') {
+                depth--;
+                if (depth == 0)
+                    return offset + 1;
+            }
+            offset++;
+        }
+        return 0;
+    }
+
+    /* Number, true, false or null */
+    gsize start = offset;
+    while (offset < length && !is_json_space (data[offset]) && data[offset] != ',' && data[offset] != '}' && data[offset] != ']')
+        offset++;
+    return offset > start ? offset : 0;
+}
+
+/* Split a response object into the members other than "result", and the span of "result" if it is an array */
+static GBytes *
+split_array_response (const gchar *data, gsize length, gsize *result_start, gsize *result_end)
+{
+    *result_start = *result_end = 0;
+
+    gsize offset = skip_json_space (data, length, 0);
+    if (offset >= length || data[offset] != '{')
+        return NULL;
+    offset++;
+
+    g_autoptr(GString) envelope = g_string_new ("{");
+    while (TRUE) {
+        offset = skip_json_space (data, length, offset);
+        if (offset < length && data[offset] == '}')
+            break;
+
+        gsize name_start = offset;
+        if (offset >= length || data[offset] != '"')
+            return NULL;
+        offset = skip_json_string (data, length, offset);
+        if (offset == 0)
+            return NULL;
+        gsize name_end = offset;
+        offset = skip_json_space (data, length, offset);
+        if (offset >= length || data[offset] != ':')
+            return NULL;
+        offset = skip_json_space (data, length, offset + 1);
+        gsize value_start = offset;
+        offset = skip_json_value (data, length, offset);
+        if (offset == 0)
+            return NULL;
+
+        if (name_end - name_start == 8 && strncmp (data + name_start, "\"result\"", 8) == 0 && data[value_start] == '[') {
+            *result_start = value_start;
+            *result_end = offset;
+        }
+        else {
+            if (envelope->len > 1)
+                g_string_append_c (envelope, ',');
+            g_string_append_len (envelope, data + name_start, offset - name_start);
+        }
+
+        offset = skip_json_space (data, length, offset);
+        if (offset < length && data[offset] == ',')
+            offset++;
+        else if (offset >= length || data[offset] != '}')
+            return NULL;
+    }
+    g_string_append_c (envelope, '}');
+
+    gsize envelope_length = envelope->len;
+    return g_bytes_new_take (g_string_free (g_steal_pointer (&envelope), FALSE), envelope_length);
+}
+
+/* Parse each element of the result array in turn, so only one element is held in memory as a JSON tree.
+ * Elements outside @offset and @limit are skipped without being parsed, but are still counted */
+static gboolean
+parse_array_elements (const gchar *data, gsize length, guint offset, guint limit, guint *n_elements, SnapdJsonElementFunc element_func, gpointer user_data, GError **error)
+{
+#ifdef HAVE_SIMDJSON
+    return _snapd_json_simd_parse_array (data, length, offset, limit, n_elements, element_func, user_data, error);
+#else
+    g_autoptr(JsonParser) parser = json_parser_new ();
+    guint index = 0;
+    gsize position = skip_json_space (data, length, 1);
+    while (position < length && data[position] != ']') {
+        gsize element_start = position;
+        position = skip_json_value (data, length, position);
+        if (position == 0) {
+            g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: unterminated array element");
+            return FALSE;
+        }
+
+        if (index >= offset && index - offset < limit) {
+            g_autoptr(GError) error_local = NULL;
+            if (!json_parser_load_from_data (parser, data + element_start, position - element_start, &error_local)) {
+                g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: %s", error_local->message);
+                return FALSE;
+            }
+            if (!element_func (json_parser_get_root (parser), user_data, error))
+                return FALSE;
+        }
+        index++;
+
+        position = skip_json_space (data, length, position);
+        if (position < length && data[position] == ',')
+            position = skip_json_space (data, length, position + 1);
+        else if (position >= length || data[position] != ']') {
+            g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE, "Unable to parse snapd response: unexpected data in array");
+            return FALSE;
+        }
+    }
+    if (n_elements != NULL)
+        *n_elements = index;
+
+    return TRUE;
+#endif
+}
+
+JsonObject *
+_snapd_json_parse_array_response (const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, SnapdJsonElementFunc element_func, gpointer user_data, GError **error)
+{
+    return _snapd_json_parse_array_response_range (content_type, body, maintenance, 0, 0, NULL, element_func, user_data, error);
+}
+
+JsonObject *
+_snapd_json_parse_array_response_range (const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance,
+                                        guint offset, guint limit, guint *n_elements,
+                                        SnapdJsonElementFunc element_func, gpointer user_data, GError **error)
+{
+    if (limit == 0)
+        limit = G_MAXUINT;
+
+    gsize length;
+    const gchar *data = g_bytes_get_data (body, &length);
+    gsize result_start, result_end;
+    g_autoptr(GBytes) envelope = data != NULL ? split_array_response (data, length, &result_start, &result_end) : NULL;
+
+    /* Use the full parser if the response can't be split, so it reports the same errors */
+    if (envelope == NULL || result_end == 0) {
+        g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+        if (response == NULL)
+            return NULL;
+        g_autoptr(JsonArray) result = _snapd_json_get_sync_result_a (response, error);
+        if (result == NULL)
+            return NULL;
+
+        guint result_length = json_array_get_length (result);
+        for (guint i = offset; i < result_length && i - offset < limit; i++) {
+            if (!element_func (json_array_get_element (result, i), user_data, error))
+                return NULL;
+        }
+        if (n_elements != NULL)
+            *n_elements = result_length;
+
+        return g_steal_pointer (&response);
+    }
+
+    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, envelope, maintenance, NULL, error);
+    if (response == NULL)
+        return NULL;
+    const gchar *type = json_object_get_string_member (response, "type");
+    if (strcmp (type, "sync") != 0) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected response '%s' returned for sync request", type);
+        return NULL;
+    }
+
+    if (!parse_array_elements (data + result_start, result_end - result_start, offset, limit, n_elements, element_func, user_data, error))
+        return NULL;
+
+    return g_steal_pointer (&response);
+}
+
 gchar *
 _snapd_json_get_async_result (JsonObject *response, GError **error)
 {
@@ -497,79 +846,541 @@ _snapd_json_get_async_result (JsonObject *response, GError **error)
         return NULL;
     }
 
-    return g_strdup (json_node_get_string (change_node));
+    return g_strdup (json_node_get_string (change_node));
+}
+
+/* Objects are decoded from a table of the members used, giving the name, the
+ * type of value and where in a struct to store it. The object is walked once
+ * however many members are wanted, and values of an unexpected type are ignored,
+ * leaving the default the caller set in the struct */
+typedef enum
+{
+    FIELD_STRING,
+    FIELD_BOOLEAN,
+    FIELD_INT,
+    FIELD_OBJECT,
+    FIELD_NODE
+} FieldKind;
+
+typedef struct
+{
+    const gchar *name;
+    gsize length;
+    FieldKind kind;
+    gsize offset;
+    /* An old name for the member, only used if the current name is not present */
+    gboolean legacy;
+} JsonField;
+
+#define FIELD(name, kind, type, member) { name, sizeof (name) - 1, kind, G_STRUCT_OFFSET (type, member), FALSE }
+#define LEGACY_FIELD(name, kind, type, member) { name, sizeof (name) - 1, kind, G_STRUCT_OFFSET (type, member), TRUE }
+
+#define MAX_FIELDS 64
+
+static void
+store_field (const JsonField *field, JsonNode *node, gpointer fields_out)
+{
+    gpointer value = G_STRUCT_MEMBER_P (fields_out, field->offset);
+    GType type = json_node_get_value_type (node);
+
+    switch (field->kind) {
+    case FIELD_STRING:
+        if (type == G_TYPE_STRING)
+            *(const gchar **) value = json_node_get_string (node);
+        break;
+    case FIELD_BOOLEAN:
+        if (type == G_TYPE_BOOLEAN)
+            *(gboolean *) value = json_node_get_boolean (node);
+        break;
+    case FIELD_INT:
+        if (type == G_TYPE_INT64)
+            *(gint64 *) value = json_node_get_int (node);
+        break;
+    case FIELD_OBJECT:
+        if (type == JSON_TYPE_OBJECT)
+            *(JsonObject **) value = json_node_get_object (node);
+        break;
+    case FIELD_NODE:
+        *(JsonNode **) value = node;
+        break;
+    }
+}
+
+static gboolean
+has_current_field (const JsonField *fields, gsize n_fields, JsonNode **nodes, const JsonField *legacy_field)
+{
+    for (gsize i = 0; i < n_fields; i++) {
+        if (!fields[i].legacy && fields[i].offset == legacy_field->offset && nodes[i] != NULL)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void
+decode_fields (JsonObject *object, const JsonField *fields, gsize n_fields, gpointer fields_out)
+{
+    g_assert (n_fields <= MAX_FIELDS);
+
+    JsonNode *nodes[MAX_FIELDS] = { NULL };
+    JsonObjectIter iter;
+    json_object_iter_init (&iter, object);
+    const gchar *name;
+    JsonNode *node;
+    while (json_object_iter_next (&iter, &name, &node)) {
+        gsize length = strlen (name);
+        for (gsize i = 0; i < n_fields; i++) {
+            if (fields[i].length == length && fields[i].name[0] == name[0] && memcmp (fields[i].name, name, length) == 0) {
+                nodes[i] = node;
+                break;
+            }
+        }
+    }
+
+    for (gsize i = 0; i < n_fields; i++) {
+        if (nodes[i] == NULL)
+            continue;
+        if (fields[i].legacy && has_current_field (fields, n_fields, nodes, &fields[i]))
+            continue;
+        store_field (&fields[i], nodes[i], fields_out);
+    }
+}
+
+/* Decode @node into @fields_out, failing if it is not an object */
+static gboolean
+decode_object (JsonNode *node, const gchar *type_name, const JsonField *fields, gsize n_fields, gpointer fields_out, GError **error)
+{
+    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "Unexpected %s type", type_name);
+        return FALSE;
+    }
+
+    decode_fields (json_node_get_object (node), fields, n_fields, fields_out);
+    return TRUE;
+}
+
+typedef struct
+{
+    const gchar *id;
+    const gchar *kind;
+    const gchar *summary;
+    const gchar *status;
+    JsonObject *progress;
+    JsonNode *spawn_time;
+    JsonNode *ready_time;
+} TaskFields;
+
+static const JsonField task_fields[] =
+{
+    FIELD ("id", FIELD_STRING, TaskFields, id),
+    FIELD ("kind", FIELD_STRING, TaskFields, kind),
+    FIELD ("summary", FIELD_STRING, TaskFields, summary),
+    FIELD ("status", FIELD_STRING, TaskFields, status),
+    FIELD ("progress", FIELD_OBJECT, TaskFields, progress),
+    FIELD ("spawn-time", FIELD_NODE, TaskFields, spawn_time),
+    FIELD ("ready-time", FIELD_NODE, TaskFields, ready_time)
+};
+
+typedef struct
+{
+    const gchar *label;
+    gint64 done;
+    gint64 total;
+} ProgressFields;
+
+static const JsonField progress_fields[] =
+{
+    FIELD ("label", FIELD_STRING, ProgressFields, label),
+    FIELD ("done", FIELD_INT, ProgressFields, done),
+    FIELD ("total", FIELD_INT, ProgressFields, total)
+};
+
+typedef struct
+{
+    const gchar *id;
+    const gchar *kind;
+    const gchar *summary;
+    const gchar *status;
+    JsonNode *tasks;
+    gboolean ready;
+    JsonNode *spawn_time;
+    JsonNode *ready_time;
+    const gchar *err;
+} ChangeFields;
+
+static const JsonField change_fields[] =
+{
+    FIELD ("id", FIELD_STRING, ChangeFields, id),
+    FIELD ("kind", FIELD_STRING, ChangeFields, kind),
+    FIELD ("summary", FIELD_STRING, ChangeFields, summary),
+    FIELD ("status", FIELD_STRING, ChangeFields, status),
+    FIELD ("tasks", FIELD_NODE, ChangeFields, tasks),
+    FIELD ("ready", FIELD_BOOLEAN, ChangeFields, ready),
+    FIELD ("spawn-time", FIELD_NODE, ChangeFields, spawn_time),
+    FIELD ("ready-time", FIELD_NODE, ChangeFields, ready_time),
+    FIELD ("err", FIELD_STRING, ChangeFields, err)
+};
+
+/* Check if a task is unchanged, so it can be reused when polling. Only the
+ * status, progress and ready time are expected to change */
+static gboolean
+task_unchanged (SnapdTask *task, const TaskFields *fields, const ProgressFields *progress)
+{
+    return g_strcmp0 (snapd_task_get_id (task), fields->id) == 0 &&
+           g_strcmp0 (snapd_task_get_status (task), fields->status) == 0 &&
+           g_strcmp0 (snapd_task_get_summary (task), fields->summary) == 0 &&
+           g_strcmp0 (snapd_task_get_progress_label (task), progress->label) == 0 &&
+           snapd_task_get_progress_done (task) == progress->done &&
+           snapd_task_get_progress_total (task) == progress->total &&
+           _snapd_task_get_ready_timestamp (task)->is_set == (node_get_string (fields->ready_time, NULL) != NULL);
+}
+
+static gboolean
+change_unchanged (SnapdChange *change, const ChangeFields *fields)
+{
+    return g_strcmp0 (snapd_change_get_id (change), fields->id) == 0 &&
+           g_strcmp0 (snapd_change_get_kind (change), fields->kind) == 0 &&
+           g_strcmp0 (snapd_change_get_summary (change), fields->summary) == 0 &&
+           g_strcmp0 (snapd_change_get_status (change), fields->status) == 0 &&
+           !!snapd_change_get_ready (change) == !!fields->ready &&
+           g_strcmp0 (snapd_change_get_error (change), fields->err) == 0 &&
+           _snapd_change_get_ready_timestamp (change)->is_set == (node_get_string (fields->ready_time, NULL) != NULL);
+}
+
+SnapdChange *
+_snapd_json_parse_change (JsonNode *node, GError **error)
+{
+    return _snapd_json_parse_change_update (node, NULL, error);
+}
+
+SnapdChange *
+_snapd_json_parse_change_update (JsonNode *node, SnapdChange *previous, GError **error)
+{
+    ChangeFields fields = { NULL };
+    if (!decode_object (node, "change", change_fields, G_N_ELEMENTS (change_fields), &fields, error))
+        return NULL;
+
+    GPtrArray *previous_tasks = previous != NULL ? snapd_change_get_tasks (previous) : NULL;
+    g_autoptr(JsonArray) array = node_get_array (fields.tasks);
+    g_autoptr(GPtrArray) tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    gboolean tasks_unchanged = previous_tasks != NULL && previous_tasks->len == json_array_get_length (array);
+    for (guint i = 0; i < json_array_get_length (array); i++) {
+        TaskFields task = { NULL };
+        if (!decode_object (json_array_get_element (array, i), "task", task_fields, G_N_ELEMENTS (task_fields), &task, error))
+            return NULL;
+        ProgressFields progress = { NULL, 0, 0 };
+        if (task.progress != NULL)
+            decode_fields (task.progress, progress_fields, G_N_ELEMENTS (progress_fields), &progress);
+
+        /* Tasks are returned in the same order each time, so reuse the previous one if it hasn't moved */
+        SnapdTask *previous_task = previous_tasks != NULL && i < previous_tasks->len ? previous_tasks->pdata[i] : NULL;
+        if (previous_task != NULL && task_unchanged (previous_task, &task, &progress)) {
+            g_ptr_array_add (tasks, g_object_ref (previous_task));
+            continue;
+        }
+        tasks_unchanged = FALSE;
+
+        SnapdTimestamp spawn_time = { 0 }, ready_time = { 0 };
+        node_get_timestamp (task.spawn_time, &spawn_time);
+        node_get_timestamp (task.ready_time, &ready_time);
+        SnapdTask *t = _snapd_task_new (task.id,
+                                        task.kind,
+                                        task.summary,
+                                        task.status,
+                                        progress.label,
+                                        progress.done,
+                                        progress.total,
+                                        &spawn_time,
+                                        &ready_time);
+        _snapd_task_update_estimate (t, previous_task);
+        g_ptr_array_add (tasks, t);
+    }
+
+    if (tasks_unchanged && change_unchanged (previous, &fields))
+        return g_object_ref (previous);
+
+    SnapdTimestamp spawn_time = { 0 }, ready_time = { 0 };
+    node_get_timestamp (fields.spawn_time, &spawn_time);
+    node_get_timestamp (fields.ready_time, &ready_time);
+    return _snapd_change_new (fields.id,
+                              fields.kind,
+                              fields.summary,
+                              fields.status,
+                              g_steal_pointer (&tasks),
+                              fields.ready,
+                              &spawn_time,
+                              &ready_time,
+                              fields.err);
 }
 
-SnapdChange *
-_snapd_json_parse_change (JsonNode *node, GError **error)
+SnapdNotice *
+_snapd_json_parse_notice (JsonNode *node, GError **error)
 {
     if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
         g_set_error (error,
                      SNAPD_ERROR,
                      SNAPD_ERROR_READ_FAILED,
-                     "Unexpected change type");
+                     "Unexpected notice type");
         return NULL;
     }
     JsonObject *object = json_node_get_object (node);
 
-    g_autoptr(JsonArray) array = _snapd_json_get_array (object, "tasks");
-    g_autoptr(GPtrArray) tasks = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (array); i++) {
-        JsonNode *node = json_array_get_element (array, i);
-
-        if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-            g_set_error (error,
-                         SNAPD_ERROR,
-                         SNAPD_ERROR_READ_FAILED,
-                         "Unexpected task type");
-            return NULL;
+    g_autoptr(GHashTable) last_data = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    JsonObject *data = _snapd_json_get_object (object, "last-data");
+    if (data != NULL) {
+        JsonObjectIter iter;
+        json_object_iter_init (&iter, data);
+        const gchar *name;
+        JsonNode *value_node;
+        while (json_object_iter_next (&iter, &name, &value_node)) {
+            if (json_node_get_value_type (value_node) == G_TYPE_STRING)
+                g_hash_table_insert (last_data, g_strdup (name), g_strdup (json_node_get_string (value_node)));
         }
-        JsonObject *object = json_node_get_object (node);
-        JsonObject *progress = _snapd_json_get_object (object, "progress");
-        g_autoptr(GDateTime) spawn_time = _snapd_json_get_date_time (object, "spawn-time");
-        g_autoptr(GDateTime) ready_time = _snapd_json_get_date_time (object, "ready-time");
-
-        g_autoptr(SnapdTask) t = g_object_new (SNAPD_TYPE_TASK,
-                                               "id", _snapd_json_get_string (object, "id", NULL),
-                                               "kind", _snapd_json_get_string (object, "kind", NULL),
-                                               "summary", _snapd_json_get_string (object, "summary", NULL),
-                                               "status", _snapd_json_get_string (object, "status", NULL),
-                                               "progress-label", progress != NULL ? _snapd_json_get_string (progress, "label", NULL) : NULL,
-                                               "progress-done", progress != NULL ? _snapd_json_get_int (progress, "done", 0) : 0,
-                                               "progress-total", progress != NULL ? _snapd_json_get_int (progress, "total", 0) : 0,
-                                               "spawn-time", spawn_time,
-                                               "ready-time", ready_time,
-                                               NULL);
-        g_ptr_array_add (tasks, g_steal_pointer (&t));
     }
 
-    g_autoptr(GDateTime) main_spawn_time = _snapd_json_get_date_time (object, "spawn-time");
-    g_autoptr(GDateTime) main_ready_time = _snapd_json_get_date_time (object, "ready-time");
+    g_autoptr(GDateTime) first_occurred = _snapd_json_get_date_time (object, "first-occurred");
+    g_autoptr(GDateTime) last_occurred = _snapd_json_get_date_time (object, "last-occurred");
+    g_autoptr(GDateTime) last_repeated = _snapd_json_get_date_time (object, "last-repeated");
 
-    return g_object_new (SNAPD_TYPE_CHANGE,
+    return g_object_new (SNAPD_TYPE_NOTICE,
                          "id", _snapd_json_get_string (object, "id", NULL),
-                         "kind", _snapd_json_get_string (object, "kind", NULL),
-                         "summary", _snapd_json_get_string (object, "summary", NULL),
-                         "status", _snapd_json_get_string (object, "status", NULL),
-                         "tasks", tasks,
-                         "ready", _snapd_json_get_bool (object, "ready", FALSE),
-                         "spawn-time", main_spawn_time,
-                         "ready-time", main_ready_time,
-                         "error", _snapd_json_get_string (object, "err", NULL),
+                         "notice-type", _snapd_json_get_string (object, "type", NULL),
+                         "key", _snapd_json_get_string (object, "key", NULL),
+                         "first-occurred", first_occurred,
+                         "last-occurred", last_occurred,
+                         "last-repeated", last_repeated,
+                         "occurrences", _snapd_json_get_int (object, "occurrences", 0),
+                         "last-data", last_data,
+                         NULL);
+}
+
+SnapdLog *
+_snapd_json_parse_log (JsonNode *node, GError **error)
+{
+    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "Unexpected log type");
+        return NULL;
+    }
+    JsonObject *object = json_node_get_object (node);
+
+    g_autoptr(GDateTime) timestamp = _snapd_json_get_date_time (object, "timestamp");
+
+    return g_object_new (SNAPD_TYPE_LOG,
+                         "timestamp", timestamp,
+                         "sid", _snapd_json_get_string (object, "sid", NULL),
+                         "pid", _snapd_json_get_string (object, "pid", NULL),
+                         "message", _snapd_json_get_string (object, "message", NULL),
                          NULL);
 }
 
+typedef struct
+{
+    const gchar *name;
+    gsize length;
+    gint value;
+} EnumValue;
+
+#define ENUM_VALUE(name, value) { name, sizeof (name) - 1, value }
+
+static const EnumValue confinement_values[] =
+{
+    ENUM_VALUE ("strict", SNAPD_CONFINEMENT_STRICT),
+    ENUM_VALUE ("classic", SNAPD_CONFINEMENT_CLASSIC),
+    ENUM_VALUE ("devmode", SNAPD_CONFINEMENT_DEVMODE)
+};
+
+static const EnumValue snap_type_values[] =
+{
+    ENUM_VALUE ("app", SNAPD_SNAP_TYPE_APP),
+    ENUM_VALUE ("kernel", SNAPD_SNAP_TYPE_KERNEL),
+    ENUM_VALUE ("gadget", SNAPD_SNAP_TYPE_GADGET),
+    ENUM_VALUE ("os", SNAPD_SNAP_TYPE_OS),
+    ENUM_VALUE ("core", SNAPD_SNAP_TYPE_CORE),
+    ENUM_VALUE ("base", SNAPD_SNAP_TYPE_BASE),
+    ENUM_VALUE ("snapd", SNAPD_SNAP_TYPE_SNAPD)
+};
+
+static const EnumValue snap_status_values[] =
+{
+    ENUM_VALUE ("available", SNAPD_SNAP_STATUS_AVAILABLE),
+    ENUM_VALUE ("priced", SNAPD_SNAP_STATUS_PRICED),
+    ENUM_VALUE ("installed", SNAPD_SNAP_STATUS_INSTALLED),
+    ENUM_VALUE ("active", SNAPD_SNAP_STATUS_ACTIVE)
+};
+
+static const EnumValue publisher_validation_values[] =
+{
+    ENUM_VALUE ("unproven", SNAPD_PUBLISHER_VALIDATION_UNPROVEN),
+    ENUM_VALUE ("starred", SNAPD_PUBLISHER_VALIDATION_STARRED),
+    ENUM_VALUE ("verified", SNAPD_PUBLISHER_VALIDATION_VERIFIED)
+};
+
+static const EnumValue daemon_type_values[] =
+{
+    ENUM_VALUE ("simple", SNAPD_DAEMON_TYPE_SIMPLE),
+    ENUM_VALUE ("forking", SNAPD_DAEMON_TYPE_FORKING),
+    ENUM_VALUE ("oneshot", SNAPD_DAEMON_TYPE_ONESHOT),
+    ENUM_VALUE ("dbus", SNAPD_DAEMON_TYPE_DBUS),
+    ENUM_VALUE ("notify", SNAPD_DAEMON_TYPE_NOTIFY)
+};
+
+/* Decode one of a small set of strings. The length and first character rule out
+ * almost every other entry, so at most one full comparison is normally done */
+static gint
+parse_enum (const EnumValue *values, gsize n_values, const gchar *value, gint default_value)
+{
+    if (value == NULL)
+        return default_value;
+
+    gsize length = strlen (value);
+    for (gsize i = 0; i < n_values; i++) {
+        if (values[i].length == length && values[i].name[0] == value[0] && memcmp (values[i].name, value, length) == 0)
+            return values[i].value;
+    }
+
+    return default_value;
+}
+
 static SnapdConfinement
 parse_confinement (const gchar *value)
 {
-    if (strcmp (value, "strict") == 0)
-        return SNAPD_CONFINEMENT_STRICT;
-    else if (strcmp (value, "classic") == 0)
-        return SNAPD_CONFINEMENT_CLASSIC;
-    else if (strcmp (value, "devmode") == 0)
-        return SNAPD_CONFINEMENT_DEVMODE;
-    else
-        return SNAPD_CONFINEMENT_UNKNOWN;
+    return parse_enum (confinement_values, G_N_ELEMENTS (confinement_values), value, SNAPD_CONFINEMENT_UNKNOWN);
+}
+
+/* Members of the objects that are decoded in one pass, as snaps have many
+ * members and there can be thousands of them in a response */
+enum
+{
+    CHANNEL_CHANNEL,
+    CHANNEL_CONFINEMENT,
+    CHANNEL_EPOCH,
+    CHANNEL_RELEASED_AT,
+    CHANNEL_REVISION,
+    CHANNEL_SIZE,
+    CHANNEL_VERSION,
+    N_CHANNEL_MEMBERS
+};
+
+static const EnumValue channel_members[] =
+{
+    ENUM_VALUE ("channel", CHANNEL_CHANNEL),
+    ENUM_VALUE ("confinement", CHANNEL_CONFINEMENT),
+    ENUM_VALUE ("epoch", CHANNEL_EPOCH),
+    ENUM_VALUE ("released-at", CHANNEL_RELEASED_AT),
+    ENUM_VALUE ("revision", CHANNEL_REVISION),
+    ENUM_VALUE ("size", CHANNEL_SIZE),
+    ENUM_VALUE ("version", CHANNEL_VERSION)
+};
+
+enum
+{
+    SNAP_APPS,
+    SNAP_BASE,
+    SNAP_BROKEN,
+    SNAP_CHANNEL,
+    SNAP_CHANNELS,
+    SNAP_COMMON_IDS,
+    SNAP_CONFINEMENT,
+    SNAP_CONTACT,
+    SNAP_DESCRIPTION,
+#ifndef DISABLE_LEGACY_SNAPD
+    SNAP_DEVELOPER,
+#endif
+    SNAP_DEVMODE,
+    SNAP_DOWNLOAD_SIZE,
+    SNAP_ICON,
+    SNAP_ID,
+    SNAP_INSTALL_DATE,
+    SNAP_INSTALLED_SIZE,
+    SNAP_JAILMODE,
+    SNAP_LICENSE,
+    SNAP_MEDIA,
+    SNAP_MOUNTED_FROM,
+    SNAP_NAME,
+    SNAP_PRICES,
+    SNAP_PRIVATE,
+    SNAP_PUBLISHER,
+    SNAP_REVISION,
+    SNAP_STATUS,
+    SNAP_STORE_URL,
+    SNAP_SUMMARY,
+    SNAP_TITLE,
+    SNAP_TRACKING_CHANNEL,
+    SNAP_TRACKS,
+#ifndef DISABLE_LEGACY_SNAPD
+    SNAP_TRACKS_LEGACY,
+#endif
+    SNAP_TRYMODE,
+    SNAP_TYPE,
+    SNAP_VERSION,
+    SNAP_WEBSITE,
+    N_SNAP_MEMBERS
+};
+
+static const EnumValue snap_members[] =
+{
+    ENUM_VALUE ("apps", SNAP_APPS),
+    ENUM_VALUE ("base", SNAP_BASE),
+    ENUM_VALUE ("broken", SNAP_BROKEN),
+    ENUM_VALUE ("channel", SNAP_CHANNEL),
+    ENUM_VALUE ("channels", SNAP_CHANNELS),
+    ENUM_VALUE ("common-ids", SNAP_COMMON_IDS),
+    ENUM_VALUE ("confinement", SNAP_CONFINEMENT),
+    ENUM_VALUE ("contact", SNAP_CONTACT),
+    ENUM_VALUE ("description", SNAP_DESCRIPTION),
+#ifndef DISABLE_LEGACY_SNAPD
+    ENUM_VALUE ("developer", SNAP_DEVELOPER),
+#endif
+    ENUM_VALUE ("devmode", SNAP_DEVMODE),
+    ENUM_VALUE ("download-size", SNAP_DOWNLOAD_SIZE),
+    ENUM_VALUE ("icon", SNAP_ICON),
+    ENUM_VALUE ("id", SNAP_ID),
+    ENUM_VALUE ("install-date", SNAP_INSTALL_DATE),
+    ENUM_VALUE ("installed-size", SNAP_INSTALLED_SIZE),
+    ENUM_VALUE ("jailmode", SNAP_JAILMODE),
+    ENUM_VALUE ("license", SNAP_LICENSE),
+    ENUM_VALUE ("media", SNAP_MEDIA),
+    ENUM_VALUE ("mounted-from", SNAP_MOUNTED_FROM),
+    ENUM_VALUE ("name", SNAP_NAME),
+    ENUM_VALUE ("prices", SNAP_PRICES),
+    ENUM_VALUE ("private", SNAP_PRIVATE),
+    ENUM_VALUE ("publisher", SNAP_PUBLISHER),
+    ENUM_VALUE ("revision", SNAP_REVISION),
+    ENUM_VALUE ("status", SNAP_STATUS),
+    ENUM_VALUE ("store-url", SNAP_STORE_URL),
+    ENUM_VALUE ("summary", SNAP_SUMMARY),
+    ENUM_VALUE ("title", SNAP_TITLE),
+    ENUM_VALUE ("tracking-channel", SNAP_TRACKING_CHANNEL),
+    ENUM_VALUE ("tracks", SNAP_TRACKS),
+#ifndef DISABLE_LEGACY_SNAPD
+    /* The tracks field was originally incorrectly named, fixed in snapd 61ad9ed (2.29.5) */
+    ENUM_VALUE ("Tracks", SNAP_TRACKS_LEGACY),
+#endif
+    ENUM_VALUE ("trymode", SNAP_TRYMODE),
+    ENUM_VALUE ("type", SNAP_TYPE),
+    ENUM_VALUE ("version", SNAP_VERSION),
+    ENUM_VALUE ("website", SNAP_WEBSITE)
+};
+
+/* Visit each member of an object once, storing the ones in @keys at the index they map to */
+static void
+collect_members (JsonObject *object, const EnumValue *keys, gsize n_keys, JsonNode **members)
+{
+    JsonObjectIter iter;
+    json_object_iter_init (&iter, object);
+    const gchar *name;
+    JsonNode *node;
+    while (json_object_iter_next (&iter, &name, &node)) {
+        gint index = parse_enum (keys, n_keys, name, -1);
+        if (index >= 0)
+            members[index] = node;
+    }
 }
 
 SnapdSystemInformation *
@@ -652,65 +1463,75 @@ _snapd_json_parse_system_information (JsonNode *node, GError **error)
                          NULL);
 }
 
-SnapdSnap *
-_snapd_json_parse_snap (JsonNode *node, GError **error)
+typedef struct
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected snap type");
+    gboolean active;
+    const gchar *common_id;
+    const gchar *daemon;
+    const gchar *desktop_file;
+    gboolean enabled;
+    const gchar *name;
+    const gchar *snap;
+} AppFields;
+
+static const JsonField app_fields[] =
+{
+    FIELD ("active", FIELD_BOOLEAN, AppFields, active),
+    FIELD ("common-id", FIELD_STRING, AppFields, common_id),
+    FIELD ("daemon", FIELD_STRING, AppFields, daemon),
+    FIELD ("desktop-file", FIELD_STRING, AppFields, desktop_file),
+    FIELD ("enabled", FIELD_BOOLEAN, AppFields, enabled),
+    FIELD ("name", FIELD_STRING, AppFields, name),
+    FIELD ("snap", FIELD_STRING, AppFields, snap)
+};
+
+static SnapdApp *
+parse_app (JsonNode *node, const gchar *snap_name, SnapdArena *arena, GError **error)
+{
+    AppFields fields = { FALSE };
+    if (!decode_object (node, "app", app_fields, G_N_ELEMENTS (app_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
-    const gchar *name = _snapd_json_get_string (object, "name", NULL);
-
-    SnapdConfinement confinement = parse_confinement (_snapd_json_get_string (object, "confinement", ""));
-
-    const gchar *snap_type_string = _snapd_json_get_string (object, "type", "");
-    SnapdSnapType snap_type = SNAPD_SNAP_TYPE_UNKNOWN;
-    if (strcmp (snap_type_string, "app") == 0)
-        snap_type = SNAPD_SNAP_TYPE_APP;
-    else if (strcmp (snap_type_string, "kernel") == 0)
-        snap_type = SNAPD_SNAP_TYPE_KERNEL;
-    else if (strcmp (snap_type_string, "gadget") == 0)
-        snap_type = SNAPD_SNAP_TYPE_GADGET;
-    else if (strcmp (snap_type_string, "os") == 0)
-        snap_type = SNAPD_SNAP_TYPE_OS;
-    else if (strcmp (snap_type_string, "core") == 0)
-        snap_type = SNAPD_SNAP_TYPE_CORE;
-    else if (strcmp (snap_type_string, "base") == 0)
-        snap_type = SNAPD_SNAP_TYPE_BASE;
-    else if (strcmp (snap_type_string, "snapd") == 0)
-        snap_type = SNAPD_SNAP_TYPE_SNAPD;
-
-    const gchar *snap_status_string = _snapd_json_get_string (object, "status", "");
-    SnapdSnapStatus snap_status = SNAPD_SNAP_STATUS_UNKNOWN;
-    if (strcmp (snap_status_string, "available") == 0)
-        snap_status = SNAPD_SNAP_STATUS_AVAILABLE;
-    else if (strcmp (snap_status_string, "priced") == 0)
-        snap_status = SNAPD_SNAP_STATUS_PRICED;
-    else if (strcmp (snap_status_string, "installed") == 0)
-        snap_status = SNAPD_SNAP_STATUS_INSTALLED;
-    else if (strcmp (snap_status_string, "active") == 0)
-        snap_status = SNAPD_SNAP_STATUS_ACTIVE;
-
-    g_autoptr(JsonArray) apps = _snapd_json_get_array (object, "apps");
-    g_autoptr(GPtrArray) apps_array = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (apps); i++) {
+    SnapdDaemonType daemon_type = SNAPD_DAEMON_TYPE_NONE;
+    if (fields.daemon != NULL)
+        daemon_type = parse_enum (daemon_type_values, G_N_ELEMENTS (daemon_type_values), fields.daemon, SNAPD_DAEMON_TYPE_UNKNOWN);
+
+    return _snapd_app_new (arena,
+                           fields.name,
+                           fields.active,
+                           fields.common_id,
+                           daemon_type,
+                           fields.desktop_file,
+                           fields.enabled,
+                           snap_name ? snap_name : fields.snap);
+}
+
+/* Parse the members of a snap that take the most work to build */
+static gboolean
+parse_snap_details (JsonNode **members, const gchar *name, SnapdSnapFields fields, SnapdArena *arena,
+                    GPtrArray **apps_out, GPtrArray **channels_out, GPtrArray **common_ids_out, SnapdTimestamp *install_date_out,
+                    GPtrArray **prices_out, GPtrArray **media_out, GPtrArray **screenshots_out, GPtrArray **tracks_out,
+                    GError **error)
+{
+    g_autoptr(JsonArray) apps = node_get_array (members[SNAP_APPS]);
+    g_autoptr(GPtrArray) apps_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_APPS) != 0)
+        apps_array = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; apps_array != NULL && i < json_array_get_length (apps); i++) {
         JsonNode *node = json_array_get_element (apps, i);
 
-        SnapdApp *app = _snapd_json_parse_app (node, name, error);
+        SnapdApp *app = parse_app (node, name, arena, error);
         if (app == NULL)
-            return NULL;
+            return FALSE;
 
         g_ptr_array_add (apps_array, app);
     }
 
-    JsonObject *channels = _snapd_json_get_object (object, "channels");
-    g_autoptr(GPtrArray) channels_array = g_ptr_array_new_with_free_func (g_object_unref);
-    if (channels != NULL) {
+    JsonObject *channels = node_get_object (members[SNAP_CHANNELS]);
+    g_autoptr(GPtrArray) channels_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_CHANNELS) != 0)
+        channels_array = g_ptr_array_new_with_free_func (g_object_unref);
+    if (channels_array != NULL && channels != NULL) {
         JsonObjectIter iter;
         json_object_iter_init (&iter, channels);
         const gchar *name;
@@ -718,45 +1539,49 @@ _snapd_json_parse_snap (JsonNode *node, GError **error)
         while (json_object_iter_next (&iter, &name, &channel_node)) {
             if (json_node_get_value_type (channel_node) != JSON_TYPE_OBJECT) {
                 g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected channel type");
-                return NULL;
+                return FALSE;
             }
-            JsonObject *c = json_node_get_object (channel_node);
-
-            SnapdConfinement confinement = parse_confinement (_snapd_json_get_string (c, "confinement", ""));
-            g_autoptr(GDateTime) released_at = _snapd_json_get_date_time (c, "released-at");
-
-            g_autoptr(SnapdChannel) channel = g_object_new (SNAPD_TYPE_CHANNEL,
-                                                            "confinement", confinement,
-                                                            "epoch", _snapd_json_get_string (c, "epoch", NULL),
-                                                            "name", _snapd_json_get_string (c, "channel", NULL),
-                                                            "released-at", released_at,
-                                                            "revision", _snapd_json_get_string (c, "revision", NULL),
-                                                            "size", _snapd_json_get_int (c, "size", 0),
-                                                            "version", _snapd_json_get_string (c, "version", NULL),
-                                                            NULL);
-            g_ptr_array_add (channels_array, g_steal_pointer (&channel));
+            JsonNode *c[N_CHANNEL_MEMBERS] = { NULL };
+            collect_members (json_node_get_object (channel_node), channel_members, G_N_ELEMENTS (channel_members), c);
+
+            SnapdConfinement confinement = parse_confinement (node_get_string (c[CHANNEL_CONFINEMENT], ""));
+            SnapdTimestamp released_at = { 0 };
+            node_get_timestamp (c[CHANNEL_RELEASED_AT], &released_at);
+
+            SnapdChannel *channel = _snapd_channel_new (arena,
+                                                        confinement,
+                                                        node_get_string (c[CHANNEL_EPOCH], NULL),
+                                                        node_get_string (c[CHANNEL_CHANNEL], NULL),
+                                                        &released_at,
+                                                        node_get_string (c[CHANNEL_REVISION], NULL),
+                                                        node_get_int (c[CHANNEL_SIZE], 0),
+                                                        node_get_string (c[CHANNEL_VERSION], NULL));
+            g_ptr_array_add (channels_array, channel);
         }
     }
 
-    g_autoptr(JsonArray) common_ids = _snapd_json_get_array (object, "common-ids");
-    g_autoptr(GPtrArray) common_ids_array = g_ptr_array_new ();
-    for (guint i = 0; i < json_array_get_length (common_ids); i++) {
+    g_autoptr(JsonArray) common_ids = node_get_array (members[SNAP_COMMON_IDS]);
+    g_autoptr(GPtrArray) common_ids_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_COMMON_IDS) != 0)
+        common_ids_array = g_ptr_array_new ();
+    for (guint i = 0; common_ids_array != NULL && i < json_array_get_length (common_ids); i++) {
         JsonNode *node = json_array_get_element (common_ids, i);
 
         if (json_node_get_value_type (node) != G_TYPE_STRING) {
             g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected common ID type");
-            return NULL;
+            return FALSE;
         }
 
         g_ptr_array_add (common_ids_array, (gpointer) json_node_get_string (node));
     }
-    g_ptr_array_add (common_ids_array, NULL);
-
-    g_autoptr(GDateTime) install_date = _snapd_json_get_date_time (object, "install-date");
-
-    JsonObject *prices = _snapd_json_get_object (object, "prices");
-    g_autoptr(GPtrArray) prices_array = g_ptr_array_new_with_free_func (g_object_unref);
-    if (prices != NULL) {
+    if (common_ids_array != NULL)
+        g_ptr_array_add (common_ids_array, NULL);
+
+    JsonObject *prices = node_get_object (members[SNAP_PRICES]);
+    g_autoptr(GPtrArray) prices_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_PRICES) != 0)
+        prices_array = g_ptr_array_new_with_free_func (g_object_unref);
+    if (prices_array != NULL && prices != NULL) {
         JsonObjectIter iter;
         json_object_iter_init (&iter, prices);
         const gchar *currency;
@@ -764,160 +1589,284 @@ _snapd_json_parse_snap (JsonNode *node, GError **error)
         while (json_object_iter_next (&iter, &currency, &amount_node)) {
             if (json_node_get_value_type (amount_node) != G_TYPE_DOUBLE) {
                 g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected price type");
-                return NULL;
+                return FALSE;
             }
 
-            g_autoptr(SnapdPrice) price = g_object_new (SNAPD_TYPE_PRICE,
-                                                        "amount", json_node_get_double (amount_node),
-                                                        "currency", currency,
-                                                        NULL);
-            g_ptr_array_add (prices_array, g_steal_pointer (&price));
+            g_ptr_array_add (prices_array, _snapd_price_new (arena, json_node_get_double (amount_node), currency));
         }
     }
 
-    g_autoptr(JsonArray) media = _snapd_json_get_array (object, "media");
-    g_autoptr(GPtrArray) media_array = g_ptr_array_new_with_free_func (g_object_unref);
-    for (guint i = 0; i < json_array_get_length (media); i++) {
+    g_autoptr(JsonArray) media = node_get_array (members[SNAP_MEDIA]);
+    g_autoptr(GPtrArray) media_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_MEDIA) != 0)
+        media_array = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; media_array != NULL && i < json_array_get_length (media); i++) {
         JsonNode *node = json_array_get_element (media, i);
 
         if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
             g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected media type");
-            return NULL;
+            return FALSE;
         }
 
         JsonObject *s = json_node_get_object (node);
-        g_autoptr(SnapdMedia) media = g_object_new (SNAPD_TYPE_MEDIA,
-                                                    "type", _snapd_json_get_string (s, "type", NULL),
-                                                    "url", _snapd_json_get_string (s, "url", NULL),
-                                                    "width", (guint) _snapd_json_get_int (s, "width", 0),
-                                                    "height", (guint) _snapd_json_get_int (s, "height", 0),
-                                                    NULL);
-        g_ptr_array_add (media_array, g_steal_pointer (&media));
+        g_ptr_array_add (media_array, _snapd_media_new (arena,
+                                                        _snapd_json_get_string (s, "type", NULL),
+                                                        _snapd_json_get_string (s, "url", NULL),
+                                                        (guint) _snapd_json_get_int (s, "width", 0),
+                                                        (guint) _snapd_json_get_int (s, "height", 0)));
     }
 
-    g_autoptr(GPtrArray) screenshots_array = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GPtrArray) screenshots_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_MEDIA) != 0)
+        screenshots_array = g_ptr_array_new_with_free_func (g_object_unref);
 
-    /* The tracks field was originally incorrectly named, fixed in snapd 61ad9ed (2.29.5) */
-    g_autoptr(JsonArray) tracks = NULL;
-    if (json_object_has_member (object, "Tracks"))
-        tracks = _snapd_json_get_array (object, "Tracks");
-    else
-        tracks = _snapd_json_get_array (object, "tracks");
-    g_autoptr(GPtrArray) track_array = g_ptr_array_new ();
-    for (guint i = 0; i < json_array_get_length (tracks); i++) {
+#ifndef DISABLE_LEGACY_SNAPD
+    g_autoptr(JsonArray) tracks = node_get_array (members[SNAP_TRACKS_LEGACY] != NULL ? members[SNAP_TRACKS_LEGACY] : members[SNAP_TRACKS]);
+#else
+    g_autoptr(JsonArray) tracks = node_get_array (members[SNAP_TRACKS]);
+#endif
+    g_autoptr(GPtrArray) track_array = NULL;
+    if ((fields & SNAPD_SNAP_FIELDS_TRACKS) != 0)
+        track_array = g_ptr_array_new ();
+    for (guint i = 0; track_array != NULL && i < json_array_get_length (tracks); i++) {
         JsonNode *node = json_array_get_element (tracks, i);
 
         if (json_node_get_value_type (node) != G_TYPE_STRING) {
             g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED, "Unexpected track type");
-            return NULL;
+            return FALSE;
         }
 
         g_ptr_array_add (track_array, (gpointer) json_node_get_string (node));
     }
-    g_ptr_array_add (track_array, NULL);
+    if (track_array != NULL)
+        g_ptr_array_add (track_array, NULL);
+
+    *apps_out = g_steal_pointer (&apps_array);
+    *channels_out = g_steal_pointer (&channels_array);
+    *common_ids_out = g_steal_pointer (&common_ids_array);
+    if ((fields & SNAPD_SNAP_FIELDS_INSTALL_DATE) != 0)
+        node_get_timestamp (members[SNAP_INSTALL_DATE], install_date_out);
+    *prices_out = g_steal_pointer (&prices_array);
+    *media_out = g_steal_pointer (&media_array);
+    *screenshots_out = g_steal_pointer (&screenshots_array);
+    *tracks_out = g_steal_pointer (&track_array);
+
+    return TRUE;
+}
+
+static SnapdSnap *
+load_snap_details (gpointer data)
+{
+    return _snapd_json_parse_snap (data, NULL);
+}
+
+static SnapdSnap *
+parse_snap (JsonNode *node, gboolean lazy, SnapdSnapFields fields, SnapdArena *arena, GError **error)
+{
+    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "Unexpected snap type");
+        return NULL;
+    }
+    JsonNode *members[N_SNAP_MEMBERS] = { NULL };
+    collect_members (json_node_get_object (node), snap_members, G_N_ELEMENTS (snap_members), members);
+
+    const gchar *name = node_get_string (members[SNAP_NAME], NULL);
+
+    SnapdConfinement confinement = parse_confinement (node_get_string (members[SNAP_CONFINEMENT], ""));
+
+    SnapdSnapType snap_type = parse_enum (snap_type_values, G_N_ELEMENTS (snap_type_values),
+                                          node_get_string (members[SNAP_TYPE], NULL),
+                                          SNAPD_SNAP_TYPE_UNKNOWN);
+    SnapdSnapStatus snap_status = parse_enum (snap_status_values, G_N_ELEMENTS (snap_status_values),
+                                              node_get_string (members[SNAP_STATUS], NULL),
+                                              SNAPD_SNAP_STATUS_UNKNOWN);
+
+    /* In lazy mode these are parsed from the retained node when first used */
+    g_autoptr(GPtrArray) apps_array = NULL;
+    g_autoptr(GPtrArray) channels_array = NULL;
+    g_autoptr(GPtrArray) common_ids_array = NULL;
+    SnapdTimestamp install_date = { 0 };
+    g_autoptr(GPtrArray) prices_array = NULL;
+    g_autoptr(GPtrArray) media_array = NULL;
+    g_autoptr(GPtrArray) screenshots_array = NULL;
+    g_autoptr(GPtrArray) track_array = NULL;
+    if (!lazy && !parse_snap_details (members, name, fields, arena,
+                                      &apps_array, &channels_array, &common_ids_array, &install_date,
+                                      &prices_array, &media_array, &screenshots_array, &track_array,
+                                      error))
+        return NULL;
 
+#ifndef DISABLE_LEGACY_SNAPD
     /* The developer field originally contained the publisher username */
-    const gchar *publisher_username = _snapd_json_get_string (object, "developer", NULL);
-    JsonObject *publisher = _snapd_json_get_object (object, "publisher");
+    const gchar *publisher_username = node_get_string (members[SNAP_DEVELOPER], NULL);
+#else
+    const gchar *publisher_username = NULL;
+#endif
+    JsonObject *publisher = node_get_object (members[SNAP_PUBLISHER]);
     const gchar *publisher_display_name = NULL;
     const gchar *publisher_id = NULL;
     SnapdPublisherValidation publisher_validation = SNAPD_PUBLISHER_VALIDATION_UNKNOWN;
-    if (publisher != NULL) {
+    if ((fields & SNAPD_SNAP_FIELDS_PUBLISHER) == 0)
+        publisher_username = NULL;
+    else if (publisher != NULL) {
         publisher_display_name = _snapd_json_get_string (publisher, "display-name", NULL);
         publisher_id = _snapd_json_get_string (publisher, "id", NULL);
         publisher_username = _snapd_json_get_string (publisher, "username", publisher_username);
-        const gchar *validation = _snapd_json_get_string (publisher, "validation", NULL);
-        if (g_strcmp0 (validation, "unproven") == 0)
-            publisher_validation = SNAPD_PUBLISHER_VALIDATION_UNPROVEN;
-        else if (g_strcmp0 (validation, "starred") == 0)
-            publisher_validation = SNAPD_PUBLISHER_VALIDATION_STARRED;
-        else if (g_strcmp0 (validation, "verified") == 0)
-            publisher_validation = SNAPD_PUBLISHER_VALIDATION_VERIFIED;
-        else
-            publisher_validation = SNAPD_PUBLISHER_VALIDATION_UNKNOWN;
+        publisher_validation = parse_enum (publisher_validation_values, G_N_ELEMENTS (publisher_validation_values),
+                                           _snapd_json_get_string (publisher, "validation", NULL),
+                                           SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
     }
 
-    return g_object_new (SNAPD_TYPE_SNAP,
-                         "apps", apps_array,
-                         "base", _snapd_json_get_string (object, "base", NULL),
-                         "broken", _snapd_json_get_string (object, "broken", NULL),
-                         "channel", _snapd_json_get_string (object, "channel", NULL),
-                         "channels", channels_array,
-                         "common-ids", (GStrv) common_ids_array->pdata,
-                         "confinement", confinement,
-                         "contact", _snapd_json_get_string (object, "contact", NULL),
-                         "description", _snapd_json_get_string (object, "description", NULL),
-                         "devmode", _snapd_json_get_bool (object, "devmode", FALSE),
-                         "download-size", _snapd_json_get_int (object, "download-size", 0),
-                         "icon", _snapd_json_get_string (object, "icon", NULL),
-                         "id", _snapd_json_get_string (object, "id", NULL),
-                         "install-date", install_date,
-                         "installed-size", _snapd_json_get_int (object, "installed-size", 0),
-                         "jailmode", _snapd_json_get_bool (object, "jailmode", FALSE),
-                         "license", _snapd_json_get_string (object, "license", NULL),
-                         "media", media_array,
-                         "mounted-from", _snapd_json_get_string (object, "mounted-from", NULL),
-                         "name", name,
-                         "prices", prices_array,
-                         "private", _snapd_json_get_bool (object, "private", FALSE),
-                         "publisher-id", publisher_id,
-                         "publisher-username", publisher_username,
-                         "publisher-display-name", publisher_display_name,
-                         "publisher-validation", publisher_validation,
-                         "revision", _snapd_json_get_string (object, "revision", NULL),
-                         "screenshots", screenshots_array,
-                         "snap-type", snap_type,
-                         "status", snap_status,
-                         "store-url", _snapd_json_get_string (object, "store-url", NULL),
-                         "summary", _snapd_json_get_string (object, "summary", NULL),
-                         "title", _snapd_json_get_string (object, "title", NULL),
-                         "tracking-channel", _snapd_json_get_string (object, "tracking-channel", NULL),
-                         "tracks", (GStrv) track_array->pdata,
-                         "trymode", _snapd_json_get_bool (object, "trymode", FALSE),
-                         "version", _snapd_json_get_string (object, "version", NULL),
-                         "website", _snapd_json_get_string (object, "website", NULL),
-                         NULL);
+    SnapdSnap *snap = g_object_new (SNAPD_TYPE_SNAP, NULL);
+    snap->arena = arena != NULL ? _snapd_arena_ref (arena) : _snapd_arena_new ();
+    snap->broken = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_BROKEN], NULL));
+    snap->id = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_ID], NULL));
+    snap->mounted_from = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_MOUNTED_FROM], NULL));
+    snap->name = _snapd_arena_strdup (snap->arena, name);
+    snap->revision = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_REVISION], NULL));
+    snap->version = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_VERSION], NULL));
+    if ((fields & SNAPD_SNAP_FIELDS_DESCRIPTION) != 0) {
+        snap->contact = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_CONTACT], NULL));
+        snap->description = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_DESCRIPTION], NULL));
+        snap->icon = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_ICON], NULL));
+        snap->license = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_LICENSE], NULL));
+        snap->store_url = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_STORE_URL], NULL));
+        snap->summary = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_SUMMARY], NULL));
+        snap->title = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_TITLE], NULL));
+        snap->website = _snapd_arena_strdup (snap->arena, node_get_string (members[SNAP_WEBSITE], NULL));
+    }
+
+    snap->apps = g_steal_pointer (&apps_array);
+    snap->base = g_intern_string (node_get_string (members[SNAP_BASE], NULL));
+    snap->channel = g_intern_string (node_get_string (members[SNAP_CHANNEL], NULL));
+    snap->channels = g_steal_pointer (&channels_array);
+    snap->common_ids = common_ids_array != NULL ? g_strdupv ((GStrv) common_ids_array->pdata) : NULL;
+    snap->confinement = confinement;
+    snap->devmode = node_get_bool (members[SNAP_DEVMODE], FALSE);
+    snap->download_size = node_get_int (members[SNAP_DOWNLOAD_SIZE], 0);
+    snap->install_date = install_date;
+    snap->installed_size = node_get_int (members[SNAP_INSTALLED_SIZE], 0);
+    snap->jailmode = node_get_bool (members[SNAP_JAILMODE], FALSE);
+    snap->media = g_steal_pointer (&media_array);
+    snap->prices = g_steal_pointer (&prices_array);
+    snap->private = node_get_bool (members[SNAP_PRIVATE], FALSE);
+    snap->publisher_id = g_intern_string (publisher_id);
+    snap->publisher_username = g_intern_string (publisher_username);
+    snap->publisher_display_name = g_intern_string (publisher_display_name);
+    snap->publisher_validation = publisher_validation;
+    snap->screenshots = g_steal_pointer (&screenshots_array);
+    snap->snap_type = snap_type;
+    snap->status = snap_status;
+    snap->tracking_channel = g_intern_string (node_get_string (members[SNAP_TRACKING_CHANNEL], NULL));
+    snap->tracks = track_array != NULL ? g_strdupv ((GStrv) track_array->pdata) : NULL;
+    snap->trymode = node_get_bool (members[SNAP_TRYMODE], FALSE);
+
+    if (lazy)
+        _snapd_snap_set_loader (snap, load_snap_details, json_node_ref (node), (GDestroyNotify) json_node_unref);
+
+    return snap;
 }
 
-SnapdApp *
-_snapd_json_parse_app (JsonNode *node, const gchar *snap_name, GError **error)
+SnapdSnap *
+_snapd_json_parse_snap (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected app type");
-        return NULL;
+    return parse_snap (node, FALSE, SNAPD_SNAP_FIELDS_ALL, NULL, error);
+}
+
+SnapdSnap *
+_snapd_json_parse_snap_full (JsonNode *node, gboolean lazy, SnapdSnapFields fields, SnapdArena *arena, GError **error)
+{
+    return parse_snap (node, lazy, fields, arena, error);
+}
+
+static void checksum_node (GChecksum *checksum, JsonNode *node);
+
+static void
+checksum_member (JsonObject *object, const gchar *name, JsonNode *node, gpointer user_data)
+{
+    GChecksum *checksum = user_data;
+    g_checksum_update (checksum, (const guchar *) name, strlen (name) + 1);
+    checksum_node (checksum, node);
+}
+
+static void
+checksum_element (JsonArray *array, guint index, JsonNode *node, gpointer user_data)
+{
+    checksum_node (user_data, node);
+}
+
+/* Add the contents of @node to @checksum, with each value tagged by its type so different documents can't be confused */
+static void
+checksum_node (GChecksum *checksum, JsonNode *node)
+{
+    switch (json_node_get_node_type (node)) {
+    case JSON_NODE_OBJECT:
+        g_checksum_update (checksum, (const guchar *) "{", 1);
+        json_object_foreach_member (json_node_get_object (node), checksum_member, checksum);
+        g_checksum_update (checksum, (const guchar *) "}", 1);
+        break;
+    case JSON_NODE_ARRAY:
+        g_checksum_update (checksum, (const guchar *) "[", 1);
+        json_array_foreach_element (json_node_get_array (node), checksum_element, checksum);
+        g_checksum_update (checksum, (const guchar *) "]", 1);
+        break;
+    case JSON_NODE_VALUE:
+        if (json_node_get_value_type (node) == G_TYPE_STRING) {
+            const gchar *value = json_node_get_string (node);
+            g_checksum_update (checksum, (const guchar *) "s", 1);
+            g_checksum_update (checksum, (const guchar *) value, strlen (value) + 1);
+        }
+        else if (json_node_get_value_type (node) == G_TYPE_INT64) {
+            gint64 value = json_node_get_int (node);
+            g_checksum_update (checksum, (const guchar *) "i", 1);
+            g_checksum_update (checksum, (const guchar *) &value, sizeof (value));
+        }
+        else if (json_node_get_value_type (node) == G_TYPE_DOUBLE) {
+            gdouble value = json_node_get_double (node);
+            g_checksum_update (checksum, (const guchar *) "d", 1);
+            g_checksum_update (checksum, (const guchar *) &value, sizeof (value));
+        }
+        else if (json_node_get_value_type (node) == G_TYPE_BOOLEAN)
+            g_checksum_update (checksum, (const guchar *) (json_node_get_boolean (node) ? "t" : "f"), 1);
+        break;
+    case JSON_NODE_NULL:
+        g_checksum_update (checksum, (const guchar *) "n", 1);
+        break;
     }
-    JsonObject *object = json_node_get_object (node);
+}
 
-    const gchar *daemon = _snapd_json_get_string (object, "daemon", NULL);
-    SnapdDaemonType daemon_type = SNAPD_DAEMON_TYPE_NONE;
-    if (daemon == NULL)
-        daemon_type = SNAPD_DAEMON_TYPE_NONE;
-    else if (strcmp (daemon, "simple") == 0)
-        daemon_type = SNAPD_DAEMON_TYPE_SIMPLE;
-    else if (strcmp (daemon, "forking") == 0)
-        daemon_type = SNAPD_DAEMON_TYPE_FORKING;
-    else if (strcmp (daemon, "oneshot") == 0)
-        daemon_type = SNAPD_DAEMON_TYPE_ONESHOT;
-    else if (strcmp (daemon, "dbus") == 0)
-        daemon_type = SNAPD_DAEMON_TYPE_DBUS;
-    else if (strcmp (daemon, "notify") == 0)
-        daemon_type = SNAPD_DAEMON_TYPE_NOTIFY;
-    else
-        daemon_type = SNAPD_DAEMON_TYPE_UNKNOWN;
-
-    const gchar *app_snap_name = _snapd_json_get_string (object, "snap", NULL);
-    return g_object_new (SNAPD_TYPE_APP,
-                         "name", _snapd_json_get_string (object, "name", NULL),
-                         "active", _snapd_json_get_bool (object, "active", FALSE),
-                         "common-id", _snapd_json_get_string (object, "common-id", NULL),
-                         "daemon-type", daemon_type,
-                         "desktop-file", _snapd_json_get_string (object, "desktop-file", NULL),
-                         "enabled", _snapd_json_get_bool (object, "enabled", FALSE),
-                         "snap", snap_name ? snap_name : app_snap_name,
-                         NULL);
+/* Parse a snap, sharing an existing object if an identical snap has already been parsed in this process */
+SnapdSnap *
+_snapd_json_parse_snap_shared (JsonNode *node, gboolean lazy, SnapdSnapFields fields, SnapdArena *arena, gboolean *is_new, GError **error)
+{
+    g_autoptr(GChecksum) checksum = g_checksum_new (G_CHECKSUM_SHA256);
+    g_autofree gchar *options = g_strdup_printf ("snap:%d:%u:", lazy ? 1 : 0, (guint) fields);
+    g_checksum_update (checksum, (const guchar *) options, strlen (options));
+    checksum_node (checksum, node);
+    const gchar *key = g_checksum_get_string (checksum);
+
+    GObject *existing = _snapd_identity_map_lookup (key);
+    if (existing != NULL) {
+        *is_new = FALSE;
+        return SNAPD_SNAP (existing);
+    }
+
+    g_autoptr(SnapdSnap) snap = parse_snap (node, lazy, fields, arena, error);
+    if (snap == NULL)
+        return NULL;
+
+    GObject *object = _snapd_identity_map_insert (key, G_OBJECT (snap));
+    *is_new = object == G_OBJECT (snap);
+    return SNAPD_SNAP (object);
+}
+
+SnapdApp *
+_snapd_json_parse_app (JsonNode *node, const gchar *snap_name, GError **error)
+{
+    return parse_app (node, snap_name, NULL, error);
 }
 
 SnapdAlias *
@@ -1043,19 +1992,123 @@ _snapd_json_parse_attributes (JsonNode *node, GError **error)
     return _snapd_json_parse_object (json_node_get_object (node), error);
 }
 
-SnapdSlot *
-_snapd_json_parse_slot (JsonNode *node, GError **error)
+/* Attributes are optional, so @object is set to %NULL if they're not present.
+ * They are only checked here, the values are converted when the plug / slot is queried */
+static gboolean
+get_optional_attributes (JsonNode *node, JsonObject **object, GError **error)
 {
+    *object = NULL;
+    if (node == NULL)
+        return TRUE;
+
     if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
         g_set_error (error,
                      SNAPD_ERROR,
                      SNAPD_ERROR_READ_FAILED,
-                     "Unexpected slot type");
-        return NULL;
+                     "Unexpected attributes type");
+        return FALSE;
     }
-    JsonObject *object = json_node_get_object (node);
 
-    g_autoptr(JsonArray) connections = _snapd_json_get_array (object, "connections");
+    *object = json_node_get_object (node);
+    return TRUE;
+}
+
+typedef struct
+{
+    const gchar *name;
+    const gchar *snap;
+    const gchar *interface;
+    const gchar *label;
+    JsonNode *connections;
+    JsonNode *attrs;
+} PlugSlotFields;
+
+static const JsonField slot_fields[] =
+{
+    FIELD ("slot", FIELD_STRING, PlugSlotFields, name),
+    FIELD ("snap", FIELD_STRING, PlugSlotFields, snap),
+    FIELD ("interface", FIELD_STRING, PlugSlotFields, interface),
+    FIELD ("label", FIELD_STRING, PlugSlotFields, label),
+    FIELD ("connections", FIELD_NODE, PlugSlotFields, connections),
+    FIELD ("attrs", FIELD_NODE, PlugSlotFields, attrs)
+};
+
+static const JsonField plug_fields[] =
+{
+    FIELD ("plug", FIELD_STRING, PlugSlotFields, name),
+    FIELD ("snap", FIELD_STRING, PlugSlotFields, snap),
+    FIELD ("interface", FIELD_STRING, PlugSlotFields, interface),
+    FIELD ("label", FIELD_STRING, PlugSlotFields, label),
+    FIELD ("connections", FIELD_NODE, PlugSlotFields, connections),
+    FIELD ("attrs", FIELD_NODE, PlugSlotFields, attrs)
+};
+
+typedef struct
+{
+    const gchar *name;
+    const gchar *snap;
+} RefFields;
+
+static const JsonField slot_ref_fields[] =
+{
+    FIELD ("slot", FIELD_STRING, RefFields, name),
+    FIELD ("snap", FIELD_STRING, RefFields, snap)
+};
+
+static const JsonField plug_ref_fields[] =
+{
+    FIELD ("plug", FIELD_STRING, RefFields, name),
+    FIELD ("snap", FIELD_STRING, RefFields, snap)
+};
+
+typedef struct
+{
+    JsonNode *slot;
+    JsonNode *plug;
+    const gchar *interface;
+    gboolean manual;
+    gboolean gadget;
+    JsonNode *slot_attrs;
+    JsonNode *plug_attrs;
+} ConnectionFields;
+
+static const JsonField connection_fields[] =
+{
+    FIELD ("slot", FIELD_NODE, ConnectionFields, slot),
+    FIELD ("plug", FIELD_NODE, ConnectionFields, plug),
+    FIELD ("interface", FIELD_STRING, ConnectionFields, interface),
+    FIELD ("manual", FIELD_BOOLEAN, ConnectionFields, manual),
+    FIELD ("gadget", FIELD_BOOLEAN, ConnectionFields, gadget),
+    FIELD ("slot-attrs", FIELD_NODE, ConnectionFields, slot_attrs),
+    FIELD ("plug-attrs", FIELD_NODE, ConnectionFields, plug_attrs)
+};
+
+typedef struct
+{
+    const gchar *name;
+    const gchar *summary;
+    const gchar *doc_url;
+    JsonNode *plugs;
+    JsonNode *slots;
+} InterfaceFields;
+
+static const JsonField interface_fields[] =
+{
+    FIELD ("name", FIELD_STRING, InterfaceFields, name),
+    FIELD ("summary", FIELD_STRING, InterfaceFields, summary),
+    FIELD ("doc-url", FIELD_STRING, InterfaceFields, doc_url),
+    FIELD ("plugs", FIELD_NODE, InterfaceFields, plugs),
+    FIELD ("slots", FIELD_NODE, InterfaceFields, slots)
+};
+
+SnapdSlot *
+_snapd_json_parse_slot (JsonNode *node, GError **error)
+{
+    PlugSlotFields fields = { NULL };
+    if (!decode_object (node, "slot", slot_fields, G_N_ELEMENTS (slot_fields), &fields, error))
+        return NULL;
+
+    g_autoptr(JsonArray) connections = node_get_array (fields.connections);
     g_autoptr(GPtrArray) plug_refs = g_ptr_array_new_with_free_func (g_object_unref);
     for (guint i = 0; i < json_array_get_length (connections); i++) {
         JsonNode *node = json_array_get_element (connections, i);
@@ -1066,39 +2119,31 @@ _snapd_json_parse_slot (JsonNode *node, GError **error)
         g_ptr_array_add (plug_refs, plug_ref);
     }
 
-    g_autoptr(GHashTable) attributes = NULL;
-    if (json_object_has_member (object, "attrs")) {
-        attributes = _snapd_json_parse_attributes (json_object_get_member (object, "attrs"), error);
-        if (attributes == NULL)
-            return FALSE;
-    }
-    else
-        attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
-
-    return g_object_new (SNAPD_TYPE_SLOT,
-                         "name", _snapd_json_get_string (object, "slot", NULL),
-                         "snap", _snapd_json_get_string (object, "snap", NULL),
-                         "interface", _snapd_json_get_string (object, "interface", NULL),
-                         "label", _snapd_json_get_string (object, "label", NULL),
-                         "connections", plug_refs,
-                         "attributes", attributes,
-                         // FIXME: apps
-                         NULL);
+    JsonObject *attributes;
+    if (!get_optional_attributes (fields.attrs, &attributes, error))
+        return NULL;
+
+    SnapdSlot *slot = g_object_new (SNAPD_TYPE_SLOT,
+                                    "name", fields.name,
+                                    "snap", fields.snap,
+                                    "interface", fields.interface,
+                                    "label", fields.label,
+                                    "connections", plug_refs,
+                                    // FIXME: apps
+                                    NULL);
+    _snapd_slot_set_attributes_object (slot, attributes);
+
+    return slot;
 }
 
 SnapdPlug *
 _snapd_json_parse_plug (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected plug type");
+    PlugSlotFields fields = { NULL };
+    if (!decode_object (node, "plug", plug_fields, G_N_ELEMENTS (plug_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
-    g_autoptr(JsonArray) connections = _snapd_json_get_array (object, "connections");
+    g_autoptr(JsonArray) connections = node_get_array (fields.connections);
     g_autoptr(GPtrArray) slot_refs = g_ptr_array_new_with_free_func (g_object_unref);
     for (guint i = 0; i < json_array_get_length (connections); i++) {
         JsonNode *node = json_array_get_element (connections, i);
@@ -1109,156 +2154,121 @@ _snapd_json_parse_plug (JsonNode *node, GError **error)
         g_ptr_array_add (slot_refs, slot_ref);
     }
 
-    g_autoptr(GHashTable) attributes = NULL;
-    if (json_object_has_member (object, "attrs")) {
-        attributes = _snapd_json_parse_attributes (json_object_get_member (object, "attrs"), error);
-        if (attributes == NULL)
-            return FALSE;
-    }
-    else
-        attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
-
-    return g_object_new (SNAPD_TYPE_PLUG,
-                         "name", _snapd_json_get_string (object, "plug", NULL),
-                         "snap", _snapd_json_get_string (object, "snap", NULL),
-                         "interface", _snapd_json_get_string (object, "interface", NULL),
-                         "label", _snapd_json_get_string (object, "label", NULL),
-                         "connections", slot_refs,
-                         "attributes", attributes,
-                         // FIXME: apps
-                         NULL);
+    JsonObject *attributes;
+    if (!get_optional_attributes (fields.attrs, &attributes, error))
+        return NULL;
+
+    SnapdPlug *plug = g_object_new (SNAPD_TYPE_PLUG,
+                                    "name", fields.name,
+                                    "snap", fields.snap,
+                                    "interface", fields.interface,
+                                    "label", fields.label,
+                                    "connections", slot_refs,
+                                    // FIXME: apps
+                                    NULL);
+    _snapd_plug_set_attributes_object (plug, attributes);
+
+    return plug;
 }
 
 SnapdSlotRef *
 _snapd_json_parse_slot_ref (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected slot ref type");
+    RefFields fields = { NULL };
+    if (!decode_object (node, "slot ref", slot_ref_fields, G_N_ELEMENTS (slot_ref_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
     return g_object_new (SNAPD_TYPE_SLOT_REF,
-                         "slot", _snapd_json_get_string (object, "slot", NULL),
-                         "snap", _snapd_json_get_string (object, "snap", NULL),
+                         "slot", fields.name,
+                         "snap", fields.snap,
                          NULL);
 }
 
 SnapdPlugRef *
 _snapd_json_parse_plug_ref (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected plug ref type");
+    RefFields fields = { NULL };
+    if (!decode_object (node, "plug ref", plug_ref_fields, G_N_ELEMENTS (plug_ref_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
     return g_object_new (SNAPD_TYPE_PLUG_REF,
-                         "plug", _snapd_json_get_string (object, "plug", NULL),
-                         "snap", _snapd_json_get_string (object, "snap", NULL),
+                         "plug", fields.name,
+                         "snap", fields.snap,
                          NULL);
 }
 
 SnapdConnection *
 _snapd_json_parse_connection (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected connection type");
+    ConnectionFields fields = { NULL };
+    if (!decode_object (node, "connection", connection_fields, G_N_ELEMENTS (connection_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
     g_autoptr(SnapdSlotRef) slot_ref = NULL;
-    if (json_object_has_member (object, "slot")) {
-        slot_ref = _snapd_json_parse_slot_ref (json_object_get_member (object, "slot"), error);
+    if (fields.slot != NULL) {
+        slot_ref = _snapd_json_parse_slot_ref (fields.slot, error);
         if (slot_ref == NULL)
             return NULL;
     }
     g_autoptr(SnapdPlugRef) plug_ref = NULL;
-    if (json_object_has_member (object, "plug")) {
-        plug_ref = _snapd_json_parse_plug_ref (json_object_get_member (object, "plug"), error);
+    if (fields.plug != NULL) {
+        plug_ref = _snapd_json_parse_plug_ref (fields.plug, error);
         if (plug_ref == NULL)
             return NULL;
     }
 
-    g_autoptr(GHashTable) slot_attributes = NULL;
-    if (json_object_has_member (object, "slot-attrs")) {
-        slot_attributes = _snapd_json_parse_attributes (json_object_get_member (object, "slot-attrs"), error);
-        if (slot_attributes == NULL)
-            return FALSE;
-    }
-    else
-        slot_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    JsonObject *slot_attributes, *plug_attributes;
+    if (!get_optional_attributes (fields.slot_attrs, &slot_attributes, error) ||
+        !get_optional_attributes (fields.plug_attrs, &plug_attributes, error))
+        return NULL;
 
-    g_autoptr(GHashTable) plug_attributes = NULL;
-    if (json_object_has_member (object, "plug-attrs")) {
-        plug_attributes = _snapd_json_parse_attributes (json_object_get_member (object, "plug-attrs"), error);
-        if (plug_attributes == NULL)
-            return FALSE;
-    }
-    else
-        plug_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
-
-    return g_object_new (SNAPD_TYPE_CONNECTION,
-                         "slot", slot_ref,
-                         "plug", plug_ref,
-                         "interface", _snapd_json_get_string (object, "interface", NULL),
-                         "manual", _snapd_json_get_bool (object, "manual", FALSE),
-                         "gadget", _snapd_json_get_bool (object, "gadget", FALSE),
-                         "slot-attrs", slot_attributes,
-                         "plug-attrs", plug_attributes,
-                         NULL);
+    SnapdConnection *connection = g_object_new (SNAPD_TYPE_CONNECTION,
+                                                "slot", slot_ref,
+                                                "plug", plug_ref,
+                                                "interface", fields.interface,
+                                                "manual", fields.manual,
+                                                "gadget", fields.gadget,
+                                                NULL);
+    _snapd_connection_set_attributes_objects (connection, slot_attributes, plug_attributes);
+
+    return connection;
 }
 
 SnapdInterface *
 _snapd_json_parse_interface (JsonNode *node, GError **error)
 {
-    if (json_node_get_value_type (node) != JSON_TYPE_OBJECT) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_READ_FAILED,
-                     "Unexpected interface type");
+    InterfaceFields fields = { NULL };
+    if (!decode_object (node, "interface", interface_fields, G_N_ELEMENTS (interface_fields), &fields, error))
         return NULL;
-    }
-    JsonObject *object = json_node_get_object (node);
 
-    g_autoptr(JsonArray) plugs = _snapd_json_get_array (object, "plugs");
+    g_autoptr(JsonArray) plugs = node_get_array (fields.plugs);
     g_autoptr(GPtrArray) plug_array = g_ptr_array_new_with_free_func (g_object_unref);
     for (guint i = 0; i < json_array_get_length (plugs); i++) {
         JsonNode *node = json_array_get_element (plugs, i);
 
         SnapdPlug *plug = _snapd_json_parse_plug (node, error);
         if (plug == NULL)
-            return FALSE;
+            return NULL;
 
         g_ptr_array_add (plug_array, plug);
     }
 
-    g_autoptr(JsonArray) slots = _snapd_json_get_array (object, "slots");
+    g_autoptr(JsonArray) slots = node_get_array (fields.slots);
     g_autoptr(GPtrArray) slot_array = g_ptr_array_new_with_free_func (g_object_unref);
     for (guint i = 0; i < json_array_get_length (slots); i++) {
         JsonNode *node = json_array_get_element (slots, i);
 
         SnapdSlot *slot = _snapd_json_parse_slot (node, error);
         if (slot == NULL)
-            return FALSE;
+            return NULL;
 
         g_ptr_array_add (slot_array, slot);
     }
 
     return g_object_new (SNAPD_TYPE_INTERFACE,
-                         "name", _snapd_json_get_string (object, "name", NULL),
-                         "summary", _snapd_json_get_string (object, "summary", NULL),
-                         "doc-url", _snapd_json_get_string (object, "doc-url", NULL),
+                         "name", fields.name,
+                         "summary", fields.summary,
+                         "doc-url", fields.doc_url,
                          "plugs", plug_array,
                          "slots", slot_array,
                          NULL);
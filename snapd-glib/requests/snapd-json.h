@@ -15,22 +15,63 @@
 
 #include "snapd-alias.h"
 #include "snapd-app.h"
+#include "snapd-arena.h"
 #include "snapd-change.h"
 #include "snapd-connection.h"
+#include "snapd-http-request.h"
 #include "snapd-interface.h"
+#include "snapd-log.h"
 #include "snapd-maintenance.h"
+#include "snapd-notice.h"
 #include "snapd-plug.h"
 #include "snapd-plug-ref.h"
 #include "snapd-slot.h"
 #include "snapd-slot-ref.h"
 #include "snapd-snap.h"
+#include "snapd-snap-private.h"
 #include "snapd-system-information.h"
 #include "snapd-user-information.h"
 
 G_BEGIN_DECLS
 
-void                  _snapd_json_set_body               (SoupMessage        *message,
-                                                          JsonBuilder        *builder,
+typedef gboolean (*SnapdJsonElementFunc) (JsonNode *element, gpointer user_data, GError **error);
+
+typedef struct _SnapdJsonWriter SnapdJsonWriter;
+
+SnapdJsonWriter      *_snapd_json_writer_new             (void);
+
+void                  _snapd_json_writer_free            (SnapdJsonWriter    *writer);
+
+void                  _snapd_json_writer_begin_object    (SnapdJsonWriter    *writer);
+
+void                  _snapd_json_writer_end_object      (SnapdJsonWriter    *writer);
+
+void                  _snapd_json_writer_begin_array     (SnapdJsonWriter    *writer);
+
+void                  _snapd_json_writer_end_array       (SnapdJsonWriter    *writer);
+
+void                  _snapd_json_writer_set_member_name (SnapdJsonWriter    *writer,
+                                                          const gchar        *name);
+
+void                  _snapd_json_writer_add_string_value (SnapdJsonWriter   *writer,
+                                                           const gchar       *value);
+
+void                  _snapd_json_writer_add_boolean_value (SnapdJsonWriter  *writer,
+                                                            gboolean          value);
+
+void                  _snapd_json_writer_add_int_value   (SnapdJsonWriter    *writer,
+                                                          gint64              value);
+
+void                  _snapd_json_writer_add_double_value (SnapdJsonWriter   *writer,
+                                                           gdouble           value);
+
+void                  _snapd_json_writer_add_value       (SnapdJsonWriter    *writer,
+                                                          JsonNode           *value);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdJsonWriter, _snapd_json_writer_free)
+
+void                  _snapd_json_set_body               (SnapdHttpRequest   *message,
+                                                          SnapdJsonWriter    *writer,
                                                           GBytes            **body);
 
 gboolean              _snapd_json_get_bool               (JsonObject         *object,
@@ -69,18 +110,58 @@ JsonObject           *_snapd_json_get_sync_result_o      (JsonObject         *re
 JsonArray            *_snapd_json_get_sync_result_a      (JsonObject         *response,
                                                           GError            **error);
 
+JsonObject           *_snapd_json_parse_array_response   (const gchar          *content_type,
+                                                          GBytes               *body,
+                                                          SnapdMaintenance    **maintenance,
+                                                          SnapdJsonElementFunc  element_func,
+                                                          gpointer              user_data,
+                                                          GError              **error);
+
+JsonObject           *_snapd_json_parse_array_response_range (const gchar          *content_type,
+                                                              GBytes               *body,
+                                                              SnapdMaintenance    **maintenance,
+                                                              guint                 offset,
+                                                              guint                 limit,
+                                                              guint                *n_elements,
+                                                              SnapdJsonElementFunc  element_func,
+                                                              gpointer              user_data,
+                                                              GError              **error);
+
 gchar                *_snapd_json_get_async_result       (JsonObject         *response,
                                                           GError            **error);
 
 SnapdChange          *_snapd_json_parse_change           (JsonNode            *node,
                                                           GError            **error);
 
+SnapdChange          *_snapd_json_parse_change_update    (JsonNode            *node,
+                                                          SnapdChange         *previous,
+                                                          GError            **error);
+
+SnapdNotice          *_snapd_json_parse_notice           (JsonNode           *node,
+                                                          GError            **error);
+
+SnapdLog             *_snapd_json_parse_log              (JsonNode           *node,
+                                                          GError            **error);
+
 SnapdSystemInformation *_snapd_json_parse_system_information (JsonNode       *node,
                                                               GError        **error);
 
 SnapdSnap            *_snapd_json_parse_snap             (JsonNode           *node,
                                                           GError            **error);
 
+SnapdSnap            *_snapd_json_parse_snap_full        (JsonNode           *node,
+                                                          gboolean            lazy,
+                                                          SnapdSnapFields     fields,
+                                                          SnapdArena         *arena,
+                                                          GError            **error);
+
+SnapdSnap            *_snapd_json_parse_snap_shared      (JsonNode           *node,
+                                                          gboolean            lazy,
+                                                          SnapdSnapFields     fields,
+                                                          SnapdArena         *arena,
+                                                          gboolean           *is_new,
+                                                          GError            **error);
+
 SnapdApp             *_snapd_json_parse_app              (JsonNode           *node,
                                                           const gchar        *snap_name,
                                                           GError            **error);
@@ -43,31 +43,31 @@ _snapd_post_aliases_new (const gchar *action,
     return self;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_aliases_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostAliases *self = SNAPD_POST_ALIASES (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/aliases");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/aliases");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "action");
-    json_builder_add_string_value (builder, self->action);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
     if (self->snap != NULL) {
-        json_builder_set_member_name (builder, "snap");
-        json_builder_add_string_value (builder, self->snap);
+        _snapd_json_writer_set_member_name (writer, "snap");
+        _snapd_json_writer_add_string_value (writer, self->snap);
     }
     if (self->app != NULL) {
-        json_builder_set_member_name (builder, "app");
-        json_builder_add_string_value (builder, self->app);
+        _snapd_json_writer_set_member_name (writer, "app");
+        _snapd_json_writer_add_string_value (writer, self->app);
     }
     if (self->alias != NULL) {
-        json_builder_set_member_name (builder, "alias");
-        json_builder_add_string_value (builder, self->alias);
+        _snapd_json_writer_set_member_name (writer, "alias");
+        _snapd_json_writer_add_string_value (writer, self->alias);
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-post-apps.h"
+
+#include "snapd-json.h"
+
+struct _SnapdPostApps
+{
+    SnapdRequestAsync parent_instance;
+    gchar *action;
+    GStrv names;
+    gboolean enable;
+    gboolean disable;
+    gboolean reload;
+};
+
+G_DEFINE_TYPE (SnapdPostApps, snapd_post_apps, snapd_request_async_get_type ())
+
+SnapdPostApps *
+_snapd_post_apps_new (const gchar *action, GStrv names,
+                      SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdPostApps *self = SNAPD_POST_APPS (g_object_new (snapd_post_apps_get_type (),
+                                                         "cancellable", cancellable,
+                                                         "ready-callback", callback,
+                                                         "ready-callback-data", user_data,
+                                                         "progress-callback", progress_callback,
+                                                         "progress-callback-data", progress_callback_data,
+                                                         NULL));
+    self->action = g_strdup (action);
+    self->names = g_strdupv (names);
+
+    return self;
+}
+
+void
+_snapd_post_apps_set_enable (SnapdPostApps *self, gboolean enable)
+{
+    self->enable = enable;
+}
+
+void
+_snapd_post_apps_set_disable (SnapdPostApps *self, gboolean disable)
+{
+    self->disable = disable;
+}
+
+void
+_snapd_post_apps_set_reload (SnapdPostApps *self, gboolean reload)
+{
+    self->reload = reload;
+}
+
+static SnapdHttpRequest *
+generate_post_apps_request (SnapdRequest *request, GBytes **body)
+{
+    SnapdPostApps *self = SNAPD_POST_APPS (request);
+
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/apps");
+
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
+    _snapd_json_writer_set_member_name (writer, "names");
+    _snapd_json_writer_begin_array (writer);
+    for (int i = 0; self->names[i] != NULL; i++)
+        _snapd_json_writer_add_string_value (writer, self->names[i]);
+    _snapd_json_writer_end_array (writer);
+    if (self->enable) {
+        _snapd_json_writer_set_member_name (writer, "enable");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
+    }
+    if (self->disable) {
+        _snapd_json_writer_set_member_name (writer, "disable");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
+    }
+    if (self->reload) {
+        _snapd_json_writer_set_member_name (writer, "reload");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
+    }
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
+
+    return message;
+}
+
+static void
+snapd_post_apps_finalize (GObject *object)
+{
+    SnapdPostApps *self = SNAPD_POST_APPS (object);
+
+    g_clear_pointer (&self->action, g_free);
+    g_clear_pointer (&self->names, g_strfreev);
+
+    G_OBJECT_CLASS (snapd_post_apps_parent_class)->finalize (object);
+}
+
+static void
+snapd_post_apps_class_init (SnapdPostAppsClass *klass)
+{
+   SnapdRequestClass *request_class = SNAPD_REQUEST_CLASS (klass);
+   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+   request_class->generate_request = generate_post_apps_request;
+   gobject_class->finalize = snapd_post_apps_finalize;
+}
+
+static void
+snapd_post_apps_init (SnapdPostApps *self)
+{
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2017 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_POST_APPS_H__
+#define __SNAPD_POST_APPS_H__
+
+#include "snapd-request-async.h"
+
+#include "snapd-client.h"
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE (SnapdPostApps, snapd_post_apps, SNAPD, POST_APPS, SnapdRequestAsync)
+
+SnapdPostApps *_snapd_post_apps_new (const gchar           *action,
+                                     GStrv                  names,
+                                     SnapdProgressCallback  progress_callback,
+                                     gpointer               progress_callback_data,
+                                     GCancellable          *cancellable,
+                                     GAsyncReadyCallback    callback,
+                                     gpointer               user_data);
+
+void           _snapd_post_apps_set_enable  (SnapdPostApps *request,
+                                             gboolean       enable);
+
+void           _snapd_post_apps_set_disable (SnapdPostApps *request,
+                                             gboolean       disable);
+
+void           _snapd_post_apps_set_reload  (SnapdPostApps *request,
+                                             gboolean       reload);
+
+G_END_DECLS
+
+#endif /* __SNAPD_POST_APPS_H__ */
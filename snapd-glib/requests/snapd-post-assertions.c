@@ -17,6 +17,7 @@ struct _SnapdPostAssertions
 {
     SnapdRequest parent_instance;
     GStrv assertions;
+    GInputStream *stream;
 };
 
 G_DEFINE_TYPE (SnapdPostAssertions, snapd_post_assertions, snapd_request_get_type ())
@@ -35,19 +36,27 @@ _snapd_post_assertions_new (GStrv assertions,
     return self;
 }
 
-static SoupMessage *
+void
+_snapd_post_assertions_set_stream (SnapdPostAssertions *self, GInputStream *stream)
+{
+    g_set_object (&self->stream, stream);
+}
+
+static SnapdHttpRequest *
 generate_post_assertions_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostAssertions *self = SNAPD_POST_ASSERTIONS (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/assertions");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/assertions");
+
+    _snapd_http_request_add_header (message, "Content-Type", "application/x.ubuntu.assertion"); //FIXME
+
+    /* Streams are sent with chunked encoding as they are read */
+    if (self->stream != NULL) {
+        _snapd_request_set_body_stream (request, self->stream);
+        return message;
+    }
 
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    SoupMessageHeaders *request_headers = soup_message_get_request_headers (message);
-#else
-    SoupMessageHeaders *request_headers = message->request_headers;
-#endif
-    soup_message_headers_set_content_type (request_headers, "application/x.ubuntu.assertion", NULL); //FIXME
     g_autofree gchar *assertions = g_strjoinv ("\n\n", self->assertions);
     *body = g_bytes_new (assertions, strlen (assertions));
 
@@ -64,12 +73,22 @@ parse_post_assertions_response (SnapdRequest *request, guint status_code, const
     return TRUE;
 }
 
+static void
+release_post_assertions_body (SnapdRequest *request)
+{
+    SnapdPostAssertions *self = SNAPD_POST_ASSERTIONS (request);
+
+    g_clear_pointer (&self->assertions, g_strfreev);
+    g_clear_object (&self->stream);
+}
+
 static void
 snapd_post_assertions_finalize (GObject *object)
 {
     SnapdPostAssertions *self = SNAPD_POST_ASSERTIONS (object);
 
     g_clear_pointer (&self->assertions, g_strfreev);
+    g_clear_object (&self->stream);
 
     G_OBJECT_CLASS (snapd_post_assertions_parent_class)->finalize (object);
 }
@@ -82,6 +101,7 @@ snapd_post_assertions_class_init (SnapdPostAssertionsClass *klass)
 
    request_class->generate_request = generate_post_assertions_request;
    request_class->parse_response = parse_post_assertions_response;
+   request_class->release_body = release_post_assertions_body;
    gobject_class->finalize = snapd_post_assertions_finalize;
 }
 
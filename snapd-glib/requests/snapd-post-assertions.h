@@ -21,6 +21,9 @@ SnapdPostAssertions *_snapd_post_assertions_new (GStrv                assertions
                                                  GAsyncReadyCallback  callback,
                                                  gpointer             user_data);
 
+void                 _snapd_post_assertions_set_stream (SnapdPostAssertions *request,
+                                                        GInputStream        *stream);
+
 G_END_DECLS
 
 #endif /* __SNAPD_POST_ASSERTIONS_H__ */
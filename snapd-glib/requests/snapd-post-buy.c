@@ -38,23 +38,23 @@ _snapd_post_buy_new (const gchar *id, gdouble amount, const gchar *currency,
     return self;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_buy_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostBuy *self = SNAPD_POST_BUY (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/buy");
-
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "snap-id");
-    json_builder_add_string_value (builder, self->id);
-    json_builder_set_member_name (builder, "price");
-    json_builder_add_double_value (builder, self->amount);
-    json_builder_set_member_name (builder, "currency");
-    json_builder_add_string_value (builder, self->currency);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/buy");
+
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "snap-id");
+    _snapd_json_writer_add_string_value (writer, self->id);
+    _snapd_json_writer_set_member_name (writer, "price");
+    _snapd_json_writer_add_double_value (writer, self->amount);
+    _snapd_json_writer_set_member_name (writer, "currency");
+    _snapd_json_writer_add_string_value (writer, self->currency);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
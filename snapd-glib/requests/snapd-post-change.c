@@ -63,20 +63,20 @@ _snapd_post_change_set_api_path (SnapdPostChange *self, const gchar *api_path)
     self->api_path = g_strdup (api_path);
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_change_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostChange *self = SNAPD_POST_CHANGE (request);
 
-    g_autofree gchar *path = g_strdup_printf ("http://snapd%s/%s", self->api_path ? self->api_path : "/v2/changes", self->change_id);
-    SoupMessage *message = soup_message_new ("POST", path);
+    g_autofree gchar *path = g_strdup_printf ("%s/%s", self->api_path ? self->api_path : "/v2/changes", self->change_id);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", path);
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "action");
-    json_builder_add_string_value (builder, self->action);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -55,27 +55,27 @@ _snapd_post_create_user_get_user_information (SnapdPostCreateUser *self)
     return self->user_information;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_create_user_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostCreateUser *self = SNAPD_POST_CREATE_USER (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/create-user");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/create-user");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "email");
-    json_builder_add_string_value (builder, self->email);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "email");
+    _snapd_json_writer_add_string_value (writer, self->email);
     if (self->sudoer) {
-        json_builder_set_member_name (builder, "sudoer");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "sudoer");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
     if (self->known) {
-        json_builder_set_member_name (builder, "known");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "known");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -36,17 +36,17 @@ _snapd_post_create_users_get_users_information (SnapdPostCreateUsers *self)
     return self->users_information;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_create_users_request (SnapdRequest *request, GBytes **body)
 {
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/create-user");
-
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "known");
-    json_builder_add_boolean_value (builder, TRUE);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/create-user");
+
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "known");
+    _snapd_json_writer_add_boolean_value (writer, TRUE);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -18,7 +18,13 @@ struct _SnapdPostDownload
     gchar *name;
     gchar *channel;
     gchar *revision;
+    gchar *resume_token;
+    goffset resume_offset;
+    gboolean header_peek;
     GBytes *data;
+    goffset size;
+    gchar *sha3_384;
+    gchar *download_token;
 };
 
 G_DEFINE_TYPE (SnapdPostDownload, snapd_post_download, snapd_request_get_type ())
@@ -39,36 +45,91 @@ _snapd_post_download_new (const gchar *name, const gchar *channel, const gchar *
     return self;
 }
 
-static SoupMessage *
+void
+_snapd_post_download_set_resume (SnapdPostDownload *self, const gchar *resume_token, goffset offset)
+{
+    g_free (self->resume_token);
+    self->resume_token = g_strdup (resume_token);
+    self->resume_offset = offset;
+}
+
+void
+_snapd_post_download_set_header_peek (SnapdPostDownload *self, gboolean header_peek)
+{
+    self->header_peek = header_peek;
+}
+
+void
+_snapd_post_download_set_stream (SnapdPostDownload *self, GOutputStream *stream,
+                                 GFileProgressCallback progress_callback, gpointer progress_callback_data)
+{
+    _snapd_request_set_response_stream (SNAPD_REQUEST (self), stream, progress_callback, progress_callback_data);
+}
+
+static SnapdHttpRequest *
 generate_post_download_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostDownload *self = SNAPD_POST_DOWNLOAD (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/download");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/download");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "snap-name");
-    json_builder_add_string_value (builder, self->name);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "snap-name");
+    _snapd_json_writer_add_string_value (writer, self->name);
     if (self->channel != NULL) {
-        json_builder_set_member_name (builder, "channel");
-        json_builder_add_string_value (builder, self->channel);
+        _snapd_json_writer_set_member_name (writer, "channel");
+        _snapd_json_writer_add_string_value (writer, self->channel);
     }
     if (self->revision != NULL) {
-        json_builder_set_member_name (builder, "revision");
-        json_builder_add_string_value (builder, self->revision);
+        _snapd_json_writer_set_member_name (writer, "revision");
+        _snapd_json_writer_add_string_value (writer, self->revision);
+    }
+    if (self->header_peek) {
+        _snapd_json_writer_set_member_name (writer, "header-peek");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
+    }
+    if (self->resume_token != NULL) {
+        _snapd_json_writer_set_member_name (writer, "resume-token");
+        _snapd_json_writer_add_string_value (writer, self->resume_token);
+    }
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
+
+    if (self->resume_offset > 0) {
+        g_autofree gchar *range = g_strdup_printf ("bytes=%" G_GINT64_FORMAT "-", (gint64) self->resume_offset);
+        _snapd_http_request_add_header (message, "Range", range);
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
 
     return message;
 }
 
+static void
+parse_post_download_headers (SnapdRequest *request, guint status_code, SoupMessageHeaders *headers)
+{
+    SnapdPostDownload *self = SNAPD_POST_DOWNLOAD (request);
+
+    const gchar *size = soup_message_headers_get_one (headers, "Snap-Length");
+    if (size != NULL)
+        self->size = g_ascii_strtoll (size, NULL, 10);
+    g_free (self->sha3_384);
+    self->sha3_384 = g_strdup (soup_message_headers_get_one (headers, "Snap-Sha3-384"));
+    g_free (self->download_token);
+    self->download_token = g_strdup (soup_message_headers_get_one (headers, "Snap-Download-Token"));
+}
+
 static gboolean
 parse_post_download_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
 {
     SnapdPostDownload *self = SNAPD_POST_DOWNLOAD (request);
 
+    /* Errors are reported in the usual JSON form */
+    if (g_strcmp0 (content_type, "application/json") == 0) {
+        g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+        if (response == NULL)
+            return FALSE;
+    }
+
     if (g_strcmp0 (content_type, "application/octet-stream") != 0) {
         g_set_error (error,
                      SNAPD_ERROR,
@@ -77,7 +138,18 @@ parse_post_download_response (SnapdRequest *request, guint status_code, const gc
         return FALSE;
     }
 
-    self->data = g_bytes_ref (body);
+    /* Check snapd started from where we asked */
+    if (self->resume_offset > 0 && status_code != SOUP_STATUS_PARTIAL_CONTENT) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_READ_FAILED,
+                     "snapd did not resume download");
+        return FALSE;
+    }
+
+    /* Data has already been written if streaming */
+    if (!_snapd_request_has_response_stream (request))
+        self->data = g_bytes_ref (body);
 
     return TRUE;
 }
@@ -90,7 +162,10 @@ snapd_post_download_finalize (GObject *object)
     g_clear_pointer (&self->name, g_free);
     g_clear_pointer (&self->channel, g_free);
     g_clear_pointer (&self->revision, g_free);
+    g_clear_pointer (&self->resume_token, g_free);
     g_clear_pointer (&self->data, g_bytes_unref);
+    g_clear_pointer (&self->sha3_384, g_free);
+    g_clear_pointer (&self->download_token, g_free);
 
     G_OBJECT_CLASS (snapd_post_download_parent_class)->finalize (object);
 }
@@ -102,6 +177,7 @@ snapd_post_download_class_init (SnapdPostDownloadClass *klass)
     GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
     request_class->generate_request = generate_post_download_request;
+    request_class->parse_headers = parse_post_download_headers;
     request_class->parse_response = parse_post_download_response;
     gobject_class->finalize = snapd_post_download_finalize;
 }
@@ -109,6 +185,7 @@ snapd_post_download_class_init (SnapdPostDownloadClass *klass)
 static void
 snapd_post_download_init (SnapdPostDownload *self)
 {
+    self->size = -1;
 }
 
 GBytes *
@@ -117,3 +194,24 @@ _snapd_post_download_get_data (SnapdPostDownload *self)
     g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (self), NULL);
     return self->data;
 }
+
+goffset
+_snapd_post_download_get_size (SnapdPostDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (self), -1);
+    return self->size;
+}
+
+const gchar *
+_snapd_post_download_get_sha3_384 (SnapdPostDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (self), NULL);
+    return self->sha3_384;
+}
+
+const gchar *
+_snapd_post_download_get_resume_token (SnapdPostDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (self), NULL);
+    return self->download_token;
+}
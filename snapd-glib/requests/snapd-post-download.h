@@ -16,14 +16,32 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (SnapdPostDownload, snapd_post_download, SNAPD, POST_DOWNLOAD, SnapdRequest)
 
-SnapdPostDownload *_snapd_post_download_new      (const gchar         *name,
-                                                  const gchar         *channel,
-                                                  const gchar         *revision,
-                                                  GCancellable        *cancellable,
-                                                  GAsyncReadyCallback  callback,
-                                                  gpointer             user_data);
-
-GBytes            *_snapd_post_download_get_data (SnapdPostDownload   *request);
+SnapdPostDownload *_snapd_post_download_new              (const gchar           *name,
+                                                          const gchar           *channel,
+                                                          const gchar           *revision,
+                                                          GCancellable          *cancellable,
+                                                          GAsyncReadyCallback    callback,
+                                                          gpointer               user_data);
+
+void               _snapd_post_download_set_resume       (SnapdPostDownload     *request,
+                                                          const gchar           *resume_token,
+                                                          goffset                offset);
+
+void               _snapd_post_download_set_header_peek  (SnapdPostDownload     *request,
+                                                          gboolean               header_peek);
+
+void               _snapd_post_download_set_stream       (SnapdPostDownload     *request,
+                                                          GOutputStream         *stream,
+                                                          GFileProgressCallback  progress_callback,
+                                                          gpointer               progress_callback_data);
+
+GBytes            *_snapd_post_download_get_data         (SnapdPostDownload     *request);
+
+goffset            _snapd_post_download_get_size         (SnapdPostDownload     *request);
+
+const gchar       *_snapd_post_download_get_sha3_384     (SnapdPostDownload     *request);
+
+const gchar       *_snapd_post_download_get_resume_token (SnapdPostDownload     *request);
 
 G_END_DECLS
 
@@ -46,37 +46,37 @@ _snapd_post_interfaces_new (const gchar *action,
     return self;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_interfaces_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostInterfaces *self = SNAPD_POST_INTERFACES (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/interfaces");
-
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "action");
-    json_builder_add_string_value (builder, self->action);
-    json_builder_set_member_name (builder, "plugs");
-    json_builder_begin_array (builder);
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "snap");
-    json_builder_add_string_value (builder, self->plug_snap);
-    json_builder_set_member_name (builder, "plug");
-    json_builder_add_string_value (builder, self->plug_name);
-    json_builder_end_object (builder);
-    json_builder_end_array (builder);
-    json_builder_set_member_name (builder, "slots");
-    json_builder_begin_array (builder);
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "snap");
-    json_builder_add_string_value (builder, self->slot_snap);
-    json_builder_set_member_name (builder, "slot");
-    json_builder_add_string_value (builder, self->slot_name);
-    json_builder_end_object (builder);
-    json_builder_end_array (builder);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/interfaces");
+
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
+    _snapd_json_writer_set_member_name (writer, "plugs");
+    _snapd_json_writer_begin_array (writer);
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "snap");
+    _snapd_json_writer_add_string_value (writer, self->plug_snap);
+    _snapd_json_writer_set_member_name (writer, "plug");
+    _snapd_json_writer_add_string_value (writer, self->plug_name);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_writer_end_array (writer);
+    _snapd_json_writer_set_member_name (writer, "slots");
+    _snapd_json_writer_begin_array (writer);
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "snap");
+    _snapd_json_writer_add_string_value (writer, self->slot_snap);
+    _snapd_json_writer_set_member_name (writer, "slot");
+    _snapd_json_writer_add_string_value (writer, self->slot_name);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_writer_end_array (writer);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
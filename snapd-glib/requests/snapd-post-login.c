@@ -45,28 +45,28 @@ _snapd_post_login_get_user_information (SnapdPostLogin *self)
     return self->user_information;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_login_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostLogin *self = SNAPD_POST_LOGIN (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/login");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/login");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "email");
-    json_builder_add_string_value (builder, self->email);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "email");
+    _snapd_json_writer_add_string_value (writer, self->email);
     /* Send legacy username field for snapd < 2.16 */
-    json_builder_set_member_name (builder, "username");
-    json_builder_add_string_value (builder, self->email);
-    json_builder_set_member_name (builder, "password");
-    json_builder_add_string_value (builder, self->password);
+    _snapd_json_writer_set_member_name (writer, "username");
+    _snapd_json_writer_add_string_value (writer, self->email);
+    _snapd_json_writer_set_member_name (writer, "password");
+    _snapd_json_writer_add_string_value (writer, self->password);
     if (self->otp != NULL) {
-        json_builder_set_member_name (builder, "otp");
-        json_builder_add_string_value (builder, self->otp);
+        _snapd_json_writer_set_member_name (writer, "otp");
+        _snapd_json_writer_add_string_value (writer, self->otp);
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
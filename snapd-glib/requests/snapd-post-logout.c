@@ -34,19 +34,19 @@ _snapd_post_logout_new (gint64 id,
     return self;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_logout_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostLogout *self = SNAPD_POST_LOGOUT (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/logout");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/logout");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "id");
-    json_builder_add_int_value (builder, self->id);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "id");
+    _snapd_json_writer_add_int_value (writer, self->id);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
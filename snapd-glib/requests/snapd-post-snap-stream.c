@@ -8,6 +8,7 @@
  */
 
 #include <string.h>
+#include <unistd.h>
 
 #include "snapd-post-snap-stream.h"
 
@@ -20,7 +21,9 @@ struct _SnapdPostSnapStream
     gboolean dangerous;
     gboolean devmode;
     gboolean jailmode;
-    GByteArray *snap_contents;
+    GInputStream *stream;
+    int fd;
+    goffset fd_length;
 };
 
 G_DEFINE_TYPE (SnapdPostSnapStream, snapd_post_snap_stream, snapd_request_async_get_type ())
@@ -65,77 +68,88 @@ _snapd_post_snap_stream_set_jailmode (SnapdPostSnapStream *self, gboolean jailmo
 }
 
 void
-_snapd_post_snap_stream_append_data (SnapdPostSnapStream *self, const guint8 *data, guint len)
+_snapd_post_snap_stream_set_stream (SnapdPostSnapStream *self, GInputStream *stream)
 {
-    g_byte_array_append (self->snap_contents, data, len);
+    g_set_object (&self->stream, stream);
+}
+
+void
+_snapd_post_snap_stream_set_fd (SnapdPostSnapStream *self, int fd, goffset length)
+{
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = fd;
+    self->fd_length = length;
 }
 
 static void
-append_multipart_value (SoupMultipart *multipart, const gchar *name, const gchar *value)
+append_multipart_value (GString *data, const gchar *boundary, const gchar *name, const gchar *value)
 {
-    g_autoptr(SoupMessageHeaders) headers = soup_message_headers_new (SOUP_MESSAGE_HEADERS_MULTIPART);
-    g_autoptr(GHashTable) params = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-    g_hash_table_insert (params, g_strdup ("name"), g_strdup (name));
-    soup_message_headers_set_content_disposition (headers, "form-data", params);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    g_autoptr(GBytes) buffer = g_bytes_new (value, strlen (value));
-#else
-    g_autoptr(SoupBuffer) buffer = soup_buffer_new_take ((guchar *) g_strdup (value), strlen (value));
-#endif
-    soup_multipart_append_part (multipart, headers, buffer);
+    g_string_append_printf (data, "--%s\r\n", boundary);
+    g_string_append_printf (data, "Content-Disposition: form-data; name=\"%s\"\r\n", name);
+    g_string_append (data, "\r\n");
+    g_string_append_printf (data, "%s\r\n", value);
 }
 
-static SoupMessage *
+/* The multipart body is written by hand so the snap contents can be streamed
+ * or sent from the file between the leading parts and the closing boundary */
+static SnapdHttpRequest *
 generate_post_snap_stream_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostSnapStream *self = SNAPD_POST_SNAP_STREAM (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/snaps");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/snaps");
+
+    g_autofree gchar *boundary = g_strdup_printf ("snapd-glib-%08x%08x%08x", g_random_int (), g_random_int (), g_random_int ());
+    g_autofree gchar *content_type = g_strdup_printf ("multipart/form-data; boundary=%s", boundary);
+    _snapd_http_request_add_header (message, "Content-Type", content_type);
 
-    g_autoptr(SoupMultipart) multipart = soup_multipart_new ("multipart/form-data");
+    g_autoptr(GString) data = g_string_new ("");
     if (self->classic)
-        append_multipart_value (multipart, "classic", "true");
+        append_multipart_value (data, boundary, "classic", "true");
     if (self->dangerous)
-        append_multipart_value (multipart, "dangerous", "true");
+        append_multipart_value (data, boundary, "dangerous", "true");
     if (self->devmode)
-        append_multipart_value (multipart, "devmode", "true");
+        append_multipart_value (data, boundary, "devmode", "true");
     if (self->jailmode)
-        append_multipart_value (multipart, "jailmode", "true");
-
-    g_autoptr(GHashTable) params = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-    g_hash_table_insert (params, g_strdup ("name"), g_strdup ("snap"));
-    g_hash_table_insert (params, g_strdup ("filename"), g_strdup ("x"));
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    SoupMessageHeaders *request_headers = soup_message_get_request_headers (message);
-#else
-    SoupMessageHeaders *request_headers = message->request_headers;
-#endif
-    soup_message_headers_set_content_disposition (request_headers, "form-data", params);
-    soup_message_headers_set_content_type (request_headers, "application/vnd.snap", NULL);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    g_autoptr(GBytes) part_buffer = g_bytes_new_static (self->snap_contents->data, self->snap_contents->len);
-#else
-    g_autoptr(SoupBuffer) part_buffer = soup_buffer_new (SOUP_MEMORY_STATIC, self->snap_contents->data, self->snap_contents->len);
-#endif
-    soup_multipart_append_part (multipart, request_headers, part_buffer);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    soup_multipart_to_message (multipart, request_headers, body);
-#else
-    g_autoptr(SoupMessageBody) b = soup_message_body_new ();
-    soup_multipart_to_message (multipart, request_headers, b);
-    g_autoptr(SoupBuffer) buffer = soup_message_body_flatten (b);
-    *body = g_bytes_new (buffer->data, buffer->length);
-#endif
+        append_multipart_value (data, boundary, "jailmode", "true");
+    g_string_append_printf (data, "--%s\r\n", boundary);
+    g_string_append (data, "Content-Disposition: form-data; name=\"snap\"; filename=\"x\"\r\n");
+    g_string_append (data, "Content-Type: application/vnd.snap\r\n");
+    g_string_append (data, "\r\n");
+    *body = g_string_free_to_bytes (g_steal_pointer (&data));
+
+    g_autofree gchar *trailer_text = g_strdup_printf ("\r\n--%s--\r\n", boundary);
+    g_autoptr(GBytes) trailer = g_bytes_new (trailer_text, strlen (trailer_text));
+    if (self->fd >= 0)
+        _snapd_request_set_body_fd (request, self->fd, self->fd_length);
+    else
+        _snapd_request_set_body_stream (request, self->stream);
+    _snapd_request_set_body_trailer (request, trailer);
 
     return message;
 }
 
+static void
+release_post_snap_stream_body (SnapdRequest *request)
+{
+    SnapdPostSnapStream *self = SNAPD_POST_SNAP_STREAM (request);
+
+    g_clear_object (&self->stream);
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = -1;
+}
+
 static void
 snapd_post_snap_stream_finalize (GObject *object)
 {
     SnapdPostSnapStream *self = SNAPD_POST_SNAP_STREAM (object);
 
-    g_clear_pointer (&self->snap_contents, g_byte_array_unref);
+    g_clear_object (&self->stream);
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = -1;
 
     G_OBJECT_CLASS (snapd_post_snap_stream_parent_class)->finalize (object);
 }
@@ -147,11 +161,12 @@ snapd_post_snap_stream_class_init (SnapdPostSnapStreamClass *klass)
    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
    request_class->generate_request = generate_post_snap_stream_request;
+   request_class->release_body = release_post_snap_stream_body;
    gobject_class->finalize = snapd_post_snap_stream_finalize;
 }
 
 static void
 snapd_post_snap_stream_init (SnapdPostSnapStream *self)
 {
-    self->snap_contents = g_byte_array_new ();
+    self->fd = -1;
 }
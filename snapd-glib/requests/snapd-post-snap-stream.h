@@ -36,9 +36,12 @@ void                 _snapd_post_snap_stream_set_devmode   (SnapdPostSnapStream
 void                 _snapd_post_snap_stream_set_jailmode  (SnapdPostSnapStream   *request,
                                                             gboolean               jailmode);
 
-void                 _snapd_post_snap_stream_append_data   (SnapdPostSnapStream   *request,
-                                                            const guint8          *data,
-                                                            guint                  len);
+void                 _snapd_post_snap_stream_set_stream    (SnapdPostSnapStream   *request,
+                                                            GInputStream          *stream);
+
+void                 _snapd_post_snap_stream_set_fd        (SnapdPostSnapStream   *request,
+                                                            int                    fd,
+                                                            goffset                length);
 
 G_END_DECLS
 
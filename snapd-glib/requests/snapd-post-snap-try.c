@@ -53,24 +53,26 @@ append_multipart_value (SoupMultipart *multipart, const gchar *name, const gchar
     soup_multipart_append_part (multipart, headers, buffer);
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_snap_try_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostSnapTry *self = SNAPD_POST_SNAP_TRY (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/snaps");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/snaps");
 
     g_autoptr(SoupMultipart) multipart = soup_multipart_new ("multipart/form-data");
     append_multipart_value (multipart, "action", "try");
     append_multipart_value (multipart, "snap-path", self->path);
+    g_autoptr(SoupMessageHeaders) headers = soup_message_headers_new (SOUP_MESSAGE_HEADERS_REQUEST);
 #if SOUP_CHECK_VERSION (2, 99, 2)
-    soup_multipart_to_message (multipart, soup_message_get_request_headers (message), body);
+    soup_multipart_to_message (multipart, headers, body);
 #else
     g_autoptr(SoupMessageBody) b = soup_message_body_new ();
-    soup_multipart_to_message (multipart, message->request_headers, b);
+    soup_multipart_to_message (multipart, headers, b);
     g_autoptr(SoupBuffer) buffer = soup_message_body_flatten (b);
     *body = g_bytes_new (buffer->data, buffer->length);
 #endif
+    _snapd_http_request_add_header (message, "Content-Type", soup_message_headers_get_one (headers, "Content-Type"));
 
     return message;
 }
@@ -89,49 +89,49 @@ _snapd_post_snap_set_purge (SnapdPostSnap *self, gboolean purge)
     self->purge = purge;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_snap_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostSnap *self = SNAPD_POST_SNAP (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/snaps/");
+    g_autoptr(GString) path = g_string_new ("/v2/snaps/");
     g_string_append_uri_escaped (path, self->name, NULL, TRUE);
-    SoupMessage *message = soup_message_new ("POST", path->str);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", path->str);
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "action");
-    json_builder_add_string_value (builder, self->action);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
     if (self->channel != NULL) {
-        json_builder_set_member_name (builder, "channel");
-        json_builder_add_string_value (builder, self->channel);
+        _snapd_json_writer_set_member_name (writer, "channel");
+        _snapd_json_writer_add_string_value (writer, self->channel);
     }
     if (self->revision != NULL) {
-        json_builder_set_member_name (builder, "revision");
-        json_builder_add_string_value (builder, self->revision);
+        _snapd_json_writer_set_member_name (writer, "revision");
+        _snapd_json_writer_add_string_value (writer, self->revision);
     }
     if (self->classic) {
-        json_builder_set_member_name (builder, "classic");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "classic");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
     if (self->dangerous) {
-        json_builder_set_member_name (builder, "dangerous");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "dangerous");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
     if (self->devmode) {
-        json_builder_set_member_name (builder, "devmode");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "devmode");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
     if (self->jailmode) {
-        json_builder_set_member_name (builder, "jailmode");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "jailmode");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
     if (self->purge) {
-        json_builder_set_member_name (builder, "purge");
-        json_builder_add_boolean_value (builder, TRUE);
+        _snapd_json_writer_set_member_name (writer, "purge");
+        _snapd_json_writer_add_boolean_value (writer, TRUE);
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -56,24 +56,24 @@ _snapd_post_snapctl_get_exit_code (SnapdPostSnapctl *self)
     return self->exit_code;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_snapctl_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostSnapctl *self = SNAPD_POST_SNAPCTL (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/snapctl");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/snapctl");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "context-id");
-    json_builder_add_string_value (builder, self->context_id);
-    json_builder_set_member_name (builder, "args");
-    json_builder_begin_array (builder);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "context-id");
+    _snapd_json_writer_add_string_value (writer, self->context_id);
+    _snapd_json_writer_set_member_name (writer, "args");
+    _snapd_json_writer_begin_array (writer);
     for (int i = 0; self->args[i] != NULL; i++)
-        json_builder_add_string_value (builder, self->args[i]);
-    json_builder_end_array (builder);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+        _snapd_json_writer_add_string_value (writer, self->args[i]);
+    _snapd_json_writer_end_array (writer);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
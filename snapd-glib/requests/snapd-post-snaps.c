@@ -16,6 +16,7 @@ struct _SnapdPostSnaps
 {
     SnapdRequestAsync parent_instance;
     gchar *action;
+    GStrv snaps;
     GStrv snap_names;
 };
 
@@ -38,25 +39,39 @@ _snapd_post_snaps_new (const gchar *action,
     return self;
 }
 
+void
+_snapd_post_snaps_set_snaps (SnapdPostSnaps *self, GStrv snaps)
+{
+    g_strfreev (self->snaps);
+    self->snaps = g_strdupv (snaps);
+}
+
 GStrv
 _snapd_post_snaps_get_snap_names (SnapdPostSnaps *self)
 {
     return self->snap_names;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_snaps_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostSnaps *self = SNAPD_POST_SNAPS (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/snaps");
-
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    json_builder_set_member_name (builder, "action");
-    json_builder_add_string_value (builder, self->action);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/snaps");
+
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    _snapd_json_writer_set_member_name (writer, "action");
+    _snapd_json_writer_add_string_value (writer, self->action);
+    if (self->snaps != NULL) {
+        _snapd_json_writer_set_member_name (writer, "snaps");
+        _snapd_json_writer_begin_array (writer);
+        for (int i = 0; self->snaps[i] != NULL; i++)
+            _snapd_json_writer_add_string_value (writer, self->snaps[i]);
+        _snapd_json_writer_end_array (writer);
+    }
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -108,6 +123,7 @@ snapd_post_snaps_finalize (GObject *object)
     SnapdPostSnaps *self = SNAPD_POST_SNAPS (object);
 
     g_clear_pointer (&self->action, g_free);
+    g_clear_pointer (&self->snaps, g_strfreev);
     g_clear_pointer (&self->snap_names, g_strfreev);
 
     G_OBJECT_CLASS (snapd_post_snaps_parent_class)->finalize (object);
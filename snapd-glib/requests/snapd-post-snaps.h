@@ -25,6 +25,9 @@ SnapdPostSnaps *_snapd_post_snaps_new            (const gchar           *action,
                                                   GAsyncReadyCallback    callback,
                                                   gpointer               user_data);
 
+void            _snapd_post_snaps_set_snaps      (SnapdPostSnaps        *request,
+                                                  GStrv                  snaps);
+
 GStrv           _snapd_post_snaps_get_snap_names (SnapdPostSnaps        *request);
 
 G_END_DECLS
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <unistd.h>
+
+#include "snapd-post-snapshots.h"
+
+#include "snapd-error.h"
+#include "snapd-json.h"
+
+struct _SnapdPostSnapshots
+{
+    SnapdRequest parent_instance;
+    GInputStream *stream;
+    goffset stream_length;
+    int fd;
+    goffset fd_length;
+    gint64 set_id;
+    GStrv snaps;
+};
+
+G_DEFINE_TYPE (SnapdPostSnapshots, snapd_post_snapshots, snapd_request_get_type ())
+
+SnapdPostSnapshots *
+_snapd_post_snapshots_new (GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    return SNAPD_POST_SNAPSHOTS (g_object_new (snapd_post_snapshots_get_type (),
+                                               "cancellable", cancellable,
+                                               "ready-callback", callback,
+                                               "ready-callback-data", user_data,
+                                               NULL));
+}
+
+void
+_snapd_post_snapshots_set_stream (SnapdPostSnapshots *self, GInputStream *stream, goffset length)
+{
+    g_set_object (&self->stream, stream);
+    self->stream_length = length;
+}
+
+void
+_snapd_post_snapshots_set_fd (SnapdPostSnapshots *self, int fd, goffset length)
+{
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = fd;
+    self->fd_length = length;
+}
+
+/* snapd checks the archive against Content-Length, so the body is always sent with a known size */
+static SnapdHttpRequest *
+generate_post_snapshots_request (SnapdRequest *request, GBytes **body)
+{
+    SnapdPostSnapshots *self = SNAPD_POST_SNAPSHOTS (request);
+
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/snapshots");
+    _snapd_http_request_add_header (message, "Content-Type", "application/x.snapd.snapshot");
+
+    if (self->fd >= 0)
+        _snapd_request_set_body_fd (request, self->fd, self->fd_length);
+    else {
+        _snapd_request_set_body_stream (request, self->stream);
+        _snapd_request_set_body_stream_length (request, self->stream_length);
+    }
+
+    return message;
+}
+
+static gboolean
+parse_post_snapshots_response (SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error)
+{
+    SnapdPostSnapshots *self = SNAPD_POST_SNAPSHOTS (request);
+
+    g_autoptr(JsonObject) response = _snapd_json_parse_response (content_type, body, maintenance, NULL, error);
+    if (response == NULL)
+        return FALSE;
+    g_autoptr(JsonObject) result = _snapd_json_get_sync_result_o (response, error);
+    if (result == NULL)
+        return FALSE;
+
+    self->set_id = _snapd_json_get_int (result, "set-id", 0);
+    g_autoptr(JsonArray) a = _snapd_json_get_array (result, "snaps");
+    g_autoptr(GPtrArray) snaps = g_ptr_array_new ();
+    for (guint i = 0; i < json_array_get_length (a); i++) {
+        JsonNode *node = json_array_get_element (a, i);
+        if (json_node_get_value_type (node) != G_TYPE_STRING) {
+            g_set_error_literal (error,
+                                 SNAPD_ERROR,
+                                 SNAPD_ERROR_READ_FAILED,
+                                 "Unexpected snap name type");
+            return FALSE;
+        }
+
+        g_ptr_array_add (snaps, g_strdup (json_node_get_string (node)));
+    }
+    g_ptr_array_add (snaps, NULL);
+
+    g_strfreev (self->snaps);
+    self->snaps = (GStrv) g_ptr_array_free (g_steal_pointer (&snaps), FALSE);
+
+    return TRUE;
+}
+
+static void
+release_post_snapshots_body (SnapdRequest *request)
+{
+    SnapdPostSnapshots *self = SNAPD_POST_SNAPSHOTS (request);
+
+    g_clear_object (&self->stream);
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = -1;
+}
+
+static void
+snapd_post_snapshots_finalize (GObject *object)
+{
+    SnapdPostSnapshots *self = SNAPD_POST_SNAPSHOTS (object);
+
+    g_clear_object (&self->stream);
+    if (self->fd >= 0)
+        close (self->fd);
+    self->fd = -1;
+    g_clear_pointer (&self->snaps, g_strfreev);
+
+    G_OBJECT_CLASS (snapd_post_snapshots_parent_class)->finalize (object);
+}
+
+static void
+snapd_post_snapshots_class_init (SnapdPostSnapshotsClass *klass)
+{
+    SnapdRequestClass *request_class = SNAPD_REQUEST_CLASS (klass);
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    request_class->generate_request = generate_post_snapshots_request;
+    request_class->parse_response = parse_post_snapshots_response;
+    request_class->release_body = release_post_snapshots_body;
+    gobject_class->finalize = snapd_post_snapshots_finalize;
+}
+
+static void
+snapd_post_snapshots_init (SnapdPostSnapshots *self)
+{
+    self->fd = -1;
+}
+
+gint64
+_snapd_post_snapshots_get_set_id (SnapdPostSnapshots *self)
+{
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPSHOTS (self), 0);
+    return self->set_id;
+}
+
+GStrv
+_snapd_post_snapshots_get_snaps (SnapdPostSnapshots *self)
+{
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPSHOTS (self), NULL);
+    return self->snaps;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_POST_SNAPSHOTS_H__
+#define __SNAPD_POST_SNAPSHOTS_H__
+
+#include "snapd-request.h"
+
+G_BEGIN_DECLS
+
+G_DECLARE_FINAL_TYPE (SnapdPostSnapshots, snapd_post_snapshots, SNAPD, POST_SNAPSHOTS, SnapdRequest)
+
+SnapdPostSnapshots *_snapd_post_snapshots_new       (GCancellable        *cancellable,
+                                                     GAsyncReadyCallback  callback,
+                                                     gpointer             user_data);
+
+void                _snapd_post_snapshots_set_stream (SnapdPostSnapshots *request,
+                                                      GInputStream       *stream,
+                                                      goffset             length);
+
+void                _snapd_post_snapshots_set_fd     (SnapdPostSnapshots *request,
+                                                      int                 fd,
+                                                      goffset             length);
+
+gint64              _snapd_post_snapshots_get_set_id (SnapdPostSnapshots *request);
+
+GStrv               _snapd_post_snapshots_get_snaps  (SnapdPostSnapshots *request);
+
+G_END_DECLS
+
+#endif /* __SNAPD_POST_SNAPSHOTS_H__ */
@@ -42,34 +42,34 @@ _snapd_post_themes_new (GStrv gtk_theme_names, GStrv icon_theme_names, GStrv sou
 }
 
 static void
-add_themes (JsonBuilder *builder, const char *member_name, GStrv theme_names) {
+add_themes (SnapdJsonWriter *writer, const char *member_name, GStrv theme_names) {
     char *const *name;
 
     if (theme_names == NULL)
         return;
 
-    json_builder_set_member_name (builder, member_name);
-    json_builder_begin_array (builder);
+    _snapd_json_writer_set_member_name (writer, member_name);
+    _snapd_json_writer_begin_array (writer);
     for (name = theme_names; *name != NULL; name++) {
-        json_builder_add_string_value (builder, *name);
+        _snapd_json_writer_add_string_value (writer, *name);
     }
-    json_builder_end_array (builder);
+    _snapd_json_writer_end_array (writer);
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_post_themes_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPostThemes *self = SNAPD_POST_THEMES (request);
 
-    SoupMessage *message = soup_message_new ("POST", "http://snapd/v2/accessories/themes");
+    SnapdHttpRequest *message = _snapd_http_request_new ("POST", "/v2/accessories/themes");
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
-    add_themes (builder, "gtk-themes", self->gtk_theme_names);
-    add_themes (builder, "icon-themes", self->icon_theme_names);
-    add_themes (builder, "sound-themes", self->sound_theme_names);
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
+    add_themes (writer, "gtk-themes", self->gtk_theme_names);
+    add_themes (writer, "icon-themes", self->icon_theme_names);
+    add_themes (writer, "sound-themes", self->sound_theme_names);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
@@ -34,18 +34,18 @@ _snapd_put_snap_conf_new (const gchar *name, GHashTable *key_values, GCancellabl
     return self;
 }
 
-static SoupMessage *
+static SnapdHttpRequest *
 generate_put_snap_conf_request (SnapdRequest *request, GBytes **body)
 {
     SnapdPutSnapConf *self = SNAPD_PUT_SNAP_CONF (request);
 
-    g_autoptr(GString) path = g_string_new ("http://snapd/v2/snaps/");
+    g_autoptr(GString) path = g_string_new ("/v2/snaps/");
     g_string_append_uri_escaped (path, self->name, NULL, TRUE);
     g_string_append (path, "/conf");
-    SoupMessage *message = soup_message_new ("PUT", path->str);
+    SnapdHttpRequest *message = _snapd_http_request_new ("PUT", path->str);
 
-    g_autoptr(JsonBuilder) builder = json_builder_new ();
-    json_builder_begin_object (builder);
+    g_autoptr(SnapdJsonWriter) writer = _snapd_json_writer_new ();
+    _snapd_json_writer_begin_object (writer);
     GHashTableIter iter;
     g_hash_table_iter_init (&iter, self->key_values);
     gpointer key, value;
@@ -53,11 +53,11 @@ generate_put_snap_conf_request (SnapdRequest *request, GBytes **body)
         const gchar *conf_key = key;
         GVariant *conf_value = value;
 
-        json_builder_set_member_name (builder, conf_key);
-        json_builder_add_value (builder, json_gvariant_serialize (conf_value));
+        _snapd_json_writer_set_member_name (writer, conf_key);
+        _snapd_json_writer_add_value (writer, json_gvariant_serialize (conf_value));
     }
-    json_builder_end_object (builder);
-    _snapd_json_set_body (message, builder, body);
+    _snapd_json_writer_end_object (writer);
+    _snapd_json_set_body (message, writer, body);
 
     return message;
 }
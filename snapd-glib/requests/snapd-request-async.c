@@ -11,7 +11,9 @@
 
 #include "snapd-client.h"
 #include "snapd-json.h"
+#include "snapd-change-private.h"
 #include "snapd-task.h"
+#include "snapd-task-private.h"
 
 enum
 {
@@ -21,6 +23,15 @@ enum
     PROP_LAST
 };
 
+typedef struct
+{
+    SnapdRequestAsync *request;
+    SnapdClient *client;
+    SnapdChange *change;
+    SnapdProgressDeltaCallback delta_callback;
+    gpointer delta_callback_data;
+} ProgressData;
+
 typedef struct
 {
     SnapdProgressCallback progress_callback;
@@ -30,8 +41,17 @@ typedef struct
     /* Returned change ID for this request */
     gchar *change_id;
 
-    /* Last reported change (so we don't send duplicates) */
+    /* Last received change (so we don't send duplicates) */
     SnapdChange *change;
+
+    /* Last change passed to the progress callbacks */
+    SnapdChange *reported_change;
+
+    /* Report held back to limit the rate of progress callbacks, and when to send it */
+    GMutex progress_mutex;
+    ProgressData *pending_progress;
+    GSource *progress_source;
+    gint64 last_report_time;
 } SnapdRequestAsyncPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (SnapdRequestAsync, snapd_request_async, snapd_request_get_type ())
@@ -69,17 +89,13 @@ parse_async_response (SnapdRequest *self, guint status_code, const gchar *conten
     return TRUE;
 }
 
-static gboolean
-times_equal (GDateTime *time1, GDateTime *time2)
-{
-    if (time1 == NULL || time2 == NULL)
-        return time1 == time2;
-    return g_date_time_equal (time1, time2);
-}
-
 static gboolean
 tasks_equal (SnapdTask *task1, SnapdTask *task2)
 {
+    /* Tasks that didn't change are reused from the previous poll */
+    if (task1 == task2)
+        return TRUE;
+
     return g_strcmp0 (snapd_task_get_id (task1), snapd_task_get_id (task2)) == 0 &&
            g_strcmp0 (snapd_task_get_kind (task1), snapd_task_get_kind (task2)) == 0 &&
            g_strcmp0 (snapd_task_get_summary (task1), snapd_task_get_summary (task2)) == 0 &&
@@ -87,14 +103,14 @@ tasks_equal (SnapdTask *task1, SnapdTask *task2)
            g_strcmp0 (snapd_task_get_progress_label (task1), snapd_task_get_progress_label (task2)) == 0 &&
            snapd_task_get_progress_done (task1) == snapd_task_get_progress_done (task2) &&
            snapd_task_get_progress_total (task1) == snapd_task_get_progress_total (task2) &&
-           times_equal (snapd_task_get_spawn_time (task1), snapd_task_get_spawn_time (task2)) &&
-           times_equal (snapd_task_get_spawn_time (task1), snapd_task_get_spawn_time (task2));
+           _snapd_timestamp_equal (_snapd_task_get_spawn_timestamp (task1), _snapd_task_get_spawn_timestamp (task2)) &&
+           _snapd_timestamp_equal (_snapd_task_get_ready_timestamp (task1), _snapd_task_get_ready_timestamp (task2));
 }
 
 static gboolean
 changes_equal (SnapdChange *change1, SnapdChange *change2)
 {
-    if (change1 == NULL || change2 == NULL)
+    if (change1 == NULL || change2 == NULL || change1 == change2)
         return change1 == change2;
 
     GPtrArray *tasks1 = snapd_change_get_tasks (change1);
@@ -118,25 +134,167 @@ changes_equal (SnapdChange *change1, SnapdChange *change2)
            g_strcmp0 (snapd_change_get_summary (change1), snapd_change_get_summary (change2)) == 0 &&
            g_strcmp0 (snapd_change_get_status (change1), snapd_change_get_status (change2)) == 0 &&
            !!snapd_change_get_ready (change1) == !!snapd_change_get_ready (change2) &&
-           times_equal (snapd_change_get_spawn_time (change1), snapd_change_get_spawn_time (change2)) &&
-           times_equal (snapd_change_get_spawn_time (change1), snapd_change_get_spawn_time (change2));
+           _snapd_timestamp_equal (_snapd_change_get_spawn_timestamp (change1), _snapd_change_get_spawn_timestamp (change2)) &&
+           _snapd_timestamp_equal (_snapd_change_get_ready_timestamp (change1), _snapd_change_get_ready_timestamp (change2));
 
     return TRUE;
 }
 
+/* Get the tasks in @change that are new or differ from those in @previous */
+static GPtrArray *
+get_changed_tasks (SnapdChange *previous, SnapdChange *change)
+{
+    GPtrArray *previous_tasks = previous != NULL ? snapd_change_get_tasks (previous) : NULL;
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    GPtrArray *changed_tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; tasks != NULL && i < tasks->len; i++) {
+        SnapdTask *task = tasks->pdata[i];
+        SnapdTask *previous_task = previous_tasks != NULL && i < previous_tasks->len ? previous_tasks->pdata[i] : NULL;
+        if (previous_task == NULL || !tasks_equal (previous_task, task))
+            g_ptr_array_add (changed_tasks, g_object_ref (task));
+    }
+
+    return changed_tasks;
+}
+
+static void
+progress_data_free (ProgressData *data)
+{
+    g_object_unref (data->request);
+    g_object_unref (data->client);
+    g_object_unref (data->change);
+    g_slice_free (ProgressData, data);
+}
+
+/* Called in the context the request was made from */
+static void
+call_progress_callback (ProgressData *data)
+{
+    SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (data->request);
+
+    /* Changed tasks are relative to the last report made, as reports may have been skipped */
+    g_autoptr(GPtrArray) changed_tasks = NULL;
+    if (data->delta_callback != NULL)
+        changed_tasks = get_changed_tasks (priv->reported_change, data->change);
+    g_set_object (&priv->reported_change, data->change);
+
+    if (priv->progress_callback != NULL)
+        priv->progress_callback (data->client,
+                                 data->change,
+                                 snapd_change_get_tasks (data->change), // Passed for ABI compatibility, is deprecated
+                                 priv->progress_callback_data);
+    if (data->delta_callback != NULL)
+        data->delta_callback (data->client, data->change, changed_tasks, data->delta_callback_data);
+}
+
+static gboolean
+progress_cb (gpointer user_data)
+{
+    ProgressData *data = user_data;
+    call_progress_callback (data);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+send_progress (ProgressData *data)
+{
+    /* Call back in the context the request was made from, responses may be handled in another thread */
+    GMainContext *context = _snapd_request_get_context (SNAPD_REQUEST (data->request));
+    if (g_main_context_is_owner (context)) {
+        call_progress_callback (data);
+        progress_data_free (data);
+        return;
+    }
+
+    _snapd_request_dispatch (SNAPD_REQUEST (data->request), progress_cb, data, (GDestroyNotify) progress_data_free);
+}
+
+/* Take the report held back by the rate limit, if there is one */
+static ProgressData *
+take_pending_progress (SnapdRequestAsync *self)
+{
+    SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (self);
+
+    if (priv->progress_source != NULL)
+        g_source_destroy (priv->progress_source);
+    g_clear_pointer (&priv->progress_source, g_source_unref);
+    return g_steal_pointer (&priv->pending_progress);
+}
+
+static gboolean
+progress_timeout_cb (gpointer user_data)
+{
+    SnapdRequestAsync *self = user_data;
+    SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->progress_mutex);
+    ProgressData *data = take_pending_progress (self);
+    priv->last_report_time = g_get_monotonic_time ();
+    g_clear_pointer (&locker, g_mutex_locker_free);
+
+    if (data != NULL)
+        send_progress (data);
+
+    return G_SOURCE_REMOVE;
+}
+
 void
-_snapd_request_async_report_progress (SnapdRequestAsync *self, SnapdClient *client, SnapdChange *change)
+_snapd_request_async_report_progress (SnapdRequestAsync *self, SnapdClient *client, SnapdChange *change,
+                                      SnapdProgressDeltaCallback delta_callback, gpointer delta_callback_data,
+                                      guint min_interval)
 {
     SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (self);
 
-    if (!changes_equal (priv->change, change)) {
-        g_set_object (&priv->change, change);
-        if (priv->progress_callback != NULL)
-            priv->progress_callback (client,
-                                     change,
-                                     snapd_change_get_tasks (change), // Passed for ABI compatibility, is deprecated
-                                     priv->progress_callback_data);
+    if (changes_equal (priv->change, change))
+        return;
+    g_set_object (&priv->change, change);
+    if (priv->progress_callback == NULL && delta_callback == NULL)
+        return;
+
+    ProgressData *data = g_slice_new (ProgressData);
+    data->request = g_object_ref (self);
+    data->client = g_object_ref (client);
+    data->change = g_object_ref (change);
+    data->delta_callback = delta_callback;
+    data->delta_callback_data = delta_callback_data;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->progress_mutex);
+    gint64 now = g_get_monotonic_time ();
+    gint64 next_report_time = priv->last_report_time + (gint64) min_interval * 1000;
+
+    /* The final state is sent straight away, so it is always seen before the request completes */
+    if (min_interval == 0 || snapd_change_get_ready (change) || (priv->progress_source == NULL && now >= next_report_time)) {
+        ProgressData *pending = take_pending_progress (self);
+        if (pending != NULL)
+            progress_data_free (pending);
+        priv->last_report_time = now;
+        g_clear_pointer (&locker, g_mutex_locker_free);
+        send_progress (data);
+        return;
     }
+
+    /* Otherwise only keep the latest state and send it when the interval is up */
+    if (priv->pending_progress != NULL)
+        progress_data_free (priv->pending_progress);
+    priv->pending_progress = data;
+    if (priv->progress_source == NULL) {
+        priv->progress_source = g_timeout_source_new ((guint) ((next_report_time - now) / 1000));
+        g_source_set_callback (priv->progress_source, progress_timeout_cb, g_object_ref (self), g_object_unref);
+        g_source_attach (priv->progress_source, _snapd_request_get_context (SNAPD_REQUEST (self)));
+    }
+}
+
+void
+_snapd_request_async_flush_progress (SnapdRequestAsync *self)
+{
+    SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->progress_mutex);
+    ProgressData *data = take_pending_progress (self);
+    g_clear_pointer (&locker, g_mutex_locker_free);
+
+    if (data != NULL)
+        send_progress (data);
 }
 
 SnapdGetChange *
@@ -146,6 +304,7 @@ _snapd_request_async_make_get_change_request (SnapdRequestAsync *self)
     SnapdGetChange *request = _snapd_get_change_new (priv->change_id, NULL, NULL, NULL);
 
     _snapd_get_change_set_api_path (request, priv->change_api_path);
+    _snapd_get_change_set_previous (request, priv->change);
     return request;
 }
 
@@ -191,6 +350,8 @@ snapd_request_async_finalize (GObject *object)
 
     g_clear_pointer (&priv->change_id, g_free);
     g_clear_object (&priv->change);
+    g_clear_object (&priv->reported_change);
+    g_mutex_clear (&priv->progress_mutex);
 
     G_OBJECT_CLASS (snapd_request_async_parent_class)->finalize (object);
 }
@@ -229,4 +390,7 @@ snapd_request_async_class_init (SnapdRequestAsyncClass *klass)
 static void
 snapd_request_async_init (SnapdRequestAsync *self)
 {
+    SnapdRequestAsyncPrivate *priv = snapd_request_async_get_instance_private (self);
+
+    g_mutex_init (&priv->progress_mutex);
 }
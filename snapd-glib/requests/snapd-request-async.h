@@ -36,9 +36,14 @@ gboolean     _snapd_request_async_parse_result    (SnapdRequestAsync *request,
                                                    JsonNode          *result,
                                                    GError           **error);
 
-void         _snapd_request_async_report_progress (SnapdRequestAsync *request,
-                                                   SnapdClient       *client,
-                                                   SnapdChange       *change);
+void         _snapd_request_async_report_progress (SnapdRequestAsync          *request,
+                                                   SnapdClient                *client,
+                                                   SnapdChange                *change,
+                                                   SnapdProgressDeltaCallback  delta_callback,
+                                                   gpointer                    delta_callback_data,
+                                                   guint                       min_interval);
+
+void         _snapd_request_async_flush_progress  (SnapdRequestAsync *request);
 
 SnapdGetChange  *_snapd_request_async_make_get_change_request  (SnapdRequestAsync *request);
 
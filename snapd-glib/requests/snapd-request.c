@@ -8,6 +8,10 @@
  */
 
 #include "snapd-request.h"
+#include "snapd-catalog-cache-private.h"
+#include "snapd-error.h"
+#include "snapd-json.h"
+#include "snapd-request-timings-private.h"
 
 enum
 {
@@ -25,11 +29,80 @@ typedef struct
     /* Context request was made from */
     GMainContext *context;
 
-    SoupMessage *message;
+    SnapdHttpRequest *http_request;
     GBytes *body;
 
+    /* Stream or file to send after the body and data to send once it is complete */
+    GInputStream *body_stream;
+    goffset body_stream_length;
+    int body_fd;
+    goffset body_fd_length;
+    GBytes *body_trailer;
+
+    /* Stream to write an unparsed response body to as it is received */
+    GOutputStream *response_stream;
+    gchar *response_stream_content_type;
+    GFileProgressCallback response_progress_callback;
+    gpointer response_progress_callback_data;
+    goffset response_length;
+
+    /* Rate shared with other requests that the streamed response is received at, or %NULL for no limit */
+    SnapdBandwidthLimit *bandwidth_limit;
+
+    /* TRUE if the response body is passed to the write_response method as it is received */
+    gboolean write_response;
+
+    /* Function to pass each item in the response to as it is parsed */
+    SnapdRequestItemCallback item_callback;
+    gpointer item_callback_data;
+    gboolean items_dispatched;
+
+    /* Number of items queued for the callback but not yet passed to it, and function to call once they have been */
+    gint n_pending_items;
+    SnapdRequestFinishedCallback items_delivered_callback;
+    gpointer items_delivered_callback_data;
+
+    /* TRUE if objects can keep the parsed response and build their contents on demand */
+    gboolean lazy_parsing;
+
+    /* TRUE if snaps identical to ones already parsed in this process are shared */
+    gboolean share_snaps;
+
+    /* Counter to add the size of parsed snaps to while they are alive */
+    SnapdMemoryCounter *memory_counter;
+
+    /* Priority to send this request ahead of others waiting to be written */
+    gint priority;
+
+    /* Largest response body to keep in memory, or 0 for no limit */
+    gsize max_response_size;
+
+    /* Monotonic time this request must complete by, or 0 for no limit */
+    gint64 deadline;
+
+    /* Key of the requests this request replaces if they haven't completed */
+    gchar *supersede_key;
+
+    /* Headers to send in place of the ones of the client writing the request, when sent from
+     * another client sharing its transport */
+    GBytes *common_headers;
+
+    /* Cache to record the response in and fall back to if snapd can't be reached */
+    SnapdCatalogCache *catalog_cache;
+
+    /* Time spent in each phase of the request, and function to call once it has completed */
+    SnapdRequestTimings *timings;
+    SnapdRequestFinishedCallback finished_callback;
+    gpointer finished_callback_data;
+
+    /* TRUE if the response is only partly parsed, so can't be shared */
+    gboolean partial_response;
+
     GCancellable *cancellable;
 
+    /* TRUE if made by a sync call, so can be completed without returning to the main loop */
+    gboolean sync;
+
     gboolean responded;
     GAsyncReadyCallback ready_callback;
     gpointer ready_callback_data;
@@ -61,22 +134,631 @@ void
 _snapd_request_set_source_object (SnapdRequest *self, GObject *object)
 {
     SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
-    priv->source_object = g_object_ref (object);
+    g_set_object (&priv->source_object, object);
 }
 
-SoupMessage *
-_snapd_request_get_message (SnapdRequest *self, GBytes **body)
+SnapdHttpRequest *
+_snapd_request_get_http_request (SnapdRequest *self, GBytes **body)
 {
     SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
 
-    if (priv->message == NULL) {
-        g_clear_object (&priv->body);
-        priv->message = SNAPD_REQUEST_GET_CLASS (self)->generate_request (self, &priv->body);
+    if (priv->http_request == NULL) {
+        g_clear_pointer (&priv->body, g_bytes_unref);
+        priv->http_request = SNAPD_REQUEST_GET_CLASS (self)->generate_request (self, &priv->body);
     }
 
     if (body != NULL)
         *body = priv->body != NULL ? g_bytes_ref (priv->body) : NULL;
-    return priv->message;
+    return priv->http_request;
+}
+
+void
+_snapd_request_set_body_stream (SnapdRequest *self, GInputStream *stream)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_set_object (&priv->body_stream, stream);
+}
+
+void
+_snapd_request_set_body_stream_length (SnapdRequest *self, goffset length)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->body_stream_length = length;
+}
+
+void
+_snapd_request_set_body_fd (SnapdRequest *self, int fd, goffset length)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->body_fd = fd;
+    priv->body_fd_length = length;
+}
+
+void
+_snapd_request_set_body_trailer (SnapdRequest *self, GBytes *trailer)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_clear_pointer (&priv->body_trailer, g_bytes_unref);
+    priv->body_trailer = trailer != NULL ? g_bytes_ref (trailer) : NULL;
+}
+
+GInputStream *
+_snapd_request_get_body_stream (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->body_stream;
+}
+
+goffset
+_snapd_request_get_body_stream_length (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->body_stream_length;
+}
+
+int
+_snapd_request_get_body_fd (SnapdRequest *self, goffset *length)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    if (length != NULL)
+        *length = priv->body_fd_length;
+    return priv->body_fd;
+}
+
+GBytes *
+_snapd_request_get_body_trailer (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->body_trailer;
+}
+
+/* Drop the body once it has been written so large uploads don't stay in memory
+ * while waiting for the response. The request can't be sent again after this */
+void
+_snapd_request_release_body (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+
+    g_clear_pointer (&priv->body, g_bytes_unref);
+    g_clear_object (&priv->body_stream);
+    priv->body_stream_length = -1;
+    priv->body_fd = -1;
+    priv->body_fd_length = 0;
+    g_clear_pointer (&priv->body_trailer, g_bytes_unref);
+
+    if (SNAPD_REQUEST_GET_CLASS (self)->release_body != NULL)
+        SNAPD_REQUEST_GET_CLASS (self)->release_body (self);
+}
+
+void
+_snapd_request_set_response_stream (SnapdRequest *self, GOutputStream *stream,
+                                    GFileProgressCallback progress_callback, gpointer progress_callback_data)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_set_object (&priv->response_stream, stream);
+    priv->response_progress_callback = progress_callback;
+    priv->response_progress_callback_data = progress_callback_data;
+}
+
+gboolean
+_snapd_request_has_response_stream (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->response_stream != NULL;
+}
+
+void
+_snapd_request_set_response_stream_content_type (SnapdRequest *self, const gchar *content_type)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_free (priv->response_stream_content_type);
+    priv->response_stream_content_type = g_strdup (content_type);
+}
+
+void
+_snapd_request_set_bandwidth_limit (SnapdRequest *self, SnapdBandwidthLimit *limit)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_clear_pointer (&priv->bandwidth_limit, _snapd_bandwidth_limit_unref);
+    if (limit != NULL)
+        priv->bandwidth_limit = _snapd_bandwidth_limit_ref (limit);
+}
+
+SnapdBandwidthLimit *
+_snapd_request_get_bandwidth_limit (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->bandwidth_limit;
+}
+
+void
+_snapd_request_set_write_response (SnapdRequest *self, gboolean write_response)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->write_response = write_response && SNAPD_REQUEST_GET_CLASS (self)->write_response != NULL;
+}
+
+gboolean
+_snapd_request_streams_response (SnapdRequest *self, const gchar *content_type)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+
+    /* Only binary content is written to streams, errors are still parsed as JSON */
+    if (priv->response_stream != NULL)
+        return g_strcmp0 (content_type, priv->response_stream_content_type != NULL ? priv->response_stream_content_type : "application/octet-stream") == 0;
+
+    return priv->write_response;
+}
+
+/* A callback waiting to be called in the context a request was made from */
+typedef struct
+{
+    GSourceFunc callback;
+    gpointer data;
+    GDestroyNotify notify;
+} DispatchItem;
+
+/* Callbacks waiting for each context, called in order from a single idle source */
+typedef struct
+{
+    GMainContext *context;
+    GQueue items;
+} DispatchQueue;
+
+static GMutex dispatch_queues_mutex;
+static GHashTable *dispatch_queues = NULL;
+
+static void
+dispatch_item_free (DispatchItem *item)
+{
+    if (item->notify != NULL)
+        item->notify (item->data);
+    g_slice_free (DispatchItem, item);
+}
+
+static void
+dispatch_queue_free (DispatchQueue *queue)
+{
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dispatch_queues_mutex);
+        if (g_hash_table_lookup (dispatch_queues, queue->context) == queue)
+            g_hash_table_remove (dispatch_queues, queue->context);
+    }
+
+    /* Only left if the context was destroyed before the callbacks were called */
+    g_queue_foreach (&queue->items, (GFunc) dispatch_item_free, NULL);
+    g_queue_clear (&queue->items);
+    g_slice_free (DispatchQueue, queue);
+}
+
+static gboolean
+dispatch_cb (gpointer user_data)
+{
+    DispatchQueue *queue = user_data;
+
+    /* Callbacks queued from now on go to a new source */
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dispatch_queues_mutex);
+        g_hash_table_remove (dispatch_queues, queue->context);
+    }
+
+    while (!g_queue_is_empty (&queue->items)) {
+        DispatchItem *item = g_queue_pop_head (&queue->items);
+        item->callback (item->data);
+        dispatch_item_free (item);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Call @callback in the context @self was made from. Callbacks queued while the context is
+ * busy are all called in one main loop iteration, in the order they were queued */
+void
+_snapd_request_dispatch (SnapdRequest *self, GSourceFunc callback, gpointer data, GDestroyNotify notify)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+
+    DispatchItem *item = g_slice_new (DispatchItem);
+    item->callback = callback;
+    item->data = data;
+    item->notify = notify;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&dispatch_queues_mutex);
+    if (dispatch_queues == NULL)
+        dispatch_queues = g_hash_table_new (g_direct_hash, g_direct_equal);
+    DispatchQueue *queue = g_hash_table_lookup (dispatch_queues, priv->context);
+    if (queue == NULL) {
+        queue = g_slice_new0 (DispatchQueue);
+        queue->context = priv->context;
+        g_queue_init (&queue->items);
+        g_hash_table_insert (dispatch_queues, queue->context, queue);
+
+        g_autoptr(GSource) source = g_idle_source_new ();
+        g_source_set_name (source, "snapd-glib-dispatch-source");
+        g_source_set_callback (source, dispatch_cb, queue, (GDestroyNotify) dispatch_queue_free);
+        g_source_attach (source, queue->context);
+    }
+    g_queue_push_tail (&queue->items, item);
+}
+
+typedef struct
+{
+    SnapdRequest *request;
+    goffset current_length;
+    goffset total_length;
+} ResponseProgressData;
+
+static void
+response_progress_data_free (ResponseProgressData *data)
+{
+    g_object_unref (data->request);
+    g_slice_free (ResponseProgressData, data);
+}
+
+static gboolean
+response_progress_cb (gpointer user_data)
+{
+    ResponseProgressData *data = user_data;
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (data->request);
+
+    priv->response_progress_callback (data->current_length, data->total_length, priv->response_progress_callback_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+report_response_progress (SnapdRequest *self, goffset total_length)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+
+    /* Call back in the context the request was made from, responses may be handled in another thread */
+    if (g_main_context_is_owner (priv->context)) {
+        priv->response_progress_callback (priv->response_length, total_length, priv->response_progress_callback_data);
+        return;
+    }
+
+    ResponseProgressData *data = g_slice_new (ResponseProgressData);
+    data->request = g_object_ref (self);
+    data->current_length = priv->response_length;
+    data->total_length = total_length;
+    _snapd_request_dispatch (self, response_progress_cb, data, (GDestroyNotify) response_progress_data_free);
+}
+
+gboolean
+_snapd_request_write_response (SnapdRequest *self, const guint8 *data, gsize length, goffset total_length, GError **error)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+
+    if (length == 0)
+        return TRUE;
+
+    if (priv->response_stream == NULL)
+        return SNAPD_REQUEST_GET_CLASS (self)->write_response (self, data, length, error);
+
+    if (!g_output_stream_write_all (priv->response_stream, data, length, NULL, priv->cancellable, error))
+        return FALSE;
+    priv->response_length += length;
+
+    if (priv->response_progress_callback != NULL)
+        report_response_progress (self, total_length);
+
+    return TRUE;
+}
+
+goffset
+_snapd_request_get_response_length (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->response_length;
+}
+
+void
+_snapd_request_set_item_callback (SnapdRequest *self, GCallback callback, gpointer callback_data)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->item_callback = (SnapdRequestItemCallback) callback;
+    priv->item_callback_data = callback_data;
+}
+
+gboolean
+_snapd_request_has_item_callback (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->item_callback != NULL;
+}
+
+typedef struct
+{
+    SnapdRequest *request;
+    GObject *item;
+} ItemData;
+
+static void
+item_data_free (ItemData *data)
+{
+    g_object_unref (data->request);
+    g_object_unref (data->item);
+    g_slice_free (ItemData, data);
+}
+
+static gboolean
+item_cb (gpointer user_data)
+{
+    ItemData *data = user_data;
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (data->request);
+
+    priv->item_callback (priv->source_object, data->item, priv->item_callback_data);
+    if (g_atomic_int_dec_and_test (&priv->n_pending_items) && priv->items_delivered_callback != NULL)
+        priv->items_delivered_callback (data->request, priv->items_delivered_callback_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+void
+_snapd_request_report_item (SnapdRequest *self, GObject *item)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+
+    /* Call back in the context the request was made from, responses may be parsed in another thread.
+     * Items are queued ahead of the completion so they are always delivered first */
+    if (g_main_context_is_owner (priv->context)) {
+        priv->item_callback (priv->source_object, item, priv->item_callback_data);
+        return;
+    }
+
+    ItemData *data = g_slice_new (ItemData);
+    data->request = g_object_ref (self);
+    data->item = g_object_ref (item);
+    priv->items_dispatched = TRUE;
+    g_atomic_int_inc (&priv->n_pending_items);
+    _snapd_request_dispatch (self, item_cb, data, (GDestroyNotify) item_data_free);
+}
+
+/* Get the number of items reported from another thread that haven't been passed to the item callback yet */
+guint
+_snapd_request_get_n_pending_items (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+    return g_atomic_int_get (&priv->n_pending_items);
+}
+
+/* Call @callback in the request's context each time all the pending items have been passed to the item callback */
+void
+_snapd_request_set_items_delivered_callback (SnapdRequest *self, SnapdRequestFinishedCallback callback, gpointer callback_data)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+    priv->items_delivered_callback = callback;
+    priv->items_delivered_callback_data = callback_data;
+}
+
+void
+_snapd_request_set_lazy_parsing (SnapdRequest *self, gboolean lazy_parsing)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->lazy_parsing = lazy_parsing;
+}
+
+gboolean
+_snapd_request_get_lazy_parsing (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->lazy_parsing;
+}
+
+void
+_snapd_request_set_share_snaps (SnapdRequest *self, gboolean share_snaps)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->share_snaps = share_snaps;
+}
+
+/* Parse a snap from the response, using the identity map if enabled.
+ * Memory is only tracked for new snaps, not ones shared from earlier responses */
+SnapdSnap *
+_snapd_request_parse_snap (SnapdRequest *self, JsonNode *node, SnapdSnapFields fields, SnapdArena *arena, GError **error)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+
+    gboolean lazy = fields == SNAPD_SNAP_FIELDS_ALL && priv->lazy_parsing;
+    gboolean is_new = TRUE;
+    SnapdSnap *snap;
+    if (priv->share_snaps)
+        snap = _snapd_json_parse_snap_shared (node, lazy, fields, arena, &is_new, error);
+    else
+        snap = _snapd_json_parse_snap_full (node, lazy, fields, arena, error);
+    if (snap != NULL && is_new)
+        _snapd_request_track_snap (self, snap);
+
+    return snap;
+}
+
+void
+_snapd_request_set_memory_counter (SnapdRequest *self, SnapdMemoryCounter *counter)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_clear_pointer (&priv->memory_counter, _snapd_memory_counter_unref);
+    if (counter != NULL)
+        priv->memory_counter = _snapd_memory_counter_ref (counter);
+}
+
+/* Count the memory used by a newly parsed snap, if the client is tracking it */
+void
+_snapd_request_track_snap (SnapdRequest *self, SnapdSnap *snap)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    if (priv->memory_counter != NULL)
+        _snapd_memory_counter_track (priv->memory_counter, G_OBJECT (snap), snapd_snap_get_memory_size (snap));
+}
+
+void
+_snapd_request_set_priority (SnapdRequest *self, gint priority)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->priority = priority;
+}
+
+gint
+_snapd_request_get_priority (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->priority;
+}
+
+void
+_snapd_request_set_max_response_size (SnapdRequest *self, gsize max_response_size)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->max_response_size = max_response_size;
+}
+
+gsize
+_snapd_request_get_max_response_size (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->max_response_size;
+}
+
+void
+_snapd_request_set_deadline (SnapdRequest *self, gint64 deadline)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->deadline = deadline;
+}
+
+gint64
+_snapd_request_get_deadline (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->deadline;
+}
+
+void
+_snapd_request_set_supersede_key (SnapdRequest *self, const gchar *supersede_key)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_free (priv->supersede_key);
+    priv->supersede_key = g_strdup (supersede_key);
+}
+
+const gchar *
+_snapd_request_get_supersede_key (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->supersede_key;
+}
+
+void
+_snapd_request_set_common_headers (SnapdRequest *self, GBytes *common_headers)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_clear_pointer (&priv->common_headers, g_bytes_unref);
+    if (common_headers != NULL)
+        priv->common_headers = g_bytes_ref (common_headers);
+}
+
+GBytes *
+_snapd_request_get_common_headers (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->common_headers;
+}
+
+void
+_snapd_request_set_catalog_cache (SnapdRequest *self, SnapdCatalogCache *cache)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    g_set_object (&priv->catalog_cache, cache);
+}
+
+static gchar *
+get_cache_path (SnapdRequest *self)
+{
+    SnapdHttpRequest *http_request = _snapd_request_get_http_request (self, NULL);
+    if (http_request->query != NULL)
+        return g_strdup_printf ("%s?%s", http_request->path, http_request->query);
+    else
+        return g_strdup (http_request->path);
+}
+
+/* Record a successfully parsed response, if the client is caching them */
+void
+_snapd_request_store_response (SnapdRequest *self, GBytes *body)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    if (priv->catalog_cache == NULL)
+        return;
+
+    g_autofree gchar *path = get_cache_path (self);
+    _snapd_catalog_cache_insert (priv->catalog_cache, path, body);
+}
+
+/* Parse the response last recorded for this request in @cache */
+gboolean
+_snapd_request_parse_cached_response (SnapdRequest *self, SnapdCatalogCache *cache, GError **error)
+{
+    g_autofree gchar *path = get_cache_path (self);
+    g_autoptr(GBytes) body = _snapd_catalog_cache_lookup (cache, path);
+    if (body == NULL) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND, "No cached response for %s", path);
+        return FALSE;
+    }
+
+    g_autoptr(SnapdMaintenance) maintenance = NULL;
+    return SNAPD_REQUEST_GET_CLASS (self)->parse_response (self, 200, "application/json", body, &maintenance, error);
+}
+
+SnapdRequestTimings *
+_snapd_request_get_timings (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    return priv->timings;
+}
+
+void
+_snapd_request_set_finished_callback (SnapdRequest *self, SnapdRequestFinishedCallback callback, gpointer callback_data)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->finished_callback = callback;
+    priv->finished_callback_data = callback_data;
+}
+
+void
+_snapd_request_set_partial_response (SnapdRequest *self, gboolean partial_response)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (SNAPD_REQUEST (self));
+    priv->partial_response = partial_response;
+}
+
+gboolean
+_snapd_request_can_copy_response (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+
+    /* Items are reported while parsing, so the response has to come from snapd */
+    if (priv->item_callback != NULL || priv->partial_response)
+        return FALSE;
+
+    return SNAPD_REQUEST_GET_CLASS (self)->copy_response != NULL;
+}
+
+void
+_snapd_request_copy_response (SnapdRequest *self, SnapdRequest *source)
+{
+    g_return_if_fail (G_OBJECT_TYPE (self) == G_OBJECT_TYPE (source));
+    SNAPD_REQUEST_GET_CLASS (self)->copy_response (self, source);
+}
+
+gboolean
+_snapd_request_needs_headers (SnapdRequest *self)
+{
+    return SNAPD_REQUEST_GET_CLASS (self)->parse_headers != NULL;
+}
+
+void
+_snapd_request_parse_headers (SnapdRequest *self, guint status_code, SoupMessageHeaders *headers)
+{
+    if (SNAPD_REQUEST_GET_CLASS (self)->parse_headers != NULL)
+        SNAPD_REQUEST_GET_CLASS (self)->parse_headers (self, status_code, headers);
 }
 
 static gboolean
@@ -85,12 +767,24 @@ respond_cb (gpointer user_data)
     SnapdRequest *self = SNAPD_REQUEST (user_data);
     SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
 
+    _snapd_request_timings_set_time (priv->timings, SNAPD_REQUEST_PHASE_COMPLETED, g_get_monotonic_time ());
     if (priv->ready_callback != NULL)
         priv->ready_callback (priv->source_object, G_ASYNC_RESULT (self), priv->ready_callback_data);
+    if (priv->finished_callback != NULL)
+        priv->finished_callback (self, priv->finished_callback_data);
 
     return G_SOURCE_REMOVE;
 }
 
+/* Set when requests being created are for a sync call in this thread */
+static GPrivate making_sync_requests;
+
+void
+_snapd_request_set_making_sync_requests (gboolean making_sync_requests_)
+{
+    g_private_set (&making_sync_requests, GINT_TO_POINTER (making_sync_requests_));
+}
+
 void
 _snapd_request_return (SnapdRequest *self, GError *error)
 {
@@ -102,9 +796,22 @@ _snapd_request_return (SnapdRequest *self, GError *error)
     if (error != NULL)
         priv->error = g_error_copy (error);
 
-    g_autoptr(GSource) source = g_idle_source_new ();
-    g_source_set_callback (source, respond_cb, g_object_ref (self), g_object_unref);
-    g_source_attach (source, _snapd_request_get_context (self));
+    /* A sync call is waiting in this context, so complete it now rather than via another main loop iteration.
+     * If items are queued the completion has to follow them */
+    if (priv->sync && !priv->items_dispatched && g_main_context_is_owner (priv->context)) {
+        g_autoptr(SnapdRequest) request = g_object_ref (self);
+        respond_cb (request);
+        return;
+    }
+
+    _snapd_request_dispatch (self, respond_cb, g_object_ref (self), g_object_unref);
+}
+
+gboolean
+_snapd_request_get_responded (SnapdRequest *self)
+{
+    SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
+    return priv->responded;
 }
 
 gboolean
@@ -171,8 +878,18 @@ snapd_request_finalize (GObject *object)
     SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
 
     g_clear_object (&priv->source_object);
-    g_clear_object (&priv->message);
+    g_clear_object (&priv->timings);
+    g_clear_pointer (&priv->memory_counter, _snapd_memory_counter_unref);
+    g_clear_pointer (&priv->supersede_key, g_free);
+    g_clear_pointer (&priv->common_headers, g_bytes_unref);
+    g_clear_object (&priv->catalog_cache);
+    g_clear_pointer (&priv->http_request, _snapd_http_request_free);
     g_clear_pointer (&priv->body, g_bytes_unref);
+    g_clear_object (&priv->body_stream);
+    g_clear_pointer (&priv->body_trailer, g_bytes_unref);
+    g_clear_object (&priv->response_stream);
+    g_clear_pointer (&priv->response_stream_content_type, g_free);
+    g_clear_pointer (&priv->bandwidth_limit, _snapd_bandwidth_limit_unref);
     g_clear_object (&priv->cancellable);
     g_clear_pointer (&priv->error, g_error_free);
     g_clear_pointer (&priv->context, g_main_context_unref);
@@ -222,4 +939,8 @@ snapd_request_init (SnapdRequest *self)
     SnapdRequestPrivate *priv = snapd_request_get_instance_private (self);
 
     priv->context = g_main_context_ref_thread_default ();
+    priv->sync = GPOINTER_TO_INT (g_private_get (&making_sync_requests));
+    priv->body_stream_length = -1;
+    priv->body_fd = -1;
+    priv->timings = _snapd_request_timings_new ();
 }
@@ -11,20 +11,37 @@
 #define __SNAPD_REQUEST_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <libsoup/soup.h>
+#include <json-glib/json-glib.h>
 
+#include "snapd-arena.h"
+#include "snapd-bandwidth-limit.h"
+#include "snapd-catalog-cache.h"
+#include "snapd-http-request.h"
 #include "snapd-maintenance.h"
+#include "snapd-memory.h"
+#include "snapd-request-timings.h"
+#include "snapd-snap.h"
 
 G_BEGIN_DECLS
 
 G_DECLARE_DERIVABLE_TYPE (SnapdRequest, snapd_request, SNAPD, REQUEST, GObject)
 
+typedef void (*SnapdRequestItemCallback) (GObject *source_object, GObject *item, gpointer user_data);
+
+typedef void (*SnapdRequestFinishedCallback) (SnapdRequest *request, gpointer user_data);
+
 struct _SnapdRequestClass
 {
     GObjectClass parent_class;
 
-    SoupMessage *(*generate_request)(SnapdRequest *request, GBytes **body);
+    SnapdHttpRequest *(*generate_request)(SnapdRequest *request, GBytes **body);
+    void (*parse_headers)(SnapdRequest *request, guint status_code, SoupMessageHeaders *headers);
     gboolean (*parse_response)(SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body, SnapdMaintenance **maintenance, GError **error);
+    void (*copy_response)(SnapdRequest *request, SnapdRequest *source);
+    gboolean (*write_response)(SnapdRequest *request, const guint8 *data, gsize length, GError **error);
+    void (*release_body)(SnapdRequest *request);
 };
 
 void          _snapd_request_set_source_object (SnapdRequest *request,
@@ -32,16 +49,168 @@ void          _snapd_request_set_source_object (SnapdRequest *request,
 
 GMainContext *_snapd_request_get_context       (SnapdRequest *request);
 
+void          _snapd_request_set_making_sync_requests (gboolean making_sync_requests);
+
+void          _snapd_request_dispatch          (SnapdRequest   *request,
+                                                GSourceFunc     callback,
+                                                gpointer        data,
+                                                GDestroyNotify  notify);
+
 GCancellable *_snapd_request_get_cancellable   (SnapdRequest *request);
 
 void          _snapd_request_generate          (SnapdRequest *request);
 
-SoupMessage  *_snapd_request_get_message       (SnapdRequest *request,
-                                                GBytes      **body);
+SnapdHttpRequest *_snapd_request_get_http_request (SnapdRequest *request,
+                                                   GBytes      **body);
+
+void          _snapd_request_set_body_stream   (SnapdRequest *request,
+                                                GInputStream *stream);
+
+void          _snapd_request_set_body_stream_length (SnapdRequest *request,
+                                                     goffset       length);
+
+void          _snapd_request_set_body_fd       (SnapdRequest *request,
+                                                int           fd,
+                                                goffset       length);
+
+void          _snapd_request_set_body_trailer  (SnapdRequest *request,
+                                                GBytes       *trailer);
+
+GInputStream *_snapd_request_get_body_stream   (SnapdRequest *request);
+
+goffset       _snapd_request_get_body_stream_length (SnapdRequest *request);
+
+int           _snapd_request_get_body_fd       (SnapdRequest *request,
+                                                goffset      *length);
+
+GBytes       *_snapd_request_get_body_trailer  (SnapdRequest *request);
+
+void          _snapd_request_release_body      (SnapdRequest *request);
+
+void          _snapd_request_set_response_stream (SnapdRequest          *request,
+                                                  GOutputStream         *stream,
+                                                  GFileProgressCallback  progress_callback,
+                                                  gpointer               progress_callback_data);
+
+gboolean      _snapd_request_has_response_stream (SnapdRequest          *request);
+
+void          _snapd_request_set_response_stream_content_type (SnapdRequest *request,
+                                                               const gchar  *content_type);
+
+void          _snapd_request_set_bandwidth_limit (SnapdRequest          *request,
+                                                  SnapdBandwidthLimit   *limit);
+
+SnapdBandwidthLimit *_snapd_request_get_bandwidth_limit (SnapdRequest   *request);
+
+void          _snapd_request_set_write_response  (SnapdRequest          *request,
+                                                  gboolean               write_response);
+
+gboolean      _snapd_request_streams_response    (SnapdRequest          *request,
+                                                  const gchar           *content_type);
+
+gboolean      _snapd_request_write_response      (SnapdRequest          *request,
+                                                  const guint8          *data,
+                                                  gsize                  length,
+                                                  goffset                total_length,
+                                                  GError               **error);
+
+goffset       _snapd_request_get_response_length (SnapdRequest          *request);
+
+void          _snapd_request_set_item_callback (SnapdRequest *request,
+                                                GCallback     callback,
+                                                gpointer      callback_data);
+
+gboolean      _snapd_request_has_item_callback (SnapdRequest *request);
+
+void          _snapd_request_report_item       (SnapdRequest *request,
+                                                GObject      *item);
+
+guint         _snapd_request_get_n_pending_items (SnapdRequest *request);
+
+void          _snapd_request_set_items_delivered_callback (SnapdRequest                 *request,
+                                                           SnapdRequestFinishedCallback  callback,
+                                                           gpointer                      callback_data);
+
+void          _snapd_request_set_lazy_parsing  (SnapdRequest *request,
+                                                gboolean      lazy_parsing);
+
+gboolean      _snapd_request_get_lazy_parsing  (SnapdRequest *request);
+
+void          _snapd_request_set_share_snaps   (SnapdRequest *request,
+                                                gboolean      share_snaps);
+
+SnapdSnap    *_snapd_request_parse_snap        (SnapdRequest     *request,
+                                                JsonNode         *node,
+                                                SnapdSnapFields   fields,
+                                                SnapdArena       *arena,
+                                                GError          **error);
+
+void          _snapd_request_set_memory_counter (SnapdRequest       *request,
+                                                 SnapdMemoryCounter *counter);
+
+void          _snapd_request_track_snap        (SnapdRequest *request,
+                                                SnapdSnap    *snap);
+
+void          _snapd_request_set_priority      (SnapdRequest *request,
+                                                gint          priority);
+
+gint          _snapd_request_get_priority      (SnapdRequest *request);
+
+void          _snapd_request_set_max_response_size (SnapdRequest *request,
+                                                    gsize         max_response_size);
+
+gsize         _snapd_request_get_max_response_size (SnapdRequest *request);
+
+void          _snapd_request_set_deadline      (SnapdRequest *request,
+                                                gint64        deadline);
+
+gint64        _snapd_request_get_deadline      (SnapdRequest *request);
+
+void          _snapd_request_set_supersede_key (SnapdRequest *request,
+                                                const gchar  *supersede_key);
+
+const gchar  *_snapd_request_get_supersede_key (SnapdRequest *request);
+
+void          _snapd_request_set_common_headers (SnapdRequest *request,
+                                                 GBytes       *common_headers);
+
+GBytes       *_snapd_request_get_common_headers (SnapdRequest *request);
+
+void          _snapd_request_set_catalog_cache (SnapdRequest      *request,
+                                                SnapdCatalogCache *cache);
+
+void          _snapd_request_store_response    (SnapdRequest *request,
+                                                GBytes       *body);
+
+gboolean      _snapd_request_parse_cached_response (SnapdRequest       *request,
+                                                    SnapdCatalogCache  *cache,
+                                                    GError            **error);
+
+SnapdRequestTimings *_snapd_request_get_timings (SnapdRequest *request);
+
+void          _snapd_request_set_finished_callback (SnapdRequest                 *request,
+                                                    SnapdRequestFinishedCallback  callback,
+                                                    gpointer                      callback_data);
+
+void          _snapd_request_set_partial_response (SnapdRequest *request,
+                                                   gboolean      partial_response);
+
+gboolean      _snapd_request_can_copy_response (SnapdRequest       *request);
+
+void          _snapd_request_copy_response     (SnapdRequest       *request,
+                                                SnapdRequest       *source);
+
+gboolean      _snapd_request_needs_headers     (SnapdRequest       *request);
+
+void          _snapd_request_parse_headers     (SnapdRequest       *request,
+                                                guint               status_code,
+                                                SoupMessageHeaders *headers);
 
 void          _snapd_request_return            (SnapdRequest *request,
                                                 GError       *error);
 
+gboolean      _snapd_request_get_responded     (SnapdRequest *request);
+
 gboolean      _snapd_request_propagate_error   (SnapdRequest *request,
                                                 GError      **error);
 
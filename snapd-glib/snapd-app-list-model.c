@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-app-list-model.h"
+#include "snapd-result-list-private.h"
+
+/**
+ * SECTION: snapd-app-list-model
+ * @short_description: Installed apps as a list model
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdAppListModel presents the apps of the snaps in a #SnapdSnapList as
+ * a #GListModel, in the order of the snaps then the order of the apps in each
+ * snap. When the #SnapdSnapList is refreshed #GListModel::items-changed is
+ * only emitted for the apps of the snaps that were added, removed or changed.
+ */
+
+/**
+ * SnapdAppListModel:
+ *
+ * #SnapdAppListModel is a list model of installed apps.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdAppListModel
+{
+    GObject parent_instance;
+
+    SnapdSnapList *list;
+
+    /* Apps as last reported to users of the model */
+    GPtrArray *apps;
+};
+
+static void snapd_app_list_model_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SnapdAppListModel, snapd_app_list_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, snapd_app_list_model_list_model_init))
+
+/* Get the apps of all the snaps in the list. Unchanged snaps keep their app objects between refreshes */
+static GPtrArray *
+get_apps (SnapdSnapList *list)
+{
+    GPtrArray *snaps = snapd_snap_list_get_snaps (list);
+    GPtrArray *apps = g_ptr_array_new ();
+    for (guint i = 0; i < snaps->len; i++) {
+        GPtrArray *snap_apps = snapd_snap_get_apps (g_ptr_array_index (snaps, i));
+        for (guint j = 0; snap_apps != NULL && j < snap_apps->len; j++)
+            g_ptr_array_add (apps, g_ptr_array_index (snap_apps, j));
+    }
+
+    return apps;
+}
+
+/* Bring the model up to date with the list. This is done on the first signal from a
+ * refresh, after which the list has all its changes and later signals do nothing */
+static void
+list_changed_cb (SnapdAppListModel *self)
+{
+    g_autoptr(GPtrArray) apps = get_apps (self->list);
+    _snapd_list_model_update (G_LIST_MODEL (self), self->apps, apps);
+}
+
+/**
+ * snapd_app_list_model_new:
+ * @list: a #SnapdSnapList.
+ *
+ * Create a list model of the apps of the snaps in @list. The model contains
+ * the apps of the snaps already in @list and is updated each time @list is
+ * refreshed.
+ *
+ * Returns: a new #SnapdAppListModel
+ *
+ * Since: 1.65
+ */
+SnapdAppListModel *
+snapd_app_list_model_new (SnapdSnapList *list)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST (list), NULL);
+
+    SnapdAppListModel *self = g_object_new (SNAPD_TYPE_APP_LIST_MODEL, NULL);
+    self->list = g_object_ref (list);
+    g_autoptr(GPtrArray) apps = get_apps (list);
+    for (guint i = 0; i < apps->len; i++)
+        g_ptr_array_add (self->apps, g_object_ref (g_ptr_array_index (apps, i)));
+    g_signal_connect_object (list, "snap-added", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object (list, "snap-removed", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object (list, "snap-changed", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+
+    return self;
+}
+
+/**
+ * snapd_app_list_model_get_list:
+ * @model: a #SnapdAppListModel.
+ *
+ * Get the list this model presents the apps of.
+ *
+ * Returns: (transfer none): a #SnapdSnapList
+ *
+ * Since: 1.65
+ */
+SnapdSnapList *
+snapd_app_list_model_get_list (SnapdAppListModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_APP_LIST_MODEL (self), NULL);
+    return self->list;
+}
+
+static GType
+snapd_app_list_model_get_item_type (GListModel *model)
+{
+    return SNAPD_TYPE_APP;
+}
+
+static guint
+snapd_app_list_model_get_n_items (GListModel *model)
+{
+    return SNAPD_APP_LIST_MODEL (model)->apps->len;
+}
+
+static gpointer
+snapd_app_list_model_get_item (GListModel *model, guint position)
+{
+    SnapdAppListModel *self = SNAPD_APP_LIST_MODEL (model);
+
+    if (position >= self->apps->len)
+        return NULL;
+    return g_object_ref (g_ptr_array_index (self->apps, position));
+}
+
+static void
+snapd_app_list_model_list_model_init (GListModelInterface *iface)
+{
+    iface->get_item_type = snapd_app_list_model_get_item_type;
+    iface->get_n_items = snapd_app_list_model_get_n_items;
+    iface->get_item = snapd_app_list_model_get_item;
+}
+
+static void
+snapd_app_list_model_finalize (GObject *object)
+{
+    SnapdAppListModel *self = SNAPD_APP_LIST_MODEL (object);
+
+    g_clear_object (&self->list);
+    g_clear_pointer (&self->apps, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_app_list_model_parent_class)->finalize (object);
+}
+
+static void
+snapd_app_list_model_class_init (SnapdAppListModelClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_app_list_model_finalize;
+}
+
+static void
+snapd_app_list_model_init (SnapdAppListModel *self)
+{
+    self->apps = g_ptr_array_new_with_free_func (g_object_unref);
+}
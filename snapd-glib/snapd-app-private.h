@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_APP_PRIVATE_H__
+#define __SNAPD_APP_PRIVATE_H__
+
+#include "snapd-app.h"
+#include "snapd-arena.h"
+
+G_BEGIN_DECLS
+
+SnapdApp *_snapd_app_new (SnapdArena      *arena,
+                          const gchar     *name,
+                          gboolean         active,
+                          const gchar     *common_id,
+                          SnapdDaemonType  daemon_type,
+                          const gchar     *desktop_file,
+                          gboolean         enabled,
+                          const gchar     *snap);
+
+gsize     _snapd_app_get_memory_size (SnapdApp *app);
+
+G_END_DECLS
+
+#endif /* __SNAPD_APP_PRIVATE_H__ */
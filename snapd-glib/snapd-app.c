@@ -10,7 +10,9 @@
 #include <string.h>
 
 #include "snapd-app.h"
+#include "snapd-app-private.h"
 #include "snapd-enum-types.h"
+#include "snapd-memory.h"
 
 /**
  * SECTION:snapd-app
@@ -41,6 +43,9 @@ struct _SnapdApp
     gchar *desktop_file;
     gboolean enabled;
     gboolean active;
+
+    /* Holds the strings if set by the parser, otherwise they are allocated separately */
+    SnapdArena *arena;
 };
 
 enum
@@ -58,6 +63,43 @@ enum
 
 G_DEFINE_TYPE (SnapdApp, snapd_app, G_TYPE_OBJECT)
 
+static gchar *
+copy_string (SnapdApp *self, const gchar *value)
+{
+    return self->arena != NULL ? _snapd_arena_strdup (self->arena, value) : g_strdup (value);
+}
+
+/* Create without going through properties */
+SnapdApp *
+_snapd_app_new (SnapdArena *arena, const gchar *name, gboolean active, const gchar *common_id,
+                SnapdDaemonType daemon_type, const gchar *desktop_file, gboolean enabled,
+                const gchar *snap)
+{
+    SnapdApp *self = g_object_new (SNAPD_TYPE_APP, NULL);
+
+    if (arena != NULL)
+        self->arena = _snapd_arena_ref (arena);
+    self->name = copy_string (self, name);
+    self->active = active;
+    self->common_id = copy_string (self, common_id);
+    self->daemon_type = daemon_type;
+    self->desktop_file = copy_string (self, desktop_file);
+    self->enabled = enabled;
+    self->snap = copy_string (self, snap);
+
+    return self;
+}
+
+gsize
+_snapd_app_get_memory_size (SnapdApp *self)
+{
+    return _snapd_memory_instance_size (self) +
+           _snapd_memory_string_size (self->name) +
+           _snapd_memory_string_size (self->snap) +
+           _snapd_memory_string_size (self->common_id) +
+           _snapd_memory_string_size (self->desktop_file);
+}
+
 /**
  * snapd_app_get_name:
  * @app: a #SnapdApp.
@@ -275,10 +317,14 @@ snapd_app_finalize (GObject *object)
 {
     SnapdApp *self = SNAPD_APP (object);
 
-    g_clear_pointer (&self->name, g_free);
-    g_clear_pointer (&self->common_id, g_free);
-    g_clear_pointer (&self->desktop_file, g_free);
-    g_clear_pointer (&self->snap, g_free);
+    if (self->arena != NULL)
+        g_clear_pointer (&self->arena, _snapd_arena_unref);
+    else {
+        g_free (self->name);
+        g_free (self->common_id);
+        g_free (self->desktop_file);
+        g_free (self->snap);
+    }
 
     G_OBJECT_CLASS (snapd_app_parent_class)->finalize (object);
 }
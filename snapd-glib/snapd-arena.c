@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-arena.h"
+
+/* Memory for the strings of the objects parsed from one response. Strings
+ * are allocated by bumping a pointer and are all freed together when the
+ * last object holding a reference is finalized. Allocation is not thread
+ * safe, so an arena is only allocated from while parsing. */
+
+#define CHUNK_SIZE 4096
+
+struct _SnapdArena
+{
+    gint ref_count;
+
+    /* Chunks to free */
+    GSList *chunks;
+
+    /* Free space in the current chunk */
+    gchar *next;
+    gsize remaining;
+
+    /* Buffer that strings can be used from directly instead of being copied */
+    GBytes *bytes;
+};
+
+SnapdArena *
+_snapd_arena_new (void)
+{
+    SnapdArena *arena = g_slice_new0 (SnapdArena);
+    arena->ref_count = 1;
+    return arena;
+}
+
+/* Create an arena that keeps @bytes alive, so strings inside it are used without copying */
+SnapdArena *
+_snapd_arena_new_for_bytes (GBytes *bytes)
+{
+    SnapdArena *arena = _snapd_arena_new ();
+    arena->bytes = g_bytes_ref (bytes);
+    return arena;
+}
+
+SnapdArena *
+_snapd_arena_ref (SnapdArena *arena)
+{
+    g_atomic_int_inc (&arena->ref_count);
+    return arena;
+}
+
+void
+_snapd_arena_unref (SnapdArena *arena)
+{
+    if (!g_atomic_int_dec_and_test (&arena->ref_count))
+        return;
+
+    g_slist_free_full (arena->chunks, g_free);
+    g_clear_pointer (&arena->bytes, g_bytes_unref);
+    g_slice_free (SnapdArena, arena);
+}
+
+static gpointer
+arena_alloc (SnapdArena *arena, gsize size)
+{
+    /* Large values get their own chunk so the space left in the current one isn't wasted */
+    if (size > CHUNK_SIZE / 4) {
+        gpointer data = g_malloc (size);
+        arena->chunks = g_slist_prepend (arena->chunks, data);
+        return data;
+    }
+
+    if (size > arena->remaining) {
+        arena->next = g_malloc (CHUNK_SIZE);
+        arena->remaining = CHUNK_SIZE;
+        arena->chunks = g_slist_prepend (arena->chunks, arena->next);
+    }
+
+    gpointer data = arena->next;
+    arena->next += size;
+    arena->remaining -= size;
+
+    return data;
+}
+
+gchar *
+_snapd_arena_strdup (SnapdArena *arena, const gchar *value)
+{
+    if (value == NULL)
+        return NULL;
+
+    if (arena->bytes != NULL) {
+        gsize length;
+        const gchar *data = g_bytes_get_data (arena->bytes, &length);
+        if (value >= data && value < data + length)
+            return (gchar *) value;
+    }
+
+    gsize size = strlen (value) + 1;
+    gchar *copy = arena_alloc (arena, size);
+    memcpy (copy, value, size);
+
+    return copy;
+}
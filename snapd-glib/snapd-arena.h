@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_ARENA_H__
+#define __SNAPD_ARENA_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SnapdArena SnapdArena;
+
+SnapdArena  *_snapd_arena_new    (void);
+
+SnapdArena  *_snapd_arena_new_for_bytes (GBytes *bytes);
+
+SnapdArena  *_snapd_arena_ref    (SnapdArena  *arena);
+
+void         _snapd_arena_unref  (SnapdArena  *arena);
+
+gchar       *_snapd_arena_strdup (SnapdArena  *arena,
+                                  const gchar *value);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdArena, _snapd_arena_unref)
+
+G_END_DECLS
+
+#endif /* __SNAPD_ARENA_H__ */
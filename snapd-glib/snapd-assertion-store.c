@@ -0,0 +1,620 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+#include <gio/gio.h>
+
+#include "snapd-assertion-store.h"
+#include "snapd-assertion-private.h"
+#include "snapd-signature.h"
+#include "snapd-timestamp.h"
+
+/**
+ * SECTION:snapd-assertion-store
+ * @short_description: Local assertion storage
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdAssertionStore holds assertions, such as those returned by
+ * snapd_client_get_assertions_sync(), so they can be looked up by their
+ * headers without asking snapd again.
+ *
+ * A store can be saved to a file with snapd_assertion_store_save() and
+ * loaded again with snapd_assertion_store_new_from_file(). The file contains
+ * a sorted index of the headers of every assertion, and is memory mapped
+ * when loaded, so lookups don't need to read or parse the whole file.
+ *
+ * The account-key assertions in a store can be used to check the signatures
+ * of other assertions with snapd_assertion_store_verify() and
+ * snapd_assertion_store_verify_all().
+ */
+
+/**
+ * SnapdAssertionStore:
+ *
+ * #SnapdAssertionStore is an opaque data structure and can only be accessed
+ * using the provided functions.
+ *
+ * Since: 1.65
+ */
+
+/* File layout, with all values little-endian:
+ * FileHeader
+ * FileAssertion[n_assertions]
+ * FileKey[n_keys], sorted by key and then assertion
+ * Assertion content and keys
+ *
+ * Keys are of the form "type\nheader\nvalue", and exist for every single line header. */
+#define FILE_MAGIC "SNAPDAS1"
+
+typedef struct
+{
+    gchar magic[8];
+    guint32 n_assertions;
+    guint32 n_keys;
+} FileHeader;
+
+typedef struct
+{
+    guint32 offset;
+    guint32 length;
+} FileAssertion;
+
+typedef struct
+{
+    guint32 offset;
+    guint32 length;
+    guint32 assertion;
+} FileKey;
+
+struct _SnapdAssertionStore
+{
+    GObject parent_instance;
+
+    /* File loaded from */
+    GMappedFile *file;
+    const gchar *data;
+    gsize data_length;
+    guint32 n_file_assertions;
+    const FileAssertion *file_assertions;
+    guint32 n_file_keys;
+    const FileKey *file_keys;
+
+    /* Assertions added since loading, and the most recent assertion for each key */
+    GPtrArray *added;
+    GHashTable *added_index;
+};
+
+G_DEFINE_TYPE (SnapdAssertionStore, snapd_assertion_store, G_TYPE_OBJECT)
+
+static gint
+compare_keys (const gchar *a, gsize a_length, const gchar *b, gsize b_length)
+{
+    gint result = memcmp (a, b, MIN (a_length, b_length));
+    if (result != 0)
+        return result;
+    return a_length < b_length ? -1 : a_length > b_length ? 1 : 0;
+}
+
+/**
+ * snapd_assertion_store_new:
+ *
+ * Create a new empty assertion store.
+ *
+ * Returns: a new #SnapdAssertionStore
+ *
+ * Since: 1.65
+ */
+SnapdAssertionStore *
+snapd_assertion_store_new (void)
+{
+    return g_object_new (SNAPD_TYPE_ASSERTION_STORE, NULL);
+}
+
+/**
+ * snapd_assertion_store_new_from_file:
+ * @path: path of a file written with snapd_assertion_store_save().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Load an assertion store from a file. The file is memory mapped, and must
+ * not be modified while the store exists.
+ *
+ * Returns: (transfer full): a new #SnapdAssertionStore or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdAssertionStore *
+snapd_assertion_store_new_from_file (const gchar *path, GError **error)
+{
+    g_return_val_if_fail (path != NULL, NULL);
+
+    g_autoptr(GMappedFile) file = g_mapped_file_new (path, FALSE, error);
+    if (file == NULL)
+        return NULL;
+
+    const gchar *data = g_mapped_file_get_contents (file);
+    gsize data_length = g_mapped_file_get_length (file);
+    const FileHeader *header = (const FileHeader *) data;
+    if (data_length < sizeof (FileHeader) || memcmp (header->magic, FILE_MAGIC, sizeof (header->magic)) != 0) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s is not an assertion store", path);
+        return NULL;
+    }
+
+    guint64 n_assertions = GUINT32_FROM_LE (header->n_assertions);
+    guint64 n_keys = GUINT32_FROM_LE (header->n_keys);
+    guint64 tables_length = sizeof (FileHeader) + n_assertions * sizeof (FileAssertion) + n_keys * sizeof (FileKey);
+    if (tables_length > data_length) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Assertion store %s is truncated", path);
+        return NULL;
+    }
+
+    /* Check everything is inside the file so lookups don't have to */
+    const FileAssertion *assertions = (const FileAssertion *) (data + sizeof (FileHeader));
+    for (guint64 i = 0; i < n_assertions; i++) {
+        guint64 offset = GUINT32_FROM_LE (assertions[i].offset), length = GUINT32_FROM_LE (assertions[i].length);
+        if (offset + length > data_length) {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Assertion store %s is corrupt", path);
+            return NULL;
+        }
+    }
+    const FileKey *keys = (const FileKey *) (assertions + n_assertions);
+    for (guint64 i = 0; i < n_keys; i++) {
+        guint64 offset = GUINT32_FROM_LE (keys[i].offset), length = GUINT32_FROM_LE (keys[i].length);
+        if (offset + length > data_length || GUINT32_FROM_LE (keys[i].assertion) >= n_assertions) {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Assertion store %s is corrupt", path);
+            return NULL;
+        }
+    }
+
+    SnapdAssertionStore *self = snapd_assertion_store_new ();
+    self->file = g_steal_pointer (&file);
+    self->data = data;
+    self->data_length = data_length;
+    self->n_file_assertions = n_assertions;
+    self->file_assertions = assertions;
+    self->n_file_keys = n_keys;
+    self->file_keys = keys;
+
+    return self;
+}
+
+/**
+ * snapd_assertion_store_add:
+ * @store: a #SnapdAssertionStore.
+ * @assertion: an assertion.
+ *
+ * Add an assertion to the store.
+ *
+ * Since: 1.65
+ */
+void
+snapd_assertion_store_add (SnapdAssertionStore *self, const gchar *assertion)
+{
+    g_return_if_fail (SNAPD_IS_ASSERTION_STORE (self));
+    g_return_if_fail (assertion != NULL);
+
+    g_autoptr(SnapdAssertion) a = snapd_assertion_new (assertion);
+    g_autofree gchar *type = snapd_assertion_get_header (a, "type");
+    if (type == NULL)
+        return;
+
+    guint index = self->n_file_assertions + self->added->len;
+    g_ptr_array_add (self->added, g_strdup (assertion));
+
+    g_auto(GStrv) headers = snapd_assertion_get_headers (a);
+    for (int i = 0; headers[i] != NULL; i++) {
+        gsize value_length;
+        const gchar *value = snapd_assertion_get_header_span (a, headers[i], &value_length);
+        if (value == NULL || memchr (value, '\n', value_length) != NULL)
+            continue;
+
+        g_autoptr(GString) key = g_string_new (type);
+        g_string_append_c (key, '\n');
+        g_string_append (key, headers[i]);
+        g_string_append_c (key, '\n');
+        g_string_append_len (key, value, value_length);
+        g_hash_table_insert (self->added_index, g_string_free (g_steal_pointer (&key), FALSE), GUINT_TO_POINTER (index));
+    }
+}
+
+/**
+ * snapd_assertion_store_add_assertions:
+ * @store: a #SnapdAssertionStore.
+ * @assertions: assertions to add, as returned by snapd_client_get_assertions_sync().
+ *
+ * Add assertions to the store.
+ *
+ * Since: 1.65
+ */
+void
+snapd_assertion_store_add_assertions (SnapdAssertionStore *self, GStrv assertions)
+{
+    g_return_if_fail (SNAPD_IS_ASSERTION_STORE (self));
+    g_return_if_fail (assertions != NULL);
+
+    for (int i = 0; assertions[i] != NULL; i++)
+        snapd_assertion_store_add (self, assertions[i]);
+}
+
+/**
+ * snapd_assertion_store_get_n_assertions:
+ * @store: a #SnapdAssertionStore.
+ *
+ * Get the number of assertions in the store.
+ *
+ * Returns: the number of assertions.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_assertion_store_get_n_assertions (SnapdAssertionStore *self)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION_STORE (self), 0);
+    return self->n_file_assertions + self->added->len;
+}
+
+static const gchar *
+get_assertion_content (SnapdAssertionStore *self, guint index, gsize *length)
+{
+    if (index < self->n_file_assertions) {
+        *length = GUINT32_FROM_LE (self->file_assertions[index].length);
+        return self->data + GUINT32_FROM_LE (self->file_assertions[index].offset);
+    }
+
+    const gchar *content = g_ptr_array_index (self->added, index - self->n_file_assertions);
+    *length = strlen (content);
+    return content;
+}
+
+/* Find the last assertion with this key in the file index, or -1 */
+static gssize
+find_file_key (SnapdAssertionStore *self, const gchar *key, gsize key_length)
+{
+    /* Find the first entry after the key */
+    gsize start = 0, end = self->n_file_keys;
+    while (start < end) {
+        gsize middle = start + (end - start) / 2;
+        const FileKey *k = &self->file_keys[middle];
+        if (compare_keys (self->data + GUINT32_FROM_LE (k->offset), GUINT32_FROM_LE (k->length), key, key_length) <= 0)
+            start = middle + 1;
+        else
+            end = middle;
+    }
+    if (start == 0)
+        return -1;
+
+    const FileKey *k = &self->file_keys[start - 1];
+    if (compare_keys (self->data + GUINT32_FROM_LE (k->offset), GUINT32_FROM_LE (k->length), key, key_length) != 0)
+        return -1;
+    return GUINT32_FROM_LE (k->assertion);
+}
+
+/**
+ * snapd_assertion_store_lookup:
+ * @store: a #SnapdAssertionStore.
+ * @type: the assertion type, e.g. "account-key".
+ * @header: the name of the header to match, e.g. "public-key-sha3-384".
+ * @value: the value of the header.
+ *
+ * Find an assertion of type @type with a header @header set to @value.
+ * Only single line headers can be matched. If more than one assertion matches,
+ * the most recently added is returned.
+ *
+ * Returns: (transfer full) (allow-none): a #SnapdAssertion or %NULL if none match.
+ *
+ * Since: 1.65
+ */
+SnapdAssertion *
+snapd_assertion_store_lookup (SnapdAssertionStore *self, const gchar *type, const gchar *header, const gchar *value)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION_STORE (self), NULL);
+    g_return_val_if_fail (type != NULL, NULL);
+    g_return_val_if_fail (header != NULL, NULL);
+    g_return_val_if_fail (value != NULL, NULL);
+
+    g_autofree gchar *key = g_strdup_printf ("%s\n%s\n%s", type, header, value);
+
+    gpointer index;
+    gssize assertion_index;
+    if (g_hash_table_lookup_extended (self->added_index, key, NULL, &index))
+        assertion_index = GPOINTER_TO_UINT (index);
+    else
+        assertion_index = find_file_key (self, key, strlen (key));
+    if (assertion_index < 0)
+        return NULL;
+
+    gsize length;
+    const gchar *content = get_assertion_content (self, assertion_index, &length);
+    g_autofree gchar *text = g_strndup (content, length);
+    return snapd_assertion_new (text);
+}
+
+typedef struct
+{
+    const gchar *key;
+    gsize key_length;
+    guint32 assertion;
+} Key;
+
+static gint
+compare_key_entries (gconstpointer a, gconstpointer b)
+{
+    const Key *key_a = a, *key_b = b;
+    gint result = compare_keys (key_a->key, key_a->key_length, key_b->key, key_b->key_length);
+    if (result != 0)
+        return result;
+    return key_a->assertion < key_b->assertion ? -1 : key_a->assertion > key_b->assertion ? 1 : 0;
+}
+
+static void
+append_uint32 (GByteArray *data, guint32 value)
+{
+    guint32 v = GUINT32_TO_LE (value);
+    g_byte_array_append (data, (const guint8 *) &v, sizeof (v));
+}
+
+/**
+ * snapd_assertion_store_save:
+ * @store: a #SnapdAssertionStore.
+ * @path: path of the file to write.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Save the assertions in the store to a file, so they can be loaded with
+ * snapd_assertion_store_new_from_file().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_assertion_store_save (SnapdAssertionStore *self, const gchar *path, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION_STORE (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    /* Keys from the file are already known, the added ones are in the index */
+    g_autoptr(GArray) keys = g_array_sized_new (FALSE, FALSE, sizeof (Key), self->n_file_keys + g_hash_table_size (self->added_index));
+    for (guint32 i = 0; i < self->n_file_keys; i++) {
+        const FileKey *k = &self->file_keys[i];
+        Key key = { self->data + GUINT32_FROM_LE (k->offset), GUINT32_FROM_LE (k->length), GUINT32_FROM_LE (k->assertion) };
+        g_array_append_val (keys, key);
+    }
+    GHashTableIter iter;
+    gpointer k, index;
+    g_hash_table_iter_init (&iter, self->added_index);
+    while (g_hash_table_iter_next (&iter, &k, &index)) {
+        Key key = { k, strlen (k), GPOINTER_TO_UINT (index) };
+        g_array_append_val (keys, key);
+    }
+    g_array_sort (keys, compare_key_entries);
+
+    guint n_assertions = snapd_assertion_store_get_n_assertions (self);
+    guint64 offset = sizeof (FileHeader) + (guint64) n_assertions * sizeof (FileAssertion) + (guint64) keys->len * sizeof (FileKey);
+
+    g_autoptr(GByteArray) data = g_byte_array_new ();
+    g_byte_array_append (data, (const guint8 *) FILE_MAGIC, strlen (FILE_MAGIC));
+    append_uint32 (data, n_assertions);
+    append_uint32 (data, keys->len);
+    for (guint i = 0; i < n_assertions; i++) {
+        gsize length;
+        get_assertion_content (self, i, &length);
+        append_uint32 (data, offset);
+        append_uint32 (data, length);
+        offset += length;
+    }
+    for (guint i = 0; i < keys->len; i++) {
+        Key *key = &g_array_index (keys, Key, i);
+        append_uint32 (data, offset);
+        append_uint32 (data, key->key_length);
+        append_uint32 (data, key->assertion);
+        offset += key->key_length;
+    }
+    if (offset > G_MAXUINT32) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Assertion store is too large to save");
+        return FALSE;
+    }
+    for (guint i = 0; i < n_assertions; i++) {
+        gsize length;
+        const gchar *content = get_assertion_content (self, i, &length);
+        g_byte_array_append (data, (const guint8 *) content, length);
+    }
+    for (guint i = 0; i < keys->len; i++) {
+        Key *key = &g_array_index (keys, Key, i);
+        g_byte_array_append (data, (const guint8 *) key->key, key->key_length);
+    }
+
+    return g_file_set_contents (path, (const gchar *) data->data, data->len, error);
+}
+
+/* Check the key used to sign @assertion was valid at the time it was made */
+static gboolean
+check_key_valid (SnapdAssertion *assertion, SnapdAssertion *account_key, const gchar *key_id, GError **error)
+{
+    g_autofree gchar *authority_id = snapd_assertion_get_header (assertion, "authority-id");
+    g_autofree gchar *account_id = snapd_assertion_get_header (account_key, "account-id");
+    if (authority_id == NULL || g_strcmp0 (authority_id, account_id) != 0) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                     "Key %s does not belong to authority %s", key_id, authority_id != NULL ? authority_id : "(none)");
+        return FALSE;
+    }
+
+    g_autofree gchar *timestamp = snapd_assertion_get_header (assertion, "timestamp");
+    if (timestamp == NULL)
+        return TRUE;
+
+    g_autofree gchar *since = snapd_assertion_get_header (account_key, "since");
+    g_autofree gchar *until = snapd_assertion_get_header (account_key, "until");
+    SnapdTimestamp time = { 0 }, since_time = { 0 }, until_time = { 0 };
+    gboolean valid = _snapd_timestamp_parse (&time, timestamp) &&
+                     (since == NULL || (_snapd_timestamp_parse (&since_time, since) &&
+                                        _snapd_timestamp_get_time (&time) >= _snapd_timestamp_get_time (&since_time))) &&
+                     (until == NULL || (_snapd_timestamp_parse (&until_time, until) &&
+                                        _snapd_timestamp_get_time (&time) < _snapd_timestamp_get_time (&until_time)));
+    _snapd_timestamp_clear (&time);
+    _snapd_timestamp_clear (&since_time);
+    _snapd_timestamp_clear (&until_time);
+    if (!valid) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Key %s was not valid at %s", key_id, timestamp);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * snapd_assertion_store_verify:
+ * @store: a #SnapdAssertionStore.
+ * @assertion: a #SnapdAssertion to check.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Check the signature of an assertion. The account-key assertion with the
+ * key ID from the sign-key-sha3-384 header of @assertion is looked up in
+ * @store. The key must belong to the authority of @assertion and be valid
+ * at its timestamp. The account-key assertions in the store are trusted,
+ * their own signatures are not checked.
+ *
+ * Signatures can only be checked if snapd-glib was built with nettle,
+ * otherwise this fails with %G_IO_ERROR_NOT_SUPPORTED.
+ *
+ * Returns: %TRUE if the signature is valid.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_assertion_store_verify (SnapdAssertionStore *self, SnapdAssertion *assertion, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION_STORE (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_ASSERTION (assertion), FALSE);
+
+    gsize content_length;
+    const gchar *content = _snapd_assertion_get_signed_content (assertion, &content_length);
+    g_autofree gchar *key_id = snapd_assertion_get_header (assertion, "sign-key-sha3-384");
+    if (content == NULL || key_id == NULL) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Assertion is not signed");
+        return FALSE;
+    }
+
+    g_autoptr(SnapdAssertion) account_key = snapd_assertion_store_lookup (self, "account-key", "public-key-sha3-384", key_id);
+    if (account_key == NULL) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "No account key %s", key_id);
+        return FALSE;
+    }
+
+    if (!check_key_valid (assertion, account_key, key_id, error))
+        return FALSE;
+
+    g_autofree gchar *public_key = snapd_assertion_get_body (account_key);
+    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
+    if (public_key == NULL) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Account key %s has no public key", key_id);
+        return FALSE;
+    }
+
+    return _snapd_signature_verify (content, content_length, signature, public_key, key_id, error);
+}
+
+typedef struct
+{
+    SnapdAssertionStore *store;
+    GPtrArray *assertions;
+    GCancellable *cancellable;
+    GError **errors;
+} VerifyData;
+
+static void
+verify_thread_func (gpointer data, gpointer user_data)
+{
+    VerifyData *verify = user_data;
+    guint index = GPOINTER_TO_UINT (data) - 1;
+
+    if (g_cancellable_is_cancelled (verify->cancellable))
+        return;
+    snapd_assertion_store_verify (verify->store, g_ptr_array_index (verify->assertions, index), &verify->errors[index]);
+}
+
+/**
+ * snapd_assertion_store_verify_all:
+ * @store: a #SnapdAssertionStore.
+ * @assertions: (element-type SnapdAssertion): the assertions to check.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Check the signatures of many assertions, as with
+ * snapd_assertion_store_verify(). The assertions are checked in parallel
+ * using a thread for each processor, and this returns once all of them
+ * have been checked. @store must not be changed until this returns.
+ *
+ * If any signature is not valid the error for the first such assertion in
+ * @assertions is returned, prefixed with its index.
+ *
+ * Returns: %TRUE if all the signatures are valid.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_assertion_store_verify_all (SnapdAssertionStore *self, GPtrArray *assertions,
+                                  GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION_STORE (self), FALSE);
+    g_return_val_if_fail (assertions != NULL, FALSE);
+
+    VerifyData verify = { self, assertions, cancellable, g_new0 (GError *, assertions->len + 1) };
+
+    /* Assertions index their headers on first use, so do that now rather than racing in the workers */
+    for (guint i = 0; i < assertions->len; i++) {
+        gsize length;
+        snapd_assertion_get_header_span (g_ptr_array_index (assertions, i), "sign-key-sha3-384", &length);
+    }
+
+    gint n_threads = MAX (MIN (g_get_num_processors (), assertions->len), 1);
+    GThreadPool *pool = g_thread_pool_new (verify_thread_func, &verify, n_threads, FALSE, NULL);
+    for (guint i = 0; i < assertions->len; i++)
+        g_thread_pool_push (pool, GUINT_TO_POINTER (i + 1), NULL);
+    g_thread_pool_free (pool, FALSE, TRUE);
+
+    gboolean result = TRUE;
+    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        result = FALSE;
+    for (guint i = 0; i < assertions->len; i++) {
+        if (result && verify.errors[i] != NULL) {
+            g_propagate_prefixed_error (error, g_steal_pointer (&verify.errors[i]), "Assertion %u: ", i);
+            result = FALSE;
+        }
+        g_clear_error (&verify.errors[i]);
+    }
+    g_free (verify.errors);
+
+    return result;
+}
+
+static void
+snapd_assertion_store_finalize (GObject *object)
+{
+    SnapdAssertionStore *self = SNAPD_ASSERTION_STORE (object);
+
+    g_clear_pointer (&self->file, g_mapped_file_unref);
+    g_clear_pointer (&self->added, g_ptr_array_unref);
+    g_clear_pointer (&self->added_index, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_assertion_store_parent_class)->finalize (object);
+}
+
+static void
+snapd_assertion_store_class_init (SnapdAssertionStoreClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_assertion_store_finalize;
+}
+
+static void
+snapd_assertion_store_init (SnapdAssertionStore *self)
+{
+    self->added = g_ptr_array_new_with_free_func (g_free);
+    self->added_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
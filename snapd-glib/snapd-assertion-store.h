@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_ASSERTION_STORE_H__
+#define __SNAPD_ASSERTION_STORE_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <gio/gio.h>
+#include <snapd-glib/snapd-assertion.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_ASSERTION_STORE  (snapd_assertion_store_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdAssertionStore, snapd_assertion_store, SNAPD, ASSERTION_STORE, GObject)
+
+SnapdAssertionStore *snapd_assertion_store_new              (void);
+
+SnapdAssertionStore *snapd_assertion_store_new_from_file    (const gchar          *path,
+                                                             GError              **error);
+
+void                 snapd_assertion_store_add              (SnapdAssertionStore  *store,
+                                                             const gchar          *assertion);
+
+void                 snapd_assertion_store_add_assertions   (SnapdAssertionStore  *store,
+                                                             GStrv                 assertions);
+
+guint                snapd_assertion_store_get_n_assertions (SnapdAssertionStore  *store);
+
+SnapdAssertion      *snapd_assertion_store_lookup           (SnapdAssertionStore  *store,
+                                                             const gchar          *type,
+                                                             const gchar          *header,
+                                                             const gchar          *value);
+
+gboolean             snapd_assertion_store_save             (SnapdAssertionStore  *store,
+                                                             const gchar          *path,
+                                                             GError              **error);
+
+gboolean             snapd_assertion_store_verify           (SnapdAssertionStore  *store,
+                                                             SnapdAssertion       *assertion,
+                                                             GError              **error);
+
+gboolean             snapd_assertion_store_verify_all       (SnapdAssertionStore  *store,
+                                                             GPtrArray            *assertions,
+                                                             GCancellable         *cancellable,
+                                                             GError              **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_ASSERTION_STORE_H__ */
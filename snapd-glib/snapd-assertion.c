@@ -11,7 +11,7 @@
 #include <string.h>
 #include <ctype.h>
 
-#include "snapd-assertion.h"
+#include "snapd-assertion-private.h"
 
 /**
  * SECTION: snapd-assertion
@@ -36,11 +36,25 @@
  * Since: 1.0
  */
 
+typedef struct
+{
+    gsize name_start;
+    gsize name_length;
+    gsize value_start;
+    gsize value_length;
+} Header;
+
 struct _SnapdAssertion
 {
     GObject parent_instance;
 
     gchar *content;
+
+    /* Location of headers in content, built on first use */
+    GArray *headers;
+    GHashTable *header_index;
+    gsize headers_length;
+    gsize body_length;
 };
 
 enum
@@ -111,6 +125,54 @@ get_header (const gchar *content, gsize *offset, gsize *name_start, gsize *name_
     return TRUE;
 }
 
+static const Header *
+find_header (SnapdAssertion *self, const gchar *name)
+{
+    gpointer index;
+    if (!g_hash_table_lookup_extended (self->header_index, name, NULL, &index))
+        return NULL;
+
+    return &g_array_index (self->headers, Header, GPOINTER_TO_UINT (index));
+}
+
+static void
+build_header_index (SnapdAssertion *self)
+{
+    if (self->headers != NULL)
+        return;
+
+    self->headers = g_array_new (FALSE, FALSE, sizeof (Header));
+    self->header_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    gsize offset = 0;
+    while (TRUE) {
+        /* Headers terminated by double newline or EOF */
+        Header header;
+        if (self->content[offset] == '\0' ||
+            self->content[offset] == '\n' ||
+            !get_header (self->content, &offset, &header.name_start, &header.name_length, &header.value_start, &header.value_length))
+            break;
+
+        /* The first header with a given name is used */
+        g_autofree gchar *name = g_strndup (self->content + header.name_start, header.name_length);
+        if (!g_hash_table_contains (self->header_index, name))
+            g_hash_table_insert (self->header_index, g_steal_pointer (&name), GUINT_TO_POINTER (self->headers->len));
+        g_array_append_val (self->headers, header);
+    }
+
+    /* Headers terminated by double newline */
+    gchar *divider = strstr (self->content, "\n\n");
+    self->headers_length = divider != NULL ? divider - self->content : 0;
+
+    const Header *body_length_header = find_header (self, "body-length");
+    if (body_length_header != NULL) {
+        g_autofree gchar *body_length = g_strndup (self->content + body_length_header->value_start, body_length_header->value_length);
+        self->body_length = strtoul (body_length, NULL, 10);
+    }
+    else
+        self->body_length = 0;
+}
+
 /**
  * snapd_assertion_get_headers:
  * @assertion: a #SnapdAssertion.
@@ -126,21 +188,16 @@ snapd_assertion_get_headers (SnapdAssertion *self)
 {
     g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
 
-    gsize offset = 0;
-    g_autoptr(GPtrArray) headers = g_ptr_array_new ();
-    while (TRUE) {
-        /* Headers terminated by double newline or EOF */
-        gsize name_start, name_length;
-        if (self->content[offset] == '\0' ||
-            self->content[offset] == '\n' ||
-            !get_header (self->content, &offset, &name_start, &name_length, NULL, NULL))
-            break;
+    build_header_index (self);
 
-        g_ptr_array_add (headers, g_strndup (self->content + name_start, name_length));
+    GStrv headers = g_new (gchar *, self->headers->len + 1);
+    for (guint i = 0; i < self->headers->len; i++) {
+        Header *header = &g_array_index (self->headers, Header, i);
+        headers[i] = g_strndup (self->content + header->name_start, header->name_length);
     }
-    g_ptr_array_add (headers, NULL);
+    headers[self->headers->len] = NULL;
 
-    return g_steal_pointer ((GStrv *)&headers->pdata);
+    return headers;
 }
 
 /**
@@ -160,43 +217,45 @@ snapd_assertion_get_header (SnapdAssertion *self, const gchar *name)
     g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    gsize offset = 0;
-    while (TRUE) {
-        /* Headers terminated by double newline or EOF */
-        if (self->content[offset] == '\0' || self->content[offset] == '\n')
-            return NULL;
-
-        gsize name_start, name_length, value_start, value_length;
-        if (!get_header (self->content, &offset, &name_start, &name_length, &value_start, &value_length))
-            return NULL;
-
-        /* Return value if header we're looking for */
-        if (strncmp (self->content + name_start, name, name_length) == 0)
-            return g_strndup (self->content + value_start, value_length);
-    }
+    gsize length;
+    const gchar *value = snapd_assertion_get_header_span (self, name, &length);
+    if (value == NULL)
+        return NULL;
 
-    return NULL;
+    return g_strndup (value, length);
 }
 
-static gsize
-get_headers_length (SnapdAssertion *self)
+/**
+ * snapd_assertion_get_header_span:
+ * @assertion: a #SnapdAssertion.
+ * @name: name of the header.
+ * @length: (out): location to store the length of the value in bytes.
+ *
+ * Get a header from an assertion without copying it. The value is not
+ * nul-terminated; use @length to find where it ends.
+ *
+ * Returns: (transfer none) (allow-none): the start of the header value in
+ *     the assertion content or %NULL if undefined.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_assertion_get_header_span (SnapdAssertion *self, const gchar *name, gsize *length)
 {
-    /* Headers terminated by double newline */
-    gchar *divider = strstr (self->content, "\n\n");
-    if (divider == NULL)
-        return 0;
+    g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+    g_return_val_if_fail (length != NULL, NULL);
 
-    return divider - self->content;
-}
+    build_header_index (self);
 
-static gsize
-get_body_length (SnapdAssertion *self)
-{
-    g_autofree gchar *body_length_header = snapd_assertion_get_header (self, "body-length");
-    if (body_length_header == NULL)
-        return 0;
+    const Header *header = find_header (self, name);
+    if (header == NULL) {
+        *length = 0;
+        return NULL;
+    }
 
-    return strtoul (body_length_header, NULL, 10);
+    *length = header->value_length;
+    return self->content + header->value_start;
 }
 
 /**
@@ -214,11 +273,12 @@ snapd_assertion_get_body (SnapdAssertion *self)
 {
     g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
 
-    gsize body_length = get_body_length (self);
-    if (body_length == 0)
+    build_header_index (self);
+
+    if (self->body_length == 0)
         return NULL;
 
-    return g_strndup (self->content + get_headers_length (self) + 2, body_length);
+    return g_strndup (self->content + self->headers_length + 2, self->body_length);
 }
 
 /**
@@ -236,11 +296,37 @@ snapd_assertion_get_signature (SnapdAssertion *self)
 {
     g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
 
-    gsize body_length = get_body_length (self);
-    if (body_length > 0)
-        return g_strdup (self->content + get_headers_length (self) + 2 + body_length + 2);
+    build_header_index (self);
+
+    if (self->body_length > 0)
+        return g_strdup (self->content + self->headers_length + 2 + self->body_length + 2);
     else
-        return g_strdup (self->content + get_headers_length (self) + 2);
+        return g_strdup (self->content + self->headers_length + 2);
+}
+
+/* Get the headers and body the signature is made over, or %NULL if there is no signature */
+const gchar *
+_snapd_assertion_get_signed_content (SnapdAssertion *self, gsize *length)
+{
+    g_return_val_if_fail (SNAPD_IS_ASSERTION (self), NULL);
+
+    build_header_index (self);
+
+    if (self->headers_length == 0) {
+        *length = 0;
+        return NULL;
+    }
+
+    gsize signed_length = self->headers_length;
+    if (self->body_length > 0)
+        signed_length += 2 + self->body_length;
+    if (signed_length + 2 > strlen (self->content)) {
+        *length = 0;
+        return NULL;
+    }
+
+    *length = signed_length;
+    return self->content;
 }
 
 static void
@@ -252,6 +338,8 @@ snapd_assertion_set_property (GObject *object, guint prop_id, const GValue *valu
     case PROP_CONTENT:
         g_free (self->content);
         self->content = g_strdup (g_value_get_string (value));
+        g_clear_pointer (&self->headers, g_array_unref);
+        g_clear_pointer (&self->header_index, g_hash_table_unref);
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -280,6 +368,8 @@ snapd_assertion_finalize (GObject *object)
     SnapdAssertion *self = SNAPD_ASSERTION (object);
 
     g_clear_pointer (&self->content, g_free);
+    g_clear_pointer (&self->headers, g_array_unref);
+    g_clear_pointer (&self->header_index, g_hash_table_unref);
 
     G_OBJECT_CLASS (snapd_assertion_parent_class)->finalize (object);
 }
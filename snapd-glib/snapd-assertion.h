@@ -29,6 +29,10 @@ GStrv           snapd_assertion_get_headers           (SnapdAssertion *assertion
 gchar          *snapd_assertion_get_header            (SnapdAssertion *assertion,
                                                        const gchar    *name);
 
+const gchar    *snapd_assertion_get_header_span       (SnapdAssertion *assertion,
+                                                       const gchar    *name,
+                                                       gsize          *length);
+
 gchar          *snapd_assertion_get_body              (SnapdAssertion *assertion);
 
 gchar          *snapd_assertion_get_signature         (SnapdAssertion *assertion);
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-attributes.h"
+
+static GHashTable *
+values_new (void)
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+}
+
+void
+_snapd_attributes_init (SnapdAttributes *attributes)
+{
+    g_mutex_init (&attributes->mutex);
+    attributes->object = NULL;
+    attributes->values = values_new ();
+}
+
+void
+_snapd_attributes_set_object (SnapdAttributes *attributes, JsonObject *object)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+
+    g_clear_pointer (&attributes->object, json_object_unref);
+    g_clear_pointer (&attributes->values, g_hash_table_unref);
+    if (object != NULL)
+        attributes->object = json_object_ref (object);
+    attributes->values = values_new ();
+}
+
+void
+_snapd_attributes_set_table (SnapdAttributes *attributes, GHashTable *values)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+
+    g_clear_pointer (&attributes->object, json_object_unref);
+    g_clear_pointer (&attributes->values, g_hash_table_unref);
+    attributes->values = values != NULL ? g_hash_table_ref (values) : values_new ();
+}
+
+/* Convert a value from the JSON if it hasn't been already. Must be called with the mutex held */
+static GVariant *
+lookup_value (SnapdAttributes *attributes, const gchar *name)
+{
+    GVariant *value = g_hash_table_lookup (attributes->values, name);
+    if (value != NULL || attributes->object == NULL)
+        return value;
+
+    JsonNode *node = json_object_get_member (attributes->object, name);
+    if (node == NULL)
+        return NULL;
+
+    g_autoptr(GError) error = NULL;
+    value = json_gvariant_deserialize (node, NULL, &error);
+    if (value == NULL) {
+        g_warning ("Failed to convert attribute %s: %s", name, error->message);
+        return NULL;
+    }
+    g_hash_table_insert (attributes->values, g_strdup (name), g_variant_ref_sink (value));
+
+    return value;
+}
+
+GStrv
+_snapd_attributes_get_names (SnapdAttributes *attributes, guint *length)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+
+    g_autoptr(GPtrArray) names = g_ptr_array_new ();
+    if (attributes->object != NULL) {
+        JsonObjectIter iter;
+        json_object_iter_init (&iter, attributes->object);
+        const gchar *name;
+        while (json_object_iter_next (&iter, &name, NULL))
+            g_ptr_array_add (names, g_strdup (name));
+    }
+    else {
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, attributes->values);
+        gpointer name;
+        while (g_hash_table_iter_next (&iter, &name, NULL))
+            g_ptr_array_add (names, g_strdup (name));
+    }
+
+    if (length != NULL)
+        *length = names->len;
+    g_ptr_array_add (names, NULL);
+    return (GStrv) g_ptr_array_free (g_steal_pointer (&names), FALSE);
+}
+
+gboolean
+_snapd_attributes_contains (SnapdAttributes *attributes, const gchar *name)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+
+    if (attributes->object != NULL)
+        return json_object_has_member (attributes->object, name);
+    return g_hash_table_contains (attributes->values, name);
+}
+
+GVariant *
+_snapd_attributes_lookup (SnapdAttributes *attributes, const gchar *name)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+    return lookup_value (attributes, name);
+}
+
+/* Get all the values, converting any that haven't been read yet */
+GHashTable *
+_snapd_attributes_get_table (SnapdAttributes *attributes)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&attributes->mutex);
+
+    if (attributes->object != NULL) {
+        JsonObjectIter iter;
+        json_object_iter_init (&iter, attributes->object);
+        const gchar *name;
+        while (json_object_iter_next (&iter, &name, NULL))
+            lookup_value (attributes, name);
+        g_clear_pointer (&attributes->object, json_object_unref);
+    }
+
+    return attributes->values;
+}
+
+void
+_snapd_attributes_clear (SnapdAttributes *attributes)
+{
+    g_clear_pointer (&attributes->object, json_object_unref);
+    g_clear_pointer (&attributes->values, g_hash_table_unref);
+    g_mutex_clear (&attributes->mutex);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_ATTRIBUTES_H__
+#define __SNAPD_ATTRIBUTES_H__
+
+#include <json-glib/json-glib.h>
+
+G_BEGIN_DECLS
+
+/* Plug and slot attributes. When read from snapd the JSON is kept and each
+ * value is only converted to a #GVariant when it is first requested */
+typedef struct
+{
+    GMutex mutex;
+    JsonObject *object;
+    GHashTable *values;
+} SnapdAttributes;
+
+void        _snapd_attributes_init       (SnapdAttributes *attributes);
+
+void        _snapd_attributes_set_object (SnapdAttributes *attributes,
+                                          JsonObject      *object);
+
+void        _snapd_attributes_set_table  (SnapdAttributes *attributes,
+                                          GHashTable      *values);
+
+GStrv       _snapd_attributes_get_names  (SnapdAttributes *attributes,
+                                          guint           *length);
+
+gboolean    _snapd_attributes_contains   (SnapdAttributes *attributes,
+                                          const gchar     *name);
+
+GVariant   *_snapd_attributes_lookup     (SnapdAttributes *attributes,
+                                          const gchar     *name);
+
+GHashTable *_snapd_attributes_get_table  (SnapdAttributes *attributes);
+
+void        _snapd_attributes_clear      (SnapdAttributes *attributes);
+
+G_END_DECLS
+
+#endif /* __SNAPD_ATTRIBUTES_H__ */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-bandwidth-limit.h"
+
+/* A token bucket shared by the requests that have to stay under a combined
+ * rate. Up to one second of data can be received in a burst, after which
+ * connections are paused until the average drops back under the limit.
+ * Requests may be read in different threads, so the bucket is locked. */
+
+struct _SnapdBandwidthLimit
+{
+    gint ref_count;
+
+    gint64 bytes_per_second;
+
+    GMutex mutex;
+
+    /* Bytes that can be received without waiting in millionths of a byte, so short intervals aren't rounded away.
+     * Negative if over the limit */
+    gint64 available;
+    gint64 update_time;
+};
+
+SnapdBandwidthLimit *
+_snapd_bandwidth_limit_new (goffset bytes_per_second)
+{
+    g_return_val_if_fail (bytes_per_second > 0, NULL);
+
+    SnapdBandwidthLimit *limit = g_slice_new0 (SnapdBandwidthLimit);
+    limit->ref_count = 1;
+    limit->bytes_per_second = bytes_per_second;
+    g_mutex_init (&limit->mutex);
+    limit->available = bytes_per_second * G_USEC_PER_SEC;
+    limit->update_time = g_get_monotonic_time ();
+    return limit;
+}
+
+SnapdBandwidthLimit *
+_snapd_bandwidth_limit_ref (SnapdBandwidthLimit *limit)
+{
+    g_atomic_int_inc (&limit->ref_count);
+    return limit;
+}
+
+void
+_snapd_bandwidth_limit_unref (SnapdBandwidthLimit *limit)
+{
+    if (!g_atomic_int_dec_and_test (&limit->ref_count))
+        return;
+
+    g_mutex_clear (&limit->mutex);
+    g_slice_free (SnapdBandwidthLimit, limit);
+}
+
+/* Add the data allowed since the last update, limiting the burst to one second.
+ * Checked before multiplying so a long idle time can't overflow */
+static void
+refill (SnapdBandwidthLimit *limit)
+{
+    gint64 now = g_get_monotonic_time ();
+    gint64 elapsed = now - limit->update_time;
+    gint64 capacity = limit->bytes_per_second * G_USEC_PER_SEC;
+    if (elapsed >= (capacity - limit->available) / limit->bytes_per_second)
+        limit->available = capacity;
+    else
+        limit->available += elapsed * limit->bytes_per_second;
+    limit->update_time = now;
+}
+
+static gint64
+get_delay (SnapdBandwidthLimit *limit)
+{
+    return limit->available >= 0 ? 0 : -limit->available / limit->bytes_per_second;
+}
+
+/* Note @n_bytes have been received, returning how many microseconds to wait before receiving more */
+gint64
+_snapd_bandwidth_limit_consume (SnapdBandwidthLimit *limit, gsize n_bytes)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&limit->mutex);
+
+    refill (limit);
+    limit->available -= (gint64) n_bytes * G_USEC_PER_SEC;
+    return get_delay (limit);
+}
+
+/* Get how many microseconds to wait before starting another transfer */
+gint64
+_snapd_bandwidth_limit_get_delay (SnapdBandwidthLimit *limit)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&limit->mutex);
+
+    refill (limit);
+    return get_delay (limit);
+}
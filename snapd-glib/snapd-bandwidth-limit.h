@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_BANDWIDTH_LIMIT_H__
+#define __SNAPD_BANDWIDTH_LIMIT_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SnapdBandwidthLimit SnapdBandwidthLimit;
+
+SnapdBandwidthLimit *_snapd_bandwidth_limit_new     (goffset              bytes_per_second);
+
+SnapdBandwidthLimit *_snapd_bandwidth_limit_ref     (SnapdBandwidthLimit *limit);
+
+void                 _snapd_bandwidth_limit_unref   (SnapdBandwidthLimit *limit);
+
+gint64               _snapd_bandwidth_limit_consume (SnapdBandwidthLimit *limit,
+                                                     gsize                n_bytes);
+
+gint64               _snapd_bandwidth_limit_get_delay (SnapdBandwidthLimit *limit);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdBandwidthLimit, _snapd_bandwidth_limit_unref)
+
+G_END_DECLS
+
+#endif /* __SNAPD_BANDWIDTH_LIMIT_H__ */
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CACHE_MANAGER_PRIVATE_H__
+#define __SNAPD_CACHE_MANAGER_PRIVATE_H__
+
+#include "snapd-cache-manager.h"
+
+G_BEGIN_DECLS
+
+/* Called to make a cache drop the entries returned by _snapd_cache_manager_take_evicted() */
+typedef void (*SnapdCacheDrainFunc) (gpointer user_data);
+
+guint  _snapd_cache_manager_add_cache    (SnapdCacheManager   *manager,
+                                          const gchar         *name,
+                                          gboolean             on_disk,
+                                          SnapdCacheDrainFunc  drain,
+                                          gpointer             drain_data);
+
+void   _snapd_cache_manager_remove_cache (SnapdCacheManager   *manager,
+                                          guint                cache_id);
+
+void   _snapd_cache_manager_insert       (SnapdCacheManager   *manager,
+                                          guint                cache_id,
+                                          const gchar         *key,
+                                          guint64              size);
+
+void   _snapd_cache_manager_remove       (SnapdCacheManager   *manager,
+                                          guint                cache_id,
+                                          const gchar         *key);
+
+void   _snapd_cache_manager_remove_all   (SnapdCacheManager   *manager,
+                                          guint                cache_id);
+
+void   _snapd_cache_manager_hit          (SnapdCacheManager   *manager,
+                                          guint                cache_id,
+                                          const gchar         *key);
+
+void   _snapd_cache_manager_miss         (SnapdCacheManager   *manager,
+                                          guint                cache_id);
+
+GStrv  _snapd_cache_manager_take_evicted (SnapdCacheManager   *manager,
+                                          guint                cache_id);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CACHE_MANAGER_PRIVATE_H__ */
@@ -0,0 +1,815 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+#include <gio/gio.h>
+
+#include "snapd-cache-manager-private.h"
+
+/**
+ * SECTION:snapd-cache-manager
+ * @short_description: Shared budget for cached data
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdCacheManager limits the memory and disk space used by the caches
+ * of one or more clients. Cached responses, snaps, store results in a
+ * #SnapdCatalogCache and snaps in a #SnapdDownloadCache are all counted
+ * against the same budgets, and when a budget is exceeded the least recently
+ * used entries are removed, whichever cache they are in. Entries larger than
+ * half of a budget are not kept at all so one large response can't remove
+ * everything else.
+ *
+ * Each client has its own manager by default. Set one manager on every
+ * client with snapd_client_set_cache_manager() to have them share a budget.
+ *
+ * When the system reports it is low on memory all cached data is removed,
+ * which can also be done with snapd_cache_manager_trim(). Entries removed to
+ * make room for another cache's entries are released in the background, so
+ * the budgets hold even for caches that aren't being used.
+ */
+
+/**
+ * SnapdCacheManager:
+ *
+ * #SnapdCacheManager is an opaque data structure and can only be accessed
+ * using the provided functions.
+ *
+ * Since: 1.65
+ */
+
+/* Fits comfortably on devices with 512MB of memory */
+#define DEFAULT_MEMORY_BUDGET (16 * 1024 * 1024)
+#define DEFAULT_DISK_BUDGET ((guint64) 1024 * 1024 * 1024)
+
+/* Statistics accumulate by name, across caches that come and go */
+typedef struct
+{
+    guint hits;
+    guint misses;
+    guint evictions;
+} CacheStats;
+
+typedef struct
+{
+    CacheStats *stats;
+    gboolean on_disk;
+    SnapdCacheDrainFunc drain;
+    gpointer drain_data;
+
+    /* Entries keyed by the key the cache uses */
+    GHashTable *entries;
+
+    /* Keys removed here the cache hasn't dropped yet */
+    GPtrArray *evicted;
+} Cache;
+
+typedef struct
+{
+    Cache *cache;
+    gchar *key;
+    guint64 size;
+    GList link;
+} Entry;
+
+struct _SnapdCacheManager
+{
+    GObject parent_instance;
+
+    /* Held while calling drain functions, so caches are not removed during the call.
+     * Taken before mutex, and before any lock the drain functions take */
+    GMutex drain_mutex;
+
+    /* Protects the fields below */
+    GMutex mutex;
+
+    gsize memory_budget;
+    guint64 disk_budget;
+    gsize memory_used;
+    guint64 disk_used;
+
+    /* Entries with the most recently used first */
+    GQueue memory_lru;
+    GQueue disk_lru;
+
+    /* Registered caches keyed by ID */
+    GHashTable *caches;
+    guint next_cache_id;
+
+    /* TRUE while waiting for the drain thread to drop evicted entries */
+    gboolean drain_queued;
+
+    /* CacheStats keyed by cache name */
+    GHashTable *stats;
+
+#if GLIB_CHECK_VERSION (2, 64, 0)
+    GMemoryMonitor *memory_monitor;
+#endif
+};
+
+G_DEFINE_TYPE (SnapdCacheManager, snapd_cache_manager, G_TYPE_OBJECT)
+
+typedef struct
+{
+    SnapdCacheDrainFunc drain;
+    gpointer drain_data;
+} DrainCall;
+
+static void
+entry_free (Entry *entry)
+{
+    g_free (entry->key);
+    g_slice_free (Entry, entry);
+}
+
+static void
+cache_free (Cache *cache)
+{
+    g_hash_table_unref (cache->entries);
+    g_ptr_array_unref (cache->evicted);
+    g_slice_free (Cache, cache);
+}
+
+static GQueue *
+get_lru (SnapdCacheManager *self, Cache *cache)
+{
+    return cache->on_disk ? &self->disk_lru : &self->memory_lru;
+}
+
+static guint64
+get_budget (SnapdCacheManager *self, Cache *cache)
+{
+    return cache->on_disk ? self->disk_budget : self->memory_budget;
+}
+
+/* Stop counting @entry. Must be called with the mutex held */
+static void
+remove_entry_unlocked (SnapdCacheManager *self, Entry *entry)
+{
+    Cache *cache = entry->cache;
+
+    g_queue_unlink (get_lru (self, cache), &entry->link);
+    if (cache->on_disk)
+        self->disk_used -= entry->size;
+    else
+        self->memory_used -= entry->size;
+    g_hash_table_remove (cache->entries, entry->key);
+}
+
+/* Remove @entry and queue it for its cache to drop. Must be called with the mutex held */
+static void
+evict_entry_unlocked (SnapdCacheManager *self, Entry *entry)
+{
+    Cache *cache = entry->cache;
+
+    cache->stats->evictions++;
+    g_ptr_array_add (cache->evicted, g_strdup (entry->key));
+    remove_entry_unlocked (self, entry);
+}
+
+/* Remove least recently used entries until @lru fits in @budget. Must be called with the mutex held */
+static void
+shrink_unlocked (SnapdCacheManager *self, GQueue *lru, guint64 budget)
+{
+    while (lru->tail != NULL && (lru == &self->disk_lru ? self->disk_used : self->memory_used) > budget)
+        evict_entry_unlocked (self, lru->tail->data);
+}
+
+static void
+forget_evicted_unlocked (Cache *cache, const gchar *key)
+{
+    for (guint i = 0; i < cache->evicted->len; i++) {
+        if (strcmp (g_ptr_array_index (cache->evicted, i), key) == 0) {
+            g_ptr_array_remove_index_fast (cache->evicted, i);
+            return;
+        }
+    }
+}
+
+/* Make every cache drop the entries evicted from it. Must be called with the drain mutex held */
+static void
+drain_caches (SnapdCacheManager *self)
+{
+    g_autoptr(GArray) calls = g_array_new (FALSE, FALSE, sizeof (DrainCall));
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init (&iter, self->caches);
+        while (g_hash_table_iter_next (&iter, NULL, &value)) {
+            Cache *cache = value;
+            if (cache->evicted->len > 0 && cache->drain != NULL) {
+                DrainCall call = { cache->drain, cache->drain_data };
+                g_array_append_val (calls, call);
+            }
+        }
+    }
+
+    for (guint i = 0; i < calls->len; i++) {
+        DrainCall *call = &g_array_index (calls, DrainCall, i);
+        call->drain (call->drain_data);
+    }
+}
+
+static void
+drain_thread_func (gpointer user_data, gpointer pool_data)
+{
+    g_autoptr(SnapdCacheManager) self = user_data;
+
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        self->drain_queued = FALSE;
+    }
+    g_autoptr(GMutexLocker) drain_locker = g_mutex_locker_new (&self->drain_mutex);
+    drain_caches (self);
+}
+
+/* Get the thread shared by all managers for draining caches other than the one being used */
+static GThreadPool *
+get_drain_pool (void)
+{
+    static gsize pool = 0;
+
+    if (g_once_init_enter (&pool)) {
+        GThreadPool *p = g_thread_pool_new (drain_thread_func, NULL, 1, FALSE, NULL);
+        g_once_init_leave (&pool, (gsize) p);
+    }
+
+    return (GThreadPool *) pool;
+}
+
+/* Drain caches other than @current that had entries evicted. This is done from another thread, as
+ * the caller holds the locks of @current, which the drain functions may need. Must be called with the mutex held */
+static void
+queue_drain_unlocked (SnapdCacheManager *self, Cache *current)
+{
+    if (self->drain_queued)
+        return;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init (&iter, self->caches);
+    while (g_hash_table_iter_next (&iter, NULL, &value)) {
+        Cache *cache = value;
+        if (cache != current && cache->evicted->len > 0 && cache->drain != NULL) {
+            self->drain_queued = TRUE;
+            g_thread_pool_push (get_drain_pool (), g_object_ref (self), NULL);
+            return;
+        }
+    }
+}
+
+/* Register a cache. Entries evicted from it are returned by _snapd_cache_manager_take_evicted(),
+ * which the cache should call whenever it is used. @drain is called from another thread when entries are evicted
+ * outside of the cache being used, and must not be called with locks held that @drain takes */
+guint
+_snapd_cache_manager_add_cache (SnapdCacheManager *self, const gchar *name, gboolean on_disk, SnapdCacheDrainFunc drain, gpointer drain_data)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    CacheStats *stats = g_hash_table_lookup (self->stats, name);
+    if (stats == NULL) {
+        stats = g_slice_new0 (CacheStats);
+        g_hash_table_insert (self->stats, g_strdup (name), stats);
+    }
+
+    Cache *cache = g_slice_new0 (Cache);
+    cache->stats = stats;
+    cache->on_disk = on_disk;
+    cache->drain = drain;
+    cache->drain_data = drain_data;
+    cache->entries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) entry_free);
+    cache->evicted = g_ptr_array_new_with_free_func (g_free);
+
+    guint id = ++self->next_cache_id;
+    g_hash_table_insert (self->caches, GUINT_TO_POINTER (id), cache);
+
+    return id;
+}
+
+/* Stop counting a cache. Its drain function won't be called once this returns */
+void
+_snapd_cache_manager_remove_cache (SnapdCacheManager *self, guint cache_id)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) drain_locker = g_mutex_locker_new (&self->drain_mutex);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL)
+        return;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init (&iter, cache->entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value)) {
+        Entry *entry = value;
+        g_queue_unlink (get_lru (self, cache), &entry->link);
+        if (cache->on_disk)
+            self->disk_used -= entry->size;
+        else
+            self->memory_used -= entry->size;
+    }
+    g_hash_table_remove (self->caches, GUINT_TO_POINTER (cache_id));
+}
+
+/* Count an entry of @size bytes added to or replaced in a cache, evicting others to stay in the budget */
+void
+_snapd_cache_manager_insert (SnapdCacheManager *self, guint cache_id, const gchar *key, guint64 size)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+    g_return_if_fail (key != NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL)
+        return;
+
+    /* The new entry replaces one that was evicted but not yet dropped */
+    forget_evicted_unlocked (cache, key);
+
+    GQueue *lru = get_lru (self, cache);
+    Entry *entry = g_hash_table_lookup (cache->entries, key);
+    if (entry != NULL)
+        remove_entry_unlocked (self, entry);
+
+    guint64 budget = get_budget (self, cache);
+    if (size > budget / 2) {
+        cache->stats->evictions++;
+        g_ptr_array_add (cache->evicted, g_strdup (key));
+        return;
+    }
+
+    entry = g_slice_new0 (Entry);
+    entry->cache = cache;
+    entry->key = g_strdup (key);
+    entry->size = size;
+    entry->link.data = entry;
+    g_hash_table_insert (cache->entries, entry->key, entry);
+    g_queue_push_head_link (lru, &entry->link);
+    if (cache->on_disk)
+        self->disk_used += size;
+    else
+        self->memory_used += size;
+
+    shrink_unlocked (self, lru, budget);
+    queue_drain_unlocked (self, cache);
+}
+
+/* Stop counting an entry the cache removed itself */
+void
+_snapd_cache_manager_remove (SnapdCacheManager *self, guint cache_id, const gchar *key)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+    g_return_if_fail (key != NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL)
+        return;
+
+    forget_evicted_unlocked (cache, key);
+    Entry *entry = g_hash_table_lookup (cache->entries, key);
+    if (entry != NULL)
+        remove_entry_unlocked (self, entry);
+}
+
+/* Stop counting the entries of a cache that was cleared */
+void
+_snapd_cache_manager_remove_all (SnapdCacheManager *self, guint cache_id)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL)
+        return;
+
+    g_ptr_array_set_size (cache->evicted, 0);
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init (&iter, cache->entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value)) {
+        Entry *entry = value;
+        g_queue_unlink (get_lru (self, cache), &entry->link);
+        if (cache->on_disk)
+            self->disk_used -= entry->size;
+        else
+            self->memory_used -= entry->size;
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+/* Count an entry being used, making it the last to be evicted */
+void
+_snapd_cache_manager_hit (SnapdCacheManager *self, guint cache_id, const gchar *key)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+    g_return_if_fail (key != NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL)
+        return;
+
+    cache->stats->hits++;
+    Entry *entry = g_hash_table_lookup (cache->entries, key);
+    if (entry != NULL) {
+        GQueue *lru = get_lru (self, cache);
+        g_queue_unlink (lru, &entry->link);
+        g_queue_push_head_link (lru, &entry->link);
+    }
+}
+
+/* Count a lookup that wasn't in the cache */
+void
+_snapd_cache_manager_miss (SnapdCacheManager *self, guint cache_id)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache != NULL)
+        cache->stats->misses++;
+}
+
+/**
+ * _snapd_cache_manager_take_evicted:
+ *
+ * Get the keys of entries evicted since this was last called, which the cache should now remove.
+ *
+ * Returns: (transfer full) (allow-none): the evicted keys or %NULL if there are none.
+ */
+GStrv
+_snapd_cache_manager_take_evicted (SnapdCacheManager *self, guint cache_id)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    Cache *cache = g_hash_table_lookup (self->caches, GUINT_TO_POINTER (cache_id));
+    if (cache == NULL || cache->evicted->len == 0)
+        return NULL;
+
+    g_ptr_array_add (cache->evicted, NULL);
+    GStrv keys = (GStrv) g_ptr_array_free (cache->evicted, FALSE);
+    cache->evicted = g_ptr_array_new_with_free_func (g_free);
+
+    return keys;
+}
+
+/**
+ * snapd_cache_manager_new:
+ *
+ * Create a new cache manager with the default budgets.
+ *
+ * Returns: a new #SnapdCacheManager
+ *
+ * Since: 1.65
+ */
+SnapdCacheManager *
+snapd_cache_manager_new (void)
+{
+    return g_object_new (SNAPD_TYPE_CACHE_MANAGER, NULL);
+}
+
+/**
+ * snapd_cache_manager_set_memory_budget:
+ * @manager: a #SnapdCacheManager.
+ * @budget: the number of bytes cached data can use in memory.
+ *
+ * Set how much memory cached data can use in total. Entries are removed
+ * straight away if the new budget is smaller than the memory they use.
+ * Defaults to 16MB.
+ *
+ * Since: 1.65
+ */
+void
+snapd_cache_manager_set_memory_budget (SnapdCacheManager *self, gsize budget)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) drain_locker = g_mutex_locker_new (&self->drain_mutex);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        self->memory_budget = budget;
+        shrink_unlocked (self, &self->memory_lru, budget);
+    }
+    drain_caches (self);
+}
+
+/**
+ * snapd_cache_manager_get_memory_budget:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Get the memory budget set with snapd_cache_manager_set_memory_budget().
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_cache_manager_get_memory_budget (SnapdCacheManager *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->memory_budget;
+}
+
+/**
+ * snapd_cache_manager_set_disk_budget:
+ * @manager: a #SnapdCacheManager.
+ * @budget: the number of bytes cached data can use on disk.
+ *
+ * Set how much disk space cached files can use in total. Files are deleted
+ * straight away if the new budget is smaller than the space they use.
+ * Defaults to 1GB.
+ *
+ * Since: 1.65
+ */
+void
+snapd_cache_manager_set_disk_budget (SnapdCacheManager *self, guint64 budget)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) drain_locker = g_mutex_locker_new (&self->drain_mutex);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        self->disk_budget = budget;
+        shrink_unlocked (self, &self->disk_lru, budget);
+    }
+    drain_caches (self);
+}
+
+/**
+ * snapd_cache_manager_get_disk_budget:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Get the disk budget set with snapd_cache_manager_set_disk_budget().
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+guint64
+snapd_cache_manager_get_disk_budget (SnapdCacheManager *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->disk_budget;
+}
+
+/**
+ * snapd_cache_manager_get_memory_used:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Get an estimate of the memory used by cached data.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_cache_manager_get_memory_used (SnapdCacheManager *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->memory_used;
+}
+
+/**
+ * snapd_cache_manager_get_disk_used:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Get the disk space used by cached files.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+guint64
+snapd_cache_manager_get_disk_used (SnapdCacheManager *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->disk_used;
+}
+
+/**
+ * snapd_cache_manager_trim:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Remove everything from the caches. This is done automatically when the
+ * system is low on memory.
+ *
+ * Since: 1.65
+ */
+void
+snapd_cache_manager_trim (SnapdCacheManager *self)
+{
+    g_return_if_fail (SNAPD_IS_CACHE_MANAGER (self));
+
+    g_autoptr(GMutexLocker) drain_locker = g_mutex_locker_new (&self->drain_mutex);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        shrink_unlocked (self, &self->memory_lru, 0);
+        shrink_unlocked (self, &self->disk_lru, 0);
+    }
+    drain_caches (self);
+}
+
+static gint
+compare_names (gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0 (*(const gchar **) a, *(const gchar **) b);
+}
+
+/**
+ * snapd_cache_manager_get_cache_names:
+ * @manager: a #SnapdCacheManager.
+ *
+ * Get the names of the caches that have been counted by this manager, for
+ * use with snapd_cache_manager_get_hits() and similar.
+ *
+ * Returns: (transfer full): a sorted list of cache names.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_cache_manager_get_cache_names (SnapdCacheManager *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    g_autoptr(GPtrArray) names = g_ptr_array_new ();
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init (&iter, self->stats);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        g_ptr_array_add (names, g_strdup (key));
+    g_ptr_array_sort (names, compare_names);
+    g_ptr_array_add (names, NULL);
+
+    return (GStrv) g_ptr_array_free (g_steal_pointer (&names), FALSE);
+}
+
+static CacheStats *
+get_stats_unlocked (SnapdCacheManager *self, const gchar *name)
+{
+    return g_hash_table_lookup (self->stats, name);
+}
+
+/**
+ * snapd_cache_manager_get_hits:
+ * @manager: a #SnapdCacheManager.
+ * @name: a cache name from snapd_cache_manager_get_cache_names().
+ *
+ * Get the number of times an entry was found in the named caches.
+ *
+ * Returns: the number of cache hits.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_cache_manager_get_hits (SnapdCacheManager *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    CacheStats *stats = get_stats_unlocked (self, name);
+    return stats != NULL ? stats->hits : 0;
+}
+
+/**
+ * snapd_cache_manager_get_misses:
+ * @manager: a #SnapdCacheManager.
+ * @name: a cache name from snapd_cache_manager_get_cache_names().
+ *
+ * Get the number of times an entry was not found in the named caches.
+ *
+ * Returns: the number of cache misses.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_cache_manager_get_misses (SnapdCacheManager *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    CacheStats *stats = get_stats_unlocked (self, name);
+    return stats != NULL ? stats->misses : 0;
+}
+
+/**
+ * snapd_cache_manager_get_evictions:
+ * @manager: a #SnapdCacheManager.
+ * @name: a cache name from snapd_cache_manager_get_cache_names().
+ *
+ * Get the number of entries removed from the named caches to stay within a
+ * budget, including entries too large to be kept and those removed by
+ * snapd_cache_manager_trim().
+ *
+ * Returns: the number of evictions.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_cache_manager_get_evictions (SnapdCacheManager *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CACHE_MANAGER (self), 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    CacheStats *stats = get_stats_unlocked (self, name);
+    return stats != NULL ? stats->evictions : 0;
+}
+
+#if GLIB_CHECK_VERSION (2, 64, 0)
+static void
+low_memory_warning_cb (SnapdCacheManager *self, GMemoryMonitorWarningLevel level)
+{
+    snapd_cache_manager_trim (self);
+}
+#endif
+
+static void
+cache_stats_free (CacheStats *stats)
+{
+    g_slice_free (CacheStats, stats);
+}
+
+static void
+snapd_cache_manager_dispose (GObject *object)
+{
+    SnapdCacheManager *self = SNAPD_CACHE_MANAGER (object);
+
+#if GLIB_CHECK_VERSION (2, 64, 0)
+    if (self->memory_monitor != NULL)
+        g_signal_handlers_disconnect_by_data (self->memory_monitor, self);
+    g_clear_object (&self->memory_monitor);
+#endif
+
+    G_OBJECT_CLASS (snapd_cache_manager_parent_class)->dispose (object);
+}
+
+static void
+snapd_cache_manager_finalize (GObject *object)
+{
+    SnapdCacheManager *self = SNAPD_CACHE_MANAGER (object);
+
+    g_mutex_clear (&self->drain_mutex);
+    g_mutex_clear (&self->mutex);
+    g_clear_pointer (&self->caches, g_hash_table_unref);
+    g_clear_pointer (&self->stats, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_cache_manager_parent_class)->finalize (object);
+}
+
+static void
+snapd_cache_manager_class_init (SnapdCacheManagerClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->dispose = snapd_cache_manager_dispose;
+    gobject_class->finalize = snapd_cache_manager_finalize;
+}
+
+static void
+snapd_cache_manager_init (SnapdCacheManager *self)
+{
+    g_mutex_init (&self->drain_mutex);
+    g_mutex_init (&self->mutex);
+    self->memory_budget = DEFAULT_MEMORY_BUDGET;
+    self->disk_budget = DEFAULT_DISK_BUDGET;
+    g_queue_init (&self->memory_lru);
+    g_queue_init (&self->disk_lru);
+    self->caches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) cache_free);
+    self->stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) cache_stats_free);
+
+#if GLIB_CHECK_VERSION (2, 64, 0)
+    self->memory_monitor = g_memory_monitor_dup_default ();
+    if (self->memory_monitor != NULL)
+        g_signal_connect_object (self->memory_monitor, "low-memory-warning", G_CALLBACK (low_memory_warning_cb), self, G_CONNECT_SWAPPED);
+#endif
+}
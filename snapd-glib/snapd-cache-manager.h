@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CACHE_MANAGER_H__
+#define __SNAPD_CACHE_MANAGER_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CACHE_MANAGER  (snapd_cache_manager_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdCacheManager, snapd_cache_manager, SNAPD, CACHE_MANAGER, GObject)
+
+SnapdCacheManager *snapd_cache_manager_new               (void);
+
+void               snapd_cache_manager_set_memory_budget (SnapdCacheManager *manager,
+                                                          gsize              budget);
+
+gsize              snapd_cache_manager_get_memory_budget (SnapdCacheManager *manager);
+
+void               snapd_cache_manager_set_disk_budget   (SnapdCacheManager *manager,
+                                                          guint64            budget);
+
+guint64            snapd_cache_manager_get_disk_budget   (SnapdCacheManager *manager);
+
+gsize              snapd_cache_manager_get_memory_used   (SnapdCacheManager *manager);
+
+guint64            snapd_cache_manager_get_disk_used     (SnapdCacheManager *manager);
+
+void               snapd_cache_manager_trim              (SnapdCacheManager *manager);
+
+GStrv              snapd_cache_manager_get_cache_names   (SnapdCacheManager *manager);
+
+guint              snapd_cache_manager_get_hits          (SnapdCacheManager *manager,
+                                                          const gchar       *name);
+
+guint              snapd_cache_manager_get_misses        (SnapdCacheManager *manager,
+                                                          const gchar       *name);
+
+guint              snapd_cache_manager_get_evictions     (SnapdCacheManager *manager,
+                                                          const gchar       *name);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CACHE_MANAGER_H__ */
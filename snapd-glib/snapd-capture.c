@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+
+#include "snapd-capture.h"
+
+/* Exchanges written by snapd_client_start_capture(), in the format described there */
+#define CAPTURE_HEADER "snapd-glib-capture 1\n"
+
+/* Endpoints whose response bodies contain credentials, and so are recorded as empty */
+static const gchar *credential_paths[] = { "/v2/login", NULL };
+
+struct _SnapdCapture
+{
+    gint ref_count;
+
+    /* Responses can complete in any thread */
+    GMutex mutex;
+    FILE *file;
+
+    /* Monotonic time the capture started, exchange times are relative to this */
+    gint64 start_time;
+};
+
+SnapdCapture *
+_snapd_capture_new (const gchar *path, GError **error)
+{
+    /* Responses can contain private data, so only the user can read the file */
+    FILE *file = NULL;
+    int fd = g_open (path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd >= 0 && fchmod (fd, 0600) == 0)
+        file = fdopen (fd, "wb");
+    if (file == NULL || fputs (CAPTURE_HEADER, file) == EOF) {
+        int errsv = errno;
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                     "Failed to open capture file %s: %s", path, g_strerror (errsv));
+        if (file != NULL)
+            fclose (file);
+        else if (fd >= 0)
+            close (fd);
+        return NULL;
+    }
+
+    SnapdCapture *capture = g_slice_new0 (SnapdCapture);
+    capture->ref_count = 1;
+    g_mutex_init (&capture->mutex);
+    capture->file = file;
+    capture->start_time = g_get_monotonic_time ();
+
+    return capture;
+}
+
+SnapdCapture *
+_snapd_capture_ref (SnapdCapture *capture)
+{
+    g_atomic_int_inc (&capture->ref_count);
+    return capture;
+}
+
+void
+_snapd_capture_unref (SnapdCapture *capture)
+{
+    if (!g_atomic_int_dec_and_test (&capture->ref_count))
+        return;
+
+    fclose (capture->file);
+    g_mutex_clear (&capture->mutex);
+    g_slice_free (SnapdCapture, capture);
+}
+
+/* Times that weren't recorded are taken as the same as the previous phase */
+static gint64
+get_interval (gint64 start, gint64 end)
+{
+    return start > 0 && end > start ? end - start : 0;
+}
+
+void
+_snapd_capture_add_exchange (SnapdCapture *capture,
+                             const gchar *method, const gchar *path, const gchar *query,
+                             gint64 written_time, gint64 first_byte_time, gint64 body_time,
+                             guint status_code, const gchar *content_type, GBytes *body)
+{
+    gsize body_length;
+    const gchar *body_data = g_bytes_get_data (body, &body_length);
+    if (g_strv_contains (credential_paths, path))
+        body_length = 0;
+    gint64 first_byte = first_byte_time > 0 ? first_byte_time : body_time;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&capture->mutex);
+    fprintf (capture->file, "%" G_GINT64_FORMAT " %" G_GINT64_FORMAT " %" G_GINT64_FORMAT " %u %" G_GSIZE_FORMAT " %s %s%s%s %s\n",
+             get_interval (capture->start_time, written_time),
+             get_interval (written_time, first_byte),
+             get_interval (first_byte, body_time),
+             status_code, body_length,
+             method, path, query != NULL ? "?" : "", query != NULL ? query : "",
+             content_type != NULL && content_type[0] != '\0' ? content_type : "-");
+    if (body_length > 0)
+        fwrite (body_data, 1, body_length, capture->file);
+    fputc ('\n', capture->file);
+    fflush (capture->file);
+}
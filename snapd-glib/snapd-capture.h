@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CAPTURE_H__
+#define __SNAPD_CAPTURE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SnapdCapture SnapdCapture;
+
+SnapdCapture *_snapd_capture_new          (const gchar  *path,
+                                           GError      **error);
+
+SnapdCapture *_snapd_capture_ref          (SnapdCapture *capture);
+
+void          _snapd_capture_unref        (SnapdCapture *capture);
+
+void          _snapd_capture_add_exchange (SnapdCapture *capture,
+                                           const gchar  *method,
+                                           const gchar  *path,
+                                           const gchar  *query,
+                                           gint64        written_time,
+                                           gint64        first_byte_time,
+                                           gint64        body_time,
+                                           guint         status_code,
+                                           const gchar  *content_type,
+                                           GBytes       *body);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdCapture, _snapd_capture_unref)
+
+G_END_DECLS
+
+#endif /* __SNAPD_CAPTURE_H__ */
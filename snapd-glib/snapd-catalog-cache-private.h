@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CATALOG_CACHE_PRIVATE_H__
+#define __SNAPD_CATALOG_CACHE_PRIVATE_H__
+
+#include "snapd-cache-manager.h"
+#include "snapd-catalog-cache.h"
+
+G_BEGIN_DECLS
+
+void    _snapd_catalog_cache_insert (SnapdCatalogCache *cache,
+                                     const gchar       *path,
+                                     GBytes            *body);
+
+GBytes *_snapd_catalog_cache_lookup (SnapdCatalogCache *cache,
+                                     const gchar       *path);
+
+void    _snapd_catalog_cache_set_cache_manager (SnapdCatalogCache *cache,
+                                                SnapdCacheManager *manager);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CATALOG_CACHE_PRIVATE_H__ */
@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+#include <gio/gio.h>
+
+#include "snapd-cache-manager-private.h"
+#include "snapd-catalog-cache-private.h"
+
+/**
+ * SECTION:snapd-catalog-cache
+ * @short_description: Persistent cache of store results
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdCatalogCache keeps the responses snapd returned for store searches,
+ * sections and system information. When set on a client with
+ * snapd_client_set_catalog_cache() every successful find, sections and system
+ * information request is recorded, and the results can be read back without
+ * contacting snapd using snapd_client_find_cached(),
+ * snapd_client_get_sections_cached() and
+ * snapd_client_get_system_information_cached(). This allows a store to show
+ * results immediately on start while it refreshes them in the background.
+ *
+ * When snapd can't be reached, for example while it is restarting, or it
+ * can't reach the store, requests that have cached responses complete with
+ * those instead of failing. snapd_client_get_maintenance() reports if snapd
+ * announced it was restarting.
+ *
+ * A cache can be saved to a file with snapd_catalog_cache_save() and
+ * loaded again with snapd_catalog_cache_new_from_file(). The file is memory
+ * mapped so loading is quick regardless of its size.
+ *
+ * Responses recorded since the cache was loaded count against the memory
+ * budget of the #SnapdCacheManager of the last client the cache was set on,
+ * and the least recently used are forgotten when it is exceeded.
+ */
+
+/**
+ * SnapdCatalogCache:
+ *
+ * #SnapdCatalogCache is an opaque data structure and can only be accessed
+ * using the provided functions.
+ *
+ * Since: 1.65
+ */
+
+/* File layout, with all values little-endian:
+ * FileHeader
+ * FileEntry[n_entries], sorted by path
+ * Paths and response bodies */
+#define FILE_MAGIC "SNAPDCC1"
+
+typedef struct
+{
+    gchar magic[8];
+    guint32 n_entries;
+    guint32 reserved;
+} FileHeader;
+
+typedef struct
+{
+    guint32 path_offset;
+    guint32 path_length;
+    guint32 body_offset;
+    guint32 body_length;
+} FileEntry;
+
+struct _SnapdCatalogCache
+{
+    GObject parent_instance;
+
+    GMutex mutex;
+
+    /* File loaded from */
+    GMappedFile *file;
+    GBytes *data;
+    guint32 n_file_entries;
+    const FileEntry *file_entries;
+
+    /* Responses added since loading, keyed by request path */
+    GHashTable *added;
+
+    /* Manager counting the added responses, and the ID they are counted with */
+    SnapdCacheManager *cache_manager;
+    guint cache_id;
+};
+
+G_DEFINE_TYPE (SnapdCatalogCache, snapd_catalog_cache, G_TYPE_OBJECT)
+
+static gint
+compare_paths (const gchar *a, gsize a_length, const gchar *b, gsize b_length)
+{
+    gint result = memcmp (a, b, MIN (a_length, b_length));
+    if (result != 0)
+        return result;
+    return a_length < b_length ? -1 : a_length > b_length ? 1 : 0;
+}
+
+static const gchar *
+get_file_path (SnapdCatalogCache *self, guint index, gsize *length)
+{
+    const gchar *data = g_bytes_get_data (self->data, NULL);
+    *length = GUINT32_FROM_LE (self->file_entries[index].path_length);
+    return data + GUINT32_FROM_LE (self->file_entries[index].path_offset);
+}
+
+/* Find the entry for @path in the file, or -1 */
+static gssize
+find_file_entry (SnapdCatalogCache *self, const gchar *path)
+{
+    gsize path_length = strlen (path);
+    gsize start = 0, end = self->n_file_entries;
+    while (start < end) {
+        gsize middle = start + (end - start) / 2;
+        gsize length;
+        const gchar *p = get_file_path (self, middle, &length);
+        gint result = compare_paths (p, length, path, path_length);
+        if (result == 0)
+            return middle;
+        if (result < 0)
+            start = middle + 1;
+        else
+            end = middle;
+    }
+
+    return -1;
+}
+
+static GBytes *
+get_file_body (SnapdCatalogCache *self, guint index)
+{
+    const FileEntry *entry = &self->file_entries[index];
+    return g_bytes_new_from_bytes (self->data, GUINT32_FROM_LE (entry->body_offset), GUINT32_FROM_LE (entry->body_length));
+}
+
+/**
+ * snapd_catalog_cache_new:
+ *
+ * Create a new empty catalog cache.
+ *
+ * Returns: a new #SnapdCatalogCache
+ *
+ * Since: 1.65
+ */
+SnapdCatalogCache *
+snapd_catalog_cache_new (void)
+{
+    return g_object_new (SNAPD_TYPE_CATALOG_CACHE, NULL);
+}
+
+/**
+ * snapd_catalog_cache_new_from_file:
+ * @path: path of a file written with snapd_catalog_cache_save().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Load a catalog cache from a file. The file is memory mapped, and must not
+ * be modified while the cache exists. snapd_catalog_cache_save() replaces the
+ * file rather than modifying it, so the same path can be saved to.
+ *
+ * Returns: (transfer full): a new #SnapdCatalogCache or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdCatalogCache *
+snapd_catalog_cache_new_from_file (const gchar *path, GError **error)
+{
+    g_return_val_if_fail (path != NULL, NULL);
+
+    g_autoptr(GMappedFile) file = g_mapped_file_new (path, FALSE, error);
+    if (file == NULL)
+        return NULL;
+
+    const gchar *data = g_mapped_file_get_contents (file);
+    gsize data_length = g_mapped_file_get_length (file);
+    const FileHeader *header = (const FileHeader *) data;
+    if (data_length < sizeof (FileHeader) || memcmp (header->magic, FILE_MAGIC, sizeof (header->magic)) != 0) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s is not a catalog cache", path);
+        return NULL;
+    }
+
+    guint64 n_entries = GUINT32_FROM_LE (header->n_entries);
+    if (sizeof (FileHeader) + n_entries * sizeof (FileEntry) > data_length) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Catalog cache %s is truncated", path);
+        return NULL;
+    }
+
+    /* Check everything is inside the file so lookups don't have to */
+    const FileEntry *entries = (const FileEntry *) (data + sizeof (FileHeader));
+    for (guint64 i = 0; i < n_entries; i++) {
+        guint64 path_end = (guint64) GUINT32_FROM_LE (entries[i].path_offset) + GUINT32_FROM_LE (entries[i].path_length);
+        guint64 body_end = (guint64) GUINT32_FROM_LE (entries[i].body_offset) + GUINT32_FROM_LE (entries[i].body_length);
+        if (path_end > data_length || body_end > data_length) {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Catalog cache %s is corrupt", path);
+            return NULL;
+        }
+    }
+
+    SnapdCatalogCache *self = snapd_catalog_cache_new ();
+    self->data = g_mapped_file_get_bytes (file);
+    self->file = g_steal_pointer (&file);
+    self->n_file_entries = n_entries;
+    self->file_entries = entries;
+
+    return self;
+}
+
+/* Forget responses the cache manager evicted. Must be called with the mutex held */
+static void
+drop_evicted_unlocked (SnapdCatalogCache *self)
+{
+    if (self->cache_manager == NULL)
+        return;
+
+    g_auto(GStrv) paths = _snapd_cache_manager_take_evicted (self->cache_manager, self->cache_id);
+    for (int i = 0; paths != NULL && paths[i] != NULL; i++)
+        g_hash_table_remove (self->added, paths[i]);
+}
+
+static void
+drain_cb (gpointer user_data)
+{
+    SnapdCatalogCache *self = user_data;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    drop_evicted_unlocked (self);
+}
+
+static guint64
+get_entry_size (const gchar *path, GBytes *body)
+{
+    return strlen (path) + 1 + g_bytes_get_size (body) + sizeof (GBytes);
+}
+
+/* Count the responses added to the cache in @manager's budget, in place of any previous manager */
+void
+_snapd_catalog_cache_set_cache_manager (SnapdCatalogCache *self, SnapdCacheManager *manager)
+{
+    g_return_if_fail (SNAPD_IS_CATALOG_CACHE (self));
+
+    g_autoptr(SnapdCacheManager) old_manager = NULL;
+    guint old_cache_id = 0;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        if (self->cache_manager == manager)
+            return;
+
+        old_manager = g_steal_pointer (&self->cache_manager);
+        old_cache_id = self->cache_id;
+        self->cache_id = 0;
+        if (manager != NULL) {
+            self->cache_manager = g_object_ref (manager);
+            self->cache_id = _snapd_cache_manager_add_cache (manager, "catalog", FALSE, drain_cb, self);
+
+            GHashTableIter iter;
+            gpointer key, value;
+            g_hash_table_iter_init (&iter, self->added);
+            while (g_hash_table_iter_next (&iter, &key, &value))
+                _snapd_cache_manager_insert (manager, self->cache_id, key, get_entry_size (key, value));
+            drop_evicted_unlocked (self);
+        }
+    }
+
+    /* Removed without the mutex held as it waits for drain_cb () */
+    if (old_manager != NULL)
+        _snapd_cache_manager_remove_cache (old_manager, old_cache_id);
+}
+
+/* Record the response to a request for @path */
+void
+_snapd_catalog_cache_insert (SnapdCatalogCache *self, const gchar *path, GBytes *body)
+{
+    g_return_if_fail (SNAPD_IS_CATALOG_CACHE (self));
+    g_return_if_fail (path != NULL);
+    g_return_if_fail (body != NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    g_hash_table_insert (self->added, g_strdup (path), g_bytes_ref (body));
+    if (self->cache_manager != NULL) {
+        _snapd_cache_manager_insert (self->cache_manager, self->cache_id, path, get_entry_size (path, body));
+        drop_evicted_unlocked (self);
+    }
+}
+
+/* Get the last response recorded for @path, or %NULL */
+GBytes *
+_snapd_catalog_cache_lookup (SnapdCatalogCache *self, const gchar *path)
+{
+    g_return_val_if_fail (SNAPD_IS_CATALOG_CACHE (self), NULL);
+    g_return_val_if_fail (path != NULL, NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    drop_evicted_unlocked (self);
+    GBytes *body = g_hash_table_lookup (self->added, path);
+    if (body != NULL) {
+        if (self->cache_manager != NULL)
+            _snapd_cache_manager_hit (self->cache_manager, self->cache_id, path);
+        return g_bytes_ref (body);
+    }
+
+    gssize index = find_file_entry (self, path);
+    if (self->cache_manager != NULL) {
+        if (index >= 0)
+            _snapd_cache_manager_hit (self->cache_manager, self->cache_id, path);
+        else
+            _snapd_cache_manager_miss (self->cache_manager, self->cache_id);
+    }
+    return index >= 0 ? get_file_body (self, index) : NULL;
+}
+
+/**
+ * snapd_catalog_cache_get_n_entries:
+ * @cache: a #SnapdCatalogCache.
+ *
+ * Get the number of responses in the cache.
+ *
+ * Returns: the number of responses.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_catalog_cache_get_n_entries (SnapdCatalogCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CATALOG_CACHE (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    drop_evicted_unlocked (self);
+    guint n_entries = g_hash_table_size (self->added);
+    for (guint i = 0; i < self->n_file_entries; i++) {
+        gsize length;
+        const gchar *path = get_file_path (self, i, &length);
+        g_autofree gchar *p = g_strndup (path, length);
+        if (!g_hash_table_contains (self->added, p))
+            n_entries++;
+    }
+
+    return n_entries;
+}
+
+/**
+ * snapd_catalog_cache_clear:
+ * @cache: a #SnapdCatalogCache.
+ *
+ * Remove all responses from the cache.
+ *
+ * Since: 1.65
+ */
+void
+snapd_catalog_cache_clear (SnapdCatalogCache *self)
+{
+    g_return_if_fail (SNAPD_IS_CATALOG_CACHE (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    g_hash_table_remove_all (self->added);
+    if (self->cache_manager != NULL)
+        _snapd_cache_manager_remove_all (self->cache_manager, self->cache_id);
+    g_clear_pointer (&self->data, g_bytes_unref);
+    g_clear_pointer (&self->file, g_mapped_file_unref);
+    self->n_file_entries = 0;
+    self->file_entries = NULL;
+}
+
+typedef struct
+{
+    const gchar *path;
+    gsize path_length;
+    GBytes *body;
+} Entry;
+
+static gint
+compare_entries (gconstpointer a, gconstpointer b)
+{
+    const Entry *entry_a = a, *entry_b = b;
+    return compare_paths (entry_a->path, entry_a->path_length, entry_b->path, entry_b->path_length);
+}
+
+static void
+entry_clear (Entry *entry)
+{
+    g_bytes_unref (entry->body);
+}
+
+static void
+append_uint32 (GByteArray *data, guint32 value)
+{
+    guint32 v = GUINT32_TO_LE (value);
+    g_byte_array_append (data, (const guint8 *) &v, sizeof (v));
+}
+
+/**
+ * snapd_catalog_cache_save:
+ * @cache: a #SnapdCatalogCache.
+ * @path: path of the file to write.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Save the responses in the cache to a file, so they can be loaded with
+ * snapd_catalog_cache_new_from_file().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_catalog_cache_save (SnapdCatalogCache *self, const gchar *path, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CATALOG_CACHE (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    drop_evicted_unlocked (self);
+
+    /* Responses added replace those from the file */
+    g_autoptr(GArray) entries = g_array_new (FALSE, FALSE, sizeof (Entry));
+    g_array_set_clear_func (entries, (GDestroyNotify) entry_clear);
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init (&iter, self->added);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        Entry entry = { key, strlen (key), g_bytes_ref (value) };
+        g_array_append_val (entries, entry);
+    }
+    for (guint i = 0; i < self->n_file_entries; i++) {
+        Entry entry;
+        entry.path = get_file_path (self, i, &entry.path_length);
+        g_autofree gchar *p = g_strndup (entry.path, entry.path_length);
+        if (g_hash_table_contains (self->added, p))
+            continue;
+        entry.body = get_file_body (self, i);
+        g_array_append_val (entries, entry);
+    }
+    g_array_sort (entries, compare_entries);
+
+    guint64 offset = sizeof (FileHeader) + (guint64) entries->len * sizeof (FileEntry);
+    g_autoptr(GByteArray) data = g_byte_array_new ();
+    g_byte_array_append (data, (const guint8 *) FILE_MAGIC, strlen (FILE_MAGIC));
+    append_uint32 (data, entries->len);
+    append_uint32 (data, 0);
+    for (guint i = 0; i < entries->len; i++) {
+        Entry *entry = &g_array_index (entries, Entry, i);
+        gsize body_length = g_bytes_get_size (entry->body);
+        append_uint32 (data, offset);
+        append_uint32 (data, entry->path_length);
+        append_uint32 (data, offset + entry->path_length);
+        append_uint32 (data, body_length);
+        offset += entry->path_length + body_length;
+    }
+    if (offset > G_MAXUINT32) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Catalog cache is too large to save");
+        return FALSE;
+    }
+    for (guint i = 0; i < entries->len; i++) {
+        Entry *entry = &g_array_index (entries, Entry, i);
+        gsize body_length;
+        const guint8 *body = g_bytes_get_data (entry->body, &body_length);
+        g_byte_array_append (data, (const guint8 *) entry->path, entry->path_length);
+        g_byte_array_append (data, body, body_length);
+    }
+
+    return g_file_set_contents (path, (const gchar *) data->data, data->len, error);
+}
+
+static void
+snapd_catalog_cache_finalize (GObject *object)
+{
+    SnapdCatalogCache *self = SNAPD_CATALOG_CACHE (object);
+
+    if (self->cache_manager != NULL)
+        _snapd_cache_manager_remove_cache (self->cache_manager, self->cache_id);
+    g_clear_object (&self->cache_manager);
+    g_mutex_clear (&self->mutex);
+    g_clear_pointer (&self->added, g_hash_table_unref);
+    g_clear_pointer (&self->data, g_bytes_unref);
+    g_clear_pointer (&self->file, g_mapped_file_unref);
+
+    G_OBJECT_CLASS (snapd_catalog_cache_parent_class)->finalize (object);
+}
+
+static void
+snapd_catalog_cache_class_init (SnapdCatalogCacheClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_catalog_cache_finalize;
+}
+
+static void
+snapd_catalog_cache_init (SnapdCatalogCache *self)
+{
+    g_mutex_init (&self->mutex);
+    self->added = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_bytes_unref);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CATALOG_CACHE_H__
+#define __SNAPD_CATALOG_CACHE_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CATALOG_CACHE  (snapd_catalog_cache_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdCatalogCache, snapd_catalog_cache, SNAPD, CATALOG_CACHE, GObject)
+
+SnapdCatalogCache *snapd_catalog_cache_new             (void);
+
+SnapdCatalogCache *snapd_catalog_cache_new_from_file   (const gchar        *path,
+                                                        GError            **error);
+
+guint              snapd_catalog_cache_get_n_entries   (SnapdCatalogCache  *cache);
+
+void               snapd_catalog_cache_clear           (SnapdCatalogCache  *cache);
+
+gboolean           snapd_catalog_cache_save            (SnapdCatalogCache  *cache,
+                                                        const gchar        *path,
+                                                        GError            **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CATALOG_CACHE_H__ */
@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-change-list.h"
+#include "snapd-change-private.h"
+
+#include "snapd-error.h"
+#include "snapd-task.h"
+
+/**
+ * SECTION: snapd-change-list
+ * @short_description: Changes kept up to date
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdChangeList holds the changes snapd knows about. The first call to
+ * snapd_change_list_refresh_async() gets all changes. Later calls only get
+ * the changes that are in progress, and then the individual changes that have
+ * finished or started since the last refresh. Changes that are ready are not
+ * fetched again. If many changes need fetching individually, all changes are
+ * fetched instead. #SnapdChangeList::change-added,
+ * #SnapdChangeList::change-removed and #SnapdChangeList::change-changed are
+ * emitted for the differences.
+ */
+
+/**
+ * SnapdChangeList:
+ *
+ * #SnapdChangeList holds changes.
+ *
+ * Since: 1.65
+ */
+
+/* Number of changes to fetch individually before fetching all changes instead */
+#define MAX_CHANGE_FETCHES 16
+
+struct _SnapdChangeList
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* TRUE once all changes have been fetched */
+    gboolean have_changes;
+
+    /* Changes in order of ID and indexed by ID */
+    GPtrArray *changes;
+    GHashTable *changes_by_id;
+
+    /* The highest change ID and latest spawn time seen */
+    gint64 last_id;
+    GDateTime *last_spawn_time;
+    gint64 last_spawn_time_usec;
+};
+
+typedef struct
+{
+    /* IDs of changes to fetch individually, and the one being fetched */
+    GQueue ids;
+    gchar *id;
+    guint n_fetches;
+} RefreshData;
+
+enum
+{
+    SIGNAL_CHANGE_ADDED,
+    SIGNAL_CHANGE_REMOVED,
+    SIGNAL_CHANGE_CHANGED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdChangeList, snapd_change_list, G_TYPE_OBJECT)
+
+static void
+refresh_data_free (RefreshData *data)
+{
+    g_queue_foreach (&data->ids, (GFunc) g_free, NULL);
+    g_queue_clear (&data->ids);
+    g_free (data->id);
+    g_slice_free (RefreshData, data);
+}
+
+static gint64
+parse_id (const gchar *id)
+{
+    return g_ascii_strtoll (id, NULL, 10);
+}
+
+static gint
+compare_changes (gconstpointer a, gconstpointer b)
+{
+    gint64 id_a = parse_id (snapd_change_get_id (*((SnapdChange **) a)));
+    gint64 id_b = parse_id (snapd_change_get_id (*((SnapdChange **) b)));
+    return id_a < id_b ? -1 : id_a > id_b ? 1 : 0;
+}
+
+static gint64
+get_progress_done (SnapdChange *change)
+{
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    gint64 done = 0;
+    for (guint i = 0; tasks != NULL && i < tasks->len; i++)
+        done += snapd_task_get_progress_done (g_ptr_array_index (tasks, i));
+    return done;
+}
+
+static gboolean
+change_changed (SnapdChange *old_change, SnapdChange *new_change)
+{
+    return g_strcmp0 (snapd_change_get_status (old_change), snapd_change_get_status (new_change)) != 0 ||
+           snapd_change_get_ready (old_change) != snapd_change_get_ready (new_change) ||
+           get_progress_done (old_change) != get_progress_done (new_change);
+}
+
+static void
+merge_change (SnapdChangeList *self, SnapdChange *change)
+{
+    const gchar *id = snapd_change_get_id (change);
+
+    gint64 id_value = parse_id (id);
+    if (id_value > self->last_id)
+        self->last_id = id_value;
+    const SnapdTimestamp *spawn_time = _snapd_change_get_spawn_timestamp (change);
+    if (spawn_time->is_set && (self->last_spawn_time == NULL || spawn_time->time > self->last_spawn_time_usec)) {
+        g_clear_pointer (&self->last_spawn_time, g_date_time_unref);
+        self->last_spawn_time = g_date_time_ref (snapd_change_get_spawn_time (change));
+        self->last_spawn_time_usec = spawn_time->time;
+    }
+
+    SnapdChange *old_change = g_hash_table_lookup (self->changes_by_id, id);
+    if (old_change == NULL) {
+        g_ptr_array_add (self->changes, g_object_ref (change));
+        if (self->changes->len > 1 && parse_id (snapd_change_get_id (g_ptr_array_index (self->changes, self->changes->len - 2))) > id_value)
+            g_ptr_array_sort (self->changes, compare_changes);
+        g_hash_table_insert (self->changes_by_id, (gpointer) id, change);
+        g_signal_emit (self, signals[SIGNAL_CHANGE_ADDED], 0, change);
+        return;
+    }
+
+    if (!change_changed (old_change, change))
+        return;
+
+    for (guint i = 0; i < self->changes->len; i++) {
+        if (g_ptr_array_index (self->changes, i) == old_change) {
+            g_ptr_array_index (self->changes, i) = g_object_ref (change);
+            break;
+        }
+    }
+    g_hash_table_replace (self->changes_by_id, (gpointer) id, change);
+    g_object_unref (old_change);
+    g_signal_emit (self, signals[SIGNAL_CHANGE_CHANGED], 0, change);
+}
+
+static void
+remove_change (SnapdChangeList *self, const gchar *id)
+{
+    SnapdChange *change = g_hash_table_lookup (self->changes_by_id, id);
+    if (change == NULL)
+        return;
+
+    g_autoptr(SnapdChange) removed = g_object_ref (change);
+    g_hash_table_remove (self->changes_by_id, id);
+    g_ptr_array_remove (self->changes, change);
+    g_signal_emit (self, signals[SIGNAL_CHANGE_REMOVED], 0, removed);
+}
+
+static void
+all_changes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdChangeList *self = g_task_get_source_object (task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_finish (SNAPD_CLIENT (object), result, &error);
+    if (changes == NULL) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+
+    /* Drop changes snapd has pruned */
+    g_autoptr(GHashTable) ids = g_hash_table_new (g_str_hash, g_str_equal);
+    for (guint i = 0; i < changes->len; i++)
+        g_hash_table_add (ids, (gpointer) snapd_change_get_id (g_ptr_array_index (changes, i)));
+    g_autoptr(GPtrArray) removed_ids = g_ptr_array_new_with_free_func (g_free);
+    for (guint i = 0; i < self->changes->len; i++) {
+        const gchar *id = snapd_change_get_id (g_ptr_array_index (self->changes, i));
+        if (!g_hash_table_contains (ids, id))
+            g_ptr_array_add (removed_ids, g_strdup (id));
+    }
+    for (guint i = 0; i < removed_ids->len; i++)
+        remove_change (self, g_ptr_array_index (removed_ids, i));
+
+    for (guint i = 0; i < changes->len; i++)
+        merge_change (self, g_ptr_array_index (changes, i));
+    self->have_changes = TRUE;
+
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+get_all_changes (GTask *task)
+{
+    SnapdChangeList *self = g_task_get_source_object (task);
+    snapd_client_get_changes_async (self->client, SNAPD_CHANGE_FILTER_ALL, NULL, g_task_get_cancellable (task), all_changes_cb, task);
+}
+
+static void fetch_next_change (GTask *task);
+
+static void
+change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdChangeList *self = g_task_get_source_object (task);
+    RefreshData *data = g_task_get_task_data (task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_get_change_finish (SNAPD_CLIENT (object), result, &error);
+    if (change != NULL)
+        merge_change (self, change);
+    else if (g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND)) {
+        /* Pruned, or past the newest change */
+        remove_change (self, data->id);
+        if (parse_id (data->id) > self->last_id) {
+            g_task_return_boolean (task, TRUE);
+            return;
+        }
+    }
+    else {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+
+    fetch_next_change (g_steal_pointer (&task));
+}
+
+/* Fetch the changes that need updating one at a time, then look for any after the last seen */
+static void
+fetch_next_change (GTask *task)
+{
+    SnapdChangeList *self = g_task_get_source_object (task);
+    RefreshData *data = g_task_get_task_data (task);
+
+    if (data->n_fetches >= MAX_CHANGE_FETCHES) {
+        get_all_changes (task);
+        return;
+    }
+    data->n_fetches++;
+
+    g_free (data->id);
+    data->id = g_queue_pop_head (&data->ids);
+    if (data->id == NULL)
+        data->id = g_strdup_printf ("%" G_GINT64_FORMAT, self->last_id + 1);
+    snapd_client_get_change_async (self->client, data->id, g_task_get_cancellable (task), change_cb, task);
+}
+
+static void
+in_progress_changes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdChangeList *self = g_task_get_source_object (task);
+    RefreshData *data = g_task_get_task_data (task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_finish (SNAPD_CLIENT (object), result, &error);
+    if (changes == NULL) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+
+    g_autoptr(GHashTable) in_progress = g_hash_table_new (g_str_hash, g_str_equal);
+    gint64 old_last_id = self->last_id;
+    for (guint i = 0; i < changes->len; i++) {
+        SnapdChange *change = g_ptr_array_index (changes, i);
+        g_hash_table_add (in_progress, (gpointer) snapd_change_get_id (change));
+        merge_change (self, change);
+    }
+
+    /* Changes that were in progress and have since completed */
+    for (guint i = 0; i < self->changes->len; i++) {
+        SnapdChange *change = g_ptr_array_index (self->changes, i);
+        if (!snapd_change_get_ready (change) && !g_hash_table_contains (in_progress, snapd_change_get_id (change)))
+            g_queue_push_tail (&data->ids, g_strdup (snapd_change_get_id (change)));
+    }
+
+    /* Changes that started and completed between in progress ones */
+    for (gint64 id = old_last_id + 1; id < self->last_id && g_queue_get_length (&data->ids) < MAX_CHANGE_FETCHES; id++) {
+        g_autofree gchar *id_string = g_strdup_printf ("%" G_GINT64_FORMAT, id);
+        if (!g_hash_table_contains (self->changes_by_id, id_string))
+            g_queue_push_tail (&data->ids, g_steal_pointer (&id_string));
+    }
+
+    if (g_queue_get_length (&data->ids) >= MAX_CHANGE_FETCHES)
+        get_all_changes (g_steal_pointer (&task));
+    else
+        fetch_next_change (g_steal_pointer (&task));
+}
+
+/**
+ * snapd_change_list_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create an object to hold changes. The list is empty until
+ * snapd_change_list_refresh_async() is called.
+ *
+ * Returns: a new #SnapdChangeList
+ *
+ * Since: 1.65
+ */
+SnapdChangeList *
+snapd_change_list_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdChangeList *self = g_object_new (SNAPD_TYPE_CHANGE_LIST, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+/**
+ * snapd_change_list_refresh_async:
+ * @list: a #SnapdChangeList.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the changes made since the last refresh and update the
+ * list. Signals are emitted for each difference before @callback is called.
+ *
+ * Since: 1.65
+ */
+void
+snapd_change_list_refresh_async (SnapdChangeList *self, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CHANGE_LIST (self));
+
+    GTask *task = g_task_new (self, cancellable, callback, user_data);
+    if (!self->have_changes) {
+        get_all_changes (task);
+        return;
+    }
+
+    RefreshData *data = g_slice_new0 (RefreshData);
+    g_queue_init (&data->ids);
+    g_task_set_task_data (task, data, (GDestroyNotify) refresh_data_free);
+    snapd_client_get_changes_async (self->client, SNAPD_CHANGE_FILTER_IN_PROGRESS, NULL, cancellable, in_progress_changes_cb, task);
+}
+
+/**
+ * snapd_change_list_refresh_finish:
+ * @list: a #SnapdChangeList.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_change_list_refresh_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_change_list_refresh_finish (SnapdChangeList *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_LIST (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_change_list_get_changes:
+ * @list: a #SnapdChangeList.
+ *
+ * Get the changes, in the order they were made.
+ *
+ * Returns: (transfer none) (element-type SnapdChange): an array of #SnapdChange.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_change_list_get_changes (SnapdChangeList *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_LIST (self), NULL);
+    return self->changes;
+}
+
+/**
+ * snapd_change_list_get_change:
+ * @list: a #SnapdChangeList.
+ * @id: ID of change to get.
+ *
+ * Get a change from the list.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdChange or %NULL if not in the list.
+ *
+ * Since: 1.65
+ */
+SnapdChange *
+snapd_change_list_get_change (SnapdChangeList *self, const gchar *id)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_LIST (self), NULL);
+    g_return_val_if_fail (id != NULL, NULL);
+    return g_hash_table_lookup (self->changes_by_id, id);
+}
+
+/**
+ * snapd_change_list_get_last_spawn_time:
+ * @list: a #SnapdChangeList.
+ *
+ * Get the time the most recent change in the list was started.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if no changes have been seen.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_change_list_get_last_spawn_time (SnapdChangeList *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_LIST (self), NULL);
+    return self->last_spawn_time;
+}
+
+static void
+snapd_change_list_finalize (GObject *object)
+{
+    SnapdChangeList *self = SNAPD_CHANGE_LIST (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->changes_by_id, g_hash_table_unref);
+    g_clear_pointer (&self->changes, g_ptr_array_unref);
+    g_clear_pointer (&self->last_spawn_time, g_date_time_unref);
+
+    G_OBJECT_CLASS (snapd_change_list_parent_class)->finalize (object);
+}
+
+static void
+snapd_change_list_class_init (SnapdChangeListClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_change_list_finalize;
+
+    /**
+     * SnapdChangeList::change-added:
+     * @list: a #SnapdChangeList.
+     * @change: the #SnapdChange that was added.
+     *
+     * Emitted when a refresh finds a change that was not previously in the list.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_CHANGE_ADDED] = g_signal_new ("change-added",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0,
+                                                 NULL, NULL,
+                                                 NULL,
+                                                 G_TYPE_NONE, 1, SNAPD_TYPE_CHANGE);
+
+    /**
+     * SnapdChangeList::change-removed:
+     * @list: a #SnapdChangeList.
+     * @change: the #SnapdChange that was removed.
+     *
+     * Emitted when a change in the list is no longer known to snapd.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_CHANGE_REMOVED] = g_signal_new ("change-removed",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0,
+                                                   NULL, NULL,
+                                                   NULL,
+                                                   G_TYPE_NONE, 1, SNAPD_TYPE_CHANGE);
+
+    /**
+     * SnapdChangeList::change-changed:
+     * @list: a #SnapdChangeList.
+     * @change: the new #SnapdChange.
+     *
+     * Emitted when the status or progress of a change in the list changes. The
+     * previous #SnapdChange object is replaced by @change.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_CHANGE_CHANGED] = g_signal_new ("change-changed",
+                                                   G_TYPE_FROM_CLASS (klass),
+                                                   G_SIGNAL_RUN_LAST,
+                                                   0,
+                                                   NULL, NULL,
+                                                   NULL,
+                                                   G_TYPE_NONE, 1, SNAPD_TYPE_CHANGE);
+}
+
+static void
+snapd_change_list_init (SnapdChangeList *self)
+{
+    self->changes = g_ptr_array_new_with_free_func (g_object_unref);
+    self->changes_by_id = g_hash_table_new (g_str_hash, g_str_equal);
+}
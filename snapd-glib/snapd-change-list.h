@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CHANGE_LIST_H__
+#define __SNAPD_CHANGE_LIST_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-change.h>
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CHANGE_LIST  (snapd_change_list_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdChangeList, snapd_change_list, SNAPD, CHANGE_LIST, GObject)
+
+SnapdChangeList *snapd_change_list_new                 (SnapdClient         *client);
+
+void             snapd_change_list_refresh_async       (SnapdChangeList     *list,
+                                                        GCancellable        *cancellable,
+                                                        GAsyncReadyCallback  callback,
+                                                        gpointer             user_data);
+gboolean         snapd_change_list_refresh_finish      (SnapdChangeList     *list,
+                                                        GAsyncResult        *result,
+                                                        GError             **error);
+
+GPtrArray       *snapd_change_list_get_changes         (SnapdChangeList     *list);
+
+SnapdChange     *snapd_change_list_get_change          (SnapdChangeList     *list,
+                                                        const gchar         *id);
+
+GDateTime       *snapd_change_list_get_last_spawn_time (SnapdChangeList     *list);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CHANGE_LIST_H__ */
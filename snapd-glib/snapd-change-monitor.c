@@ -0,0 +1,439 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-change-monitor.h"
+#include "snapd-change-private.h"
+
+/**
+ * SECTION: snapd-change-monitor
+ * @short_description: Share progress of changes between clients
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdChangeMonitor polls snapd for the progress of changes on behalf of
+ * everything in the process that is interested in them. Components that each
+ * have their own #SnapdClient, e.g. a shell plugin and a settings panel, can
+ * watch the same change with snapd_change_monitor_watch() and only one poll
+ * is made for it, with the result delivered to every watcher. The load on
+ * snapd grows with the number of changes being watched rather than the number
+ * of watchers.
+ *
+ * Use snapd_change_monitor_get_default() to get the monitor shared by the
+ * process. Watches must be made from the same thread.
+ */
+
+/**
+ * SnapdChangeMonitor:
+ *
+ * #SnapdChangeMonitor shares polls for the progress of changes.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdChangeMonitor
+{
+    GObject parent_instance;
+
+    /* Changes being polled, keyed by socket and change ID */
+    GHashTable *changes;
+
+    /* Watches by ID */
+    GHashTable *watches;
+    guint next_watch_id;
+};
+
+G_DEFINE_TYPE (SnapdChangeMonitor, snapd_change_monitor, G_TYPE_OBJECT)
+
+typedef struct
+{
+    int ref_count;
+
+    /* Monitor this change is polled by, or %NULL once no longer watched */
+    SnapdChangeMonitor *monitor;
+    gchar *key;
+    gchar *change_id;
+
+    /* Client to poll with, taken from the first watcher */
+    SnapdClient *client;
+    GMainContext *context;
+    GCancellable *cancellable;
+    GSource *poll_source;
+
+    /* Time until the next poll and the progress seen in the last one */
+    guint poll_interval;
+    guint progress_hash;
+
+    /* Last state seen */
+    SnapdChange *change;
+
+    /* IDs of watches on this change */
+    GArray *watch_ids;
+} ChangeData;
+
+typedef struct
+{
+    ChangeData *change_data;
+    SnapdChangeMonitorCallback callback;
+    gpointer user_data;
+    GDestroyNotify destroy_notify;
+} WatchData;
+
+static ChangeData *
+change_data_ref (ChangeData *data)
+{
+    data->ref_count++;
+    return data;
+}
+
+static void
+change_data_unref (ChangeData *data)
+{
+    if (--data->ref_count != 0)
+        return;
+
+    g_free (data->key);
+    g_free (data->change_id);
+    g_clear_object (&data->client);
+    g_clear_pointer (&data->context, g_main_context_unref);
+    g_clear_object (&data->cancellable);
+    g_clear_object (&data->change);
+    g_array_unref (data->watch_ids);
+    g_slice_free (ChangeData, data);
+}
+
+static void
+watch_data_free (WatchData *watch)
+{
+    if (watch->destroy_notify != NULL)
+        watch->destroy_notify (watch->user_data);
+    g_slice_free (WatchData, watch);
+}
+
+/* Stop polling a change that no longer has any watchers */
+static void
+stop_change (ChangeData *data)
+{
+    SnapdChangeMonitor *self = data->monitor;
+
+    if (self == NULL)
+        return;
+    data->monitor = NULL;
+
+    g_cancellable_cancel (data->cancellable);
+    if (data->poll_source != NULL)
+        g_source_destroy (data->poll_source);
+    g_clear_pointer (&data->poll_source, g_source_unref);
+    g_hash_table_remove (self->changes, data->key);
+}
+
+static void
+remove_watch (SnapdChangeMonitor *self, guint watch_id)
+{
+    WatchData *watch = g_hash_table_lookup (self->watches, GUINT_TO_POINTER (watch_id));
+    if (watch == NULL)
+        return;
+
+    ChangeData *data = change_data_ref (watch->change_data);
+    for (guint i = 0; i < data->watch_ids->len; i++) {
+        if (g_array_index (data->watch_ids, guint, i) == watch_id) {
+            g_array_remove_index (data->watch_ids, i);
+            break;
+        }
+    }
+    if (data->watch_ids->len == 0)
+        stop_change (data);
+    g_hash_table_remove (self->watches, GUINT_TO_POINTER (watch_id));
+    change_data_unref (data);
+}
+
+/* Call every watcher of a change, allowing for them removing watches while being called */
+static void
+notify_watches (ChangeData *data, SnapdChange *change, GError *error)
+{
+    SnapdChangeMonitor *self = data->monitor;
+    g_autoptr(GArray) watch_ids = g_array_sized_new (FALSE, FALSE, sizeof (guint), data->watch_ids->len);
+    g_array_append_vals (watch_ids, data->watch_ids->data, data->watch_ids->len);
+
+    for (guint i = 0; i < watch_ids->len && data->monitor != NULL; i++) {
+        WatchData *watch = g_hash_table_lookup (self->watches, GUINT_TO_POINTER (g_array_index (watch_ids, guint, i)));
+        if (watch != NULL && watch->change_data == data)
+            watch->callback (self, change, error, watch->user_data);
+    }
+}
+
+/* Remove all the watches on a change once it has completed */
+static void
+finish_change (ChangeData *data)
+{
+    SnapdChangeMonitor *self = data->monitor;
+
+    while (data->monitor != NULL && data->watch_ids->len > 0)
+        remove_watch (self, g_array_index (data->watch_ids, guint, 0));
+}
+
+static void send_poll (ChangeData *data);
+
+static gboolean
+poll_cb (gpointer user_data)
+{
+    ChangeData *data = user_data;
+
+    g_clear_pointer (&data->poll_source, g_source_unref);
+    send_poll (data);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_poll (ChangeData *data)
+{
+    data->poll_source = g_timeout_source_new (data->poll_interval);
+    g_source_set_callback (data->poll_source, poll_cb, data, NULL);
+    g_source_attach (data->poll_source, data->context);
+}
+
+static void
+get_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    ChangeData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_get_change_finish (SNAPD_CLIENT (object), result, &error);
+    if (data->monitor == NULL) {
+        change_data_unref (data);
+        return;
+    }
+
+    if (change == NULL) {
+        notify_watches (data, NULL, error);
+        finish_change (data);
+        change_data_unref (data);
+        return;
+    }
+
+    /* Only report when something has changed, backing off while nothing is */
+    guint progress_hash = _snapd_change_get_progress_hash (change);
+    gboolean changed = data->change == NULL || progress_hash != data->progress_hash || snapd_change_get_ready (change);
+    if (changed)
+        data->poll_interval = snapd_client_get_poll_interval (data->client);
+    else
+        data->poll_interval = MIN (data->poll_interval * 2, MAX (snapd_client_get_max_poll_interval (data->client), snapd_client_get_poll_interval (data->client)));
+    data->progress_hash = progress_hash;
+    g_set_object (&data->change, change);
+
+    if (changed)
+        notify_watches (data, change, NULL);
+
+    if (snapd_change_get_ready (change))
+        finish_change (data);
+    else if (data->monitor != NULL)
+        schedule_poll (data);
+
+    change_data_unref (data);
+}
+
+static void
+send_poll (ChangeData *data)
+{
+    snapd_client_get_change_async (data->client, data->change_id, data->cancellable, get_change_cb, change_data_ref (data));
+}
+
+typedef struct
+{
+    SnapdChangeMonitor *monitor;
+    guint watch_id;
+} InitialData;
+
+static void
+initial_data_free (InitialData *initial)
+{
+    g_object_unref (initial->monitor);
+    g_slice_free (InitialData, initial);
+}
+
+static gboolean
+initial_cb (gpointer user_data)
+{
+    InitialData *initial = user_data;
+
+    WatchData *watch = g_hash_table_lookup (initial->monitor->watches, GUINT_TO_POINTER (initial->watch_id));
+    if (watch != NULL && watch->change_data->change != NULL)
+        watch->callback (initial->monitor, watch->change_data->change, NULL, watch->user_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * snapd_change_monitor_get_default:
+ *
+ * Get the change monitor shared by the process.
+ *
+ * Returns: (transfer none): a #SnapdChangeMonitor
+ *
+ * Since: 1.65
+ */
+SnapdChangeMonitor *
+snapd_change_monitor_get_default (void)
+{
+    static SnapdChangeMonitor *default_monitor = NULL;
+
+    if (g_once_init_enter (&default_monitor)) {
+        SnapdChangeMonitor *monitor = g_object_new (SNAPD_TYPE_CHANGE_MONITOR, NULL);
+        g_once_init_leave (&default_monitor, monitor);
+    }
+
+    return default_monitor;
+}
+
+/**
+ * snapd_change_monitor_watch:
+ * @monitor: a #SnapdChangeMonitor.
+ * @client: a #SnapdClient to poll with.
+ * @change_id: the ID of the change to watch.
+ * @callback: (scope notified): function to call when the change progresses.
+ * @user_data: (closure): user data to pass to @callback.
+ * @destroy_notify: (allow-none): function to free @user_data or %NULL.
+ *
+ * Watch the progress of a change. @callback is called with the state of the
+ * change each time it progresses, including when it becomes ready. If the
+ * change is already being watched by another client connected to the same
+ * socket, @callback is first called with the last state seen.
+ *
+ * The watch is removed once the change is ready or if it can't be retrieved,
+ * after which @destroy_notify is called. Callbacks are made in the
+ * thread-default main context of the first watcher of the change.
+ *
+ * Returns: an ID to pass to snapd_change_monitor_unwatch().
+ *
+ * Since: 1.65
+ */
+guint
+snapd_change_monitor_watch (SnapdChangeMonitor *self, SnapdClient *client, const gchar *change_id,
+                            SnapdChangeMonitorCallback callback, gpointer user_data, GDestroyNotify destroy_notify)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_MONITOR (self), 0);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), 0);
+    g_return_val_if_fail (change_id != NULL, 0);
+    g_return_val_if_fail (callback != NULL, 0);
+
+    g_autofree gchar *key = g_strdup_printf ("%s\n%s", snapd_client_get_socket_path (client), change_id);
+    ChangeData *data = g_hash_table_lookup (self->changes, key);
+    gboolean new_change = data == NULL;
+    if (new_change) {
+        data = g_slice_new0 (ChangeData);
+        data->ref_count = 1;
+        data->monitor = self;
+        data->key = g_steal_pointer (&key);
+        data->change_id = g_strdup (change_id);
+        data->client = g_object_ref (client);
+        data->context = g_main_context_ref_thread_default ();
+        data->cancellable = g_cancellable_new ();
+        data->watch_ids = g_array_new (FALSE, FALSE, sizeof (guint));
+        g_hash_table_insert (self->changes, data->key, data);
+    }
+
+    WatchData *watch = g_slice_new0 (WatchData);
+    watch->change_data = data;
+    watch->callback = callback;
+    watch->user_data = user_data;
+    watch->destroy_notify = destroy_notify;
+
+    guint watch_id = self->next_watch_id++;
+    if (self->next_watch_id == 0)
+        self->next_watch_id = 1;
+    g_hash_table_insert (self->watches, GUINT_TO_POINTER (watch_id), watch);
+    g_array_append_val (data->watch_ids, watch_id);
+
+    if (new_change)
+        send_poll (data);
+    else if (data->change != NULL) {
+        InitialData *initial = g_slice_new0 (InitialData);
+        initial->monitor = g_object_ref (self);
+        initial->watch_id = watch_id;
+        g_autoptr(GSource) source = g_idle_source_new ();
+        g_source_set_callback (source, initial_cb, initial, (GDestroyNotify) initial_data_free);
+        g_source_attach (source, data->context);
+    }
+
+    return watch_id;
+}
+
+/**
+ * snapd_change_monitor_unwatch:
+ * @monitor: a #SnapdChangeMonitor.
+ * @watch_id: an ID returned from snapd_change_monitor_watch().
+ *
+ * Stop watching a change. Polling stops once nothing is watching the change.
+ * Does nothing if the watch has already been removed.
+ *
+ * Since: 1.65
+ */
+void
+snapd_change_monitor_unwatch (SnapdChangeMonitor *self, guint watch_id)
+{
+    g_return_if_fail (SNAPD_IS_CHANGE_MONITOR (self));
+    remove_watch (self, watch_id);
+}
+
+/**
+ * snapd_change_monitor_get_n_changes:
+ * @monitor: a #SnapdChangeMonitor.
+ *
+ * Get the number of changes being polled. This is the number of distinct
+ * changes being watched, regardless of how many watchers each has.
+ *
+ * Returns: the number of changes.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_change_monitor_get_n_changes (SnapdChangeMonitor *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_MONITOR (self), 0);
+    return g_hash_table_size (self->changes);
+}
+
+static void
+snapd_change_monitor_dispose (GObject *object)
+{
+    SnapdChangeMonitor *self = SNAPD_CHANGE_MONITOR (object);
+
+    g_autoptr(GList) watch_ids = g_hash_table_get_keys (self->watches);
+    for (GList *link = watch_ids; link != NULL; link = link->next)
+        remove_watch (self, GPOINTER_TO_UINT (link->data));
+
+    G_OBJECT_CLASS (snapd_change_monitor_parent_class)->dispose (object);
+}
+
+static void
+snapd_change_monitor_finalize (GObject *object)
+{
+    SnapdChangeMonitor *self = SNAPD_CHANGE_MONITOR (object);
+
+    g_clear_pointer (&self->changes, g_hash_table_unref);
+    g_clear_pointer (&self->watches, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_change_monitor_parent_class)->finalize (object);
+}
+
+static void
+snapd_change_monitor_class_init (SnapdChangeMonitorClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->dispose = snapd_change_monitor_dispose;
+    gobject_class->finalize = snapd_change_monitor_finalize;
+}
+
+static void
+snapd_change_monitor_init (SnapdChangeMonitor *self)
+{
+    self->changes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) change_data_unref);
+    self->watches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) watch_data_free);
+    self->next_watch_id = 1;
+}
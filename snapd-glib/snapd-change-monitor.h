@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CHANGE_MONITOR_H__
+#define __SNAPD_CHANGE_MONITOR_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+#include <snapd-glib/snapd-change.h>
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CHANGE_MONITOR  (snapd_change_monitor_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdChangeMonitor, snapd_change_monitor, SNAPD, CHANGE_MONITOR, GObject)
+
+/**
+ * SnapdChangeMonitorCallback:
+ * @monitor: a #SnapdChangeMonitor
+ * @change: (allow-none): the latest state of the change or %NULL if it could not be retrieved
+ * @error: (allow-none): the reason the change could not be retrieved or %NULL
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_change_monitor_watch().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdChangeMonitorCallback) (SnapdChangeMonitor *monitor, SnapdChange *change, GError *error, gpointer user_data);
+
+SnapdChangeMonitor *snapd_change_monitor_get_default   (void);
+
+guint               snapd_change_monitor_watch         (SnapdChangeMonitor         *monitor,
+                                                        SnapdClient                *client,
+                                                        const gchar                *change_id,
+                                                        SnapdChangeMonitorCallback  callback,
+                                                        gpointer                    user_data,
+                                                        GDestroyNotify              destroy_notify);
+
+void                snapd_change_monitor_unwatch       (SnapdChangeMonitor         *monitor,
+                                                        guint                       watch_id);
+
+guint               snapd_change_monitor_get_n_changes (SnapdChangeMonitor         *monitor);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CHANGE_MONITOR_H__ */
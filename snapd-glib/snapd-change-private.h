@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CHANGE_PRIVATE_H__
+#define __SNAPD_CHANGE_PRIVATE_H__
+
+#include "snapd-change.h"
+#include "snapd-timestamp.h"
+
+G_BEGIN_DECLS
+
+SnapdChange          *_snapd_change_new                 (const gchar    *id,
+                                                         const gchar    *kind,
+                                                         const gchar    *summary,
+                                                         const gchar    *status,
+                                                         GPtrArray      *tasks,
+                                                         gboolean        ready,
+                                                         SnapdTimestamp *spawn_time,
+                                                         SnapdTimestamp *ready_time,
+                                                         const gchar    *error);
+
+const SnapdTimestamp *_snapd_change_get_spawn_timestamp (SnapdChange *change);
+
+const SnapdTimestamp *_snapd_change_get_ready_timestamp (SnapdChange *change);
+
+guint                 _snapd_change_get_progress_hash   (SnapdChange *change);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CHANGE_PRIVATE_H__ */
@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-change-summary.h"
+
+/**
+ * SECTION: snapd-change-summary
+ * @short_description: Progress of a change for each snap
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdChangeSummary groups the tasks in a #SnapdChange by the snap they
+ * act on, e.g. for a refresh of many snaps. It is updated with the tasks that
+ * changed in each progress report, as given to a #SnapdProgressDeltaCallback,
+ * so the work done for each report doesn't depend on the size of the change.
+ *
+ * The snap a task acts on is taken from the first quoted name in its summary,
+ * which is how snapd describes tasks. Tasks that don't name a snap only count
+ * towards the progress of the whole change.
+ */
+
+/**
+ * SnapdChangeSummary:
+ *
+ * #SnapdChangeSummary holds the progress of a change for each snap.
+ *
+ * Since: 1.65
+ */
+
+/* Number of microseconds over which the progress rate is smoothed */
+#define RATE_SMOOTHING_TIME (5 * G_USEC_PER_SEC)
+
+/* Progress for one snap, or for the whole change */
+typedef struct
+{
+    gchar *name;
+    gint64 progress_done;
+    gint64 progress_total;
+    SnapdTask *current_task;
+
+    /* Smoothed progress per second and the progress when last sampled */
+    gdouble progress_rate;
+    gint64 sample_time;
+    gint64 sample_done;
+    GDateTime *estimated_ready_time;
+
+    /* TRUE if changed in the current update */
+    gboolean changed;
+} SnapProgress;
+
+/* What each task last added to its snap */
+typedef struct
+{
+    SnapProgress *snap;
+    gint64 progress_done;
+    gint64 progress_total;
+} TaskProgress;
+
+struct _SnapdChangeSummary
+{
+    GObject parent_instance;
+
+    /* Snaps in the order they were first seen and indexed by name */
+    GPtrArray *snaps;
+    GHashTable *snaps_by_name;
+
+    /* Progress of the whole change */
+    SnapProgress *change;
+
+    /* TaskProgress keyed by task ID */
+    GHashTable *tasks;
+};
+
+enum
+{
+    SIGNAL_SNAP_CHANGED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdChangeSummary, snapd_change_summary, G_TYPE_OBJECT)
+
+static SnapProgress *
+snap_progress_new (const gchar *name)
+{
+    SnapProgress *progress = g_slice_new0 (SnapProgress);
+    progress->name = g_strdup (name);
+    return progress;
+}
+
+static void
+snap_progress_free (SnapProgress *progress)
+{
+    g_free (progress->name);
+    g_clear_object (&progress->current_task);
+    g_clear_pointer (&progress->estimated_ready_time, g_date_time_unref);
+    g_slice_free (SnapProgress, progress);
+}
+
+static void
+task_progress_free (TaskProgress *progress)
+{
+    g_slice_free (TaskProgress, progress);
+}
+
+/* Get the snap name from a summary like 'Download snap "foo" (123) from channel "stable"'.
+ * Plugs and slots are quoted as "snap:name" */
+static gchar *
+get_task_snap_name (SnapdTask *task)
+{
+    const gchar *summary = snapd_task_get_summary (task);
+    const gchar *start = summary != NULL ? strchr (summary, '"') : NULL;
+    if (start == NULL)
+        return NULL;
+    start++;
+
+    gsize length = strcspn (start, "\":");
+    if (length == 0 || start[length] == '\0')
+        return NULL;
+
+    return g_strndup (start, length);
+}
+
+static SnapProgress *
+get_snap_progress (SnapdChangeSummary *self, SnapdTask *task)
+{
+    g_autofree gchar *name = get_task_snap_name (task);
+    if (name == NULL)
+        return NULL;
+
+    SnapProgress *progress = g_hash_table_lookup (self->snaps_by_name, name);
+    if (progress == NULL) {
+        progress = snap_progress_new (name);
+        g_ptr_array_add (self->snaps, progress);
+        g_hash_table_insert (self->snaps_by_name, progress->name, progress);
+    }
+
+    return progress;
+}
+
+/* Add the change in a task's progress, and follow the task currently being worked on */
+static void
+apply_task (SnapProgress *progress, SnapdTask *task, gint64 done_delta, gint64 total_delta)
+{
+    progress->progress_done += done_delta;
+    progress->progress_total += total_delta;
+
+    SnapdTask *current = progress->current_task;
+    if (g_strcmp0 (snapd_task_get_status (task), "Doing") == 0 ||
+        (current != NULL && g_strcmp0 (snapd_task_get_id (current), snapd_task_get_id (task)) == 0))
+        g_set_object (&progress->current_task, task);
+
+    progress->changed = TRUE;
+}
+
+/* Estimate when the snap will be done from how fast its progress has been increasing */
+static void
+update_estimate (SnapProgress *progress, gint64 now)
+{
+    gint64 elapsed = now - progress->sample_time;
+    if (progress->sample_time != 0 && elapsed > 0 && progress->progress_done >= progress->sample_done) {
+        /* Smooth exponentially, weighting each sample by the time it covers */
+        gdouble rate = (gdouble) (progress->progress_done - progress->sample_done) * G_USEC_PER_SEC / elapsed;
+        if (progress->progress_rate == 0)
+            progress->progress_rate = rate;
+        else
+            progress->progress_rate += (rate - progress->progress_rate) * elapsed / (elapsed + RATE_SMOOTHING_TIME);
+    }
+    progress->sample_time = now;
+    progress->sample_done = progress->progress_done;
+
+    g_clear_pointer (&progress->estimated_ready_time, g_date_time_unref);
+    if (progress->progress_rate > 0 && progress->progress_done < progress->progress_total) {
+        g_autoptr(GDateTime) utc_now = g_date_time_new_now_utc ();
+        progress->estimated_ready_time = g_date_time_add_seconds (utc_now, (progress->progress_total - progress->progress_done) / progress->progress_rate);
+    }
+}
+
+static SnapProgress *
+lookup_snap (SnapdChangeSummary *self, const gchar *snap)
+{
+    return snap != NULL ? g_hash_table_lookup (self->snaps_by_name, snap) : self->change;
+}
+
+/**
+ * snapd_change_summary_new:
+ *
+ * Create an empty summary. Call snapd_change_summary_update() with the tasks
+ * of a change and then with each set of tasks that changes.
+ *
+ * Returns: (transfer full): a new #SnapdChangeSummary.
+ *
+ * Since: 1.65
+ */
+SnapdChangeSummary *
+snapd_change_summary_new (void)
+{
+    return g_object_new (SNAPD_TYPE_CHANGE_SUMMARY, NULL);
+}
+
+/**
+ * snapd_change_summary_update:
+ * @summary: a #SnapdChangeSummary.
+ * @tasks: (element-type SnapdTask): tasks that are new or have changed, e.g. from snapd_change_get_tasks() or a #SnapdProgressDeltaCallback.
+ *
+ * Update the summary with the latest state of some tasks. Tasks are matched by
+ * ID, so passing a task that hasn't changed has no effect.
+ * #SnapdChangeSummary::snap-changed is emitted for each snap whose progress
+ * changed.
+ *
+ * Since: 1.65
+ */
+void
+snapd_change_summary_update (SnapdChangeSummary *self, GPtrArray *tasks)
+{
+    g_return_if_fail (SNAPD_IS_CHANGE_SUMMARY (self));
+    g_return_if_fail (tasks != NULL);
+
+    g_autoptr(GPtrArray) changed = g_ptr_array_new ();
+    for (guint i = 0; i < tasks->len; i++) {
+        SnapdTask *task = g_ptr_array_index (tasks, i);
+
+        TaskProgress *task_progress = g_hash_table_lookup (self->tasks, snapd_task_get_id (task));
+        if (task_progress == NULL) {
+            task_progress = g_slice_new0 (TaskProgress);
+            task_progress->snap = get_snap_progress (self, task);
+            g_hash_table_insert (self->tasks, g_strdup (snapd_task_get_id (task)), task_progress);
+        }
+
+        gint64 done_delta = snapd_task_get_progress_done (task) - task_progress->progress_done;
+        gint64 total_delta = snapd_task_get_progress_total (task) - task_progress->progress_total;
+        task_progress->progress_done = snapd_task_get_progress_done (task);
+        task_progress->progress_total = snapd_task_get_progress_total (task);
+
+        apply_task (self->change, task, done_delta, total_delta);
+        SnapProgress *snap = task_progress->snap;
+        if (snap != NULL) {
+            if (!snap->changed)
+                g_ptr_array_add (changed, snap);
+            apply_task (snap, task, done_delta, total_delta);
+        }
+    }
+
+    gint64 now = g_get_monotonic_time ();
+    if (self->change->changed) {
+        update_estimate (self->change, now);
+        self->change->changed = FALSE;
+    }
+    for (guint i = 0; i < changed->len; i++) {
+        SnapProgress *snap = g_ptr_array_index (changed, i);
+        update_estimate (snap, now);
+        snap->changed = FALSE;
+    }
+    for (guint i = 0; i < changed->len; i++) {
+        SnapProgress *snap = g_ptr_array_index (changed, i);
+        g_signal_emit (self, signals[SIGNAL_SNAP_CHANGED], 0, snap->name);
+    }
+}
+
+/**
+ * snapd_change_summary_get_snap_names:
+ * @summary: a #SnapdChangeSummary.
+ *
+ * Get the names of the snaps the change acts on, in the order their tasks were first seen.
+ *
+ * Returns: (transfer full): an array of snap names.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_change_summary_get_snap_names (SnapdChangeSummary *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_SUMMARY (self), NULL);
+
+    GStrv names = g_new0 (gchar *, self->snaps->len + 1);
+    for (guint i = 0; i < self->snaps->len; i++) {
+        SnapProgress *snap = g_ptr_array_index (self->snaps, i);
+        names[i] = g_strdup (snap->name);
+    }
+
+    return names;
+}
+
+/**
+ * snapd_change_summary_get_progress_done:
+ * @summary: a #SnapdChangeSummary.
+ * @snap: (allow-none): the name of a snap or %NULL for the whole change.
+ *
+ * Get the progress made on the tasks for a snap, the sum of
+ * snapd_task_get_progress_done() for each task.
+ *
+ * Returns: the progress done.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_change_summary_get_progress_done (SnapdChangeSummary *self, const gchar *snap)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_SUMMARY (self), 0);
+    SnapProgress *progress = lookup_snap (self, snap);
+    return progress != NULL ? progress->progress_done : 0;
+}
+
+/**
+ * snapd_change_summary_get_progress_total:
+ * @summary: a #SnapdChangeSummary.
+ * @snap: (allow-none): the name of a snap or %NULL for the whole change.
+ *
+ * Get the total progress of the tasks for a snap, the sum of
+ * snapd_task_get_progress_total() for each task.
+ *
+ * Returns: the total progress.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_change_summary_get_progress_total (SnapdChangeSummary *self, const gchar *snap)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_SUMMARY (self), 0);
+    SnapProgress *progress = lookup_snap (self, snap);
+    return progress != NULL ? progress->progress_total : 0;
+}
+
+/**
+ * snapd_change_summary_get_current_task:
+ * @summary: a #SnapdChangeSummary.
+ * @snap: (allow-none): the name of a snap or %NULL for the whole change.
+ *
+ * Get the task most recently seen in progress for a snap, i.e. the phase the
+ * snap is in, such as downloading or mounting. Once the task finishes, the
+ * latest state of it is returned until another task starts.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdTask or %NULL if no task has started.
+ *
+ * Since: 1.65
+ */
+SnapdTask *
+snapd_change_summary_get_current_task (SnapdChangeSummary *self, const gchar *snap)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_SUMMARY (self), NULL);
+    SnapProgress *progress = lookup_snap (self, snap);
+    return progress != NULL ? progress->current_task : NULL;
+}
+
+/**
+ * snapd_change_summary_get_estimated_ready_time:
+ * @summary: a #SnapdChangeSummary.
+ * @snap: (allow-none): the name of a snap or %NULL for the whole change.
+ *
+ * Get when the tasks for a snap are expected to complete, based on how fast
+ * their progress has increased between updates.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not known.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_change_summary_get_estimated_ready_time (SnapdChangeSummary *self, const gchar *snap)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE_SUMMARY (self), NULL);
+    SnapProgress *progress = lookup_snap (self, snap);
+    return progress != NULL ? progress->estimated_ready_time : NULL;
+}
+
+static void
+snapd_change_summary_finalize (GObject *object)
+{
+    SnapdChangeSummary *self = SNAPD_CHANGE_SUMMARY (object);
+
+    g_clear_pointer (&self->tasks, g_hash_table_unref);
+    g_clear_pointer (&self->snaps_by_name, g_hash_table_unref);
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    g_clear_pointer (&self->change, snap_progress_free);
+
+    G_OBJECT_CLASS (snapd_change_summary_parent_class)->finalize (object);
+}
+
+static void
+snapd_change_summary_class_init (SnapdChangeSummaryClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_change_summary_finalize;
+
+    /**
+     * SnapdChangeSummary::snap-changed:
+     * @summary: a #SnapdChangeSummary.
+     * @snap: the name of the snap.
+     *
+     * Emitted when an update changes the progress of a snap.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_SNAP_CHANGED] = g_signal_new ("snap-changed",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0,
+                                                 NULL, NULL,
+                                                 NULL,
+                                                 G_TYPE_NONE, 1, G_TYPE_STRING);
+}
+
+static void
+snapd_change_summary_init (SnapdChangeSummary *self)
+{
+    self->snaps = g_ptr_array_new_with_free_func ((GDestroyNotify) snap_progress_free);
+    self->snaps_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+    self->change = snap_progress_new (NULL);
+    self->tasks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) task_progress_free);
+}
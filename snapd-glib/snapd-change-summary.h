@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CHANGE_SUMMARY_H__
+#define __SNAPD_CHANGE_SUMMARY_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+#include <snapd-glib/snapd-task.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CHANGE_SUMMARY  (snapd_change_summary_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdChangeSummary, snapd_change_summary, SNAPD, CHANGE_SUMMARY, GObject)
+
+SnapdChangeSummary *snapd_change_summary_new                      (void);
+
+void                snapd_change_summary_update                   (SnapdChangeSummary *summary,
+                                                                   GPtrArray          *tasks);
+
+GStrv               snapd_change_summary_get_snap_names           (SnapdChangeSummary *summary);
+
+gint64              snapd_change_summary_get_progress_done        (SnapdChangeSummary *summary,
+                                                                   const gchar        *snap);
+
+gint64              snapd_change_summary_get_progress_total       (SnapdChangeSummary *summary,
+                                                                   const gchar        *snap);
+
+SnapdTask          *snapd_change_summary_get_current_task         (SnapdChangeSummary *summary,
+                                                                   const gchar        *snap);
+
+GDateTime          *snapd_change_summary_get_estimated_ready_time (SnapdChangeSummary *summary,
+                                                                   const gchar        *snap);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CHANGE_SUMMARY_H__ */
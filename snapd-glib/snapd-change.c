@@ -10,6 +10,9 @@
 #include <string.h>
 
 #include "snapd-change.h"
+#include "snapd-change-private.h"
+#include "snapd-serialize.h"
+#include "snapd-task-private.h"
 
 /**
  * SECTION: snapd-change
@@ -38,8 +41,8 @@ struct _SnapdChange
     gchar *status;
     GPtrArray *tasks;
     gboolean ready;
-    GDateTime *spawn_time;
-    GDateTime *ready_time;
+    SnapdTimestamp spawn_time;
+    SnapdTimestamp ready_time;
     gchar *error;
 };
 
@@ -59,6 +62,27 @@ enum
 
 G_DEFINE_TYPE (SnapdChange, snapd_change, G_TYPE_OBJECT)
 
+/* Create without going through properties, taking ownership of tasks and the contents of spawn_time and ready_time */
+SnapdChange *
+_snapd_change_new (const gchar *id, const gchar *kind, const gchar *summary, const gchar *status,
+                   GPtrArray *tasks, gboolean ready, SnapdTimestamp *spawn_time, SnapdTimestamp *ready_time,
+                   const gchar *error)
+{
+    SnapdChange *self = g_object_new (SNAPD_TYPE_CHANGE, NULL);
+
+    self->id = g_strdup (id);
+    self->kind = g_strdup (kind);
+    self->summary = g_strdup (summary);
+    self->status = g_strdup (status);
+    self->tasks = tasks;
+    self->ready = ready;
+    self->spawn_time = *spawn_time;
+    self->ready_time = *ready_time;
+    self->error = g_strdup (error);
+
+    return self;
+}
+
 /**
  * snapd_change_get_id:
  * @change: a #SnapdChange.
@@ -175,7 +199,25 @@ GDateTime *
 snapd_change_get_spawn_time (SnapdChange *self)
 {
     g_return_val_if_fail (SNAPD_IS_CHANGE (self), NULL);
-    return self->spawn_time;
+    return _snapd_timestamp_get_date_time (&self->spawn_time);
+}
+
+/**
+ * snapd_change_get_spawn_time_usec:
+ * @change: a #SnapdChange.
+ *
+ * Get the time this change started as a number, for sorting and comparing
+ * changes without creating a #GDateTime.
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if not set.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_change_get_spawn_time_usec (SnapdChange *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE (self), 0);
+    return _snapd_timestamp_get_time (&self->spawn_time);
 }
 
 /**
@@ -192,7 +234,25 @@ GDateTime *
 snapd_change_get_ready_time (SnapdChange *self)
 {
     g_return_val_if_fail (SNAPD_IS_CHANGE (self), NULL);
-    return self->ready_time;
+    return _snapd_timestamp_get_date_time (&self->ready_time);
+}
+
+/**
+ * snapd_change_get_ready_time_usec:
+ * @change: a #SnapdChange.
+ *
+ * Get the time this change completed as a number. See
+ * snapd_change_get_spawn_time_usec().
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if not yet completed.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_change_get_ready_time_usec (SnapdChange *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE (self), 0);
+    return _snapd_timestamp_get_time (&self->ready_time);
 }
 
 /**
@@ -212,6 +272,140 @@ snapd_change_get_error (SnapdChange *self)
     return self->error;
 }
 
+const SnapdTimestamp *
+_snapd_change_get_spawn_timestamp (SnapdChange *self)
+{
+    return &self->spawn_time;
+}
+
+const SnapdTimestamp *
+_snapd_change_get_ready_timestamp (SnapdChange *self)
+{
+    return &self->ready_time;
+}
+
+/* Get a value that changes whenever the tasks in a change make progress */
+guint
+_snapd_change_get_progress_hash (SnapdChange *self)
+{
+    guint hash = g_str_hash (self->status != NULL ? self->status : "");
+    for (guint i = 0; self->tasks != NULL && i < self->tasks->len; i++) {
+        SnapdTask *task = g_ptr_array_index (self->tasks, i);
+        const gchar *status = snapd_task_get_status (task);
+        hash = hash * 31 + g_str_hash (status != NULL ? status : "");
+        hash = hash * 31 + (guint) snapd_task_get_progress_done (task);
+    }
+
+    return hash;
+}
+
+#define TASK_TYPE "(msmsmsmsmsxx" SNAPD_SERIALIZED_DATE_TIME SNAPD_SERIALIZED_DATE_TIME ")"
+#define CHANGE_TYPE "(msmsmsmsb" SNAPD_SERIALIZED_DATE_TIME SNAPD_SERIALIZED_DATE_TIME "msa" TASK_TYPE ")"
+
+/**
+ * snapd_change_serialize:
+ * @change: a #SnapdChange.
+ *
+ * Serialize a change and its tasks to a compact binary form, so it can be
+ * stored or sent to another process and read back with
+ * snapd_change_deserialize().
+ *
+ * Returns: (transfer full): the serialized change.
+ *
+ * Since: 1.65
+ */
+GBytes *
+snapd_change_serialize (SnapdChange *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANGE (self), NULL);
+
+    GVariantBuilder tasks;
+    g_variant_builder_init (&tasks, G_VARIANT_TYPE ("a" TASK_TYPE));
+    for (guint i = 0; self->tasks != NULL && i < self->tasks->len; i++) {
+        SnapdTask *task = g_ptr_array_index (self->tasks, i);
+        g_variant_builder_add (&tasks, "(msmsmsmsmsxx@" SNAPD_SERIALIZED_DATE_TIME "@" SNAPD_SERIALIZED_DATE_TIME ")",
+                               snapd_task_get_id (task),
+                               snapd_task_get_kind (task),
+                               snapd_task_get_summary (task),
+                               snapd_task_get_status (task),
+                               snapd_task_get_progress_label (task),
+                               snapd_task_get_progress_done (task),
+                               snapd_task_get_progress_total (task),
+                               _snapd_serialize_timestamp (_snapd_task_get_spawn_timestamp (task)),
+                               _snapd_serialize_timestamp (_snapd_task_get_ready_timestamp (task)));
+    }
+
+    return _snapd_serialize_wrap ("change",
+                                  g_variant_new ("(msmsmsmsb@" SNAPD_SERIALIZED_DATE_TIME "@" SNAPD_SERIALIZED_DATE_TIME "ms@a" TASK_TYPE ")",
+                                                 self->id,
+                                                 self->kind,
+                                                 self->summary,
+                                                 self->status,
+                                                 self->ready,
+                                                 _snapd_serialize_timestamp (&self->spawn_time),
+                                                 _snapd_serialize_timestamp (&self->ready_time),
+                                                 self->error,
+                                                 g_variant_builder_end (&tasks)));
+}
+
+/**
+ * snapd_change_deserialize:
+ * @data: data written by snapd_change_serialize().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Read a change serialized with snapd_change_serialize().
+ *
+ * Returns: (transfer full): a #SnapdChange or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdChange *
+snapd_change_deserialize (GBytes *data, GError **error)
+{
+    g_return_val_if_fail (data != NULL, NULL);
+
+    g_autoptr(SnapdArena) arena = NULL;
+    g_autoptr(GVariant) value = _snapd_serialize_unwrap (data, "change", CHANGE_TYPE, &arena, error);
+    if (value == NULL)
+        return NULL;
+
+    SnapdReader reader;
+    _snapd_reader_init (&reader, value);
+    const gchar *id = _snapd_reader_get_string (&reader);
+    const gchar *kind = _snapd_reader_get_string (&reader);
+    const gchar *summary = _snapd_reader_get_string (&reader);
+    const gchar *status = _snapd_reader_get_string (&reader);
+    gboolean ready = _snapd_reader_get_boolean (&reader);
+    SnapdTimestamp spawn_time = { 0 }, ready_time = { 0 };
+    _snapd_reader_get_timestamp (&reader, &spawn_time);
+    _snapd_reader_get_timestamp (&reader, &ready_time);
+    const gchar *change_error = _snapd_reader_get_string (&reader);
+    g_autoptr(GVariant) tasks_value = _snapd_reader_get_value (&reader);
+
+    gsize n_tasks = g_variant_n_children (tasks_value);
+    GPtrArray *tasks = g_ptr_array_new_full (n_tasks, g_object_unref);
+    for (gsize i = 0; i < n_tasks; i++) {
+        g_autoptr(GVariant) task_value = g_variant_get_child_value (tasks_value, i);
+        SnapdReader task_reader;
+        _snapd_reader_init (&task_reader, task_value);
+        const gchar *task_id = _snapd_reader_get_string (&task_reader);
+        const gchar *task_kind = _snapd_reader_get_string (&task_reader);
+        const gchar *task_summary = _snapd_reader_get_string (&task_reader);
+        const gchar *task_status = _snapd_reader_get_string (&task_reader);
+        const gchar *progress_label = _snapd_reader_get_string (&task_reader);
+        gint64 progress_done = _snapd_reader_get_int64 (&task_reader);
+        gint64 progress_total = _snapd_reader_get_int64 (&task_reader);
+        SnapdTimestamp task_spawn_time = { 0 }, task_ready_time = { 0 };
+        _snapd_reader_get_timestamp (&task_reader, &task_spawn_time);
+        _snapd_reader_get_timestamp (&task_reader, &task_ready_time);
+        g_ptr_array_add (tasks, _snapd_task_new (task_id, task_kind, task_summary, task_status,
+                                                 progress_label, progress_done, progress_total,
+                                                 &task_spawn_time, &task_ready_time));
+    }
+
+    return _snapd_change_new (id, kind, summary, status, tasks, ready, &spawn_time, &ready_time, change_error);
+}
+
 static void
 snapd_change_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
 {
@@ -243,14 +437,10 @@ snapd_change_set_property (GObject *object, guint prop_id, const GValue *value,
         self->ready = g_value_get_boolean (value);
         break;
     case PROP_SPAWN_TIME:
-        g_clear_pointer (&self->spawn_time, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->spawn_time = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->spawn_time, g_value_get_boxed (value));
         break;
     case PROP_READY_TIME:
-        g_clear_pointer (&self->ready_time, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->ready_time = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->ready_time, g_value_get_boxed (value));
         break;
     case PROP_ERROR:
         g_free (self->error);
@@ -287,10 +477,10 @@ snapd_change_get_property (GObject *object, guint prop_id, GValue *value, GParam
         g_value_set_boolean (value, self->ready);
         break;
     case PROP_SPAWN_TIME:
-        g_value_set_boxed (value, self->spawn_time);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->spawn_time));
         break;
     case PROP_READY_TIME:
-        g_value_set_boxed (value, self->ready_time);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->ready_time));
         break;
     case PROP_ERROR:
         g_value_set_string (value, self->error);
@@ -311,8 +501,8 @@ snapd_change_finalize (GObject *object)
     g_clear_pointer (&self->summary, g_free);
     g_clear_pointer (&self->status, g_free);
     g_clear_pointer (&self->tasks, g_ptr_array_unref);
-    g_clear_pointer (&self->spawn_time, g_date_time_unref);
-    g_clear_pointer (&self->ready_time, g_date_time_unref);
+    _snapd_timestamp_clear (&self->spawn_time);
+    _snapd_timestamp_clear (&self->ready_time);
     g_clear_pointer (&self->error, g_free);
 
     G_OBJECT_CLASS (snapd_change_parent_class)->finalize (object);
@@ -22,23 +22,32 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (SnapdChange, snapd_change, SNAPD, CHANGE, GObject)
 
-const gchar *snapd_change_get_id         (SnapdChange *change);
+const gchar *snapd_change_get_id              (SnapdChange *change);
 
-const gchar *snapd_change_get_kind       (SnapdChange *change);
+const gchar *snapd_change_get_kind            (SnapdChange *change);
 
-const gchar *snapd_change_get_summary    (SnapdChange *change);
+const gchar *snapd_change_get_summary         (SnapdChange *change);
 
-const gchar *snapd_change_get_status     (SnapdChange *change);
+const gchar *snapd_change_get_status          (SnapdChange *change);
 
-gboolean     snapd_change_get_ready      (SnapdChange *change);
+gboolean     snapd_change_get_ready           (SnapdChange *change);
 
-GPtrArray   *snapd_change_get_tasks      (SnapdChange *change);
+GPtrArray   *snapd_change_get_tasks           (SnapdChange *change);
 
-GDateTime   *snapd_change_get_spawn_time (SnapdChange *change);
+GDateTime   *snapd_change_get_spawn_time      (SnapdChange *change);
 
-GDateTime   *snapd_change_get_ready_time (SnapdChange *change);
+gint64       snapd_change_get_spawn_time_usec (SnapdChange *change);
 
-const gchar *snapd_change_get_error      (SnapdChange *change);
+GDateTime   *snapd_change_get_ready_time      (SnapdChange *change);
+
+gint64       snapd_change_get_ready_time_usec (SnapdChange *change);
+
+const gchar *snapd_change_get_error           (SnapdChange *change);
+
+GBytes      *snapd_change_serialize           (SnapdChange *change);
+
+SnapdChange *snapd_change_deserialize         (GBytes      *data,
+                                               GError     **error);
 
 G_END_DECLS
 
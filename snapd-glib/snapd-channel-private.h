@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CHANNEL_PRIVATE_H__
+#define __SNAPD_CHANNEL_PRIVATE_H__
+
+#include "snapd-channel.h"
+#include "snapd-arena.h"
+#include "snapd-timestamp.h"
+
+G_BEGIN_DECLS
+
+SnapdChannel         *_snapd_channel_new                       (SnapdArena       *arena,
+                                                                SnapdConfinement  confinement,
+                                                                const gchar      *epoch,
+                                                                const gchar      *name,
+                                                                SnapdTimestamp   *released_at,
+                                                                const gchar      *revision,
+                                                                gint64            size,
+                                                                const gchar      *version);
+
+const SnapdTimestamp *_snapd_channel_get_released_at_timestamp (SnapdChannel *channel);
+
+gint                  _snapd_channel_get_risk_level            (SnapdChannel *channel);
+
+gsize                 _snapd_channel_get_memory_size           (SnapdChannel *channel);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CHANNEL_PRIVATE_H__ */
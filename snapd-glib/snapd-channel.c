@@ -7,8 +7,12 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <string.h>
+
 #include "snapd-channel.h"
+#include "snapd-channel-private.h"
 #include "snapd-enum-types.h"
+#include "snapd-memory.h"
 
 /**
  * SECTION:snapd-channel
@@ -32,16 +36,23 @@ struct _SnapdChannel
 {
     GObject parent_instance;
 
-    SnapdConfinement confinement;
+    /* The name, risk and track are interned, as the same values repeat across many snaps */
     gchar *branch;
     gchar *epoch;
-    gchar *name;
-    GDateTime *released_at;
+    const gchar *name;
+    SnapdTimestamp released_at;
     gchar *revision;
-    gchar *risk;
+    const gchar *risk;
     gint64 size;
-    gchar *track;
+    const gchar *track;
     gchar *version;
+
+    /* Packed, as large catalogs can hold tens of thousands of channels */
+    guint confinement : 8;
+    gint risk_level : 8;
+
+    /* Holds the strings if set by the parser, otherwise they are allocated separately */
+    SnapdArena *arena;
 };
 
 enum
@@ -152,7 +163,25 @@ GDateTime *
 snapd_channel_get_released_at (SnapdChannel *self)
 {
     g_return_val_if_fail (SNAPD_IS_CHANNEL (self), NULL);
-    return self->released_at;
+    return _snapd_timestamp_get_date_time (&self->released_at);
+}
+
+/**
+ * snapd_channel_get_released_at_usec:
+ * @channel: a #SnapdChannel.
+ *
+ * Get the date this revision was released into the channel as a number, for
+ * sorting and comparing channels without creating a #GDateTime.
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if unknown.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_channel_get_released_at_usec (SnapdChannel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CHANNEL (self), 0);
+    return _snapd_timestamp_get_time (&self->released_at);
 }
 
 /**
@@ -242,53 +271,122 @@ snapd_channel_get_version (SnapdChannel *self)
     return self->version;
 }
 
+/* Risks, from least to most risky */
+static const gchar *risks[] = { "stable", "candidate", "beta", "edge" };
+
+static gint
+parse_risk (const gchar *risk)
+{
+    for (gint i = 0; risk != NULL && i < (gint) G_N_ELEMENTS (risks); i++) {
+        if (strcmp (risk, risks[i]) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
 static gboolean
 is_risk (const gchar *risk)
 {
-    return g_strcmp0 (risk, "stable") == 0 || g_strcmp0 (risk, "candidate") == 0 || g_strcmp0 (risk, "beta") == 0 || g_strcmp0 (risk, "edge") == 0;
+    return parse_risk (risk) >= 0;
+}
+
+const SnapdTimestamp *
+_snapd_channel_get_released_at_timestamp (SnapdChannel *self)
+{
+    return &self->released_at;
+}
+
+gint
+_snapd_channel_get_risk_level (SnapdChannel *self)
+{
+    return self->risk_level;
+}
+
+/* The name, risk and track are interned so are not counted */
+gsize
+_snapd_channel_get_memory_size (SnapdChannel *self)
+{
+    return _snapd_memory_instance_size (self) +
+           _snapd_memory_string_size (self->branch) +
+           _snapd_memory_string_size (self->epoch) +
+           _snapd_memory_string_size (self->revision) +
+           _snapd_memory_string_size (self->version);
 }
 
 static void
 set_name (SnapdChannel *self, const gchar *name)
 {
-    g_free (self->name);
-    self->name = g_strdup (name);
+    self->name = g_intern_string (name);
 
-    g_clear_pointer (&self->track, g_free);
-    g_clear_pointer (&self->risk, g_free);
+    self->track = NULL;
+    self->risk = NULL;
+    self->risk_level = -1;
     g_clear_pointer (&self->branch, g_free);
 
+    if (name == NULL)
+        return;
+
     g_auto(GStrv) tokens = g_strsplit (name, "/", -1);
     switch (g_strv_length (tokens)) {
     case 1:
         if (is_risk (tokens[0])) {
-            self->track = g_strdup ("latest");
-            self->risk = g_strdup (tokens[0]);
+            self->track = g_intern_static_string ("latest");
+            self->risk = g_intern_string (tokens[0]);
         }
         else {
-            self->track = g_strdup (tokens[0]);
-            self->risk = g_strdup ("stable");
+            self->track = g_intern_string (tokens[0]);
+            self->risk = g_intern_static_string ("stable");
         }
         break;
     case 2:
         if (is_risk (tokens[0])) {
-            self->track = g_strdup ("latest");
-            self->risk = g_strdup (tokens[0]);
+            self->track = g_intern_static_string ("latest");
+            self->risk = g_intern_string (tokens[0]);
             self->branch = g_strdup (tokens[1]);
         }
         else {
-            self->track = g_strdup (tokens[0]);
-            self->risk = g_strdup (tokens[1]);
+            self->track = g_intern_string (tokens[0]);
+            self->risk = g_intern_string (tokens[1]);
         }
         break;
     case 3:
-        self->track = g_strdup (tokens[0]);
-        self->risk = g_strdup (tokens[1]);
+        self->track = g_intern_string (tokens[0]);
+        self->risk = g_intern_string (tokens[1]);
         self->branch = g_strdup (tokens[2]);
         break;
     default:
         break;
     }
+    self->risk_level = parse_risk (self->risk);
+}
+
+static gchar *
+copy_string (SnapdChannel *self, const gchar *value)
+{
+    return self->arena != NULL ? _snapd_arena_strdup (self->arena, value) : g_strdup (value);
+}
+
+/* Create without going through properties, taking ownership of the contents of released_at */
+SnapdChannel *
+_snapd_channel_new (SnapdArena *arena, SnapdConfinement confinement, const gchar *epoch, const gchar *name,
+                    SnapdTimestamp *released_at, const gchar *revision, gint64 size,
+                    const gchar *version)
+{
+    SnapdChannel *self = g_object_new (SNAPD_TYPE_CHANNEL, NULL);
+
+    if (arena != NULL)
+        self->arena = _snapd_arena_ref (arena);
+    self->confinement = confinement;
+    self->epoch = copy_string (self, epoch);
+    set_name (self, name);
+    if (released_at != NULL)
+        self->released_at = *released_at;
+    self->revision = copy_string (self, revision);
+    self->size = size;
+    self->version = copy_string (self, version);
+
+    return self;
 }
 
 static void
@@ -308,9 +406,7 @@ snapd_channel_set_property (GObject *object, guint prop_id, const GValue *value,
         set_name (self, g_value_get_string (value));
         break;
     case PROP_RELEASED_AT:
-        g_clear_pointer (&self->released_at, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->released_at = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->released_at, g_value_get_boxed (value));
         break;
     case PROP_REVISION:
         g_free (self->revision);
@@ -345,7 +441,7 @@ snapd_channel_get_property (GObject *object, guint prop_id, GValue *value, GPara
         g_value_set_string (value, self->name);
         break;
     case PROP_RELEASED_AT:
-        g_value_set_boxed (value, self->released_at);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->released_at));
         break;
     case PROP_REVISION:
         g_value_set_string (value, self->revision);
@@ -368,13 +464,14 @@ snapd_channel_finalize (GObject *object)
     SnapdChannel *self = SNAPD_CHANNEL (object);
 
     g_clear_pointer (&self->branch, g_free);
-    g_clear_pointer (&self->epoch, g_free);
-    g_clear_pointer (&self->name, g_free);
-    g_clear_pointer (&self->revision, g_free);
-    g_clear_pointer (&self->released_at, g_date_time_unref);
-    g_clear_pointer (&self->risk, g_free);
-    g_clear_pointer (&self->track, g_free);
-    g_clear_pointer (&self->version, g_free);
+    _snapd_timestamp_clear (&self->released_at);
+    if (self->arena != NULL)
+        g_clear_pointer (&self->arena, _snapd_arena_unref);
+    else {
+        g_free (self->epoch);
+        g_free (self->revision);
+        g_free (self->version);
+    }
 
     G_OBJECT_CLASS (snapd_channel_parent_class)->finalize (object);
 }
@@ -442,4 +539,5 @@ snapd_channel_class_init (SnapdChannelClass *klass)
 static void
 snapd_channel_init (SnapdChannel *self)
 {
+    self->risk_level = -1;
 }
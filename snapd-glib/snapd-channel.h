@@ -41,25 +41,27 @@ typedef enum
     SNAPD_CONFINEMENT_CLASSIC
 } SnapdConfinement;
 
-const gchar      *snapd_channel_get_branch      (SnapdChannel *channel);
+const gchar      *snapd_channel_get_branch           (SnapdChannel *channel);
 
-SnapdConfinement  snapd_channel_get_confinement (SnapdChannel *channel);
+SnapdConfinement  snapd_channel_get_confinement      (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_epoch       (SnapdChannel *channel);
+const gchar      *snapd_channel_get_epoch            (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_name        (SnapdChannel *channel);
+const gchar      *snapd_channel_get_name             (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_revision    (SnapdChannel *channel);
+const gchar      *snapd_channel_get_revision         (SnapdChannel *channel);
 
-GDateTime        *snapd_channel_get_released_at (SnapdChannel *channel);
+GDateTime        *snapd_channel_get_released_at      (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_risk        (SnapdChannel *channel);
+gint64            snapd_channel_get_released_at_usec (SnapdChannel *channel);
 
-gint64            snapd_channel_get_size        (SnapdChannel *channel);
+const gchar      *snapd_channel_get_risk             (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_track       (SnapdChannel *channel);
+gint64            snapd_channel_get_size             (SnapdChannel *channel);
 
-const gchar      *snapd_channel_get_version     (SnapdChannel *channel);
+const gchar      *snapd_channel_get_track            (SnapdChannel *channel);
+
+const gchar      *snapd_channel_get_version          (SnapdChannel *channel);
 
 G_END_DECLS
 
@@ -10,23 +10,48 @@
 #include "snapd-client.h"
 #include "snapd-error.h"
 
+#include "requests/snapd-request.h"
+
 typedef struct {
     GMainContext *context;
     GMainLoop    *loop;
     GAsyncResult *result;
 } SyncData;
 
+/* Context reused by sync calls made from each thread */
+static GPrivate sync_context = G_PRIVATE_INIT ((GDestroyNotify) g_main_context_unref);
+
+static GMainContext *
+get_sync_context (void)
+{
+    GMainContext *context = g_private_get (&sync_context);
+
+    if (context == NULL) {
+        context = g_main_context_new ();
+        g_private_set (&sync_context, context);
+    }
+
+    /* A sync call made from a callback of another one needs a context of its own,
+     * otherwise it would dispatch the outer call's sources */
+    if (g_main_context_get_thread_default () == context)
+        return g_main_context_new ();
+
+    return g_main_context_ref (context);
+}
+
 static void
 start_sync (SyncData *data)
 {
-    data->context = g_main_context_new ();
+    data->context = get_sync_context ();
     data->loop = g_main_loop_new (data->context, FALSE);
     g_main_context_push_thread_default (data->context);
+    _snapd_request_set_making_sync_requests (TRUE);
 }
 
 static void
 end_sync (SyncData *data)
 {
+    _snapd_request_set_making_sync_requests (FALSE);
     if (data->loop != NULL)
         g_main_loop_run (data->loop);
     g_main_context_pop_thread_default (data->context);
@@ -70,6 +95,39 @@ snapd_client_connect_sync (SnapdClient *self,
     return TRUE;
 }
 
+/**
+ * snapd_client_prepare_sync:
+ * @client: a #SnapdClient
+ * @cancellable: (allow-none): a #GCancellable or %NULL
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Open connections to snapd, up to the number set with
+ * snapd_client_set_max_connections(). snapd-glib connects on demand, so this
+ * is not required, but calling it at startup means the first requests don't
+ * wait for the connection to be made (and for snapd to be started if it is
+ * socket activated).
+ *
+ * Connections not being used by a request are watched in the I/O thread, or
+ * otherwise the thread-default main context, and are dropped if snapd closes
+ * them so later requests don't try to use them.
+ *
+ * Returns: %TRUE if the connections to snapd were opened.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_prepare_sync (SnapdClient *self,
+                           GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_prepare_async (self, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_prepare_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_login_sync:
  * @client: a #SnapdClient.
@@ -196,6 +254,72 @@ snapd_client_get_changes_sync (SnapdClient *self,
     return snapd_client_get_changes_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_get_changes_model_sync:
+ * @client: a #SnapdClient.
+ * @filter: changes to filter on.
+ * @snap_name: (allow-none): name of snap to filter on or %NULL for changes for any snap.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get changes that have occurred / are occurring on the snap daemon as a list
+ * model. This is the same as snapd_client_get_changes_sync(), but language
+ * bindings only convert the changes that are accessed.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdChange or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_get_changes_model_sync (SnapdClient *self,
+                                     SnapdChangeFilter filter, const gchar *snap_name,
+                                     GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_changes_async (self, filter, snap_name, cancellable, sync_cb, &data);
+    end_sync (&data);
+
+    return snapd_client_get_changes_model_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_changes_stream_sync:
+ * @client: a #SnapdClient.
+ * @filter: changes to filter on.
+ * @snap_name: (allow-none): name of snap to filter on or %NULL for changes for any snap.
+ * @change_callback: (scope call): function to call with each change as it is parsed.
+ * @change_callback_data: (closure): user data to pass to @change_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get changes that have occurred / are occurring on the snap daemon, passing
+ * each change to @change_callback as it is parsed rather than collecting them
+ * into an array. If the request fails, changes may have already been passed
+ * to @change_callback.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_changes_stream_sync (SnapdClient *self,
+                                      SnapdChangeFilter filter, const gchar *snap_name,
+                                      SnapdChangeCallback change_callback, gpointer change_callback_data,
+                                      GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_changes_stream_async (self, filter, snap_name, change_callback, change_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+
+    return snapd_client_get_changes_stream_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_get_change_sync:
  * @client: a #SnapdClient.
@@ -254,6 +378,38 @@ snapd_client_abort_change_sync (SnapdClient *self,
     return snapd_client_abort_change_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_get_notices_sync:
+ * @client: a #SnapdClient.
+ * @since_date_time: (allow-none): only get notices reported after this time or %NULL for all notices.
+ * @timeout: number of milliseconds to wait for a notice if there are none, or 0 to return immediately.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get notices of events that have occurred on the snap daemon, e.g. changes
+ * being updated. If @timeout is non-zero and there are no notices then wait
+ * up to that long for one to occur. To continually watch for notices use a
+ * #SnapdNoticesMonitor.
+ *
+ * Returns: (transfer container) (element-type SnapdNotice): an array of #SnapdNotice or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_notices_sync (SnapdClient *self,
+                               GDateTime *since_date_time, guint timeout,
+                               GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_notices_async (self, since_date_time, timeout, cancellable, sync_cb, &data);
+    end_sync (&data);
+
+    return snapd_client_get_notices_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_get_system_information_sync:
  * @client: a #SnapdClient.
@@ -391,6 +547,132 @@ snapd_client_set_snap_conf_sync (SnapdClient *self,
     return snapd_client_set_snap_conf_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_get_snap_config_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get configuration for a snap, as with snapd_client_get_snap_conf_sync().
+ * The values are only converted when read from the returned #SnapdSnapConfig,
+ * so single values can be read from a large configuration cheaply.
+ *
+ * Returns: (transfer full): a #SnapdSnapConfig or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdSnapConfig *
+snapd_client_get_snap_config_sync (SnapdClient *self,
+                                   const gchar *name,
+                                   GStrv keys,
+                                   GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snap_config_async (self, name, keys, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snap_config_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_snap_configs_sync:
+ * @client: a #SnapdClient.
+ * @names: names of snaps to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get configuration for many snaps. The requests for each snap are sent
+ * together so they are pipelined.
+ *
+ * Returns: (transfer container) (element-type utf8 SnapdSnapConfig): a table of configuration by snap name or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_client_get_snap_configs_sync (SnapdClient *self,
+                                    GStrv names,
+                                    GStrv keys,
+                                    GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (names != NULL && names[0] != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snap_configs_async (self, names, keys, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snap_configs_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_update_snap_conf_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to set configuration for.
+ * @key_values: (element-type utf8 GVariant): Keys to set.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Set configuration for a snap, only sending the values that are different
+ * to the current ones. If nothing has changed no change is made in snapd, so
+ * the snap's configure hook is not run.
+ *
+ * Returns: %TRUE if configuration successfully applied.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_update_snap_conf_sync (SnapdClient *self,
+                                    const gchar *name,
+                                    GHashTable *key_values,
+                                    GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (name != NULL, FALSE);
+    g_return_val_if_fail (key_values != NULL, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_update_snap_conf_async (self, name, key_values, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_update_snap_conf_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_update_snap_confs_sync:
+ * @client: a #SnapdClient.
+ * @confs: (element-type utf8 GLib.HashTable): tables of keys to set by snap name.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Set configuration for many snaps, as with
+ * snapd_client_update_snap_conf_sync(). The requests for each snap are sent
+ * together so they are pipelined. All snaps are updated even if some fail.
+ *
+ * Returns: %TRUE if configuration successfully applied to all snaps, otherwise %FALSE with the first error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_update_snap_confs_sync (SnapdClient *self,
+                                     GHashTable *confs,
+                                     GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (confs != NULL, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_update_snap_confs_async (self, confs, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_update_snap_confs_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_get_apps_sync:
  * @client: a #SnapdClient.
@@ -443,151 +725,539 @@ snapd_client_get_apps2_sync (SnapdClient *self,
 }
 
 /**
- * snapd_client_get_icon_sync:
+ * snapd_client_get_apps2_model_sync:
  * @client: a #SnapdClient.
- * @name: name of snap to get icon for.
+ * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
+ * @snaps: (allow-none): A list of snap names to return results for. If %NULL or empty then apps for all installed snaps are returned.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get the icon for an installed snap.
+ * Get information on installed apps as a list model. This is the same as
+ * snapd_client_get_apps2_sync(), but language bindings only convert the apps
+ * that are accessed.
  *
- * Returns: (transfer full): a #SnapdIcon or %NULL on error.
+ * Returns: (transfer full): a #SnapdResultList of #SnapdApp or %NULL on error.
  *
- * Since: 1.0
+ * Since: 1.65
  */
-SnapdIcon *
-snapd_client_get_icon_sync (SnapdClient *self,
-                            const gchar *name,
-                            GCancellable *cancellable, GError **error)
+SnapdResultList *
+snapd_client_get_apps2_model_sync (SnapdClient *self,
+                                   SnapdGetAppsFlags flags,
+                                   GStrv snaps,
+                                   GCancellable *cancellable, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-    snapd_client_get_icon_async (self, name, cancellable, sync_cb, &data);
+    snapd_client_get_apps2_async (self, flags, snaps, cancellable, sync_cb, &data);
     end_sync (&data);
-    return snapd_client_get_icon_finish (self, data.result, error);
+    return snapd_client_get_apps2_model_finish (self, data.result, error);
 }
 
 /**
- * snapd_client_list_sync:
+ * snapd_client_control_services_sync:
  * @client: a #SnapdClient.
+ * @action: the #SnapdServiceAction to apply.
+ * @flags: a set of #SnapdControlServicesFlags to control how the services are changed.
+ * @names: names of snaps or apps in the form snap.app to change the services of.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get information on all installed snaps.
+ * Start, stop or restart the services in many snaps as a single change.
+ * Naming a snap selects all of its services.
+ * Once done the services are fetched again, as for snapd_client_get_apps2_sync().
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp with the new state of the services or %NULL on error.
  *
- * Since: 1.0
- * Deprecated: 1.42: Use snapd_client_get_snaps_sync()
+ * Since: 1.65
  */
 GPtrArray *
-snapd_client_list_sync (SnapdClient *self,
-                        GCancellable *cancellable, GError **error)
+snapd_client_control_services_sync (SnapdClient *self,
+                                    SnapdServiceAction action, SnapdControlServicesFlags flags,
+                                    GStrv names,
+                                    SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                    GCancellable *cancellable, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    snapd_client_list_async (self, cancellable, sync_cb, &data);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    snapd_client_control_services_async (self, action, flags, names, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
     end_sync (&data);
-
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    return snapd_client_list_finish (self, data.result, error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    return snapd_client_control_services_finish (self, data.result, error);
 }
 
 /**
- * snapd_client_get_snaps_sync:
+ * snapd_client_get_logs_sync:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
- * @names: (allow-none): A list of snap names or %NULL.
+ * @names: (allow-none): a list of snap or app names to get logs for. If %NULL or empty then logs for all services are returned.
+ * @n: number of log entries to get, -1 for all of them or 0 for the snapd default.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get information on installed snaps (snaps with status %SNAPD_SNAP_STATUS_ACTIVE).
- * If @flags contains %SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE then also return snaps
- * with status %SNAPD_SNAP_STATUS_INSTALLED.
- *
- * If @names is not %NULL and contains at least one name only snaps that match these names are
- * returned. If a snap is not installed it is not returned (no error is generated).
+ * Get the most recent log entries written by services.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdLog): an array of #SnapdLog or %NULL on error.
  *
- * Since: 1.42
+ * Since: 1.65
  */
 GPtrArray *
-snapd_client_get_snaps_sync (SnapdClient *self,
-                             SnapdGetSnapsFlags flags, GStrv names,
-                             GCancellable *cancellable, GError **error)
+snapd_client_get_logs_sync (SnapdClient *self,
+                            GStrv names, gint n,
+                            GCancellable *cancellable, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-    snapd_client_get_snaps_async (self, flags, names, cancellable, sync_cb, &data);
+    snapd_client_get_logs_async (self, names, n, cancellable, sync_cb, &data);
     end_sync (&data);
-    return snapd_client_get_snaps_finish (self, data.result, error);
+    return snapd_client_get_logs_finish (self, data.result, error);
 }
 
 /**
- * snapd_client_get_assertions_sync:
+ * snapd_client_follow_logs_sync:
  * @client: a #SnapdClient.
- * @type: assertion type to get.
+ * @names: (allow-none): a list of snap or app names to get logs for. If %NULL or empty then logs for all services are returned.
+ * @n: number of existing log entries to get before following, -1 for all of them or 0 for the snapd default.
+ * @log_callback: (scope call): function to call with each log entry as it is received.
+ * @log_callback_data: (closure): user data to pass to @log_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get assertions.
+ * Follow the logs written by services, passing each entry to @log_callback
+ * as soon as it has been received. snapd keeps sending entries until the
+ * request is cancelled with @cancellable, so this only returns on error or
+ * cancellation.
  *
- * Returns: (transfer full) (array zero-terminated=1): an array of assertions or %NULL on error.
+ * Each followed log uses a connection to itself, and only the entry currently
+ * being received is kept in memory. If entries arrive faster than
+ * @log_callback is called, reading stops until it has caught up.
  *
- * Since: 1.8
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
  */
-GStrv
-snapd_client_get_assertions_sync (SnapdClient *self,
-                                  const gchar *type,
-                                  GCancellable *cancellable, GError **error)
+gboolean
+snapd_client_follow_logs_sync (SnapdClient *self,
+                               GStrv names, gint n,
+                               SnapdLogCallback log_callback, gpointer log_callback_data,
+                               GCancellable *cancellable, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-    snapd_client_get_assertions_async (self, type, cancellable, sync_cb, &data);
+    snapd_client_follow_logs_async (self, names, n, log_callback, log_callback_data, cancellable, sync_cb, &data);
     end_sync (&data);
-    return snapd_client_get_assertions_finish (self, data.result, error);
+
+    return snapd_client_follow_logs_finish (self, data.result, error);
 }
 
 /**
- * snapd_client_add_assertions_sync:
+ * snapd_client_get_icon_sync:
  * @client: a #SnapdClient.
- * @assertions: assertions to add.
+ * @name: name of snap to get icon for.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Add an assertion.
+ * Get the icon for an installed snap.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer full): a #SnapdIcon or %NULL on error.
  *
- * Since: 1.8
+ * Since: 1.0
  */
-gboolean
-snapd_client_add_assertions_sync (SnapdClient *self,
-                                  GStrv assertions,
-                                  GCancellable *cancellable, GError **error)
+SnapdIcon *
+snapd_client_get_icon_sync (SnapdClient *self,
+                            const gchar *name,
+                            GCancellable *cancellable, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (assertions != NULL, FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-    snapd_client_add_assertions_async (self, assertions, cancellable, sync_cb, &data);
+    snapd_client_get_icon_async (self, name, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_icon_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_icons_sync:
+ * @client: a #SnapdClient.
+ * @names: names of snaps to get icons for.
+ * @max_parallel: maximum number of icons to request at once, or 0 for one per connection.
+ * @icon_callback: (scope call): function to call with each icon as it is retrieved.
+ * @icon_callback_data: (closure): user data to pass to @icon_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get the icons for many installed snaps. Icons are requested in parallel
+ * on the connections allowed by snapd_client_set_max_connections(), and
+ * @icon_callback is called for each snap as soon as its icon is retrieved
+ * or fails.
+ *
+ * Returns: %TRUE if all icons were retrieved.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_icons_sync (SnapdClient *self,
+                             GStrv names, guint max_parallel,
+                             SnapdIconCallback icon_callback, gpointer icon_callback_data,
+                             GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_icons_async (self, names, max_parallel, icon_callback, icon_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_icons_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_icon2_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get icon for.
+ * @revision: (allow-none): revision of the snap that is installed or %NULL if not known.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get the icon for an installed snap. If an icon cache is set with
+ * snapd_client_set_icon_cache_path() and @revision is provided, a stored icon
+ * for that revision is used rather than asking snapd.
+ *
+ * Returns: (transfer full): a #SnapdIcon or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdIcon *
+snapd_client_get_icon2_sync (SnapdClient *self,
+                             const gchar *name, const gchar *revision,
+                             GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_icon2_async (self, name, revision, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_icon2_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_list_sync:
+ * @client: a #SnapdClient.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get information on all installed snaps.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.0
+ * Deprecated: 1.42: Use snapd_client_get_snaps_sync()
+ */
+GPtrArray *
+snapd_client_list_sync (SnapdClient *self,
+                        GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    snapd_client_list_async (self, cancellable, sync_cb, &data);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    end_sync (&data);
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    return snapd_client_list_finish (self, data.result, error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+}
+
+/**
+ * snapd_client_get_snaps_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get information on installed snaps (snaps with status %SNAPD_SNAP_STATUS_ACTIVE).
+ * If @flags contains %SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE then also return snaps
+ * with status %SNAPD_SNAP_STATUS_INSTALLED.
+ *
+ * If @names is not %NULL and contains at least one name only snaps that match these names are
+ * returned. If a snap is not installed it is not returned (no error is generated).
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.42
+ */
+GPtrArray *
+snapd_client_get_snaps_sync (SnapdClient *self,
+                             SnapdGetSnapsFlags flags, GStrv names,
+                             GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snaps_async (self, flags, names, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snaps_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_snaps_model_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get information on installed snaps as a list model. This is the same as
+ * snapd_client_get_snaps_sync(), but language bindings only convert the snaps
+ * that are accessed.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_get_snaps_model_sync (SnapdClient *self,
+                                   SnapdGetSnapsFlags flags, GStrv names,
+                                   GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snaps_async (self, flags, names, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snaps_model_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_snaps_with_fields_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names or %NULL.
+ * @fields: a set of #SnapdSnapFields to set in the returned snaps.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get information on installed snaps, only setting the snap fields in @fields.
+ * This is faster than snapd_client_get_snaps_sync() when only a few fields are
+ * needed. See snapd_client_get_snaps_sync() for the snaps returned.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_snaps_with_fields_sync (SnapdClient *self,
+                                         SnapdGetSnapsFlags flags, GStrv names,
+                                         SnapdSnapFields fields,
+                                         GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snaps_with_fields_async (self, flags, names, fields, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snaps_with_fields_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_snaps_stream_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names or %NULL.
+ * @snap_callback: (scope call): function to call with each snap as it is parsed.
+ * @snap_callback_data: (closure): user data to pass to @snap_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get information on installed snaps, passing each snap to @snap_callback as
+ * it is parsed rather than collecting them into an array. See
+ * snapd_client_get_snaps_sync() for the snaps returned. If the request fails,
+ * snaps may have already been passed to @snap_callback.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_snaps_stream_sync (SnapdClient *self,
+                                    SnapdGetSnapsFlags flags, GStrv names,
+                                    SnapdSnapCallback snap_callback, gpointer snap_callback_data,
+                                    GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_snaps_stream_async (self, flags, names, snap_callback, snap_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_snaps_stream_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_assertions_sync:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get assertions.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): an array of assertions or %NULL on error.
+ *
+ * Since: 1.8
+ */
+GStrv
+snapd_client_get_assertions_sync (SnapdClient *self,
+                                  const gchar *type,
+                                  GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_assertions_async (self, type, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_assertions_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_assertions_bytes_sync:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get assertions, in the same way as snapd_client_get_assertions_sync().
+ * Each assertion is a slice of the response from snapd, so no copies are
+ * made. The assertions are not nul-terminated.
+ *
+ * Returns: (transfer container) (element-type GBytes): an array of assertions or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_assertions_bytes_sync (SnapdClient *self,
+                                        const gchar *type,
+                                        GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_assertions_bytes_async (self, type, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_get_assertions_bytes_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_get_assertions_stream_sync:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @assertion_callback: (scope call): function to call with each assertion as it is received.
+ * @assertion_callback_data: (closure): user data to pass to @assertion_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get assertions, passing each one to @assertion_callback as soon as it has
+ * been received rather than waiting for the whole response. Only the
+ * assertion currently being received is kept in memory, so this is suitable
+ * for exporting large numbers of assertions. If the request fails, assertions
+ * may have already been passed to @assertion_callback.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_assertions_stream_sync (SnapdClient *self,
+                                         const gchar *type,
+                                         SnapdAssertionCallback assertion_callback, gpointer assertion_callback_data,
+                                         GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_get_assertions_stream_async (self, type, assertion_callback, assertion_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+
+    return snapd_client_get_assertions_stream_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_add_assertions_sync:
+ * @client: a #SnapdClient.
+ * @assertions: assertions to add.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Add an assertion.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.8
+ */
+gboolean
+snapd_client_add_assertions_sync (SnapdClient *self,
+                                  GStrv assertions,
+                                  GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (assertions != NULL, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_add_assertions_async (self, assertions, cancellable, sync_cb, &data);
     end_sync (&data);
     return snapd_client_add_assertions_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_add_assertions_stream_sync:
+ * @client: a #SnapdClient.
+ * @stream: a #GInputStream containing the assertions to add.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Add assertions read from @stream, which contains assertions in the same
+ * format returned by snapd_client_get_assertions_sync(), separated by blank
+ * lines. The stream is sent to snapd as it is read, so the assertions don't
+ * need to be held in memory.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_add_assertions_stream_sync (SnapdClient *self,
+                                         GInputStream *stream,
+                                         GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_add_assertions_stream_async (self, stream, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_add_assertions_stream_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_get_interfaces_sync:
  * @client: a #SnapdClient.
@@ -790,6 +1460,78 @@ snapd_client_disconnect_interface_sync (SnapdClient *self,
     return snapd_client_disconnect_interface_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_connect_interfaces_sync:
+ * @client: a #SnapdClient.
+ * @plugs: (element-type SnapdPlugRef): plugs to connect.
+ * @slots: (element-type SnapdSlotRef): slots to connect each plug to.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Connect many plugs and slots, where the plug at each index in @plugs is
+ * connected to the slot at the same index in @slots.
+ *
+ * snapd only connects one plug and slot per change and refuses to start a
+ * change for a snap that already has one in progress, so pairs involving
+ * different snaps are connected in parallel and the rest are sent as soon as
+ * the snaps they involve are free. @progress_callback is given a single change
+ * containing the tasks of all the changes made.
+ *
+ * All pairs are attempted even if some fail.
+ *
+ * Returns: %TRUE if all the plugs were connected, otherwise %FALSE with the first error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_connect_interfaces_sync (SnapdClient *self,
+                                      GPtrArray *plugs, GPtrArray *slots,
+                                      SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                      GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_connect_interfaces_async (self, plugs, slots, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_connect_interfaces_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_disconnect_interfaces_sync:
+ * @client: a #SnapdClient.
+ * @plugs: (element-type SnapdPlugRef): plugs to disconnect.
+ * @slots: (element-type SnapdSlotRef): slots to disconnect each plug from.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Disconnect many plugs and slots. See snapd_client_connect_interfaces_sync()
+ * for how the requests are sent.
+ *
+ * Returns: %TRUE if all the plugs were disconnected, otherwise %FALSE with the first error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_disconnect_interfaces_sync (SnapdClient *self,
+                                         GPtrArray *plugs, GPtrArray *slots,
+                                         SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                         GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_disconnect_interfaces_async (self, plugs, slots, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_disconnect_interfaces_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_find_sync:
  * @client: a #SnapdClient.
@@ -845,6 +1587,188 @@ snapd_client_find_section_sync (SnapdClient *self,
     return snapd_client_find_section_finish (self, data.result, suggested_currency, error);
 }
 
+/**
+ * snapd_client_find_section_model_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Find snaps in the store as a list model. This is the same as
+ * snapd_client_find_section_sync(), but language bindings only convert the
+ * snaps that are accessed.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_find_section_model_sync (SnapdClient *self,
+                                      SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                      gchar **suggested_currency,
+                                      GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_find_section_async (self, flags, section, query, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_find_model_finish (self, data.result, suggested_currency, error);
+}
+
+/**
+ * snapd_client_find_with_fields_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @fields: a set of #SnapdSnapFields to set in the returned snaps.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Find snaps in the store, only setting the snap fields in @fields.
+ * This is faster than snapd_client_find_section_sync() when only a few fields
+ * are needed.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_find_with_fields_sync (SnapdClient *self,
+                                    SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                    SnapdSnapFields fields,
+                                    gchar **suggested_currency,
+                                    GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_find_with_fields_async (self, flags, section, query, fields, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_find_with_fields_finish (self, data.result, suggested_currency, error);
+}
+
+/**
+ * snapd_client_find_page_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @offset: index of the first result to return.
+ * @limit: maximum number of results to return, or 0 for all results after @offset.
+ * @total: (out) (allow-none): location to store the total number of results.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Find up to @limit snaps in the store, starting from result @offset.
+ * snapd always returns every result, but only the snaps in the page are
+ * parsed. The response is kept with the results, so if a cache is enabled for
+ * "/v2/find" with snapd_client_set_cache_ttl() other pages of the same query
+ * are parsed from it without another request to snapd.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_find_page_sync (SnapdClient *self,
+                             SnapdFindFlags flags, const gchar *section, const gchar *query,
+                             guint offset, guint limit,
+                             guint *total, gchar **suggested_currency,
+                             GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_find_page_async (self, flags, section, query, offset, limit, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_find_page_finish (self, data.result, total, suggested_currency, error);
+}
+
+/**
+ * snapd_client_find_stream_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @snap_callback: (scope call): function to call with each snap as it is parsed.
+ * @snap_callback_data: (closure): user data to pass to @snap_callback.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Find snaps in the store, passing each snap to @snap_callback as it is
+ * parsed rather than collecting them into an array. When combined with
+ * snapd_client_set_parse_thread_threshold() the first results are delivered
+ * while the rest of a large response is still being parsed. If the request
+ * fails, snaps may have already been passed to @snap_callback.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_find_stream_sync (SnapdClient *self,
+                               SnapdFindFlags flags, const gchar *section, const gchar *query,
+                               SnapdSnapCallback snap_callback, gpointer snap_callback_data,
+                               gchar **suggested_currency,
+                               GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_find_stream_async (self, flags, section, query, snap_callback, snap_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_find_stream_finish (self, data.result, suggested_currency, error);
+}
+
+/**
+ * snapd_client_resolve_snaps_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags, which must include either %SNAPD_FIND_FLAGS_MATCH_NAME or %SNAPD_FIND_FLAGS_MATCH_COMMON_ID.
+ * @ids: (array zero-terminated=1): snap names or common IDs to look up.
+ * @max_parallel: maximum number of lookups to make at once, or 0 for one per connection.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Find the store snaps for many names or common IDs, as from
+ * snapd_client_find_sync() with %SNAPD_FIND_FLAGS_MATCH_NAME or
+ * %SNAPD_FIND_FLAGS_MATCH_COMMON_ID. Each distinct ID is looked up once,
+ * with up to @max_parallel lookups at a time. IDs looked up recently are
+ * answered from a cache, see snapd_client_set_resolve_cache_ttl(). IDs that
+ * don't match a snap are left out of the result. No more lookups are
+ * started once one fails.
+ *
+ * Returns: (transfer container) (element-type utf8 SnapdSnap): a table of #SnapdSnap keyed by ID or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_client_resolve_snaps_sync (SnapdClient *self,
+                                 SnapdFindFlags flags, GStrv ids, guint max_parallel,
+                                 GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (ids != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_resolve_snaps_async (self, flags, ids, max_parallel, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_resolve_snaps_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_find_refreshable_sync:
  * @client: a #SnapdClient.
@@ -931,6 +1855,38 @@ snapd_client_install2_sync (SnapdClient *self,
     return snapd_client_install2_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_install_many_sync:
+ * @client: a #SnapdClient.
+ * @names: a %NULL-terminated array of snap names to install.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Install multiple snaps from the store.
+ * All the snaps are handled in a single snapd change, so @progress_callback reports the combined progress.
+ *
+ * Returns: (transfer full): a %NULL-terminated array of the snap names installed or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_client_install_many_sync (SnapdClient *self,
+                                GStrv names,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (names != NULL && names[0] != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_install_many_async (self, names, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_install_many_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_install_stream_sync:
  * @client: a #SnapdClient.
@@ -959,23 +1915,94 @@ snapd_client_install2_sync (SnapdClient *self,
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.9
+ * Since: 1.9
+ */
+gboolean
+snapd_client_install_stream_sync (SnapdClient *self,
+                                  SnapdInstallFlags flags,
+                                  GInputStream *stream,
+                                  SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                  GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_install_stream_async (self, flags, stream, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_install_stream_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_install_fd_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @fd: a file descriptor to read the snap file contents from.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Install a snap from a file descriptor. If @fd refers to a regular file the
+ * whole file is sent and the contents are copied to snapd by the kernel without
+ * passing through the process. Otherwise the contents are read from the current
+ * position until the end of the file. @fd is not closed and may be closed as soon
+ * as this call returns.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_install_fd_sync (SnapdClient *self,
+                              SnapdInstallFlags flags,
+                              int fd,
+                              SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                              GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (fd >= 0, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_install_fd_async (self, flags, fd, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_install_fd_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_install_path_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @path: path to the snap file to install.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Install a snap from a local file.
+ * See snapd_client_install_fd_sync() for more information.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
  */
 gboolean
-snapd_client_install_stream_sync (SnapdClient *self,
-                                  SnapdInstallFlags flags,
-                                  GInputStream *stream,
-                                  SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                  GCancellable *cancellable, GError **error)
+snapd_client_install_path_sync (SnapdClient *self,
+                                SnapdInstallFlags flags,
+                                const gchar *path,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
 
     g_auto(SyncData) data = { 0 };
     start_sync (&data);
-    snapd_client_install_stream_async (self, flags, stream, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    snapd_client_install_path_async (self, flags, path, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
     end_sync (&data);
-    return snapd_client_install_stream_finish (self, data.result, error);
+    return snapd_client_install_path_finish (self, data.result, error);
 }
 
 /**
@@ -1069,6 +2096,38 @@ snapd_client_refresh_all_sync (SnapdClient *self,
     return snapd_client_refresh_all_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_refresh_many_sync:
+ * @client: a #SnapdClient.
+ * @names: a %NULL-terminated array of snap names to refresh.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Update multiple installed snaps to their latest version.
+ * All the snaps are handled in a single snapd change, so @progress_callback reports the combined progress.
+ *
+ * Returns: (transfer full): a %NULL-terminated array of the snap names refreshed or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_client_refresh_many_sync (SnapdClient *self,
+                                GStrv names,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (names != NULL && names[0] != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_refresh_many_async (self, names, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_refresh_many_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_remove_sync:
  * @client: a #SnapdClient.
@@ -1127,6 +2186,38 @@ snapd_client_remove2_sync (SnapdClient *self,
     return snapd_client_remove2_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_remove_many_sync:
+ * @client: a #SnapdClient.
+ * @names: a %NULL-terminated array of snap names to remove.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Uninstall multiple snaps.
+ * All the snaps are handled in a single snapd change, so @progress_callback reports the combined progress.
+ *
+ * Returns: (transfer full): a %NULL-terminated array of the snap names removed or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_client_remove_many_sync (SnapdClient *self,
+                               GStrv names,
+                               SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                               GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (names != NULL && names[0] != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_remove_many_async (self, names, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_remove_many_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_enable_sync:
  * @client: a #SnapdClient.
@@ -1388,6 +2479,48 @@ snapd_client_get_sections_sync (SnapdClient *self,
     return snapd_client_get_sections_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_prefetch_sections_sync:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @sections: (array zero-terminated=1): store sections to fetch, e.g. from snapd_client_get_sections_sync().
+ * @max_parallel: maximum number of sections to fetch at once, or 0 for one per connection.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Get the snaps in many store sections, as with snapd_client_find_section_sync()
+ * with no query. Up to @max_parallel sections are fetched at once, spread over
+ * the connections allowed by snapd_client_set_max_connections().
+ *
+ * The responses are recorded in the cache set with snapd_client_set_catalog_cache(),
+ * so a store front can prefetch every section when it starts and show a section
+ * with snapd_client_find_cached() as soon as it is selected. When prefetching
+ * again the previous results remain available from the cache until they are
+ * replaced, and are used if snapd can't be reached.
+ *
+ * Sections that fail are left out of the result. An error is only returned if
+ * every section failed.
+ *
+ * Returns: (transfer container) (element-type utf8 GPtrArray): a table of arrays of #SnapdSnap keyed by section or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_client_prefetch_sections_sync (SnapdClient *self,
+                                     SnapdFindFlags flags, GStrv sections, guint max_parallel,
+                                     GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (sections != NULL, NULL);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_prefetch_sections_async (self, flags, sections, max_parallel, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_prefetch_sections_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_get_aliases_sync:
  * @client: a #SnapdClient.
@@ -1509,6 +2642,45 @@ snapd_client_prefer_sync (SnapdClient *self,
     return snapd_client_prefer_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_set_aliases_sync:
+ * @client: a #SnapdClient.
+ * @changes: (array length=n_changes): the alias changes to make.
+ * @n_changes: the number of changes in @changes.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Create, remove and prefer many aliases at once. snapd makes each change
+ * separately, so this is the same as calling snapd_client_alias_sync(),
+ * snapd_client_unalias_sync() and snapd_client_prefer_sync() for each change,
+ * except the requests are all sent without waiting for the previous change to
+ * complete. @progress_callback is called with the progress of each change.
+ *
+ * If any changes fail the others are still made and the first error is returned.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_set_aliases_sync (SnapdClient *self,
+                               const SnapdAliasChange *changes, gsize n_changes,
+                               SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                               GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (changes != NULL || n_changes == 0, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_set_aliases_async (self, changes, n_changes, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_set_aliases_finish (self, data.result, error);
+}
+
 /**
  * snapd_client_enable_aliases_sync:
  * @client: a #SnapdClient.
@@ -1697,6 +2869,275 @@ snapd_client_download_sync (SnapdClient *self,
     return snapd_client_download_finish (self, data.result, error);
 }
 
+/**
+ * snapd_client_download_to_stream_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
+ * @stream: a #GOutputStream to write the snap contents to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Download the given snap, writing the contents to @stream as they are received
+ * rather than holding the whole snap in memory. To write to a file descriptor use
+ * a #GUnixOutputStream. The total number of bytes passed to @progress_callback is
+ * -1 if snapd did not report the size of the snap. @stream is not closed.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_download_to_stream_sync (SnapdClient *self,
+                                      const gchar *name, const gchar *channel, const gchar *revision,
+                                      GOutputStream *stream,
+                                      GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                      GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (name != NULL, FALSE);
+    g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_download_to_stream_async (self, name, channel, revision, stream, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_download_to_stream_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_download_peek_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
+ * @size: (out) (allow-none): location to store the size of the snap in bytes or %NULL.
+ * @sha3_384: (out) (allow-none): location to store the SHA3-384 hash of the snap or %NULL.
+ * @resume_token: (out) (allow-none): location to store the token to resume a download or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Get information about a snap download without downloading it. The resume
+ * token can be passed to snapd_client_download_resume_sync() to download the
+ * snap in parts. @size is set to -1 if snapd did not report it.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_download_peek_sync (SnapdClient *self,
+                                 const gchar *name, const gchar *channel, const gchar *revision,
+                                 goffset *size, gchar **sha3_384, gchar **resume_token,
+                                 GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (name != NULL, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_download_peek_async (self, name, channel, revision, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_download_peek_finish (self, data.result, size, sha3_384, resume_token, error);
+}
+
+/**
+ * snapd_client_download_resume_sync:
+ * @client: a #SnapdClient.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
+ * @resume_token: token returned by snapd_client_download_peek_sync().
+ * @offset: number of bytes already downloaded.
+ * @stream: a #GOutputStream to write the remaining snap contents to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Download a snap starting from @offset bytes, for example to continue a
+ * download that was interrupted. Only the remaining contents are written to
+ * @stream and the byte counts passed to @progress_callback are for the
+ * remaining contents.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_download_resume_sync (SnapdClient *self,
+                                   const gchar *name, const gchar *channel, const gchar *revision,
+                                   const gchar *resume_token, goffset offset,
+                                   GOutputStream *stream,
+                                   GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                   GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (name != NULL, FALSE);
+    g_return_val_if_fail (resume_token != NULL, FALSE);
+    g_return_val_if_fail (offset >= 0, FALSE);
+    g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_download_resume_async (self, name, channel, revision, resume_token, offset, stream, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_download_resume_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_download_many_sync:
+ * @client: a #SnapdClient.
+ * @downloads: (element-type SnapdDownload): snaps to download.
+ * @max_parallel: maximum number of snaps to download at once, or 0 for one per connection.
+ * @max_bytes_per_second: maximum combined download rate, or 0 for no limit.
+ * @progress_callback: (allow-none) (scope call): function to call as the snaps are downloaded.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Download many snaps, each to the stream in its #SnapdDownload. The size
+ * of every snap is checked first, then the snaps are downloaded in parallel.
+ * Both steps send at most @max_parallel requests at once. If
+ * @max_bytes_per_second is set, reading from snapd is held back so the
+ * downloads together stay under that rate. No more snaps are started once
+ * one fails.
+ *
+ * Returns: %TRUE if all snaps were downloaded.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_download_many_sync (SnapdClient *self,
+                                 GPtrArray *downloads, guint max_parallel, goffset max_bytes_per_second,
+                                 SnapdDownloadProgressCallback progress_callback, gpointer progress_callback_data,
+                                 GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (downloads != NULL, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_download_many_async (self, downloads, max_parallel, max_bytes_per_second, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_download_many_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_export_snapshot_sync:
+ * @client: a #SnapdClient.
+ * @set_id: the ID of the snapshot set to export.
+ * @stream: a #GOutputStream to write the snapshot archive to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Export a snapshot set as an archive that can be imported with
+ * snapd_client_import_snapshot_sync(). The archive is written to @stream
+ * as it is received, so memory use doesn't depend on its size. To write to
+ * a file descriptor wrap it in a #GUnixOutputStream.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_export_snapshot_sync (SnapdClient *self,
+                                   gint64 set_id,
+                                   GOutputStream *stream,
+                                   GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                   GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_export_snapshot_async (self, set_id, stream, progress_callback, progress_callback_data, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_export_snapshot_finish (self, data.result, error);
+}
+
+/**
+ * snapd_client_import_snapshot_sync:
+ * @client: a #SnapdClient.
+ * @stream: a #GInputStream to read the snapshot archive from.
+ * @size: the size of the archive in bytes.
+ * @set_id: (out) (allow-none): location to store the ID of the imported snapshot set or %NULL.
+ * @snaps: (out) (allow-none) (transfer full): location to store the names of the snaps in the set or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Import a snapshot set from an archive made with
+ * snapd_client_export_snapshot_sync(). @size bytes are read from @stream
+ * and sent to snapd as they are read, so memory use doesn't depend on the
+ * size of the archive.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_import_snapshot_sync (SnapdClient *self,
+                                   GInputStream *stream, goffset size,
+                                   gint64 *set_id, GStrv *snaps,
+                                   GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (G_IS_INPUT_STREAM (stream), FALSE);
+    g_return_val_if_fail (size >= 0, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_import_snapshot_async (self, stream, size, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_import_snapshot_finish (self, data.result, set_id, snaps, error);
+}
+
+/**
+ * snapd_client_import_snapshot_fd_sync:
+ * @client: a #SnapdClient.
+ * @fd: a file descriptor for a regular file containing the snapshot archive.
+ * @set_id: (out) (allow-none): location to store the ID of the imported snapshot set or %NULL.
+ * @snaps: (out) (allow-none) (transfer full): location to store the names of the snaps in the set or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ *     to ignore.
+ *
+ * Import a snapshot set from a file. The file is copied to snapd by the
+ * kernel where possible. @fd is not closed, a duplicate is used for the
+ * request. For pipes and other streams use snapd_client_import_snapshot_sync().
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_import_snapshot_fd_sync (SnapdClient *self,
+                                      int fd,
+                                      gint64 *set_id, GStrv *snaps,
+                                      GCancellable *cancellable, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (fd >= 0, FALSE);
+
+    g_auto(SyncData) data = { 0 };
+    start_sync (&data);
+    snapd_client_import_snapshot_fd_async (self, fd, cancellable, sync_cb, &data);
+    end_sync (&data);
+    return snapd_client_import_snapshot_finish (self, data.result, set_id, snaps, error);
+}
+
 /**
  * snapd_client_check_themes_sync:
  * @client: a #SnapdClient.
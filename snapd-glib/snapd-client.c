@@ -7,14 +7,40 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <glib/gstdio.h>
+#include <gio/gunixinputstream.h>
 #include <gio/gunixsocketaddress.h>
 #include <libsoup/soup.h>
 
 #include "snapd-client.h"
 
+#include "snapd-cache-manager-private.h"
+#include "snapd-change-monitor.h"
+#include "snapd-capture.h"
+#include "snapd-catalog-cache-private.h"
+#include "snapd-change-private.h"
+#include "snapd-transport-private.h"
+#include "snapd-download-cache-private.h"
+#include "snapd-download-private.h"
 #include "snapd-error.h"
+#include "snapd-interface.h"
+#include "snapd-memory.h"
+#include "snapd-plug-ref.h"
+#include "snapd-slot-ref.h"
+#include "snapd-pending-request-private.h"
+#include "snapd-request-timings-private.h"
+#include "snapd-trace.h"
+#include "snapd-task.h"
 #include "requests/snapd-get-aliases.h"
 #include "requests/snapd-get-apps.h"
 #include "requests/snapd-get-assertions.h"
@@ -25,15 +51,22 @@
 #include "requests/snapd-get-find.h"
 #include "requests/snapd-get-icon.h"
 #include "requests/snapd-get-interfaces.h"
+#ifndef DISABLE_LEGACY_SNAPD
 #include "requests/snapd-get-interfaces-legacy.h"
+#endif
+#include "requests/snapd-get-logs.h"
+#include "requests/snapd-get-notices.h"
 #include "requests/snapd-get-sections.h"
 #include "requests/snapd-get-snap.h"
+#include "requests/snapd-get-snapshot-export.h"
 #include "requests/snapd-get-snap-conf.h"
 #include "requests/snapd-get-snaps.h"
 #include "requests/snapd-get-system-info.h"
 #include "requests/snapd-get-themes.h"
 #include "requests/snapd-get-users.h"
+#include "requests/snapd-http-response.h"
 #include "requests/snapd-post-aliases.h"
+#include "requests/snapd-post-apps.h"
 #include "requests/snapd-post-assertions.h"
 #include "requests/snapd-post-buy.h"
 #include "requests/snapd-post-change.h"
@@ -47,6 +80,7 @@
 #include "requests/snapd-post-snap-stream.h"
 #include "requests/snapd-post-snap-try.h"
 #include "requests/snapd-post-snaps.h"
+#include "requests/snapd-post-snapshots.h"
 #include "requests/snapd-post-snapctl.h"
 #include "requests/snapd-post-themes.h"
 #include "requests/snapd-put-snap-conf.h"
@@ -63,6 +97,11 @@
  *
  * Some requests require authorization which can be set with
  * snapd_client_set_auth_data().
+ *
+ * Setting the `SNAPD_GLIB_DEBUG` environment variable to a comma separated
+ * list of channels logs debugging information: `timing` logs a line for each
+ * request with the time spent in each phase and the bytes transferred, and
+ * `wire` logs all data sent to and received from snapd.
  */
 
 /**
@@ -94,13 +133,156 @@
  * ]|
  */
 
+/* State of the HTTP response currently being received from snapd.
+ * Offsets are relative to the start of the response in the receive buffer */
+typedef struct
+{
+    /* Number of bytes already searched for the end of the headers */
+    gsize header_scanned;
+
+    /* Fields from the headers, once they have been completely received */
+    gboolean have_headers;
+    gsize header_length;
+    guint status_code;
+    SnapdHttpEncoding encoding;
+    gsize content_length;
+    gchar content_type[SNAPD_HTTP_CONTENT_TYPE_SIZE];
+
+    /* Progress through a chunked body, relative to the start of the body.
+     * Chunk data is joined on to the end of the first chunk as it is received,
+     * so a body sent in a single chunk is used where it was read */
+    gsize chunk_offset;
+    gsize chunk_remaining;
+    gsize chunk_data_start;
+    gsize chunked_length;
+    gboolean last_chunk;
+
+    /* Request this response is for */
+    SnapdRequest *request;
+
+    /* TRUE if the body is written to the request as it is received, and if the request
+     * has failed and the rest of the body is being dropped */
+    gboolean streaming;
+    gboolean discard;
+    goffset total_length;
+
+    /* Time the first byte of the response was received, and bytes consumed so far */
+    gint64 first_byte_time;
+    gsize n_received;
+} ResponseState;
+
+/* Source reading from a connection in a main context that has requests waiting for responses */
+typedef struct
+{
+    GMainContext *context;
+    guint n_requests;
+    GSource *source;
+
+    /* Source failing the connection attempt if snapd hasn't accepted it in time */
+    GSource *connect_timeout_source;
+} ReadSource;
+
+/* A request submitted from another thread waiting to be picked up in the I/O context */
+typedef struct _Submission Submission;
+struct _Submission
+{
+    Submission *next;
+    SnapdRequest *request;
+};
+
+/* Requests cancelled with a #GCancellable waiting to be completed in a main context */
+typedef struct
+{
+    SnapdClient *client;
+    GMainContext *context;
+    GSource *source;
+    GPtrArray *requests;
+} CancelQueue;
+
+/* Latency histogram buckets, the first covering up to 1ms and each one after twice as long as the last.
+ * The final bucket has no upper bound */
+#define N_LATENCY_BUCKETS 18
+
+/* Statistics for requests to one endpoint */
+typedef struct
+{
+    guint64 n_requests;
+    guint64 n_errors;
+    guint64 latency_sum;
+    guint64 latency_counts[N_LATENCY_BUCKETS];
+} EndpointStatistics;
+
+/* A connection to snapd and the response being received on it */
+typedef struct
+{
+    SnapdClient *client;
+
+    /* Socket to communicate with snapd, or %NULL if not connected */
+    GSocket *socket;
+
+    /* TRUE until the first write to a socket connected for waiting requests. A failed write on an
+     * older socket may be because snapd closed it, so the request is sent again on a new one */
+    gboolean new_socket;
+
+    /* Socket being connected, and whether snapd is completing the connection or the attempt has to be
+     * made again because its listen queue was full. The attempt fails at the deadline if non-zero */
+    GSocket *connect_socket;
+    GSocketAddress *connect_address;
+    gboolean connect_pending;
+    gint64 connect_deadline;
+
+    /* Request that is streaming its body to snapd and requests waiting to be written */
+    struct _RequestData *upload;
+    GQueue pending_writes;
+
+    /* Number of requests written that haven't had a response yet */
+    guint n_in_flight;
+
+    /* Requests sent on this connection that haven't had a response yet, in the order they were sent */
+    GQueue awaiting_response;
+
+    /* Sources reading from the socket, one for each context that requests are waiting in */
+    GPtrArray *read_sources;
+
+    /* Source watching for snapd closing the socket while no requests are using it */
+    GSource *idle_source;
+
+    /* Tasks from snapd_client_prepare_async() waiting for this connection to be made */
+    GPtrArray *prepare_tasks;
+
+    /* Data received from snapd, or %NULL if not currently reading */
+    GMutex buffer_mutex;
+    GByteArray *buffer;
+    gsize buffer_start;
+    gsize n_read;
+
+    /* Reference to the buffer shared with response bodies, or %NULL if none handed out */
+    GBytes *buffer_bytes;
+
+    /* Response being received */
+    ResponseState response;
+
+    /* Streaming request whose items are being delivered slower than they arrive, so the socket isn't read until they catch up */
+    SnapdRequest *paused_request;
+} ConnectionData;
+
 typedef struct
 {
     /* Socket path to connect to */
     gchar *socket_path;
 
-    /* Socket to communicate with snapd */
-    GSocket *snapd_socket;
+    /* Address to connect to instead of @socket_path, e.g. a TCP proxy */
+    GSocketAddress *address;
+
+    /* Connections to snapd */
+    GPtrArray *connections;
+    guint max_connections;
+
+    /* TRUE if using a socket provided by the user, so no other connections can be made */
+    gboolean socket_provided;
+
+    /* Transport to send requests on instead of these connections, or %NULL */
+    SnapdTransport *transport;
 
     /* User agent to send to snapd */
     gchar *user_agent;
@@ -108,17 +290,192 @@ typedef struct
     /* Authentication data to send with requests to snapd */
     SnapdAuthData *auth_data;
 
-    /* Outstanding requests */
+    /* Queues of cancelled requests for each context. These have their own lock so it can be
+     * taken from a cancelled handler without g_cancellable_disconnect() deadlocking */
+    GMutex cancel_mutex;
+    GPtrArray *cancel_queues;
+
+    /* Outstanding requests, keyed by the request, and async requests and requests to abort them keyed by change ID */
     GMutex requests_mutex;
-    GPtrArray *requests;
+    GHashTable *requests;
+    GHashTable *change_requests;
+    GHashTable *post_change_requests;
+
+    /* TRUE if identical read-only requests share one request to snapd, and those requests keyed by method and path */
+    gboolean coalesce_requests;
+    GHashTable *coalesced_requests;
+
+    /* The latest incomplete request for each supersede key */
+    GHashTable *superseding_requests;
+
+    /* Milliseconds to cache responses for keyed by path pattern, cached requests keyed by method and path, and cache usage */
+    GHashTable *cache_ttls;
+    GHashTable *cache;
+    guint cache_hits;
+    guint cache_misses;
+
+    /* Installed snaps and store snaps from recent responses keyed by name, and how long to keep them */
+    GHashTable *snap_cache;
+    GHashTable *store_snap_cache;
+    guint snap_cache_ttl;
+
+    /* Store snaps found by snapd_client_resolve_snaps_async() keyed by find flags and ID, and how long to keep them */
+    GMutex resolve_mutex;
+    GHashTable *resolve_cache;
+    guint resolve_cache_ttl;
+
+    /* Totals for requests made by this client, and per endpoint statistics keyed by path template */
+    GMutex statistics_mutex;
+    guint64 n_requests;
+    guint64 n_errors;
+    guint64 bytes_sent;
+    guint64 bytes_received;
+    guint64 n_reconnects;
+    guint64 n_idle_closes;
+    guint64 n_retries;
+    guint64 n_parked;
+    guint64 n_polls;
+    GHashTable *endpoint_statistics;
+
+    /* File responses are recorded in, or %NULL if not capturing */
+    GMutex capture_mutex;
+    SnapdCapture *capture;
+
+    /* Directory to store icons in */
+    gchar *icon_cache_path;
 
     /* Whether to send the X-Allow-Interaction request header */
     gboolean allow_interaction;
 
-    /* Data received from snapd */
-    GMutex buffer_mutex;
-    GByteArray *buffer;
-    gsize n_read;
+    /* Headers sent with every request, and the language names they were generated for */
+    GMutex headers_mutex;
+    GBytes *common_headers;
+    const gchar * const *common_headers_languages;
+
+    /* Serialized heads of requests without a body, so polled requests are only serialized once */
+    GHashTable *prepared_requests;
+
+    /* Maximum number of bytes to read from the socket at a time */
+    gsize max_read_size;
+
+    /* TRUE if connections share receive buffers with the process-wide pool */
+    gboolean use_buffer_pool;
+
+    /* Maximum number of requests to have waiting for a response on each connection */
+    guint max_pipeline_depth;
+
+    /* Priority given to new requests */
+    SnapdRequestPriority request_priority;
+
+    /* Milliseconds new requests have to complete in and the monotonic time they must complete by, or 0 for no limit */
+    guint request_timeout;
+    gint64 request_deadline;
+
+    /* Milliseconds to wait for snapd to accept a connection, or 0 for no limit */
+    guint connect_timeout;
+
+    /* Milliseconds after which requests that haven't completed are reported as slow, or 0 to not report them */
+    guint slow_request_threshold;
+
+    /* Number of milliseconds between polls for changes */
+    guint poll_interval;
+    guint max_poll_interval;
+
+    /* Number of times to resend idempotent requests that got no response, and the backoff between them in milliseconds */
+    guint max_retries;
+    guint retry_interval;
+    guint max_retry_interval;
+
+    /* Watch on the socket path, and the timers for polls and retries held back while the socket is missing */
+    GMutex socket_monitor_mutex;
+    GFileMonitor *socket_monitor;
+    GPtrArray *parked_sources;
+
+    /* Callback for the tasks that changed in each progress report */
+    SnapdProgressDeltaCallback progress_delta_callback;
+    gpointer progress_delta_callback_data;
+    GDestroyNotify progress_delta_callback_destroy_notify;
+
+    /* Callback for the amount of each request body sent */
+    SnapdUploadProgressCallback upload_progress_callback;
+    gpointer upload_progress_callback_data;
+    GDestroyNotify upload_progress_callback_destroy_notify;
+
+    /* Minimum number of milliseconds between progress reports for each request, or 0 for no limit */
+    guint min_progress_interval;
+
+    /* Largest response body kept in memory for requests made from now on, or 0 for no limit */
+    gsize max_response_size;
+
+    /* Size of upload above which snapd has to accept the request before the body is sent, or 0 to always send it */
+    goffset expect_continue_size;
+
+    /* TRUE if polls for all changes are combined into one request, and the timer for the next one */
+    gboolean batch_polls;
+    GSource *batch_poll_source;
+
+    /* TRUE if the application isn't being used, so polls are made less often and wake up together */
+    gboolean background;
+
+    /* TRUE if waiting for change notices instead of polling, and if snapd doesn't support them */
+    gboolean use_notices;
+    gboolean notices_unsupported;
+
+    /* Connections used for waiting for notices */
+    GPtrArray *notices_connections;
+
+    /* State of the request waiting for change notices */
+    GMainContext *notices_context;
+    GSource *notices_source;
+    gboolean notices_running;
+    gchar *notices_after;
+
+    /* Thread that socket I/O and response parsing is done in, if enabled */
+    GMainContext *io_context;
+    GMainLoop *io_loop;
+    GThread *io_thread;
+
+    /* Requests submitted from other threads, newest first, and the source in the I/O context that sends them.
+     * Threads add to the list without locking and only the first to find it empty wakes the I/O context.
+     * The source and @io_context are set and cleared with @submit_mutex held */
+    Submission *submissions;
+    GMutex submit_mutex;
+    GSource *submit_source;
+
+    /* Responses at least this many bytes long are parsed in a worker thread, or 0 to always parse in place */
+    gsize parse_thread_threshold;
+
+    /* TRUE if snaps keep their part of the response and build apps, channels etc when first used */
+    gboolean lazy_parsing;
+
+    /* TRUE if identical snaps from different responses are shared */
+    gboolean share_snaps;
+
+    /* Memory used by the parsed snaps that are still alive, if tracking is enabled */
+    gboolean track_memory;
+    SnapdMemoryCounter *memory_counter;
+
+    /* Store results recorded for instant start and when snapd can't be reached */
+    SnapdCatalogCache *catalog_cache;
+
+    /* Store downloaded snaps by digest */
+    SnapdDownloadCache *download_cache;
+
+    /* Budget shared by the caches above, the response, snap and resolve caches, and the IDs they are counted with.
+     * Changed with both the requests and resolve mutexes held */
+    SnapdCacheManager *cache_manager;
+    guint response_cache_id;
+    guint snap_cache_id;
+    guint store_snap_cache_id;
+    guint resolve_cache_id;
+
+    /* Interface summaries and documentation URLs, which only change when snapd is upgraded */
+    gboolean cache_interface_docs;
+    gchar *snapd_version;
+    gboolean requested_snapd_version;
+    GHashTable *interface_docs;
+    gchar *interface_docs_version;
+    gboolean interface_docs_complete;
 
     /* Maintenance information returned from snapd */
     SnapdMaintenance *maintenance;
@@ -131,22 +488,214 @@ G_DEFINE_TYPE_WITH_PRIVATE (SnapdClient, snapd_client, G_TYPE_OBJECT)
 /* Default socket to connect to */
 #define SNAPD_SOCKET "/run/snapd.socket"
 
-/* Number of bytes to read at a time */
+/* Minimum number of bytes to read at a time */
 #define READ_SIZE 1024
 
-/* Number of milliseconds to poll for status in asynchronous operations */
-#define ASYNC_POLL_TIME 100
+/* Default maximum number of bytes to read at a time */
+#define DEFAULT_MAX_READ_SIZE 65536
 
-typedef struct
+/* Largest receive buffer to keep once the data in it has been used, and the most unused buffers to pool */
+#define STEADY_BUFFER_SIZE (2 * DEFAULT_MAX_READ_SIZE)
+#define MAX_POOLED_BUFFERS 16
+
+/* Default maximum number of requests to send before getting responses */
+#define DEFAULT_MAX_PIPELINE_DEPTH 16
+
+/* Number of bytes to read from an upload stream at a time */
+#define UPLOAD_BLOCK_SIZE 65536
+
+/* Most request heads to keep serialized, e.g. one per change being polled */
+#define MAX_PREPARED_REQUESTS 64
+
+/* Maximum number of bytes to copy from a file each time the socket is ready */
+#define UPLOAD_SENDFILE_SIZE (1024 * 1024)
+
+/* Uploads larger than this many bytes wait for snapd to accept them, and the number of
+ * milliseconds to wait before sending the body anyway */
+#define DEFAULT_EXPECT_CONTINUE_SIZE (1024 * 1024)
+#define EXPECT_CONTINUE_TIMEOUT 2000
+
+/* Default number of milliseconds between polls for status in asynchronous operations,
+ * and the longest interval to back off to while a change isn't progressing */
+#define DEFAULT_POLL_INTERVAL 100
+#define DEFAULT_MAX_POLL_INTERVAL 1000
+
+/* Shortest number of seconds between polls while in the background */
+#define BACKGROUND_POLL_INTERVAL 10
+
+/* Default time to wait before the first retry and the most to wait between retries in milliseconds */
+#define DEFAULT_RETRY_INTERVAL 100
+#define DEFAULT_MAX_RETRY_INTERVAL 5000
+
+/* Milliseconds to wait for snapd to accept a connection, and between attempts while its listen queue is full */
+#define DEFAULT_CONNECT_TIMEOUT 30000
+#define CONNECT_RETRY_INTERVAL 10
+
+/* Milliseconds to reuse snaps resolved from the store for */
+#define DEFAULT_RESOLVE_CACHE_TTL 300000
+
+/* Time for snapd to wait for notices before responding */
+#define NOTICES_TIMEOUT "30s"
+
+/* Number of items from a streamed response that can wait to be delivered before reading stops */
+#define MAX_PENDING_ITEMS 256
+
+/* Debug output enabled with SNAPD_GLIB_DEBUG, e.g. SNAPD_GLIB_DEBUG=timing,wire */
+typedef enum
+{
+    DEBUG_TIMING = 1 << 0,
+    DEBUG_WIRE   = 1 << 1,
+
+    /* Set once the environment has been checked, as the result can't be zero */
+    DEBUG_CHECKED = 1 << 30
+} DebugFlags;
+
+static gboolean
+debug_enabled (DebugFlags flag)
+{
+    static gsize flags = 0;
+
+    if (g_once_init_enter (&flags)) {
+        static const GDebugKey keys[] = {
+            { "timing", DEBUG_TIMING },
+            { "wire", DEBUG_WIRE }
+        };
+        guint f = g_parse_debug_string (g_getenv ("SNAPD_GLIB_DEBUG"), keys, G_N_ELEMENTS (keys));
+        g_once_init_leave (&flags, f | DEBUG_CHECKED);
+    }
+
+    return (flags & flag) != 0;
+}
+
+static void
+debug_log (const gchar *channel, const gchar *format, ...) G_GNUC_PRINTF (2, 3);
+
+static void
+debug_log (const gchar *channel, const gchar *format, ...)
+{
+    va_list args;
+    va_start (args, format);
+    g_autofree gchar *message = g_strdup_vprintf (format, args);
+    va_end (args);
+
+#if GLIB_CHECK_VERSION (2, 50, 0)
+    g_log_structured (G_LOG_DOMAIN, G_LOG_LEVEL_MESSAGE,
+                      "SNAPD_GLIB_DEBUG", channel,
+                      "MESSAGE", "%s", message);
+#else
+    g_message ("%s: %s", channel, message);
+#endif
+}
+
+/* Log data sent to or received from snapd, @direction is '>' or '<' */
+static void
+debug_dump_wire (gchar direction, const guint8 *data, gsize length)
+{
+    for (gsize offset = 0; offset < length; offset += 16) {
+        g_autoptr(GString) line = g_string_new (NULL);
+        g_string_append_printf (line, "%c %06" G_GSIZE_MODIFIER "x ", direction, offset);
+        for (gsize i = offset; i < offset + 16; i++) {
+            if (i < length)
+                g_string_append_printf (line, " %02x", data[i]);
+            else
+                g_string_append (line, "   ");
+        }
+        g_string_append (line, "  ");
+        for (gsize i = offset; i < offset + 16 && i < length; i++)
+            g_string_append_c (line, g_ascii_isprint (data[i]) ? data[i] : '.');
+        debug_log ("wire", "%s", line->str);
+    }
+}
+
+static SnapdCapture *
+get_capture (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->capture_mutex);
+    return priv->capture != NULL ? _snapd_capture_ref (priv->capture) : NULL;
+}
+
+typedef enum
+{
+    BATCH_POLL_NONE,
+    BATCH_POLL_WAITING,
+    BATCH_POLL_SENT
+} BatchPollState;
+
+typedef struct _RequestData
 {
     int ref_count;
     SnapdClient *client;
     SnapdRequest *request;
-    GSource *read_source;
+
+    /* Client that made the request, whose settings it is sent with. This is the client above
+     * unless the request came from a client sharing its transport */
+    SnapdClient *origin;
+
     GSource *poll_source;
     gulong cancelled_id;
+
+    /* Connection this request is sent on */
+    ConnectionData *connection;
+
+    /* Time until the next poll for the change and the progress seen in the last poll */
+    guint poll_interval;
+    guint progress_hash;
+    BatchPollState batch_poll_state;
+    gboolean waiting_for_notice;
+
+    /* Number of times this request has been resent and the timer to send it again */
+    guint n_retries;
+    GSource *retry_source;
+
+    /* TRUE once part of the response has been received, as snapd may have acted on the request */
+    gboolean response_started;
+
+    /* Timer to fail the request if it hasn't completed by its deadline */
+    GSource *timeout_source;
+
+    /* Timer to report the request as slow */
+    GSource *slow_source;
+
+    /* Timer to send the body if snapd hasn't replied to "Expect: 100-continue" */
+    GSource *continue_source;
+
+    /* Progress sending a file or stream body, and when it started and was last reported */
+    goffset upload_offset;
+    gboolean use_sendfile;
+    gint64 upload_start_time;
+    gint64 upload_report_time;
+
+    /* Key the response to this request is shared and cached under, and how long to cache it for */
+    gchar *response_key;
+    guint cache_ttl;
+
+    /* The request this one is sharing the response of and requests sharing this one */
+    struct _RequestData *leader;
+    GPtrArray *followers;
 } RequestData;
 
+/* Get the client that made @request. The request keeps a reference to it */
+static SnapdClient *
+get_origin (SnapdClient *self, SnapdRequest *request)
+{
+    g_autoptr(GObject) source_object = g_async_result_get_source_object (G_ASYNC_RESULT (request));
+    return SNAPD_IS_CLIENT (source_object) ? SNAPD_CLIENT (source_object) : self;
+}
+
+/* Lock the client that made a request, if it isn't @self. Clients never take the
+ * lock of the transport they use while holding their own, so it is safe to take
+ * with the requests mutex of @self held */
+static GMutexLocker *
+lock_origin (SnapdClient *self, SnapdClient *origin)
+{
+    if (origin == self)
+        return NULL;
+
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (origin);
+    return g_mutex_locker_new (&origin_priv->requests_mutex);
+}
+
 static RequestData *
 request_data_new (SnapdClient *client, SnapdRequest *request)
 {
@@ -154,6 +703,7 @@ request_data_new (SnapdClient *client, SnapdRequest *request)
     data->ref_count = 1;
     data->client = client;
     data->request = g_object_ref (request);
+    data->origin = get_origin (client, request);
 
     return data;
 }
@@ -172,15 +722,27 @@ request_data_unref (RequestData *data)
     if (data->ref_count > 0)
         return;
 
-    if (data->read_source != NULL)
-        g_source_destroy (data->read_source);
-    g_clear_pointer (&data->read_source, g_source_unref);
     if (data->poll_source != NULL)
         g_source_destroy (data->poll_source);
     g_clear_pointer (&data->poll_source, g_source_unref);
+    if (data->retry_source != NULL)
+        g_source_destroy (data->retry_source);
+    g_clear_pointer (&data->retry_source, g_source_unref);
+    if (data->timeout_source != NULL)
+        g_source_destroy (data->timeout_source);
+    g_clear_pointer (&data->timeout_source, g_source_unref);
+    if (data->slow_source != NULL)
+        g_source_destroy (data->slow_source);
+    g_clear_pointer (&data->slow_source, g_source_unref);
+    if (data->continue_source != NULL)
+        g_source_destroy (data->continue_source);
+    g_clear_pointer (&data->continue_source, g_source_unref);
     if (data->cancelled_id != 0)
         g_cancellable_disconnect (_snapd_request_get_cancellable (data->request), data->cancelled_id);
     data->cancelled_id = 0;
+    g_clear_pointer (&data->response_key, g_free);
+    g_clear_pointer (&data->leader, request_data_unref);
+    g_clear_pointer (&data->followers, g_ptr_array_unref);
     g_clear_object (&data->request);
     g_slice_free (RequestData, data);
 }
@@ -189,2444 +751,11129 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC (RequestData, request_data_unref)
 
 static void send_request (SnapdClient *self, SnapdRequest *request);
 
-static RequestData *
-get_request_data (SnapdClient *self, SnapdRequest *request)
+static void
+response_state_clear (ResponseState *state)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_clear_object (&state->request);
+    memset (state, 0, sizeof (ResponseState));
+}
 
-    for (guint i = 0; i < priv->requests->len; i++) {
-        RequestData *data = g_ptr_array_index (priv->requests, i);
-        if (data->request == request)
-            return data;
-    }
+/* Unused receive buffers shared between all clients that enable it */
+G_LOCK_DEFINE_STATIC (buffer_pool);
+static GPtrArray *buffer_pool = NULL;
 
-    return NULL;
+static GByteArray *
+buffer_pool_take (void)
+{
+    G_LOCK (buffer_pool);
+    GByteArray *buffer = NULL;
+    if (buffer_pool != NULL && buffer_pool->len > 0)
+        buffer = g_ptr_array_remove_index_fast (buffer_pool, buffer_pool->len - 1);
+    G_UNLOCK (buffer_pool);
+
+    return buffer;
 }
 
-static void
-complete_request_unlocked (SnapdClient *self, SnapdRequest *request, GError *error)
+static gboolean
+buffer_pool_add (GByteArray *buffer)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    G_LOCK (buffer_pool);
+    if (buffer_pool == NULL)
+        buffer_pool = g_ptr_array_new ();
+    gboolean added = buffer_pool->len < MAX_POOLED_BUFFERS;
+    if (added)
+        g_ptr_array_add (buffer_pool, buffer);
+    G_UNLOCK (buffer_pool);
 
-    _snapd_request_return (request, error);
+    return added;
+}
 
-    RequestData *data = get_request_data (self, request);
-    g_ptr_array_remove (priv->requests, data);
+/* Stop using the receive buffer, dropping any data in it.
+ * Memory still used by response bodies is left to them, and large buffers are
+ * freed so one big response doesn't keep its memory allocated. Other buffers
+ * are kept by the connection, or returned to the pool for any connection to use */
+static void
+release_buffer (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    if (connection->buffer_bytes != NULL) {
+        g_clear_pointer (&connection->buffer_bytes, g_bytes_unref);
+        g_clear_pointer (&connection->buffer, g_byte_array_unref);
+    }
+    else if (connection->buffer != NULL && connection->buffer->len > STEADY_BUFFER_SIZE)
+        g_clear_pointer (&connection->buffer, g_byte_array_unref);
+    else if (connection->buffer != NULL && priv->use_buffer_pool && buffer_pool_add (connection->buffer))
+        connection->buffer = NULL;
+    connection->buffer_start = 0;
+    connection->n_read = 0;
 }
 
+/* Drop any partially received response */
 static void
-complete_request (SnapdClient *self, SnapdRequest *request, GError *error)
+reset_buffer (ConnectionData *connection)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
-    complete_request_unlocked (self, request, error);
+    response_state_clear (&connection->response);
+    release_buffer (connection);
 }
 
-static gboolean
-async_poll_cb (gpointer data)
+static void
+read_source_free (ReadSource *read_source)
 {
-    RequestData *d = data;
+    if (read_source->source != NULL)
+        g_source_destroy (read_source->source);
+    g_clear_pointer (&read_source->source, g_source_unref);
+    if (read_source->connect_timeout_source != NULL)
+        g_source_destroy (read_source->connect_timeout_source);
+    g_clear_pointer (&read_source->connect_timeout_source, g_source_unref);
+    g_main_context_unref (read_source->context);
+    g_slice_free (ReadSource, read_source);
+}
 
-    g_autoptr(SnapdGetChange) change_request = _snapd_request_async_make_get_change_request (SNAPD_REQUEST_ASYNC (d->request));
-    send_request (d->client, SNAPD_REQUEST (change_request));
+static ConnectionData *
+connection_new (SnapdClient *client)
+{
+    ConnectionData *connection = g_slice_new0 (ConnectionData);
+    connection->client = client;
+    g_queue_init (&connection->pending_writes);
+    g_queue_init (&connection->awaiting_response);
+    connection->read_sources = g_ptr_array_new_with_free_func ((GDestroyNotify) read_source_free);
+    connection->prepare_tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    g_mutex_init (&connection->buffer_mutex);
 
-    if (d->poll_source != NULL)
-        g_source_destroy (d->poll_source);
-    g_clear_pointer (&d->poll_source, g_source_unref);
-    return G_SOURCE_REMOVE;
+    return connection;
 }
 
 static void
-schedule_poll (SnapdClient *self, SnapdRequestAsync *request)
+unwatch_idle_connection (ConnectionData *connection)
 {
-    RequestData *data = get_request_data (self, SNAPD_REQUEST (request));
-    if (data->poll_source != NULL)
-        g_source_destroy (data->poll_source);
-    g_clear_pointer (&data->poll_source, g_source_unref);
-    data->poll_source = g_timeout_source_new (ASYNC_POLL_TIME);
-    g_source_set_callback (data->poll_source, async_poll_cb, data, NULL);
-    g_source_attach (data->poll_source, _snapd_request_get_context (SNAPD_REQUEST (request)));
+    if (connection->idle_source == NULL)
+        return;
+
+    g_source_destroy (connection->idle_source);
+    g_clear_pointer (&connection->idle_source, g_source_unref);
 }
 
+/* Drop the connection to snapd, it will be reconnected on demand */
 static void
-complete_all_requests (SnapdClient *self, GError *error)
+connection_close (ConnectionData *connection)
+{
+    unwatch_idle_connection (connection);
+    if (connection->socket != NULL)
+        g_socket_close (connection->socket, NULL);
+    g_clear_object (&connection->socket);
+    connection->new_socket = FALSE;
+    g_clear_object (&connection->connect_socket);
+    g_clear_object (&connection->connect_address);
+    connection->connect_pending = FALSE;
+    reset_buffer (connection);
+    connection->n_in_flight = 0;
+    connection->paused_request = NULL;
+
+    /* Any upload in progress can't be continued */
+    if (connection->upload != NULL && connection->upload->continue_source != NULL)
+        g_source_destroy (connection->upload->continue_source);
+    if (connection->upload != NULL)
+        g_clear_pointer (&connection->upload->continue_source, g_source_unref);
+    g_clear_pointer (&connection->upload, request_data_unref);
+    while (!g_queue_is_empty (&connection->pending_writes))
+        request_data_unref (g_queue_pop_head (&connection->pending_writes));
+
+    /* Responses will never be received */
+    while (!g_queue_is_empty (&connection->awaiting_response))
+        request_data_unref (g_queue_pop_head (&connection->awaiting_response));
+    g_ptr_array_set_size (connection->read_sources, 0);
+}
+
+static void
+connection_free (ConnectionData *connection)
+{
+    connection_close (connection);
+    g_mutex_clear (&connection->buffer_mutex);
+    g_clear_pointer (&connection->buffer_bytes, g_bytes_unref);
+    g_clear_pointer (&connection->buffer, g_byte_array_unref);
+    g_clear_pointer (&connection->read_sources, g_ptr_array_unref);
+    g_clear_pointer (&connection->prepare_tasks, g_ptr_array_unref);
+    g_slice_free (ConnectionData, connection);
+}
+
+/* Get the context to do I/O for @request in, which is the I/O thread if enabled */
+static GMainContext *
+get_io_context (SnapdClient *self, SnapdRequest *request)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
 
-    /* Disconnect socket - we will reconnect on demand */
-    if (priv->snapd_socket != NULL)
-        g_socket_close (priv->snapd_socket, NULL);
-    g_clear_object (&priv->snapd_socket);
+    if (priv->io_context != NULL)
+        return priv->io_context;
+    return _snapd_request_get_context (request);
+}
 
-    /* Cancel synchronous requests (we'll never know the result); reschedule async ones (can reconnect to check result) */
-    g_autoptr(GPtrArray) requests_copy = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
-    for (guint i = 0; i < priv->requests->len; i++)
-        g_ptr_array_add (requests_copy, request_data_ref (g_ptr_array_index (priv->requests, i)));
-    for (guint i = 0; i < requests_copy->len; i++) {
-        RequestData *data = g_ptr_array_index (requests_copy, i);
+static RequestData *
+get_request_data (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    return g_hash_table_lookup (priv->requests, request);
+}
 
-        if (SNAPD_IS_REQUEST_ASYNC (data->request))
-            schedule_poll (self, SNAPD_REQUEST_ASYNC (data->request));
-        else
-            complete_request_unlocked (self, data->request, error);
-    }
+/* Remove an entry from a table keyed by change ID if it is for this request */
+static void
+remove_change_index (GHashTable *index, const gchar *change_id, RequestData *data)
+{
+    if (change_id != NULL && g_hash_table_lookup (index, change_id) == data)
+        g_hash_table_remove (index, change_id);
 }
 
+/* A successful request kept so its response can be used again */
+typedef struct
+{
+    SnapdRequest *request;
+    gint64 expiry_time;
+} CacheEntry;
+
 static void
-append_string (GByteArray *array, const gchar *value)
+cache_entry_free (CacheEntry *entry)
 {
-    g_byte_array_append (array, (const guint8 *) value, strlen (value));
+    g_object_unref (entry->request);
+    g_slice_free (CacheEntry, entry);
 }
 
-/* Converts a language in POSIX format and to be RFC2616 compliant */
-static gchar *
-posix_lang_to_rfc2616 (const gchar *language)
+/* A snap resolved from the store, or %NULL if nothing matched */
+typedef struct
 {
-    /* Don't include charset variants, etc */
-    if (strchr (language, '.') || strchr (language, '@'))
-        return NULL;
+    SnapdSnap *snap;
+    gint64 expiry_time;
+} ResolveCacheEntry;
 
-    /* Ignore "C" locale, which g_get_language_names() always includes as a fallback. */
-    if (strcmp (language, "C") == 0)
-        return NULL;
+static void
+resolve_cache_entry_free (ResolveCacheEntry *entry)
+{
+    g_clear_object (&entry->snap);
+    g_slice_free (ResolveCacheEntry, entry);
+}
 
-    return g_strdelimit (g_ascii_strdown (language, -1), "_", '-');
+/* Remove the entries of @cache that the cache manager evicted */
+static void
+drop_evicted (SnapdCacheManager *manager, guint cache_id, GHashTable *cache)
+{
+    g_auto(GStrv) keys = _snapd_cache_manager_take_evicted (manager, cache_id);
+    for (int i = 0; keys != NULL && keys[i] != NULL; i++)
+        g_hash_table_remove (cache, keys[i]);
 }
 
-/* Converts @quality from 0-100 to 0.0-1.0 and appends to @str */
-static gchar *
-add_quality_value (const gchar *str, int quality)
+/* Remove evicted responses and snaps. Must be called with the requests mutex held */
+static void
+drop_evicted_unlocked (SnapdClient *self)
 {
-    g_return_val_if_fail (str != NULL, NULL);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    if (quality >= 0 && quality < 100) {
-        /* We don't use %.02g because of "." vs "," locale issues */
-        if (quality % 10)
-            return g_strdup_printf ("%s;q=0.%02d", str, quality);
-        else
-            return g_strdup_printf ("%s;q=0.%d", str, quality / 10);
-    } else
-        return g_strdup (str);
+    drop_evicted (priv->cache_manager, priv->response_cache_id, priv->cache);
+    drop_evicted (priv->cache_manager, priv->snap_cache_id, priv->snap_cache);
+    drop_evicted (priv->cache_manager, priv->store_snap_cache_id, priv->store_snap_cache);
 }
 
-/* Returns a RFC2616 compliant languages list from system locales */
-/* Copied from libsoup */
-static gchar *
-get_accept_languages (void)
+static void
+cache_drain_cb (gpointer user_data)
 {
-    const char * const * lang_names = g_get_language_names ();
-    g_return_val_if_fail (lang_names != NULL, NULL);
+    SnapdClient *self = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    /* Build the array of languages */
-    g_autoptr(GPtrArray) langs = g_ptr_array_new_with_free_func (g_free);
-    for (guint i = 0; lang_names[i] != NULL; i++) {
-        gchar *lang = posix_lang_to_rfc2616 (lang_names[i]);
-        if (lang != NULL)
-            g_ptr_array_add (langs, lang);
-    }
-
-    /* Add quality values */
-    int delta;
-    if (langs->len < 10)
-        delta = 10;
-    else if (langs->len < 20)
-        delta = 5;
-    else
-        delta = 1;
-    for (guint i = 0; i < langs->len; i++) {
-        g_autofree gchar *lang = langs->pdata[i];
-        langs->pdata[i] = add_quality_value (lang, 100 - i * delta);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        drop_evicted_unlocked (self);
     }
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->resolve_mutex);
+    drop_evicted (priv->cache_manager, priv->resolve_cache_id, priv->resolve_cache);
+}
 
-    /* Fallback to "en" if list is empty */
-    if (langs->len == 0)
-        return g_strdup ("en");
+static void
+add_caches (SnapdClient *self, SnapdCacheManager *manager, guint *response_cache_id, guint *snap_cache_id, guint *store_snap_cache_id, guint *resolve_cache_id)
+{
+    *response_cache_id = _snapd_cache_manager_add_cache (manager, "responses", FALSE, cache_drain_cb, self);
+    *snap_cache_id = _snapd_cache_manager_add_cache (manager, "snaps", FALSE, cache_drain_cb, self);
+    *store_snap_cache_id = _snapd_cache_manager_add_cache (manager, "store-snaps", FALSE, cache_drain_cb, self);
+    *resolve_cache_id = _snapd_cache_manager_add_cache (manager, "resolved-snaps", FALSE, cache_drain_cb, self);
+}
 
-    g_ptr_array_add (langs, NULL);
-    return g_strjoinv (", ", (char **)langs->pdata);
+/* Must be called without the requests and resolve mutexes held, as it waits for cache_drain_cb () */
+static void
+remove_caches (SnapdCacheManager *manager, guint response_cache_id, guint snap_cache_id, guint store_snap_cache_id, guint resolve_cache_id)
+{
+    _snapd_cache_manager_remove_cache (manager, response_cache_id);
+    _snapd_cache_manager_remove_cache (manager, snap_cache_id);
+    _snapd_cache_manager_remove_cache (manager, store_snap_cache_id);
+    _snapd_cache_manager_remove_cache (manager, resolve_cache_id);
 }
 
-static SnapdPostChange *
-find_post_change_request (SnapdClient *self, const gchar *change_id)
+/* Remember @snap until @expiry_time. Must be called with the requests mutex held */
+static void
+add_cached_snap_unlocked (SnapdClient *self, GHashTable *cache, guint cache_id, SnapdSnap *snap, gint64 expiry_time)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
 
-    for (guint i = 0; i < priv->requests->len; i++) {
-        RequestData *data = g_ptr_array_index (priv->requests, i);
+    ResolveCacheEntry *entry = g_slice_new (ResolveCacheEntry);
+    entry->snap = g_object_ref (snap);
+    entry->expiry_time = expiry_time;
+    const gchar *name = snapd_snap_get_name (snap);
+    g_hash_table_insert (cache, g_strdup (name), entry);
+    _snapd_cache_manager_insert (priv->cache_manager, cache_id, name, sizeof (ResolveCacheEntry) + snapd_snap_get_memory_size (snap));
+}
+
+/* Get the snap cached for @name, or %NULL if there isn't one or it is too old. Must be called with the requests mutex held */
+static SnapdSnap *
+lookup_cached_snap_unlocked (SnapdClient *self, GHashTable *cache, guint cache_id, const gchar *name)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-        if (SNAPD_IS_POST_CHANGE (data->request) &&
-            g_strcmp0 (_snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)), change_id) == 0)
-            return SNAPD_POST_CHANGE (data->request);
+    drop_evicted_unlocked (self);
+    ResolveCacheEntry *entry = g_hash_table_lookup (cache, name);
+    if (entry != NULL && g_get_monotonic_time () >= entry->expiry_time) {
+        g_hash_table_remove (cache, name);
+        _snapd_cache_manager_remove (priv->cache_manager, cache_id, name);
+        entry = NULL;
+    }
+    if (entry == NULL) {
+        _snapd_cache_manager_miss (priv->cache_manager, cache_id);
+        return NULL;
     }
 
-    return NULL;
+    _snapd_cache_manager_hit (priv->cache_manager, cache_id, name);
+    return entry->snap;
 }
 
+/* Forget snaps that may have changed. Must be called with the requests mutex held */
 static void
-send_cancel (SnapdClient *self, SnapdRequestAsync *request)
+clear_snap_cache_unlocked (SnapdClient *self)
 {
-    g_autoptr(SnapdPostChange) change_request = find_post_change_request (self, _snapd_request_async_get_change_id (request));
-    if (change_request != NULL)
-        return;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    change_request = _snapd_request_async_make_post_change_request (request);
-    send_request (self, SNAPD_REQUEST (change_request));
+    g_hash_table_remove_all (priv->snap_cache);
+    g_hash_table_remove_all (priv->store_snap_cache);
+    _snapd_cache_manager_remove_all (priv->cache_manager, priv->snap_cache_id);
+    _snapd_cache_manager_remove_all (priv->cache_manager, priv->store_snap_cache_id);
 }
 
-static SnapdRequestAsync *
-find_change_request (SnapdClient *self, const gchar *change_id)
+/* Forget cached responses. Must be called with the requests mutex held */
+static void
+clear_response_cache_unlocked (SnapdClient *self)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
 
-    for (guint i = 0; i < priv->requests->len; i++) {
-        RequestData *data = g_ptr_array_index (priv->requests, i);
+    g_hash_table_remove_all (priv->cache);
+    _snapd_cache_manager_remove_all (priv->cache_manager, priv->response_cache_id);
+}
+
+/* Remember the snaps in the response to @request, so other requests for them can be answered without snapd.
+ * Must be called with the requests mutex held */
+static void
+update_snap_cache_unlocked (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    if (priv->snap_cache_ttl == 0)
+        return;
+
+    gint64 expiry_time = g_get_monotonic_time () + (gint64) priv->snap_cache_ttl * 1000;
+    if (SNAPD_IS_GET_SNAP (request)) {
+        SnapdSnap *snap = _snapd_get_snap_get_snap (SNAPD_GET_SNAP (request));
+        if (snap != NULL)
+            add_cached_snap_unlocked (self, priv->snap_cache, priv->snap_cache_id, snap, expiry_time);
+    }
+    else if (SNAPD_IS_GET_SNAPS (request)) {
+        SnapdGetSnaps *r = SNAPD_GET_SNAPS (request);
 
-        if (SNAPD_IS_REQUEST_ASYNC (data->request) &&
-            g_strcmp0 (_snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)), change_id) == 0)
-            return SNAPD_REQUEST_ASYNC (data->request);
+        /* Partial snaps can't be used for other requests, and inactive revisions share a name with the active one */
+        if (_snapd_get_snaps_get_fields (r) != SNAPD_SNAP_FIELDS_ALL || g_strcmp0 (_snapd_get_snaps_get_select (r), "all") == 0)
+            return;
+        GPtrArray *snaps = _snapd_get_snaps_get_snaps (r);
+        for (guint i = 0; snaps != NULL && i < snaps->len; i++)
+            add_cached_snap_unlocked (self, priv->snap_cache, priv->snap_cache_id, g_ptr_array_index (snaps, i), expiry_time);
     }
+    else if (SNAPD_IS_GET_FIND (request)) {
+        SnapdGetFind *r = SNAPD_GET_FIND (request);
 
-    return NULL;
+        if (_snapd_get_find_get_fields (r) != SNAPD_SNAP_FIELDS_ALL)
+            return;
+        GPtrArray *snaps = _snapd_get_find_get_parsed_snaps (r);
+        for (guint i = 0; snaps != NULL && i < snaps->len; i++)
+            add_cached_snap_unlocked (self, priv->store_snap_cache, priv->store_snap_cache_id, g_ptr_array_index (snaps, i), expiry_time);
+    }
 }
 
-static SnapdRequest *
-get_first_request (SnapdClient *self)
+/* Get how long to cache the response to @request for. Must be called with the requests mutex held */
+static guint
+get_cache_ttl (SnapdClient *self, SnapdRequest *request)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
 
-    for (guint i = 0; i < priv->requests->len; i++) {
-        RequestData *data = g_ptr_array_index (priv->requests, i);
+    if (g_hash_table_size (priv->cache_ttls) == 0)
+        return 0;
 
-        /* Return first non-async request or async request without change id */
-        if (SNAPD_IS_REQUEST_ASYNC (data->request)) {
-            if (_snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)) == NULL)
-                return data->request;
-        }
-        else
-            return data->request;
+    /* TTLs are set per path, whatever the query */
+    SnapdHttpRequest *http_request = _snapd_request_get_http_request (request, NULL);
+
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, priv->cache_ttls);
+    gpointer pattern, ttl;
+    while (g_hash_table_iter_next (&iter, &pattern, &ttl)) {
+        if (g_pattern_match_simple (pattern, http_request->path))
+            return GPOINTER_TO_UINT (ttl);
     }
 
-    return NULL;
+    return 0;
 }
 
-/* Check if we have all HTTP chunks */
-static gboolean
-have_chunked_body (const gchar *body, gsize body_length)
+/* Get a cached request that @request can use the response of. Must be called with the requests mutex held */
+static SnapdRequest *
+lookup_cache (SnapdClient *self, const gchar *key)
 {
-    while (TRUE) {
-        /* Read chunk header, stopping on zero length chunk */
-        const gchar *chunk_start = g_strstr_len (body, body_length, "\r\n");
-        if (chunk_start == NULL)
-            return FALSE;
-        gsize chunk_header_length = chunk_start - body + 2;
-        gsize chunk_length = strtoul (body, NULL, 16);
-        if (chunk_length == 0)
-            return TRUE;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-        /* Check enough space for chunk body */
-        gsize required_length = chunk_header_length + chunk_length + 2;
-        if (required_length > body_length)
-            return FALSE;
-        // FIXME: Validate that \r\n is on the end of a chunk?
-        body += required_length;
-        body_length -= required_length;
+    drop_evicted_unlocked (self);
+    CacheEntry *entry = g_hash_table_lookup (priv->cache, key);
+    if (entry != NULL && g_get_monotonic_time () >= entry->expiry_time) {
+        g_hash_table_remove (priv->cache, key);
+        _snapd_cache_manager_remove (priv->cache_manager, priv->response_cache_id, key);
+        entry = NULL;
+    }
+    if (entry == NULL) {
+        _snapd_cache_manager_miss (priv->cache_manager, priv->response_cache_id);
+        return NULL;
     }
+
+    _snapd_cache_manager_hit (priv->cache_manager, priv->response_cache_id, key);
+    return entry->request;
 }
 
-/* If more than one HTTP chunk, re-order buffer to contain one chunk.
- * Assumes body is a valid chunked data block (as checked with have_chunked_body()) */
+static gboolean send_request_cb (gpointer user_data);
+static void complete_request_unlocked (SnapdClient *self, SnapdRequest *request, GError *error);
+
+/* Complete requests sharing the response to @data. Must be called with the requests mutex held */
 static void
-compress_chunks (gchar *body, gsize body_length, gchar **combined_start, gsize *combined_length, gsize *total_length)
+complete_followers (SnapdClient *self, RequestData *data, GError *error)
 {
-    /* Use first chunk as output */
-    *combined_length = strtoul (body, NULL, 16);
-    *combined_start = strstr (body, "\r\n") + 2;
-    if (*combined_length == 0) {
-        *total_length = *combined_start - body;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    if (data->followers == NULL)
         return;
-    }
 
-    /* Copy any remaining chunks beside the first one */
-    gchar *chunk_start = *combined_start + *combined_length + 2;
-    while (TRUE) {
-        gsize chunk_length;
+    g_autoptr(GPtrArray) followers = g_steal_pointer (&data->followers);
+    gboolean leader_cancelled = g_cancellable_is_cancelled (_snapd_request_get_cancellable (data->request));
+    for (guint i = 0; i < followers->len; i++) {
+        RequestData *follower = g_ptr_array_index (followers, i);
+        SnapdRequest *request = follower->request;
 
-        chunk_length = strtoul (chunk_start, NULL, 16);
-        chunk_start = strstr (chunk_start, "\r\n") + 2;
-        if (chunk_length == 0) {
-            *total_length = chunk_start - body;
-            return;
+        g_clear_pointer (&follower->leader, request_data_unref);
+        if (error == NULL) {
+            _snapd_request_copy_response (request, data->request);
+            complete_request_unlocked (self, request, NULL);
         }
+        /* Send again if only the request being shared was cancelled */
+        else if (leader_cancelled && !g_cancellable_is_cancelled (_snapd_request_get_cancellable (request))) {
+            g_autoptr(SnapdRequest) r = g_object_ref (request);
+            g_hash_table_remove (priv->requests, r);
+            g_autoptr(GSource) source = g_idle_source_new ();
+            g_source_set_callback (source, send_request_cb, g_object_ref (r), g_object_unref);
+            g_source_attach (source, get_io_context (self, r));
+        }
+        else
+            complete_request_unlocked (self, request, error);
+    }
+}
+
+/* Get the endpoint a path is for, with the snap name or other identifier replaced, e.g. "/v2/snaps/{name}/conf" */
+static gchar *
+get_endpoint_template (const gchar *path)
+{
+    g_auto(GStrv) components = g_strsplit (path, "/", -1);
+
+    /* Components are "", "v2", collection, identifier, ... */
+    if (g_strv_length (components) > 3 && components[3][0] != '\0') {
+        const gchar *collection = components[2];
+        g_free (components[3]);
+        if (g_strcmp0 (collection, "changes") == 0)
+            components[3] = g_strdup ("{id}");
+        else if (g_strcmp0 (collection, "assertions") == 0)
+            components[3] = g_strdup ("{type}");
+        else
+            components[3] = g_strdup ("{name}");
+    }
 
-        /* Move this chunk on the end of the last one */
-        memmove (*combined_start + *combined_length, chunk_start, chunk_length);
-        *combined_length += chunk_length;
+    return g_strjoinv ("/", components);
+}
 
-        chunk_start += chunk_length + 2;
+static guint
+get_latency_bucket (gint64 latency)
+{
+    guint bucket = 0;
+    gint64 limit = 1000;
+    while (bucket < N_LATENCY_BUCKETS - 1 && latency > limit) {
+        bucket++;
+        limit *= 2;
     }
+
+    return bucket;
 }
 
+/* Add a completed request to the client statistics */
 static void
-complete_change (SnapdClient *self, const gchar *change_id, GError *error)
+update_statistics (SnapdClient *self, SnapdRequest *request, GError *error)
 {
-    SnapdRequestAsync *request = find_change_request (self, change_id);
-    if (request != NULL)
-        complete_request (self, SNAPD_REQUEST (request), error);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    SnapdRequestTimings *timings = _snapd_request_get_timings (request);
+
+    gint64 started = snapd_request_timings_get_time (timings, SNAPD_REQUEST_PHASE_STARTED);
+    gint64 latency = started != 0 ? g_get_monotonic_time () - started : 0;
+    g_autofree gchar *endpoint = get_endpoint_template (_snapd_request_get_http_request (request, NULL)->path);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->statistics_mutex);
+    priv->n_requests++;
+    if (error != NULL)
+        priv->n_errors++;
+    priv->bytes_sent += snapd_request_timings_get_bytes_sent (timings);
+    priv->bytes_received += snapd_request_timings_get_bytes_received (timings);
+
+    EndpointStatistics *statistics = g_hash_table_lookup (priv->endpoint_statistics, endpoint);
+    if (statistics == NULL) {
+        statistics = g_new0 (EndpointStatistics, 1);
+        g_hash_table_insert (priv->endpoint_statistics, g_strdup (endpoint), statistics);
+    }
+    statistics->n_requests++;
+    if (error != NULL)
+        statistics->n_errors++;
+    statistics->latency_sum += latency;
+    statistics->latency_counts[get_latency_bucket (latency)]++;
 }
 
-static void
-update_changes (SnapdClient *self, SnapdChange *change, JsonNode *data)
+/* TRUE if @error means snapd or the store couldn't be reached, rather than refusing the request */
+static gboolean
+is_unreachable_error (GError *error)
 {
-    SnapdRequestAsync *request = find_change_request (self, snapd_change_get_id (change));
-    if (request == NULL)
-        return;
+    return g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED) ||
+           g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED) ||
+           g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_WRITE_FAILED) ||
+           g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_NETWORK_TIMEOUT) ||
+           g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_DNS_FAILURE);
+}
 
-    _snapd_request_async_report_progress (request, self, change);
+static gboolean
+uses_catalog_cache (SnapdRequest *request)
+{
+    return SNAPD_IS_GET_FIND (request) || SNAPD_IS_GET_SECTIONS (request) || SNAPD_IS_GET_SYSTEM_INFO (request);
+}
 
-    /* Complete parent */
-    if (snapd_change_get_ready (change)) {
-        g_autoptr(GError) error = NULL;
-        if (!_snapd_request_async_parse_result (request, data, &error)) {
-            complete_request (self, SNAPD_REQUEST (request), error);
-            return;
-        }
+static void
+clear_interface_docs_unlocked (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-        if (g_cancellable_set_error_if_cancelled (_snapd_request_get_cancellable (SNAPD_REQUEST (request)), &error)) {
-            complete_request (self, SNAPD_REQUEST (request), error);
-            return;
-        }
+    g_clear_pointer (&priv->snapd_version, g_free);
+    priv->requested_snapd_version = FALSE;
+    g_hash_table_remove_all (priv->interface_docs);
+    g_clear_pointer (&priv->interface_docs_version, g_free);
+    priv->interface_docs_complete = FALSE;
+}
 
-        if (snapd_change_get_error (change) != NULL) {
-            g_set_error_literal (&error,
-                                 SNAPD_ERROR,
-                                 SNAPD_ERROR_FAILED,
-                                 snapd_change_get_error (change));
-            complete_request (self, SNAPD_REQUEST (request), error);
-            return;
-        }
+/* TRUE if the documentation for the interfaces @names (or all interfaces if %NULL) can be filled in from the cache */
+static gboolean
+have_interface_docs_unlocked (SnapdClient *self, gchar **names)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-        complete_request (self, SNAPD_REQUEST (request), NULL);
-        return;
+    if (priv->snapd_version == NULL || g_strcmp0 (priv->interface_docs_version, priv->snapd_version) != 0)
+        return FALSE;
+    if (priv->interface_docs_complete)
+        return TRUE;
+    if (names == NULL)
+        return FALSE;
+    for (gsize i = 0; names[i] != NULL; i++) {
+        if (!g_hash_table_contains (priv->interface_docs, names[i]))
+            return FALSE;
     }
-
-    /* Poll for updates */
-    schedule_poll (self, request);
+    return TRUE;
 }
 
+/* Record the snapd version and interface documentation seen in responses, and fill in documentation not requested from snapd */
 static void
-parse_response (SnapdClient *self, SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body)
+update_interface_docs_unlocked (SnapdClient *self, SnapdRequest *request)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    g_clear_object (&priv->maintenance);
-    g_autoptr(GError) error = NULL;
-    if (!SNAPD_REQUEST_GET_CLASS (request)->parse_response (request, status_code, content_type, body, &priv->maintenance, &error)) {
-        if (SNAPD_IS_GET_CHANGE (request)) {
-            complete_change (self, _snapd_get_change_get_change_id (SNAPD_GET_CHANGE (request)), error);
-            complete_request (self, request, NULL);
+    if (SNAPD_IS_GET_SYSTEM_INFO (request)) {
+        const gchar *version = snapd_system_information_get_version (_snapd_get_system_info_get_system_information (SNAPD_GET_SYSTEM_INFO (request)));
+        if (g_strcmp0 (priv->snapd_version, version) != 0) {
+            g_free (priv->snapd_version);
+            priv->snapd_version = g_strdup (version);
         }
-        else if (SNAPD_IS_POST_CHANGE (request)) {
-            complete_change (self, _snapd_post_change_get_change_id (SNAPD_POST_CHANGE (request)), error);
-            complete_request (self, request, NULL);
+
+        /* Documentation recorded before the version was known is from this version, as it is cleared when snapd restarts */
+        if (priv->interface_docs_version == NULL && g_hash_table_size (priv->interface_docs) > 0)
+            priv->interface_docs_version = g_strdup (version);
+        else if (g_strcmp0 (priv->interface_docs_version, version) != 0) {
+            g_hash_table_remove_all (priv->interface_docs);
+            g_clear_pointer (&priv->interface_docs_version, g_free);
+            priv->interface_docs_complete = FALSE;
         }
-        else
-            complete_request (self, request, error);
         return;
     }
 
-    if (SNAPD_IS_GET_CHANGE (request))
-        update_changes (self,
-                        _snapd_get_change_get_change (SNAPD_GET_CHANGE (request)),
-                        _snapd_get_change_get_data (SNAPD_GET_CHANGE (request)));
-    else if (SNAPD_IS_POST_CHANGE (request))
-        update_changes (self,
-                        _snapd_post_change_get_change (SNAPD_POST_CHANGE (request)),
-                        _snapd_post_change_get_data (SNAPD_POST_CHANGE (request)));
-
-    if (SNAPD_IS_REQUEST_ASYNC (request)) {
-        /* Immediately cancel if requested, otherwise poll for updates */
-        if (g_cancellable_is_cancelled (_snapd_request_get_cancellable (request)))
-            send_cancel (self, SNAPD_REQUEST_ASYNC (request));
-        else
-            schedule_poll (self, SNAPD_REQUEST_ASYNC (request));
+    if (!SNAPD_IS_GET_INTERFACES (request))
+        return;
+    SnapdGetInterfaces *r = SNAPD_GET_INTERFACES (request);
+    GPtrArray *interfaces = _snapd_get_interfaces_get_interfaces (r);
+
+    if (_snapd_get_interfaces_get_include_docs (r) && priv->cache_interface_docs) {
+        if (g_strcmp0 (priv->interface_docs_version, priv->snapd_version) != 0) {
+            g_hash_table_remove_all (priv->interface_docs);
+            g_free (priv->interface_docs_version);
+            priv->interface_docs_version = g_strdup (priv->snapd_version);
+            priv->interface_docs_complete = FALSE;
+        }
+        for (guint i = 0; i < interfaces->len; i++) {
+            SnapdInterface *interface = g_ptr_array_index (interfaces, i);
+            SnapdInterface *docs = g_object_new (SNAPD_TYPE_INTERFACE,
+                                                 "name", snapd_interface_get_name (interface),
+                                                 "summary", snapd_interface_get_summary (interface),
+                                                 "doc-url", snapd_interface_get_doc_url (interface),
+                                                 NULL);
+            g_hash_table_insert (priv->interface_docs, g_strdup (snapd_interface_get_name (interface)), docs);
+        }
+        if (_snapd_get_interfaces_get_names (r) == NULL && !_snapd_get_interfaces_get_only_connected (r))
+            priv->interface_docs_complete = TRUE;
+    }
+    else if (_snapd_get_interfaces_get_fill_docs (r)) {
+        for (guint i = 0; i < interfaces->len; i++) {
+            SnapdInterface *interface = g_ptr_array_index (interfaces, i);
+            SnapdInterface *docs = g_hash_table_lookup (priv->interface_docs, snapd_interface_get_name (interface));
+            if (docs == NULL)
+                continue;
+
+            interfaces->pdata[i] = g_object_new (SNAPD_TYPE_INTERFACE,
+                                                 "name", snapd_interface_get_name (interface),
+                                                 "summary", snapd_interface_get_summary (docs),
+                                                 "doc-url", snapd_interface_get_doc_url (docs),
+                                                 "plugs", snapd_interface_get_plugs (interface),
+                                                 "slots", snapd_interface_get_slots (interface),
+                                                 NULL);
+            g_object_unref (interface);
+        }
     }
-    else
-        complete_request (self, request, NULL);
 }
 
-static gboolean
-read_cb (GSocket *socket, GIOCondition condition, SnapdClient *self)
+static void
+complete_request_unlocked (SnapdClient *self, SnapdRequest *request, GError *error)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->buffer_mutex);
 
-    if (priv->n_read + READ_SIZE > priv->buffer->len)
-        g_byte_array_set_size (priv->buffer, priv->n_read + READ_SIZE);
-    g_autoptr(GError) error = NULL;
-    gssize n_read = g_socket_receive (socket,
-                                      (gchar *) (priv->buffer->data + priv->n_read),
-                                      READ_SIZE,
-                                      NULL,
-                                      &error);
-
-    if (n_read == 0) {
-        g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
-                                           SNAPD_ERROR_READ_FAILED,
-                                           "snapd connection closed");
-        complete_all_requests (self, e);
-        return G_SOURCE_REMOVE;
+    /* Use the last results seen if snapd is offline */
+    gboolean offline = FALSE;
+    if (is_unreachable_error (error) && priv->catalog_cache != NULL && uses_catalog_cache (request) &&
+        !_snapd_request_get_responded (request) &&
+        _snapd_request_parse_cached_response (request, priv->catalog_cache, NULL)) {
+        error = NULL;
+        offline = TRUE;
     }
 
-    if (n_read < 0) {
-        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
-            return TRUE;
-
-        g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
-                                           SNAPD_ERROR_READ_FAILED,
-                                           "Failed to read from snapd: %s",
-                                           error->message);
-        complete_all_requests (self, e);
-        return G_SOURCE_REMOVE;
+    if (error == NULL && !_snapd_request_get_responded (request)) {
+        update_interface_docs_unlocked (self, request);
+        if (!offline) {
+            /* Snaps are cached by the client that asked for them */
+            SnapdClient *origin = get_origin (self, request);
+            g_autoptr(GMutexLocker) origin_locker = lock_origin (self, origin);
+            update_snap_cache_unlocked (origin, request);
+        }
     }
 
-    priv->n_read += n_read;
+    /* Progress held back by the rate limit is sent before the request completes */
+    if (SNAPD_IS_REQUEST_ASYNC (request))
+        _snapd_request_async_flush_progress (SNAPD_REQUEST_ASYNC (request));
+    if (!_snapd_request_get_responded (request)) {
+        /* Requests from clients sharing a transport are counted by the client that made them */
+        g_autoptr(GObject) source_object = g_async_result_get_source_object (G_ASYNC_RESULT (request));
+        SNAPD_TRACE2 (request__complete, request, error != NULL ? error->code : 0);
+        update_statistics (SNAPD_IS_CLIENT (source_object) ? SNAPD_CLIENT (source_object) : self, request, error);
+    }
+    _snapd_request_return (request, error);
 
-    while (TRUE) {
-        /* Look for header divider */
-        gchar *body = g_strstr_len ((gchar *) priv->buffer->data, priv->n_read, "\r\n\r\n");
-        if (body == NULL)
-            return G_SOURCE_CONTINUE;
-        body += 4;
-        gsize header_length = body - (gchar *) priv->buffer->data;
+    const gchar *supersede_key = _snapd_request_get_supersede_key (request);
+    if (supersede_key != NULL && g_hash_table_lookup (priv->superseding_requests, supersede_key) == request)
+        g_hash_table_remove (priv->superseding_requests, supersede_key);
 
-        /* Match this response to the next uncompleted request */
-        SnapdRequest *request = get_first_request (self);
-        if (request == NULL) {
-            g_warning ("Ignoring unexpected response");
-            return G_SOURCE_REMOVE;
+    RequestData *data = get_request_data (self, request);
+    if (data == NULL)
+        return;
+    if (data->timeout_source != NULL)
+        g_source_destroy (data->timeout_source);
+    g_clear_pointer (&data->timeout_source, g_source_unref);
+    if (data->slow_source != NULL)
+        g_source_destroy (data->slow_source);
+    g_clear_pointer (&data->slow_source, g_source_unref);
+    if (data->leader != NULL) {
+        if (data->leader->followers != NULL)
+            g_ptr_array_remove (data->leader->followers, data);
+        g_clear_pointer (&data->leader, request_data_unref);
+    }
+    {
+        /* Responses are shared and cached by the client that made the request, so clients
+         * sharing a transport with different authorization don't see each other's responses */
+        SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+        g_autoptr(GMutexLocker) origin_locker = lock_origin (self, data->origin);
+
+        if (data->response_key != NULL && g_hash_table_lookup (origin_priv->coalesced_requests, data->response_key) == data)
+            g_hash_table_remove (origin_priv->coalesced_requests, data->response_key);
+        if (data->cache_ttl > 0 && error == NULL) {
+            /* Keep a copy of the response, as the request refers back to the client */
+            CacheEntry *entry = g_slice_new (CacheEntry);
+            entry->request = g_object_new (G_OBJECT_TYPE (request), NULL);
+            _snapd_request_copy_response (entry->request, request);
+            entry->expiry_time = g_get_monotonic_time () + (gint64) data->cache_ttl * 1000;
+            g_hash_table_insert (origin_priv->cache, g_strdup (data->response_key), entry);
+            guint64 size = sizeof (CacheEntry) + snapd_request_timings_get_bytes_received (_snapd_request_get_timings (request));
+            _snapd_cache_manager_insert (origin_priv->cache_manager, origin_priv->response_cache_id, data->response_key, size);
         }
 
-        /* Parse headers */
-        guint status_code;
-        g_autoptr(SoupMessageHeaders) response_headers = soup_message_headers_new (SOUP_MESSAGE_HEADERS_RESPONSE);
-        if (!soup_headers_parse_response ((gchar *) priv->buffer->data, header_length, response_headers, NULL, &status_code, NULL)) {
-            g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
-                                               SNAPD_ERROR_READ_FAILED,
-                                               "Failed to parse headers from snapd");
-            complete_all_requests (self, e);
-            return G_SOURCE_REMOVE;
+        /* Cached responses may no longer be correct once something has been changed */
+        if (g_strcmp0 (_snapd_request_get_http_request (request, NULL)->method, "GET") != 0) {
+            clear_response_cache_unlocked (data->origin);
+            clear_snap_cache_unlocked (data->origin);
         }
+        drop_evicted_unlocked (data->origin);
+    }
+    complete_followers (self, data, error);
+    if (SNAPD_IS_REQUEST_ASYNC (request))
+        remove_change_index (priv->change_requests, _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (request)), data);
+    else if (SNAPD_IS_POST_CHANGE (request))
+        remove_change_index (priv->post_change_requests, _snapd_post_change_get_change_id (SNAPD_POST_CHANGE (request)), data);
+    g_hash_table_remove (priv->requests, request);
+}
 
-        /* Read content and process content */
-        gsize content_length;
-        g_autoptr(GBytes) b = NULL;
-        switch (soup_message_headers_get_encoding (response_headers)) {
-        case SOUP_ENCODING_EOF:
-            if (!g_socket_is_closed (priv->snapd_socket))
-                return G_SOURCE_CONTINUE;
-
-            content_length = priv->n_read - header_length;
-            b = g_bytes_new (body, content_length);
-            break;
-
-        case SOUP_ENCODING_CHUNKED:
-            // FIXME: Find a way to abort on error
-            if (!have_chunked_body (body, priv->n_read - header_length))
-                return G_SOURCE_CONTINUE;
+static void
+complete_request (SnapdClient *self, SnapdRequest *request, GError *error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    complete_request_unlocked (self, request, error);
+}
 
-            gchar *combined_start;
-            gsize combined_length;
-            compress_chunks (body, priv->n_read - header_length, &combined_start, &combined_length, &content_length);
-            b = g_bytes_new (combined_start, combined_length);
-            break;
+static void
+send_change_poll (RequestData *data)
+{
+    g_autoptr(SnapdGetChange) change_request = _snapd_request_async_make_get_change_request (SNAPD_REQUEST_ASYNC (data->request));
+    _snapd_request_set_common_headers (SNAPD_REQUEST (change_request), _snapd_request_get_common_headers (data->request));
+    send_request (data->client, SNAPD_REQUEST (change_request));
+}
 
-        case SOUP_ENCODING_CONTENT_LENGTH:
-            content_length = soup_message_headers_get_content_length (response_headers);
-            if (priv->n_read < header_length + content_length)
-                return G_SOURCE_CONTINUE;
+static gboolean
+async_poll_cb (gpointer data)
+{
+    RequestData *d = data;
 
-            b = g_bytes_new (body, content_length);
-            break;
+    d->waiting_for_notice = FALSE;
+    send_change_poll (d);
 
-        default:
-            {
-                g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
-                                                   SNAPD_ERROR_READ_FAILED,
-                                                   "Unable to determine header encoding");
-                complete_all_requests (self, e);
-            }
-            return G_SOURCE_REMOVE;
-        }
+    if (d->poll_source != NULL)
+        g_source_destroy (d->poll_source);
+    g_clear_pointer (&d->poll_source, g_source_unref);
+    return G_SOURCE_REMOVE;
+}
 
-        const gchar *content_type = soup_message_headers_get_content_type (response_headers, NULL);
-        parse_response (self, request, status_code, content_type, b);
+static void update_changes (SnapdClient *self, SnapdChange *change, JsonNode *data);
 
-        /* Move remaining data to the start of the buffer */
-        g_byte_array_remove_range (priv->buffer, 0, header_length + content_length);
-        priv->n_read -= header_length + content_length;
+static SnapdChange *
+find_change (GPtrArray *changes, const gchar *change_id)
+{
+    for (guint i = 0; changes != NULL && i < changes->len; i++) {
+        SnapdChange *change = g_ptr_array_index (changes, i);
+        if (g_strcmp0 (snapd_change_get_id (change), change_id) == 0)
+            return change;
     }
+
+    return NULL;
 }
 
-static gboolean
-cancel_idle_cb (gpointer user_data)
+static void
+batch_poll_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    RequestData *data = user_data;
+    SnapdClient *self = SNAPD_CLIENT (object);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    SnapdGetChanges *request = SNAPD_GET_CHANGES (result);
 
     g_autoptr(GError) error = NULL;
-    g_cancellable_set_error_if_cancelled (_snapd_request_get_cancellable (data->request), &error);
-    complete_request (data->client, data->request, error);
+    GPtrArray *changes = NULL;
+    if (_snapd_request_propagate_error (SNAPD_REQUEST (request), &error))
+        changes = _snapd_get_changes_get_changes (request);
 
-    return G_SOURCE_REMOVE;
-}
+    g_autoptr(GPtrArray) polled = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data)) {
+            if (data->batch_poll_state == BATCH_POLL_SENT) {
+                data->batch_poll_state = BATCH_POLL_NONE;
+                g_ptr_array_add (polled, request_data_ref (data));
+            }
+        }
+    }
 
-static void
-request_cancelled_cb (GCancellable *cancellable, RequestData *data)
-{
-    /* Asynchronous requests require asking snapd to stop them */
-    if (SNAPD_IS_REQUEST_ASYNC (data->request)) {
-        SnapdRequestAsync *r = SNAPD_REQUEST_ASYNC (data->request);
+    for (guint i = 0; i < polled->len; i++) {
+        RequestData *data = g_ptr_array_index (polled, i);
+        SnapdChange *change = find_change (changes, _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)));
 
-        /* Cancel if we have got a response from snapd */
-        if (_snapd_request_async_get_change_id (r) != NULL)
-            send_cancel (data->client, r);
-    }
-    else {
-        /* Execute in an idle thread so g_cancellable_disconnect doesn't deadlock */
-        g_autoptr(GSource) idle_source = g_idle_source_new ();
-        g_source_set_callback (idle_source, cancel_idle_cb, request_data_ref (data), (GDestroyNotify) request_data_unref);
-        g_source_attach (idle_source, _snapd_request_get_context (data->request));
+        /* Changes that have finished aren't listed, and the result is only available
+         * from the change itself, so poll those individually */
+        if (change != NULL && !snapd_change_get_ready (change))
+            update_changes (self, change, NULL);
+        else
+            send_change_poll (data);
     }
 }
 
-static GSocket *
-open_snapd_socket (const gchar *socket_path, GCancellable *cancellable, GError **error)
+static gboolean
+batch_poll_timeout_cb (gpointer user_data)
 {
-    g_autoptr(GError) error_local = NULL;
-    g_autoptr(GSocket) socket = g_socket_new (G_SOCKET_FAMILY_UNIX,
-                                              G_SOCKET_TYPE_STREAM,
-                                              G_SOCKET_PROTOCOL_DEFAULT,
-                                              &error_local);
-    if (socket == NULL) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_CONNECTION_FAILED,
-                     "Unable to create snapd socket: %s",
-                     error_local->message);
-        return NULL;
+    SnapdClient *self = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_clear_pointer (&priv->batch_poll_source, g_source_unref);
+
+    gboolean have_polls = FALSE;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data)) {
+            if (data->batch_poll_state == BATCH_POLL_WAITING) {
+                data->batch_poll_state = BATCH_POLL_SENT;
+                have_polls = TRUE;
+            }
+        }
     }
-    g_socket_set_blocking (socket, FALSE);
-    g_autoptr(GSocketAddress) address = g_unix_socket_address_new (socket_path);
-    if (!g_socket_connect (socket, address, cancellable, &error_local)) {
-        g_set_error (error,
-                     SNAPD_ERROR,
-                     SNAPD_ERROR_CONNECTION_FAILED,
-                     "Unable to connect snapd socket: %s",
-                     error_local->message);
-        return NULL;
+
+    if (have_polls) {
+        g_autoptr(SnapdGetChanges) request = _snapd_get_changes_new ("in-progress", NULL, NULL, batch_poll_cb, NULL);
+        send_request (self, SNAPD_REQUEST (request));
     }
 
-    return g_steal_pointer (&socket);
+    return G_SOURCE_REMOVE;
 }
 
+/* Make a timer for the next poll. In the background these use whole seconds so GLib
+ * can wake up for all the polls in the process at the same time */
 static GSource *
-make_read_source (SnapdClient *self, GMainContext *context)
+poll_timeout_source_new (SnapdClient *self, guint poll_interval)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    g_autoptr(GSource) source = g_socket_create_source (priv->snapd_socket, G_IO_IN, NULL);
-    g_source_set_name (source, "snapd-glib-read-source");
-    g_source_set_callback (source, (GSourceFunc) read_cb, self, NULL);
-    g_source_attach (source, context);
+    if (priv->background)
+        return g_timeout_source_new_seconds (MAX ((poll_interval + 999) / 1000, BACKGROUND_POLL_INTERVAL));
 
-    return g_steal_pointer (&source);
+    return g_timeout_source_new (poll_interval);
 }
 
+/* Wait for the next combined poll. Only requests made from the same context are combined */
 static gboolean
-write_to_snapd (SnapdClient *self, GByteArray *data, GCancellable *cancellable, GError **error)
+join_batch_poll (SnapdClient *self, RequestData *data)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    GMainContext *context = get_io_context (self, data->request);
 
-    guint n_sent = 0;
-    while (n_sent < data->len) {
-        gssize n_written = g_socket_send (priv->snapd_socket, (const gchar *) (data->data + n_sent), data->len - n_sent, cancellable, error);
-        if (n_written < 0)
-            return FALSE;
+    if (!priv->batch_polls ||
+        _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)) == NULL ||
+        data->batch_poll_state == BATCH_POLL_SENT)
+        return FALSE;
+    if (priv->batch_poll_source != NULL && g_source_get_context (priv->batch_poll_source) != context)
+        return FALSE;
 
-        n_sent += n_written;
+    data->batch_poll_state = BATCH_POLL_WAITING;
+    if (priv->batch_poll_source == NULL) {
+        priv->batch_poll_source = poll_timeout_source_new (self, data->poll_interval);
+        g_source_set_callback (priv->batch_poll_source, batch_poll_timeout_cb, self, NULL);
+        g_source_attach (priv->batch_poll_source, context);
     }
 
     return TRUE;
 }
 
+static void start_notices (SnapdClient *self);
+
+static gboolean
+has_change_notice (GPtrArray *notices, const gchar *change_id)
+{
+    for (guint i = 0; i < notices->len; i++) {
+        SnapdNotice *notice = g_ptr_array_index (notices, i);
+        if (g_strcmp0 (snapd_notice_get_notice_type (notice), "change-update") == 0 &&
+            g_strcmp0 (snapd_notice_get_key (notice), change_id) == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
 static void
-send_request (SnapdClient *self, SnapdRequest *request)
+notices_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
+    SnapdClient *self = SNAPD_CLIENT (object);
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    SnapdGetNotices *request = SNAPD_GET_NOTICES (result);
 
-    // This code can be replaced with support in libsoup3 at some point.
-    // https://gitlab.gnome.org/GNOME/libsoup/-/issues/75
+    priv->notices_running = FALSE;
 
-    _snapd_request_set_source_object (request, G_OBJECT (self));
+    g_autoptr(GError) error = NULL;
+    GPtrArray *notices = NULL;
+    if (_snapd_request_propagate_error (SNAPD_REQUEST (request), &error)) {
+        notices = _snapd_get_notices_get_notices (request);
+
+        const gchar *last_repeated = _snapd_get_notices_get_last_repeated (request);
+        if (last_repeated != NULL) {
+            g_free (priv->notices_after);
+            priv->notices_after = g_strdup (last_repeated);
+        }
+    }
+    else if (g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND) ||
+             g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST))
+        priv->notices_unsupported = TRUE;
 
-    g_autoptr(RequestData) data = request_data_new (self, request);
+    /* On error the waiting requests are left to their polling timers */
+    g_autoptr(GPtrArray) notified = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
+    gboolean still_waiting = FALSE;
     {
         g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
-        g_ptr_array_add (priv->requests, request_data_ref (data));
+
+        /* Snaps may have been changed by changes from other clients too */
+        if (notices != NULL && notices->len > 0)
+            clear_snap_cache_unlocked (self);
+
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data)) {
+            if (!data->waiting_for_notice)
+                continue;
+
+            const gchar *change_id = _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request));
+            if (notices == NULL || has_change_notice (notices, change_id)) {
+                data->waiting_for_notice = FALSE;
+                if (notices != NULL)
+                    g_ptr_array_add (notified, request_data_ref (data));
+            }
+            else
+                still_waiting = TRUE;
+        }
     }
 
-    GCancellable *cancellable = _snapd_request_get_cancellable (request);
-    if (cancellable != NULL)
-        data->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (request_cancelled_cb), request_data_new (self, request), (GDestroyNotify) request_data_unref);
+    for (guint i = 0; i < notified->len; i++) {
+        RequestData *data = g_ptr_array_index (notified, i);
+        if (data->poll_source != NULL)
+            g_source_destroy (data->poll_source);
+        g_clear_pointer (&data->poll_source, g_source_unref);
+        send_change_poll (data);
+    }
 
-    g_autoptr(GBytes) body = NULL;
-    SoupMessage *message = _snapd_request_get_message (request, &body);
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    SoupMessageHeaders *request_headers = soup_message_get_request_headers (message);
-#else
-    SoupMessageHeaders *request_headers = message->request_headers;
-#endif
-    soup_message_headers_append (request_headers, "Host", "");
-    soup_message_headers_append (request_headers, "Connection", "keep-alive");
-    if (priv->user_agent != NULL)
-        soup_message_headers_append (request_headers, "User-Agent", priv->user_agent);
-    if (priv->allow_interaction)
-        soup_message_headers_append (request_headers, "X-Allow-Interaction", "true");
+    if (still_waiting)
+        start_notices (self);
+    else
+        g_clear_pointer (&priv->notices_context, g_main_context_unref);
+}
 
-    g_autofree gchar *accept_languages = get_accept_languages ();
-    soup_message_headers_append (request_headers, "Accept-Language", accept_languages);
+static void
+start_notices (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    if (priv->auth_data != NULL) {
-        g_autoptr(GString) authorization = g_string_new ("");
-        g_string_append_printf (authorization, "Macaroon root=\"%s\"", snapd_auth_data_get_macaroon (priv->auth_data));
-        GStrv discharges = snapd_auth_data_get_discharges (priv->auth_data);
-        if (discharges != NULL)
-            for (gsize i = 0; discharges[i] != NULL; i++)
-                g_string_append_printf (authorization, ",discharge=\"%s\"", discharges[i]);
-        soup_message_headers_append (request_headers, "Authorization", authorization->str);
+    priv->notices_running = TRUE;
+    g_autoptr(SnapdGetNotices) request = _snapd_get_notices_new ("change-update", priv->notices_after, NOTICES_TIMEOUT, NULL, notices_cb, NULL);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+static gboolean
+start_notices_cb (gpointer user_data)
+{
+    SnapdClient *self = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_clear_pointer (&priv->notices_source, g_source_unref);
+    start_notices (self);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Wait for snapd to notify that the change has been updated. Only requests made from the same context share the notices request */
+static gboolean
+wait_for_notice (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    GMainContext *context = get_io_context (self, data->request);
+
+    if (!priv->use_notices || priv->notices_unsupported || priv->socket_provided ||
+        _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)) == NULL)
+        return FALSE;
+    if (priv->notices_context != NULL && priv->notices_context != context)
+        return FALSE;
+
+    data->waiting_for_notice = TRUE;
+    if (priv->notices_context == NULL)
+        priv->notices_context = g_main_context_ref (context);
+    if (priv->notices_after == NULL) {
+        /* Only notices from now on are of interest, allowing for the change having started a moment ago */
+        g_autoptr(GDateTime) now = g_date_time_new_now_utc ();
+        g_autoptr(GDateTime) after = g_date_time_add_seconds (now, -1);
+        priv->notices_after = g_date_time_format (after, "%Y-%m-%dT%H:%M:%SZ");
     }
-    if (body != NULL)
-        soup_message_headers_set_content_length (request_headers, g_bytes_get_size (body));
 
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    const gchar *method = soup_message_get_method (message);
-#else
-    const gchar *method = message->method;
-#endif
-    g_autoptr(GByteArray) request_data = g_byte_array_new ();
-    append_string (request_data, method);
-    append_string (request_data, " ");
-#if SOUP_CHECK_VERSION (2, 99, 2)
-    GUri *uri = soup_message_get_uri (message);
-    const gchar *uri_path = g_uri_get_path (uri);
-    const gchar *uri_query = g_uri_get_query (uri);
-#else
-    SoupURI *uri = soup_message_get_uri (message);
-    const gchar *uri_path = uri->path;
-    const gchar *uri_query = uri->query;
-#endif
-    append_string (request_data, uri_path);
-    if (uri_query != NULL) {
-        append_string (request_data, "?");
-        append_string (request_data, uri_query);
-    }
-    append_string (request_data, " HTTP/1.1\r\n");
-    SoupMessageHeadersIter iter;
-    soup_message_headers_iter_init (&iter, request_headers);
-    const char *name, *value;
-    while (soup_message_headers_iter_next (&iter, &name, &value)) {
-        append_string (request_data, name);
-        append_string (request_data, ": ");
-        append_string (request_data, value);
-        append_string (request_data, "\r\n");
+    /* Start from an idle callback as this may be called with the requests locked */
+    if (!priv->notices_running && priv->notices_source == NULL) {
+        priv->notices_source = g_idle_source_new ();
+        g_source_set_callback (priv->notices_source, start_notices_cb, self, NULL);
+        g_source_attach (priv->notices_source, context);
     }
-    append_string (request_data, "\r\n");
 
-    if (body != NULL)
-        g_byte_array_append (request_data, g_bytes_get_data (body, NULL), g_bytes_get_size (body));
+    return TRUE;
+}
 
-    gboolean new_socket = FALSE;
-    if (priv->snapd_socket == NULL) {
-        g_autoptr(GError) error = NULL;
-        priv->snapd_socket = open_snapd_socket (priv->socket_path, cancellable, &error);
-        if (priv->snapd_socket == NULL) {
-            complete_request (self, request, error);
-            return;
-        }
-        new_socket = TRUE;
+/* Check if snapd has gone away, so there is no point trying to connect until the socket is created again */
+static gboolean
+is_socket_missing (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+
+    return priv->socket_monitor != NULL && priv->address == NULL && !priv->socket_provided &&
+           !g_file_test (priv->socket_path, G_FILE_TEST_EXISTS);
+}
+
+/* Hold back a poll or retry timer until the socket is created again. The timer still
+ * fires on its own after the maximum retry interval in case the change is missed */
+static void
+park_source (SnapdClient *self, GSource *source)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+
+    g_ptr_array_add (priv->parked_sources, g_source_ref (source));
+    {
+        g_autoptr(GMutexLocker) statistics_locker = g_mutex_locker_new (&priv->statistics_mutex);
+        priv->n_parked++;
     }
+}
+
+static void
+socket_changed_cb (GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
 
-    data->read_source = make_read_source (self, _snapd_request_get_context (request));
+    if (event_type != G_FILE_MONITOR_EVENT_CREATED && event_type != G_FILE_MONITOR_EVENT_MOVED_IN)
+        return;
 
-    /* send HTTP request */
+    /* Fire the held back timers now, in whichever context they are attached to */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+    for (guint i = 0; i < priv->parked_sources->len; i++)
+        g_source_set_ready_time (g_ptr_array_index (priv->parked_sources, i), 0);
+    g_ptr_array_set_size (priv->parked_sources, 0);
+}
+
+static void
+stop_socket_monitor (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+
+    if (priv->socket_monitor != NULL) {
+        g_signal_handlers_disconnect_by_data (priv->socket_monitor, self);
+        g_file_monitor_cancel (priv->socket_monitor);
+        g_clear_object (&priv->socket_monitor);
+    }
+
+    /* Let anything held back try again at once */
+    for (guint i = 0; i < priv->parked_sources->len; i++)
+        g_source_set_ready_time (g_ptr_array_index (priv->parked_sources, i), 0);
+    g_ptr_array_set_size (priv->parked_sources, 0);
+}
+
+static void
+start_socket_monitor (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    stop_socket_monitor (self);
+
+    g_autoptr(GFile) file = g_file_new_for_path (priv->socket_path);
     g_autoptr(GError) error = NULL;
-    if (write_to_snapd (self, request_data, cancellable, &error))
+    g_autoptr(GFileMonitor) monitor = g_file_monitor_file (file, G_FILE_MONITOR_WATCH_MOVES, NULL, &error);
+    if (monitor == NULL) {
+        g_debug ("Unable to watch snapd socket %s: %s", priv->socket_path, error->message);
         return;
+    }
+    g_signal_connect (monitor, "changed", G_CALLBACK (socket_changed_cb), self);
 
-    /* If was re-using closed socket, then reconnect and retry */
-    if (!new_socket && g_error_matches (error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE)) {
-        g_clear_error (&error);
-        g_clear_object (&priv->snapd_socket);
-        g_source_destroy (data->read_source);
-        g_clear_pointer (&data->read_source, g_source_unref);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+    priv->socket_monitor = g_steal_pointer (&monitor);
+}
 
-        priv->snapd_socket = open_snapd_socket (priv->socket_path, cancellable, &error);
-        if (priv->snapd_socket == NULL) {
-            complete_request (self, request, error);
-            return;
-        }
+static void
+schedule_poll (SnapdClient *self, SnapdRequestAsync *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    RequestData *data = get_request_data (self, SNAPD_REQUEST (request));
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+    if (data->poll_source != NULL)
+        g_source_destroy (data->poll_source);
+    g_clear_pointer (&data->poll_source, g_source_unref);
+    if (data->poll_interval == 0)
+        data->poll_interval = origin_priv->poll_interval;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->statistics_mutex);
+        priv->n_polls++;
+    }
+    if (join_batch_poll (self, data))
+        return;
 
-        data->read_source = make_read_source (self, _snapd_request_get_context (request));
+    /* Keep polling in case notices are lost, but not as often */
+    guint poll_interval = data->poll_interval;
+    if (wait_for_notice (self, data))
+        poll_interval = MAX (poll_interval, origin_priv->max_poll_interval);
 
-        if (write_to_snapd (self, request_data, cancellable, &error))
-            return;
+    /* Wait for snapd to come back rather than failing to connect */
+    gboolean park = is_socket_missing (self);
+    if (park)
+        poll_interval = MAX (poll_interval, origin_priv->max_retry_interval);
+
+    data->poll_source = poll_timeout_source_new (data->origin, poll_interval);
+    g_source_set_callback (data->poll_source, async_poll_cb, data, NULL);
+    g_source_attach (data->poll_source, get_io_context (self, SNAPD_REQUEST (request)));
+    if (park)
+        park_source (self, data->poll_source);
+}
+
+static void send_to_connection (SnapdClient *self, RequestData *data);
+static void remove_reader (ConnectionData *connection, GMainContext *context);
+
+/* Check if snapd may take a long time to respond to a request, or keep sending the response until it is cancelled */
+static gboolean
+is_long_lived (SnapdRequest *request)
+{
+    return SNAPD_IS_GET_NOTICES (request) ||
+           (SNAPD_IS_GET_LOGS (request) && _snapd_get_logs_get_follow (SNAPD_GET_LOGS (request)));
+}
+
+/* Check if a request that didn't get a response can be sent again.
+ * Only requests that don't change anything are retried. Must be called with the requests mutex held */
+static gboolean
+can_retry (SnapdClient *self, RequestData *data, GError *error)
+{
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+
+    if (data->response_started || data->n_retries >= origin_priv->max_retries || get_request_data (self, data->request) != data)
+        return FALSE;
+    if (!g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED) &&
+        !g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED))
+        return FALSE;
+    if (SNAPD_IS_REQUEST_ASYNC (data->request) || is_long_lived (data->request) || data->leader != NULL)
+        return FALSE;
+    if (g_cancellable_is_cancelled (_snapd_request_get_cancellable (data->request)))
+        return FALSE;
+
+    return g_strcmp0 (_snapd_request_get_http_request (data->request, NULL)->method, "GET") == 0;
+}
+
+static gboolean
+retry_cb (gpointer user_data)
+{
+    RequestData *data = user_data;
+
+    g_clear_pointer (&data->retry_source, g_source_unref);
+    send_to_connection (data->client, data);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Send a request again after a delay that doubles with each attempt.
+ * Must be called with the requests mutex held */
+static void
+schedule_retry (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    /* Stop matching responses on the old connection to this request */
+    if (data->connection != NULL && g_queue_remove (&data->connection->awaiting_response, data)) {
+        remove_reader (data->connection, get_io_context (self, data->request));
+        request_data_unref (data);
     }
 
-    g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
-                                       SNAPD_ERROR_WRITE_FAILED,
-                                       "Failed to write to snapd: %s",
-                                       error->message);
-    complete_request (self, request, e);
+    /* No point trying again quickly if snapd has said it is restarting */
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+    guint64 interval = (guint64) origin_priv->retry_interval << MIN (data->n_retries, 16);
+    if (priv->maintenance != NULL && snapd_maintenance_get_kind (priv->maintenance) == SNAPD_MAINTENANCE_KIND_DAEMON_RESTART)
+        interval = origin_priv->max_retry_interval;
+    interval = MIN (interval, origin_priv->max_retry_interval);
+
+    /* Spread out clients that lost their connection at the same time */
+    guint delay = g_random_int_range (interval / 2, interval + 1);
+
+    /* Wait for snapd to come back rather than failing to connect */
+    gboolean park = is_socket_missing (self);
+    if (park)
+        delay = origin_priv->max_retry_interval;
+
+    data->n_retries++;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->statistics_mutex);
+        priv->n_retries++;
+    }
+
+    if (data->retry_source != NULL)
+        g_source_destroy (data->retry_source);
+    g_clear_pointer (&data->retry_source, g_source_unref);
+    data->retry_source = g_timeout_source_new (delay);
+    g_source_set_callback (data->retry_source, retry_cb, data, NULL);
+    g_source_attach (data->retry_source, get_io_context (self, data->request));
+    if (park)
+        park_source (self, data->retry_source);
 }
 
-/**
- * snapd_client_connect_async:
- * @client: a #SnapdClient
- * @cancellable: (allow-none): a #GCancellable or %NULL
+/* Complete a request that couldn't be sent or didn't get a response, unless it can be sent again.
+ * Must be called with the requests mutex held */
+static void
+fail_request_unlocked (SnapdClient *self, RequestData *data, GError *error)
+{
+    if (can_retry (self, data, error))
+        schedule_retry (self, data);
+    else
+        complete_request_unlocked (self, data->request, error);
+}
+
+static void
+complete_all_requests (ConnectionData *connection, GError *error)
+{
+    SnapdClient *self = connection->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    /* Handle requests waiting for a response in the order they were sent, then async requests that have started changes */
+    g_autoptr(GPtrArray) requests_copy = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
+    for (GList *link = connection->awaiting_response.head; link != NULL; link = link->next) {
+        RequestData *data = link->data;
+        if (get_request_data (self, data->request) == data)
+            g_ptr_array_add (requests_copy, request_data_ref (data));
+    }
+    guint n_awaiting = requests_copy->len;
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, priv->requests);
+    RequestData *d;
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &d)) {
+        if (d->connection == connection && g_queue_find (&connection->awaiting_response, d) == NULL)
+            g_ptr_array_add (requests_copy, request_data_ref (d));
+    }
+
+    /* Disconnect socket - we will reconnect on demand.
+     * Unsent requests are handled below with the others */
+    connection_close (connection);
+
+    /* Cancel synchronous requests (we'll never know the result); reschedule async ones (can reconnect to check result).
+     * Requests that hadn't started getting a response may be sent again */
+    for (guint i = 0; i < requests_copy->len; i++) {
+        RequestData *data = g_ptr_array_index (requests_copy, i);
+
+        if (SNAPD_IS_REQUEST_ASYNC (data->request))
+            schedule_poll (self, SNAPD_REQUEST_ASYNC (data->request));
+        else if (i < n_awaiting)
+            fail_request_unlocked (self, data, error);
+        else
+            complete_request_unlocked (self, data->request, error);
+    }
+}
+
+static void
+append_string (GByteArray *array, const gchar *value)
+{
+    g_byte_array_append (array, (const guint8 *) value, strlen (value));
+}
+
+/* Converts a language in POSIX format and to be RFC2616 compliant */
+static gchar *
+posix_lang_to_rfc2616 (const gchar *language)
+{
+    /* Don't include charset variants, etc */
+    if (strchr (language, '.') || strchr (language, '@'))
+        return NULL;
+
+    /* Ignore "C" locale, which g_get_language_names() always includes as a fallback. */
+    if (strcmp (language, "C") == 0)
+        return NULL;
+
+    return g_strdelimit (g_ascii_strdown (language, -1), "_", '-');
+}
+
+/* Converts @quality from 0-100 to 0.0-1.0 and appends to @str */
+static gchar *
+add_quality_value (const gchar *str, int quality)
+{
+    g_return_val_if_fail (str != NULL, NULL);
+
+    if (quality >= 0 && quality < 100) {
+        /* We don't use %.02g because of "." vs "," locale issues */
+        if (quality % 10)
+            return g_strdup_printf ("%s;q=0.%02d", str, quality);
+        else
+            return g_strdup_printf ("%s;q=0.%d", str, quality / 10);
+    } else
+        return g_strdup (str);
+}
+
+/* Returns a RFC2616 compliant languages list from system locales */
+/* Copied from libsoup */
+static gchar *
+get_accept_languages (void)
+{
+    const char * const * lang_names = g_get_language_names ();
+    g_return_val_if_fail (lang_names != NULL, NULL);
+
+    /* Build the array of languages */
+    g_autoptr(GPtrArray) langs = g_ptr_array_new_with_free_func (g_free);
+    for (guint i = 0; lang_names[i] != NULL; i++) {
+        gchar *lang = posix_lang_to_rfc2616 (lang_names[i]);
+        if (lang != NULL)
+            g_ptr_array_add (langs, lang);
+    }
+
+    /* Add quality values */
+    int delta;
+    if (langs->len < 10)
+        delta = 10;
+    else if (langs->len < 20)
+        delta = 5;
+    else
+        delta = 1;
+    for (guint i = 0; i < langs->len; i++) {
+        g_autofree gchar *lang = langs->pdata[i];
+        langs->pdata[i] = add_quality_value (lang, 100 - i * delta);
+    }
+
+    /* Fallback to "en" if list is empty */
+    if (langs->len == 0)
+        return g_strdup ("en");
+
+    g_ptr_array_add (langs, NULL);
+    return g_strjoinv (", ", (char **)langs->pdata);
+}
+
+static SnapdPostChange *
+find_post_change_request (SnapdClient *self, const gchar *change_id)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    RequestData *data = change_id != NULL ? g_hash_table_lookup (priv->post_change_requests, change_id) : NULL;
+    return data != NULL ? g_object_ref (SNAPD_POST_CHANGE (data->request)) : NULL;
+}
+
+static void
+send_cancel (SnapdClient *self, SnapdRequestAsync *request)
+{
+    g_autoptr(SnapdPostChange) change_request = find_post_change_request (self, _snapd_request_async_get_change_id (request));
+    if (change_request != NULL)
+        return;
+
+    change_request = _snapd_request_async_make_post_change_request (request);
+    _snapd_request_set_common_headers (SNAPD_REQUEST (change_request), _snapd_request_get_common_headers (SNAPD_REQUEST (request)));
+    send_request (self, SNAPD_REQUEST (change_request));
+}
+
+static SnapdRequestAsync *
+find_change_request (SnapdClient *self, const gchar *change_id)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    RequestData *data = change_id != NULL ? g_hash_table_lookup (priv->change_requests, change_id) : NULL;
+    return data != NULL ? SNAPD_REQUEST_ASYNC (data->request) : NULL;
+}
+
+/* Track an async request by the change it started so polls can find it */
+static void
+add_change_request (SnapdClient *self, SnapdRequestAsync *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    const gchar *change_id = _snapd_request_async_get_change_id (request);
+    RequestData *data = get_request_data (self, SNAPD_REQUEST (request));
+    if (change_id != NULL && data != NULL)
+        g_hash_table_insert (priv->change_requests, g_strdup (change_id), data);
+}
+
+/* Get the request the next response on this connection is for.
+ * Sets @completed if the request has already completed (e.g. it was cancelled) and the response should be dropped */
+static SnapdRequest *
+pop_awaiting_request (ConnectionData *connection, gboolean *completed)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    g_autoptr(RequestData) data = g_queue_pop_head (&connection->awaiting_response);
+    if (data == NULL)
+        return NULL;
+
+    *completed = get_request_data (connection->client, data->request) != data;
+    return g_object_ref (data->request);
+}
+
+/* Note the request the next response on this connection is for has started getting it,
+ * so it isn't sent again if the connection is lost before the response is complete */
+static void
+mark_response_started (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    RequestData *data = g_queue_peek_head (&connection->awaiting_response);
+    if (data != NULL)
+        data->response_started = TRUE;
+}
+
+static void
+complete_change (SnapdClient *self, const gchar *change_id, GError *error)
+{
+    SnapdRequestAsync *request = find_change_request (self, change_id);
+    if (request != NULL)
+        complete_request (self, SNAPD_REQUEST (request), error);
+}
+
+/* Poll quickly while a change is progressing, backing off while it isn't */
+static void
+update_poll_interval (SnapdClient *self, SnapdRequestAsync *request, SnapdChange *change)
+{
+    RequestData *data = get_request_data (self, SNAPD_REQUEST (request));
+    if (data == NULL)
+        return;
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+
+    guint progress_hash = _snapd_change_get_progress_hash (change);
+    if (data->poll_interval == 0 || progress_hash != data->progress_hash)
+        data->poll_interval = origin_priv->poll_interval;
+    else
+        data->poll_interval = MIN (data->poll_interval * 2, MAX (origin_priv->max_poll_interval, origin_priv->poll_interval));
+    data->progress_hash = progress_hash;
+}
+
+static void
+update_changes (SnapdClient *self, SnapdChange *change, JsonNode *data)
+{
+    SnapdRequestAsync *request = find_change_request (self, snapd_change_get_id (change));
+    if (request == NULL)
+        return;
+
+    /* Progress is reported to the client that made the request, with its settings */
+    SnapdClient *origin = get_origin (self, SNAPD_REQUEST (request));
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (origin);
+    _snapd_request_async_report_progress (request, origin, change,
+                                          origin_priv->progress_delta_callback, origin_priv->progress_delta_callback_data,
+                                          origin_priv->min_progress_interval);
+
+    /* Complete parent */
+    if (snapd_change_get_ready (change)) {
+        g_autoptr(GError) error = NULL;
+        if (!_snapd_request_async_parse_result (request, data, &error)) {
+            complete_request (self, SNAPD_REQUEST (request), error);
+            return;
+        }
+
+        if (g_cancellable_set_error_if_cancelled (_snapd_request_get_cancellable (SNAPD_REQUEST (request)), &error)) {
+            complete_request (self, SNAPD_REQUEST (request), error);
+            return;
+        }
+
+        if (snapd_change_get_error (change) != NULL) {
+            g_set_error_literal (&error,
+                                 SNAPD_ERROR,
+                                 SNAPD_ERROR_FAILED,
+                                 snapd_change_get_error (change));
+            complete_request (self, SNAPD_REQUEST (request), error);
+            return;
+        }
+
+        complete_request (self, SNAPD_REQUEST (request), NULL);
+        return;
+    }
+
+    /* Poll for updates */
+    update_poll_interval (self, request, change);
+    schedule_poll (self, request);
+}
+
+static void
+handle_parsed_response (SnapdClient *self, SnapdRequest *request, gboolean parsed, SnapdMaintenance *maintenance, GError *error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    _snapd_request_timings_set_time (_snapd_request_get_timings (request), SNAPD_REQUEST_PHASE_PARSED, g_get_monotonic_time ());
+
+    g_set_object (&priv->maintenance, maintenance);
+    if (maintenance != NULL) {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        clear_response_cache_unlocked (self);
+        clear_snap_cache_unlocked (self);
+        clear_interface_docs_unlocked (self);
+    }
+    if (!parsed) {
+        if (SNAPD_IS_GET_CHANGE (request)) {
+            /* Check the change again once snapd is back if it went away part way through */
+            const gchar *change_id = _snapd_get_change_get_change_id (SNAPD_GET_CHANGE (request));
+            SnapdRequestAsync *parent = find_change_request (self, change_id);
+            if (parent != NULL && is_unreachable_error (error) && is_socket_missing (self))
+                schedule_poll (self, parent);
+            else
+                complete_change (self, change_id, error);
+            complete_request (self, request, NULL);
+        }
+        else if (SNAPD_IS_POST_CHANGE (request)) {
+            complete_change (self, _snapd_post_change_get_change_id (SNAPD_POST_CHANGE (request)), error);
+            complete_request (self, request, NULL);
+        }
+        else
+            complete_request (self, request, error);
+        return;
+    }
+
+    if (SNAPD_IS_GET_CHANGE (request))
+        update_changes (self,
+                        _snapd_get_change_get_change (SNAPD_GET_CHANGE (request)),
+                        _snapd_get_change_get_data (SNAPD_GET_CHANGE (request)));
+    else if (SNAPD_IS_POST_CHANGE (request))
+        update_changes (self,
+                        _snapd_post_change_get_change (SNAPD_POST_CHANGE (request)),
+                        _snapd_post_change_get_data (SNAPD_POST_CHANGE (request)));
+
+    if (SNAPD_IS_REQUEST_ASYNC (request)) {
+        add_change_request (self, SNAPD_REQUEST_ASYNC (request));
+
+        /* Immediately cancel if requested, otherwise poll for updates */
+        if (g_cancellable_is_cancelled (_snapd_request_get_cancellable (request)))
+            send_cancel (self, SNAPD_REQUEST_ASYNC (request));
+        else
+            schedule_poll (self, SNAPD_REQUEST_ASYNC (request));
+    }
+    else
+        complete_request (self, request, NULL);
+}
+
+/* A response being parsed in a worker thread */
+typedef struct
+{
+    SnapdClient *client;
+    SnapdRequest *request;
+    guint status_code;
+    gchar *content_type;
+    GBytes *body;
+    gboolean parsed;
+    SnapdMaintenance *maintenance;
+    GError *error;
+} ParseData;
+
+static void
+parse_data_free (ParseData *data)
+{
+    g_object_unref (data->client);
+    g_object_unref (data->request);
+    g_free (data->content_type);
+    g_bytes_unref (data->body);
+    g_clear_object (&data->maintenance);
+    g_clear_error (&data->error);
+    g_slice_free (ParseData, data);
+}
+
+static gboolean
+parse_done_cb (gpointer user_data)
+{
+    ParseData *data = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (data->client);
+
+    /* Request may have been cancelled or failed while being parsed */
+    gboolean outstanding;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        outstanding = get_request_data (data->client, data->request) != NULL;
+    }
+    if (outstanding)
+        handle_parsed_response (data->client, data->request, data->parsed, data->maintenance, data->error);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+parse_thread_func (gpointer user_data, gpointer pool_data)
+{
+    ParseData *data = user_data;
+
+    SNAPD_TRACE2 (parse__begin, data->request, g_bytes_get_size (data->body));
+    data->parsed = SNAPD_REQUEST_GET_CLASS (data->request)->parse_response (data->request, data->status_code, data->content_type, data->body, &data->maintenance, &data->error);
+    SNAPD_TRACE2 (parse__end, data->request, data->parsed);
+
+    /* Complete in the context the response was received in */
+    g_autoptr(GSource) source = g_idle_source_new ();
+    g_source_set_callback (source, parse_done_cb, data, (GDestroyNotify) parse_data_free);
+    g_source_attach (source, get_io_context (data->client, data->request));
+}
+
+/* Get the pool of threads shared by all clients for parsing large responses */
+static GThreadPool *
+get_parse_pool (void)
+{
+    static gsize pool = 0;
+
+    if (g_once_init_enter (&pool)) {
+        GThreadPool *p = g_thread_pool_new (parse_thread_func, NULL, (gint) g_get_num_processors (), FALSE, NULL);
+        g_once_init_leave (&pool, (gsize) p);
+    }
+
+    return (GThreadPool *) pool;
+}
+
+/* Check if the response to @request can be parsed in a worker thread.
+ * Changes are always handled in place as they update the state of other requests */
+static gboolean
+can_parse_in_thread (SnapdClient *self, SnapdRequest *request, GBytes *body)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    return priv->parse_thread_threshold > 0 &&
+           body != NULL && g_bytes_get_size (body) >= priv->parse_thread_threshold &&
+           !SNAPD_IS_REQUEST_ASYNC (request) && !SNAPD_IS_GET_CHANGE (request) && !SNAPD_IS_POST_CHANGE (request);
+}
+
+static void
+parse_response (SnapdClient *self, SnapdRequest *request, guint status_code, const gchar *content_type, GBytes *body)
+{
+    if (can_parse_in_thread (self, request, body)) {
+        ParseData *data = g_slice_new0 (ParseData);
+        data->client = g_object_ref (self);
+        data->request = g_object_ref (request);
+        data->status_code = status_code;
+        data->content_type = g_strdup (content_type);
+        data->body = g_bytes_ref (body);
+        g_thread_pool_push (get_parse_pool (), data, NULL);
+        return;
+    }
+
+    g_autoptr(SnapdMaintenance) maintenance = NULL;
+    g_autoptr(GError) error = NULL;
+    SNAPD_TRACE2 (parse__begin, request, body != NULL ? g_bytes_get_size (body) : 0);
+    gboolean parsed = SNAPD_REQUEST_GET_CLASS (request)->parse_response (request, status_code, content_type, body, &maintenance, &error);
+    SNAPD_TRACE2 (parse__end, request, parsed);
+    handle_parsed_response (self, request, parsed, maintenance, error);
+}
+
+/* Process newly received HTTP chunks, returning %TRUE once the last chunk has been received.
+ * Each byte is only examined once, and moved at most once to join it to the data before it */
+static gboolean
+read_chunks (ResponseState *state, gchar *body, gsize body_length)
+{
+    while (TRUE) {
+        gchar *chunk_start = body + state->chunk_offset;
+        gsize available = body_length - state->chunk_offset;
+
+        /* Skip trailers until the empty line that ends the body */
+        if (state->last_chunk) {
+            gchar *line_end = g_strstr_len (chunk_start, available, "\r\n");
+            if (line_end == NULL)
+                return FALSE;
+            gsize line_length = line_end - chunk_start;
+            state->chunk_offset += line_length + 2;
+            if (line_length == 0)
+                return TRUE;
+            continue;
+        }
+
+        /* Read chunk header, stopping on zero length chunk */
+        if (state->chunk_remaining == 0) {
+            gchar *header_end = g_strstr_len (chunk_start, available, "\r\n");
+            if (header_end == NULL)
+                return FALSE;
+            gsize chunk_length = strtoul (chunk_start, NULL, 16);
+            state->chunk_offset += header_end - chunk_start + 2;
+            if (chunk_length == 0)
+                state->last_chunk = TRUE;
+            else
+                state->chunk_remaining = chunk_length + 2;
+            continue;
+        }
+
+        /* Move chunk data on the end of the previous chunks, the first is left in place */
+        if (available == 0)
+            return FALSE;
+        gsize n_used = MIN (available, state->chunk_remaining);
+        gsize data_remaining = state->chunk_remaining > 2 ? state->chunk_remaining - 2 : 0;
+        gsize n_data = MIN (n_used, data_remaining);
+        if (state->chunked_length == 0 && n_data > 0)
+            state->chunk_data_start = state->chunk_offset;
+        gchar *data_end = body + state->chunk_data_start + state->chunked_length;
+        // FIXME: Validate that \r\n is on the end of a chunk?
+        if (data_end != chunk_start)
+            memmove (data_end, chunk_start, n_data);
+        state->chunked_length += n_data;
+        state->chunk_offset += n_used;
+        state->chunk_remaining -= n_used;
+    }
+}
+
+/* Make sure there is space in the receive buffer for @size more bytes.
+ * Unread data is only moved when there isn't enough space left. If response
+ * bodies are still using the buffer it is replaced rather than modified */
+static void
+ensure_buffer_space (ConnectionData *connection, gsize size)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    if (connection->buffer == NULL && priv->use_buffer_pool)
+        connection->buffer = buffer_pool_take ();
+    if (connection->buffer == NULL)
+        connection->buffer = g_byte_array_new ();
+
+    if (connection->n_read + size <= connection->buffer->len)
+        return;
+
+    gsize unread_length = connection->n_read - connection->buffer_start;
+    if (connection->buffer_bytes != NULL) {
+        GByteArray *buffer = g_byte_array_sized_new (unread_length + size);
+        g_byte_array_append (buffer, connection->buffer->data + connection->buffer_start, unread_length);
+        g_byte_array_unref (connection->buffer);
+        connection->buffer = buffer;
+        g_clear_pointer (&connection->buffer_bytes, g_bytes_unref);
+    }
+    else if (connection->buffer_start > 0)
+        memmove (connection->buffer->data, connection->buffer->data + connection->buffer_start, unread_length);
+    connection->buffer_start = 0;
+    connection->n_read = unread_length;
+
+    if (connection->n_read + size > connection->buffer->len)
+        g_byte_array_set_size (connection->buffer, connection->n_read + size);
+}
+
+/* Get a response body that refers to data in the receive buffer without copying it */
+static GBytes *
+get_buffer_slice (ConnectionData *connection, const gchar *data, gsize length)
+{
+    if (connection->buffer_bytes == NULL)
+        connection->buffer_bytes = g_bytes_new_with_free_func (connection->buffer->data, connection->buffer->len,
+                                                               (GDestroyNotify) g_byte_array_unref, g_byte_array_ref (connection->buffer));
+
+    return g_bytes_new_from_bytes (connection->buffer_bytes, (const guint8 *) data - connection->buffer->data, length);
+}
+
+/* Work out how much to read next, reading the rest of the response in one go if the size is known */
+static gsize
+get_read_size (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    ResponseState *state = &connection->response;
+
+    gsize size = READ_SIZE;
+    if (state->have_headers) {
+        gsize response_length = connection->n_read - connection->buffer_start;
+        gsize needed = 0;
+        switch (state->encoding) {
+        case SNAPD_HTTP_ENCODING_CONTENT_LENGTH:
+            if (state->header_length + state->content_length > response_length)
+                needed = state->header_length + state->content_length - response_length;
+            break;
+        case SNAPD_HTTP_ENCODING_CHUNKED:
+            /* Remaining chunk data plus space for the next chunk header */
+            if (state->chunk_remaining > 0) {
+                gsize unparsed = response_length - state->header_length - state->chunk_offset;
+                if (state->chunk_remaining > unparsed)
+                    needed = state->chunk_remaining - unparsed + READ_SIZE;
+            }
+            break;
+        default:
+            break;
+        }
+        size = MAX (size, needed);
+    }
+
+    return MIN (size, MAX (priv->max_read_size, READ_SIZE));
+}
+
+static gboolean
+idle_closed_cb (GSocket *socket, GIOCondition condition, ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    /* Nothing is expected from snapd on an unused connection, so any activity means it has been closed.
+     * Drop it so the next request opens a new one rather than failing to write to this */
+    g_clear_pointer (&connection->idle_source, g_source_unref);
+    if (connection->socket == socket && g_queue_is_empty (&connection->awaiting_response) && connection->upload == NULL) {
+        connection_close (connection);
+
+        g_mutex_lock (&priv->statistics_mutex);
+        priv->n_idle_closes++;
+        g_mutex_unlock (&priv->statistics_mutex);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Watch a connection that no requests are using in case snapd closes it.
+ * Must be called with the requests mutex held */
+static void
+watch_idle_connection (ConnectionData *connection, GMainContext *context)
+{
+    if (connection->idle_source != NULL || connection->socket == NULL ||
+        connection->read_sources->len > 0 || connection->n_in_flight > 0 ||
+        !g_queue_is_empty (&connection->awaiting_response) || connection->upload != NULL)
+        return;
+
+    connection->idle_source = g_socket_create_source (connection->socket, G_IO_IN | G_IO_HUP | G_IO_ERR, NULL);
+    g_source_set_name (connection->idle_source, "snapd-glib-idle-source");
+    g_source_set_callback (connection->idle_source, (GSourceFunc) idle_closed_cb, connection, NULL);
+    g_source_attach (connection->idle_source, context);
+}
+
+/* Note a request is waiting for a response in @context, so the socket needs to be read from there.
+ * Must be called with the requests mutex held */
+static void
+add_reader (ConnectionData *connection, GMainContext *context)
+{
+    unwatch_idle_connection (connection);
+
+    for (guint i = 0; i < connection->read_sources->len; i++) {
+        ReadSource *read_source = g_ptr_array_index (connection->read_sources, i);
+        if (read_source->context == context) {
+            read_source->n_requests++;
+            return;
+        }
+    }
+
+    ReadSource *read_source = g_slice_new0 (ReadSource);
+    read_source->context = g_main_context_ref (context);
+    read_source->n_requests = 1;
+    g_ptr_array_add (connection->read_sources, read_source);
+}
+
+/* Note a request in @context has had its response. Must be called with the requests mutex held */
+static void
+remove_reader (ConnectionData *connection, GMainContext *context)
+{
+    for (guint i = 0; i < connection->read_sources->len; i++) {
+        ReadSource *read_source = g_ptr_array_index (connection->read_sources, i);
+        if (read_source->context == context) {
+            read_source->n_requests--;
+            if (read_source->n_requests == 0) {
+                g_ptr_array_remove_index_fast (connection->read_sources, i);
+                watch_idle_connection (connection, context);
+            }
+            return;
+        }
+    }
+}
+
+static gboolean read_responses (ConnectionData *connection);
+static void write_pending_requests (ConnectionData *connection);
+
+/* Drop the sources reading from @connection. The caller holds the requests lock */
+static void
+remove_read_sources (ConnectionData *connection)
+{
+    for (guint i = 0; i < connection->read_sources->len; i++) {
+        ReadSource *read_source = g_ptr_array_index (connection->read_sources, i);
+        if (read_source->source != NULL)
+            g_source_destroy (read_source->source);
+        g_clear_pointer (&read_source->source, g_source_unref);
+    }
+}
+
+/* Stop reading from a connection until the items already received from @request have been delivered.
+ * snapd is held back by the socket filling up, so a fast stream doesn't build up in memory */
+static void
+pause_reading (ConnectionData *connection, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    /* Checked with the lock held so items_delivered_cb can't miss the pause */
+    if (_snapd_request_get_n_pending_items (request) == 0)
+        return;
+
+    connection->paused_request = request;
+    remove_read_sources (connection);
+}
+
+static gboolean
+is_paused (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return connection->paused_request != NULL;
+}
+
+static void update_read_sources (ConnectionData *connection, gboolean reset);
+
+/* Start reading connections again once the items from a streaming request have caught up */
+static void
+items_delivered_cb (SnapdRequest *request, gpointer user_data)
+{
+    SnapdClient *self = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_autoptr(GPtrArray) resumed = g_ptr_array_new ();
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        GPtrArray *connection_lists[] = { priv->connections, priv->notices_connections };
+        for (gsize i = 0; i < G_N_ELEMENTS (connection_lists); i++) {
+            for (guint j = 0; j < connection_lists[i]->len; j++) {
+                ConnectionData *connection = g_ptr_array_index (connection_lists[i], j);
+                if (connection->paused_request == request) {
+                    connection->paused_request = NULL;
+                    g_ptr_array_add (resumed, connection);
+                }
+            }
+        }
+    }
+
+    for (guint i = 0; i < resumed->len; i++)
+        update_read_sources (g_ptr_array_index (resumed, i), FALSE);
+}
+
+typedef struct
+{
+    SnapdClient *client;
+    SnapdRequest *request;
+} ThrottleData;
+
+static void
+throttle_data_free (ThrottleData *data)
+{
+    g_object_unref (data->client);
+    g_object_unref (data->request);
+    g_slice_free (ThrottleData, data);
+}
+
+static gboolean
+throttle_timeout_cb (gpointer user_data)
+{
+    ThrottleData *data = user_data;
+    items_delivered_cb (data->request, data->client);
+    return G_SOURCE_REMOVE;
+}
+
+/* Stop reading from a connection for @delay microseconds, so snapd is held back while @request is over its bandwidth limit */
+static void
+throttle_reading (ConnectionData *connection, SnapdRequest *request, gint64 delay)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        /* Already waiting for items to be delivered */
+        if (connection->paused_request != NULL)
+            return;
+
+        connection->paused_request = request;
+        remove_read_sources (connection);
+    }
+
+    ThrottleData *data = g_slice_new (ThrottleData);
+    data->client = g_object_ref (connection->client);
+    data->request = g_object_ref (request);
+    g_autoptr(GSource) source = g_timeout_source_new ((guint) MAX (delay / 1000, 1));
+    g_source_set_name (source, "snapd-glib-throttle");
+    g_source_set_callback (source, throttle_timeout_cb, data, (GDestroyNotify) throttle_data_free);
+    g_source_attach (source, get_io_context (connection->client, request));
+}
+
+static gboolean
+read_cb (GSocket *socket, GIOCondition condition, ConnectionData *connection)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&connection->buffer_mutex);
+
+    /* Read until no more data is available so we only wake up once per burst */
+    while (TRUE) {
+        gsize read_size = get_read_size (connection);
+        ensure_buffer_space (connection, read_size);
+        g_autoptr(GError) error = NULL;
+        gssize n_read = g_socket_receive (socket,
+                                          (gchar *) (connection->buffer->data + connection->n_read),
+                                          read_size,
+                                          NULL,
+                                          &error);
+
+        if (n_read == 0) {
+            g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_READ_FAILED,
+                                               "snapd connection closed");
+            complete_all_requests (connection, e);
+            return G_SOURCE_REMOVE;
+        }
+
+        if (n_read < 0) {
+            /* Send requests that were waiting for responses to be received */
+            if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+                /* Give up the buffer between responses */
+                if (connection->buffer_start == connection->n_read)
+                    release_buffer (connection);
+                write_pending_requests (connection);
+                return G_SOURCE_CONTINUE;
+            }
+
+            g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_READ_FAILED,
+                                               "Failed to read from snapd: %s",
+                                               error->message);
+            complete_all_requests (connection, e);
+            return G_SOURCE_REMOVE;
+        }
+
+        if (debug_enabled (DEBUG_WIRE))
+            debug_dump_wire ('<', connection->buffer->data + connection->n_read, n_read);
+        connection->n_read += n_read;
+        SNAPD_TRACE2 (read__chunk, connection, n_read);
+
+        if (!read_responses (connection))
+            return G_SOURCE_REMOVE;
+
+        /* Leave the rest in the socket until the items already received are delivered */
+        if (is_paused (connection))
+            return G_SOURCE_REMOVE;
+    }
+}
+
+static void continue_upload (ConnectionData *connection);
+static void drop_unsent_upload (ConnectionData *connection);
+
+/* Fail the request a response is for if its body is bigger than it allows to be kept in memory.
+ * The rest of the response is then dropped as it arrives */
+static void
+check_response_size (ConnectionData *connection, gsize size)
+{
+    ResponseState *state = &connection->response;
+
+    gsize max_response_size = _snapd_request_get_max_response_size (state->request);
+    if (max_response_size == 0 || size <= max_response_size)
+        return;
+
+    g_autoptr(GError) error = g_error_new (SNAPD_ERROR,
+                                           SNAPD_ERROR_RESPONSE_TOO_LARGE,
+                                           "Response from snapd is larger than %" G_GSIZE_FORMAT " bytes",
+                                           max_response_size);
+    complete_request (connection->client, state->request, error);
+    state->discard = TRUE;
+}
+
+static const gchar *
+get_content_type (ResponseState *state)
+{
+    return state->content_type[0] != '\0' ? state->content_type : NULL;
+}
+
+/* Process all complete responses in the receive buffer.
+ * Returns %FALSE if the connection can no longer be read from */
+static gboolean
+read_responses (ConnectionData *connection)
+{
+    while (TRUE) {
+        ResponseState *state = &connection->response;
+        gchar *response_start = (gchar *) connection->buffer->data + connection->buffer_start;
+        gsize response_length = connection->n_read - connection->buffer_start;
+
+        if (state->first_byte_time == 0 && response_length > 0) {
+            state->first_byte_time = g_get_monotonic_time ();
+            mark_response_started (connection);
+        }
+
+        /* Look for header divider, continuing from where the last search stopped */
+        if (!state->have_headers) {
+            gsize scan_start = state->header_scanned > 3 ? state->header_scanned - 3 : 0;
+            gchar *divider = g_strstr_len (response_start + scan_start, response_length - scan_start, "\r\n\r\n");
+            if (divider == NULL) {
+                state->header_scanned = response_length;
+                return TRUE;
+            }
+            state->header_length = divider + 4 - response_start;
+
+            /* Parse headers */
+            SnapdHttpResponseHeaders headers;
+            if (!_snapd_http_response_parse_headers (response_start, state->header_length, &headers)) {
+                g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                                   SNAPD_ERROR_READ_FAILED,
+                                                   "Failed to parse headers from snapd");
+                complete_all_requests (connection, e);
+                return FALSE;
+            }
+
+            /* Interim responses only tell a request sent with "Expect: 100-continue" to send its body */
+            if (headers.status_code >= 100 && headers.status_code < 200) {
+                connection->buffer_start += state->header_length;
+                response_state_clear (state);
+                if (headers.status_code == 100 && connection->upload != NULL && connection->upload->continue_source != NULL) {
+                    continue_upload (connection);
+                    if (connection->socket == NULL)
+                        return FALSE;
+                }
+                continue;
+            }
+
+            state->have_headers = TRUE;
+            state->status_code = headers.status_code;
+            memcpy (state->content_type, headers.content_type, sizeof (state->content_type));
+
+            state->encoding = headers.encoding;
+            switch (state->encoding) {
+            case SNAPD_HTTP_ENCODING_EOF:
+            case SNAPD_HTTP_ENCODING_CHUNKED:
+                state->total_length = -1;
+                break;
+            case SNAPD_HTTP_ENCODING_CONTENT_LENGTH:
+                state->content_length = headers.content_length;
+                state->total_length = state->content_length;
+                break;
+            default:
+                {
+                    g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                                       SNAPD_ERROR_READ_FAILED,
+                                                       "Unable to determine header encoding");
+                    complete_all_requests (connection, e);
+                }
+                return FALSE;
+            }
+
+            /* Match this response to the oldest request waiting for one */
+            gboolean completed = FALSE;
+            SnapdRequest *request = pop_awaiting_request (connection, &completed);
+            if (request == NULL) {
+                g_warning ("Ignoring unexpected response");
+                return FALSE;
+            }
+            state->request = request;
+
+            /* Responses to requests that have already completed are dropped */
+            state->discard = completed;
+            if (!completed) {
+                SnapdRequestTimings *timings = _snapd_request_get_timings (request);
+                _snapd_request_timings_set_time (timings, SNAPD_REQUEST_PHASE_FIRST_BYTE, state->first_byte_time);
+                _snapd_request_timings_set_time (timings, SNAPD_REQUEST_PHASE_HEADERS, g_get_monotonic_time ());
+                _snapd_request_timings_set_status_code (timings, state->status_code);
+
+                /* The few requests that need other headers get them parsed in full */
+                if (_snapd_request_needs_headers (request)) {
+                    g_autoptr(SoupMessageHeaders) response_headers = soup_message_headers_new (SOUP_MESSAGE_HEADERS_RESPONSE);
+                    if (soup_headers_parse_response (response_start, state->header_length, response_headers, NULL, NULL, NULL))
+                        _snapd_request_parse_headers (request, state->status_code, response_headers);
+                }
+
+                /* Content can be passed on as it arrives if the request supports it */
+                state->streaming = _snapd_request_streams_response (request, get_content_type (state));
+
+                /* Fail before reading a body that is known to be too big */
+                if (!state->streaming && state->encoding == SNAPD_HTTP_ENCODING_CONTENT_LENGTH)
+                    check_response_size (connection, state->content_length);
+            }
+        }
+
+        /* Check how much of the content we have */
+        gchar *body = response_start + state->header_length;
+        gsize body_length = response_length - state->header_length;
+        gboolean complete;
+        gchar *data = body;
+        gsize content_length, data_length;
+        switch (state->encoding) {
+        case SNAPD_HTTP_ENCODING_EOF:
+            complete = g_socket_is_closed (connection->socket);
+            content_length = data_length = body_length;
+            break;
+
+        case SNAPD_HTTP_ENCODING_CHUNKED:
+            // FIXME: Find a way to abort on error
+            complete = read_chunks (state, body, body_length);
+            content_length = state->chunk_offset;
+            data = body + state->chunk_data_start;
+            data_length = state->chunked_length;
+            break;
+
+        default:
+            complete = body_length >= state->content_length;
+            content_length = data_length = MIN (body_length, state->content_length);
+            break;
+        }
+
+        /* Responses that are kept until complete can't grow past the limit */
+        if (!state->streaming && !state->discard)
+            check_response_size (connection, data_length);
+
+        if (!complete && !state->discard)
+            _snapd_request_timings_set_bytes_pending (_snapd_request_get_timings (state->request), state->n_received + response_length);
+
+        g_autoptr(GBytes) b = NULL;
+        if (state->streaming || state->discard) {
+            /* Pass on the data received so far and drop it from the buffer.
+             * Responses to requests that have already completed are dropped the same way without being kept */
+            g_autoptr(GError) error = NULL;
+            if (!state->discard && !_snapd_request_write_response (state->request, (const guint8 *) data, data_length, state->total_length, &error)) {
+                complete_request (connection->client, state->request, error);
+                state->discard = TRUE;
+            }
+            else if (!state->discard && _snapd_request_get_n_pending_items (state->request) >= MAX_PENDING_ITEMS)
+                pause_reading (connection, state->request);
+            else if (!state->discard && _snapd_request_get_bandwidth_limit (state->request) != NULL) {
+                gint64 delay = _snapd_bandwidth_limit_consume (_snapd_request_get_bandwidth_limit (state->request), data_length);
+                if (delay > 0 && !complete)
+                    throttle_reading (connection, state->request, delay);
+            }
+            connection->buffer_start += state->header_length + content_length;
+            state->n_received += state->header_length + content_length;
+            state->header_length = 0;
+            state->header_scanned = 0;
+            state->content_length -= MIN (state->content_length, content_length);
+            state->chunk_offset = 0;
+            state->chunk_data_start = 0;
+            state->chunked_length = 0;
+            content_length = 0;
+
+            if (!complete)
+                return TRUE;
+            b = g_bytes_new (NULL, 0);
+        }
+        else {
+            if (!complete)
+                return TRUE;
+            b = get_buffer_slice (connection, data, data_length);
+        }
+
+        /* Mark response as consumed, the buffer is compacted later if space is required */
+        connection->buffer_start += state->header_length + content_length;
+        state->n_received += state->header_length + content_length;
+        SnapdRequestTimings *timings = _snapd_request_get_timings (state->request);
+        _snapd_request_timings_add_bytes_received (timings, state->n_received);
+        _snapd_request_timings_set_bytes_pending (timings, 0);
+        _snapd_request_timings_set_time (timings, SNAPD_REQUEST_PHASE_BODY, g_get_monotonic_time ());
+        SNAPD_TRACE3 (response__complete, state->request, state->status_code, state->n_received);
+        guint status_code = state->status_code;
+        gchar content_type[SNAPD_HTTP_CONTENT_TYPE_SIZE];
+        memcpy (content_type, state->content_type, sizeof (content_type));
+        gboolean discard = state->discard;
+        g_autoptr(SnapdRequest) request = g_steal_pointer (&state->request);
+        response_state_clear (state);
+        if (connection->n_in_flight > 0)
+            connection->n_in_flight--;
+        {
+            SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+            g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+            remove_reader (connection, get_io_context (connection->client, request));
+        }
+
+        /* snapd has rejected a request before it sent its body, so the connection can't be used any more */
+        gboolean rejected_upload = connection->upload != NULL && connection->upload->request == request &&
+                                   connection->upload->continue_source != NULL;
+
+        /* Request has already failed */
+        if (discard) {
+            if (rejected_upload) {
+                drop_unsent_upload (connection);
+                return FALSE;
+            }
+            continue;
+        }
+
+        g_autoptr(SnapdCapture) capture = get_capture (connection->client);
+        if (capture != NULL) {
+            SnapdHttpRequest *http_request = _snapd_request_get_http_request (request, NULL);
+            _snapd_capture_add_exchange (capture, http_request->method, http_request->path, http_request->query,
+                                         snapd_request_timings_get_time (timings, SNAPD_REQUEST_PHASE_WRITTEN),
+                                         snapd_request_timings_get_time (timings, SNAPD_REQUEST_PHASE_FIRST_BYTE),
+                                         snapd_request_timings_get_time (timings, SNAPD_REQUEST_PHASE_BODY),
+                                         status_code, content_type, b);
+        }
+
+        parse_response (connection->client, request, status_code, content_type[0] != '\0' ? content_type : NULL, b);
+        if (rejected_upload) {
+            drop_unsent_upload (connection);
+            return FALSE;
+        }
+    }
+}
+
+static void
+cancel_queue_free (CancelQueue *queue)
+{
+    if (queue->source != NULL)
+        g_source_destroy (queue->source);
+    g_clear_pointer (&queue->source, g_source_unref);
+    g_main_context_unref (queue->context);
+    g_ptr_array_unref (queue->requests);
+    g_slice_free (CancelQueue, queue);
+}
+
+/* Complete all the requests cancelled since the last time this ran */
+static gboolean
+cancel_queue_cb (gpointer user_data)
+{
+    CancelQueue *queue = user_data;
+    SnapdClient *self = queue->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_autoptr(GPtrArray) requests = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->cancel_mutex);
+        requests = g_steal_pointer (&queue->requests);
+        queue->requests = g_ptr_array_new_with_free_func (g_object_unref);
+        g_clear_pointer (&queue->source, g_source_unref);
+    }
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    for (guint i = 0; i < requests->len; i++) {
+        SnapdRequest *request = g_ptr_array_index (requests, i);
+
+        /* Long lived requests may not get a response or finish it for a long time, so drop their connection
+         * rather than have the response mistaken for one to a later request */
+        if (is_long_lived (request) && !priv->socket_provided) {
+            RequestData *d = get_request_data (self, request);
+            if (d != NULL && d->connection != NULL)
+                connection_close (d->connection);
+        }
+
+        /* Any response that arrives later is read but not parsed */
+        g_autoptr(GError) error = NULL;
+        g_cancellable_set_error_if_cancelled (_snapd_request_get_cancellable (request), &error);
+        complete_request_unlocked (self, request, error);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Queue a cancelled request to be completed in its context.
+ * All the requests cancelled before the context next runs share one idle source */
+static void
+queue_cancel (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    GMainContext *context = get_io_context (self, request);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->cancel_mutex);
+
+    CancelQueue *queue = NULL;
+    for (guint i = 0; i < priv->cancel_queues->len && queue == NULL; i++) {
+        CancelQueue *q = g_ptr_array_index (priv->cancel_queues, i);
+        if (q->context == context)
+            queue = q;
+    }
+    if (queue == NULL) {
+        queue = g_slice_new0 (CancelQueue);
+        queue->client = self;
+        queue->context = g_main_context_ref (context);
+        queue->requests = g_ptr_array_new_with_free_func (g_object_unref);
+        g_ptr_array_add (priv->cancel_queues, queue);
+    }
+
+    g_ptr_array_add (queue->requests, g_object_ref (request));
+    if (queue->source == NULL) {
+        queue->source = g_idle_source_new ();
+        g_source_set_callback (queue->source, cancel_queue_cb, queue, NULL);
+        g_source_attach (queue->source, context);
+    }
+}
+
+static void
+request_cancelled_cb (GCancellable *cancellable, RequestData *data)
+{
+    /* Asynchronous requests require asking snapd to stop them */
+    if (SNAPD_IS_REQUEST_ASYNC (data->request)) {
+        SnapdRequestAsync *r = SNAPD_REQUEST_ASYNC (data->request);
+
+        /* Cancel if we have got a response from snapd */
+        if (_snapd_request_async_get_change_id (r) != NULL)
+            send_cancel (data->client, r);
+    }
+    else {
+        /* Complete from the request's context so g_cancellable_disconnect doesn't deadlock */
+        queue_cancel (data->client, data->request);
+    }
+}
+
+/* Create a non-blocking socket to connect to snapd with */
+static GSocket *
+create_snapd_socket (SnapdClient *self, GSocketAddress **address, GError **error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_autoptr(GSocketAddress) a = NULL;
+    if (priv->address != NULL)
+        a = g_object_ref (priv->address);
+    else
+        a = g_unix_socket_address_new (priv->socket_path);
+    GSocketFamily family = g_socket_address_get_family (a);
+
+    g_autoptr(GError) error_local = NULL;
+    g_autoptr(GSocket) socket = g_socket_new (family,
+                                              G_SOCKET_TYPE_STREAM,
+                                              G_SOCKET_PROTOCOL_DEFAULT,
+                                              &error_local);
+    if (socket == NULL) {
+        g_set_error (error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_CONNECTION_FAILED,
+                     "Unable to create snapd socket: %s",
+                     error_local->message);
+        return NULL;
+    }
+    g_socket_set_blocking (socket, FALSE);
+
+    /* Requests are small and pipelined, so don't wait to coalesce them */
+    if (family == G_SOCKET_FAMILY_IPV4 || family == G_SOCKET_FAMILY_IPV6) {
+        g_socket_set_option (socket, IPPROTO_TCP, TCP_NODELAY, 1, NULL);
+        g_socket_set_keepalive (socket, TRUE);
+    }
+
+    *address = g_steal_pointer (&a);
+    return g_steal_pointer (&socket);
+}
+
+/* State of a snapd_client_prepare_async() call waiting for connections to be made */
+typedef struct
+{
+    guint n_pending;
+    GError *error;
+} PrepareData;
+
+static void
+prepare_data_free (PrepareData *data)
+{
+    g_clear_error (&data->error);
+    g_slice_free (PrepareData, data);
+}
+
+/* Get the context a snapd_client_prepare_async() call waits for connections in */
+static GMainContext *
+get_prepare_context (SnapdClient *self, GTask *task)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    if (priv->io_context != NULL)
+        return priv->io_context;
+    return g_task_get_context (task);
+}
+
+/* Note @connection has been made, or failed with @error, for the prepare calls waiting for it.
+ * Returns the tasks that have no more connections to wait for, to be completed with
+ * complete_prepare_tasks() once the lock is released.
+ * Must be called with the requests mutex held */
+static GPtrArray *
+take_prepare_tasks_unlocked (ConnectionData *connection, GError *error)
+{
+    GPtrArray *completed = g_ptr_array_new_with_free_func (g_object_unref);
+
+    for (guint i = 0; i < connection->prepare_tasks->len; i++) {
+        GTask *task = g_ptr_array_index (connection->prepare_tasks, i);
+        PrepareData *data = g_task_get_task_data (task);
+
+        remove_reader (connection, get_prepare_context (connection->client, task));
+        if (error != NULL && data->error == NULL)
+            data->error = g_error_copy (error);
+        data->n_pending--;
+        if (data->n_pending == 0)
+            g_ptr_array_add (completed, g_object_ref (task));
+    }
+    g_ptr_array_set_size (connection->prepare_tasks, 0);
+
+    return completed;
+}
+
+static void
+complete_prepare_tasks (GPtrArray *tasks)
+{
+    for (guint i = 0; tasks != NULL && i < tasks->len; i++) {
+        GTask *task = g_ptr_array_index (tasks, i);
+        PrepareData *data = g_task_get_task_data (task);
+
+        if (g_task_return_error_if_cancelled (task))
+            continue;
+        if (data->error != NULL)
+            g_task_return_error (task, g_steal_pointer (&data->error));
+        else
+            g_task_return_boolean (task, TRUE);
+    }
+}
+
+/* Fail the requests waiting for a connection that couldn't be made, they may be retried later.
+ * Must be called with the requests mutex held */
+static void
+abandon_connect (ConnectionData *connection, GError *error)
+{
+    SnapdClient *self = connection->client;
+
+    g_clear_object (&connection->connect_socket);
+    g_clear_object (&connection->connect_address);
+    connection->connect_pending = FALSE;
+
+    while (!g_queue_is_empty (&connection->pending_writes)) {
+        g_autoptr(RequestData) data = g_queue_pop_head (&connection->pending_writes);
+        if (g_queue_remove (&connection->awaiting_response, data)) {
+            remove_reader (connection, get_io_context (self, data->request));
+            request_data_unref (data);
+        }
+        if (get_request_data (self, data->request) == data)
+            fail_request_unlocked (self, data, error);
+    }
+}
+
+/* Make the next attempt to connect to snapd without blocking.
+ * Returns %FALSE and sets @error if the connection can't be made.
+ * Must be called with the requests mutex held */
+static gboolean
+try_connect (ConnectionData *connection, GError **error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    if (connection->connect_socket == NULL) {
+        connection->connect_socket = create_snapd_socket (connection->client, &connection->connect_address, error);
+        if (connection->connect_socket == NULL)
+            return FALSE;
+        connection->connect_pending = FALSE;
+        connection->connect_deadline = priv->connect_timeout > 0 ? g_get_monotonic_time () + (gint64) priv->connect_timeout * 1000 : 0;
+    }
+
+    g_autoptr(GError) error_local = NULL;
+    gboolean connected;
+    if (connection->connect_pending)
+        connected = g_socket_check_connect_result (connection->connect_socket, &error_local);
+    else
+        connected = g_socket_connect (connection->connect_socket, connection->connect_address, NULL, &error_local);
+    if (connected) {
+        connection->socket = g_steal_pointer (&connection->connect_socket);
+        connection->new_socket = TRUE;
+        g_clear_object (&connection->connect_address);
+        connection->connect_pending = FALSE;
+        return TRUE;
+    }
+
+    /* TCP connections complete in the background. Unix sockets refuse the connection while
+     * the listen queue is full, e.g. when snapd is socket activated and still starting up */
+    if (g_error_matches (error_local, G_IO_ERROR, G_IO_ERROR_PENDING)) {
+        connection->connect_pending = TRUE;
+        return TRUE;
+    }
+    if (g_error_matches (error_local, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+        connection->connect_pending = FALSE;
+        return TRUE;
+    }
+
+    g_set_error (error,
+                 SNAPD_ERROR,
+                 SNAPD_ERROR_CONNECTION_FAILED,
+                 "Unable to connect snapd socket: %s",
+                 error_local->message);
+    return FALSE;
+}
+
+/* Connect to snapd if not already, and write the requests that were waiting for the connection */
+static void
+connect_to_snapd (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    g_autoptr(GPtrArray) prepared = NULL;
+    gboolean connected;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        /* May have been connected from another context */
+        if (connection->socket != NULL)
+            return;
+
+        g_autoptr(GError) error = NULL;
+        if (!try_connect (connection, &error))
+            abandon_connect (connection, error);
+        connected = connection->socket != NULL;
+        if (connection->connect_socket == NULL)
+            prepared = take_prepare_tasks_unlocked (connection, error);
+    }
+
+    update_read_sources (connection, TRUE);
+    if (connected)
+        write_pending_requests (connection);
+    complete_prepare_tasks (prepared);
+}
+
+static gboolean
+connect_ready_cb (GSocket *socket, GIOCondition condition, ConnectionData *connection)
+{
+    connect_to_snapd (connection);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+connect_retry_cb (gpointer user_data)
+{
+    connect_to_snapd (user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+connect_timeout_cb (gpointer user_data)
+{
+    ConnectionData *connection = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+
+    g_autoptr(GPtrArray) prepared = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        if (connection->connect_socket == NULL)
+            return G_SOURCE_REMOVE;
+
+        g_autoptr(GError) error = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_CONNECTION_FAILED,
+                                               "Timed out waiting for snapd to accept connection");
+        abandon_connect (connection, error);
+        prepared = take_prepare_tasks_unlocked (connection, error);
+    }
+
+    update_read_sources (connection, TRUE);
+    complete_prepare_tasks (prepared);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Make sure there is a source reading the socket in each context requests are waiting in.
+ * If @reset then the socket has changed and existing sources are replaced */
+static void
+update_read_sources (ConnectionData *connection, gboolean reset)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+    for (guint i = 0; i < connection->read_sources->len; i++) {
+        ReadSource *read_source = g_ptr_array_index (connection->read_sources, i);
+
+        if (reset && read_source->source != NULL) {
+            g_source_destroy (read_source->source);
+            g_clear_pointer (&read_source->source, g_source_unref);
+        }
+        if (reset && read_source->connect_timeout_source != NULL) {
+            g_source_destroy (read_source->connect_timeout_source);
+            g_clear_pointer (&read_source->connect_timeout_source, g_source_unref);
+        }
+        if (read_source->source != NULL || connection->paused_request != NULL)
+            continue;
+
+        if (connection->socket != NULL) {
+            read_source->source = g_socket_create_source (connection->socket, G_IO_IN, NULL);
+            g_source_set_name (read_source->source, "snapd-glib-read-source");
+            g_source_set_callback (read_source->source, (GSourceFunc) read_cb, connection, NULL);
+            g_source_attach (read_source->source, read_source->context);
+            continue;
+        }
+        if (connection->connect_socket == NULL)
+            continue;
+
+        /* Wait for the connection to complete, or to try again if snapd couldn't accept it yet */
+        if (connection->connect_pending) {
+            read_source->source = g_socket_create_source (connection->connect_socket, G_IO_OUT, NULL);
+            g_source_set_callback (read_source->source, (GSourceFunc) connect_ready_cb, connection, NULL);
+        }
+        else {
+            read_source->source = g_timeout_source_new (CONNECT_RETRY_INTERVAL);
+            g_source_set_callback (read_source->source, connect_retry_cb, connection, NULL);
+        }
+        g_source_set_name (read_source->source, "snapd-glib-connect-source");
+        g_source_attach (read_source->source, read_source->context);
+
+        if (read_source->connect_timeout_source == NULL && connection->connect_deadline != 0) {
+            gint64 remaining = connection->connect_deadline - g_get_monotonic_time ();
+            read_source->connect_timeout_source = g_timeout_source_new (remaining > 0 ? (guint) ((remaining + 999) / 1000) : 0);
+            g_source_set_name (read_source->connect_timeout_source, "snapd-glib-connect-timeout-source");
+            g_source_set_callback (read_source->connect_timeout_source, connect_timeout_cb, connection, NULL);
+            g_source_attach (read_source->connect_timeout_source, read_source->context);
+        }
+    }
+}
+
+/* Write blocks of data to snapd without joining them together first.
+ * The vectors are updated as data is written */
+static gboolean
+write_to_snapd (ConnectionData *connection, GOutputVector *vectors, gsize n_vectors, GCancellable *cancellable, GError **error)
+{
+    if (debug_enabled (DEBUG_WIRE)) {
+        for (gsize i = 0; i < n_vectors; i++)
+            debug_dump_wire ('>', vectors[i].buffer, vectors[i].size);
+    }
+
+    GOutputVector *v = vectors;
+    while (n_vectors > 0) {
+        g_autoptr(GError) error_local = NULL;
+        gssize n_written = g_socket_send_message (connection->socket, NULL, v, n_vectors, NULL, 0, G_SOCKET_MSG_NONE, cancellable, &error_local);
+        if (n_written < 0) {
+            /* Wait for snapd to read what has been sent so far */
+            if (g_error_matches (error_local, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+                if (!g_socket_condition_wait (connection->socket, G_IO_OUT, cancellable, error))
+                    return FALSE;
+                continue;
+            }
+
+            g_propagate_error (error, g_steal_pointer (&error_local));
+            return FALSE;
+        }
+
+        /* Skip over the data that was written, which may end part way through a vector */
+        gsize n_remaining = n_written;
+        while (n_vectors > 0 && n_remaining >= v->size) {
+            n_remaining -= v->size;
+            v++;
+            n_vectors--;
+        }
+        if (n_vectors > 0) {
+            v->buffer = (const guint8 *) v->buffer + n_remaining;
+            v->size -= n_remaining;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Write a block of a body using chunked transfer encoding, an empty block ends the body */
+static gboolean
+write_chunk (ConnectionData *connection, GBytes *data, GCancellable *cancellable, GError **error)
+{
+    gsize length = data != NULL ? g_bytes_get_size (data) : 0;
+    g_autofree gchar *chunk_header = g_strdup_printf ("%" G_GSIZE_MODIFIER "x\r\n", length);
+
+    GOutputVector vectors[3];
+    vectors[0].buffer = chunk_header;
+    vectors[0].size = strlen (chunk_header);
+    vectors[1].buffer = length > 0 ? g_bytes_get_data (data, NULL) : NULL;
+    vectors[1].size = length;
+    vectors[2].buffer = "\r\n";
+    vectors[2].size = 2;
+
+    return write_to_snapd (connection, vectors, 3, cancellable, error);
+}
+
+/* Write a request to snapd, with the body either written directly or as the first chunk of a streamed body */
+static gboolean
+write_request_to_snapd (ConnectionData *connection, GBytes *head, GBytes *body, gboolean chunked, GCancellable *cancellable, GError **error)
+{
+    GOutputVector vectors[2];
+    gsize n_vectors = 0;
+    vectors[n_vectors].buffer = g_bytes_get_data (head, &vectors[n_vectors].size);
+    n_vectors++;
+    if (!chunked && body != NULL) {
+        vectors[n_vectors].buffer = g_bytes_get_data (body, NULL);
+        vectors[n_vectors].size = g_bytes_get_size (body);
+        n_vectors++;
+    }
+
+    if (!write_to_snapd (connection, vectors, n_vectors, cancellable, error))
+        return FALSE;
+
+    if (chunked && body != NULL && g_bytes_get_size (body) > 0)
+        return write_chunk (connection, body, cancellable, error);
+
+    return TRUE;
+}
+
+static void write_request (SnapdClient *self, RequestData *data);
+
+/* Check if a request can be written now, or has to wait for the connection to snapd,
+ * for an upload to complete or for responses to the requests already written */
+static gboolean
+can_write (ConnectionData *connection)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (connection->client);
+    return connection->socket != NULL && connection->upload == NULL && connection->n_in_flight < priv->max_pipeline_depth;
+}
+
+/* Write requests that were waiting to be sent */
+static void
+write_pending_requests (ConnectionData *connection)
+{
+    SnapdClient *self = connection->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    while (can_write (connection) && !g_queue_is_empty (&connection->pending_writes)) {
+        g_autoptr(RequestData) data = g_queue_pop_head (&connection->pending_writes);
+
+        /* Skip requests that were cancelled while waiting, they will never get a response */
+        gboolean outstanding;
+        {
+            g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+            outstanding = get_request_data (self, data->request) != NULL;
+            if (!outstanding && g_queue_remove (&connection->awaiting_response, data)) {
+                remove_reader (connection, get_io_context (self, data->request));
+                request_data_unref (data);
+            }
+        }
+        if (outstanding)
+            write_request (self, data);
+    }
+}
+
+/* Drop the body of a request that has been completely written, unless it may be resent after a failure */
+static void
+release_request_body (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+
+    if (origin_priv->max_retries > 0 && _snapd_request_get_body_stream (data->request) == NULL && _snapd_request_get_body_fd (data->request, NULL) < 0 &&
+        !SNAPD_IS_REQUEST_ASYNC (data->request) && g_strcmp0 (_snapd_request_get_http_request (data->request, NULL)->method, "GET") == 0)
+        return;
+
+    _snapd_request_release_body (data->request);
+}
+
+/* Stop an upload that can't be completed. The connection has to be dropped as
+ * the request has only been partially sent */
+static void
+abort_upload (ConnectionData *connection, GError *error)
+{
+    g_autoptr(RequestData) data = g_steal_pointer (&connection->upload);
+    complete_request (connection->client, data->request, error);
+
+    g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                       SNAPD_ERROR_WRITE_FAILED,
+                                       "Upload to snapd aborted: %s",
+                                       error->message);
+    complete_all_requests (connection, e);
+}
+
+typedef struct
+{
+    SnapdClient *client;
+    goffset sent;
+    goffset total;
+    goffset bytes_per_second;
+} UploadProgressData;
+
+static void
+upload_progress_data_free (UploadProgressData *data)
+{
+    g_object_unref (data->client);
+    g_slice_free (UploadProgressData, data);
+}
+
+static gboolean
+upload_progress_cb (gpointer user_data)
+{
+    UploadProgressData *data = user_data;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (data->client);
+
+    if (priv->upload_progress_callback != NULL)
+        priv->upload_progress_callback (data->client, data->sent, data->total, data->bytes_per_second, priv->upload_progress_callback_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Report how much of a body has been sent, in the context the request was made from.
+ * Reports are limited like change progress, except the one when the body is complete */
+static void
+report_upload_progress (RequestData *data, goffset total)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (data->origin);
+
+    if (priv->upload_progress_callback == NULL)
+        return;
+
+    gint64 now = g_get_monotonic_time ();
+    gboolean complete = total >= 0 && data->upload_offset >= total;
+    if (!complete && data->upload_report_time != 0 &&
+        now - data->upload_report_time < (gint64) priv->min_progress_interval * 1000)
+        return;
+    data->upload_report_time = now;
+
+    UploadProgressData *progress = g_slice_new (UploadProgressData);
+    progress->client = g_object_ref (data->origin);
+    progress->sent = data->upload_offset;
+    progress->total = total;
+    gint64 elapsed = now - data->upload_start_time;
+    progress->bytes_per_second = elapsed > 0 ? (goffset) ((gdouble) data->upload_offset * G_USEC_PER_SEC / elapsed) : 0;
+    _snapd_request_dispatch (data->request, upload_progress_cb, progress, (GDestroyNotify) upload_progress_data_free);
+}
+
+/* Write the data that follows the streamed body and let other requests be written */
+static void
+end_upload (ConnectionData *connection, gboolean chunked)
+{
+    RequestData *data = connection->upload;
+
+    GCancellable *cancellable = _snapd_request_get_cancellable (data->request);
+    GBytes *trailer = _snapd_request_get_body_trailer (data->request);
+    g_autoptr(GError) error = NULL;
+    gboolean result;
+    if (chunked)
+        result = (trailer == NULL || g_bytes_get_size (trailer) == 0 || write_chunk (connection, trailer, cancellable, &error)) &&
+                 write_chunk (connection, NULL, cancellable, &error);
+    else if (trailer != NULL) {
+        GOutputVector vector = { g_bytes_get_data (trailer, NULL), g_bytes_get_size (trailer) };
+        result = write_to_snapd (connection, &vector, 1, cancellable, &error);
+    }
+    else
+        result = TRUE;
+
+    if (!result) {
+        g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                           SNAPD_ERROR_WRITE_FAILED,
+                                           "Failed to write to snapd: %s",
+                                           error->message);
+        abort_upload (connection, e);
+        return;
+    }
+
+    release_request_body (connection->client, data);
+    g_clear_pointer (&connection->upload, request_data_unref);
+    write_pending_requests (connection);
+}
+
+static void upload_read_cb (GObject *source_object, GAsyncResult *result, gpointer user_data);
+
+static void
+read_upload_block (RequestData *data)
+{
+    GMainContext *context = get_io_context (data->client, data->request);
+
+    /* Read in the context the request does I/O in, in case we were started from another one */
+    g_main_context_push_thread_default (context);
+    g_input_stream_read_bytes_async (_snapd_request_get_body_stream (data->request),
+                                     UPLOAD_BLOCK_SIZE,
+                                     G_PRIORITY_DEFAULT,
+                                     _snapd_request_get_cancellable (data->request),
+                                     upload_read_cb,
+                                     request_data_ref (data));
+    g_main_context_pop_thread_default (context);
+}
+
+static void
+upload_read_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(RequestData) data = user_data;
+    ConnectionData *connection = data->connection;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GBytes) block = g_input_stream_read_bytes_finish (G_INPUT_STREAM (source_object), result, &error);
+
+    /* Connection was dropped while reading */
+    if (connection->upload != data)
+        return;
+
+    if (block == NULL) {
+        abort_upload (connection, error);
+        return;
+    }
+
+    /* Streams of a known length are sent as is, the rest in chunks */
+    goffset length = _snapd_request_get_body_stream_length (data->request);
+    if (g_bytes_get_size (block) == 0) {
+        if (length >= 0 && data->upload_offset < length) {
+            g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_WRITE_FAILED,
+                                               "Upload stream ended early");
+            abort_upload (connection, e);
+            return;
+        }
+        /* The total of a chunked body is only known once it has all been sent */
+        if (length < 0)
+            report_upload_progress (data, data->upload_offset);
+        end_upload (connection, length < 0);
+        return;
+    }
+
+    gboolean written;
+    if (length < 0) {
+        written = write_chunk (connection, block, _snapd_request_get_cancellable (data->request), &error);
+        data->upload_offset += g_bytes_get_size (block);
+    }
+    else {
+        /* Ignore anything past the length that was promised to snapd */
+        gsize n_write = MIN (g_bytes_get_size (block), (gsize) (length - data->upload_offset));
+        GOutputVector vector = { g_bytes_get_data (block, NULL), n_write };
+        written = write_to_snapd (connection, &vector, 1, _snapd_request_get_cancellable (data->request), &error);
+        data->upload_offset += n_write;
+    }
+    if (!written) {
+        g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                           SNAPD_ERROR_WRITE_FAILED,
+                                           "Failed to write to snapd: %s",
+                                           error->message);
+        abort_upload (connection, e);
+        return;
+    }
+    report_upload_progress (data, length);
+
+    if (length >= 0 && data->upload_offset >= length) {
+        end_upload (connection, FALSE);
+        return;
+    }
+
+    read_upload_block (data);
+}
+
+/* Copy part of a file to the socket, falling back to reading it if the kernel can't copy it directly */
+static gssize
+send_file_data (int socket_fd, int fd, goffset offset, gsize count, gboolean *use_sendfile)
+{
+    if (*use_sendfile) {
+        off_t o = offset;
+        gssize n_sent = sendfile (socket_fd, fd, &o, count);
+        if (n_sent >= 0 || (errno != EINVAL && errno != ENOSYS))
+            return n_sent;
+        *use_sendfile = FALSE;
+    }
+
+    guint8 buffer[UPLOAD_BLOCK_SIZE];
+    gssize n_read = pread (fd, buffer, MIN (count, sizeof (buffer)), offset);
+    if (n_read <= 0)
+        return n_read;
+
+    /* The socket may accept only part of the data, the rest will be read again */
+    return send (socket_fd, buffer, n_read, MSG_NOSIGNAL);
+}
+
+static gboolean
+upload_write_cb (GSocket *socket, GIOCondition condition, RequestData *data)
+{
+    ConnectionData *connection = data->connection;
+
+    /* Connection was dropped */
+    if (connection->upload != data)
+        return G_SOURCE_REMOVE;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (_snapd_request_get_cancellable (data->request), &error)) {
+        abort_upload (connection, error);
+        return G_SOURCE_REMOVE;
+    }
+
+    /* Send a limited amount each time so other sources get a chance to run */
+    goffset length;
+    int fd = _snapd_request_get_body_fd (data->request, &length);
+    gsize n_sent = 0;
+    while (data->upload_offset < length && n_sent < UPLOAD_SENDFILE_SIZE) {
+        gsize count = MIN ((gsize) (length - data->upload_offset), UPLOAD_SENDFILE_SIZE - n_sent);
+        gssize n = send_file_data (g_socket_get_fd (socket), fd, data->upload_offset, count, &data->use_sendfile);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return G_SOURCE_CONTINUE;
+        if (n <= 0) {
+            int errsv = errno;
+            g_autoptr(GError) e = NULL;
+            if (n == 0)
+                e = g_error_new (SNAPD_ERROR,
+                                 SNAPD_ERROR_WRITE_FAILED,
+                                 "Snap file ended early");
+            else
+                e = g_error_new (SNAPD_ERROR,
+                                 SNAPD_ERROR_WRITE_FAILED,
+                                 "Failed to write to snapd: %s",
+                                 g_strerror (errsv));
+            abort_upload (connection, e);
+            return G_SOURCE_REMOVE;
+        }
+
+        data->upload_offset += n;
+        n_sent += n;
+    }
+    if (n_sent > 0)
+        report_upload_progress (data, length);
+
+    if (data->upload_offset < length)
+        return G_SOURCE_CONTINUE;
+
+    end_upload (connection, FALSE);
+    return G_SOURCE_REMOVE;
+}
+
+/* Start sending the body of a request that has had its headers written */
+static void
+start_upload (RequestData *data)
+{
+    ConnectionData *connection = data->connection;
+
+    if (_snapd_request_get_body_stream (data->request) != NULL) {
+        connection->upload = request_data_ref (data);
+        data->upload_offset = 0;
+        data->upload_start_time = g_get_monotonic_time ();
+        data->upload_report_time = 0;
+        read_upload_block (data);
+    }
+    else if (_snapd_request_get_body_fd (data->request, NULL) >= 0) {
+        connection->upload = request_data_ref (data);
+        data->upload_offset = 0;
+        data->upload_start_time = g_get_monotonic_time ();
+        data->upload_report_time = 0;
+        data->use_sendfile = TRUE;
+
+        /* Copy the file whenever the socket has space */
+        g_autoptr(GSource) source = g_socket_create_source (connection->socket, G_IO_OUT, NULL);
+        g_source_set_name (source, "snapd-glib-upload-source");
+        g_source_set_callback (source, (GSourceFunc) upload_write_cb, request_data_ref (data), (GDestroyNotify) request_data_unref);
+        g_source_attach (source, get_io_context (data->client, data->request));
+    }
+    else
+        release_request_body (data->client, data);
+}
+
+/* Close a connection snapd is waiting for a body on that will never be sent, and send the requests
+ * that were waiting behind it on another connection */
+static void
+drop_unsent_upload (ConnectionData *connection)
+{
+    SnapdClient *self = connection->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_autoptr(GPtrArray) unsent = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        while (!g_queue_is_empty (&connection->pending_writes)) {
+            RequestData *d = g_queue_pop_head (&connection->pending_writes);
+            if (get_request_data (self, d->request) == d)
+                g_ptr_array_add (unsent, d);
+            else
+                request_data_unref (d);
+        }
+        connection_close (connection);
+    }
+
+    for (guint i = 0; i < unsent->len; i++)
+        send_to_connection (self, g_ptr_array_index (unsent, i));
+}
+
+/* Send the body of a request that was waiting for snapd to accept it */
+static void
+continue_upload (ConnectionData *connection)
+{
+    SnapdClient *self = connection->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    RequestData *data = connection->upload;
+
+    if (data->continue_source != NULL)
+        g_source_destroy (data->continue_source);
+    g_clear_pointer (&data->continue_source, g_source_unref);
+
+    /* Don't send a body that is no longer wanted */
+    gboolean outstanding;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        outstanding = get_request_data (self, data->request) == data;
+    }
+    if (!outstanding) {
+        drop_unsent_upload (connection);
+        return;
+    }
+
+    /* The start of the body was held back with the headers */
+    GCancellable *cancellable = _snapd_request_get_cancellable (data->request);
+    g_autoptr(GBytes) body = NULL;
+    _snapd_request_get_http_request (data->request, &body);
+    if (body != NULL && g_bytes_get_size (body) > 0) {
+        g_autoptr(GError) error = NULL;
+        gboolean result;
+        if (_snapd_request_get_body_stream (data->request) != NULL && _snapd_request_get_body_stream_length (data->request) < 0)
+            result = write_chunk (connection, body, cancellable, &error);
+        else {
+            GOutputVector vector = { g_bytes_get_data (body, NULL), g_bytes_get_size (body) };
+            result = write_to_snapd (connection, &vector, 1, cancellable, &error);
+        }
+        if (!result) {
+            g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_WRITE_FAILED,
+                                               "Failed to write to snapd: %s",
+                                               error->message);
+            abort_upload (connection, e);
+            return;
+        }
+    }
+
+    g_autoptr(RequestData) d = g_steal_pointer (&connection->upload);
+    start_upload (d);
+}
+
+static gboolean
+continue_timeout_cb (gpointer user_data)
+{
+    RequestData *data = user_data;
+
+    /* snapd doesn't support the expectation, so send the body anyway */
+    continue_upload (data->connection);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Hold back the body of a request sent with "Expect: 100-continue" until snapd accepts it.
+ * Other requests aren't written on the connection until the body has been sent */
+static void
+wait_for_continue (RequestData *data)
+{
+    ConnectionData *connection = data->connection;
+
+    connection->upload = request_data_ref (data);
+    data->continue_source = g_timeout_source_new (EXPECT_CONTINUE_TIMEOUT);
+    g_source_set_name (data->continue_source, "snapd-glib-continue-source");
+    g_source_set_callback (data->continue_source, continue_timeout_cb, data, NULL);
+    g_source_attach (data->continue_source, get_io_context (data->client, data->request));
+}
+
+/* Number of requests on a connection that a request of the given priority would wait behind */
+static guint
+get_connection_load (SnapdClient *self, ConnectionData *connection, gint priority)
+{
+    guint load = connection->n_in_flight;
+    for (GList *link = connection->pending_writes.head; link != NULL; link = link->next) {
+        RequestData *d = link->data;
+        if (_snapd_request_get_priority (d->request) >= priority)
+            load++;
+    }
+
+    return load;
+}
+
+static const gchar *
+get_poll_change_id (SnapdRequest *request)
+{
+    if (SNAPD_IS_GET_CHANGE (request))
+        return _snapd_get_change_get_change_id (SNAPD_GET_CHANGE (request));
+    else if (SNAPD_IS_POST_CHANGE (request))
+        return _snapd_post_change_get_change_id (SNAPD_POST_CHANGE (request));
+    else
+        return NULL;
+}
+
+/* Pick the connection to send a request on, must be called with the requests mutex held */
+static ConnectionData *
+choose_connection (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    /* Notices requests and followed logs can wait for a long time so each has a connection to itself */
+    if (is_long_lived (data->request) && !priv->socket_provided) {
+        for (guint i = 0; i < priv->notices_connections->len; i++) {
+            ConnectionData *c = g_ptr_array_index (priv->notices_connections, i);
+            if (g_queue_is_empty (&c->awaiting_response))
+                return c;
+        }
+
+        ConnectionData *connection = connection_new (self);
+        g_ptr_array_add (priv->notices_connections, connection);
+        return connection;
+    }
+
+    /* Requests for a change follow the request that started it so they are answered in order */
+    const gchar *change_id = get_poll_change_id (data->request);
+    RequestData *parent = NULL;
+    if (change_id != NULL) {
+        parent = g_hash_table_lookup (priv->change_requests, change_id);
+        if (parent != NULL && parent->connection != NULL && parent->connection->upload == NULL)
+            return parent->connection;
+    }
+
+    /* Use the least busy connection, avoiding ones that are uploading */
+    ConnectionData *connection = NULL;
+    guint connection_load = 0;
+    gboolean connection_uploading = FALSE;
+    for (guint i = 0; i < priv->connections->len; i++) {
+        ConnectionData *c = g_ptr_array_index (priv->connections, i);
+        gboolean uploading = c->upload != NULL;
+        guint load = get_connection_load (self, c, _snapd_request_get_priority (data->request));
+
+        if (connection == NULL ||
+            (connection_uploading && !uploading) ||
+            (uploading == connection_uploading && load < connection_load)) {
+            connection = c;
+            connection_load = load;
+            connection_uploading = uploading;
+        }
+    }
+
+    /* Open another connection if all the existing ones are busy */
+    guint max_connections = priv->socket_provided ? 1 : priv->max_connections;
+    if ((connection == NULL || connection_load > 0 || connection_uploading) && priv->connections->len < max_connections) {
+        connection = connection_new (self);
+        g_ptr_array_add (priv->connections, connection);
+    }
+
+    /* Later polls go to the same connection */
+    if (parent != NULL)
+        parent->connection = connection;
+
+    return connection;
+}
+
+/* Queue a request behind the ones waiting to be written with the same or a higher priority.
+ * Must be called with the requests mutex held */
+static void
+queue_pending_write (ConnectionData *connection, RequestData *data)
+{
+    gint priority = _snapd_request_get_priority (data->request);
+
+    GList *link;
+    for (link = connection->pending_writes.head; link != NULL; link = link->next) {
+        RequestData *d = link->data;
+        if (_snapd_request_get_priority (d->request) < priority)
+            break;
+    }
+    if (link == NULL) {
+        g_queue_push_tail (&connection->pending_writes, data);
+        return;
+    }
+
+    /* Responses are matched in the order requests are written, so keep the order the same */
+    RequestData *next = link->data;
+    g_queue_insert_before (&connection->pending_writes, link, data);
+    GList *awaiting_link = g_queue_find (&connection->awaiting_response, next);
+    if (g_queue_remove (&connection->awaiting_response, data))
+        g_queue_insert_before (&connection->awaiting_response, awaiting_link, data);
+}
+
+static void queue_request (SnapdClient *self, SnapdRequest *request);
+static GBytes *get_common_headers (SnapdClient *self);
+
+static gboolean
+timeout_cb (gpointer user_data)
+{
+    RequestData *data = user_data;
+    SnapdClient *self = data->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    ConnectionData *connection = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        g_clear_pointer (&data->timeout_source, g_source_unref);
+        if (get_request_data (self, data->request) != data)
+            return G_SOURCE_REMOVE;
+
+        /* Once written the response has to be read before any to later requests on the connection,
+         * and snapd may never send it, so the connection is abandoned. Unwritten requests are just dropped */
+        ConnectionData *c = data->connection;
+        if (c != NULL && c->socket != NULL &&
+            (c->response.request == data->request ||
+             (g_queue_find (&c->awaiting_response, data) != NULL && g_queue_find (&c->pending_writes, data) == NULL)))
+            connection = c;
+
+        g_autoptr(GError) error = g_error_new (G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "Timed out waiting for snapd");
+        complete_request_unlocked (self, data->request, error);
+    }
+
+    if (connection != NULL) {
+        g_autoptr(GError) error = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_READ_FAILED,
+                                               "snapd connection abandoned after a request timed out");
+        complete_all_requests (connection, error);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Fail a request if it hasn't completed by its deadline. Asynchronous operations and the requests
+ * they make to follow their changes aren't limited. Must be called with the requests mutex held */
+static void
+start_timeout (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    gint64 deadline = _snapd_request_get_deadline (data->request);
+    if (deadline == 0 || SNAPD_IS_REQUEST_ASYNC (data->request) || is_long_lived (data->request))
+        return;
+    const gchar *change_id = get_poll_change_id (data->request);
+    if (change_id != NULL && g_hash_table_contains (priv->change_requests, change_id))
+        return;
+
+    gint64 remaining = deadline - g_get_monotonic_time ();
+    data->timeout_source = g_timeout_source_new (remaining > 0 ? (guint) ((remaining + 999) / 1000) : 0);
+    g_source_set_callback (data->timeout_source, timeout_cb, data, NULL);
+    g_source_attach (data->timeout_source, get_io_context (self, data->request));
+}
+
+enum
+{
+    SIGNAL_REQUEST_FINISHED,
+    SIGNAL_SLOW_REQUEST,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+/* Describe what a request is waiting for. Must be called with the requests mutex held */
+static SnapdPendingRequest *
+make_pending_request (RequestData *data, gint64 now)
+{
+    SnapdRequestTimings *timings = _snapd_request_get_timings (data->request);
+
+    /* Requests sharing the response of another are at the same point as it */
+    SnapdRequestTimings *progress = data->leader != NULL ? _snapd_request_get_timings (data->leader->request) : timings;
+
+    const gchar *change_id = SNAPD_IS_REQUEST_ASYNC (data->request) ? _snapd_request_async_get_change_id (SNAPD_REQUEST_ASYNC (data->request)) : NULL;
+    SnapdPendingRequestState state;
+    if (change_id != NULL)
+        state = SNAPD_PENDING_REQUEST_STATE_POLLING;
+    else if (snapd_request_timings_get_time (progress, SNAPD_REQUEST_PHASE_BODY) != 0)
+        state = SNAPD_PENDING_REQUEST_STATE_PARSING;
+    else if (snapd_request_timings_get_time (progress, SNAPD_REQUEST_PHASE_HEADERS) != 0)
+        state = SNAPD_PENDING_REQUEST_STATE_RECEIVING;
+    else if (snapd_request_timings_get_time (progress, SNAPD_REQUEST_PHASE_WRITTEN) != 0)
+        state = SNAPD_PENDING_REQUEST_STATE_WAITING;
+    else
+        state = SNAPD_PENDING_REQUEST_STATE_QUEUED;
+
+    gint64 started = snapd_request_timings_get_time (timings, SNAPD_REQUEST_PHASE_STARTED);
+    return _snapd_pending_request_new (snapd_request_timings_get_method (timings),
+                                       snapd_request_timings_get_path (timings),
+                                       state,
+                                       change_id,
+                                       started != 0 ? now - started : 0,
+                                       snapd_request_timings_get_bytes_sent (progress),
+                                       snapd_request_timings_get_bytes_received (progress) + _snapd_request_timings_get_bytes_pending (progress));
+}
+
+static gboolean
+slow_request_cb (gpointer user_data)
+{
+    RequestData *d = user_data;
+    SnapdClient *self = d->client;
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_autoptr(SnapdPendingRequest) pending_request = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        RequestData *data = get_request_data (self, d->request);
+        if (data == NULL)
+            return G_SOURCE_REMOVE;
+        g_clear_pointer (&data->slow_source, g_source_unref);
+        pending_request = make_pending_request (data, g_get_monotonic_time ());
+    }
+
+    g_signal_emit (d->origin, signals[SIGNAL_SLOW_REQUEST], 0, pending_request);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Report the request if it hasn't completed by the slow request threshold. Must be called with the requests mutex held */
+static void
+start_slow_timer (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+
+    if (origin_priv->slow_request_threshold == 0)
+        return;
+
+    /* The signal is emitted in the context the request was made in, which may not be the I/O thread.
+     * The timer has its own reference to the request as the request data isn't thread-safe */
+    data->slow_source = g_timeout_source_new (origin_priv->slow_request_threshold);
+    g_source_set_callback (data->slow_source, slow_request_cb, request_data_new (self, data->request), (GDestroyNotify) request_data_unref);
+    g_source_attach (data->slow_source, _snapd_request_get_context (data->request));
+}
+
+/* Log how long each phase of a request took, in milliseconds */
+static void
+log_timings (SnapdRequest *request, SnapdRequestTimings *timings)
+{
+    static const gchar *phase_names[] = { NULL, "write", "wait", "headers", "body", "parse", "callback" };
+
+    SnapdHttpRequest *http_request = _snapd_request_get_http_request (request, NULL);
+    g_autoptr(GString) line = g_string_new (NULL);
+    g_string_append_printf (line, "%s %s %u sent=%" G_GSIZE_FORMAT " received=%" G_GSIZE_FORMAT,
+                            http_request->method, http_request->path,
+                            snapd_request_timings_get_status_code (timings),
+                            snapd_request_timings_get_bytes_sent (timings),
+                            snapd_request_timings_get_bytes_received (timings));
+
+    /* Phases that were skipped, e.g. for cached responses, are measured from the last phase reached */
+    SnapdRequestPhase last = SNAPD_REQUEST_PHASE_STARTED;
+    for (SnapdRequestPhase phase = SNAPD_REQUEST_PHASE_WRITTEN; phase <= SNAPD_REQUEST_PHASE_COMPLETED; phase++) {
+        gint64 duration = snapd_request_timings_get_duration (timings, last, phase);
+        if (duration < 0) {
+            g_string_append_printf (line, " %s=-", phase_names[phase]);
+            continue;
+        }
+        g_string_append_printf (line, " %s=%.3f", phase_names[phase], duration / 1000.0);
+        last = phase;
+    }
+    gint64 total = snapd_request_timings_get_duration (timings, SNAPD_REQUEST_PHASE_STARTED, SNAPD_REQUEST_PHASE_COMPLETED);
+    g_string_append_printf (line, " total=%.3f", total / 1000.0);
+
+    debug_log ("timing", "%s", line->str);
+}
+
+static void
+request_finished_cb (SnapdRequest *request, gpointer user_data)
+{
+    SnapdClient *self = user_data;
+    SnapdRequestTimings *timings = _snapd_request_get_timings (request);
+
+    if (debug_enabled (DEBUG_TIMING))
+        log_timings (request, timings);
+
+    g_signal_emit (self, signals[SIGNAL_REQUEST_FINISHED], 0, timings);
+}
+
+static gboolean
+send_request_cb (gpointer user_data)
+{
+    SnapdRequest *request = user_data;
+
+    g_autoptr(GObject) source_object = g_async_result_get_source_object (G_ASYNC_RESULT (request));
+    queue_request (SNAPD_CLIENT (source_object), request);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Take all the submitted requests, oldest first */
+static Submission *
+take_submissions (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    Submission *head;
+    do
+        head = g_atomic_pointer_get (&priv->submissions);
+    while (!g_atomic_pointer_compare_and_exchange (&priv->submissions, head, NULL));
+
+    Submission *submissions = NULL;
+    while (head != NULL) {
+        Submission *next = head->next;
+        head->next = submissions;
+        submissions = head;
+        head = next;
+    }
+
+    return submissions;
+}
+
+/* Send requests submitted from other threads, after they have been taken off the list */
+static void
+queue_submissions (SnapdClient *self, Submission *submissions)
+{
+    while (submissions != NULL) {
+        Submission *next = submissions->next;
+        g_autoptr(SnapdRequest) request = submissions->request;
+        g_slice_free (Submission, submissions);
+        queue_request (self, request);
+        submissions = next;
+    }
+}
+
+static gboolean
+submit_source_dispatch (GSource *source, GSourceFunc callback, gpointer user_data)
+{
+    return callback (user_data);
+}
+
+static GSourceFuncs submit_source_funcs = {
+    NULL,
+    NULL,
+    submit_source_dispatch,
+    NULL,
+    NULL,
+    NULL
+};
+
+static gboolean
+submit_cb (gpointer user_data)
+{
+    SnapdClient *self = user_data;
+
+    /* Stop before taking the list so a request submitted after this wakes the context again */
+    g_source_set_ready_time (g_main_current_source (), -1);
+    Submission *submissions = take_submissions (self);
+    if (submissions == NULL)
+        return G_SOURCE_CONTINUE;
+
+    /* The submitted requests keep the client alive until they are sent */
+    g_autoptr(SnapdClient) client = g_object_ref (self);
+    queue_submissions (self, submissions);
+
+    return G_SOURCE_CONTINUE;
+}
+
+/* Hand a request to the I/O context without blocking on anything it is doing.
+ * Returns %FALSE if there is no I/O context or this thread is running it, so the request should be sent directly */
+static gboolean
+submit_request (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    /* Keep the source alive in case the I/O context is cleared while submitting */
+    g_autoptr(GSource) submit_source = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->submit_mutex);
+        if (priv->submit_source == NULL || g_main_context_is_owner (priv->io_context))
+            return FALSE;
+        submit_source = g_source_ref (priv->submit_source);
+    }
+
+    Submission *submission = g_slice_new (Submission);
+    submission->request = g_object_ref (request);
+    Submission *head;
+    do {
+        head = g_atomic_pointer_get (&priv->submissions);
+        submission->next = head;
+    } while (!g_atomic_pointer_compare_and_exchange (&priv->submissions, head, submission));
+
+    if (head == NULL)
+        g_source_set_ready_time (submit_source, 0);
+
+    /* If the I/O context was cleared before the request was added it won't be picked up, so send it from here */
+    if (g_source_is_destroyed (submit_source))
+        queue_submissions (self, take_submissions (self));
+
+    return TRUE;
+}
+
+/* Start using @context for I/O */
+static void
+set_io_context (SnapdClient *self, GMainContext *context)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    GSource *submit_source = g_source_new (&submit_source_funcs, sizeof (GSource));
+    g_source_set_name (submit_source, "snapd-glib-submit-source");
+    g_source_set_callback (submit_source, submit_cb, self, NULL);
+    g_source_attach (submit_source, context);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->submit_mutex);
+    priv->io_context = g_main_context_ref (context);
+    priv->submit_source = submit_source;
+}
+
+/* Stop using the I/O context. Requests that it hasn't picked up yet are sent from this thread */
+static void
+clear_io_context (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->submit_mutex);
+        if (priv->submit_source != NULL)
+            g_source_destroy (priv->submit_source);
+        g_clear_pointer (&priv->submit_source, g_source_unref);
+        g_clear_pointer (&priv->io_context, g_main_context_unref);
+    }
+    queue_submissions (self, take_submissions (self));
+}
+
+static void
+send_request (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    SNAPD_TRACE1 (request__enqueue, request);
+
+    _snapd_request_set_source_object (request, G_OBJECT (self));
+    _snapd_request_set_lazy_parsing (request, priv->lazy_parsing);
+    _snapd_request_set_share_snaps (request, priv->share_snaps);
+    _snapd_request_set_memory_counter (request, priv->track_memory ? priv->memory_counter : NULL);
+    if (uses_catalog_cache (request))
+        _snapd_request_set_catalog_cache (request, priv->catalog_cache);
+    _snapd_request_set_priority (request, priv->request_priority);
+    _snapd_request_set_max_response_size (request, priv->max_response_size);
+    gint64 deadline = priv->request_deadline;
+    if (priv->request_timeout > 0) {
+        gint64 timeout_deadline = g_get_monotonic_time () + (gint64) priv->request_timeout * 1000;
+        if (deadline == 0 || timeout_deadline < deadline)
+            deadline = timeout_deadline;
+    }
+    _snapd_request_set_deadline (request, deadline);
+    _snapd_request_set_finished_callback (request, request_finished_cb, self);
+    _snapd_request_set_items_delivered_callback (request, items_delivered_cb, self);
+    _snapd_request_timings_set_time (_snapd_request_get_timings (request), SNAPD_REQUEST_PHASE_STARTED, g_get_monotonic_time ());
+
+    /* Connections are only used from the I/O thread */
+    if (submit_request (self, request))
+        return;
+
+    queue_request (self, request);
+}
+
+static void
+queue_request (SnapdClient *self, SnapdRequest *request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    // This code can be replaced with support in libsoup3 at some point.
+    // https://gitlab.gnome.org/GNOME/libsoup/-/issues/75
+
+    /* Hand over to the client owning the shared connections, keeping this client's headers */
+    if (priv->transport != NULL) {
+        SnapdClient *transport_client = _snapd_transport_get_client (priv->transport);
+        g_autoptr(GBytes) common_headers = get_common_headers (self);
+        _snapd_request_set_common_headers (request, common_headers);
+        _snapd_request_set_items_delivered_callback (request, items_delivered_cb, transport_client);
+        queue_request (transport_client, request);
+        return;
+    }
+
+    g_autoptr(RequestData) data = request_data_new (self, request);
+
+    /* Record what the request is now so it can be shown while queued */
+    SnapdHttpRequest *http_request = _snapd_request_get_http_request (request, NULL);
+    _snapd_request_timings_set_request (_snapd_request_get_timings (request), http_request->method, http_request->path);
+    if (_snapd_request_can_copy_response (request)) {
+        /* The query selects what is returned, so requests only share responses if it matches too */
+        if (http_request->query != NULL)
+            data->response_key = g_strdup_printf ("%s %s?%s", http_request->method, http_request->path, http_request->query);
+        else
+            data->response_key = g_strdup_printf ("%s %s", http_request->method, http_request->path);
+    }
+    gboolean cached = FALSE;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        /* Drop the previous request with the same key. If it is still waiting to be
+         * written it is never sent, otherwise its response is discarded unparsed */
+        const gchar *supersede_key = _snapd_request_get_supersede_key (request);
+        if (supersede_key != NULL) {
+            SnapdRequest *superseded_request = g_hash_table_lookup (priv->superseding_requests, supersede_key);
+            if (superseded_request != NULL) {
+                g_autoptr(GError) error = g_error_new (G_IO_ERROR, G_IO_ERROR_CANCELLED, "Superseded by a newer request");
+                complete_request_unlocked (self, superseded_request, error);
+            }
+            g_hash_table_insert (priv->superseding_requests, g_strdup (supersede_key), request);
+        }
+
+        /* Responses are cached and shared using the settings and caches of the client that made the request */
+        SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (data->origin);
+        g_autoptr(GMutexLocker) origin_locker = lock_origin (self, data->origin);
+
+        /* Use a recent response to the same request */
+        if (data->response_key != NULL)
+            data->cache_ttl = get_cache_ttl (data->origin, request);
+        if (data->cache_ttl > 0) {
+            SnapdRequest *cached_request = lookup_cache (data->origin, data->response_key);
+            if (cached_request != NULL) {
+                _snapd_request_copy_response (request, cached_request);
+                origin_priv->cache_hits++;
+                cached = TRUE;
+            }
+            else
+                origin_priv->cache_misses++;
+        }
+
+        /* Share the response to an identical request that is already waiting for one */
+        if (!cached && origin_priv->coalesce_requests && data->response_key != NULL) {
+            RequestData *leader = g_hash_table_lookup (origin_priv->coalesced_requests, data->response_key);
+            if (leader != NULL) {
+                data->leader = request_data_ref (leader);
+                if (leader->followers == NULL)
+                    leader->followers = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
+                g_ptr_array_add (leader->followers, request_data_ref (data));
+                g_hash_table_insert (priv->requests, request, request_data_ref (data));
+                start_timeout (self, data);
+                start_slow_timer (self, data);
+            }
+            else
+                g_hash_table_insert (origin_priv->coalesced_requests, g_strdup (data->response_key), data);
+        }
+    }
+    if (cached) {
+        complete_request (self, request, NULL);
+        return;
+    }
+    if (data->leader != NULL) {
+        GCancellable *cancellable = _snapd_request_get_cancellable (request);
+        if (cancellable != NULL)
+            data->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (request_cancelled_cb), request_data_new (self, request), (GDestroyNotify) request_data_unref);
+        return;
+    }
+
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        g_hash_table_insert (priv->requests, request, request_data_ref (data));
+        start_timeout (self, data);
+        start_slow_timer (self, data);
+        if (SNAPD_IS_POST_CHANGE (request))
+            g_hash_table_insert (priv->post_change_requests, g_strdup (_snapd_post_change_get_change_id (SNAPD_POST_CHANGE (request))), data);
+    }
+
+    GCancellable *cancellable = _snapd_request_get_cancellable (request);
+    if (cancellable != NULL)
+        data->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (request_cancelled_cb), request_data_new (self, request), (GDestroyNotify) request_data_unref);
+
+    send_to_connection (self, data);
+}
+
+/* Write a request on a connection, or queue it to be written */
+static void
+send_to_connection (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    ConnectionData *connection;
+    gboolean write_now = FALSE, start_connect = FALSE, wait_for_connect = FALSE;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        /* May have completed while waiting to be retried */
+        if (get_request_data (self, data->request) != data)
+            return;
+
+        connection = data->connection = choose_connection (self, data);
+        g_queue_push_tail (&connection->awaiting_response, request_data_ref (data));
+        add_reader (connection, get_io_context (self, data->request));
+
+        /* Requests can't be written until connected, while another request is streaming its body or
+         * too many are waiting for responses */
+        if (can_write (connection) && g_queue_is_empty (&connection->pending_writes))
+            write_now = TRUE;
+        else {
+            queue_pending_write (connection, request_data_ref (data));
+            start_connect = connection->socket == NULL && connection->connect_socket == NULL;
+            wait_for_connect = connection->connect_socket != NULL;
+        }
+    }
+
+    if (write_now)
+        write_request (self, data);
+    /* Start connecting, or also wait for the connection being made in this request's context */
+    else if (start_connect)
+        connect_to_snapd (connection);
+    else if (wait_for_connect)
+        update_read_sources (connection, FALSE);
+}
+
+static void
+append_header (GByteArray *array, const gchar *name, const gchar *value)
+{
+    append_string (array, name);
+    append_string (array, ": ");
+    append_string (array, value);
+    append_string (array, "\r\n");
+}
+
+/* Get the headers that are the same for every request. These are generated once and
+ * regenerated when the client settings or the language change */
+static GBytes *
+get_common_headers (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->headers_mutex);
+
+    /* GLib returns the same language names until the locale environment variables change */
+    const gchar * const *languages = g_get_language_names ();
+    if (priv->common_headers != NULL && priv->common_headers_languages == languages)
+        return g_bytes_ref (priv->common_headers);
+
+    g_autoptr(GByteArray) headers = g_byte_array_new ();
+    append_header (headers, "Host", "");
+    append_header (headers, "Connection", "keep-alive");
+    if (priv->user_agent != NULL)
+        append_header (headers, "User-Agent", priv->user_agent);
+    if (priv->allow_interaction)
+        append_header (headers, "X-Allow-Interaction", "true");
+
+    g_autofree gchar *accept_languages = get_accept_languages ();
+    append_header (headers, "Accept-Language", accept_languages);
+
+    if (priv->auth_data != NULL) {
+        g_autoptr(GString) authorization = g_string_new ("");
+        g_string_append_printf (authorization, "Macaroon root=\"%s\"", snapd_auth_data_get_macaroon (priv->auth_data));
+        GStrv discharges = snapd_auth_data_get_discharges (priv->auth_data);
+        if (discharges != NULL)
+            for (gsize i = 0; discharges[i] != NULL; i++)
+                g_string_append_printf (authorization, ",discharge=\"%s\"", discharges[i]);
+        append_header (headers, "Authorization", authorization->str);
+    }
+
+    g_clear_pointer (&priv->common_headers, g_bytes_unref);
+    priv->common_headers = g_byte_array_free_to_bytes (g_steal_pointer (&headers));
+    priv->common_headers_languages = languages;
+
+    return g_bytes_ref (priv->common_headers);
+}
+
+/* Regenerate the common headers before the next request is sent */
+static void
+clear_common_headers (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->headers_mutex);
+    g_clear_pointer (&priv->common_headers, g_bytes_unref);
+    g_hash_table_remove_all (priv->prepared_requests);
+}
+
+/* A serialized request head, reused while the common headers it was made with are current */
+typedef struct
+{
+    gchar *method;
+    gchar *path;
+    gchar *query;
+    GBytes *common_headers;
+    GBytes *head;
+} PreparedRequest;
+
+static void
+prepared_request_free (PreparedRequest *prepared)
+{
+    g_free (prepared->method);
+    g_free (prepared->path);
+    g_free (prepared->query);
+    g_bytes_unref (prepared->common_headers);
+    g_bytes_unref (prepared->head);
+    g_slice_free (PreparedRequest, prepared);
+}
+
+static guint
+prepared_request_hash (gconstpointer key)
+{
+    const PreparedRequest *prepared = key;
+    return g_str_hash (prepared->method) ^ g_str_hash (prepared->path) ^ (prepared->query != NULL ? g_str_hash (prepared->query) : 0);
+}
+
+static gboolean
+prepared_request_equal (gconstpointer a, gconstpointer b)
+{
+    const PreparedRequest *prepared_a = a, *prepared_b = b;
+    return g_str_equal (prepared_a->method, prepared_b->method) &&
+           g_str_equal (prepared_a->path, prepared_b->path) &&
+           g_strcmp0 (prepared_a->query, prepared_b->query) == 0;
+}
+
+/* Write the request line and the headers specific to @http_request */
+static void
+append_request_head (GByteArray *array, SnapdHttpRequest *http_request)
+{
+    append_string (array, http_request->method);
+    append_string (array, " ");
+    append_string (array, http_request->path);
+    if (http_request->query != NULL) {
+        append_string (array, "?");
+        append_string (array, http_request->query);
+    }
+    append_string (array, " HTTP/1.1\r\n");
+    for (guint i = 0; i < http_request->header_names->len; i++)
+        append_header (array, g_ptr_array_index (http_request->header_names, i), g_ptr_array_index (http_request->header_values, i));
+}
+
+/* Get the complete head of a request that has no body or headers of its own.
+ * Requests repeated with the same method, path and query, such as change polls, reuse the same bytes */
+static GBytes *
+get_prepared_request (SnapdClient *self, SnapdRequest *request, SnapdHttpRequest *http_request)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    GBytes *request_headers = _snapd_request_get_common_headers (request);
+    g_autoptr(GBytes) common_headers = request_headers != NULL ? g_bytes_ref (request_headers) : get_common_headers (self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->headers_mutex);
+
+    /* Prepared requests keep their common headers alive, so an unchanged pointer means unchanged headers */
+    PreparedRequest key = { http_request->method, http_request->path, http_request->query, NULL, NULL };
+    PreparedRequest *prepared = g_hash_table_lookup (priv->prepared_requests, &key);
+    if (prepared != NULL && prepared->common_headers == common_headers)
+        return g_bytes_ref (prepared->head);
+
+    g_autoptr(GByteArray) head = g_byte_array_new ();
+    append_request_head (head, http_request);
+    g_byte_array_append (head, g_bytes_get_data (common_headers, NULL), g_bytes_get_size (common_headers));
+    append_string (head, "\r\n");
+
+    if (prepared == NULL) {
+        if (g_hash_table_size (priv->prepared_requests) >= MAX_PREPARED_REQUESTS)
+            g_hash_table_remove_all (priv->prepared_requests);
+        prepared = g_slice_new0 (PreparedRequest);
+        prepared->method = g_strdup (http_request->method);
+        prepared->path = g_strdup (http_request->path);
+        prepared->query = g_strdup (http_request->query);
+        g_hash_table_add (priv->prepared_requests, prepared);
+    }
+    g_clear_pointer (&prepared->common_headers, g_bytes_unref);
+    prepared->common_headers = g_bytes_ref (common_headers);
+    g_clear_pointer (&prepared->head, g_bytes_unref);
+    prepared->head = g_byte_array_free_to_bytes (g_steal_pointer (&head));
+
+    return g_bytes_ref (prepared->head);
+}
+
+/* Record that a request has been written to snapd */
+static void
+mark_written (SnapdRequest *request, SnapdHttpRequest *http_request, gsize n_bytes)
+{
+    SnapdRequestTimings *timings = _snapd_request_get_timings (request);
+    if (snapd_request_timings_get_method (timings) == NULL)
+        _snapd_request_timings_set_request (timings, http_request->method, http_request->path);
+    _snapd_request_timings_add_bytes_sent (timings, n_bytes);
+    _snapd_request_timings_set_time (timings, SNAPD_REQUEST_PHASE_WRITTEN, g_get_monotonic_time ());
+    SNAPD_TRACE4 (request__write, request, http_request->method, http_request->path, n_bytes);
+}
+
+/* Serialize the head of a request that has a body or headers of its own */
+static GBytes *
+generate_request_head (SnapdClient *self, SnapdRequest *request, SnapdHttpRequest *http_request, goffset *content_length, gboolean *expect_continue)
+{
+    SnapdClientPrivate *origin_priv = snapd_client_get_instance_private (get_origin (self, request));
+
+    g_autoptr(GBytes) body = NULL;
+    _snapd_request_get_http_request (request, &body);
+    GInputStream *body_stream = _snapd_request_get_body_stream (request);
+    goffset body_stream_length = _snapd_request_get_body_stream_length (request);
+    gboolean chunked = body_stream != NULL && body_stream_length < 0;
+    goffset body_fd_length;
+    int body_fd = _snapd_request_get_body_fd (request, &body_fd_length);
+
+    g_autoptr(GByteArray) request_data = g_byte_array_new ();
+    append_request_head (request_data, http_request);
+    *content_length = 0;
+    if (chunked)
+        append_header (request_data, "Transfer-Encoding", "chunked");
+    else if (body_stream != NULL || body_fd >= 0 || body != NULL) {
+        if (body_stream != NULL)
+            *content_length = body_stream_length;
+        else
+            *content_length = body_fd >= 0 ? body_fd_length : 0;
+        GBytes *trailer = _snapd_request_get_body_trailer (request);
+        if (body != NULL)
+            *content_length += g_bytes_get_size (body);
+        if (trailer != NULL)
+            *content_length += g_bytes_get_size (trailer);
+        g_autofree gchar *content_length_value = g_strdup_printf ("%" G_GINT64_FORMAT, (gint64) *content_length);
+        append_header (request_data, "Content-Length", content_length_value);
+    }
+
+    /* Check snapd will accept a large upload before sending it, so a rejection doesn't have to wait for the body */
+    *expect_continue = (body_stream != NULL || body_fd >= 0) && origin_priv->expect_continue_size > 0 &&
+                       (chunked || *content_length > origin_priv->expect_continue_size);
+    if (*expect_continue)
+        append_header (request_data, "Expect", "100-continue");
+    GBytes *request_headers = _snapd_request_get_common_headers (request);
+    g_autoptr(GBytes) common_headers = request_headers != NULL ? g_bytes_ref (request_headers) : get_common_headers (self);
+    g_byte_array_append (request_data, g_bytes_get_data (common_headers, NULL), g_bytes_get_size (common_headers));
+    append_string (request_data, "\r\n");
+
+    return g_byte_array_free_to_bytes (g_steal_pointer (&request_data));
+}
+
+/* Get @head without its Authorization header, so macaroons aren't sent in plain text over the network */
+static GBytes *
+remove_authorization (GBytes *head)
+{
+    gsize length;
+    const gchar *data = g_bytes_get_data (head, &length);
+    const gchar *start = g_strstr_len (data, length, "\r\nAuthorization: ");
+    if (start == NULL)
+        return g_bytes_ref (head);
+    start += 2;
+    const gchar *end = g_strstr_len (start, data + length - start, "\r\n") + 2;
+
+    g_autoptr(GByteArray) array = g_byte_array_sized_new (length);
+    g_byte_array_append (array, (const guint8 *) data, start - data);
+    g_byte_array_append (array, (const guint8 *) end, data + length - end);
+    return g_byte_array_free_to_bytes (g_steal_pointer (&array));
+}
+
+static void
+write_request (SnapdClient *self, RequestData *data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    ConnectionData *connection = data->connection;
+    SnapdRequest *request = data->request;
+    GCancellable *cancellable = _snapd_request_get_cancellable (request);
+
+    g_autoptr(GBytes) body = NULL;
+    SnapdHttpRequest *http_request = _snapd_request_get_http_request (request, &body);
+    GInputStream *body_stream = _snapd_request_get_body_stream (request);
+    goffset body_stream_length = _snapd_request_get_body_stream_length (request);
+    gboolean chunked = body_stream != NULL && body_stream_length < 0;
+    goffset body_fd_length;
+    int body_fd = _snapd_request_get_body_fd (request, &body_fd_length);
+
+    g_autoptr(GBytes) request_head = NULL;
+    goffset content_length = 0;
+    gboolean expect_continue = FALSE;
+    if (body_stream == NULL && body_fd < 0 && body == NULL && http_request->header_names->len == 0)
+        request_head = get_prepared_request (self, request, http_request);
+    else
+        request_head = generate_request_head (self, request, http_request, &content_length, &expect_continue);
+    if (g_socket_get_family (connection->socket) != G_SOCKET_FAMILY_UNIX) {
+        GBytes *head = remove_authorization (request_head);
+        g_bytes_unref (request_head);
+        request_head = head;
+    }
+
+    update_read_sources (connection, FALSE);
+
+    /* send HTTP request */
+    g_autoptr(GError) error = NULL;
+    gboolean new_socket = connection->new_socket;
+    connection->new_socket = FALSE;
+    if (write_request_to_snapd (connection, request_head, expect_continue ? NULL : body, chunked, cancellable, &error)) {
+        connection->n_in_flight++;
+        mark_written (request, http_request, g_bytes_get_size (request_head) + content_length);
+        if (expect_continue)
+            wait_for_continue (data);
+        else
+            start_upload (data);
+        return;
+    }
+
+    /* If was re-using closed socket, then reconnect and send it again once connected */
+    if (!new_socket && g_error_matches (error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE)) {
+        g_clear_object (&connection->socket);
+        {
+            g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->statistics_mutex);
+            priv->n_reconnects++;
+        }
+
+        {
+            g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+            g_queue_push_head (&connection->pending_writes, request_data_ref (data));
+        }
+        connect_to_snapd (connection);
+        return;
+    }
+
+    g_autoptr(GError) e = g_error_new (SNAPD_ERROR,
+                                       SNAPD_ERROR_WRITE_FAILED,
+                                       "Failed to write to snapd: %s",
+                                       error->message);
+    complete_request (self, request, e);
+}
+
+/**
+ * snapd_client_connect_async:
+ * @client: a #SnapdClient
+ * @cancellable: (allow-none): a #GCancellable or %NULL
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * This method is no longer required and does nothing, snapd-glib now connects on demand.
+ *
+ * Since: 1.3
+ * Deprecated: 1.24
+ */
+void
+snapd_client_connect_async (SnapdClient *self,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * snapd_client_connect_finish:
+ * @client: a #SnapdClient
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_connect_async().
+ * See snapd_client_connect_sync() for more information.
+ *
+ * Returns: %TRUE if successfully connected to snapd.
+ *
+ * Since: 1.3
+ */
+gboolean
+snapd_client_connect_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static gboolean
+prepare_cb (gpointer user_data)
+{
+    GTask *task = user_data;
+    SnapdClient *self = g_task_get_source_object (task);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    GMainContext *context = get_prepare_context (self, task);
+    PrepareData *data = g_task_get_task_data (task);
+
+    /* Wait for any connections that aren't open yet, starting them if nothing else has.
+     * Once made, they are watched until they are needed */
+    g_autoptr(GPtrArray) connecting = g_ptr_array_new ();
+    g_autoptr(GPtrArray) waiting = g_ptr_array_new ();
+    gboolean connected;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+
+        guint max_connections = priv->socket_provided ? 1 : priv->max_connections;
+        while (priv->connections->len < max_connections)
+            g_ptr_array_add (priv->connections, connection_new (self));
+
+        for (guint i = 0; i < priv->connections->len; i++) {
+            ConnectionData *connection = g_ptr_array_index (priv->connections, i);
+
+            if (connection->socket != NULL)
+                continue;
+
+            add_reader (connection, context);
+            g_ptr_array_add (connection->prepare_tasks, g_object_ref (task));
+            data->n_pending++;
+            g_ptr_array_add (connection->connect_socket == NULL ? connecting : waiting, connection);
+        }
+
+        connected = data->n_pending == 0;
+    }
+
+    if (connected) {
+        g_task_return_boolean (task, TRUE);
+        return G_SOURCE_REMOVE;
+    }
+
+    for (guint i = 0; i < connecting->len; i++)
+        connect_to_snapd (g_ptr_array_index (connecting, i));
+    for (guint i = 0; i < waiting->len; i++)
+        update_read_sources (g_ptr_array_index (waiting, i), FALSE);
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * snapd_client_prepare_async:
+ * @client: a #SnapdClient
+ * @cancellable: (allow-none): a #GCancellable or %NULL
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously open connections to snapd ahead of the first request.
+ * See snapd_client_prepare_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_prepare_async (SnapdClient *self,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    /* Connections are only used from the I/O thread */
+    GTask *task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, g_slice_new0 (PrepareData), (GDestroyNotify) prepare_data_free);
+    if (priv->io_context != NULL && !g_main_context_is_owner (priv->io_context)) {
+        g_main_context_invoke_full (priv->io_context, G_PRIORITY_DEFAULT, prepare_cb, task, g_object_unref);
+        return;
+    }
+
+    prepare_cb (task);
+    g_object_unref (task);
+}
+
+/**
+ * snapd_client_prepare_finish:
+ * @client: a #SnapdClient
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_prepare_async().
+ * See snapd_client_prepare_sync() for more information.
+ *
+ * Returns: %TRUE if the connections to snapd were opened.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_prepare_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_set_socket_path:
+ * @client: a #SnapdClient
+ * @socket_path: (allow-none): a socket path or %NULL to reset to the default.
+ *
+ * Set the Unix socket path to connect to snapd with.
+ * Defaults to the system socket. This clears any address set with
+ * snapd_client_set_address(). Authorization data is only sent on connections
+ * made to the socket path, not ones already open to that address.
+ *
+ * Since: 1.24
+ */
+void
+snapd_client_set_socket_path (SnapdClient *self, const gchar *socket_path)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_free (priv->socket_path);
+    if (socket_path != NULL)
+        priv->socket_path = g_strdup (socket_path);
+    else
+        priv->socket_path = g_strdup (SNAPD_SOCKET);
+    g_clear_object (&priv->address);
+
+    if (snapd_client_get_watch_socket (self))
+        start_socket_monitor (self);
+}
+
+/**
+ * snapd_client_get_socket_path:
+ * @client: a #SnapdClient
+ *
+ * Get the unix socket path to connect to snapd with.
+ *
+ * Returns: socket path.
+ *
+ * Since: 1.24
+ */
+const gchar *
+snapd_client_get_socket_path (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->socket_path;
+}
+
+/* Authorization data is only sent over Unix sockets */
+static void
+warn_insecure_auth_data (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    if (priv->auth_data != NULL && priv->address != NULL && g_socket_address_get_family (priv->address) != G_SOCKET_FAMILY_UNIX)
+        g_warning ("Authorization data will not be sent to snapd over a non-Unix socket");
+}
+
+/**
+ * snapd_client_set_address:
+ * @client: a #SnapdClient
+ * @address: (allow-none): a #GSocketAddress or %NULL to use the socket path.
+ *
+ * Set the address to connect to snapd with, instead of the path set with
+ * snapd_client_set_socket_path(). This allows connecting over TCP with a
+ * #GInetSocketAddress, e.g. to a proxy that forwards to snapd on a remote
+ * machine. Connections are kept open and requests pipelined in the same way as
+ * with a Unix socket. The address applies to connections opened after this
+ * call. Setting the socket path again clears the address.
+ *
+ * Requests are sent unencrypted, so authorization data set with
+ * snapd_client_set_auth_data() is never sent over a connection that isn't a
+ * Unix socket, and a warning is logged if it is set while @address isn't a Unix
+ * socket address. Operations that need it will fail with
+ * %SNAPD_ERROR_AUTH_DATA_REQUIRED or a permission error.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_address (SnapdClient *self, GSocketAddress *address)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (address == NULL || G_IS_SOCKET_ADDRESS (address));
+
+    g_set_object (&priv->address, address);
+    warn_insecure_auth_data (self);
+}
+
+/**
+ * snapd_client_get_address:
+ * @client: a #SnapdClient
+ *
+ * Get the address set with snapd_client_set_address().
+ *
+ * Returns: (transfer none) (allow-none): a #GSocketAddress or %NULL if connecting to the socket path.
+ *
+ * Since: 1.65
+ */
+GSocketAddress *
+snapd_client_get_address (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->address;
+}
+
+/**
+ * snapd_client_set_user_agent:
+ * @client: a #SnapdClient
+ * @user_agent: (allow-none): a user agent or %NULL.
+ *
+ * Set the HTTP user-agent that is sent with each request to snapd.
+ * Defaults to "snapd-glib/VERSION".
+ *
+ * Since: 1.16
+ */
+void
+snapd_client_set_user_agent (SnapdClient *self, const gchar *user_agent)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_free (priv->user_agent);
+    priv->user_agent = g_strdup (user_agent);
+    clear_common_headers (self);
+}
+
+/**
+ * snapd_client_get_user_agent:
+ * @client: a #SnapdClient
+ *
+ * Get the HTTP user-agent that is sent with each request to snapd.
+ *
+ * Returns: (allow-none): user agent or %NULL if none set.
+ *
+ * Since: 1.16
+ */
+const gchar *
+snapd_client_get_user_agent (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->user_agent;
+}
+
+/**
+ * snapd_client_set_allow_interaction:
+ * @client: a #SnapdClient
+ * @allow_interaction: whether to allow interaction.
+ *
+ * Set whether snapd operations are allowed to interact with the user.
+ * This affects operations that use polkit authorisation.
+ * Defaults to TRUE.
+ *
+ * Since: 1.19
+ */
+void
+snapd_client_set_allow_interaction (SnapdClient *self, gboolean allow_interaction)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->allow_interaction = allow_interaction;
+    clear_common_headers (self);
+}
+
+/**
+ * snapd_client_set_max_read_size:
+ * @client: a #SnapdClient
+ * @max_read_size: maximum number of bytes to read at a time or 0 for the default.
+ *
+ * Set the maximum number of bytes to read from snapd in a single socket read.
+ * Once the length of a response is known it is read in blocks of up to this size,
+ * larger values reduce the number of reads required for large responses at the
+ * cost of memory. Defaults to 65536.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_read_size (SnapdClient *self, gsize max_read_size)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_read_size = max_read_size != 0 ? max_read_size : DEFAULT_MAX_READ_SIZE;
+}
+
+/**
+ * snapd_client_get_max_read_size:
+ * @client: a #SnapdClient
+ *
+ * Get the maximum number of bytes to read from snapd in a single socket read.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_client_get_max_read_size (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_read_size;
+}
+
+/**
+ * snapd_client_set_use_buffer_pool:
+ * @client: a #SnapdClient
+ * @use_buffer_pool: %TRUE to share receive buffers with other clients.
+ *
+ * Set whether connections to snapd take their receive buffers from a pool
+ * shared by all the clients in the process that enable it. Connections give
+ * up their buffers between responses, so many mostly idle clients or
+ * connections only need as many buffers as are reading at once.
+ *
+ * Whether or not the pool is used, buffers that grew to hold a large response
+ * are freed once it has been processed. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_use_buffer_pool (SnapdClient *self, gboolean use_buffer_pool)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->use_buffer_pool = use_buffer_pool;
+}
+
+/**
+ * snapd_client_get_use_buffer_pool:
+ * @client: a #SnapdClient
+ *
+ * Get whether connections to snapd share receive buffers with other clients.
+ *
+ * Returns: %TRUE if the buffer pool is used.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_use_buffer_pool (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->use_buffer_pool;
+}
+
+/**
+ * snapd_client_set_max_connections:
+ * @client: a #SnapdClient
+ * @max_connections: maximum number of connections to snapd or 0 for the default.
+ *
+ * Set the maximum number of connections to use to snapd. snapd answers the
+ * requests on a connection in order, so a slow request delays any requests
+ * sent after it. With more than one connection, requests are sent on
+ * whichever connection is least busy, avoiding connections that are uploading
+ * a snap. Polls for the progress of a change are kept on the same connection
+ * so they are answered in order. Defaults to 1.
+ *
+ * Clients created with snapd_client_new_from_socket() only use the provided
+ * socket.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_connections (SnapdClient *self, guint max_connections)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    priv->max_connections = max_connections != 0 ? max_connections : 1;
+}
+
+/**
+ * snapd_client_get_max_connections:
+ * @client: a #SnapdClient
+ *
+ * Get the maximum number of connections to use to snapd.
+ *
+ * Returns: a number of connections.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_max_connections (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_connections;
+}
+
+/**
+ * snapd_client_set_transport:
+ * @client: a #SnapdClient
+ * @transport: (allow-none): a #SnapdTransport or %NULL.
+ *
+ * Set a transport to send requests on, so this client shares connections
+ * with the other clients using it. Requests are sent with this client's
+ * authorization, user agent and X-Allow-Interaction header, and use this
+ * client's request settings: priority, timeouts and deadline, retries,
+ * response size limit, Expect: 100-continue, change polling intervals,
+ * background and progress callbacks. Responses are only cached and shared
+ * with other requests from this client.
+ *
+ * The socket path and connection settings of the transport are used instead
+ * of those of this client, so this client's socket path, address, connection
+ * and pipeline limits, connect timeout, read size, buffer pool, socket
+ * watching, I/O thread and context, parse thread threshold, combined polls
+ * and notices settings are ignored while a transport is set.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_transport (SnapdClient *self, SnapdTransport *transport)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (transport == NULL || SNAPD_IS_TRANSPORT (transport));
+    g_set_object (&priv->transport, transport);
+}
+
+/**
+ * snapd_client_get_transport:
+ * @client: a #SnapdClient
+ *
+ * Get the transport this client sends requests on.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdTransport or %NULL.
+ *
+ * Since: 1.65
+ */
+SnapdTransport *
+snapd_client_get_transport (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->transport;
+}
+
+/**
+ * snapd_client_set_max_pipeline_depth:
+ * @client: a #SnapdClient
+ * @max_pipeline_depth: maximum number of requests to send without a response or 0 for the default.
+ *
+ * Set the maximum number of requests that are sent on each connection to snapd
+ * before responses are received for them. Further requests are queued and sent
+ * as responses arrive, which limits the amount of data waiting in the socket
+ * when many requests are made at once. Defaults to 16.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_pipeline_depth (SnapdClient *self, guint max_pipeline_depth)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_pipeline_depth = max_pipeline_depth != 0 ? max_pipeline_depth : DEFAULT_MAX_PIPELINE_DEPTH;
+}
+
+/**
+ * snapd_client_get_max_pipeline_depth:
+ * @client: a #SnapdClient
+ *
+ * Get the maximum number of requests that are sent on each connection to snapd
+ * before responses are received for them.
+ *
+ * Returns: a number of requests.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_max_pipeline_depth (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_pipeline_depth;
+}
+
+/**
+ * snapd_client_set_request_priority:
+ * @client: a #SnapdClient
+ * @priority: a #SnapdRequestPriority.
+ *
+ * Set the priority of requests made after this call. Requests that are waiting
+ * to be sent to snapd, because a connection has too many requests waiting for
+ * responses, are sent in priority order. Requests already written to snapd
+ * are not affected. Defaults to %SNAPD_REQUEST_PRIORITY_NORMAL.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_request_priority (SnapdClient *self, SnapdRequestPriority priority)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->request_priority = priority;
+}
+
+/**
+ * snapd_client_get_request_priority:
+ * @client: a #SnapdClient
+ *
+ * Get the priority given to new requests.
+ *
+ * Returns: a #SnapdRequestPriority.
+ *
+ * Since: 1.65
+ */
+SnapdRequestPriority
+snapd_client_get_request_priority (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), SNAPD_REQUEST_PRIORITY_NORMAL);
+    return priv->request_priority;
+}
+
+/**
+ * snapd_client_set_request_timeout:
+ * @client: a #SnapdClient
+ * @timeout: number of milliseconds requests have to complete in or 0 for no limit.
+ *
+ * Set how long requests made after this call have to complete. A request
+ * that takes longer fails with %G_IO_ERROR_TIMED_OUT. If the request had
+ * already been sent its response will arrive before those to any requests
+ * sent after it on the same connection, so the connection is dropped and the
+ * other requests waiting on it fail with %SNAPD_ERROR_READ_FAILED (or are
+ * retried, see snapd_client_set_max_retries()).
+ *
+ * Asynchronous operations such as snapd_client_install2_async() aren't
+ * limited, as they continue in snapd. Use a #GCancellable to stop them.
+ * Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_request_timeout (SnapdClient *self, guint timeout)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->request_timeout = timeout;
+}
+
+/**
+ * snapd_client_get_request_timeout:
+ * @client: a #SnapdClient
+ *
+ * Get how long new requests have to complete.
+ *
+ * Returns: a number of milliseconds or 0 for no limit.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_request_timeout (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->request_timeout;
+}
+
+/**
+ * snapd_client_set_connect_timeout:
+ * @client: a #SnapdClient
+ * @timeout: number of milliseconds to wait for snapd to accept a connection or 0 for no limit.
+ *
+ * Set how long to wait for snapd to accept a new connection. Connections are
+ * made without blocking, and requests wait for them to complete. When snapd
+ * is socket activated and still starting up it may not be able to accept
+ * connections straight away, in which case the connection is attempted again
+ * until this timeout. Requests waiting for a connection that isn't made fail
+ * with %SNAPD_ERROR_CONNECTION_FAILED. Defaults to 30000.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_connect_timeout (SnapdClient *self, guint timeout)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->connect_timeout = timeout;
+}
+
+/**
+ * snapd_client_get_connect_timeout:
+ * @client: a #SnapdClient
+ *
+ * Get how long to wait for snapd to accept a new connection.
+ *
+ * Returns: a number of milliseconds or 0 for no limit.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_connect_timeout (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->connect_timeout;
+}
+
+/**
+ * snapd_client_set_resolve_cache_ttl:
+ * @client: a #SnapdClient
+ * @ttl: number of milliseconds to reuse resolved snaps for, or 0 to not cache them.
+ *
+ * Set how long snaps looked up with snapd_client_resolve_snaps_async() are
+ * reused for. IDs that didn't match a snap are remembered for the same time.
+ * Setting this clears the snaps already cached. Defaults to 300000.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_resolve_cache_ttl (SnapdClient *self, guint ttl)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->resolve_mutex);
+    priv->resolve_cache_ttl = ttl;
+    g_hash_table_remove_all (priv->resolve_cache);
+    _snapd_cache_manager_remove_all (priv->cache_manager, priv->resolve_cache_id);
+}
+
+/**
+ * snapd_client_get_resolve_cache_ttl:
+ * @client: a #SnapdClient
+ *
+ * Get how long resolved snaps are reused for.
+ *
+ * Returns: a number of milliseconds or 0 if not cached.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_resolve_cache_ttl (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->resolve_mutex);
+    return priv->resolve_cache_ttl;
+}
+
+/**
+ * snapd_client_set_request_deadline:
+ * @client: a #SnapdClient
+ * @deadline: monotonic time in microseconds, as from g_get_monotonic_time(), or 0 for no limit.
+ *
+ * Set the time requests made after this call must complete by. This allows
+ * an operation made of several requests to share one limit. If a timeout is
+ * also set with snapd_client_set_request_timeout() the earlier of the two
+ * applies. Requests that miss the deadline fail as described in
+ * snapd_client_set_request_timeout(). Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_request_deadline (SnapdClient *self, gint64 deadline)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->request_deadline = deadline;
+}
+
+/**
+ * snapd_client_get_request_deadline:
+ * @client: a #SnapdClient
+ *
+ * Get the time new requests must complete by.
+ *
+ * Returns: a monotonic time in microseconds or 0 for no limit.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_client_get_request_deadline (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->request_deadline;
+}
+
+/**
+ * snapd_client_get_request_timings:
+ * @client: a #SnapdClient
+ * @result: a #GAsyncResult passed to the callback of a request.
+ *
+ * Get timing information for a request made by this client. This is only
+ * complete once the request callback has been called. Use the
+ * #SnapdClient::request-finished signal to see the timings of all requests.
+ *
+ * Returns: (transfer full) (allow-none): a #SnapdRequestTimings or %NULL if @result is not from a single request to snapd.
+ *
+ * Since: 1.65
+ */
+SnapdRequestTimings *
+snapd_client_get_request_timings (SnapdClient *self, GAsyncResult *result)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+
+    if (!SNAPD_IS_REQUEST (result))
+        return NULL;
+
+    return g_object_ref (_snapd_request_get_timings (SNAPD_REQUEST (result)));
+}
+
+static gint
+compare_pending_age (gconstpointer a, gconstpointer b)
+{
+    gint64 age_a = snapd_pending_request_get_age (*((SnapdPendingRequest **) a));
+    gint64 age_b = snapd_pending_request_get_age (*((SnapdPendingRequest **) b));
+    return age_a > age_b ? -1 : age_a < age_b ? 1 : 0;
+}
+
+/**
+ * snapd_client_get_pending_requests:
+ * @client: a #SnapdClient
+ *
+ * Get a snapshot of the requests made by this client that haven't completed,
+ * oldest first. This includes requests made internally, such as polls for
+ * change progress. This is useful to find out what a client is waiting on
+ * when it appears to be stuck.
+ *
+ * Returns: (transfer container) (element-type SnapdPendingRequest): an array of #SnapdPendingRequest.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_pending_requests (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    GPtrArray *pending_requests = g_ptr_array_new_with_free_func (g_object_unref);
+    gint64 now = g_get_monotonic_time ();
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data))
+            g_ptr_array_add (pending_requests, make_pending_request (data, now));
+    }
+    g_ptr_array_sort (pending_requests, compare_pending_age);
+
+    return pending_requests;
+}
+
+/**
+ * snapd_client_set_slow_request_threshold:
+ * @client: a #SnapdClient
+ * @slow_request_threshold: number of milliseconds or 0 to not report slow requests.
+ *
+ * Set how long requests can take before they are reported with the
+ * #SnapdClient::slow-request signal. Only requests made after this is set
+ * are reported. Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_slow_request_threshold (SnapdClient *self, guint slow_request_threshold)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->slow_request_threshold = slow_request_threshold;
+}
+
+/**
+ * snapd_client_get_slow_request_threshold:
+ * @client: a #SnapdClient
+ *
+ * Get how long requests can take before they are reported as slow.
+ *
+ * Returns: a number of milliseconds or 0 if slow requests are not reported.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_slow_request_threshold (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->slow_request_threshold;
+}
+
+/**
+ * snapd_client_get_statistics:
+ * @client: a #SnapdClient
+ *
+ * Get a snapshot of statistics about the requests made by this client, as a
+ * dictionary of type `a{sv}` containing:
+ *
+ * - "requests" (`t`): number of requests completed.
+ * - "errors" (`t`): number of requests that failed.
+ * - "bytes-sent" (`t`): bytes written to snapd.
+ * - "bytes-received" (`t`): bytes read from snapd.
+ * - "reconnects" (`t`): number of times a closed connection was reopened to send a request.
+ * - "idle-closes" (`t`): number of unused connections dropped because snapd closed them.
+ * - "retries" (`t`): number of times requests were sent again after getting no response.
+ * - "parked" (`t`): number of polls and retries held back while the snapd socket was missing,
+ *   see snapd_client_set_watch_socket().
+ * - "polls" (`t`): number of polls scheduled for the progress of changes.
+ * - "cache-hits" (`u`) and "cache-misses" (`u`): use of the response cache.
+ * - "live-parsed-bytes" (`t`): the value of snapd_client_get_live_parsed_bytes().
+ * - "latency-buckets" (`at`): upper bound of each latency histogram bucket in
+ *   microseconds, with the last bucket unbounded and given as %G_MAXUINT64.
+ * - "endpoints" (`a{sa{sv}}`): statistics for each endpoint, keyed by path
+ *   with identifiers replaced, e.g. "/v2/snaps/{name}". Each contains
+ *   "requests" (`t`), "errors" (`t`), "latency-sum" (`t`) in microseconds and
+ *   "latency-histogram" (`at`) with the number of requests in each bucket.
+ *
+ * Internal requests, such as polls for the progress of changes, are included.
+ *
+ * Returns: (transfer full): a #GVariant.
+ *
+ * Since: 1.65
+ */
+GVariant *
+snapd_client_get_statistics (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        g_variant_builder_add (&builder, "{sv}", "cache-hits", g_variant_new_uint32 (priv->cache_hits));
+        g_variant_builder_add (&builder, "{sv}", "cache-misses", g_variant_new_uint32 (priv->cache_misses));
+    }
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->statistics_mutex);
+    g_variant_builder_add (&builder, "{sv}", "requests", g_variant_new_uint64 (priv->n_requests));
+    g_variant_builder_add (&builder, "{sv}", "errors", g_variant_new_uint64 (priv->n_errors));
+    g_variant_builder_add (&builder, "{sv}", "bytes-sent", g_variant_new_uint64 (priv->bytes_sent));
+    g_variant_builder_add (&builder, "{sv}", "bytes-received", g_variant_new_uint64 (priv->bytes_received));
+    g_variant_builder_add (&builder, "{sv}", "reconnects", g_variant_new_uint64 (priv->n_reconnects));
+    g_variant_builder_add (&builder, "{sv}", "idle-closes", g_variant_new_uint64 (priv->n_idle_closes));
+    g_variant_builder_add (&builder, "{sv}", "retries", g_variant_new_uint64 (priv->n_retries));
+    g_variant_builder_add (&builder, "{sv}", "parked", g_variant_new_uint64 (priv->n_parked));
+    g_variant_builder_add (&builder, "{sv}", "polls", g_variant_new_uint64 (priv->n_polls));
+    g_variant_builder_add (&builder, "{sv}", "live-parsed-bytes", g_variant_new_uint64 (_snapd_memory_counter_get_size (priv->memory_counter)));
+
+    guint64 bounds[N_LATENCY_BUCKETS];
+    for (guint i = 0; i < N_LATENCY_BUCKETS; i++)
+        bounds[i] = i < N_LATENCY_BUCKETS - 1 ? (guint64) 1000 << i : G_MAXUINT64;
+    g_variant_builder_add (&builder, "{sv}", "latency-buckets",
+                           g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64, bounds, N_LATENCY_BUCKETS, sizeof (guint64)));
+
+    GVariantBuilder endpoints_builder;
+    g_variant_builder_init (&endpoints_builder, G_VARIANT_TYPE ("a{sa{sv}}"));
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, priv->endpoint_statistics);
+    const gchar *endpoint;
+    EndpointStatistics *statistics;
+    while (g_hash_table_iter_next (&iter, (gpointer *) &endpoint, (gpointer *) &statistics)) {
+        GVariantBuilder endpoint_builder;
+        g_variant_builder_init (&endpoint_builder, G_VARIANT_TYPE_VARDICT);
+        g_variant_builder_add (&endpoint_builder, "{sv}", "requests", g_variant_new_uint64 (statistics->n_requests));
+        g_variant_builder_add (&endpoint_builder, "{sv}", "errors", g_variant_new_uint64 (statistics->n_errors));
+        g_variant_builder_add (&endpoint_builder, "{sv}", "latency-sum", g_variant_new_uint64 (statistics->latency_sum));
+        g_variant_builder_add (&endpoint_builder, "{sv}", "latency-histogram",
+                               g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64, statistics->latency_counts, N_LATENCY_BUCKETS, sizeof (guint64)));
+        g_variant_builder_add (&endpoints_builder, "{s@a{sv}}", endpoint, g_variant_builder_end (&endpoint_builder));
+    }
+    g_variant_builder_add (&builder, "{sv}", "endpoints", g_variant_builder_end (&endpoints_builder));
+
+    return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+/**
+ * snapd_client_start_capture:
+ * @client: a #SnapdClient
+ * @path: file to write to.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Record the responses snapd sends to this client, with their timing, so they
+ * can be served again by a test server to benchmark against real data. The
+ * file starts with the line `snapd-glib-capture 1` and is followed by one
+ * record for each response:
+ *
+ * |[
+ * <sent> <latency> <duration> <status> <length> <method> <path> <content-type>
+ * <body>
+ * ]|
+ *
+ * The header line has space separated fields: the time the request was
+ * written in microseconds since the capture started, the microseconds until
+ * the first byte of the response was received and the microseconds taken to
+ * receive the rest of it, the response status code and body length in bytes,
+ * the request method and path including any query, and the rest of the line
+ * is the content type (`-` if none). It is followed by the body, decoded from
+ * any transfer encoding, and a newline.
+ *
+ * Request headers and bodies are not recorded. Response bodies can contain
+ * private data, so the file is created readable only by the user. The bodies
+ * of responses that contain credentials, such as the authorization data
+ * returned by snapd_client_login2_sync(), are recorded as empty. Responses
+ * that are streamed to the caller as they are received are not recorded.
+ *
+ * Returns: %TRUE if the file was opened.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_start_capture (SnapdClient *self, const gchar *path, GError **error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    SnapdCapture *capture = _snapd_capture_new (path, error);
+    if (capture == NULL)
+        return FALSE;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->capture_mutex);
+    g_clear_pointer (&priv->capture, _snapd_capture_unref);
+    priv->capture = capture;
+
+    return TRUE;
+}
+
+/**
+ * snapd_client_stop_capture:
+ * @client: a #SnapdClient
+ *
+ * Stop recording responses started with snapd_client_start_capture() and
+ * close the file.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_stop_capture (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdCapture) capture = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->capture_mutex);
+        capture = g_steal_pointer (&priv->capture);
+    }
+}
+
+/**
+ * snapd_client_set_poll_interval:
+ * @client: a #SnapdClient
+ * @poll_interval: number of milliseconds between polls or 0 for the default.
+ *
+ * Set how often to check the progress of asynchronous operations, e.g.
+ * snapd_client_install2_async(). Polls are made at this interval while the
+ * operation is progressing. Defaults to 100ms.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_poll_interval (SnapdClient *self, guint poll_interval)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->poll_interval = poll_interval != 0 ? poll_interval : DEFAULT_POLL_INTERVAL;
+}
+
+/**
+ * snapd_client_get_poll_interval:
+ * @client: a #SnapdClient
+ *
+ * Get how often to check the progress of asynchronous operations.
+ *
+ * Returns: a number of milliseconds.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_poll_interval (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->poll_interval;
+}
+
+/**
+ * snapd_client_set_max_poll_interval:
+ * @client: a #SnapdClient
+ * @max_poll_interval: maximum number of milliseconds between polls or 0 for the default.
+ *
+ * Set the longest time to wait between checks of the progress of asynchronous
+ * operations. While an operation isn't making progress the time between
+ * polls doubles up to this limit, and returns to the interval set with
+ * snapd_client_set_poll_interval() as soon as progress is made. Setting this
+ * to the poll interval disables backing off. Defaults to 1000ms.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_poll_interval (SnapdClient *self, guint max_poll_interval)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_poll_interval = max_poll_interval != 0 ? max_poll_interval : DEFAULT_MAX_POLL_INTERVAL;
+}
+
+/**
+ * snapd_client_get_max_poll_interval:
+ * @client: a #SnapdClient
+ *
+ * Get the longest time to wait between checks of the progress of asynchronous
+ * operations.
+ *
+ * Returns: a number of milliseconds.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_max_poll_interval (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_poll_interval;
+}
+
+/**
+ * snapd_client_set_max_retries:
+ * @client: a #SnapdClient
+ * @max_retries: number of times to retry a request or 0 to not retry.
+ *
+ * Set how many times to send a request again if snapd can't be connected to
+ * or the connection is closed before a response is received, e.g. while
+ * snapd restarts after being refreshed. Only requests that don't change
+ * anything are retried; asynchronous operations such as
+ * snapd_client_install2_async() already check their change again after
+ * reconnecting. Defaults to 0.
+ *
+ * Retries wait for the interval set with snapd_client_set_retry_interval(),
+ * doubling each time up to the limit set with
+ * snapd_client_set_max_retry_interval(). If snapd has reported it is
+ * restarting (%SNAPD_MAINTENANCE_KIND_DAEMON_RESTART) the limit is used
+ * straight away. Each wait is randomly shortened by up to half, so many
+ * clients don't all reconnect at the same moment.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_retries (SnapdClient *self, guint max_retries)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_retries = max_retries;
+}
+
+/**
+ * snapd_client_get_max_retries:
+ * @client: a #SnapdClient
+ *
+ * Get how many times to send a request again if no response is received.
+ *
+ * Returns: a number of retries.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_max_retries (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_retries;
+}
+
+/**
+ * snapd_client_set_retry_interval:
+ * @client: a #SnapdClient
+ * @retry_interval: number of milliseconds to wait before the first retry or 0 for the default.
+ *
+ * Set how long to wait before the first retry of a request, see
+ * snapd_client_set_max_retries(). Defaults to 100ms.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_retry_interval (SnapdClient *self, guint retry_interval)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->retry_interval = retry_interval != 0 ? retry_interval : DEFAULT_RETRY_INTERVAL;
+}
+
+/**
+ * snapd_client_get_retry_interval:
+ * @client: a #SnapdClient
+ *
+ * Get how long to wait before the first retry of a request.
+ *
+ * Returns: a number of milliseconds.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_retry_interval (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->retry_interval;
+}
+
+/**
+ * snapd_client_set_max_retry_interval:
+ * @client: a #SnapdClient
+ * @max_retry_interval: maximum number of milliseconds between retries or 0 for the default.
+ *
+ * Set the longest time to wait between retries of a request, see
+ * snapd_client_set_max_retries(). Defaults to 5000ms.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_retry_interval (SnapdClient *self, guint max_retry_interval)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_retry_interval = max_retry_interval != 0 ? max_retry_interval : DEFAULT_MAX_RETRY_INTERVAL;
+}
+
+/**
+ * snapd_client_get_max_retry_interval:
+ * @client: a #SnapdClient
+ *
+ * Get the longest time to wait between retries of a request.
+ *
+ * Returns: a number of milliseconds.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_max_retry_interval (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_retry_interval;
+}
+
+/**
+ * snapd_client_set_watch_socket:
+ * @client: a #SnapdClient
+ * @watch_socket: %TRUE to watch the socket path.
+ *
+ * Set if the socket path is watched for snapd going away and coming back, e.g.
+ * while it restarts after being refreshed. While the socket is missing,
+ * asynchronous operations stop polling their changes and retries (see
+ * snapd_client_set_max_retries()) wait, rather than failing to connect. They
+ * continue as soon as the socket is created again, or after the interval set
+ * with snapd_client_set_max_retry_interval() if no change is seen.
+ *
+ * Without this an asynchronous operation fails if snapd can't be reached when
+ * its change is next checked.
+ *
+ * Changes are reported in the thread-default main context of the caller, which
+ * must be running for operations to continue straight away. This has no effect
+ * when connecting with snapd_client_set_address() or snapd_client_new_from_socket().
+ * Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_watch_socket (SnapdClient *self, gboolean watch_socket)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    if (watch_socket)
+        start_socket_monitor (self);
+    else
+        stop_socket_monitor (self);
+}
+
+/**
+ * snapd_client_get_watch_socket:
+ * @client: a #SnapdClient
+ *
+ * Get if the socket path is being watched for snapd restarting.
+ *
+ * Returns: %TRUE if watching the socket path.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_watch_socket (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->socket_monitor_mutex);
+    return priv->socket_monitor != NULL;
+}
+
+/**
+ * snapd_client_set_progress_delta_callback:
+ * @client: a #SnapdClient
+ * @callback: (allow-none) (scope notified): function to call with the tasks that changed, or %NULL.
+ * @user_data: (closure): user data to pass to @callback.
+ * @destroy_notify: (allow-none): function to free @user_data when @callback is replaced or the client is destroyed, or %NULL.
+ *
+ * Set a function to call each time the progress of an asynchronous operation
+ * is reported. Unlike a #SnapdProgressCallback, this is only passed the tasks
+ * that are new or have changed since the last report for that operation, so
+ * the cost of handling a report depends on what changed rather than the size
+ * of the change. It is called in the same context as the operation's progress
+ * callback, whether or not the operation has one.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_progress_delta_callback (SnapdClient *self, SnapdProgressDeltaCallback callback, gpointer user_data, GDestroyNotify destroy_notify)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    if (priv->progress_delta_callback_destroy_notify != NULL)
+        priv->progress_delta_callback_destroy_notify (priv->progress_delta_callback_data);
+    priv->progress_delta_callback = callback;
+    priv->progress_delta_callback_data = user_data;
+    priv->progress_delta_callback_destroy_notify = destroy_notify;
+}
+
+/**
+ * snapd_client_set_upload_progress_callback:
+ * @client: a #SnapdClient
+ * @callback: (allow-none) (scope notified): function to call with the amount uploaded, or %NULL.
+ * @user_data: (closure): user data to pass to @callback.
+ * @destroy_notify: (allow-none): function to free @user_data when @callback is replaced or the client is destroyed, or %NULL.
+ *
+ * Set a function to call as data is sent to snapd, for example while a snap
+ * is sent by snapd_client_install_stream_async() or
+ * snapd_client_install_path_async() before snapd has created a change for it.
+ * This shows a slow upload apart from snapd not responding. Reports are
+ * limited by snapd_client_set_min_progress_interval(), except the final one.
+ * It is called in the context the upload was started from.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_upload_progress_callback (SnapdClient *self, SnapdUploadProgressCallback callback, gpointer user_data, GDestroyNotify destroy_notify)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    if (priv->upload_progress_callback_destroy_notify != NULL)
+        priv->upload_progress_callback_destroy_notify (priv->upload_progress_callback_data);
+    priv->upload_progress_callback = callback;
+    priv->upload_progress_callback_data = user_data;
+    priv->upload_progress_callback_destroy_notify = destroy_notify;
+}
+
+/**
+ * snapd_client_set_min_progress_interval:
+ * @client: a #SnapdClient
+ * @min_progress_interval: minimum number of milliseconds between progress reports or 0 for no limit.
+ *
+ * Set the shortest time between progress callbacks for each asynchronous
+ * operation, regardless of how often snapd reports changes. Progress that
+ * arrives sooner is held back and only the latest state is reported when the
+ * time is up. The final state of an operation is always reported before it
+ * completes. Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_min_progress_interval (SnapdClient *self, guint min_progress_interval)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->min_progress_interval = min_progress_interval;
+}
+
+/**
+ * snapd_client_get_min_progress_interval:
+ * @client: a #SnapdClient
+ *
+ * Get the shortest time between progress callbacks for each asynchronous
+ * operation.
+ *
+ * Returns: a number of milliseconds.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_min_progress_interval (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->min_progress_interval;
+}
+
+/**
+ * snapd_client_set_max_response_size:
+ * @client: a #SnapdClient
+ * @max_response_size: maximum number of bytes or 0 for no limit.
+ *
+ * Set the largest response that requests made after this call keep in
+ * memory. Requests with a larger response fail with
+ * %SNAPD_ERROR_RESPONSE_TOO_LARGE and the rest of the response is dropped as it
+ * is received. Responses passed on as they arrive, such as logs being
+ * followed, assertions reported with a callback and files saved to a stream,
+ * are not limited. Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_max_response_size (SnapdClient *self, gsize max_response_size)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->max_response_size = max_response_size;
+}
+
+/**
+ * snapd_client_get_max_response_size:
+ * @client: a #SnapdClient
+ *
+ * Get the largest response that new requests keep in memory.
+ *
+ * Returns: a number of bytes or 0 if not limited.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_client_get_max_response_size (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->max_response_size;
+}
+
+/**
+ * snapd_client_set_expect_continue_size:
+ * @client: a #SnapdClient
+ * @size: number of bytes, or 0 to always send the body straight away.
+ *
+ * Set the size of upload above which snapd is asked to accept the request
+ * before the body is sent, using "Expect: 100-continue". A request that snapd
+ * rejects, for example because it isn't authorized or snapd is in
+ * maintenance, then fails without sending the snap or assertions. Uploads
+ * of unknown size always wait. If snapd doesn't reply the body is sent after
+ * two seconds. Defaults to 1048576.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_expect_continue_size (SnapdClient *self, goffset size)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (size >= 0);
+    priv->expect_continue_size = size;
+}
+
+/**
+ * snapd_client_get_expect_continue_size:
+ * @client: a #SnapdClient
+ *
+ * Get the size of upload above which snapd is asked to accept the request
+ * before the body is sent.
+ *
+ * Returns: a number of bytes or 0 if bodies are always sent straight away.
+ *
+ * Since: 1.65
+ */
+goffset
+snapd_client_get_expect_continue_size (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->expect_continue_size;
+}
+
+/**
+ * snapd_client_set_batch_polls:
+ * @client: a #SnapdClient
+ * @batch_polls: %TRUE to check the progress of all asynchronous operations with one request.
+ *
+ * Set if the progress of asynchronous operations is checked with a single
+ * request for all the changes in progress, rather than a request for each
+ * operation. This reduces the load on snapd when many operations are
+ * running at once. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_batch_polls (SnapdClient *self, gboolean batch_polls)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->batch_polls = batch_polls;
+}
+
+/**
+ * snapd_client_get_batch_polls:
+ * @client: a #SnapdClient
+ *
+ * Get if the progress of asynchronous operations is checked with a single
+ * request.
+ *
+ * Returns: %TRUE if polls are combined.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_batch_polls (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->batch_polls;
+}
+
+/**
+ * snapd_client_set_background:
+ * @client: a #SnapdClient
+ * @background: %TRUE if the application is in the background.
+ *
+ * Set if the application isn't currently being used, e.g. its window is
+ * hidden or the system is saving power. While in the background the
+ * progress of asynchronous operations is checked at most every ten seconds,
+ * and the checks for all clients in the process are aligned so the process
+ * wakes up as little as possible. Progress callbacks are called less often
+ * as a result.
+ *
+ * Leaving the background checks all operations immediately and then polls
+ * at the rate set by snapd_client_set_poll_interval() again. Defaults to
+ * %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_background (SnapdClient *self, gboolean background)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    if (priv->background == background)
+        return;
+    priv->background = background;
+    if (background)
+        return;
+
+    /* Bring the pending polls forward, the timers can run in other contexts so only mark them as ready */
+    g_autoptr(GPtrArray) sources = g_ptr_array_new_with_free_func ((GDestroyNotify) g_source_unref);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data)) {
+            if (data->poll_source != NULL)
+                g_ptr_array_add (sources, g_source_ref (data->poll_source));
+        }
+        if (priv->batch_poll_source != NULL)
+            g_ptr_array_add (sources, g_source_ref (priv->batch_poll_source));
+    }
+
+    /* Requests sent on a transport are held by the client that owns its connections */
+    if (priv->transport != NULL) {
+        SnapdClient *transport_client = _snapd_transport_get_client (priv->transport);
+        SnapdClientPrivate *transport_priv = snapd_client_get_instance_private (transport_client);
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&transport_priv->requests_mutex);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, transport_priv->requests);
+        RequestData *data;
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &data)) {
+            if (data->origin == self && data->poll_source != NULL)
+                g_ptr_array_add (sources, g_source_ref (data->poll_source));
+        }
+    }
+    for (guint i = 0; i < sources->len; i++)
+        g_source_set_ready_time (g_ptr_array_index (sources, i), 0);
+}
+
+/**
+ * snapd_client_get_background:
+ * @client: a #SnapdClient
+ *
+ * Get if the application has been set as being in the background.
+ *
+ * Returns: %TRUE if polling less often.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_background (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->background;
+}
+
+/**
+ * snapd_client_set_use_notices:
+ * @client: a #SnapdClient
+ * @use_notices: %TRUE to wait for notices from snapd about changes.
+ *
+ * Set if asynchronous operations wait for snapd to send a notice that their
+ * change has been updated, rather than regularly checking its progress. This
+ * uses an extra connection to snapd. If snapd doesn't support notices then
+ * progress is checked as normal. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_use_notices (SnapdClient *self, gboolean use_notices)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->use_notices = use_notices;
+}
+
+/**
+ * snapd_client_get_use_notices:
+ * @client: a #SnapdClient
+ *
+ * Get if asynchronous operations wait for notices from snapd.
+ *
+ * Returns: %TRUE if notices are used.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_use_notices (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->use_notices;
+}
+
+static gpointer
+io_thread_func (gpointer user_data)
+{
+    g_autoptr(GMainLoop) loop = user_data;
+    GMainContext *context = g_main_loop_get_context (loop);
+
+    g_main_context_push_thread_default (context);
+    g_main_loop_run (loop);
+    g_main_context_pop_thread_default (context);
+
+    return NULL;
+}
+
+static void
+stop_io_thread (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    if (priv->io_thread == NULL)
+        return;
+
+    g_main_loop_quit (priv->io_loop);
+    if (g_thread_self () == priv->io_thread)
+        g_thread_unref (priv->io_thread);
+    else
+        g_thread_join (priv->io_thread);
+    priv->io_thread = NULL;
+    g_clear_pointer (&priv->io_loop, g_main_loop_unref);
+    clear_io_context (self);
+}
+
+/**
+ * snapd_client_set_coalesce_requests:
+ * @client: a #SnapdClient
+ * @coalesce_requests: %TRUE to share responses between identical requests.
+ *
+ * Set if a request that is identical to one already waiting for a response
+ * from snapd shares that response rather than being sent again. This only
+ * applies to requests that read information, such as getting system
+ * information, installed snaps or icons. Each caller gets the same result
+ * objects. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_coalesce_requests (SnapdClient *self, gboolean coalesce_requests)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->coalesce_requests = coalesce_requests;
+}
+
+/**
+ * snapd_client_get_coalesce_requests:
+ * @client: a #SnapdClient
+ *
+ * Get if identical requests share responses from snapd.
+ *
+ * Returns: %TRUE if responses are shared.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_coalesce_requests (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->coalesce_requests;
+}
+
+/**
+ * snapd_client_set_cache_ttl:
+ * @client: a #SnapdClient
+ * @path: path of the snapd API to cache responses from, e.g. "/v2/system-info".
+ *     This may contain "*" and "?" wildcards, e.g. "/v2/snaps/<!-- -->*<!-- -->/conf".
+ * @ttl: number of milliseconds to use cached responses for, or 0 to not cache.
+ *
+ * Set how long responses from snapd are reused for requests with the same
+ * path and query. Caching is only supported for requests that read
+ * information, such as system information, sections, interfaces and snap
+ * configuration. The cache is cleared whenever a request that changes
+ * something completes, or snapd reports maintenance.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_cache_ttl (SnapdClient *self, const gchar *path, guint ttl)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (path != NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    if (ttl > 0)
+        g_hash_table_insert (priv->cache_ttls, g_strdup (path), GUINT_TO_POINTER (ttl));
+    else
+        g_hash_table_remove (priv->cache_ttls, path);
+    clear_response_cache_unlocked (self);
+}
+
+/**
+ * snapd_client_get_cache_ttl:
+ * @client: a #SnapdClient
+ * @path: path of the snapd API as passed to snapd_client_set_cache_ttl().
+ *
+ * Get how long responses from snapd are cached for.
+ *
+ * Returns: number of milliseconds responses are cached for, or 0 if not cached.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_cache_ttl (SnapdClient *self, const gchar *path)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    g_return_val_if_fail (path != NULL, 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return GPOINTER_TO_UINT (g_hash_table_lookup (priv->cache_ttls, path));
+}
+
+/**
+ * snapd_client_clear_cache:
+ * @client: a #SnapdClient
+ *
+ * Remove all cached responses, so the following requests are sent to snapd.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_clear_cache (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    clear_response_cache_unlocked (self);
+    clear_snap_cache_unlocked (self);
+    clear_interface_docs_unlocked (self);
+}
+
+/**
+ * snapd_client_set_snap_cache_ttl:
+ * @client: a #SnapdClient
+ * @ttl: number of milliseconds to reuse snaps for, or 0 to not cache them.
+ *
+ * Set how long snaps returned by snapd are shared between requests. When
+ * set, snapd_client_get_snap_async() uses the snap from a recent
+ * snapd_client_get_snap_async() or snapd_client_get_snaps_async()
+ * response without contacting snapd, and the store snaps returned by find
+ * requests can be got with snapd_client_get_cached_store_snap(). Only
+ * responses that contain every field are used. The cached snaps are cleared whenever a request that
+ * changes something completes, snapd reports a change by another client
+ * or maintenance, or snapd_client_clear_cache() is called. Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_snap_cache_ttl (SnapdClient *self, guint ttl)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    priv->snap_cache_ttl = ttl;
+    clear_snap_cache_unlocked (self);
+}
+
+/**
+ * snapd_client_get_snap_cache_ttl:
+ * @client: a #SnapdClient
+ *
+ * Get how long snaps are shared between requests.
+ *
+ * Returns: a number of milliseconds or 0 if not cached.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_snap_cache_ttl (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return priv->snap_cache_ttl;
+}
+
+/**
+ * snapd_client_get_cached_store_snap:
+ * @client: a #SnapdClient
+ * @name: name of the snap.
+ *
+ * Get the store information for a snap from a recent find request, so it
+ * can be shown with the installed snap without contacting the store.
+ * The snap is only cached if enabled with snapd_client_set_snap_cache_ttl().
+ *
+ * Returns: (transfer full) (allow-none): a #SnapdSnap or %NULL if not cached.
+ *
+ * Since: 1.65
+ */
+SnapdSnap *
+snapd_client_get_cached_store_snap (SnapdClient *self, const gchar *name)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    SnapdSnap *snap = lookup_cached_snap_unlocked (self, priv->store_snap_cache, priv->store_snap_cache_id, name);
+    return snap != NULL ? g_object_ref (snap) : NULL;
+}
+
+/**
+ * snapd_client_get_cache_hits:
+ * @client: a #SnapdClient
+ *
+ * Get the number of requests that were completed using a cached response.
+ *
+ * Returns: number of cache hits.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_cache_hits (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return priv->cache_hits;
+}
+
+/**
+ * snapd_client_get_cache_misses:
+ * @client: a #SnapdClient
+ *
+ * Get the number of requests that could have used a cached response but had
+ * to be sent to snapd.
+ *
+ * Returns: number of cache misses.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_client_get_cache_misses (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return priv->cache_misses;
+}
+
+/**
+ * snapd_client_set_icon_cache_path:
+ * @client: a #SnapdClient
+ * @path: (allow-none): directory to store icons in or %NULL to not store icons.
+ *
+ * Set the directory icons retrieved with snapd_client_get_icon2_sync() are
+ * stored in. Stored icons are used until the revision of the snap changes,
+ * and are read from disk without copying them. Icons are not stored for snap
+ * names or revisions that aren't valid file names. Defaults to %NULL.
+ * See also snapd_client_set_use_icon_cache().
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_icon_cache_path (SnapdClient *self, const gchar *path)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_free (priv->icon_cache_path);
+    priv->icon_cache_path = g_strdup (path);
+}
+
+/**
+ * snapd_client_get_icon_cache_path:
+ * @client: a #SnapdClient
+ *
+ * Get the directory icons are stored in.
+ *
+ * Returns: (allow-none): a directory or %NULL if icons are not stored.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_client_get_icon_cache_path (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->icon_cache_path;
+}
+
+/**
+ * snapd_client_set_use_icon_cache:
+ * @client: a #SnapdClient
+ * @use_icon_cache: %TRUE to store icons in the user cache directory.
+ *
+ * Set if icons are stored in the user cache directory ($XDG_CACHE_HOME).
+ * See snapd_client_set_icon_cache_path() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_use_icon_cache (SnapdClient *self, gboolean use_icon_cache)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    if (use_icon_cache) {
+        g_autofree gchar *path = g_build_filename (g_get_user_cache_dir (), "snapd-glib", "icons", NULL);
+        snapd_client_set_icon_cache_path (self, path);
+    }
+    else
+        snapd_client_set_icon_cache_path (self, NULL);
+}
+
+/**
+ * snapd_client_set_use_io_thread:
+ * @client: a #SnapdClient
+ * @use_io_thread: %TRUE to communicate with snapd from a separate thread.
+ *
+ * Set if communication with snapd is done in a thread owned by the client.
+ * This includes reading and parsing responses, so large responses don't block
+ * the thread requests are made from. Callbacks are still called in the
+ * #GMainContext requests were made from. Requests can be made from any
+ * number of threads, and are handed to the I/O thread without waiting for
+ * it. This should be set before any requests are made. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_use_io_thread (SnapdClient *self, gboolean use_io_thread)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    if (!use_io_thread) {
+        stop_io_thread (self);
+        return;
+    }
+
+    if (priv->io_thread != NULL)
+        return;
+    clear_io_context (self);
+    g_autoptr(GMainContext) context = g_main_context_new ();
+    set_io_context (self, context);
+    priv->io_loop = g_main_loop_new (priv->io_context, FALSE);
+    priv->io_thread = g_thread_new ("snapd-glib-io", io_thread_func, g_main_loop_ref (priv->io_loop));
+}
+
+/**
+ * snapd_client_get_use_io_thread:
+ * @client: a #SnapdClient
+ *
+ * Get if communication with snapd is done in a separate thread.
+ *
+ * Returns: %TRUE if a separate thread is used.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_use_io_thread (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->io_thread != NULL;
+}
+
+/**
+ * snapd_client_set_io_context:
+ * @client: a #SnapdClient
+ * @context: (allow-none): a #GMainContext to communicate with snapd from or %NULL.
+ *
+ * Set a #GMainContext that communication with snapd is done in, in the same
+ * way as with snapd_client_set_use_io_thread() but in a context the caller
+ * runs. This allows many clients to share one thread and one set of file
+ * descriptors to poll, and for the context to be driven from an existing
+ * event loop with g_main_context_query(), g_main_context_check() and
+ * g_main_context_dispatch(). Requests won't complete unless the context is
+ * being iterated, including those made with synchronous calls.
+ *
+ * This replaces any thread started with snapd_client_set_use_io_thread().
+ * This should be set before any requests are made. Defaults to %NULL.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_io_context (SnapdClient *self, GMainContext *context)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    stop_io_thread (self);
+    clear_io_context (self);
+    if (context != NULL)
+        set_io_context (self, context);
+}
+
+/**
+ * snapd_client_get_io_context:
+ * @client: a #SnapdClient
+ *
+ * Get the #GMainContext communication with snapd is done in, either set with
+ * snapd_client_set_io_context() or run by the thread started with
+ * snapd_client_set_use_io_thread().
+ *
+ * Returns: (transfer none) (allow-none): a #GMainContext or %NULL if communication is done in the context requests are made from.
+ *
+ * Since: 1.65
+ */
+GMainContext *
+snapd_client_get_io_context (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->io_context;
+}
+
+/**
+ * snapd_client_set_parse_thread_threshold:
+ * @client: a #SnapdClient
+ * @threshold: minimum response size in bytes to parse in a worker thread, or 0 to disable.
+ *
+ * Set the size of responses from snapd that are parsed in a worker thread
+ * rather than the thread they were received in. Parsing large responses, such
+ * as the results of a search, can take a noticeable amount of time. Callbacks
+ * are still called in the #GMainContext requests were made from. Defaults to 0.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_parse_thread_threshold (SnapdClient *self, gsize threshold)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->parse_thread_threshold = threshold;
+}
+
+/**
+ * snapd_client_get_parse_thread_threshold:
+ * @client: a #SnapdClient
+ *
+ * Get the size of responses from snapd that are parsed in a worker thread.
+ *
+ * Returns: the minimum response size in bytes, or 0 if worker threads are not used.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_client_get_parse_thread_threshold (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return priv->parse_thread_threshold;
+}
+
+/**
+ * snapd_client_set_lazy_parsing:
+ * @client: a #SnapdClient
+ * @lazy_parsing: %TRUE to build snap contents when first used.
+ *
+ * Set if #SnapdSnap objects returned from this client build their apps,
+ * channels, common IDs, install date, media, prices and tracks when they are
+ * first accessed rather than when the response is received. This makes
+ * results much cheaper to create when only some of them are looked at, such
+ * as a list that only shows names and revisions, at the cost of keeping the
+ * relevant part of the response in memory until then. If that part of the
+ * response is not valid it is treated as empty. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_lazy_parsing (SnapdClient *self, gboolean lazy_parsing)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->lazy_parsing = lazy_parsing;
+}
+
+/**
+ * snapd_client_get_lazy_parsing:
+ * @client: a #SnapdClient
+ *
+ * Get if snaps build their contents when first used.
+ *
+ * Returns: %TRUE if snap contents are built when first used.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_lazy_parsing (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->lazy_parsing;
+}
+
+/**
+ * snapd_client_set_share_snaps:
+ * @client: a #SnapdClient
+ * @share_snaps: %TRUE to share identical snaps between results.
+ *
+ * Set if a snap parsed by this client is replaced with an existing #SnapdSnap
+ * when one with exactly the same contents is still alive in this process, for
+ * example the same store snap returned by two searches. Snaps are matched on
+ * everything snapd returned for them, so an installed snap and the store
+ * version of it remain separate objects. Programs that keep several lists of
+ * snaps use less memory, at the cost of checksumming each snap as it is
+ * parsed. Defaults to %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_share_snaps (SnapdClient *self, gboolean share_snaps)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->share_snaps = share_snaps;
+}
+
+/**
+ * snapd_client_get_share_snaps:
+ * @client: a #SnapdClient
+ *
+ * Get if identical snaps are shared between results.
+ *
+ * Returns: %TRUE if identical snaps are shared.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_share_snaps (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->share_snaps;
+}
+
+/**
+ * snapd_client_set_track_memory:
+ * @client: a #SnapdClient
+ * @track_memory: %TRUE to count the memory used by parsed snaps.
+ *
+ * Set if the memory used by #SnapdSnap objects returned from this client is
+ * counted while they are alive, as reported by
+ * snapd_client_get_live_parsed_bytes(). Each snap is measured with
+ * snapd_snap_get_memory_size() when it is parsed, so this adds some cost to
+ * parsing. Only requests started after this is set are counted. Defaults to
+ * %FALSE.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_track_memory (SnapdClient *self, gboolean track_memory)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    priv->track_memory = track_memory;
+}
+
+/**
+ * snapd_client_get_track_memory:
+ * @client: a #SnapdClient
+ *
+ * Get if the memory used by parsed snaps is counted.
+ *
+ * Returns: %TRUE if memory is counted.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_track_memory (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->track_memory;
+}
+
+/**
+ * snapd_client_get_live_parsed_bytes:
+ * @client: a #SnapdClient
+ *
+ * Get the memory used by the snaps parsed by this client that have not been
+ * freed yet, as measured by snapd_snap_get_memory_size() when they were
+ * parsed. Snaps still count after @client is destroyed, and details that are
+ * loaded later with lazy parsing are not included. Only counted when enabled
+ * with snapd_client_set_track_memory().
+ *
+ * Returns: a size in bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_client_get_live_parsed_bytes (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), 0);
+    return _snapd_memory_counter_get_size (priv->memory_counter);
+}
+
+/**
+ * snapd_client_set_catalog_cache:
+ * @client: a #SnapdClient
+ * @cache: (allow-none): a #SnapdCatalogCache or %NULL.
+ *
+ * Set a cache to record the responses to find, sections and system information
+ * requests in. If snapd can't be reached these requests complete with the last
+ * recorded response instead of failing. The recorded responses can be read
+ * without contacting snapd using snapd_client_find_cached(),
+ * snapd_client_get_sections_cached() and
+ * snapd_client_get_system_information_cached(). Only requests started after this is set
+ * use the cache.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_catalog_cache (SnapdClient *self, SnapdCatalogCache *cache)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (cache == NULL || SNAPD_IS_CATALOG_CACHE (cache));
+
+    g_autoptr(SnapdCacheManager) manager = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        g_set_object (&priv->catalog_cache, cache);
+        manager = g_object_ref (priv->cache_manager);
+    }
+    if (cache != NULL)
+        _snapd_catalog_cache_set_cache_manager (cache, manager);
+}
+
+/**
+ * snapd_client_get_catalog_cache:
+ * @client: a #SnapdClient
+ *
+ * Get the cache set with snapd_client_set_catalog_cache().
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdCatalogCache or %NULL.
+ *
+ * Since: 1.65
+ */
+SnapdCatalogCache *
+snapd_client_get_catalog_cache (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->catalog_cache;
+}
+
+/**
+ * snapd_client_set_download_cache:
+ * @client: a #SnapdClient
+ * @cache: (allow-none): a #SnapdDownloadCache or %NULL.
+ *
+ * Set a cache to store snaps downloaded with snapd_client_download_async()
+ * in. Each download first asks snapd for the digest of the snap, and if it
+ * is already in the cache it is returned from disk without being
+ * downloaded again. Only requests started after this is set use the cache.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_download_cache (SnapdClient *self, SnapdDownloadCache *cache)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (cache == NULL || SNAPD_IS_DOWNLOAD_CACHE (cache));
+
+    g_autoptr(SnapdCacheManager) manager = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        g_set_object (&priv->download_cache, cache);
+        manager = g_object_ref (priv->cache_manager);
+    }
+    if (cache != NULL)
+        _snapd_download_cache_set_cache_manager (cache, manager);
+}
+
+/**
+ * snapd_client_get_download_cache:
+ * @client: a #SnapdClient
+ *
+ * Get the cache set with snapd_client_set_download_cache().
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdDownloadCache or %NULL.
+ *
+ * Since: 1.65
+ */
+SnapdDownloadCache *
+snapd_client_get_download_cache (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->download_cache;
+}
+
+/**
+ * snapd_client_set_cache_manager:
+ * @client: a #SnapdClient
+ * @manager: (allow-none): a #SnapdCacheManager or %NULL.
+ *
+ * Set the manager that limits the memory and disk space used by the caches
+ * of this client, including its #SnapdCatalogCache and #SnapdDownloadCache.
+ * Setting the same manager on several clients makes them share one budget.
+ * Each client has its own manager with the default budgets until this is
+ * called, and setting %NULL gives it a new one. Cached responses and snaps
+ * are forgotten when the manager changes.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_cache_manager (SnapdClient *self, SnapdCacheManager *manager)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (manager == NULL || SNAPD_IS_CACHE_MANAGER (manager));
+
+    g_autoptr(SnapdCacheManager) new_manager = manager != NULL ? g_object_ref (manager) : snapd_cache_manager_new ();
+    guint response_cache_id, snap_cache_id, store_snap_cache_id, resolve_cache_id;
+    add_caches (self, new_manager, &response_cache_id, &snap_cache_id, &store_snap_cache_id, &resolve_cache_id);
+
+    g_autoptr(SnapdCacheManager) old_manager = NULL;
+    guint old_response_cache_id, old_snap_cache_id, old_store_snap_cache_id, old_resolve_cache_id;
+    g_autoptr(SnapdCatalogCache) catalog_cache = NULL;
+    g_autoptr(SnapdDownloadCache) download_cache = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        g_autoptr(GMutexLocker) resolve_locker = g_mutex_locker_new (&priv->resolve_mutex);
+
+        g_hash_table_remove_all (priv->cache);
+        g_hash_table_remove_all (priv->snap_cache);
+        g_hash_table_remove_all (priv->store_snap_cache);
+        g_hash_table_remove_all (priv->resolve_cache);
+
+        old_manager = g_steal_pointer (&priv->cache_manager);
+        priv->cache_manager = g_object_ref (new_manager);
+        old_response_cache_id = priv->response_cache_id;
+        old_snap_cache_id = priv->snap_cache_id;
+        old_store_snap_cache_id = priv->store_snap_cache_id;
+        old_resolve_cache_id = priv->resolve_cache_id;
+        priv->response_cache_id = response_cache_id;
+        priv->snap_cache_id = snap_cache_id;
+        priv->store_snap_cache_id = store_snap_cache_id;
+        priv->resolve_cache_id = resolve_cache_id;
+
+        if (priv->catalog_cache != NULL)
+            catalog_cache = g_object_ref (priv->catalog_cache);
+        if (priv->download_cache != NULL)
+            download_cache = g_object_ref (priv->download_cache);
+    }
+
+    remove_caches (old_manager, old_response_cache_id, old_snap_cache_id, old_store_snap_cache_id, old_resolve_cache_id);
+    if (catalog_cache != NULL)
+        _snapd_catalog_cache_set_cache_manager (catalog_cache, new_manager);
+    if (download_cache != NULL)
+        _snapd_download_cache_set_cache_manager (download_cache, new_manager);
+}
+
+/**
+ * snapd_client_get_cache_manager:
+ * @client: a #SnapdClient
+ *
+ * Get the manager set with snapd_client_set_cache_manager().
+ *
+ * Returns: (transfer none): a #SnapdCacheManager.
+ *
+ * Since: 1.65
+ */
+SnapdCacheManager *
+snapd_client_get_cache_manager (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    return priv->cache_manager;
+}
+
+/**
+ * snapd_client_set_cache_interface_docs:
+ * @client: a #SnapdClient
+ * @cache_interface_docs: %TRUE to cache interface documentation.
+ *
+ * Set if interface summaries and documentation URLs are cached. These only
+ * change when snapd is upgraded, so once they have been retrieved
+ * snapd_client_get_interfaces2_sync() with
+ * %SNAPD_GET_INTERFACES_FLAGS_INCLUDE_DOCS only requests the plugs and slots
+ * from snapd and adds the documentation from the cache. The cache is tied to
+ * the snapd version, which is requested from snapd the first time it is
+ * needed, and is cleared if snapd reports maintenance or
+ * snapd_client_clear_cache() is called.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_set_cache_interface_docs (SnapdClient *self, gboolean cache_interface_docs)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+    priv->cache_interface_docs = cache_interface_docs;
+    if (!cache_interface_docs)
+        clear_interface_docs_unlocked (self);
+}
+
+/**
+ * snapd_client_get_cache_interface_docs:
+ * @client: a #SnapdClient
+ *
+ * Get if interface documentation is cached.
+ *
+ * Returns: %TRUE if interface documentation is cached.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_cache_interface_docs (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->cache_interface_docs;
+}
+
+/**
+ * snapd_client_get_maintenance:
+ * @client: a #SnapdClient
+ *
+ * Get the maintenance information reported by snapd or %NULL if no maintenance is in progress.
+ * This information is updated after every request. A %SNAPD_MAINTENANCE_KIND_DAEMON_RESTART
+ * kind means snapd is restarting, during which requests using a #SnapdCatalogCache
+ * are answered from the cache.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdMaintenance or %NULL.
+ *
+ * Since: 1.45
+ */
+SnapdMaintenance *
+snapd_client_get_maintenance (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->maintenance;
+}
+
+/**
+ * snapd_client_get_allow_interaction:
+ * @client: a #SnapdClient
+ *
+ * Get whether snapd operations are allowed to interact with the user.
+ *
+ * Returns: %TRUE if interaction is allowed.
+ *
+ * Since: 1.19
+ */
+gboolean
+snapd_client_get_allow_interaction (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    return priv->allow_interaction;
+}
+
+/**
+ * snapd_client_login_async:
+ * @client: a #SnapdClient.
+ * @email: email address to log in with.
+ * @password: password to log in with.
+ * @otp: (allow-none): response to one-time password challenge.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get authorization to install/remove snaps.
+ * See snapd_client_login_sync() for more information.
+ *
+ * Since: 1.0
+ * Deprecated: 1.26: Use snapd_client_login2_async()
+ */
+void
+snapd_client_login_async (SnapdClient *self,
+                          const gchar *email, const gchar *password, const gchar *otp,
+                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    snapd_client_login2_async (self, email, password, otp, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_login_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_login_async().
+ * See snapd_client_login_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdAuthData or %NULL on error.
+ *
+ * Since: 1.0
+ * Deprecated: 1.26: Use snapd_client_login2_finish()
+ */
+SnapdAuthData *
+snapd_client_login_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_finish (self, result, error);
+    if (user_information == NULL)
+        return NULL;
+
+    return g_object_ref (snapd_user_information_get_auth_data (user_information));
+}
+
+/**
+ * snapd_client_login2_async:
+ * @client: a #SnapdClient.
+ * @email: email address to log in with.
+ * @password: password to log in with.
+ * @otp: (allow-none): response to one-time password challenge.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get authorization to install/remove snaps.
+ * See snapd_client_login2_sync() for more information.
+ *
+ * Since: 1.26
+ */
+void
+snapd_client_login2_async (SnapdClient *self,
+                           const gchar *email, const gchar *password, const gchar *otp,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdPostLogin) request = _snapd_post_login_new (email, password, otp, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_login2_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_login2_async().
+ * See snapd_client_login2_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdUserInformation or %NULL on error.
+ *
+ * Since: 1.26
+ */
+SnapdUserInformation *
+snapd_client_login2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_LOGIN (result), NULL);
+
+    SnapdPostLogin *request = SNAPD_POST_LOGIN (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_post_login_get_user_information (request));
+}
+
+/**
+ * snapd_client_logout_async:
+ * @client: a #SnapdClient.
+ * @id: login ID to use.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously log out from the snap store.
+ * See snapd_client_logout_sync() for more information.
+ *
+ * Since: 1.55
+ */
+void
+snapd_client_logout_async (SnapdClient *self,
+                           gint64 id,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdPostLogout) request = _snapd_post_logout_new (id, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_logout_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_logout_async().
+ * See snapd_client_logout_sync() for more information.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.55
+ */
+gboolean
+snapd_client_logout_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_LOGOUT (result), FALSE);
+
+    SnapdPostLogout *request = SNAPD_POST_LOGOUT (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return FALSE;
+    return TRUE;
+}
+
+/**
+ * snapd_client_set_auth_data:
+ * @client: a #SnapdClient.
+ * @auth_data: (allow-none): a #SnapdAuthData or %NULL.
+ *
+ * Set the authorization data to use for requests. Authorization data can be
+ * obtained by:
+ *
+ * - Logging into snapd using snapd_client_login_sync()
+ *
+ * - Using an existing authorization with snapd_auth_data_new().
+ *
+ * Authorization data is only sent over Unix sockets, see
+ * snapd_client_set_address().
+ *
+ * Since: 1.0
+ */
+void
+snapd_client_set_auth_data (SnapdClient *self, SnapdAuthData *auth_data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_clear_object (&priv->auth_data);
+    if (auth_data != NULL)
+        priv->auth_data = g_object_ref (auth_data);
+    clear_common_headers (self);
+    warn_insecure_auth_data (self);
+}
+
+/**
+ * snapd_client_get_auth_data:
+ * @client: a #SnapdClient.
+ *
+ * Get the authorization data that is used for requests.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdAuthData or %NULL.
+ *
+ * Since: 1.0
+ */
+SnapdAuthData *
+snapd_client_get_auth_data (SnapdClient *self)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    return priv->auth_data;
+}
+
+static SnapdGetChanges *
+make_get_changes_request (SnapdChangeFilter filter, const gchar *snap_name,
+                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    const gchar *select = NULL;
+    switch (filter)
+    {
+    case SNAPD_CHANGE_FILTER_ALL:
+        select = "all";
+        break;
+    case SNAPD_CHANGE_FILTER_IN_PROGRESS:
+        select = "in-progress";
+        break;
+    case SNAPD_CHANGE_FILTER_READY:
+        select = "ready";
+        break;
+    }
+
+    return _snapd_get_changes_new (select, snap_name, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_get_changes_async:
+ * @client: a #SnapdClient.
+ * @filter: changes to filter on.
+ * @snap_name: (allow-none): name of snap to filter on or %NULL for changes for any snap.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get changes that have occurred / are occurring on the snap daemon.
+ * See snapd_client_get_changes_sync() for more information.
+ *
+ * Since: 1.29
+ */
+void
+snapd_client_get_changes_async (SnapdClient *self,
+                                SnapdChangeFilter filter, const gchar *snap_name,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetChanges) request = make_get_changes_request (filter, snap_name, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_changes_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_changes_async().
+ * See snapd_client_get_changes_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdChange): an array of #SnapdChange or %NULL on error.
+ *
+ * Since: 1.29
+ */
+GPtrArray *
+snapd_client_get_changes_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_CHANGES (result), NULL);
+
+    SnapdGetChanges *request = SNAPD_GET_CHANGES (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_changes_get_changes (request));
+}
+
+/**
+ * snapd_client_get_changes_model_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_changes_async(), returning
+ * the changes as a list model.
+ * See snapd_client_get_changes_model_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdChange or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_get_changes_model_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_finish (self, result, error);
+    if (changes == NULL)
+        return NULL;
+    return snapd_result_list_new (SNAPD_TYPE_CHANGE, changes);
+}
+
+/**
+ * snapd_client_get_changes_stream_async:
+ * @client: a #SnapdClient.
+ * @filter: changes to filter on.
+ * @snap_name: (allow-none): name of snap to filter on or %NULL for changes for any snap.
+ * @change_callback: (scope call): function to call with each change as it is parsed.
+ * @change_callback_data: (closure): user data to pass to @change_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get changes that have occurred / are occurring on the snap daemon.
+ * See snapd_client_get_changes_stream_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_changes_stream_async (SnapdClient *self,
+                                       SnapdChangeFilter filter, const gchar *snap_name,
+                                       SnapdChangeCallback change_callback, gpointer change_callback_data,
+                                       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (change_callback != NULL);
+
+    g_autoptr(SnapdGetChanges) request = make_get_changes_request (filter, snap_name, cancellable, callback, user_data);
+    _snapd_request_set_item_callback (SNAPD_REQUEST (request), G_CALLBACK (change_callback), change_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_changes_stream_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_changes_stream_async().
+ * See snapd_client_get_changes_stream_sync() for more information.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_changes_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_CHANGES (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/**
+ * snapd_client_get_change_async:
+ * @client: a #SnapdClient.
+ * @id: a change ID to get information on.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on a change.
+ * See snapd_client_get_change_sync() for more information.
+ *
+ * Since: 1.29
+ */
+void
+snapd_client_get_change_async (SnapdClient *self,
+                               const gchar *id,
+                               GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (id != NULL);
+
+    g_autoptr(SnapdGetChange) request = _snapd_get_change_new (id, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_change_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_change_async().
+ * See snapd_client_get_change_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdChange or %NULL on error.
+ *
+ * Since: 1.29
+ */
+SnapdChange *
+snapd_client_get_change_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_CHANGE (result), NULL);
+
+    SnapdGetChange *request = SNAPD_GET_CHANGE (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_get_change_get_change (request));
+}
+
+typedef struct
+{
+    SnapdProgressCallback progress_callback;
+    gpointer progress_callback_data;
+    guint watch_id;
+    GSource *cancelled_source;
+    gboolean completed;
+} WaitChangeData;
+
+static void
+wait_change_data_free (WaitChangeData *data)
+{
+    if (data->cancelled_source != NULL)
+        g_source_destroy (data->cancelled_source);
+    g_clear_pointer (&data->cancelled_source, g_source_unref);
+    g_slice_free (WaitChangeData, data);
+}
+
+static void
+wait_change_cb (SnapdChangeMonitor *monitor, SnapdChange *change, GError *error, gpointer user_data)
+{
+    GTask *task = user_data;
+    WaitChangeData *data = g_task_get_task_data (task);
+
+    if (data->completed)
+        return;
+
+    if (error != NULL) {
+        data->completed = TRUE;
+        g_task_return_error (task, g_error_copy (error));
+    }
+    else if (snapd_change_get_ready (change)) {
+        data->completed = TRUE;
+        g_task_return_pointer (task, g_object_ref (change), g_object_unref);
+    }
+    else if (data->progress_callback != NULL)
+        data->progress_callback (SNAPD_CLIENT (g_task_get_source_object (task)), change, NULL, data->progress_callback_data);
+}
+
+/* Runs in the context the wait was started in, so the monitor is only used from that thread */
+static gboolean
+wait_change_cancelled_cb (GCancellable *cancellable, gpointer user_data)
+{
+    g_autoptr(GTask) task = g_object_ref (user_data);
+    WaitChangeData *data = g_task_get_task_data (task);
+
+    if (!data->completed) {
+        data->completed = TRUE;
+        snapd_change_monitor_unwatch (snapd_change_monitor_get_default (), data->watch_id);
+        g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Wait for change cancelled");
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * snapd_client_wait_change_async:
+ * @client: a #SnapdClient.
+ * @id: a change ID to wait for.
+ * @progress_callback: (allow-none) (scope async): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the change is ready.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously wait for a change started elsewhere, e.g. by another
+ * process, to complete. The change is followed with the default
+ * #SnapdChangeMonitor, so waiting on many changes or waiting on the same
+ * change from several places only polls snapd once for each change.
+ * @progress_callback is called each time the change is updated.
+ *
+ * Cancelling stops waiting, it does not abort the change. Use
+ * snapd_client_abort_change_async() for that.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_wait_change_async (SnapdClient *self,
+                                const gchar *id,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (id != NULL);
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_source_tag (task, snapd_client_wait_change_async);
+    if (g_task_return_error_if_cancelled (task))
+        return;
+
+    WaitChangeData *data = g_slice_new0 (WaitChangeData);
+    data->progress_callback = progress_callback;
+    data->progress_callback_data = progress_callback_data;
+    g_task_set_task_data (task, data, (GDestroyNotify) wait_change_data_free);
+
+    data->watch_id = snapd_change_monitor_watch (snapd_change_monitor_get_default (), self, id,
+                                                 wait_change_cb, g_object_ref (task), g_object_unref);
+
+    if (cancellable != NULL) {
+        data->cancelled_source = g_cancellable_source_new (cancellable);
+        g_source_set_callback (data->cancelled_source, (GSourceFunc) wait_change_cancelled_cb, task, NULL);
+        g_source_attach (data->cancelled_source, g_task_get_context (task));
+    }
+}
+
+/**
+ * snapd_client_wait_change_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_wait_change_async().
+ * An error is only returned if the change could not be retrieved, a change
+ * that failed is returned with its status and error set.
+ *
+ * Returns: (transfer full): the ready #SnapdChange or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdChange *
+snapd_client_wait_change_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+    return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_abort_change_async:
+ * @client: a #SnapdClient.
+ * @id: a change ID to abort.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously abort a change.
+ * See snapd_client_abort_change_sync() for more information.
+ *
+ * Since: 1.30
+ */
+void
+snapd_client_abort_change_async (SnapdClient *self,
+                                 const gchar *id,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (id != NULL);
+
+    g_autoptr(SnapdPostChange) request = _snapd_post_change_new (id, "abort", cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_abort_change_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_abort_change_async().
+ * See snapd_client_abort_change_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdChange or %NULL on error.
+ *
+ * Since: 1.30
+ */
+SnapdChange *
+snapd_client_abort_change_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_CHANGE (result), NULL);
+
+    SnapdPostChange *request = SNAPD_POST_CHANGE (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_post_change_get_change (request));
+}
+
+/**
+ * snapd_client_get_notices_async:
+ * @client: a #SnapdClient.
+ * @since_date_time: (allow-none): only get notices reported after this time or %NULL for all notices.
+ * @timeout: number of milliseconds to wait for a notice if there are none, or 0 to return immediately.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get notices of events that have occurred on the snap daemon.
+ * See snapd_client_get_notices_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_notices_async (SnapdClient *self,
+                                GDateTime *since_date_time, guint timeout,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autofree gchar *after = NULL;
+    if (since_date_time != NULL) {
+        g_autoptr(GDateTime) utc_time = g_date_time_to_utc (since_date_time);
+        g_autofree gchar *seconds = g_date_time_format (utc_time, "%Y-%m-%dT%H:%M:%S");
+        after = g_strdup_printf ("%s.%06dZ", seconds, g_date_time_get_microsecond (utc_time));
+    }
+    g_autofree gchar *timeout_value = NULL;
+    if (timeout > 0)
+        timeout_value = g_strdup_printf ("%ums", timeout);
+
+    g_autoptr(SnapdGetNotices) request = _snapd_get_notices_new (NULL, after, timeout_value, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_notices_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_notices_async().
+ * See snapd_client_get_notices_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdNotice): an array of #SnapdNotice or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_notices_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_NOTICES (result), NULL);
+
+    SnapdGetNotices *request = SNAPD_GET_NOTICES (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_notices_get_notices (request));
+}
+
+/**
+ * snapd_client_get_system_information_async:
+ * @client: a #SnapdClient.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Request system information asynchronously from snapd.
+ * See snapd_client_get_system_information_sync() for more information.
+ *
+ * Since: 1.0
+ */
+void
+snapd_client_get_system_information_async (SnapdClient *self,
+                                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetSystemInfo) request = _snapd_get_system_info_new (cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_system_information_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_system_information_async().
+ * See snapd_client_get_system_information_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdSystemInformation or %NULL on error.
+ *
+ * Since: 1.0
+ */
+SnapdSystemInformation *
+snapd_client_get_system_information_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SYSTEM_INFO (result), NULL);
+
+    SnapdGetSystemInfo *request = SNAPD_GET_SYSTEM_INFO (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_get_system_info_get_system_information (request));
+}
+
+/**
+ * snapd_client_get_system_information_cached:
+ * @client: a #SnapdClient.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get the system information last recorded in the cache set with
+ * snapd_client_set_catalog_cache(), without contacting snapd. This allows a
+ * program to decide which features to use as soon as it starts, then check
+ * them with snapd_client_get_system_information_async() in the background.
+ * If the build ID of the new information is the same as
+ * snapd_system_information_get_build_id() of the cached one, snapd has not
+ * changed and everything worked out from the cached information still holds.
+ * The new information replaces the cached one.
+ *
+ * The error %SNAPD_ERROR_NOT_FOUND is returned if no system information has
+ * been recorded.
+ *
+ * Returns: (transfer full): a #SnapdSystemInformation or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdSystemInformation *
+snapd_client_get_system_information_cached (SnapdClient *self, GError **error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    if (priv->catalog_cache == NULL) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND, "No catalog cache set");
+        return NULL;
+    }
+
+    g_autoptr(SnapdGetSystemInfo) request = _snapd_get_system_info_new (NULL, NULL, NULL);
+    if (!_snapd_request_parse_cached_response (SNAPD_REQUEST (request), priv->catalog_cache, error))
+        return NULL;
+    return g_object_ref (_snapd_get_system_info_get_system_information (request));
+}
+
+/**
+ * snapd_client_list_one_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information of a single installed snap.
+ * See snapd_client_list_one_sync() for more information.
+ *
+ * Since: 1.0
+ * Deprecated: 1.42: Use snapd_client_get_snap_async()
+ */
+void
+snapd_client_list_one_async (SnapdClient *self,
+                             const gchar *name,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    return snapd_client_get_snap_async (self, name, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_list_one_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_list_one_async().
+ * See snapd_client_list_one_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.0
+ * Deprecated: 1.42: Use snapd_client_get_snap_finish()
+ */
+SnapdSnap *
+snapd_client_list_one_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    return snapd_client_get_snap_finish (self, result, error);
+}
+
+/**
+ * snapd_client_get_snap_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information of a single installed snap.
+ * See snapd_client_get_snap_sync() for more information.
+ *
+ * Since: 1.42
+ */
+void
+snapd_client_get_snap_async (SnapdClient *self,
+                             const gchar *name,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetSnap) request = _snapd_get_snap_new (name, cancellable, callback, user_data);
+
+    /* Use the snap from a recent response */
+    gboolean cached = FALSE;
+    if (name != NULL) {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        SnapdSnap *snap = lookup_cached_snap_unlocked (self, priv->snap_cache, priv->snap_cache_id, name);
+        if (snap != NULL) {
+            _snapd_get_snap_set_snap (request, snap);
+            priv->cache_hits++;
+            cached = TRUE;
+        }
+    }
+    if (cached) {
+        _snapd_request_set_source_object (SNAPD_REQUEST (request), G_OBJECT (self));
+        _snapd_request_return (SNAPD_REQUEST (request), NULL);
+        return;
+    }
+
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snap_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snap_async().
+ * See snapd_client_get_snap_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.42
+ */
+SnapdSnap *
+snapd_client_get_snap_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAP (result), NULL);
+
+    SnapdGetSnap *request = SNAPD_GET_SNAP (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_get_snap_get_snap (request));
+}
+
+/**
+ * snapd_client_get_snap_conf_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get configuration for a snap.
+ * See snapd_client_get_snap_conf_sync() for more information.
+ *
+ * Since: 1.48
+ */
+void
+snapd_client_get_snap_conf_async (SnapdClient *self,
+                                  const gchar *name,
+                                  GStrv keys,
+                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdGetSnapConf) request = _snapd_get_snap_conf_new (name, keys, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snap_conf_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snap_conf_async().
+ * See snapd_client_get_snap_conf_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type utf8 GVariant): a table of configuration values or %NULL on error.
+ *
+ * Since: 1.48
+ */
+GHashTable *
+snapd_client_get_snap_conf_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAP_CONF (result), NULL);
+
+    SnapdGetSnapConf *request = SNAPD_GET_SNAP_CONF (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    GHashTable *conf = _snapd_get_snap_conf_get_conf (request, error);
+    return conf != NULL ? g_hash_table_ref (conf) : NULL;
+}
+
+/**
+ * snapd_client_set_snap_conf_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to set configuration for.
+ * @key_values: (element-type utf8 GVariant): Keys to set.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously set configuration for a snap.
+ * See snapd_client_set_snap_conf_sync() for more information.
+ *
+ * Since: 1.48
+ */
+void
+snapd_client_set_snap_conf_async (SnapdClient *self,
+                                  const gchar *name,
+                                  GHashTable *key_values,
+                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+    g_return_if_fail (key_values != NULL);
+
+    g_autoptr(SnapdPutSnapConf) request = _snapd_put_snap_conf_new (name, key_values, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_set_snap_conf_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_set_snap_conf_async().
+ * See snapd_client_set_snap_conf_sync() for more information.
+ *
+ * Returns: %TRUE if configuration successfully applied.
+ *
+ * Since: 1.48
+ */
+gboolean
+snapd_client_set_snap_conf_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_PUT_SNAP_CONF (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/**
+ * snapd_client_get_snap_config_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get configuration for a snap.
+ * See snapd_client_get_snap_config_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_snap_config_async (SnapdClient *self,
+                                    const gchar *name,
+                                    GStrv keys,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdGetSnapConf) request = _snapd_get_snap_conf_new (name, keys, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snap_config_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snap_config_async().
+ * See snapd_client_get_snap_config_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdSnapConfig or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdSnapConfig *
+snapd_client_get_snap_config_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAP_CONF (result), NULL);
+
+    SnapdGetSnapConf *request = SNAPD_GET_SNAP_CONF (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_get_snap_conf_get_config (request));
+}
+
+/* State of a request to get or update the configuration of many snaps */
+typedef struct
+{
+    SnapdClient *client;
+    guint n_running;
+    GHashTable *configs;
+    GError *error;
+} SnapConfsData;
+
+static void
+snap_confs_data_free (SnapConfsData *data)
+{
+    g_object_unref (data->client);
+    g_hash_table_unref (data->configs);
+    g_clear_error (&data->error);
+    g_slice_free (SnapConfsData, data);
+}
+
+/* The configuration of a single snap being got or updated for a #SnapConfsData */
+typedef struct
+{
+    GTask *task;
+    gchar *name;
+    GHashTable *key_values;
+    gboolean all_keys;
+} SnapConfsItem;
+
+static SnapConfsItem *
+snap_confs_item_new (GTask *task, const gchar *name, GHashTable *key_values)
+{
+    SnapConfsItem *item = g_slice_new (SnapConfsItem);
+    item->task = g_object_ref (task);
+    item->name = g_strdup (name);
+    item->key_values = key_values != NULL ? g_hash_table_ref (key_values) : NULL;
+    item->all_keys = FALSE;
+    return item;
+}
+
+static void
+snap_confs_item_free (SnapConfsItem *item)
+{
+    g_object_unref (item->task);
+    g_free (item->name);
+    g_clear_pointer (&item->key_values, g_hash_table_unref);
+    g_slice_free (SnapConfsItem, item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapConfsItem, snap_confs_item_free)
+
+static SnapConfsData *
+snap_confs_data_new (SnapdClient *self)
+{
+    SnapConfsData *data = g_slice_new0 (SnapConfsData);
+    data->client = g_object_ref (self);
+    data->configs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    return data;
+}
+
+/* Complete the task once all the snaps are done */
+static void
+snap_confs_item_done (SnapConfsItem *item, GError *error)
+{
+    SnapConfsData *data = g_task_get_task_data (item->task);
+
+    if (error != NULL && data->error == NULL)
+        data->error = g_error_copy (error);
+
+    data->n_running--;
+    if (data->n_running > 0)
+        return;
+
+    if (data->error != NULL)
+        g_task_return_error (item->task, g_steal_pointer (&data->error));
+    else
+        g_task_return_boolean (item->task, TRUE);
+}
+
+static void
+get_snap_configs_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(SnapConfsItem) item = user_data;
+    SnapConfsData *data = g_task_get_task_data (item->task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSnapConfig) config = snapd_client_get_snap_config_finish (SNAPD_CLIENT (object), result, &error);
+    if (config != NULL)
+        g_hash_table_insert (data->configs, g_strdup (item->name), g_steal_pointer (&config));
+    snap_confs_item_done (item, error);
+}
+
+/**
+ * snapd_client_get_snap_configs_async:
+ * @client: a #SnapdClient.
+ * @names: names of snaps to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get configuration for many snaps.
+ * See snapd_client_get_snap_configs_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_snap_configs_async (SnapdClient *self,
+                                     GStrv names,
+                                     GStrv keys,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL && names[0] != NULL);
+
+    SnapConfsData *data = snap_confs_data_new (self);
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) snap_confs_data_free);
+
+    /* All requests are sent at once so they are pipelined */
+    data->n_running = g_strv_length (names);
+    for (gsize i = 0; names[i] != NULL; i++)
+        snapd_client_get_snap_config_async (self, names[i], keys, cancellable, get_snap_configs_cb, snap_confs_item_new (task, names[i], NULL));
+}
+
+/**
+ * snapd_client_get_snap_configs_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snap_configs_async().
+ * See snapd_client_get_snap_configs_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type utf8 SnapdSnapConfig): a table of configuration by snap name or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_client_get_snap_configs_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+    if (!g_task_propagate_boolean (G_TASK (result), error))
+        return NULL;
+    SnapConfsData *data = g_task_get_task_data (G_TASK (result));
+    return g_hash_table_ref (data->configs);
+}
+
+static void
+update_snap_conf_set_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(SnapConfsItem) item = user_data;
+
+    g_autoptr(GError) error = NULL;
+    snapd_client_set_snap_conf_finish (SNAPD_CLIENT (object), result, &error);
+    snap_confs_item_done (item, error);
+}
+
+static void
+update_snap_conf_get_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(SnapConfsItem) item = user_data;
+    GCancellable *cancellable = g_task_get_cancellable (item->task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSnapConfig) config = snapd_client_get_snap_config_finish (SNAPD_CLIENT (object), result, &error);
+
+    /* Getting keys that aren't set fails, so compare against everything instead */
+    if (g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_OPTION_NOT_FOUND) && !item->all_keys) {
+        item->all_keys = TRUE;
+        snapd_client_get_snap_config_async (SNAPD_CLIENT (object), item->name, NULL, cancellable, update_snap_conf_get_cb, g_steal_pointer (&item));
+        return;
+    }
+    if (config == NULL) {
+        snap_confs_item_done (item, error);
+        return;
+    }
+
+    g_autoptr(GHashTable) changes = snapd_snap_config_get_changes (config, item->key_values);
+    if (g_hash_table_size (changes) == 0) {
+        snap_confs_item_done (item, NULL);
+        return;
+    }
+
+    snapd_client_set_snap_conf_async (SNAPD_CLIENT (object), item->name, changes, cancellable, update_snap_conf_set_cb, g_steal_pointer (&item));
+}
+
+static void
+update_snap_confs (SnapdClient *self, GHashTable *confs,
+                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapConfsData *data = snap_confs_data_new (self);
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) snap_confs_data_free);
+
+    if (g_hash_table_size (confs) == 0) {
+        g_task_return_boolean (task, TRUE);
+        return;
+    }
+
+    /* All requests are sent at once so they are pipelined */
+    data->n_running = g_hash_table_size (confs);
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, confs);
+    gpointer name, key_values;
+    while (g_hash_table_iter_next (&iter, &name, &key_values)) {
+        g_autofree GStrv keys = (GStrv) g_hash_table_get_keys_as_array (key_values, NULL);
+        g_autoptr(SnapdGetSnapConf) request = _snapd_get_snap_conf_new (name, keys, cancellable, update_snap_conf_get_cb, snap_confs_item_new (task, name, key_values));
+        send_request (self, SNAPD_REQUEST (request));
+    }
+}
+
+/**
+ * snapd_client_update_snap_conf_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to set configuration for.
+ * @key_values: (element-type utf8 GVariant): Keys to set.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously set the configuration values for a snap that have changed.
+ * See snapd_client_update_snap_conf_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_update_snap_conf_async (SnapdClient *self,
+                                     const gchar *name,
+                                     GHashTable *key_values,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+    g_return_if_fail (key_values != NULL);
+
+    g_autoptr(GHashTable) confs = g_hash_table_new (g_str_hash, g_str_equal);
+    if (g_hash_table_size (key_values) > 0)
+        g_hash_table_insert (confs, (gpointer) name, key_values);
+    update_snap_confs (self, confs, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_update_snap_conf_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_update_snap_conf_async().
+ * See snapd_client_update_snap_conf_sync() for more information.
+ *
+ * Returns: %TRUE if configuration successfully applied.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_update_snap_conf_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_update_snap_confs_async:
+ * @client: a #SnapdClient.
+ * @confs: (element-type utf8 GLib.HashTable): tables of keys to set by snap name.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously set the configuration values for many snaps that have changed.
+ * See snapd_client_update_snap_confs_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_update_snap_confs_async (SnapdClient *self,
+                                      GHashTable *confs,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (confs != NULL);
+
+    g_autoptr(GHashTable) non_empty = g_hash_table_new (g_str_hash, g_str_equal);
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, confs);
+    gpointer name, key_values;
+    while (g_hash_table_iter_next (&iter, &name, &key_values)) {
+        if (g_hash_table_size (key_values) > 0)
+            g_hash_table_insert (non_empty, name, key_values);
+    }
+    update_snap_confs (self, non_empty, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_update_snap_confs_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_update_snap_confs_async().
+ * See snapd_client_update_snap_confs_sync() for more information.
+ *
+ * Returns: %TRUE if configuration successfully applied to all snaps.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_update_snap_confs_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_get_apps_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on installed apps.
+ * See snapd_client_get_apps_sync() for more information.
+ *
+ * Since: 1.25
+ * Deprecated: 1.45: Use snapd_client_get_apps2_async()
+ */
+void
+snapd_client_get_apps_async (SnapdClient *self,
+                             SnapdGetAppsFlags flags,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    return snapd_client_get_apps2_async (self, flags, NULL, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_get_apps_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_apps_async().
+ * See snapd_client_get_apps_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp or %NULL on error.
+ *
+ * Since: 1.25
+ * Deprecated: 1.45: Use snapd_client_get_apps2_finish()
+ */
+GPtrArray *
+snapd_client_get_apps_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    return snapd_client_get_apps2_finish (self, result, error);
+}
+
+/**
+ * snapd_client_get_apps2_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
+ * @snaps: (allow-none): A list of snap names to return results for. If %NULL or empty then apps for all installed snaps are returned.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on installed apps.
+ * See snapd_client_get_apps2_sync() for more information.
+ *
+ * Since: 1.45
+ */
+void
+snapd_client_get_apps2_async (SnapdClient *self,
+                              SnapdGetAppsFlags flags,
+                              GStrv snaps,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetApps) request = _snapd_get_apps_new (snaps, cancellable, callback, user_data);
+    if ((flags & SNAPD_GET_APPS_FLAGS_SELECT_SERVICES) != 0)
+        _snapd_get_apps_set_select (request, "service");
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_apps2_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_apps2_async().
+ * See snapd_client_get_apps2_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp or %NULL on error.
+ *
+ * Since: 1.45
+ */
+GPtrArray *
+snapd_client_get_apps2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_APPS (result), NULL);
+
+    SnapdGetApps *request = SNAPD_GET_APPS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_apps_get_apps (request));
+}
+
+/**
+ * snapd_client_get_apps2_model_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_apps2_async(), returning
+ * the apps as a list model.
+ * See snapd_client_get_apps2_model_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdApp or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_get_apps2_model_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_finish (self, result, error);
+    if (apps == NULL)
+        return NULL;
+    return snapd_result_list_new (SNAPD_TYPE_APP, apps);
+}
+
+static void
+control_services_get_apps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+
+    GError *error = NULL;
+    GPtrArray *apps = snapd_client_get_apps2_finish (SNAPD_CLIENT (object), result, &error);
+    if (apps == NULL)
+        g_task_return_error (task, error);
+    else
+        g_task_return_pointer (task, apps, (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+control_services_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdClient *self = SNAPD_CLIENT (object);
+    SnapdPostApps *request = SNAPD_POST_APPS (result);
+
+    GError *error = NULL;
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), &error)) {
+        g_task_return_error (task, error);
+        return;
+    }
+
+    /* Refresh the state of all the services in one request */
+    GStrv names = g_task_get_task_data (task);
+    snapd_client_get_apps2_async (self, SNAPD_GET_APPS_FLAGS_SELECT_SERVICES, names, g_task_get_cancellable (task), control_services_get_apps_cb, g_object_ref (task));
+}
+
+/**
+ * snapd_client_control_services_async:
+ * @client: a #SnapdClient.
+ * @action: the #SnapdServiceAction to apply.
+ * @flags: a set of #SnapdControlServicesFlags to control how the services are changed.
+ * @names: names of snaps or apps in the form snap.app to change the services of.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously start, stop or restart services.
+ * See snapd_client_control_services_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_control_services_async (SnapdClient *self,
+                                     SnapdServiceAction action, SnapdControlServicesFlags flags,
+                                     GStrv names,
+                                     SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL && names[0] != NULL);
+
+    const gchar *action_name = NULL;
+    switch (action) {
+    case SNAPD_SERVICE_ACTION_START:
+        action_name = "start";
+        break;
+    case SNAPD_SERVICE_ACTION_STOP:
+        action_name = "stop";
+        break;
+    case SNAPD_SERVICE_ACTION_RESTART:
+        action_name = "restart";
+        break;
+    }
+    g_return_if_fail (action_name != NULL);
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, g_strdupv (names), (GDestroyNotify) g_strfreev);
+
+    /* All the services are changed in a single change so progress covers them all */
+    g_autoptr(SnapdPostApps) request = _snapd_post_apps_new (action_name, names, progress_callback, progress_callback_data, cancellable, control_services_cb, g_object_ref (task));
+    _snapd_post_apps_set_enable (request, action == SNAPD_SERVICE_ACTION_START && (flags & SNAPD_CONTROL_SERVICES_FLAGS_ENABLE) != 0);
+    _snapd_post_apps_set_disable (request, action == SNAPD_SERVICE_ACTION_STOP && (flags & SNAPD_CONTROL_SERVICES_FLAGS_DISABLE) != 0);
+    _snapd_post_apps_set_reload (request, action == SNAPD_SERVICE_ACTION_RESTART && (flags & SNAPD_CONTROL_SERVICES_FLAGS_RELOAD) != 0);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_control_services_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_control_services_async().
+ * See snapd_client_control_services_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_control_services_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+    return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_get_logs_async:
+ * @client: a #SnapdClient.
+ * @names: (allow-none): a list of snap or app names to get logs for. If %NULL or empty then logs for all services are returned.
+ * @n: number of log entries to get, -1 for all of them or 0 for the snapd default.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the most recent log entries written by services.
+ * See snapd_client_get_logs_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_logs_async (SnapdClient *self,
+                             GStrv names, gint n,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetLogs) request = _snapd_get_logs_new (names, n, FALSE, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_logs_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_logs_async().
+ * See snapd_client_get_logs_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdLog): an array of #SnapdLog or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_logs_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_LOGS (result), NULL);
+
+    SnapdGetLogs *request = SNAPD_GET_LOGS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_logs_get_logs (request));
+}
+
+/**
+ * snapd_client_follow_logs_async:
+ * @client: a #SnapdClient.
+ * @names: (allow-none): a list of snap or app names to get logs for. If %NULL or empty then logs for all services are returned.
+ * @n: number of existing log entries to get before following, -1 for all of them or 0 for the snapd default.
+ * @log_callback: (scope call): function to call with each log entry as it is received.
+ * @log_callback_data: (closure): user data to pass to @log_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously follow the logs written by services, passing each entry to @log_callback as it is received.
+ * See snapd_client_follow_logs_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_follow_logs_async (SnapdClient *self,
+                                GStrv names, gint n,
+                                SnapdLogCallback log_callback, gpointer log_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (log_callback != NULL);
+
+    g_autoptr(SnapdGetLogs) request = _snapd_get_logs_new (names, n, TRUE, cancellable, callback, user_data);
+    _snapd_request_set_item_callback (SNAPD_REQUEST (request), G_CALLBACK (log_callback), log_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_follow_logs_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_follow_logs_async().
+ * See snapd_client_follow_logs_sync() for more information.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_follow_logs_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_LOGS (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/**
+ * snapd_client_get_icon_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get icon for.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the icon for an installed snap.
+ * See snapd_client_get_icon_sync() for more information.
+ *
+ * Since: 1.0
+ */
+void
+snapd_client_get_icon_async (SnapdClient *self,
+                             const gchar *name,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetIcon) request = _snapd_get_icon_new (name, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_icon_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_icon_async().
+ * See snapd_client_get_icon_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdIcon or %NULL on error.
+ *
+ * Since: 1.0
+ */
+SnapdIcon *
+snapd_client_get_icon_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_ICON (result), NULL);
+
+    SnapdGetIcon *request = SNAPD_GET_ICON (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_get_icon_get_icon (request));
+}
+
+/* State of a request for many icons */
+typedef struct
+{
+    SnapdClient *client;
+    GStrv names;
+    guint next_name;
+    guint n_running;
+    guint max_parallel;
+    SnapdIconCallback icon_callback;
+    gpointer icon_callback_data;
+    GError *error;
+} GetIconsData;
+
+static void
+get_icons_data_free (GetIconsData *data)
+{
+    g_object_unref (data->client);
+    g_strfreev (data->names);
+    g_clear_error (&data->error);
+    g_slice_free (GetIconsData, data);
+}
+
+/* A single icon being retrieved for a #GetIconsData */
+typedef struct
+{
+    GTask *task;
+    gchar *name;
+} GetIconsItem;
+
+static void get_icons_start (GTask *task);
+
+static void
+get_icons_icon_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    GetIconsItem *item = user_data;
+    g_autoptr(GTask) task = item->task;
+    g_autofree gchar *name = item->name;
+    g_slice_free (GetIconsItem, item);
+    GetIconsData *data = g_task_get_task_data (task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), result, &error);
+    if (data->icon_callback != NULL)
+        data->icon_callback (data->client, name, icon, error, data->icon_callback_data);
+    if (error != NULL && data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    data->n_running--;
+    get_icons_start (task);
+}
+
+/* Request icons until the limit is reached, completing once all have been received */
+static void
+get_icons_start (GTask *task)
+{
+    GetIconsData *data = g_task_get_task_data (task);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    while (data->names[data->next_name] != NULL && data->n_running < data->max_parallel &&
+           !g_cancellable_is_cancelled (cancellable)) {
+        GetIconsItem *item = g_slice_new (GetIconsItem);
+        item->task = g_object_ref (task);
+        item->name = g_strdup (data->names[data->next_name]);
+        data->next_name++;
+        data->n_running++;
+        snapd_client_get_icon_async (data->client, item->name, cancellable, get_icons_icon_cb, item);
+    }
+
+    if (data->n_running > 0)
+        return;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+        g_task_return_error (task, g_steal_pointer (&error));
+    else if (data->error != NULL)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * snapd_client_get_icons_async:
+ * @client: a #SnapdClient.
+ * @names: names of snaps to get icons for.
+ * @max_parallel: maximum number of icons to request at once, or 0 for one per connection.
+ * @icon_callback: (scope call): function to call with each icon as it is retrieved.
+ * @icon_callback_data: (closure): user data to pass to @icon_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the icons for many installed snaps.
+ * See snapd_client_get_icons_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_icons_async (SnapdClient *self,
+                              GStrv names, guint max_parallel,
+                              SnapdIconCallback icon_callback, gpointer icon_callback_data,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL);
+
+    GetIconsData *data = g_slice_new0 (GetIconsData);
+    data->client = g_object_ref (self);
+    data->names = g_strdupv (names);
+    data->max_parallel = max_parallel > 0 ? max_parallel : MAX (priv->max_connections, 1);
+    data->icon_callback = icon_callback;
+    data->icon_callback_data = icon_callback_data;
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) get_icons_data_free);
+    get_icons_start (task);
+}
+
+/**
+ * snapd_client_get_icons_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_icons_async().
+ * See snapd_client_get_icons_sync() for more information.
+ *
+ * Returns: %TRUE if all icons were retrieved.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_icons_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_client_get_icon2_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to get icon for.
+ * @revision: (allow-none): revision of the snap that is installed or %NULL if not known.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the icon for an installed snap.
+ * See snapd_client_get_icon2_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_icon2_async (SnapdClient *self,
+                              const gchar *name, const gchar *revision,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetIcon) request = _snapd_get_icon_new (name, cancellable, callback, user_data);
+    _snapd_get_icon_set_cache (request, priv->icon_cache_path, revision);
+    if (_snapd_get_icon_load_cache (request)) {
+        _snapd_request_set_source_object (SNAPD_REQUEST (request), G_OBJECT (self));
+        _snapd_request_return (SNAPD_REQUEST (request), NULL);
+        return;
+    }
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_icon2_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_icon2_async().
+ * See snapd_client_get_icon2_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdIcon or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdIcon *
+snapd_client_get_icon2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    return snapd_client_get_icon_finish (self, result, error);
+}
+
+/**
+ * snapd_client_list_async:
+ * @client: a #SnapdClient.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on all installed snaps.
+ * See snapd_client_list_sync() for more information.
+ *
+ * Since: 1.0
+ * Deprecated: 1.42: Use snapd_client_get_snaps_async()
+ */
+void
+snapd_client_list_async (SnapdClient *self,
+                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    return snapd_client_get_snaps_async (self, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, cancellable, callback, user_data);
+}
+
+/**
+ * snapd_client_list_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_list_async().
+ * See snapd_client_list_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.0
+ * Deprecated: 1.42: Use snapd_client_get_snaps_finish()
+ */
+GPtrArray *
+snapd_client_list_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    return snapd_client_get_snaps_finish (self, result, error);
+}
+
+static SnapdGetSnaps *
+make_get_snaps_request (SnapdGetSnapsFlags flags, GStrv names,
+                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdGetSnaps *request = _snapd_get_snaps_new (cancellable, names, callback, user_data);
+    if ((flags & SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE) != 0)
+        _snapd_get_snaps_set_select (request, "all");
+
+    return request;
+}
+
+/**
+ * snapd_client_get_snaps_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names to return results for. If %NULL or empty then all installed snaps are returned.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on installed snaps.
+ * See snapd_client_get_snaps_sync() for more information.
+ *
+ * Since: 1.42
+ */
+void
+snapd_client_get_snaps_async (SnapdClient *self,
+                              SnapdGetSnapsFlags flags,
+                              GStrv names,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetSnaps) request = make_get_snaps_request (flags, names, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snaps_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snaps_async().
+ * See snapd_client_get_snaps_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.42
+ */
+GPtrArray *
+snapd_client_get_snaps_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAPS (result), NULL);
+
+    SnapdGetSnaps *request = SNAPD_GET_SNAPS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_snaps_get_snaps (request));
+}
+
+/**
+ * snapd_client_get_snaps_model_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snaps_async(), returning
+ * the snaps as a list model.
+ * See snapd_client_get_snaps_model_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_get_snaps_model_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (self, result, error);
+    if (snaps == NULL)
+        return NULL;
+    return snapd_result_list_new (SNAPD_TYPE_SNAP, snaps);
+}
+
+/**
+ * snapd_client_get_snaps_with_fields_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names to return results for. If %NULL or empty then all installed snaps are returned.
+ * @fields: a set of #SnapdSnapFields to set in the returned snaps.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on installed snaps, only setting the snap fields in @fields.
+ * See snapd_client_get_snaps_with_fields_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_snaps_with_fields_async (SnapdClient *self,
+                                          SnapdGetSnapsFlags flags,
+                                          GStrv names,
+                                          SnapdSnapFields fields,
+                                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetSnaps) request = make_get_snaps_request (flags, names, cancellable, callback, user_data);
+    _snapd_get_snaps_set_fields (request, fields);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snaps_with_fields_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snaps_with_fields_async().
+ * See snapd_client_get_snaps_with_fields_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_snaps_with_fields_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    return snapd_client_get_snaps_finish (self, result, error);
+}
+
+/**
+ * snapd_client_get_snaps_stream_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
+ * @names: (allow-none): A list of snap names to return results for. If %NULL or empty then all installed snaps are returned.
+ * @snap_callback: (scope call): function to call with each snap as it is parsed.
+ * @snap_callback_data: (closure): user data to pass to @snap_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get information on installed snaps.
+ * See snapd_client_get_snaps_stream_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_snaps_stream_async (SnapdClient *self,
+                                     SnapdGetSnapsFlags flags, GStrv names,
+                                     SnapdSnapCallback snap_callback, gpointer snap_callback_data,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (snap_callback != NULL);
+
+    g_autoptr(SnapdGetSnaps) request = make_get_snaps_request (flags, names, cancellable, callback, user_data);
+    _snapd_request_set_item_callback (SNAPD_REQUEST (request), G_CALLBACK (snap_callback), snap_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_snaps_stream_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_snaps_stream_async().
+ * See snapd_client_get_snaps_stream_sync() for more information.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_snaps_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAPS (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/**
+ * snapd_client_get_assertions_async:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get assertions.
+ * See snapd_client_get_assertions_sync() for more information.
+ *
+ * Since: 1.8
+ */
+void
+snapd_client_get_assertions_async (SnapdClient *self,
+                                   const gchar *type,
+                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (type != NULL);
+
+    g_autoptr(SnapdGetAssertions) request = _snapd_get_assertions_new (type, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_assertions_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_assertions_async().
+ * See snapd_client_get_assertions_sync() for more information.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): an array of assertions or %NULL on error.
+ *
+ * Since: 1.8
+ */
+GStrv
+snapd_client_get_assertions_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_ASSERTIONS (result), NULL);
+
+    SnapdGetAssertions *request = SNAPD_GET_ASSERTIONS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+
+    GPtrArray *assertions = _snapd_get_assertions_get_assertions (request);
+    GStrv result_assertions = g_new (gchar *, assertions->len + 1);
+    for (guint i = 0; i < assertions->len; i++) {
+        GBytes *assertion = g_ptr_array_index (assertions, i);
+        gsize length;
+        const gchar *data = g_bytes_get_data (assertion, &length);
+        result_assertions[i] = g_strndup (data, length);
+    }
+    result_assertions[assertions->len] = NULL;
+
+    return result_assertions;
+}
+
+/**
+ * snapd_client_get_assertions_bytes_async:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get assertions without copying them.
+ * See snapd_client_get_assertions_bytes_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_assertions_bytes_async (SnapdClient *self,
+                                         const gchar *type,
+                                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (type != NULL);
+
+    g_autoptr(SnapdGetAssertions) request = _snapd_get_assertions_new (type, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_assertions_bytes_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_assertions_bytes_async().
+ * See snapd_client_get_assertions_bytes_sync() for more information.
+ *
+ * Returns: (transfer container) (element-type GBytes): an array of assertions or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_get_assertions_bytes_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_ASSERTIONS (result), NULL);
+
+    SnapdGetAssertions *request = SNAPD_GET_ASSERTIONS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_assertions_get_assertions (request));
+}
+
+/**
+ * snapd_client_get_assertions_stream_async:
+ * @client: a #SnapdClient.
+ * @type: assertion type to get.
+ * @assertion_callback: (scope call): function to call with each assertion as it is received.
+ * @assertion_callback_data: (closure): user data to pass to @assertion_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get assertions, passing each one to @assertion_callback as it is received.
+ * See snapd_client_get_assertions_stream_sync() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_client_get_assertions_stream_async (SnapdClient *self,
+                                          const gchar *type,
+                                          SnapdAssertionCallback assertion_callback, gpointer assertion_callback_data,
+                                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (type != NULL);
+    g_return_if_fail (assertion_callback != NULL);
+
+    g_autoptr(SnapdGetAssertions) request = _snapd_get_assertions_new (type, cancellable, callback, user_data);
+    _snapd_request_set_item_callback (SNAPD_REQUEST (request), G_CALLBACK (assertion_callback), assertion_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+/**
+ * snapd_client_get_assertions_stream_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_get_assertions_stream_async().
+ * See snapd_client_get_assertions_stream_sync() for more information.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_client_get_assertions_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_ASSERTIONS (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/**
+ * snapd_client_add_assertions_async:
+ * @client: a #SnapdClient.
+ * @assertions: assertions to add.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * This method is no longer required and does nothing, snapd-glib now connects on demand.
+ * Asynchronously add an assertion.
+ * See snapd_client_add_assertions_sync() for more information.
  *
- * Since: 1.3
- * Deprecated: 1.24
+ * Since: 1.8
  */
 void
-snapd_client_connect_async (SnapdClient *self,
-                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_add_assertions_async (SnapdClient *self,
+                                   GStrv assertions,
+                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (assertions != NULL);
 
-    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
-    g_task_return_boolean (task, TRUE);
+    g_autoptr(SnapdPostAssertions) request = _snapd_post_assertions_new (assertions, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_connect_finish:
- * @client: a #SnapdClient
+ * snapd_client_add_assertions_finish:
+ * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_connect_async().
- * See snapd_client_connect_sync() for more information.
+ * Complete request started with snapd_client_add_assertions_async().
+ * See snapd_client_add_assertions_sync() for more information.
  *
- * Returns: %TRUE if successfully connected to snapd.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.3
+ * Since: 1.8
  */
 gboolean
-snapd_client_connect_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_add_assertions_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_ASSERTIONS (result), FALSE);
 
-    return g_task_propagate_boolean (G_TASK (result), error);
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_set_socket_path:
- * @client: a #SnapdClient
- * @socket_path: (allow-none): a socket path or %NULL to reset to the default.
+ * snapd_client_add_assertions_stream_async:
+ * @client: a #SnapdClient.
+ * @stream: a #GInputStream containing the assertions to add.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
  *
- * Set the Unix socket path to connect to snapd with.
- * Defaults to the system socket.
+ * Asynchronously add assertions read from a stream.
+ * See snapd_client_add_assertions_stream_sync() for more information.
  *
- * Since: 1.24
+ * Since: 1.65
  */
 void
-snapd_client_set_socket_path (SnapdClient *self, const gchar *socket_path)
+snapd_client_add_assertions_stream_async (SnapdClient *self,
+                                          GInputStream *stream,
+                                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (G_IS_INPUT_STREAM (stream));
 
-    g_free (priv->socket_path);
-    if (socket_path != NULL)
-        priv->socket_path = g_strdup (socket_path);
-    else
-        priv->socket_path = g_strdup (SNAPD_SOCKET);
+    g_autoptr(SnapdPostAssertions) request = _snapd_post_assertions_new (NULL, cancellable, callback, user_data);
+    _snapd_post_assertions_set_stream (request, stream);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_socket_path:
- * @client: a #SnapdClient
+ * snapd_client_add_assertions_stream_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get the unix socket path to connect to snapd with.
+ * Complete request started with snapd_client_add_assertions_stream_async().
+ * See snapd_client_add_assertions_stream_sync() for more information.
  *
- * Returns: socket path.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.24
+ * Since: 1.65
  */
-const gchar *
-snapd_client_get_socket_path (SnapdClient *self)
+gboolean
+snapd_client_add_assertions_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    return priv->socket_path;
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_ASSERTIONS (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_set_user_agent:
- * @client: a #SnapdClient
- * @user_agent: (allow-none): a user agent or %NULL.
+ * snapd_client_get_interfaces_async:
+ * @client: a #SnapdClient.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
  *
- * Set the HTTP user-agent that is sent with each request to snapd.
- * Defaults to "snapd-glib/VERSION".
+ * Asynchronously get the installed snap interfaces.
+ * See snapd_client_get_interfaces_sync() for more information.
  *
- * Since: 1.16
+ * Since: 1.0
+ * Deprecated: 1.48: Use snapd_client_get_connections2_async()
  */
 void
-snapd_client_set_user_agent (SnapdClient *self, const gchar *user_agent)
+snapd_client_get_interfaces_async (SnapdClient *self,
+                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_free (priv->user_agent);
-    priv->user_agent = g_strdup (user_agent);
+#ifndef DISABLE_LEGACY_SNAPD
+    g_autoptr(SnapdGetInterfacesLegacy) request = _snapd_get_interfaces_legacy_new (cancellable, callback, user_data);
+#else
+    /* Without the legacy decoder get the plugs and slots from /v2/connections */
+    g_autoptr(SnapdGetConnections) request = _snapd_get_connections_new (NULL, NULL, "all", cancellable, callback, user_data);
+#endif
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_user_agent:
- * @client: a #SnapdClient
+ * snapd_client_get_interfaces_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
+ * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get the HTTP user-agent that is sent with each request to snapd.
+ * Complete request started with snapd_client_get_interfaces_async().
+ * See snapd_client_get_interfaces_sync() for more information.
  *
- * Returns: (allow-none): user agent or %NULL if none set.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.16
+ * Since: 1.0
+ * Deprecated: 1.48: Use snapd_client_get_connections2_finish()
  */
-const gchar *
-snapd_client_get_user_agent (SnapdClient *self)
+gboolean
+snapd_client_get_interfaces_finish (SnapdClient *self, GAsyncResult *result,
+                                    GPtrArray **plugs, GPtrArray **slots,
+                                    GError **error)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    return priv->user_agent;
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+#ifndef DISABLE_LEGACY_SNAPD
+    g_return_val_if_fail (SNAPD_IS_GET_INTERFACES_LEGACY (result), FALSE);
+
+    SnapdGetInterfacesLegacy *request = SNAPD_GET_INTERFACES_LEGACY (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return FALSE;
+    if (plugs)
+       *plugs = g_ptr_array_ref (_snapd_get_interfaces_legacy_get_plugs (request));
+    if (slots)
+       *slots = g_ptr_array_ref (_snapd_get_interfaces_legacy_get_slots (request));
+#else
+    g_return_val_if_fail (SNAPD_IS_GET_CONNECTIONS (result), FALSE);
+
+    SnapdGetConnections *request = SNAPD_GET_CONNECTIONS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return FALSE;
+    if (plugs)
+       *plugs = g_ptr_array_ref (_snapd_get_connections_get_plugs (request));
+    if (slots)
+       *slots = g_ptr_array_ref (_snapd_get_connections_get_slots (request));
+#endif
+    return TRUE;
 }
 
 /**
- * snapd_client_set_allow_interaction:
- * @client: a #SnapdClient
- * @allow_interaction: whether to allow interaction.
+ * snapd_client_get_interfaces2_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdGetInterfacesFlags to control what information is returned about the interfaces.
+ * @names: (allow-none) (array zero-terminated=1): a null-terminated array of interface names or %NULL.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
  *
- * Set whether snapd operations are allowed to interact with the user.
- * This affects operations that use polkit authorisation.
- * Defaults to TRUE.
+ * Asynchronously get the installed snap interfaces.
+ * See snapd_client_get_interfaces2_sync() for more information.
  *
- * Since: 1.19
+ * Since: 1.48
  */
 void
-snapd_client_set_allow_interaction (SnapdClient *self, gboolean allow_interaction)
+snapd_client_get_interfaces2_async (SnapdClient *self,
+                                    SnapdGetInterfacesFlags flags,
+                                    GStrv names,
+                                    GCancellable *cancellable,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    priv->allow_interaction = allow_interaction;
-}
 
-/**
- * snapd_client_get_maintenance:
- * @client: a #SnapdClient
- *
- * Get the maintenance information reported by snapd or %NULL if no maintenance is in progress.
- * This information is updated after every request.
- *
- * Returns: (transfer none) (allow-none): a #SnapdMaintenance or %NULL.
- *
- * Since: 1.45
- */
-SnapdMaintenance *
-snapd_client_get_maintenance (SnapdClient *self)
-{
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    return priv->maintenance;
+
+    g_autoptr(SnapdGetInterfaces) request = _snapd_get_interfaces_new (names, cancellable, callback, user_data);
+    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_DOCS) != 0) {
+        gboolean fill_docs = FALSE, request_version = FALSE;
+        g_mutex_lock (&priv->requests_mutex);
+        if (priv->cache_interface_docs) {
+            fill_docs = have_interface_docs_unlocked (self, _snapd_get_interfaces_get_names (request));
+            request_version = priv->snapd_version == NULL && !priv->requested_snapd_version;
+            if (request_version)
+                priv->requested_snapd_version = TRUE;
+        }
+        g_mutex_unlock (&priv->requests_mutex);
+
+        /* The documentation is recorded against the snapd version, so get it first */
+        if (request_version) {
+            g_autoptr(SnapdGetSystemInfo) system_info_request = _snapd_get_system_info_new (NULL, NULL, NULL);
+            send_request (self, SNAPD_REQUEST (system_info_request));
+        }
+
+        if (fill_docs)
+            _snapd_get_interfaces_set_fill_docs (request, TRUE);
+        else
+            _snapd_get_interfaces_set_include_docs (request, TRUE);
+    }
+    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_PLUGS) != 0)
+        _snapd_get_interfaces_set_include_plugs (request, TRUE);
+    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_SLOTS) != 0)
+        _snapd_get_interfaces_set_include_slots (request, TRUE);
+    if ((flags & SNAPD_GET_INTERFACES_FLAGS_ONLY_CONNECTED) != 0)
+        _snapd_get_interfaces_set_only_connected (request, TRUE);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_allow_interaction:
- * @client: a #SnapdClient
+ * snapd_client_get_interfaces2_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get whether snapd operations are allowed to interact with the user.
+ * Complete request started with snapd_client_get_interfaces2_async().
+ * See snapd_client_get_interfaces2_sync() for more information.
  *
- * Returns: %TRUE if interaction is allowed.
+ * Returns: (transfer container) (element-type SnapdInterface): an array of #SnapdInterface or %NULL on error.
  *
- * Since: 1.19
+ * Since: 1.48
  */
-gboolean
-snapd_client_get_allow_interaction (SnapdClient *self)
+GPtrArray *
+snapd_client_get_interfaces2_finish (SnapdClient *self,
+                                     GAsyncResult *result,
+                                     GError **error)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    return priv->allow_interaction;
+    g_return_val_if_fail (SNAPD_IS_GET_INTERFACES (result), FALSE);
+
+    SnapdGetInterfaces *request = SNAPD_GET_INTERFACES (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_interfaces_get_interfaces (request));
 }
 
 /**
- * snapd_client_login_async:
+ * snapd_client_get_connections_async:
  * @client: a #SnapdClient.
- * @email: email address to log in with.
- * @password: password to log in with.
- * @otp: (allow-none): response to one-time password challenge.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get authorization to install/remove snaps.
- * See snapd_client_login_sync() for more information.
+ * Asynchronously get the installed snap connections.
+ * See snapd_client_get_connections_sync() for more information.
  *
- * Since: 1.0
- * Deprecated: 1.26: Use snapd_client_login2_async()
+ * Since: 1.48
+ * Deprecated: 1.49: Use snapd_client_get_connections2_async()
  */
 void
-snapd_client_login_async (SnapdClient *self,
-                          const gchar *email, const gchar *password, const gchar *otp,
-                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_get_connections_async (SnapdClient *self,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    snapd_client_login2_async (self, email, password, otp, cancellable, callback, user_data);
+    snapd_client_get_connections2_async (self, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_login_finish:
+ * snapd_client_get_connections_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @established: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of connections or %NULL.
+ * @undesired: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of auto-connected connections that have been manually disconnected or %NULL.
+ * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
+ * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_login_async().
- * See snapd_client_login_sync() for more information.
+ * Complete request started with snapd_client_get_connections_async().
+ * See snapd_client_get_connections_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdAuthData or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.0
- * Deprecated: 1.26: Use snapd_client_login2_finish()
+ * Since: 1.48
+ * Deprecated: 1.49: Use snapd_client_get_connections2_finish()
  */
-SnapdAuthData *
-snapd_client_login_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_get_connections_finish (SnapdClient *self, GAsyncResult *result,
+                                     GPtrArray **established, GPtrArray **undesired,
+                                     GPtrArray **plugs, GPtrArray **slots,
+                                     GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_finish (self, result, error);
-    if (user_information == NULL)
-        return NULL;
-
-    return g_object_ref (snapd_user_information_get_auth_data (user_information));
+    return snapd_client_get_connections2_finish (self, result, established, undesired, plugs, slots, error);
 }
 
 /**
- * snapd_client_login2_async:
+ * snapd_client_get_connections2_async:
  * @client: a #SnapdClient.
- * @email: email address to log in with.
- * @password: password to log in with.
- * @otp: (allow-none): response to one-time password challenge.
+ * @flags: a set of #SnapdGetConnectionsFlags to control what results are returned.
+ * @snap: (allow-none): the name of the snap to get connections for or %NULL for all snaps.
+ * @interface: (allow-none): the name of the interface to get connections for or %NULL for all interfaces.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get authorization to install/remove snaps.
- * See snapd_client_login2_sync() for more information.
+ * Asynchronously get the installed snap connections.
+ * See snapd_client_get_connections_sync() for more information.
  *
- * Since: 1.26
+ * Since: 1.49
  */
 void
-snapd_client_login2_async (SnapdClient *self,
-                           const gchar *email, const gchar *password, const gchar *otp,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_get_connections2_async (SnapdClient *self,
+                                     SnapdGetConnectionsFlags flags, const gchar *snap, const gchar *interface,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdPostLogin) request = _snapd_post_login_new (email, password, otp, cancellable, callback, user_data);
+    const gchar *select = NULL;
+    if ((flags & SNAPD_GET_CONNECTIONS_FLAGS_SELECT_ALL) != 0)
+        select = "all";
+    g_autoptr(SnapdGetConnections) request = _snapd_get_connections_new (snap, interface, select, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_login2_finish:
+ * snapd_client_get_connections2_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @established: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of connections or %NULL.
+ * @undesired: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of auto-connected connections that have been manually disconnected or %NULL.
+ * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
+ * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_login2_async().
- * See snapd_client_login2_sync() for more information.
+ * Complete request started with snapd_client_get_connections_async().
+ * See snapd_client_get_connections_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdUserInformation or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.26
+ * Since: 1.49
  */
-SnapdUserInformation *
-snapd_client_login2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_get_connections2_finish (SnapdClient *self, GAsyncResult *result,
+                                      GPtrArray **established, GPtrArray **undesired,
+                                      GPtrArray **plugs, GPtrArray **slots,
+                                      GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_POST_LOGIN (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_CONNECTIONS (result), FALSE);
 
-    SnapdPostLogin *request = SNAPD_POST_LOGIN (result);
+    SnapdGetConnections *request = SNAPD_GET_CONNECTIONS (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_object_ref (_snapd_post_login_get_user_information (request));
+        return FALSE;
+    if (established)
+       *established = g_ptr_array_ref (_snapd_get_connections_get_established (request));
+    if (undesired)
+       *undesired = g_ptr_array_ref (_snapd_get_connections_get_undesired (request));
+    if (plugs)
+       *plugs = g_ptr_array_ref (_snapd_get_connections_get_plugs (request));
+    if (slots)
+       *slots = g_ptr_array_ref (_snapd_get_connections_get_slots (request));
+    return TRUE;
 }
 
 /**
- * snapd_client_logout_async:
+ * snapd_client_connect_interface_async:
  * @client: a #SnapdClient.
- * @id: login ID to use.
+ * @plug_snap: name of snap containing plug.
+ * @plug_name: name of plug to connect.
+ * @slot_snap: name of snap containing socket.
+ * @slot_name: name of slot to connect.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously log out from the snap store.
- * See snapd_client_logout_sync() for more information.
+ * Asynchronously connect two interfaces together.
+ * See snapd_client_connect_interface_sync() for more information.
  *
- * Since: 1.55
+ * Since: 1.0
  */
 void
-snapd_client_logout_async (SnapdClient *self,
-                           gint64 id,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_connect_interface_async (SnapdClient *self,
+                                      const gchar *plug_snap, const gchar *plug_name,
+                                      const gchar *slot_snap, const gchar *slot_name,
+                                      SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdPostLogout) request = _snapd_post_logout_new (id, cancellable, callback, user_data);
+    g_autoptr(SnapdPostInterfaces) request = _snapd_post_interfaces_new ("connect", plug_snap, plug_name, slot_snap, slot_name, progress_callback, progress_callback_data, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_logout_finish:
+ * snapd_client_connect_interface_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_logout_async().
- * See snapd_client_logout_sync() for more information.
+ * Complete request started with snapd_client_connect_interface_async().
+ * See snapd_client_connect_interface_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.55
+ * Since: 1.0
  */
 gboolean
-snapd_client_logout_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_connect_interface_finish (SnapdClient *self,
+                                       GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_LOGOUT (result), FALSE);
-
-    SnapdPostLogout *request = SNAPD_POST_LOGOUT (result);
+    g_return_val_if_fail (SNAPD_IS_POST_INTERFACES (result), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return FALSE;
-    return TRUE;
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_set_auth_data:
+ * snapd_client_disconnect_interface_async:
  * @client: a #SnapdClient.
- * @auth_data: (allow-none): a #SnapdAuthData or %NULL.
- *
- * Set the authorization data to use for requests. Authorization data can be
- * obtained by:
- *
- * - Logging into snapd using snapd_client_login_sync()
+ * @plug_snap: name of snap containing plug.
+ * @plug_name: name of plug to disconnect.
+ * @slot_snap: name of snap containing socket.
+ * @slot_name: name of slot to disconnect.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
  *
- * - Using an existing authorization with snapd_auth_data_new().
+ * Asynchronously disconnect two interfaces.
+ * See snapd_client_disconnect_interface_sync() for more information.
  *
  * Since: 1.0
  */
 void
-snapd_client_set_auth_data (SnapdClient *self, SnapdAuthData *auth_data)
+snapd_client_disconnect_interface_async (SnapdClient *self,
+                                         const gchar *plug_snap, const gchar *plug_name,
+                                         const gchar *slot_snap, const gchar *slot_name,
+                                         SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_clear_object (&priv->auth_data);
-    if (auth_data != NULL)
-        priv->auth_data = g_object_ref (auth_data);
+
+    g_autoptr(SnapdPostInterfaces) request = _snapd_post_interfaces_new ("disconnect", plug_snap, plug_name, slot_snap, slot_name, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_auth_data:
+ * snapd_client_disconnect_interface_finish:
  * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Get the authorization data that is used for requests.
+ * Complete request started with snapd_client_disconnect_interface_async().
+ * See snapd_client_disconnect_interface_sync() for more information.
  *
- * Returns: (transfer none) (allow-none): a #SnapdAuthData or %NULL.
+ * Returns: %TRUE on success or %FALSE on error.
  *
  * Since: 1.0
  */
-SnapdAuthData *
-snapd_client_get_auth_data (SnapdClient *self)
+gboolean
+snapd_client_disconnect_interface_finish (SnapdClient *self,
+                                          GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_INTERFACES (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/* State of a request to connect or disconnect many plugs and slots */
+typedef struct
+{
+    SnapdClient *client;
+    gchar *action;
+    GPtrArray *plugs;
+    GPtrArray *slots;
+    GPtrArray *changes;
+    gboolean *started;
+    guint n_started;
+    guint n_running;
+    guint max_parallel;
+    GHashTable *busy_snaps;
+    SnapdProgressCallback progress_callback;
+    gpointer progress_callback_data;
+    GError *error;
+} PostInterfacesManyData;
+
+static void
+post_interfaces_many_data_free (PostInterfacesManyData *data)
+{
+    g_object_unref (data->client);
+    g_free (data->action);
+    g_ptr_array_unref (data->plugs);
+    g_ptr_array_unref (data->slots);
+    g_ptr_array_unref (data->changes);
+    g_free (data->started);
+    g_hash_table_unref (data->busy_snaps);
+    g_clear_error (&data->error);
+    g_slice_free (PostInterfacesManyData, data);
+}
+
+/* A single plug and slot pair being connected or disconnected for a #PostInterfacesManyData */
+typedef struct
+{
+    GTask *task;
+    guint index;
+} PostInterfacesManyItem;
+
+static const gchar *
+slot_ref_get_snap (SnapdSlotRef *slot)
+{
+    const gchar *snap = snapd_slot_ref_get_snap (slot);
+    return snap != NULL ? snap : "";
+}
+
+static void post_interfaces_many_start (GTask *task);
+
+/* Report the combined tasks of every change seen so far as a single change */
+static void
+post_interfaces_many_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    PostInterfacesManyItem *item = user_data;
+    PostInterfacesManyData *data = g_task_get_task_data (item->task);
+
+    g_clear_object (&data->changes->pdata[item->index]);
+    data->changes->pdata[item->index] = g_object_ref (change);
+    if (data->progress_callback == NULL)
+        return;
+
+    g_autoptr(GPtrArray) tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    SnapdChange *first_change = NULL;
+    for (guint i = 0; i < data->changes->len; i++) {
+        SnapdChange *c = data->changes->pdata[i];
+        if (c == NULL)
+            continue;
+
+        GPtrArray *change_tasks = snapd_change_get_tasks (c);
+        for (guint j = 0; change_tasks != NULL && j < change_tasks->len; j++)
+            g_ptr_array_add (tasks, g_object_ref (change_tasks->pdata[j]));
+        const SnapdTimestamp *t = _snapd_change_get_spawn_timestamp (c);
+        if (t->is_set && (first_change == NULL || t->time < _snapd_change_get_spawn_timestamp (first_change)->time))
+            first_change = c;
+    }
+    GDateTime *spawn_time = first_change != NULL ? snapd_change_get_spawn_time (first_change) : NULL;
+
+    g_autofree gchar *summary = NULL;
+    if (strcmp (data->action, "connect") == 0)
+        summary = g_strdup_printf ("Connect %u interfaces", data->plugs->len);
+    else
+        summary = g_strdup_printf ("Disconnect %u interfaces", data->plugs->len);
+    g_autoptr(SnapdChange) combined = g_object_new (SNAPD_TYPE_CHANGE,
+                                                    "kind", data->action,
+                                                    "summary", summary,
+                                                    "status", "Doing",
+                                                    "tasks", tasks,
+                                                    "ready", FALSE,
+                                                    "spawn-time", spawn_time,
+                                                    NULL);
+    data->progress_callback (data->client, combined, NULL, data->progress_callback_data);
+}
+
+static void
+post_interfaces_many_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    PostInterfacesManyItem *item = user_data;
+    g_autoptr(GTask) task = item->task;
+    guint index = item->index;
+    g_slice_free (PostInterfacesManyItem, item);
+    PostInterfacesManyData *data = g_task_get_task_data (task);
+
+    g_autoptr(GError) error = NULL;
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (result), &error) && data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    g_hash_table_remove (data->busy_snaps, snapd_plug_ref_get_snap (data->plugs->pdata[index]));
+    g_hash_table_remove (data->busy_snaps, slot_ref_get_snap (data->slots->pdata[index]));
+    data->n_running--;
+    post_interfaces_many_start (task);
+}
+
+/* Send requests for pairs that don't involve snaps with a change in progress,
+ * as snapd refuses to start a change for a snap that already has one */
+static void
+post_interfaces_many_start (GTask *task)
+{
+    PostInterfacesManyData *data = g_task_get_task_data (task);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    for (guint i = 0; i < data->plugs->len && data->n_running < data->max_parallel && !g_cancellable_is_cancelled (cancellable); i++) {
+        if (data->started[i])
+            continue;
+
+        SnapdPlugRef *plug = data->plugs->pdata[i];
+        SnapdSlotRef *slot = data->slots->pdata[i];
+        const gchar *plug_snap = snapd_plug_ref_get_snap (plug);
+        const gchar *slot_snap = slot_ref_get_snap (slot);
+        if (g_hash_table_contains (data->busy_snaps, plug_snap) || g_hash_table_contains (data->busy_snaps, slot_snap))
+            continue;
+
+        g_hash_table_add (data->busy_snaps, (gpointer) plug_snap);
+        g_hash_table_add (data->busy_snaps, (gpointer) slot_snap);
+        data->started[i] = TRUE;
+        data->n_started++;
+        data->n_running++;
+
+        PostInterfacesManyItem *item = g_slice_new (PostInterfacesManyItem);
+        item->task = g_object_ref (task);
+        item->index = i;
+        g_autoptr(SnapdPostInterfaces) request = _snapd_post_interfaces_new (data->action,
+                                                                             plug_snap, snapd_plug_ref_get_plug (plug),
+                                                                             snapd_slot_ref_get_snap (slot), snapd_slot_ref_get_slot (slot),
+                                                                             post_interfaces_many_progress_cb, item,
+                                                                             cancellable, post_interfaces_many_cb, item);
+        send_request (data->client, SNAPD_REQUEST (request));
+    }
+
+    if (data->n_running > 0)
+        return;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+        g_task_return_error (task, g_steal_pointer (&error));
+    else if (data->error != NULL)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_boolean (task, TRUE);
+}
+
+static void
+post_interfaces_many (SnapdClient *self, const gchar *action,
+                      GPtrArray *plugs, GPtrArray *slots,
+                      SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    return priv->auth_data;
+
+    PostInterfacesManyData *data = g_slice_new0 (PostInterfacesManyData);
+    data->client = g_object_ref (self);
+    data->action = g_strdup (action);
+    data->plugs = g_ptr_array_ref (plugs);
+    data->slots = g_ptr_array_ref (slots);
+    data->changes = g_ptr_array_new_with_free_func ((GDestroyNotify) g_object_unref);
+    g_ptr_array_set_size (data->changes, plugs->len);
+    data->started = g_new0 (gboolean, plugs->len);
+    data->max_parallel = MAX (priv->max_connections, 1);
+    data->busy_snaps = g_hash_table_new (g_str_hash, g_str_equal);
+    data->progress_callback = progress_callback;
+    data->progress_callback_data = progress_callback_data;
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) post_interfaces_many_data_free);
+    post_interfaces_many_start (task);
 }
 
 /**
- * snapd_client_get_changes_async:
+ * snapd_client_connect_interfaces_async:
  * @client: a #SnapdClient.
- * @filter: changes to filter on.
- * @snap_name: (allow-none): name of snap to filter on or %NULL for changes for any snap.
+ * @plugs: (element-type SnapdPlugRef): plugs to connect.
+ * @slots: (element-type SnapdSlotRef): slots to connect each plug to.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get changes that have occurred / are occurring on the snap daemon.
- * See snapd_client_get_changes_sync() for more information.
+ * Asynchronously connect many plugs and slots.
+ * See snapd_client_connect_interfaces_sync() for more information.
  *
- * Since: 1.29
- */
-void
-snapd_client_get_changes_async (SnapdClient *self,
-                                SnapdChangeFilter filter, const gchar *snap_name,
-                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+ * Since: 1.65
+ */
+void
+snapd_client_connect_interfaces_async (SnapdClient *self,
+                                       GPtrArray *plugs, GPtrArray *slots,
+                                       SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (plugs != NULL && slots != NULL);
+    g_return_if_fail (plugs->len == slots->len);
 
-    const gchar *select = NULL;
-    switch (filter)
-    {
-    case SNAPD_CHANGE_FILTER_ALL:
-        select = "all";
-        break;
-    case SNAPD_CHANGE_FILTER_IN_PROGRESS:
-        select = "in-progress";
-        break;
-    case SNAPD_CHANGE_FILTER_READY:
-        select = "ready";
-        break;
-    }
-
-    g_autoptr(SnapdGetChanges) request = _snapd_get_changes_new (select, snap_name, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    post_interfaces_many (self, "connect", plugs, slots, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_get_changes_finish:
+ * snapd_client_connect_interfaces_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_changes_async().
- * See snapd_client_get_changes_sync() for more information.
+ * Complete request started with snapd_client_connect_interfaces_async().
+ * See snapd_client_connect_interfaces_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdChange): an array of #SnapdChange or %NULL on error.
+ * Returns: %TRUE if all the plugs were connected.
  *
- * Since: 1.29
+ * Since: 1.65
  */
-GPtrArray *
-snapd_client_get_changes_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_connect_interfaces_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_CHANGES (result), NULL);
-
-    SnapdGetChanges *request = SNAPD_GET_CHANGES (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_get_changes_get_changes (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_get_change_async:
+ * snapd_client_disconnect_interfaces_async:
  * @client: a #SnapdClient.
- * @id: a change ID to get information on.
+ * @plugs: (element-type SnapdPlugRef): plugs to disconnect.
+ * @slots: (element-type SnapdSlotRef): slots to disconnect each plug from.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information on a change.
- * See snapd_client_get_change_sync() for more information.
+ * Asynchronously disconnect many plugs and slots.
+ * See snapd_client_disconnect_interfaces_sync() for more information.
  *
- * Since: 1.29
+ * Since: 1.65
  */
 void
-snapd_client_get_change_async (SnapdClient *self,
-                               const gchar *id,
-                               GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_disconnect_interfaces_async (SnapdClient *self,
+                                          GPtrArray *plugs, GPtrArray *slots,
+                                          SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (id != NULL);
+    g_return_if_fail (plugs != NULL && slots != NULL);
+    g_return_if_fail (plugs->len == slots->len);
 
-    g_autoptr(SnapdGetChange) request = _snapd_get_change_new (id, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    post_interfaces_many (self, "disconnect", plugs, slots, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_get_change_finish:
+ * snapd_client_disconnect_interfaces_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_change_async().
- * See snapd_client_get_change_sync() for more information.
+ * Complete request started with snapd_client_disconnect_interfaces_async().
+ * See snapd_client_disconnect_interfaces_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdChange or %NULL on error.
+ * Returns: %TRUE if all the plugs were disconnected.
  *
- * Since: 1.29
+ * Since: 1.65
  */
-SnapdChange *
-snapd_client_get_change_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_disconnect_interfaces_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_CHANGE (result), NULL);
-
-    SnapdGetChange *request = SNAPD_GET_CHANGE (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_object_ref (_snapd_get_change_get_change (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_abort_change_async:
+ * snapd_client_find_async:
  * @client: a #SnapdClient.
- * @id: a change ID to abort.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @query: (allow-none): query string to send or %NULL to return featured snaps.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously abort a change.
- * See snapd_client_abort_change_sync() for more information.
+ * Asynchronously find snaps in the store.
+ * See snapd_client_find_sync() for more information.
  *
- * Since: 1.30
+ * Since: 1.0
  */
 void
-snapd_client_abort_change_async (SnapdClient *self,
-                                 const gchar *id,
-                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_async (SnapdClient *self,
+                         SnapdFindFlags flags, const gchar *query,
+                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (id != NULL);
-
-    g_autoptr(SnapdPostChange) request = _snapd_post_change_new (id, "abort", cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_return_if_fail (query != NULL);
+    snapd_client_find_section_async (self, flags, NULL, query, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_abort_change_finish:
+ * snapd_client_find_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_abort_change_async().
- * See snapd_client_abort_change_sync() for more information.
+ * Complete request started with snapd_client_find_async().
+ * See snapd_client_find_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdChange or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.30
+ * Since: 1.0
  */
-SnapdChange *
-snapd_client_abort_change_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_find_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_POST_CHANGE (result), NULL);
+    return snapd_client_find_section_finish (self, result, suggested_currency, error);
+}
 
-    SnapdPostChange *request = SNAPD_POST_CHANGE (result);
+static SnapdGetFind *
+make_find_request (SnapdFindFlags flags, const gchar *section, const gchar *query,
+                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdGetFind *request = _snapd_get_find_new (cancellable, callback, user_data);
+    if ((flags & SNAPD_FIND_FLAGS_MATCH_NAME) != 0)
+        _snapd_get_find_set_name (request, query);
+    else if ((flags & SNAPD_FIND_FLAGS_MATCH_COMMON_ID) != 0)
+        _snapd_get_find_set_common_id (request, query);
+    else
+        _snapd_get_find_set_query (request, query);
+    if ((flags & SNAPD_FIND_FLAGS_SELECT_PRIVATE) != 0)
+        _snapd_get_find_set_select (request, "private");
+    else if ((flags & SNAPD_FIND_FLAGS_SELECT_REFRESH) != 0)
+        _snapd_get_find_set_select (request, "refresh");
+    else if ((flags & SNAPD_FIND_FLAGS_SCOPE_WIDE) != 0)
+        _snapd_get_find_set_scope (request, "wide");
+    _snapd_get_find_set_section (request, section);
+    _snapd_get_find_set_parse_descriptions (request, (flags & SNAPD_FIND_FLAGS_PARSE_DESCRIPTIONS) != 0);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_object_ref (_snapd_post_change_get_change (request));
+    return request;
 }
 
 /**
- * snapd_client_get_system_information_async:
+ * snapd_client_find_section_async:
  * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Request system information asynchronously from snapd.
- * See snapd_client_get_system_information_sync() for more information.
+ * Asynchronously find snaps in the store.
+ * See snapd_client_find_section_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.7
  */
 void
-snapd_client_get_system_information_async (SnapdClient *self,
-                                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_section_async (SnapdClient *self,
+                                 SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdGetSystemInfo) request = _snapd_get_system_info_new (cancellable, callback, user_data);
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_system_information_finish:
+ * snapd_client_find_section_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_system_information_async().
- * See snapd_client_get_system_information_sync() for more information.
+ * Complete request started with snapd_client_find_async().
+ * See snapd_client_find_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdSystemInformation or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.0
+ * Since: 1.7
  */
-SnapdSystemInformation *
-snapd_client_get_system_information_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_find_section_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_SYSTEM_INFO (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), NULL);
 
-    SnapdGetSystemInfo *request = SNAPD_GET_SYSTEM_INFO (result);
+    SnapdGetFind *request = SNAPD_GET_FIND (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
         return NULL;
-    return g_object_ref (_snapd_get_system_info_get_system_information (request));
+
+    if (suggested_currency != NULL)
+        *suggested_currency = g_strdup (_snapd_get_find_get_suggested_currency (request));
+    return g_ptr_array_ref (_snapd_get_find_get_snaps (request));
 }
 
 /**
- * snapd_client_list_one_async:
+ * snapd_client_find_model_finish:
  * @client: a #SnapdClient.
- * @name: name of snap to get.
+ * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_find_async() or
+ * snapd_client_find_section_async(), returning the snaps as a list model.
+ * See snapd_client_find_section_model_sync() for more information.
+ *
+ * Returns: (transfer full): a #SnapdResultList of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_client_find_model_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
+{
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_finish (self, result, suggested_currency, error);
+    if (snaps == NULL)
+        return NULL;
+    return snapd_result_list_new (SNAPD_TYPE_SNAP, snaps);
+}
+
+/**
+ * snapd_client_find_with_fields_async:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @fields: a set of #SnapdSnapFields to set in the returned snaps.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information of a single installed snap.
- * See snapd_client_list_one_sync() for more information.
+ * Asynchronously find snaps in the store, only setting the snap fields in @fields.
+ * See snapd_client_find_with_fields_sync() for more information.
  *
- * Since: 1.0
- * Deprecated: 1.42: Use snapd_client_get_snap_async()
+ * Since: 1.65
  */
 void
-snapd_client_list_one_async (SnapdClient *self,
-                             const gchar *name,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_with_fields_async (SnapdClient *self,
+                                     SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                     SnapdSnapFields fields,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    return snapd_client_get_snap_async (self, name, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, cancellable, callback, user_data);
+    _snapd_get_find_set_fields (request, fields);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_list_one_finish:
+ * snapd_client_find_with_fields_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_list_one_async().
- * See snapd_client_list_one_sync() for more information.
+ * Complete request started with snapd_client_find_with_fields_async().
+ * See snapd_client_find_with_fields_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdSnap or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.0
- * Deprecated: 1.42: Use snapd_client_get_snap_finish()
+ * Since: 1.65
  */
-SnapdSnap *
-snapd_client_list_one_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_find_with_fields_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
 {
-    return snapd_client_get_snap_finish (self, result, error);
+    return snapd_client_find_section_finish (self, result, suggested_currency, error);
 }
 
 /**
- * snapd_client_get_snap_async:
+ * snapd_client_find_page_async:
  * @client: a #SnapdClient.
- * @name: name of snap to get.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @offset: index of the first result to return.
+ * @limit: maximum number of results to return, or 0 for all results after @offset.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information of a single installed snap.
- * See snapd_client_get_snap_sync() for more information.
+ * Asynchronously find a page of snaps in the store.
+ * See snapd_client_find_page_sync() for more information.
  *
- * Since: 1.42
+ * Since: 1.65
  */
 void
-snapd_client_get_snap_async (SnapdClient *self,
-                             const gchar *name,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_page_async (SnapdClient *self,
+                              SnapdFindFlags flags, const gchar *section, const gchar *query,
+                              guint offset, guint limit,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdGetSnap) request = _snapd_get_snap_new (name, cancellable, callback, user_data);
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, cancellable, callback, user_data);
+    _snapd_get_find_set_range (request, offset, limit);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_snap_finish:
+ * snapd_client_find_page_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @total: (out) (allow-none): location to store the total number of results.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_snap_async().
- * See snapd_client_get_snap_sync() for more information.
+ * Complete request started with snapd_client_find_page_async().
+ * See snapd_client_find_page_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdSnap or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.42
+ * Since: 1.65
  */
-SnapdSnap *
-snapd_client_get_snap_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_find_page_finish (SnapdClient *self, GAsyncResult *result, guint *total, gchar **suggested_currency, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_SNAP (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), NULL);
 
-    SnapdGetSnap *request = SNAPD_GET_SNAP (result);
+    SnapdGetFind *request = SNAPD_GET_FIND (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
         return NULL;
-    return g_object_ref (_snapd_get_snap_get_snap (request));
+
+    GPtrArray *snaps = g_ptr_array_ref (_snapd_get_find_get_snaps (request));
+    if (total != NULL)
+        *total = _snapd_get_find_get_total (request);
+    if (suggested_currency != NULL)
+        *suggested_currency = g_strdup (_snapd_get_find_get_suggested_currency (request));
+    return snaps;
 }
 
 /**
- * snapd_client_get_snap_conf_async:
+ * snapd_client_find_superseding_async:
  * @client: a #SnapdClient.
- * @name: name of snap to get configuration from.
- * @keys: (allow-none): keys to returns or %NULL to return all.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @supersede_key: key shared by requests that replace each other, e.g. the name of a search box.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get configuration for a snap.
- * See snapd_client_get_snap_conf_sync() for more information.
+ * Asynchronously find snaps in the store, replacing any earlier request with
+ * the same @supersede_key that has not completed. A replaced request that is
+ * still waiting to be sent is never sent, and the response to one already sent
+ * is discarded without being parsed. The callback for a replaced request is
+ * called with %G_IO_ERROR_CANCELLED.
  *
- * Since: 1.48
+ * This is intended for searches that are updated as the user types.
+ *
+ * Since: 1.65
  */
 void
-snapd_client_get_snap_conf_async (SnapdClient *self,
-                                  const gchar *name,
-                                  GStrv keys,
-                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_superseding_async (SnapdClient *self,
+                                     SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                     const gchar *supersede_key,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
+    g_return_if_fail (supersede_key != NULL);
 
-    g_autoptr(SnapdGetSnapConf) request = _snapd_get_snap_conf_new (name, keys, cancellable, callback, user_data);
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, cancellable, callback, user_data);
+    _snapd_request_set_supersede_key (SNAPD_REQUEST (request), supersede_key);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_snap_conf_finish:
+ * snapd_client_find_superseding_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_snap_conf_async().
- * See snapd_client_get_snap_conf_sync() for more information.
+ * Complete request started with snapd_client_find_superseding_async().
  *
- * Returns: (transfer container) (element-type utf8 GVariant): a table of configuration values or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.48
+ * Since: 1.65
  */
-GHashTable *
-snapd_client_get_snap_conf_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_find_superseding_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
+{
+    return snapd_client_find_section_finish (self, result, suggested_currency, error);
+}
+
+/**
+ * snapd_client_find_cached:
+ * @client: a #SnapdClient.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get the results of the last matching find recorded in the cache set with
+ * snapd_client_set_catalog_cache(), without contacting snapd. This allows
+ * results to be shown immediately while a new find is made. The error
+ * %SNAPD_ERROR_NOT_FOUND is returned if no matching find has been recorded.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_client_find_cached (SnapdClient *self,
+                          SnapdFindFlags flags, const gchar *section, const gchar *query,
+                          gchar **suggested_currency, GError **error)
 {
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_SNAP_CONF (result), NULL);
 
-    SnapdGetSnapConf *request = SNAPD_GET_SNAP_CONF (result);
+    if (priv->catalog_cache == NULL) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND, "No catalog cache set");
+        return NULL;
+    }
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, NULL, NULL, NULL);
+    _snapd_request_set_lazy_parsing (SNAPD_REQUEST (request), priv->lazy_parsing);
+    _snapd_request_set_share_snaps (SNAPD_REQUEST (request), priv->share_snaps);
+    _snapd_request_set_memory_counter (SNAPD_REQUEST (request), priv->track_memory ? priv->memory_counter : NULL);
+    if (!_snapd_request_parse_cached_response (SNAPD_REQUEST (request), priv->catalog_cache, error))
         return NULL;
-    return g_hash_table_ref (_snapd_get_snap_conf_get_conf (request));
+
+    if (suggested_currency != NULL)
+        *suggested_currency = g_strdup (_snapd_get_find_get_suggested_currency (request));
+    return g_ptr_array_ref (_snapd_get_find_get_snaps (request));
 }
 
 /**
- * snapd_client_set_snap_conf_async:
+ * snapd_client_find_stream_async:
  * @client: a #SnapdClient.
- * @name: name of snap to set configuration for.
- * @key_values: (element-type utf8 GVariant): Keys to set.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @section: (allow-none): store section to search in or %NULL to search in all sections.
+ * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @snap_callback: (scope call): function to call with each snap as it is parsed.
+ * @snap_callback_data: (closure): user data to pass to @snap_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously set configuration for a snap.
- * See snapd_client_set_snap_conf_sync() for more information.
+ * Asynchronously find snaps in the store.
+ * See snapd_client_find_stream_sync() for more information.
  *
- * Since: 1.48
+ * Since: 1.65
  */
 void
-snapd_client_set_snap_conf_async (SnapdClient *self,
-                                  const gchar *name,
-                                  GHashTable *key_values,
-                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_stream_async (SnapdClient *self,
+                                SnapdFindFlags flags, const gchar *section, const gchar *query,
+                                SnapdSnapCallback snap_callback, gpointer snap_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
-    g_return_if_fail (key_values != NULL);
+    g_return_if_fail (snap_callback != NULL);
 
-    g_autoptr(SnapdPutSnapConf) request = _snapd_put_snap_conf_new (name, key_values, cancellable, callback, user_data);
+    g_autoptr(SnapdGetFind) request = make_find_request (flags, section, query, cancellable, callback, user_data);
+    _snapd_request_set_item_callback (SNAPD_REQUEST (request), G_CALLBACK (snap_callback), snap_callback_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_set_snap_conf_finish:
+ * snapd_client_find_stream_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_set_snap_conf_async().
- * See snapd_client_set_snap_conf_sync() for more information.
+ * Complete request started with snapd_client_find_stream_async().
+ * See snapd_client_find_stream_sync() for more information.
  *
- * Returns: %TRUE if configuration successfully applied.
+ * Returns: %TRUE on success.
  *
- * Since: 1.48
+ * Since: 1.65
  */
 gboolean
-snapd_client_set_snap_conf_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_find_stream_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_PUT_SNAP_CONF (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), FALSE);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    SnapdGetFind *request = SNAPD_GET_FIND (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return FALSE;
+
+    if (suggested_currency != NULL)
+        *suggested_currency = g_strdup (_snapd_get_find_get_suggested_currency (request));
+    return TRUE;
+}
+
+/* State of a request to resolve many IDs to store snaps */
+typedef struct
+{
+    SnapdClient *client;
+    SnapdFindFlags flags;
+    GPtrArray *ids;
+    guint next_id;
+    guint n_running;
+    guint max_parallel;
+    GHashTable *snaps;
+    GError *error;
+} ResolveSnapsData;
+
+static void
+resolve_snaps_data_free (ResolveSnapsData *data)
+{
+    g_object_unref (data->client);
+    g_ptr_array_unref (data->ids);
+    g_hash_table_unref (data->snaps);
+    g_clear_error (&data->error);
+    g_slice_free (ResolveSnapsData, data);
+}
+
+/* A single ID being looked up for a #ResolveSnapsData */
+typedef struct
+{
+    GTask *task;
+    gchar *id;
+} ResolveSnapsItem;
+
+static void
+resolve_snaps_item_free (ResolveSnapsItem *item)
+{
+    g_object_unref (item->task);
+    g_free (item->id);
+    g_slice_free (ResolveSnapsItem, item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (ResolveSnapsItem, resolve_snaps_item_free)
+
+/* Other flags change what the store returns, so they are part of the key */
+static gchar *
+get_resolve_cache_key (SnapdFindFlags flags, const gchar *id)
+{
+    return g_strdup_printf ("%x:%s", flags, id);
+}
+
+static void resolve_snaps_start (GTask *task);
+
+static void
+resolve_snaps_find_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(ResolveSnapsItem) item = user_data;
+    ResolveSnapsData *data = g_task_get_task_data (item->task);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (data->client);
+
+    /* Names that don't exist are reported as errors, common-ids that don't match return no snaps */
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (data->client, result, NULL, &error);
+    gboolean found = snaps != NULL || g_error_matches (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    SnapdSnap *snap = snaps != NULL && snaps->len > 0 ? g_ptr_array_index (snaps, 0) : NULL;
+    if (!found) {
+        if (data->error == NULL)
+            data->error = g_steal_pointer (&error);
+    }
+    else {
+        if (snap != NULL)
+            g_hash_table_insert (data->snaps, g_strdup (item->id), g_object_ref (snap));
+
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->resolve_mutex);
+        if (priv->resolve_cache_ttl > 0) {
+            ResolveCacheEntry *entry = g_slice_new (ResolveCacheEntry);
+            entry->snap = snap != NULL ? g_object_ref (snap) : NULL;
+            entry->expiry_time = g_get_monotonic_time () + (gint64) priv->resolve_cache_ttl * 1000;
+            g_autofree gchar *key = get_resolve_cache_key (data->flags, item->id);
+            g_hash_table_insert (priv->resolve_cache, g_strdup (key), entry);
+            _snapd_cache_manager_insert (priv->cache_manager, priv->resolve_cache_id, key,
+                                         sizeof (ResolveCacheEntry) + strlen (key) + 1 + (snap != NULL ? snapd_snap_get_memory_size (snap) : 0));
+            drop_evicted (priv->cache_manager, priv->resolve_cache_id, priv->resolve_cache);
+        }
+    }
+
+    data->n_running--;
+    resolve_snaps_start (item->task);
+}
+
+/* Look up IDs until the limit is reached, completing once all have been found.
+ * Stops starting lookups after an error, since the result won't be complete */
+static void
+resolve_snaps_start (GTask *task)
+{
+    ResolveSnapsData *data = g_task_get_task_data (task);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    while (data->next_id < data->ids->len && data->n_running < data->max_parallel &&
+           data->error == NULL && !g_cancellable_is_cancelled (cancellable)) {
+        const gchar *id = g_ptr_array_index (data->ids, data->next_id);
+        data->next_id++;
+        data->n_running++;
+
+        ResolveSnapsItem *item = g_slice_new (ResolveSnapsItem);
+        item->task = g_object_ref (task);
+        item->id = g_strdup (id);
+        snapd_client_find_async (data->client, data->flags, id, cancellable, resolve_snaps_find_cb, item);
+    }
+
+    if (data->n_running > 0)
+        return;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+        g_task_return_error (task, g_steal_pointer (&error));
+    else if (data->error != NULL)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_pointer (task, g_hash_table_ref (data->snaps), (GDestroyNotify) g_hash_table_unref);
 }
 
 /**
- * snapd_client_get_apps_async:
+ * snapd_client_resolve_snaps_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
+ * @flags: a set of #SnapdFindFlags, which must include either %SNAPD_FIND_FLAGS_MATCH_NAME or %SNAPD_FIND_FLAGS_MATCH_COMMON_ID.
+ * @ids: (array zero-terminated=1): snap names or common IDs to look up.
+ * @max_parallel: maximum number of lookups to make at once, or 0 for one per connection.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information on installed apps.
- * See snapd_client_get_apps_sync() for more information.
+ * Asynchronously find the store snaps for many names or common IDs.
+ * See snapd_client_resolve_snaps_sync() for more information.
  *
- * Since: 1.25
- * Deprecated: 1.45: Use snapd_client_get_apps2_async()
+ * Since: 1.65
  */
 void
-snapd_client_get_apps_async (SnapdClient *self,
-                             SnapdGetAppsFlags flags,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_resolve_snaps_async (SnapdClient *self,
+                                  SnapdFindFlags flags, GStrv ids, guint max_parallel,
+                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    return snapd_client_get_apps2_async (self, flags, NULL, cancellable, callback, user_data);
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (((flags & SNAPD_FIND_FLAGS_MATCH_NAME) != 0) != ((flags & SNAPD_FIND_FLAGS_MATCH_COMMON_ID) != 0));
+    g_return_if_fail (ids != NULL);
+
+    ResolveSnapsData *data = g_slice_new0 (ResolveSnapsData);
+    data->client = g_object_ref (self);
+    data->flags = flags;
+    data->ids = g_ptr_array_new_with_free_func (g_free);
+    data->max_parallel = max_parallel > 0 ? max_parallel : MAX (priv->max_connections, 1);
+    data->snaps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) resolve_snaps_data_free);
+
+    /* Only look up each ID once, and not at all if found recently */
+    g_autoptr(GHashTable) seen = g_hash_table_new (g_str_hash, g_str_equal);
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->resolve_mutex);
+        gint64 now = g_get_monotonic_time ();
+        drop_evicted (priv->cache_manager, priv->resolve_cache_id, priv->resolve_cache);
+        for (int i = 0; ids[i] != NULL; i++) {
+            if (!g_hash_table_add (seen, ids[i]))
+                continue;
+
+            g_autofree gchar *key = get_resolve_cache_key (flags, ids[i]);
+            ResolveCacheEntry *entry = g_hash_table_lookup (priv->resolve_cache, key);
+            if (entry != NULL && now < entry->expiry_time) {
+                if (entry->snap != NULL)
+                    g_hash_table_insert (data->snaps, g_strdup (ids[i]), g_object_ref (entry->snap));
+                _snapd_cache_manager_hit (priv->cache_manager, priv->resolve_cache_id, key);
+                continue;
+            }
+            if (entry != NULL) {
+                g_hash_table_remove (priv->resolve_cache, key);
+                _snapd_cache_manager_remove (priv->cache_manager, priv->resolve_cache_id, key);
+            }
+            _snapd_cache_manager_miss (priv->cache_manager, priv->resolve_cache_id);
+
+            g_ptr_array_add (data->ids, g_strdup (ids[i]));
+        }
+    }
+
+    resolve_snaps_start (task);
 }
 
 /**
- * snapd_client_get_apps_finish:
+ * snapd_client_resolve_snaps_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_apps_async().
- * See snapd_client_get_apps_sync() for more information.
+ * Complete request started with snapd_client_resolve_snaps_async().
+ * See snapd_client_resolve_snaps_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp or %NULL on error.
+ * Returns: (transfer container) (element-type utf8 SnapdSnap): a table of #SnapdSnap keyed by ID or %NULL on error.
  *
- * Since: 1.25
- * Deprecated: 1.45: Use snapd_client_get_apps2_finish()
+ * Since: 1.65
  */
-GPtrArray *
-snapd_client_get_apps_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GHashTable *
+snapd_client_resolve_snaps_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_get_apps2_finish (self, result, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+    return g_task_propagate_pointer (G_TASK (result), error);
 }
 
 /**
- * snapd_client_get_apps2_async:
+ * snapd_client_find_refreshable_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
- * @snaps: (allow-none): A list of snap names to return results for. If %NULL or empty then apps for all installed snaps are returned.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information on installed apps.
- * See snapd_client_get_apps2_sync() for more information.
+ * Asynchronously find snaps in store that are newer revisions than locally installed versions.
+ * See snapd_client_find_refreshable_sync() for more information.
  *
- * Since: 1.45
+ * Since: 1.8
  */
 void
-snapd_client_get_apps2_async (SnapdClient *self,
-                              SnapdGetAppsFlags flags,
-                              GStrv snaps,
-                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_find_refreshable_async (SnapdClient *self,
+                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdGetApps) request = _snapd_get_apps_new (snaps, cancellable, callback, user_data);
-    if ((flags & SNAPD_GET_APPS_FLAGS_SELECT_SERVICES) != 0)
-        _snapd_get_apps_set_select (request, "service");
+    g_autoptr(SnapdGetFind) request = _snapd_get_find_new (cancellable, callback, user_data);
+    _snapd_get_find_set_select (request, "refresh");
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_apps2_finish:
+ * snapd_client_find_refreshable_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_apps2_async().
- * See snapd_client_get_apps2_sync() for more information.
+ * Complete request started with snapd_client_find_refreshable_async().
+ * See snapd_client_find_refreshable_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdApp): an array of #SnapdApp or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
  *
- * Since: 1.45
+ * Since: 1.5
  */
 GPtrArray *
-snapd_client_get_apps2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_find_refreshable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_APPS (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), NULL);
 
-    SnapdGetApps *request = SNAPD_GET_APPS (result);
+    SnapdGetFind *request = SNAPD_GET_FIND (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
         return NULL;
-    return g_ptr_array_ref (_snapd_get_apps_get_apps (request));
+
+    return g_ptr_array_ref (_snapd_get_find_get_snaps (request));
 }
 
 /**
- * snapd_client_get_icon_async:
+ * snapd_client_install_async:
  * @client: a #SnapdClient.
- * @name: name of snap to get icon for.
+ * @name: name of snap to install.
+ * @channel: (allow-none): channel to install from or %NULL for default.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the icon for an installed snap.
- * See snapd_client_get_icon_sync() for more information.
+ * Asynchronously install a snap from the store.
+ * See snapd_client_install_sync() for more information.
  *
  * Since: 1.0
+ * Deprecated: 1.12: Use snapd_client_install2_async()
  */
 void
-snapd_client_get_icon_async (SnapdClient *self,
-                             const gchar *name,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_install_async (SnapdClient *self,
+                            const gchar *name, const gchar *channel,
+                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-
-    g_autoptr(SnapdGetIcon) request = _snapd_get_icon_new (name, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    snapd_client_install2_async (self, SNAPD_INSTALL_FLAGS_NONE, name, channel, NULL, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_get_icon_finish:
+ * snapd_client_install_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_icon_async().
- * See snapd_client_get_icon_sync() for more information.
+ * Complete request started with snapd_client_install_async().
+ * See snapd_client_install_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdIcon or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
  * Since: 1.0
+ * Deprecated: 1.12: Use snapd_client_install2_finish()
  */
-SnapdIcon *
-snapd_client_get_icon_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_install_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_ICON (result), NULL);
-
-    SnapdGetIcon *request = SNAPD_GET_ICON (result);
-
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_object_ref (_snapd_get_icon_get_icon (request));
+    return snapd_client_install2_finish (self, result, error);
 }
 
 /**
- * snapd_client_list_async:
+ * snapd_client_install2_async:
  * @client: a #SnapdClient.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @name: name of snap to install.
+ * @channel: (allow-none): channel to install from or %NULL for default.
+ * @revision: (allow-none): revision to install or %NULL for default.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information on all installed snaps.
- * See snapd_client_list_sync() for more information.
+ * Asynchronously install a snap from the store.
+ * See snapd_client_install2_sync() for more information.
  *
- * Since: 1.0
- * Deprecated: 1.42: Use snapd_client_get_snaps_async()
+ * Since: 1.12
  */
 void
-snapd_client_list_async (SnapdClient *self,
-                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_install2_async (SnapdClient *self,
+                             SnapdInstallFlags flags,
+                             const gchar *name, const gchar *channel, const gchar *revision,
+                             SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    return snapd_client_get_snaps_async (self, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "install", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    _snapd_post_snap_set_channel (request, channel);
+    _snapd_post_snap_set_revision (request, revision);
+    if ((flags & SNAPD_INSTALL_FLAGS_CLASSIC) != 0)
+        _snapd_post_snap_set_classic (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_DANGEROUS) != 0)
+        _snapd_post_snap_set_dangerous (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_DEVMODE) != 0)
+        _snapd_post_snap_set_devmode (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_JAILMODE) != 0)
+        _snapd_post_snap_set_jailmode (request, TRUE);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_list_finish:
+ * snapd_client_install2_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_list_async().
- * See snapd_client_list_sync() for more information.
+ * Complete request started with snapd_client_install2_async().
+ * See snapd_client_install2_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.0
- * Deprecated: 1.42: Use snapd_client_get_snaps_finish()
+ * Since: 1.12
  */
-GPtrArray *
-snapd_client_list_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_install2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_get_snaps_finish (self, result, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+static void
+post_snaps_many (SnapdClient *self, const gchar *action, GStrv names,
+                 SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_autoptr(SnapdPostSnaps) request = _snapd_post_snaps_new (action, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    _snapd_post_snaps_set_snaps (request, names);
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+static GStrv
+post_snaps_many_finish (SnapdPostSnaps *request, GError **error)
+{
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+
+    return g_strdupv (_snapd_post_snaps_get_snap_names (request));
 }
 
 /**
- * snapd_client_get_snaps_async:
+ * snapd_client_install_many_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetSnapsFlags to control what results are returned.
- * @names: (allow-none): A list of snap names to return results for. If %NULL or empty then all installed snaps are returned.
+ * @names: a %NULL-terminated array of snap names to install.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get information on installed snaps.
- * See snapd_client_get_snaps_sync() for more information.
+ * Asynchronously install multiple snaps in a single change.
+ * See snapd_client_install_many_sync() for more information.
  *
- * Since: 1.42
+ * Since: 1.65
  */
 void
-snapd_client_get_snaps_async (SnapdClient *self,
-                              SnapdGetSnapsFlags flags,
-                              GStrv names,
-                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_install_many_async (SnapdClient *self,
+                                 GStrv names,
+                                 SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL && names[0] != NULL);
 
-    g_autoptr(SnapdGetSnaps) request = _snapd_get_snaps_new (cancellable, names, callback, user_data);
-    if ((flags & SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE) != 0)
-        _snapd_get_snaps_set_select (request, "all");
-    send_request (self, SNAPD_REQUEST (request));
+    post_snaps_many (self, "install", names, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_get_snaps_finish:
+ * snapd_client_install_many_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_snaps_async().
- * See snapd_client_get_snaps_sync() for more information.
+ * Complete request started with snapd_client_install_many_async().
+ * See snapd_client_install_many_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: (transfer full): a %NULL-terminated array of the snap names installed or %NULL on error.
  *
- * Since: 1.42
+ * Since: 1.65
  */
-GPtrArray *
-snapd_client_get_snaps_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GStrv
+snapd_client_install_many_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_SNAPS (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPS (result), NULL);
 
-    SnapdGetSnaps *request = SNAPD_GET_SNAPS (result);
+    return post_snaps_many_finish (SNAPD_POST_SNAPS (result), error);
+}
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_get_snaps_get_snaps (request));
+static SnapdPostSnapStream *
+make_post_snap_stream_request (SnapdInstallFlags flags,
+                               SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                               GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    SnapdPostSnapStream *request = _snapd_post_snap_stream_new (progress_callback, progress_callback_data, cancellable, callback, user_data);
+    if ((flags & SNAPD_INSTALL_FLAGS_CLASSIC) != 0)
+        _snapd_post_snap_stream_set_classic (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_DANGEROUS) != 0)
+        _snapd_post_snap_stream_set_dangerous (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_DEVMODE) != 0)
+        _snapd_post_snap_stream_set_devmode (request, TRUE);
+    if ((flags & SNAPD_INSTALL_FLAGS_JAILMODE) != 0)
+        _snapd_post_snap_stream_set_jailmode (request, TRUE);
+
+    return request;
 }
 
 /**
- * snapd_client_get_assertions_async:
+ * snapd_client_install_stream_async:
  * @client: a #SnapdClient.
- * @type: assertion type to get.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @stream: a #GInputStream containing the snap file contents to install.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get assertions.
- * See snapd_client_get_assertions_sync() for more information.
+ * Asynchronously install a snap.
+ * See snapd_client_install_stream_sync() for more information.
  *
- * Since: 1.8
+ * Since: 1.9
  */
 void
-snapd_client_get_assertions_async (SnapdClient *self,
-                                   const gchar *type,
+snapd_client_install_stream_async (SnapdClient *self,
+                                   SnapdInstallFlags flags,
+                                   GInputStream *stream,
+                                   SnapdProgressCallback progress_callback, gpointer progress_callback_data,
                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (type != NULL);
+    g_return_if_fail (G_IS_INPUT_STREAM (stream));
 
-    g_autoptr(SnapdGetAssertions) request = _snapd_get_assertions_new (type, cancellable, callback, user_data);
+    g_autoptr(SnapdPostSnapStream) request = make_post_snap_stream_request (flags, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    _snapd_post_snap_stream_set_stream (request, stream);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_assertions_finish:
+ * snapd_client_install_stream_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_assertions_async().
- * See snapd_client_get_assertions_sync() for more information.
+ * Complete request started with snapd_client_install_stream_async().
+ * See snapd_client_install_stream_sync() for more information.
  *
- * Returns: (transfer full) (array zero-terminated=1): an array of assertions or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.8
+ * Since: 1.9
  */
-GStrv
-snapd_client_get_assertions_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_install_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_ASSERTIONS (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP_STREAM (result), FALSE);
 
-    SnapdGetAssertions *request = SNAPD_GET_ASSERTIONS (result);
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_strdupv (_snapd_get_assertions_get_assertions (request));
+/* Send a snap from a file descriptor that the request now owns */
+static void
+install_fd (SnapdClient *self, SnapdPostSnapStream *request, int fd)
+{
+    /* Regular files can be copied by the kernel, anything else is read like a stream */
+    struct stat file_info;
+    if (fstat (fd, &file_info) == 0 && S_ISREG (file_info.st_mode))
+        _snapd_post_snap_stream_set_fd (request, fd, file_info.st_size);
+    else {
+        g_autoptr(GInputStream) stream = g_unix_input_stream_new (fd, TRUE);
+        _snapd_post_snap_stream_set_stream (request, stream);
+    }
+    send_request (self, SNAPD_REQUEST (request));
+}
+
+static void
+return_fd_error (SnapdClient *self, SnapdRequest *request, const gchar *message)
+{
+    int errsv = errno;
+    g_autoptr(GError) error = g_error_new (G_IO_ERROR,
+                                           g_io_error_from_errno (errsv),
+                                           "%s: %s",
+                                           message,
+                                           g_strerror (errsv));
+    _snapd_request_set_source_object (request, G_OBJECT (self));
+    _snapd_request_return (request, error);
 }
 
 /**
- * snapd_client_add_assertions_async:
+ * snapd_client_install_fd_async:
  * @client: a #SnapdClient.
- * @assertions: assertions to add.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @fd: a file descriptor to read the snap file contents from.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously add an assertion.
- * See snapd_client_add_assertions_sync() for more information.
+ * Asynchronously install a snap.
+ * See snapd_client_install_fd_sync() for more information.
  *
- * Since: 1.8
+ * Since: 1.65
  */
 void
-snapd_client_add_assertions_async (SnapdClient *self,
-                                   GStrv assertions,
-                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_install_fd_async (SnapdClient *self,
+                               SnapdInstallFlags flags,
+                               int fd,
+                               SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                               GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (assertions != NULL);
+    g_return_if_fail (fd >= 0);
 
-    g_autoptr(SnapdPostAssertions) request = _snapd_post_assertions_new (assertions, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(SnapdPostSnapStream) request = make_post_snap_stream_request (flags, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    int request_fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+    if (request_fd < 0) {
+        return_fd_error (self, SNAPD_REQUEST (request), "Failed to duplicate snap file descriptor");
+        return;
+    }
+    install_fd (self, request, request_fd);
 }
 
 /**
- * snapd_client_add_assertions_finish:
+ * snapd_client_install_fd_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_add_assertions_async().
- * See snapd_client_add_assertions_sync() for more information.
+ * Complete request started with snapd_client_install_fd_async().
+ * See snapd_client_install_fd_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.8
+ * Since: 1.65
  */
 gboolean
-snapd_client_add_assertions_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_install_fd_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_ASSERTIONS (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP_STREAM (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_get_interfaces_async:
+ * snapd_client_install_path_async:
  * @client: a #SnapdClient.
+ * @flags: a set of #SnapdInstallFlags to control install options.
+ * @path: path to the snap file to install.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the installed snap interfaces.
- * See snapd_client_get_interfaces_sync() for more information.
+ * Asynchronously install a snap.
+ * See snapd_client_install_path_sync() for more information.
  *
- * Since: 1.0
- * Deprecated: 1.48: Use snapd_client_get_connections2_async()
+ * Since: 1.65
  */
 void
-snapd_client_get_interfaces_async (SnapdClient *self,
-                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_install_path_async (SnapdClient *self,
+                                 SnapdInstallFlags flags,
+                                 const gchar *path,
+                                 SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (path != NULL);
 
-    g_autoptr(SnapdGetInterfacesLegacy) request = _snapd_get_interfaces_legacy_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(SnapdPostSnapStream) request = make_post_snap_stream_request (flags, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    int fd = open (path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return_fd_error (self, SNAPD_REQUEST (request), "Failed to open snap file");
+        return;
+    }
+    install_fd (self, request, fd);
 }
 
 /**
- * snapd_client_get_interfaces_finish:
+ * snapd_client_install_path_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
- * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_interfaces_async().
- * See snapd_client_get_interfaces_sync() for more information.
+ * Complete request started with snapd_client_install_path_async().
+ * See snapd_client_install_path_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.0
- * Deprecated: 1.48: Use snapd_client_get_connections2_finish()
+ * Since: 1.65
  */
 gboolean
-snapd_client_get_interfaces_finish (SnapdClient *self, GAsyncResult *result,
-                                    GPtrArray **plugs, GPtrArray **slots,
-                                    GError **error)
+snapd_client_install_path_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_GET_INTERFACES_LEGACY (result), FALSE);
-
-    SnapdGetInterfacesLegacy *request = SNAPD_GET_INTERFACES_LEGACY (result);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP_STREAM (result), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return FALSE;
-    if (plugs)
-       *plugs = g_ptr_array_ref (_snapd_get_interfaces_legacy_get_plugs (request));
-    if (slots)
-       *slots = g_ptr_array_ref (_snapd_get_interfaces_legacy_get_slots (request));
-    return TRUE;
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_get_interfaces2_async:
+ * snapd_client_try_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetInterfacesFlags to control what information is returned about the interfaces.
- * @names: (allow-none) (array zero-terminated=1): a null-terminated array of interface names or %NULL.
+ * @path: path to snap directory to try.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the installed snap interfaces.
- * See snapd_client_get_interfaces2_sync() for more information.
+ * Asynchronously try a snap.
+ * See snapd_client_try_sync() for more information.
  *
- * Since: 1.48
+ * Since: 1.9
  */
 void
-snapd_client_get_interfaces2_async (SnapdClient *self,
-                                    SnapdGetInterfacesFlags flags,
-                                    GStrv names,
-                                    GCancellable *cancellable,
-                                    GAsyncReadyCallback callback,
-                                    gpointer user_data)
+snapd_client_try_async (SnapdClient *self,
+                        const gchar *path,
+                        SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (path != NULL);
 
-    g_autoptr(SnapdGetInterfaces) request = _snapd_get_interfaces_new (names, cancellable, callback, user_data);
-    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_DOCS) != 0)
-        _snapd_get_interfaces_set_include_docs (request, TRUE);
-    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_PLUGS) != 0)
-        _snapd_get_interfaces_set_include_plugs (request, TRUE);
-    if ((flags & SNAPD_GET_INTERFACES_FLAGS_INCLUDE_SLOTS) != 0)
-        _snapd_get_interfaces_set_include_slots (request, TRUE);
-    if ((flags & SNAPD_GET_INTERFACES_FLAGS_ONLY_CONNECTED) != 0)
-        _snapd_get_interfaces_set_only_connected (request, TRUE);
+    g_autoptr(SnapdPostSnapTry) request = _snapd_post_snap_try_new (path, progress_callback, progress_callback_data, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_interfaces2_finish:
+ * snapd_client_try_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_interfaces2_async().
- * See snapd_client_get_interfaces2_sync() for more information.
+ * Complete request started with snapd_client_try_async().
+ * See snapd_client_try_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdInterface): an array of #SnapdInterface or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.48
+ * Since: 1.9
  */
-GPtrArray *
-snapd_client_get_interfaces2_finish (SnapdClient *self,
-                                     GAsyncResult *result,
-                                     GError **error)
+gboolean
+snapd_client_try_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_GET_INTERFACES (result), FALSE);
-
-    SnapdGetInterfaces *request = SNAPD_GET_INTERFACES (result);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP_TRY (result), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_get_interfaces_get_interfaces (request));
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_get_connections_async:
+ * snapd_client_refresh_async:
  * @client: a #SnapdClient.
+ * @name: name of snap to refresh.
+ * @channel: (allow-none): channel to refresh from or %NULL for default.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the installed snap connections.
- * See snapd_client_get_connections_sync() for more information.
+ * Asynchronously ensure an installed snap is at the latest version.
+ * See snapd_client_refresh_sync() for more information.
  *
- * Since: 1.48
- * Deprecated: 1.49: Use snapd_client_get_connections2_async()
+ * Since: 1.0
  */
 void
-snapd_client_get_connections_async (SnapdClient *self,
-                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_refresh_async (SnapdClient *self,
+                            const gchar *name, const gchar *channel,
+                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    snapd_client_get_connections2_async (self, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "refresh", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    _snapd_post_snap_set_channel (request, channel);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_connections_finish:
+ * snapd_client_refresh_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @established: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of connections or %NULL.
- * @undesired: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of auto-connected connections that have been manually disconnected or %NULL.
- * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
- * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_connections_async().
- * See snapd_client_get_connections_sync() for more information.
+ * Complete request started with snapd_client_refresh_async().
+ * See snapd_client_refresh_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.48
- * Deprecated: 1.49: Use snapd_client_get_connections2_finish()
+ * Since: 1.0
  */
 gboolean
-snapd_client_get_connections_finish (SnapdClient *self, GAsyncResult *result,
-                                     GPtrArray **established, GPtrArray **undesired,
-                                     GPtrArray **plugs, GPtrArray **slots,
-                                     GError **error)
+snapd_client_refresh_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_get_connections2_finish (self, result, established, undesired, plugs, slots, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_get_connections2_async:
+ * snapd_client_refresh_all_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdGetConnectionsFlags to control what results are returned.
- * @snap: (allow-none): the name of the snap to get connections for or %NULL for all snaps.
- * @interface: (allow-none): the name of the interface to get connections for or %NULL for all interfaces.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the installed snap connections.
- * See snapd_client_get_connections_sync() for more information.
+ * Asynchronously ensure all snaps are updated to their latest versions.
+ * See snapd_client_refresh_all_sync() for more information.
  *
- * Since: 1.49
+ * Since: 1.5
  */
 void
-snapd_client_get_connections2_async (SnapdClient *self,
-                                     SnapdGetConnectionsFlags flags, const gchar *snap, const gchar *interface,
-                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_refresh_all_async (SnapdClient *self,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    const gchar *select = NULL;
-    if ((flags & SNAPD_GET_CONNECTIONS_FLAGS_SELECT_ALL) != 0)
-        select = "all";
-    g_autoptr(SnapdGetConnections) request = _snapd_get_connections_new (snap, interface, select, cancellable, callback, user_data);
+    g_autoptr(SnapdPostSnaps) request = _snapd_post_snaps_new ("refresh", progress_callback, progress_callback_data, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_get_connections2_finish:
+ * snapd_client_refresh_all_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @established: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of connections or %NULL.
- * @undesired: (out) (allow-none) (transfer container) (element-type SnapdConnection): the location to store the array of auto-connected connections that have been manually disconnected or %NULL.
- * @plugs: (out) (allow-none) (transfer container) (element-type SnapdPlug): the location to store the array of #SnapdPlug or %NULL.
- * @slots: (out) (allow-none) (transfer container) (element-type SnapdSlot): the location to store the array of #SnapdSlot or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_connections_async().
- * See snapd_client_get_connections_sync() for more information.
+ * Complete request started with snapd_client_refresh_all_async().
+ * See snapd_client_refresh_all_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer full): a %NULL-terminated array of the snap names refreshed or %NULL on error.
  *
- * Since: 1.49
+ * Since: 1.5
  */
-gboolean
-snapd_client_get_connections2_finish (SnapdClient *self, GAsyncResult *result,
-                                      GPtrArray **established, GPtrArray **undesired,
-                                      GPtrArray **plugs, GPtrArray **slots,
-                                      GError **error)
+GStrv
+snapd_client_refresh_all_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_GET_CONNECTIONS (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPS (result), FALSE);
 
-    SnapdGetConnections *request = SNAPD_GET_CONNECTIONS (result);
+    SnapdPostSnaps *request = SNAPD_POST_SNAPS (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return FALSE;
-    if (established)
-       *established = g_ptr_array_ref (_snapd_get_connections_get_established (request));
-    if (undesired)
-       *undesired = g_ptr_array_ref (_snapd_get_connections_get_undesired (request));
-    if (plugs)
-       *plugs = g_ptr_array_ref (_snapd_get_connections_get_plugs (request));
-    if (slots)
-       *slots = g_ptr_array_ref (_snapd_get_connections_get_slots (request));
-    return TRUE;
+        return NULL;
+
+    return g_strdupv (_snapd_post_snaps_get_snap_names (request));
 }
 
 /**
- * snapd_client_connect_interface_async:
+ * snapd_client_refresh_many_async:
  * @client: a #SnapdClient.
- * @plug_snap: name of snap containing plug.
- * @plug_name: name of plug to connect.
- * @slot_snap: name of snap containing socket.
- * @slot_name: name of slot to connect.
+ * @names: a %NULL-terminated array of snap names to refresh.
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously connect two interfaces together.
- * See snapd_client_connect_interface_sync() for more information.
+ * Asynchronously refresh multiple snaps in a single change.
+ * See snapd_client_refresh_many_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.65
  */
 void
-snapd_client_connect_interface_async (SnapdClient *self,
-                                      const gchar *plug_snap, const gchar *plug_name,
-                                      const gchar *slot_snap, const gchar *slot_name,
-                                      SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_refresh_many_async (SnapdClient *self,
+                                 GStrv names,
+                                 SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL && names[0] != NULL);
 
-    g_autoptr(SnapdPostInterfaces) request = _snapd_post_interfaces_new ("connect", plug_snap, plug_name, slot_snap, slot_name, progress_callback, progress_callback_data, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    post_snaps_many (self, "refresh", names, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_connect_interface_finish:
+ * snapd_client_refresh_many_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_connect_interface_async().
- * See snapd_client_connect_interface_sync() for more information.
+ * Complete request started with snapd_client_refresh_many_async().
+ * See snapd_client_refresh_many_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer full): a %NULL-terminated array of the snap names refreshed or %NULL on error.
  *
- * Since: 1.0
+ * Since: 1.65
  */
-gboolean
-snapd_client_connect_interface_finish (SnapdClient *self,
-                                       GAsyncResult *result, GError **error)
+GStrv
+snapd_client_refresh_many_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_INTERFACES (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPS (result), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    return post_snaps_many_finish (SNAPD_POST_SNAPS (result), error);
 }
 
 /**
- * snapd_client_disconnect_interface_async:
+ * snapd_client_remove_async:
  * @client: a #SnapdClient.
- * @plug_snap: name of snap containing plug.
- * @plug_name: name of plug to disconnect.
- * @slot_snap: name of snap containing socket.
- * @slot_name: name of slot to disconnect.
+ * @name: name of snap to remove.
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously disconnect two interfaces.
- * See snapd_client_disconnect_interface_sync() for more information.
+ * Asynchronously uninstall a snap.
+ * See snapd_client_remove_sync() for more information.
  *
  * Since: 1.0
+ * Deprecated 1.50: Use snapd_client_remove2_async()
  */
 void
-snapd_client_disconnect_interface_async (SnapdClient *self,
-                                         const gchar *plug_snap, const gchar *plug_name,
-                                         const gchar *slot_snap, const gchar *slot_name,
-                                         SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_remove_async (SnapdClient *self,
+                           const gchar *name,
+                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-
-    g_autoptr(SnapdPostInterfaces) request = _snapd_post_interfaces_new ("disconnect", plug_snap, plug_name, slot_snap, slot_name, progress_callback, progress_callback_data, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    snapd_client_remove2_async (self, SNAPD_REMOVE_FLAGS_NONE, name, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_disconnect_interface_finish:
+ * snapd_client_remove_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_disconnect_interface_async().
- * See snapd_client_disconnect_interface_sync() for more information.
+ * Complete request started with snapd_client_remove_async().
+ * See snapd_client_remove_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
  * Since: 1.0
+ * Deprecated 1.50: Use snapd_client_remove2_finish()
  */
 gboolean
-snapd_client_disconnect_interface_finish (SnapdClient *self,
-                                          GAsyncResult *result, GError **error)
+snapd_client_remove_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_INTERFACES (result), FALSE);
-
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    return snapd_client_remove2_finish (self, result, error);
 }
 
 /**
- * snapd_client_find_async:
+ * snapd_client_remove2_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdFindFlags to control how the find is performed.
- * @query: (allow-none): query string to send or %NULL to return featured snaps.
+ * @flags: a set of #SnapdRemoveFlags to control remove options.
+ * @name: name of snap to remove.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously find snaps in the store.
- * See snapd_client_find_sync() for more information.
+ * Asynchronously uninstall a snap.
+ * See snapd_client_remove2_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.50
  */
 void
-snapd_client_find_async (SnapdClient *self,
-                         SnapdFindFlags flags, const gchar *query,
-                         GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_remove2_async (SnapdClient *self,
+                            SnapdRemoveFlags flags,
+                            const gchar *name,
+                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    g_return_if_fail (query != NULL);
-    snapd_client_find_section_async (self, flags, NULL, query, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "remove", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    if ((flags & SNAPD_REMOVE_FLAGS_PURGE) != 0)
+        _snapd_post_snap_set_purge (request, TRUE);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_find_finish:
+ * snapd_client_remove2_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_find_async().
- * See snapd_client_find_sync() for more information.
+ * Complete request started with snapd_client_remove2_async().
+ * See snapd_client_remove2_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.0
+ * Since: 1.50
  */
-GPtrArray *
-snapd_client_find_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
+gboolean
+snapd_client_remove2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_find_section_finish (self, result, suggested_currency, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_find_section_async:
+ * snapd_client_remove_many_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdFindFlags to control how the find is performed.
- * @section: (allow-none): store section to search in or %NULL to search in all sections.
- * @query: (allow-none): query string to send or %NULL to get all snaps from the given section.
+ * @names: a %NULL-terminated array of snap names to remove.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously find snaps in the store.
- * See snapd_client_find_section_sync() for more information.
+ * Asynchronously remove multiple snaps in a single change.
+ * See snapd_client_remove_many_sync() for more information.
  *
- * Since: 1.7
+ * Since: 1.65
  */
 void
-snapd_client_find_section_async (SnapdClient *self,
-                                 SnapdFindFlags flags, const gchar *section, const gchar *query,
-                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_remove_many_async (SnapdClient *self,
+                                GStrv names,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (names != NULL && names[0] != NULL);
 
-    g_autoptr(SnapdGetFind) request = _snapd_get_find_new (cancellable, callback, user_data);
-    if ((flags & SNAPD_FIND_FLAGS_MATCH_NAME) != 0)
-        _snapd_get_find_set_name (request, query);
-    else if ((flags & SNAPD_FIND_FLAGS_MATCH_COMMON_ID) != 0)
-        _snapd_get_find_set_common_id (request, query);
-    else
-        _snapd_get_find_set_query (request, query);
-    if ((flags & SNAPD_FIND_FLAGS_SELECT_PRIVATE) != 0)
-        _snapd_get_find_set_select (request, "private");
-    else if ((flags & SNAPD_FIND_FLAGS_SELECT_REFRESH) != 0)
-        _snapd_get_find_set_select (request, "refresh");
-    else if ((flags & SNAPD_FIND_FLAGS_SCOPE_WIDE) != 0)
-        _snapd_get_find_set_scope (request, "wide");
-    _snapd_get_find_set_section (request, section);
-    send_request (self, SNAPD_REQUEST (request));
+    post_snaps_many (self, "remove", names, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_find_section_finish:
+ * snapd_client_remove_many_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @suggested_currency: (out) (allow-none): location to store the ISO 4217 currency that is suggested to purchase with.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_find_async().
- * See snapd_client_find_sync() for more information.
+ * Complete request started with snapd_client_remove_many_async().
+ * See snapd_client_remove_many_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: (transfer full): a %NULL-terminated array of the snap names removed or %NULL on error.
  *
- * Since: 1.7
+ * Since: 1.65
  */
-GPtrArray *
-snapd_client_find_section_finish (SnapdClient *self, GAsyncResult *result, gchar **suggested_currency, GError **error)
+GStrv
+snapd_client_remove_many_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), NULL);
-
-    SnapdGetFind *request = SNAPD_GET_FIND (result);
-
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPS (result), NULL);
 
-    if (suggested_currency != NULL)
-        *suggested_currency = g_strdup (_snapd_get_find_get_suggested_currency (request));
-    return g_ptr_array_ref (_snapd_get_find_get_snaps (request));
+    return post_snaps_many_finish (SNAPD_POST_SNAPS (result), error);
 }
 
 /**
- * snapd_client_find_refreshable_async:
+ * snapd_client_enable_async:
  * @client: a #SnapdClient.
+ * @name: name of snap to enable.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously find snaps in store that are newer revisions than locally installed versions.
- * See snapd_client_find_refreshable_sync() for more information.
+ * Asynchronously enable an installed snap.
+ * See snapd_client_enable_sync() for more information.
  *
- * Since: 1.8
+ * Since: 1.0
  */
 void
-snapd_client_find_refreshable_async (SnapdClient *self,
-                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_enable_async (SnapdClient *self,
+                           const gchar *name,
+                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
 
-    g_autoptr(SnapdGetFind) request = _snapd_get_find_new (cancellable, callback, user_data);
-    _snapd_get_find_set_select (request, "refresh");
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "enable", progress_callback, progress_callback_data, cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_find_refreshable_finish:
+ * snapd_client_enable_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_find_refreshable_async().
- * See snapd_client_find_refreshable_sync() for more information.
+ * Complete request started with snapd_client_enable_async().
+ * See snapd_client_enable_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.5
+ * Since: 1.0
  */
-GPtrArray *
-snapd_client_find_refreshable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_enable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_FIND (result), NULL);
-
-    SnapdGetFind *request = SNAPD_GET_FIND (result);
-
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
 
-    return g_ptr_array_ref (_snapd_get_find_get_snaps (request));
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_install_async:
+ * snapd_client_disable_async:
  * @client: a #SnapdClient.
- * @name: name of snap to install.
- * @channel: (allow-none): channel to install from or %NULL for default.
+ * @name: name of snap to disable.
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously install a snap from the store.
- * See snapd_client_install_sync() for more information.
+ * Asynchronously disable an installed snap.
+ * See snapd_client_disable_sync() for more information.
  *
  * Since: 1.0
- * Deprecated: 1.12: Use snapd_client_install2_async()
  */
 void
-snapd_client_install_async (SnapdClient *self,
-                            const gchar *name, const gchar *channel,
+snapd_client_disable_async (SnapdClient *self,
+                            const gchar *name,
                             SnapdProgressCallback progress_callback, gpointer progress_callback_data,
                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    snapd_client_install2_async (self, SNAPD_INSTALL_FLAGS_NONE, name, channel, NULL, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "disable", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_install_finish:
+ * snapd_client_disable_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_install_async().
- * See snapd_client_install_sync() for more information.
+ * Complete request started with snapd_client_disable_async().
+ * See snapd_client_disable_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
  * Since: 1.0
- * Deprecated: 1.12: Use snapd_client_install2_finish()
  */
 gboolean
-snapd_client_install_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_disable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_install2_finish (self, result, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_install2_async:
+ * snapd_client_switch_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdInstallFlags to control install options.
- * @name: name of snap to install.
- * @channel: (allow-none): channel to install from or %NULL for default.
- * @revision: (allow-none): revision to install or %NULL for default.
+ * @name: name of snap to switch channel.
+ * @channel: channel to track.
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously install a snap from the store.
- * See snapd_client_install2_sync() for more information.
+ * Asynchronously set the tracking channel on an installed snap.
+ * See snapd_client_switch_sync() for more information.
  *
- * Since: 1.12
+ * Since: 1.26
  */
 void
-snapd_client_install2_async (SnapdClient *self,
-                             SnapdInstallFlags flags,
-                             const gchar *name, const gchar *channel, const gchar *revision,
-                             SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_switch_async (SnapdClient *self,
+                           const gchar *name, const gchar *channel,
+                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
     g_return_if_fail (name != NULL);
 
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "install", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "switch", progress_callback, progress_callback_data, cancellable, callback, user_data);
     _snapd_post_snap_set_channel (request, channel);
-    _snapd_post_snap_set_revision (request, revision);
-    if ((flags & SNAPD_INSTALL_FLAGS_CLASSIC) != 0)
-        _snapd_post_snap_set_classic (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_DANGEROUS) != 0)
-        _snapd_post_snap_set_dangerous (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_DEVMODE) != 0)
-        _snapd_post_snap_set_devmode (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_JAILMODE) != 0)
-        _snapd_post_snap_set_jailmode (request, TRUE);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_install2_finish:
+ * snapd_client_switch_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_install2_async().
- * See snapd_client_install2_sync() for more information.
+ * Complete request started with snapd_client_switch_async().
+ * See snapd_client_switch_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.12
+ * Since: 1.26
  */
 gboolean
-snapd_client_install2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_switch_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
     g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
@@ -2634,1174 +11881,1771 @@ snapd_client_install2_finish (SnapdClient *self, GAsyncResult *result, GError **
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
-typedef struct
-{
-    SnapdClient *client;
-    SnapdPostSnapStream *request;
-    GCancellable *cancellable;
-    GInputStream *stream;
-} InstallStreamData;
-
-static InstallStreamData *
-install_stream_data_new (SnapdClient *client, SnapdPostSnapStream *request, GCancellable *cancellable, GInputStream *stream)
+/**
+ * snapd_client_check_buy_async:
+ * @client: a #SnapdClient.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously check if able to buy snaps.
+ * See snapd_client_check_buy_sync() for more information.
+ *
+ * Since: 1.3
+ */
+void
+snapd_client_check_buy_async (SnapdClient *self,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    InstallStreamData *data = g_slice_new (InstallStreamData);
-    data->client = g_object_ref (client);
-    data->request = g_object_ref (request);
-    data->cancellable = cancellable != NULL ? g_object_ref (cancellable) : NULL;
-    data->stream = g_object_ref (stream);
-
-    return data;
-}
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-static void
-install_stream_data_free (InstallStreamData *data)
-{
-    g_object_unref (data->client);
-    g_object_unref (data->request);
-    if (data->cancellable != NULL)
-        g_object_unref (data->cancellable);
-    g_object_unref (data->stream);
-    g_slice_free (InstallStreamData, data);
+    g_autoptr(SnapdGetBuyReady) request = _snapd_get_buy_ready_new (cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (InstallStreamData, install_stream_data_free)
-
-static void
-stream_read_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+/**
+ * snapd_client_check_buy_finish:
+ * @client: a #SnapdClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_client_check_buy_async().
+ * See snapd_client_check_buy_sync() for more information.
+ *
+ * Returns: %TRUE on success or %FALSE on error.
+ *
+ * Since: 1.3
+ */
+gboolean
+snapd_client_check_buy_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_autoptr(InstallStreamData) data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GBytes) read_data = g_input_stream_read_bytes_finish (data->stream, result, &error);
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (data->request), &error))
-        return;
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_BUY_READY (result), FALSE);
 
-    if (g_bytes_get_size (read_data) == 0)
-        send_request (data->client, SNAPD_REQUEST (data->request));
-    else {
-        _snapd_post_snap_stream_append_data (data->request, g_bytes_get_data (read_data, NULL), g_bytes_get_size (read_data));
-        InstallStreamData *d = g_steal_pointer (&data);
-        g_input_stream_read_bytes_async (d->stream, 65535, G_PRIORITY_DEFAULT, d->cancellable, stream_read_cb, d);
-    }
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_install_stream_async:
+ * snapd_client_buy_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdInstallFlags to control install options.
- * @stream: a #GInputStream containing the snap file contents to install.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @id: id of snap to buy.
+ * @amount: amount of currency to spend, e.g. 0.99.
+ * @currency: the currency to buy with as an ISO 4217 currency code, e.g. "NZD".
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously install a snap.
- * See snapd_client_install_stream_sync() for more information.
+ * Asynchronously buy a snap from the store.
+ * See snapd_client_buy_sync() for more information.
  *
- * Since: 1.9
+ * Since: 1.3
  */
 void
-snapd_client_install_stream_async (SnapdClient *self,
-                                   SnapdInstallFlags flags,
-                                   GInputStream *stream,
-                                   SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
-{
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (G_IS_INPUT_STREAM (stream));
-
-    g_autoptr(SnapdPostSnapStream) request = _snapd_post_snap_stream_new (progress_callback, progress_callback_data, cancellable, callback, user_data);
-    if ((flags & SNAPD_INSTALL_FLAGS_CLASSIC) != 0)
-        _snapd_post_snap_stream_set_classic (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_DANGEROUS) != 0)
-        _snapd_post_snap_stream_set_dangerous (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_DEVMODE) != 0)
-        _snapd_post_snap_stream_set_devmode (request, TRUE);
-    if ((flags & SNAPD_INSTALL_FLAGS_JAILMODE) != 0)
-        _snapd_post_snap_stream_set_jailmode (request, TRUE);
-    g_input_stream_read_bytes_async (stream, 65535, G_PRIORITY_DEFAULT, cancellable, stream_read_cb, install_stream_data_new (self, request, cancellable, stream));
+snapd_client_buy_async (SnapdClient *self,
+                        const gchar *id, gdouble amount, const gchar *currency,
+                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (id != NULL);
+    g_return_if_fail (currency != NULL);
+
+    g_autoptr(SnapdPostBuy) request = _snapd_post_buy_new (id, amount, currency, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_install_stream_finish:
+ * snapd_client_buy_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_install_stream_async().
- * See snapd_client_install_stream_sync() for more information.
+ * Complete request started with snapd_client_buy_async().
+ * See snapd_client_buy_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.9
+ * Since: 1.3
  */
 gboolean
-snapd_client_install_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_buy_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP_STREAM (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_BUY (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_try_async:
+ * snapd_client_create_user_async:
  * @client: a #SnapdClient.
- * @path: path to snap directory to try.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @email: the email of the user to create.
+ * @flags: a set of #SnapdCreateUserFlags to control how the user account is created.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously try a snap.
- * See snapd_client_try_sync() for more information.
+ * Asynchronously create a local user account.
+ * See snapd_client_create_user_sync() for more information.
  *
- * Since: 1.9
+ * Since: 1.3
  */
 void
-snapd_client_try_async (SnapdClient *self,
-                        const gchar *path,
-                        SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_create_user_async (SnapdClient *self,
+                                const gchar *email, SnapdCreateUserFlags flags,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (path != NULL);
+    g_return_if_fail (email != NULL);
 
-    g_autoptr(SnapdPostSnapTry) request = _snapd_post_snap_try_new (path, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_autoptr(SnapdPostCreateUser) request = _snapd_post_create_user_new (email, cancellable, callback, user_data);
+    if ((flags & SNAPD_CREATE_USER_FLAGS_SUDO) != 0)
+        _snapd_post_create_user_set_sudoer (request, TRUE);
+    if ((flags & SNAPD_CREATE_USER_FLAGS_KNOWN) != 0)
+        _snapd_post_create_user_set_known (request, TRUE);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_try_finish:
+ * snapd_client_create_user_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_try_async().
- * See snapd_client_try_sync() for more information.
+ * Complete request started with snapd_client_create_user_async().
+ * See snapd_client_create_user_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer full): a #SnapdUserInformation or %NULL on error.
  *
- * Since: 1.9
+ * Since: 1.3
  */
-gboolean
-snapd_client_try_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+SnapdUserInformation *
+snapd_client_create_user_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP_TRY (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_CREATE_USER (result), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    SnapdPostCreateUser *request = SNAPD_POST_CREATE_USER (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_object_ref (_snapd_post_create_user_get_user_information (request));
 }
 
 /**
- * snapd_client_refresh_async:
+ * snapd_client_create_users_async:
  * @client: a #SnapdClient.
- * @name: name of snap to refresh.
- * @channel: (allow-none): channel to refresh from or %NULL for default.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously ensure an installed snap is at the latest version.
- * See snapd_client_refresh_sync() for more information.
+ * Asynchronously create local user accounts using the system-user assertions that are valid for this device.
+ * See snapd_client_create_users_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.3
  */
 void
-snapd_client_refresh_async (SnapdClient *self,
-                            const gchar *name, const gchar *channel,
-                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_create_users_async (SnapdClient *self,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
 
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "refresh", progress_callback, progress_callback_data, cancellable, callback, user_data);
-    _snapd_post_snap_set_channel (request, channel);
+    g_autoptr(SnapdPostCreateUsers) request = _snapd_post_create_users_new (cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_refresh_finish:
+ * snapd_client_create_users_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_refresh_async().
- * See snapd_client_refresh_sync() for more information.
+ * Complete request started with snapd_client_create_users_async().
+ * See snapd_client_create_users_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer container) (element-type SnapdUserInformation): an array of #SnapdUserInformation or %NULL on error.
  *
- * Since: 1.0
+ * Since: 1.3
  */
-gboolean
-snapd_client_refresh_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_create_users_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_CREATE_USERS (result), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    SnapdPostCreateUsers *request = SNAPD_POST_CREATE_USERS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_post_create_users_get_users_information (request));
 }
 
 /**
- * snapd_client_refresh_all_async:
+ * snapd_client_get_users_async:
  * @client: a #SnapdClient.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously ensure all snaps are updated to their latest versions.
- * See snapd_client_refresh_all_sync() for more information.
+ * Asynchronously get user accounts that are valid for this device.
+ * See snapd_client_get_users_sync() for more information.
  *
- * Since: 1.5
+ * Since: 1.26
  */
 void
-snapd_client_refresh_all_async (SnapdClient *self,
-                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_get_users_async (SnapdClient *self,
+                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdPostSnaps) request = _snapd_post_snaps_new ("refresh", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_autoptr(SnapdGetUsers) request = _snapd_get_users_new (cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_refresh_all_finish:
+ * snapd_client_get_users_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_refresh_all_async().
- * See snapd_client_refresh_all_sync() for more information.
+ * Complete request started with snapd_client_get_users_async().
+ * See snapd_client_get_users_sync() for more information.
  *
- * Returns: (transfer full): a %NULL-terminated array of the snap names refreshed or %NULL on error.
+ * Returns: (transfer container) (element-type SnapdUserInformation): an array of #SnapdUserInformation or %NULL on error.
  *
- * Since: 1.5
+ * Since: 1.26
  */
-GStrv
-snapd_client_refresh_all_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_get_users_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAPS (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_USERS (result), NULL);
 
-    SnapdPostSnaps *request = SNAPD_POST_SNAPS (result);
+    SnapdGetUsers *request = SNAPD_GET_USERS (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
         return NULL;
-
-    return g_strdupv (_snapd_post_snaps_get_snap_names (request));
+    return g_ptr_array_ref (_snapd_get_users_get_users_information (request));
 }
 
 /**
- * snapd_client_remove_async:
+ * snapd_client_get_sections_async:
  * @client: a #SnapdClient.
- * @name: name of snap to remove.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously uninstall a snap.
- * See snapd_client_remove_sync() for more information.
+ * Asynchronously get the store sections.
+ * See snapd_client_get_sections_sync() for more information.
  *
- * Since: 1.0
- * Deprecated 1.50: Use snapd_client_remove2_async()
+ * Since: 1.7
  */
 void
-snapd_client_remove_async (SnapdClient *self,
-                           const gchar *name,
-                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_get_sections_async (SnapdClient *self,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    snapd_client_remove2_async (self, SNAPD_REMOVE_FLAGS_NONE, name, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+
+    g_autoptr(SnapdGetSections) request = _snapd_get_sections_new (cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_remove_finish:
+ * snapd_client_get_sections_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_remove_async().
- * See snapd_client_remove_sync() for more information.
+ * Complete request started with snapd_client_get_sections_async().
+ * See snapd_client_get_sections_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer full) (array zero-terminated=1): an array of section names or %NULL on error.
  *
- * Since: 1.0
- * Deprecated 1.50: Use snapd_client_remove2_finish()
+ * Since: 1.7
  */
-gboolean
-snapd_client_remove_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GStrv
+snapd_client_get_sections_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    return snapd_client_remove2_finish (self, result, error);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_SECTIONS (result), NULL);
+
+    SnapdGetSections *request = SNAPD_GET_SECTIONS (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_strdupv (_snapd_get_sections_get_sections (request));
+}
+
+/**
+ * snapd_client_get_sections_cached:
+ * @client: a #SnapdClient.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Get the store sections last recorded in the cache set with
+ * snapd_client_set_catalog_cache(), without contacting snapd. The error
+ * %SNAPD_ERROR_NOT_FOUND is returned if the sections have not been recorded.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): an array of section names or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_client_get_sections_cached (SnapdClient *self, GError **error)
+{
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+
+    if (priv->catalog_cache == NULL) {
+        g_set_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND, "No catalog cache set");
+        return NULL;
+    }
+
+    g_autoptr(SnapdGetSections) request = _snapd_get_sections_new (NULL, NULL, NULL);
+    if (!_snapd_request_parse_cached_response (SNAPD_REQUEST (request), priv->catalog_cache, error))
+        return NULL;
+    return g_strdupv (_snapd_get_sections_get_sections (request));
+}
+
+/* State of a request to fetch the snaps in many store sections */
+typedef struct
+{
+    SnapdClient *client;
+    SnapdFindFlags flags;
+    GPtrArray *sections;
+    guint next_section;
+    guint n_running;
+    guint max_parallel;
+    GHashTable *snaps;
+    GError *error;
+} PrefetchSectionsData;
+
+static void
+prefetch_sections_data_free (PrefetchSectionsData *data)
+{
+    g_object_unref (data->client);
+    g_ptr_array_unref (data->sections);
+    g_hash_table_unref (data->snaps);
+    g_clear_error (&data->error);
+    g_slice_free (PrefetchSectionsData, data);
+}
+
+/* A single section being fetched for a #PrefetchSectionsData */
+typedef struct
+{
+    GTask *task;
+    gchar *section;
+} PrefetchSectionsItem;
+
+static void
+prefetch_sections_item_free (PrefetchSectionsItem *item)
+{
+    g_object_unref (item->task);
+    g_free (item->section);
+    g_slice_free (PrefetchSectionsItem, item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (PrefetchSectionsItem, prefetch_sections_item_free)
+
+static void prefetch_sections_start (GTask *task);
+
+static void
+prefetch_sections_find_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(PrefetchSectionsItem) item = user_data;
+    PrefetchSectionsData *data = g_task_get_task_data (item->task);
+
+    /* A section that fails is left out, the rest are still useful */
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_finish (data->client, result, NULL, &error);
+    if (snaps != NULL)
+        g_hash_table_insert (data->snaps, g_strdup (item->section), g_steal_pointer (&snaps));
+    else if (data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    data->n_running--;
+    prefetch_sections_start (item->task);
+}
+
+/* Fetch sections until the limit is reached, completing once all have been fetched */
+static void
+prefetch_sections_start (GTask *task)
+{
+    PrefetchSectionsData *data = g_task_get_task_data (task);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    while (data->next_section < data->sections->len && data->n_running < data->max_parallel &&
+           !g_cancellable_is_cancelled (cancellable)) {
+        const gchar *section = g_ptr_array_index (data->sections, data->next_section);
+        data->next_section++;
+        data->n_running++;
+
+        PrefetchSectionsItem *item = g_slice_new (PrefetchSectionsItem);
+        item->task = g_object_ref (task);
+        item->section = g_strdup (section);
+        snapd_client_find_section_async (data->client, data->flags, section, NULL, cancellable, prefetch_sections_find_cb, item);
+    }
+
+    if (data->n_running > 0)
+        return;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+        g_task_return_error (task, g_steal_pointer (&error));
+    else if (data->error != NULL && g_hash_table_size (data->snaps) == 0)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_pointer (task, g_hash_table_ref (data->snaps), (GDestroyNotify) g_hash_table_unref);
 }
 
 /**
- * snapd_client_remove2_async:
+ * snapd_client_prefetch_sections_async:
  * @client: a #SnapdClient.
- * @flags: a set of #SnapdRemoveFlags to control remove options.
- * @name: name of snap to remove.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @flags: a set of #SnapdFindFlags to control how the find is performed.
+ * @sections: (array zero-terminated=1): store sections to fetch, e.g. from snapd_client_get_sections_async().
+ * @max_parallel: maximum number of sections to fetch at once, or 0 for one per connection.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously uninstall a snap.
- * See snapd_client_remove2_sync() for more information.
+ * Asynchronously fetch the snaps in many store sections.
+ * See snapd_client_prefetch_sections_sync() for more information.
  *
- * Since: 1.50
+ * Since: 1.65
  */
 void
-snapd_client_remove2_async (SnapdClient *self,
-                            SnapdRemoveFlags flags,
-                            const gchar *name,
-                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_prefetch_sections_async (SnapdClient *self,
+                                      SnapdFindFlags flags, GStrv sections, guint max_parallel,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
+    g_return_if_fail (sections != NULL);
 
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "remove", progress_callback, progress_callback_data, cancellable, callback, user_data);
-    if ((flags & SNAPD_REMOVE_FLAGS_PURGE) != 0)
-        _snapd_post_snap_set_purge (request, TRUE);
-    send_request (self, SNAPD_REQUEST (request));
+    PrefetchSectionsData *data = g_slice_new0 (PrefetchSectionsData);
+    data->client = g_object_ref (self);
+    data->flags = flags;
+    data->sections = g_ptr_array_new_with_free_func (g_free);
+    data->max_parallel = max_parallel > 0 ? max_parallel : MAX (priv->max_connections, 1);
+    data->snaps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) prefetch_sections_data_free);
+
+    g_autoptr(GHashTable) seen = g_hash_table_new (g_str_hash, g_str_equal);
+    for (int i = 0; sections[i] != NULL; i++) {
+        if (g_hash_table_add (seen, sections[i]))
+            g_ptr_array_add (data->sections, g_strdup (sections[i]));
+    }
+
+    prefetch_sections_start (task);
 }
 
 /**
- * snapd_client_remove2_finish:
+ * snapd_client_prefetch_sections_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_remove2_async().
- * See snapd_client_remove2_sync() for more information.
+ * Complete request started with snapd_client_prefetch_sections_async().
+ * See snapd_client_prefetch_sections_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer container) (element-type utf8 GPtrArray): a table of arrays of #SnapdSnap keyed by section or %NULL on error.
  *
- * Since: 1.50
+ * Since: 1.65
  */
-gboolean
-snapd_client_remove2_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GHashTable *
+snapd_client_prefetch_sections_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    return g_task_propagate_pointer (G_TASK (result), error);
 }
 
 /**
- * snapd_client_enable_async:
+ * snapd_client_get_aliases_async:
  * @client: a #SnapdClient.
- * @name: name of snap to enable.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously enable an installed snap.
- * See snapd_client_enable_sync() for more information.
+ * Asynchronously get the available aliases.
+ * See snapd_client_get_aliases_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.8
  */
 void
-snapd_client_enable_async (SnapdClient *self,
-                           const gchar *name,
-                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_get_aliases_async (SnapdClient *self,
+                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
 
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "enable", progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_autoptr(SnapdGetAliases) request = _snapd_get_aliases_new (cancellable, callback, user_data);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_enable_finish:
+ * snapd_client_get_aliases_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_enable_async().
- * See snapd_client_enable_sync() for more information.
+ * Complete request started with snapd_client_get_aliases_async().
+ * See snapd_client_get_aliases_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: (transfer container) (element-type SnapdAlias): an array of #SnapdAlias or %NULL on error.
  *
- * Since: 1.0
+ * Since: 1.8
  */
-gboolean
-snapd_client_enable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GPtrArray *
+snapd_client_get_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_GET_ALIASES (result), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    SnapdGetAliases *request = SNAPD_GET_ALIASES (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+    return g_ptr_array_ref (_snapd_get_aliases_get_aliases (request));
+}
+
+static void
+send_change_aliases_request (SnapdClient *self,
+                             const gchar *action,
+                             const gchar *snap, const gchar *app, const gchar *alias,
+                             SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_autoptr(SnapdPostAliases) request = _snapd_post_aliases_new (action, snap, app, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_disable_async:
+ * snapd_client_alias_async:
  * @client: a #SnapdClient.
- * @name: name of snap to disable.
+ * @snap: the name of the snap to modify.
+ * @app: an app in the snap to make the alias to.
+ * @alias: the name of the alias (i.e. the command that will run this app).
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously disable an installed snap.
- * See snapd_client_disable_sync() for more information.
+ * Asynchronously create an alias to an app.
+ * See snapd_client_alias_sync() for more information.
  *
- * Since: 1.0
+ * Since: 1.25
  */
 void
-snapd_client_disable_async (SnapdClient *self,
-                            const gchar *name,
-                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_alias_async (SnapdClient *self,
+                          const gchar *snap, const gchar *app, const gchar *alias,
+                          SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
-
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "disable", progress_callback, progress_callback_data, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_return_if_fail (snap != NULL);
+    g_return_if_fail (app != NULL);
+    g_return_if_fail (alias != NULL);
+    send_change_aliases_request (self, "alias", snap, app, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_disable_finish:
+ * snapd_client_alias_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_disable_async().
- * See snapd_client_disable_sync() for more information.
+ * Complete request started with snapd_client_alias_async().
+ * See snapd_client_alias_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.0
+ * Since: 1.25
  */
 gboolean
-snapd_client_disable_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_alias_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_switch_async:
+ * snapd_client_unalias_async:
  * @client: a #SnapdClient.
- * @name: name of snap to switch channel.
- * @channel: channel to track.
+ * @snap: (allow-none): the name of the snap to modify or %NULL.
+ * @alias: (allow-none): the name of the alias to remove or %NULL to remove all aliases for the given snap.
  * @progress_callback: (allow-none) (scope call): function to callback with progress.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously set the tracking channel on an installed snap.
- * See snapd_client_switch_sync() for more information.
+ * Asynchronously remove an alias from an app.
+ * See snapd_client_unalias_sync() for more information.
  *
- * Since: 1.26
+ * Since: 1.25
  */
 void
-snapd_client_switch_async (SnapdClient *self,
-                           const gchar *name, const gchar *channel,
-                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_unalias_async (SnapdClient *self,
+                            const gchar *snap, const gchar *alias,
+                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
-
-    g_autoptr(SnapdPostSnap) request = _snapd_post_snap_new (name, "switch", progress_callback, progress_callback_data, cancellable, callback, user_data);
-    _snapd_post_snap_set_channel (request, channel);
-    send_request (self, SNAPD_REQUEST (request));
+    g_return_if_fail (alias != NULL);
+    send_change_aliases_request (self, "unalias", snap, NULL, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_switch_finish:
+ * snapd_client_unalias_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_switch_async().
- * See snapd_client_switch_sync() for more information.
+ * Complete request started with snapd_client_unalias_async().
+ * See snapd_client_unalias_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.26
+ * Since: 1.25
  */
 gboolean
-snapd_client_switch_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_unalias_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAP (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_check_buy_async:
+ * snapd_client_prefer_async:
  * @client: a #SnapdClient.
+ * @snap: the name of the snap to modify.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously check if able to buy snaps.
- * See snapd_client_check_buy_sync() for more information.
+ * Asynchronously ???.
+ * See snapd_client_prefer_sync() for more information.
  *
- * Since: 1.3
+ * Since: 1.25
  */
 void
-snapd_client_check_buy_async (SnapdClient *self,
-                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_prefer_async (SnapdClient *self,
+                           const gchar *snap,
+                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-
-    g_autoptr(SnapdGetBuyReady) request = _snapd_get_buy_ready_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_return_if_fail (snap != NULL);
+    send_change_aliases_request (self, "prefer", snap, NULL, NULL, progress_callback, progress_callback_data, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_check_buy_finish:
+ * snapd_client_prefer_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_check_buy_async().
- * See snapd_client_check_buy_sync() for more information.
+ * Complete request started with snapd_client_prefer_async().
+ * See snapd_client_prefer_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.3
+ * Since: 1.25
  */
 gboolean
-snapd_client_check_buy_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_prefer_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_GET_BUY_READY (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
-/**
- * snapd_client_buy_async:
- * @client: a #SnapdClient.
- * @id: id of snap to buy.
- * @amount: amount of currency to spend, e.g. 0.99.
- * @currency: the currency to buy with as an ISO 4217 currency code, e.g. "NZD".
- * @cancellable: (allow-none): a #GCancellable or %NULL.
- * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
- * @user_data: (closure): the data to pass to callback function.
- *
- * Asynchronously buy a snap from the store.
- * See snapd_client_buy_sync() for more information.
- *
- * Since: 1.3
- */
-void
-snapd_client_buy_async (SnapdClient *self,
-                        const gchar *id, gdouble amount, const gchar *currency,
-                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+/* Alias changes being made with snapd_client_set_aliases_async() */
+typedef struct
 {
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (id != NULL);
-    g_return_if_fail (currency != NULL);
+    guint n_running;
+    GError *error;
+} SetAliasesData;
 
-    g_autoptr(SnapdPostBuy) request = _snapd_post_buy_new (id, amount, currency, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+static void
+set_aliases_data_free (SetAliasesData *data)
+{
+    g_clear_error (&data->error);
+    g_slice_free (SetAliasesData, data);
 }
 
-/**
- * snapd_client_buy_finish:
- * @client: a #SnapdClient.
- * @result: a #GAsyncResult.
- * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
- *
- * Complete request started with snapd_client_buy_async().
- * See snapd_client_buy_sync() for more information.
- *
- * Returns: %TRUE on success or %FALSE on error.
- *
- * Since: 1.3
- */
-gboolean
-snapd_client_buy_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+static void
+set_aliases_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_BUY (result), FALSE);
+    g_autoptr(GTask) task = user_data;
+    SetAliasesData *data = g_task_get_task_data (task);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    /* Report the first change that failed */
+    g_autoptr(GError) error = NULL;
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (result), &error) && data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    data->n_running--;
+    if (data->n_running > 0)
+        return;
+
+    if (data->error != NULL)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_boolean (task, TRUE);
+}
+
+static const gchar *
+get_alias_action_name (SnapdAliasAction action)
+{
+    switch (action) {
+    case SNAPD_ALIAS_ACTION_ALIAS:
+        return "alias";
+    case SNAPD_ALIAS_ACTION_UNALIAS:
+        return "unalias";
+    case SNAPD_ALIAS_ACTION_PREFER:
+        return "prefer";
+    default:
+        return NULL;
+    }
 }
 
 /**
- * snapd_client_create_user_async:
+ * snapd_client_set_aliases_async:
  * @client: a #SnapdClient.
- * @email: the email of the user to create.
- * @flags: a set of #SnapdCreateUserFlags to control how the user account is created.
+ * @changes: (array length=n_changes): the alias changes to make.
+ * @n_changes: the number of changes in @changes.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously create a local user account.
- * See snapd_client_create_user_sync() for more information.
+ * Asynchronously make many alias changes.
+ * See snapd_client_set_aliases_sync() for more information.
  *
- * Since: 1.3
+ * Since: 1.65
  */
 void
-snapd_client_create_user_async (SnapdClient *self,
-                                const gchar *email, SnapdCreateUserFlags flags,
+snapd_client_set_aliases_async (SnapdClient *self,
+                                const SnapdAliasChange *changes, gsize n_changes,
+                                SnapdProgressCallback progress_callback, gpointer progress_callback_data,
                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (email != NULL);
+    g_return_if_fail (changes != NULL || n_changes == 0);
+    for (gsize i = 0; i < n_changes; i++) {
+        const SnapdAliasChange *change = &changes[i];
+        g_return_if_fail (get_alias_action_name (change->action) != NULL);
+        g_return_if_fail (change->action == SNAPD_ALIAS_ACTION_UNALIAS || change->snap != NULL);
+        g_return_if_fail (change->action != SNAPD_ALIAS_ACTION_ALIAS || change->app != NULL);
+        g_return_if_fail (change->action == SNAPD_ALIAS_ACTION_PREFER || change->alias != NULL);
+    }
 
-    g_autoptr(SnapdPostCreateUser) request = _snapd_post_create_user_new (email, cancellable, callback, user_data);
-    if ((flags & SNAPD_CREATE_USER_FLAGS_SUDO) != 0)
-        _snapd_post_create_user_set_sudoer (request, TRUE);
-    if ((flags & SNAPD_CREATE_USER_FLAGS_KNOWN) != 0)
-        _snapd_post_create_user_set_known (request, TRUE);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    SetAliasesData *data = g_slice_new0 (SetAliasesData);
+    g_task_set_task_data (task, data, (GDestroyNotify) set_aliases_data_free);
+
+    if (n_changes == 0) {
+        g_task_return_boolean (task, TRUE);
+        return;
+    }
+
+    /* snapd only takes one alias per request, so send them all at once and let them share the connection */
+    data->n_running = n_changes;
+    for (gsize i = 0; i < n_changes; i++) {
+        const SnapdAliasChange *change = &changes[i];
+        send_change_aliases_request (self, get_alias_action_name (change->action),
+                                     change->snap,
+                                     change->action == SNAPD_ALIAS_ACTION_ALIAS ? change->app : NULL,
+                                     change->action != SNAPD_ALIAS_ACTION_PREFER ? change->alias : NULL,
+                                     progress_callback, progress_callback_data,
+                                     cancellable, set_aliases_cb, g_object_ref (task));
+    }
 }
 
 /**
- * snapd_client_create_user_finish:
+ * snapd_client_set_aliases_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_create_user_async().
- * See snapd_client_create_user_sync() for more information.
+ * Complete request started with snapd_client_set_aliases_async().
+ * See snapd_client_set_aliases_sync() for more information.
  *
- * Returns: (transfer full): a #SnapdUserInformation or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.3
+ * Since: 1.65
  */
-SnapdUserInformation *
-snapd_client_create_user_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_set_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_POST_CREATE_USER (result), NULL);
-
-    SnapdPostCreateUser *request = SNAPD_POST_CREATE_USER (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_object_ref (_snapd_post_create_user_get_user_information (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_create_users_async:
+ * snapd_client_enable_aliases_async:
  * @client: a #SnapdClient.
+ * @snap: the name of the snap to modify.
+ * @aliases: the aliases to modify.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously create local user accounts using the system-user assertions that are valid for this device.
- * See snapd_client_create_users_sync() for more information.
+ * Asynchronously change the state of aliases.
+ * See snapd_client_enable_aliases_sync() for more information.
  *
- * Since: 1.3
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_alias_async()
  */
 void
-snapd_client_create_users_async (SnapdClient *self,
-                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_enable_aliases_async (SnapdClient *self,
+                                   const gchar *snap, GStrv aliases,
+                                   SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdPostCreateUsers) request = _snapd_post_create_users_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_enable_aliases_async is deprecated");
 }
 
 /**
- * snapd_client_create_users_finish:
+ * snapd_client_enable_aliases_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_create_users_async().
- * See snapd_client_create_users_sync() for more information.
+ * Complete request started with snapd_client_enable_aliases_async().
+ * See snapd_client_enable_aliases_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdUserInformation): an array of #SnapdUserInformation or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.3
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_unalias_finish()
  */
-GPtrArray *
-snapd_client_create_users_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_enable_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_POST_CREATE_USERS (result), NULL);
-
-    SnapdPostCreateUsers *request = SNAPD_POST_CREATE_USERS (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_post_create_users_get_users_information (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_get_users_async:
+ * snapd_client_disable_aliases_async:
  * @client: a #SnapdClient.
+ * @snap: the name of the snap to modify.
+ * @aliases: the aliases to modify.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get user accounts that are valid for this device.
- * See snapd_client_get_users_sync() for more information.
+ * Asynchronously change the state of aliases.
+ * See snapd_client_disable_aliases_sync() for more information.
  *
- * Since: 1.26
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_unalias_async()
  */
 void
-snapd_client_get_users_async (SnapdClient *self,
-                              GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_disable_aliases_async (SnapdClient *self,
+                                    const gchar *snap, GStrv aliases,
+                                    SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdGetUsers) request = _snapd_get_users_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_disable_aliases_async is deprecated");
 }
 
 /**
- * snapd_client_get_users_finish:
+ * snapd_client_disable_aliases_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_users_async().
- * See snapd_client_get_users_sync() for more information.
+ * Complete request started with snapd_client_disable_aliases_async().
+ * See snapd_client_disable_aliases_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdUserInformation): an array of #SnapdUserInformation or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.26
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_unalias_finish()
  */
-GPtrArray *
-snapd_client_get_users_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_disable_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_USERS (result), NULL);
-
-    SnapdGetUsers *request = SNAPD_GET_USERS (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_get_users_get_users_information (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_get_sections_async:
+ * snapd_client_reset_aliases_async:
  * @client: a #SnapdClient.
+ * @snap: the name of the snap to modify.
+ * @aliases: the aliases to modify.
+ * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the store sections.
- * See snapd_client_get_sections_sync() for more information.
+ * Asynchronously change the state of aliases.
+ * See snapd_client_reset_aliases_sync() for more information.
  *
- * Since: 1.7
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_disable_aliases_async()
  */
 void
-snapd_client_get_sections_async (SnapdClient *self,
-                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_reset_aliases_async (SnapdClient *self,
+                                  const gchar *snap, GStrv aliases,
+                                  SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
 
-    g_autoptr(SnapdGetSections) request = _snapd_get_sections_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_reset_aliases_async is deprecated");
 }
 
 /**
- * snapd_client_get_sections_finish:
+ * snapd_client_reset_aliases_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_sections_async().
- * See snapd_client_get_sections_sync() for more information.
+ * Complete request started with snapd_client_reset_aliases_async().
+ * See snapd_client_reset_aliases_sync() for more information.
  *
- * Returns: (transfer full) (array zero-terminated=1): an array of section names or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.7
+ * Since: 1.8
+ * Deprecated: 1.25: Use snapd_client_disable_aliases_finish()
  */
-GStrv
-snapd_client_get_sections_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_reset_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_SECTIONS (result), NULL);
-
-    SnapdGetSections *request = SNAPD_GET_SECTIONS (result);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
 
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_strdupv (_snapd_get_sections_get_sections (request));
+    return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
- * snapd_client_get_aliases_async:
+ * snapd_client_run_snapctl_async:
  * @client: a #SnapdClient.
+ * @context_id: context for this call.
+ * @args: the arguments to pass to snapctl.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously get the available aliases.
- * See snapd_client_get_aliases_sync() for more information.
+ * Asynchronously run a snapctl command.
+ * See snapd_client_run_snapctl_sync() for more information.
  *
  * Since: 1.8
+ * Deprecated: 1.59: Use snapd_client_run_snapctl2_async()
  */
 void
-snapd_client_get_aliases_async (SnapdClient *self,
+snapd_client_run_snapctl_async (SnapdClient *self,
+                                const gchar *context_id, GStrv args,
                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    g_return_if_fail (SNAPD_IS_CLIENT (self));
-
-    g_autoptr(SnapdGetAliases) request = _snapd_get_aliases_new (cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+    return snapd_client_run_snapctl2_async (self, context_id, args, cancellable, callback, user_data);
 }
 
 /**
- * snapd_client_get_aliases_finish:
+ * snapd_client_run_snapctl_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @stdout_output: (out) (allow-none): the location to write the stdout from the command or %NULL.
+ * @stderr_output: (out) (allow-none): the location to write the stderr from the command or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_get_aliases_async().
- * See snapd_client_get_aliases_sync() for more information.
+ * Complete request started with snapd_client_run_snapctl_async().
+ * See snapd_client_run_snapctl_sync() for more information.
  *
- * Returns: (transfer container) (element-type SnapdAlias): an array of #SnapdAlias or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
  * Since: 1.8
+ * Deprecated: 1.59: Use snapd_client_run_snapctl2_finish()
  */
-GPtrArray *
-snapd_client_get_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_run_snapctl_finish (SnapdClient *self, GAsyncResult *result,
+                                 gchar **stdout_output, gchar **stderr_output,
+                                 GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_GET_ALIASES (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPCTL (result), FALSE);
 
-    SnapdGetAliases *request = SNAPD_GET_ALIASES (result);
+    SnapdPostSnapctl *request = SNAPD_POST_SNAPCTL (result);
 
+    /* We need to return an error for unsuccessful commands to match old API */
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-    return g_ptr_array_ref (_snapd_get_aliases_get_aliases (request));
-}
-
-static void
-send_change_aliases_request (SnapdClient *self,
-                             const gchar *action,
-                             const gchar *snap, const gchar *app, const gchar *alias,
-                             SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
-{
-    g_autoptr(SnapdPostAliases) request = _snapd_post_aliases_new (action, snap, app, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
-    send_request (self, SNAPD_REQUEST (request));
+        return FALSE;
+
+    return snapd_client_run_snapctl2_finish (self, result, stdout_output, stderr_output, NULL, error);
 }
 
 /**
- * snapd_client_alias_async:
+ * snapd_client_run_snapctl2_async:
  * @client: a #SnapdClient.
- * @snap: the name of the snap to modify.
- * @app: an app in the snap to make the alias to.
- * @alias: the name of the alias (i.e. the command that will run this app).
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @context_id: context for this call.
+ * @args: the arguments to pass to snapctl.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously create an alias to an app.
- * See snapd_client_alias_sync() for more information.
+ * Asynchronously run a snapctl command.
+ * See snapd_client_run_snapctl_sync() for more information.
  *
- * Since: 1.25
+ * Since: 1.59
  */
 void
-snapd_client_alias_async (SnapdClient *self,
-                          const gchar *snap, const gchar *app, const gchar *alias,
-                          SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                          GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_run_snapctl2_async (SnapdClient *self,
+                                 const gchar *context_id, GStrv args,
+                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (snap != NULL);
-    g_return_if_fail (app != NULL);
-    g_return_if_fail (alias != NULL);
-    send_change_aliases_request (self, "alias", snap, app, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_return_if_fail (context_id != NULL);
+    g_return_if_fail (args != NULL);
+
+    g_autoptr(SnapdPostSnapctl) request = _snapd_post_snapctl_new (context_id, args, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_alias_finish:
+ * snapd_client_run_snapctl2_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @stdout_output: (out) (allow-none): the location to write the stdout from the command or %NULL.
+ * @stderr_output: (out) (allow-none): the location to write the stderr from the command or %NULL.
+ * @exit_code: (out) (allow-none): the location to write the exit code of the command or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_alias_async().
- * See snapd_client_alias_sync() for more information.
+ * Complete request started with snapd_client_run_snapctl2_async().
+ * See snapd_client_run_snapctl2_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.25
+ * Since: 1.59
  */
 gboolean
-snapd_client_alias_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_run_snapctl2_finish (SnapdClient *self, GAsyncResult *result,
+                                  gchar **stdout_output, gchar **stderr_output,
+                                  int *exit_code,
+                                  GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPCTL (result), FALSE);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    SnapdPostSnapctl *request = SNAPD_POST_SNAPCTL (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error)) {
+        if (g_error_matches (*error, SNAPD_ERROR, SNAPD_ERROR_UNSUCCESSFUL)) {
+            /* Ignore unsuccessful errors */
+            g_clear_error (error);
+        } else {
+            return FALSE;
+        }
+    }
+
+    if (stdout_output)
+        *stdout_output = g_strdup (_snapd_post_snapctl_get_stdout_output (request));
+    if (stderr_output)
+        *stderr_output = g_strdup (_snapd_post_snapctl_get_stderr_output (request));
+    if (exit_code)
+        *exit_code = _snapd_post_snapctl_get_exit_code (request);
+
+    return TRUE;
+}
+
+typedef struct
+{
+    SnapdDownloadCache *cache;
+    gchar *name;
+    gchar *channel;
+    gchar *revision;
+    gchar *sha3_384;
+    gchar *temp_path;
+    GOutputStream *temp_stream;
+} CachedDownloadData;
+
+static void
+cached_download_data_free (CachedDownloadData *data)
+{
+    g_object_unref (data->cache);
+    g_free (data->name);
+    g_free (data->channel);
+    g_free (data->revision);
+    g_free (data->sha3_384);
+    g_free (data->temp_path);
+    g_clear_object (&data->temp_stream);
+    g_slice_free (CachedDownloadData, data);
+}
+
+static void
+return_download (GTask *task, GBytes *contents, GError *error)
+{
+    if (contents != NULL)
+        g_task_return_pointer (task, g_bytes_ref (contents), (GDestroyNotify) g_bytes_unref);
+    else
+        g_task_return_error (task, g_error_copy (error));
+}
+
+/* Complete a download and any requests for the same snap that waited for it */
+static void
+end_cached_download (GTask *task, GBytes *contents, GError *error)
+{
+    CachedDownloadData *data = g_task_get_task_data (task);
+
+    g_autoptr(GPtrArray) waiting = _snapd_download_cache_end (data->cache, data->sha3_384);
+    return_download (task, contents, error);
+    for (guint i = 0; i < waiting->len; i++)
+        return_download (g_ptr_array_index (waiting, i), contents, error);
+}
+
+static void
+cached_download_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    CachedDownloadData *data = g_task_get_task_data (task);
+    SnapdPostDownload *request = SNAPD_POST_DOWNLOAD (result);
+
+    g_autoptr(GError) error = NULL;
+    gboolean downloaded = _snapd_request_propagate_error (SNAPD_REQUEST (request), &error) &&
+                          g_output_stream_close (data->temp_stream, NULL, &error);
+    if (downloaded && g_strcmp0 (_snapd_post_download_get_sha3_384 (request), data->sha3_384) != 0) {
+        error = g_error_new (SNAPD_ERROR,
+                             SNAPD_ERROR_READ_FAILED,
+                             "Snap changed while being downloaded");
+        downloaded = FALSE;
+    }
+    if (!downloaded) {
+        g_unlink (data->temp_path);
+        end_cached_download (task, NULL, error);
+        return;
+    }
+
+    g_autoptr(GBytes) contents = _snapd_download_cache_commit (data->cache, data->temp_path, data->sha3_384, &error);
+    end_cached_download (task, contents, error);
+}
+
+static void
+uncached_download_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+
+    GError *error = NULL;
+    GBytes *contents = snapd_client_download_finish (SNAPD_CLIENT (object), result, &error);
+    if (contents != NULL)
+        g_task_return_pointer (task, contents, (GDestroyNotify) g_bytes_unref);
+    else
+        g_task_return_error (task, error);
+}
+
+static void
+cached_download_peek_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdClient *self = SNAPD_CLIENT (object);
+    CachedDownloadData *data = g_task_get_task_data (task);
+    SnapdPostDownload *request = SNAPD_POST_DOWNLOAD (result);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    GError *error = NULL;
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), &error)) {
+        g_task_return_error (task, error);
+        return;
+    }
+
+    /* Snaps without a usable digest can't be cached */
+    data->sha3_384 = g_strdup (_snapd_post_download_get_sha3_384 (request));
+    g_autofree gchar *path = _snapd_download_cache_get_path (data->cache, data->sha3_384);
+    if (path == NULL) {
+        g_autoptr(SnapdPostDownload) download = _snapd_post_download_new (data->name, data->channel, data->revision, cancellable, uncached_download_cb, g_object_ref (task));
+        send_request (self, SNAPD_REQUEST (download));
+        return;
+    }
+
+    g_autoptr(GBytes) contents = _snapd_download_cache_load (data->cache, data->sha3_384, _snapd_post_download_get_size (request));
+    if (contents != NULL) {
+        g_task_return_pointer (task, g_steal_pointer (&contents), (GDestroyNotify) g_bytes_unref);
+        return;
+    }
+
+    /* Wait for the same snap if it is already being downloaded */
+    if (!_snapd_download_cache_begin (data->cache, data->sha3_384, task))
+        return;
+
+    data->temp_stream = _snapd_download_cache_create_temp (data->cache, &data->temp_path, &error);
+    if (data->temp_stream == NULL) {
+        g_autoptr(GError) e = error;
+        end_cached_download (task, NULL, e);
+        return;
+    }
+
+    /* Write the download straight to the cache so large snaps aren't held in memory */
+    g_autoptr(SnapdPostDownload) download = _snapd_post_download_new (data->name, data->channel, data->revision, cancellable, cached_download_cb, g_object_ref (task));
+    _snapd_post_download_set_stream (download, data->temp_stream, NULL, NULL);
+    send_request (self, SNAPD_REQUEST (download));
 }
 
 /**
- * snapd_client_unalias_async:
+ * snapd_client_download_async:
  * @client: a #SnapdClient.
- * @snap: (allow-none): the name of the snap to modify or %NULL.
- * @alias: (allow-none): the name of the alias to remove or %NULL to remove all aliases for the given snap.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously remove an alias from an app.
- * See snapd_client_unalias_sync() for more information.
+ * Asynchronously download a snap.
+ * See snapd_client_download_sync() for more information.
  *
- * Since: 1.25
+ * Since: 1.54
  */
 void
-snapd_client_unalias_async (SnapdClient *self,
-                            const gchar *snap, const gchar *alias,
-                            SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                            GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_download_async (SnapdClient *self,
+                             const gchar *name, const gchar *channel, const gchar *revision,
+                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (alias != NULL);
-    send_change_aliases_request (self, "unalias", snap, NULL, alias, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_return_if_fail (name != NULL);
+
+    g_autoptr(SnapdDownloadCache) cache = NULL;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&priv->requests_mutex);
+        if (priv->download_cache != NULL)
+            cache = g_object_ref (priv->download_cache);
+    }
+
+    if (cache == NULL) {
+        g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, callback, user_data);
+        send_request (self, SNAPD_REQUEST (request));
+        return;
+    }
+
+    CachedDownloadData *data = g_slice_new0 (CachedDownloadData);
+    data->cache = g_steal_pointer (&cache);
+    data->name = g_strdup (name);
+    data->channel = g_strdup (channel);
+    data->revision = g_strdup (revision);
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_task_data (task, data, (GDestroyNotify) cached_download_data_free);
+
+    /* Find out which snap would be sent before deciding if it needs downloading */
+    g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, cached_download_peek_cb, g_steal_pointer (&task));
+    _snapd_post_download_set_header_peek (request, TRUE);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_unalias_finish:
+ * snapd_client_download_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_unalias_async().
- * See snapd_client_unalias_sync() for more information.
+ * Complete request started with snapd_client_download_async().
+ * See snapd_client_download_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: the snap contents or %NULL on error.
  *
- * Since: 1.25
+ * Since: 1.54
  */
-gboolean
-snapd_client_unalias_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+GBytes *
+snapd_client_download_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (result) || g_task_is_valid (result, self), NULL);
 
-    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+    /* Downloads using the cache */
+    if (G_IS_TASK (result))
+        return g_task_propagate_pointer (G_TASK (result), error);
+
+    SnapdPostDownload *request = SNAPD_POST_DOWNLOAD (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return NULL;
+
+    return g_bytes_ref (_snapd_post_download_get_data (request));
 }
 
 /**
- * snapd_client_prefer_async:
+ * snapd_client_download_to_stream_async:
  * @client: a #SnapdClient.
- * @snap: the name of the snap to modify.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
+ * @stream: a #GOutputStream to write the snap contents to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously ???.
- * See snapd_client_prefer_sync() for more information.
+ * Asynchronously download a snap.
+ * See snapd_client_download_to_stream_sync() for more information.
  *
- * Since: 1.25
+ * Since: 1.65
  */
 void
-snapd_client_prefer_async (SnapdClient *self,
-                           const gchar *snap,
-                           SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                           GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_download_to_stream_async (SnapdClient *self,
+                                       const gchar *name, const gchar *channel, const gchar *revision,
+                                       GOutputStream *stream,
+                                       GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (snap != NULL);
-    send_change_aliases_request (self, "prefer", snap, NULL, NULL, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    g_return_if_fail (name != NULL);
+    g_return_if_fail (G_IS_OUTPUT_STREAM (stream));
+
+    g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, callback, user_data);
+    _snapd_post_download_set_stream (request, stream, progress_callback, progress_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_prefer_finish:
+ * snapd_client_download_to_stream_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_prefer_async().
- * See snapd_client_prefer_sync() for more information.
+ * Complete request started with snapd_client_download_to_stream_async().
+ * See snapd_client_download_to_stream_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.25
+ * Since: 1.65
  */
 gboolean
-snapd_client_prefer_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_download_to_stream_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_ALIASES (result), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (result), FALSE);
 
     return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_enable_aliases_async:
+ * snapd_client_download_peek_async:
  * @client: a #SnapdClient.
- * @snap: the name of the snap to modify.
- * @aliases: the aliases to modify.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
- * @progress_callback_data: (closure): user data to pass to @progress_callback.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously change the state of aliases.
- * See snapd_client_enable_aliases_sync() for more information.
+ * Asynchronously get information about a snap download.
+ * See snapd_client_download_peek_sync() for more information.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_alias_async()
+ * Since: 1.65
  */
 void
-snapd_client_enable_aliases_async (SnapdClient *self,
-                                   const gchar *snap, GStrv aliases,
-                                   SnapdProgressCallback progress_callback, gpointer progress_callback_data,
-                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_download_peek_async (SnapdClient *self,
+                                  const gchar *name, const gchar *channel, const gchar *revision,
+                                  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
 
-    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
-    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_enable_aliases_async is deprecated");
+    g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, callback, user_data);
+    _snapd_post_download_set_header_peek (request, TRUE);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_enable_aliases_finish:
+ * snapd_client_download_peek_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @size: (out) (allow-none): location to store the size of the snap in bytes or %NULL.
+ * @sha3_384: (out) (allow-none): location to store the SHA3-384 hash of the snap or %NULL.
+ * @resume_token: (out) (allow-none): location to store the token to resume a download or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_enable_aliases_async().
- * See snapd_client_enable_aliases_sync() for more information.
+ * Complete request started with snapd_client_download_peek_async().
+ * See snapd_client_download_peek_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_unalias_finish()
+ * Since: 1.65
  */
 gboolean
-snapd_client_enable_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_download_peek_finish (SnapdClient *self, GAsyncResult *result,
+                                   goffset *size, gchar **sha3_384, gchar **resume_token,
+                                   GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (result), FALSE);
 
-    return g_task_propagate_boolean (G_TASK (result), error);
+    SnapdPostDownload *request = SNAPD_POST_DOWNLOAD (result);
+
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
+        return FALSE;
+
+    if (size)
+       *size = _snapd_post_download_get_size (request);
+    if (sha3_384)
+       *sha3_384 = g_strdup (_snapd_post_download_get_sha3_384 (request));
+    if (resume_token)
+       *resume_token = g_strdup (_snapd_post_download_get_resume_token (request));
+
+    return TRUE;
 }
 
-/**
- * snapd_client_disable_aliases_async:
- * @client: a #SnapdClient.
- * @snap: the name of the snap to modify.
- * @aliases: the aliases to modify.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
+/**
+ * snapd_client_download_resume_async:
+ * @client: a #SnapdClient.
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from.
+ * @revision: (allow-none): revision to download.
+ * @resume_token: token returned by snapd_client_download_peek_sync().
+ * @offset: number of bytes already downloaded.
+ * @stream: a #GOutputStream to write the remaining snap contents to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously change the state of aliases.
- * See snapd_client_disable_aliases_sync() for more information.
+ * Asynchronously continue downloading a snap.
+ * See snapd_client_download_resume_sync() for more information.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_unalias_async()
+ * Since: 1.65
  */
 void
-snapd_client_disable_aliases_async (SnapdClient *self,
-                                    const gchar *snap, GStrv aliases,
-                                    SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+snapd_client_download_resume_async (SnapdClient *self,
+                                    const gchar *name, const gchar *channel, const gchar *revision,
+                                    const gchar *resume_token, goffset offset,
+                                    GOutputStream *stream,
+                                    GFileProgressCallback progress_callback, gpointer progress_callback_data,
                                     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (name != NULL);
+    g_return_if_fail (resume_token != NULL);
+    g_return_if_fail (offset >= 0);
+    g_return_if_fail (G_IS_OUTPUT_STREAM (stream));
 
-    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
-    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_disable_aliases_async is deprecated");
+    g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, callback, user_data);
+    _snapd_post_download_set_resume (request, resume_token, offset);
+    _snapd_post_download_set_stream (request, stream, progress_callback, progress_callback_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_disable_aliases_finish:
+ * snapd_client_download_resume_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_disable_aliases_async().
- * See snapd_client_disable_aliases_sync() for more information.
+ * Complete request started with snapd_client_download_resume_async().
+ * See snapd_client_download_resume_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_unalias_finish()
+ * Since: 1.65
  */
 gboolean
-snapd_client_disable_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_download_resume_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (result), FALSE);
 
-    return g_task_propagate_boolean (G_TASK (result), error);
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
+}
+
+/* State of a request to download many snaps */
+typedef struct
+{
+    SnapdClient *client;
+    GPtrArray *downloads;
+    guint next_peek;
+    guint next_download;
+    guint n_running;
+    guint max_parallel;
+    SnapdBandwidthLimit *limit;
+    GSource *delay_source;
+    SnapdDownloadProgressCallback progress_callback;
+    gpointer progress_callback_data;
+    goffset total;
+    goffset downloaded;
+    gint64 start_time;
+    GError *error;
+} DownloadManyData;
+
+static void
+download_many_data_free (DownloadManyData *data)
+{
+    g_object_unref (data->client);
+    g_ptr_array_unref (data->downloads);
+    g_clear_pointer (&data->limit, _snapd_bandwidth_limit_unref);
+    if (data->delay_source != NULL)
+        g_source_destroy (data->delay_source);
+    g_clear_pointer (&data->delay_source, g_source_unref);
+    g_clear_error (&data->error);
+    g_slice_free (DownloadManyData, data);
+}
+
+/* A single snap being downloaded for a #DownloadManyData */
+typedef struct
+{
+    GTask *task;
+    SnapdDownload *download;
+} DownloadManyItem;
+
+static DownloadManyItem *
+download_many_item_new (GTask *task, SnapdDownload *download)
+{
+    DownloadManyItem *item = g_slice_new (DownloadManyItem);
+    item->task = g_object_ref (task);
+    item->download = g_object_ref (download);
+    return item;
+}
+
+static void
+download_many_item_free (DownloadManyItem *item)
+{
+    g_object_unref (item->task);
+    g_object_unref (item->download);
+    g_slice_free (DownloadManyItem, item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (DownloadManyItem, download_many_item_free)
+
+static void download_many_start (GTask *task);
+
+static void
+download_many_progress_cb (goffset current_num_bytes, goffset total_num_bytes, gpointer user_data)
+{
+    DownloadManyItem *item = user_data;
+    DownloadManyData *data = g_task_get_task_data (item->task);
+
+    data->downloaded += current_num_bytes - snapd_download_get_downloaded (item->download);
+    _snapd_download_set_downloaded (item->download, current_num_bytes);
+
+    if (data->progress_callback == NULL)
+        return;
+
+    /* Estimate from the average rate so far */
+    gint64 eta = -1;
+    gint64 elapsed = g_get_monotonic_time () - data->start_time;
+    if (data->downloaded > 0)
+        eta = (gint64) ((gdouble) (data->total - data->downloaded) * elapsed / data->downloaded / G_USEC_PER_SEC);
+    data->progress_callback (data->client, item->download, data->downloaded, data->total, eta, data->progress_callback_data);
+}
+
+static void
+download_many_download_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(DownloadManyItem) item = user_data;
+    DownloadManyData *data = g_task_get_task_data (item->task);
+
+    g_autoptr(GError) error = NULL;
+    if (!_snapd_request_propagate_error (SNAPD_REQUEST (result), &error) && data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    data->n_running--;
+    download_many_start (item->task);
+}
+
+static gboolean
+download_many_delay_cb (gpointer user_data)
+{
+    GTask *task = user_data;
+    DownloadManyData *data = g_task_get_task_data (task);
+
+    g_clear_pointer (&data->delay_source, g_source_unref);
+    download_many_start (task);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Download snaps until the limit is reached, completing once all have been received.
+ * Stops starting downloads after an error, since the set won't be complete */
+static void
+download_many_start (GTask *task)
+{
+    DownloadManyData *data = g_task_get_task_data (task);
+    GCancellable *cancellable = g_task_get_cancellable (task);
+
+    if (data->delay_source != NULL)
+        return;
+
+    while (data->next_download < data->downloads->len && data->n_running < data->max_parallel &&
+           data->error == NULL && !g_cancellable_is_cancelled (cancellable)) {
+        /* Small snaps are received before the connection can be held back, so wait here until under the limit again */
+        gint64 delay = data->limit != NULL ? _snapd_bandwidth_limit_get_delay (data->limit) : 0;
+        if (delay > 0) {
+            data->delay_source = g_timeout_source_new ((guint) MAX (delay / 1000, 1));
+            g_source_set_name (data->delay_source, "snapd-glib-download-many-delay");
+            g_source_set_callback (data->delay_source, download_many_delay_cb, g_object_ref (task), g_object_unref);
+            g_source_attach (data->delay_source, g_task_get_context (task));
+            return;
+        }
+
+        SnapdDownload *download = g_ptr_array_index (data->downloads, data->next_download);
+        data->next_download++;
+        data->n_running++;
+
+        DownloadManyItem *item = download_many_item_new (task, download);
+        g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (snapd_download_get_name (download),
+                                                                         snapd_download_get_channel (download),
+                                                                         snapd_download_get_revision (download),
+                                                                         cancellable, download_many_download_cb, item);
+        _snapd_post_download_set_stream (request, snapd_download_get_stream (download), download_many_progress_cb, item);
+        _snapd_request_set_bandwidth_limit (SNAPD_REQUEST (request), data->limit);
+        send_request (data->client, SNAPD_REQUEST (request));
+    }
+
+    if (data->n_running > 0)
+        return;
+
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error))
+        g_task_return_error (task, g_steal_pointer (&error));
+    else if (data->error != NULL)
+        g_task_return_error (task, g_steal_pointer (&data->error));
+    else
+        g_task_return_boolean (task, TRUE);
+}
+
+static void download_many_peek_cb (GObject *object, GAsyncResult *result, gpointer user_data);
+
+/* Get the size of snaps until the limit is reached, using the same number of requests at once as the downloads */
+static void
+download_many_peek (GTask *task)
+{
+    DownloadManyData *data = g_task_get_task_data (task);
+
+    while (data->next_peek < data->downloads->len && data->n_running < data->max_parallel && data->error == NULL) {
+        SnapdDownload *download = g_ptr_array_index (data->downloads, data->next_peek);
+        data->next_peek++;
+        data->n_running++;
+        _snapd_download_set_downloaded (download, 0);
+        snapd_client_download_peek_async (data->client,
+                                          snapd_download_get_name (download),
+                                          snapd_download_get_channel (download),
+                                          snapd_download_get_revision (download),
+                                          g_task_get_cancellable (task), download_many_peek_cb, download_many_item_new (task, download));
+    }
+}
+
+static void
+download_many_peek_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(DownloadManyItem) item = user_data;
+    DownloadManyData *data = g_task_get_task_data (item->task);
+
+    g_autoptr(GError) error = NULL;
+    goffset size;
+    if (snapd_client_download_peek_finish (SNAPD_CLIENT (object), result, &size, NULL, NULL, &error)) {
+        _snapd_download_set_size (item->download, size);
+        data->total += size;
+    }
+    else if (data->error == NULL)
+        data->error = g_steal_pointer (&error);
+
+    data->n_running--;
+    download_many_peek (item->task);
+    if (data->n_running > 0)
+        return;
+
+    /* Everything is checked to exist before downloading anything */
+    data->start_time = g_get_monotonic_time ();
+    download_many_start (item->task);
 }
 
 /**
- * snapd_client_reset_aliases_async:
+ * snapd_client_download_many_async:
  * @client: a #SnapdClient.
- * @snap: the name of the snap to modify.
- * @aliases: the aliases to modify.
- * @progress_callback: (allow-none) (scope call): function to callback with progress.
+ * @downloads: (element-type SnapdDownload): snaps to download.
+ * @max_parallel: maximum number of snaps to download at once, or 0 for one per connection.
+ * @max_bytes_per_second: maximum combined download rate, or 0 for no limit.
+ * @progress_callback: (allow-none) (scope call): function to call as the snaps are downloaded.
  * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously change the state of aliases.
- * See snapd_client_reset_aliases_sync() for more information.
+ * Asynchronously download many snaps.
+ * See snapd_client_download_many_sync() for more information.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_disable_aliases_async()
+ * Since: 1.65
  */
 void
-snapd_client_reset_aliases_async (SnapdClient *self,
-                                  const gchar *snap, GStrv aliases,
-                                  SnapdProgressCallback progress_callback, gpointer progress_callback_data,
+snapd_client_download_many_async (SnapdClient *self,
+                                  GPtrArray *downloads, guint max_parallel, goffset max_bytes_per_second,
+                                  SnapdDownloadProgressCallback progress_callback, gpointer progress_callback_data,
                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
+    SnapdClientPrivate *priv = snapd_client_get_instance_private (self);
+
     g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (downloads != NULL);
+    g_return_if_fail (max_bytes_per_second >= 0);
+
+    DownloadManyData *data = g_slice_new0 (DownloadManyData);
+    data->client = g_object_ref (self);
+    data->downloads = g_ptr_array_ref (downloads);
+    data->max_parallel = max_parallel > 0 ? max_parallel : MAX (priv->max_connections, 1);
+    if (max_bytes_per_second > 0)
+        data->limit = _snapd_bandwidth_limit_new (max_bytes_per_second);
+    data->progress_callback = progress_callback;
+    data->progress_callback_data = progress_callback_data;
+    data->start_time = g_get_monotonic_time ();
 
     g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
-    g_task_return_new_error (task, SNAPD_ERROR, SNAPD_ERROR_FAILED, "snapd_client_reset_aliases_async is deprecated");
+    g_task_set_task_data (task, data, (GDestroyNotify) download_many_data_free);
+
+    if (downloads->len == 0) {
+        download_many_start (task);
+        return;
+    }
+
+    /* Get the size of every snap first so the overall progress is known */
+    download_many_peek (task);
 }
 
 /**
- * snapd_client_reset_aliases_finish:
+ * snapd_client_download_many_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_reset_aliases_async().
- * See snapd_client_reset_aliases_sync() for more information.
+ * Complete request started with snapd_client_download_many_async().
+ * See snapd_client_download_many_sync() for more information.
  *
- * Returns: %TRUE on success or %FALSE on error.
+ * Returns: %TRUE if all snaps were downloaded.
  *
- * Since: 1.8
- * Deprecated: 1.25: Use snapd_client_disable_aliases_finish()
+ * Since: 1.65
  */
 gboolean
-snapd_client_reset_aliases_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+snapd_client_download_many_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
     g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
     g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
@@ -3810,185 +13654,159 @@ snapd_client_reset_aliases_finish (SnapdClient *self, GAsyncResult *result, GErr
 }
 
 /**
- * snapd_client_run_snapctl_async:
+ * snapd_client_export_snapshot_async:
  * @client: a #SnapdClient.
- * @context_id: context for this call.
- * @args: the arguments to pass to snapctl.
+ * @set_id: the ID of the snapshot set to export.
+ * @stream: a #GOutputStream to write the snapshot archive to.
+ * @progress_callback: (allow-none) (scope call): function to callback with the number of bytes received.
+ * @progress_callback_data: (closure): user data to pass to @progress_callback.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously run a snapctl command.
- * See snapd_client_run_snapctl_sync() for more information.
+ * Asynchronously export a snapshot set.
+ * See snapd_client_export_snapshot_sync() for more information.
  *
- * Since: 1.8
- * Deprecated: 1.59: Use snapd_client_run_snapctl2_async()
+ * Since: 1.65
  */
 void
-snapd_client_run_snapctl_async (SnapdClient *self,
-                                const gchar *context_id, GStrv args,
-                                GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_export_snapshot_async (SnapdClient *self,
+                                    gint64 set_id,
+                                    GOutputStream *stream,
+                                    GFileProgressCallback progress_callback, gpointer progress_callback_data,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
-    return snapd_client_run_snapctl2_async (self, context_id, args, cancellable, callback, user_data);
+    g_return_if_fail (SNAPD_IS_CLIENT (self));
+    g_return_if_fail (G_IS_OUTPUT_STREAM (stream));
+
+    g_autoptr(SnapdGetSnapshotExport) request = _snapd_get_snapshot_export_new (set_id, stream, progress_callback, progress_callback_data, cancellable, callback, user_data);
+    send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_run_snapctl_finish:
+ * snapd_client_export_snapshot_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
- * @stdout_output: (out) (allow-none): the location to write the stdout from the command or %NULL.
- * @stderr_output: (out) (allow-none): the location to write the stderr from the command or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_run_snapctl_async().
- * See snapd_client_run_snapctl_sync() for more information.
+ * Complete request started with snapd_client_export_snapshot_async().
+ * See snapd_client_export_snapshot_sync() for more information.
  *
  * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.8
- * Deprecated: 1.59: Use snapd_client_run_snapctl2_finish()
+ * Since: 1.65
  */
 gboolean
-snapd_client_run_snapctl_finish (SnapdClient *self, GAsyncResult *result,
-                                 gchar **stdout_output, gchar **stderr_output,
-                                 GError **error)
+snapd_client_export_snapshot_finish (SnapdClient *self, GAsyncResult *result, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_POST_SNAPCTL (result), FALSE);
-
-    SnapdPostSnapctl *request = SNAPD_POST_SNAPCTL (result);
-
-    /* We need to return an error for unsuccessful commands to match old API */
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return FALSE;
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_GET_SNAPSHOT_EXPORT (result), FALSE);
 
-    return snapd_client_run_snapctl2_finish (self, result, stdout_output, stderr_output, NULL, error);
+    return _snapd_request_propagate_error (SNAPD_REQUEST (result), error);
 }
 
 /**
- * snapd_client_run_snapctl2_async:
+ * snapd_client_import_snapshot_async:
  * @client: a #SnapdClient.
- * @context_id: context for this call.
- * @args: the arguments to pass to snapctl.
+ * @stream: a #GInputStream to read the snapshot archive from.
+ * @size: the size of the archive in bytes.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously run a snapctl command.
- * See snapd_client_run_snapctl_sync() for more information.
+ * Asynchronously import a snapshot set.
+ * See snapd_client_import_snapshot_sync() for more information.
  *
- * Since: 1.59
+ * Since: 1.65
  */
 void
-snapd_client_run_snapctl2_async (SnapdClient *self,
-                                 const gchar *context_id, GStrv args,
-                                 GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_import_snapshot_async (SnapdClient *self,
+                                    GInputStream *stream, goffset size,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (context_id != NULL);
-    g_return_if_fail (args != NULL);
+    g_return_if_fail (G_IS_INPUT_STREAM (stream));
+    g_return_if_fail (size >= 0);
 
-    g_autoptr(SnapdPostSnapctl) request = _snapd_post_snapctl_new (context_id, args, cancellable, callback, user_data);
+    g_autoptr(SnapdPostSnapshots) request = _snapd_post_snapshots_new (cancellable, callback, user_data);
+    _snapd_post_snapshots_set_stream (request, stream, size);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_run_snapctl2_finish:
- * @client: a #SnapdClient.
- * @result: a #GAsyncResult.
- * @stdout_output: (out) (allow-none): the location to write the stdout from the command or %NULL.
- * @stderr_output: (out) (allow-none): the location to write the stderr from the command or %NULL.
- * @exit_code: (out) (allow-none): the location to write the exit code of the command or %NULL.
- * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
- *
- * Complete request started with snapd_client_run_snapctl2_async().
- * See snapd_client_run_snapctl2_sync() for more information.
- *
- * Returns: %TRUE on success or %FALSE on error.
- *
- * Since: 1.59
- */
-gboolean
-snapd_client_run_snapctl2_finish (SnapdClient *self, GAsyncResult *result,
-                                  gchar **stdout_output, gchar **stderr_output,
-                                  int *exit_code,
-                                  GError **error)
-{
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
-    g_return_val_if_fail (SNAPD_IS_POST_SNAPCTL (result), FALSE);
-
-    SnapdPostSnapctl *request = SNAPD_POST_SNAPCTL (result);
-
-    if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error)) {
-        if (g_error_matches (*error, SNAPD_ERROR, SNAPD_ERROR_UNSUCCESSFUL)) {
-            /* Ignore unsuccessful errors */
-            g_clear_error (error);
-        } else {
-            return FALSE;
-        }
-    }
-
-    if (stdout_output)
-        *stdout_output = g_strdup (_snapd_post_snapctl_get_stdout_output (request));
-    if (stderr_output)
-        *stderr_output = g_strdup (_snapd_post_snapctl_get_stderr_output (request));
-    if (exit_code)
-        *exit_code = _snapd_post_snapctl_get_exit_code (request);
-
-    return TRUE;
-}
-
-/**
- * snapd_client_download_async:
+ * snapd_client_import_snapshot_fd_async:
  * @client: a #SnapdClient.
- * @name: name of snap to download.
- * @channel: (allow-none): channel to download from.
- * @revision: (allow-none): revision to download.
+ * @fd: a file descriptor for a regular file containing the snapshot archive.
  * @cancellable: (allow-none): a #GCancellable or %NULL.
  * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
  * @user_data: (closure): the data to pass to callback function.
  *
- * Asynchronously download a snap.
- * See snapd_client_download_sync() for more information.
+ * Asynchronously import a snapshot set from a file.
+ * See snapd_client_import_snapshot_fd_sync() for more information.
  *
- * Since: 1.54
+ * Since: 1.65
  */
 void
-snapd_client_download_async (SnapdClient *self,
-                             const gchar *name, const gchar *channel, const gchar *revision,
-                             GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+snapd_client_import_snapshot_fd_async (SnapdClient *self,
+                                       int fd,
+                                       GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
     g_return_if_fail (SNAPD_IS_CLIENT (self));
-    g_return_if_fail (name != NULL);
+    g_return_if_fail (fd >= 0);
 
-    g_autoptr(SnapdPostDownload) request = _snapd_post_download_new (name, channel, revision, cancellable, callback, user_data);
+    g_autoptr(SnapdPostSnapshots) request = _snapd_post_snapshots_new (cancellable, callback, user_data);
+    int request_fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+    if (request_fd < 0) {
+        return_fd_error (self, SNAPD_REQUEST (request), "Failed to duplicate snapshot file descriptor");
+        return;
+    }
+
+    /* The file is copied to the socket by the kernel, so its size has to be known up front */
+    struct stat file_info;
+    if (fstat (request_fd, &file_info) != 0 || !S_ISREG (file_info.st_mode)) {
+        close (request_fd);
+        g_autoptr(GError) error = g_error_new (G_IO_ERROR,
+                                               G_IO_ERROR_NOT_REGULAR_FILE,
+                                               "Snapshot file descriptor is not a regular file");
+        _snapd_request_set_source_object (SNAPD_REQUEST (request), G_OBJECT (self));
+        _snapd_request_return (SNAPD_REQUEST (request), error);
+        return;
+    }
+    _snapd_post_snapshots_set_fd (request, request_fd, file_info.st_size);
     send_request (self, SNAPD_REQUEST (request));
 }
 
 /**
- * snapd_client_download_finish:
+ * snapd_client_import_snapshot_finish:
  * @client: a #SnapdClient.
  * @result: a #GAsyncResult.
+ * @set_id: (out) (allow-none): location to store the ID of the imported snapshot set or %NULL.
+ * @snaps: (out) (allow-none) (transfer full): location to store the names of the snaps in the set or %NULL.
  * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
  *
- * Complete request started with snapd_client_download_async().
- * See snapd_client_download_sync() for more information.
+ * Complete request started with snapd_client_import_snapshot_async() or
+ * snapd_client_import_snapshot_fd_async().
+ * See snapd_client_import_snapshot_sync() for more information.
  *
- * Returns: the snap contents or %NULL on error.
+ * Returns: %TRUE on success or %FALSE on error.
  *
- * Since: 1.54
+ * Since: 1.65
  */
-GBytes *
-snapd_client_download_finish (SnapdClient *self, GAsyncResult *result, GError **error)
+gboolean
+snapd_client_import_snapshot_finish (SnapdClient *self, GAsyncResult *result, gint64 *set_id, GStrv *snaps, GError **error)
 {
-    g_return_val_if_fail (SNAPD_IS_CLIENT (self), NULL);
-    g_return_val_if_fail (SNAPD_IS_POST_DOWNLOAD (result), NULL);
+    g_return_val_if_fail (SNAPD_IS_CLIENT (self), FALSE);
+    g_return_val_if_fail (SNAPD_IS_POST_SNAPSHOTS (result), FALSE);
 
-    SnapdPostDownload *request = SNAPD_POST_DOWNLOAD (result);
+    SnapdPostSnapshots *request = SNAPD_POST_SNAPSHOTS (result);
 
     if (!_snapd_request_propagate_error (SNAPD_REQUEST (request), error))
-        return NULL;
-
-    return g_bytes_ref (_snapd_post_download_get_data (request));
+        return FALSE;
+    if (set_id != NULL)
+        *set_id = _snapd_post_snapshots_get_set_id (request);
+    if (snaps != NULL)
+        *snaps = g_strdupv (_snapd_post_snapshots_get_snaps (request));
+    return TRUE;
 }
 
 /**
@@ -4136,8 +13954,11 @@ snapd_client_new_from_socket (GSocket *socket)
 {
     SnapdClient *self = snapd_client_new ();
     SnapdClientPrivate *priv = snapd_client_get_instance_private (SNAPD_CLIENT (self));
-    priv->snapd_socket = g_object_ref (socket);
-    g_socket_set_blocking (priv->snapd_socket, FALSE);
+    ConnectionData *connection = connection_new (self);
+    connection->socket = g_object_ref (socket);
+    g_socket_set_blocking (connection->socket, FALSE);
+    g_ptr_array_add (priv->connections, connection);
+    priv->socket_provided = TRUE;
 
     return self;
 }
@@ -4147,16 +13968,61 @@ snapd_client_finalize (GObject *object)
 {
     SnapdClientPrivate *priv = snapd_client_get_instance_private (SNAPD_CLIENT (object));
 
+    remove_caches (priv->cache_manager, priv->response_cache_id, priv->snap_cache_id, priv->store_snap_cache_id, priv->resolve_cache_id);
+    g_clear_object (&priv->cache_manager);
+    stop_io_thread (SNAPD_CLIENT (object));
+    clear_io_context (SNAPD_CLIENT (object));
+    g_clear_pointer (&priv->cancel_queues, g_ptr_array_unref);
+    if (priv->progress_delta_callback_destroy_notify != NULL)
+        priv->progress_delta_callback_destroy_notify (priv->progress_delta_callback_data);
+    if (priv->upload_progress_callback_destroy_notify != NULL)
+        priv->upload_progress_callback_destroy_notify (priv->upload_progress_callback_data);
+    g_mutex_clear (&priv->cancel_mutex);
+    g_mutex_clear (&priv->submit_mutex);
     g_mutex_clear (&priv->requests_mutex);
-    g_mutex_clear (&priv->buffer_mutex);
+    g_mutex_clear (&priv->headers_mutex);
+    g_mutex_clear (&priv->statistics_mutex);
+    g_clear_pointer (&priv->endpoint_statistics, g_hash_table_unref);
+    g_clear_pointer (&priv->memory_counter, _snapd_memory_counter_unref);
+    g_clear_object (&priv->catalog_cache);
+    g_clear_object (&priv->download_cache);
     g_clear_pointer (&priv->socket_path, g_free);
+    g_clear_object (&priv->address);
     g_clear_pointer (&priv->user_agent, g_free);
     g_clear_object (&priv->auth_data);
-    g_clear_pointer (&priv->requests, g_ptr_array_unref);
-    if (priv->snapd_socket != NULL)
-        g_socket_close (priv->snapd_socket, NULL);
-    g_clear_object (&priv->snapd_socket);
-    g_clear_pointer (&priv->buffer, g_byte_array_unref);
+    g_clear_pointer (&priv->common_headers, g_bytes_unref);
+    g_clear_pointer (&priv->prepared_requests, g_hash_table_unref);
+    if (priv->batch_poll_source != NULL)
+        g_source_destroy (priv->batch_poll_source);
+    g_clear_pointer (&priv->batch_poll_source, g_source_unref);
+    if (priv->notices_source != NULL)
+        g_source_destroy (priv->notices_source);
+    g_clear_pointer (&priv->notices_source, g_source_unref);
+    g_clear_pointer (&priv->notices_context, g_main_context_unref);
+    g_clear_pointer (&priv->notices_after, g_free);
+    g_clear_pointer (&priv->notices_connections, g_ptr_array_unref);
+    g_clear_pointer (&priv->connections, g_ptr_array_unref);
+    g_clear_object (&priv->transport);
+    g_clear_pointer (&priv->capture, _snapd_capture_unref);
+    g_mutex_clear (&priv->capture_mutex);
+    g_clear_pointer (&priv->change_requests, g_hash_table_unref);
+    g_clear_pointer (&priv->post_change_requests, g_hash_table_unref);
+    g_clear_pointer (&priv->coalesced_requests, g_hash_table_unref);
+    g_clear_pointer (&priv->superseding_requests, g_hash_table_unref);
+    g_clear_pointer (&priv->cache_ttls, g_hash_table_unref);
+    g_clear_pointer (&priv->cache, g_hash_table_unref);
+    g_clear_pointer (&priv->snap_cache, g_hash_table_unref);
+    g_clear_pointer (&priv->store_snap_cache, g_hash_table_unref);
+    g_mutex_clear (&priv->resolve_mutex);
+    g_clear_pointer (&priv->resolve_cache, g_hash_table_unref);
+    stop_socket_monitor (SNAPD_CLIENT (object));
+    g_mutex_clear (&priv->socket_monitor_mutex);
+    g_clear_pointer (&priv->parked_sources, g_ptr_array_unref);
+    g_clear_pointer (&priv->snapd_version, g_free);
+    g_clear_pointer (&priv->interface_docs, g_hash_table_unref);
+    g_clear_pointer (&priv->interface_docs_version, g_free);
+    g_clear_pointer (&priv->icon_cache_path, g_free);
+    g_clear_pointer (&priv->requests, g_hash_table_unref);
     g_clear_object (&priv->maintenance);
 
     G_OBJECT_CLASS (snapd_client_parent_class)->finalize (object);
@@ -4168,6 +14034,44 @@ snapd_client_class_init (SnapdClientClass *klass)
    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
    gobject_class->finalize = snapd_client_finalize;
+
+   /**
+    * SnapdClient::request-finished:
+    * @client: a #SnapdClient.
+    * @timings: the #SnapdRequestTimings for the request.
+    *
+    * Emitted after the callback for a request has been called, including
+    * requests made internally such as polls for change progress. The signal is
+    * emitted in the thread-default main context the request was made in.
+    *
+    * Since: 1.65
+    */
+   signals[SIGNAL_REQUEST_FINISHED] = g_signal_new ("request-finished",
+                                                    G_TYPE_FROM_CLASS (klass),
+                                                    G_SIGNAL_RUN_LAST,
+                                                    0,
+                                                    NULL, NULL,
+                                                    NULL,
+                                                    G_TYPE_NONE, 1, SNAPD_TYPE_REQUEST_TIMINGS);
+
+   /**
+    * SnapdClient::slow-request:
+    * @client: a #SnapdClient.
+    * @request: a #SnapdPendingRequest describing what the request is waiting for.
+    *
+    * Emitted once for each request that hasn't completed after the time set
+    * with snapd_client_set_slow_request_threshold(). The signal is emitted in
+    * the thread-default main context the request was made in.
+    *
+    * Since: 1.65
+    */
+   signals[SIGNAL_SLOW_REQUEST] = g_signal_new ("slow-request",
+                                                G_TYPE_FROM_CLASS (klass),
+                                                G_SIGNAL_RUN_LAST,
+                                                0,
+                                                NULL, NULL,
+                                                NULL,
+                                                G_TYPE_NONE, 1, SNAPD_TYPE_PENDING_REQUEST);
 }
 
 static void
@@ -4178,8 +14082,43 @@ snapd_client_init (SnapdClient *self)
     priv->socket_path = g_strdup (SNAPD_SOCKET);
     priv->user_agent = g_strdup ("snapd-glib/" VERSION);
     priv->allow_interaction = TRUE;
-    priv->requests = g_ptr_array_new_with_free_func ((GDestroyNotify) request_data_unref);
-    priv->buffer = g_byte_array_new ();
+    priv->max_read_size = DEFAULT_MAX_READ_SIZE;
+    priv->max_connections = 1;
+    priv->max_pipeline_depth = DEFAULT_MAX_PIPELINE_DEPTH;
+    priv->request_priority = SNAPD_REQUEST_PRIORITY_NORMAL;
+    priv->poll_interval = DEFAULT_POLL_INTERVAL;
+    priv->memory_counter = _snapd_memory_counter_new ();
+    priv->max_poll_interval = DEFAULT_MAX_POLL_INTERVAL;
+    priv->retry_interval = DEFAULT_RETRY_INTERVAL;
+    priv->max_retry_interval = DEFAULT_MAX_RETRY_INTERVAL;
+    priv->connect_timeout = DEFAULT_CONNECT_TIMEOUT;
+    priv->expect_continue_size = DEFAULT_EXPECT_CONTINUE_SIZE;
+    priv->connections = g_ptr_array_new_with_free_func ((GDestroyNotify) connection_free);
+    priv->notices_connections = g_ptr_array_new_with_free_func ((GDestroyNotify) connection_free);
+    priv->requests = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) request_data_unref);
+    priv->change_requests = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    priv->post_change_requests = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    priv->coalesced_requests = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    priv->superseding_requests = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    priv->cache_ttls = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    priv->cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) cache_entry_free);
+    priv->snap_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) resolve_cache_entry_free);
+    priv->store_snap_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) resolve_cache_entry_free);
+    g_mutex_init (&priv->socket_monitor_mutex);
+    priv->parked_sources = g_ptr_array_new_with_free_func ((GDestroyNotify) g_source_unref);
+    g_mutex_init (&priv->resolve_mutex);
+    priv->resolve_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) resolve_cache_entry_free);
+    priv->resolve_cache_ttl = DEFAULT_RESOLVE_CACHE_TTL;
+    priv->cache_manager = snapd_cache_manager_new ();
+    add_caches (self, priv->cache_manager, &priv->response_cache_id, &priv->snap_cache_id, &priv->store_snap_cache_id, &priv->resolve_cache_id);
+    priv->interface_docs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    g_mutex_init (&priv->cancel_mutex);
+    priv->cancel_queues = g_ptr_array_new_with_free_func ((GDestroyNotify) cancel_queue_free);
+    g_mutex_init (&priv->submit_mutex);
     g_mutex_init (&priv->requests_mutex);
-    g_mutex_init (&priv->buffer_mutex);
+    g_mutex_init (&priv->headers_mutex);
+    priv->prepared_requests = g_hash_table_new_full (prepared_request_hash, prepared_request_equal, (GDestroyNotify) prepared_request_free, NULL);
+    g_mutex_init (&priv->statistics_mutex);
+    g_mutex_init (&priv->capture_mutex);
+    priv->endpoint_statistics = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
@@ -17,12 +17,24 @@
 #include <glib-object.h>
 #include <gio/gio.h>
 
+#include <snapd-glib/snapd-assertion.h>
 #include <snapd-glib/snapd-auth-data.h>
+#include <snapd-glib/snapd-cache-manager.h>
+#include <snapd-glib/snapd-catalog-cache.h>
+#include <snapd-glib/snapd-download.h>
+#include <snapd-glib/snapd-download-cache.h>
 #include <snapd-glib/snapd-icon.h>
+#include <snapd-glib/snapd-log.h>
 #include <snapd-glib/snapd-maintenance.h>
 #include <snapd-glib/snapd-snap.h>
+#include <snapd-glib/snapd-snap-config.h>
 #include <snapd-glib/snapd-system-information.h>
+#include <snapd-glib/snapd-transport.h>
 #include <snapd-glib/snapd-change.h>
+#include <snapd-glib/snapd-notice.h>
+#include <snapd-glib/snapd-pending-request.h>
+#include <snapd-glib/snapd-request-timings.h>
+#include <snapd-glib/snapd-result-list.h>
 #include <snapd-glib/snapd-user-information.h>
 
 G_BEGIN_DECLS
@@ -91,6 +103,42 @@ typedef enum
     SNAPD_GET_APPS_FLAGS_SELECT_SERVICES = 1 << 0
 } SnapdGetAppsFlags;
 
+/**
+ * SnapdServiceAction:
+ * @SNAPD_SERVICE_ACTION_START: Start the services.
+ * @SNAPD_SERVICE_ACTION_STOP: Stop the services.
+ * @SNAPD_SERVICE_ACTION_RESTART: Restart the services.
+ *
+ * Action to apply to services.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_SERVICE_ACTION_START,
+    SNAPD_SERVICE_ACTION_STOP,
+    SNAPD_SERVICE_ACTION_RESTART
+} SnapdServiceAction;
+
+/**
+ * SnapdControlServicesFlags:
+ * @SNAPD_CONTROL_SERVICES_FLAGS_NONE: No flags, default behaviour.
+ * @SNAPD_CONTROL_SERVICES_FLAGS_ENABLE: Enable the services so they run on boot (start only).
+ * @SNAPD_CONTROL_SERVICES_FLAGS_DISABLE: Disable the services so they don't run on boot (stop only).
+ * @SNAPD_CONTROL_SERVICES_FLAGS_RELOAD: Reload the services if they support it instead of restarting them (restart only).
+ *
+ * Flags to control how services are changed.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_CONTROL_SERVICES_FLAGS_NONE    = 0,
+    SNAPD_CONTROL_SERVICES_FLAGS_ENABLE  = 1 << 0,
+    SNAPD_CONTROL_SERVICES_FLAGS_DISABLE = 1 << 1,
+    SNAPD_CONTROL_SERVICES_FLAGS_RELOAD  = 1 << 2
+} SnapdControlServicesFlags;
+
 /**
  * SnapdGetConnectionsFlags:
  * @SNAPD_GET_CONNECTIONS_FLAGS_NONE: No flags, default behaviour.
@@ -116,6 +164,9 @@ typedef enum
  * @SNAPD_FIND_FLAGS_SELECT_PRIVATE: Search private snaps.
  * @SNAPD_FIND_FLAGS_SELECT_REFRESH: Deprecated, do not use.
  * @SNAPD_FIND_FLAGS_SCOPE_WIDE: Search for snaps from any architecture or branch.
+ * @SNAPD_FIND_FLAGS_PARSE_DESCRIPTIONS: Parse the snap descriptions as markdown
+ *     along with the rest of the response, see snapd_snap_get_description_nodes().
+ *     (Since: 1.65)
  *
  * Flag to change how a find is performed.
  *
@@ -128,7 +179,8 @@ typedef enum
     SNAPD_FIND_FLAGS_SELECT_PRIVATE  = 1 << 1,
     SNAPD_FIND_FLAGS_SELECT_REFRESH  = 1 << 2,
     SNAPD_FIND_FLAGS_SCOPE_WIDE      = 1 << 3,
-    SNAPD_FIND_FLAGS_MATCH_COMMON_ID = 1 << 4
+    SNAPD_FIND_FLAGS_MATCH_COMMON_ID = 1 << 4,
+    SNAPD_FIND_FLAGS_PARSE_DESCRIPTIONS = 1 << 5
 } SnapdFindFlags;
 
 /**
@@ -224,6 +276,59 @@ typedef enum
     SNAPD_THEME_STATUS_UNAVAILABLE,
 } SnapdThemeStatus;
 
+/**
+ * SnapdRequestPriority:
+ * @SNAPD_REQUEST_PRIORITY_LOW: requests that can wait, e.g. background refreshes.
+ * @SNAPD_REQUEST_PRIORITY_NORMAL: the default priority.
+ * @SNAPD_REQUEST_PRIORITY_HIGH: requests that a user is waiting on.
+ *
+ * Priority used when choosing which queued request to send to snapd next.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_REQUEST_PRIORITY_LOW,
+    SNAPD_REQUEST_PRIORITY_NORMAL,
+    SNAPD_REQUEST_PRIORITY_HIGH,
+} SnapdRequestPriority;
+
+/**
+ * SnapdAliasAction:
+ * @SNAPD_ALIAS_ACTION_ALIAS: Create an alias to an app, as with snapd_client_alias_async().
+ * @SNAPD_ALIAS_ACTION_UNALIAS: Remove an alias, as with snapd_client_unalias_async().
+ * @SNAPD_ALIAS_ACTION_PREFER: Make the automatic aliases of a snap preferred, as with snapd_client_prefer_async().
+ *
+ * Change to make with snapd_client_set_aliases_async().
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_ALIAS_ACTION_ALIAS,
+    SNAPD_ALIAS_ACTION_UNALIAS,
+    SNAPD_ALIAS_ACTION_PREFER
+} SnapdAliasAction;
+
+/**
+ * SnapdAliasChange:
+ * @action: the change to make.
+ * @snap: (allow-none): the name of the snap to modify, required for %SNAPD_ALIAS_ACTION_ALIAS and %SNAPD_ALIAS_ACTION_PREFER.
+ * @app: (allow-none): the app to make the alias to, required for %SNAPD_ALIAS_ACTION_ALIAS.
+ * @alias: (allow-none): the name of the alias, required for %SNAPD_ALIAS_ACTION_ALIAS and %SNAPD_ALIAS_ACTION_UNALIAS.
+ *
+ * A single alias change made with snapd_client_set_aliases_async().
+ *
+ * Since: 1.65
+ */
+typedef struct
+{
+    SnapdAliasAction  action;
+    const gchar      *snap;
+    const gchar      *app;
+    const gchar      *alias;
+} SnapdAliasChange;
+
 /**
  * SnapdProgressCallback:
  * @client: a #SnapdClient
@@ -244,6 +349,111 @@ typedef enum
  */
 typedef void (*SnapdProgressCallback) (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data);
 
+/**
+ * SnapdProgressDeltaCallback:
+ * @client: a #SnapdClient
+ * @change: a #SnapdChange describing the change in progress
+ * @changed_tasks: (element-type SnapdTask): the tasks in @change that are new or have changed since the last report
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_set_progress_delta_callback().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdProgressDeltaCallback) (SnapdClient *client, SnapdChange *change, GPtrArray *changed_tasks, gpointer user_data);
+
+/**
+ * SnapdUploadProgressCallback:
+ * @client: a #SnapdClient
+ * @sent: number of bytes sent so far
+ * @total: number of bytes to send, or -1 if not known until the upload is complete
+ * @bytes_per_second: average rate the data has been sent at
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_set_upload_progress_callback().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdUploadProgressCallback) (SnapdClient *client, goffset sent, goffset total, goffset bytes_per_second, gpointer user_data);
+
+/**
+ * SnapdIconCallback:
+ * @client: a #SnapdClient
+ * @name: name of the snap the icon is for
+ * @icon: (allow-none): the icon or %NULL if it could not be retrieved
+ * @error: (allow-none): the reason the icon could not be retrieved or %NULL
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_get_icons_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdIconCallback) (SnapdClient *client, const gchar *name, SnapdIcon *icon, GError *error, gpointer user_data);
+
+/**
+ * SnapdDownloadProgressCallback:
+ * @client: a #SnapdClient
+ * @download: the #SnapdDownload that has progressed
+ * @downloaded: number of bytes downloaded for all the snaps
+ * @total: combined size of all the snaps
+ * @eta: estimated number of seconds until all the snaps are downloaded, or -1 if not yet known
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_download_many_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdDownloadProgressCallback) (SnapdClient *client, SnapdDownload *download, goffset downloaded, goffset total, gint64 eta, gpointer user_data);
+
+/**
+ * SnapdSnapCallback:
+ * @client: a #SnapdClient
+ * @snap: a #SnapdSnap from the response
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_find_stream_sync() and
+ * snapd_client_get_snaps_stream_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdSnapCallback) (SnapdClient *client, SnapdSnap *snap, gpointer user_data);
+
+/**
+ * SnapdChangeCallback:
+ * @client: a #SnapdClient
+ * @change: a #SnapdChange from the response
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_get_changes_stream_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdChangeCallback) (SnapdClient *client, SnapdChange *change, gpointer user_data);
+
+/**
+ * SnapdAssertionCallback:
+ * @client: a #SnapdClient
+ * @assertion: a #SnapdAssertion from the response
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_get_assertions_stream_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdAssertionCallback) (SnapdClient *client, SnapdAssertion *assertion, gpointer user_data);
+
+/**
+ * SnapdLogCallback:
+ * @client: a #SnapdClient
+ * @log: a #SnapdLog from the response
+ * @user_data: user data passed to the callback
+ *
+ * Signature for callback function used in snapd_client_follow_logs_sync().
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdLogCallback) (SnapdClient *client, SnapdLog *log, gpointer user_data);
+
 SnapdClient            *snapd_client_new                           (void);
 
 SnapdClient            *snapd_client_new_from_socket               (GSocket              *socket);
@@ -261,11 +471,27 @@ gboolean                snapd_client_connect_finish                (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error) G_DEPRECATED;
 
+gboolean                snapd_client_prepare_sync                  (SnapdClient          *client,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_prepare_async                 (SnapdClient          *client,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_prepare_finish                (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 void                    snapd_client_set_socket_path               (SnapdClient          *client,
                                                                     const gchar          *socket_path);
 
 const gchar            *snapd_client_get_socket_path               (SnapdClient          *client);
 
+void                    snapd_client_set_address                   (SnapdClient          *client,
+                                                                    GSocketAddress       *address);
+
+GSocketAddress         *snapd_client_get_address                   (SnapdClient          *client);
+
 void                    snapd_client_set_user_agent                (SnapdClient          *client,
                                                                     const gchar          *user_agent);
 
@@ -276,6 +502,230 @@ void                    snapd_client_set_allow_interaction         (SnapdClient
 
 gboolean                snapd_client_get_allow_interaction         (SnapdClient          *client);
 
+void                    snapd_client_set_max_read_size             (SnapdClient          *client,
+                                                                    gsize                 max_read_size);
+
+gsize                   snapd_client_get_max_read_size             (SnapdClient          *client);
+
+void                    snapd_client_set_use_buffer_pool           (SnapdClient          *client,
+                                                                    gboolean              use_buffer_pool);
+
+gboolean                snapd_client_get_use_buffer_pool           (SnapdClient          *client);
+
+void                    snapd_client_set_max_connections           (SnapdClient          *client,
+                                                                    guint                 max_connections);
+
+guint                   snapd_client_get_max_connections           (SnapdClient          *client);
+
+void                    snapd_client_set_transport                 (SnapdClient          *client,
+                                                                    SnapdTransport       *transport);
+
+SnapdTransport         *snapd_client_get_transport                 (SnapdClient          *client);
+
+void                    snapd_client_set_max_pipeline_depth        (SnapdClient          *client,
+                                                                    guint                 max_pipeline_depth);
+
+guint                   snapd_client_get_max_pipeline_depth        (SnapdClient          *client);
+
+void                    snapd_client_set_request_priority          (SnapdClient          *client,
+                                                                    SnapdRequestPriority  priority);
+
+SnapdRequestPriority    snapd_client_get_request_priority          (SnapdClient          *client);
+
+void                    snapd_client_set_request_timeout           (SnapdClient          *client,
+                                                                    guint                 timeout);
+
+guint                   snapd_client_get_request_timeout           (SnapdClient          *client);
+
+void                    snapd_client_set_connect_timeout           (SnapdClient          *client,
+                                                                    guint                 timeout);
+
+guint                   snapd_client_get_connect_timeout           (SnapdClient          *client);
+
+void                    snapd_client_set_resolve_cache_ttl         (SnapdClient          *client,
+                                                                    guint                 ttl);
+
+guint                   snapd_client_get_resolve_cache_ttl         (SnapdClient          *client);
+
+void                    snapd_client_set_request_deadline          (SnapdClient          *client,
+                                                                    gint64                deadline);
+
+gint64                  snapd_client_get_request_deadline          (SnapdClient          *client);
+
+SnapdRequestTimings    *snapd_client_get_request_timings           (SnapdClient          *client,
+                                                                    GAsyncResult         *result);
+
+GPtrArray              *snapd_client_get_pending_requests          (SnapdClient          *client);
+
+void                    snapd_client_set_slow_request_threshold    (SnapdClient          *client,
+                                                                    guint                 slow_request_threshold);
+
+guint                   snapd_client_get_slow_request_threshold    (SnapdClient          *client);
+
+void                    snapd_client_set_poll_interval             (SnapdClient          *client,
+                                                                    guint                 poll_interval);
+
+guint                   snapd_client_get_poll_interval             (SnapdClient          *client);
+
+void                    snapd_client_set_max_poll_interval         (SnapdClient          *client,
+                                                                    guint                 max_poll_interval);
+
+guint                   snapd_client_get_max_poll_interval         (SnapdClient          *client);
+
+void                    snapd_client_set_max_retries               (SnapdClient          *client,
+                                                                    guint                 max_retries);
+
+guint                   snapd_client_get_max_retries               (SnapdClient          *client);
+
+void                    snapd_client_set_retry_interval            (SnapdClient          *client,
+                                                                    guint                 retry_interval);
+
+guint                   snapd_client_get_retry_interval            (SnapdClient          *client);
+
+void                    snapd_client_set_max_retry_interval        (SnapdClient          *client,
+                                                                    guint                 max_retry_interval);
+
+guint                   snapd_client_get_max_retry_interval        (SnapdClient          *client);
+
+void                    snapd_client_set_watch_socket              (SnapdClient          *client,
+                                                                    gboolean              watch_socket);
+
+gboolean                snapd_client_get_watch_socket              (SnapdClient          *client);
+
+void                    snapd_client_set_progress_delta_callback   (SnapdClient          *client,
+                                                                    SnapdProgressDeltaCallback callback,
+                                                                    gpointer              user_data,
+                                                                    GDestroyNotify        destroy_notify);
+
+void                    snapd_client_set_upload_progress_callback  (SnapdClient          *client,
+                                                                    SnapdUploadProgressCallback callback,
+                                                                    gpointer              user_data,
+                                                                    GDestroyNotify        destroy_notify);
+
+void                    snapd_client_set_min_progress_interval     (SnapdClient          *client,
+                                                                    guint                 min_progress_interval);
+
+guint                   snapd_client_get_min_progress_interval     (SnapdClient          *client);
+
+void                    snapd_client_set_max_response_size         (SnapdClient          *client,
+                                                                    gsize                 max_response_size);
+
+gsize                   snapd_client_get_max_response_size         (SnapdClient          *client);
+
+void                    snapd_client_set_expect_continue_size      (SnapdClient          *client,
+                                                                    goffset               size);
+
+goffset                 snapd_client_get_expect_continue_size      (SnapdClient          *client);
+
+void                    snapd_client_set_batch_polls               (SnapdClient          *client,
+                                                                    gboolean              batch_polls);
+
+gboolean                snapd_client_get_batch_polls               (SnapdClient          *client);
+
+void                    snapd_client_set_background                (SnapdClient          *client,
+                                                                    gboolean              background);
+
+gboolean                snapd_client_get_background                (SnapdClient          *client);
+
+void                    snapd_client_set_use_notices               (SnapdClient          *client,
+                                                                    gboolean              use_notices);
+
+gboolean                snapd_client_get_use_notices               (SnapdClient          *client);
+
+void                    snapd_client_set_coalesce_requests         (SnapdClient          *client,
+                                                                    gboolean              coalesce_requests);
+
+gboolean                snapd_client_get_coalesce_requests         (SnapdClient          *client);
+
+void                    snapd_client_set_cache_ttl                 (SnapdClient          *client,
+                                                                    const gchar          *path,
+                                                                    guint                 ttl);
+
+guint                   snapd_client_get_cache_ttl                 (SnapdClient          *client,
+                                                                    const gchar          *path);
+
+void                    snapd_client_clear_cache                   (SnapdClient          *client);
+
+void                    snapd_client_set_snap_cache_ttl            (SnapdClient          *client,
+                                                                    guint                 ttl);
+
+guint                   snapd_client_get_snap_cache_ttl            (SnapdClient          *client);
+
+SnapdSnap              *snapd_client_get_cached_store_snap         (SnapdClient          *client,
+                                                                    const gchar          *name);
+
+guint                   snapd_client_get_cache_hits                (SnapdClient          *client);
+
+guint                   snapd_client_get_cache_misses              (SnapdClient          *client);
+
+GVariant               *snapd_client_get_statistics                (SnapdClient          *client);
+
+gboolean                snapd_client_start_capture                 (SnapdClient          *client,
+                                                                    const gchar          *path,
+                                                                    GError              **error);
+
+void                    snapd_client_stop_capture                  (SnapdClient          *client);
+
+void                    snapd_client_set_icon_cache_path           (SnapdClient          *client,
+                                                                    const gchar          *path);
+
+const gchar            *snapd_client_get_icon_cache_path           (SnapdClient          *client);
+
+void                    snapd_client_set_use_icon_cache            (SnapdClient          *client,
+                                                                    gboolean              use_icon_cache);
+
+void                    snapd_client_set_use_io_thread             (SnapdClient          *client,
+                                                                    gboolean              use_io_thread);
+
+gboolean                snapd_client_get_use_io_thread             (SnapdClient          *client);
+
+void                    snapd_client_set_io_context                (SnapdClient          *client,
+                                                                    GMainContext         *context);
+
+GMainContext           *snapd_client_get_io_context                (SnapdClient          *client);
+
+void                    snapd_client_set_parse_thread_threshold    (SnapdClient          *client,
+                                                                    gsize                 threshold);
+
+gsize                   snapd_client_get_parse_thread_threshold    (SnapdClient          *client);
+
+void                    snapd_client_set_lazy_parsing              (SnapdClient          *client,
+                                                                    gboolean              lazy_parsing);
+
+gboolean                snapd_client_get_lazy_parsing              (SnapdClient          *client);
+
+void                    snapd_client_set_share_snaps               (SnapdClient          *client,
+                                                                    gboolean              share_snaps);
+
+gboolean                snapd_client_get_share_snaps               (SnapdClient          *client);
+
+void                    snapd_client_set_track_memory              (SnapdClient          *client,
+                                                                    gboolean              track_memory);
+
+gboolean                snapd_client_get_track_memory              (SnapdClient          *client);
+
+gsize                   snapd_client_get_live_parsed_bytes         (SnapdClient          *client);
+
+void                    snapd_client_set_catalog_cache             (SnapdClient          *client,
+                                                                    SnapdCatalogCache    *cache);
+
+SnapdCatalogCache      *snapd_client_get_catalog_cache             (SnapdClient          *client);
+
+void                    snapd_client_set_download_cache            (SnapdClient          *client,
+                                                                    SnapdDownloadCache   *cache);
+
+SnapdDownloadCache     *snapd_client_get_download_cache            (SnapdClient          *client);
+
+void                    snapd_client_set_cache_manager             (SnapdClient          *client,
+                                                                    SnapdCacheManager    *manager);
+
+SnapdCacheManager      *snapd_client_get_cache_manager             (SnapdClient          *client);
+
+void                    snapd_client_set_cache_interface_docs      (SnapdClient          *client,
+                                                                    gboolean              cache_interface_docs);
+
+gboolean                snapd_client_get_cache_interface_docs      (SnapdClient          *client);
+
 SnapdMaintenance       *snapd_client_get_maintenance               (SnapdClient          *client);
 
 SnapdAuthData          *snapd_client_login_sync                    (SnapdClient          *client,
@@ -345,6 +795,32 @@ void                    snapd_client_get_changes_async             (SnapdClient
 GPtrArray              *snapd_client_get_changes_finish            (SnapdClient          *client,
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
+SnapdResultList        *snapd_client_get_changes_model_sync        (SnapdClient          *client,
+                                                                    SnapdChangeFilter     filter,
+                                                                    const gchar          *snap_name,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+SnapdResultList        *snapd_client_get_changes_model_finish      (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+gboolean                snapd_client_get_changes_stream_sync       (SnapdClient          *client,
+                                                                    SnapdChangeFilter     filter,
+                                                                    const gchar          *snap_name,
+                                                                    SnapdChangeCallback   change_callback,
+                                                                    gpointer              change_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_changes_stream_async      (SnapdClient          *client,
+                                                                    SnapdChangeFilter     filter,
+                                                                    const gchar          *snap_name,
+                                                                    SnapdChangeCallback   change_callback,
+                                                                    gpointer              change_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_get_changes_stream_finish     (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
 
 SnapdChange            *snapd_client_get_change_sync               (SnapdClient          *client,
                                                                     const gchar          *id,
@@ -361,6 +837,18 @@ SnapdChange            *snapd_client_get_change_finish             (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+void                    snapd_client_wait_change_async             (SnapdClient          *client,
+                                                                    const gchar          *id,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+
+SnapdChange            *snapd_client_wait_change_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 SnapdChange            *snapd_client_abort_change_sync             (SnapdClient          *client,
                                                                     const gchar          *id,
                                                                     GCancellable         *cancellable,
@@ -376,6 +864,23 @@ SnapdChange            *snapd_client_abort_change_finish           (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+GPtrArray              *snapd_client_get_notices_sync              (SnapdClient          *client,
+                                                                    GDateTime            *since_date_time,
+                                                                    guint                 timeout,
+                                                                    GCancellable         *cancellable,
+                                                                    GError             **error);
+
+void                    snapd_client_get_notices_async             (SnapdClient          *client,
+                                                                    GDateTime            *since_date_time,
+                                                                    guint                 timeout,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+
+GPtrArray              *snapd_client_get_notices_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 SnapdSystemInformation *snapd_client_get_system_information_sync   (SnapdClient          *client,
                                                                     GCancellable         *cancellable,
                                                                     GError              **error);
@@ -387,6 +892,9 @@ SnapdSystemInformation *snapd_client_get_system_information_finish (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+SnapdSystemInformation *snapd_client_get_system_information_cached (SnapdClient          *client,
+                                                                    GError              **error);
+
 GPtrArray              *snapd_client_list_sync                     (SnapdClient          *client,
                                                                     GCancellable         *cancellable,
                                                                     GError              **error) G_DEPRECATED_FOR(snapd_client_get_snaps_sync);
@@ -412,6 +920,48 @@ void                    snapd_client_get_snaps_async               (SnapdClient
 GPtrArray              *snapd_client_get_snaps_finish              (SnapdClient          *client,
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
+SnapdResultList        *snapd_client_get_snaps_model_sync          (SnapdClient          *client,
+                                                                    SnapdGetSnapsFlags    flags,
+                                                                    GStrv                 names,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+SnapdResultList        *snapd_client_get_snaps_model_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+GPtrArray              *snapd_client_get_snaps_with_fields_sync    (SnapdClient          *client,
+                                                                    SnapdGetSnapsFlags    flags,
+                                                                    GStrv                 names,
+                                                                    SnapdSnapFields       fields,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_snaps_with_fields_async   (SnapdClient          *client,
+                                                                    SnapdGetSnapsFlags    flags,
+                                                                    GStrv                 names,
+                                                                    SnapdSnapFields       fields,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_get_snaps_with_fields_finish  (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+gboolean                snapd_client_get_snaps_stream_sync         (SnapdClient          *client,
+                                                                    SnapdGetSnapsFlags    flags,
+                                                                    GStrv                 names,
+                                                                    SnapdSnapCallback     snap_callback,
+                                                                    gpointer              snap_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_snaps_stream_async        (SnapdClient          *client,
+                                                                    SnapdGetSnapsFlags    flags,
+                                                                    GStrv                 names,
+                                                                    SnapdSnapCallback     snap_callback,
+                                                                    gpointer              snap_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_get_snaps_stream_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
 
 SnapdSnap              *snapd_client_list_one_sync                 (SnapdClient          *client,
                                                                     const gchar          *name,
@@ -469,6 +1019,64 @@ gboolean                snapd_client_set_snap_conf_finish          (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+SnapdSnapConfig        *snapd_client_get_snap_config_sync          (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    GStrv                 keys,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_snap_config_async         (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    GStrv                 keys,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+SnapdSnapConfig        *snapd_client_get_snap_config_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+GHashTable             *snapd_client_get_snap_configs_sync         (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    GStrv                 keys,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_snap_configs_async        (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    GStrv                 keys,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GHashTable             *snapd_client_get_snap_configs_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_update_snap_conf_sync         (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    GHashTable           *key_values,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_update_snap_conf_async        (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    GHashTable           *key_values,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_update_snap_conf_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_update_snap_confs_sync        (SnapdClient          *client,
+                                                                    GHashTable           *confs,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_update_snap_confs_async       (SnapdClient          *client,
+                                                                    GHashTable           *confs,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_update_snap_confs_finish      (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 GPtrArray              *snapd_client_get_apps_sync                 (SnapdClient          *client,
                                                                     SnapdGetAppsFlags     flags,
                                                                     GCancellable         *cancellable,
@@ -496,6 +1104,69 @@ void                    snapd_client_get_apps2_async               (SnapdClient
 GPtrArray              *snapd_client_get_apps2_finish              (SnapdClient          *client,
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
+SnapdResultList        *snapd_client_get_apps2_model_sync          (SnapdClient          *client,
+                                                                    SnapdGetAppsFlags     flags,
+                                                                    GStrv                 snaps,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+SnapdResultList        *snapd_client_get_apps2_model_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+GPtrArray              *snapd_client_control_services_sync         (SnapdClient          *client,
+                                                                    SnapdServiceAction    action,
+                                                                    SnapdControlServicesFlags flags,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_control_services_async        (SnapdClient          *client,
+                                                                    SnapdServiceAction    action,
+                                                                    SnapdControlServicesFlags flags,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_control_services_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+GPtrArray              *snapd_client_get_logs_sync                 (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    gint                  n,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_logs_async                (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    gint                  n,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_get_logs_finish               (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_follow_logs_sync              (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    gint                  n,
+                                                                    SnapdLogCallback      log_callback,
+                                                                    gpointer              log_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_follow_logs_async             (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    gint                  n,
+                                                                    SnapdLogCallback      log_callback,
+                                                                    gpointer              log_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_follow_logs_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
 
 SnapdIcon              *snapd_client_get_icon_sync                 (SnapdClient          *client,
                                                                     const gchar          *name,
@@ -510,6 +1181,40 @@ SnapdIcon              *snapd_client_get_icon_finish               (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+gboolean                snapd_client_get_icons_sync                (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    guint                 max_parallel,
+                                                                    SnapdIconCallback     icon_callback,
+                                                                    gpointer              icon_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_icons_async               (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    guint                 max_parallel,
+                                                                    SnapdIconCallback     icon_callback,
+                                                                    gpointer              icon_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_get_icons_finish              (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+SnapdIcon              *snapd_client_get_icon2_sync                (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *revision,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_icon2_async               (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *revision,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+SnapdIcon              *snapd_client_get_icon2_finish              (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 GStrv                   snapd_client_get_assertions_sync           (SnapdClient          *client,
                                                                     const gchar          *type,
                                                                     GCancellable         *cancellable,
@@ -523,6 +1228,36 @@ GStrv                   snapd_client_get_assertions_finish         (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+GPtrArray              *snapd_client_get_assertions_bytes_sync     (SnapdClient          *client,
+                                                                    const gchar          *type,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_assertions_bytes_async    (SnapdClient          *client,
+                                                                    const gchar          *type,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_get_assertions_bytes_finish   (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_get_assertions_stream_sync    (SnapdClient          *client,
+                                                                    const gchar          *type,
+                                                                    SnapdAssertionCallback assertion_callback,
+                                                                    gpointer              assertion_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_get_assertions_stream_async   (SnapdClient          *client,
+                                                                    const gchar          *type,
+                                                                    SnapdAssertionCallback assertion_callback,
+                                                                    gpointer              assertion_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_get_assertions_stream_finish  (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_add_assertions_sync           (SnapdClient          *client,
                                                                     GStrv                 assertions,
                                                                     GCancellable         *cancellable,
@@ -536,6 +1271,19 @@ gboolean                snapd_client_add_assertions_finish         (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+gboolean                snapd_client_add_assertions_stream_sync    (SnapdClient          *client,
+                                                                    GInputStream         *stream,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_add_assertions_stream_async   (SnapdClient          *client,
+                                                                    GInputStream         *stream,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_add_assertions_stream_finish  (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_get_interfaces_sync           (SnapdClient          *client,
                                                                     GPtrArray           **plugs,
                                                                     GPtrArray           **slots,
@@ -652,7 +1400,45 @@ void                    snapd_client_disconnect_interface_async    (SnapdClient
                                                                     GCancellable         *cancellable,
                                                                     GAsyncReadyCallback   callback,
                                                                     gpointer              user_data);
-gboolean               snapd_client_disconnect_interface_finish    (SnapdClient          *client,
+gboolean               snapd_client_disconnect_interface_finish    (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_connect_interfaces_sync       (SnapdClient          *client,
+                                                                    GPtrArray            *plugs,
+                                                                    GPtrArray            *slots,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_connect_interfaces_async      (SnapdClient          *client,
+                                                                    GPtrArray            *plugs,
+                                                                    GPtrArray            *slots,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_connect_interfaces_finish     (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_disconnect_interfaces_sync    (SnapdClient          *client,
+                                                                    GPtrArray            *plugs,
+                                                                    GPtrArray            *slots,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_disconnect_interfaces_async   (SnapdClient          *client,
+                                                                    GPtrArray            *plugs,
+                                                                    GPtrArray            *slots,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_disconnect_interfaces_finish  (SnapdClient          *client,
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
@@ -691,6 +1477,118 @@ GPtrArray              *snapd_client_find_section_finish           (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     gchar               **suggested_currency,
                                                                     GError              **error);
+SnapdResultList        *snapd_client_find_section_model_sync       (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    gchar               **suggested_currency,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+SnapdResultList        *snapd_client_find_model_finish             (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+GPtrArray              *snapd_client_find_with_fields_sync         (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    SnapdSnapFields       fields,
+                                                                    gchar               **suggested_currency,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_find_with_fields_async        (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    SnapdSnapFields       fields,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_find_with_fields_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+GPtrArray              *snapd_client_find_page_sync                (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    guint                 offset,
+                                                                    guint                 limit,
+                                                                    guint                *total,
+                                                                    gchar               **suggested_currency,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_find_page_async               (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    guint                 offset,
+                                                                    guint                 limit,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_find_page_finish              (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    guint                *total,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+void                    snapd_client_find_superseding_async        (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    const gchar          *supersede_key,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GPtrArray              *snapd_client_find_superseding_finish       (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+GPtrArray              *snapd_client_find_cached                   (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+gboolean                snapd_client_find_stream_sync              (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    SnapdSnapCallback     snap_callback,
+                                                                    gpointer              snap_callback_data,
+                                                                    gchar               **suggested_currency,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_find_stream_async             (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    const gchar          *section,
+                                                                    const gchar          *query,
+                                                                    SnapdSnapCallback     snap_callback,
+                                                                    gpointer              snap_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_find_stream_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    gchar               **suggested_currency,
+                                                                    GError              **error);
+
+GHashTable             *snapd_client_resolve_snaps_sync            (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    GStrv                 ids,
+                                                                    guint                 max_parallel,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_resolve_snaps_async           (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    GStrv                 ids,
+                                                                    guint                 max_parallel,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GHashTable             *snapd_client_resolve_snaps_finish          (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
 
 GPtrArray              *snapd_client_find_refreshable_sync         (SnapdClient          *client,
                                                                     GCancellable         *cancellable,
@@ -745,6 +1643,23 @@ gboolean                snapd_client_install2_finish               (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+GStrv                   snapd_client_install_many_sync             (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_install_many_async            (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GStrv                   snapd_client_install_many_finish           (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_install_stream_sync           (SnapdClient          *client,
                                                                     SnapdInstallFlags     flags,
                                                                     GInputStream         *stream,
@@ -764,6 +1679,44 @@ gboolean                snapd_client_install_stream_finish         (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+gboolean                snapd_client_install_fd_sync               (SnapdClient          *client,
+                                                                    SnapdInstallFlags     flags,
+                                                                    int                   fd,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_install_fd_async              (SnapdClient          *client,
+                                                                    SnapdInstallFlags     flags,
+                                                                    int                   fd,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_install_fd_finish             (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_install_path_sync             (SnapdClient          *client,
+                                                                    SnapdInstallFlags     flags,
+                                                                    const gchar          *path,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_install_path_async            (SnapdClient          *client,
+                                                                    SnapdInstallFlags     flags,
+                                                                    const gchar          *path,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_install_path_finish           (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_try_sync                      (SnapdClient          *client,
                                                                     const gchar          *path,
                                                                     SnapdProgressCallback progress_callback,
@@ -815,6 +1768,23 @@ GStrv                   snapd_client_refresh_all_finish            (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+GStrv                   snapd_client_refresh_many_sync             (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_refresh_many_async            (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GStrv                   snapd_client_refresh_many_finish           (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_remove_sync                   (SnapdClient          *client,
                                                                     const gchar          *name,
                                                                     SnapdProgressCallback progress_callback,
@@ -851,6 +1821,23 @@ gboolean                snapd_client_remove2_finish                (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+GStrv                   snapd_client_remove_many_sync              (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_remove_many_async             (SnapdClient          *client,
+                                                                    GStrv                 names,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GStrv                   snapd_client_remove_many_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_enable_sync                   (SnapdClient          *client,
                                                                     const gchar          *name,
                                                                     SnapdProgressCallback progress_callback,
@@ -979,6 +1966,25 @@ void                    snapd_client_get_sections_async            (SnapdClient
 GStrv                   snapd_client_get_sections_finish           (SnapdClient          *client,
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
+GStrv                   snapd_client_get_sections_cached           (SnapdClient          *client,
+                                                                    GError              **error);
+
+GHashTable             *snapd_client_prefetch_sections_sync        (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    GStrv                 sections,
+                                                                    guint                 max_parallel,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_prefetch_sections_async       (SnapdClient          *client,
+                                                                    SnapdFindFlags        flags,
+                                                                    GStrv                 sections,
+                                                                    guint                 max_parallel,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+GHashTable             *snapd_client_prefetch_sections_finish      (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
 
 GPtrArray              *snapd_client_get_aliases_sync              (SnapdClient          *client,
                                                                     GCancellable         *cancellable,
@@ -1048,6 +2054,25 @@ gboolean                snapd_client_prefer_finish                 (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+gboolean                snapd_client_set_aliases_sync              (SnapdClient          *client,
+                                                                    const SnapdAliasChange *changes,
+                                                                    gsize                 n_changes,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_set_aliases_async             (SnapdClient          *client,
+                                                                    const SnapdAliasChange *changes,
+                                                                    gsize                 n_changes,
+                                                                    SnapdProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_set_aliases_finish            (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
 gboolean                snapd_client_enable_aliases_sync           (SnapdClient          *client,
                                                                     const gchar          *snap,
                                                                     GStrv                 aliases,
@@ -1161,6 +2186,149 @@ GBytes                 *snapd_client_download_finish               (SnapdClient
                                                                     GAsyncResult         *result,
                                                                     GError              **error);
 
+gboolean                snapd_client_download_to_stream_sync       (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_download_to_stream_async      (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_download_to_stream_finish     (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_download_peek_sync            (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    goffset              *size,
+                                                                    gchar               **sha3_384,
+                                                                    gchar               **resume_token,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_download_peek_async           (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_download_peek_finish          (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    goffset              *size,
+                                                                    gchar               **sha3_384,
+                                                                    gchar               **resume_token,
+                                                                    GError              **error);
+
+gboolean                snapd_client_download_resume_sync          (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    const gchar          *resume_token,
+                                                                    goffset               offset,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_download_resume_async         (SnapdClient          *client,
+                                                                    const gchar          *name,
+                                                                    const gchar          *channel,
+                                                                    const gchar          *revision,
+                                                                    const gchar          *resume_token,
+                                                                    goffset               offset,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_download_resume_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_download_many_sync            (SnapdClient          *client,
+                                                                    GPtrArray            *downloads,
+                                                                    guint                 max_parallel,
+                                                                    goffset               max_bytes_per_second,
+                                                                    SnapdDownloadProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_download_many_async           (SnapdClient          *client,
+                                                                    GPtrArray            *downloads,
+                                                                    guint                 max_parallel,
+                                                                    goffset               max_bytes_per_second,
+                                                                    SnapdDownloadProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_download_many_finish          (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_export_snapshot_sync          (SnapdClient          *client,
+                                                                    gint64                set_id,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_export_snapshot_async         (SnapdClient          *client,
+                                                                    gint64                set_id,
+                                                                    GOutputStream        *stream,
+                                                                    GFileProgressCallback progress_callback,
+                                                                    gpointer              progress_callback_data,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_export_snapshot_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    GError              **error);
+
+gboolean                snapd_client_import_snapshot_sync          (SnapdClient          *client,
+                                                                    GInputStream         *stream,
+                                                                    goffset               size,
+                                                                    gint64               *set_id,
+                                                                    GStrv                *snaps,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_import_snapshot_async         (SnapdClient          *client,
+                                                                    GInputStream         *stream,
+                                                                    goffset               size,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_import_snapshot_fd_sync       (SnapdClient          *client,
+                                                                    int                   fd,
+                                                                    gint64               *set_id,
+                                                                    GStrv                *snaps,
+                                                                    GCancellable         *cancellable,
+                                                                    GError              **error);
+void                    snapd_client_import_snapshot_fd_async      (SnapdClient          *client,
+                                                                    int                   fd,
+                                                                    GCancellable         *cancellable,
+                                                                    GAsyncReadyCallback   callback,
+                                                                    gpointer              user_data);
+gboolean                snapd_client_import_snapshot_finish        (SnapdClient          *client,
+                                                                    GAsyncResult         *result,
+                                                                    gint64               *set_id,
+                                                                    GStrv                *snaps,
+                                                                    GError              **error);
+
 gboolean                snapd_client_check_themes_sync             (SnapdClient          *client,
                                                                     GStrv                 gtk_theme_names,
                                                                     GStrv                 icon_theme_names,
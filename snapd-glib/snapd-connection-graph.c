@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-connection-graph.h"
+
+/**
+ * SECTION: snapd-connection-graph
+ * @short_description: Indexed interface connections
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdConnectionGraph indexes the results of
+ * snapd_client_get_connections2_sync() so questions like "what is connected
+ * to this slot" or "which snaps plug into the camera interface" are answered
+ * without scanning every connection.
+ *
+ * The graph is filled with snapd_connection_graph_update() and can be kept up
+ * to date after snapd_client_connect_interface_sync() and
+ * snapd_client_disconnect_interface_sync() complete using
+ * snapd_connection_graph_connect() and snapd_connection_graph_disconnect()
+ * rather than getting all the connections again. The connected plugs and
+ * slots reported by the #SnapdPlug and #SnapdSlot objects are not updated by
+ * these.
+ *
+ * Arrays returned by the graph are owned by it and are only valid until it
+ * is next changed.
+ *
+ * The graph is not thread safe and should only be used from one thread.
+ */
+
+/**
+ * SnapdConnectionGraph:
+ *
+ * #SnapdConnectionGraph is an index over interface connections.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdConnectionGraph
+{
+    GObject parent_instance;
+
+    /* Connections keyed by "plug-snap:plug slot-snap:slot" */
+    GHashTable *connections;
+
+    /* Arrays of connections keyed by "snap:plug", "snap:slot", snap name and interface */
+    GHashTable *connections_by_plug;
+    GHashTable *connections_by_slot;
+    GHashTable *connections_by_snap;
+    GHashTable *connections_by_interface;
+
+    /* Plugs and slots keyed by "snap:name", and arrays of them keyed by interface */
+    GHashTable *plugs;
+    GHashTable *slots;
+    GHashTable *plugs_by_interface;
+    GHashTable *slots_by_interface;
+
+    /* Returned when nothing matches */
+    GPtrArray *empty;
+};
+
+G_DEFINE_TYPE (SnapdConnectionGraph, snapd_connection_graph, G_TYPE_OBJECT)
+
+static gchar *
+make_key (const gchar *snap, const gchar *name)
+{
+    return g_strdup_printf ("%s:%s", snap, name);
+}
+
+static gchar *
+make_connection_key (const gchar *plug_snap, const gchar *plug_name, const gchar *slot_snap, const gchar *slot_name)
+{
+    return g_strdup_printf ("%s:%s %s:%s", plug_snap, plug_name, slot_snap, slot_name);
+}
+
+static GHashTable *
+index_new (void)
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+}
+
+static void
+index_add (GHashTable *index, const gchar *key, gpointer object)
+{
+    if (key == NULL)
+        return;
+
+    GPtrArray *objects = g_hash_table_lookup (index, key);
+    if (objects == NULL) {
+        objects = g_ptr_array_new_with_free_func (g_object_unref);
+        g_hash_table_insert (index, g_strdup (key), objects);
+    }
+    g_ptr_array_add (objects, g_object_ref (object));
+}
+
+static void
+index_remove (GHashTable *index, const gchar *key, gpointer object)
+{
+    if (key == NULL)
+        return;
+
+    GPtrArray *objects = g_hash_table_lookup (index, key);
+    if (objects == NULL)
+        return;
+    g_ptr_array_remove (objects, object);
+    if (objects->len == 0)
+        g_hash_table_remove (index, key);
+}
+
+static GPtrArray *
+index_lookup (SnapdConnectionGraph *self, GHashTable *index, const gchar *key)
+{
+    GPtrArray *objects = key != NULL ? g_hash_table_lookup (index, key) : NULL;
+    return objects != NULL ? objects : self->empty;
+}
+
+static void
+add_connection (SnapdConnectionGraph *self, SnapdConnection *connection)
+{
+    SnapdPlugRef *plug = snapd_connection_get_plug (connection);
+    SnapdSlotRef *slot = snapd_connection_get_slot (connection);
+    if (plug == NULL || slot == NULL)
+        return;
+
+    const gchar *plug_snap = snapd_plug_ref_get_snap (plug);
+    const gchar *slot_snap = snapd_slot_ref_get_snap (slot);
+    g_autofree gchar *plug_key = make_key (plug_snap, snapd_plug_ref_get_plug (plug));
+    g_autofree gchar *slot_key = make_key (slot_snap, snapd_slot_ref_get_slot (slot));
+    g_autofree gchar *key = make_connection_key (plug_snap, snapd_plug_ref_get_plug (plug), slot_snap, snapd_slot_ref_get_slot (slot));
+    if (g_hash_table_contains (self->connections, key))
+        return;
+
+    g_hash_table_insert (self->connections, g_steal_pointer (&key), g_object_ref (connection));
+    index_add (self->connections_by_plug, plug_key, connection);
+    index_add (self->connections_by_slot, slot_key, connection);
+    index_add (self->connections_by_snap, plug_snap, connection);
+    if (g_strcmp0 (plug_snap, slot_snap) != 0)
+        index_add (self->connections_by_snap, slot_snap, connection);
+    index_add (self->connections_by_interface, snapd_connection_get_interface (connection), connection);
+}
+
+static void
+remove_connection (SnapdConnectionGraph *self, SnapdConnection *connection)
+{
+    SnapdPlugRef *plug = snapd_connection_get_plug (connection);
+    SnapdSlotRef *slot = snapd_connection_get_slot (connection);
+    const gchar *plug_snap = snapd_plug_ref_get_snap (plug);
+    const gchar *slot_snap = snapd_slot_ref_get_snap (slot);
+    g_autofree gchar *plug_key = make_key (plug_snap, snapd_plug_ref_get_plug (plug));
+    g_autofree gchar *slot_key = make_key (slot_snap, snapd_slot_ref_get_slot (slot));
+    g_autofree gchar *key = make_connection_key (plug_snap, snapd_plug_ref_get_plug (plug), slot_snap, snapd_slot_ref_get_slot (slot));
+
+    index_remove (self->connections_by_plug, plug_key, connection);
+    index_remove (self->connections_by_slot, slot_key, connection);
+    index_remove (self->connections_by_snap, plug_snap, connection);
+    if (g_strcmp0 (plug_snap, slot_snap) != 0)
+        index_remove (self->connections_by_snap, slot_snap, connection);
+    index_remove (self->connections_by_interface, snapd_connection_get_interface (connection), connection);
+
+    /* Removed last as this may hold the final reference */
+    g_hash_table_remove (self->connections, key);
+}
+
+/**
+ * snapd_connection_graph_new:
+ *
+ * Create a new empty connection graph.
+ *
+ * Returns: a new #SnapdConnectionGraph
+ *
+ * Since: 1.65
+ */
+SnapdConnectionGraph *
+snapd_connection_graph_new (void)
+{
+    return g_object_new (SNAPD_TYPE_CONNECTION_GRAPH, NULL);
+}
+
+/**
+ * snapd_connection_graph_update:
+ * @graph: a #SnapdConnectionGraph.
+ * @established: (element-type SnapdConnection): connections, as returned by snapd_client_get_connections2_sync().
+ * @plugs: (allow-none) (element-type SnapdPlug): plugs, as returned by snapd_client_get_connections2_sync().
+ * @slots: (allow-none) (element-type SnapdSlot): slots, as returned by snapd_client_get_connections2_sync().
+ *
+ * Replace the contents of the graph.
+ *
+ * Since: 1.65
+ */
+void
+snapd_connection_graph_update (SnapdConnectionGraph *self, GPtrArray *established, GPtrArray *plugs, GPtrArray *slots)
+{
+    g_return_if_fail (SNAPD_IS_CONNECTION_GRAPH (self));
+    g_return_if_fail (established != NULL);
+
+    g_hash_table_remove_all (self->connections);
+    g_hash_table_remove_all (self->connections_by_plug);
+    g_hash_table_remove_all (self->connections_by_slot);
+    g_hash_table_remove_all (self->connections_by_snap);
+    g_hash_table_remove_all (self->connections_by_interface);
+    g_hash_table_remove_all (self->plugs);
+    g_hash_table_remove_all (self->slots);
+    g_hash_table_remove_all (self->plugs_by_interface);
+    g_hash_table_remove_all (self->slots_by_interface);
+
+    for (guint i = 0; plugs != NULL && i < plugs->len; i++) {
+        SnapdPlug *plug = g_ptr_array_index (plugs, i);
+        g_hash_table_insert (self->plugs, make_key (snapd_plug_get_snap (plug), snapd_plug_get_name (plug)), g_object_ref (plug));
+        index_add (self->plugs_by_interface, snapd_plug_get_interface (plug), plug);
+    }
+    for (guint i = 0; slots != NULL && i < slots->len; i++) {
+        SnapdSlot *slot = g_ptr_array_index (slots, i);
+        g_hash_table_insert (self->slots, make_key (snapd_slot_get_snap (slot), snapd_slot_get_name (slot)), g_object_ref (slot));
+        index_add (self->slots_by_interface, snapd_slot_get_interface (slot), slot);
+    }
+    for (guint i = 0; i < established->len; i++)
+        add_connection (self, g_ptr_array_index (established, i));
+}
+
+typedef GStrv (*GetAttributeNamesFunc) (gpointer object, guint *length);
+typedef GVariant *(*GetAttributeFunc) (gpointer object, const gchar *name);
+
+static GHashTable *
+copy_attributes (gpointer object, GetAttributeNamesFunc get_names, GetAttributeFunc get_attribute)
+{
+    GHashTable *attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    if (object == NULL)
+        return attributes;
+
+    g_auto(GStrv) names = get_names (object, NULL);
+    for (gsize i = 0; names[i] != NULL; i++)
+        g_hash_table_insert (attributes, g_strdup (names[i]), g_variant_ref (get_attribute (object, names[i])));
+
+    return attributes;
+}
+
+/**
+ * snapd_connection_graph_connect:
+ * @graph: a #SnapdConnectionGraph.
+ * @plug_snap: name of snap containing plug.
+ * @plug_name: name of plug.
+ * @slot_snap: name of snap containing slot.
+ * @slot_name: name of slot.
+ *
+ * Add a manual connection, as made by a successful
+ * snapd_client_connect_interface_sync() with the same arguments. The
+ * connection has the attributes of the plug and slot, if they are in the
+ * graph.
+ *
+ * Since: 1.65
+ */
+void
+snapd_connection_graph_connect (SnapdConnectionGraph *self,
+                                const gchar *plug_snap, const gchar *plug_name,
+                                const gchar *slot_snap, const gchar *slot_name)
+{
+    g_return_if_fail (SNAPD_IS_CONNECTION_GRAPH (self));
+    g_return_if_fail (plug_snap != NULL && plug_name != NULL);
+    g_return_if_fail (slot_snap != NULL && slot_name != NULL);
+
+    g_autofree gchar *key = make_connection_key (plug_snap, plug_name, slot_snap, slot_name);
+    if (g_hash_table_contains (self->connections, key))
+        return;
+
+    SnapdPlug *plug = snapd_connection_graph_lookup_plug (self, plug_snap, plug_name);
+    SnapdSlot *slot = snapd_connection_graph_lookup_slot (self, slot_snap, slot_name);
+    const gchar *interface = NULL;
+    if (plug != NULL)
+        interface = snapd_plug_get_interface (plug);
+    else if (slot != NULL)
+        interface = snapd_slot_get_interface (slot);
+
+    g_autoptr(SnapdPlugRef) plug_ref = g_object_new (SNAPD_TYPE_PLUG_REF, "snap", plug_snap, "plug", plug_name, NULL);
+    g_autoptr(SnapdSlotRef) slot_ref = g_object_new (SNAPD_TYPE_SLOT_REF, "snap", slot_snap, "slot", slot_name, NULL);
+    g_autoptr(GHashTable) plug_attributes = copy_attributes (plug, (GetAttributeNamesFunc) snapd_plug_get_attribute_names, (GetAttributeFunc) snapd_plug_get_attribute);
+    g_autoptr(GHashTable) slot_attributes = copy_attributes (slot, (GetAttributeNamesFunc) snapd_slot_get_attribute_names, (GetAttributeFunc) snapd_slot_get_attribute);
+    g_autoptr(SnapdConnection) connection = g_object_new (SNAPD_TYPE_CONNECTION,
+                                                          "plug", plug_ref,
+                                                          "slot", slot_ref,
+                                                          "interface", interface,
+                                                          "manual", TRUE,
+                                                          "plug-attrs", plug_attributes,
+                                                          "slot-attrs", slot_attributes,
+                                                          NULL);
+    add_connection (self, connection);
+}
+
+/**
+ * snapd_connection_graph_disconnect:
+ * @graph: a #SnapdConnectionGraph.
+ * @plug_snap: (allow-none): name of snap containing plug.
+ * @plug_name: (allow-none): name of plug.
+ * @slot_snap: (allow-none): name of snap containing slot.
+ * @slot_name: (allow-none): name of slot.
+ *
+ * Remove a connection, as done by a successful
+ * snapd_client_disconnect_interface_sync() with the same arguments. As with
+ * snapd, if the slot is %NULL all connections to the plug are removed and if
+ * the plug is %NULL all connections to the slot are removed.
+ *
+ * Since: 1.65
+ */
+void
+snapd_connection_graph_disconnect (SnapdConnectionGraph *self,
+                                   const gchar *plug_snap, const gchar *plug_name,
+                                   const gchar *slot_snap, const gchar *slot_name)
+{
+    g_return_if_fail (SNAPD_IS_CONNECTION_GRAPH (self));
+
+    g_autoptr(GPtrArray) connections = NULL;
+    if (slot_snap == NULL || slot_name == NULL)
+        connections = g_ptr_array_ref (snapd_connection_graph_get_plug_connections (self, plug_snap, plug_name));
+    else if (plug_snap == NULL || plug_name == NULL)
+        connections = g_ptr_array_ref (snapd_connection_graph_get_slot_connections (self, slot_snap, slot_name));
+    else {
+        g_autofree gchar *key = make_connection_key (plug_snap, plug_name, slot_snap, slot_name);
+        SnapdConnection *connection = g_hash_table_lookup (self->connections, key);
+        if (connection != NULL)
+            remove_connection (self, connection);
+        return;
+    }
+
+    /* Copy, as the index is changed while removing */
+    g_autoptr(GPtrArray) to_remove = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; i < connections->len; i++)
+        g_ptr_array_add (to_remove, g_object_ref (g_ptr_array_index (connections, i)));
+    for (guint i = 0; i < to_remove->len; i++)
+        remove_connection (self, g_ptr_array_index (to_remove, i));
+}
+
+/**
+ * snapd_connection_graph_get_n_connections:
+ * @graph: a #SnapdConnectionGraph.
+ *
+ * Get the number of connections in the graph.
+ *
+ * Returns: the number of connections.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_connection_graph_get_n_connections (SnapdConnectionGraph *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), 0);
+    return g_hash_table_size (self->connections);
+}
+
+/**
+ * snapd_connection_graph_lookup_plug:
+ * @graph: a #SnapdConnectionGraph.
+ * @snap: name of snap containing plug.
+ * @name: name of plug.
+ *
+ * Get a plug in the graph.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdPlug or %NULL if not present.
+ *
+ * Since: 1.65
+ */
+SnapdPlug *
+snapd_connection_graph_lookup_plug (SnapdConnectionGraph *self, const gchar *snap, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    g_return_val_if_fail (snap != NULL && name != NULL, NULL);
+
+    g_autofree gchar *key = make_key (snap, name);
+    return g_hash_table_lookup (self->plugs, key);
+}
+
+/**
+ * snapd_connection_graph_lookup_slot:
+ * @graph: a #SnapdConnectionGraph.
+ * @snap: name of snap containing slot.
+ * @name: name of slot.
+ *
+ * Get a slot in the graph.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdSlot or %NULL if not present.
+ *
+ * Since: 1.65
+ */
+SnapdSlot *
+snapd_connection_graph_lookup_slot (SnapdConnectionGraph *self, const gchar *snap, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    g_return_val_if_fail (snap != NULL && name != NULL, NULL);
+
+    g_autofree gchar *key = make_key (snap, name);
+    return g_hash_table_lookup (self->slots, key);
+}
+
+/**
+ * snapd_connection_graph_get_plug_connections:
+ * @graph: a #SnapdConnectionGraph.
+ * @snap: name of snap containing plug.
+ * @name: name of plug.
+ *
+ * Get the connections to a plug.
+ *
+ * Returns: (transfer none) (element-type SnapdConnection): an array of #SnapdConnection.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_plug_connections (SnapdConnectionGraph *self, const gchar *snap, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+
+    g_autofree gchar *key = snap != NULL && name != NULL ? make_key (snap, name) : NULL;
+    return index_lookup (self, self->connections_by_plug, key);
+}
+
+/**
+ * snapd_connection_graph_get_slot_connections:
+ * @graph: a #SnapdConnectionGraph.
+ * @snap: name of snap containing slot.
+ * @name: name of slot.
+ *
+ * Get the connections to a slot.
+ *
+ * Returns: (transfer none) (element-type SnapdConnection): an array of #SnapdConnection.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_slot_connections (SnapdConnectionGraph *self, const gchar *snap, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+
+    g_autofree gchar *key = snap != NULL && name != NULL ? make_key (snap, name) : NULL;
+    return index_lookup (self, self->connections_by_slot, key);
+}
+
+/**
+ * snapd_connection_graph_get_snap_connections:
+ * @graph: a #SnapdConnectionGraph.
+ * @snap: a snap name.
+ *
+ * Get the connections to the plugs and slots of a snap.
+ *
+ * Returns: (transfer none) (element-type SnapdConnection): an array of #SnapdConnection.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_snap_connections (SnapdConnectionGraph *self, const gchar *snap)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    return index_lookup (self, self->connections_by_snap, snap);
+}
+
+/**
+ * snapd_connection_graph_get_interface_connections:
+ * @graph: a #SnapdConnectionGraph.
+ * @interface: an interface name, e.g. "camera".
+ *
+ * Get the connections using an interface.
+ *
+ * Returns: (transfer none) (element-type SnapdConnection): an array of #SnapdConnection.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_interface_connections (SnapdConnectionGraph *self, const gchar *interface)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    return index_lookup (self, self->connections_by_interface, interface);
+}
+
+/**
+ * snapd_connection_graph_get_interface_plugs:
+ * @graph: a #SnapdConnectionGraph.
+ * @interface: an interface name, e.g. "camera".
+ *
+ * Get the plugs for an interface, whether connected or not.
+ *
+ * Returns: (transfer none) (element-type SnapdPlug): an array of #SnapdPlug.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_interface_plugs (SnapdConnectionGraph *self, const gchar *interface)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    return index_lookup (self, self->plugs_by_interface, interface);
+}
+
+/**
+ * snapd_connection_graph_get_interface_slots:
+ * @graph: a #SnapdConnectionGraph.
+ * @interface: an interface name, e.g. "camera".
+ *
+ * Get the slots for an interface, whether connected or not.
+ *
+ * Returns: (transfer none) (element-type SnapdSlot): an array of #SnapdSlot.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_connection_graph_get_interface_slots (SnapdConnectionGraph *self, const gchar *interface)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION_GRAPH (self), NULL);
+    return index_lookup (self, self->slots_by_interface, interface);
+}
+
+static void
+snapd_connection_graph_finalize (GObject *object)
+{
+    SnapdConnectionGraph *self = SNAPD_CONNECTION_GRAPH (object);
+
+    g_clear_pointer (&self->connections, g_hash_table_unref);
+    g_clear_pointer (&self->connections_by_plug, g_hash_table_unref);
+    g_clear_pointer (&self->connections_by_slot, g_hash_table_unref);
+    g_clear_pointer (&self->connections_by_snap, g_hash_table_unref);
+    g_clear_pointer (&self->connections_by_interface, g_hash_table_unref);
+    g_clear_pointer (&self->plugs, g_hash_table_unref);
+    g_clear_pointer (&self->slots, g_hash_table_unref);
+    g_clear_pointer (&self->plugs_by_interface, g_hash_table_unref);
+    g_clear_pointer (&self->slots_by_interface, g_hash_table_unref);
+    g_clear_pointer (&self->empty, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_connection_graph_parent_class)->finalize (object);
+}
+
+static void
+snapd_connection_graph_class_init (SnapdConnectionGraphClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_connection_graph_finalize;
+}
+
+static void
+snapd_connection_graph_init (SnapdConnectionGraph *self)
+{
+    self->connections = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    self->connections_by_plug = index_new ();
+    self->connections_by_slot = index_new ();
+    self->connections_by_snap = index_new ();
+    self->connections_by_interface = index_new ();
+    self->plugs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    self->slots = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    self->plugs_by_interface = index_new ();
+    self->slots_by_interface = index_new ();
+    self->empty = g_ptr_array_new ();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CONNECTION_GRAPH_H__
+#define __SNAPD_CONNECTION_GRAPH_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+#include <snapd-glib/snapd-connection.h>
+#include <snapd-glib/snapd-plug.h>
+#include <snapd-glib/snapd-slot.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_CONNECTION_GRAPH  (snapd_connection_graph_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdConnectionGraph, snapd_connection_graph, SNAPD, CONNECTION_GRAPH, GObject)
+
+SnapdConnectionGraph *snapd_connection_graph_new                      (void);
+
+void                  snapd_connection_graph_update                   (SnapdConnectionGraph *graph,
+                                                                       GPtrArray            *established,
+                                                                       GPtrArray            *plugs,
+                                                                       GPtrArray            *slots);
+
+void                  snapd_connection_graph_connect                  (SnapdConnectionGraph *graph,
+                                                                       const gchar          *plug_snap,
+                                                                       const gchar          *plug_name,
+                                                                       const gchar          *slot_snap,
+                                                                       const gchar          *slot_name);
+
+void                  snapd_connection_graph_disconnect               (SnapdConnectionGraph *graph,
+                                                                       const gchar          *plug_snap,
+                                                                       const gchar          *plug_name,
+                                                                       const gchar          *slot_snap,
+                                                                       const gchar          *slot_name);
+
+guint                 snapd_connection_graph_get_n_connections        (SnapdConnectionGraph *graph);
+
+SnapdPlug            *snapd_connection_graph_lookup_plug              (SnapdConnectionGraph *graph,
+                                                                       const gchar          *snap,
+                                                                       const gchar          *name);
+
+SnapdSlot            *snapd_connection_graph_lookup_slot              (SnapdConnectionGraph *graph,
+                                                                       const gchar          *snap,
+                                                                       const gchar          *name);
+
+GPtrArray            *snapd_connection_graph_get_plug_connections     (SnapdConnectionGraph *graph,
+                                                                       const gchar          *snap,
+                                                                       const gchar          *name);
+
+GPtrArray            *snapd_connection_graph_get_slot_connections     (SnapdConnectionGraph *graph,
+                                                                       const gchar          *snap,
+                                                                       const gchar          *name);
+
+GPtrArray            *snapd_connection_graph_get_snap_connections     (SnapdConnectionGraph *graph,
+                                                                       const gchar          *snap);
+
+GPtrArray            *snapd_connection_graph_get_interface_connections (SnapdConnectionGraph *graph,
+                                                                       const gchar          *interface);
+
+GPtrArray            *snapd_connection_graph_get_interface_plugs      (SnapdConnectionGraph *graph,
+                                                                       const gchar          *interface);
+
+GPtrArray            *snapd_connection_graph_get_interface_slots      (SnapdConnectionGraph *graph,
+                                                                       const gchar          *interface);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CONNECTION_GRAPH_H__ */
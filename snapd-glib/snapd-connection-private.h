@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_CONNECTION_PRIVATE_H__
+#define __SNAPD_CONNECTION_PRIVATE_H__
+
+#include <json-glib/json-glib.h>
+
+#include "snapd-connection.h"
+
+G_BEGIN_DECLS
+
+void _snapd_connection_set_attributes_objects (SnapdConnection *connection,
+                                               JsonObject      *slot_attributes,
+                                               JsonObject      *plug_attributes);
+
+G_END_DECLS
+
+#endif /* __SNAPD_CONNECTION_PRIVATE_H__ */
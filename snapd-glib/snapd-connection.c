@@ -9,7 +9,9 @@
 
 #include <string.h>
 
-#include "snapd-connection.h"
+#include "snapd-connection-private.h"
+#include "snapd-attributes.h"
+#include "snapd-serialize.h"
 
 /**
  * SECTION: snapd-connection
@@ -34,11 +36,11 @@ struct _SnapdConnection
 
     SnapdSlotRef *slot;
     SnapdPlugRef *plug;
-    gchar *interface;
+    const gchar *interface; /* Interned */
     gboolean manual;
     gboolean gadget;
-    GHashTable *slot_attributes;
-    GHashTable *plug_attributes;
+    SnapdAttributes slot_attributes;
+    SnapdAttributes plug_attributes;
 
     /* legacy */
     gchar *name;
@@ -161,20 +163,7 @@ GStrv
 snapd_connection_get_slot_attribute_names (SnapdConnection *self, guint *length)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), NULL);
-
-    GHashTableIter iter;
-    g_hash_table_iter_init (&iter, self->slot_attributes);
-    guint size = g_hash_table_size (self->slot_attributes);
-    GStrv names = g_malloc (sizeof (gchar *) * (size + 1));
-    guint i;
-    gpointer name;
-    for (i = 0; g_hash_table_iter_next (&iter, &name, NULL); i++)
-        names[i] = g_strdup (name);
-    names[i] = NULL;
-
-    if (length != NULL)
-        *length = size;
-    return names;
+    return _snapd_attributes_get_names (&self->slot_attributes, length);
 }
 
 /**
@@ -192,7 +181,7 @@ gboolean
 snapd_connection_has_slot_attribute (SnapdConnection *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), FALSE);
-    return g_hash_table_contains (self->slot_attributes, name);
+    return _snapd_attributes_contains (&self->slot_attributes, name);
 }
 
 /**
@@ -210,7 +199,7 @@ GVariant *
 snapd_connection_get_slot_attribute (SnapdConnection *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), NULL);
-    return g_hash_table_lookup (self->slot_attributes, name);
+    return _snapd_attributes_lookup (&self->slot_attributes, name);
 }
 
 /**
@@ -228,20 +217,7 @@ GStrv
 snapd_connection_get_plug_attribute_names (SnapdConnection *self, guint *length)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), NULL);
-
-    GHashTableIter iter;
-    g_hash_table_iter_init (&iter, self->plug_attributes);
-    guint size = g_hash_table_size (self->plug_attributes);
-    GStrv names = g_malloc (sizeof (gchar *) * (size + 1));
-    guint i;
-    gpointer name;
-    for (i = 0; g_hash_table_iter_next (&iter, &name, NULL); i++)
-        names[i] = g_strdup (name);
-    names[i] = NULL;
-
-    if (length != NULL)
-        *length = size;
-    return names;
+    return _snapd_attributes_get_names (&self->plug_attributes, length);
 }
 
 /**
@@ -259,7 +235,7 @@ gboolean
 snapd_connection_has_plug_attribute (SnapdConnection *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), FALSE);
-    return g_hash_table_contains (self->plug_attributes, name);
+    return _snapd_attributes_contains (&self->plug_attributes, name);
 }
 
 /**
@@ -277,7 +253,16 @@ GVariant *
 snapd_connection_get_plug_attribute (SnapdConnection *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_CONNECTION (self), NULL);
-    return g_hash_table_lookup (self->plug_attributes, name);
+    return _snapd_attributes_lookup (&self->plug_attributes, name);
+}
+
+/* Keep the attributes from snapd, they are converted when requested */
+void
+_snapd_connection_set_attributes_objects (SnapdConnection *self, JsonObject *slot_attributes, JsonObject *plug_attributes)
+{
+    g_return_if_fail (SNAPD_IS_CONNECTION (self));
+    _snapd_attributes_set_object (&self->slot_attributes, slot_attributes);
+    _snapd_attributes_set_object (&self->plug_attributes, plug_attributes);
 }
 
 /**
@@ -316,6 +301,134 @@ snapd_connection_get_snap (SnapdConnection *self)
     return self->snap;
 }
 
+#define REF_TYPE "(msms)"
+#define CONNECTION_TYPE "(m" REF_TYPE "m" REF_TYPE "msbba{sv}a{sv}msms)"
+
+static GVariant *
+ref_to_variant (const gchar *snap, const gchar *name, gboolean set)
+{
+    if (!set)
+        return g_variant_new_maybe (G_VARIANT_TYPE (REF_TYPE), NULL);
+    return g_variant_new_maybe (NULL, g_variant_new ("(msms)", snap, name));
+}
+
+static GVariant *
+attributes_to_variant (GHashTable *attributes)
+{
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+    if (attributes != NULL) {
+        GHashTableIter iter;
+        gpointer name, value;
+        g_hash_table_iter_init (&iter, attributes);
+        while (g_hash_table_iter_next (&iter, &name, &value))
+            g_variant_builder_add (&builder, "{sv}", name, value);
+    }
+    return g_variant_builder_end (&builder);
+}
+
+static GHashTable *
+attributes_from_variant (GVariant *value)
+{
+    GHashTable *attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    GVariantIter iter;
+    const gchar *name;
+    GVariant *attribute;
+    g_variant_iter_init (&iter, value);
+    while (g_variant_iter_next (&iter, "{&sv}", &name, &attribute))
+        g_hash_table_insert (attributes, g_strdup (name), attribute);
+    return attributes;
+}
+
+/**
+ * snapd_connection_serialize:
+ * @connection: a #SnapdConnection.
+ *
+ * Serialize a connection to a compact binary form, so it can be stored or
+ * sent to another process and read back with snapd_connection_deserialize().
+ *
+ * Returns: (transfer full): the serialized connection.
+ *
+ * Since: 1.65
+ */
+GBytes *
+snapd_connection_serialize (SnapdConnection *self)
+{
+    g_return_val_if_fail (SNAPD_IS_CONNECTION (self), NULL);
+
+    return _snapd_serialize_wrap ("connection",
+                                  g_variant_new ("(@m" REF_TYPE "@m" REF_TYPE "msbb@a{sv}@a{sv}msms)",
+                                                 ref_to_variant (self->slot != NULL ? snapd_slot_ref_get_snap (self->slot) : NULL,
+                                                                 self->slot != NULL ? snapd_slot_ref_get_slot (self->slot) : NULL,
+                                                                 self->slot != NULL),
+                                                 ref_to_variant (self->plug != NULL ? snapd_plug_ref_get_snap (self->plug) : NULL,
+                                                                 self->plug != NULL ? snapd_plug_ref_get_plug (self->plug) : NULL,
+                                                                 self->plug != NULL),
+                                                 self->interface,
+                                                 self->manual,
+                                                 self->gadget,
+                                                 attributes_to_variant (_snapd_attributes_get_table (&self->slot_attributes)),
+                                                 attributes_to_variant (_snapd_attributes_get_table (&self->plug_attributes)),
+                                                 self->name,
+                                                 self->snap));
+}
+
+/**
+ * snapd_connection_deserialize:
+ * @data: data written by snapd_connection_serialize().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Read a connection serialized with snapd_connection_serialize().
+ *
+ * Returns: (transfer full): a #SnapdConnection or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdConnection *
+snapd_connection_deserialize (GBytes *data, GError **error)
+{
+    g_return_val_if_fail (data != NULL, NULL);
+
+    g_autoptr(SnapdArena) arena = NULL;
+    g_autoptr(GVariant) value = _snapd_serialize_unwrap (data, "connection", CONNECTION_TYPE, &arena, error);
+    if (value == NULL)
+        return NULL;
+
+    SnapdReader reader;
+    _snapd_reader_init (&reader, value);
+
+    SnapdConnection *self = g_object_new (SNAPD_TYPE_CONNECTION, NULL);
+    g_autoptr(GVariant) slot = _snapd_reader_get_array (&reader);
+    if (slot != NULL) {
+        SnapdReader ref_reader;
+        _snapd_reader_init (&ref_reader, slot);
+        const gchar *snap = _snapd_reader_get_string (&ref_reader);
+        const gchar *name = _snapd_reader_get_string (&ref_reader);
+        self->slot = g_object_new (SNAPD_TYPE_SLOT_REF, "snap", snap, "slot", name, NULL);
+    }
+    g_autoptr(GVariant) plug = _snapd_reader_get_array (&reader);
+    if (plug != NULL) {
+        SnapdReader ref_reader;
+        _snapd_reader_init (&ref_reader, plug);
+        const gchar *snap = _snapd_reader_get_string (&ref_reader);
+        const gchar *name = _snapd_reader_get_string (&ref_reader);
+        self->plug = g_object_new (SNAPD_TYPE_PLUG_REF, "snap", snap, "plug", name, NULL);
+    }
+    self->interface = g_intern_string (_snapd_reader_get_string (&reader));
+    self->manual = _snapd_reader_get_boolean (&reader);
+    self->gadget = _snapd_reader_get_boolean (&reader);
+    g_autoptr(GVariant) slot_attributes = _snapd_reader_get_value (&reader);
+    g_autoptr(GHashTable) slot_attributes_table = attributes_from_variant (slot_attributes);
+    _snapd_attributes_set_table (&self->slot_attributes, slot_attributes_table);
+    g_autoptr(GVariant) plug_attributes = _snapd_reader_get_value (&reader);
+    g_autoptr(GHashTable) plug_attributes_table = attributes_from_variant (plug_attributes);
+    _snapd_attributes_set_table (&self->plug_attributes, plug_attributes_table);
+    self->name = g_strdup (_snapd_reader_get_string (&reader));
+    self->snap = g_strdup (_snapd_reader_get_string (&reader));
+
+    return self;
+}
+
 static void
 snapd_connection_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
 {
@@ -337,8 +450,7 @@ snapd_connection_set_property (GObject *object, guint prop_id, const GValue *val
         g_set_object (&self->slot, g_value_get_object (value));
         break;
     case PROP_INTERFACE:
-        g_free (self->interface);
-        self->interface = g_strdup (g_value_get_string (value));
+        self->interface = g_intern_string (g_value_get_string (value));
         break;
     case PROP_MANUAL:
         self->manual = g_value_get_boolean (value);
@@ -347,14 +459,10 @@ snapd_connection_set_property (GObject *object, guint prop_id, const GValue *val
         self->gadget = g_value_get_boolean (value);
         break;
     case PROP_SLOT_ATTRIBUTES:
-        g_clear_pointer (&self->slot_attributes, g_hash_table_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->slot_attributes = g_hash_table_ref (g_value_get_boxed (value));
+        _snapd_attributes_set_table (&self->slot_attributes, g_value_get_boxed (value));
         break;
     case PROP_PLUG_ATTRIBUTES:
-        g_clear_pointer (&self->plug_attributes, g_hash_table_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->plug_attributes = g_hash_table_ref (g_value_get_boxed (value));
+        _snapd_attributes_set_table (&self->plug_attributes, g_value_get_boxed (value));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -390,10 +498,10 @@ snapd_connection_get_property (GObject *object, guint prop_id, GValue *value, GP
         g_value_set_boolean (value, self->gadget);
         break;
     case PROP_SLOT_ATTRIBUTES:
-        g_value_set_boxed (value, self->slot_attributes);
+        g_value_set_boxed (value, _snapd_attributes_get_table (&self->slot_attributes));
         break;
     case PROP_PLUG_ATTRIBUTES:
-        g_value_set_boxed (value, self->plug_attributes);
+        g_value_set_boxed (value, _snapd_attributes_get_table (&self->plug_attributes));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -408,9 +516,8 @@ snapd_connection_finalize (GObject *object)
 
     g_clear_object (&self->slot);
     g_clear_object (&self->plug);
-    g_clear_pointer (&self->interface, g_free);
-    g_clear_pointer (&self->slot_attributes, g_hash_table_unref);
-    g_clear_pointer (&self->plug_attributes, g_hash_table_unref);
+    _snapd_attributes_clear (&self->slot_attributes);
+    _snapd_attributes_clear (&self->plug_attributes);
     g_clear_pointer (&self->name, g_free);
     g_clear_pointer (&self->snap, g_free);
 
@@ -494,4 +601,6 @@ snapd_connection_class_init (SnapdConnectionClass *klass)
 static void
 snapd_connection_init (SnapdConnection *self)
 {
+    _snapd_attributes_init (&self->slot_attributes);
+    _snapd_attributes_init (&self->plug_attributes);
 }
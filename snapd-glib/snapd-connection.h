@@ -56,6 +56,11 @@ const gchar  *snapd_connection_get_name                 (SnapdConnection *connec
 
 const gchar  *snapd_connection_get_snap                 (SnapdConnection *connection) G_DEPRECATED;
 
+GBytes       *snapd_connection_serialize                (SnapdConnection *connection);
+
+SnapdConnection *snapd_connection_deserialize           (GBytes          *data,
+                                                         GError         **error);
+
 G_END_DECLS
 
 #endif /* __SNAPD_CONNECTION_H__ */
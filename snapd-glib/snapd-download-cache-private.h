@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_DOWNLOAD_CACHE_PRIVATE_H__
+#define __SNAPD_DOWNLOAD_CACHE_PRIVATE_H__
+
+#include <gio/gio.h>
+
+#include "snapd-cache-manager.h"
+#include "snapd-download-cache.h"
+
+G_BEGIN_DECLS
+
+gchar         *_snapd_download_cache_get_path     (SnapdDownloadCache *cache,
+                                                   const gchar        *sha3_384);
+
+GBytes        *_snapd_download_cache_load         (SnapdDownloadCache *cache,
+                                                   const gchar        *sha3_384,
+                                                   goffset             size);
+
+gboolean       _snapd_download_cache_begin        (SnapdDownloadCache *cache,
+                                                   const gchar        *sha3_384,
+                                                   GTask              *task);
+
+GOutputStream *_snapd_download_cache_create_temp  (SnapdDownloadCache *cache,
+                                                   gchar             **path,
+                                                   GError            **error);
+
+GBytes        *_snapd_download_cache_commit       (SnapdDownloadCache *cache,
+                                                   const gchar        *temp_path,
+                                                   const gchar        *sha3_384,
+                                                   GError            **error);
+
+GPtrArray     *_snapd_download_cache_end          (SnapdDownloadCache *cache,
+                                                   const gchar        *sha3_384);
+
+void           _snapd_download_cache_set_cache_manager (SnapdDownloadCache *cache,
+                                                        SnapdCacheManager  *manager);
+
+G_END_DECLS
+
+#endif /* __SNAPD_DOWNLOAD_CACHE_PRIVATE_H__ */
@@ -0,0 +1,475 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+#include <gio/gunixoutputstream.h>
+
+#include "snapd-cache-manager-private.h"
+#include "snapd-download-cache-private.h"
+
+/**
+ * SECTION: snapd-download-cache
+ * @short_description: Disk cache for downloaded snaps
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdDownloadCache stores snaps downloaded with
+ * snapd_client_download_async() on disk, named by their SHA3-384 digest.
+ * Before downloading, the client asks snapd for the digest of the snap that
+ * would be sent. If that snap is already in the cache it is returned from
+ * disk, so the same revision requested from several channels is only
+ * downloaded and stored once. Requests for a snap that is already being
+ * downloaded wait for that download instead of starting another.
+ *
+ * A cached snap can be installed without reading it into memory by looking
+ * up its path with snapd_download_cache_lookup() and passing it to
+ * snapd_client_install_path_async(). The cache directory can be shared
+ * between processes.
+ *
+ * The digests are the ones reported by snapd. GLib can't compute SHA3-384,
+ * so the cache only checks that a cached file has the size snapd reports.
+ *
+ * The snaps in the cache count against the disk budget of the
+ * #SnapdCacheManager of the last client the cache was set on, and the least
+ * recently used are deleted when it is exceeded.
+ */
+
+/**
+ * SnapdDownloadCache:
+ *
+ * #SnapdDownloadCache stores downloaded snaps by digest.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdDownloadCache
+{
+    GObject parent_instance;
+
+    gchar *cache_dir;
+
+    /* Protects the fields below, the cache may be shared by clients in different threads */
+    GMutex mutex;
+
+    /* Tasks waiting for a download in progress, keyed by digest */
+    GHashTable *downloads;
+
+    guint n_hits;
+    guint n_misses;
+
+    /* Manager counting the cached snaps, and the ID they are counted with */
+    SnapdCacheManager *cache_manager;
+    guint cache_id;
+};
+
+G_DEFINE_TYPE (SnapdDownloadCache, snapd_download_cache, G_TYPE_OBJECT)
+
+/* Digests are used as filenames so only allow characters that can't escape the cache directory */
+static gboolean
+is_valid_digest (const gchar *sha3_384)
+{
+    if (sha3_384 == NULL || sha3_384[0] == '\0')
+        return FALSE;
+
+    for (const gchar *c = sha3_384; *c != '\0'; c++) {
+        if (!g_ascii_isalnum (*c) && strchr ("-_:", *c) == NULL)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+gchar *
+_snapd_download_cache_get_path (SnapdDownloadCache *self, const gchar *sha3_384)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+
+    if (!is_valid_digest (sha3_384))
+        return NULL;
+
+    g_autofree gchar *filename = g_strconcat (sha3_384, ".snap", NULL);
+    return g_build_filename (self->cache_dir, filename, NULL);
+}
+
+/* Get the manager counting the cache, and the ID it uses */
+static SnapdCacheManager *
+get_cache_manager (SnapdDownloadCache *self, guint *cache_id)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    *cache_id = self->cache_id;
+    return self->cache_manager != NULL ? g_object_ref (self->cache_manager) : NULL;
+}
+
+/* Delete snaps the cache manager evicted */
+static void
+drop_evicted (SnapdDownloadCache *self)
+{
+    guint cache_id;
+    g_autoptr(SnapdCacheManager) manager = get_cache_manager (self, &cache_id);
+    if (manager == NULL)
+        return;
+
+    g_auto(GStrv) digests = _snapd_cache_manager_take_evicted (manager, cache_id);
+    for (int i = 0; digests != NULL && digests[i] != NULL; i++) {
+        g_autofree gchar *path = _snapd_download_cache_get_path (self, digests[i]);
+        if (path != NULL)
+            g_unlink (path);
+    }
+}
+
+static void
+drain_cb (gpointer user_data)
+{
+    drop_evicted (SNAPD_DOWNLOAD_CACHE (user_data));
+}
+
+typedef struct
+{
+    gchar *digest;
+    guint64 size;
+    gint64 mtime;
+} CachedFile;
+
+static void
+cached_file_clear (CachedFile *file)
+{
+    g_free (file->digest);
+}
+
+static gint
+compare_mtimes (gconstpointer a, gconstpointer b)
+{
+    const CachedFile *file_a = a, *file_b = b;
+    return file_a->mtime < file_b->mtime ? -1 : file_a->mtime > file_b->mtime ? 1 : 0;
+}
+
+/* Count the snaps already in the directory, oldest first so they are evicted first */
+static void
+insert_existing_files (SnapdDownloadCache *self, SnapdCacheManager *manager, guint cache_id)
+{
+    g_autoptr(GDir) dir = g_dir_open (self->cache_dir, 0, NULL);
+    if (dir == NULL)
+        return;
+
+    g_autoptr(GArray) files = g_array_new (FALSE, FALSE, sizeof (CachedFile));
+    g_array_set_clear_func (files, (GDestroyNotify) cached_file_clear);
+    const gchar *name;
+    while ((name = g_dir_read_name (dir)) != NULL) {
+        if (name[0] == '.' || !g_str_has_suffix (name, ".snap"))
+            continue;
+
+        g_autofree gchar *path = g_build_filename (self->cache_dir, name, NULL);
+        GStatBuf buf;
+        if (g_stat (path, &buf) < 0 || !S_ISREG (buf.st_mode))
+            continue;
+
+        CachedFile file;
+        file.digest = g_strndup (name, strlen (name) - strlen (".snap"));
+        file.size = buf.st_size;
+        file.mtime = buf.st_mtime;
+        g_array_append_val (files, file);
+    }
+    g_array_sort (files, compare_mtimes);
+
+    for (guint i = 0; i < files->len; i++) {
+        CachedFile *file = &g_array_index (files, CachedFile, i);
+        _snapd_cache_manager_insert (manager, cache_id, file->digest, file->size);
+    }
+}
+
+/* Count the snaps in the cache in @manager's budget, in place of any previous manager */
+void
+_snapd_download_cache_set_cache_manager (SnapdDownloadCache *self, SnapdCacheManager *manager)
+{
+    g_return_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self));
+
+    g_autoptr(SnapdCacheManager) old_manager = NULL;
+    guint old_cache_id = 0, cache_id = 0;
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        if (self->cache_manager == manager)
+            return;
+
+        old_manager = g_steal_pointer (&self->cache_manager);
+        old_cache_id = self->cache_id;
+        self->cache_id = 0;
+        if (manager != NULL) {
+            self->cache_manager = g_object_ref (manager);
+            self->cache_id = cache_id = _snapd_cache_manager_add_cache (manager, "downloads", TRUE, drain_cb, self);
+        }
+    }
+
+    if (old_manager != NULL)
+        _snapd_cache_manager_remove_cache (old_manager, old_cache_id);
+    if (manager != NULL) {
+        insert_existing_files (self, manager, cache_id);
+        drop_evicted (self);
+    }
+}
+
+/* Map a cached snap into memory, counting whether it was found */
+GBytes *
+_snapd_download_cache_load (SnapdDownloadCache *self, const gchar *sha3_384, goffset size)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+
+    g_autofree gchar *path = _snapd_download_cache_get_path (self, sha3_384);
+    g_autoptr(GMappedFile) file = path != NULL ? g_mapped_file_new (path, FALSE, NULL) : NULL;
+    gboolean hit = file != NULL && (size < 0 || (goffset) g_mapped_file_get_length (file) == size);
+
+    {
+        g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+        if (hit)
+            self->n_hits++;
+        else
+            self->n_misses++;
+    }
+
+    guint cache_id;
+    g_autoptr(SnapdCacheManager) manager = get_cache_manager (self, &cache_id);
+    if (manager != NULL) {
+        if (hit)
+            _snapd_cache_manager_hit (manager, cache_id, sha3_384);
+        else
+            _snapd_cache_manager_miss (manager, cache_id);
+    }
+
+    return hit ? g_mapped_file_get_bytes (file) : NULL;
+}
+
+/* Returns %TRUE if @task should download the snap, or %FALSE if it has been queued
+ * to complete when the download already in progress ends */
+gboolean
+_snapd_download_cache_begin (SnapdDownloadCache *self, const gchar *sha3_384, GTask *task)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), FALSE);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    GPtrArray *waiting = g_hash_table_lookup (self->downloads, sha3_384);
+    if (waiting != NULL) {
+        g_ptr_array_add (waiting, g_object_ref (task));
+        return FALSE;
+    }
+
+    g_hash_table_insert (self->downloads, g_strdup (sha3_384), g_ptr_array_new_with_free_func (g_object_unref));
+    return TRUE;
+}
+
+/* Downloads are written next to the cache entries so they can be moved into place atomically */
+GOutputStream *
+_snapd_download_cache_create_temp (SnapdDownloadCache *self, gchar **path, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+
+    if (g_mkdir_with_parents (self->cache_dir, 0700) < 0) {
+        int errsv = errno;
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                     "Failed to create download cache directory %s: %s", self->cache_dir, g_strerror (errsv));
+        return NULL;
+    }
+
+    g_autofree gchar *temp_path = g_build_filename (self->cache_dir, ".download-XXXXXX", NULL);
+    int fd = g_mkstemp (temp_path);
+    if (fd < 0) {
+        int errsv = errno;
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                     "Failed to create download file in %s: %s", self->cache_dir, g_strerror (errsv));
+        return NULL;
+    }
+
+    *path = g_steal_pointer (&temp_path);
+    return g_unix_output_stream_new (fd, TRUE);
+}
+
+/* Move a completed download into the cache and map it into memory */
+GBytes *
+_snapd_download_cache_commit (SnapdDownloadCache *self, const gchar *temp_path, const gchar *sha3_384, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+
+    g_autofree gchar *path = _snapd_download_cache_get_path (self, sha3_384);
+    if (g_rename (temp_path, path) < 0) {
+        int errsv = errno;
+        g_unlink (temp_path);
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+                     "Failed to store download in %s: %s", path, g_strerror (errsv));
+        return NULL;
+    }
+
+    g_autoptr(GMappedFile) file = g_mapped_file_new (path, FALSE, error);
+    if (file == NULL)
+        return NULL;
+
+    /* Mapped before counting, so the file is still readable if it is evicted straight away */
+    guint cache_id;
+    g_autoptr(SnapdCacheManager) manager = get_cache_manager (self, &cache_id);
+    if (manager != NULL) {
+        _snapd_cache_manager_insert (manager, cache_id, sha3_384, g_mapped_file_get_length (file));
+        drop_evicted (self);
+    }
+
+    return g_mapped_file_get_bytes (file);
+}
+
+/**
+ * _snapd_download_cache_end:
+ *
+ * Mark a download as done.
+ *
+ * Returns: (transfer container) (element-type GTask): the tasks that were waiting for it.
+ */
+GPtrArray *
+_snapd_download_cache_end (SnapdDownloadCache *self, const gchar *sha3_384)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    GPtrArray *waiting = g_hash_table_lookup (self->downloads, sha3_384);
+    if (waiting == NULL)
+        return g_ptr_array_new_with_free_func (g_object_unref);
+    g_ptr_array_ref (waiting);
+    g_hash_table_remove (self->downloads, sha3_384);
+    return waiting;
+}
+
+/**
+ * snapd_download_cache_new:
+ * @cache_dir: the directory to store snaps in.
+ *
+ * Create a new cache to use with snapd_client_set_download_cache(). The
+ * directory is created when the first snap is stored.
+ *
+ * Returns: a new #SnapdDownloadCache
+ *
+ * Since: 1.65
+ */
+SnapdDownloadCache *
+snapd_download_cache_new (const gchar *cache_dir)
+{
+    g_return_val_if_fail (cache_dir != NULL, NULL);
+
+    SnapdDownloadCache *self = g_object_new (SNAPD_TYPE_DOWNLOAD_CACHE, NULL);
+    self->cache_dir = g_strdup (cache_dir);
+
+    return self;
+}
+
+/**
+ * snapd_download_cache_get_cache_dir:
+ * @cache: a #SnapdDownloadCache.
+ *
+ * Get the directory snaps are stored in.
+ *
+ * Returns: a directory path.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_download_cache_get_cache_dir (SnapdDownloadCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+    return self->cache_dir;
+}
+
+/**
+ * snapd_download_cache_lookup:
+ * @cache: a #SnapdDownloadCache.
+ * @sha3_384: the digest of the snap, as returned by snapd_client_download_peek_sync().
+ *
+ * Get the path to a cached snap.
+ *
+ * Returns: (transfer full) (allow-none): the path to the file or %NULL if not in the cache.
+ *
+ * Since: 1.65
+ */
+gchar *
+snapd_download_cache_lookup (SnapdDownloadCache *self, const gchar *sha3_384)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), NULL);
+    g_return_val_if_fail (sha3_384 != NULL, NULL);
+
+    g_autofree gchar *path = _snapd_download_cache_get_path (self, sha3_384);
+    if (path == NULL || !g_file_test (path, G_FILE_TEST_IS_REGULAR))
+        return NULL;
+
+    return g_steal_pointer (&path);
+}
+
+/**
+ * snapd_download_cache_get_hits:
+ * @cache: a #SnapdDownloadCache.
+ *
+ * Get the number of downloads that were returned from the cache.
+ *
+ * Returns: the number of cache hits.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_download_cache_get_hits (SnapdDownloadCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->n_hits;
+}
+
+/**
+ * snapd_download_cache_get_misses:
+ * @cache: a #SnapdDownloadCache.
+ *
+ * Get the number of downloads that were not in the cache. Downloads that
+ * waited for the same snap to be downloaded by another request are counted
+ * as misses.
+ *
+ * Returns: the number of cache misses.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_download_cache_get_misses (SnapdDownloadCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD_CACHE (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->n_misses;
+}
+
+static void
+snapd_download_cache_finalize (GObject *object)
+{
+    SnapdDownloadCache *self = SNAPD_DOWNLOAD_CACHE (object);
+
+    if (self->cache_manager != NULL)
+        _snapd_cache_manager_remove_cache (self->cache_manager, self->cache_id);
+    g_clear_object (&self->cache_manager);
+    g_clear_pointer (&self->cache_dir, g_free);
+    g_mutex_clear (&self->mutex);
+    g_clear_pointer (&self->downloads, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_download_cache_parent_class)->finalize (object);
+}
+
+static void
+snapd_download_cache_class_init (SnapdDownloadCacheClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_download_cache_finalize;
+}
+
+static void
+snapd_download_cache_init (SnapdDownloadCache *self)
+{
+    g_mutex_init (&self->mutex);
+    self->downloads = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_DOWNLOAD_CACHE_H__
+#define __SNAPD_DOWNLOAD_CACHE_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_DOWNLOAD_CACHE  (snapd_download_cache_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdDownloadCache, snapd_download_cache, SNAPD, DOWNLOAD_CACHE, GObject)
+
+SnapdDownloadCache *snapd_download_cache_new           (const gchar        *cache_dir);
+
+const gchar        *snapd_download_cache_get_cache_dir (SnapdDownloadCache *cache);
+
+gchar              *snapd_download_cache_lookup        (SnapdDownloadCache *cache,
+                                                        const gchar        *sha3_384);
+
+guint               snapd_download_cache_get_hits      (SnapdDownloadCache *cache);
+
+guint               snapd_download_cache_get_misses    (SnapdDownloadCache *cache);
+
+G_END_DECLS
+
+#endif /* __SNAPD_DOWNLOAD_CACHE_H__ */
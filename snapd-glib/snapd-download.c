@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-download-private.h"
+
+/**
+ * SECTION: snapd-download
+ * @short_description: Snap to download
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdDownload describes a snap to download with
+ * snapd_client_download_many_async() and the stream to write it to. The
+ * size and number of bytes downloaded are updated as the download
+ * progresses.
+ */
+
+/**
+ * SnapdDownload:
+ *
+ * #SnapdDownload is a snap to download.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdDownload
+{
+    GObject parent_instance;
+
+    gchar *name;
+    gchar *channel;
+    gchar *revision;
+    GOutputStream *stream;
+    goffset size;
+    goffset downloaded;
+};
+
+enum
+{
+    PROP_NAME = 1,
+    PROP_CHANNEL,
+    PROP_REVISION,
+    PROP_STREAM,
+    PROP_LAST
+};
+
+G_DEFINE_TYPE (SnapdDownload, snapd_download, G_TYPE_OBJECT)
+
+/**
+ * snapd_download_new:
+ * @name: name of snap to download.
+ * @channel: (allow-none): channel to download from or %NULL for the default.
+ * @revision: (allow-none): revision to download or %NULL for the default.
+ * @stream: a #GOutputStream to write the snap contents to.
+ *
+ * Create a snap download to pass to snapd_client_download_many_async().
+ *
+ * Returns: a new #SnapdDownload
+ *
+ * Since: 1.65
+ */
+SnapdDownload *
+snapd_download_new (const gchar *name, const gchar *channel, const gchar *revision, GOutputStream *stream)
+{
+    g_return_val_if_fail (name != NULL, NULL);
+    g_return_val_if_fail (G_IS_OUTPUT_STREAM (stream), NULL);
+
+    return g_object_new (SNAPD_TYPE_DOWNLOAD,
+                         "name", name,
+                         "channel", channel,
+                         "revision", revision,
+                         "stream", stream,
+                         NULL);
+}
+
+/**
+ * snapd_download_get_name:
+ * @download: a #SnapdDownload.
+ *
+ * Get the name of the snap to download.
+ *
+ * Returns: a snap name.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_download_get_name (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), NULL);
+    return self->name;
+}
+
+/**
+ * snapd_download_get_channel:
+ * @download: a #SnapdDownload.
+ *
+ * Get the channel to download from.
+ *
+ * Returns: (allow-none): a channel name or %NULL for the default.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_download_get_channel (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), NULL);
+    return self->channel;
+}
+
+/**
+ * snapd_download_get_revision:
+ * @download: a #SnapdDownload.
+ *
+ * Get the revision to download.
+ *
+ * Returns: (allow-none): a revision or %NULL for the default.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_download_get_revision (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), NULL);
+    return self->revision;
+}
+
+/**
+ * snapd_download_get_stream:
+ * @download: a #SnapdDownload.
+ *
+ * Get the stream the snap is written to.
+ *
+ * Returns: (transfer none): a #GOutputStream.
+ *
+ * Since: 1.65
+ */
+GOutputStream *
+snapd_download_get_stream (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), NULL);
+    return self->stream;
+}
+
+void
+_snapd_download_set_size (SnapdDownload *self, goffset size)
+{
+    g_return_if_fail (SNAPD_IS_DOWNLOAD (self));
+    self->size = size;
+}
+
+/**
+ * snapd_download_get_size:
+ * @download: a #SnapdDownload.
+ *
+ * Get the size of the snap.
+ *
+ * Returns: the size in bytes or -1 if not yet known.
+ *
+ * Since: 1.65
+ */
+goffset
+snapd_download_get_size (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), -1);
+    return self->size;
+}
+
+void
+_snapd_download_set_downloaded (SnapdDownload *self, goffset downloaded)
+{
+    g_return_if_fail (SNAPD_IS_DOWNLOAD (self));
+    self->downloaded = downloaded;
+}
+
+/**
+ * snapd_download_get_downloaded:
+ * @download: a #SnapdDownload.
+ *
+ * Get the number of bytes of the snap written to the stream so far.
+ *
+ * Returns: the number of bytes downloaded.
+ *
+ * Since: 1.65
+ */
+goffset
+snapd_download_get_downloaded (SnapdDownload *self)
+{
+    g_return_val_if_fail (SNAPD_IS_DOWNLOAD (self), 0);
+    return self->downloaded;
+}
+
+static void
+snapd_download_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+    SnapdDownload *self = SNAPD_DOWNLOAD (object);
+
+    switch (prop_id) {
+    case PROP_NAME:
+        g_free (self->name);
+        self->name = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_CHANNEL:
+        g_free (self->channel);
+        self->channel = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_REVISION:
+        g_free (self->revision);
+        self->revision = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_STREAM:
+        g_set_object (&self->stream, g_value_get_object (value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_download_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    SnapdDownload *self = SNAPD_DOWNLOAD (object);
+
+    switch (prop_id) {
+    case PROP_NAME:
+        g_value_set_string (value, self->name);
+        break;
+    case PROP_CHANNEL:
+        g_value_set_string (value, self->channel);
+        break;
+    case PROP_REVISION:
+        g_value_set_string (value, self->revision);
+        break;
+    case PROP_STREAM:
+        g_value_set_object (value, self->stream);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_download_finalize (GObject *object)
+{
+    SnapdDownload *self = SNAPD_DOWNLOAD (object);
+
+    g_clear_pointer (&self->name, g_free);
+    g_clear_pointer (&self->channel, g_free);
+    g_clear_pointer (&self->revision, g_free);
+    g_clear_object (&self->stream);
+
+    G_OBJECT_CLASS (snapd_download_parent_class)->finalize (object);
+}
+
+static void
+snapd_download_class_init (SnapdDownloadClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->set_property = snapd_download_set_property;
+    gobject_class->get_property = snapd_download_get_property;
+    gobject_class->finalize = snapd_download_finalize;
+
+    g_object_class_install_property (gobject_class,
+                                     PROP_NAME,
+                                     g_param_spec_string ("name",
+                                                          "name",
+                                                          "Name of snap to download",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_CHANNEL,
+                                     g_param_spec_string ("channel",
+                                                          "channel",
+                                                          "Channel to download from",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_REVISION,
+                                     g_param_spec_string ("revision",
+                                                          "revision",
+                                                          "Revision to download",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_STREAM,
+                                     g_param_spec_object ("stream",
+                                                          "stream",
+                                                          "Stream to write snap to",
+                                                          G_TYPE_OUTPUT_STREAM,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+}
+
+static void
+snapd_download_init (SnapdDownload *self)
+{
+    self->size = -1;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_DOWNLOAD_H__
+#define __SNAPD_DOWNLOAD_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_DOWNLOAD  (snapd_download_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdDownload, snapd_download, SNAPD, DOWNLOAD, GObject)
+
+SnapdDownload *snapd_download_new            (const gchar   *name,
+                                              const gchar   *channel,
+                                              const gchar   *revision,
+                                              GOutputStream *stream);
+
+const gchar   *snapd_download_get_name       (SnapdDownload *download);
+
+const gchar   *snapd_download_get_channel    (SnapdDownload *download);
+
+const gchar   *snapd_download_get_revision   (SnapdDownload *download);
+
+GOutputStream *snapd_download_get_stream     (SnapdDownload *download);
+
+goffset        snapd_download_get_size       (SnapdDownload *download);
+
+goffset        snapd_download_get_downloaded (SnapdDownload *download);
+
+G_END_DECLS
+
+#endif /* __SNAPD_DOWNLOAD_H__ */
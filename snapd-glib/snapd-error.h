@@ -63,6 +63,8 @@ G_BEGIN_DECLS
  * @SNAPD_ERROR_DNS_FAILURE: A hostname failed to resolve during the request.
  * @SNAPD_ERROR_OPTION_NOT_FOUND: A requested configuration option is not set.
  * @SNAPD_ERROR_UNSUCCESSFUL: A snapctl command was unsuccessful.
+ * @SNAPD_ERROR_RESPONSE_TOO_LARGE: the response from snapd was larger than
+ *     the client keeps in memory. Since: 1.65
  *
  * Error codes returned by snapd operations.
  *
@@ -103,6 +105,7 @@ typedef enum
     SNAPD_ERROR_DNS_FAILURE,
     SNAPD_ERROR_OPTION_NOT_FOUND,
     SNAPD_ERROR_UNSUCCESSFUL,
+    SNAPD_ERROR_RESPONSE_TOO_LARGE,
 } SnapdError;
 
 /**
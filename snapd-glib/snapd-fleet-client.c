@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-fleet-client.h"
+
+/**
+ * SECTION: snapd-fleet-client
+ * @short_description: Requests to many snapd instances
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdFleetClient holds a #SnapdClient for each of a set of devices, each
+ * one reached through its own socket, e.g. one forwarded over SSH. A request
+ * is run on all of them with snapd_fleet_client_run_async(), which starts it
+ * on up to snapd_fleet_client_get_max_concurrent() devices at a time.
+ * #SnapdFleetClient::device-completed is emitted with the name of each device
+ * as its request completes, and the handler gets the result by calling the
+ * matching finish function on the device client. A device that fails or
+ * times out (see snapd_fleet_client_set_timeout()) only affects its own
+ * result.
+ */
+
+/**
+ * SnapdFleetClient:
+ *
+ * #SnapdFleetClient is a set of clients to run requests on together.
+ *
+ * Since: 1.65
+ */
+
+/* Default number of devices to run requests on at once */
+#define DEFAULT_MAX_CONCURRENT 16
+
+typedef struct
+{
+    SnapdFleetClient *fleet;
+    gchar *name;
+    SnapdClient *client;
+} FleetDevice;
+
+struct _SnapdFleetClient
+{
+    GObject parent_instance;
+
+    /* Devices in the order they were added */
+    GPtrArray *devices;
+
+    guint max_concurrent;
+    guint timeout;
+
+    /* Current run, the next device to start and the number in progress */
+    GTask *task;
+    SnapdFleetStartFunc start_func;
+    gpointer start_data;
+    guint next_device;
+    guint n_running;
+};
+
+enum
+{
+    SIGNAL_DEVICE_COMPLETED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdFleetClient, snapd_fleet_client, G_TYPE_OBJECT)
+
+static void
+fleet_device_free (FleetDevice *device)
+{
+    g_free (device->name);
+    g_clear_object (&device->client);
+    g_slice_free (FleetDevice, device);
+}
+
+static FleetDevice *
+find_device (SnapdFleetClient *self, const gchar *name)
+{
+    for (guint i = 0; i < self->devices->len; i++) {
+        FleetDevice *device = g_ptr_array_index (self->devices, i);
+        if (g_strcmp0 (device->name, name) == 0)
+            return device;
+    }
+
+    return NULL;
+}
+
+/**
+ * snapd_fleet_client_new:
+ *
+ * Create a fleet client with no devices.
+ *
+ * Returns: a new #SnapdFleetClient
+ *
+ * Since: 1.65
+ */
+SnapdFleetClient *
+snapd_fleet_client_new (void)
+{
+    return g_object_new (SNAPD_TYPE_FLEET_CLIENT, NULL);
+}
+
+/**
+ * snapd_fleet_client_add_device:
+ * @fleet: a #SnapdFleetClient.
+ * @name: (allow-none): a unique name for the device or %NULL to use @socket_path.
+ * @socket_path: the path to the snapd socket of the device.
+ *
+ * Add a device that requests are run on. The returned client can be used to
+ * change other settings, e.g. snapd_client_set_auth_data().
+ *
+ * Returns: (transfer none): the #SnapdClient for the device.
+ *
+ * Since: 1.65
+ */
+SnapdClient *
+snapd_fleet_client_add_device (SnapdFleetClient *self, const gchar *name, const gchar *socket_path)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), NULL);
+    g_return_val_if_fail (self->task == NULL, NULL);
+    g_return_val_if_fail (socket_path != NULL, NULL);
+
+    if (name == NULL)
+        name = socket_path;
+    g_return_val_if_fail (find_device (self, name) == NULL, NULL);
+
+    FleetDevice *device = g_slice_new0 (FleetDevice);
+    device->fleet = self;
+    device->name = g_strdup (name);
+    device->client = snapd_client_new ();
+    snapd_client_set_socket_path (device->client, socket_path);
+    snapd_client_set_request_timeout (device->client, self->timeout);
+    g_ptr_array_add (self->devices, device);
+
+    return device->client;
+}
+
+/**
+ * snapd_fleet_client_get_device:
+ * @fleet: a #SnapdFleetClient.
+ * @name: the name of the device.
+ *
+ * Get the client for a device added with snapd_fleet_client_add_device().
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdClient or %NULL if no device has this name.
+ *
+ * Since: 1.65
+ */
+SnapdClient *
+snapd_fleet_client_get_device (SnapdFleetClient *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    FleetDevice *device = find_device (self, name);
+    return device != NULL ? device->client : NULL;
+}
+
+/**
+ * snapd_fleet_client_get_n_devices:
+ * @fleet: a #SnapdFleetClient.
+ *
+ * Get the number of devices in the fleet.
+ *
+ * Returns: the number of devices.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_fleet_client_get_n_devices (SnapdFleetClient *self)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), 0);
+    return self->devices->len;
+}
+
+/**
+ * snapd_fleet_client_set_max_concurrent:
+ * @fleet: a #SnapdFleetClient.
+ * @max_concurrent: the maximum number of devices to run a request on at once or 0 for the default.
+ *
+ * Set how many devices a request is in progress on at once. The remaining
+ * devices are started as others complete. Defaults to 16.
+ *
+ * Since: 1.65
+ */
+void
+snapd_fleet_client_set_max_concurrent (SnapdFleetClient *self, guint max_concurrent)
+{
+    g_return_if_fail (SNAPD_IS_FLEET_CLIENT (self));
+    self->max_concurrent = max_concurrent != 0 ? max_concurrent : DEFAULT_MAX_CONCURRENT;
+}
+
+/**
+ * snapd_fleet_client_get_max_concurrent:
+ * @fleet: a #SnapdFleetClient.
+ *
+ * Get the value set by snapd_fleet_client_set_max_concurrent().
+ *
+ * Returns: the maximum number of devices to run a request on at once.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_fleet_client_get_max_concurrent (SnapdFleetClient *self)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), 0);
+    return self->max_concurrent;
+}
+
+/**
+ * snapd_fleet_client_set_timeout:
+ * @fleet: a #SnapdFleetClient.
+ * @timeout: timeout in milliseconds or 0 for no timeout.
+ *
+ * Set the timeout for requests to each device, as with
+ * snapd_client_set_request_timeout(). A device that doesn't respond in time
+ * completes with %G_IO_ERROR_TIMED_OUT. This applies to all devices, including
+ * ones added later. Defaults to no timeout.
+ *
+ * Since: 1.65
+ */
+void
+snapd_fleet_client_set_timeout (SnapdFleetClient *self, guint timeout)
+{
+    g_return_if_fail (SNAPD_IS_FLEET_CLIENT (self));
+
+    self->timeout = timeout;
+    for (guint i = 0; i < self->devices->len; i++) {
+        FleetDevice *device = g_ptr_array_index (self->devices, i);
+        snapd_client_set_request_timeout (device->client, timeout);
+    }
+}
+
+/**
+ * snapd_fleet_client_get_timeout:
+ * @fleet: a #SnapdFleetClient.
+ *
+ * Get the value set by snapd_fleet_client_set_timeout().
+ *
+ * Returns: timeout in milliseconds or 0 for no timeout.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_fleet_client_get_timeout (SnapdFleetClient *self)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), 0);
+    return self->timeout;
+}
+
+static void start_devices (SnapdFleetClient *self);
+
+static void
+device_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    FleetDevice *device = user_data;
+    SnapdFleetClient *self = device->fleet;
+
+    g_signal_emit (self, signals[SIGNAL_DEVICE_COMPLETED], 0, device->name, device->client, result);
+
+    self->n_running--;
+    start_devices (self);
+}
+
+static void
+start_devices (SnapdFleetClient *self)
+{
+    GCancellable *cancellable = g_task_get_cancellable (self->task);
+
+    /* Stop starting devices once cancelled, the ones in progress complete with a cancelled error */
+    while (self->n_running < self->max_concurrent &&
+           self->next_device < self->devices->len &&
+           !g_cancellable_is_cancelled (cancellable)) {
+        FleetDevice *device = g_ptr_array_index (self->devices, self->next_device);
+
+        self->next_device++;
+        self->n_running++;
+        self->start_func (device->client, cancellable, device_cb, device, self->start_data);
+    }
+
+    if (self->n_running > 0)
+        return;
+
+    g_autoptr(GTask) task = g_steal_pointer (&self->task);
+    if (!g_task_return_error_if_cancelled (task))
+        g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * snapd_fleet_client_run_async:
+ * @fleet: a #SnapdFleetClient.
+ * @start_func: (scope async): a #SnapdFleetStartFunc to start the request on each device.
+ * @start_data: (closure): the data to pass to @start_func.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all the devices have completed.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously run a request on every device. @start_func is called for
+ * each device in the order they were added, and
+ * #SnapdFleetClient::device-completed is emitted as each one completes.
+ * If @cancellable is cancelled, no more devices are started. Devices can't be
+ * added while a request is running.
+ *
+ * Since: 1.65
+ */
+void
+snapd_fleet_client_run_async (SnapdFleetClient *self, SnapdFleetStartFunc start_func, gpointer start_data, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_FLEET_CLIENT (self));
+    g_return_if_fail (start_func != NULL);
+    g_return_if_fail (self->task == NULL);
+
+    /* The task holds a reference to the fleet, keeping the devices alive until they have all completed */
+    self->task = g_task_new (self, cancellable, callback, user_data);
+    self->start_func = start_func;
+    self->start_data = start_data;
+    self->next_device = 0;
+    self->n_running = 0;
+    start_devices (self);
+}
+
+/**
+ * snapd_fleet_client_run_finish:
+ * @fleet: a #SnapdFleetClient.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_fleet_client_run_async(). Errors from
+ * individual devices are reported in #SnapdFleetClient::device-completed.
+ *
+ * Returns: %TRUE if the request was run on all devices or %FALSE if it was cancelled.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_fleet_client_run_finish (SnapdFleetClient *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_FLEET_CLIENT (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+snapd_fleet_client_finalize (GObject *object)
+{
+    SnapdFleetClient *self = SNAPD_FLEET_CLIENT (object);
+
+    g_clear_pointer (&self->devices, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_fleet_client_parent_class)->finalize (object);
+}
+
+static void
+snapd_fleet_client_class_init (SnapdFleetClientClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_fleet_client_finalize;
+
+    /**
+     * SnapdFleetClient::device-completed:
+     * @fleet: a #SnapdFleetClient.
+     * @name: the name of the device.
+     * @client: the #SnapdClient for the device.
+     * @result: the #GAsyncResult of the request.
+     *
+     * Emitted when the request on a device completes. The handler gets the
+     * result by passing @client and @result to the finish function matching
+     * the request started, e.g. snapd_client_get_snaps_finish().
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_DEVICE_COMPLETED] = g_signal_new ("device-completed",
+                                                     G_TYPE_FROM_CLASS (klass),
+                                                     G_SIGNAL_RUN_LAST,
+                                                     0,
+                                                     NULL, NULL,
+                                                     NULL,
+                                                     G_TYPE_NONE, 3, G_TYPE_STRING, SNAPD_TYPE_CLIENT, G_TYPE_ASYNC_RESULT);
+}
+
+static void
+snapd_fleet_client_init (SnapdFleetClient *self)
+{
+    self->devices = g_ptr_array_new_with_free_func ((GDestroyNotify) fleet_device_free);
+    self->max_concurrent = DEFAULT_MAX_CONCURRENT;
+}
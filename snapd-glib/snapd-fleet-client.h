@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_FLEET_CLIENT_H__
+#define __SNAPD_FLEET_CLIENT_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_FLEET_CLIENT  (snapd_fleet_client_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdFleetClient, snapd_fleet_client, SNAPD, FLEET_CLIENT, GObject)
+
+/**
+ * SnapdFleetStartFunc:
+ * @client: the #SnapdClient for the device.
+ * @cancellable: (allow-none): a #GCancellable to pass to the request.
+ * @callback: (scope async): the #GAsyncReadyCallback to pass to the request.
+ * @callback_data: (closure): the data to pass to @callback.
+ * @user_data: (closure): the data passed to snapd_fleet_client_run_async().
+ *
+ * Start a request on one device, e.g. by calling snapd_client_get_snaps_async()
+ * with @cancellable, @callback and @callback_data.
+ *
+ * Since: 1.65
+ */
+typedef void (*SnapdFleetStartFunc) (SnapdClient         *client,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             callback_data,
+                                     gpointer             user_data);
+
+SnapdFleetClient *snapd_fleet_client_new                (void);
+
+SnapdClient      *snapd_fleet_client_add_device         (SnapdFleetClient     *fleet,
+                                                         const gchar          *name,
+                                                         const gchar          *socket_path);
+
+SnapdClient      *snapd_fleet_client_get_device         (SnapdFleetClient     *fleet,
+                                                         const gchar          *name);
+
+guint             snapd_fleet_client_get_n_devices      (SnapdFleetClient     *fleet);
+
+void              snapd_fleet_client_set_max_concurrent (SnapdFleetClient     *fleet,
+                                                         guint                 max_concurrent);
+
+guint             snapd_fleet_client_get_max_concurrent (SnapdFleetClient     *fleet);
+
+void              snapd_fleet_client_set_timeout        (SnapdFleetClient     *fleet,
+                                                         guint                 timeout);
+
+guint             snapd_fleet_client_get_timeout        (SnapdFleetClient     *fleet);
+
+void              snapd_fleet_client_run_async          (SnapdFleetClient     *fleet,
+                                                         SnapdFleetStartFunc   start_func,
+                                                         gpointer              start_data,
+                                                         GCancellable         *cancellable,
+                                                         GAsyncReadyCallback   callback,
+                                                         gpointer              user_data);
+gboolean          snapd_fleet_client_run_finish         (SnapdFleetClient     *fleet,
+                                                         GAsyncResult         *result,
+                                                         GError              **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_FLEET_CLIENT_H__ */
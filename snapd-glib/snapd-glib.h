@@ -14,29 +14,58 @@
 
 #include <snapd-glib/snapd-alias.h>
 #include <snapd-glib/snapd-app.h>
+#include <snapd-glib/snapd-app-list-model.h>
 #include <snapd-glib/snapd-assertion.h>
+#include <snapd-glib/snapd-assertion-store.h>
 #include <snapd-glib/snapd-auth-data.h>
+#include <snapd-glib/snapd-cache-manager.h>
+#include <snapd-glib/snapd-catalog-cache.h>
+#include <snapd-glib/snapd-change-list.h>
+#include <snapd-glib/snapd-change-summary.h>
+#include <snapd-glib/snapd-change-monitor.h>
 #include <snapd-glib/snapd-channel.h>
 #include <snapd-glib/snapd-client.h>
 #include <snapd-glib/snapd-connection.h>
+#include <snapd-glib/snapd-connection-graph.h>
 #include <snapd-glib/snapd-enum-types.h>
+#include <snapd-glib/snapd-download.h>
+#include <snapd-glib/snapd-download-cache.h>
 #include <snapd-glib/snapd-error.h>
+#include <snapd-glib/snapd-fleet-client.h>
 #include <snapd-glib/snapd-icon.h>
 #include <snapd-glib/snapd-interface.h>
+#include <snapd-glib/snapd-local-index.h>
+#include <snapd-glib/snapd-log.h>
 #include <snapd-glib/snapd-login.h>
 #include <snapd-glib/snapd-maintenance.h>
+#include <snapd-glib/snapd-markdown-buffer.h>
+#include <snapd-glib/snapd-markdown-document.h>
 #include <snapd-glib/snapd-markdown-node.h>
 #include <snapd-glib/snapd-markdown-parser.h>
 #include <snapd-glib/snapd-media.h>
+#include <snapd-glib/snapd-media-prefetcher.h>
+#include <snapd-glib/snapd-notice.h>
+#include <snapd-glib/snapd-notices-monitor.h>
+#include <snapd-glib/snapd-pending-request.h>
 #include <snapd-glib/snapd-plug.h>
 #include <snapd-glib/snapd-plug-ref.h>
 #include <snapd-glib/snapd-price.h>
+#include <snapd-glib/snapd-refreshable-cache.h>
+#include <snapd-glib/snapd-request-batch.h>
+#include <snapd-glib/snapd-request-timings.h>
+#include <snapd-glib/snapd-result-list.h>
 #include <snapd-glib/snapd-screenshot.h>
 #include <snapd-glib/snapd-slot.h>
 #include <snapd-glib/snapd-slot-ref.h>
 #include <snapd-glib/snapd-snap.h>
+#include <snapd-glib/snapd-snap-config.h>
+#include <snapd-glib/snapd-snap-list.h>
+#include <snapd-glib/snapd-snap-list-model.h>
+#include <snapd-glib/snapd-sorted-snap-model.h>
 #include <snapd-glib/snapd-system-information.h>
 #include <snapd-glib/snapd-task.h>
+#include <snapd-glib/snapd-transport.h>
+#include <snapd-glib/snapd-theme-status-cache.h>
 #include <snapd-glib/snapd-user-information.h>
 #include <snapd-glib/snapd-version.h>
 
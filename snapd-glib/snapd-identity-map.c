@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-identity-map.h"
+
+/* Process-wide map from a key describing the contents of an object to an
+ * existing object with those contents, so identical objects parsed from
+ * different responses can be shared. Objects are only weakly referenced;
+ * entries for objects that have been finalized are removed when the map
+ * next grows. Objects are shared between threads, so the map is locked. */
+
+/* Number of entries to allow before looking for ones that can be removed */
+#define MIN_SWEEP_SIZE 256
+
+G_LOCK_DEFINE_STATIC (identity_map);
+static GHashTable *identity_map = NULL;
+static guint sweep_size = MIN_SWEEP_SIZE;
+
+static void
+weak_ref_free (GWeakRef *ref)
+{
+    g_weak_ref_clear (ref);
+    g_slice_free (GWeakRef, ref);
+}
+
+static gboolean
+ref_is_dead (gpointer key, gpointer value, gpointer user_data)
+{
+    g_autoptr(GObject) object = g_weak_ref_get (value);
+    return object == NULL;
+}
+
+/* Returns: (transfer full) (allow-none): an existing object for @key. */
+GObject *
+_snapd_identity_map_lookup (const gchar *key)
+{
+    G_LOCK (identity_map);
+    GWeakRef *ref = identity_map != NULL ? g_hash_table_lookup (identity_map, key) : NULL;
+    GObject *object = ref != NULL ? g_weak_ref_get (ref) : NULL;
+    G_UNLOCK (identity_map);
+
+    return object;
+}
+
+/* Record @object as having the contents described by @key. If another thread
+ * added an object for the same key first, that one is returned instead.
+ * Returns: (transfer full): the object to use. */
+GObject *
+_snapd_identity_map_insert (const gchar *key, GObject *object)
+{
+    G_LOCK (identity_map);
+
+    if (identity_map == NULL)
+        identity_map = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) weak_ref_free);
+
+    GWeakRef *ref = g_hash_table_lookup (identity_map, key);
+    GObject *existing = ref != NULL ? g_weak_ref_get (ref) : NULL;
+    if (existing != NULL) {
+        G_UNLOCK (identity_map);
+        return existing;
+    }
+
+    if (ref != NULL)
+        g_weak_ref_set (ref, object);
+    else {
+        /* Drop entries for finalized objects before growing */
+        if (g_hash_table_size (identity_map) >= sweep_size) {
+            g_hash_table_foreach_remove (identity_map, ref_is_dead, NULL);
+            sweep_size = MAX (MIN_SWEEP_SIZE, g_hash_table_size (identity_map) * 2);
+        }
+
+        ref = g_slice_new0 (GWeakRef);
+        g_weak_ref_init (ref, object);
+        g_hash_table_insert (identity_map, g_strdup (key), ref);
+    }
+
+    G_UNLOCK (identity_map);
+
+    return g_object_ref (object);
+}
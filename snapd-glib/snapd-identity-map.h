@@ -0,0 +1,24 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_IDENTITY_MAP_H__
+#define __SNAPD_IDENTITY_MAP_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+GObject *_snapd_identity_map_lookup (const gchar *key);
+
+GObject *_snapd_identity_map_insert (const gchar *key,
+                                     GObject     *object);
+
+G_END_DECLS
+
+#endif /* __SNAPD_IDENTITY_MAP_H__ */
@@ -0,0 +1,705 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapd-local-index.h"
+
+#include "snapd-alias.h"
+
+/**
+ * SECTION: snapd-local-index
+ * @short_description: Fast searches over installed snaps
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdLocalIndex answers the lookups application launchers make over the
+ * installed snaps without making requests to snapd. Snaps are matched by
+ * prefix or with typing errors using snapd_local_index_find_prefix() and
+ * snapd_local_index_find_fuzzy(), which search the snap names, titles, app
+ * names and the words in the summaries. Apps can be found by common ID,
+ * desktop file and alias.
+ *
+ * Snaps are added with snapd_local_index_add_snap() or kept up to date from a
+ * #SnapdSnapList with snapd_local_index_track_snap_list().
+ *
+ * The index is not thread safe and should only be used from one thread.
+ */
+
+/**
+ * SnapdLocalIndex:
+ *
+ * #SnapdLocalIndex is an index over installed snaps.
+ *
+ * Since: 1.65
+ */
+
+/* Fields that are searched, in the order they are ranked */
+typedef enum
+{
+    FIELD_NAME,
+    FIELD_TITLE,
+    FIELD_APP,
+    FIELD_SUMMARY
+} Field;
+
+/* A normalized string that matches a snap */
+typedef struct
+{
+    gchar *key;
+    gunichar *chars;
+    glong n_chars;
+    Field field;
+    SnapdSnap *snap;
+} Term;
+
+struct _SnapdLocalIndex
+{
+    GObject parent_instance;
+
+    /* Indexed snaps by name */
+    GHashTable *snaps;
+
+    /* App names keyed by alias name, each as "snap.app" */
+    GHashTable *aliases;
+
+    /* Terms sorted by key, the indexes of the terms containing each trigram,
+     * apps keyed by common ID and desktop file. These are rebuilt by
+     * update_index() when the snaps change */
+    gboolean dirty;
+    GArray *terms;
+    GHashTable *trigrams;
+    GHashTable *apps_by_common_id;
+    GHashTable *apps_by_desktop_file;
+
+    SnapdSnapList *snap_list;
+    gulong snap_added_id;
+    gulong snap_removed_id;
+    gulong snap_changed_id;
+};
+
+G_DEFINE_TYPE (SnapdLocalIndex, snapd_local_index, G_TYPE_OBJECT)
+
+static void
+term_clear (Term *term)
+{
+    g_free (term->key);
+    g_free (term->chars);
+}
+
+static gchar *
+normalize (const gchar *text)
+{
+    g_autofree gchar *normalized = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
+    if (normalized == NULL)
+        return NULL;
+    return g_utf8_casefold (normalized, -1);
+}
+
+static void
+add_term (SnapdLocalIndex *self, const gchar *text, Field field, SnapdSnap *snap)
+{
+    if (text == NULL || text[0] == '\0')
+        return;
+
+    Term term;
+    term.key = normalize (text);
+    if (term.key == NULL)
+        return;
+    term.chars = g_utf8_to_ucs4_fast (term.key, -1, &term.n_chars);
+    term.field = field;
+    term.snap = snap;
+    g_array_append_val (self->terms, term);
+}
+
+/* Add @text and, if it has more than one, each word in it */
+static void
+add_terms (SnapdLocalIndex *self, const gchar *text, Field field, SnapdSnap *snap)
+{
+    if (text == NULL)
+        return;
+
+    add_term (self, text, field, snap);
+
+    g_autoptr(GPtrArray) words = g_ptr_array_new_with_free_func (g_free);
+    const gchar *word_start = NULL;
+    for (const gchar *c = text; ; c = g_utf8_next_char (c)) {
+        gunichar ch = g_utf8_get_char (c);
+        if (ch != 0 && g_unichar_isalnum (ch)) {
+            if (word_start == NULL)
+                word_start = c;
+            continue;
+        }
+
+        if (word_start != NULL)
+            g_ptr_array_add (words, g_strndup (word_start, c - word_start));
+        word_start = NULL;
+        if (ch == 0)
+            break;
+    }
+    if (words->len < 2)
+        return;
+    for (guint i = 0; i < words->len; i++)
+        add_term (self, g_ptr_array_index (words, i), field, snap);
+}
+
+static int
+compare_terms (const void *a, const void *b)
+{
+    const Term *term_a = a, *term_b = b;
+    return strcmp (term_a->key, term_b->key);
+}
+
+/* Rebuild the terms and lookup tables from the indexed snaps */
+static void
+update_index (SnapdLocalIndex *self)
+{
+    if (!self->dirty)
+        return;
+    self->dirty = FALSE;
+
+    g_array_set_size (self->terms, 0);
+    g_hash_table_remove_all (self->trigrams);
+    g_hash_table_remove_all (self->apps_by_common_id);
+    g_hash_table_remove_all (self->apps_by_desktop_file);
+
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, self->snaps);
+    gpointer value;
+    while (g_hash_table_iter_next (&iter, NULL, &value)) {
+        SnapdSnap *snap = value;
+
+        add_terms (self, snapd_snap_get_name (snap), FIELD_NAME, snap);
+        add_terms (self, snapd_snap_get_title (snap), FIELD_TITLE, snap);
+        add_terms (self, snapd_snap_get_summary (snap), FIELD_SUMMARY, snap);
+
+        GPtrArray *apps = snapd_snap_get_apps (snap);
+        for (guint i = 0; apps != NULL && i < apps->len; i++) {
+            SnapdApp *app = g_ptr_array_index (apps, i);
+
+            add_term (self, snapd_app_get_name (app), FIELD_APP, snap);
+
+            const gchar *common_id = snapd_app_get_common_id (app);
+            if (common_id != NULL)
+                g_hash_table_insert (self->apps_by_common_id, (gpointer) common_id, app);
+
+            /* Desktop files can be looked up by path or just the file name */
+            const gchar *desktop_file = snapd_app_get_desktop_file (app);
+            if (desktop_file != NULL) {
+                g_hash_table_insert (self->apps_by_desktop_file, g_strdup (desktop_file), app);
+                g_hash_table_insert (self->apps_by_desktop_file, g_path_get_basename (desktop_file), app);
+            }
+        }
+    }
+
+    qsort (self->terms->data, self->terms->len, sizeof (Term), compare_terms);
+
+    /* Index each term by the sequences of three characters it contains, to quickly find fuzzy match candidates */
+    for (guint i = 0; i < self->terms->len; i++) {
+        Term *term = &g_array_index (self->terms, Term, i);
+        const gchar *c = term->key;
+        for (glong j = 0; j + 3 <= term->n_chars; j++) {
+            const gchar *end = g_utf8_offset_to_pointer (c, 3);
+            g_autofree gchar *trigram = g_strndup (c, end - c);
+            GArray *term_indexes = g_hash_table_lookup (self->trigrams, trigram);
+            if (term_indexes == NULL) {
+                term_indexes = g_array_new (FALSE, FALSE, sizeof (guint));
+                g_hash_table_insert (self->trigrams, g_steal_pointer (&trigram), term_indexes);
+            }
+            if (term_indexes->len == 0 || g_array_index (term_indexes, guint, term_indexes->len - 1) != i)
+                g_array_append_val (term_indexes, i);
+            c = g_utf8_next_char (c);
+        }
+    }
+}
+
+/* A matching snap and how well it matched, lower is better */
+typedef struct
+{
+    SnapdSnap *snap;
+    guint score;
+} Match;
+
+static guint
+get_score (Term *term, guint distance, gboolean exact)
+{
+    return distance * 16 + term->field * 2 + (exact ? 0 : 1);
+}
+
+static void
+add_match (GHashTable *matches, Term *term, guint score)
+{
+    Match *match = g_hash_table_lookup (matches, term->snap);
+    if (match == NULL) {
+        match = g_new0 (Match, 1);
+        match->snap = term->snap;
+        match->score = score;
+        g_hash_table_insert (matches, term->snap, match);
+    }
+    else if (score < match->score)
+        match->score = score;
+}
+
+static int
+compare_matches (const void *a, const void *b)
+{
+    Match *match_a = *((Match **) a), *match_b = *((Match **) b);
+    if (match_a->score != match_b->score)
+        return match_a->score < match_b->score ? -1 : 1;
+    return strcmp (snapd_snap_get_name (match_a->snap), snapd_snap_get_name (match_b->snap));
+}
+
+/* Get the matched snaps, best match first */
+static GPtrArray *
+get_ranked_snaps (GHashTable *matches)
+{
+    g_autoptr(GPtrArray) ranked = g_ptr_array_new ();
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, matches);
+    gpointer value;
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+        g_ptr_array_add (ranked, value);
+    g_ptr_array_sort (ranked, compare_matches);
+
+    GPtrArray *snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; i < ranked->len; i++) {
+        Match *match = g_ptr_array_index (ranked, i);
+        g_ptr_array_add (snaps, g_object_ref (match->snap));
+    }
+
+    return snaps;
+}
+
+/* Get the smallest number of edits to turn @query into a prefix of @term,
+ * or a value greater than @max_distance if it is more than that */
+static guint
+get_prefix_distance (const gunichar *query, glong query_length, Term *term, guint max_distance)
+{
+    g_autofree guint *row = g_new (guint, term->n_chars + 1);
+    for (glong j = 0; j <= term->n_chars; j++)
+        row[j] = j;
+
+    for (glong i = 1; i <= query_length; i++) {
+        guint diagonal = row[0];
+        row[0] = i;
+        guint row_min = row[0];
+        for (glong j = 1; j <= term->n_chars; j++) {
+            guint above = row[j];
+            guint cost = query[i - 1] == term->chars[j - 1] ? 0 : 1;
+            row[j] = MIN (MIN (above + 1, row[j - 1] + 1), diagonal + cost);
+            diagonal = above;
+            row_min = MIN (row_min, row[j]);
+        }
+        if (row_min > max_distance)
+            return max_distance + 1;
+    }
+
+    /* The rest of the term after the matched prefix is free */
+    guint distance = row[0];
+    for (glong j = 1; j <= term->n_chars; j++)
+        distance = MIN (distance, row[j]);
+    return distance;
+}
+
+static void
+snap_added_cb (SnapdLocalIndex *self, SnapdSnap *snap)
+{
+    snapd_local_index_add_snap (self, snap);
+}
+
+static void
+snap_removed_cb (SnapdLocalIndex *self, SnapdSnap *snap)
+{
+    snapd_local_index_remove_snap (self, snapd_snap_get_name (snap));
+}
+
+static void
+disconnect_snap_list (SnapdLocalIndex *self)
+{
+    if (self->snap_list == NULL)
+        return;
+
+    g_signal_handler_disconnect (self->snap_list, self->snap_added_id);
+    g_signal_handler_disconnect (self->snap_list, self->snap_removed_id);
+    g_signal_handler_disconnect (self->snap_list, self->snap_changed_id);
+    g_clear_object (&self->snap_list);
+}
+
+/**
+ * snapd_local_index_new:
+ *
+ * Create a new empty index.
+ *
+ * Returns: a new #SnapdLocalIndex
+ *
+ * Since: 1.65
+ */
+SnapdLocalIndex *
+snapd_local_index_new (void)
+{
+    return g_object_new (SNAPD_TYPE_LOCAL_INDEX, NULL);
+}
+
+/**
+ * snapd_local_index_add_snap:
+ * @index: a #SnapdLocalIndex.
+ * @snap: a #SnapdSnap.
+ *
+ * Add a snap to the index, replacing any snap with the same name.
+ *
+ * Since: 1.65
+ */
+void
+snapd_local_index_add_snap (SnapdLocalIndex *self, SnapdSnap *snap)
+{
+    g_return_if_fail (SNAPD_IS_LOCAL_INDEX (self));
+    g_return_if_fail (SNAPD_IS_SNAP (snap));
+
+    g_hash_table_insert (self->snaps, g_strdup (snapd_snap_get_name (snap)), g_object_ref (snap));
+    self->dirty = TRUE;
+}
+
+/**
+ * snapd_local_index_remove_snap:
+ * @index: a #SnapdLocalIndex.
+ * @name: name of the snap to remove.
+ *
+ * Remove a snap from the index.
+ *
+ * Since: 1.65
+ */
+void
+snapd_local_index_remove_snap (SnapdLocalIndex *self, const gchar *name)
+{
+    g_return_if_fail (SNAPD_IS_LOCAL_INDEX (self));
+    g_return_if_fail (name != NULL);
+
+    if (g_hash_table_remove (self->snaps, name))
+        self->dirty = TRUE;
+}
+
+/**
+ * snapd_local_index_set_aliases:
+ * @index: a #SnapdLocalIndex.
+ * @aliases: (element-type SnapdAlias): the aliases from snapd_client_get_aliases_sync().
+ *
+ * Set the aliases used by snapd_local_index_lookup_alias(), replacing any
+ * previously set. Disabled aliases are ignored.
+ *
+ * Since: 1.65
+ */
+void
+snapd_local_index_set_aliases (SnapdLocalIndex *self, GPtrArray *aliases)
+{
+    g_return_if_fail (SNAPD_IS_LOCAL_INDEX (self));
+    g_return_if_fail (aliases != NULL);
+
+    g_hash_table_remove_all (self->aliases);
+    for (guint i = 0; i < aliases->len; i++) {
+        SnapdAlias *alias = g_ptr_array_index (aliases, i);
+        if (snapd_alias_get_status (alias) == SNAPD_ALIAS_STATUS_DISABLED)
+            continue;
+
+        const gchar *app = snapd_alias_get_app_manual (alias);
+        if (app == NULL)
+            app = snapd_alias_get_app_auto (alias);
+        if (app == NULL)
+            continue;
+        g_hash_table_insert (self->aliases, g_strdup (snapd_alias_get_name (alias)), g_strdup_printf ("%s.%s", snapd_alias_get_snap (alias), app));
+    }
+}
+
+/**
+ * snapd_local_index_track_snap_list:
+ * @index: a #SnapdLocalIndex.
+ * @list: (allow-none): a #SnapdSnapList or %NULL to stop tracking.
+ *
+ * Index the snaps in @list and update the index as the list changes. This
+ * replaces any snaps previously added.
+ *
+ * Since: 1.65
+ */
+void
+snapd_local_index_track_snap_list (SnapdLocalIndex *self, SnapdSnapList *list)
+{
+    g_return_if_fail (SNAPD_IS_LOCAL_INDEX (self));
+    g_return_if_fail (list == NULL || SNAPD_IS_SNAP_LIST (list));
+
+    disconnect_snap_list (self);
+    g_hash_table_remove_all (self->snaps);
+    self->dirty = TRUE;
+    if (list == NULL)
+        return;
+
+    self->snap_list = g_object_ref (list);
+    self->snap_added_id = g_signal_connect_swapped (list, "snap-added", G_CALLBACK (snap_added_cb), self);
+    self->snap_removed_id = g_signal_connect_swapped (list, "snap-removed", G_CALLBACK (snap_removed_cb), self);
+    self->snap_changed_id = g_signal_connect_swapped (list, "snap-changed", G_CALLBACK (snap_added_cb), self);
+
+    GPtrArray *snaps = snapd_snap_list_get_snaps (list);
+    for (guint i = 0; i < snaps->len; i++)
+        snapd_local_index_add_snap (self, g_ptr_array_index (snaps, i));
+}
+
+/**
+ * snapd_local_index_get_n_snaps:
+ * @index: a #SnapdLocalIndex.
+ *
+ * Get the number of snaps in the index.
+ *
+ * Returns: the number of snaps.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_local_index_get_n_snaps (SnapdLocalIndex *self)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), 0);
+    return g_hash_table_size (self->snaps);
+}
+
+/**
+ * snapd_local_index_find_prefix:
+ * @index: a #SnapdLocalIndex.
+ * @prefix: text to match.
+ *
+ * Find the snaps with a name, title, app name or summary word that starts
+ * with @prefix. Matching ignores case. Snaps are ordered with exact matches
+ * first, then by the field matched in the order name, title, app and summary.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_local_index_find_prefix (SnapdLocalIndex *self, const gchar *prefix)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), NULL);
+    g_return_val_if_fail (prefix != NULL, NULL);
+
+    update_index (self);
+
+    g_autoptr(GHashTable) matches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+    g_autofree gchar *key = normalize (prefix);
+    if (key == NULL)
+        return get_ranked_snaps (matches);
+    gsize key_length = strlen (key);
+
+    /* Find the first term not less than the prefix, and all the terms from there with the prefix */
+    guint start = 0, end = self->terms->len;
+    while (start < end) {
+        guint mid = start + (end - start) / 2;
+        if (strcmp (g_array_index (self->terms, Term, mid).key, key) < 0)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+    for (guint i = start; i < self->terms->len; i++) {
+        Term *term = &g_array_index (self->terms, Term, i);
+        if (strncmp (term->key, key, key_length) != 0)
+            break;
+        add_match (matches, term, get_score (term, 0, term->key[key_length] == '\0'));
+    }
+
+    return get_ranked_snaps (matches);
+}
+
+/**
+ * snapd_local_index_find_fuzzy:
+ * @index: a #SnapdLocalIndex.
+ * @query: text to match.
+ * @max_distance: the maximum number of characters that can be inserted,
+ *     deleted or changed for @query to match.
+ *
+ * Find the snaps with a name, title, app name or summary word that starts
+ * with @query, allowing up to @max_distance typing errors. Matching ignores
+ * case. Snaps are ordered by the fewest errors, then as for
+ * snapd_local_index_find_prefix().
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_local_index_find_fuzzy (SnapdLocalIndex *self, const gchar *query, guint max_distance)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), NULL);
+    g_return_val_if_fail (query != NULL, NULL);
+
+    update_index (self);
+
+    g_autoptr(GHashTable) matches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+    g_autofree gchar *key = normalize (query);
+    if (key == NULL)
+        return get_ranked_snaps (matches);
+    glong query_length;
+    g_autofree gunichar *query_chars = g_utf8_to_ucs4_fast (key, -1, &query_length);
+
+    /* Each error changes at most three trigrams, so a match must share the
+     * rest of the query trigrams. Short queries have to check every term */
+    g_autoptr(GHashTable) query_trigrams = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    const gchar *c = key;
+    for (glong i = 0; i + 3 <= query_length; i++) {
+        const gchar *end = g_utf8_offset_to_pointer (c, 3);
+        g_hash_table_add (query_trigrams, g_strndup (c, end - c));
+        c = g_utf8_next_char (c);
+    }
+    gint min_shared = (gint) g_hash_table_size (query_trigrams) - 3 * (gint) max_distance;
+
+    g_autofree guint *shared = NULL;
+    if (min_shared > 0) {
+        shared = g_new0 (guint, self->terms->len);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, query_trigrams);
+        gpointer trigram;
+        while (g_hash_table_iter_next (&iter, &trigram, NULL)) {
+            GArray *term_indexes = g_hash_table_lookup (self->trigrams, trigram);
+            for (guint i = 0; term_indexes != NULL && i < term_indexes->len; i++)
+                shared[g_array_index (term_indexes, guint, i)]++;
+        }
+    }
+
+    for (guint i = 0; i < self->terms->len; i++) {
+        if (shared != NULL && shared[i] < (guint) min_shared)
+            continue;
+
+        Term *term = &g_array_index (self->terms, Term, i);
+        guint distance = get_prefix_distance (query_chars, query_length, term, max_distance);
+        if (distance <= max_distance)
+            add_match (matches, term, get_score (term, distance, term->n_chars == query_length));
+    }
+
+    return get_ranked_snaps (matches);
+}
+
+/**
+ * snapd_local_index_lookup_common_id:
+ * @index: a #SnapdLocalIndex.
+ * @common_id: a common ID, e.g. "org.example.App".
+ *
+ * Find the app with the given common ID.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdApp or %NULL if none found.
+ *
+ * Since: 1.65
+ */
+SnapdApp *
+snapd_local_index_lookup_common_id (SnapdLocalIndex *self, const gchar *common_id)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), NULL);
+    g_return_val_if_fail (common_id != NULL, NULL);
+
+    update_index (self);
+    return g_hash_table_lookup (self->apps_by_common_id, common_id);
+}
+
+/**
+ * snapd_local_index_lookup_desktop_file:
+ * @index: a #SnapdLocalIndex.
+ * @desktop_file: path or file name of a desktop file.
+ *
+ * Find the app with the given desktop file. This can be the full path or just
+ * the file name, e.g. "example_app.desktop".
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdApp or %NULL if none found.
+ *
+ * Since: 1.65
+ */
+SnapdApp *
+snapd_local_index_lookup_desktop_file (SnapdLocalIndex *self, const gchar *desktop_file)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), NULL);
+    g_return_val_if_fail (desktop_file != NULL, NULL);
+
+    update_index (self);
+    return g_hash_table_lookup (self->apps_by_desktop_file, desktop_file);
+}
+
+/**
+ * snapd_local_index_lookup_alias:
+ * @index: a #SnapdLocalIndex.
+ * @alias: an alias name.
+ *
+ * Find the app an alias runs. The aliases must have been set with
+ * snapd_local_index_set_aliases().
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdApp or %NULL if none found.
+ *
+ * Since: 1.65
+ */
+SnapdApp *
+snapd_local_index_lookup_alias (SnapdLocalIndex *self, const gchar *alias)
+{
+    g_return_val_if_fail (SNAPD_IS_LOCAL_INDEX (self), NULL);
+    g_return_val_if_fail (alias != NULL, NULL);
+
+    const gchar *app_name = g_hash_table_lookup (self->aliases, alias);
+    if (app_name == NULL)
+        return NULL;
+    const gchar *dot = strchr (app_name, '.');
+    g_autofree gchar *snap_name = g_strndup (app_name, dot - app_name);
+
+    SnapdSnap *snap = g_hash_table_lookup (self->snaps, snap_name);
+    if (snap == NULL)
+        return NULL;
+    GPtrArray *apps = snapd_snap_get_apps (snap);
+    for (guint i = 0; apps != NULL && i < apps->len; i++) {
+        SnapdApp *app = g_ptr_array_index (apps, i);
+        if (g_strcmp0 (snapd_app_get_name (app), dot + 1) == 0)
+            return app;
+    }
+
+    return NULL;
+}
+
+static void
+snapd_local_index_dispose (GObject *object)
+{
+    SnapdLocalIndex *self = SNAPD_LOCAL_INDEX (object);
+
+    disconnect_snap_list (self);
+
+    G_OBJECT_CLASS (snapd_local_index_parent_class)->dispose (object);
+}
+
+static void
+snapd_local_index_finalize (GObject *object)
+{
+    SnapdLocalIndex *self = SNAPD_LOCAL_INDEX (object);
+
+    g_clear_pointer (&self->apps_by_desktop_file, g_hash_table_unref);
+    g_clear_pointer (&self->apps_by_common_id, g_hash_table_unref);
+    g_clear_pointer (&self->trigrams, g_hash_table_unref);
+    g_clear_pointer (&self->terms, g_array_unref);
+    g_clear_pointer (&self->aliases, g_hash_table_unref);
+    g_clear_pointer (&self->snaps, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_local_index_parent_class)->finalize (object);
+}
+
+static void
+snapd_local_index_class_init (SnapdLocalIndexClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->dispose = snapd_local_index_dispose;
+    gobject_class->finalize = snapd_local_index_finalize;
+}
+
+static void
+snapd_local_index_init (SnapdLocalIndex *self)
+{
+    self->snaps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    self->aliases = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    self->terms = g_array_new (FALSE, FALSE, sizeof (Term));
+    g_array_set_clear_func (self->terms, (GDestroyNotify) term_clear);
+    self->trigrams = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_array_unref);
+    self->apps_by_common_id = g_hash_table_new (g_str_hash, g_str_equal);
+    self->apps_by_desktop_file = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
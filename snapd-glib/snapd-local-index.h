@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_LOCAL_INDEX_H__
+#define __SNAPD_LOCAL_INDEX_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+#include <snapd-glib/snapd-app.h>
+#include <snapd-glib/snapd-snap.h>
+#include <snapd-glib/snapd-snap-list.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_LOCAL_INDEX  (snapd_local_index_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdLocalIndex, snapd_local_index, SNAPD, LOCAL_INDEX, GObject)
+
+SnapdLocalIndex *snapd_local_index_new                  (void);
+
+void             snapd_local_index_add_snap             (SnapdLocalIndex *index,
+                                                         SnapdSnap       *snap);
+
+void             snapd_local_index_remove_snap          (SnapdLocalIndex *index,
+                                                         const gchar     *name);
+
+void             snapd_local_index_set_aliases          (SnapdLocalIndex *index,
+                                                         GPtrArray       *aliases);
+
+void             snapd_local_index_track_snap_list      (SnapdLocalIndex *index,
+                                                         SnapdSnapList   *list);
+
+guint            snapd_local_index_get_n_snaps          (SnapdLocalIndex *index);
+
+GPtrArray       *snapd_local_index_find_prefix          (SnapdLocalIndex *index,
+                                                         const gchar     *prefix);
+
+GPtrArray       *snapd_local_index_find_fuzzy           (SnapdLocalIndex *index,
+                                                         const gchar     *query,
+                                                         guint            max_distance);
+
+SnapdApp        *snapd_local_index_lookup_common_id     (SnapdLocalIndex *index,
+                                                         const gchar     *common_id);
+
+SnapdApp        *snapd_local_index_lookup_desktop_file  (SnapdLocalIndex *index,
+                                                         const gchar     *desktop_file);
+
+SnapdApp        *snapd_local_index_lookup_alias         (SnapdLocalIndex *index,
+                                                         const gchar     *alias);
+
+G_END_DECLS
+
+#endif /* __SNAPD_LOCAL_INDEX_H__ */
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-log.h"
+
+/**
+ * SECTION:snapd-log
+ * @short_description: Service log entries
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdLog is a line written to the log by a snap service.
+ * Logs can be retrieved using snapd_client_get_logs_sync() or followed as
+ * they are written using snapd_client_follow_logs_sync().
+ */
+
+/**
+ * SnapdLog:
+ *
+ * #SnapdLog contains a service log entry.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdLog
+{
+    GObject parent_instance;
+
+    GDateTime *timestamp;
+    gchar *sid;
+    gchar *pid;
+    gchar *message;
+};
+
+enum
+{
+    PROP_TIMESTAMP = 1,
+    PROP_SID,
+    PROP_PID,
+    PROP_MESSAGE,
+    PROP_LAST
+};
+
+G_DEFINE_TYPE (SnapdLog, snapd_log, G_TYPE_OBJECT)
+
+/**
+ * snapd_log_get_timestamp:
+ * @log: a #SnapdLog.
+ *
+ * Get the time this entry was written.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_log_get_timestamp (SnapdLog *self)
+{
+    g_return_val_if_fail (SNAPD_IS_LOG (self), NULL);
+    return self->timestamp;
+}
+
+/**
+ * snapd_log_get_sid:
+ * @log: a #SnapdLog.
+ *
+ * Get the syslog identifier of the service that wrote this entry, e.g. "snap.http.service".
+ *
+ * Returns: a syslog identifier.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_log_get_sid (SnapdLog *self)
+{
+    g_return_val_if_fail (SNAPD_IS_LOG (self), NULL);
+    return self->sid;
+}
+
+/**
+ * snapd_log_get_pid:
+ * @log: a #SnapdLog.
+ *
+ * Get the process ID that wrote this entry.
+ *
+ * Returns: a process ID.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_log_get_pid (SnapdLog *self)
+{
+    g_return_val_if_fail (SNAPD_IS_LOG (self), NULL);
+    return self->pid;
+}
+
+/**
+ * snapd_log_get_message:
+ * @log: a #SnapdLog.
+ *
+ * Get the text of this entry.
+ *
+ * Returns: message text.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_log_get_message (SnapdLog *self)
+{
+    g_return_val_if_fail (SNAPD_IS_LOG (self), NULL);
+    return self->message;
+}
+
+static void
+snapd_log_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+    SnapdLog *self = SNAPD_LOG (object);
+
+    switch (prop_id) {
+    case PROP_TIMESTAMP:
+        g_clear_pointer (&self->timestamp, g_date_time_unref);
+        if (g_value_get_boxed (value) != NULL)
+            self->timestamp = g_date_time_ref (g_value_get_boxed (value));
+        break;
+    case PROP_SID:
+        g_free (self->sid);
+        self->sid = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_PID:
+        g_free (self->pid);
+        self->pid = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_MESSAGE:
+        g_free (self->message);
+        self->message = g_strdup (g_value_get_string (value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_log_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    SnapdLog *self = SNAPD_LOG (object);
+
+    switch (prop_id) {
+    case PROP_TIMESTAMP:
+        g_value_set_boxed (value, self->timestamp);
+        break;
+    case PROP_SID:
+        g_value_set_string (value, self->sid);
+        break;
+    case PROP_PID:
+        g_value_set_string (value, self->pid);
+        break;
+    case PROP_MESSAGE:
+        g_value_set_string (value, self->message);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_log_finalize (GObject *object)
+{
+    SnapdLog *self = SNAPD_LOG (object);
+
+    g_clear_pointer (&self->timestamp, g_date_time_unref);
+    g_clear_pointer (&self->sid, g_free);
+    g_clear_pointer (&self->pid, g_free);
+    g_clear_pointer (&self->message, g_free);
+
+    G_OBJECT_CLASS (snapd_log_parent_class)->finalize (object);
+}
+
+static void
+snapd_log_class_init (SnapdLogClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->set_property = snapd_log_set_property;
+    gobject_class->get_property = snapd_log_get_property;
+    gobject_class->finalize = snapd_log_finalize;
+
+    g_object_class_install_property (gobject_class,
+                                     PROP_TIMESTAMP,
+                                     g_param_spec_boxed ("timestamp",
+                                                         "timestamp",
+                                                         "Time entry was written",
+                                                         G_TYPE_DATE_TIME,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_SID,
+                                     g_param_spec_string ("sid",
+                                                          "sid",
+                                                          "Syslog identifier",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_PID,
+                                     g_param_spec_string ("pid",
+                                                          "pid",
+                                                          "Process ID",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_MESSAGE,
+                                     g_param_spec_string ("message",
+                                                          "message",
+                                                          "Message text",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+}
+
+static void
+snapd_log_init (SnapdLog *self)
+{
+}
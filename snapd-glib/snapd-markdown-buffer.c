@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-markdown-buffer.h"
+#include "snapd-markdown-parser-private.h"
+
+/**
+ * SECTION:snapd-markdown-buffer
+ * @short_description: Incrementally parsed markdown text
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdMarkdownBuffer holds markdown text that is being edited, for
+ * example when showing a live preview of a snap description. When the text
+ * is changed with snapd_markdown_buffer_replace () only the blocks around the
+ * edit are parsed again, and the top level nodes that were replaced are
+ * reported so a preview only has to update those.
+ *
+ * The nodes are the same as snapd_markdown_parser_parse () would return for
+ * the whole text.
+ */
+
+/**
+ * SnapdMarkdownBuffer:
+ *
+ * #SnapdMarkdownBuffer is an opaque data structure and can only be accessed
+ * using the provided functions.
+ *
+ * Since: 1.65
+ */
+struct _SnapdMarkdownBuffer
+{
+    GObject parent_instance;
+
+    SnapdMarkdownParser *parser;
+    gboolean preserve_whitespace;
+
+    GString *text;
+    GPtrArray *nodes;
+
+    /* Lines where parsing can start again, in order */
+    GArray *restarts;
+};
+
+G_DEFINE_TYPE (SnapdMarkdownBuffer, snapd_markdown_buffer, G_TYPE_OBJECT)
+
+static void
+parse_all (SnapdMarkdownBuffer *self)
+{
+    self->preserve_whitespace = snapd_markdown_parser_get_preserve_whitespace (self->parser);
+    g_array_set_size (self->restarts, 0);
+    g_clear_pointer (&self->nodes, g_ptr_array_unref);
+    self->nodes = _snapd_markdown_parser_parse_blocks (self->parser, self->text->str, 0, 0, self->restarts, NULL, 0, 0, NULL);
+}
+
+/**
+ * snapd_markdown_buffer_new:
+ * @parser: a #SnapdMarkdownParser to parse with.
+ * @text: the initial text.
+ *
+ * Create a buffer to edit markdown text in.
+ *
+ * Returns: a new #SnapdMarkdownBuffer
+ *
+ * Since: 1.65
+ */
+SnapdMarkdownBuffer *
+snapd_markdown_buffer_new (SnapdMarkdownParser *parser, const gchar *text)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (parser), NULL);
+    g_return_val_if_fail (text != NULL, NULL);
+
+    SnapdMarkdownBuffer *self = g_object_new (SNAPD_TYPE_MARKDOWN_BUFFER, NULL);
+    self->parser = g_object_ref (parser);
+    self->text = g_string_new (text);
+    parse_all (self);
+
+    return self;
+}
+
+/**
+ * snapd_markdown_buffer_get_text:
+ * @buffer: a #SnapdMarkdownBuffer.
+ *
+ * Get the current text.
+ *
+ * Returns: the text in the buffer.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_markdown_buffer_get_text (SnapdMarkdownBuffer *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_BUFFER (self), NULL);
+    return self->text->str;
+}
+
+/**
+ * snapd_markdown_buffer_get_nodes:
+ * @buffer: a #SnapdMarkdownBuffer.
+ *
+ * Get the top level nodes of the current text. The array is changed by
+ * snapd_markdown_buffer_replace ().
+ *
+ * Returns: (transfer none) (element-type SnapdMarkdownNode): Text split into blocks.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_markdown_buffer_get_nodes (SnapdMarkdownBuffer *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_BUFFER (self), NULL);
+    return self->nodes;
+}
+
+/**
+ * snapd_markdown_buffer_replace:
+ * @buffer: a #SnapdMarkdownBuffer.
+ * @offset: offset in bytes of the text to replace.
+ * @length: length in bytes of the text to replace.
+ * @text: text to insert at @offset.
+ * @position: (out) (allow-none): location to store the index of the first node that changed.
+ * @n_removed: (out) (allow-none): location to store the number of nodes removed at @position.
+ * @n_added: (out) (allow-none): location to store the number of nodes added at @position.
+ *
+ * Replace @length bytes of the text at @offset with @text, for example to
+ * apply a change made in an editor. Parsing starts again from the last line
+ * before the edit where no block is open, and stops at the first such line
+ * after the edit which was also one before it, as the nodes after that are
+ * unchanged. If the parser settings have changed since the last parse then
+ * all the text is parsed again.
+ *
+ * Since: 1.65
+ */
+void
+snapd_markdown_buffer_replace (SnapdMarkdownBuffer *self, gsize offset, gsize length, const gchar *text,
+                               guint *position, guint *n_removed, guint *n_added)
+{
+    g_return_if_fail (SNAPD_IS_MARKDOWN_BUFFER (self));
+    g_return_if_fail (offset <= self->text->len && length <= self->text->len - offset);
+    g_return_if_fail (text != NULL);
+
+    gsize text_length = strlen (text);
+    g_string_erase (self->text, offset, length);
+    g_string_insert_len (self->text, offset, text, text_length);
+
+    if (snapd_markdown_parser_get_preserve_whitespace (self->parser) != self->preserve_whitespace) {
+        guint n_old_nodes = self->nodes->len;
+        parse_all (self);
+        if (position != NULL)
+            *position = 0;
+        if (n_removed != NULL)
+            *n_removed = n_old_nodes;
+        if (n_added != NULL)
+            *n_added = self->nodes->len;
+        return;
+    }
+
+    /* Find the last restart point before the edit, the text before it is unchanged.
+     * The first line always starts at a restart point */
+    guint first = 0;
+    while (first + 1 < self->restarts->len && g_array_index (self->restarts, SnapdMarkdownRestartPoint, first + 1).offset < offset)
+        first++;
+    SnapdMarkdownRestartPoint start = { 0, 0 };
+    if (first < self->restarts->len)
+        start = g_array_index (self->restarts, SnapdMarkdownRestartPoint, first);
+
+    g_autoptr(GArray) restarts = g_array_new (FALSE, FALSE, sizeof (SnapdMarkdownRestartPoint));
+    g_array_append_vals (restarts, self->restarts->data, first);
+    guint stop_index = G_MAXUINT;
+    g_autoptr(GPtrArray) nodes = _snapd_markdown_parser_parse_blocks (self->parser, self->text->str, start.offset, start.n_nodes,
+                                                                      restarts, self->restarts, offset + text_length,
+                                                                      (gssize) text_length - (gssize) length, &stop_index);
+
+    /* The nodes after the stop are the same as before, moved by the change in length */
+    guint end = self->nodes->len;
+    if (stop_index != G_MAXUINT)
+        end = g_array_index (self->restarts, SnapdMarkdownRestartPoint, stop_index).n_nodes;
+    guint removed = end - start.n_nodes;
+    for (guint i = stop_index; stop_index != G_MAXUINT && i < self->restarts->len; i++) {
+        SnapdMarkdownRestartPoint point = g_array_index (self->restarts, SnapdMarkdownRestartPoint, i);
+        point.offset = point.offset + text_length - length;
+        point.n_nodes = point.n_nodes - removed + nodes->len;
+        g_array_append_val (restarts, point);
+    }
+    g_array_unref (self->restarts);
+    self->restarts = g_steal_pointer (&restarts);
+
+    g_ptr_array_remove_range (self->nodes, start.n_nodes, removed);
+    for (guint i = 0; i < nodes->len; i++)
+        g_ptr_array_insert (self->nodes, start.n_nodes + i, g_object_ref (g_ptr_array_index (nodes, i)));
+
+    if (position != NULL)
+        *position = start.n_nodes;
+    if (n_removed != NULL)
+        *n_removed = removed;
+    if (n_added != NULL)
+        *n_added = nodes->len;
+}
+
+static void
+snapd_markdown_buffer_finalize (GObject *object)
+{
+    SnapdMarkdownBuffer *self = SNAPD_MARKDOWN_BUFFER (object);
+
+    g_clear_object (&self->parser);
+    if (self->text != NULL)
+        g_string_free (self->text, TRUE);
+    self->text = NULL;
+    g_clear_pointer (&self->nodes, g_ptr_array_unref);
+    g_clear_pointer (&self->restarts, g_array_unref);
+
+    G_OBJECT_CLASS (snapd_markdown_buffer_parent_class)->finalize (object);
+}
+
+static void
+snapd_markdown_buffer_class_init (SnapdMarkdownBufferClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_markdown_buffer_finalize;
+}
+
+static void
+snapd_markdown_buffer_init (SnapdMarkdownBuffer *self)
+{
+    self->restarts = g_array_new (FALSE, FALSE, sizeof (SnapdMarkdownRestartPoint));
+}
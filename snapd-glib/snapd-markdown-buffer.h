@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MARKDOWN_BUFFER_H__
+#define __SNAPD_MARKDOWN_BUFFER_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <snapd-glib/snapd-markdown-parser.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_MARKDOWN_BUFFER  (snapd_markdown_buffer_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdMarkdownBuffer, snapd_markdown_buffer, SNAPD, MARKDOWN_BUFFER, GObject)
+
+SnapdMarkdownBuffer *snapd_markdown_buffer_new       (SnapdMarkdownParser *parser,
+                                                      const gchar         *text);
+
+const gchar         *snapd_markdown_buffer_get_text  (SnapdMarkdownBuffer *buffer);
+
+GPtrArray           *snapd_markdown_buffer_get_nodes (SnapdMarkdownBuffer *buffer);
+
+void                 snapd_markdown_buffer_replace   (SnapdMarkdownBuffer *buffer,
+                                                      gsize                offset,
+                                                      gsize                length,
+                                                      const gchar         *text,
+                                                      guint               *position,
+                                                      guint               *n_removed,
+                                                      guint               *n_added);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MARKDOWN_BUFFER_H__ */
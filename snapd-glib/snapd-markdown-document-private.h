@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MARKDOWN_DOCUMENT_PRIVATE_H__
+#define __SNAPD_MARKDOWN_DOCUMENT_PRIVATE_H__
+
+#include "snapd-markdown-document.h"
+
+G_BEGIN_DECLS
+
+SnapdMarkdownDocument *_snapd_markdown_document_new (GPtrArray *nodes);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MARKDOWN_DOCUMENT_PRIVATE_H__ */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-markdown-document-private.h"
+
+/**
+ * SECTION:snapd-markdown-document
+ * @short_description: Flat markdown parse result
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdMarkdownDocument contains the result of snapd_markdown_parser_parse_flat ().
+ *
+ * The nodes are stored in a single array of #SnapdMarkdownFlatNode, in
+ * document order, and the text of all the nodes is stored in a single string.
+ * The nodes can be walked without allocating any memory. The top level nodes
+ * start at index 0 and are linked using the @next_sibling field, and the
+ * children of each node are linked from its @first_child field.
+ */
+
+/**
+ * SnapdMarkdownDocument:
+ *
+ * #SnapdMarkdownDocument is an opaque data structure and can only be accessed
+ * using the provided functions.
+ *
+ * Since: 1.65
+ */
+struct _SnapdMarkdownDocument
+{
+    GObject parent_instance;
+
+    GArray *nodes;
+    GString *text;
+};
+
+G_DEFINE_TYPE (SnapdMarkdownDocument, snapd_markdown_document, G_TYPE_OBJECT)
+
+static gint
+add_nodes (SnapdMarkdownDocument *self, GPtrArray *nodes)
+{
+    gint first_index = -1, last_index = -1;
+    for (guint i = 0; i < nodes->len; i++) {
+        SnapdMarkdownNode *node = g_ptr_array_index (nodes, i);
+
+        SnapdMarkdownFlatNode flat_node = { snapd_markdown_node_get_node_type (node), 0, 0, -1, -1 };
+        const gchar *text = snapd_markdown_node_get_text (node);
+        if (text != NULL) {
+            flat_node.text_offset = self->text->len;
+            flat_node.text_length = strlen (text);
+
+            /* Keep the nul terminator so the text can be used directly */
+            g_string_append_len (self->text, text, flat_node.text_length + 1);
+        }
+
+        gint index = self->nodes->len;
+        g_array_append_val (self->nodes, flat_node);
+        if (last_index >= 0)
+            g_array_index (self->nodes, SnapdMarkdownFlatNode, last_index).next_sibling = index;
+        else
+            first_index = index;
+        last_index = index;
+
+        GPtrArray *children = snapd_markdown_node_get_children (node);
+        if (children != NULL) {
+            gint first_child = add_nodes (self, children);
+            g_array_index (self->nodes, SnapdMarkdownFlatNode, index).first_child = first_child;
+        }
+    }
+
+    return first_index;
+}
+
+SnapdMarkdownDocument *
+_snapd_markdown_document_new (GPtrArray *nodes)
+{
+    SnapdMarkdownDocument *self = g_object_new (SNAPD_TYPE_MARKDOWN_DOCUMENT, NULL);
+
+    add_nodes (self, nodes);
+
+    return self;
+}
+
+/**
+ * snapd_markdown_document_get_nodes:
+ * @document: a #SnapdMarkdownDocument.
+ * @n_nodes: (out): location to store the number of nodes.
+ *
+ * Get the nodes in this document. The top level nodes start at index 0.
+ *
+ * Returns: (transfer none) (array length=n_nodes): the nodes in this document.
+ *
+ * Since: 1.65
+ */
+const SnapdMarkdownFlatNode *
+snapd_markdown_document_get_nodes (SnapdMarkdownDocument *self, guint *n_nodes)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_DOCUMENT (self), NULL);
+    g_return_val_if_fail (n_nodes != NULL, NULL);
+
+    *n_nodes = self->nodes->len;
+    return (const SnapdMarkdownFlatNode *) self->nodes->data;
+}
+
+/**
+ * snapd_markdown_document_get_text:
+ * @document: a #SnapdMarkdownDocument.
+ *
+ * Get the text referenced by the nodes in this document. The text of each node
+ * is nul-terminated, so the text at the @text_offset of a node can be used as
+ * a string.
+ *
+ * Returns: the text of all the nodes in this document.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_markdown_document_get_text (SnapdMarkdownDocument *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_DOCUMENT (self), NULL);
+    return self->text->str;
+}
+
+static void
+snapd_markdown_document_finalize (GObject *object)
+{
+    SnapdMarkdownDocument *self = SNAPD_MARKDOWN_DOCUMENT (object);
+
+    g_array_unref (self->nodes);
+    g_string_free (self->text, TRUE);
+
+    G_OBJECT_CLASS (snapd_markdown_document_parent_class)->finalize (object);
+}
+
+static void
+snapd_markdown_document_class_init (SnapdMarkdownDocumentClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_markdown_document_finalize;
+}
+
+static void
+snapd_markdown_document_init (SnapdMarkdownDocument *self)
+{
+    self->nodes = g_array_new (FALSE, FALSE, sizeof (SnapdMarkdownFlatNode));
+    self->text = g_string_new ("");
+}
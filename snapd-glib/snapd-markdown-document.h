@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MARKDOWN_DOCUMENT_H__
+#define __SNAPD_MARKDOWN_DOCUMENT_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <snapd-glib/snapd-markdown-node.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_MARKDOWN_DOCUMENT  (snapd_markdown_document_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdMarkdownDocument, snapd_markdown_document, SNAPD, MARKDOWN_DOCUMENT, GObject)
+
+/**
+ * SnapdMarkdownFlatNode:
+ * @node_type: the type of node.
+ * @text_offset: offset of the node text in the document text, only valid for nodes of type %SNAPD_MARKDOWN_NODE_TYPE_TEXT.
+ * @text_length: length of the node text in bytes.
+ * @first_child: index of the first child of this node or -1 if it has no children.
+ * @next_sibling: index of the next node with the same parent or -1 if this is the last.
+ *
+ * A markdown node in a #SnapdMarkdownDocument.
+ *
+ * Since: 1.65
+ */
+typedef struct
+{
+    SnapdMarkdownNodeType node_type;
+    guint text_offset;
+    guint text_length;
+    gint first_child;
+    gint next_sibling;
+} SnapdMarkdownFlatNode;
+
+const SnapdMarkdownFlatNode *snapd_markdown_document_get_nodes (SnapdMarkdownDocument *document,
+                                                                guint                 *n_nodes);
+
+const gchar                 *snapd_markdown_document_get_text  (SnapdMarkdownDocument *document);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MARKDOWN_DOCUMENT_H__ */
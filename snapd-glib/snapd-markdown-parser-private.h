@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MARKDOWN_PARSER_PRIVATE_H__
+#define __SNAPD_MARKDOWN_PARSER_PRIVATE_H__
+
+#include "snapd-markdown-parser.h"
+
+G_BEGIN_DECLS
+
+/* A line where no block is open, so parsing can start again from it */
+typedef struct
+{
+    gsize offset;
+    /* Number of top level nodes completed before this line */
+    guint n_nodes;
+} SnapdMarkdownRestartPoint;
+
+GPtrArray *_snapd_markdown_parser_parse_blocks (SnapdMarkdownParser *parser,
+                                                const gchar         *text,
+                                                gsize                start,
+                                                guint                n_previous_nodes,
+                                                GArray              *restarts,
+                                                GArray              *stop_points,
+                                                gsize                stop_after,
+                                                gssize               shift,
+                                                guint               *stop_index);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MARKDOWN_PARSER_PRIVATE_H__ */
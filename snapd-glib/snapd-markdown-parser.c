@@ -9,8 +9,10 @@
 
 #include <ctype.h>
 #include <string.h>
+#include <gio/gio.h>
 
-#include "snapd-markdown-parser.h"
+#include "snapd-markdown-parser-private.h"
+#include "snapd-markdown-document-private.h"
 #include "snapd-markdown-node.h"
 
 /**
@@ -47,93 +49,117 @@ struct _SnapdMarkdownParser
     GObject parent_instance;
 
     gboolean preserve_whitespace;
+
+    /* Cache of parsed text, most recently used first */
+    guint cache_size;
+    GHashTable *cache;
+    GQueue cache_queue;
 };
 
 G_DEFINE_TYPE (SnapdMarkdownParser, snapd_markdown_parser, G_TYPE_OBJECT)
 
+/* A line of the original text, including its line ending */
+typedef struct
+{
+    const gchar *text;
+    gsize length;
+} Line;
+
 static gboolean
-parse_empty_line (const gchar *line)
+parse_empty_line (const Line *line)
 {
-    for (int i = 0; line[i] != '\0'; i++)
-        if (!isspace (line[i]))
+    for (gsize i = 0; i < line->length; i++)
+        if (!isspace (line->text[i]))
             return FALSE;
     return TRUE;
 }
 
 static gboolean
-parse_paragraph (const gchar *line, gchar **text)
+parse_paragraph (const Line *line, Line *text)
 {
-    int i = 0;
-    while (isspace (line[i]))
+    gsize i = 0;
+    while (i < line->length && isspace (line->text[i]))
         i++;
 
-    if (text != NULL)
-        *text = g_strdup (line + i);
+    if (text != NULL) {
+        text->text = line->text + i;
+        text->length = line->length - i;
+    }
 
     return TRUE;
 }
 
 static gboolean
-parse_bullet_list_item (const gchar *line, int *offset, gchar *symbol, gchar **bullet_text)
+parse_bullet_list_item (const Line *line, gsize *offset, gchar *symbol, Line *bullet_text)
 {
-    int i = 0;
-    while (isspace (line[i]))
+    gsize i = 0;
+    while (i < line->length && isspace (line->text[i]))
         i++;
-    gchar symbol_ = line[i];
+    if (i >= line->length)
+        return FALSE;
+    gchar symbol_ = line->text[i];
     if (symbol_ != '-' && symbol_ != '+' && symbol_ != '*')
         return FALSE;
-    int marker_offset = i;
+    gsize marker_offset = i;
     i++;
-    if (line[i] == '\0')
+    if (i >= line->length)
         return FALSE;
 
-    if (!isspace (line[i]))
+    if (!isspace (line->text[i]))
         return FALSE;
     i++;
 
-    int offset_ = i;
-    while (isspace (line[offset_]))
+    gsize offset_ = i;
+    while (offset_ < line->length && isspace (line->text[offset_]))
         offset_++;
 
     /* Blank lines start one place after marker */
-    if (line[offset_] == '\0')
+    if (offset_ >= line->length)
        offset_ = marker_offset + 1;
 
     if (offset != NULL)
         *offset = offset_;
     if (symbol != NULL)
         *symbol = symbol_;
-    if (bullet_text != NULL)
-        *bullet_text = g_strdup (line + i);
+    if (bullet_text != NULL) {
+        bullet_text->text = line->text + i;
+        bullet_text->length = line->length - i;
+    }
 
     return TRUE;
 }
 
 static gboolean
-parse_list_item_line (const gchar *line, int offset, gchar **text)
+parse_list_item_line (const Line *line, gsize offset, Line *text)
 {
-    for (int i = 0; i < offset; i++) {
-        if (!isspace (line[i]))
+    if (offset > line->length)
+        return FALSE;
+    for (gsize i = 0; i < offset; i++) {
+        if (!isspace (line->text[i]))
             return FALSE;
     }
 
-    if (text != NULL)
-        *text = g_strdup (line + offset);
+    if (text != NULL) {
+        text->text = line->text + offset;
+        text->length = line->length - offset;
+    }
 
     return TRUE;
 }
 
 static gboolean
-parse_indented_code_block (const gchar *line, gchar **text)
+parse_indented_code_block (const Line *line, Line *text)
 {
-    int space_count = 0;
-    while (line[space_count] == ' ')
+    gsize space_count = 0;
+    while (space_count < line->length && line->text[space_count] == ' ')
         space_count++;
     if (space_count < 4)
         return FALSE;
 
-    if (text != NULL)
-        *text = g_strdup (line + 4);
+    if (text != NULL) {
+        text->text = line->text + 4;
+        text->length = line->length - 4;
+    }
 
     return TRUE;
 }
@@ -141,7 +167,8 @@ parse_indented_code_block (const gchar *line, gchar **text)
 static gboolean
 is_punctuation_character (gchar c)
 {
-    return strchr ("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~", c) != NULL;
+    /* strchr () matches the nul terminator, which isn't punctuation */
+    return c != '\0' && strchr ("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~", c) != NULL;
     // FIXME: Also support unicode categories Pc, Pd, Pe, Pf, Pi, Po, and Ps.
 }
 
@@ -202,17 +229,17 @@ is_right_flanking_delimiter_run (const gchar *text, int index)
 }
 
 static gchar *
-strip_text (const gchar *text)
+strip_text (const gchar *text, int length)
 {
     g_autoptr(GString) stripped_text = g_string_new ("");
 
     /* Strip leading whitespace */
     int i = 0;
-    while (isspace (text[i]))
+    while (i < length && isspace (text[i]))
         i++;
 
     gboolean in_whitespace = FALSE;
-    while (text[i] != '\0') {
+    while (i < length) {
         if (isspace (text[i]))
             in_whitespace = TRUE;
         else {
@@ -495,9 +522,10 @@ is_url (const gchar *text, int *length)
 static int
 find_url (const gchar *text, int *url_length)
 {
-    for (int offset = 0; text[offset] != '\0'; offset++)
-         if (is_url (text + offset, url_length))
-             return offset;
+    /* Only check where a URL prefix could start */
+    for (const gchar *c = strpbrk (text, "hm"); c != NULL; c = strpbrk (c + 1, "hm"))
+         if (is_url (c, url_length))
+             return c - text;
     return -1;
 }
 
@@ -541,11 +569,24 @@ extract_urls (GPtrArray *nodes)
     }
 }
 
+/* Characters that can start an inline element */
+#define INLINE_SPECIAL_CHARACTERS "*_`\\"
+
 static GPtrArray *
 markup_inline (SnapdMarkdownParser *self, const gchar *text)
 {
     /* Split into nodes */
     g_autoptr(GPtrArray) nodes = g_ptr_array_new_with_free_func (g_object_unref);
+
+    /* Text without any special characters is a single node, which only needs URLs extracting */
+    if (text[strcspn (text, INLINE_SPECIAL_CHARACTERS)] == '\0') {
+        if (text[0] != '\0')
+            g_ptr_array_add (nodes, make_paragraph_text_node (self, text, strlen (text)));
+        if (strchr (text, ':') != NULL)
+            extract_urls (nodes);
+        return g_steal_pointer (&nodes);
+    }
+
     g_autoptr(GHashTable) emphasis_info = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) emphasis_info_free);
     for (int i = 0; text[i] != '\0';) {
         int start = i;
@@ -554,18 +595,17 @@ markup_inline (SnapdMarkdownParser *self, const gchar *text)
         if (text[start] == '`') {
             int size = backtick_count (text + start);
             int end = start + size;
-            while (text[end] != '\0') {
+            while (TRUE) {
+                 end += strcspn (text + end, "`");
+                 if (text[end] == '\0')
+                     break;
                  int s = backtick_count (text + end);
                  if (s == size)
                      break;
-                 else if (s == 0)
-                     end++;
-                 else
-                     end += s;
+                 end += s;
             }
             if (text[end] != '\0') {
-                 g_autofree gchar *code_text = g_strndup (text + start + size, end - start - size);
-                 g_autofree gchar *stripped_code_text = strip_text (code_text);
+                 g_autofree gchar *stripped_code_text = strip_text (text + start + size, end - start - size);
                  g_ptr_array_add (nodes, make_code_node (SNAPD_MARKDOWN_NODE_TYPE_CODE_SPAN, stripped_code_text));
                  i = end + size;
             }
@@ -611,12 +651,9 @@ markup_inline (SnapdMarkdownParser *self, const gchar *text)
 
         /* Extract text until next potential emphasis or code span */
         while (text[i] != '\0') {
-            if (text[i] == '*' || text[i] == '_' || text[i] == '`')
-                break;
-
-            if (text[i] == '\\' && is_punctuation_character (text[i + 1]))
+            i += strcspn (text + i, INLINE_SPECIAL_CHARACTERS);
+            if (text[i] != '\\' || is_punctuation_character (text[i + 1]))
                 break;
-
             i++;
         }
         g_ptr_array_add (nodes, make_paragraph_text_node (self, text + start, i - start));
@@ -629,192 +666,400 @@ markup_inline (SnapdMarkdownParser *self, const gchar *text)
     combine_text_nodes (nodes);
 
     /* Extract URLs */
-    extract_urls (nodes);
+    if (strchr (text, ':') != NULL)
+        extract_urls (nodes);
 
     return g_steal_pointer (&nodes);
 }
 
-static GPtrArray *
-markdown_to_markup (SnapdMarkdownParser *self, const gchar *text)
-{
-    /* Snap supports the following subset of CommonMark (https://commonmark.org/):
-     *
-     * Indented code blocks
-     * Paragraphs
-     * Blank lines
-     * Lists
-     * Backslash escapes
-     * Code spans
-     * Emphasis and strong emphasis
-     * Textual content
-     *
-     * In addition, links are automatically converted to hyperlinks.
-     */
-
-    /* 1. Split into lines */
-    g_autoptr(GPtrArray) line_array = g_ptr_array_new_with_free_func (g_free);
-    int line_start = 0;
-    for (int i = 0; text[i] != '\0'; i++) {
-        if (text[i] == '\n' || text[i] == '\r') {
-            if (text[i] == '\r' && text[i + 1] == '\n')
-                i++;
-            g_ptr_array_add (line_array, g_strndup (text + line_start, i - line_start + 1));
-            line_start = i + 1;
-        }
-    }
-    if (text[line_start] != '\0')
-        g_ptr_array_add (line_array, g_strdup (text + line_start));
-    g_ptr_array_add (line_array, NULL);
-    GStrv lines = (GStrv) line_array->pdata;
+/* Snap supports the following subset of CommonMark (https://commonmark.org/):
+ *
+ * Indented code blocks
+ * Paragraphs
+ * Blank lines
+ * Lists
+ * Backslash escapes
+ * Code spans
+ * Emphasis and strong emphasis
+ * Textual content
+ *
+ * In addition, links are automatically converted to hyperlinks.
+ *
+ * Blocks are parsed in a single pass over the lines using a stack of
+ * containers. The bottom of the stack is the document, and each open list
+ * pushes a container for its current item. Each line is passed up the stack,
+ * with each list removing its indentation, until it reaches the container
+ * that consumes it.
+ */
 
-    /* 2. Split lines into blocks (paragraphs, lists, code) */
-    int line_number = 0;
-    g_autoptr(GPtrArray) nodes = g_ptr_array_new_with_free_func (g_object_unref);
-    while (lines[line_number] != NULL) {
-        /* Skip empty lines */
-        if (parse_empty_line (lines[line_number])) {
-            line_number++;
-            continue;
-        }
+typedef enum
+{
+    BLOCK_NONE,
+    BLOCK_PARAGRAPH,
+    BLOCK_CODE,
+    BLOCK_LIST
+} BlockType;
 
-        g_autofree gchar *block_text = NULL;
-        int bullet_offset = 0;
-        gchar bullet_symbol;
-        g_autofree gchar *bullet_text = NULL;
-        /* Indented code blocks */
-        if (parse_indented_code_block (lines[line_number], &block_text)) {
-            g_autoptr(GString) code_text = g_string_new ("");
-            g_string_append (code_text, block_text);
+typedef struct
+{
+    /* Completed blocks in this container */
+    GPtrArray *nodes;
+
+    /* Block currently being parsed */
+    BlockType type;
+    GString *text;
+    GPtrArray *list_items;
+    gsize bullet_offset;
+    gchar bullet_symbol;
+    gboolean starts_with_empty_line;
+} Container;
+
+static Container *
+container_new (void)
+{
+    Container *container = g_new0 (Container, 1);
+    container->nodes = g_ptr_array_new_with_free_func (g_object_unref);
+    return container;
+}
 
-            while (TRUE) {
-                line_number++;
+static void
+container_free (Container *container)
+{
+    g_clear_pointer (&container->nodes, g_ptr_array_unref);
+    if (container->text != NULL)
+        g_string_free (container->text, TRUE);
+    g_clear_pointer (&container->list_items, g_ptr_array_unref);
+    g_free (container);
+}
 
-                if (lines[line_number] == NULL)
-                    break;
+static void
+close_block (SnapdMarkdownParser *self, Container *container)
+{
+    switch (container->type) {
+    case BLOCK_NONE:
+        return;
+
+    case BLOCK_PARAGRAPH: {
+        GString *paragraph_text = container->text;
+
+        /* Strip leading and trailing whitespace */
+        int offset = 0;
+        while (isspace (paragraph_text->str[offset]))
+            offset++;
+        int length = paragraph_text->len;
+        while (length > 0 && isspace (paragraph_text->str[length - 1]))
+            length--;
+        if (offset + length > paragraph_text->len)
+            length = 0;
+        g_string_truncate (paragraph_text, offset + length);
+
+        g_autoptr(GPtrArray) children = markup_inline (self, paragraph_text->str + offset);
+        g_ptr_array_add (container->nodes, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
+                                                         "node-type", SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH,
+                                                         "children", children,
+                                                         NULL));
+        break;
+    }
 
-                g_autofree gchar *text = NULL;
-                if (parse_indented_code_block (lines[line_number], &text)) {
-                    g_string_append (code_text, text);
-                }
-                else if (parse_empty_line (lines[line_number]))
-                    g_string_append_c (code_text, '\n');
-                else
-                    break;
-            }
+    case BLOCK_CODE: {
+        GString *code_text = container->text;
 
-            /* Remove trailing empty lines */
-            while (g_str_has_suffix (code_text->str, "\n\n"))
-                g_string_truncate (code_text, code_text->len - 1);
+        /* Remove trailing empty lines */
+        while (g_str_has_suffix (code_text->str, "\n\n"))
+            g_string_truncate (code_text, code_text->len - 1);
 
-            g_ptr_array_add (nodes, make_code_node (SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK, code_text->str));
-        }
-        /* Bullet lists */
-        else if (parse_bullet_list_item (lines[line_number], &bullet_offset, &bullet_symbol, &bullet_text)) {
-            g_autoptr(GPtrArray) list_items = g_ptr_array_new_with_free_func (g_object_unref);
-            g_autoptr(GString) list_data = g_string_new (bullet_text);
-            gboolean starts_with_empty_line = bullet_text[0] == '\0';
-            gboolean have_item = TRUE;
-            while (TRUE) {
-                line_number++;
-                if (lines[line_number] == NULL)
-                    break;
-
-                if (parse_empty_line (lines[line_number])) {
-                    if (starts_with_empty_line)
-                        break;
-                    g_string_append (list_data, lines[line_number]);
-                    have_item = TRUE;
-                    continue;
-                }
-                starts_with_empty_line = FALSE;
-                g_autofree gchar *line_text = NULL;
-                if (parse_list_item_line (lines[line_number], bullet_offset, &line_text)) {
-                    g_string_append (list_data, line_text);
-                    have_item = TRUE;
-                    continue;
-                }
+        g_ptr_array_add (container->nodes, make_code_node (SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK, code_text->str));
+        break;
+    }
 
-                if (have_item) {
-                    g_autoptr(GPtrArray) children = markdown_to_markup (self, list_data->str);
-                    g_ptr_array_add (list_items, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
-                                                               "node-type", SNAPD_MARKDOWN_NODE_TYPE_LIST_ITEM,
-                                                               "children", children,
-                                                               NULL));
-                    g_string_assign (list_data, "");
-                    have_item = FALSE;
-                }
+    case BLOCK_LIST:
+        g_ptr_array_add (container->nodes, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
+                                                         "node-type", SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST,
+                                                         "children", container->list_items,
+                                                         NULL));
+        break;
+    }
 
-                // FIXME: Check matching offset
-                g_autofree gchar *text = NULL;
-                gchar symbol;
-                if (!parse_bullet_list_item (lines[line_number], &bullet_offset, &symbol, &text))
-                    break;
-                if (symbol != bullet_symbol)
-                    break;
-                g_string_assign (list_data, text);
-                have_item = TRUE;
-            }
+    container->type = BLOCK_NONE;
+    if (container->text != NULL)
+        g_string_free (container->text, TRUE);
+    container->text = NULL;
+    g_clear_pointer (&container->list_items, g_ptr_array_unref);
+}
 
-            if (have_item) {
-                g_autoptr(GPtrArray) children = markdown_to_markup (self, list_data->str);
-                g_ptr_array_add (list_items, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
+/* Close all the containers above @level, adding each as an item to the list below it */
+static void
+close_containers (SnapdMarkdownParser *self, GPtrArray *stack, guint level)
+{
+    while (stack->len > level + 1) {
+        Container *item = g_ptr_array_index (stack, stack->len - 1);
+        Container *parent = g_ptr_array_index (stack, stack->len - 2);
+
+        close_block (self, item);
+        g_ptr_array_add (parent->list_items, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
                                                            "node-type", SNAPD_MARKDOWN_NODE_TYPE_LIST_ITEM,
-                                                           "children", children,
+                                                           "children", item->nodes,
                                                            NULL));
+        g_ptr_array_remove_index (stack, stack->len - 1);
+    }
+}
+
+static void
+add_line (SnapdMarkdownParser *self, GPtrArray *stack, Line line)
+{
+    guint level = 0;
+    while (TRUE) {
+        Container *container = g_ptr_array_index (stack, level);
+        Line text;
+        gchar symbol;
+
+        switch (container->type) {
+        case BLOCK_NONE:
+            /* Skip empty lines */
+            if (parse_empty_line (&line))
+                return;
+
+            /* Indented code blocks */
+            if (parse_indented_code_block (&line, &text)) {
+                container->type = BLOCK_CODE;
+                container->text = g_string_new_len (text.text, text.length);
+                return;
             }
 
-            g_ptr_array_add (nodes, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
-                                                  "node-type", SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST,
-                                                  "children", list_items,
-                                                  NULL));
-        }
-        /* Paragraphs */
-        else {
-            g_autoptr(GString) paragraph_text = g_string_new ("");
-            while (TRUE) {
-                g_autofree gchar *text = NULL;
-                parse_paragraph (lines[line_number], &text);
+            /* Bullet lists */
+            if (parse_bullet_list_item (&line, &container->bullet_offset, &container->bullet_symbol, &text)) {
+                container->type = BLOCK_LIST;
+                container->list_items = g_ptr_array_new_with_free_func (g_object_unref);
+                container->starts_with_empty_line = text.length == 0;
+                g_ptr_array_add (stack, container_new ());
+                if (text.length == 0)
+                    return;
+                line = text;
+                level++;
+                continue;
+            }
 
-                g_string_append (paragraph_text, text);
+            /* Paragraphs */
+            parse_paragraph (&line, &text);
+            container->type = BLOCK_PARAGRAPH;
+            container->text = g_string_new_len (text.text, text.length);
+            return;
+
+        case BLOCK_PARAGRAPH:
+            /* Break on empty line or non-empty list items */
+            if (parse_empty_line (&line) ||
+                (parse_bullet_list_item (&line, NULL, NULL, &text) && text.length != 0)) {
+                close_block (self, container);
+                continue;
+            }
 
-                line_number++;
+            parse_paragraph (&line, &text);
+            g_string_append_len (container->text, text.text, text.length);
+            return;
 
-                /* Out of data */
-                if (lines[line_number] == NULL)
-                    break;
+        case BLOCK_CODE:
+            if (parse_indented_code_block (&line, &text)) {
+                g_string_append_len (container->text, text.text, text.length);
+                return;
+            }
+            if (parse_empty_line (&line)) {
+                g_string_append_c (container->text, '\n');
+                return;
+            }
 
-                /* Break on empty line */
-                if (parse_empty_line (lines[line_number]))
-                    break;
+            close_block (self, container);
+            continue;
 
-                /* Break on non-empty list items */
-                g_autofree gchar *bullet_text = NULL;
-                if (parse_bullet_list_item (lines[line_number], NULL, NULL, &bullet_text)) {
-                    if (bullet_text[0] != '\0')
-                        break;
+        case BLOCK_LIST:
+            if (parse_empty_line (&line)) {
+                if (container->starts_with_empty_line) {
+                    close_containers (self, stack, level);
+                    close_block (self, container);
+                    continue;
                 }
+                level++;
+                continue;
+            }
+            container->starts_with_empty_line = FALSE;
+            if (parse_list_item_line (&line, container->bullet_offset, &text)) {
+                line = text;
+                level++;
+                continue;
             }
 
-            /* Strip leading and trailing whitespace */
-            int offset = 0;
-            while (isspace (paragraph_text->str[offset]))
-                offset++;
-            int length = paragraph_text->len;
-            while (length > 0 && isspace (paragraph_text->str[length - 1]))
-                length--;
-            if (offset + length > paragraph_text->len)
-                length = 0;
-            g_autofree gchar *stripped_text = g_strndup (paragraph_text->str + offset, length);
-
-            g_autoptr(GPtrArray) children = markup_inline (self, stripped_text);
-            g_ptr_array_add (nodes, g_object_new (SNAPD_TYPE_MARKDOWN_NODE,
-                                                  "node-type", SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH,
-                                                  "children", children,
-                                                  NULL));
+            close_containers (self, stack, level);
+
+            // FIXME: Check matching offset
+            if (!parse_bullet_list_item (&line, &container->bullet_offset, &symbol, &text) ||
+                symbol != container->bullet_symbol) {
+                close_block (self, container);
+                continue;
+            }
+            g_ptr_array_add (stack, container_new ());
+            if (text.length == 0)
+                return;
+            line = text;
+            level++;
+            continue;
         }
     }
+}
 
-    return g_steal_pointer (&nodes);
+/* Find a restart point at @offset in the sorted array @points */
+static gboolean
+find_restart_point (GArray *points, gsize offset, guint *index)
+{
+    guint lower = 0, upper = points->len;
+    while (lower < upper) {
+        guint middle = lower + (upper - lower) / 2;
+        gsize middle_offset = g_array_index (points, SnapdMarkdownRestartPoint, middle).offset;
+        if (middle_offset == offset) {
+            *index = middle;
+            return TRUE;
+        }
+        if (middle_offset < offset)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    return FALSE;
+}
+
+/* Parse the lines of @text from @start, which must be a line where no block is open.
+ * The lines where no block is open are added to @restarts, as parsing can start
+ * again from any of them. If @stop_points is set then parsing stops at the first of
+ * these at or after @stop_after that, when moved by @shift, is also in @stop_points;
+ * the index of the matching point is returned in @stop_index */
+GPtrArray *
+_snapd_markdown_parser_parse_blocks (SnapdMarkdownParser *self, const gchar *text, gsize start, guint n_previous_nodes,
+                                     GArray *restarts, GArray *stop_points, gsize stop_after, gssize shift, guint *stop_index)
+{
+    g_autoptr(GPtrArray) stack = g_ptr_array_new_with_free_func ((GDestroyNotify) container_free);
+    Container *document = container_new ();
+    g_ptr_array_add (stack, document);
+
+    /* Split into lines, each of which references the original text */
+    gsize line_start = start;
+    while (text[line_start] != '\0') {
+        if (stack->len == 1 && document->type == BLOCK_NONE) {
+            if (stop_points != NULL && line_start >= stop_after &&
+                find_restart_point (stop_points, line_start - shift, stop_index))
+                break;
+            if (restarts != NULL) {
+                SnapdMarkdownRestartPoint point = { line_start, n_previous_nodes + document->nodes->len };
+                g_array_append_val (restarts, point);
+            }
+        }
+
+        gsize line_end = line_start;
+        while (text[line_end] != '\0' && text[line_end] != '\n' && text[line_end] != '\r')
+            line_end++;
+        if (text[line_end] == '\r' && text[line_end + 1] == '\n')
+            line_end += 2;
+        else if (text[line_end] != '\0')
+            line_end++;
+
+        Line line = { text + line_start, line_end - line_start };
+        add_line (self, stack, line);
+        line_start = line_end;
+    }
+
+    close_containers (self, stack, 0);
+    close_block (self, document);
+
+    return g_steal_pointer (&document->nodes);
+}
+
+static GPtrArray *
+parse_text (SnapdMarkdownParser *self, const gchar *text)
+{
+    return _snapd_markdown_parser_parse_blocks (self, text, 0, 0, NULL, NULL, 0, 0, NULL);
+}
+
+/* Previously parsed text, stored in both the hash table and the queue */
+typedef struct
+{
+    gchar *text;
+    gboolean preserve_whitespace;
+    GPtrArray *nodes;
+    GList link;
+} CacheEntry;
+
+static guint
+cache_entry_hash (gconstpointer key)
+{
+    const CacheEntry *entry = key;
+    return g_str_hash (entry->text) ^ (entry->preserve_whitespace ? 1 : 0);
+}
+
+static gboolean
+cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+    const CacheEntry *entry_a = a, *entry_b = b;
+    return entry_a->preserve_whitespace == entry_b->preserve_whitespace &&
+           strcmp (entry_a->text, entry_b->text) == 0;
+}
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+    g_free (entry->text);
+    g_ptr_array_unref (entry->nodes);
+    g_free (entry);
+}
+
+static void
+trim_cache (SnapdMarkdownParser *self)
+{
+    /* Remove least recently used entries */
+    while (g_queue_get_length (&self->cache_queue) > self->cache_size) {
+        GList *link = g_queue_pop_tail_link (&self->cache_queue);
+        g_hash_table_remove (self->cache, link->data);
+    }
+}
+
+static CacheEntry *
+lookup_cache (SnapdMarkdownParser *self, const gchar *text)
+{
+    CacheEntry key = { (gchar *) text, self->preserve_whitespace, NULL, { NULL, NULL, NULL } };
+    CacheEntry *entry = g_hash_table_lookup (self->cache, &key);
+    if (entry != NULL) {
+        /* Move to the front of the queue */
+        g_queue_unlink (&self->cache_queue, &entry->link);
+        g_queue_push_head_link (&self->cache_queue, &entry->link);
+    }
+
+    return entry;
+}
+
+static CacheEntry *
+add_to_cache (SnapdMarkdownParser *self, const gchar *text, GPtrArray *nodes)
+{
+    CacheEntry *entry = lookup_cache (self, text);
+    if (entry != NULL)
+        return entry;
+
+    entry = g_new0 (CacheEntry, 1);
+    entry->text = g_strdup (text);
+    entry->preserve_whitespace = self->preserve_whitespace;
+    entry->nodes = g_ptr_array_ref (nodes);
+    entry->link.data = entry;
+    g_hash_table_add (self->cache, entry);
+    g_queue_push_head_link (&self->cache_queue, &entry->link);
+    trim_cache (self);
+
+    return entry;
+}
+
+/* Return a new array so the caller can't modify the cached one */
+static GPtrArray *
+copy_nodes (GPtrArray *nodes)
+{
+    GPtrArray *copy = g_ptr_array_new_full (nodes->len, g_object_unref);
+    for (guint i = 0; i < nodes->len; i++)
+        g_ptr_array_add (copy, g_object_ref (g_ptr_array_index (nodes, i)));
+    return copy;
 }
 
 /**
@@ -869,6 +1114,43 @@ snapd_markdown_parser_get_preserve_whitespace (SnapdMarkdownParser *self)
     return self->preserve_whitespace;
 }
 
+/**
+ * snapd_markdown_parser_set_cache_size:
+ * @parser: a #SnapdMarkdownParser.
+ * @cache_size: the maximum number of results to keep, or 0 to disable caching.
+ *
+ * Set the number of parse results to keep. When enabled, parsing text that
+ * was recently parsed with the same settings returns the same nodes as before
+ * without parsing the text again. The least recently used results are removed
+ * when the cache is full. Caching is disabled by default.
+ *
+ * Since: 1.65
+ */
+void
+snapd_markdown_parser_set_cache_size (SnapdMarkdownParser *self, guint cache_size)
+{
+    g_return_if_fail (SNAPD_IS_MARKDOWN_PARSER (self));
+    self->cache_size = cache_size;
+    trim_cache (self);
+}
+
+/**
+ * snapd_markdown_parser_get_cache_size:
+ * @parser: a #SnapdMarkdownParser.
+ *
+ * Get the number of parse results that are kept.
+ *
+ * Returns: the maximum number of results to keep, or 0 if caching is disabled.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_markdown_parser_get_cache_size (SnapdMarkdownParser *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), 0);
+    return self->cache_size;
+}
+
 /**
  * snapd_markdown_parser_parse:
  * @parser: a #SnapdMarkdownParser.
@@ -885,15 +1167,482 @@ snapd_markdown_parser_parse (SnapdMarkdownParser *self, const gchar *text)
 {
     g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
     g_return_val_if_fail (text != NULL, NULL);
-    return markdown_to_markup (self, text);
+
+    if (self->cache_size == 0)
+        return parse_text (self, text);
+
+    CacheEntry *entry = lookup_cache (self, text);
+    if (entry == NULL) {
+        g_autoptr(GPtrArray) nodes = parse_text (self, text);
+        entry = add_to_cache (self, text, nodes);
+    }
+
+    return copy_nodes (entry->nodes);
+}
+
+/**
+ * snapd_markdown_parser_parse_flat:
+ * @parser: a #SnapdMarkdownParser.
+ * @text: text to parse.
+ *
+ * Convert text in snapd markdown format to markup, in the same way as
+ * snapd_markdown_parser_parse (). The result is stored in a single flat array
+ * of nodes rather than as a tree of objects.
+ *
+ * Returns: (transfer full): a #SnapdMarkdownDocument.
+ *
+ * Since: 1.65
+ */
+SnapdMarkdownDocument *
+snapd_markdown_parser_parse_flat (SnapdMarkdownParser *self, const gchar *text)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
+    g_return_val_if_fail (text != NULL, NULL);
+
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (self, text);
+    return _snapd_markdown_document_new (nodes);
+}
+
+/* Texts being parsed in a worker thread */
+typedef struct
+{
+    gboolean preserve_whitespace;
+    GStrv texts;
+
+    /* Parsed nodes for each text, set before starting for texts found in the cache */
+    GPtrArray *results;
+} ParseData;
+
+static void
+parse_data_free (ParseData *data)
+{
+    g_strfreev (data->texts);
+    g_ptr_array_unref (data->results);
+    g_free (data);
+}
+
+static void
+parse_thread_func (GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+    ParseData *data = task_data;
+
+    /* Use a separate parser so this thread doesn't share any state with the caller */
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    parser->preserve_whitespace = data->preserve_whitespace;
+
+    for (guint i = 0; data->texts[i] != NULL; i++) {
+        if (g_task_return_error_if_cancelled (task))
+            return;
+
+        if (g_ptr_array_index (data->results, i) == NULL)
+            g_ptr_array_index (data->results, i) = parse_text (parser, data->texts[i]);
+    }
+
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+start_parse (SnapdMarkdownParser *self, GStrv texts, GCancellable *cancellable, gpointer source_tag,
+             GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    g_task_set_source_tag (task, source_tag);
+
+    ParseData *data = g_new0 (ParseData, 1);
+    data->preserve_whitespace = self->preserve_whitespace;
+    data->texts = g_strdupv (texts);
+    data->results = g_ptr_array_new_with_free_func ((GDestroyNotify) g_ptr_array_unref);
+    g_task_set_task_data (task, data, (GDestroyNotify) parse_data_free);
+
+    gboolean all_cached = TRUE;
+    for (guint i = 0; texts[i] != NULL; i++) {
+        CacheEntry *entry = self->cache_size > 0 ? lookup_cache (self, texts[i]) : NULL;
+        g_ptr_array_add (data->results, entry != NULL ? copy_nodes (entry->nodes) : NULL);
+        if (entry == NULL)
+            all_cached = FALSE;
+    }
+
+    if (all_cached) {
+        g_task_return_boolean (task, TRUE);
+        return;
+    }
+
+    g_task_set_return_on_cancel (task, TRUE);
+    g_task_run_in_thread (task, parse_thread_func);
+}
+
+static ParseData *
+finish_parse (SnapdMarkdownParser *self, GAsyncResult *result, GError **error)
+{
+    if (!g_task_propagate_boolean (G_TASK (result), error))
+        return NULL;
+
+    /* Results are added to the cache here as it may only be used from the thread that owns the parser */
+    ParseData *data = g_task_get_task_data (G_TASK (result));
+    if (self->cache_size > 0 && data->preserve_whitespace == self->preserve_whitespace) {
+        for (guint i = 0; data->texts[i] != NULL; i++)
+            add_to_cache (self, data->texts[i], g_ptr_array_index (data->results, i));
+    }
+
+    return data;
+}
+
+/**
+ * snapd_markdown_parser_parse_async:
+ * @parser: a #SnapdMarkdownParser.
+ * @text: text to parse.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the text is parsed.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously convert text in snapd markdown format to markup, in the same
+ * way as snapd_markdown_parser_parse (). The text is parsed in a worker
+ * thread so long texts don't block the main loop. Text in the cache is
+ * returned without using a thread.
+ * See snapd_markdown_parser_parse () for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_markdown_parser_parse_async (SnapdMarkdownParser *self, const gchar *text,
+                                   GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_MARKDOWN_PARSER (self));
+    g_return_if_fail (text != NULL);
+
+    const gchar *texts[] = { text, NULL };
+    start_parse (self, (GStrv) texts, cancellable, snapd_markdown_parser_parse_async, callback, user_data);
+}
+
+/**
+ * snapd_markdown_parser_parse_finish:
+ * @parser: a #SnapdMarkdownParser.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_markdown_parser_parse_async().
+ * See snapd_markdown_parser_parse () for more information.
+ *
+ * Returns: (transfer container) (element-type SnapdMarkdownNode): Text split into blocks or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_markdown_parser_parse_finish (SnapdMarkdownParser *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+    g_return_val_if_fail (g_async_result_is_tagged (result, snapd_markdown_parser_parse_async), NULL);
+
+    ParseData *data = finish_parse (self, result, error);
+    if (data == NULL)
+        return NULL;
+
+    return copy_nodes (g_ptr_array_index (data->results, 0));
+}
+
+/**
+ * snapd_markdown_parser_parse_many_async:
+ * @parser: a #SnapdMarkdownParser.
+ * @texts: (array zero-terminated=1): texts to parse.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the texts are parsed.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously convert several texts in snapd markdown format to markup,
+ * for example the descriptions of a list of snaps. All the texts are parsed
+ * in a single worker thread task.
+ * See snapd_markdown_parser_parse () for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_markdown_parser_parse_many_async (SnapdMarkdownParser *self, GStrv texts,
+                                        GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_MARKDOWN_PARSER (self));
+    g_return_if_fail (texts != NULL);
+
+    start_parse (self, texts, cancellable, snapd_markdown_parser_parse_many_async, callback, user_data);
+}
+
+/**
+ * snapd_markdown_parser_parse_many_finish:
+ * @parser: a #SnapdMarkdownParser.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_markdown_parser_parse_many_async().
+ * See snapd_markdown_parser_parse () for more information.
+ *
+ * Returns: (transfer container) (element-type GPtrArray): an array of
+ *     #SnapdMarkdownNode arrays in the same order as the texts, or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_markdown_parser_parse_many_finish (SnapdMarkdownParser *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+    g_return_val_if_fail (g_async_result_is_tagged (result, snapd_markdown_parser_parse_many_async), NULL);
+
+    ParseData *data = finish_parse (self, result, error);
+    if (data == NULL)
+        return NULL;
+
+    GPtrArray *results = g_ptr_array_new_full (data->results->len, (GDestroyNotify) g_ptr_array_unref);
+    for (guint i = 0; i < data->results->len; i++)
+        g_ptr_array_add (results, copy_nodes (g_ptr_array_index (data->results, i)));
+    return results;
+}
+
+static void
+append_escaped (GString *output, const gchar *text)
+{
+    g_autofree gchar *escaped_text = g_markup_escape_text (text, -1);
+    g_string_append (output, escaped_text);
+}
+
+static const gchar *
+get_url (SnapdMarkdownNode *node)
+{
+    GPtrArray *children = snapd_markdown_node_get_children (node);
+    if (children == NULL || children->len != 1)
+        return "";
+    return snapd_markdown_node_get_text (g_ptr_array_index (children, 0));
+}
+
+static void
+render_html (GString *output, GPtrArray *nodes)
+{
+    for (guint i = 0; i < nodes->len; i++) {
+        SnapdMarkdownNode *node = g_ptr_array_index (nodes, i);
+        GPtrArray *children = snapd_markdown_node_get_children (node);
+
+        switch (snapd_markdown_node_get_node_type (node)) {
+        case SNAPD_MARKDOWN_NODE_TYPE_TEXT:
+            append_escaped (output, snapd_markdown_node_get_text (node));
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH:
+            g_string_append (output, "<p>");
+            render_html (output, children);
+            g_string_append (output, "</p>\n");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST:
+            g_string_append (output, "<ul>\n");
+            render_html (output, children);
+            g_string_append (output, "</ul>\n");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_LIST_ITEM:
+            /* Items containing a single paragraph are written inline */
+            if (children->len == 1 &&
+                snapd_markdown_node_get_node_type (g_ptr_array_index (children, 0)) == SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH) {
+                g_string_append (output, "<li>");
+                render_html (output, snapd_markdown_node_get_children (g_ptr_array_index (children, 0)));
+                g_string_append (output, "</li>\n");
+            }
+            else {
+                g_string_append (output, children->len > 0 ? "<li>\n" : "<li>");
+                render_html (output, children);
+                g_string_append (output, "</li>\n");
+            }
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK:
+            g_string_append (output, "<pre><code>");
+            render_html (output, children);
+            g_string_append (output, "</code></pre>\n");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_CODE_SPAN:
+            g_string_append (output, "<code>");
+            render_html (output, children);
+            g_string_append (output, "</code>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_EMPHASIS:
+            g_string_append (output, "<em>");
+            render_html (output, children);
+            g_string_append (output, "</em>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_STRONG_EMPHASIS:
+            g_string_append (output, "<strong>");
+            render_html (output, children);
+            g_string_append (output, "</strong>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_URL:
+            g_string_append (output, "<a href=\"");
+            append_escaped (output, get_url (node));
+            g_string_append (output, "\">");
+            render_html (output, children);
+            g_string_append (output, "</a>");
+            break;
+        }
+    }
+}
+
+static void
+render_pango_inline (GString *output, GPtrArray *nodes)
+{
+    for (guint i = 0; i < nodes->len; i++) {
+        SnapdMarkdownNode *node = g_ptr_array_index (nodes, i);
+        GPtrArray *children = snapd_markdown_node_get_children (node);
+
+        switch (snapd_markdown_node_get_node_type (node)) {
+        case SNAPD_MARKDOWN_NODE_TYPE_TEXT:
+            append_escaped (output, snapd_markdown_node_get_text (node));
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_CODE_SPAN:
+            g_string_append (output, "<tt>");
+            render_pango_inline (output, children);
+            g_string_append (output, "</tt>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_EMPHASIS:
+            g_string_append (output, "<i>");
+            render_pango_inline (output, children);
+            g_string_append (output, "</i>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_STRONG_EMPHASIS:
+            g_string_append (output, "<b>");
+            render_pango_inline (output, children);
+            g_string_append (output, "</b>");
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_URL:
+            g_string_append (output, "<a href=\"");
+            append_escaped (output, get_url (node));
+            g_string_append (output, "\">");
+            render_pango_inline (output, children);
+            g_string_append (output, "</a>");
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void
+render_pango_blocks (GString *output, GPtrArray *nodes, int depth)
+{
+    for (guint i = 0; i < nodes->len; i++) {
+        SnapdMarkdownNode *node = g_ptr_array_index (nodes, i);
+        GPtrArray *children = snapd_markdown_node_get_children (node);
+
+        /* Pango has no block elements, so separate blocks with blank lines, or new lines inside lists */
+        if (i > 0) {
+            if (depth == 0)
+                g_string_append (output, "\n\n");
+            else {
+                g_string_append_c (output, '\n');
+                for (int j = 0; j < depth; j++)
+                    g_string_append (output, "  ");
+            }
+        }
+
+        switch (snapd_markdown_node_get_node_type (node)) {
+        case SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH:
+            render_pango_inline (output, children);
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST:
+            for (guint j = 0; j < children->len; j++) {
+                SnapdMarkdownNode *item = g_ptr_array_index (children, j);
+                if (j > 0) {
+                    g_string_append_c (output, '\n');
+                    for (int k = 0; k < depth; k++)
+                        g_string_append (output, "  ");
+                }
+                g_string_append (output, "\xe2\x80\xa2 "); /* U+2022 BULLET */
+                render_pango_blocks (output, snapd_markdown_node_get_children (item), depth + 1);
+            }
+            break;
+        case SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK: {
+            g_autoptr(GString) code_text = g_string_new ("");
+            render_pango_inline (code_text, children);
+            if (g_str_has_suffix (code_text->str, "\n"))
+                g_string_truncate (code_text, code_text->len - 1);
+            g_string_append (output, "<tt>");
+            g_string_append (output, code_text->str);
+            g_string_append (output, "</tt>");
+            break;
+        }
+        default:
+            render_pango_inline (output, children);
+            break;
+        }
+    }
+}
+
+/**
+ * snapd_markdown_parser_render_html:
+ * @parser: a #SnapdMarkdownParser.
+ * @text: text to parse.
+ *
+ * Convert text in snapd markdown format to HTML. Paragraphs, lists and code
+ * blocks are written as block elements and URLs are converted to links. All
+ * text is escaped.
+ *
+ * Returns: (transfer full): an HTML fragment.
+ *
+ * Since: 1.65
+ */
+gchar *
+snapd_markdown_parser_render_html (SnapdMarkdownParser *self, const gchar *text)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
+    g_return_val_if_fail (text != NULL, NULL);
+
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (self, text);
+    g_autoptr(GString) output = g_string_new ("");
+    render_html (output, nodes);
+
+    return g_string_free (g_steal_pointer (&output), FALSE);
+}
+
+/**
+ * snapd_markdown_parser_render_pango:
+ * @parser: a #SnapdMarkdownParser.
+ * @text: text to parse.
+ *
+ * Convert text in snapd markdown format to Pango markup, suitable for use in
+ * a label. Paragraphs are separated by blank lines, list items are written
+ * on separate lines starting with a bullet and URLs are converted to links.
+ * All text is escaped.
+ *
+ * Returns: (transfer full): Pango markup.
+ *
+ * Since: 1.65
+ */
+gchar *
+snapd_markdown_parser_render_pango (SnapdMarkdownParser *self, const gchar *text)
+{
+    g_return_val_if_fail (SNAPD_IS_MARKDOWN_PARSER (self), NULL);
+    g_return_val_if_fail (text != NULL, NULL);
+
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (self, text);
+    g_autoptr(GString) output = g_string_new ("");
+    render_pango_blocks (output, nodes, 0);
+
+    return g_string_free (g_steal_pointer (&output), FALSE);
+}
+
+static void
+snapd_markdown_parser_finalize (GObject *object)
+{
+    SnapdMarkdownParser *self = SNAPD_MARKDOWN_PARSER (object);
+
+    g_clear_pointer (&self->cache, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_markdown_parser_parent_class)->finalize (object);
 }
 
 static void
 snapd_markdown_parser_class_init (SnapdMarkdownParserClass *klass)
 {
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_markdown_parser_finalize;
 }
 
 static void
 snapd_markdown_parser_init (SnapdMarkdownParser *self)
 {
+    self->cache = g_hash_table_new_full (cache_entry_hash, cache_entry_equal, (GDestroyNotify) cache_entry_free, NULL);
+    g_queue_init (&self->cache_queue);
 }
@@ -14,7 +14,8 @@
 #error "Only <snapd-glib/snapd-glib.h> can be included directly."
 #endif
 
-#include <glib-object.h>
+#include <gio/gio.h>
+#include <snapd-glib/snapd-markdown-document.h>
 
 G_BEGIN_DECLS
 
@@ -35,15 +36,47 @@ typedef enum
 
 G_DECLARE_FINAL_TYPE (SnapdMarkdownParser, snapd_markdown_parser, SNAPD, MARKDOWN_PARSER, GObject)
 
-SnapdMarkdownParser *snapd_markdown_parser_new                     (SnapdMarkdownVersion version);
+SnapdMarkdownParser   *snapd_markdown_parser_new                     (SnapdMarkdownVersion version);
 
-void                 snapd_markdown_parser_set_preserve_whitespace (SnapdMarkdownParser *parser,
-                                                                    gboolean             preserve_whitespace);
+void                   snapd_markdown_parser_set_preserve_whitespace (SnapdMarkdownParser *parser,
+                                                                      gboolean             preserve_whitespace);
 
-gboolean             snapd_markdown_parser_get_preserve_whitespace (SnapdMarkdownParser *parser);
+gboolean               snapd_markdown_parser_get_preserve_whitespace (SnapdMarkdownParser *parser);
 
-GPtrArray           *snapd_markdown_parser_parse                   (SnapdMarkdownParser *parser,
-                                                                    const gchar         *text);
+void                   snapd_markdown_parser_set_cache_size          (SnapdMarkdownParser *parser,
+                                                                      guint                cache_size);
+
+guint                  snapd_markdown_parser_get_cache_size          (SnapdMarkdownParser *parser);
+
+GPtrArray             *snapd_markdown_parser_parse                   (SnapdMarkdownParser *parser,
+                                                                      const gchar         *text);
+
+void                   snapd_markdown_parser_parse_async             (SnapdMarkdownParser *parser,
+                                                                      const gchar         *text,
+                                                                      GCancellable        *cancellable,
+                                                                      GAsyncReadyCallback  callback,
+                                                                      gpointer             user_data);
+GPtrArray             *snapd_markdown_parser_parse_finish            (SnapdMarkdownParser *parser,
+                                                                      GAsyncResult        *result,
+                                                                      GError             **error);
+
+void                   snapd_markdown_parser_parse_many_async        (SnapdMarkdownParser *parser,
+                                                                      GStrv                texts,
+                                                                      GCancellable        *cancellable,
+                                                                      GAsyncReadyCallback  callback,
+                                                                      gpointer             user_data);
+GPtrArray             *snapd_markdown_parser_parse_many_finish       (SnapdMarkdownParser *parser,
+                                                                      GAsyncResult        *result,
+                                                                      GError             **error);
+
+SnapdMarkdownDocument *snapd_markdown_parser_parse_flat              (SnapdMarkdownParser *parser,
+                                                                      const gchar         *text);
+
+gchar                 *snapd_markdown_parser_render_html             (SnapdMarkdownParser *parser,
+                                                                      const gchar         *text);
+
+gchar                 *snapd_markdown_parser_render_pango            (SnapdMarkdownParser *parser,
+                                                                      const gchar         *text);
 
 G_END_DECLS
 
@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <glib/gstdio.h>
+#include <libsoup/soup.h>
+
+#include "snapd-media-prefetcher.h"
+
+#include "snapd-error.h"
+
+/**
+ * SECTION: snapd-media-prefetcher
+ * @short_description: Download snap media in the background
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdMediaPrefetcher downloads the media of snaps, e.g. the screenshots
+ * of the snaps on a store page, into a disk cache. Several downloads run at
+ * once (see snapd_media_prefetcher_set_max_concurrent()) and
+ * #SnapdMediaPrefetcher::media-fetched is emitted as each one completes, so
+ * results can be shown as they arrive. Media that is already cached is
+ * revalidated with the server using the ETag and Last-Modified headers from
+ * the previous download, so unchanged files are not downloaded again. The
+ * cache can be shared between processes.
+ */
+
+/**
+ * SnapdMediaPrefetcher:
+ *
+ * #SnapdMediaPrefetcher downloads snap media into a cache.
+ *
+ * Since: 1.65
+ */
+
+/* Default number of downloads to run at once */
+#define DEFAULT_MAX_CONCURRENT 6
+
+typedef struct
+{
+    SnapdMediaPrefetcher *prefetcher;
+    SnapdSnap *snap;
+    SnapdMedia *media;
+    gchar *path;
+    gchar *info_path;
+    SoupMessage *message;
+    GOutputStream *output;
+} FetchJob;
+
+struct _SnapdMediaPrefetcher
+{
+    GObject parent_instance;
+
+    SoupSession *session;
+    gchar *cache_dir;
+    guint max_concurrent;
+
+    /* Current fetch, downloads waiting to start and the number in progress */
+    GTask *task;
+    GQueue jobs;
+    guint n_running;
+};
+
+enum
+{
+    SIGNAL_MEDIA_FETCHED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdMediaPrefetcher, snapd_media_prefetcher, G_TYPE_OBJECT)
+
+static void
+fetch_job_free (FetchJob *job)
+{
+    g_clear_object (&job->snap);
+    g_clear_object (&job->media);
+    g_free (job->path);
+    g_free (job->info_path);
+    g_clear_object (&job->message);
+    g_clear_object (&job->output);
+    g_slice_free (FetchJob, job);
+}
+
+static gchar *
+get_cache_path (SnapdMediaPrefetcher *self, const gchar *url, const gchar *suffix)
+{
+    g_autofree gchar *checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, url, -1);
+    g_autofree gchar *filename = g_strconcat (checksum, suffix, NULL);
+    return g_build_filename (self->cache_dir, filename, NULL);
+}
+
+static SoupMessageHeaders *
+get_request_headers (SoupMessage *message)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    return soup_message_get_request_headers (message);
+#else
+    return message->request_headers;
+#endif
+}
+
+static SoupMessageHeaders *
+get_response_headers (SoupMessage *message)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    return soup_message_get_response_headers (message);
+#else
+    return message->response_headers;
+#endif
+}
+
+static guint
+get_status (SoupMessage *message)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    return soup_message_get_status (message);
+#else
+    return message->status_code;
+#endif
+}
+
+static void start_jobs (SnapdMediaPrefetcher *self);
+
+static void
+job_done (FetchJob *job, GError *error)
+{
+    SnapdMediaPrefetcher *self = job->prefetcher;
+
+    g_signal_emit (self, signals[SIGNAL_MEDIA_FETCHED], 0, job->snap, job->media, error == NULL ? job->path : NULL, error);
+    fetch_job_free (job);
+
+    self->n_running--;
+    start_jobs (self);
+}
+
+/* Store the validators for the next time this file is fetched */
+static void
+write_info (FetchJob *job)
+{
+    SoupMessageHeaders *headers = get_response_headers (job->message);
+    const gchar *etag = soup_message_headers_get_one (headers, "ETag");
+    const gchar *last_modified = soup_message_headers_get_one (headers, "Last-Modified");
+
+    g_autoptr(GKeyFile) info = g_key_file_new ();
+    g_key_file_set_string (info, "Media", "URL", snapd_media_get_url (job->media));
+    if (etag != NULL)
+        g_key_file_set_string (info, "Media", "ETag", etag);
+    if (last_modified != NULL)
+        g_key_file_set_string (info, "Media", "Last-Modified", last_modified);
+    g_key_file_save_to_file (info, job->info_path, NULL);
+}
+
+static void
+splice_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    FetchJob *job = user_data;
+
+    g_autoptr(GError) error = NULL;
+    if (g_output_stream_splice_finish (G_OUTPUT_STREAM (object), result, &error) < 0) {
+        job_done (job, error);
+        return;
+    }
+
+    g_autoptr(GBytes) data = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (job->output));
+    if (!g_file_set_contents (job->path, g_bytes_get_data (data, NULL), g_bytes_get_size (data), &error)) {
+        job_done (job, error);
+        return;
+    }
+    write_info (job);
+
+    job_done (job, NULL);
+}
+
+static void
+send_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    FetchJob *job = user_data;
+    SnapdMediaPrefetcher *self = job->prefetcher;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GInputStream) stream = soup_session_send_finish (SOUP_SESSION (object), result, &error);
+    if (stream == NULL) {
+        job_done (job, error);
+        return;
+    }
+
+    guint status_code = get_status (job->message);
+    if (status_code == SOUP_STATUS_NOT_MODIFIED) {
+        g_input_stream_close (stream, NULL, NULL);
+        job_done (job, NULL);
+        return;
+    }
+    if (status_code != SOUP_STATUS_OK) {
+        g_input_stream_close (stream, NULL, NULL);
+        g_set_error (&error,
+                     SNAPD_ERROR,
+                     SNAPD_ERROR_FAILED,
+                     "Failed to download %s: HTTP status %u",
+                     snapd_media_get_url (job->media), status_code);
+        job_done (job, error);
+        return;
+    }
+
+    job->output = g_memory_output_stream_new_resizable ();
+    g_output_stream_splice_async (job->output, stream,
+                                  G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+                                  G_PRIORITY_DEFAULT, g_task_get_cancellable (self->task), splice_cb, job);
+}
+
+static void
+start_job (FetchJob *job)
+{
+    SnapdMediaPrefetcher *self = job->prefetcher;
+
+    job->message = soup_message_new ("GET", snapd_media_get_url (job->media));
+    if (job->message == NULL) {
+        g_autoptr(GError) error = g_error_new (SNAPD_ERROR,
+                                               SNAPD_ERROR_FAILED,
+                                               "Invalid media URL %s",
+                                               snapd_media_get_url (job->media));
+        job_done (job, error);
+        return;
+    }
+
+    /* Revalidate files that are already in the cache */
+    g_autoptr(GKeyFile) info = g_key_file_new ();
+    if (g_file_test (job->path, G_FILE_TEST_EXISTS) &&
+        g_key_file_load_from_file (info, job->info_path, G_KEY_FILE_NONE, NULL)) {
+        SoupMessageHeaders *headers = get_request_headers (job->message);
+        g_autofree gchar *etag = g_key_file_get_string (info, "Media", "ETag", NULL);
+        g_autofree gchar *last_modified = g_key_file_get_string (info, "Media", "Last-Modified", NULL);
+        if (etag != NULL)
+            soup_message_headers_replace (headers, "If-None-Match", etag);
+        if (last_modified != NULL)
+            soup_message_headers_replace (headers, "If-Modified-Since", last_modified);
+    }
+
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    soup_session_send_async (self->session, job->message, G_PRIORITY_DEFAULT, g_task_get_cancellable (self->task), send_cb, job);
+#else
+    soup_session_send_async (self->session, job->message, g_task_get_cancellable (self->task), send_cb, job);
+#endif
+}
+
+static void
+start_jobs (SnapdMediaPrefetcher *self)
+{
+    GCancellable *cancellable = g_task_get_cancellable (self->task);
+
+    /* Once cancelled, drop the downloads that haven't started */
+    if (g_cancellable_is_cancelled (cancellable)) {
+        g_queue_foreach (&self->jobs, (GFunc) fetch_job_free, NULL);
+        g_queue_clear (&self->jobs);
+    }
+
+    /* A download that fails to start completes the fetch itself if it was the last one */
+    while (self->task != NULL && self->n_running < self->max_concurrent && !g_queue_is_empty (&self->jobs)) {
+        self->n_running++;
+        start_job (g_queue_pop_head (&self->jobs));
+    }
+
+    if (self->task == NULL || self->n_running > 0 || !g_queue_is_empty (&self->jobs))
+        return;
+
+    g_autoptr(GTask) task = g_steal_pointer (&self->task);
+    if (!g_task_return_error_if_cancelled (task))
+        g_task_return_boolean (task, TRUE);
+}
+
+typedef struct
+{
+    guint width;
+    guint height;
+} TargetSize;
+
+static guint
+size_distance (SnapdMedia *media, const TargetSize *target)
+{
+    return abs ((int) snapd_media_get_width (media) - (int) target->width) +
+           abs ((int) snapd_media_get_height (media) - (int) target->height);
+}
+
+static gint
+compare_media (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    guint distance_a = size_distance (*((SnapdMedia **) a), user_data);
+    guint distance_b = size_distance (*((SnapdMedia **) b), user_data);
+    return distance_a < distance_b ? -1 : distance_a > distance_b ? 1 : 0;
+}
+
+/**
+ * snapd_media_prefetcher_new:
+ * @cache_dir: (allow-none): directory to store media in or %NULL for the default.
+ *
+ * Create an object to download snap media. The default cache directory is in
+ * the user cache directory.
+ *
+ * Returns: a new #SnapdMediaPrefetcher
+ *
+ * Since: 1.65
+ */
+SnapdMediaPrefetcher *
+snapd_media_prefetcher_new (const gchar *cache_dir)
+{
+    SnapdMediaPrefetcher *self = g_object_new (SNAPD_TYPE_MEDIA_PREFETCHER, NULL);
+    if (cache_dir != NULL)
+        self->cache_dir = g_strdup (cache_dir);
+    else
+        self->cache_dir = g_build_filename (g_get_user_cache_dir (), "snapd-glib", "media", NULL);
+
+    return self;
+}
+
+/**
+ * snapd_media_prefetcher_get_cache_dir:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ *
+ * Get the directory media is stored in.
+ *
+ * Returns: a directory path.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_media_prefetcher_get_cache_dir (SnapdMediaPrefetcher *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self), NULL);
+    return self->cache_dir;
+}
+
+/**
+ * snapd_media_prefetcher_set_max_concurrent:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ * @max_concurrent: the maximum number of downloads to run at once or 0 for the default.
+ *
+ * Set how many downloads run at once. Defaults to 6.
+ *
+ * Since: 1.65
+ */
+void
+snapd_media_prefetcher_set_max_concurrent (SnapdMediaPrefetcher *self, guint max_concurrent)
+{
+    g_return_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self));
+    self->max_concurrent = max_concurrent != 0 ? max_concurrent : DEFAULT_MAX_CONCURRENT;
+    /* The libsoup default only allows a couple of connections to each server */
+    g_object_set (self->session,
+                  "max-conns", MAX (self->max_concurrent, 10),
+                  "max-conns-per-host", self->max_concurrent,
+                  NULL);
+}
+
+/**
+ * snapd_media_prefetcher_get_max_concurrent:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ *
+ * Get the value set by snapd_media_prefetcher_set_max_concurrent().
+ *
+ * Returns: the maximum number of downloads to run at once.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_media_prefetcher_get_max_concurrent (SnapdMediaPrefetcher *self)
+{
+    g_return_val_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self), 0);
+    return self->max_concurrent;
+}
+
+/**
+ * snapd_media_prefetcher_lookup:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ * @media: a #SnapdMedia.
+ *
+ * Get the cached copy of @media from a previous download. The file may be out
+ * of date if it has changed on the server since.
+ *
+ * Returns: (transfer full) (allow-none): the path to the file or %NULL if not in the cache.
+ *
+ * Since: 1.65
+ */
+gchar *
+snapd_media_prefetcher_lookup (SnapdMediaPrefetcher *self, SnapdMedia *media)
+{
+    g_return_val_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self), NULL);
+    g_return_val_if_fail (SNAPD_IS_MEDIA (media), NULL);
+
+    g_autofree gchar *path = get_cache_path (self, snapd_media_get_url (media), "");
+    if (!g_file_test (path, G_FILE_TEST_EXISTS))
+        return NULL;
+
+    return g_steal_pointer (&path);
+}
+
+/**
+ * snapd_media_prefetcher_fetch_async:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ * @snaps: (element-type SnapdSnap): snaps to get media for.
+ * @media_type: (allow-none): the type of media to get, e.g. "screenshot", or %NULL for all types.
+ * @width: the width to prefer or 0.
+ * @height: the height to prefer or 0.
+ * @max_per_snap: the maximum number of media to get for each snap or 0 for all.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all the downloads have completed.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously download media for @snaps into the cache. When
+ * @max_per_snap is set the media closest to @width and @height are chosen,
+ * e.g. to get one icon of a suitable size. Each URL is only downloaded once,
+ * and #SnapdMediaPrefetcher::media-fetched is emitted as each download
+ * completes. Only one fetch can run at a time.
+ *
+ * Since: 1.65
+ */
+void
+snapd_media_prefetcher_fetch_async (SnapdMediaPrefetcher *self,
+                                    GPtrArray *snaps, const gchar *media_type,
+                                    guint width, guint height, guint max_per_snap,
+                                    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self));
+    g_return_if_fail (snaps != NULL);
+    g_return_if_fail (self->task == NULL);
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+
+    if (g_mkdir_with_parents (self->cache_dir, 0700) < 0) {
+        int errsv = errno;
+        g_task_return_new_error (task, G_IO_ERROR, g_io_error_from_errno (errsv),
+                                 "Failed to create media cache directory %s: %s", self->cache_dir, g_strerror (errsv));
+        return;
+    }
+
+    TargetSize target = { width, height };
+    g_autoptr(GHashTable) urls = g_hash_table_new (g_str_hash, g_str_equal);
+    for (guint i = 0; i < snaps->len; i++) {
+        SnapdSnap *snap = g_ptr_array_index (snaps, i);
+        GPtrArray *media = snapd_snap_get_media (snap);
+
+        g_autoptr(GPtrArray) selected = g_ptr_array_new ();
+        for (guint j = 0; media != NULL && j < media->len; j++) {
+            SnapdMedia *m = g_ptr_array_index (media, j);
+            if (media_type == NULL || g_strcmp0 (snapd_media_get_media_type (m), media_type) == 0)
+                g_ptr_array_add (selected, m);
+        }
+        if (max_per_snap > 0) {
+            g_ptr_array_sort_with_data (selected, compare_media, &target);
+            if (selected->len > max_per_snap)
+                g_ptr_array_set_size (selected, max_per_snap);
+        }
+
+        for (guint j = 0; j < selected->len; j++) {
+            SnapdMedia *m = g_ptr_array_index (selected, j);
+            const gchar *url = snapd_media_get_url (m);
+
+            if (url == NULL || g_hash_table_contains (urls, url))
+                continue;
+            g_hash_table_add (urls, (gpointer) url);
+
+            FetchJob *job = g_slice_new0 (FetchJob);
+            job->prefetcher = self;
+            job->snap = g_object_ref (snap);
+            job->media = g_object_ref (m);
+            job->path = get_cache_path (self, url, "");
+            job->info_path = get_cache_path (self, url, ".info");
+            g_queue_push_tail (&self->jobs, job);
+        }
+    }
+
+    /* The task holds a reference to the prefetcher, keeping it alive until all downloads have completed */
+    self->task = g_steal_pointer (&task);
+    start_jobs (self);
+}
+
+/**
+ * snapd_media_prefetcher_fetch_finish:
+ * @prefetcher: a #SnapdMediaPrefetcher.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_media_prefetcher_fetch_async().
+ * Errors from individual downloads are reported in
+ * #SnapdMediaPrefetcher::media-fetched.
+ *
+ * Returns: %TRUE if all the downloads were attempted.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_media_prefetcher_fetch_finish (SnapdMediaPrefetcher *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_MEDIA_PREFETCHER (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+snapd_media_prefetcher_finalize (GObject *object)
+{
+    SnapdMediaPrefetcher *self = SNAPD_MEDIA_PREFETCHER (object);
+
+    g_clear_object (&self->session);
+    g_clear_pointer (&self->cache_dir, g_free);
+
+    G_OBJECT_CLASS (snapd_media_prefetcher_parent_class)->finalize (object);
+}
+
+static void
+snapd_media_prefetcher_class_init (SnapdMediaPrefetcherClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_media_prefetcher_finalize;
+
+    /**
+     * SnapdMediaPrefetcher::media-fetched:
+     * @prefetcher: a #SnapdMediaPrefetcher.
+     * @snap: the #SnapdSnap the media is from.
+     * @media: the #SnapdMedia that was fetched.
+     * @path: (allow-none): the path to the cached file or %NULL on error.
+     * @error: (allow-none): the error that occurred or %NULL.
+     *
+     * Emitted when a download completes, or the cached copy was confirmed to
+     * be current.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_MEDIA_FETCHED] = g_signal_new ("media-fetched",
+                                                  G_TYPE_FROM_CLASS (klass),
+                                                  G_SIGNAL_RUN_LAST,
+                                                  0,
+                                                  NULL, NULL,
+                                                  NULL,
+                                                  G_TYPE_NONE, 4, SNAPD_TYPE_SNAP, SNAPD_TYPE_MEDIA, G_TYPE_STRING, G_TYPE_ERROR);
+}
+
+static void
+snapd_media_prefetcher_init (SnapdMediaPrefetcher *self)
+{
+    self->session = soup_session_new ();
+    g_queue_init (&self->jobs);
+    snapd_media_prefetcher_set_max_concurrent (self, DEFAULT_MAX_CONCURRENT);
+}
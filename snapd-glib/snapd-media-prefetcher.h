@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MEDIA_PREFETCHER_H__
+#define __SNAPD_MEDIA_PREFETCHER_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-media.h>
+#include <snapd-glib/snapd-snap.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_MEDIA_PREFETCHER  (snapd_media_prefetcher_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdMediaPrefetcher, snapd_media_prefetcher, SNAPD, MEDIA_PREFETCHER, GObject)
+
+SnapdMediaPrefetcher *snapd_media_prefetcher_new                (const gchar           *cache_dir);
+
+const gchar          *snapd_media_prefetcher_get_cache_dir      (SnapdMediaPrefetcher  *prefetcher);
+
+void                  snapd_media_prefetcher_set_max_concurrent (SnapdMediaPrefetcher  *prefetcher,
+                                                                 guint                  max_concurrent);
+
+guint                 snapd_media_prefetcher_get_max_concurrent (SnapdMediaPrefetcher  *prefetcher);
+
+gchar                *snapd_media_prefetcher_lookup             (SnapdMediaPrefetcher  *prefetcher,
+                                                                 SnapdMedia            *media);
+
+void                  snapd_media_prefetcher_fetch_async        (SnapdMediaPrefetcher  *prefetcher,
+                                                                 GPtrArray             *snaps,
+                                                                 const gchar           *media_type,
+                                                                 guint                  width,
+                                                                 guint                  height,
+                                                                 guint                  max_per_snap,
+                                                                 GCancellable          *cancellable,
+                                                                 GAsyncReadyCallback    callback,
+                                                                 gpointer               user_data);
+gboolean              snapd_media_prefetcher_fetch_finish       (SnapdMediaPrefetcher  *prefetcher,
+                                                                 GAsyncResult          *result,
+                                                                 GError               **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MEDIA_PREFETCHER_H__ */
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MEDIA_PRIVATE_H__
+#define __SNAPD_MEDIA_PRIVATE_H__
+
+#include "snapd-media.h"
+#include "snapd-arena.h"
+
+G_BEGIN_DECLS
+
+SnapdMedia *_snapd_media_new (SnapdArena  *arena,
+                              const gchar *type,
+                              const gchar *url,
+                              guint        width,
+                              guint        height);
+
+gsize       _snapd_media_get_memory_size (SnapdMedia *media);
+
+G_END_DECLS
+
+#endif /* __SNAPD_MEDIA_PRIVATE_H__ */
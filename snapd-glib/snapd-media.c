@@ -8,6 +8,8 @@
  */
 
 #include "snapd-media.h"
+#include "snapd-media-private.h"
+#include "snapd-memory.h"
 
 /**
  * SECTION: snapd-media
@@ -34,6 +36,9 @@ struct _SnapdMedia
     gchar *url;
     guint width;
     guint height;
+
+    /* Holds the strings if set by the parser, otherwise they are allocated separately */
+    SnapdArena *arena;
 };
 
 enum
@@ -47,6 +52,36 @@ enum
 
 G_DEFINE_TYPE (SnapdMedia, snapd_media, G_TYPE_OBJECT)
 
+static gchar *
+copy_string (SnapdMedia *self, const gchar *value)
+{
+    return self->arena != NULL ? _snapd_arena_strdup (self->arena, value) : g_strdup (value);
+}
+
+/* Create without going through properties */
+SnapdMedia *
+_snapd_media_new (SnapdArena *arena, const gchar *type, const gchar *url, guint width, guint height)
+{
+    SnapdMedia *self = g_object_new (SNAPD_TYPE_MEDIA, NULL);
+
+    if (arena != NULL)
+        self->arena = _snapd_arena_ref (arena);
+    self->type = copy_string (self, type);
+    self->url = copy_string (self, url);
+    self->width = width;
+    self->height = height;
+
+    return self;
+}
+
+gsize
+_snapd_media_get_memory_size (SnapdMedia *self)
+{
+    return _snapd_memory_instance_size (self) +
+           _snapd_memory_string_size (self->type) +
+           _snapd_memory_string_size (self->url);
+}
+
 SnapdMedia *
 snapd_media_new (void)
 {
@@ -176,8 +211,12 @@ snapd_media_finalize (GObject *object)
 {
     SnapdMedia *self = SNAPD_MEDIA (object);
 
-    g_clear_pointer (&self->type, g_free);
-    g_clear_pointer (&self->url, g_free);
+    if (self->arena != NULL)
+        g_clear_pointer (&self->arena, _snapd_arena_unref);
+    else {
+        g_free (self->type);
+        g_free (self->url);
+    }
 
     G_OBJECT_CLASS (snapd_media_parent_class)->finalize (object);
 }
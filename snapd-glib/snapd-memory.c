@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-memory.h"
+
+/* Sizes count the memory an object holds on its own. Strings that are
+ * interned are shared between objects and so are not counted, while strings
+ * in an arena are counted by their length as the arena is shared too. */
+
+/* Running total of the memory held by tracked objects. Objects can outlive
+ * the client that created them, so each holds a reference to the counter. */
+struct _SnapdMemoryCounter
+{
+    gint ref_count;
+    gssize size;
+};
+
+typedef struct
+{
+    SnapdMemoryCounter *counter;
+    gsize size;
+} TrackedObject;
+
+gsize
+_snapd_memory_string_size (const gchar *value)
+{
+    return value != NULL ? strlen (value) + 1 : 0;
+}
+
+gsize
+_snapd_memory_strv_size (GStrv values)
+{
+    if (values == NULL)
+        return 0;
+
+    gsize size = sizeof (gchar *);
+    for (int i = 0; values[i] != NULL; i++)
+        size += sizeof (gchar *) + _snapd_memory_string_size (values[i]);
+
+    return size;
+}
+
+gsize
+_snapd_memory_instance_size (gpointer object)
+{
+    GTypeQuery query;
+    g_type_query (G_TYPE_FROM_INSTANCE (object), &query);
+    return query.instance_size;
+}
+
+/* Size of the array itself, not the objects in it */
+gsize
+_snapd_memory_array_size (GPtrArray *array)
+{
+    return array != NULL ? sizeof (GPtrArray) + array->len * sizeof (gpointer) : 0;
+}
+
+SnapdMemoryCounter *
+_snapd_memory_counter_new (void)
+{
+    SnapdMemoryCounter *counter = g_slice_new0 (SnapdMemoryCounter);
+    counter->ref_count = 1;
+    return counter;
+}
+
+SnapdMemoryCounter *
+_snapd_memory_counter_ref (SnapdMemoryCounter *counter)
+{
+    g_atomic_int_inc (&counter->ref_count);
+    return counter;
+}
+
+void
+_snapd_memory_counter_unref (SnapdMemoryCounter *counter)
+{
+    if (g_atomic_int_dec_and_test (&counter->ref_count))
+        g_slice_free (SnapdMemoryCounter, counter);
+}
+
+static void
+object_finalized_cb (gpointer user_data, GObject *object)
+{
+    TrackedObject *tracked = user_data;
+
+    g_atomic_pointer_add (&tracked->counter->size, -(gssize) tracked->size);
+    _snapd_memory_counter_unref (tracked->counter);
+    g_slice_free (TrackedObject, tracked);
+}
+
+/* Add @size to @counter until @object is finalized */
+void
+_snapd_memory_counter_track (SnapdMemoryCounter *counter, GObject *object, gsize size)
+{
+    TrackedObject *tracked = g_slice_new (TrackedObject);
+    tracked->counter = _snapd_memory_counter_ref (counter);
+    tracked->size = size;
+    g_atomic_pointer_add (&counter->size, (gssize) size);
+    g_object_weak_ref (object, object_finalized_cb, tracked);
+}
+
+gsize
+_snapd_memory_counter_get_size (SnapdMemoryCounter *counter)
+{
+    return (gsize) g_atomic_pointer_get (&counter->size);
+}
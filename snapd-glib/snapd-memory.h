@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_MEMORY_H__
+#define __SNAPD_MEMORY_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SnapdMemoryCounter SnapdMemoryCounter;
+
+gsize               _snapd_memory_string_size     (const gchar        *value);
+
+gsize               _snapd_memory_strv_size       (GStrv               values);
+
+gsize               _snapd_memory_instance_size   (gpointer            object);
+
+gsize               _snapd_memory_array_size      (GPtrArray          *array);
+
+SnapdMemoryCounter *_snapd_memory_counter_new     (void);
+
+SnapdMemoryCounter *_snapd_memory_counter_ref     (SnapdMemoryCounter *counter);
+
+void                _snapd_memory_counter_unref   (SnapdMemoryCounter *counter);
+
+void                _snapd_memory_counter_track   (SnapdMemoryCounter *counter,
+                                                   GObject            *object,
+                                                   gsize               size);
+
+gsize               _snapd_memory_counter_get_size (SnapdMemoryCounter *counter);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (SnapdMemoryCounter, _snapd_memory_counter_unref)
+
+G_END_DECLS
+
+#endif /* __SNAPD_MEMORY_H__ */
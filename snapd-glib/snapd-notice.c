@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-notice.h"
+
+/**
+ * SECTION: snapd-notice
+ * @short_description: Notices of events in snapd
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdNotice records that an event occurred in snapd, e.g. a change was
+ * updated. Notices can be retrieved using snapd_client_get_notices_sync() or
+ * watched for using a #SnapdNoticesMonitor.
+ */
+
+/**
+ * SnapdNotice:
+ *
+ * #SnapdNotice contains information on an event in snapd.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdNotice
+{
+    GObject parent_instance;
+
+    gchar *id;
+    gchar *notice_type;
+    gchar *key;
+    GDateTime *first_occurred;
+    GDateTime *last_occurred;
+    GDateTime *last_repeated;
+    gint64 occurrences;
+    GHashTable *last_data;
+};
+
+enum
+{
+    PROP_ID = 1,
+    PROP_NOTICE_TYPE,
+    PROP_KEY,
+    PROP_FIRST_OCCURRED,
+    PROP_LAST_OCCURRED,
+    PROP_LAST_REPEATED,
+    PROP_OCCURRENCES,
+    PROP_LAST_DATA,
+    PROP_LAST
+};
+
+G_DEFINE_TYPE (SnapdNotice, snapd_notice, G_TYPE_OBJECT)
+
+/**
+ * snapd_notice_get_id:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the unique ID for this notice.
+ *
+ * Returns: an ID.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_notice_get_id (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->id;
+}
+
+/**
+ * snapd_notice_get_notice_type:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the type of event this notice is for, e.g. "change-update".
+ *
+ * Returns: a notice type.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_notice_get_notice_type (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->notice_type;
+}
+
+/**
+ * snapd_notice_get_key:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the key for this notice, the meaning of which depends on the notice
+ * type, e.g. the change ID for "change-update" notices.
+ *
+ * Returns: a key.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_notice_get_key (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->key;
+}
+
+/**
+ * snapd_notice_get_first_occurred:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the time this event first occurred.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not set.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_notice_get_first_occurred (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->first_occurred;
+}
+
+/**
+ * snapd_notice_get_last_occurred:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the time this event last occurred.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not set.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_notice_get_last_occurred (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->last_occurred;
+}
+
+/**
+ * snapd_notice_get_last_repeated:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the time this notice was last reported. Notices are only reported again
+ * after a period of time, so this may be earlier than the time returned by
+ * snapd_notice_get_last_occurred().
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not set.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_notice_get_last_repeated (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->last_repeated;
+}
+
+/**
+ * snapd_notice_get_occurrences:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the number of times this event has occurred.
+ *
+ * Returns: an occurrence count.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_notice_get_occurrences (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), 0);
+    return self->occurrences;
+}
+
+/**
+ * snapd_notice_get_last_data:
+ * @notice: a #SnapdNotice.
+ *
+ * Get the data provided with the last occurrence of this event.
+ *
+ * Returns: (transfer none) (element-type utf8 utf8): a table of values keyed by name.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_notice_get_last_data (SnapdNotice *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICE (self), NULL);
+    return self->last_data;
+}
+
+static void
+snapd_notice_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+    SnapdNotice *self = SNAPD_NOTICE (object);
+
+    switch (prop_id) {
+    case PROP_ID:
+        g_free (self->id);
+        self->id = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_NOTICE_TYPE:
+        g_free (self->notice_type);
+        self->notice_type = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_KEY:
+        g_free (self->key);
+        self->key = g_strdup (g_value_get_string (value));
+        break;
+    case PROP_FIRST_OCCURRED:
+        g_clear_pointer (&self->first_occurred, g_date_time_unref);
+        if (g_value_get_boxed (value) != NULL)
+            self->first_occurred = g_date_time_ref (g_value_get_boxed (value));
+        break;
+    case PROP_LAST_OCCURRED:
+        g_clear_pointer (&self->last_occurred, g_date_time_unref);
+        if (g_value_get_boxed (value) != NULL)
+            self->last_occurred = g_date_time_ref (g_value_get_boxed (value));
+        break;
+    case PROP_LAST_REPEATED:
+        g_clear_pointer (&self->last_repeated, g_date_time_unref);
+        if (g_value_get_boxed (value) != NULL)
+            self->last_repeated = g_date_time_ref (g_value_get_boxed (value));
+        break;
+    case PROP_OCCURRENCES:
+        self->occurrences = g_value_get_int64 (value);
+        break;
+    case PROP_LAST_DATA:
+        if (g_value_get_boxed (value) != NULL) {
+            g_clear_pointer (&self->last_data, g_hash_table_unref);
+            self->last_data = g_hash_table_ref (g_value_get_boxed (value));
+        }
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_notice_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+    SnapdNotice *self = SNAPD_NOTICE (object);
+
+    switch (prop_id) {
+    case PROP_ID:
+        g_value_set_string (value, self->id);
+        break;
+    case PROP_NOTICE_TYPE:
+        g_value_set_string (value, self->notice_type);
+        break;
+    case PROP_KEY:
+        g_value_set_string (value, self->key);
+        break;
+    case PROP_FIRST_OCCURRED:
+        g_value_set_boxed (value, self->first_occurred);
+        break;
+    case PROP_LAST_OCCURRED:
+        g_value_set_boxed (value, self->last_occurred);
+        break;
+    case PROP_LAST_REPEATED:
+        g_value_set_boxed (value, self->last_repeated);
+        break;
+    case PROP_OCCURRENCES:
+        g_value_set_int64 (value, self->occurrences);
+        break;
+    case PROP_LAST_DATA:
+        g_value_set_boxed (value, self->last_data);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+snapd_notice_finalize (GObject *object)
+{
+    SnapdNotice *self = SNAPD_NOTICE (object);
+
+    g_clear_pointer (&self->id, g_free);
+    g_clear_pointer (&self->notice_type, g_free);
+    g_clear_pointer (&self->key, g_free);
+    g_clear_pointer (&self->first_occurred, g_date_time_unref);
+    g_clear_pointer (&self->last_occurred, g_date_time_unref);
+    g_clear_pointer (&self->last_repeated, g_date_time_unref);
+    g_clear_pointer (&self->last_data, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_notice_parent_class)->finalize (object);
+}
+
+static void
+snapd_notice_class_init (SnapdNoticeClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->set_property = snapd_notice_set_property;
+    gobject_class->get_property = snapd_notice_get_property;
+    gobject_class->finalize = snapd_notice_finalize;
+
+    g_object_class_install_property (gobject_class,
+                                     PROP_ID,
+                                     g_param_spec_string ("id",
+                                                          "id",
+                                                          "ID of notice",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_NOTICE_TYPE,
+                                     g_param_spec_string ("notice-type",
+                                                          "notice-type",
+                                                          "Type of event",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_KEY,
+                                     g_param_spec_string ("key",
+                                                          "key",
+                                                          "Key identifying what the event is about",
+                                                          NULL,
+                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_FIRST_OCCURRED,
+                                     g_param_spec_boxed ("first-occurred",
+                                                         "first-occurred",
+                                                         "Time this event first occurred",
+                                                         G_TYPE_DATE_TIME,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_LAST_OCCURRED,
+                                     g_param_spec_boxed ("last-occurred",
+                                                         "last-occurred",
+                                                         "Time this event last occurred",
+                                                         G_TYPE_DATE_TIME,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_LAST_REPEATED,
+                                     g_param_spec_boxed ("last-repeated",
+                                                         "last-repeated",
+                                                         "Time this notice was last reported",
+                                                         G_TYPE_DATE_TIME,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_OCCURRENCES,
+                                     g_param_spec_int64 ("occurrences",
+                                                         "occurrences",
+                                                         "Number of times this event has occurred",
+                                                         0, G_MAXINT64, 0,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+    g_object_class_install_property (gobject_class,
+                                     PROP_LAST_DATA,
+                                     g_param_spec_boxed ("last-data",
+                                                         "last-data",
+                                                         "Data from the last occurrence",
+                                                         G_TYPE_HASH_TABLE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+}
+
+static void
+snapd_notice_init (SnapdNotice *self)
+{
+    self->last_data = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
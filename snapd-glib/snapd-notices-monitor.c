@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-notices-monitor.h"
+
+/**
+ * SECTION: snapd-notices-monitor
+ * @short_description: Watch for notices from snapd
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdNoticesMonitor keeps a request open to snapd and emits
+ * #SnapdNoticesMonitor::notice-event as each notice is reported. This allows
+ * cached information to be updated when it changes rather than by
+ * periodically fetching it again, e.g. to refresh a list of snaps when a
+ * change completes. The signal detail is the notice type, so handlers can
+ * connect to e.g. "notice-event::change-update" to only get notices of that
+ * type.
+ */
+
+/**
+ * SnapdNoticesMonitor:
+ *
+ * #SnapdNoticesMonitor watches for notices from snapd.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdNoticesMonitor
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* Time of the last notice seen */
+    GDateTime *since_date_time;
+
+    /* Context callbacks are made in, the current request and the timer to retry after an error */
+    GMainContext *context;
+    GCancellable *cancellable;
+    GSource *retry_source;
+};
+
+enum
+{
+    SIGNAL_NOTICE_EVENT,
+    SIGNAL_ERROR_EVENT,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdNoticesMonitor, snapd_notices_monitor, G_TYPE_OBJECT)
+
+/* Number of milliseconds snapd should wait for notices before responding */
+#define WAIT_TIMEOUT 30000
+
+/* Number of milliseconds to wait before trying again when a request fails */
+#define RETRY_INTERVAL 5000
+
+static void send_request (SnapdNoticesMonitor *self);
+
+static gboolean
+retry_cb (gpointer user_data)
+{
+    SnapdNoticesMonitor *self = user_data;
+
+    g_clear_pointer (&self->retry_source, g_source_unref);
+    send_request (self);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+get_notices_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(SnapdNoticesMonitor) self = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) notices = snapd_client_get_notices_finish (SNAPD_CLIENT (object), result, &error);
+    if (notices == NULL) {
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            return;
+
+        g_signal_emit (self, signals[SIGNAL_ERROR_EVENT], 0, error);
+        if (self->cancellable != NULL) {
+            self->retry_source = g_timeout_source_new (RETRY_INTERVAL);
+            g_source_set_callback (self->retry_source, retry_cb, g_object_ref (self), g_object_unref);
+            g_source_attach (self->retry_source, self->context);
+        }
+        return;
+    }
+
+    for (guint i = 0; i < notices->len && self->cancellable != NULL; i++) {
+        SnapdNotice *notice = g_ptr_array_index (notices, i);
+        GDateTime *last_repeated = snapd_notice_get_last_repeated (notice);
+
+        /* Times are requested with less precision than snapd has, so the last notice can be returned again */
+        if (last_repeated != NULL) {
+            if (self->since_date_time != NULL && g_date_time_compare (last_repeated, self->since_date_time) <= 0)
+                continue;
+            g_clear_pointer (&self->since_date_time, g_date_time_unref);
+            self->since_date_time = g_date_time_ref (last_repeated);
+        }
+
+        const gchar *notice_type = snapd_notice_get_notice_type (notice);
+        g_signal_emit (self, signals[SIGNAL_NOTICE_EVENT], notice_type != NULL ? g_quark_from_string (notice_type) : 0, notice);
+    }
+
+    /* Handlers may have stopped the monitor */
+    if (self->cancellable != NULL)
+        send_request (self);
+}
+
+static void
+send_request (SnapdNoticesMonitor *self)
+{
+    snapd_client_get_notices_async (self->client, self->since_date_time, WAIT_TIMEOUT, self->cancellable, get_notices_cb, g_object_ref (self));
+}
+
+/**
+ * snapd_notices_monitor_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create an object to watch for notices from snapd.
+ *
+ * Returns: a new #SnapdNoticesMonitor
+ *
+ * Since: 1.65
+ */
+SnapdNoticesMonitor *
+snapd_notices_monitor_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdNoticesMonitor *self = g_object_new (SNAPD_TYPE_NOTICES_MONITOR, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+/**
+ * snapd_notices_monitor_set_since_date_time:
+ * @monitor: a #SnapdNoticesMonitor.
+ * @since_date_time: (allow-none): a #GDateTime or %NULL.
+ *
+ * Set the time to report notices after. If not set, only notices reported
+ * after the monitor was started are reported. This is updated as notices are
+ * received, so it can be used to continue from the last notice seen. Has no
+ * effect while the monitor is running.
+ *
+ * Since: 1.65
+ */
+void
+snapd_notices_monitor_set_since_date_time (SnapdNoticesMonitor *self, GDateTime *since_date_time)
+{
+    g_return_if_fail (SNAPD_IS_NOTICES_MONITOR (self));
+
+    if (self->cancellable != NULL)
+        return;
+
+    g_clear_pointer (&self->since_date_time, g_date_time_unref);
+    if (since_date_time != NULL)
+        self->since_date_time = g_date_time_ref (since_date_time);
+}
+
+/**
+ * snapd_notices_monitor_get_since_date_time:
+ * @monitor: a #SnapdNoticesMonitor.
+ *
+ * Get the time notices are reported after. While running, this is the time
+ * the last notice was reported.
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not set.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_notices_monitor_get_since_date_time (SnapdNoticesMonitor *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICES_MONITOR (self), NULL);
+    return self->since_date_time;
+}
+
+/**
+ * snapd_notices_monitor_start:
+ * @monitor: a #SnapdNoticesMonitor.
+ *
+ * Start watching for notices. Signals are emitted in the thread-default main
+ * context of the thread calling this function. The monitor keeps a reference
+ * to itself while running, so snapd_notices_monitor_stop() must be called to
+ * release it.
+ *
+ * Since: 1.65
+ */
+void
+snapd_notices_monitor_start (SnapdNoticesMonitor *self)
+{
+    g_return_if_fail (SNAPD_IS_NOTICES_MONITOR (self));
+
+    if (self->cancellable != NULL)
+        return;
+
+    if (self->since_date_time == NULL)
+        self->since_date_time = g_date_time_new_now_utc ();
+    g_clear_pointer (&self->context, g_main_context_unref);
+    self->context = g_main_context_ref_thread_default ();
+    self->cancellable = g_cancellable_new ();
+    send_request (self);
+}
+
+/**
+ * snapd_notices_monitor_stop:
+ * @monitor: a #SnapdNoticesMonitor.
+ *
+ * Stop watching for notices.
+ *
+ * Since: 1.65
+ */
+void
+snapd_notices_monitor_stop (SnapdNoticesMonitor *self)
+{
+    g_return_if_fail (SNAPD_IS_NOTICES_MONITOR (self));
+
+    if (self->cancellable != NULL)
+        g_cancellable_cancel (self->cancellable);
+    g_clear_object (&self->cancellable);
+    if (self->retry_source != NULL)
+        g_source_destroy (self->retry_source);
+    g_clear_pointer (&self->retry_source, g_source_unref);
+}
+
+/**
+ * snapd_notices_monitor_get_running:
+ * @monitor: a #SnapdNoticesMonitor.
+ *
+ * Get if the monitor is watching for notices.
+ *
+ * Returns: %TRUE if running.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_notices_monitor_get_running (SnapdNoticesMonitor *self)
+{
+    g_return_val_if_fail (SNAPD_IS_NOTICES_MONITOR (self), FALSE);
+    return self->cancellable != NULL;
+}
+
+static void
+snapd_notices_monitor_dispose (GObject *object)
+{
+    SnapdNoticesMonitor *self = SNAPD_NOTICES_MONITOR (object);
+
+    snapd_notices_monitor_stop (self);
+
+    G_OBJECT_CLASS (snapd_notices_monitor_parent_class)->dispose (object);
+}
+
+static void
+snapd_notices_monitor_finalize (GObject *object)
+{
+    SnapdNoticesMonitor *self = SNAPD_NOTICES_MONITOR (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->since_date_time, g_date_time_unref);
+    g_clear_pointer (&self->context, g_main_context_unref);
+
+    G_OBJECT_CLASS (snapd_notices_monitor_parent_class)->finalize (object);
+}
+
+static void
+snapd_notices_monitor_class_init (SnapdNoticesMonitorClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->dispose = snapd_notices_monitor_dispose;
+    gobject_class->finalize = snapd_notices_monitor_finalize;
+
+    /**
+     * SnapdNoticesMonitor::notice-event:
+     * @monitor: a #SnapdNoticesMonitor.
+     * @notice: the #SnapdNotice reported.
+     *
+     * Emitted when snapd reports a notice. The signal detail is the notice type.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_NOTICE_EVENT] = g_signal_new ("notice-event",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST | G_SIGNAL_DETAILED,
+                                                 0,
+                                                 NULL, NULL,
+                                                 NULL,
+                                                 G_TYPE_NONE, 1, SNAPD_TYPE_NOTICE);
+
+    /**
+     * SnapdNoticesMonitor::error-event:
+     * @monitor: a #SnapdNoticesMonitor.
+     * @error: the #GError that occurred.
+     *
+     * Emitted when a request for notices fails. The monitor keeps trying while running.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_ERROR_EVENT] = g_signal_new ("error-event",
+                                                G_TYPE_FROM_CLASS (klass),
+                                                G_SIGNAL_RUN_LAST,
+                                                0,
+                                                NULL, NULL,
+                                                NULL,
+                                                G_TYPE_NONE, 1, G_TYPE_ERROR);
+}
+
+static void
+snapd_notices_monitor_init (SnapdNoticesMonitor *self)
+{
+}
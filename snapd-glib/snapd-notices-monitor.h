@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_NOTICES_MONITOR_H__
+#define __SNAPD_NOTICES_MONITOR_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_NOTICES_MONITOR  (snapd_notices_monitor_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdNoticesMonitor, snapd_notices_monitor, SNAPD, NOTICES_MONITOR, GObject)
+
+SnapdNoticesMonitor *snapd_notices_monitor_new                 (SnapdClient         *client);
+
+void                 snapd_notices_monitor_set_since_date_time (SnapdNoticesMonitor *monitor,
+                                                                GDateTime           *since_date_time);
+
+GDateTime           *snapd_notices_monitor_get_since_date_time (SnapdNoticesMonitor *monitor);
+
+void                 snapd_notices_monitor_start               (SnapdNoticesMonitor *monitor);
+
+void                 snapd_notices_monitor_stop                (SnapdNoticesMonitor *monitor);
+
+gboolean             snapd_notices_monitor_get_running         (SnapdNoticesMonitor *monitor);
+
+G_END_DECLS
+
+#endif /* __SNAPD_NOTICES_MONITOR_H__ */
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_PENDING_REQUEST_PRIVATE_H__
+#define __SNAPD_PENDING_REQUEST_PRIVATE_H__
+
+#include "snapd-pending-request.h"
+
+G_BEGIN_DECLS
+
+SnapdPendingRequest *_snapd_pending_request_new (const gchar              *method,
+                                                 const gchar              *path,
+                                                 SnapdPendingRequestState  state,
+                                                 const gchar              *change_id,
+                                                 gint64                    age,
+                                                 gsize                     bytes_sent,
+                                                 gsize                     bytes_received);
+
+G_END_DECLS
+
+#endif /* __SNAPD_PENDING_REQUEST_PRIVATE_H__ */
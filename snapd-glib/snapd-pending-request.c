@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-pending-request-private.h"
+
+/**
+ * SECTION:snapd-pending-request
+ * @short_description: Requests waiting for snapd
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdPendingRequest describes a request that hasn't completed, at the
+ * time it was returned by snapd_client_get_pending_requests() or emitted in
+ * the #SnapdClient::slow-request signal. It shows if the request is waiting
+ * to be sent, waiting for snapd to respond, receiving or processing a
+ * response, or waiting for a change to complete.
+ */
+
+/**
+ * SnapdPendingRequest:
+ *
+ * #SnapdPendingRequest contains the state of a request that hasn't completed.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdPendingRequest
+{
+    GObject parent_instance;
+
+    gchar *method;
+    gchar *path;
+    SnapdPendingRequestState state;
+    gchar *change_id;
+    gint64 age;
+    gsize bytes_sent;
+    gsize bytes_received;
+};
+
+G_DEFINE_TYPE (SnapdPendingRequest, snapd_pending_request, G_TYPE_OBJECT)
+
+SnapdPendingRequest *
+_snapd_pending_request_new (const gchar *method, const gchar *path, SnapdPendingRequestState state, const gchar *change_id,
+                            gint64 age, gsize bytes_sent, gsize bytes_received)
+{
+    SnapdPendingRequest *self = g_object_new (SNAPD_TYPE_PENDING_REQUEST, NULL);
+
+    self->method = g_strdup (method);
+    self->path = g_strdup (path);
+    self->state = state;
+    self->change_id = g_strdup (change_id);
+    self->age = age;
+    self->bytes_sent = bytes_sent;
+    self->bytes_received = bytes_received;
+
+    return self;
+}
+
+/**
+ * snapd_pending_request_get_method:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get the HTTP method used, e.g. "POST".
+ *
+ * Returns: a method name.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_pending_request_get_method (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), NULL);
+    return self->method;
+}
+
+/**
+ * snapd_pending_request_get_path:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get the path requested, e.g. "/v2/snaps/hello".
+ *
+ * Returns: a path.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_pending_request_get_path (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), NULL);
+    return self->path;
+}
+
+/**
+ * snapd_pending_request_get_state:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get what the request is waiting for.
+ *
+ * Returns: a #SnapdPendingRequestState.
+ *
+ * Since: 1.65
+ */
+SnapdPendingRequestState
+snapd_pending_request_get_state (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), SNAPD_PENDING_REQUEST_STATE_QUEUED);
+    return self->state;
+}
+
+/**
+ * snapd_pending_request_get_change_id:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get the ID of the change the request is waiting for.
+ *
+ * Returns: (allow-none): a change ID or %NULL if the request hasn't started a change.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_pending_request_get_change_id (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), NULL);
+    return self->change_id;
+}
+
+/**
+ * snapd_pending_request_get_age:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get how long ago the request was made.
+ *
+ * Returns: a time in microseconds.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_pending_request_get_age (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), 0);
+    return self->age;
+}
+
+/**
+ * snapd_pending_request_get_bytes_sent:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get the number of bytes of the request written to snapd so far.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_pending_request_get_bytes_sent (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), 0);
+    return self->bytes_sent;
+}
+
+/**
+ * snapd_pending_request_get_bytes_received:
+ * @request: a #SnapdPendingRequest.
+ *
+ * Get the number of bytes of the response received from snapd so far.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_pending_request_get_bytes_received (SnapdPendingRequest *self)
+{
+    g_return_val_if_fail (SNAPD_IS_PENDING_REQUEST (self), 0);
+    return self->bytes_received;
+}
+
+static void
+snapd_pending_request_finalize (GObject *object)
+{
+    SnapdPendingRequest *self = SNAPD_PENDING_REQUEST (object);
+
+    g_clear_pointer (&self->method, g_free);
+    g_clear_pointer (&self->path, g_free);
+    g_clear_pointer (&self->change_id, g_free);
+
+    G_OBJECT_CLASS (snapd_pending_request_parent_class)->finalize (object);
+}
+
+static void
+snapd_pending_request_class_init (SnapdPendingRequestClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_pending_request_finalize;
+}
+
+static void
+snapd_pending_request_init (SnapdPendingRequest *self)
+{
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_PENDING_REQUEST_H__
+#define __SNAPD_PENDING_REQUEST_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_PENDING_REQUEST (snapd_pending_request_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdPendingRequest, snapd_pending_request, SNAPD, PENDING_REQUEST, GObject)
+
+/**
+ * SnapdPendingRequestState:
+ * @SNAPD_PENDING_REQUEST_STATE_QUEUED: the request is waiting to be written to snapd.
+ * @SNAPD_PENDING_REQUEST_STATE_WAITING: the request has been written and snapd hasn't responded.
+ * @SNAPD_PENDING_REQUEST_STATE_RECEIVING: the response is being received.
+ * @SNAPD_PENDING_REQUEST_STATE_PARSING: the response has been received and is being processed.
+ * @SNAPD_PENDING_REQUEST_STATE_POLLING: snapd has started a change and the request is waiting for it to complete.
+ *
+ * What a request that hasn't completed is waiting for.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_PENDING_REQUEST_STATE_QUEUED,
+    SNAPD_PENDING_REQUEST_STATE_WAITING,
+    SNAPD_PENDING_REQUEST_STATE_RECEIVING,
+    SNAPD_PENDING_REQUEST_STATE_PARSING,
+    SNAPD_PENDING_REQUEST_STATE_POLLING
+} SnapdPendingRequestState;
+
+const gchar             *snapd_pending_request_get_method         (SnapdPendingRequest *request);
+
+const gchar             *snapd_pending_request_get_path           (SnapdPendingRequest *request);
+
+SnapdPendingRequestState snapd_pending_request_get_state          (SnapdPendingRequest *request);
+
+const gchar             *snapd_pending_request_get_change_id      (SnapdPendingRequest *request);
+
+gint64                   snapd_pending_request_get_age            (SnapdPendingRequest *request);
+
+gsize                    snapd_pending_request_get_bytes_sent     (SnapdPendingRequest *request);
+
+gsize                    snapd_pending_request_get_bytes_received (SnapdPendingRequest *request);
+
+G_END_DECLS
+
+#endif /* __SNAPD_PENDING_REQUEST_H__ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_PRICE_PRIVATE_H__
+#define __SNAPD_PRICE_PRIVATE_H__
+
+#include "snapd-price.h"
+#include "snapd-arena.h"
+
+G_BEGIN_DECLS
+
+SnapdPrice *_snapd_price_new (SnapdArena  *arena,
+                              gdouble      amount,
+                              const gchar *currency);
+
+gsize       _snapd_price_get_memory_size (SnapdPrice *price);
+
+G_END_DECLS
+
+#endif /* __SNAPD_PRICE_PRIVATE_H__ */
@@ -8,6 +8,8 @@
  */
 
 #include "snapd-price.h"
+#include "snapd-price-private.h"
+#include "snapd-memory.h"
 
 /**
  * SECTION: snapd-price
@@ -33,6 +35,9 @@ struct _SnapdPrice
 
     gdouble amount;
     gchar *currency;
+
+    /* Holds the strings if set by the parser, otherwise they are allocated separately */
+    SnapdArena *arena;
 };
 
 enum
@@ -44,6 +49,33 @@ enum
 
 G_DEFINE_TYPE (SnapdPrice, snapd_price, G_TYPE_OBJECT)
 
+static gchar *
+copy_string (SnapdPrice *self, const gchar *value)
+{
+    return self->arena != NULL ? _snapd_arena_strdup (self->arena, value) : g_strdup (value);
+}
+
+/* Create without going through properties */
+SnapdPrice *
+_snapd_price_new (SnapdArena *arena, gdouble amount, const gchar *currency)
+{
+    SnapdPrice *self = g_object_new (SNAPD_TYPE_PRICE, NULL);
+
+    if (arena != NULL)
+        self->arena = _snapd_arena_ref (arena);
+    self->amount = amount;
+    self->currency = copy_string (self, currency);
+
+    return self;
+}
+
+gsize
+_snapd_price_get_memory_size (SnapdPrice *self)
+{
+    return _snapd_memory_instance_size (self) +
+           _snapd_memory_string_size (self->currency);
+}
+
 /**
  * snapd_price_get_amount:
  * @price: a #SnapdPrice.
@@ -120,7 +152,11 @@ snapd_price_finalize (GObject *object)
 {
     SnapdPrice *self = SNAPD_PRICE (object);
 
-    g_clear_pointer (&self->currency, g_free);
+    if (self->arena != NULL)
+        g_clear_pointer (&self->arena, _snapd_arena_unref);
+    else {
+        g_free (self->currency);
+    }
 
     G_OBJECT_CLASS (snapd_price_parent_class)->finalize (object);
 }
@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-refreshable-cache.h"
+
+/**
+ * SECTION: snapd-refreshable-cache
+ * @short_description: Cached refreshable snaps
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdRefreshableCache keeps the result of
+ * snapd_client_find_refreshable_async(), which makes snapd contact the store.
+ * Each call to snapd_refreshable_cache_get_async() checks the refresh times
+ * from snapd_client_get_system_information_async() and the installed snaps,
+ * which snapd has locally. The store is only asked again when snapd has run
+ * a refresh, the next scheduled refresh time has passed, or snaps have been
+ * installed, removed or changed revision. Calls made while a check is in
+ * progress wait for its result instead of making their own requests.
+ */
+
+/**
+ * SnapdRefreshableCache:
+ *
+ * #SnapdRefreshableCache holds the snaps that can be refreshed.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdRefreshableCache
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* Result of the last store check, and the state it was made in */
+    GPtrArray *snaps;
+    GDateTime *refresh_last;
+    GDateTime *refresh_next;
+    gchar *installed;
+
+    /* Tasks waiting for the check in progress */
+    GPtrArray *tasks;
+    GCancellable *cancellable;
+};
+
+G_DEFINE_TYPE (SnapdRefreshableCache, snapd_refreshable_cache, G_TYPE_OBJECT)
+
+static gboolean
+date_time_equal (GDateTime *a, GDateTime *b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+    return g_date_time_equal (a, b);
+}
+
+/* Make a string that changes when any snap is installed, removed or changes revision */
+static gchar *
+get_installed_key (GPtrArray *snaps)
+{
+    g_autoptr(GString) key = g_string_new ("");
+    for (guint i = 0; i < snaps->len; i++) {
+        SnapdSnap *snap = g_ptr_array_index (snaps, i);
+        g_string_append_printf (key, "%s=%s;", snapd_snap_get_name (snap), snapd_snap_get_revision (snap));
+    }
+    return g_string_free (g_steal_pointer (&key), FALSE);
+}
+
+static void
+return_error (SnapdRefreshableCache *self, GError *error)
+{
+    g_autoptr(GPtrArray) tasks = g_steal_pointer (&self->tasks);
+    self->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    g_clear_object (&self->cancellable);
+
+    for (guint i = 0; i < tasks->len; i++)
+        g_task_return_error (g_ptr_array_index (tasks, i), g_error_copy (error));
+}
+
+static void
+return_snaps (SnapdRefreshableCache *self)
+{
+    g_autoptr(GPtrArray) tasks = g_steal_pointer (&self->tasks);
+    self->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    g_clear_object (&self->cancellable);
+
+    for (guint i = 0; i < tasks->len; i++)
+        g_task_return_pointer (g_ptr_array_index (tasks, i), g_ptr_array_ref (self->snaps), (GDestroyNotify) g_ptr_array_unref);
+}
+
+typedef struct
+{
+    SnapdRefreshableCache *cache;
+    GDateTime *refresh_last;
+    GDateTime *refresh_next;
+    gchar *installed;
+} CheckData;
+
+static void
+check_data_free (CheckData *data)
+{
+    g_object_unref (data->cache);
+    g_clear_pointer (&data->refresh_last, g_date_time_unref);
+    g_clear_pointer (&data->refresh_next, g_date_time_unref);
+    g_free (data->installed);
+    g_slice_free (CheckData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (CheckData, check_data_free)
+
+static void
+find_refreshable_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(CheckData) data = user_data;
+    SnapdRefreshableCache *self = data->cache;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_finish (SNAPD_CLIENT (object), result, &error);
+    if (snaps == NULL) {
+        return_error (self, error);
+        return;
+    }
+
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    self->snaps = g_steal_pointer (&snaps);
+    g_clear_pointer (&self->refresh_last, g_date_time_unref);
+    self->refresh_last = g_steal_pointer (&data->refresh_last);
+    g_clear_pointer (&self->refresh_next, g_date_time_unref);
+    self->refresh_next = g_steal_pointer (&data->refresh_next);
+    g_free (self->installed);
+    self->installed = g_steal_pointer (&data->installed);
+
+    return_snaps (self);
+}
+
+static gboolean
+cache_valid (SnapdRefreshableCache *self, CheckData *data)
+{
+    if (self->snaps == NULL)
+        return FALSE;
+
+    if (!date_time_equal (self->refresh_last, data->refresh_last) ||
+        g_strcmp0 (self->installed, data->installed) != 0)
+        return FALSE;
+
+    /* The refresh timer has fired, even if snapd is yet to record it */
+    g_autoptr(GDateTime) now = g_date_time_new_now_utc ();
+    if (self->refresh_next != NULL && g_date_time_compare (now, self->refresh_next) >= 0)
+        return FALSE;
+    if (data->refresh_next != NULL && g_date_time_compare (now, data->refresh_next) >= 0)
+        return FALSE;
+
+    return TRUE;
+}
+
+static void
+get_snaps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(CheckData) data = user_data;
+    SnapdRefreshableCache *self = data->cache;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    if (snaps == NULL) {
+        return_error (self, error);
+        return;
+    }
+    data->installed = get_installed_key (snaps);
+
+    if (cache_valid (self, data)) {
+        return_snaps (self);
+        return;
+    }
+
+    snapd_client_find_refreshable_async (self->client, self->cancellable, find_refreshable_cb, g_steal_pointer (&data));
+}
+
+static void
+system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(CheckData) data = user_data;
+    SnapdRefreshableCache *self = data->cache;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
+    if (info == NULL) {
+        return_error (self, error);
+        return;
+    }
+
+    GDateTime *refresh_last = snapd_system_information_get_refresh_last (info);
+    if (refresh_last != NULL)
+        data->refresh_last = g_date_time_ref (refresh_last);
+    GDateTime *refresh_next = snapd_system_information_get_refresh_next (info);
+    if (refresh_next != NULL)
+        data->refresh_next = g_date_time_ref (refresh_next);
+
+    snapd_client_get_snaps_async (self->client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, self->cancellable, get_snaps_cb, g_steal_pointer (&data));
+}
+
+/**
+ * snapd_refreshable_cache_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create a cache of refreshable snaps. The cache is empty until
+ * snapd_refreshable_cache_get_async() is called.
+ *
+ * Returns: a new #SnapdRefreshableCache
+ *
+ * Since: 1.65
+ */
+SnapdRefreshableCache *
+snapd_refreshable_cache_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdRefreshableCache *self = g_object_new (SNAPD_TYPE_REFRESHABLE_CACHE, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+/**
+ * snapd_refreshable_cache_get_async:
+ * @cache: a #SnapdRefreshableCache.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the snaps that can be refreshed, as with
+ * snapd_client_find_refreshable_async(), using the cached result if nothing
+ * has changed since it was made. @cancellable only cancels the check if no
+ * other calls are waiting for it.
+ *
+ * Since: 1.65
+ */
+void
+snapd_refreshable_cache_get_async (SnapdRefreshableCache *self, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_REFRESHABLE_CACHE (self));
+
+    g_ptr_array_add (self->tasks, g_task_new (self, cancellable, callback, user_data));
+    if (self->tasks->len > 1) {
+        /* Waiting on more than one caller, so no single cancellable can stop the check */
+        g_clear_object (&self->cancellable);
+        return;
+    }
+
+    if (cancellable != NULL)
+        self->cancellable = g_object_ref (cancellable);
+    CheckData *data = g_slice_new0 (CheckData);
+    data->cache = g_object_ref (self);
+    snapd_client_get_system_information_async (self->client, self->cancellable, system_information_cb, data);
+}
+
+/**
+ * snapd_refreshable_cache_get_finish:
+ * @cache: a #SnapdRefreshableCache.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_refreshable_cache_get_async().
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_refreshable_cache_get_finish (SnapdRefreshableCache *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_REFRESHABLE_CACHE (self), NULL);
+    g_return_val_if_fail (g_task_is_valid (result, self), NULL);
+
+    return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * snapd_refreshable_cache_get_snaps:
+ * @cache: a #SnapdRefreshableCache.
+ *
+ * Get the snaps from the last check, without checking if they are current.
+ *
+ * Returns: (transfer none) (element-type SnapdSnap) (allow-none): an array of #SnapdSnap or %NULL if not checked yet.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_refreshable_cache_get_snaps (SnapdRefreshableCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REFRESHABLE_CACHE (self), NULL);
+    return self->snaps;
+}
+
+/**
+ * snapd_refreshable_cache_invalidate:
+ * @cache: a #SnapdRefreshableCache.
+ *
+ * Drop the cached result, so the next call to
+ * snapd_refreshable_cache_get_async() asks the store again, e.g. when the
+ * user explicitly asks to check for updates.
+ *
+ * Since: 1.65
+ */
+void
+snapd_refreshable_cache_invalidate (SnapdRefreshableCache *self)
+{
+    g_return_if_fail (SNAPD_IS_REFRESHABLE_CACHE (self));
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+}
+
+static void
+snapd_refreshable_cache_finalize (GObject *object)
+{
+    SnapdRefreshableCache *self = SNAPD_REFRESHABLE_CACHE (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+    g_clear_pointer (&self->refresh_last, g_date_time_unref);
+    g_clear_pointer (&self->refresh_next, g_date_time_unref);
+    g_clear_pointer (&self->installed, g_free);
+    g_clear_pointer (&self->tasks, g_ptr_array_unref);
+    g_clear_object (&self->cancellable);
+
+    G_OBJECT_CLASS (snapd_refreshable_cache_parent_class)->finalize (object);
+}
+
+static void
+snapd_refreshable_cache_class_init (SnapdRefreshableCacheClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_refreshable_cache_finalize;
+}
+
+static void
+snapd_refreshable_cache_init (SnapdRefreshableCache *self)
+{
+    self->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+}
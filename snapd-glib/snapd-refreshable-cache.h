@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_REFRESHABLE_CACHE_H__
+#define __SNAPD_REFRESHABLE_CACHE_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_REFRESHABLE_CACHE  (snapd_refreshable_cache_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdRefreshableCache, snapd_refreshable_cache, SNAPD, REFRESHABLE_CACHE, GObject)
+
+SnapdRefreshableCache *snapd_refreshable_cache_new        (SnapdClient            *client);
+
+void                   snapd_refreshable_cache_get_async  (SnapdRefreshableCache  *cache,
+                                                           GCancellable           *cancellable,
+                                                           GAsyncReadyCallback     callback,
+                                                           gpointer                user_data);
+GPtrArray             *snapd_refreshable_cache_get_finish (SnapdRefreshableCache  *cache,
+                                                           GAsyncResult           *result,
+                                                           GError                **error);
+
+GPtrArray             *snapd_refreshable_cache_get_snaps  (SnapdRefreshableCache  *cache);
+
+void                   snapd_refreshable_cache_invalidate (SnapdRefreshableCache  *cache);
+
+G_END_DECLS
+
+#endif /* __SNAPD_REFRESHABLE_CACHE_H__ */
@@ -0,0 +1,665 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-request-batch.h"
+
+/**
+ * SECTION: snapd-request-batch
+ * @short_description: Many read requests run together
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdRequestBatch collects read requests, e.g. the snap, configuration
+ * and connections for several snaps, and runs them all at once with
+ * snapd_request_batch_run_async(). The requests are all sent immediately, so
+ * they are pipelined over the client connections. #SnapdRequestBatch::request-completed
+ * is emitted as each one finishes and the callback is called once all have
+ * finished. The result of each request is then retrieved by the index
+ * returned when it was added.
+ *
+ * A batch can also hold snapctl commands, so a hook that runs many commands
+ * only pays for one connection. snapd handles the requests on a connection in
+ * the order they are sent, so with the default of one connection (see
+ * snapd_client_set_max_connections()) the commands run in the order they were
+ * added.
+ */
+
+/**
+ * SnapdRequestBatch:
+ *
+ * #SnapdRequestBatch is a set of requests to run together.
+ *
+ * Since: 1.65
+ */
+
+typedef enum
+{
+    BATCH_ITEM_GET_SNAP,
+    BATCH_ITEM_GET_SNAP_CONF,
+    BATCH_ITEM_GET_APPS,
+    BATCH_ITEM_GET_CONNECTIONS,
+    BATCH_ITEM_RUN_SNAPCTL
+} BatchItemType;
+
+/* A single request in a batch, with its arguments and results */
+typedef struct
+{
+    SnapdRequestBatch *batch;
+    guint index;
+    BatchItemType type;
+
+    gchar *name;
+    GStrv strv;
+    guint flags;
+    gchar *interface;
+
+    gboolean completed;
+    GError *error;
+    SnapdSnap *snap;
+    GHashTable *conf;
+    GPtrArray *apps;
+    GPtrArray *established;
+    GPtrArray *undesired;
+    GPtrArray *plugs;
+    GPtrArray *slots;
+    gchar *stdout_output;
+    gchar *stderr_output;
+    int exit_code;
+} BatchItem;
+
+struct _SnapdRequestBatch
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* Requests in the order they were added */
+    GPtrArray *items;
+
+    /* Task for the current run, and the number of requests it is waiting for */
+    GTask *task;
+    guint n_running;
+};
+
+enum
+{
+    SIGNAL_REQUEST_COMPLETED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdRequestBatch, snapd_request_batch, G_TYPE_OBJECT)
+
+static void
+batch_item_free (BatchItem *item)
+{
+    g_free (item->name);
+    g_strfreev (item->strv);
+    g_free (item->interface);
+    g_clear_error (&item->error);
+    g_clear_object (&item->snap);
+    g_clear_pointer (&item->conf, g_hash_table_unref);
+    g_clear_pointer (&item->apps, g_ptr_array_unref);
+    g_clear_pointer (&item->established, g_ptr_array_unref);
+    g_clear_pointer (&item->undesired, g_ptr_array_unref);
+    g_clear_pointer (&item->plugs, g_ptr_array_unref);
+    g_clear_pointer (&item->slots, g_ptr_array_unref);
+    g_free (item->stdout_output);
+    g_free (item->stderr_output);
+    g_slice_free (BatchItem, item);
+}
+
+static BatchItem *
+add_item (SnapdRequestBatch *self, BatchItemType type)
+{
+    BatchItem *item = g_slice_new0 (BatchItem);
+    item->batch = self;
+    item->index = self->items->len;
+    item->type = type;
+    g_ptr_array_add (self->items, item);
+
+    return item;
+}
+
+static BatchItem *
+get_completed_item (SnapdRequestBatch *self, guint index, BatchItemType type)
+{
+    if (index >= self->items->len)
+        return NULL;
+
+    BatchItem *item = g_ptr_array_index (self->items, index);
+    if (item->type != type || !item->completed || item->error != NULL)
+        return NULL;
+
+    return item;
+}
+
+/**
+ * snapd_request_batch_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create an empty batch of requests.
+ *
+ * Returns: a new #SnapdRequestBatch
+ *
+ * Since: 1.65
+ */
+SnapdRequestBatch *
+snapd_request_batch_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdRequestBatch *self = g_object_new (SNAPD_TYPE_REQUEST_BATCH, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+/**
+ * snapd_request_batch_add_get_snap:
+ * @batch: a #SnapdRequestBatch.
+ * @name: name of snap to get.
+ *
+ * Add a request to get an installed snap, as with snapd_client_get_snap_async().
+ * The result is retrieved with snapd_request_batch_get_snap().
+ *
+ * Returns: the index of the request in the batch.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_add_get_snap (SnapdRequestBatch *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    g_return_val_if_fail (self->task == NULL, 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    BatchItem *item = add_item (self, BATCH_ITEM_GET_SNAP);
+    item->name = g_strdup (name);
+
+    return item->index;
+}
+
+/**
+ * snapd_request_batch_add_get_snap_conf:
+ * @batch: a #SnapdRequestBatch.
+ * @name: name of snap to get configuration from.
+ * @keys: (allow-none): keys to returns or %NULL to return all.
+ *
+ * Add a request to get configuration for a snap, as with snapd_client_get_snap_conf_async().
+ * The result is retrieved with snapd_request_batch_get_snap_conf().
+ *
+ * Returns: the index of the request in the batch.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_add_get_snap_conf (SnapdRequestBatch *self, const gchar *name, GStrv keys)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    g_return_val_if_fail (self->task == NULL, 0);
+    g_return_val_if_fail (name != NULL, 0);
+
+    BatchItem *item = add_item (self, BATCH_ITEM_GET_SNAP_CONF);
+    item->name = g_strdup (name);
+    item->strv = g_strdupv (keys);
+
+    return item->index;
+}
+
+/**
+ * snapd_request_batch_add_get_apps:
+ * @batch: a #SnapdRequestBatch.
+ * @flags: a set of #SnapdGetAppsFlags to control what results are returned.
+ * @snaps: (allow-none): A list of snap names to return results for. If %NULL or empty then apps for all installed snaps are returned.
+ *
+ * Add a request to get apps, as with snapd_client_get_apps2_async().
+ * The result is retrieved with snapd_request_batch_get_apps().
+ *
+ * Returns: the index of the request in the batch.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_add_get_apps (SnapdRequestBatch *self, SnapdGetAppsFlags flags, GStrv snaps)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    g_return_val_if_fail (self->task == NULL, 0);
+
+    BatchItem *item = add_item (self, BATCH_ITEM_GET_APPS);
+    item->flags = flags;
+    item->strv = g_strdupv (snaps);
+
+    return item->index;
+}
+
+/**
+ * snapd_request_batch_add_get_connections:
+ * @batch: a #SnapdRequestBatch.
+ * @flags: a set of #SnapdGetConnectionsFlags to control what results are returned.
+ * @snap: (allow-none): the name of the snap to get connections for or %NULL for all snaps.
+ * @interface: (allow-none): the name of the interface to get connections for or %NULL for all interfaces.
+ *
+ * Add a request to get connections, as with snapd_client_get_connections2_async().
+ * The result is retrieved with snapd_request_batch_get_connections().
+ *
+ * Returns: the index of the request in the batch.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_add_get_connections (SnapdRequestBatch *self, SnapdGetConnectionsFlags flags, const gchar *snap, const gchar *interface)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    g_return_val_if_fail (self->task == NULL, 0);
+
+    BatchItem *item = add_item (self, BATCH_ITEM_GET_CONNECTIONS);
+    item->flags = flags;
+    item->name = g_strdup (snap);
+    item->interface = g_strdup (interface);
+
+    return item->index;
+}
+
+/**
+ * snapd_request_batch_add_run_snapctl:
+ * @batch: a #SnapdRequestBatch.
+ * @context_id: context for this call.
+ * @args: the arguments to pass to snapctl.
+ *
+ * Add a snapctl command, as with snapd_client_run_snapctl2_async().
+ * The result is retrieved with snapd_request_batch_get_snapctl_output().
+ *
+ * Returns: the index of the request in the batch.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_add_run_snapctl (SnapdRequestBatch *self, const gchar *context_id, GStrv args)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    g_return_val_if_fail (self->task == NULL, 0);
+    g_return_val_if_fail (context_id != NULL, 0);
+    g_return_val_if_fail (args != NULL, 0);
+
+    BatchItem *item = add_item (self, BATCH_ITEM_RUN_SNAPCTL);
+    item->name = g_strdup (context_id);
+    item->strv = g_strdupv (args);
+
+    return item->index;
+}
+
+/**
+ * snapd_request_batch_get_n_requests:
+ * @batch: a #SnapdRequestBatch.
+ *
+ * Get the number of requests that have been added to the batch.
+ *
+ * Returns: the number of requests.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_batch_get_n_requests (SnapdRequestBatch *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), 0);
+    return self->items->len;
+}
+
+static void
+item_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    BatchItem *item = user_data;
+    SnapdRequestBatch *self = item->batch;
+    SnapdClient *client = SNAPD_CLIENT (object);
+
+    switch (item->type)
+    {
+    case BATCH_ITEM_GET_SNAP:
+        item->snap = snapd_client_get_snap_finish (client, result, &item->error);
+        break;
+    case BATCH_ITEM_GET_SNAP_CONF:
+        item->conf = snapd_client_get_snap_conf_finish (client, result, &item->error);
+        break;
+    case BATCH_ITEM_GET_APPS:
+        item->apps = snapd_client_get_apps2_finish (client, result, &item->error);
+        break;
+    case BATCH_ITEM_GET_CONNECTIONS:
+        snapd_client_get_connections2_finish (client, result, &item->established, &item->undesired, &item->plugs, &item->slots, &item->error);
+        break;
+    case BATCH_ITEM_RUN_SNAPCTL:
+        snapd_client_run_snapctl2_finish (client, result, &item->stdout_output, &item->stderr_output, &item->exit_code, &item->error);
+        break;
+    }
+    item->completed = TRUE;
+
+    g_signal_emit (self, signals[SIGNAL_REQUEST_COMPLETED], 0, item->index);
+
+    self->n_running--;
+    if (self->n_running > 0)
+        return;
+
+    /* Clear the task before returning so the callback can inspect the results and run the batch again */
+    g_autoptr(GTask) task = g_steal_pointer (&self->task);
+    g_autoptr(GError) error = NULL;
+    if (g_cancellable_set_error_if_cancelled (g_task_get_cancellable (task), &error)) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+    for (guint i = 0; i < self->items->len; i++) {
+        BatchItem *i_item = g_ptr_array_index (self->items, i);
+        if (i_item->error != NULL) {
+            g_task_return_error (task, g_error_copy (i_item->error));
+            return;
+        }
+    }
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+reset_item (BatchItem *item)
+{
+    item->completed = FALSE;
+    g_clear_error (&item->error);
+    g_clear_object (&item->snap);
+    g_clear_pointer (&item->conf, g_hash_table_unref);
+    g_clear_pointer (&item->apps, g_ptr_array_unref);
+    g_clear_pointer (&item->established, g_ptr_array_unref);
+    g_clear_pointer (&item->undesired, g_ptr_array_unref);
+    g_clear_pointer (&item->plugs, g_ptr_array_unref);
+    g_clear_pointer (&item->slots, g_ptr_array_unref);
+    g_clear_pointer (&item->stdout_output, g_free);
+    g_clear_pointer (&item->stderr_output, g_free);
+    item->exit_code = 0;
+}
+
+/**
+ * snapd_request_batch_run_async:
+ * @batch: a #SnapdRequestBatch.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when all the requests have completed.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously run all the requests in the batch. Results from a previous
+ * run are discarded. Requests can't be added while the batch is running.
+ *
+ * Since: 1.65
+ */
+void
+snapd_request_batch_run_async (SnapdRequestBatch *self, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_REQUEST_BATCH (self));
+    g_return_if_fail (self->task == NULL);
+
+    GTask *task = g_task_new (self, cancellable, callback, user_data);
+    if (self->items->len == 0) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* The task holds a reference to the batch, keeping the items alive until they have all completed */
+    self->task = task;
+    self->n_running = self->items->len;
+    for (guint i = 0; i < self->items->len; i++) {
+        BatchItem *item = g_ptr_array_index (self->items, i);
+
+        reset_item (item);
+        switch (item->type)
+        {
+        case BATCH_ITEM_GET_SNAP:
+            snapd_client_get_snap_async (self->client, item->name, cancellable, item_cb, item);
+            break;
+        case BATCH_ITEM_GET_SNAP_CONF:
+            snapd_client_get_snap_conf_async (self->client, item->name, item->strv, cancellable, item_cb, item);
+            break;
+        case BATCH_ITEM_GET_APPS:
+            snapd_client_get_apps2_async (self->client, item->flags, item->strv, cancellable, item_cb, item);
+            break;
+        case BATCH_ITEM_GET_CONNECTIONS:
+            snapd_client_get_connections2_async (self->client, item->flags, item->name, item->interface, cancellable, item_cb, item);
+            break;
+        case BATCH_ITEM_RUN_SNAPCTL:
+            snapd_client_run_snapctl2_async (self->client, item->name, item->strv, cancellable, item_cb, item);
+            break;
+        }
+    }
+}
+
+/**
+ * snapd_request_batch_run_finish:
+ * @batch: a #SnapdRequestBatch.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_request_batch_run_async().
+ * The results of the requests that succeeded are available even if this
+ * returns an error.
+ *
+ * Returns: %TRUE if all the requests succeeded or %FALSE with the error from the first one that failed.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_request_batch_run_finish (SnapdRequestBatch *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_request_batch_get_error:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of the request.
+ * @error: (allow-none): #GError location to store the error from the request, or %NULL to ignore.
+ *
+ * Check if a request in the batch succeeded.
+ *
+ * Returns: %TRUE if the request completed successfully.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_request_batch_get_error (SnapdRequestBatch *self, guint index, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), FALSE);
+    g_return_val_if_fail (index < self->items->len, FALSE);
+
+    BatchItem *item = g_ptr_array_index (self->items, index);
+    if (!item->completed) {
+        g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_PENDING, "Request has not completed");
+        return FALSE;
+    }
+    if (item->error != NULL) {
+        g_propagate_error (error, g_error_copy (item->error));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * snapd_request_batch_get_snap:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of a request added with snapd_request_batch_add_get_snap().
+ *
+ * Get the result of a request for a snap.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdSnap or %NULL if the request failed or has not completed.
+ *
+ * Since: 1.65
+ */
+SnapdSnap *
+snapd_request_batch_get_snap (SnapdRequestBatch *self, guint index)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), NULL);
+
+    BatchItem *item = get_completed_item (self, index, BATCH_ITEM_GET_SNAP);
+    return item != NULL ? item->snap : NULL;
+}
+
+/**
+ * snapd_request_batch_get_snap_conf:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of a request added with snapd_request_batch_add_get_snap_conf().
+ *
+ * Get the result of a request for snap configuration.
+ *
+ * Returns: (transfer none) (element-type utf8 GVariant) (allow-none): a table of configuration values or %NULL if the request failed or has not completed.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_request_batch_get_snap_conf (SnapdRequestBatch *self, guint index)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), NULL);
+
+    BatchItem *item = get_completed_item (self, index, BATCH_ITEM_GET_SNAP_CONF);
+    return item != NULL ? item->conf : NULL;
+}
+
+/**
+ * snapd_request_batch_get_apps:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of a request added with snapd_request_batch_add_get_apps().
+ *
+ * Get the result of a request for apps.
+ *
+ * Returns: (transfer none) (element-type SnapdApp) (allow-none): an array of #SnapdApp or %NULL if the request failed or has not completed.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_request_batch_get_apps (SnapdRequestBatch *self, guint index)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), NULL);
+
+    BatchItem *item = get_completed_item (self, index, BATCH_ITEM_GET_APPS);
+    return item != NULL ? item->apps : NULL;
+}
+
+/**
+ * snapd_request_batch_get_connections:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of a request added with snapd_request_batch_add_get_connections().
+ * @established: (out) (allow-none) (transfer none) (element-type SnapdConnection): the established connections or %NULL.
+ * @undesired: (out) (allow-none) (transfer none) (element-type SnapdConnection): the undesired connections or %NULL.
+ * @plugs: (out) (allow-none) (transfer none) (element-type SnapdPlug): the plugs or %NULL.
+ * @slots: (out) (allow-none) (transfer none) (element-type SnapdSlot): the slots or %NULL.
+ *
+ * Get the result of a request for connections.
+ *
+ * Returns: %TRUE if the request completed successfully.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_request_batch_get_connections (SnapdRequestBatch *self, guint index,
+                                     GPtrArray **established, GPtrArray **undesired,
+                                     GPtrArray **plugs, GPtrArray **slots)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), FALSE);
+
+    BatchItem *item = get_completed_item (self, index, BATCH_ITEM_GET_CONNECTIONS);
+    if (item == NULL)
+        return FALSE;
+
+    if (established != NULL)
+        *established = item->established;
+    if (undesired != NULL)
+        *undesired = item->undesired;
+    if (plugs != NULL)
+        *plugs = item->plugs;
+    if (slots != NULL)
+        *slots = item->slots;
+
+    return TRUE;
+}
+
+/**
+ * snapd_request_batch_get_snapctl_output:
+ * @batch: a #SnapdRequestBatch.
+ * @index: index of a request added with snapd_request_batch_add_run_snapctl().
+ * @stdout_output: (out) (allow-none) (transfer none): the location to write the stdout from the command or %NULL.
+ * @stderr_output: (out) (allow-none) (transfer none): the location to write the stderr from the command or %NULL.
+ * @exit_code: (out) (allow-none): the location to write the exit code of the command or %NULL.
+ *
+ * Get the result of a snapctl command. A command that ran but exited with a
+ * non-zero exit code still completes successfully.
+ *
+ * Returns: %TRUE if the request completed successfully.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_request_batch_get_snapctl_output (SnapdRequestBatch *self, guint index,
+                                        const gchar **stdout_output, const gchar **stderr_output,
+                                        int *exit_code)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_BATCH (self), FALSE);
+
+    BatchItem *item = get_completed_item (self, index, BATCH_ITEM_RUN_SNAPCTL);
+    if (item == NULL)
+        return FALSE;
+
+    if (stdout_output != NULL)
+        *stdout_output = item->stdout_output;
+    if (stderr_output != NULL)
+        *stderr_output = item->stderr_output;
+    if (exit_code != NULL)
+        *exit_code = item->exit_code;
+
+    return TRUE;
+}
+
+static void
+snapd_request_batch_finalize (GObject *object)
+{
+    SnapdRequestBatch *self = SNAPD_REQUEST_BATCH (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->items, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_request_batch_parent_class)->finalize (object);
+}
+
+static void
+snapd_request_batch_class_init (SnapdRequestBatchClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_request_batch_finalize;
+
+    /**
+     * SnapdRequestBatch::request-completed:
+     * @batch: a #SnapdRequestBatch.
+     * @index: the index of the request that completed.
+     *
+     * Emitted when a request in the batch completes, before the batch as a
+     * whole has completed. The result is available from the matching
+     * snapd_request_batch_get_*() call.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_REQUEST_COMPLETED] = g_signal_new ("request-completed",
+                                                      G_TYPE_FROM_CLASS (klass),
+                                                      G_SIGNAL_RUN_LAST,
+                                                      0,
+                                                      NULL, NULL,
+                                                      NULL,
+                                                      G_TYPE_NONE, 1, G_TYPE_UINT);
+}
+
+static void
+snapd_request_batch_init (SnapdRequestBatch *self)
+{
+    self->items = g_ptr_array_new_with_free_func ((GDestroyNotify) batch_item_free);
+}
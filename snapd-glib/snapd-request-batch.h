@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_REQUEST_BATCH_H__
+#define __SNAPD_REQUEST_BATCH_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-client.h>
+#include <snapd-glib/snapd-snap.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_REQUEST_BATCH  (snapd_request_batch_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdRequestBatch, snapd_request_batch, SNAPD, REQUEST_BATCH, GObject)
+
+SnapdRequestBatch *snapd_request_batch_new                 (SnapdClient              *client);
+
+guint              snapd_request_batch_add_get_snap        (SnapdRequestBatch        *batch,
+                                                            const gchar              *name);
+
+guint              snapd_request_batch_add_get_snap_conf   (SnapdRequestBatch        *batch,
+                                                            const gchar              *name,
+                                                            GStrv                     keys);
+
+guint              snapd_request_batch_add_get_apps        (SnapdRequestBatch        *batch,
+                                                            SnapdGetAppsFlags         flags,
+                                                            GStrv                     snaps);
+
+guint              snapd_request_batch_add_get_connections (SnapdRequestBatch        *batch,
+                                                            SnapdGetConnectionsFlags  flags,
+                                                            const gchar              *snap,
+                                                            const gchar              *interface);
+
+guint              snapd_request_batch_add_run_snapctl     (SnapdRequestBatch        *batch,
+                                                            const gchar              *context_id,
+                                                            GStrv                     args);
+
+guint              snapd_request_batch_get_n_requests      (SnapdRequestBatch        *batch);
+
+void               snapd_request_batch_run_async           (SnapdRequestBatch        *batch,
+                                                            GCancellable             *cancellable,
+                                                            GAsyncReadyCallback       callback,
+                                                            gpointer                  user_data);
+gboolean           snapd_request_batch_run_finish          (SnapdRequestBatch        *batch,
+                                                            GAsyncResult             *result,
+                                                            GError                  **error);
+
+gboolean           snapd_request_batch_get_error           (SnapdRequestBatch        *batch,
+                                                            guint                     index,
+                                                            GError                  **error);
+
+SnapdSnap         *snapd_request_batch_get_snap            (SnapdRequestBatch        *batch,
+                                                            guint                     index);
+
+GHashTable        *snapd_request_batch_get_snap_conf       (SnapdRequestBatch        *batch,
+                                                            guint                     index);
+
+GPtrArray         *snapd_request_batch_get_apps            (SnapdRequestBatch        *batch,
+                                                            guint                     index);
+
+gboolean           snapd_request_batch_get_connections     (SnapdRequestBatch        *batch,
+                                                            guint                     index,
+                                                            GPtrArray               **established,
+                                                            GPtrArray               **undesired,
+                                                            GPtrArray               **plugs,
+                                                            GPtrArray               **slots);
+
+gboolean           snapd_request_batch_get_snapctl_output  (SnapdRequestBatch        *batch,
+                                                            guint                     index,
+                                                            const gchar             **stdout_output,
+                                                            const gchar             **stderr_output,
+                                                            int                      *exit_code);
+
+G_END_DECLS
+
+#endif /* __SNAPD_REQUEST_BATCH_H__ */
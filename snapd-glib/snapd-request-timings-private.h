@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_REQUEST_TIMINGS_PRIVATE_H__
+#define __SNAPD_REQUEST_TIMINGS_PRIVATE_H__
+
+#include "snapd-request-timings.h"
+
+G_BEGIN_DECLS
+
+SnapdRequestTimings *_snapd_request_timings_new             (void);
+
+void                 _snapd_request_timings_set_request     (SnapdRequestTimings *timings,
+                                                             const gchar         *method,
+                                                             const gchar         *path);
+
+void                 _snapd_request_timings_set_status_code (SnapdRequestTimings *timings,
+                                                             guint                status_code);
+
+void                 _snapd_request_timings_add_bytes_sent  (SnapdRequestTimings *timings,
+                                                             gsize                n_bytes);
+
+void                 _snapd_request_timings_add_bytes_received (SnapdRequestTimings *timings,
+                                                                gsize                n_bytes);
+
+void                 _snapd_request_timings_set_bytes_pending (SnapdRequestTimings *timings,
+                                                               gsize                n_bytes);
+
+gsize                _snapd_request_timings_get_bytes_pending (SnapdRequestTimings *timings);
+
+void                 _snapd_request_timings_set_time        (SnapdRequestTimings *timings,
+                                                             SnapdRequestPhase    phase,
+                                                             gint64               time);
+
+G_END_DECLS
+
+#endif /* __SNAPD_REQUEST_TIMINGS_PRIVATE_H__ */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-request-timings-private.h"
+
+/**
+ * SECTION:snapd-request-timings
+ * @short_description: Request timing information
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdRequestTimings records when a request to snapd reached each stage
+ * of being sent and answered, and how much data was transferred. Timings are
+ * retrieved with snapd_client_get_request_timings() or from the
+ * #SnapdClient::request-finished signal.
+ */
+
+/**
+ * SnapdRequestTimings:
+ *
+ * #SnapdRequestTimings contains timing information for a request.
+ *
+ * Since: 1.65
+ */
+
+#define N_PHASES (SNAPD_REQUEST_PHASE_COMPLETED + 1)
+
+struct _SnapdRequestTimings
+{
+    GObject parent_instance;
+
+    gchar *method;
+    gchar *path;
+    guint status_code;
+    gsize bytes_sent;
+    gsize bytes_received;
+    gsize bytes_pending;
+    gint64 times[N_PHASES];
+};
+
+G_DEFINE_TYPE (SnapdRequestTimings, snapd_request_timings, G_TYPE_OBJECT)
+
+SnapdRequestTimings *
+_snapd_request_timings_new (void)
+{
+    return g_object_new (SNAPD_TYPE_REQUEST_TIMINGS, NULL);
+}
+
+void
+_snapd_request_timings_set_request (SnapdRequestTimings *self, const gchar *method, const gchar *path)
+{
+    g_free (self->method);
+    self->method = g_strdup (method);
+    g_free (self->path);
+    self->path = g_strdup (path);
+}
+
+void
+_snapd_request_timings_set_status_code (SnapdRequestTimings *self, guint status_code)
+{
+    self->status_code = status_code;
+}
+
+void
+_snapd_request_timings_add_bytes_sent (SnapdRequestTimings *self, gsize n_bytes)
+{
+    self->bytes_sent += n_bytes;
+}
+
+void
+_snapd_request_timings_add_bytes_received (SnapdRequestTimings *self, gsize n_bytes)
+{
+    self->bytes_received += n_bytes;
+}
+
+/* Bytes of a response that is still being received, which are added to the total when it is complete */
+void
+_snapd_request_timings_set_bytes_pending (SnapdRequestTimings *self, gsize n_bytes)
+{
+    self->bytes_pending = n_bytes;
+}
+
+gsize
+_snapd_request_timings_get_bytes_pending (SnapdRequestTimings *self)
+{
+    return self->bytes_pending;
+}
+
+void
+_snapd_request_timings_set_time (SnapdRequestTimings *self, SnapdRequestPhase phase, gint64 time)
+{
+    g_return_if_fail (phase < N_PHASES);
+    self->times[phase] = time;
+}
+
+/**
+ * snapd_request_timings_get_method:
+ * @timings: a #SnapdRequestTimings.
+ *
+ * Get the HTTP method used, e.g. "GET".
+ *
+ * Returns: (allow-none): a method name or %NULL if the request was not sent to snapd.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_request_timings_get_method (SnapdRequestTimings *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), NULL);
+    return self->method;
+}
+
+/**
+ * snapd_request_timings_get_path:
+ * @timings: a #SnapdRequestTimings.
+ *
+ * Get the path requested, e.g. "/v2/snaps".
+ *
+ * Returns: (allow-none): a path or %NULL if the request was not sent to snapd.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_request_timings_get_path (SnapdRequestTimings *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), NULL);
+    return self->path;
+}
+
+/**
+ * snapd_request_timings_get_status_code:
+ * @timings: a #SnapdRequestTimings.
+ *
+ * Get the HTTP status code of the response.
+ *
+ * Returns: a status code or 0 if no response was received.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_request_timings_get_status_code (SnapdRequestTimings *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), 0);
+    return self->status_code;
+}
+
+/**
+ * snapd_request_timings_get_bytes_sent:
+ * @timings: a #SnapdRequestTimings.
+ *
+ * Get the number of bytes written to snapd for the request headers and body.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_request_timings_get_bytes_sent (SnapdRequestTimings *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), 0);
+    return self->bytes_sent;
+}
+
+/**
+ * snapd_request_timings_get_bytes_received:
+ * @timings: a #SnapdRequestTimings.
+ *
+ * Get the number of bytes received from snapd for the response headers and body.
+ *
+ * Returns: a number of bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_request_timings_get_bytes_received (SnapdRequestTimings *self)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), 0);
+    return self->bytes_received;
+}
+
+/**
+ * snapd_request_timings_get_time:
+ * @timings: a #SnapdRequestTimings.
+ * @phase: a #SnapdRequestPhase.
+ *
+ * Get the time the request reached @phase, in the same clock as
+ * g_get_monotonic_time(). Phases are skipped by requests that are answered
+ * without contacting snapd, e.g. from the response cache.
+ *
+ * Returns: a time in microseconds or 0 if the phase was not reached.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_request_timings_get_time (SnapdRequestTimings *self, SnapdRequestPhase phase)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), 0);
+    g_return_val_if_fail (phase < N_PHASES, 0);
+    return self->times[phase];
+}
+
+/**
+ * snapd_request_timings_get_duration:
+ * @timings: a #SnapdRequestTimings.
+ * @start: the #SnapdRequestPhase to measure from.
+ * @end: the #SnapdRequestPhase to measure to.
+ *
+ * Get the time taken between two phases of the request, e.g.
+ * %SNAPD_REQUEST_PHASE_WRITTEN and %SNAPD_REQUEST_PHASE_FIRST_BYTE for the time
+ * snapd took to start responding.
+ *
+ * Returns: a duration in microseconds or -1 if either phase was not reached.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_request_timings_get_duration (SnapdRequestTimings *self, SnapdRequestPhase start, SnapdRequestPhase end)
+{
+    g_return_val_if_fail (SNAPD_IS_REQUEST_TIMINGS (self), -1);
+    g_return_val_if_fail (start < N_PHASES && end < N_PHASES, -1);
+
+    if (self->times[start] == 0 || self->times[end] == 0)
+        return -1;
+    return self->times[end] - self->times[start];
+}
+
+static void
+snapd_request_timings_finalize (GObject *object)
+{
+    SnapdRequestTimings *self = SNAPD_REQUEST_TIMINGS (object);
+
+    g_clear_pointer (&self->method, g_free);
+    g_clear_pointer (&self->path, g_free);
+
+    G_OBJECT_CLASS (snapd_request_timings_parent_class)->finalize (object);
+}
+
+static void
+snapd_request_timings_class_init (SnapdRequestTimingsClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_request_timings_finalize;
+}
+
+static void
+snapd_request_timings_init (SnapdRequestTimings *self)
+{
+}
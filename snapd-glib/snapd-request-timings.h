@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_REQUEST_TIMINGS_H__
+#define __SNAPD_REQUEST_TIMINGS_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_REQUEST_TIMINGS (snapd_request_timings_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdRequestTimings, snapd_request_timings, SNAPD, REQUEST_TIMINGS, GObject)
+
+/**
+ * SnapdRequestPhase:
+ * @SNAPD_REQUEST_PHASE_STARTED: the request was started.
+ * @SNAPD_REQUEST_PHASE_WRITTEN: the request was written to the socket.
+ * @SNAPD_REQUEST_PHASE_FIRST_BYTE: the first byte of the response was received.
+ * @SNAPD_REQUEST_PHASE_HEADERS: the response headers were parsed.
+ * @SNAPD_REQUEST_PHASE_BODY: the response body was received.
+ * @SNAPD_REQUEST_PHASE_PARSED: the response body was parsed.
+ * @SNAPD_REQUEST_PHASE_COMPLETED: the request callback was called.
+ *
+ * Points in the life of a request that are timed.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_REQUEST_PHASE_STARTED,
+    SNAPD_REQUEST_PHASE_WRITTEN,
+    SNAPD_REQUEST_PHASE_FIRST_BYTE,
+    SNAPD_REQUEST_PHASE_HEADERS,
+    SNAPD_REQUEST_PHASE_BODY,
+    SNAPD_REQUEST_PHASE_PARSED,
+    SNAPD_REQUEST_PHASE_COMPLETED
+} SnapdRequestPhase;
+
+const gchar *snapd_request_timings_get_method         (SnapdRequestTimings *timings);
+
+const gchar *snapd_request_timings_get_path           (SnapdRequestTimings *timings);
+
+guint        snapd_request_timings_get_status_code    (SnapdRequestTimings *timings);
+
+gsize        snapd_request_timings_get_bytes_sent     (SnapdRequestTimings *timings);
+
+gsize        snapd_request_timings_get_bytes_received (SnapdRequestTimings *timings);
+
+gint64       snapd_request_timings_get_time           (SnapdRequestTimings *timings,
+                                                       SnapdRequestPhase    phase);
+
+gint64       snapd_request_timings_get_duration       (SnapdRequestTimings *timings,
+                                                       SnapdRequestPhase    start,
+                                                       SnapdRequestPhase    end);
+
+G_END_DECLS
+
+#endif /* __SNAPD_REQUEST_TIMINGS_H__ */
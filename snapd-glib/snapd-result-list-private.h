@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_RESULT_LIST_PRIVATE_H__
+#define __SNAPD_RESULT_LIST_PRIVATE_H__
+
+#include "snapd-result-list.h"
+
+G_BEGIN_DECLS
+
+void _snapd_list_model_update (GListModel *model,
+                               GPtrArray  *items,
+                               GPtrArray  *new_items);
+
+G_END_DECLS
+
+#endif /* __SNAPD_RESULT_LIST_PRIVATE_H__ */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-result-list-private.h"
+
+/**
+ * SECTION: snapd-result-list
+ * @short_description: Results as a list model
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdResultList holds the results of a request, such as the snaps
+ * returned by snapd_client_get_snaps_model_finish(), as a #GListModel.
+ * Language bindings convert a returned #GPtrArray and every object in it
+ * before the caller sees any of them. With a #SnapdResultList only the
+ * objects that are accessed with g_list_model_get_item() are converted, and
+ * the list can be given directly to widgets that display list models.
+ *
+ * The contents of a #SnapdResultList don't change.
+ */
+
+/**
+ * SnapdResultList:
+ *
+ * #SnapdResultList is a list model of results from snapd.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdResultList
+{
+    GObject parent_instance;
+
+    GType item_type;
+    GPtrArray *items;
+};
+
+static void snapd_result_list_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SnapdResultList, snapd_result_list, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, snapd_result_list_list_model_init))
+
+/**
+ * snapd_result_list_new:
+ * @item_type: the #GType of the objects in @items.
+ * @items: (element-type GObject): the objects to hold.
+ *
+ * Create a list model holding @items. The array is referenced, not copied,
+ * so must not be modified afterwards.
+ *
+ * Returns: (transfer full): a new #SnapdResultList
+ *
+ * Since: 1.65
+ */
+SnapdResultList *
+snapd_result_list_new (GType item_type, GPtrArray *items)
+{
+    g_return_val_if_fail (g_type_is_a (item_type, G_TYPE_OBJECT), NULL);
+    g_return_val_if_fail (items != NULL, NULL);
+
+    SnapdResultList *self = g_object_new (SNAPD_TYPE_RESULT_LIST, NULL);
+    self->item_type = item_type;
+    self->items = g_ptr_array_ref (items);
+
+    return self;
+}
+
+/**
+ * snapd_result_list_get_array:
+ * @list: a #SnapdResultList.
+ *
+ * Get the objects in the list as an array, for C callers that prefer to
+ * index it directly.
+ *
+ * Returns: (transfer none) (element-type GObject): an array of objects.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_result_list_get_array (SnapdResultList *self)
+{
+    g_return_val_if_fail (SNAPD_IS_RESULT_LIST (self), NULL);
+    return self->items;
+}
+
+/* Replace the objects in @items, the contents of @model, with @new_items.
+ * Objects in both are matched by identity and #GListModel::items-changed is
+ * emitted for each run of objects that were removed, added or replaced.
+ * If objects have been reordered everything after the first move is replaced */
+void
+_snapd_list_model_update (GListModel *model, GPtrArray *items, GPtrArray *new_items)
+{
+    g_autoptr(GHashTable) old_set = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < items->len; i++)
+        g_hash_table_add (old_set, g_ptr_array_index (items, i));
+    g_autoptr(GHashTable) new_set = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < new_items->len; i++)
+        g_hash_table_add (new_set, g_ptr_array_index (new_items, i));
+
+    /* Walk both lists, with @position the index in @items as it is being updated */
+    guint position = 0, j = 0;
+    while (position < items->len || j < new_items->len) {
+        if (position < items->len && j < new_items->len &&
+            g_ptr_array_index (items, position) == g_ptr_array_index (new_items, j)) {
+            position++;
+            j++;
+            continue;
+        }
+
+        guint n_removed = 0;
+        while (position + n_removed < items->len && !g_hash_table_contains (new_set, g_ptr_array_index (items, position + n_removed)))
+            n_removed++;
+        guint n_added = 0;
+        while (j + n_added < new_items->len && !g_hash_table_contains (old_set, g_ptr_array_index (new_items, j + n_added)))
+            n_added++;
+        if (n_removed == 0 && n_added == 0) {
+            n_removed = items->len - position;
+            n_added = new_items->len - j;
+        }
+
+        g_ptr_array_remove_range (items, position, n_removed);
+        for (guint k = 0; k < n_added; k++)
+            g_ptr_array_insert (items, position + k, g_object_ref (g_ptr_array_index (new_items, j + k)));
+        g_list_model_items_changed (model, position, n_removed, n_added);
+        position += n_added;
+        j += n_added;
+    }
+}
+
+static GType
+snapd_result_list_get_item_type (GListModel *model)
+{
+    return SNAPD_RESULT_LIST (model)->item_type;
+}
+
+static guint
+snapd_result_list_get_n_items (GListModel *model)
+{
+    return SNAPD_RESULT_LIST (model)->items->len;
+}
+
+static gpointer
+snapd_result_list_get_item (GListModel *model, guint position)
+{
+    SnapdResultList *self = SNAPD_RESULT_LIST (model);
+
+    if (position >= self->items->len)
+        return NULL;
+    return g_object_ref (g_ptr_array_index (self->items, position));
+}
+
+static void
+snapd_result_list_list_model_init (GListModelInterface *iface)
+{
+    iface->get_item_type = snapd_result_list_get_item_type;
+    iface->get_n_items = snapd_result_list_get_n_items;
+    iface->get_item = snapd_result_list_get_item;
+}
+
+static void
+snapd_result_list_finalize (GObject *object)
+{
+    SnapdResultList *self = SNAPD_RESULT_LIST (object);
+
+    g_clear_pointer (&self->items, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_result_list_parent_class)->finalize (object);
+}
+
+static void
+snapd_result_list_class_init (SnapdResultListClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_result_list_finalize;
+}
+
+static void
+snapd_result_list_init (SnapdResultList *self)
+{
+    self->item_type = G_TYPE_OBJECT;
+}
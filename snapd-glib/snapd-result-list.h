@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_RESULT_LIST_H__
+#define __SNAPD_RESULT_LIST_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_RESULT_LIST  (snapd_result_list_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdResultList, snapd_result_list, SNAPD, RESULT_LIST, GObject)
+
+SnapdResultList *snapd_result_list_new       (GType            item_type,
+                                              GPtrArray       *items);
+
+GPtrArray       *snapd_result_list_get_array (SnapdResultList *list);
+
+G_END_DECLS
+
+#endif /* __SNAPD_RESULT_LIST_H__ */
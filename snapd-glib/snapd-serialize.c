@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <gio/gio.h>
+
+#include "snapd-serialize.h"
+
+/* Objects are serialized as a GVariant of type (sqv) containing the kind of
+ * object, the format version and the object as a tuple of fixed type. The
+ * tuple is read directly from the serialized data, so strings are used in
+ * place. Fields are only ever added to the end of a tuple, with the version
+ * increased so older readers reject it. */
+#define FORMAT_VERSION 1
+
+GBytes *
+_snapd_serialize_wrap (const gchar *kind, GVariant *value)
+{
+    g_autoptr(GVariant) wrapper = g_variant_ref_sink (g_variant_new ("(sqv)", kind, FORMAT_VERSION, value));
+    return g_variant_get_data_as_bytes (wrapper);
+}
+
+/* Get the tuple of @type from @data, which is not trusted to be well formed.
+ * @arena is set to one that keeps the data alive, for the strings inside it */
+GVariant *
+_snapd_serialize_unwrap (GBytes *data, const gchar *kind, const gchar *type, SnapdArena **arena, GError **error)
+{
+    /* The data is copied if not aligned, so strings are taken from the buffer the variant uses */
+    g_autoptr(GVariant) wrapper = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("(sqv)"), data, FALSE));
+
+    const gchar *wrapper_kind;
+    guint16 version;
+    g_autoptr(GVariant) value = NULL;
+    g_variant_get (wrapper, "(&sqv)", &wrapper_kind, &version, &value);
+    if (g_strcmp0 (wrapper_kind, kind) != 0) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Serialized data is not a %s", kind);
+        return NULL;
+    }
+    if (version != FORMAT_VERSION) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Unsupported serialization version %u", version);
+        return NULL;
+    }
+    if (!g_variant_is_of_type (value, G_VARIANT_TYPE (type))) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Serialized %s has unexpected type %s", kind, g_variant_get_type_string (value));
+        return NULL;
+    }
+
+    g_autoptr(GBytes) wrapper_data = g_variant_get_data_as_bytes (wrapper);
+    *arena = _snapd_arena_new_for_bytes (wrapper_data);
+    return g_steal_pointer (&value);
+}
+
+GVariant *
+_snapd_serialize_date_time (GDateTime *date_time)
+{
+    if (date_time == NULL)
+        return g_variant_new_maybe (G_VARIANT_TYPE ("(xi)"), NULL);
+
+    gint64 time = g_date_time_to_unix (date_time) * G_USEC_PER_SEC + g_date_time_get_microsecond (date_time);
+    gint32 offset = g_date_time_get_utc_offset (date_time) / G_USEC_PER_SEC;
+    return g_variant_new_maybe (NULL, g_variant_new ("(xi)", time, offset));
+}
+
+GVariant *
+_snapd_serialize_timestamp (const SnapdTimestamp *timestamp)
+{
+    if (!timestamp->is_set)
+        return g_variant_new_maybe (G_VARIANT_TYPE ("(xi)"), NULL);
+
+    return g_variant_new_maybe (NULL, g_variant_new ("(xi)", timestamp->time, timestamp->utc_offset));
+}
+
+void
+_snapd_reader_init (SnapdReader *reader, GVariant *value)
+{
+    reader->value = value;
+    reader->index = 0;
+}
+
+static GVariant *
+next_child (SnapdReader *reader)
+{
+    return g_variant_get_child_value (reader->value, reader->index++);
+}
+
+/* Returns a string inside the serialized data, or %NULL if not set */
+const gchar *
+_snapd_reader_get_string (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    g_autoptr(GVariant) value = g_variant_get_maybe (child);
+    return value != NULL ? g_variant_get_string (value, NULL) : NULL;
+}
+
+gboolean
+_snapd_reader_get_boolean (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_boolean (child);
+}
+
+guint8
+_snapd_reader_get_byte (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_byte (child);
+}
+
+guint32
+_snapd_reader_get_uint32 (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_uint32 (child);
+}
+
+gint64
+_snapd_reader_get_int64 (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_int64 (child);
+}
+
+gdouble
+_snapd_reader_get_double (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_double (child);
+}
+
+void
+_snapd_reader_get_timestamp (SnapdReader *reader, SnapdTimestamp *timestamp)
+{
+    _snapd_timestamp_clear (timestamp);
+
+    g_autoptr(GVariant) child = next_child (reader);
+    g_autoptr(GVariant) value = g_variant_get_maybe (child);
+    if (value == NULL)
+        return;
+
+    gint64 time;
+    gint32 offset;
+    g_variant_get (value, "(xi)", &time, &offset);
+    _snapd_timestamp_set (timestamp, time, offset);
+}
+
+GDateTime *
+_snapd_reader_get_date_time (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    g_autoptr(GVariant) value = g_variant_get_maybe (child);
+    if (value == NULL)
+        return NULL;
+
+    gint64 time;
+    gint32 offset;
+    g_variant_get (value, "(xi)", &time, &offset);
+    return _snapd_date_time_new (time, offset);
+}
+
+GStrv
+_snapd_reader_get_strv (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    g_autoptr(GVariant) value = g_variant_get_maybe (child);
+    return value != NULL ? g_variant_dup_strv (value, NULL) : NULL;
+}
+
+/* Returns the contents of an optional array, or %NULL if not set */
+GVariant *
+_snapd_reader_get_array (SnapdReader *reader)
+{
+    g_autoptr(GVariant) child = next_child (reader);
+    return g_variant_get_maybe (child);
+}
+
+GVariant *
+_snapd_reader_get_value (SnapdReader *reader)
+{
+    return next_child (reader);
+}
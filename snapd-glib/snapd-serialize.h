@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SERIALIZE_H__
+#define __SNAPD_SERIALIZE_H__
+
+#include <glib.h>
+
+#include "snapd-arena.h"
+#include "snapd-timestamp.h"
+
+G_BEGIN_DECLS
+
+/* Serialized date and time, as microseconds since the epoch and UTC offset in seconds */
+#define SNAPD_SERIALIZED_DATE_TIME "m(xi)"
+
+/* Reads the members of a serialized tuple in order */
+typedef struct
+{
+    GVariant *value;
+    gsize index;
+} SnapdReader;
+
+GBytes      *_snapd_serialize_wrap             (const gchar  *kind,
+                                                GVariant     *value);
+
+GVariant    *_snapd_serialize_unwrap           (GBytes       *data,
+                                                const gchar  *kind,
+                                                const gchar  *type,
+                                                SnapdArena  **arena,
+                                                GError      **error);
+
+GVariant    *_snapd_serialize_date_time        (GDateTime    *date_time);
+
+GVariant    *_snapd_serialize_timestamp        (const SnapdTimestamp *timestamp);
+
+void         _snapd_reader_init                (SnapdReader  *reader,
+                                                GVariant     *value);
+
+const gchar *_snapd_reader_get_string          (SnapdReader  *reader);
+
+gboolean     _snapd_reader_get_boolean         (SnapdReader  *reader);
+
+guint8       _snapd_reader_get_byte            (SnapdReader  *reader);
+
+guint32      _snapd_reader_get_uint32          (SnapdReader  *reader);
+
+gint64       _snapd_reader_get_int64           (SnapdReader  *reader);
+
+gdouble      _snapd_reader_get_double          (SnapdReader  *reader);
+
+GDateTime   *_snapd_reader_get_date_time       (SnapdReader  *reader);
+
+void         _snapd_reader_get_timestamp       (SnapdReader    *reader,
+                                                SnapdTimestamp *timestamp);
+
+GStrv        _snapd_reader_get_strv            (SnapdReader  *reader);
+
+GVariant    *_snapd_reader_get_array           (SnapdReader  *reader);
+
+GVariant    *_snapd_reader_get_value           (SnapdReader  *reader);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SERIALIZE_H__ */
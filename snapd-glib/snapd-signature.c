@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <gio/gio.h>
+
+#ifdef HAVE_NETTLE
+#include <nettle/bignum.h>
+#include <nettle/rsa.h>
+#include <nettle/sha2.h>
+#include <nettle/sha3.h>
+#endif
+
+#include "snapd-signature.h"
+
+/* Assertion keys and signatures are a format byte followed by an OpenPGP packet (RFC 4880), base64 encoded.
+ * snapd only uses v4 RSA keys and v4 SHA-512 signatures over the assertion content. */
+#define FORMAT_V1 0x01
+
+#define PACKET_TAG_SIGNATURE 2
+#define PACKET_TAG_PUBLIC_KEY 6
+
+#define PUBLIC_KEY_ALGORITHM_RSA 1
+#define HASH_ALGORITHM_SHA512 10
+
+#ifdef HAVE_NETTLE
+
+static guint32
+read_uint16 (const guint8 *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+static guint32
+read_uint32 (const guint8 *data)
+{
+    return ((guint32) data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+/* Get the body of the packet at the start of @data, or %NULL if it isn't a complete packet of type @tag */
+static const guint8 *
+read_packet (const guint8 *data, gsize length, guint tag, gsize *body_length)
+{
+    if (length < 2 || (data[0] & 0x80) == 0)
+        return NULL;
+
+    guint packet_tag;
+    gsize header_length, packet_length;
+    if ((data[0] & 0x40) != 0) {
+        packet_tag = data[0] & 0x3f;
+        if (data[1] < 192) {
+            header_length = 2;
+            packet_length = data[1];
+        }
+        else if (data[1] < 224) {
+            header_length = 3;
+            if (length < header_length)
+                return NULL;
+            packet_length = ((data[1] - 192) << 8) + data[2] + 192;
+        }
+        else if (data[1] == 255) {
+            header_length = 6;
+            if (length < header_length)
+                return NULL;
+            packet_length = read_uint32 (data + 2);
+        }
+        else
+            return NULL;
+    }
+    else {
+        packet_tag = (data[0] >> 2) & 0x0f;
+        switch (data[0] & 0x03) {
+        case 0:
+            header_length = 2;
+            packet_length = data[1];
+            break;
+        case 1:
+            header_length = 3;
+            if (length < header_length)
+                return NULL;
+            packet_length = read_uint16 (data + 1);
+            break;
+        case 2:
+            header_length = 5;
+            if (length < header_length)
+                return NULL;
+            packet_length = read_uint32 (data + 1);
+            break;
+        default:
+            return NULL;
+        }
+    }
+
+    if (packet_tag != tag || packet_length > length - header_length)
+        return NULL;
+
+    *body_length = packet_length;
+    return data + header_length;
+}
+
+/* Read a multiprecision integer, returning the offset after it or 0 if it doesn't fit */
+static gsize
+read_mpi (const guint8 *data, gsize length, gsize offset, const guint8 **value, gsize *value_length)
+{
+    if (offset + 2 > length)
+        return 0;
+    gsize n_bytes = (read_uint16 (data + offset) + 7) / 8;
+    if (n_bytes > length - offset - 2)
+        return 0;
+
+    *value = data + offset + 2;
+    *value_length = n_bytes;
+    return offset + 2 + n_bytes;
+}
+
+/* Decode the base64 text of a key or signature and return the packet inside it */
+static guint8 *
+decode_packet (const gchar *text, guint tag, gsize *length, const guint8 **body, gsize *body_length)
+{
+    g_autofree guint8 *data = g_base64_decode (text, length);
+    if (*length < 1 || data[0] != FORMAT_V1)
+        return NULL;
+
+    *body = read_packet (data + 1, *length - 1, tag, body_length);
+    if (*body == NULL)
+        return NULL;
+
+    return g_steal_pointer (&data);
+}
+
+/* Keys are identified by the unpadded base64url encoding of the SHA3-384 digest of the encoded key */
+static gboolean
+check_key_id (const guint8 *data, gsize length, const gchar *key_id)
+{
+    struct sha3_384_ctx sha3;
+    guint8 digest[SHA3_384_DIGEST_SIZE];
+    sha3_384_init (&sha3);
+    sha3_384_update (&sha3, length, data);
+    sha3_384_digest (&sha3, sizeof (digest), digest);
+
+    g_autofree gchar *id = g_base64_encode (digest, sizeof (digest));
+    for (gchar *c = id; *c != '\0'; c++) {
+        if (*c == '+')
+            *c = '-';
+        else if (*c == '/')
+            *c = '_';
+        else if (*c == '=')
+            *c = '\0';
+    }
+
+    return g_strcmp0 (id, key_id) == 0;
+}
+
+static gboolean
+read_public_key (const gchar *text, const gchar *key_id, struct rsa_public_key *key, GError **error)
+{
+    gsize length;
+    const guint8 *packet;
+    gsize packet_length;
+    g_autofree guint8 *data = decode_packet (text, PACKET_TAG_PUBLIC_KEY, &length, &packet, &packet_length);
+    if (data == NULL) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid public key");
+        return FALSE;
+    }
+
+    if (!check_key_id (data, length, key_id)) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Public key does not match key ID %s", key_id);
+        return FALSE;
+    }
+
+    /* Version, creation time, algorithm, RSA modulus and exponent */
+    const guint8 *n, *e;
+    gsize n_length, e_length;
+    gsize offset = 6;
+    if (packet_length < offset || packet[0] != 4 || packet[5] != PUBLIC_KEY_ALGORITHM_RSA ||
+        (offset = read_mpi (packet, packet_length, offset, &n, &n_length)) == 0 ||
+        read_mpi (packet, packet_length, offset, &e, &e_length) == 0) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Unsupported public key");
+        return FALSE;
+    }
+
+    nettle_mpz_set_str_256_u (key->n, n_length, n);
+    nettle_mpz_set_str_256_u (key->e, e_length, e);
+    if (!rsa_public_key_prepare (key)) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid RSA public key");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+gboolean
+_snapd_signature_verify (const gchar *content, gsize content_length, const gchar *signature, const gchar *public_key, const gchar *public_key_id, GError **error)
+{
+    struct rsa_public_key key;
+    rsa_public_key_init (&key);
+    if (!read_public_key (public_key, public_key_id, &key, error)) {
+        rsa_public_key_clear (&key);
+        return FALSE;
+    }
+
+    gsize length;
+    const guint8 *packet;
+    gsize packet_length;
+    g_autofree guint8 *data = decode_packet (signature, PACKET_TAG_SIGNATURE, &length, &packet, &packet_length);
+    if (data == NULL) {
+        rsa_public_key_clear (&key);
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid signature");
+        return FALSE;
+    }
+
+    /* Version, type, public key algorithm, hash algorithm, hashed and unhashed subpackets,
+     * the first two bytes of the digest and the RSA signature */
+    gsize hashed_length = 0, offset = 0;
+    const guint8 *s = NULL;
+    gsize s_length = 0;
+    if (packet_length >= 6) {
+        hashed_length = 6 + read_uint16 (packet + 4);
+        if (hashed_length + 2 <= packet_length)
+            offset = hashed_length + 2 + read_uint16 (packet + hashed_length);
+    }
+    if (packet_length < 6 || packet[0] != 4 || packet[2] != PUBLIC_KEY_ALGORITHM_RSA || packet[3] != HASH_ALGORITHM_SHA512 ||
+        offset == 0 || offset + 2 > packet_length ||
+        read_mpi (packet, packet_length, offset + 2, &s, &s_length) == 0) {
+        rsa_public_key_clear (&key);
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Unsupported signature");
+        return FALSE;
+    }
+
+    /* The signed data is the content followed by the hashed part of the signature packet and a trailer */
+    struct sha512_ctx sha512;
+    guint8 digest[SHA512_DIGEST_SIZE];
+    guint8 trailer[6] = { 4, 0xff, (hashed_length >> 24) & 0xff, (hashed_length >> 16) & 0xff, (hashed_length >> 8) & 0xff, hashed_length & 0xff };
+    sha512_init (&sha512);
+    sha512_update (&sha512, content_length, (const guint8 *) content);
+    sha512_update (&sha512, hashed_length, packet);
+    sha512_update (&sha512, sizeof (trailer), trailer);
+    sha512_digest (&sha512, sizeof (digest), digest);
+
+    mpz_t signature_value;
+    nettle_mpz_init_set_str_256_u (signature_value, s_length, s);
+    gboolean valid = digest[0] == packet[offset] && digest[1] == packet[offset + 1] &&
+                     rsa_sha512_verify_digest (&key, digest, signature_value);
+    mpz_clear (signature_value);
+    rsa_public_key_clear (&key);
+
+    if (!valid) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Signature does not match content");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+#else
+
+gboolean
+_snapd_signature_verify (const gchar *content, gsize content_length, const gchar *signature, const gchar *public_key, const gchar *public_key_id, GError **error)
+{
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "snapd-glib was built without signature verification");
+    return FALSE;
+}
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SIGNATURE_H__
+#define __SNAPD_SIGNATURE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gboolean _snapd_signature_verify (const gchar  *content,
+                                  gsize         content_length,
+                                  const gchar  *signature,
+                                  const gchar  *public_key,
+                                  const gchar  *public_key_id,
+                                  GError      **error);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SIGNATURE_H__ */
@@ -9,7 +9,8 @@
 
 #include <string.h>
 
-#include "snapd-slot.h"
+#include "snapd-slot-private.h"
+#include "snapd-attributes.h"
 #include "snapd-connection.h"
 #include "snapd-plug-ref.h"
 
@@ -39,8 +40,8 @@ struct _SnapdSlot
 
     gchar *name;
     gchar *snap;
-    gchar *interface;
-    GHashTable *attributes;
+    const gchar *interface; /* Interned */
+    SnapdAttributes attributes;
     gchar *label;
     GPtrArray *connections;
     GPtrArray *legacy_connections;
@@ -125,21 +126,7 @@ GStrv
 snapd_slot_get_attribute_names (SnapdSlot *self, guint *length)
 {
     g_return_val_if_fail (SNAPD_IS_SLOT (self), NULL);
-
-    guint size = g_hash_table_size (self->attributes);
-    GStrv names = g_malloc (sizeof (gchar *) * (size + 1));
-
-    GHashTableIter iter;
-    g_hash_table_iter_init (&iter, self->attributes);
-    guint i;
-    gpointer name;
-    for (i = 0; g_hash_table_iter_next (&iter, &name, NULL); i++)
-        names[i] = g_strdup (name);
-    names[i] = NULL;
-
-    if (length != NULL)
-        *length = size;
-    return names;
+    return _snapd_attributes_get_names (&self->attributes, length);
 }
 
 /**
@@ -157,7 +144,7 @@ gboolean
 snapd_slot_has_attribute (SnapdSlot *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_SLOT (self), FALSE);
-    return g_hash_table_contains (self->attributes, name);
+    return _snapd_attributes_contains (&self->attributes, name);
 }
 
 /**
@@ -175,7 +162,15 @@ GVariant *
 snapd_slot_get_attribute (SnapdSlot *self, const gchar *name)
 {
     g_return_val_if_fail (SNAPD_IS_SLOT (self), NULL);
-    return g_hash_table_lookup (self->attributes, name);
+    return _snapd_attributes_lookup (&self->attributes, name);
+}
+
+/* Keep the attributes from snapd, they are converted when requested */
+void
+_snapd_slot_set_attributes_object (SnapdSlot *self, JsonObject *object)
+{
+    g_return_if_fail (SNAPD_IS_SLOT (self));
+    _snapd_attributes_set_object (&self->attributes, object);
 }
 
 /**
@@ -260,8 +255,7 @@ snapd_slot_set_property (GObject *object, guint prop_id, const GValue *value, GP
         self->snap = g_strdup (g_value_get_string (value));
         break;
     case PROP_INTERFACE:
-        g_free (self->interface);
-        self->interface = g_strdup (g_value_get_string (value));
+        self->interface = g_intern_string (g_value_get_string (value));
         break;
     case PROP_LABEL:
         g_free (self->label);
@@ -273,9 +267,7 @@ snapd_slot_set_property (GObject *object, guint prop_id, const GValue *value, GP
             self->connections = g_ptr_array_ref (g_value_get_boxed (value));
         break;
     case PROP_ATTRIBUTES:
-        g_clear_pointer (&self->attributes, g_hash_table_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->attributes = g_hash_table_ref (g_value_get_boxed (value));
+        _snapd_attributes_set_table (&self->attributes, g_value_get_boxed (value));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -305,7 +297,7 @@ snapd_slot_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_boxed (value, self->connections);
         break;
     case PROP_ATTRIBUTES:
-        g_value_set_boxed (value, self->attributes);
+        g_value_set_boxed (value, _snapd_attributes_get_table (&self->attributes));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -320,8 +312,7 @@ snapd_slot_finalize (GObject *object)
 
     g_clear_pointer (&self->name, g_free);
     g_clear_pointer (&self->snap, g_free);
-    g_clear_pointer (&self->interface, g_free);
-    g_clear_pointer (&self->attributes, g_hash_table_unref);
+    _snapd_attributes_clear (&self->attributes);
     g_clear_pointer (&self->label, g_free);
     g_clear_pointer (&self->connections, g_ptr_array_unref);
     g_clear_pointer (&self->legacy_connections, g_ptr_array_unref);
@@ -385,5 +376,5 @@ snapd_slot_class_init (SnapdSlotClass *klass)
 static void
 snapd_slot_init (SnapdSlot *self)
 {
-    self->attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    _snapd_attributes_init (&self->attributes);
 }
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-snap-config-private.h"
+
+/**
+ * SECTION: snapd-snap-config
+ * @short_description: Snap configuration
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdSnapConfig contains configuration values for a snap, as returned by
+ * snapd_client_get_snap_config_sync(). Values are read by their dotted key,
+ * e.g. "network.proxy.port", and only the values that are read are converted
+ * from the response.
+ */
+
+/**
+ * SnapdSnapConfig:
+ *
+ * #SnapdSnapConfig contains configuration values for a snap.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdSnapConfig
+{
+    GObject parent_instance;
+
+    JsonObject *object;
+};
+
+G_DEFINE_TYPE (SnapdSnapConfig, snapd_snap_config, G_TYPE_OBJECT)
+
+SnapdSnapConfig *
+_snapd_snap_config_new (JsonObject *object)
+{
+    SnapdSnapConfig *self = g_object_new (SNAPD_TYPE_SNAP_CONFIG, NULL);
+    self->object = json_object_ref (object);
+    return self;
+}
+
+JsonObject *
+_snapd_snap_config_get_object (SnapdSnapConfig *self)
+{
+    return self->object;
+}
+
+/* Find the value for a dotted key. snapd returns the requested keys as
+ * members, e.g. "a.b", and the whole configuration as nested objects */
+static JsonNode *
+lookup_node (JsonObject *object, const gchar *key)
+{
+    JsonNode *node = json_object_get_member (object, key);
+    if (node != NULL)
+        return node;
+
+    for (const gchar *c = strchr (key, '.'); c != NULL; c = strchr (c + 1, '.')) {
+        g_autofree gchar *prefix = g_strndup (key, c - key);
+        JsonNode *child = json_object_get_member (object, prefix);
+        if (child == NULL || !JSON_NODE_HOLDS_OBJECT (child))
+            continue;
+
+        node = lookup_node (json_node_get_object (child), c + 1);
+        if (node != NULL)
+            return node;
+    }
+
+    return NULL;
+}
+
+/**
+ * snapd_snap_config_get_keys:
+ * @config: a #SnapdSnapConfig.
+ *
+ * Get the top level keys in this configuration.
+ *
+ * Returns: (transfer full): a %NULL-terminated array of keys.
+ *
+ * Since: 1.65
+ */
+GStrv
+snapd_snap_config_get_keys (SnapdSnapConfig *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), NULL);
+
+    g_autoptr(GList) members = json_object_get_members (self->object);
+    GStrv keys = g_new (gchar *, g_list_length (members) + 1);
+    guint i = 0;
+    for (GList *link = members; link != NULL; link = link->next)
+        keys[i++] = g_strdup (link->data);
+    keys[i] = NULL;
+
+    return keys;
+}
+
+/**
+ * snapd_snap_config_has_key:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ *
+ * Check if this configuration has a value for a key.
+ *
+ * Returns: %TRUE if a value exists.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_snap_config_has_key (SnapdSnapConfig *self, const gchar *key)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), FALSE);
+    g_return_val_if_fail (key != NULL, FALSE);
+
+    return lookup_node (self->object, key) != NULL;
+}
+
+/**
+ * snapd_snap_config_get_value:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ *
+ * Get a configuration value. If the value is an object it is returned as a
+ * dictionary containing all the values below @key.
+ *
+ * Returns: (transfer full) (allow-none): a #GVariant or %NULL if not set.
+ *
+ * Since: 1.65
+ */
+GVariant *
+snapd_snap_config_get_value (SnapdSnapConfig *self, const gchar *key)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), NULL);
+    g_return_val_if_fail (key != NULL, NULL);
+
+    JsonNode *node = lookup_node (self->object, key);
+    if (node == NULL)
+        return NULL;
+
+    GVariant *value = json_gvariant_deserialize (node, NULL, NULL);
+    return value != NULL ? g_variant_ref_sink (value) : NULL;
+}
+
+static JsonNode *
+lookup_value (SnapdSnapConfig *self, const gchar *key, GType value_type)
+{
+    JsonNode *node = lookup_node (self->object, key);
+    if (node == NULL || !JSON_NODE_HOLDS_VALUE (node) || json_node_get_value_type (node) != value_type)
+        return NULL;
+    return node;
+}
+
+/**
+ * snapd_snap_config_get_string:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ * @default_value: (allow-none): value to return if not set.
+ *
+ * Get a string configuration value.
+ *
+ * Returns: (allow-none): the value, or @default_value if not set or not a string.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_snap_config_get_string (SnapdSnapConfig *self, const gchar *key, const gchar *default_value)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), default_value);
+    g_return_val_if_fail (key != NULL, default_value);
+
+    JsonNode *node = lookup_value (self, key, G_TYPE_STRING);
+    return node != NULL ? json_node_get_string (node) : default_value;
+}
+
+/**
+ * snapd_snap_config_get_int:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ * @default_value: value to return if not set.
+ *
+ * Get an integer configuration value.
+ *
+ * Returns: the value, or @default_value if not set or not an integer.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_snap_config_get_int (SnapdSnapConfig *self, const gchar *key, gint64 default_value)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), default_value);
+    g_return_val_if_fail (key != NULL, default_value);
+
+    JsonNode *node = lookup_value (self, key, G_TYPE_INT64);
+    return node != NULL ? json_node_get_int (node) : default_value;
+}
+
+/**
+ * snapd_snap_config_get_boolean:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ * @default_value: value to return if not set.
+ *
+ * Get a boolean configuration value.
+ *
+ * Returns: the value, or @default_value if not set or not a boolean.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_snap_config_get_boolean (SnapdSnapConfig *self, const gchar *key, gboolean default_value)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), default_value);
+    g_return_val_if_fail (key != NULL, default_value);
+
+    JsonNode *node = lookup_value (self, key, G_TYPE_BOOLEAN);
+    return node != NULL ? json_node_get_boolean (node) : default_value;
+}
+
+/**
+ * snapd_snap_config_get_double:
+ * @config: a #SnapdSnapConfig.
+ * @key: a dotted configuration key.
+ * @default_value: value to return if not set.
+ *
+ * Get a numeric configuration value. Integer values are converted.
+ *
+ * Returns: the value, or @default_value if not set or not a number.
+ *
+ * Since: 1.65
+ */
+gdouble
+snapd_snap_config_get_double (SnapdSnapConfig *self, const gchar *key, gdouble default_value)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), default_value);
+    g_return_val_if_fail (key != NULL, default_value);
+
+    JsonNode *node = lookup_value (self, key, G_TYPE_DOUBLE);
+    if (node != NULL)
+        return json_node_get_double (node);
+    node = lookup_value (self, key, G_TYPE_INT64);
+    if (node != NULL)
+        return json_node_get_int (node);
+    return default_value;
+}
+
+/* Compare using the same JSON form the value would be sent to snapd in */
+static gboolean
+value_matches (JsonNode *node, GVariant *value)
+{
+    g_autoptr(JsonNode) new_node = json_gvariant_serialize (value);
+
+    g_autoptr(JsonGenerator) generator = json_generator_new ();
+    json_generator_set_root (generator, node);
+    g_autofree gchar *old_data = json_generator_to_data (generator, NULL);
+    json_generator_set_root (generator, new_node);
+    g_autofree gchar *new_data = json_generator_to_data (generator, NULL);
+
+    return strcmp (old_data, new_data) == 0;
+}
+
+/**
+ * snapd_snap_config_get_changes:
+ * @config: a #SnapdSnapConfig.
+ * @key_values: (element-type utf8 GVariant): configuration values to set.
+ *
+ * Get the values in @key_values that are different to those in this
+ * configuration, so only changed values need to be sent with
+ * snapd_client_set_snap_conf_sync().
+ *
+ * Returns: (transfer container) (element-type utf8 GVariant): a table of changed values, which may be empty.
+ *
+ * Since: 1.65
+ */
+GHashTable *
+snapd_snap_config_get_changes (SnapdSnapConfig *self, GHashTable *key_values)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_CONFIG (self), NULL);
+    g_return_val_if_fail (key_values != NULL, NULL);
+
+    GHashTable *changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, key_values);
+    gpointer key, value;
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        JsonNode *node = lookup_node (self->object, key);
+        if (node == NULL || !value_matches (node, value))
+            g_hash_table_insert (changes, g_strdup (key), g_variant_ref (value));
+    }
+
+    return changes;
+}
+
+static void
+snapd_snap_config_finalize (GObject *object)
+{
+    SnapdSnapConfig *self = SNAPD_SNAP_CONFIG (object);
+
+    g_clear_pointer (&self->object, json_object_unref);
+
+    G_OBJECT_CLASS (snapd_snap_config_parent_class)->finalize (object);
+}
+
+static void
+snapd_snap_config_class_init (SnapdSnapConfigClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_snap_config_finalize;
+}
+
+static void
+snapd_snap_config_init (SnapdSnapConfig *self)
+{
+}
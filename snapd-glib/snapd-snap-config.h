@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SNAP_CONFIG_H__
+#define __SNAPD_SNAP_CONFIG_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_SNAP_CONFIG  (snapd_snap_config_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdSnapConfig, snapd_snap_config, SNAPD, SNAP_CONFIG, GObject)
+
+GStrv        snapd_snap_config_get_keys    (SnapdSnapConfig *config);
+
+gboolean     snapd_snap_config_has_key     (SnapdSnapConfig *config,
+                                            const gchar     *key);
+
+GVariant    *snapd_snap_config_get_value   (SnapdSnapConfig *config,
+                                            const gchar     *key);
+
+const gchar *snapd_snap_config_get_string  (SnapdSnapConfig *config,
+                                            const gchar     *key,
+                                            const gchar     *default_value);
+
+gint64       snapd_snap_config_get_int     (SnapdSnapConfig *config,
+                                            const gchar     *key,
+                                            gint64           default_value);
+
+gboolean     snapd_snap_config_get_boolean (SnapdSnapConfig *config,
+                                            const gchar     *key,
+                                            gboolean         default_value);
+
+gdouble      snapd_snap_config_get_double  (SnapdSnapConfig *config,
+                                            const gchar     *key,
+                                            gdouble          default_value);
+
+GHashTable  *snapd_snap_config_get_changes (SnapdSnapConfig *config,
+                                            GHashTable      *key_values);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SNAP_CONFIG_H__ */
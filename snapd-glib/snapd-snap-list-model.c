@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-snap-list-model.h"
+#include "snapd-result-list-private.h"
+
+/**
+ * SECTION: snapd-snap-list-model
+ * @short_description: Installed snaps as a list model
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdSnapListModel presents the snaps in a #SnapdSnapList as a
+ * #GListModel, for use with list widgets such as GTK's list views. When the
+ * #SnapdSnapList is refreshed #GListModel::items-changed is only emitted for
+ * the snaps that were added, removed or changed, so widgets only update the
+ * rows that are affected.
+ */
+
+/**
+ * SnapdSnapListModel:
+ *
+ * #SnapdSnapListModel is a list model of installed snaps.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdSnapListModel
+{
+    GObject parent_instance;
+
+    SnapdSnapList *list;
+
+    /* Snaps as last reported to users of the model */
+    GPtrArray *snaps;
+};
+
+static void snapd_snap_list_model_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SnapdSnapListModel, snapd_snap_list_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, snapd_snap_list_model_list_model_init))
+
+/* Bring the model up to date with the list. This is done on the first signal from a
+ * refresh, after which the list has all its changes and later signals do nothing */
+static void
+list_changed_cb (SnapdSnapListModel *self)
+{
+    _snapd_list_model_update (G_LIST_MODEL (self), self->snaps, snapd_snap_list_get_snaps (self->list));
+}
+
+/**
+ * snapd_snap_list_model_new:
+ * @list: a #SnapdSnapList.
+ *
+ * Create a list model of the snaps in @list. The model contains the snaps
+ * already in @list and is updated each time @list is refreshed.
+ *
+ * Returns: a new #SnapdSnapListModel
+ *
+ * Since: 1.65
+ */
+SnapdSnapListModel *
+snapd_snap_list_model_new (SnapdSnapList *list)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST (list), NULL);
+
+    SnapdSnapListModel *self = g_object_new (SNAPD_TYPE_SNAP_LIST_MODEL, NULL);
+    self->list = g_object_ref (list);
+    GPtrArray *snaps = snapd_snap_list_get_snaps (list);
+    for (guint i = 0; i < snaps->len; i++)
+        g_ptr_array_add (self->snaps, g_object_ref (g_ptr_array_index (snaps, i)));
+    g_signal_connect_object (list, "snap-added", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object (list, "snap-removed", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+    g_signal_connect_object (list, "snap-changed", G_CALLBACK (list_changed_cb), self, G_CONNECT_SWAPPED);
+
+    return self;
+}
+
+/**
+ * snapd_snap_list_model_get_list:
+ * @model: a #SnapdSnapListModel.
+ *
+ * Get the list this model presents.
+ *
+ * Returns: (transfer none): a #SnapdSnapList
+ *
+ * Since: 1.65
+ */
+SnapdSnapList *
+snapd_snap_list_model_get_list (SnapdSnapListModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST_MODEL (self), NULL);
+    return self->list;
+}
+
+static GType
+snapd_snap_list_model_get_item_type (GListModel *model)
+{
+    return SNAPD_TYPE_SNAP;
+}
+
+static guint
+snapd_snap_list_model_get_n_items (GListModel *model)
+{
+    return SNAPD_SNAP_LIST_MODEL (model)->snaps->len;
+}
+
+static gpointer
+snapd_snap_list_model_get_item (GListModel *model, guint position)
+{
+    SnapdSnapListModel *self = SNAPD_SNAP_LIST_MODEL (model);
+
+    if (position >= self->snaps->len)
+        return NULL;
+    return g_object_ref (g_ptr_array_index (self->snaps, position));
+}
+
+static void
+snapd_snap_list_model_list_model_init (GListModelInterface *iface)
+{
+    iface->get_item_type = snapd_snap_list_model_get_item_type;
+    iface->get_n_items = snapd_snap_list_model_get_n_items;
+    iface->get_item = snapd_snap_list_model_get_item;
+}
+
+static void
+snapd_snap_list_model_finalize (GObject *object)
+{
+    SnapdSnapListModel *self = SNAPD_SNAP_LIST_MODEL (object);
+
+    g_clear_object (&self->list);
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_snap_list_model_parent_class)->finalize (object);
+}
+
+static void
+snapd_snap_list_model_class_init (SnapdSnapListModelClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_snap_list_model_finalize;
+}
+
+static void
+snapd_snap_list_model_init (SnapdSnapListModel *self)
+{
+    self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+}
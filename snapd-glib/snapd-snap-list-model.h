@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SNAP_LIST_MODEL_H__
+#define __SNAPD_SNAP_LIST_MODEL_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-snap-list.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_SNAP_LIST_MODEL  (snapd_snap_list_model_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdSnapListModel, snapd_snap_list_model, SNAPD, SNAP_LIST_MODEL, GObject)
+
+SnapdSnapListModel *snapd_snap_list_model_new      (SnapdSnapList      *list);
+
+SnapdSnapList      *snapd_snap_list_model_get_list (SnapdSnapListModel *model);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SNAP_LIST_MODEL_H__ */
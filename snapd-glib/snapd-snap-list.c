@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-snap-list.h"
+
+/**
+ * SECTION: snapd-snap-list
+ * @short_description: Installed snaps kept up to date
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdSnapList holds the snaps installed on the system. Each time
+ * snapd_snap_list_refresh_async() is called the snaps are fetched again and
+ * compared to the previous result, emitting #SnapdSnapList::snap-added,
+ * #SnapdSnapList::snap-removed and #SnapdSnapList::snap-changed for the
+ * differences. Snaps with the same name, revision and status are considered
+ * unchanged and the existing #SnapdSnap objects are kept, so user interfaces
+ * only need to update the entries that changed. Refreshes can be driven by
+ * polling or from a #SnapdNoticesMonitor.
+ */
+
+/**
+ * SnapdSnapList:
+ *
+ * #SnapdSnapList holds the installed snaps.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdSnapList
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* Snaps from the last refresh, in the order snapd returned them and indexed by name */
+    GPtrArray *snaps;
+    GHashTable *snaps_by_name;
+};
+
+enum
+{
+    SIGNAL_SNAP_ADDED,
+    SIGNAL_SNAP_REMOVED,
+    SIGNAL_SNAP_CHANGED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST] = { 0 };
+
+G_DEFINE_TYPE (SnapdSnapList, snapd_snap_list, G_TYPE_OBJECT)
+
+static gboolean
+snap_changed (SnapdSnap *old_snap, SnapdSnap *new_snap)
+{
+    return g_strcmp0 (snapd_snap_get_revision (old_snap), snapd_snap_get_revision (new_snap)) != 0 ||
+           snapd_snap_get_status (old_snap) != snapd_snap_get_status (new_snap);
+}
+
+static void
+get_snaps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    SnapdSnapList *self = g_task_get_source_object (task);
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) new_snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    if (new_snaps == NULL) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+
+    g_autoptr(GPtrArray) snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GHashTable) snaps_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+    g_autoptr(GPtrArray) added = g_ptr_array_new ();
+    g_autoptr(GPtrArray) changed = g_ptr_array_new ();
+    for (guint i = 0; i < new_snaps->len; i++) {
+        SnapdSnap *snap = g_ptr_array_index (new_snaps, i);
+        const gchar *name = snapd_snap_get_name (snap);
+
+        SnapdSnap *old_snap = g_hash_table_lookup (self->snaps_by_name, name);
+        if (old_snap == NULL)
+            g_ptr_array_add (added, snap);
+        else if (snap_changed (old_snap, snap))
+            g_ptr_array_add (changed, snap);
+        else
+            snap = old_snap;
+
+        g_ptr_array_add (snaps, g_object_ref (snap));
+        g_hash_table_insert (snaps_by_name, (gpointer) snapd_snap_get_name (snap), snap);
+    }
+
+    /* Swap in the new list before emitting so handlers see the current state */
+    g_autoptr(GPtrArray) old_snaps = g_steal_pointer (&self->snaps);
+    g_autoptr(GHashTable) old_snaps_by_name = g_steal_pointer (&self->snaps_by_name);
+    self->snaps = g_steal_pointer (&snaps);
+    self->snaps_by_name = g_steal_pointer (&snaps_by_name);
+
+    for (guint i = 0; i < old_snaps->len; i++) {
+        SnapdSnap *snap = g_ptr_array_index (old_snaps, i);
+        if (!g_hash_table_contains (self->snaps_by_name, snapd_snap_get_name (snap)))
+            g_signal_emit (self, signals[SIGNAL_SNAP_REMOVED], 0, snap);
+    }
+    for (guint i = 0; i < added->len; i++)
+        g_signal_emit (self, signals[SIGNAL_SNAP_ADDED], 0, g_ptr_array_index (added, i));
+    for (guint i = 0; i < changed->len; i++)
+        g_signal_emit (self, signals[SIGNAL_SNAP_CHANGED], 0, g_ptr_array_index (changed, i));
+
+    g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * snapd_snap_list_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create an object to hold the installed snaps. The list is empty until
+ * snapd_snap_list_refresh_async() is called.
+ *
+ * Returns: a new #SnapdSnapList
+ *
+ * Since: 1.65
+ */
+SnapdSnapList *
+snapd_snap_list_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdSnapList *self = g_object_new (SNAPD_TYPE_SNAP_LIST, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+/**
+ * snapd_snap_list_refresh_async:
+ * @list: a #SnapdSnapList.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously get the installed snaps and update the list. Signals are
+ * emitted for each difference before @callback is called.
+ *
+ * Since: 1.65
+ */
+void
+snapd_snap_list_refresh_async (SnapdSnapList *self, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_SNAP_LIST (self));
+
+    GTask *task = g_task_new (self, cancellable, callback, user_data);
+    snapd_client_get_snaps_async (self->client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, cancellable, get_snaps_cb, task);
+}
+
+/**
+ * snapd_snap_list_refresh_finish:
+ * @list: a #SnapdSnapList.
+ * @result: a #GAsyncResult.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_snap_list_refresh_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_snap_list_refresh_finish (SnapdSnapList *self, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * snapd_snap_list_get_snaps:
+ * @list: a #SnapdSnapList.
+ *
+ * Get the snaps from the last refresh.
+ *
+ * Returns: (transfer none) (element-type SnapdSnap): an array of #SnapdSnap.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_snap_list_get_snaps (SnapdSnapList *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST (self), NULL);
+    return self->snaps;
+}
+
+/**
+ * snapd_snap_list_get_snap:
+ * @list: a #SnapdSnapList.
+ * @name: name of snap to get.
+ *
+ * Get a snap from the last refresh.
+ *
+ * Returns: (transfer none) (allow-none): a #SnapdSnap or %NULL if not installed.
+ *
+ * Since: 1.65
+ */
+SnapdSnap *
+snapd_snap_list_get_snap (SnapdSnapList *self, const gchar *name)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP_LIST (self), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+    return g_hash_table_lookup (self->snaps_by_name, name);
+}
+
+static void
+snapd_snap_list_finalize (GObject *object)
+{
+    SnapdSnapList *self = SNAPD_SNAP_LIST (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->snaps_by_name, g_hash_table_unref);
+    g_clear_pointer (&self->snaps, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (snapd_snap_list_parent_class)->finalize (object);
+}
+
+static void
+snapd_snap_list_class_init (SnapdSnapListClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_snap_list_finalize;
+
+    /**
+     * SnapdSnapList::snap-added:
+     * @list: a #SnapdSnapList.
+     * @snap: the #SnapdSnap that was installed.
+     *
+     * Emitted when a refresh finds a snap that was not previously in the list.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_SNAP_ADDED] = g_signal_new ("snap-added",
+                                               G_TYPE_FROM_CLASS (klass),
+                                               G_SIGNAL_RUN_LAST,
+                                               0,
+                                               NULL, NULL,
+                                               NULL,
+                                               G_TYPE_NONE, 1, SNAPD_TYPE_SNAP);
+
+    /**
+     * SnapdSnapList::snap-removed:
+     * @list: a #SnapdSnapList.
+     * @snap: the #SnapdSnap that was removed.
+     *
+     * Emitted when a snap in the list is no longer installed.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_SNAP_REMOVED] = g_signal_new ("snap-removed",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0,
+                                                 NULL, NULL,
+                                                 NULL,
+                                                 G_TYPE_NONE, 1, SNAPD_TYPE_SNAP);
+
+    /**
+     * SnapdSnapList::snap-changed:
+     * @list: a #SnapdSnapList.
+     * @snap: the new #SnapdSnap.
+     *
+     * Emitted when the revision or status of a snap in the list changes. The
+     * previous #SnapdSnap object is replaced by @snap.
+     *
+     * Since: 1.65
+     */
+    signals[SIGNAL_SNAP_CHANGED] = g_signal_new ("snap-changed",
+                                                 G_TYPE_FROM_CLASS (klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0,
+                                                 NULL, NULL,
+                                                 NULL,
+                                                 G_TYPE_NONE, 1, SNAPD_TYPE_SNAP);
+}
+
+static void
+snapd_snap_list_init (SnapdSnapList *self)
+{
+    self->snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    self->snaps_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+}
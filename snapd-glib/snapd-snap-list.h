@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SNAP_LIST_H__
+#define __SNAPD_SNAP_LIST_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-client.h>
+#include <snapd-glib/snapd-snap.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_SNAP_LIST  (snapd_snap_list_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdSnapList, snapd_snap_list, SNAPD, SNAP_LIST, GObject)
+
+SnapdSnapList *snapd_snap_list_new            (SnapdClient         *client);
+
+void           snapd_snap_list_refresh_async  (SnapdSnapList       *list,
+                                               GCancellable        *cancellable,
+                                               GAsyncReadyCallback  callback,
+                                               gpointer             user_data);
+gboolean       snapd_snap_list_refresh_finish (SnapdSnapList       *list,
+                                               GAsyncResult        *result,
+                                               GError             **error);
+
+GPtrArray     *snapd_snap_list_get_snaps      (SnapdSnapList       *list);
+
+SnapdSnap     *snapd_snap_list_get_snap       (SnapdSnapList       *list,
+                                               const gchar         *name);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SNAP_LIST_H__ */
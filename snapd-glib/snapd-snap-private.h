@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SNAP_PRIVATE_H__
+#define __SNAPD_SNAP_PRIVATE_H__
+
+#include "snapd-snap.h"
+#include "snapd-arena.h"
+#include "snapd-timestamp.h"
+
+G_BEGIN_DECLS
+
+typedef SnapdSnap *(*SnapdSnapLoadFunc) (gpointer data);
+
+/* Defined here so the parser can fill in snaps without going through properties */
+struct _SnapdSnap
+{
+    GObject parent_instance;
+
+    /* Strings that are const are interned, as the same values repeat across many snaps */
+    GPtrArray *apps;
+    const gchar *base;
+    gchar *broken;
+    const gchar *channel;
+    GPtrArray *channels;
+    GStrv common_ids;
+    gchar *contact;
+    gchar *description;
+    GPtrArray *description_nodes;
+    gint64 download_size;
+    gchar *icon;
+    gchar *id;
+    SnapdTimestamp install_date;
+    gint64 installed_size;
+    gchar *license;
+    GPtrArray *media;
+    gchar *mounted_from;
+    gchar *name;
+    GPtrArray *prices;
+    const gchar *publisher_display_name;
+    const gchar *publisher_id;
+    const gchar *publisher_username;
+    gchar *revision;
+    GPtrArray *screenshots;
+    gchar *store_url;
+    gchar *summary;
+    gchar *title;
+    const gchar *tracking_channel;
+    GStrv tracks;
+    gchar *version;
+    gchar *website;
+
+    /* Holds the plain string fields when set by the parser, otherwise they are allocated separately */
+    SnapdArena *arena;
+
+    /* Packed, as large catalogs can hold thousands of snaps */
+    guint confinement : 8;
+    guint publisher_validation : 8;
+    guint status : 8;
+    guint snap_type : 8;
+    guint devmode : 1;
+    guint jailmode : 1;
+    guint private : 1;
+    guint trymode : 1;
+
+    /* Channels by track and branch, built when first matched against */
+    GHashTable *channel_index;
+
+    /* Function to build the apps, channels, media etc, if they are loaded when first used */
+    SnapdSnapLoadFunc load_func;
+    gpointer load_data;
+    GDestroyNotify load_data_destroy;
+};
+
+void _snapd_snap_set_loader (SnapdSnap         *snap,
+                             SnapdSnapLoadFunc  load_func,
+                             gpointer           data,
+                             GDestroyNotify     data_destroy);
+
+void _snapd_snap_set_description_nodes (SnapdSnap *snap,
+                                        GPtrArray *nodes);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SNAP_PRIVATE_H__ */
@@ -8,7 +8,15 @@
  */
 
 #include "snapd-snap.h"
+#include "snapd-snap-private.h"
+#include "snapd-app-private.h"
+#include "snapd-channel-private.h"
 #include "snapd-enum-types.h"
+#include "snapd-media-private.h"
+#include "snapd-memory.h"
+#include "snapd-price-private.h"
+#include "snapd-screenshot.h"
+#include "snapd-serialize.h"
 
 /**
  * SECTION:snapd-snap
@@ -28,50 +36,6 @@
  * Since: 1.0
  */
 
-struct _SnapdSnap
-{
-    GObject parent_instance;
-
-    GPtrArray *apps;
-    gchar *base;
-    gchar *broken;
-    gchar *channel;
-    GPtrArray *channels;
-    GStrv common_ids;
-    SnapdConfinement confinement;
-    gchar *contact;
-    gchar *description;
-    gboolean devmode;
-    gint64 download_size;
-    gchar *icon;
-    gchar *id;
-    GDateTime *install_date;
-    gint64 installed_size;
-    gboolean jailmode;
-    gchar *license;
-    GPtrArray *media;
-    gchar *mounted_from;
-    gchar *name;
-    GPtrArray *prices;
-    gboolean private;
-    gchar *publisher_display_name;
-    gchar *publisher_id;
-    gchar *publisher_username;
-    SnapdPublisherValidation publisher_validation;
-    gchar *revision;
-    GPtrArray *screenshots;
-    SnapdSnapStatus status;
-    gchar *store_url;
-    gchar *summary;
-    gchar *title;
-    gchar *tracking_channel;
-    GStrv tracks;
-    gboolean trymode;
-    SnapdSnapType snap_type;
-    gchar *version;
-    gchar *website;
-};
-
 enum
 {
     PROP_APPS = 1,
@@ -118,6 +82,62 @@ enum
 
 G_DEFINE_TYPE (SnapdSnap, snapd_snap, G_TYPE_OBJECT)
 
+/* Snaps can be shared between threads, so loading is serialized */
+static GMutex load_mutex;
+
+void
+_snapd_snap_set_loader (SnapdSnap *self, SnapdSnapLoadFunc load_func, gpointer data, GDestroyNotify data_destroy)
+{
+    self->load_func = load_func;
+    self->load_data = data;
+    self->load_data_destroy = data_destroy;
+}
+
+static void
+clear_loader (SnapdSnap *self)
+{
+    if (self->load_data_destroy != NULL)
+        self->load_data_destroy (self->load_data);
+    self->load_data = NULL;
+    self->load_data_destroy = NULL;
+    g_atomic_pointer_set (&self->load_func, NULL);
+}
+
+static void
+load_details (SnapdSnap *self)
+{
+    if (g_atomic_pointer_get (&self->load_func) == NULL)
+        return;
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&load_mutex);
+    if (self->load_func == NULL)
+        return;
+
+    g_autoptr(SnapdSnap) snap = self->load_func (self->load_data);
+    if (snap != NULL) {
+        self->apps = g_steal_pointer (&snap->apps);
+        self->channels = g_steal_pointer (&snap->channels);
+        self->common_ids = g_steal_pointer (&snap->common_ids);
+        self->install_date = snap->install_date;
+        snap->install_date = (SnapdTimestamp) { 0 };
+        self->media = g_steal_pointer (&snap->media);
+        self->prices = g_steal_pointer (&snap->prices);
+        self->screenshots = g_steal_pointer (&snap->screenshots);
+        self->tracks = g_steal_pointer (&snap->tracks);
+    }
+    else {
+        self->apps = g_ptr_array_new_with_free_func (g_object_unref);
+        self->channels = g_ptr_array_new_with_free_func (g_object_unref);
+        self->common_ids = g_new0 (gchar *, 1);
+        self->media = g_ptr_array_new_with_free_func (g_object_unref);
+        self->prices = g_ptr_array_new_with_free_func (g_object_unref);
+        self->screenshots = g_ptr_array_new_with_free_func (g_object_unref);
+        self->tracks = g_new0 (gchar *, 1);
+    }
+
+    clear_loader (self);
+}
+
 /**
  * snapd_snap_get_apps:
  * @snap: a #SnapdSnap.
@@ -132,6 +152,7 @@ GPtrArray *
 snapd_snap_get_apps (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->apps;
 }
 
@@ -200,22 +221,70 @@ GPtrArray *
 snapd_snap_get_channels (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->channels;
 }
 
-static int
-parse_risk (const gchar *risk)
+/* Channels on one track and branch, with the first channel seen at each risk level */
+#define N_RISK_LEVELS 4
+typedef struct
+{
+    SnapdChannel *channels[N_RISK_LEVELS];
+    SnapdChannel *unknown_risk_channel;
+} ChannelIndexEntry;
+
+static void
+channel_index_entry_free (ChannelIndexEntry *entry)
+{
+    g_slice_free (ChannelIndexEntry, entry);
+}
+
+static gchar *
+make_channel_key (SnapdChannel *channel)
+{
+    const gchar *branch = snapd_channel_get_branch (channel);
+    return g_strconcat (snapd_channel_get_track (channel), "/", branch != NULL ? branch : "", NULL);
+}
+
+static GHashTable *
+get_channel_index (SnapdSnap *self)
 {
-    if (g_strcmp0 (risk, "stable") == 0)
-        return 0;
-    else if (g_strcmp0 (risk, "candidate") == 0)
-        return 1;
-    else if (g_strcmp0 (risk, "beta") == 0)
-        return 2;
-    else if (g_strcmp0 (risk, "edge") == 0)
-        return 3;
-    else
-        return -1;
+    GHashTable *index = g_atomic_pointer_get (&self->channel_index);
+    if (index != NULL)
+        return index;
+
+    load_details (self);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&load_mutex);
+    if (self->channel_index != NULL)
+        return self->channel_index;
+
+    /* Channels are not referenced, as the snap holds them for as long as the index exists */
+    index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) channel_index_entry_free);
+    for (guint i = 0; self->channels != NULL && i < self->channels->len; i++) {
+        SnapdChannel *channel = self->channels->pdata[i];
+
+        if (snapd_channel_get_track (channel) == NULL)
+            continue;
+
+        g_autofree gchar *key = make_channel_key (channel);
+        ChannelIndexEntry *entry = g_hash_table_lookup (index, key);
+        if (entry == NULL) {
+            entry = g_slice_new0 (ChannelIndexEntry);
+            g_hash_table_insert (index, g_steal_pointer (&key), entry);
+        }
+
+        gint risk_level = _snapd_channel_get_risk_level (channel);
+        if (risk_level < 0) {
+            if (entry->unknown_risk_channel == NULL)
+                entry->unknown_risk_channel = channel;
+        }
+        else if (risk_level < N_RISK_LEVELS && entry->channels[risk_level] == NULL)
+            entry->channels[risk_level] = channel;
+    }
+    g_atomic_pointer_set (&self->channel_index, index);
+
+    return index;
 }
 
 /**
@@ -236,32 +305,61 @@ snapd_snap_match_channel (SnapdSnap *self, const gchar *name)
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    g_autoptr(SnapdChannel) c = g_object_new (SNAPD_TYPE_CHANNEL,
-                                              "name", name,
-                                              NULL);
-    SnapdChannel *matched_channel = NULL;
-    int matched_risk = -1;
-    for (guint i = 0; i < self->channels->len; i++) {
-        SnapdChannel *channel = self->channels->pdata[i];
+    g_autoptr(SnapdChannel) c = _snapd_channel_new (NULL, SNAPD_CONFINEMENT_UNKNOWN, NULL, name, NULL, NULL, 0, NULL);
+    if (snapd_channel_get_track (c) == NULL)
+        return NULL;
+
+    /* Must be same track and branch */
+    GHashTable *index = get_channel_index (self);
+    g_autofree gchar *key = make_channel_key (c);
+    ChannelIndexEntry *entry = g_hash_table_lookup (index, key);
+    if (entry == NULL)
+        return NULL;
+
+    /* Use the riskiest channel that is no riskier than requested */
+    for (gint r = _snapd_channel_get_risk_level (c); r >= 0; r--) {
+        if (r < N_RISK_LEVELS && entry->channels[r] != NULL)
+            return entry->channels[r];
+    }
 
-        /* Must be same track and branch */
-        if (g_strcmp0 (snapd_channel_get_track (channel), snapd_channel_get_track (c)) != 0 ||
-            g_strcmp0 (snapd_channel_get_branch (channel), snapd_channel_get_branch (c)) != 0)
-            continue;
+    return entry->unknown_risk_channel;
+}
+
+/**
+ * snapd_snap_get_track_channels:
+ * @snap: a #SnapdSnap.
+ *
+ * Get the most stable channel available on each of the tracks in
+ * snapd_snap_get_tracks(). Channels on branches are not included, and tracks
+ * that have no channels are skipped.
+ *
+ * Returns: (transfer container) (element-type SnapdChannel): an array of #SnapdChannel.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_snap_get_track_channels (SnapdSnap *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
 
-        /* Must be no riskier than requested */
-        int r = parse_risk (snapd_channel_get_risk (channel));
-        if (r > parse_risk (snapd_channel_get_risk (c)))
+    GHashTable *index = get_channel_index (self);
+    GPtrArray *channels = g_ptr_array_new_with_free_func (g_object_unref);
+    for (guint i = 0; self->tracks != NULL && self->tracks[i] != NULL; i++) {
+        g_autofree gchar *key = g_strconcat (self->tracks[i], "/", NULL);
+        ChannelIndexEntry *entry = g_hash_table_lookup (index, key);
+        if (entry == NULL)
             continue;
 
-        /* Use this if unmatched or a better risk match */
-        if (matched_channel == NULL || r > matched_risk) {
-            matched_channel = channel;
-            matched_risk = r;
-        }
+        SnapdChannel *channel = NULL;
+        for (gint r = 0; r < N_RISK_LEVELS && channel == NULL; r++)
+            channel = entry->channels[r];
+        if (channel == NULL)
+            channel = entry->unknown_risk_channel;
+        if (channel != NULL)
+            g_ptr_array_add (channels, g_object_ref (channel));
     }
 
-    return matched_channel;
+    return channels;
 }
 
 /**
@@ -278,6 +376,7 @@ GStrv
 snapd_snap_get_common_ids (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->common_ids;
 }
 
@@ -333,6 +432,36 @@ snapd_snap_get_description (SnapdSnap *self)
     return self->description;
 }
 
+/**
+ * snapd_snap_get_description_nodes:
+ * @snap: a #SnapdSnap.
+ *
+ * Get the description of this snap parsed as markdown. This is only set for
+ * snaps found with %SNAPD_FIND_FLAGS_PARSE_DESCRIPTIONS, otherwise parse
+ * snapd_snap_get_description() with a #SnapdMarkdownParser.
+ *
+ * Returns: (transfer none) (element-type SnapdMarkdownNode) (allow-none): markdown nodes or %NULL if not parsed.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_snap_get_description_nodes (SnapdSnap *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    return self->description_nodes;
+}
+
+void
+_snapd_snap_set_description_nodes (SnapdSnap *self, GPtrArray *nodes)
+{
+    g_return_if_fail (SNAPD_IS_SNAP (self));
+
+    if (nodes != NULL)
+        g_ptr_array_ref (nodes);
+    g_clear_pointer (&self->description_nodes, g_ptr_array_unref);
+    self->description_nodes = nodes;
+}
+
 /**
  * snapd_snap_get_developer:
  * @snap: a #SnapdSnap.
@@ -434,7 +563,27 @@ GDateTime *
 snapd_snap_get_install_date (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
-    return self->install_date;
+    load_details (self);
+    return _snapd_timestamp_get_date_time (&self->install_date);
+}
+
+/**
+ * snapd_snap_get_install_date_usec:
+ * @snap: a #SnapdSnap.
+ *
+ * Get the date this snap was installed as a number, for sorting and comparing
+ * snaps without creating a #GDateTime.
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if unknown.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_snap_get_install_date_usec (SnapdSnap *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP (self), 0);
+    load_details (self);
+    return _snapd_timestamp_get_time (&self->install_date);
 }
 
 /**
@@ -502,9 +651,75 @@ GPtrArray *
 snapd_snap_get_media (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->media;
 }
 
+typedef gsize (*ObjectSizeFunc) (gpointer object);
+
+static gsize
+objects_size (GPtrArray *array, ObjectSizeFunc size_func)
+{
+    gsize size = _snapd_memory_array_size (array);
+    for (guint i = 0; array != NULL && i < array->len; i++)
+        size += size_func (array->pdata[i]);
+    return size;
+}
+
+static gsize
+screenshot_size (SnapdScreenshot *screenshot)
+{
+    return _snapd_memory_instance_size (screenshot) + _snapd_memory_string_size (snapd_screenshot_get_url (screenshot));
+}
+
+/**
+ * snapd_snap_get_memory_size:
+ * @snap: a #SnapdSnap.
+ *
+ * Get an estimate of the memory used by this snap, including its strings,
+ * apps, channels, media and prices. Strings that are shared between snaps,
+ * such as publisher names and channel names, are not counted. If the snap
+ * was created with lazy parsing, details that have not been used yet are not
+ * counted or loaded.
+ *
+ * Returns: a size in bytes.
+ *
+ * Since: 1.65
+ */
+gsize
+snapd_snap_get_memory_size (SnapdSnap *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP (self), 0);
+
+    gsize size = _snapd_memory_instance_size (self) +
+                 _snapd_memory_string_size (self->broken) +
+                 _snapd_memory_string_size (self->contact) +
+                 _snapd_memory_string_size (self->description) +
+                 _snapd_memory_string_size (self->icon) +
+                 _snapd_memory_string_size (self->id) +
+                 _snapd_memory_string_size (self->license) +
+                 _snapd_memory_string_size (self->mounted_from) +
+                 _snapd_memory_string_size (self->name) +
+                 _snapd_memory_string_size (self->revision) +
+                 _snapd_memory_string_size (self->store_url) +
+                 _snapd_memory_string_size (self->summary) +
+                 _snapd_memory_string_size (self->title) +
+                 _snapd_memory_string_size (self->version) +
+                 _snapd_memory_string_size (self->website);
+
+    /* Details can be filled in by another thread */
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&load_mutex);
+    size += objects_size (self->apps, (ObjectSizeFunc) _snapd_app_get_memory_size) +
+            objects_size (self->channels, (ObjectSizeFunc) _snapd_channel_get_memory_size) +
+            objects_size (self->media, (ObjectSizeFunc) _snapd_media_get_memory_size) +
+            objects_size (self->prices, (ObjectSizeFunc) _snapd_price_get_memory_size) +
+            objects_size (self->screenshots, (ObjectSizeFunc) screenshot_size) +
+            _snapd_memory_strv_size (self->common_ids) +
+            _snapd_memory_strv_size (self->tracks);
+
+    return size;
+}
+
 /**
  * snapd_snap_get_mounted_from:
  * @snap: a #SnapdSnap.
@@ -572,6 +787,7 @@ GPtrArray *
 snapd_snap_get_prices (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->prices;
 }
 
@@ -693,6 +909,7 @@ GPtrArray *
 snapd_snap_get_screenshots (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->screenshots;
 }
 
@@ -795,6 +1012,7 @@ GStrv
 snapd_snap_get_tracks (SnapdSnap *self)
 {
     g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    load_details (self);
     return self->tracks;
 }
 
@@ -851,6 +1069,360 @@ snapd_snap_get_website (SnapdSnap *self)
     return self->website;
 }
 
+#define APP_TYPE "(msbmsumsb)"
+#define CHANNEL_TYPE "(ymsms" SNAPD_SERIALIZED_DATE_TIME "msxms)"
+#define MEDIA_TYPE "(msmsuu)"
+#define PRICE_TYPE "(dms)"
+#define SCREENSHOT_TYPE "(msuu)"
+#define SNAP_TYPE "(msmsmsmsmsmsmsmsmsmsmsmsmsmsmsmsmsmsmsms" \
+                  "xx" SNAPD_SERIALIZED_DATE_TIME "yyyyy" \
+                  "ma" APP_TYPE "ma" CHANNEL_TYPE "masma" MEDIA_TYPE "ma" PRICE_TYPE "ma" SCREENSHOT_TYPE "mas)"
+
+enum
+{
+    FLAG_DEVMODE = 1 << 0,
+    FLAG_JAILMODE = 1 << 1,
+    FLAG_PRIVATE = 1 << 2,
+    FLAG_TRYMODE = 1 << 3,
+};
+
+typedef GVariant *(*ToVariantFunc) (gpointer object);
+
+static GVariant *
+objects_to_variant (const gchar *type, GPtrArray *objects, ToVariantFunc to_variant)
+{
+    if (objects == NULL)
+        return g_variant_new_maybe (G_VARIANT_TYPE (type), NULL);
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE (type));
+    for (guint i = 0; i < objects->len; i++)
+        g_variant_builder_add_value (&builder, to_variant (g_ptr_array_index (objects, i)));
+    return g_variant_new_maybe (NULL, g_variant_builder_end (&builder));
+}
+
+static GVariant *
+strv_to_variant (GStrv values)
+{
+    if (values == NULL)
+        return g_variant_new_maybe (G_VARIANT_TYPE_STRING_ARRAY, NULL);
+    return g_variant_new_maybe (NULL, g_variant_new_strv ((const gchar * const *) values, -1));
+}
+
+static GVariant *
+app_to_variant (SnapdApp *app)
+{
+    return g_variant_new ("(msbmsumsb)",
+                          snapd_app_get_name (app),
+                          snapd_app_get_active (app),
+                          snapd_app_get_common_id (app),
+                          (guint32) snapd_app_get_daemon_type (app),
+                          snapd_app_get_desktop_file (app),
+                          snapd_app_get_enabled (app));
+}
+
+static GVariant *
+channel_to_variant (SnapdChannel *channel)
+{
+    return g_variant_new ("(ymsms@" SNAPD_SERIALIZED_DATE_TIME "msxms)",
+                          (guint8) snapd_channel_get_confinement (channel),
+                          snapd_channel_get_epoch (channel),
+                          snapd_channel_get_name (channel),
+                          _snapd_serialize_timestamp (_snapd_channel_get_released_at_timestamp (channel)),
+                          snapd_channel_get_revision (channel),
+                          snapd_channel_get_size (channel),
+                          snapd_channel_get_version (channel));
+}
+
+static GVariant *
+media_to_variant (SnapdMedia *media)
+{
+    return g_variant_new ("(msmsuu)",
+                          snapd_media_get_media_type (media),
+                          snapd_media_get_url (media),
+                          snapd_media_get_width (media),
+                          snapd_media_get_height (media));
+}
+
+static GVariant *
+price_to_variant (SnapdPrice *price)
+{
+    return g_variant_new ("(dms)", snapd_price_get_amount (price), snapd_price_get_currency (price));
+}
+
+static GVariant *
+screenshot_to_variant (SnapdScreenshot *screenshot)
+{
+    return g_variant_new ("(msuu)",
+                          snapd_screenshot_get_url (screenshot),
+                          snapd_screenshot_get_width (screenshot),
+                          snapd_screenshot_get_height (screenshot));
+}
+
+static GVariant *
+snap_to_variant (SnapdSnap *self)
+{
+    load_details (self);
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE (SNAP_TYPE));
+    const gchar *strings[] = { self->base, self->broken, self->channel, self->contact, self->description,
+                               self->icon, self->id, self->license, self->mounted_from, self->name,
+                               self->publisher_display_name, self->publisher_id, self->publisher_username, self->revision, self->store_url,
+                               self->summary, self->title, self->tracking_channel, self->version, self->website };
+    for (gsize i = 0; i < G_N_ELEMENTS (strings); i++)
+        g_variant_builder_add (&builder, "ms", strings[i]);
+    g_variant_builder_add (&builder, "x", self->download_size);
+    g_variant_builder_add (&builder, "x", self->installed_size);
+    g_variant_builder_add_value (&builder, _snapd_serialize_timestamp (&self->install_date));
+    g_variant_builder_add (&builder, "y", (guint8) self->confinement);
+    g_variant_builder_add (&builder, "y", (guint8) self->publisher_validation);
+    g_variant_builder_add (&builder, "y", (guint8) self->status);
+    g_variant_builder_add (&builder, "y", (guint8) self->snap_type);
+    g_variant_builder_add (&builder, "y", (guint8) ((self->devmode ? FLAG_DEVMODE : 0) |
+                                                    (self->jailmode ? FLAG_JAILMODE : 0) |
+                                                    (self->private ? FLAG_PRIVATE : 0) |
+                                                    (self->trymode ? FLAG_TRYMODE : 0)));
+    g_variant_builder_add_value (&builder, objects_to_variant ("a" APP_TYPE, self->apps, (ToVariantFunc) app_to_variant));
+    g_variant_builder_add_value (&builder, objects_to_variant ("a" CHANNEL_TYPE, self->channels, (ToVariantFunc) channel_to_variant));
+    g_variant_builder_add_value (&builder, strv_to_variant (self->common_ids));
+    g_variant_builder_add_value (&builder, objects_to_variant ("a" MEDIA_TYPE, self->media, (ToVariantFunc) media_to_variant));
+    g_variant_builder_add_value (&builder, objects_to_variant ("a" PRICE_TYPE, self->prices, (ToVariantFunc) price_to_variant));
+    g_variant_builder_add_value (&builder, objects_to_variant ("a" SCREENSHOT_TYPE, self->screenshots, (ToVariantFunc) screenshot_to_variant));
+    g_variant_builder_add_value (&builder, strv_to_variant (self->tracks));
+
+    return g_variant_builder_end (&builder);
+}
+
+typedef GObject *(*FromVariantFunc) (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name);
+
+static GPtrArray *
+objects_from_variant (GVariant *value, SnapdArena *arena, const gchar *snap_name, FromVariantFunc from_variant)
+{
+    if (value == NULL)
+        return NULL;
+
+    gsize length = g_variant_n_children (value);
+    GPtrArray *objects = g_ptr_array_new_full (length, g_object_unref);
+    for (gsize i = 0; i < length; i++) {
+        g_autoptr(GVariant) child = g_variant_get_child_value (value, i);
+        SnapdReader reader;
+        _snapd_reader_init (&reader, child);
+        g_ptr_array_add (objects, from_variant (&reader, arena, snap_name));
+    }
+
+    return objects;
+}
+
+static GObject *
+app_from_variant (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name)
+{
+    const gchar *name = _snapd_reader_get_string (reader);
+    gboolean active = _snapd_reader_get_boolean (reader);
+    const gchar *common_id = _snapd_reader_get_string (reader);
+    SnapdDaemonType daemon_type = _snapd_reader_get_uint32 (reader);
+    const gchar *desktop_file = _snapd_reader_get_string (reader);
+    gboolean enabled = _snapd_reader_get_boolean (reader);
+    return G_OBJECT (_snapd_app_new (arena, name, active, common_id, daemon_type, desktop_file, enabled, snap_name));
+}
+
+static GObject *
+channel_from_variant (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name)
+{
+    SnapdConfinement confinement = _snapd_reader_get_byte (reader);
+    const gchar *epoch = _snapd_reader_get_string (reader);
+    const gchar *name = _snapd_reader_get_string (reader);
+    SnapdTimestamp released_at = { 0 };
+    _snapd_reader_get_timestamp (reader, &released_at);
+    const gchar *revision = _snapd_reader_get_string (reader);
+    gint64 size = _snapd_reader_get_int64 (reader);
+    const gchar *version = _snapd_reader_get_string (reader);
+    return G_OBJECT (_snapd_channel_new (arena, confinement, epoch, name, &released_at, revision, size, version));
+}
+
+static GObject *
+media_from_variant (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name)
+{
+    const gchar *type = _snapd_reader_get_string (reader);
+    const gchar *url = _snapd_reader_get_string (reader);
+    guint width = _snapd_reader_get_uint32 (reader);
+    guint height = _snapd_reader_get_uint32 (reader);
+    return G_OBJECT (_snapd_media_new (arena, type, url, width, height));
+}
+
+static GObject *
+price_from_variant (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name)
+{
+    gdouble amount = _snapd_reader_get_double (reader);
+    const gchar *currency = _snapd_reader_get_string (reader);
+    return G_OBJECT (_snapd_price_new (arena, amount, currency));
+}
+
+static GObject *
+screenshot_from_variant (SnapdReader *reader, SnapdArena *arena, const gchar *snap_name)
+{
+    const gchar *url = _snapd_reader_get_string (reader);
+    guint width = _snapd_reader_get_uint32 (reader);
+    guint height = _snapd_reader_get_uint32 (reader);
+    return g_object_new (SNAPD_TYPE_SCREENSHOT, "url", url, "width", width, "height", height, NULL);
+}
+
+static SnapdSnap *
+snap_from_variant (GVariant *value, SnapdArena *arena)
+{
+    SnapdReader reader;
+    _snapd_reader_init (&reader, value);
+
+    SnapdSnap *self = g_object_new (SNAPD_TYPE_SNAP, NULL);
+    self->arena = _snapd_arena_ref (arena);
+    self->base = g_intern_string (_snapd_reader_get_string (&reader));
+    self->broken = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->channel = g_intern_string (_snapd_reader_get_string (&reader));
+    self->contact = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->description = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->icon = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->id = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->license = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->mounted_from = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->name = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->publisher_display_name = g_intern_string (_snapd_reader_get_string (&reader));
+    self->publisher_id = g_intern_string (_snapd_reader_get_string (&reader));
+    self->publisher_username = g_intern_string (_snapd_reader_get_string (&reader));
+    self->revision = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->store_url = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->summary = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->title = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->tracking_channel = g_intern_string (_snapd_reader_get_string (&reader));
+    self->version = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->website = _snapd_arena_strdup (arena, _snapd_reader_get_string (&reader));
+    self->download_size = _snapd_reader_get_int64 (&reader);
+    self->installed_size = _snapd_reader_get_int64 (&reader);
+    _snapd_reader_get_timestamp (&reader, &self->install_date);
+    self->confinement = _snapd_reader_get_byte (&reader);
+    self->publisher_validation = _snapd_reader_get_byte (&reader);
+    self->status = _snapd_reader_get_byte (&reader);
+    self->snap_type = _snapd_reader_get_byte (&reader);
+    guint8 flags = _snapd_reader_get_byte (&reader);
+    self->devmode = (flags & FLAG_DEVMODE) != 0;
+    self->jailmode = (flags & FLAG_JAILMODE) != 0;
+    self->private = (flags & FLAG_PRIVATE) != 0;
+    self->trymode = (flags & FLAG_TRYMODE) != 0;
+    g_autoptr(GVariant) apps = _snapd_reader_get_array (&reader);
+    self->apps = objects_from_variant (apps, arena, self->name, app_from_variant);
+    g_autoptr(GVariant) channels = _snapd_reader_get_array (&reader);
+    self->channels = objects_from_variant (channels, arena, self->name, channel_from_variant);
+    self->common_ids = _snapd_reader_get_strv (&reader);
+    g_autoptr(GVariant) media = _snapd_reader_get_array (&reader);
+    self->media = objects_from_variant (media, arena, self->name, media_from_variant);
+    g_autoptr(GVariant) prices = _snapd_reader_get_array (&reader);
+    self->prices = objects_from_variant (prices, arena, self->name, price_from_variant);
+    g_autoptr(GVariant) screenshots = _snapd_reader_get_array (&reader);
+    self->screenshots = objects_from_variant (screenshots, arena, self->name, screenshot_from_variant);
+    self->tracks = _snapd_reader_get_strv (&reader);
+
+    return self;
+}
+
+/**
+ * snapd_snap_serialize:
+ * @snap: a #SnapdSnap.
+ *
+ * Serialize a snap to a compact binary form, so it can be stored or sent to
+ * another process and read back with snapd_snap_deserialize(). The data is a
+ * #GVariant, so can be sent over D-Bus as is. Details that are loaded on
+ * first use are loaded first.
+ *
+ * Returns: (transfer full): the serialized snap.
+ *
+ * Since: 1.65
+ */
+GBytes *
+snapd_snap_serialize (SnapdSnap *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SNAP (self), NULL);
+    return _snapd_serialize_wrap ("snap", snap_to_variant (self));
+}
+
+/**
+ * snapd_snap_deserialize:
+ * @data: data written by snapd_snap_serialize().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Read a snap serialized with snapd_snap_serialize(). The strings in the snap
+ * refer to @data rather than being copied, so @data is kept alive while the
+ * snap exists. This makes reading from a mapped file, e.g. one from
+ * g_mapped_file_get_bytes(), particularly quick.
+ *
+ * Returns: (transfer full): a #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+SnapdSnap *
+snapd_snap_deserialize (GBytes *data, GError **error)
+{
+    g_return_val_if_fail (data != NULL, NULL);
+
+    g_autoptr(SnapdArena) arena = NULL;
+    g_autoptr(GVariant) value = _snapd_serialize_unwrap (data, "snap", SNAP_TYPE, &arena, error);
+    if (value == NULL)
+        return NULL;
+    return snap_from_variant (value, arena);
+}
+
+/**
+ * snapd_snap_serialize_array:
+ * @snaps: (element-type SnapdSnap): an array of #SnapdSnap.
+ *
+ * Serialize an array of snaps, as snapd_snap_serialize() does for one snap.
+ *
+ * Returns: (transfer full): the serialized snaps.
+ *
+ * Since: 1.65
+ */
+GBytes *
+snapd_snap_serialize_array (GPtrArray *snaps)
+{
+    g_return_val_if_fail (snaps != NULL, NULL);
+
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a" SNAP_TYPE));
+    for (guint i = 0; i < snaps->len; i++)
+        g_variant_builder_add_value (&builder, snap_to_variant (g_ptr_array_index (snaps, i)));
+    return _snapd_serialize_wrap ("snaps", g_variant_builder_end (&builder));
+}
+
+/**
+ * snapd_snap_deserialize_array:
+ * @data: data written by snapd_snap_serialize_array().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Read snaps serialized with snapd_snap_serialize_array(). As with
+ * snapd_snap_deserialize() the strings in the snaps refer to @data.
+ *
+ * Returns: (transfer container) (element-type SnapdSnap): an array of #SnapdSnap or %NULL on error.
+ *
+ * Since: 1.65
+ */
+GPtrArray *
+snapd_snap_deserialize_array (GBytes *data, GError **error)
+{
+    g_return_val_if_fail (data != NULL, NULL);
+
+    g_autoptr(SnapdArena) arena = NULL;
+    g_autoptr(GVariant) value = _snapd_serialize_unwrap (data, "snaps", "a" SNAP_TYPE, &arena, error);
+    if (value == NULL)
+        return NULL;
+
+    gsize length = g_variant_n_children (value);
+    GPtrArray *snaps = g_ptr_array_new_full (length, g_object_unref);
+    for (gsize i = 0; i < length; i++) {
+        g_autoptr(GVariant) child = g_variant_get_child_value (value, i);
+        g_ptr_array_add (snaps, snap_from_variant (child, arena));
+    }
+
+    return snaps;
+}
+
 static void
 snapd_snap_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
 {
@@ -863,16 +1435,14 @@ snapd_snap_set_property (GObject *object, guint prop_id, const GValue *value, GP
             self->apps = g_ptr_array_ref (g_value_get_boxed (value));
         break;
     case PROP_BASE:
-        g_free (self->base);
-        self->base = g_strdup (g_value_get_string (value));
+        self->base = g_intern_string (g_value_get_string (value));
         break;
     case PROP_BROKEN:
         g_free (self->broken);
         self->broken = g_strdup (g_value_get_string (value));
         break;
     case PROP_CHANNEL:
-        g_free (self->channel);
-        self->channel = g_strdup (g_value_get_string (value));
+        self->channel = g_intern_string (g_value_get_string (value));
         break;
     case PROP_CHANNELS:
         g_clear_pointer (&self->channels, g_ptr_array_unref);
@@ -905,9 +1475,7 @@ snapd_snap_set_property (GObject *object, guint prop_id, const GValue *value, GP
         self->id = g_strdup (g_value_get_string (value));
         break;
     case PROP_INSTALL_DATE:
-        g_clear_pointer (&self->install_date, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->install_date = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->install_date, g_value_get_boxed (value));
         break;
     case PROP_INSTALLED_SIZE:
         self->installed_size = g_value_get_int64 (value);
@@ -937,17 +1505,14 @@ snapd_snap_set_property (GObject *object, guint prop_id, const GValue *value, GP
         self->private = g_value_get_boolean (value);
         break;
     case PROP_PUBLISHER_DISPLAY_NAME:
-        g_free (self->publisher_display_name);
-        self->publisher_display_name = g_strdup (g_value_get_string (value));
+        self->publisher_display_name = g_intern_string (g_value_get_string (value));
         break;
     case PROP_PUBLISHER_ID:
-        g_free (self->publisher_id);
-        self->publisher_id = g_strdup (g_value_get_string (value));
+        self->publisher_id = g_intern_string (g_value_get_string (value));
         break;
     case PROP_PUBLISHER_USERNAME:
     case PROP_DEVELOPER:
-        g_free (self->publisher_username);
-        self->publisher_username = g_strdup (g_value_get_string (value));
+        self->publisher_username = g_intern_string (g_value_get_string (value));
         break;
     case PROP_PUBLISHER_VALIDATION:
         self->publisher_validation = g_value_get_enum (value);
@@ -980,8 +1545,7 @@ snapd_snap_set_property (GObject *object, guint prop_id, const GValue *value, GP
         self->title = g_strdup (g_value_get_string (value));
         break;
     case PROP_TRACKING_CHANNEL:
-        g_free (self->tracking_channel);
-        self->tracking_channel = g_strdup (g_value_get_string (value));
+        self->tracking_channel = g_intern_string (g_value_get_string (value));
         break;
     case PROP_TRACKS:
         g_strfreev (self->tracks);
@@ -1019,6 +1583,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
 
     switch (prop_id) {
     case PROP_APPS:
+        load_details (self);
         g_value_set_boxed (value, self->apps);
         break;
     case PROP_BASE:
@@ -1031,6 +1596,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->channel);
         break;
     case PROP_CHANNELS:
+        load_details (self);
         g_value_set_boxed (value, self->channels);
         break;
     case PROP_CONFINEMENT:
@@ -1055,7 +1621,8 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->id);
         break;
     case PROP_INSTALL_DATE:
-        g_value_set_boxed (value, self->install_date);
+        load_details (self);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->install_date));
         break;
     case PROP_INSTALLED_SIZE:
         g_value_set_int64 (value, self->installed_size);
@@ -1064,6 +1631,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_boolean (value, self->jailmode);
         break;
     case PROP_MEDIA:
+        load_details (self);
         g_value_set_boxed (value, self->media);
         break;
     case PROP_MOUNTED_FROM:
@@ -1073,6 +1641,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->name);
         break;
     case PROP_PRICES:
+        load_details (self);
         g_value_set_boxed (value, self->prices);
         break;
     case PROP_PRIVATE:
@@ -1095,6 +1664,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->revision);
         break;
     case PROP_SCREENSHOTS:
+        load_details (self);
         g_value_set_boxed (value, self->screenshots);
         break;
     case PROP_SNAP_TYPE:
@@ -1116,6 +1686,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->tracking_channel);
         break;
     case PROP_TRACKS:
+        load_details (self);
         g_value_set_boxed (value, self->tracks);
         break;
     case PROP_TRYMODE:
@@ -1128,6 +1699,7 @@ snapd_snap_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_string (value, self->license);
         break;
     case PROP_COMMON_IDS:
+        load_details (self);
         g_value_set_boxed (value, self->common_ids);
         break;
     case PROP_WEBSITE:
@@ -1145,33 +1717,34 @@ snapd_snap_finalize (GObject *object)
     SnapdSnap *self = SNAPD_SNAP (object);
 
     g_clear_pointer (&self->apps, g_ptr_array_unref);
-    g_clear_pointer (&self->base, g_free);
-    g_clear_pointer (&self->broken, g_free);
-    g_clear_pointer (&self->channel, g_free);
     g_clear_pointer (&self->channels, g_ptr_array_unref);
+    g_clear_pointer (&self->channel_index, g_hash_table_unref);
     g_clear_pointer (&self->common_ids, g_strfreev);
-    g_clear_pointer (&self->contact, g_free);
-    g_clear_pointer (&self->description, g_free);
-    g_clear_pointer (&self->icon, g_free);
-    g_clear_pointer (&self->id, g_free);
-    g_clear_pointer (&self->install_date, g_date_time_unref);
-    g_clear_pointer (&self->name, g_free);
-    g_clear_pointer (&self->license, g_free);
+    g_clear_pointer (&self->description_nodes, g_ptr_array_unref);
+    _snapd_timestamp_clear (&self->install_date);
     g_clear_pointer (&self->media, g_ptr_array_unref);
-    g_clear_pointer (&self->mounted_from, g_free);
     g_clear_pointer (&self->prices, g_ptr_array_unref);
-    g_clear_pointer (&self->publisher_display_name, g_free);
-    g_clear_pointer (&self->publisher_id, g_free);
-    g_clear_pointer (&self->publisher_username, g_free);
-    g_clear_pointer (&self->revision, g_free);
     g_clear_pointer (&self->screenshots, g_ptr_array_unref);
-    g_clear_pointer (&self->store_url, g_free);
-    g_clear_pointer (&self->summary, g_free);
-    g_clear_pointer (&self->title, g_free);
-    g_clear_pointer (&self->tracking_channel, g_free);
     g_clear_pointer (&self->tracks, g_strfreev);
-    g_clear_pointer (&self->version, g_free);
-    g_clear_pointer (&self->website, g_free);
+    if (self->arena != NULL)
+        g_clear_pointer (&self->arena, _snapd_arena_unref);
+    else {
+        g_free (self->broken);
+        g_free (self->contact);
+        g_free (self->description);
+        g_free (self->icon);
+        g_free (self->id);
+        g_free (self->license);
+        g_free (self->mounted_from);
+        g_free (self->name);
+        g_free (self->revision);
+        g_free (self->store_url);
+        g_free (self->summary);
+        g_free (self->title);
+        g_free (self->version);
+        g_free (self->website);
+    }
+    clear_loader (self);
 
     G_OBJECT_CLASS (snapd_snap_parent_class)->finalize (object);
 }
@@ -91,6 +91,42 @@ typedef enum
     SNAPD_PUBLISHER_VALIDATION_STARRED
 } SnapdPublisherValidation;
 
+/**
+ * SnapdSnapFields:
+ * @SNAPD_SNAP_FIELDS_NONE: Only set the name, ID, revision, version, status,
+ *     type, channel and other scalar fields.
+ * @SNAPD_SNAP_FIELDS_DESCRIPTION: Set the title, summary, description,
+ *     contact, license, website, store URL and icon.
+ * @SNAPD_SNAP_FIELDS_PUBLISHER: Set the publisher fields.
+ * @SNAPD_SNAP_FIELDS_APPS: Set the apps.
+ * @SNAPD_SNAP_FIELDS_CHANNELS: Set the channels.
+ * @SNAPD_SNAP_FIELDS_COMMON_IDS: Set the common IDs.
+ * @SNAPD_SNAP_FIELDS_INSTALL_DATE: Set the install date.
+ * @SNAPD_SNAP_FIELDS_MEDIA: Set the media and screenshots.
+ * @SNAPD_SNAP_FIELDS_PRICES: Set the prices.
+ * @SNAPD_SNAP_FIELDS_TRACKS: Set the tracks.
+ * @SNAPD_SNAP_FIELDS_ALL: Set all fields.
+ *
+ * Fields to set when getting snaps. Fields that are not selected are left
+ * unset, so are %NULL, empty or zero.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_SNAP_FIELDS_NONE         = 0,
+    SNAPD_SNAP_FIELDS_DESCRIPTION  = 1 << 0,
+    SNAPD_SNAP_FIELDS_PUBLISHER    = 1 << 1,
+    SNAPD_SNAP_FIELDS_APPS         = 1 << 2,
+    SNAPD_SNAP_FIELDS_CHANNELS     = 1 << 3,
+    SNAPD_SNAP_FIELDS_COMMON_IDS   = 1 << 4,
+    SNAPD_SNAP_FIELDS_INSTALL_DATE = 1 << 5,
+    SNAPD_SNAP_FIELDS_MEDIA        = 1 << 6,
+    SNAPD_SNAP_FIELDS_PRICES       = 1 << 7,
+    SNAPD_SNAP_FIELDS_TRACKS       = 1 << 8,
+    SNAPD_SNAP_FIELDS_ALL          = (1 << 9) - 1
+} SnapdSnapFields;
+
 GPtrArray               *snapd_snap_get_apps                   (SnapdSnap   *snap);
 
 const gchar             *snapd_snap_get_base                   (SnapdSnap   *snap);
@@ -112,6 +148,8 @@ const gchar             *snapd_snap_get_contact                (SnapdSnap   *sna
 
 const gchar             *snapd_snap_get_description            (SnapdSnap   *snap);
 
+GPtrArray               *snapd_snap_get_description_nodes      (SnapdSnap   *snap);
+
 const gchar             *snapd_snap_get_developer              (SnapdSnap   *snap) G_DEPRECATED_FOR(snapd_snap_get_publisher_username);
 
 gboolean                 snapd_snap_get_devmode                (SnapdSnap   *snap);
@@ -124,6 +162,8 @@ const gchar             *snapd_snap_get_id                     (SnapdSnap   *sna
 
 GDateTime               *snapd_snap_get_install_date           (SnapdSnap   *snap);
 
+gint64                   snapd_snap_get_install_date_usec      (SnapdSnap   *snap);
+
 gint64                   snapd_snap_get_installed_size         (SnapdSnap   *snap);
 
 gboolean                 snapd_snap_get_jailmode               (SnapdSnap   *snap);
@@ -132,6 +172,8 @@ const gchar             *snapd_snap_get_license                (SnapdSnap   *sna
 
 GPtrArray               *snapd_snap_get_media                  (SnapdSnap   *snap);
 
+gsize                    snapd_snap_get_memory_size            (SnapdSnap   *snap);
+
 const gchar             *snapd_snap_get_mounted_from           (SnapdSnap   *snap);
 
 const gchar             *snapd_snap_get_name                   (SnapdSnap   *snap);
@@ -166,12 +208,24 @@ const gchar             *snapd_snap_get_tracking_channel       (SnapdSnap   *sna
 
 GStrv                    snapd_snap_get_tracks                 (SnapdSnap   *snap);
 
+GPtrArray               *snapd_snap_get_track_channels         (SnapdSnap   *snap);
+
 gboolean                 snapd_snap_get_trymode                (SnapdSnap   *snap);
 
 const gchar             *snapd_snap_get_version                (SnapdSnap   *snap);
 
 const gchar             *snapd_snap_get_website                (SnapdSnap   *snap);
 
+GBytes                  *snapd_snap_serialize                  (SnapdSnap   *snap);
+
+SnapdSnap               *snapd_snap_deserialize                (GBytes      *data,
+                                                                GError     **error);
+
+GBytes                  *snapd_snap_serialize_array            (GPtrArray   *snaps);
+
+GPtrArray               *snapd_snap_deserialize_array          (GBytes      *data,
+                                                                GError     **error);
+
 G_END_DECLS
 
 #endif /* __SNAPD_SNAP_H__ */
@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-sorted-snap-model.h"
+#include "snapd-snap.h"
+
+/**
+ * SECTION: snapd-sorted-snap-model
+ * @short_description: Sorted and filtered snaps
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdSortedSnapModel presents the snaps from another #GListModel, such
+ * as a #SnapdSnapListModel or #SnapdResultList, sorted by one of the fields in
+ * #SnapdSnapSortKey and optionally filtered by text.
+ *
+ * The sort key and filter text of each snap are computed once, when the snap
+ * is added to the source model, rather than on every comparison. When the
+ * source model changes the snaps that were added are inserted in place and
+ * those removed are taken out, without sorting the rest of the list again.
+ */
+
+/**
+ * SnapdSortedSnapModel:
+ *
+ * #SnapdSortedSnapModel is a sorted view of a list of snaps.
+ *
+ * Since: 1.65
+ */
+
+/* A snap from the source with its keys computed */
+typedef struct
+{
+    SnapdSnap *snap;
+
+    /* Collation key of the name, used for sorting by name and to break ties */
+    gchar *name_key;
+
+    /* Key for the current sort field */
+    gchar *string_key;
+    gint64 number_key;
+
+    /* Case-folded name and title to match the filter against */
+    gchar *filter_text;
+} SortEntry;
+
+struct _SnapdSortedSnapModel
+{
+    GObject parent_instance;
+
+    GListModel *source;
+
+    /* Entries in the order of the source model, freed when removed */
+    GPtrArray *entries;
+
+    /* Entries that match the filter, in sorted order */
+    GPtrArray *visible;
+
+    SnapdSnapSortKey sort_key;
+    gboolean descending;
+
+    /* Text given to filter on, and its case-folded form */
+    gchar *filter_text;
+    gchar *filter_key;
+};
+
+static void snapd_sorted_snap_model_list_model_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (SnapdSortedSnapModel, snapd_sorted_snap_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, snapd_sorted_snap_model_list_model_init))
+
+static void
+sort_entry_free (SortEntry *entry)
+{
+    g_object_unref (entry->snap);
+    g_free (entry->name_key);
+    g_free (entry->string_key);
+    g_free (entry->filter_text);
+    g_slice_free (SortEntry, entry);
+}
+
+static const gchar *
+get_title (SnapdSnap *snap)
+{
+    const gchar *title = snapd_snap_get_title (snap);
+    if (title == NULL)
+        title = snapd_snap_get_name (snap);
+    return title != NULL ? title : "";
+}
+
+static void
+update_sort_key (SnapdSortedSnapModel *self, SortEntry *entry)
+{
+    g_clear_pointer (&entry->string_key, g_free);
+    entry->number_key = 0;
+
+    switch (self->sort_key) {
+    case SNAPD_SNAP_SORT_KEY_NAME:
+        break;
+    case SNAPD_SNAP_SORT_KEY_TITLE:
+        entry->string_key = g_utf8_collate_key (get_title (entry->snap), -1);
+        break;
+    case SNAPD_SNAP_SORT_KEY_INSTALL_DATE:
+        entry->number_key = snapd_snap_get_install_date_usec (entry->snap);
+        break;
+    case SNAPD_SNAP_SORT_KEY_INSTALLED_SIZE:
+        entry->number_key = snapd_snap_get_installed_size (entry->snap);
+        break;
+    }
+}
+
+static SortEntry *
+sort_entry_new (SnapdSortedSnapModel *self, SnapdSnap *snap)
+{
+    SortEntry *entry = g_slice_new0 (SortEntry);
+    entry->snap = g_object_ref (snap);
+    const gchar *name = snapd_snap_get_name (snap);
+    entry->name_key = g_utf8_collate_key (name != NULL ? name : "", -1);
+    g_autofree gchar *text = g_strdup_printf ("%s\n%s", name != NULL ? name : "", get_title (snap));
+    entry->filter_text = g_utf8_casefold (text, -1);
+    update_sort_key (self, entry);
+
+    return entry;
+}
+
+static gint
+compare_entries (SnapdSortedSnapModel *self, SortEntry *a, SortEntry *b)
+{
+    gint result = 0;
+    if (a->string_key != NULL && b->string_key != NULL)
+        result = strcmp (a->string_key, b->string_key);
+    else if (a->number_key != b->number_key)
+        result = a->number_key < b->number_key ? -1 : 1;
+    if (result == 0)
+        result = strcmp (a->name_key, b->name_key);
+
+    return self->descending ? -result : result;
+}
+
+static gboolean
+matches_filter (SnapdSortedSnapModel *self, SortEntry *entry)
+{
+    return self->filter_key == NULL || strstr (entry->filter_text, self->filter_key) != NULL;
+}
+
+/* Find where @entry goes in the visible entries, after any that compare equal */
+static guint
+find_insert_position (SnapdSortedSnapModel *self, SortEntry *entry)
+{
+    guint start = 0, end = self->visible->len;
+    while (start < end) {
+        guint middle = start + (end - start) / 2;
+        if (compare_entries (self, g_ptr_array_index (self->visible, middle), entry) <= 0)
+            start = middle + 1;
+        else
+            end = middle;
+    }
+
+    return start;
+}
+
+static gint
+compare_entries_cb (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    return compare_entries (user_data, *((SortEntry **) a), *((SortEntry **) b));
+}
+
+/* Rebuild the visible entries after the sort order or filter has changed */
+static void
+resort (SnapdSortedSnapModel *self)
+{
+    guint n_removed = self->visible->len;
+
+    g_ptr_array_set_size (self->visible, 0);
+    for (guint i = 0; i < self->entries->len; i++) {
+        SortEntry *entry = g_ptr_array_index (self->entries, i);
+        if (matches_filter (self, entry))
+            g_ptr_array_add (self->visible, entry);
+    }
+    g_ptr_array_sort_with_data (self->visible, compare_entries_cb, self);
+
+    if (n_removed > 0 || self->visible->len > 0)
+        g_list_model_items_changed (G_LIST_MODEL (self), 0, n_removed, self->visible->len);
+}
+
+static void
+remove_entry (SnapdSortedSnapModel *self, guint position)
+{
+    SortEntry *entry = g_ptr_array_remove_index (self->entries, position);
+
+    for (guint i = 0; i < self->visible->len; i++) {
+        if (g_ptr_array_index (self->visible, i) == entry) {
+            g_ptr_array_remove_index (self->visible, i);
+            g_list_model_items_changed (G_LIST_MODEL (self), i, 1, 0);
+            break;
+        }
+    }
+    sort_entry_free (entry);
+}
+
+static void
+insert_entry (SnapdSortedSnapModel *self, guint position, SnapdSnap *snap)
+{
+    SortEntry *entry = sort_entry_new (self, snap);
+    g_ptr_array_insert (self->entries, position, entry);
+
+    if (matches_filter (self, entry)) {
+        guint index = find_insert_position (self, entry);
+        g_ptr_array_insert (self->visible, index, entry);
+        g_list_model_items_changed (G_LIST_MODEL (self), index, 0, 1);
+    }
+}
+
+static void
+source_items_changed_cb (SnapdSortedSnapModel *self, guint position, guint removed, guint added)
+{
+    for (guint i = 0; i < removed; i++)
+        remove_entry (self, position);
+    for (guint i = 0; i < added; i++) {
+        g_autoptr(SnapdSnap) snap = g_list_model_get_item (self->source, position + i);
+        insert_entry (self, position + i, snap);
+    }
+}
+
+/**
+ * snapd_sorted_snap_model_new:
+ * @source: a #GListModel of #SnapdSnap.
+ *
+ * Create a sorted view of the snaps in @source. Snaps are sorted by
+ * %SNAPD_SNAP_SORT_KEY_NAME until snapd_sorted_snap_model_set_sort_key() is
+ * called.
+ *
+ * Returns: a new #SnapdSortedSnapModel
+ *
+ * Since: 1.65
+ */
+SnapdSortedSnapModel *
+snapd_sorted_snap_model_new (GListModel *source)
+{
+    g_return_val_if_fail (G_IS_LIST_MODEL (source), NULL);
+    g_return_val_if_fail (g_type_is_a (g_list_model_get_item_type (source), SNAPD_TYPE_SNAP), NULL);
+
+    SnapdSortedSnapModel *self = g_object_new (SNAPD_TYPE_SORTED_SNAP_MODEL, NULL);
+    self->source = g_object_ref (source);
+    guint n_items = g_list_model_get_n_items (source);
+    for (guint i = 0; i < n_items; i++) {
+        g_autoptr(SnapdSnap) snap = g_list_model_get_item (source, i);
+        SortEntry *entry = sort_entry_new (self, snap);
+        g_ptr_array_add (self->entries, entry);
+        g_ptr_array_add (self->visible, entry);
+    }
+    g_ptr_array_sort_with_data (self->visible, compare_entries_cb, self);
+    g_signal_connect_object (source, "items-changed", G_CALLBACK (source_items_changed_cb), self, G_CONNECT_SWAPPED);
+
+    return self;
+}
+
+/**
+ * snapd_sorted_snap_model_get_source:
+ * @model: a #SnapdSortedSnapModel.
+ *
+ * Get the model the snaps come from.
+ *
+ * Returns: (transfer none): a #GListModel
+ *
+ * Since: 1.65
+ */
+GListModel *
+snapd_sorted_snap_model_get_source (SnapdSortedSnapModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self), NULL);
+    return self->source;
+}
+
+/**
+ * snapd_sorted_snap_model_set_sort_key:
+ * @model: a #SnapdSortedSnapModel.
+ * @sort_key: the field to sort by.
+ * @descending: %TRUE to sort from highest to lowest.
+ *
+ * Set how the snaps are sorted. Snaps that compare equal are sorted by name.
+ *
+ * Since: 1.65
+ */
+void
+snapd_sorted_snap_model_set_sort_key (SnapdSortedSnapModel *self, SnapdSnapSortKey sort_key, gboolean descending)
+{
+    g_return_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self));
+
+    if (self->sort_key == sort_key && self->descending == descending)
+        return;
+
+    gboolean key_changed = self->sort_key != sort_key;
+    self->sort_key = sort_key;
+    self->descending = descending;
+    if (key_changed) {
+        for (guint i = 0; i < self->entries->len; i++)
+            update_sort_key (self, g_ptr_array_index (self->entries, i));
+    }
+    resort (self);
+}
+
+/**
+ * snapd_sorted_snap_model_get_sort_key:
+ * @model: a #SnapdSortedSnapModel.
+ *
+ * Get the field snaps are sorted by.
+ *
+ * Returns: a #SnapdSnapSortKey.
+ *
+ * Since: 1.65
+ */
+SnapdSnapSortKey
+snapd_sorted_snap_model_get_sort_key (SnapdSortedSnapModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self), SNAPD_SNAP_SORT_KEY_NAME);
+    return self->sort_key;
+}
+
+/**
+ * snapd_sorted_snap_model_get_descending:
+ * @model: a #SnapdSortedSnapModel.
+ *
+ * Get if snaps are sorted from highest to lowest.
+ *
+ * Returns: %TRUE if sorted in descending order.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_sorted_snap_model_get_descending (SnapdSortedSnapModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self), FALSE);
+    return self->descending;
+}
+
+/**
+ * snapd_sorted_snap_model_set_filter_text:
+ * @model: a #SnapdSortedSnapModel.
+ * @text: (allow-none): text to match or %NULL to show all snaps.
+ *
+ * Only show snaps whose name or title contains @text, ignoring case.
+ *
+ * Since: 1.65
+ */
+void
+snapd_sorted_snap_model_set_filter_text (SnapdSortedSnapModel *self, const gchar *text)
+{
+    g_return_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self));
+
+    if (text != NULL && text[0] == '\0')
+        text = NULL;
+    if (g_strcmp0 (self->filter_text, text) == 0)
+        return;
+
+    g_free (self->filter_text);
+    self->filter_text = g_strdup (text);
+    g_clear_pointer (&self->filter_key, g_free);
+    if (text != NULL)
+        self->filter_key = g_utf8_casefold (text, -1);
+    resort (self);
+}
+
+/**
+ * snapd_sorted_snap_model_get_filter_text:
+ * @model: a #SnapdSortedSnapModel.
+ *
+ * Get the text snaps are filtered by.
+ *
+ * Returns: (allow-none): the filter text or %NULL if all snaps are shown.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_sorted_snap_model_get_filter_text (SnapdSortedSnapModel *self)
+{
+    g_return_val_if_fail (SNAPD_IS_SORTED_SNAP_MODEL (self), NULL);
+    return self->filter_text;
+}
+
+static GType
+snapd_sorted_snap_model_get_item_type (GListModel *model)
+{
+    return SNAPD_TYPE_SNAP;
+}
+
+static guint
+snapd_sorted_snap_model_get_n_items (GListModel *model)
+{
+    return SNAPD_SORTED_SNAP_MODEL (model)->visible->len;
+}
+
+static gpointer
+snapd_sorted_snap_model_get_item (GListModel *model, guint position)
+{
+    SnapdSortedSnapModel *self = SNAPD_SORTED_SNAP_MODEL (model);
+
+    if (position >= self->visible->len)
+        return NULL;
+    SortEntry *entry = g_ptr_array_index (self->visible, position);
+    return g_object_ref (entry->snap);
+}
+
+static void
+snapd_sorted_snap_model_list_model_init (GListModelInterface *iface)
+{
+    iface->get_item_type = snapd_sorted_snap_model_get_item_type;
+    iface->get_n_items = snapd_sorted_snap_model_get_n_items;
+    iface->get_item = snapd_sorted_snap_model_get_item;
+}
+
+static void
+snapd_sorted_snap_model_finalize (GObject *object)
+{
+    SnapdSortedSnapModel *self = SNAPD_SORTED_SNAP_MODEL (object);
+
+    g_clear_object (&self->source);
+    g_clear_pointer (&self->visible, g_ptr_array_unref);
+    for (guint i = 0; i < self->entries->len; i++)
+        sort_entry_free (g_ptr_array_index (self->entries, i));
+    g_clear_pointer (&self->entries, g_ptr_array_unref);
+    g_clear_pointer (&self->filter_text, g_free);
+    g_clear_pointer (&self->filter_key, g_free);
+
+    G_OBJECT_CLASS (snapd_sorted_snap_model_parent_class)->finalize (object);
+}
+
+static void
+snapd_sorted_snap_model_class_init (SnapdSortedSnapModelClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_sorted_snap_model_finalize;
+}
+
+static void
+snapd_sorted_snap_model_init (SnapdSortedSnapModel *self)
+{
+    self->entries = g_ptr_array_new ();
+    self->visible = g_ptr_array_new ();
+    self->sort_key = SNAPD_SNAP_SORT_KEY_NAME;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_SORTED_SNAP_MODEL_H__
+#define __SNAPD_SORTED_SNAP_MODEL_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_SORTED_SNAP_MODEL  (snapd_sorted_snap_model_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdSortedSnapModel, snapd_sorted_snap_model, SNAPD, SORTED_SNAP_MODEL, GObject)
+
+/**
+ * SnapdSnapSortKey:
+ * @SNAPD_SNAP_SORT_KEY_NAME: sort by snap name.
+ * @SNAPD_SNAP_SORT_KEY_TITLE: sort by title, or name if the snap has no title.
+ * @SNAPD_SNAP_SORT_KEY_INSTALL_DATE: sort by the date the snap was installed.
+ * @SNAPD_SNAP_SORT_KEY_INSTALLED_SIZE: sort by the installed size of the snap.
+ *
+ * Field to sort snaps by in a #SnapdSortedSnapModel.
+ *
+ * Since: 1.65
+ */
+typedef enum
+{
+    SNAPD_SNAP_SORT_KEY_NAME,
+    SNAPD_SNAP_SORT_KEY_TITLE,
+    SNAPD_SNAP_SORT_KEY_INSTALL_DATE,
+    SNAPD_SNAP_SORT_KEY_INSTALLED_SIZE
+} SnapdSnapSortKey;
+
+SnapdSortedSnapModel *snapd_sorted_snap_model_new             (GListModel           *source);
+
+GListModel           *snapd_sorted_snap_model_get_source      (SnapdSortedSnapModel *model);
+
+void                  snapd_sorted_snap_model_set_sort_key    (SnapdSortedSnapModel *model,
+                                                               SnapdSnapSortKey      sort_key,
+                                                               gboolean              descending);
+
+SnapdSnapSortKey      snapd_sorted_snap_model_get_sort_key    (SnapdSortedSnapModel *model);
+
+gboolean              snapd_sorted_snap_model_get_descending  (SnapdSortedSnapModel *model);
+
+void                  snapd_sorted_snap_model_set_filter_text (SnapdSortedSnapModel *model,
+                                                               const gchar          *text);
+
+const gchar          *snapd_sorted_snap_model_get_filter_text (SnapdSortedSnapModel *model);
+
+G_END_DECLS
+
+#endif /* __SNAPD_SORTED_SNAP_MODEL_H__ */
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_TASK_PRIVATE_H__
+#define __SNAPD_TASK_PRIVATE_H__
+
+#include "snapd-task.h"
+#include "snapd-timestamp.h"
+
+G_BEGIN_DECLS
+
+SnapdTask            *_snapd_task_new                 (const gchar    *id,
+                                                       const gchar    *kind,
+                                                       const gchar    *summary,
+                                                       const gchar    *status,
+                                                       const gchar    *progress_label,
+                                                       gint64          progress_done,
+                                                       gint64          progress_total,
+                                                       SnapdTimestamp *spawn_time,
+                                                       SnapdTimestamp *ready_time);
+
+void                  _snapd_task_update_estimate     (SnapdTask      *task,
+                                                       SnapdTask      *previous);
+
+const SnapdTimestamp *_snapd_task_get_spawn_timestamp (SnapdTask      *task);
+
+const SnapdTimestamp *_snapd_task_get_ready_timestamp (SnapdTask      *task);
+
+G_END_DECLS
+
+#endif /* __SNAPD_TASK_PRIVATE_H__ */
@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "snapd-task.h"
+#include "snapd-task-private.h"
 #include "snapd-change.h"
 
 /**
@@ -39,10 +40,18 @@ struct _SnapdTask
     gchar *progress_label;
     gint64 progress_done;
     gint64 progress_total;
-    GDateTime *spawn_time;
-    GDateTime *ready_time;
+    SnapdTimestamp spawn_time;
+    SnapdTimestamp ready_time;
+
+    /* Smoothed progress per second and when the progress was seen, estimated from successive polls */
+    gdouble progress_rate;
+    gint64 progress_sample_time;
+    GDateTime *estimated_ready_time;
 };
 
+/* Number of microseconds over which the progress rate is smoothed */
+#define RATE_SMOOTHING_TIME (5 * G_USEC_PER_SEC)
+
 enum
 {
     PROP_ID = 1,
@@ -60,6 +69,53 @@ enum
 
 G_DEFINE_TYPE (SnapdTask, snapd_task, G_TYPE_OBJECT)
 
+/* Create without going through properties, taking ownership of the contents of spawn_time and ready_time */
+SnapdTask *
+_snapd_task_new (const gchar *id, const gchar *kind, const gchar *summary, const gchar *status,
+                 const gchar *progress_label, gint64 progress_done, gint64 progress_total,
+                 SnapdTimestamp *spawn_time, SnapdTimestamp *ready_time)
+{
+    SnapdTask *self = g_object_new (SNAPD_TYPE_TASK, NULL);
+
+    self->id = g_strdup (id);
+    self->kind = g_strdup (kind);
+    self->summary = g_strdup (summary);
+    self->status = g_strdup (status);
+    self->progress_label = g_strdup (progress_label);
+    self->progress_done = progress_done;
+    self->progress_total = progress_total;
+    self->spawn_time = *spawn_time;
+    self->ready_time = *ready_time;
+
+    return self;
+}
+
+/* Estimate the rate of progress from the same task seen in the previous poll */
+void
+_snapd_task_update_estimate (SnapdTask *self, SnapdTask *previous)
+{
+    self->progress_sample_time = g_get_monotonic_time ();
+    if (previous == NULL || g_strcmp0 (self->id, previous->id) != 0)
+        return;
+
+    self->progress_rate = previous->progress_rate;
+    gint64 elapsed = self->progress_sample_time - previous->progress_sample_time;
+    if (previous->progress_sample_time == 0 || elapsed <= 0 || self->progress_done < previous->progress_done)
+        return;
+
+    /* Smooth exponentially, weighting each sample by the time it covers */
+    gdouble rate = (gdouble) (self->progress_done - previous->progress_done) * G_USEC_PER_SEC / elapsed;
+    if (previous->progress_rate == 0)
+        self->progress_rate = rate;
+    else
+        self->progress_rate += (rate - previous->progress_rate) * elapsed / (elapsed + RATE_SMOOTHING_TIME);
+
+    if (self->progress_rate > 0 && self->progress_done < self->progress_total) {
+        g_autoptr(GDateTime) now = g_date_time_new_now_utc ();
+        self->estimated_ready_time = g_date_time_add_seconds (now, (self->progress_total - self->progress_done) / self->progress_rate);
+    }
+}
+
 /**
  * snapd_task_get_id:
  * @task: a #SnapdTask.
@@ -247,7 +303,25 @@ snapd_task_get_spawn_time (SnapdTask *self)
         return snapd_change_get_spawn_time (SNAPD_CHANGE (self));
 
     g_return_val_if_fail (SNAPD_IS_TASK (self), NULL);
-    return self->spawn_time;
+    return _snapd_timestamp_get_date_time (&self->spawn_time);
+}
+
+/**
+ * snapd_task_get_spawn_time_usec:
+ * @task: a #SnapdTask.
+ *
+ * Get the time this task started as a number, for sorting and comparing
+ * tasks without creating a #GDateTime.
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if not set.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_task_get_spawn_time_usec (SnapdTask *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TASK (self), 0);
+    return _snapd_timestamp_get_time (&self->spawn_time);
 }
 
 /**
@@ -268,7 +342,75 @@ snapd_task_get_ready_time (SnapdTask *self)
         return snapd_change_get_ready_time (SNAPD_CHANGE (self));
 
     g_return_val_if_fail (SNAPD_IS_TASK (self), NULL);
-    return self->ready_time;
+    return _snapd_timestamp_get_date_time (&self->ready_time);
+}
+
+/**
+ * snapd_task_get_ready_time_usec:
+ * @task: a #SnapdTask.
+ *
+ * Get the time this task completed as a number. See
+ * snapd_task_get_spawn_time_usec().
+ *
+ * Returns: microseconds since the Unix epoch, or 0 if not yet completed.
+ *
+ * Since: 1.65
+ */
+gint64
+snapd_task_get_ready_time_usec (SnapdTask *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TASK (self), 0);
+    return _snapd_timestamp_get_time (&self->ready_time);
+}
+
+const SnapdTimestamp *
+_snapd_task_get_spawn_timestamp (SnapdTask *self)
+{
+    return &self->spawn_time;
+}
+
+const SnapdTimestamp *
+_snapd_task_get_ready_timestamp (SnapdTask *self)
+{
+    return &self->ready_time;
+}
+
+/**
+ * snapd_task_get_progress_rate:
+ * @task: a #SnapdTask.
+ *
+ * Get how fast this task is progressing, in units of
+ * snapd_task_get_progress_done() per second. This is estimated from the
+ * progress seen while polling the change this task is in, and smoothed over
+ * the last few seconds.
+ *
+ * Returns: progress per second or 0 if not known.
+ *
+ * Since: 1.65
+ */
+gdouble
+snapd_task_get_progress_rate (SnapdTask *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TASK (self), 0);
+    return self->progress_rate;
+}
+
+/**
+ * snapd_task_get_estimated_ready_time:
+ * @task: a #SnapdTask.
+ *
+ * Get when this task is expected to complete, based on the remaining progress
+ * and snapd_task_get_progress_rate().
+ *
+ * Returns: (transfer none) (allow-none): a #GDateTime or %NULL if not known.
+ *
+ * Since: 1.65
+ */
+GDateTime *
+snapd_task_get_estimated_ready_time (SnapdTask *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TASK (self), NULL);
+    return self->estimated_ready_time;
 }
 
 static void
@@ -307,14 +449,10 @@ snapd_task_set_property (GObject *object, guint prop_id, const GValue *value, GP
         self->progress_total = g_value_get_int64 (value);
         break;
     case PROP_SPAWN_TIME:
-        g_clear_pointer (&self->spawn_time, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->spawn_time = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->spawn_time, g_value_get_boxed (value));
         break;
     case PROP_READY_TIME:
-        g_clear_pointer (&self->ready_time, g_date_time_unref);
-        if (g_value_get_boxed (value) != NULL)
-            self->ready_time = g_date_time_ref (g_value_get_boxed (value));
+        _snapd_timestamp_set_date_time (&self->ready_time, g_value_get_boxed (value));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -353,10 +491,10 @@ snapd_task_get_property (GObject *object, guint prop_id, GValue *value, GParamSp
         g_value_set_boolean (value, FALSE);
         break;
     case PROP_SPAWN_TIME:
-        g_value_set_boxed (value, self->spawn_time);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->spawn_time));
         break;
     case PROP_READY_TIME:
-        g_value_set_boxed (value, self->ready_time);
+        g_value_set_boxed (value, _snapd_timestamp_get_date_time (&self->ready_time));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -374,8 +512,9 @@ snapd_task_finalize (GObject *object)
     g_clear_pointer (&self->summary, g_free);
     g_clear_pointer (&self->status, g_free);
     g_clear_pointer (&self->progress_label, g_free);
-    g_clear_pointer (&self->spawn_time, g_date_time_unref);
-    g_clear_pointer (&self->ready_time, g_date_time_unref);
+    _snapd_timestamp_clear (&self->spawn_time);
+    _snapd_timestamp_clear (&self->ready_time);
+    g_clear_pointer (&self->estimated_ready_time, g_date_time_unref);
 
     G_OBJECT_CLASS (snapd_task_parent_class)->finalize (object);
 }
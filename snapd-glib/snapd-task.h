@@ -22,26 +22,34 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (SnapdTask, snapd_task, SNAPD, TASK, GObject)
 
-const gchar *snapd_task_get_id             (SnapdTask *task);
+const gchar *snapd_task_get_id                   (SnapdTask *task);
 
-const gchar *snapd_task_get_kind           (SnapdTask *task);
+const gchar *snapd_task_get_kind                 (SnapdTask *task);
 
-const gchar *snapd_task_get_summary        (SnapdTask *task);
+const gchar *snapd_task_get_summary              (SnapdTask *task);
 
-const gchar *snapd_task_get_status         (SnapdTask *task);
+const gchar *snapd_task_get_status               (SnapdTask *task);
 
 G_DEPRECATED_FOR (snapd_change_get_ready)
-gboolean     snapd_task_get_ready          (SnapdTask *task);
+gboolean     snapd_task_get_ready                (SnapdTask *task);
 
-const gchar *snapd_task_get_progress_label (SnapdTask *task);
+const gchar *snapd_task_get_progress_label       (SnapdTask *task);
 
-gint64       snapd_task_get_progress_done  (SnapdTask *task);
+gint64       snapd_task_get_progress_done        (SnapdTask *task);
 
-gint64       snapd_task_get_progress_total (SnapdTask *task);
+gint64       snapd_task_get_progress_total       (SnapdTask *task);
 
-GDateTime   *snapd_task_get_spawn_time     (SnapdTask *task);
+GDateTime   *snapd_task_get_spawn_time           (SnapdTask *task);
 
-GDateTime   *snapd_task_get_ready_time     (SnapdTask *task);
+gint64       snapd_task_get_spawn_time_usec      (SnapdTask *task);
+
+GDateTime   *snapd_task_get_ready_time           (SnapdTask *task);
+
+gint64       snapd_task_get_ready_time_usec      (SnapdTask *task);
+
+gdouble      snapd_task_get_progress_rate        (SnapdTask *task);
+
+GDateTime   *snapd_task_get_estimated_ready_time (SnapdTask *task);
 
 G_END_DECLS
 
@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+
+#include "snapd-theme-status-cache.h"
+
+/**
+ * SECTION: snapd-theme-status-cache
+ * @short_description: Cached theme status checks
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdThemeStatusCache keeps the results of
+ * snapd_client_check_themes_async(), which makes snapd contact the store.
+ * Each call to snapd_theme_status_cache_check_async() gets the installed
+ * snaps, which snapd has locally. If the same theme names were checked before
+ * and no snaps have been installed, removed or changed revision since, the
+ * previous result is returned without asking the store.
+ *
+ * Whether a theme is available from the store can change without anything
+ * changing locally, so results older than snapd_theme_status_cache_set_max_age()
+ * are still returned, but are checked again in the background for next time.
+ *
+ * The cache can be saved with snapd_theme_status_cache_save() and loaded with
+ * snapd_theme_status_cache_load(), so a session helper run at each login only
+ * waits for the store when something has changed.
+ */
+
+/**
+ * SnapdThemeStatusCache:
+ *
+ * #SnapdThemeStatusCache holds the results of theme status checks.
+ *
+ * Since: 1.65
+ */
+
+#define DEFAULT_MAX_AGE (24 * 60 * 60)
+
+/* The result of a check for one set of theme names */
+typedef struct
+{
+    /* Installed snaps when the check was made, and when it was made */
+    gchar *installed;
+    gint64 check_time;
+
+    GHashTable *gtk_theme_status;
+    GHashTable *icon_theme_status;
+    GHashTable *sound_theme_status;
+} CacheEntry;
+
+struct _SnapdThemeStatusCache
+{
+    GObject parent_instance;
+
+    SnapdClient *client;
+
+    /* Results keyed by the theme names checked */
+    GHashTable *entries;
+
+    /* Seconds before a result is checked again in the background, or 0 to never */
+    guint max_age;
+};
+
+G_DEFINE_TYPE (SnapdThemeStatusCache, snapd_theme_status_cache, G_TYPE_OBJECT)
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+    g_free (entry->installed);
+    g_clear_pointer (&entry->gtk_theme_status, g_hash_table_unref);
+    g_clear_pointer (&entry->icon_theme_status, g_hash_table_unref);
+    g_clear_pointer (&entry->sound_theme_status, g_hash_table_unref);
+    g_slice_free (CacheEntry, entry);
+}
+
+static GHashTable *
+new_status_table (void)
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static GHashTable *
+copy_status_table (GHashTable *table)
+{
+    GHashTable *copy = new_status_table ();
+    GHashTableIter iter;
+    gpointer name, status;
+    g_hash_table_iter_init (&iter, table);
+    while (g_hash_table_iter_next (&iter, &name, &status))
+        g_hash_table_insert (copy, g_strdup (name), status);
+    return copy;
+}
+
+static gint
+compare_names (gconstpointer a, gconstpointer b)
+{
+    return strcmp (*((const gchar **) a), *((const gchar **) b));
+}
+
+static void
+append_names (GString *key, const gchar *kind, GStrv names)
+{
+    g_autoptr(GPtrArray) sorted = g_ptr_array_new ();
+    for (gsize i = 0; names != NULL && names[i] != NULL; i++)
+        g_ptr_array_add (sorted, names[i]);
+    g_ptr_array_sort (sorted, compare_names);
+
+    g_string_append_printf (key, "%s:", kind);
+    for (guint i = 0; i < sorted->len; i++)
+        g_string_append_printf (key, "%s%s", i > 0 ? "," : "", (const gchar *) g_ptr_array_index (sorted, i));
+    g_string_append (key, ";");
+}
+
+/* Make a string that is the same for the same theme names in any order */
+static gchar *
+get_names_key (GStrv gtk_theme_names, GStrv icon_theme_names, GStrv sound_theme_names)
+{
+    g_autoptr(GString) key = g_string_new ("");
+    append_names (key, "gtk", gtk_theme_names);
+    append_names (key, "icon", icon_theme_names);
+    append_names (key, "sound", sound_theme_names);
+    return g_string_free (g_steal_pointer (&key), FALSE);
+}
+
+/* Make a string that changes when any snap is installed, removed or changes revision */
+static gchar *
+get_installed_key (GPtrArray *snaps)
+{
+    g_autoptr(GString) key = g_string_new ("");
+    for (guint i = 0; i < snaps->len; i++) {
+        SnapdSnap *snap = g_ptr_array_index (snaps, i);
+        g_string_append_printf (key, "%s=%s;", snapd_snap_get_name (snap), snapd_snap_get_revision (snap));
+    }
+    return g_string_free (g_steal_pointer (&key), FALSE);
+}
+
+typedef struct
+{
+    SnapdThemeStatusCache *cache;
+    GStrv gtk_theme_names;
+    GStrv icon_theme_names;
+    GStrv sound_theme_names;
+    gchar *key;
+    gchar *installed;
+} CheckData;
+
+static void
+check_data_free (CheckData *data)
+{
+    g_object_unref (data->cache);
+    g_strfreev (data->gtk_theme_names);
+    g_strfreev (data->icon_theme_names);
+    g_strfreev (data->sound_theme_names);
+    g_free (data->key);
+    g_free (data->installed);
+    g_slice_free (CheckData, data);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (CheckData, check_data_free)
+
+static void
+return_entry (GTask *task, CacheEntry *entry)
+{
+    CacheEntry *result = g_slice_new0 (CacheEntry);
+    result->gtk_theme_status = copy_status_table (entry->gtk_theme_status);
+    result->icon_theme_status = copy_status_table (entry->icon_theme_status);
+    result->sound_theme_status = copy_status_table (entry->sound_theme_status);
+    g_task_return_pointer (task, result, (GDestroyNotify) cache_entry_free);
+}
+
+/* Record the result of a check so it is used next time these themes are checked */
+static CacheEntry *
+store_result (CheckData *data, GObject *client, GAsyncResult *result, GError **error)
+{
+    g_autoptr(GHashTable) gtk_theme_status = NULL;
+    g_autoptr(GHashTable) icon_theme_status = NULL;
+    g_autoptr(GHashTable) sound_theme_status = NULL;
+    if (!snapd_client_check_themes_finish (SNAPD_CLIENT (client), result, &gtk_theme_status, &icon_theme_status, &sound_theme_status, error))
+        return NULL;
+
+    CacheEntry *entry = g_slice_new0 (CacheEntry);
+    entry->installed = g_steal_pointer (&data->installed);
+    entry->check_time = g_get_real_time ();
+    entry->gtk_theme_status = copy_status_table (gtk_theme_status);
+    entry->icon_theme_status = copy_status_table (icon_theme_status);
+    entry->sound_theme_status = copy_status_table (sound_theme_status);
+    g_hash_table_insert (data->cache->entries, g_steal_pointer (&data->key), entry);
+
+    return entry;
+}
+
+static void
+check_themes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    CheckData *data = g_task_get_task_data (task);
+
+    g_autoptr(GError) error = NULL;
+    CacheEntry *entry = store_result (data, object, result, &error);
+    if (entry == NULL) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+
+    return_entry (task, entry);
+}
+
+static void
+background_check_themes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(CheckData) data = user_data;
+
+    /* The previous result is kept if the check failed */
+    g_autoptr(GError) error = NULL;
+    store_result (data, object, result, &error);
+}
+
+static CheckData *
+copy_check_data (CheckData *data)
+{
+    CheckData *copy = g_slice_new0 (CheckData);
+    copy->cache = g_object_ref (data->cache);
+    copy->gtk_theme_names = g_strdupv (data->gtk_theme_names);
+    copy->icon_theme_names = g_strdupv (data->icon_theme_names);
+    copy->sound_theme_names = g_strdupv (data->sound_theme_names);
+    copy->key = g_strdup (data->key);
+    copy->installed = g_strdup (data->installed);
+    return copy;
+}
+
+static void
+get_snaps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(GTask) task = user_data;
+    CheckData *data = g_task_get_task_data (task);
+    SnapdThemeStatusCache *self = data->cache;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    if (snaps == NULL) {
+        g_task_return_error (task, g_steal_pointer (&error));
+        return;
+    }
+    data->installed = get_installed_key (snaps);
+
+    CacheEntry *entry = g_hash_table_lookup (self->entries, data->key);
+    if (entry != NULL && g_strcmp0 (entry->installed, data->installed) == 0) {
+        return_entry (task, entry);
+
+        /* Catch changes in the store without making the caller wait for them */
+        if (self->max_age > 0 && g_get_real_time () - entry->check_time >= (gint64) self->max_age * G_USEC_PER_SEC)
+            snapd_client_check_themes_async (self->client, data->gtk_theme_names, data->icon_theme_names, data->sound_theme_names,
+                                             NULL, background_check_themes_cb, copy_check_data (data));
+        return;
+    }
+
+    snapd_client_check_themes_async (self->client, data->gtk_theme_names, data->icon_theme_names, data->sound_theme_names,
+                                     g_task_get_cancellable (task), check_themes_cb, g_object_ref (task));
+}
+
+/**
+ * snapd_theme_status_cache_new:
+ * @client: a #SnapdClient to make requests with.
+ *
+ * Create a cache of theme status checks. The cache is empty until
+ * snapd_theme_status_cache_check_async() or snapd_theme_status_cache_load()
+ * is called.
+ *
+ * Returns: a new #SnapdThemeStatusCache
+ *
+ * Since: 1.65
+ */
+SnapdThemeStatusCache *
+snapd_theme_status_cache_new (SnapdClient *client)
+{
+    g_return_val_if_fail (SNAPD_IS_CLIENT (client), NULL);
+
+    SnapdThemeStatusCache *self = g_object_new (SNAPD_TYPE_THEME_STATUS_CACHE, NULL);
+    self->client = g_object_ref (client);
+
+    return self;
+}
+
+static GHashTable *
+load_status_table (GKeyFile *file, const gchar *group, const gchar *names_key, const gchar *status_key)
+{
+    GHashTable *table = new_status_table ();
+
+    gsize n_names = 0, n_statuses = 0;
+    g_auto(GStrv) names = g_key_file_get_string_list (file, group, names_key, &n_names, NULL);
+    g_autofree gint *statuses = g_key_file_get_integer_list (file, group, status_key, &n_statuses, NULL);
+    for (gsize i = 0; i < n_names && i < n_statuses; i++)
+        g_hash_table_insert (table, g_strdup (names[i]), GINT_TO_POINTER (statuses[i]));
+
+    return table;
+}
+
+/**
+ * snapd_theme_status_cache_load:
+ * @cache: a #SnapdThemeStatusCache.
+ * @path: path of a file written by snapd_theme_status_cache_save().
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Add the results stored in a file to the cache.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_theme_status_cache_load (SnapdThemeStatusCache *self, const gchar *path, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    g_autoptr(GKeyFile) file = g_key_file_new ();
+    if (!g_key_file_load_from_file (file, path, G_KEY_FILE_NONE, error))
+        return FALSE;
+
+    g_auto(GStrv) groups = g_key_file_get_groups (file, NULL);
+    for (gsize i = 0; groups[i] != NULL; i++) {
+        g_autofree gchar *key = g_key_file_get_string (file, groups[i], "Themes", NULL);
+        g_autofree gchar *installed = g_key_file_get_string (file, groups[i], "Installed", NULL);
+        if (key == NULL || installed == NULL)
+            continue;
+
+        CacheEntry *entry = g_slice_new0 (CacheEntry);
+        entry->installed = g_steal_pointer (&installed);
+        entry->check_time = g_key_file_get_int64 (file, groups[i], "CheckTime", NULL);
+        entry->gtk_theme_status = load_status_table (file, groups[i], "GtkThemes", "GtkThemeStatus");
+        entry->icon_theme_status = load_status_table (file, groups[i], "IconThemes", "IconThemeStatus");
+        entry->sound_theme_status = load_status_table (file, groups[i], "SoundThemes", "SoundThemeStatus");
+        g_hash_table_insert (self->entries, g_steal_pointer (&key), entry);
+    }
+
+    return TRUE;
+}
+
+static void
+save_status_table (GKeyFile *file, const gchar *group, const gchar *names_key, const gchar *status_key, GHashTable *table)
+{
+    g_autoptr(GPtrArray) names = g_ptr_array_new ();
+    g_autoptr(GArray) statuses = g_array_new (FALSE, FALSE, sizeof (gint));
+    GHashTableIter iter;
+    gpointer name, status;
+    g_hash_table_iter_init (&iter, table);
+    while (g_hash_table_iter_next (&iter, &name, &status)) {
+        gint s = GPOINTER_TO_INT (status);
+        g_ptr_array_add (names, name);
+        g_array_append_val (statuses, s);
+    }
+    g_key_file_set_string_list (file, group, names_key, (const gchar * const *) names->pdata, names->len);
+    g_key_file_set_integer_list (file, group, status_key, (gint *) statuses->data, statuses->len);
+}
+
+/**
+ * snapd_theme_status_cache_save:
+ * @cache: a #SnapdThemeStatusCache.
+ * @path: path of the file to write.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Write the results in the cache to a file, for loading with
+ * snapd_theme_status_cache_load().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_theme_status_cache_save (SnapdThemeStatusCache *self, const gchar *path, GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    g_autoptr(GKeyFile) file = g_key_file_new ();
+    GHashTableIter iter;
+    gpointer key, value;
+    guint n = 0;
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        CacheEntry *entry = value;
+        g_autofree gchar *group = g_strdup_printf ("Check %u", n++);
+        g_key_file_set_string (file, group, "Themes", key);
+        g_key_file_set_string (file, group, "Installed", entry->installed);
+        g_key_file_set_int64 (file, group, "CheckTime", entry->check_time);
+        save_status_table (file, group, "GtkThemes", "GtkThemeStatus", entry->gtk_theme_status);
+        save_status_table (file, group, "IconThemes", "IconThemeStatus", entry->icon_theme_status);
+        save_status_table (file, group, "SoundThemes", "SoundThemeStatus", entry->sound_theme_status);
+    }
+
+    return g_key_file_save_to_file (file, path, error);
+}
+
+/**
+ * snapd_theme_status_cache_set_max_age:
+ * @cache: a #SnapdThemeStatusCache.
+ * @max_age: number of seconds, or 0 to never check in the background.
+ *
+ * Set how old a result can be before it is checked again in the background
+ * when it is used. Defaults to one day.
+ *
+ * Since: 1.65
+ */
+void
+snapd_theme_status_cache_set_max_age (SnapdThemeStatusCache *self, guint max_age)
+{
+    g_return_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self));
+    self->max_age = max_age;
+}
+
+/**
+ * snapd_theme_status_cache_get_max_age:
+ * @cache: a #SnapdThemeStatusCache.
+ *
+ * Get how old a result can be before it is checked again in the background.
+ *
+ * Returns: a number of seconds, or 0 if never checked in the background.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_theme_status_cache_get_max_age (SnapdThemeStatusCache *self)
+{
+    g_return_val_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self), 0);
+    return self->max_age;
+}
+
+/**
+ * snapd_theme_status_cache_check_async:
+ * @cache: a #SnapdThemeStatusCache.
+ * @gtk_theme_names: (allow-none): a list of GTK theme names.
+ * @icon_theme_names: (allow-none): a list of icon theme names.
+ * @sound_theme_names: (allow-none): a list of sound theme names.
+ * @cancellable: (allow-none): a #GCancellable or %NULL.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the request is satisfied.
+ * @user_data: (closure): the data to pass to callback function.
+ *
+ * Asynchronously check the status of snap packaged themes, as with
+ * snapd_client_check_themes_async(), using the cached result if no snaps
+ * have changed since it was made.
+ *
+ * Since: 1.65
+ */
+void
+snapd_theme_status_cache_check_async (SnapdThemeStatusCache *self,
+                                      GStrv gtk_theme_names, GStrv icon_theme_names, GStrv sound_theme_names,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    g_return_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self));
+
+    g_autoptr(GTask) task = g_task_new (self, cancellable, callback, user_data);
+    CheckData *data = g_slice_new0 (CheckData);
+    data->cache = g_object_ref (self);
+    data->gtk_theme_names = g_strdupv (gtk_theme_names);
+    data->icon_theme_names = g_strdupv (icon_theme_names);
+    data->sound_theme_names = g_strdupv (sound_theme_names);
+    data->key = get_names_key (gtk_theme_names, icon_theme_names, sound_theme_names);
+    g_task_set_task_data (task, data, (GDestroyNotify) check_data_free);
+
+    snapd_client_get_snaps_async (self->client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, cancellable, get_snaps_cb, g_object_ref (task));
+}
+
+/**
+ * snapd_theme_status_cache_check_finish:
+ * @cache: a #SnapdThemeStatusCache.
+ * @result: a #GAsyncResult.
+ * @gtk_theme_status: (out) (transfer container) (element-type utf8 SnapdThemeStatus): status of GTK themes.
+ * @icon_theme_status: (out) (transfer container) (element-type utf8 SnapdThemeStatus): status of icon themes.
+ * @sound_theme_status: (out) (transfer container) (element-type utf8 SnapdThemeStatus): status of sound themes.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL to ignore.
+ *
+ * Complete request started with snapd_theme_status_cache_check_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.65
+ */
+gboolean
+snapd_theme_status_cache_check_finish (SnapdThemeStatusCache *self, GAsyncResult *result,
+                                       GHashTable **gtk_theme_status, GHashTable **icon_theme_status, GHashTable **sound_theme_status,
+                                       GError **error)
+{
+    g_return_val_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self), FALSE);
+    g_return_val_if_fail (g_task_is_valid (result, self), FALSE);
+
+    CacheEntry *entry = g_task_propagate_pointer (G_TASK (result), error);
+    if (entry == NULL)
+        return FALSE;
+
+    if (gtk_theme_status != NULL)
+        *gtk_theme_status = g_steal_pointer (&entry->gtk_theme_status);
+    if (icon_theme_status != NULL)
+        *icon_theme_status = g_steal_pointer (&entry->icon_theme_status);
+    if (sound_theme_status != NULL)
+        *sound_theme_status = g_steal_pointer (&entry->sound_theme_status);
+    cache_entry_free (entry);
+
+    return TRUE;
+}
+
+/**
+ * snapd_theme_status_cache_invalidate:
+ * @cache: a #SnapdThemeStatusCache.
+ *
+ * Drop all the cached results, so the next call to
+ * snapd_theme_status_cache_check_async() asks the store again.
+ *
+ * Since: 1.65
+ */
+void
+snapd_theme_status_cache_invalidate (SnapdThemeStatusCache *self)
+{
+    g_return_if_fail (SNAPD_IS_THEME_STATUS_CACHE (self));
+    g_hash_table_remove_all (self->entries);
+}
+
+static void
+snapd_theme_status_cache_finalize (GObject *object)
+{
+    SnapdThemeStatusCache *self = SNAPD_THEME_STATUS_CACHE (object);
+
+    g_clear_object (&self->client);
+    g_clear_pointer (&self->entries, g_hash_table_unref);
+
+    G_OBJECT_CLASS (snapd_theme_status_cache_parent_class)->finalize (object);
+}
+
+static void
+snapd_theme_status_cache_class_init (SnapdThemeStatusCacheClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->finalize = snapd_theme_status_cache_finalize;
+}
+
+static void
+snapd_theme_status_cache_init (SnapdThemeStatusCache *self)
+{
+    self->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) cache_entry_free);
+    self->max_age = DEFAULT_MAX_AGE;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_THEME_STATUS_CACHE_H__
+#define __SNAPD_THEME_STATUS_CACHE_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <snapd-glib/snapd-client.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_THEME_STATUS_CACHE  (snapd_theme_status_cache_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdThemeStatusCache, snapd_theme_status_cache, SNAPD, THEME_STATUS_CACHE, GObject)
+
+SnapdThemeStatusCache *snapd_theme_status_cache_new          (SnapdClient           *client);
+
+gboolean               snapd_theme_status_cache_load         (SnapdThemeStatusCache *cache,
+                                                              const gchar           *path,
+                                                              GError               **error);
+
+gboolean               snapd_theme_status_cache_save         (SnapdThemeStatusCache *cache,
+                                                              const gchar           *path,
+                                                              GError               **error);
+
+void                   snapd_theme_status_cache_set_max_age  (SnapdThemeStatusCache *cache,
+                                                              guint                  max_age);
+
+guint                  snapd_theme_status_cache_get_max_age  (SnapdThemeStatusCache *cache);
+
+void                   snapd_theme_status_cache_check_async  (SnapdThemeStatusCache *cache,
+                                                              GStrv                  gtk_theme_names,
+                                                              GStrv                  icon_theme_names,
+                                                              GStrv                  sound_theme_names,
+                                                              GCancellable          *cancellable,
+                                                              GAsyncReadyCallback    callback,
+                                                              gpointer               user_data);
+gboolean               snapd_theme_status_cache_check_finish (SnapdThemeStatusCache *cache,
+                                                              GAsyncResult          *result,
+                                                              GHashTable           **gtk_theme_status,
+                                                              GHashTable           **icon_theme_status,
+                                                              GHashTable           **sound_theme_status,
+                                                              GError               **error);
+
+void                   snapd_theme_status_cache_invalidate   (SnapdThemeStatusCache *cache);
+
+G_END_DECLS
+
+#endif /* __SNAPD_THEME_STATUS_CACHE_H__ */
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-timestamp.h"
+
+/* Time zones keyed by UTC offset in seconds.
+ * Only a few offsets are used, so this saves constructing one for every date */
+static GMutex timezones_mutex;
+static GHashTable *timezones = NULL;
+
+static GTimeZone *
+timezone_new (const gchar *identifier)
+{
+#ifdef GLIB_VERSION_2_68
+    GTimeZone *timezone = g_time_zone_new_identifier (identifier);
+    if (timezone == NULL)
+        timezone = g_time_zone_new_utc ();
+    return timezone;
+#else
+    return g_time_zone_new (identifier);
+#endif
+}
+
+GTimeZone *
+_snapd_get_timezone (gint32 utc_offset)
+{
+    if (utc_offset == 0)
+        return g_time_zone_new_utc ();
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&timezones_mutex);
+    if (timezones == NULL)
+        timezones = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_time_zone_unref);
+    GTimeZone *timezone = g_hash_table_lookup (timezones, GINT_TO_POINTER (utc_offset));
+    if (timezone == NULL) {
+        g_autofree gchar *identifier = g_strdup_printf ("%c%02d:%02d", utc_offset < 0 ? '-' : '+',
+                                                        ABS (utc_offset) / 3600, (ABS (utc_offset) / 60) % 60);
+        timezone = timezone_new (identifier);
+        g_hash_table_insert (timezones, GINT_TO_POINTER (utc_offset), timezone);
+    }
+
+    return g_time_zone_ref (timezone);
+}
+
+GDateTime *
+_snapd_date_time_new (gint64 time, gint32 utc_offset)
+{
+    gint64 seconds = time / G_USEC_PER_SEC, microseconds = time % G_USEC_PER_SEC;
+    if (microseconds < 0) {
+        seconds--;
+        microseconds += G_USEC_PER_SEC;
+    }
+    g_autoptr(GDateTime) utc_time = g_date_time_new_from_unix_utc (seconds);
+    if (utc_time == NULL)
+        return NULL;
+    g_autoptr(GDateTime) date_time = g_date_time_add (utc_time, microseconds);
+    if (date_time == NULL || utc_offset == 0)
+        return g_steal_pointer (&date_time);
+    g_autoptr(GTimeZone) timezone = _snapd_get_timezone (utc_offset);
+    return g_date_time_to_timezone (date_time, timezone);
+}
+
+void
+_snapd_timestamp_set (SnapdTimestamp *timestamp, gint64 time, gint32 utc_offset)
+{
+    _snapd_timestamp_clear (timestamp);
+    timestamp->time = time;
+    timestamp->utc_offset = utc_offset;
+    timestamp->is_set = TRUE;
+}
+
+void
+_snapd_timestamp_set_date_time (SnapdTimestamp *timestamp, GDateTime *date_time)
+{
+    _snapd_timestamp_clear (timestamp);
+    if (date_time == NULL)
+        return;
+
+    _snapd_timestamp_set (timestamp,
+                          g_date_time_to_unix (date_time) * G_USEC_PER_SEC + g_date_time_get_microsecond (date_time),
+                          g_date_time_get_utc_offset (date_time) / G_USEC_PER_SEC);
+    timestamp->date_time = g_date_time_ref (date_time);
+}
+
+/* Read a decimal number, returning the remaining string or %NULL if there are no digits */
+static const gchar *
+parse_number (const gchar *text, gint *value)
+{
+    if (!g_ascii_isdigit (*text))
+        return NULL;
+
+    gint v = 0;
+    while (g_ascii_isdigit (*text)) {
+        if (v < G_MAXINT / 10)
+            v = v * 10 + (*text - '0');
+        text++;
+    }
+    *value = v;
+
+    return text;
+}
+
+static gboolean
+is_timezone_prefix (gchar c)
+{
+    return c == '+' || c == '-' || c == 'Z';
+}
+
+/* Days from 1970-01-01 to the given date in the proleptic Gregorian calendar */
+static gint64
+days_from_civil (gint year, gint month, gint day)
+{
+    year -= month <= 2 ? 1 : 0;
+    gint64 era = (year >= 0 ? year : year - 399) / 400;
+    gint64 year_of_era = year - era * 400;
+    gint64 day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    gint64 day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+/* Get the UTC offset in seconds from Z, +hh:mm or -hh:mm */
+static gboolean
+parse_utc_offset (const gchar *text, gint32 *utc_offset)
+{
+    if (text[0] == 'Z' && text[1] == '\0') {
+        *utc_offset = 0;
+        return TRUE;
+    }
+
+    gint hours = 0, minutes = 0;
+    const gchar *c = parse_number (text + 1, &hours);
+    if (c != NULL && *c == ':')
+        c = parse_number (c + 1, &minutes);
+    if (c == NULL || *c != '\0' || hours > 24 || minutes > 59)
+        return FALSE;
+
+    *utc_offset = (hours * 3600 + minutes * 60) * (text[0] == '-' ? -1 : 1);
+    return TRUE;
+}
+
+/* Parse a time in the format snapd uses, e.g. 2016-05-17T09:36:53.682+12:00 */
+gboolean
+_snapd_timestamp_parse (SnapdTimestamp *timestamp, const gchar *value)
+{
+    _snapd_timestamp_clear (timestamp);
+
+    gint year = 0, month = 0, day = 0;
+    const gchar *c = parse_number (value, &year);
+    if (c == NULL || *c != '-')
+        return FALSE;
+    c = parse_number (c + 1, &month);
+    if (c == NULL || *c != '-')
+        return FALSE;
+    c = parse_number (c + 1, &day);
+    if (c == NULL)
+        return FALSE;
+
+    const gchar *timezone_identifier = NULL;
+    gint hour = 0, minute = 0;
+    gdouble seconds = 0.0;
+    if (*c == 'T') {
+        /* Example: 09:36:53.682 or 09:36:53 or 09:36 */
+        c = parse_number (c + 1, &hour);
+        if (c == NULL || *c != ':')
+            return FALSE;
+        c = parse_number (c + 1, &minute);
+        if (c == NULL)
+            return FALSE;
+        if (*c == ':') {
+            gchar *end;
+            seconds = g_ascii_strtod (c + 1, &end);
+            c = end;
+        }
+
+        while (*c != '\0' && !is_timezone_prefix (*c))
+            c++;
+        if (*c != '\0')
+            timezone_identifier = c;
+    }
+
+    /* Same limits as g_date_time_new () */
+    if (year < 1 || year > 9999 || month < 1 || month > 12 || day < 1 || day > 31 || !g_date_valid_dmy (day, month, year) ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || !(seconds >= 0.0 && seconds < 60.0))
+        return FALSE;
+
+    /* Fall back to GLib for local times and time zones other than offsets */
+    gint32 utc_offset;
+    if (timezone_identifier == NULL || !parse_utc_offset (timezone_identifier, &utc_offset)) {
+        g_autoptr(GTimeZone) timezone = timezone_identifier != NULL ? timezone_new (timezone_identifier) : g_time_zone_new_local ();
+        g_autoptr(GDateTime) date_time = g_date_time_new (timezone, year, month, day, hour, minute, seconds);
+        if (date_time == NULL)
+            return FALSE;
+        _snapd_timestamp_set_date_time (timestamp, date_time);
+        return TRUE;
+    }
+
+    /* Round in the same way as g_date_time_new () */
+    gint64 microseconds = seconds * G_USEC_PER_SEC;
+    if ((microseconds + 1) * 1e-6 <= seconds)
+        microseconds++;
+
+    gint64 local_seconds = days_from_civil (year, month, day) * 86400 + hour * 3600 + minute * 60;
+    _snapd_timestamp_set (timestamp, (local_seconds - utc_offset) * G_USEC_PER_SEC + microseconds, utc_offset);
+    return TRUE;
+}
+
+/* Get the time as a #GDateTime, creating it on first use. This may be called from multiple threads */
+GDateTime *
+_snapd_timestamp_get_date_time (SnapdTimestamp *timestamp)
+{
+    if (!timestamp->is_set)
+        return NULL;
+
+    GDateTime *date_time = g_atomic_pointer_get (&timestamp->date_time);
+    if (date_time != NULL)
+        return date_time;
+
+    date_time = _snapd_date_time_new (timestamp->time, timestamp->utc_offset);
+    if (!g_atomic_pointer_compare_and_exchange (&timestamp->date_time, NULL, date_time))
+        g_clear_pointer (&date_time, g_date_time_unref);
+
+    return g_atomic_pointer_get (&timestamp->date_time);
+}
+
+gint64
+_snapd_timestamp_get_time (const SnapdTimestamp *timestamp)
+{
+    return timestamp->is_set ? timestamp->time : 0;
+}
+
+/* Times are equal if they are the same instant, as with g_date_time_equal () */
+gboolean
+_snapd_timestamp_equal (const SnapdTimestamp *timestamp1, const SnapdTimestamp *timestamp2)
+{
+    if (!timestamp1->is_set || !timestamp2->is_set)
+        return timestamp1->is_set == timestamp2->is_set;
+    return timestamp1->time == timestamp2->time;
+}
+
+void
+_snapd_timestamp_clear (SnapdTimestamp *timestamp)
+{
+    g_clear_pointer (&timestamp->date_time, g_date_time_unref);
+    timestamp->time = 0;
+    timestamp->utc_offset = 0;
+    timestamp->is_set = FALSE;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_TIMESTAMP_H__
+#define __SNAPD_TIMESTAMP_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* A date and time as microseconds since the epoch and UTC offset in seconds.
+ * The #GDateTime returned by the object getters is only created when first requested */
+typedef struct
+{
+    gint64 time;
+    gint32 utc_offset;
+    gboolean is_set;
+    GDateTime *date_time;
+} SnapdTimestamp;
+
+void       _snapd_timestamp_set           (SnapdTimestamp       *timestamp,
+                                           gint64                time,
+                                           gint32                utc_offset);
+
+void       _snapd_timestamp_set_date_time (SnapdTimestamp       *timestamp,
+                                           GDateTime            *date_time);
+
+gboolean   _snapd_timestamp_parse         (SnapdTimestamp       *timestamp,
+                                           const gchar          *value);
+
+GDateTime *_snapd_timestamp_get_date_time (SnapdTimestamp       *timestamp);
+
+gint64     _snapd_timestamp_get_time      (const SnapdTimestamp *timestamp);
+
+gboolean   _snapd_timestamp_equal         (const SnapdTimestamp *timestamp1,
+                                           const SnapdTimestamp *timestamp2);
+
+void       _snapd_timestamp_clear         (SnapdTimestamp       *timestamp);
+
+GTimeZone *_snapd_get_timezone            (gint32                utc_offset);
+
+GDateTime *_snapd_date_time_new           (gint64                time,
+                                           gint32                utc_offset);
+
+G_END_DECLS
+
+#endif /* __SNAPD_TIMESTAMP_H__ */
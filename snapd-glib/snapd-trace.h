@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_TRACE_H__
+#define __SNAPD_TRACE_H__
+
+/* Static probes in the request lifecycle, for use with perf, bpftrace and SystemTap, e.g.
+ *   bpftrace -e 'usdt:libsnapd-glib.so:snapd_glib:request__write { printf ("%s %s\n", str (arg1), str (arg2)); }'
+ * Probes are only compiled in when built with -Ddtrace=true, and are a no-op unless a tracer is attached */
+
+#ifdef HAVE_SYS_SDT_H
+
+#include <sys/sdt.h>
+
+#define SNAPD_TRACE1(name, a)          DTRACE_PROBE1 (snapd_glib, name, a)
+#define SNAPD_TRACE2(name, a, b)       DTRACE_PROBE2 (snapd_glib, name, a, b)
+#define SNAPD_TRACE3(name, a, b, c)    DTRACE_PROBE3 (snapd_glib, name, a, b, c)
+#define SNAPD_TRACE4(name, a, b, c, d) DTRACE_PROBE4 (snapd_glib, name, a, b, c, d)
+
+#else
+
+#define SNAPD_TRACE1(name, a)
+#define SNAPD_TRACE2(name, a, b)
+#define SNAPD_TRACE3(name, a, b, c)
+#define SNAPD_TRACE4(name, a, b, c, d)
+
+#endif
+
+#endif /* __SNAPD_TRACE_H__ */
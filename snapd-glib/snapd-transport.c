@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include "snapd-transport-private.h"
+
+/**
+ * SECTION: snapd-transport
+ * @short_description: Connections to snapd shared between clients
+ * @include: snapd-glib/snapd-glib.h
+ *
+ * A #SnapdTransport holds connections to snapd that any number of
+ * #SnapdClient objects can send their requests on, set with
+ * snapd_client_set_transport(). A service that uses a client for each user
+ * it acts for then has the same number of sockets open and the same number of
+ * wakeups no matter how many clients it has.
+ *
+ * Each client still sends its own authorization, user agent and
+ * X-Allow-Interaction header, sends requests with its own retry, timeout,
+ * polling and progress settings, and keeps its own response caches and request
+ * statistics. The socket path and connections are those of the transport, see
+ * snapd_client_set_transport() for the client settings this replaces.
+ */
+
+/**
+ * SnapdTransport:
+ *
+ * #SnapdTransport holds connections to snapd shared between clients.
+ *
+ * Since: 1.65
+ */
+
+struct _SnapdTransport
+{
+    GObject parent_instance;
+
+    /* Client that owns the connections and writes requests from every client using this transport */
+    SnapdClient *client;
+};
+
+G_DEFINE_TYPE (SnapdTransport, snapd_transport, G_TYPE_OBJECT)
+
+SnapdClient *
+_snapd_transport_get_client (SnapdTransport *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TRANSPORT (self), NULL);
+    return self->client;
+}
+
+/**
+ * snapd_transport_new:
+ *
+ * Create a new transport to share between clients with
+ * snapd_client_set_transport().
+ *
+ * Returns: a new #SnapdTransport
+ *
+ * Since: 1.65
+ */
+SnapdTransport *
+snapd_transport_new (void)
+{
+    return g_object_new (SNAPD_TYPE_TRANSPORT, NULL);
+}
+
+/**
+ * snapd_transport_set_socket_path:
+ * @transport: a #SnapdTransport.
+ * @socket_path: (allow-none): a socket path or %NULL to reset to the default.
+ *
+ * Set the Unix socket path to connect to snapd with.
+ * See snapd_client_set_socket_path() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_transport_set_socket_path (SnapdTransport *self, const gchar *socket_path)
+{
+    g_return_if_fail (SNAPD_IS_TRANSPORT (self));
+    snapd_client_set_socket_path (self->client, socket_path);
+}
+
+/**
+ * snapd_transport_get_socket_path:
+ * @transport: a #SnapdTransport.
+ *
+ * Get the Unix socket path to connect to snapd with.
+ *
+ * Returns: socket path.
+ *
+ * Since: 1.65
+ */
+const gchar *
+snapd_transport_get_socket_path (SnapdTransport *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TRANSPORT (self), NULL);
+    return snapd_client_get_socket_path (self->client);
+}
+
+/**
+ * snapd_transport_set_max_connections:
+ * @transport: a #SnapdTransport.
+ * @max_connections: maximum number of connections to snapd or 0 for the default.
+ *
+ * Set the maximum number of connections the clients using this transport
+ * share. See snapd_client_set_max_connections() for more information.
+ *
+ * Since: 1.65
+ */
+void
+snapd_transport_set_max_connections (SnapdTransport *self, guint max_connections)
+{
+    g_return_if_fail (SNAPD_IS_TRANSPORT (self));
+    snapd_client_set_max_connections (self->client, max_connections);
+}
+
+/**
+ * snapd_transport_get_max_connections:
+ * @transport: a #SnapdTransport.
+ *
+ * Get the maximum number of connections the clients using this transport
+ * share.
+ *
+ * Returns: maximum number of connections.
+ *
+ * Since: 1.65
+ */
+guint
+snapd_transport_get_max_connections (SnapdTransport *self)
+{
+    g_return_val_if_fail (SNAPD_IS_TRANSPORT (self), 0);
+    return snapd_client_get_max_connections (self->client);
+}
+
+static void
+snapd_transport_dispose (GObject *object)
+{
+    SnapdTransport *self = SNAPD_TRANSPORT (object);
+
+    g_clear_object (&self->client);
+
+    G_OBJECT_CLASS (snapd_transport_parent_class)->dispose (object);
+}
+
+static void
+snapd_transport_class_init (SnapdTransportClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+    gobject_class->dispose = snapd_transport_dispose;
+}
+
+static void
+snapd_transport_init (SnapdTransport *self)
+{
+    self->client = snapd_client_new ();
+}
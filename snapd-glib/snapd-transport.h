@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef __SNAPD_TRANSPORT_H__
+#define __SNAPD_TRANSPORT_H__
+
+#if !defined(__SNAPD_GLIB_INSIDE__) && !defined(SNAPD_COMPILATION)
+#error "Only <snapd-glib/snapd-glib.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define SNAPD_TYPE_TRANSPORT  (snapd_transport_get_type ())
+
+G_DECLARE_FINAL_TYPE (SnapdTransport, snapd_transport, SNAPD, TRANSPORT, GObject)
+
+SnapdTransport *snapd_transport_new                 (void);
+
+void            snapd_transport_set_socket_path     (SnapdTransport *transport,
+                                                     const gchar    *socket_path);
+
+const gchar    *snapd_transport_get_socket_path     (SnapdTransport *transport);
+
+void            snapd_transport_set_max_connections (SnapdTransport *transport,
+                                                     guint           max_connections);
+
+guint           snapd_transport_get_max_connections (SnapdTransport *transport);
+
+G_END_DECLS
+
+#endif /* __SNAPD_TRANSPORT_H__ */
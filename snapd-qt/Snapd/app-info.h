@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_APP_INFO_H
+#define SNAPD_APP_INFO_H
+
+#include <QtCore/QString>
+#include <QtCore/QTypeInfo>
+#include <Snapd/App>
+
+// Implicitly shared value version of QSnapdApp, for storing many apps without a QObject each
+class Q_DECL_EXPORT QSnapdAppInfo
+{
+public:
+    QSnapdAppInfo ();
+    explicit QSnapdAppInfo (void* snapd_object);
+    QSnapdAppInfo (const QSnapdAppInfo& other);
+    QSnapdAppInfo (QSnapdAppInfo&& other) noexcept;
+    ~QSnapdAppInfo ();
+    QSnapdAppInfo& operator= (const QSnapdAppInfo& other);
+    QSnapdAppInfo& operator= (QSnapdAppInfo&& other) noexcept;
+
+    bool isNull () const;
+    QSnapdApp *toObject (QObject* parent = 0) const;
+
+    QString name () const;
+    bool active () const;
+    QString commonId () const;
+    QString desktopFile () const;
+    bool enabled () const;
+    QString snap () const;
+
+private:
+    void *snapd_object;
+};
+
+Q_DECLARE_TYPEINFO (QSnapdAppInfo, Q_MOVABLE_TYPE);
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_APP_LIST_MODEL_H
+#define SNAPD_APP_LIST_MODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QVector>
+#include <Snapd/AppInfo>
+#include <Snapd/Client>
+
+// List of apps for use in views.
+class Q_DECL_EXPORT QSnapdAppListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        SnapRole,
+        CommonIdRole,
+        DesktopFileRole,
+        ActiveRole,
+        EnabledRole
+    };
+    Q_ENUM(Roles)
+
+    explicit QSnapdAppListModel (QObject* parent = 0);
+
+    int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+    QVariant data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames () const override;
+
+    int count () const;
+    void setApps (const QVector<QSnapdAppInfo> &apps);
+    Q_INVOKABLE void setApps (QSnapdGetAppsRequest *request);
+    QSnapdAppInfo appInfo (int row) const;
+    Q_INVOKABLE void clear ();
+
+Q_SIGNALS:
+    void countChanged ();
+
+private:
+    QVector<QSnapdAppInfo> apps;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_BYTES_H
+#define SNAPD_BYTES_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QTypeInfo>
+
+// Implicitly shared reference to data received from snapd, which keeps the data alive without copying it.
+// QByteArray can't own memory it didn't allocate, so data() is only valid while a QSnapdBytes referring to it exists
+class Q_DECL_EXPORT QSnapdBytes
+{
+public:
+    QSnapdBytes ();
+    explicit QSnapdBytes (void* bytes);
+    QSnapdBytes (const QSnapdBytes& other);
+    QSnapdBytes (QSnapdBytes&& other) noexcept;
+    ~QSnapdBytes ();
+    QSnapdBytes& operator= (const QSnapdBytes& other);
+    QSnapdBytes& operator= (QSnapdBytes&& other) noexcept;
+
+    bool isNull () const;
+    int size () const;
+    const char *constData () const;
+
+    // Array using the data in place, valid while this object or a copy of it exists
+    QByteArray data () const;
+
+    // Array with its own copy of the data
+    QByteArray toByteArray () const;
+
+private:
+    void *bytes;
+};
+
+Q_DECLARE_TYPEINFO (QSnapdBytes, Q_MOVABLE_TYPE);
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CHANGE_LIST_MODEL_H
+#define SNAPD_CHANGE_LIST_MODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QVector>
+#include <Snapd/Change>
+#include <Snapd/Client>
+
+// List of changes for use in views.
+// Calling setChanges() again updates the existing rows by change ID, so progress can be
+// shown by polling getChanges().
+class Q_DECL_EXPORT QSnapdChangeListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles
+    {
+        IdRole = Qt::UserRole + 1,
+        KindRole,
+        SummaryRole,
+        StatusRole,
+        ReadyRole,
+        TaskCountRole,
+        SpawnTimeRole,
+        ReadyTimeRole,
+        ErrorRole
+    };
+    Q_ENUM(Roles)
+
+    explicit QSnapdChangeListModel (QObject* parent = 0);
+
+    int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+    QVariant data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames () const override;
+
+    int count () const;
+    Q_INVOKABLE void setChanges (QSnapdGetChangesRequest *request);
+    Q_INVOKABLE QSnapdChange *change (int row) const;
+    Q_INVOKABLE void clear ();
+
+Q_SIGNALS:
+    void countChanged ();
+
+private:
+    QVector<QSnapdChange *> changes;
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CHANNEL_INFO_H
+#define SNAPD_CHANNEL_INFO_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <QtCore/QTypeInfo>
+#include <Snapd/Channel>
+
+// Implicitly shared value version of QSnapdChannel, for storing many channels without a QObject each
+class Q_DECL_EXPORT QSnapdChannelInfo
+{
+public:
+    QSnapdChannelInfo ();
+    explicit QSnapdChannelInfo (void* snapd_object);
+    QSnapdChannelInfo (const QSnapdChannelInfo& other);
+    QSnapdChannelInfo (QSnapdChannelInfo&& other) noexcept;
+    ~QSnapdChannelInfo ();
+    QSnapdChannelInfo& operator= (const QSnapdChannelInfo& other);
+    QSnapdChannelInfo& operator= (QSnapdChannelInfo&& other) noexcept;
+
+    bool isNull () const;
+    QSnapdChannel *toObject (QObject* parent = 0) const;
+
+    QString branch () const;
+    QSnapdEnums::SnapConfinement confinement () const;
+    QString epoch () const;
+    QString name () const;
+    QDateTime releasedAt () const;
+    QString revision () const;
+    QString risk () const;
+    qint64 size () const;
+    QString track () const;
+    QString version () const;
+
+private:
+    void *snapd_object;
+};
+
+Q_DECLARE_TYPEINFO (QSnapdChannelInfo, Q_MOVABLE_TYPE);
+
+#endif
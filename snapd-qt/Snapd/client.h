@@ -15,15 +15,20 @@
 #include <QIODevice>
 #include <QLocalSocket>
 #include <Snapd/Alias>
+#include <Snapd/AppInfo>
 #include <Snapd/AuthData>
+#include <Snapd/Bytes>
+#include <Snapd/ConfigValue>
 #include <Snapd/Connection>
 #include <Snapd/Icon>
 #include <Snapd/Interface>
 #include <Snapd/Maintenance>
 #include <Snapd/Plug>
 #include <Snapd/Request>
+#include <Snapd/Result>
 #include <Snapd/Slot>
 #include <Snapd/Snap>
+#include <Snapd/SnapInfo>
 #include <Snapd/SystemInformation>
 #include <Snapd/UserInformation>
 
@@ -190,6 +195,7 @@ public:
     virtual void runAsync ();
     Q_INVOKABLE int snapCount () const;
     Q_INVOKABLE QSnapdSnap *snap (int) const;
+    QVector<QSnapdSnapInfo> snapInfos () const;
     void handleResult (void *, void *);
 
 private:
@@ -244,6 +250,9 @@ public:
     virtual void runSync ();
     virtual void runAsync ();
     Q_INVOKABLE QHash<QString, QVariant> *configuration () const;
+    Q_INVOKABLE QStringList keys () const;
+    Q_INVOKABLE QVariant value (const QString &key) const;
+    QSnapdConfigValue configValue (const QString &key) const;
     void handleResult (void *, void *);
 
 private:
@@ -282,6 +291,7 @@ public:
     virtual void runAsync ();
     Q_INVOKABLE int appCount () const;
     Q_INVOKABLE QSnapdApp *app (int) const;
+    QVector<QSnapdAppInfo> appInfos () const;
     void handleResult (void *, void *);
 
 private:
@@ -296,6 +306,7 @@ class Q_DECL_EXPORT QSnapdGetIconRequest : public QSnapdRequest
 
 public:
     explicit QSnapdGetIconRequest (const QString& name, void *snapd_client, QObject *parent = 0);
+    explicit QSnapdGetIconRequest (const QString& name, const QString& revision, void *snapd_client, QObject *parent = 0);
     ~QSnapdGetIconRequest ();
     virtual void runSync ();
     virtual void runAsync ();
@@ -461,6 +472,7 @@ public:
     virtual void runAsync ();
     Q_INVOKABLE int snapCount () const;
     Q_INVOKABLE QSnapdSnap *snap (int) const;
+    QVector<QSnapdSnapInfo> snapInfos () const;
     const QString suggestedCurrency () const;
     void handleResult (void *, void *);
 
@@ -888,11 +900,16 @@ class Q_DECL_EXPORT QSnapdDownloadRequest : public QSnapdRequest
 
 public:
     explicit QSnapdDownloadRequest (const QString& name, const QString& channel, const QString& revision, void *snapd_client, QObject *parent = 0);
+    explicit QSnapdDownloadRequest (const QString& name, const QString& channel, const QString& revision, QIODevice *ioDevice, void *snapd_client, QObject *parent = 0);
     ~QSnapdDownloadRequest ();
     virtual void runSync ();
     virtual void runAsync ();
     Q_INVOKABLE QByteArray data () const;
+    QSnapdBytes bytes () const;
+    Q_INVOKABLE qint64 bytesDownloaded () const;
+    Q_INVOKABLE qint64 totalBytes () const;
     void handleResult (void *, void *);
+    void handleDownloadProgress (qint64, qint64);
 
 private:
     QScopedPointer<QSnapdDownloadRequestPrivate> d_ptr;
@@ -1020,6 +1037,11 @@ public:
     explicit QSnapdClient (QObject* parent=0);
     explicit QSnapdClient (int fd, QObject* parent=0);
     virtual ~QSnapdClient ();
+
+    // A client shared by the whole process, which requests can be made with from any thread.
+    // It communicates with snapd from its own thread, results are returned to the thread the request was made from.
+    // Settings such as the socket path should only be changed before requests are made.
+    static QSnapdClient *shared ();
     Q_INVOKABLE Q_DECL_DEPRECATED QSnapdConnectRequest *connect ();
     Q_INVOKABLE QSnapdLoginRequest *login (const QString& email, const QString& password);
     Q_INVOKABLE QSnapdLoginRequest *login (const QString& email, const QString& password, const QString& otp);
@@ -1030,6 +1052,11 @@ public:
     Q_INVOKABLE QString userAgent () const;
     Q_INVOKABLE void setAllowInteraction (bool allowInteraction);
     Q_INVOKABLE bool allowInteraction () const;
+    Q_INVOKABLE void setIconCachePath (const QString &path);
+    Q_INVOKABLE QString iconCachePath () const;
+    Q_INVOKABLE void setUseIconCache (bool useIconCache);
+    Q_INVOKABLE void setUseIOThread (bool useIOThread);
+    Q_INVOKABLE bool useIOThread () const;
     Q_INVOKABLE QSnapdMaintenance *maintenance () const;
     Q_INVOKABLE void setAuthData (QSnapdAuthData *authData);
     Q_INVOKABLE QSnapdAuthData *authData ();
@@ -1058,6 +1085,7 @@ public:
     Q_INVOKABLE QSnapdGetAppsRequest *getApps (const QStringList &snaps);
     Q_INVOKABLE QSnapdGetAppsRequest *getApps (const QString &snap);
     Q_INVOKABLE QSnapdGetIconRequest *getIcon (const QString &name);
+    Q_INVOKABLE QSnapdGetIconRequest *getIcon (const QString &name, const QString &revision);
     Q_INVOKABLE QSnapdGetAssertionsRequest *getAssertions (const QString &type);
     Q_INVOKABLE QSnapdAddAssertionsRequest *addAssertions (const QStringList &assertions);
     Q_INVOKABLE QSnapdGetConnectionsRequest *getConnections ();
@@ -1112,9 +1140,17 @@ public:
     Q_INVOKABLE QSnapdRunSnapCtlRequest *runSnapCtl (const QString contextId, const QStringList &args);
     Q_INVOKABLE QSnapdDownloadRequest *download (const QString &name);
     Q_INVOKABLE QSnapdDownloadRequest *download (const QString &name, const QString &channel, const QString &revision);
+    Q_INVOKABLE QSnapdDownloadRequest *download (const QString &name, const QString &channel, const QString &revision, QIODevice *ioDevice);
     Q_INVOKABLE QSnapdCheckThemesRequest *checkThemes (const QStringList& gtkThemeNames, const QStringList& iconThemeNames, const QStringList& soundThemeNames);
     Q_INVOKABLE QSnapdInstallThemesRequest *installThemes (const QStringList& gtkThemeNames, const QStringList& iconThemeNames, const QStringList& soundThemeNames);
 
+    // Start requests without creating a QSnapdRequest, for combining many requests.
+    // Results are reported in the event loop of the thread the request was made from.
+    QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> getSnapsAsync (GetSnapsFlags flags = GetSnapsFlags (), const QStringList &snaps = QStringList ());
+    QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> findAsync (FindFlags flags, const QString &query);
+    QFuture<QSnapdResult<QVector<QSnapdAppInfo>>> getAppsAsync (GetAppsFlags flags = GetAppsFlags (), const QStringList &snaps = QStringList ());
+    QFuture<QSnapdResult<QByteArray>> getIconAsync (const QString &name, const QString &revision = QString ());
+
 private:
     QScopedPointer<QSnapdClientPrivate> d_ptr;
     Q_DECLARE_PRIVATE(QSnapdClient)
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_CONFIG_VALUE_H
+#define SNAPD_CONFIG_VALUE_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTypeInfo>
+#include <QtCore/QVariant>
+
+// Read-only view of a snap configuration value.
+// Child values are only converted when accessed, so a single key can be read from a large configuration cheaply.
+// Use toVariant() to convert the whole value.
+class Q_DECL_EXPORT QSnapdConfigValue
+{
+public:
+    enum Type
+    {
+        Null,
+        Bool,
+        Int,
+        Double,
+        String,
+        List,
+        Object
+    };
+
+    QSnapdConfigValue ();
+    explicit QSnapdConfigValue (void* variant);
+    QSnapdConfigValue (const QSnapdConfigValue& other);
+    QSnapdConfigValue (QSnapdConfigValue&& other) noexcept;
+    ~QSnapdConfigValue ();
+    QSnapdConfigValue& operator= (const QSnapdConfigValue& other);
+    QSnapdConfigValue& operator= (QSnapdConfigValue&& other) noexcept;
+
+    Type type () const;
+    bool isNull () const;
+
+    bool toBool () const;
+    qlonglong toLongLong () const;
+    double toDouble () const;
+    QString toString () const;
+    QVariant toVariant () const;
+
+    int size () const;
+    QSnapdConfigValue at (int index) const;
+    QStringList keys () const;
+    bool contains (const QString& key) const;
+    QSnapdConfigValue value (const QString& key) const;
+    QSnapdConfigValue operator[] (const QString& key) const { return value (key); }
+
+private:
+    void *variant;
+};
+
+Q_DECLARE_TYPEINFO (QSnapdConfigValue, Q_MOVABLE_TYPE);
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_COROUTINE_H
+#define SNAPD_COROUTINE_H
+
+#if __cplusplus >= 202002L
+#if __has_include(<coroutine>)
+
+#include <coroutine>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+
+// Allows the futures returned by QSnapdClient to be used with co_await, e.g.
+//   QSnapdResult<QByteArray> icon = co_await QSnapdAwait (client.getIconAsync ("snap"));
+// The coroutine is resumed from the event loop of the thread that awaited.
+template <class T> class QSnapdAwaiter
+{
+public:
+    explicit QSnapdAwaiter (const QFuture<T>& future) : future (future) {}
+
+    bool await_ready () const
+    {
+        return future.isFinished ();
+    }
+
+    void await_suspend (std::coroutine_handle<> handle)
+    {
+        QFutureWatcher<T> *watcher = new QFutureWatcher<T> ();
+        QObject::connect (watcher, &QFutureWatcherBase::finished, [watcher, handle] () {
+            watcher->deleteLater ();
+            handle.resume ();
+        });
+        watcher->setFuture (future);
+    }
+
+    T await_resume () const
+    {
+        return future.result ();
+    }
+
+private:
+    QFuture<T> future;
+};
+
+template <class T> QSnapdAwaiter<T> QSnapdAwait (const QFuture<T>& future)
+{
+    return QSnapdAwaiter<T> (future);
+}
+
+#endif
+#endif
+
+#endif
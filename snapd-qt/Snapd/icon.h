@@ -11,6 +11,7 @@
 #define SNAPD_ICON_H
 
 #include <QtCore/QObject>
+#include <Snapd/Bytes>
 #include <Snapd/WrappedObject>
 
 class Q_DECL_EXPORT QSnapdIcon : public QSnapdWrappedObject
@@ -25,6 +26,7 @@ public:
 
     QString mimeType () const;
     QByteArray data () const;
+    QSnapdBytes bytes () const;
 };
 
 #endif
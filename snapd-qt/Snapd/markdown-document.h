@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_MARKDOWN_DOCUMENT_H
+#define SNAPD_MARKDOWN_DOCUMENT_H
+
+#include <QtCore/QObject>
+#include <Snapd/WrappedObject>
+#include <Snapd/MarkdownNode>
+
+class Q_DECL_EXPORT QSnapdMarkdownDocument : public QSnapdWrappedObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int nodeCount READ nodeCount)
+
+public:
+    explicit QSnapdMarkdownDocument (void* snapd_object, QObject* parent = 0);
+
+    int nodeCount () const;
+    Q_INVOKABLE QSnapdMarkdownNode::NodeType nodeType (int index) const;
+    Q_INVOKABLE QString nodeText (int index) const;
+    Q_INVOKABLE int firstChild (int index) const;
+    Q_INVOKABLE int nextSibling (int index) const;
+};
+
+#endif
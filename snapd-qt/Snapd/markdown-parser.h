@@ -12,6 +12,8 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+#include <Snapd/MarkdownDocument>
 #include <Snapd/MarkdownNode>
 
 class QSnapdMarkdownParserPrivate;
@@ -33,6 +35,13 @@ public:
     void setPreserveWhitespace (bool preserveWhitespace) const;
     bool preserveWhitespace () const;
     QList<QSnapdMarkdownNode> parse (const QString &text) const;
+    QSnapdMarkdownDocument *parseFlat (const QString &text) const;
+    Q_INVOKABLE void parseAsync (const QString &text);
+    Q_INVOKABLE void parseManyAsync (const QStringList &texts);
+    Q_INVOKABLE void cancelParsing ();
+
+Q_SIGNALS:
+    void parsed (const QString &text, const QList<QSnapdMarkdownNode> &nodes);
 
 private:
     QScopedPointer<QSnapdMarkdownParserPrivate> d_ptr;
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_MARKDOWN_TEXT_RENDERER_H
+#define SNAPD_MARKDOWN_TEXT_RENDERER_H
+
+#include <QtGui/QFont>
+#include <QtGui/QFontDatabase>
+#include <QtGui/QTextCursor>
+#include <QtGui/QTextDocument>
+#include <QtGui/QTextList>
+#include <Snapd/MarkdownDocument>
+
+// Inserts parsed markdown into a QTextDocument, e.g.
+//   QScopedPointer<QSnapdMarkdownDocument> markdown (parser.parseFlat (snap->description ()));
+//   textEdit->setDocument (QSnapdMarkdownTextRenderer::toTextDocument (*markdown, textEdit));
+// The nodes are read directly from the flat document, so no node objects or HTML are created.
+// This is only defined in the header so the library doesn't depend on QtGui; applications
+// using it need to link to QtGui themselves.
+class QSnapdMarkdownTextRenderer
+{
+public:
+    explicit QSnapdMarkdownTextRenderer (QTextCursor &cursor) : cursor (cursor) {}
+
+    // Insert the document at the cursor position
+    void render (const QSnapdMarkdownDocument &document)
+    {
+        firstBlock = cursor.atBlockStart () && cursor.block ().length () <= 1;
+        for (int i = document.nodeCount () > 0 ? 0 : -1; i >= 0; i = document.nextSibling (i))
+            renderBlock (document, i, 0);
+    }
+
+    static QTextDocument *toTextDocument (const QSnapdMarkdownDocument &document, QObject *parent = 0)
+    {
+        QTextDocument *textDocument = new QTextDocument (parent);
+        QTextCursor cursor (textDocument);
+        QSnapdMarkdownTextRenderer (cursor).render (document);
+        return textDocument;
+    }
+
+private:
+    void startBlock (int indent)
+    {
+        if (!firstBlock)
+            cursor.insertBlock ();
+        firstBlock = false;
+        // New blocks carry on the list the previous one was in
+        if (cursor.currentList () != NULL)
+            cursor.currentList ()->remove (cursor.block ());
+        QTextBlockFormat format;
+        format.setIndent (indent);
+        cursor.setBlockFormat (format);
+        cursor.setCharFormat (QTextCharFormat ());
+    }
+
+    void renderBlock (const QSnapdMarkdownDocument &document, int index, int indent)
+    {
+        switch (document.nodeType (index)) {
+        case QSnapdMarkdownNode::NodeTypeParagraph:
+            startBlock (indent);
+            renderInlines (document, document.firstChild (index), QTextCharFormat ());
+            break;
+
+        case QSnapdMarkdownNode::NodeTypeCodeBlock: {
+            startBlock (indent);
+            QTextCharFormat format;
+            format.setFont (QFontDatabase::systemFont (QFontDatabase::FixedFont));
+            QString text;
+            for (int i = document.firstChild (index); i >= 0; i = document.nextSibling (i))
+                text += document.nodeText (i);
+            if (text.endsWith ('\n'))
+                text.chop (1);
+            cursor.insertText (text.replace ('\n', QChar::LineSeparator), format);
+            break;
+        }
+
+        case QSnapdMarkdownNode::NodeTypeUnorderedList:
+            renderList (document, index, indent);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void renderList (const QSnapdMarkdownDocument &document, int index, int indent)
+    {
+        QTextList *list = NULL;
+        for (int item = document.firstChild (index); item >= 0; item = document.nextSibling (item)) {
+            int child = document.firstChild (item);
+
+            // The first paragraph of each item is the list entry, anything else is indented below it
+            startBlock (indent);
+            if (child >= 0 && document.nodeType (child) == QSnapdMarkdownNode::NodeTypeParagraph) {
+                renderInlines (document, document.firstChild (child), QTextCharFormat ());
+                child = document.nextSibling (child);
+            }
+
+            if (list == NULL) {
+                QTextListFormat format;
+                format.setStyle (indent % 2 == 0 ? QTextListFormat::ListDisc : QTextListFormat::ListCircle);
+                format.setIndent (indent + 1);
+                list = cursor.createList (format);
+            }
+            else
+                list->add (cursor.block ());
+
+            for (; child >= 0; child = document.nextSibling (child))
+                renderBlock (document, child, indent + 1);
+        }
+    }
+
+    void renderInlines (const QSnapdMarkdownDocument &document, int index, const QTextCharFormat &format)
+    {
+        for (int i = index; i >= 0; i = document.nextSibling (i)) {
+            QTextCharFormat childFormat = format;
+            switch (document.nodeType (i)) {
+            case QSnapdMarkdownNode::NodeTypeText:
+                // Line breaks stay inside the paragraph rather than starting new blocks
+                cursor.insertText (document.nodeText (i).replace ('\n', QChar::LineSeparator), format);
+                continue;
+            case QSnapdMarkdownNode::NodeTypeEmphasis:
+                childFormat.setFontItalic (true);
+                break;
+            case QSnapdMarkdownNode::NodeTypeStrongEmphasis:
+                childFormat.setFontWeight (QFont::Bold);
+                break;
+            case QSnapdMarkdownNode::NodeTypeCodeSpan:
+                childFormat.setFontFamily (QFontDatabase::systemFont (QFontDatabase::FixedFont).family ());
+                break;
+            case QSnapdMarkdownNode::NodeTypeUrl: {
+                int text = document.firstChild (i);
+                childFormat.setAnchor (true);
+                childFormat.setAnchorHref (text >= 0 ? document.nodeText (text) : QString ());
+                childFormat.setFontUnderline (true);
+                break;
+            }
+            default:
+                continue;
+            }
+            renderInlines (document, document.firstChild (i), childFormat);
+        }
+    }
+
+    QTextCursor &cursor;
+    bool firstBlock = true;
+};
+
+#endif
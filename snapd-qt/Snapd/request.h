@@ -62,7 +62,8 @@ public:
         ChannelNotAvailable,
         NotASnap,
         DNSFailure,
-        OptionNotFound
+        OptionNotFound,
+        ResponseTooLarge
     };
     Q_ENUM(QSnapdError)
 
@@ -73,6 +74,9 @@ public:
     QString errorString () const;
     Q_INVOKABLE virtual void runSync () = 0;
     Q_INVOKABLE virtual void runAsync () = 0;
+    // Run runSync () in a worker thread, emitting progress and complete in this thread.
+    // The request must not be deleted until it completes, use cancel () to stop it early.
+    Q_INVOKABLE void runInThreadPool ();
     Q_INVOKABLE void cancel ();
     Q_INVOKABLE QSnapdChange *change () const;
     void handleProgress (void*);
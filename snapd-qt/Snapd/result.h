@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_RESULT_H
+#define SNAPD_RESULT_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QString>
+#include <Snapd/Request>
+
+// Result of a QSnapdClient *Async() call, which is either a value or an error
+template <class T> class QSnapdResult
+{
+public:
+    QSnapdResult () {}
+    explicit QSnapdResult (const T& value) : result_value (value) {}
+    QSnapdResult (QSnapdRequest::QSnapdError error, const QString& errorString) : result_error (error), result_error_string (errorString) {}
+
+    bool isOk () const { return result_error == QSnapdRequest::NoError; }
+    QSnapdRequest::QSnapdError error () const { return result_error; }
+    QString errorString () const { return result_error_string; }
+    const T& value () const { return result_value; }
+
+private:
+    T result_value = T ();
+    QSnapdRequest::QSnapdError result_error = QSnapdRequest::NoError;
+    QString result_error_string;
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_SNAP_INFO_H
+#define SNAPD_SNAP_INFO_H
+
+#include <QtCore/QString>
+#include <QtCore/QTypeInfo>
+#include <QtCore/QVector>
+#include <Snapd/AppInfo>
+#include <Snapd/ChannelInfo>
+#include <Snapd/Snap>
+
+// Implicitly shared value version of QSnapdSnap, for storing many snaps without a QObject each.
+// Use toObject() where a QObject is required, e.g. to pass to QML.
+class Q_DECL_EXPORT QSnapdSnapInfo
+{
+public:
+    QSnapdSnapInfo ();
+    explicit QSnapdSnapInfo (void* snapd_object);
+    QSnapdSnapInfo (const QSnapdSnapInfo& other);
+    QSnapdSnapInfo (QSnapdSnapInfo&& other) noexcept;
+    ~QSnapdSnapInfo ();
+    QSnapdSnapInfo& operator= (const QSnapdSnapInfo& other);
+    QSnapdSnapInfo& operator= (QSnapdSnapInfo&& other) noexcept;
+
+    bool isNull () const;
+    QSnapdSnap *toObject (QObject* parent = 0) const;
+
+    QVector<QSnapdAppInfo> apps () const;
+    QString base () const;
+    QString channel () const;
+    QVector<QSnapdChannelInfo> channels () const;
+    QSnapdChannelInfo matchChannel (const QString& name) const;
+    QSnapdEnums::SnapConfinement confinement () const;
+    QString description () const;
+    qint64 downloadSize () const;
+    QString icon () const;
+    QString id () const;
+    qint64 installedSize () const;
+    QString name () const;
+    QString publisherDisplayName () const;
+    QString publisherUsername () const;
+    QString revision () const;
+    QSnapdEnums::SnapStatus status () const;
+    QString summary () const;
+    QString title () const;
+    QString trackingChannel () const;
+    QString version () const;
+
+private:
+    void *snapd_object;
+};
+
+Q_DECLARE_TYPEINFO (QSnapdSnapInfo, Q_MOVABLE_TYPE);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_SNAP_LIST_MODEL_H
+#define SNAPD_SNAP_LIST_MODEL_H
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QVector>
+#include <Snapd/Client>
+#include <Snapd/SnapInfo>
+
+// List of snaps for use in views.
+// Calling setSnaps() again updates the existing rows by snap name, so views keep their state;
+// snaps not already in the list are added at the end.
+// If batchSize is set rows are exposed in batches using fetchMore(), e.g. for large search results.
+class Q_DECL_EXPORT QSnapdSnapListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int batchSize READ batchSize WRITE setBatchSize)
+
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        TitleRole,
+        SummaryRole,
+        DescriptionRole,
+        VersionRole,
+        RevisionRole,
+        ChannelRole,
+        TrackingChannelRole,
+        IconRole,
+        StatusRole,
+        ConfinementRole,
+        PublisherDisplayNameRole,
+        InstalledSizeRole,
+        DownloadSizeRole
+    };
+    Q_ENUM(Roles)
+
+    explicit QSnapdSnapListModel (QObject* parent = 0);
+
+    int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+    QVariant data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames () const override;
+    bool canFetchMore (const QModelIndex &parent) const override;
+    void fetchMore (const QModelIndex &parent) override;
+
+    int count () const;
+    int batchSize () const;
+    void setBatchSize (int batchSize);
+    void setSnaps (const QVector<QSnapdSnapInfo> &snaps);
+    Q_INVOKABLE void setSnaps (QSnapdGetSnapsRequest *request);
+    Q_INVOKABLE void setSnaps (QSnapdFindRequest *request);
+    QSnapdSnapInfo snapInfo (int row) const;
+    Q_INVOKABLE int indexOf (const QString &name) const;
+    Q_INVOKABLE QSnapdSnap *snap (int row) const;
+    Q_INVOKABLE void clear ();
+
+Q_SIGNALS:
+    void countChanged ();
+
+private:
+    QVector<QSnapdSnapInfo> snaps;
+    int loaded = 0;
+    int batch_size = 0;
+};
+
+#endif
@@ -20,6 +20,15 @@
 #include <Snapd/Price>
 #include <Snapd/Screenshot>
 
+class QSnapdClient;
+class QSnapdSnapDetails;
+
+// Snaps from lists and searches may not have all their details.
+// After setDetailsClient(), loadDetails() fetches them in the background and updates the snap in place with the
+// changed properties notified, so views don't need to rebind. Reading a property never starts a fetch.
+// The snap is updated in the thread it belongs to, so like other QObjects it must only be used from that thread.
+// Accessors such as app() and channel() return a new object owned by the caller on each call. To read many snaps,
+// apps or channels without creating objects use QSnapdSnapInfo, QSnapdAppInfo and QSnapdChannelInfo instead.
 class Q_DECL_EXPORT QSnapdSnap : public QSnapdWrappedObject
 {
     Q_OBJECT
@@ -28,11 +37,11 @@ class Q_DECL_EXPORT QSnapdSnap : public QSnapdWrappedObject
     Q_PROPERTY(QString base READ base)
     Q_PROPERTY(QString broken READ broken)
     Q_PROPERTY(QString channel READ channel)
-    Q_PROPERTY(int channelCount READ channelCount)
+    Q_PROPERTY(int channelCount READ channelCount NOTIFY channelsChanged)
     Q_PROPERTY(QStringList commonIds READ commonIds)
     Q_PROPERTY(QSnapdEnums::SnapConfinement confinement READ confinement)
-    Q_PROPERTY(QString contact READ contact)
-    Q_PROPERTY(QString description READ description)
+    Q_PROPERTY(QString contact READ contact NOTIFY contactChanged)
+    Q_PROPERTY(QString description READ description NOTIFY descriptionChanged)
     Q_PROPERTY(QString developer READ developer)
     Q_PROPERTY(bool devmode READ devmode)
     Q_PROPERTY(qint64 downloadSize READ downloadSize)
@@ -41,7 +50,8 @@ class Q_DECL_EXPORT QSnapdSnap : public QSnapdWrappedObject
     Q_PROPERTY(QDateTime installDate READ installDate)
     Q_PROPERTY(qint64 installedSize READ installedSize)
     Q_PROPERTY(bool jailmode READ jailmode)
-    Q_PROPERTY(QString license READ license)
+    Q_PROPERTY(QString license READ license NOTIFY licenseChanged)
+    Q_PROPERTY(int mediaCount READ mediaCount NOTIFY mediaChanged)
     Q_PROPERTY(QString mountedFrom READ mountedFrom)
     Q_PROPERTY(QString name READ name)
     Q_PROPERTY(int priceCount READ priceCount)
@@ -57,10 +67,10 @@ class Q_DECL_EXPORT QSnapdSnap : public QSnapdWrappedObject
     Q_PROPERTY(QString summary READ summary)
     Q_PROPERTY(QString title READ title)
     Q_PROPERTY(QString trackingChannel READ trackingChannel)
-    Q_PROPERTY(QStringList tracks READ tracks)
+    Q_PROPERTY(QStringList tracks READ tracks NOTIFY channelsChanged)
     Q_PROPERTY(bool trymode READ trymode)
     Q_PROPERTY(QString version READ version)
-    Q_PROPERTY(QString website READ website)
+    Q_PROPERTY(QString website READ website NOTIFY websiteChanged)
 
 public:
     explicit QSnapdSnap (void* snapd_object, QObject* parent = 0);
@@ -110,6 +120,21 @@ public:
     bool trymode () const;
     QString version () const;
     QString website () const;
+    Q_INVOKABLE void setDetailsClient (QSnapdClient *client);
+    Q_INVOKABLE void loadDetails ();
+
+Q_SIGNALS:
+    void channelsChanged ();
+    void contactChanged ();
+    void descriptionChanged ();
+    void licenseChanged ();
+    void mediaChanged ();
+    void websiteChanged ();
+    void detailsLoaded ();
+
+private:
+    friend class QSnapdSnapDetails;
+    void upgrade (void *snapd_object);
 };
 
 #endif
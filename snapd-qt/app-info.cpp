@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/app-info.h"
+
+QSnapdAppInfo::QSnapdAppInfo () : snapd_object (NULL) {}
+
+QSnapdAppInfo::QSnapdAppInfo (void *object) : snapd_object (object != NULL ? g_object_ref (object) : NULL) {}
+
+QSnapdAppInfo::QSnapdAppInfo (const QSnapdAppInfo& other) : snapd_object (other.snapd_object != NULL ? g_object_ref (other.snapd_object) : NULL) {}
+
+QSnapdAppInfo::QSnapdAppInfo (QSnapdAppInfo&& other) noexcept : snapd_object (other.snapd_object)
+{
+    other.snapd_object = NULL;
+}
+
+QSnapdAppInfo::~QSnapdAppInfo ()
+{
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+}
+
+QSnapdAppInfo& QSnapdAppInfo::operator= (const QSnapdAppInfo& other)
+{
+    if (other.snapd_object != NULL)
+        g_object_ref (other.snapd_object);
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+    snapd_object = other.snapd_object;
+    return *this;
+}
+
+QSnapdAppInfo& QSnapdAppInfo::operator= (QSnapdAppInfo&& other) noexcept
+{
+    if (this != &other) {
+        if (snapd_object != NULL)
+            g_object_unref (snapd_object);
+        snapd_object = other.snapd_object;
+        other.snapd_object = NULL;
+    }
+    return *this;
+}
+
+bool QSnapdAppInfo::isNull () const
+{
+    return snapd_object == NULL;
+}
+
+QSnapdApp *QSnapdAppInfo::toObject (QObject *parent) const
+{
+    if (snapd_object == NULL)
+        return NULL;
+    return new QSnapdApp (snapd_object, parent);
+}
+
+QString QSnapdAppInfo::name () const
+{
+    return snapd_app_get_name (SNAPD_APP (snapd_object));
+}
+
+bool QSnapdAppInfo::active () const
+{
+    return snapd_app_get_active (SNAPD_APP (snapd_object));
+}
+
+QString QSnapdAppInfo::commonId () const
+{
+    return snapd_app_get_common_id (SNAPD_APP (snapd_object));
+}
+
+QString QSnapdAppInfo::desktopFile () const
+{
+    return snapd_app_get_desktop_file (SNAPD_APP (snapd_object));
+}
+
+bool QSnapdAppInfo::enabled () const
+{
+    return snapd_app_get_enabled (SNAPD_APP (snapd_object));
+}
+
+QString QSnapdAppInfo::snap () const
+{
+    return snapd_app_get_snap (SNAPD_APP (snapd_object));
+}
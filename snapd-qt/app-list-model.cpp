@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/app-list-model.h"
+
+QSnapdAppListModel::QSnapdAppListModel (QObject *parent) :
+    QAbstractListModel (parent) {}
+
+int QSnapdAppListModel::rowCount (const QModelIndex &parent) const
+{
+    return parent.isValid () ? 0 : apps.size ();
+}
+
+QVariant QSnapdAppListModel::data (const QModelIndex &index, int role) const
+{
+    if (!index.isValid () || index.row () < 0 || index.row () >= apps.size ())
+        return QVariant ();
+
+    const QSnapdAppInfo &app = apps[index.row ()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case NameRole:
+        return app.name ();
+    case SnapRole:
+        return app.snap ();
+    case CommonIdRole:
+        return app.commonId ();
+    case DesktopFileRole:
+        return app.desktopFile ();
+    case ActiveRole:
+        return app.active ();
+    case EnabledRole:
+        return app.enabled ();
+    default:
+        return QVariant ();
+    }
+}
+
+QHash<int, QByteArray> QSnapdAppListModel::roleNames () const
+{
+    QHash<int, QByteArray> names;
+    names[NameRole] = "name";
+    names[SnapRole] = "snap";
+    names[CommonIdRole] = "commonId";
+    names[DesktopFileRole] = "desktopFile";
+    names[ActiveRole] = "active";
+    names[EnabledRole] = "enabled";
+    return names;
+}
+
+int QSnapdAppListModel::count () const
+{
+    return apps.size ();
+}
+
+void QSnapdAppListModel::setApps (const QVector<QSnapdAppInfo> &newApps)
+{
+    int oldCount = apps.size ();
+
+    beginResetModel ();
+    apps = newApps;
+    endResetModel ();
+
+    if (apps.size () != oldCount)
+        Q_EMIT countChanged ();
+}
+
+void QSnapdAppListModel::setApps (QSnapdGetAppsRequest *request)
+{
+    setApps (request != NULL ? request->appInfos () : QVector<QSnapdAppInfo> ());
+}
+
+QSnapdAppInfo QSnapdAppListModel::appInfo (int row) const
+{
+    if (row < 0 || row >= apps.size ())
+        return QSnapdAppInfo ();
+    return apps[row];
+}
+
+void QSnapdAppListModel::clear ()
+{
+    setApps (QVector<QSnapdAppInfo> ());
+}
@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/assertion.h"
+#include "strv.h"
 
 QSnapdAssertion::QSnapdAssertion (const QString& contents, QObject *parent) :
     QSnapdWrappedObject (NULL, g_object_unref, parent)
@@ -19,13 +20,8 @@ QSnapdAssertion::QSnapdAssertion (const QString& contents, QObject *parent) :
 
 QStringList QSnapdAssertion::headers () const
 {
-    g_auto(GStrv) headers = NULL;
-    QStringList result;
-
-    headers = snapd_assertion_get_headers (SNAPD_ASSERTION (wrapped_object));
-    for (int i = 0; headers[i] != NULL; i++)
-        result.append (headers[i]);
-    return result;
+    g_auto(GStrv) headers = snapd_assertion_get_headers (SNAPD_ASSERTION (wrapped_object));
+    return strv_to_string_list (headers);
 }
 
 QString QSnapdAssertion::header (const QString& name) const
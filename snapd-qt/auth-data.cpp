@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/auth-data.h"
+#include "strv.h"
 
 QSnapdAuthData::QSnapdAuthData (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
 
@@ -17,11 +18,7 @@ QSnapdAuthData::QSnapdAuthData (QObject *parent) : QSnapdWrappedObject (snapd_au
 
 QSnapdAuthData::QSnapdAuthData (const QString& macaroon, const QStringList& discharges, QObject *parent) : QSnapdWrappedObject (NULL, g_object_unref, parent)
 {
-    g_auto(GStrv) strv = g_new (gchar *, discharges.size () + 1);
-    int i;
-    for (i = 0; i < discharges.size (); i++)
-        strv[i] = g_strdup ((char *) discharges.at (i).toStdString ().c_str ());
-    strv[i] = NULL;
+    g_autofree gchar **strv = string_list_to_strv (discharges);
     wrapped_object = snapd_auth_data_new (macaroon.toStdString ().c_str (), strv);
 }
 
@@ -32,9 +29,5 @@ QString QSnapdAuthData::macaroon () const
 
 QStringList QSnapdAuthData::discharges () const
 {
-    GStrv discharges = snapd_auth_data_get_discharges (SNAPD_AUTH_DATA (wrapped_object));
-    QStringList result;
-    for (int i = 0; discharges[i] != NULL; i++)
-        result.append (discharges[i]);
-    return result;
+    return strv_to_string_list (snapd_auth_data_get_discharges (SNAPD_AUTH_DATA (wrapped_object)));
 }
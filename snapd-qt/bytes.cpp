@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <glib.h>
+
+#include "Snapd/bytes.h"
+
+QSnapdBytes::QSnapdBytes () : bytes (NULL) {}
+
+QSnapdBytes::QSnapdBytes (void *bytes) : bytes (bytes != NULL ? g_bytes_ref ((GBytes *) bytes) : NULL) {}
+
+QSnapdBytes::QSnapdBytes (const QSnapdBytes& other) : bytes (other.bytes != NULL ? g_bytes_ref ((GBytes *) other.bytes) : NULL) {}
+
+QSnapdBytes::QSnapdBytes (QSnapdBytes&& other) noexcept : bytes (other.bytes)
+{
+    other.bytes = NULL;
+}
+
+QSnapdBytes::~QSnapdBytes ()
+{
+    if (bytes != NULL)
+        g_bytes_unref ((GBytes *) bytes);
+}
+
+QSnapdBytes& QSnapdBytes::operator= (const QSnapdBytes& other)
+{
+    if (other.bytes != NULL)
+        g_bytes_ref ((GBytes *) other.bytes);
+    if (bytes != NULL)
+        g_bytes_unref ((GBytes *) bytes);
+    bytes = other.bytes;
+    return *this;
+}
+
+QSnapdBytes& QSnapdBytes::operator= (QSnapdBytes&& other) noexcept
+{
+    if (this != &other) {
+        if (bytes != NULL)
+            g_bytes_unref ((GBytes *) bytes);
+        bytes = other.bytes;
+        other.bytes = NULL;
+    }
+    return *this;
+}
+
+bool QSnapdBytes::isNull () const
+{
+    return bytes == NULL;
+}
+
+int QSnapdBytes::size () const
+{
+    if (bytes == NULL)
+        return 0;
+    return g_bytes_get_size ((GBytes *) bytes);
+}
+
+const char *QSnapdBytes::constData () const
+{
+    if (bytes == NULL)
+        return NULL;
+    return (const char *) g_bytes_get_data ((GBytes *) bytes, NULL);
+}
+
+QByteArray QSnapdBytes::data () const
+{
+    return QByteArray::fromRawData (constData (), size ());
+}
+
+QByteArray QSnapdBytes::toByteArray () const
+{
+    return QByteArray (constData (), size ());
+}
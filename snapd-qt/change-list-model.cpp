@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/change-list-model.h"
+
+QSnapdChangeListModel::QSnapdChangeListModel (QObject *parent) :
+    QAbstractListModel (parent) {}
+
+int QSnapdChangeListModel::rowCount (const QModelIndex &parent) const
+{
+    return parent.isValid () ? 0 : changes.size ();
+}
+
+QVariant QSnapdChangeListModel::data (const QModelIndex &index, int role) const
+{
+    if (!index.isValid () || index.row () < 0 || index.row () >= changes.size ())
+        return QVariant ();
+
+    QSnapdChange *change = changes[index.row ()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case SummaryRole:
+        return change->summary ();
+    case IdRole:
+        return change->id ();
+    case KindRole:
+        return change->kind ();
+    case StatusRole:
+        return change->status ();
+    case ReadyRole:
+        return change->ready ();
+    case TaskCountRole:
+        return change->taskCount ();
+    case SpawnTimeRole:
+        return change->spawnTime ();
+    case ReadyTimeRole:
+        return change->readyTime ();
+    case ErrorRole:
+        return change->error ();
+    default:
+        return QVariant ();
+    }
+}
+
+QHash<int, QByteArray> QSnapdChangeListModel::roleNames () const
+{
+    QHash<int, QByteArray> names;
+    names[IdRole] = "id";
+    names[KindRole] = "kind";
+    names[SummaryRole] = "summary";
+    names[StatusRole] = "status";
+    names[ReadyRole] = "ready";
+    names[TaskCountRole] = "taskCount";
+    names[SpawnTimeRole] = "spawnTime";
+    names[ReadyTimeRole] = "readyTime";
+    names[ErrorRole] = "error";
+    return names;
+}
+
+int QSnapdChangeListModel::count () const
+{
+    return changes.size ();
+}
+
+static bool changeChanged (QSnapdChange *a, QSnapdChange *b)
+{
+    return a->status () != b->status () ||
+           a->ready () != b->ready () ||
+           a->summary () != b->summary () ||
+           a->taskCount () != b->taskCount () ||
+           a->readyTime () != b->readyTime () ||
+           a->error () != b->error ();
+}
+
+void QSnapdChangeListModel::setChanges (QSnapdGetChangesRequest *request)
+{
+    int oldCount = changes.size ();
+
+    QHash<QString, QSnapdChange *> newChanges;
+    QVector<QSnapdChange *> added;
+    int nChanges = request != NULL ? request->changeCount () : 0;
+    for (int i = 0; i < nChanges; i++) {
+        QSnapdChange *change = request->change (i);
+        change->setParent (this);
+        newChanges.insert (change->id (), change);
+        added.append (change);
+    }
+
+    // Remove changes that have gone
+    for (int row = changes.size () - 1; row >= 0; row--) {
+        if (newChanges.contains (changes[row]->id ()))
+            continue;
+
+        beginRemoveRows (QModelIndex (), row, row);
+        delete changes[row];
+        changes.remove (row);
+        endRemoveRows ();
+    }
+
+    // Update changes that remain
+    for (int row = 0; row < changes.size (); row++) {
+        QSnapdChange *change = newChanges.value (changes[row]->id ());
+        added.removeOne (change);
+        if (!changeChanged (changes[row], change)) {
+            delete change;
+            continue;
+        }
+
+        delete changes[row];
+        changes[row] = change;
+        Q_EMIT dataChanged (index (row), index (row));
+    }
+
+    // Add new changes to the end
+    if (!added.isEmpty ()) {
+        beginInsertRows (QModelIndex (), changes.size (), changes.size () + added.size () - 1);
+        changes.append (added);
+        endInsertRows ();
+    }
+
+    if (changes.size () != oldCount)
+        Q_EMIT countChanged ();
+}
+
+QSnapdChange *QSnapdChangeListModel::change (int row) const
+{
+    if (row < 0 || row >= changes.size ())
+        return NULL;
+    return changes[row];
+}
+
+void QSnapdChangeListModel::clear ()
+{
+    if (changes.isEmpty ())
+        return;
+
+    beginResetModel ();
+    qDeleteAll (changes);
+    changes.clear ();
+    endResetModel ();
+    Q_EMIT countChanged ();
+}
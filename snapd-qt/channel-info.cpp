@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/channel-info.h"
+
+static QSnapdEnums::SnapConfinement convertConfinement (SnapdConfinement confinement)
+{
+    switch (confinement)
+    {
+    case SNAPD_CONFINEMENT_STRICT:
+        return QSnapdEnums::SnapConfinementStrict;
+    case SNAPD_CONFINEMENT_CLASSIC:
+        return QSnapdEnums::SnapConfinementClassic;
+    case SNAPD_CONFINEMENT_DEVMODE:
+        return QSnapdEnums::SnapConfinementDevmode;
+    case SNAPD_CONFINEMENT_UNKNOWN:
+    default:
+        return QSnapdEnums::SnapConfinementUnknown;
+    }
+}
+
+static QDateTime convertDateTime (GDateTime *datetime)
+{
+    if (datetime == NULL)
+        return QDateTime ();
+
+    QDate date (g_date_time_get_year (datetime),
+                g_date_time_get_month (datetime),
+                g_date_time_get_day_of_month (datetime));
+    QTime time (g_date_time_get_hour (datetime),
+                g_date_time_get_minute (datetime),
+                g_date_time_get_second (datetime),
+                g_date_time_get_microsecond (datetime) / 1000);
+    return QDateTime (date, time, Qt::OffsetFromUTC, g_date_time_get_utc_offset (datetime) / 1000000);
+}
+
+QSnapdChannelInfo::QSnapdChannelInfo () : snapd_object (NULL) {}
+
+QSnapdChannelInfo::QSnapdChannelInfo (void *object) : snapd_object (object != NULL ? g_object_ref (object) : NULL) {}
+
+QSnapdChannelInfo::QSnapdChannelInfo (const QSnapdChannelInfo& other) : snapd_object (other.snapd_object != NULL ? g_object_ref (other.snapd_object) : NULL) {}
+
+QSnapdChannelInfo::QSnapdChannelInfo (QSnapdChannelInfo&& other) noexcept : snapd_object (other.snapd_object)
+{
+    other.snapd_object = NULL;
+}
+
+QSnapdChannelInfo::~QSnapdChannelInfo ()
+{
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+}
+
+QSnapdChannelInfo& QSnapdChannelInfo::operator= (const QSnapdChannelInfo& other)
+{
+    if (other.snapd_object != NULL)
+        g_object_ref (other.snapd_object);
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+    snapd_object = other.snapd_object;
+    return *this;
+}
+
+QSnapdChannelInfo& QSnapdChannelInfo::operator= (QSnapdChannelInfo&& other) noexcept
+{
+    if (this != &other) {
+        if (snapd_object != NULL)
+            g_object_unref (snapd_object);
+        snapd_object = other.snapd_object;
+        other.snapd_object = NULL;
+    }
+    return *this;
+}
+
+bool QSnapdChannelInfo::isNull () const
+{
+    return snapd_object == NULL;
+}
+
+QSnapdChannel *QSnapdChannelInfo::toObject (QObject *parent) const
+{
+    if (snapd_object == NULL)
+        return NULL;
+    return new QSnapdChannel (snapd_object, parent);
+}
+
+QString QSnapdChannelInfo::branch () const
+{
+    return snapd_channel_get_branch (SNAPD_CHANNEL (snapd_object));
+}
+
+QSnapdEnums::SnapConfinement QSnapdChannelInfo::confinement () const
+{
+    return convertConfinement (snapd_channel_get_confinement (SNAPD_CHANNEL (snapd_object)));
+}
+
+QString QSnapdChannelInfo::epoch () const
+{
+    return snapd_channel_get_epoch (SNAPD_CHANNEL (snapd_object));
+}
+
+QString QSnapdChannelInfo::name () const
+{
+    return snapd_channel_get_name (SNAPD_CHANNEL (snapd_object));
+}
+
+QDateTime QSnapdChannelInfo::releasedAt () const
+{
+    return convertDateTime (snapd_channel_get_released_at (SNAPD_CHANNEL (snapd_object)));
+}
+
+QString QSnapdChannelInfo::revision () const
+{
+    return snapd_channel_get_revision (SNAPD_CHANNEL (snapd_object));
+}
+
+QString QSnapdChannelInfo::risk () const
+{
+    return snapd_channel_get_risk (SNAPD_CHANNEL (snapd_object));
+}
+
+qint64 QSnapdChannelInfo::size () const
+{
+    return snapd_channel_get_size (SNAPD_CHANNEL (snapd_object));
+}
+
+QString QSnapdChannelInfo::track () const
+{
+    return snapd_channel_get_track (SNAPD_CHANNEL (snapd_object));
+}
+
+QString QSnapdChannelInfo::version () const
+{
+    return snapd_channel_get_version (SNAPD_CHANNEL (snapd_object));
+}
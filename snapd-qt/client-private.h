@@ -12,47 +12,27 @@
 
 #include <snapd-glib/snapd-glib.h>
 
+#include "request-template.h"
 #include "stream-wrapper.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QVariant>
 #include <QIODevice>
 
-G_DECLARE_FINAL_TYPE (CallbackData, callback_data, SNAPD, CALLBACK_DATA, GObject)
-
-struct _CallbackData
-{
-    GObject parent_instance;
-    gpointer request;
-};
-
-CallbackData *callback_data_new (gpointer request);
-
-class QSnapdConnectRequestPrivate
+class QSnapdConnectRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdConnectRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdConnectRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
-    CallbackData *callback_data;
+    QSnapdConnectRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
 };
 
-class QSnapdLoginRequestPrivate
+class QSnapdLoginRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdLoginRequestPrivate (gpointer request, const QString& email, const QString& password, const QString& otp) :
-        email(email), password(password), otp(otp) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), email(email), password(password), otp(otp) {}
     ~QSnapdLoginRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (user_information != NULL)
             g_object_unref (user_information);
         if (auth_data != NULL)
@@ -61,299 +41,213 @@ public:
     QString email;
     QString password;
     QString otp;
-    CallbackData *callback_data;
     SnapdUserInformation *user_information = NULL;
     SnapdAuthData *auth_data = NULL;
 };
 
-class QSnapdLogoutRequestPrivate
+class QSnapdLogoutRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdLogoutRequestPrivate (gpointer request, qint64 id) :
-        id (id) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdLogoutRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), id (id) {}
     qint64 id;
-    CallbackData *callback_data;
 };
 
-class QSnapdGetChangesRequestPrivate
+class QSnapdGetChangesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetChangesRequestPrivate (gpointer request, int filter, const QString& snapName) :
-        filter(filter), snapName(snapName) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), filter(filter), snapName(snapName) {}
     ~QSnapdGetChangesRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (changes != NULL)
             g_ptr_array_unref (changes);
     }
     int filter;
     QString snapName;
-    CallbackData *callback_data;
     GPtrArray *changes = NULL;
 };
 
-class QSnapdGetChangeRequestPrivate
+class QSnapdGetChangeRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetChangeRequestPrivate (gpointer request, const QString& id) :
-        id(id) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), id(id) {}
     ~QSnapdGetChangeRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (change != NULL)
             g_object_unref (change);
     }
     QString id;
-    CallbackData *callback_data;
     SnapdChange *change = NULL;
 };
 
-class QSnapdAbortChangeRequestPrivate
+class QSnapdAbortChangeRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdAbortChangeRequestPrivate (gpointer request, const QString& id) :
-        id(id) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), id(id) {}
     ~QSnapdAbortChangeRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (change != NULL)
             g_object_unref (change);
     }
     QString id;
-    CallbackData *callback_data;
     SnapdChange *change = NULL;
 };
 
-class QSnapdGetSystemInformationRequestPrivate
+class QSnapdGetSystemInformationRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetSystemInformationRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetSystemInformationRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdGetSystemInformationRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (info != NULL)
             g_object_unref (info);
     }
-    CallbackData *callback_data;
     SnapdSystemInformation *info = NULL;
 };
 
-class QSnapdListRequestPrivate
+class QSnapdListRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdListRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdListRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdListRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snaps != NULL)
             g_ptr_array_unref (snaps);
     }
-    CallbackData *callback_data;
     GPtrArray *snaps = NULL;
 };
 
-class QSnapdGetSnapsRequestPrivate
+class QSnapdGetSnapsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetSnapsRequestPrivate (gpointer request, int flags, const QStringList& snaps) :
-        flags(flags), filter_snaps(snaps) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), flags(flags), filter_snaps(snaps) {}
     ~QSnapdGetSnapsRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snaps != NULL)
             g_ptr_array_unref (snaps);
     }
     int flags;
     QStringList filter_snaps;
-    CallbackData *callback_data;
     GPtrArray *snaps = NULL;
 };
 
-class QSnapdListOneRequestPrivate
+class QSnapdListOneRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdListOneRequestPrivate (gpointer request, const QString& name) :
-        name(name) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), name(name) {}
     ~QSnapdListOneRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snap != NULL)
             g_object_unref (snap);
     }
     QString name;
-    CallbackData *callback_data;
     SnapdSnap *snap = NULL;
 };
 
-class QSnapdGetSnapRequestPrivate
+class QSnapdGetSnapRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetSnapRequestPrivate (gpointer request, const QString& name) :
-        name(name) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), name(name) {}
     ~QSnapdGetSnapRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snap != NULL)
             g_object_unref (snap);
     }
     QString name;
-    CallbackData *callback_data;
     SnapdSnap *snap = NULL;
 };
 
-class QSnapdGetSnapConfRequestPrivate
+class QSnapdGetSnapConfRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetSnapConfRequestPrivate (gpointer request, const QString& name, const QStringList& keys) :
-        name(name), keys(keys) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), name(name), keys(keys) {}
     ~QSnapdGetSnapConfRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (configuration != NULL)
             g_hash_table_unref (configuration);
     }
     QString name;
     QStringList keys;
-    CallbackData *callback_data;
     GHashTable *configuration = NULL;
 };
 
-class QSnapdSetSnapConfRequestPrivate
+class QSnapdSetSnapConfRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdSetSnapConfRequestPrivate (gpointer request, const QString& name, const QHash<QString, QVariant>& configuration) :
-        name(name), configuration(configuration) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdSetSnapConfRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), name(name), configuration(configuration) {}
     QString name;
     QHash<QString, QVariant> configuration;
-    CallbackData *callback_data;
 };
 
-class QSnapdGetAppsRequestPrivate
+class QSnapdGetAppsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetAppsRequestPrivate (gpointer request, int flags, const QStringList& snaps) :
-        flags(flags), filter_snaps(snaps) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), flags(flags), filter_snaps(snaps) {}
     ~QSnapdGetAppsRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (apps != NULL)
             g_ptr_array_unref (apps);
     }
     int flags;
     QStringList filter_snaps;
-    CallbackData *callback_data;
     GPtrArray *apps = NULL;
 };
 
-class QSnapdGetIconRequestPrivate
+class QSnapdGetIconRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetIconRequestPrivate (gpointer request, const QString& name) :
-        name(name) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetIconRequestPrivate (gpointer request, const QString& name, const QString& revision) :
+        QSnapdRequestPrivateBase (request), name(name), revision(revision) {}
     ~QSnapdGetIconRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (icon != NULL)
             g_object_unref (icon);
     }
     QString name;
-    CallbackData *callback_data;
+    QString revision;
     SnapdIcon *icon = NULL;
 };
 
-class QSnapdGetAssertionsRequestPrivate
+class QSnapdGetAssertionsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetAssertionsRequestPrivate (gpointer request, const QString& type) :
-        type (type) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), type (type) {}
     ~QSnapdGetAssertionsRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (assertions != NULL)
             g_strfreev (assertions);
     }
     QString type;
-    CallbackData *callback_data;
     GStrv assertions = NULL;
 };
 
-class QSnapdAddAssertionsRequestPrivate
+class QSnapdAddAssertionsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdAddAssertionsRequestPrivate (gpointer request, const QStringList& assertions) :
-        assertions (assertions) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdAddAssertionsRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), assertions (assertions) {}
     QStringList assertions;
-    CallbackData *callback_data;
 };
 
-class QSnapdGetConnectionsRequestPrivate
+class QSnapdGetConnectionsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetConnectionsRequestPrivate (gpointer request, int flags, const QString &snap, const QString &interface) :
-        flags (flags), snap (snap), interface (interface) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), flags (flags), snap (snap), interface (interface) {}
     ~QSnapdGetConnectionsRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (established != NULL)
             g_ptr_array_unref (established);
         if (undesired != NULL)
@@ -366,138 +260,102 @@ public:
     int flags;
     QString snap;
     QString interface;
-    CallbackData *callback_data;
     GPtrArray *established = NULL;
     GPtrArray *undesired = NULL;
     GPtrArray *plugs = NULL;
     GPtrArray *slots_ = NULL;
 };
 
-class QSnapdGetInterfacesRequestPrivate
+class QSnapdGetInterfacesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetInterfacesRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetInterfacesRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdGetInterfacesRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (plugs != NULL)
             g_ptr_array_unref (plugs);
         if (slots_ != NULL)
             g_ptr_array_unref (slots_);
     }
-    CallbackData *callback_data;
     GPtrArray *plugs = NULL;
     GPtrArray *slots_ = NULL;
 };
 
-class QSnapdGetInterfaces2RequestPrivate
+class QSnapdGetInterfaces2RequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdGetInterfaces2RequestPrivate (gpointer request, int flags, const QStringList &names) :
-        flags (flags), names (names) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), flags (flags), names (names) {}
     ~QSnapdGetInterfaces2RequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (interfaces != NULL)
             g_ptr_array_unref (interfaces);
     }
     int flags;
     QStringList names;
-    CallbackData *callback_data;
     GPtrArray *interfaces = NULL;
 };
 
-class QSnapdConnectInterfaceRequestPrivate
+class QSnapdConnectInterfaceRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdConnectInterfaceRequestPrivate (gpointer request, const QString &plug_snap, const QString &plug_name, const QString &slot_snap, const QString &slot_name) :
-        plug_snap (plug_snap), plug_name (plug_name), slot_snap (slot_snap), slot_name (slot_name) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdConnectInterfaceRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), plug_snap (plug_snap), plug_name (plug_name), slot_snap (slot_snap), slot_name (slot_name) {}
     QString plug_snap;
     QString plug_name;
     QString slot_snap;
     QString slot_name;
-    CallbackData *callback_data;
 };
 
-class QSnapdDisconnectInterfaceRequestPrivate
+class QSnapdDisconnectInterfaceRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdDisconnectInterfaceRequestPrivate (gpointer request, const QString &plug_snap, const QString &plug_name, const QString &slot_snap, const QString &slot_name) :
-        plug_snap (plug_snap), plug_name (plug_name), slot_snap (slot_snap), slot_name (slot_name) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdDisconnectInterfaceRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), plug_snap (plug_snap), plug_name (plug_name), slot_snap (slot_snap), slot_name (slot_name) {}
     QString plug_snap;
     QString plug_name;
     QString slot_snap;
     QString slot_name;
-    CallbackData *callback_data;
 };
 
-class QSnapdFindRequestPrivate
+class QSnapdFindRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdFindRequestPrivate (gpointer request, int flags, const QString& section, const QString& name) :
-        flags (flags), section (section), name (name) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), flags (flags), section (section), name (name) {}
     ~QSnapdFindRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snaps != NULL)
             g_ptr_array_unref (snaps);
     }
     int flags;
     QString section;
     QString name;
-    CallbackData *callback_data;
     GPtrArray *snaps = NULL;
     QString suggestedCurrency;
 };
 
-class QSnapdFindRefreshableRequestPrivate
+class QSnapdFindRefreshableRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdFindRefreshableRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdFindRefreshableRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdFindRefreshableRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snaps != NULL)
             g_ptr_array_unref (snaps);
     }
-    CallbackData *callback_data;
     GPtrArray *snaps = NULL;
 };
 
-class QSnapdInstallRequestPrivate : public QObject
+class QSnapdInstallRequestPrivate : public QObject, public QSnapdRequestPrivateBase
 {
 public:
     QSnapdInstallRequestPrivate (gpointer request, int flags, const QString& name, const QString& channel, const QString& revision, QIODevice *ioDevice, QObject *parent = NULL) :
-        QObject (parent),
+        QObject (parent), QSnapdRequestPrivateBase (request),
         flags(flags), name(name), channel(channel), revision(revision)
     {
-        callback_data = callback_data_new (request);
         if (ioDevice != NULL) {
             wrapper = (StreamWrapper *) g_object_new (stream_wrapper_get_type (), NULL);
             wrapper->ioDevice = ioDevice;
@@ -505,370 +363,228 @@ public:
     }
     ~QSnapdInstallRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         g_clear_object (&wrapper);
     }
     int flags;
     QString name;
     QString channel;
     QString revision;
-    CallbackData *callback_data;
     StreamWrapper *wrapper = NULL;
+    bool use_fd = false;
 };
 
-class QSnapdTryRequestPrivate
+class QSnapdTryRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdTryRequestPrivate (gpointer request, const QString& path) :
-        path(path) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdTryRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), path(path) {}
     QString path;
-    CallbackData *callback_data;
 };
 
-class QSnapdRefreshRequestPrivate
+class QSnapdRefreshRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdRefreshRequestPrivate (gpointer request, const QString& name, const QString& channel) :
-        name(name), channel(channel) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdRefreshRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), name(name), channel(channel) {}
     QString name;
     QString channel;
-    CallbackData *callback_data;
 };
 
-class QSnapdRefreshAllRequestPrivate
+class QSnapdRefreshAllRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdRefreshAllRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdRefreshAllRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdRefreshAllRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (snap_names != NULL)
             g_strfreev (snap_names);
     }
-    CallbackData *callback_data;
     GStrv snap_names = NULL;
 };
 
-class QSnapdRemoveRequestPrivate
+class QSnapdRemoveRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdRemoveRequestPrivate (gpointer request, int flags, const QString& name) :
-        flags(flags), name(name) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdRemoveRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), flags(flags), name(name) {}
     int flags;
     QString name;
-    CallbackData *callback_data;
 };
 
-class QSnapdEnableRequestPrivate
+class QSnapdEnableRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdEnableRequestPrivate (gpointer request, const QString& name) :
-        name(name) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdEnableRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), name(name) {}
     QString name;
-    CallbackData *callback_data;
 };
 
-class QSnapdDisableRequestPrivate
+class QSnapdDisableRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdDisableRequestPrivate (gpointer request, const QString& name) :
-        name(name) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdDisableRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), name(name) {}
     QString name;
-    CallbackData *callback_data;
 };
 
-class QSnapdSwitchChannelRequestPrivate
+class QSnapdSwitchChannelRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdSwitchChannelRequestPrivate (gpointer request, const QString& name, const QString& channel) :
-        name(name), channel(channel) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdSwitchChannelRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), name(name), channel(channel) {}
     QString name;
     QString channel;
-    CallbackData *callback_data;
 };
 
-class QSnapdCheckBuyRequestPrivate
+class QSnapdCheckBuyRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdCheckBuyRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdCheckBuyRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
-    CallbackData *callback_data;
+    QSnapdCheckBuyRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     bool canBuy;
 };
 
-class QSnapdBuyRequestPrivate
+class QSnapdBuyRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdBuyRequestPrivate (gpointer request, const QString& id, double amount, const QString& currency) :
-      id(id), amount(amount), currency(currency) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdBuyRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+      QSnapdRequestPrivateBase (request), id(id), amount(amount), currency(currency) {}
     QString id;
     double amount;
     QString currency;
-    CallbackData *callback_data;
 };
 
-class QSnapdCreateUserRequestPrivate
+class QSnapdCreateUserRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdCreateUserRequestPrivate (gpointer request, const QString& email, int flags) :
-      email(email), flags(flags) {
-        callback_data = callback_data_new (request);
-    }
+      QSnapdRequestPrivateBase (request), email(email), flags(flags) {}
     ~QSnapdCreateUserRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (info != NULL)
             g_object_unref (info);
     }
     QString email;
     int flags;
-    CallbackData *callback_data;
     SnapdUserInformation *info = NULL;
 };
 
-class QSnapdCreateUsersRequestPrivate
+class QSnapdCreateUsersRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdCreateUsersRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdCreateUsersRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdCreateUsersRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (info != NULL)
             g_ptr_array_unref (info);
     }
-    CallbackData *callback_data;
     GPtrArray *info = NULL;
 };
 
-class QSnapdGetUsersRequestPrivate
+class QSnapdGetUsersRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetUsersRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetUsersRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdGetUsersRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (info != NULL)
             g_ptr_array_unref (info);
     }
-    CallbackData *callback_data;
     GPtrArray *info = NULL;
 };
 
-class QSnapdGetSectionsRequestPrivate
+class QSnapdGetSectionsRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetSectionsRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetSectionsRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdGetSectionsRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (sections != NULL)
             g_strfreev (sections);
     }
-    CallbackData *callback_data;
     GStrv sections = NULL;
 };
 
-class QSnapdGetAliasesRequestPrivate
+class QSnapdGetAliasesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdGetAliasesRequestPrivate (gpointer request) {
-        callback_data = callback_data_new (request);
-    }
+    QSnapdGetAliasesRequestPrivate (gpointer request) :
+        QSnapdRequestPrivateBase (request) {}
     ~QSnapdGetAliasesRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (aliases != NULL)
             g_ptr_array_unref (aliases);
     }
-    CallbackData *callback_data;
     GPtrArray *aliases = NULL;
 };
 
-class QSnapdAliasRequestPrivate
+class QSnapdAliasRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdAliasRequestPrivate (gpointer request, const QString &snap, const QString &app, const QString &alias) :
-        snap (snap), app (app), alias (alias) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdAliasRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap), app (app), alias (alias) {}
     QString snap;
     QString app;
     QString alias;
-    CallbackData *callback_data;
 };
 
-class QSnapdUnaliasRequestPrivate
+class QSnapdUnaliasRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdUnaliasRequestPrivate (gpointer request, const QString &snap, const QString &alias) :
-        snap (snap), alias (alias) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdUnaliasRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap), alias (alias) {}
     QString snap;
     QString alias;
-    CallbackData *callback_data;
 };
 
-class QSnapdPreferRequestPrivate
+class QSnapdPreferRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdPreferRequestPrivate (gpointer request, const QString &snap) :
-        snap (snap) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdPreferRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap) {}
     QString snap;
-    CallbackData *callback_data;
     QString app;
     QString alias;
 };
 
-class QSnapdEnableAliasesRequestPrivate
+class QSnapdEnableAliasesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdEnableAliasesRequestPrivate (gpointer request, const QString &snap, const QStringList& aliases) :
-        snap (snap), aliases (aliases) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdEnableAliasesRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap), aliases (aliases) {}
     QString snap;
     QStringList aliases;
-    CallbackData *callback_data;
 };
 
-class QSnapdDisableAliasesRequestPrivate
+class QSnapdDisableAliasesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdDisableAliasesRequestPrivate (gpointer request, const QString &snap, const QStringList& aliases) :
-        snap (snap), aliases (aliases) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdDisableAliasesRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap), aliases (aliases) {}
     QString snap;
     QStringList aliases;
-    CallbackData *callback_data;
 };
 
-class QSnapdResetAliasesRequestPrivate
+class QSnapdResetAliasesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdResetAliasesRequestPrivate (gpointer request, const QString &snap, const QStringList& aliases) :
-        snap (snap), aliases (aliases) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdResetAliasesRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), snap (snap), aliases (aliases) {}
     QString snap;
     QStringList aliases;
-    CallbackData *callback_data;
 };
 
-class QSnapdRunSnapCtlRequestPrivate
+class QSnapdRunSnapCtlRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdRunSnapCtlRequestPrivate (gpointer request, const QString &contextId, const QStringList& args) :
-        contextId (contextId), args (args) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), contextId (contextId), args (args) {}
     ~QSnapdRunSnapCtlRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (stdout_output != NULL)
             g_free (stdout_output);
         if (stderr_output != NULL)
@@ -876,44 +592,43 @@ public:
     }
     QString contextId;
     QStringList args;
-    CallbackData *callback_data;
     gchar *stdout_output = NULL;
     gchar *stderr_output = NULL;
     int exit_code = 0;
 };
 
-class QSnapdDownloadRequestPrivate
+class QSnapdDownloadRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
-    QSnapdDownloadRequestPrivate (gpointer request, const QString &name, const QString& channel, const QString& revision) :
-        name (name), channel (channel), revision (revision) {
-        callback_data = callback_data_new (request);
+    QSnapdDownloadRequestPrivate (gpointer request, const QString &name, const QString& channel, const QString& revision, QIODevice *ioDevice) :
+        QSnapdRequestPrivateBase (request), name (name), channel (channel), revision (revision) {
+        if (ioDevice != NULL) {
+            wrapper = (OutputStreamWrapper *) g_object_new (output_stream_wrapper_get_type (), NULL);
+            wrapper->ioDevice = ioDevice;
+        }
     }
     ~QSnapdDownloadRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (data != NULL)
             g_bytes_unref (data);
+        g_clear_object (&wrapper);
     }
     QString name;
     QString channel;
     QString revision;
-    CallbackData *callback_data;
     GBytes *data = NULL;
+    OutputStreamWrapper *wrapper = NULL;
+    qint64 bytes_downloaded = 0;
+    qint64 total_bytes = -1;
 };
 
-class QSnapdCheckThemesRequestPrivate
+class QSnapdCheckThemesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdCheckThemesRequestPrivate (gpointer request, const QStringList& gtkThemeNames, const QStringList& iconThemeNames, const QStringList& soundThemeNames) :
-        gtkThemeNames (gtkThemeNames), iconThemeNames (iconThemeNames), soundThemeNames (soundThemeNames) {
-        callback_data = callback_data_new (request);
-    }
+        QSnapdRequestPrivateBase (request), gtkThemeNames (gtkThemeNames), iconThemeNames (iconThemeNames), soundThemeNames (soundThemeNames) {}
     ~QSnapdCheckThemesRequestPrivate ()
     {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
         if (gtk_theme_status != NULL)
             g_hash_table_unref (gtk_theme_status);
         if (icon_theme_status != NULL)
@@ -924,28 +639,19 @@ public:
     QStringList gtkThemeNames;
     QStringList iconThemeNames;
     QStringList soundThemeNames;
-    CallbackData *callback_data;
     GHashTable *gtk_theme_status;
     GHashTable *icon_theme_status;
     GHashTable *sound_theme_status;
 };
 
-class QSnapdInstallThemesRequestPrivate
+class QSnapdInstallThemesRequestPrivate : public QSnapdRequestPrivateBase
 {
 public:
     QSnapdInstallThemesRequestPrivate (gpointer request, const QStringList& gtkThemeNames, const QStringList& iconThemeNames, const QStringList& soundThemeNames) :
-        gtkThemeNames (gtkThemeNames), iconThemeNames (iconThemeNames), soundThemeNames (soundThemeNames) {
-        callback_data = callback_data_new (request);
-    }
-    ~QSnapdInstallThemesRequestPrivate ()
-    {
-        callback_data->request = NULL;
-        g_object_unref (callback_data);
-    }
+        QSnapdRequestPrivateBase (request), gtkThemeNames (gtkThemeNames), iconThemeNames (iconThemeNames), soundThemeNames (soundThemeNames) {}
     QStringList gtkThemeNames;
     QStringList iconThemeNames;
     QStringList soundThemeNames;
-    CallbackData *callback_data;
 };
 
 #endif
@@ -9,8 +9,12 @@
 
 #include <snapd-glib/snapd-glib.h>
 
+#include <QFile>
+
 #include "Snapd/client.h"
 #include "client-private.h"
+#include "request-private.h"
+#include "strv.h"
 #include "variant.h"
 
 G_DEFINE_TYPE (CallbackData, callback_data, G_TYPE_OBJECT)
@@ -62,6 +66,24 @@ QSnapdClient::QSnapdClient(int fd, QObject *parent) :
 QSnapdClient::~QSnapdClient()
 {}
 
+namespace {
+class SharedClient : public QSnapdClient
+{
+public:
+    SharedClient ()
+    {
+        setUseIOThread (true);
+    }
+};
+}
+
+Q_GLOBAL_STATIC (SharedClient, sharedClient)
+
+QSnapdClient *QSnapdClient::shared ()
+{
+    return sharedClient ();
+}
+
 QSnapdConnectRequest::~QSnapdConnectRequest ()
 {}
 
@@ -141,6 +163,36 @@ bool QSnapdClient::allowInteraction () const
     return snapd_client_get_allow_interaction (d->client);
 }
 
+void QSnapdClient::setIconCachePath (const QString &path)
+{
+    Q_D(QSnapdClient);
+    snapd_client_set_icon_cache_path (d->client, path.isNull () ? NULL : path.toStdString ().c_str ());
+}
+
+QString QSnapdClient::iconCachePath () const
+{
+    Q_D(const QSnapdClient);
+    return snapd_client_get_icon_cache_path (d->client);
+}
+
+void QSnapdClient::setUseIconCache (bool useIconCache)
+{
+    Q_D(QSnapdClient);
+    snapd_client_set_use_icon_cache (d->client, useIconCache);
+}
+
+void QSnapdClient::setUseIOThread (bool useIOThread)
+{
+    Q_D(QSnapdClient);
+    snapd_client_set_use_io_thread (d->client, useIOThread);
+}
+
+bool QSnapdClient::useIOThread () const
+{
+    Q_D(const QSnapdClient);
+    return snapd_client_get_use_io_thread (d->client);
+}
+
 QSnapdMaintenance *QSnapdClient::maintenance () const
 {
     Q_D(const QSnapdClient);
@@ -341,6 +393,12 @@ QSnapdGetIconRequest *QSnapdClient::getIcon (const QString& name)
     return new QSnapdGetIconRequest (name, d->client);
 }
 
+QSnapdGetIconRequest *QSnapdClient::getIcon (const QString& name, const QString& revision)
+{
+    Q_D(QSnapdClient);
+    return new QSnapdGetIconRequest (name, revision, d->client);
+}
+
 QSnapdGetAssertionsRequest::~QSnapdGetAssertionsRequest ()
 {}
 
@@ -758,6 +816,12 @@ QSnapdDownloadRequest *QSnapdClient::download (const QString& name, const QStrin
     return new QSnapdDownloadRequest (name, channel, revision, d->client);
 }
 
+QSnapdDownloadRequest *QSnapdClient::download (const QString& name, const QString& channel, const QString& revision, QIODevice *ioDevice)
+{
+    Q_D(QSnapdClient);
+    return new QSnapdDownloadRequest (name, channel, revision, ioDevice, d->client);
+}
+
 QSnapdCheckThemesRequest::~QSnapdCheckThemesRequest ()
 {}
 
@@ -829,24 +893,15 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     finish (error);
 }
 
-static void login_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdLoginRequest *request = static_cast<QSnapdLoginRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdLoginRequest::runAsync ()
 {
     Q_D(QSnapdLoginRequest);
 
     if (getClient () != NULL)
-        snapd_client_login2_async (SNAPD_CLIENT (getClient ()), d->email.toStdString ().c_str (), d->password.toStdString ().c_str (), d->otp.isNull () ? NULL : d->otp.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), login_ready_cb, g_object_ref (d->callback_data));
+        snapd_client_login2_async (SNAPD_CLIENT (getClient ()), d->email.toStdString ().c_str (), d->password.toStdString ().c_str (), d->otp.isNull () ? NULL : d->otp.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdLoginRequest>, g_object_ref (d->callback_data));
     else
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-        snapd_login_async (d->email.toStdString ().c_str (), d->password.toStdString ().c_str (), d->otp.isNull () ? NULL : d->otp.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), login_ready_cb, g_object_ref (d->callback_data));
+        snapd_login_async (d->email.toStdString ().c_str (), d->password.toStdString ().c_str (), d->otp.isNull () ? NULL : d->otp.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdLoginRequest>, g_object_ref (d->callback_data));
 G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
@@ -889,19 +944,10 @@ void QSnapdLogoutRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void logout_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdLogoutRequest *request = static_cast<QSnapdLogoutRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdLogoutRequest::runAsync ()
 {
     Q_D(QSnapdLogoutRequest);
-    snapd_client_logout_async (SNAPD_CLIENT (getClient ()), d->id, G_CANCELLABLE (getCancellable ()), logout_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_logout_async (SNAPD_CLIENT (getClient ()), d->id, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdLogoutRequest>, g_object_ref (d->callback_data));
 }
 
 static SnapdChangeFilter convertChangeFilter (int filter)
@@ -941,19 +987,10 @@ void QSnapdGetChangesRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void changes_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetChangesRequest *request = static_cast<QSnapdGetChangesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetChangesRequest::runAsync ()
 {
     Q_D(QSnapdGetChangesRequest);
-    snapd_client_get_changes_async (SNAPD_CLIENT (getClient ()), convertChangeFilter (d->filter), d->snapName.isNull () ? NULL : d->snapName.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), changes_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_changes_async (SNAPD_CLIENT (getClient ()), convertChangeFilter (d->filter), d->snapName.isNull () ? NULL : d->snapName.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetChangesRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetChangesRequest::changeCount () const
@@ -993,19 +1030,10 @@ void QSnapdGetChangeRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void change_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetChangeRequest *request = static_cast<QSnapdGetChangeRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetChangeRequest::runAsync ()
 {
     Q_D(QSnapdGetChangeRequest);
-    snapd_client_get_change_async (SNAPD_CLIENT (getClient ()), d->id.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), change_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_change_async (SNAPD_CLIENT (getClient ()), d->id.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetChangeRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdChange *QSnapdGetChangeRequest::change () const
@@ -1037,19 +1065,10 @@ void QSnapdAbortChangeRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void abort_change_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdAbortChangeRequest *request = static_cast<QSnapdAbortChangeRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdAbortChangeRequest::runAsync ()
 {
     Q_D(QSnapdAbortChangeRequest);
-    snapd_client_abort_change_async (SNAPD_CLIENT (getClient ()), d->id.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), abort_change_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_abort_change_async (SNAPD_CLIENT (getClient ()), d->id.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdAbortChangeRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdChange *QSnapdAbortChangeRequest::change () const
@@ -1081,19 +1100,10 @@ void QSnapdGetSystemInformationRequest::handleResult (void *object, void *result
     finish (error);
 }
 
-static void system_information_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetSystemInformationRequest *request = static_cast<QSnapdGetSystemInformationRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetSystemInformationRequest::runAsync ()
 {
     Q_D(QSnapdGetSystemInformationRequest);
-    snapd_client_get_system_information_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), system_information_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_system_information_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetSystemInformationRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdSystemInformation *QSnapdGetSystemInformationRequest::systemInformation ()
@@ -1125,19 +1135,10 @@ void QSnapdListRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void list_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdListRequest *request = static_cast<QSnapdListRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdListRequest::runAsync ()
 {
     Q_D(QSnapdListRequest);
-    snapd_client_get_snaps_async (SNAPD_CLIENT (getClient ()), SNAPD_GET_SNAPS_FLAGS_NONE, NULL, G_CANCELLABLE (getCancellable ()), list_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_snaps_async (SNAPD_CLIENT (getClient ()), SNAPD_GET_SNAPS_FLAGS_NONE, NULL, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdListRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdListRequest::snapCount () const
@@ -1155,21 +1156,6 @@ QSnapdSnap *QSnapdListRequest::snap (int n) const
     return new QSnapdSnap (d->snaps->pdata[n]);
 }
 
-static GStrv
-string_list_to_strv (const QStringList& list)
-{
-    GStrv value;
-    int size, i;
-
-    size = list.size ();
-    value = (GStrv) malloc (sizeof (gchar *) * (size + 1));
-    for (i = 0; i < size; i++)
-        value[i] = g_strdup (list[i].toStdString ().c_str ());
-    value[size] = NULL;
-
-    return value;
-}
-
 static SnapdGetSnapsFlags convertGetSnapsFlags (int flags)
 {
     int result = SNAPD_GET_SNAPS_FLAGS_NONE;
@@ -1188,7 +1174,7 @@ void QSnapdGetSnapsRequest::runSync ()
 {
     Q_D(QSnapdGetSnapsRequest);
 
-    g_auto(GStrv) snaps = string_list_to_strv (d->filter_snaps);
+    g_autofree gchar **snaps = string_list_to_strv (d->filter_snaps);
     g_autoptr(GError) error = NULL;
     d->snaps = snapd_client_get_snaps_sync (SNAPD_CLIENT (getClient ()), convertGetSnapsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
@@ -1204,21 +1190,12 @@ void QSnapdGetSnapsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_snaps_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetSnapsRequest *request = static_cast<QSnapdGetSnapsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetSnapsRequest::runAsync ()
 {
     Q_D(QSnapdGetSnapsRequest);
 
-    g_auto(GStrv) snaps = string_list_to_strv (d->filter_snaps);
-    snapd_client_get_snaps_async (SNAPD_CLIENT (getClient ()), convertGetSnapsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), get_snaps_ready_cb, g_object_ref (d->callback_data));
+    g_autofree gchar **snaps = string_list_to_strv (d->filter_snaps);
+    snapd_client_get_snaps_async (SNAPD_CLIENT (getClient ()), convertGetSnapsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetSnapsRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetSnapsRequest::snapCount () const
@@ -1236,6 +1213,19 @@ QSnapdSnap *QSnapdGetSnapsRequest::snap (int n) const
     return new QSnapdSnap (d->snaps->pdata[n]);
 }
 
+QVector<QSnapdSnapInfo> QSnapdGetSnapsRequest::snapInfos () const
+{
+    Q_D(const QSnapdGetSnapsRequest);
+
+    QVector<QSnapdSnapInfo> result;
+    if (d->snaps == NULL)
+        return result;
+    result.reserve (d->snaps->len);
+    for (guint i = 0; i < d->snaps->len; i++)
+        result.append (QSnapdSnapInfo (d->snaps->pdata[i]));
+    return result;
+}
+
 QSnapdListOneRequest::QSnapdListOneRequest (const QString& name, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
     d_ptr (new QSnapdListOneRequestPrivate (this, name)) {}
@@ -1259,19 +1249,10 @@ void QSnapdListOneRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void list_one_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdListOneRequest *request = static_cast<QSnapdListOneRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdListOneRequest::runAsync ()
 {
     Q_D(QSnapdListOneRequest);
-    snapd_client_get_snap_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), list_one_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_snap_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdListOneRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdSnap *QSnapdListOneRequest::snap () const
@@ -1303,19 +1284,10 @@ void QSnapdGetSnapRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_snap_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetSnapRequest *request = static_cast<QSnapdGetSnapRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetSnapRequest::runAsync ()
 {
     Q_D(QSnapdGetSnapRequest);
-    snapd_client_get_snap_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), get_snap_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_snap_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetSnapRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdSnap *QSnapdGetSnapRequest::snap () const
@@ -1332,7 +1304,7 @@ void QSnapdGetSnapConfRequest::runSync ()
 {
     Q_D(QSnapdGetSnapConfRequest);
 
-    g_auto(GStrv) keys = string_list_to_strv (d->keys);
+    g_autofree gchar **keys = string_list_to_strv (d->keys);
     g_autoptr(GError) error = NULL;
     d->configuration = snapd_client_get_snap_conf_sync (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), keys, G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
@@ -1348,21 +1320,12 @@ void QSnapdGetSnapConfRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_snap_conf_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetSnapConfRequest *request = static_cast<QSnapdGetSnapConfRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetSnapConfRequest::runAsync ()
 {
     Q_D(QSnapdGetSnapConfRequest);
 
-    g_auto(GStrv) keys = string_list_to_strv (d->keys);
-    snapd_client_get_snap_conf_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), keys, G_CANCELLABLE (getCancellable ()), get_snap_conf_ready_cb, g_object_ref (d->callback_data));
+    g_autofree gchar **keys = string_list_to_strv (d->keys);
+    snapd_client_get_snap_conf_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), keys, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetSnapConfRequest>, g_object_ref (d->callback_data));
 }
 
 QHash<QString, QVariant> *QSnapdGetSnapConfRequest::configuration () const
@@ -1382,6 +1345,36 @@ QHash<QString, QVariant> *QSnapdGetSnapConfRequest::configuration () const
     return conf;
 }
 
+QStringList QSnapdGetSnapConfRequest::keys () const
+{
+    Q_D(const QSnapdGetSnapConfRequest);
+
+    QStringList result;
+    if (d->configuration == NULL)
+        return result;
+    GHashTableIter iter;
+    g_hash_table_iter_init (&iter, d->configuration);
+    gpointer key;
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        result.append ((const gchar *) key);
+
+    return result;
+}
+
+QVariant QSnapdGetSnapConfRequest::value (const QString &key) const
+{
+    return configValue (key).toVariant ();
+}
+
+QSnapdConfigValue QSnapdGetSnapConfRequest::configValue (const QString &key) const
+{
+    Q_D(const QSnapdGetSnapConfRequest);
+
+    if (d->configuration == NULL)
+        return QSnapdConfigValue ();
+    return QSnapdConfigValue (g_hash_table_lookup (d->configuration, key.toUtf8 ().constData ()));
+}
+
 QSnapdSetSnapConfRequest::QSnapdSetSnapConfRequest (const QString& name, const QHash<QString, QVariant>& configuration, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
     d_ptr (new QSnapdSetSnapConfRequestPrivate (this, name, configuration)) {}
@@ -1463,21 +1456,12 @@ void QSnapdSetSnapConfRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void set_snap_conf_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdSetSnapConfRequest *request = static_cast<QSnapdSetSnapConfRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdSetSnapConfRequest::runAsync ()
 {
     Q_D(QSnapdSetSnapConfRequest);
 
     g_autoptr(GHashTable) key_values = configuration_to_key_values (d->configuration);
-    snapd_client_set_snap_conf_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), key_values, G_CANCELLABLE (getCancellable ()), set_snap_conf_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_set_snap_conf_async (SNAPD_CLIENT (getClient ()), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), key_values, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdSetSnapConfRequest>, g_object_ref (d->callback_data));
 }
 
 static SnapdGetAppsFlags convertGetAppsFlags (int flags)
@@ -1502,7 +1486,7 @@ void QSnapdGetAppsRequest::runSync ()
 {
     Q_D(QSnapdGetAppsRequest);
 
-    g_auto(GStrv) snaps = string_list_to_strv (d->filter_snaps);
+    g_autofree gchar **snaps = string_list_to_strv (d->filter_snaps);
     g_autoptr(GError) error = NULL;
     d->apps = snapd_client_get_apps2_sync (SNAPD_CLIENT (getClient ()), convertGetAppsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
@@ -1518,21 +1502,12 @@ void QSnapdGetAppsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_apps_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetAppsRequest *request = static_cast<QSnapdGetAppsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetAppsRequest::runAsync ()
 {
     Q_D(QSnapdGetAppsRequest);
 
-    g_auto(GStrv) snaps = string_list_to_strv (d->filter_snaps);
-    snapd_client_get_apps2_async (SNAPD_CLIENT (getClient ()), convertGetAppsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), get_apps_ready_cb, g_object_ref (d->callback_data));
+    g_autofree gchar **snaps = string_list_to_strv (d->filter_snaps);
+    snapd_client_get_apps2_async (SNAPD_CLIENT (getClient ()), convertGetAppsFlags (d->flags), snaps, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetAppsRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetAppsRequest::appCount () const
@@ -1550,16 +1525,36 @@ QSnapdApp *QSnapdGetAppsRequest::app (int n) const
     return new QSnapdApp (d->apps->pdata[n]);
 }
 
+QVector<QSnapdAppInfo> QSnapdGetAppsRequest::appInfos () const
+{
+    Q_D(const QSnapdGetAppsRequest);
+
+    QVector<QSnapdAppInfo> result;
+    if (d->apps == NULL)
+        return result;
+    result.reserve (d->apps->len);
+    for (guint i = 0; i < d->apps->len; i++)
+        result.append (QSnapdAppInfo (d->apps->pdata[i]));
+    return result;
+}
+
 QSnapdGetIconRequest::QSnapdGetIconRequest (const QString& name, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
-    d_ptr (new QSnapdGetIconRequestPrivate (this, name)) {}
+    d_ptr (new QSnapdGetIconRequestPrivate (this, name, QString ())) {}
+
+QSnapdGetIconRequest::QSnapdGetIconRequest (const QString& name, const QString& revision, void *snapd_client, QObject *parent) :
+    QSnapdRequest (snapd_client, parent),
+    d_ptr (new QSnapdGetIconRequestPrivate (this, name, revision)) {}
 
 void QSnapdGetIconRequest::runSync ()
 {
     Q_D(QSnapdGetIconRequest);
 
     g_autoptr(GError) error = NULL;
-    d->icon = snapd_client_get_icon_sync (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), &error);
+    if (d->revision.isNull ())
+        d->icon = snapd_client_get_icon_sync (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), &error);
+    else
+        d->icon = snapd_client_get_icon2_sync (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), d->revision.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
 }
 
@@ -1568,25 +1563,23 @@ void QSnapdGetIconRequest::handleResult (void *object, void *result)
     Q_D(QSnapdGetIconRequest);
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
+    g_autoptr(SnapdIcon) icon = NULL;
+    if (d->revision.isNull ())
+        icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
+    else
+        icon = snapd_client_get_icon2_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
 
     d->icon = (SnapdIcon*) g_steal_pointer (&icon);
     finish (error);
 }
 
-static void get_icon_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetIconRequest *request = static_cast<QSnapdGetIconRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetIconRequest::runAsync ()
 {
     Q_D(QSnapdGetIconRequest);
-    snapd_client_get_icon_async (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), get_icon_ready_cb, g_object_ref (d->callback_data));
+    if (d->revision.isNull ())
+        snapd_client_get_icon_async (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetIconRequest>, g_object_ref (d->callback_data));
+    else
+        snapd_client_get_icon2_async (SNAPD_CLIENT (getClient ()), d->name.toStdString ().c_str (), d->revision.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetIconRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdIcon *QSnapdGetIconRequest::icon () const
@@ -1619,29 +1612,17 @@ void QSnapdGetAssertionsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_assertions_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetAssertionsRequest *request = static_cast<QSnapdGetAssertionsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetAssertionsRequest::runAsync ()
 {
     Q_D(QSnapdGetAssertionsRequest);
-    snapd_client_get_assertions_async (SNAPD_CLIENT (getClient ()), d->type.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), get_assertions_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_assertions_async (SNAPD_CLIENT (getClient ()), d->type.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetAssertionsRequest>, g_object_ref (d->callback_data));
 }
 
 QStringList QSnapdGetAssertionsRequest::assertions () const
 {
     Q_D(const QSnapdGetAssertionsRequest);
 
-    QStringList result;
-    for (int i = 0; d->assertions[i] != NULL; i++)
-        result.append (d->assertions[i]);
-    return result;
+    return strv_to_string_list (d->assertions);
 }
 
 QSnapdAddAssertionsRequest::QSnapdAddAssertionsRequest (const QStringList& assertions, void *snapd_client, QObject *parent) :
@@ -1652,7 +1633,7 @@ void QSnapdAddAssertionsRequest::runSync ()
 {
     Q_D(QSnapdAddAssertionsRequest);
 
-    g_auto(GStrv) assertions = string_list_to_strv (d->assertions);
+    g_autofree gchar **assertions = string_list_to_strv (d->assertions);
     g_autoptr(GError) error = NULL;
     snapd_client_add_assertions_sync (SNAPD_CLIENT (getClient ()), assertions, G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
@@ -1667,21 +1648,12 @@ void QSnapdAddAssertionsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void add_assertions_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdAddAssertionsRequest *request = static_cast<QSnapdAddAssertionsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdAddAssertionsRequest::runAsync ()
 {
     Q_D(QSnapdAddAssertionsRequest);
 
-    g_auto(GStrv) assertions = string_list_to_strv (d->assertions);
-    snapd_client_add_assertions_async (SNAPD_CLIENT (getClient ()), assertions, G_CANCELLABLE (getCancellable ()), add_assertions_ready_cb, g_object_ref (d->callback_data));
+    g_autofree gchar **assertions = string_list_to_strv (d->assertions);
+    snapd_client_add_assertions_async (SNAPD_CLIENT (getClient ()), assertions, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdAddAssertionsRequest>, g_object_ref (d->callback_data));
 }
 
 static SnapdGetConnectionsFlags convertGetConnectionsFlags (int flags)
@@ -1724,19 +1696,10 @@ void QSnapdGetConnectionsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_connections_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetConnectionsRequest *request = static_cast<QSnapdGetConnectionsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetConnectionsRequest::runAsync ()
 {
     Q_D(QSnapdGetConnectionsRequest);
-    snapd_client_get_connections2_async (SNAPD_CLIENT (getClient ()), convertGetConnectionsFlags (d->flags), d->snap.isNull () ? NULL : d->snap.toStdString ().c_str (), d->interface.isNull () ? NULL : d->interface.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), get_connections_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_connections2_async (SNAPD_CLIENT (getClient ()), convertGetConnectionsFlags (d->flags), d->snap.isNull () ? NULL : d->snap.toStdString ().c_str (), d->interface.isNull () ? NULL : d->interface.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetConnectionsRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetConnectionsRequest::establishedCount () const
@@ -1829,20 +1792,11 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     finish (error);
 }
 
-static void get_interfaces_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetInterfacesRequest *request = static_cast<QSnapdGetInterfacesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetInterfacesRequest::runAsync ()
 {
     Q_D(QSnapdGetInterfacesRequest);
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    snapd_client_get_interfaces_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), get_interfaces_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_get_interfaces_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetInterfacesRequest>, g_object_ref (d->callback_data));
 G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
@@ -1900,7 +1854,7 @@ void QSnapdGetInterfaces2Request::runSync ()
 {
     Q_D(QSnapdGetInterfaces2Request);
 
-    g_auto(GStrv) names = string_list_to_strv (d->names);
+    g_autofree gchar **names = string_list_to_strv (d->names);
     g_autoptr(GError) error = NULL;
     d->interfaces = snapd_client_get_interfaces2_sync (SNAPD_CLIENT (getClient ()), convertInterfaceFlags (d->flags), names, G_CANCELLABLE (getCancellable ()), &error);
     finish (error);
@@ -1916,21 +1870,12 @@ void QSnapdGetInterfaces2Request::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_interfaces2_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetInterfaces2Request *request = static_cast<QSnapdGetInterfaces2Request*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetInterfaces2Request::runAsync ()
 {
     Q_D(QSnapdGetInterfaces2Request);
 
-    g_auto(GStrv) names = string_list_to_strv (d->names);
-    snapd_client_get_interfaces2_async (SNAPD_CLIENT (getClient ()), convertInterfaceFlags (d->flags), names, G_CANCELLABLE (getCancellable ()), get_interfaces2_ready_cb, g_object_ref (d->callback_data));
+    g_autofree gchar **names = string_list_to_strv (d->names);
+    snapd_client_get_interfaces2_async (SNAPD_CLIENT (getClient ()), convertInterfaceFlags (d->flags), names, G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetInterfaces2Request>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetInterfaces2Request::interfaceCount () const
@@ -1983,15 +1928,6 @@ void QSnapdConnectInterfaceRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void connect_interface_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdConnectInterfaceRequest *request = static_cast<QSnapdConnectInterfaceRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdConnectInterfaceRequest::runAsync ()
 {
     Q_D(QSnapdConnectInterfaceRequest);
@@ -1999,7 +1935,7 @@ void QSnapdConnectInterfaceRequest::runAsync ()
                                           d->plug_snap.toStdString ().c_str (), d->plug_name.toStdString ().c_str (),
                                           d->slot_snap.toStdString ().c_str (), d->slot_name.toStdString ().c_str (),
                                           progress_cb, d->callback_data,
-                                          G_CANCELLABLE (getCancellable ()), connect_interface_ready_cb, g_object_ref (d->callback_data));
+                                          G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdConnectInterfaceRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdDisconnectInterfaceRequest::QSnapdDisconnectInterfaceRequest (const QString &plug_snap, const QString &plug_name, const QString &slot_snap, const QString &slot_name, void *snapd_client, QObject *parent) :
@@ -2027,15 +1963,6 @@ void QSnapdDisconnectInterfaceRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void disconnect_interface_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdDisconnectInterfaceRequest *request = static_cast<QSnapdDisconnectInterfaceRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdDisconnectInterfaceRequest::runAsync ()
 {
     Q_D(QSnapdDisconnectInterfaceRequest);
@@ -2043,7 +1970,7 @@ void QSnapdDisconnectInterfaceRequest::runAsync ()
                                              d->plug_snap.toStdString ().c_str (), d->plug_name.toStdString ().c_str (),
                                              d->slot_snap.toStdString ().c_str (), d->slot_name.toStdString ().c_str (),
                                              progress_cb, d->callback_data,
-                                             G_CANCELLABLE (getCancellable ()), disconnect_interface_ready_cb, g_object_ref (d->callback_data));
+                                             G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdDisconnectInterfaceRequest>, g_object_ref (d->callback_data));
 }
 
 static SnapdFindFlags convertFindFlags (int flags)
@@ -2089,19 +2016,10 @@ void QSnapdFindRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void find_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdFindRequest *request = static_cast<QSnapdFindRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdFindRequest::runAsync ()
 {
     Q_D(QSnapdFindRequest);
-    snapd_client_find_section_async (SNAPD_CLIENT (getClient ()), convertFindFlags (d->flags), d->section.isNull () ? NULL : d->section.toStdString ().c_str (), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), find_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_find_section_async (SNAPD_CLIENT (getClient ()), convertFindFlags (d->flags), d->section.isNull () ? NULL : d->section.toStdString ().c_str (), d->name.isNull () ? NULL : d->name.toStdString ().c_str (), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdFindRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdFindRequest::snapCount () const
@@ -2119,6 +2037,19 @@ QSnapdSnap *QSnapdFindRequest::snap (int n) const
     return new QSnapdSnap (d->snaps->pdata[n]);
 }
 
+QVector<QSnapdSnapInfo> QSnapdFindRequest::snapInfos () const
+{
+    Q_D(const QSnapdFindRequest);
+
+    QVector<QSnapdSnapInfo> result;
+    if (d->snaps == NULL)
+        return result;
+    result.reserve (d->snaps->len);
+    for (guint i = 0; i < d->snaps->len; i++)
+        result.append (QSnapdSnapInfo (d->snaps->pdata[i]));
+    return result;
+}
+
 const QString QSnapdFindRequest::suggestedCurrency () const
 {
     Q_D(const QSnapdFindRequest);
@@ -2148,19 +2079,10 @@ void QSnapdFindRefreshableRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void find_refreshable_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdFindRefreshableRequest *request = static_cast<QSnapdFindRefreshableRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdFindRefreshableRequest::runAsync ()
 {
     Q_D(QSnapdFindRefreshableRequest);
-    snapd_client_find_refreshable_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), find_refreshable_ready_cb, g_object_ref (d->callback_data));
+    snapd_client_find_refreshable_async (SNAPD_CLIENT (getClient ()), G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdFindRefreshableRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdFindRefreshableRequest::snapCount () const
@@ -2194,6 +2116,19 @@ static SnapdInstallFlags convertInstallFlags (int flags)
     return (SnapdInstallFlags) result;
 }
 
+// Get the file descriptor of a QFile so the kernel can copy it directly, or -1 to read it as a stream
+static int getInstallFd (StreamWrapper *wrapper)
+{
+    if (wrapper == NULL)
+        return -1;
+
+    QFile *file = qobject_cast<QFile *> (wrapper->ioDevice.data ());
+    if (file == NULL || !file->isOpen () || file->pos () != 0 || (file->openMode () & QIODevice::ReadOnly) == 0)
+        return -1;
+
+    return file->handle ();
+}
+
 QSnapdInstallRequest::QSnapdInstallRequest (int flags, const QString& name, const QString& channel, const QString& revision, QIODevice *ioDevice, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
     d_ptr (new QSnapdInstallRequestPrivate (this, flags, name, channel, revision, ioDevice)) {}
@@ -2203,7 +2138,16 @@ void QSnapdInstallRequest::runSync ()
     Q_D(QSnapdInstallRequest);
 
     g_autoptr(GError) error = NULL;
-    if (d->wrapper != NULL) {
+    int fd = getInstallFd (d->wrapper);
+    d->use_fd = fd >= 0;
+    if (d->use_fd) {
+        snapd_client_install_fd_sync (SNAPD_CLIENT (getClient ()),
+                                      convertInstallFlags (d->flags),
+                                      fd,
+                                      progress_cb, d->callback_data,
+                                      G_CANCELLABLE (getCancellable ()), &error);
+    }
+    else if (d->wrapper != NULL) {
         snapd_client_install_stream_sync (SNAPD_CLIENT (getClient ()),
                                           convertInstallFlags (d->flags),
                                           G_INPUT_STREAM (d->wrapper),
@@ -2227,32 +2171,33 @@ void QSnapdInstallRequest::handleResult (void *object, void *result)
     Q_D(QSnapdInstallRequest);
 
     g_autoptr(GError) error = NULL;
-    if (d->wrapper != NULL)
+    if (d->use_fd)
+        snapd_client_install_fd_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
+    else if (d->wrapper != NULL)
         snapd_client_install_stream_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
     else
         snapd_client_install2_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
     finish (error);
 }
 
-static void install_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdInstallRequest *request = static_cast<QSnapdInstallRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdInstallRequest::runAsync ()
 {
     Q_D(QSnapdInstallRequest);
 
-    if (d->wrapper != NULL)
+    int fd = getInstallFd (d->wrapper);
+    d->use_fd = fd >= 0;
+    if (d->use_fd)
+        snapd_client_install_fd_async (SNAPD_CLIENT (getClient ()),
+                                       convertInstallFlags (d->flags),
+                                       fd,
+                                       progress_cb, d->callback_data,
+                                       G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdInstallRequest>, g_object_ref (d->callback_data));
+    else if (d->wrapper != NULL)
         snapd_client_install_stream_async (SNAPD_CLIENT (getClient ()),
                                            convertInstallFlags (d->flags),
                                            G_INPUT_STREAM (d->wrapper),
                                            progress_cb, d->callback_data,
-                                           G_CANCELLABLE (getCancellable ()), install_ready_cb, g_object_ref (d->callback_data));
+                                           G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdInstallRequest>, g_object_ref (d->callback_data));
     else
         snapd_client_install2_async (SNAPD_CLIENT (getClient ()),
                                      convertInstallFlags (d->flags),
@@ -2260,7 +2205,7 @@ void QSnapdInstallRequest::runAsync ()
                                      d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
                                      d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
                                      progress_cb, d->callback_data,
-                                     G_CANCELLABLE (getCancellable ()), install_ready_cb, g_object_ref (d->callback_data));
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdInstallRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdTryRequest::QSnapdTryRequest (const QString& path, void *snapd_client, QObject *parent) :
@@ -2286,22 +2231,13 @@ void QSnapdTryRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void try_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdTryRequest *request = static_cast<QSnapdTryRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdTryRequest::runAsync ()
 {
     Q_D(QSnapdTryRequest);
     snapd_client_try_async (SNAPD_CLIENT (getClient ()),
                             d->path.toStdString ().c_str (),
                             progress_cb, d->callback_data,
-                            G_CANCELLABLE (getCancellable ()), try_ready_cb, g_object_ref (d->callback_data));
+                            G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdTryRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdRefreshRequest::QSnapdRefreshRequest (const QString& name, const QString& channel, void *snapd_client, QObject *parent) :
@@ -2327,22 +2263,13 @@ void QSnapdRefreshRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void refresh_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdRefreshRequest *request = static_cast<QSnapdRefreshRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdRefreshRequest::runAsync ()
 {
     Q_D(QSnapdRefreshRequest);
     snapd_client_refresh_async (SNAPD_CLIENT (getClient ()),
                                 d->name.toStdString ().c_str (), d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
                                 progress_cb, d->callback_data,
-                                G_CANCELLABLE (getCancellable ()), refresh_ready_cb, g_object_ref (d->callback_data));
+                                G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdRefreshRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdRefreshAllRequest::QSnapdRefreshAllRequest (void *snapd_client, QObject *parent) :
@@ -2370,31 +2297,19 @@ void QSnapdRefreshAllRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void refresh_all_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdRefreshAllRequest *request = static_cast<QSnapdRefreshAllRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdRefreshAllRequest::runAsync ()
 {
     Q_D(QSnapdRefreshAllRequest);
     snapd_client_refresh_all_async (SNAPD_CLIENT (getClient ()),
                                     progress_cb, d->callback_data,
-                                    G_CANCELLABLE (getCancellable ()), refresh_all_ready_cb, g_object_ref (d->callback_data));
+                                    G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdRefreshAllRequest>, g_object_ref (d->callback_data));
 }
 
 QStringList QSnapdRefreshAllRequest::snapNames () const
 {
     Q_D(const QSnapdRefreshAllRequest);
 
-    QStringList result;
-    for (int i = 0; d->snap_names[i] != NULL; i++)
-        result.append (d->snap_names[i]);
-    return result;
+    return strv_to_string_list (d->snap_names);
 }
 
 static SnapdRemoveFlags convertRemoveFlags (int flags)
@@ -2431,15 +2346,6 @@ void QSnapdRemoveRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void remove_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdRemoveRequest *request = static_cast<QSnapdRemoveRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdRemoveRequest::runAsync ()
 {
     Q_D(QSnapdRemoveRequest);
@@ -2447,7 +2353,7 @@ void QSnapdRemoveRequest::runAsync ()
                                 convertRemoveFlags (d->flags),
                                 d->name.toStdString ().c_str (),
                                 progress_cb, d->callback_data,
-                                G_CANCELLABLE (getCancellable ()), remove_ready_cb, g_object_ref (d->callback_data));
+                                G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdRemoveRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdEnableRequest::QSnapdEnableRequest (const QString& name, void *snapd_client, QObject *parent) :
@@ -2473,22 +2379,13 @@ void QSnapdEnableRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void enable_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdEnableRequest *request = static_cast<QSnapdEnableRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdEnableRequest::runAsync ()
 {
     Q_D(QSnapdEnableRequest);
     snapd_client_enable_async (SNAPD_CLIENT (getClient ()),
                                d->name.toStdString ().c_str (),
                                progress_cb, d->callback_data,
-                               G_CANCELLABLE (getCancellable ()), enable_ready_cb, g_object_ref (d->callback_data));
+                               G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdEnableRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdDisableRequest::QSnapdDisableRequest (const QString& name, void *snapd_client, QObject *parent) :
@@ -2514,15 +2411,6 @@ void QSnapdDisableRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void disable_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdDisableRequest *request = static_cast<QSnapdDisableRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdDisableRequest::runAsync ()
 {
     Q_D(QSnapdDisableRequest);
@@ -2530,7 +2418,7 @@ void QSnapdDisableRequest::runAsync ()
     snapd_client_disable_async (SNAPD_CLIENT (getClient ()),
                                 d->name.toStdString ().c_str (),
                                 progress_cb, d->callback_data,
-                                G_CANCELLABLE (getCancellable ()), disable_ready_cb, g_object_ref (d->callback_data));
+                                G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdDisableRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdSwitchChannelRequest::QSnapdSwitchChannelRequest (const QString& name, const QString& channel, void *snapd_client, QObject *parent) :
@@ -2557,15 +2445,6 @@ void QSnapdSwitchChannelRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void switch_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdSwitchChannelRequest *request = static_cast<QSnapdSwitchChannelRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdSwitchChannelRequest::runAsync ()
 {
     Q_D(QSnapdSwitchChannelRequest);
@@ -2574,7 +2453,7 @@ void QSnapdSwitchChannelRequest::runAsync ()
                                d->name.toStdString ().c_str (),
                                d->channel.toStdString ().c_str (),
                                progress_cb, d->callback_data,
-                               G_CANCELLABLE (getCancellable ()), switch_ready_cb, g_object_ref (d->callback_data));
+                               G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdSwitchChannelRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdCheckBuyRequest::QSnapdCheckBuyRequest (void *snapd_client, QObject *parent):
@@ -2601,20 +2480,11 @@ void QSnapdCheckBuyRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void check_buy_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdCheckBuyRequest *request = static_cast<QSnapdCheckBuyRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdCheckBuyRequest::runAsync ()
 {
     Q_D(QSnapdCheckBuyRequest);
     snapd_client_check_buy_async (SNAPD_CLIENT (getClient ()),
-                                  G_CANCELLABLE (getCancellable ()), check_buy_ready_cb, g_object_ref (d->callback_data));
+                                  G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdCheckBuyRequest>, g_object_ref (d->callback_data));
 }
 
 bool QSnapdCheckBuyRequest::canBuy () const
@@ -2645,21 +2515,12 @@ void QSnapdBuyRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void buy_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdBuyRequest *request = static_cast<QSnapdBuyRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdBuyRequest::runAsync ()
 {
     Q_D(QSnapdBuyRequest);
     snapd_client_buy_async (SNAPD_CLIENT (getClient ()),
                             d->id.toStdString ().c_str (), d->amount, d->currency.toStdString ().c_str (),
-                            G_CANCELLABLE (getCancellable ()), buy_ready_cb, g_object_ref (d->callback_data));
+                            G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdBuyRequest>, g_object_ref (d->callback_data));
 }
 
 static SnapdCreateUserFlags convertCreateUserFlags (int flags)
@@ -2698,21 +2559,12 @@ void QSnapdCreateUserRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void create_user_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdCreateUserRequest *request = static_cast<QSnapdCreateUserRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdCreateUserRequest::runAsync ()
 {
     Q_D(QSnapdCreateUserRequest);
     snapd_client_create_user_async (SNAPD_CLIENT (getClient ()),
                                     d->email.toStdString ().c_str (), convertCreateUserFlags (d->flags),
-                                    G_CANCELLABLE (getCancellable ()), create_user_ready_cb, g_object_ref (d->callback_data));
+                                    G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdCreateUserRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdUserInformation *QSnapdCreateUserRequest::userInformation () const
@@ -2744,20 +2596,11 @@ void QSnapdCreateUsersRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void create_users_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdCreateUsersRequest *request = static_cast<QSnapdCreateUsersRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdCreateUsersRequest::runAsync ()
 {
     Q_D(QSnapdCreateUsersRequest);
     snapd_client_create_users_async (SNAPD_CLIENT (getClient ()),
-                                     G_CANCELLABLE (getCancellable ()), create_users_ready_cb, g_object_ref (d->callback_data));
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdCreateUsersRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdCreateUsersRequest::userInformationCount () const
@@ -2798,20 +2641,11 @@ void QSnapdGetUsersRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_users_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetUsersRequest *request = static_cast<QSnapdGetUsersRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetUsersRequest::runAsync ()
 {
     Q_D(QSnapdGetUsersRequest);
     snapd_client_get_users_async (SNAPD_CLIENT (getClient ()),
-                                  G_CANCELLABLE (getCancellable ()), get_users_ready_cb, g_object_ref (d->callback_data));
+                                  G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetUsersRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetUsersRequest::userInformationCount () const
@@ -2854,30 +2688,18 @@ void QSnapdGetSectionsRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_sections_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetSectionsRequest *request = static_cast<QSnapdGetSectionsRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetSectionsRequest::runAsync ()
 {
     Q_D(QSnapdGetSectionsRequest);
     snapd_client_get_sections_async (SNAPD_CLIENT (getClient ()),
-                                     G_CANCELLABLE (getCancellable ()), get_sections_ready_cb, g_object_ref (d->callback_data));
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetSectionsRequest>, g_object_ref (d->callback_data));
 }
 
 QStringList QSnapdGetSectionsRequest::sections () const
 {
     Q_D(const QSnapdGetSectionsRequest);
 
-    QStringList result;
-    for (int i = 0; d->sections[i] != NULL; i++)
-        result.append (d->sections[i]);
-    return result;
+    return strv_to_string_list (d->sections);
 }
 
 QSnapdGetAliasesRequest::QSnapdGetAliasesRequest (void *snapd_client, QObject *parent) :
@@ -2904,20 +2726,11 @@ void QSnapdGetAliasesRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void get_aliases_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdGetAliasesRequest *request = static_cast<QSnapdGetAliasesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdGetAliasesRequest::runAsync ()
 {
     Q_D(QSnapdGetAliasesRequest);
     snapd_client_get_aliases_async (SNAPD_CLIENT (getClient ()),
-                                    G_CANCELLABLE (getCancellable ()), get_aliases_ready_cb, g_object_ref (d->callback_data));
+                                    G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdGetAliasesRequest>, g_object_ref (d->callback_data));
 }
 
 int QSnapdGetAliasesRequest::aliasCount () const
@@ -2960,15 +2773,6 @@ void QSnapdAliasRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void alias_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdAliasRequest *request = static_cast<QSnapdAliasRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdAliasRequest::runAsync ()
 {
     Q_D(QSnapdAliasRequest);
@@ -2978,7 +2782,7 @@ void QSnapdAliasRequest::runAsync ()
                               d->app.toStdString ().c_str (),
                               d->alias.toStdString ().c_str (),
                               progress_cb, d->callback_data,
-                              G_CANCELLABLE (getCancellable ()), alias_ready_cb, g_object_ref (d->callback_data));
+                              G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdAliasRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdUnaliasRequest::QSnapdUnaliasRequest (const QString& snap, const QString& alias, void *snapd_client, QObject *parent) :
@@ -3005,15 +2809,6 @@ void QSnapdUnaliasRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void unalias_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdUnaliasRequest *request = static_cast<QSnapdUnaliasRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdUnaliasRequest::runAsync ()
 {
     Q_D(QSnapdUnaliasRequest);
@@ -3022,7 +2817,7 @@ void QSnapdUnaliasRequest::runAsync ()
                                 d->snap.isNull () ? NULL : d->snap.toStdString ().c_str (),
                                 d->alias.isNull () ? NULL : d->alias.toStdString ().c_str (),
                                 progress_cb, d->callback_data,
-                                G_CANCELLABLE (getCancellable ()), unalias_ready_cb, g_object_ref (d->callback_data));
+                                G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdUnaliasRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdPreferRequest::QSnapdPreferRequest (const QString& snap, void *snapd_client, QObject *parent) :
@@ -3048,15 +2843,6 @@ void QSnapdPreferRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void prefer_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdPreferRequest *request = static_cast<QSnapdPreferRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdPreferRequest::runAsync ()
 {
     Q_D(QSnapdPreferRequest);
@@ -3064,7 +2850,7 @@ void QSnapdPreferRequest::runAsync ()
     snapd_client_prefer_async (SNAPD_CLIENT (getClient ()),
                                d->snap.toStdString ().c_str (),
                                progress_cb, d->callback_data,
-                               G_CANCELLABLE (getCancellable ()), prefer_ready_cb, g_object_ref (d->callback_data));
+                               G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdPreferRequest>, g_object_ref (d->callback_data));
 }
 
 QSnapdEnableAliasesRequest::QSnapdEnableAliasesRequest (const QString& name, const QStringList& aliases, void *snapd_client, QObject *parent) :
@@ -3075,7 +2861,7 @@ void QSnapdEnableAliasesRequest::runSync ()
 {
     Q_D(QSnapdEnableAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
     g_autoptr(GError) error = NULL;
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_enable_aliases_sync (SNAPD_CLIENT (getClient ()),
@@ -3095,25 +2881,16 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     finish (error);
 }
 
-static void enable_aliases_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdEnableAliasesRequest *request = static_cast<QSnapdEnableAliasesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdEnableAliasesRequest::runAsync ()
 {
     Q_D(QSnapdEnableAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_disable_aliases_async (SNAPD_CLIENT (getClient ()),
                                        d->snap.toStdString ().c_str (), aliases,
                                        progress_cb, d->callback_data,
-                                       G_CANCELLABLE (getCancellable ()), enable_aliases_ready_cb, g_object_ref (d->callback_data));
+                                       G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdEnableAliasesRequest>, g_object_ref (d->callback_data));
 G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
@@ -3125,7 +2902,7 @@ void QSnapdDisableAliasesRequest::runSync ()
 {
     Q_D(QSnapdDisableAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
     g_autoptr(GError) error = NULL;
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_disable_aliases_sync (SNAPD_CLIENT (getClient ()),
@@ -3145,25 +2922,16 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     finish (error);
 }
 
-static void disable_aliases_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdDisableAliasesRequest *request = static_cast<QSnapdDisableAliasesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdDisableAliasesRequest::runAsync ()
 {
     Q_D(QSnapdDisableAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_disable_aliases_async (SNAPD_CLIENT (getClient ()),
                                        d->snap.toStdString ().c_str (), aliases,
                                        progress_cb, d->callback_data,
-                                       G_CANCELLABLE (getCancellable ()), disable_aliases_ready_cb, g_object_ref (d->callback_data));
+                                       G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdDisableAliasesRequest>, g_object_ref (d->callback_data));
 G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
@@ -3175,7 +2943,7 @@ void QSnapdResetAliasesRequest::runSync ()
 {
     Q_D(QSnapdResetAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
     g_autoptr(GError) error = NULL;
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_reset_aliases_sync (SNAPD_CLIENT (getClient ()),
@@ -3195,25 +2963,16 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     finish (error);
 }
 
-static void reset_aliases_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdResetAliasesRequest *request = static_cast<QSnapdResetAliasesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdResetAliasesRequest::runAsync ()
 {
     Q_D(QSnapdResetAliasesRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->aliases);
+    g_autofree gchar **aliases = string_list_to_strv (d->aliases);
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
     snapd_client_reset_aliases_async (SNAPD_CLIENT (getClient ()),
                                       d->snap.toStdString ().c_str (), aliases,
                                       progress_cb, d->callback_data,
-                                      G_CANCELLABLE (getCancellable ()), reset_aliases_ready_cb, g_object_ref (d->callback_data));
+                                      G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdResetAliasesRequest>, g_object_ref (d->callback_data));
 G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
@@ -3225,7 +2984,7 @@ void QSnapdRunSnapCtlRequest::runSync ()
 {
     Q_D(QSnapdRunSnapCtlRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->args);
+    g_autofree gchar **aliases = string_list_to_strv (d->args);
     g_autoptr(GError) error = NULL;
     snapd_client_run_snapctl2_sync (SNAPD_CLIENT (getClient ()),
                                     d->contextId.toStdString ().c_str (), aliases,
@@ -3244,23 +3003,14 @@ void QSnapdRunSnapCtlRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void run_snapctl_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-    if (callback_data->request != NULL) {
-        QSnapdRunSnapCtlRequest *request = static_cast<QSnapdRunSnapCtlRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdRunSnapCtlRequest::runAsync ()
 {
     Q_D(QSnapdRunSnapCtlRequest);
 
-    g_auto(GStrv) aliases = string_list_to_strv (d->args);
+    g_autofree gchar **aliases = string_list_to_strv (d->args);
     snapd_client_run_snapctl2_async (SNAPD_CLIENT (getClient ()),
                                      d->contextId.toStdString ().c_str (), aliases,
-                                     G_CANCELLABLE (getCancellable ()), run_snapctl_ready_cb, g_object_ref (d->callback_data));
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdRunSnapCtlRequest>, g_object_ref (d->callback_data));
 }
 
 QString QSnapdRunSnapCtlRequest::stdout () const
@@ -3283,18 +3033,42 @@ int QSnapdRunSnapCtlRequest::exitCode () const
 
 QSnapdDownloadRequest::QSnapdDownloadRequest (const QString& name, const QString &channel, const QString &revision, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
-    d_ptr (new QSnapdDownloadRequestPrivate (this, name, channel, revision)) {}
+    d_ptr (new QSnapdDownloadRequestPrivate (this, name, channel, revision, NULL)) {}
+
+QSnapdDownloadRequest::QSnapdDownloadRequest (const QString& name, const QString &channel, const QString &revision, QIODevice *ioDevice, void *snapd_client, QObject *parent) :
+    QSnapdRequest (snapd_client, parent),
+    d_ptr (new QSnapdDownloadRequestPrivate (this, name, channel, revision, ioDevice)) {}
+
+static void download_progress_cb (goffset current_num_bytes, goffset total_num_bytes, gpointer data)
+{
+    CallbackData *callback_data = (CallbackData *) data;
+    if (callback_data->request != NULL) {
+        QSnapdDownloadRequest *request = static_cast<QSnapdDownloadRequest*>(callback_data->request);
+        request->handleDownloadProgress (current_num_bytes, total_num_bytes);
+    }
+}
 
 void QSnapdDownloadRequest::runSync ()
 {
     Q_D(QSnapdDownloadRequest);
 
     g_autoptr(GError) error = NULL;
-    d->data = snapd_client_download_sync (SNAPD_CLIENT (getClient ()),
-                                          d->name.toStdString ().c_str (),
-                                          d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
-                                          d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
-                                          G_CANCELLABLE (getCancellable ()), &error);
+    if (d->wrapper != NULL) {
+        snapd_client_download_to_stream_sync (SNAPD_CLIENT (getClient ()),
+                                              d->name.toStdString ().c_str (),
+                                              d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
+                                              d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
+                                              G_OUTPUT_STREAM (d->wrapper),
+                                              download_progress_cb, d->callback_data,
+                                              G_CANCELLABLE (getCancellable ()), &error);
+    }
+    else {
+        d->data = snapd_client_download_sync (SNAPD_CLIENT (getClient ()),
+                                              d->name.toStdString ().c_str (),
+                                              d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
+                                              d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
+                                              G_CANCELLABLE (getCancellable ()), &error);
+    }
     finish (error);
 }
 
@@ -3303,39 +3077,74 @@ void QSnapdDownloadRequest::handleResult (void *object, void *result)
     Q_D(QSnapdDownloadRequest);
 
     g_autoptr(GError) error = NULL;
-    d->data = snapd_client_download_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
+    if (d->wrapper != NULL)
+        snapd_client_download_to_stream_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
+    else
+        d->data = snapd_client_download_finish (SNAPD_CLIENT (object), G_ASYNC_RESULT (result), &error);
     finish (error);
 }
 
-static void download_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
+void QSnapdDownloadRequest::handleDownloadProgress (qint64 bytesDownloaded, qint64 totalBytes)
 {
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-      if (callback_data->request != NULL) {
-        QSnapdDownloadRequest *request = static_cast<QSnapdDownloadRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
+    Q_D(QSnapdDownloadRequest);
+
+    d->bytes_downloaded = bytesDownloaded;
+    d->total_bytes = totalBytes;
+    emit progress ();
 }
 
 void QSnapdDownloadRequest::runAsync ()
 {
     Q_D(QSnapdDownloadRequest);
 
-    snapd_client_download_async (SNAPD_CLIENT (getClient ()),
-                                 d->name.toStdString ().c_str (),
-                                 d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
-                                 d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
-                                 G_CANCELLABLE (getCancellable ()), download_ready_cb, g_object_ref (d->callback_data));
+    if (d->wrapper != NULL) {
+        snapd_client_download_to_stream_async (SNAPD_CLIENT (getClient ()),
+                                               d->name.toStdString ().c_str (),
+                                               d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
+                                               d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
+                                               G_OUTPUT_STREAM (d->wrapper),
+                                               download_progress_cb, d->callback_data,
+                                               G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdDownloadRequest>, g_object_ref (d->callback_data));
+    }
+    else {
+        snapd_client_download_async (SNAPD_CLIENT (getClient ()),
+                                     d->name.toStdString ().c_str (),
+                                     d->channel.isNull () ? NULL : d->channel.toStdString ().c_str (),
+                                     d->revision.isNull () ? NULL : d->revision.toStdString ().c_str (),
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdDownloadRequest>, g_object_ref (d->callback_data));
+    }
 }
 
 QByteArray QSnapdDownloadRequest::data () const
 {
     Q_D(const QSnapdDownloadRequest);
 
+    if (d->data == NULL)
+        return QByteArray ();
+
     gsize length;
     gchar *raw_data = (gchar *) g_bytes_get_data (d->data, &length);
     return QByteArray::fromRawData (raw_data, length);
 }
 
+QSnapdBytes QSnapdDownloadRequest::bytes () const
+{
+    Q_D(const QSnapdDownloadRequest);
+    return QSnapdBytes (d->data);
+}
+
+qint64 QSnapdDownloadRequest::bytesDownloaded () const
+{
+    Q_D(const QSnapdDownloadRequest);
+    return d->bytes_downloaded;
+}
+
+qint64 QSnapdDownloadRequest::totalBytes () const
+{
+    Q_D(const QSnapdDownloadRequest);
+    return d->total_bytes;
+}
+
 QSnapdCheckThemesRequest::QSnapdCheckThemesRequest (const QStringList& gtkThemeNames, const QStringList& iconThemeNames, const QStringList& soundThemeNames, void *snapd_client, QObject *parent) :
     QSnapdRequest (snapd_client, parent),
     d_ptr (new QSnapdCheckThemesRequestPrivate (this, gtkThemeNames, iconThemeNames, soundThemeNames)) {}
@@ -3344,9 +3153,9 @@ void QSnapdCheckThemesRequest::runSync ()
 {
     Q_D(QSnapdCheckThemesRequest);
 
-    g_auto(GStrv) gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
-    g_auto(GStrv) icon_theme_names = string_list_to_strv (d->iconThemeNames);
-    g_auto(GStrv) sound_theme_names = string_list_to_strv (d->soundThemeNames);
+    g_autofree gchar **gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
+    g_autofree gchar **icon_theme_names = string_list_to_strv (d->iconThemeNames);
+    g_autofree gchar **sound_theme_names = string_list_to_strv (d->soundThemeNames);
     g_autoptr(GError) error = NULL;
     snapd_client_check_themes_sync (SNAPD_CLIENT (getClient ()),
                                     gtk_theme_names,
@@ -3368,27 +3177,18 @@ void QSnapdCheckThemesRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void check_themes_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-      if (callback_data->request != NULL) {
-        QSnapdCheckThemesRequest *request = static_cast<QSnapdCheckThemesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdCheckThemesRequest::runAsync ()
 {
     Q_D(QSnapdCheckThemesRequest);
 
-    g_auto(GStrv) gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
-    g_auto(GStrv) icon_theme_names = string_list_to_strv (d->iconThemeNames);
-    g_auto(GStrv) sound_theme_names = string_list_to_strv (d->soundThemeNames);
+    g_autofree gchar **gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
+    g_autofree gchar **icon_theme_names = string_list_to_strv (d->iconThemeNames);
+    g_autofree gchar **sound_theme_names = string_list_to_strv (d->soundThemeNames);
     snapd_client_check_themes_async (SNAPD_CLIENT (getClient ()),
                                      gtk_theme_names,
                                      icon_theme_names,
                                      sound_theme_names,
-                                     G_CANCELLABLE (getCancellable ()), check_themes_ready_cb, g_object_ref (d->callback_data));
+                                     G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdCheckThemesRequest>, g_object_ref (d->callback_data));
 }
 
 static QSnapdCheckThemesRequest::ThemeStatus convertThemeStatus (int status)
@@ -3434,9 +3234,9 @@ void QSnapdInstallThemesRequest::runSync ()
 {
     Q_D(QSnapdInstallThemesRequest);
 
-    g_auto(GStrv) gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
-    g_auto(GStrv) icon_theme_names = string_list_to_strv (d->iconThemeNames);
-    g_auto(GStrv) sound_theme_names = string_list_to_strv (d->soundThemeNames);
+    g_autofree gchar **gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
+    g_autofree gchar **icon_theme_names = string_list_to_strv (d->iconThemeNames);
+    g_autofree gchar **sound_theme_names = string_list_to_strv (d->soundThemeNames);
     g_autoptr(GError) error = NULL;
     snapd_client_install_themes_sync (SNAPD_CLIENT (getClient ()),
                                       gtk_theme_names,
@@ -3454,26 +3254,143 @@ void QSnapdInstallThemesRequest::handleResult (void *object, void *result)
     finish (error);
 }
 
-static void install_themes_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
-{
-    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
-      if (callback_data->request != NULL) {
-        QSnapdInstallThemesRequest *request = static_cast<QSnapdInstallThemesRequest*>(callback_data->request);
-        request->handleResult (object, result);
-    }
-}
-
 void QSnapdInstallThemesRequest::runAsync ()
 {
     Q_D(QSnapdInstallThemesRequest);
 
-    g_auto(GStrv) gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
-    g_auto(GStrv) icon_theme_names = string_list_to_strv (d->iconThemeNames);
-    g_auto(GStrv) sound_theme_names = string_list_to_strv (d->soundThemeNames);
+    g_autofree gchar **gtk_theme_names = string_list_to_strv (d->gtkThemeNames);
+    g_autofree gchar **icon_theme_names = string_list_to_strv (d->iconThemeNames);
+    g_autofree gchar **sound_theme_names = string_list_to_strv (d->soundThemeNames);
     snapd_client_install_themes_async (SNAPD_CLIENT (getClient ()),
                                        gtk_theme_names,
                                        icon_theme_names,
                                        sound_theme_names,
                                        progress_cb, d->callback_data,
-                                       G_CANCELLABLE (getCancellable ()), install_themes_ready_cb, g_object_ref (d->callback_data));
+                                       G_CANCELLABLE (getCancellable ()), request_ready_cb<QSnapdInstallThemesRequest>, g_object_ref (d->callback_data));
+}
+
+template <class T> static QFutureInterface<QSnapdResult<T>> *newFutureInterface ()
+{
+    QFutureInterface<QSnapdResult<T>> *interface = new QFutureInterface<QSnapdResult<T>> ();
+    interface->reportStarted ();
+    return interface;
+}
+
+template <class T> static void reportFutureResult (gpointer data, GError *error, const T& value)
+{
+    QFutureInterface<QSnapdResult<T>> *interface = static_cast<QFutureInterface<QSnapdResult<T>> *> (data);
+    if (error != NULL)
+        interface->reportResult (QSnapdResult<T> (convertError (error), error->message));
+    else
+        interface->reportResult (QSnapdResult<T> (value));
+    interface->reportFinished ();
+    delete interface;
+}
+
+static QVector<QSnapdSnapInfo> snapInfos (GPtrArray *snaps)
+{
+    QVector<QSnapdSnapInfo> result;
+    if (snaps == NULL)
+        return result;
+    result.reserve (snaps->len);
+    for (guint i = 0; i < snaps->len; i++)
+        result.append (QSnapdSnapInfo (snaps->pdata[i]));
+    return result;
+}
+
+static void get_snaps_future_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    reportFutureResult (data, error, snapInfos (snaps));
+}
+
+QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> QSnapdClient::getSnapsAsync (GetSnapsFlags flags, const QStringList &snaps)
+{
+    Q_D(QSnapdClient);
+
+    QFutureInterface<QSnapdResult<QVector<QSnapdSnapInfo>>> *interface = newFutureInterface<QVector<QSnapdSnapInfo>> ();
+    QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> future = interface->future ();
+    g_autofree gchar **names = string_list_to_strv (snaps);
+    snapd_client_get_snaps_async (d->client, convertGetSnapsFlags (flags), names, NULL, get_snaps_future_cb, interface);
+    return future;
+}
+
+static void find_future_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    reportFutureResult (data, error, snapInfos (snaps));
+}
+
+QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> QSnapdClient::findAsync (FindFlags flags, const QString &query)
+{
+    Q_D(QSnapdClient);
+
+    QFutureInterface<QSnapdResult<QVector<QSnapdSnapInfo>>> *interface = newFutureInterface<QVector<QSnapdSnapInfo>> ();
+    QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> future = interface->future ();
+    snapd_client_find_section_async (d->client, convertFindFlags (flags), NULL, query.isNull () ? NULL : query.toStdString ().c_str (), NULL, find_future_cb, interface);
+    return future;
+}
+
+static void get_apps_future_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_finish (SNAPD_CLIENT (object), result, &error);
+
+    QVector<QSnapdAppInfo> appInfos;
+    if (apps != NULL) {
+        appInfos.reserve (apps->len);
+        for (guint i = 0; i < apps->len; i++)
+            appInfos.append (QSnapdAppInfo (apps->pdata[i]));
+    }
+    reportFutureResult (data, error, appInfos);
+}
+
+QFuture<QSnapdResult<QVector<QSnapdAppInfo>>> QSnapdClient::getAppsAsync (GetAppsFlags flags, const QStringList &snaps)
+{
+    Q_D(QSnapdClient);
+
+    QFutureInterface<QSnapdResult<QVector<QSnapdAppInfo>>> *interface = newFutureInterface<QVector<QSnapdAppInfo>> ();
+    QFuture<QSnapdResult<QVector<QSnapdAppInfo>>> future = interface->future ();
+    g_autofree gchar **names = string_list_to_strv (snaps);
+    snapd_client_get_apps2_async (d->client, convertGetAppsFlags (flags), names, NULL, get_apps_future_cb, interface);
+    return future;
+}
+
+static QByteArray iconData (SnapdIcon *icon)
+{
+    if (icon == NULL)
+        return QByteArray ();
+
+    gsize length;
+    const gchar *data = (const gchar *) g_bytes_get_data (snapd_icon_get_data (icon), &length);
+    return QByteArray (data, length);
+}
+
+static void get_icon_future_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon2_finish (SNAPD_CLIENT (object), result, &error);
+    reportFutureResult (data, error, iconData (icon));
+}
+
+static void get_icon_no_revision_future_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), result, &error);
+    reportFutureResult (data, error, iconData (icon));
+}
+
+QFuture<QSnapdResult<QByteArray>> QSnapdClient::getIconAsync (const QString &name, const QString &revision)
+{
+    Q_D(QSnapdClient);
+
+    QFutureInterface<QSnapdResult<QByteArray>> *interface = newFutureInterface<QByteArray> ();
+    QFuture<QSnapdResult<QByteArray>> future = interface->future ();
+    if (revision.isNull ())
+        snapd_client_get_icon_async (d->client, name.toStdString ().c_str (), NULL, get_icon_no_revision_future_cb, interface);
+    else
+        snapd_client_get_icon2_async (d->client, name.toStdString ().c_str (), revision.toStdString ().c_str (), NULL, get_icon_future_cb, interface);
+    return future;
 }
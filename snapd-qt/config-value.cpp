@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <glib.h>
+
+#include "Snapd/config-value.h"
+#include "variant.h"
+
+QSnapdConfigValue::QSnapdConfigValue () : variant (NULL) {}
+
+QSnapdConfigValue::QSnapdConfigValue (void *variant) : variant (variant != NULL ? g_variant_ref ((GVariant *) variant) : NULL) {}
+
+QSnapdConfigValue::QSnapdConfigValue (const QSnapdConfigValue& other) : variant (other.variant != NULL ? g_variant_ref ((GVariant *) other.variant) : NULL) {}
+
+QSnapdConfigValue::QSnapdConfigValue (QSnapdConfigValue&& other) noexcept : variant (other.variant)
+{
+    other.variant = NULL;
+}
+
+QSnapdConfigValue::~QSnapdConfigValue ()
+{
+    if (variant != NULL)
+        g_variant_unref ((GVariant *) variant);
+}
+
+QSnapdConfigValue& QSnapdConfigValue::operator= (const QSnapdConfigValue& other)
+{
+    if (other.variant != NULL)
+        g_variant_ref ((GVariant *) other.variant);
+    if (variant != NULL)
+        g_variant_unref ((GVariant *) variant);
+    variant = other.variant;
+    return *this;
+}
+
+QSnapdConfigValue& QSnapdConfigValue::operator= (QSnapdConfigValue&& other) noexcept
+{
+    if (this != &other) {
+        if (variant != NULL)
+            g_variant_unref ((GVariant *) variant);
+        variant = other.variant;
+        other.variant = NULL;
+    }
+    return *this;
+}
+
+QSnapdConfigValue::Type QSnapdConfigValue::type () const
+{
+    GVariant *v = (GVariant *) variant;
+
+    if (v == NULL)
+        return Null;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE_BOOLEAN))
+        return Bool;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE_INT64))
+        return Int;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE_DOUBLE))
+        return Double;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE_STRING))
+        return String;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE ("av")))
+        return List;
+    if (g_variant_is_of_type (v, G_VARIANT_TYPE ("a{sv}")))
+        return Object;
+
+    return Null;
+}
+
+bool QSnapdConfigValue::isNull () const
+{
+    return type () == Null;
+}
+
+bool QSnapdConfigValue::toBool () const
+{
+    return type () == Bool && g_variant_get_boolean ((GVariant *) variant);
+}
+
+qlonglong QSnapdConfigValue::toLongLong () const
+{
+    switch (type ())
+    {
+    case Int:
+        return g_variant_get_int64 ((GVariant *) variant);
+    case Double:
+        return (qlonglong) g_variant_get_double ((GVariant *) variant);
+    default:
+        return 0;
+    }
+}
+
+double QSnapdConfigValue::toDouble () const
+{
+    switch (type ())
+    {
+    case Int:
+        return g_variant_get_int64 ((GVariant *) variant);
+    case Double:
+        return g_variant_get_double ((GVariant *) variant);
+    default:
+        return 0;
+    }
+}
+
+QString QSnapdConfigValue::toString () const
+{
+    if (type () != String)
+        return QString ();
+    return QString::fromUtf8 (g_variant_get_string ((GVariant *) variant, NULL));
+}
+
+QVariant QSnapdConfigValue::toVariant () const
+{
+    return gvariant_to_qvariant ((GVariant *) variant);
+}
+
+int QSnapdConfigValue::size () const
+{
+    Type t = type ();
+    if (t != List && t != Object)
+        return 0;
+    return g_variant_n_children ((GVariant *) variant);
+}
+
+QSnapdConfigValue QSnapdConfigValue::at (int index) const
+{
+    if (type () != List || index < 0 || (gsize) index >= g_variant_n_children ((GVariant *) variant))
+        return QSnapdConfigValue ();
+
+    g_autoptr(GVariant) child = g_variant_get_child_value ((GVariant *) variant, index);
+    g_autoptr(GVariant) value = g_variant_get_variant (child);
+    return QSnapdConfigValue (value);
+}
+
+QStringList QSnapdConfigValue::keys () const
+{
+    QStringList result;
+
+    if (type () != Object)
+        return result;
+
+    GVariantIter iter;
+    g_variant_iter_init (&iter, (GVariant *) variant);
+    const gchar *key;
+    while (g_variant_iter_next (&iter, "{&sv}", &key, NULL))
+        result.append (QString::fromUtf8 (key));
+
+    return result;
+}
+
+bool QSnapdConfigValue::contains (const QString& key) const
+{
+    if (type () != Object)
+        return false;
+
+    QByteArray k = key.toUtf8 ();
+    GVariantIter iter;
+    g_variant_iter_init (&iter, (GVariant *) variant);
+    const gchar *child_key;
+    while (g_variant_iter_next (&iter, "{&sv}", &child_key, NULL)) {
+        if (g_strcmp0 (child_key, k.constData ()) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+QSnapdConfigValue QSnapdConfigValue::value (const QString& key) const
+{
+    if (type () != Object)
+        return QSnapdConfigValue ();
+
+    g_autoptr(GVariant) value = g_variant_lookup_value ((GVariant *) variant, key.toUtf8 ().constData (), NULL);
+    return QSnapdConfigValue (value);
+}
@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/connection.h"
+#include "strv.h"
 #include "variant.h"
 
 QSnapdConnection::QSnapdConnection (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
@@ -48,10 +49,7 @@ bool QSnapdConnection::gadget () const
 QStringList QSnapdConnection::slotAttributeNames () const
 {
     g_auto(GStrv) names = snapd_connection_get_slot_attribute_names (SNAPD_CONNECTION (wrapped_object), NULL);
-    QStringList result;
-    for (int i = 0; names[i] != NULL; i++)
-        result.append (names[i]);
-    return result;
+    return strv_to_string_list (names);
 }
 
 bool QSnapdConnection::hasSlotAttribute (const QString &name) const
@@ -68,10 +66,7 @@ QVariant QSnapdConnection::slotAttribute (const QString &name) const
 QStringList QSnapdConnection::plugAttributeNames () const
 {
     g_auto(GStrv) names = snapd_connection_get_plug_attribute_names (SNAPD_CONNECTION (wrapped_object), NULL);
-    QStringList result;
-    for (int i = 0; names[i] != NULL; i++)
-        result.append (names[i]);
-    return result;
+    return strv_to_string_list (names);
 }
 
 bool QSnapdConnection::hasPlugAttribute (const QString &name) const
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QRunnable>
+#include <Snapd/Client>
+
+#include "icon-provider.h"
+
+// Maximum number of icons being fetched at once
+#define MAX_REQUESTS 4
+
+// Memory used for decoded icons, in kilobytes
+#define MAX_CACHE_SIZE (32 * 1024)
+
+class SnapdIconResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    SnapdIconResponse (const QString &id, const QSize &requestedSize, SnapdIconProvider *provider) :
+        id (id), requestedSize (requestedSize), provider (provider)
+    {
+        // Deleted by the engine once finished
+        setAutoDelete (false);
+    }
+
+    void run () override
+    {
+        if (cancelled.loadAcquire () == 0) {
+            if (!provider->lookup (id, &image))
+                fetch ();
+            if (!image.isNull () && requestedSize.isValid () && image.size () != requestedSize)
+                image = image.scaled (requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+
+        Q_EMIT finished ();
+    }
+
+    QQuickTextureFactory *textureFactory () const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage (image);
+    }
+
+    QString errorString () const override
+    {
+        return error;
+    }
+
+    void cancel () override
+    {
+        // Requests already running are left to complete, as the engine waits for finished()
+        cancelled.storeRelease (1);
+    }
+
+private:
+    void fetch ()
+    {
+        int separator = id.indexOf ('/');
+        QString name = separator < 0 ? id : id.left (separator);
+        QString revision = separator < 0 ? QString () : id.mid (separator + 1);
+
+        // Each thread has its own client so requests don't share a main context
+        QSnapdClient client;
+        client.setUseIconCache (true);
+        QScopedPointer<QSnapdGetIconRequest> request (revision.isEmpty () ? client.getIcon (name) : client.getIcon (name, revision));
+        request->runSync ();
+        if (request->error () != QSnapdRequest::NoError) {
+            error = request->errorString ();
+            return;
+        }
+
+        QScopedPointer<QSnapdIcon> icon (request->icon ());
+        if (!image.loadFromData (icon->data ())) {
+            error = QStringLiteral ("Failed to decode icon for %1").arg (name);
+            return;
+        }
+
+        provider->insert (id, image);
+    }
+
+    QString id;
+    QSize requestedSize;
+    SnapdIconProvider *provider;
+    QAtomicInt cancelled;
+    QImage image;
+    QString error;
+};
+
+SnapdIconProvider::SnapdIconProvider () :
+    images (MAX_CACHE_SIZE)
+{
+    pool.setMaxThreadCount (MAX_REQUESTS);
+}
+
+SnapdIconProvider::~SnapdIconProvider ()
+{
+    // Running responses use the cache
+    pool.waitForDone ();
+}
+
+QQuickImageResponse *SnapdIconProvider::requestImageResponse (const QString &id, const QSize &requestedSize)
+{
+    SnapdIconResponse *response = new SnapdIconResponse (id, requestedSize, this);
+    pool.start (response);
+    return response;
+}
+
+bool SnapdIconProvider::lookup (const QString &id, QImage *image)
+{
+    QMutexLocker locker (&mutex);
+    QImage *cached = images.object (id);
+    if (cached == NULL)
+        return false;
+    *image = *cached;
+    return true;
+}
+
+void SnapdIconProvider::insert (const QString &id, const QImage &image)
+{
+    QMutexLocker locker (&mutex);
+    int cost = qMax (1, (int) (image.sizeInBytes () / 1024));
+    images.insert (id, new QImage (image), cost);
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef ICON_PROVIDER_H
+#define ICON_PROVIDER_H
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <QtQuick/QQuickAsyncImageProvider>
+
+// Provides snap icons to QML as image://snapd-icon/<name> or image://snapd-icon/<name>/<revision>.
+// Icons are fetched and decoded in a thread pool, and recently used icons are kept in memory.
+// If a revision is given the icon is also stored in the on-disk icon cache.
+class SnapdIconProvider : public QQuickAsyncImageProvider
+{
+public:
+    SnapdIconProvider ();
+    ~SnapdIconProvider ();
+
+    QQuickImageResponse *requestImageResponse (const QString &id, const QSize &requestedSize) override;
+
+    bool lookup (const QString &id, QImage *image);
+    void insert (const QString &id, const QImage &image);
+
+private:
+    QThreadPool pool;
+    QMutex mutex;
+    QCache<QString, QImage> images;
+};
+
+#endif
@@ -25,3 +25,8 @@ QByteArray QSnapdIcon::data () const
     gchar *raw_data = (gchar *) g_bytes_get_data (data, &length);
     return QByteArray::fromRawData (raw_data, length);
 }
+
+QSnapdBytes QSnapdIcon::bytes () const
+{
+    return QSnapdBytes (snapd_icon_get_data (SNAPD_ICON (wrapped_object)));
+}
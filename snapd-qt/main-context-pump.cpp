@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <QtCore/QAbstractEventDispatcher>
+#include <QtCore/QThreadStorage>
+
+#include "main-context-pump.h"
+
+static QThreadStorage<QSnapdMainContextPump *> pumps;
+
+void QSnapdMainContextPump::ensure ()
+{
+    if (pumps.hasLocalData ())
+        return;
+
+    // Nothing to do if Qt already runs the GLib context or there's no Qt event loop in this thread
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance ();
+    if (dispatcher == NULL || dispatcher->inherits ("QEventDispatcherGlib"))
+        return;
+
+    // May already be run by a GMainLoop in another thread
+    g_autoptr(GMainContext) context = g_main_context_ref_thread_default ();
+    if (!g_main_context_acquire (context))
+        return;
+    g_main_context_release (context);
+
+    pumps.setLocalData (new QSnapdMainContextPump (context));
+}
+
+QSnapdMainContextPump::QSnapdMainContextPump (GMainContext *context, QObject *parent) :
+    QObject (parent),
+    context (g_main_context_ref (context)),
+    fds (8)
+{
+    timer.setSingleShot (true);
+    connect (&timer, &QTimer::timeout, this, &QSnapdMainContextPump::iterate);
+    connect (QAbstractEventDispatcher::instance (), &QAbstractEventDispatcher::aboutToBlock, this, &QSnapdMainContextPump::update);
+    update ();
+}
+
+QSnapdMainContextPump::~QSnapdMainContextPump ()
+{
+    qDeleteAll (notifiers);
+    g_main_context_unref (context);
+}
+
+// Check what the GLib context is waiting for, without dispatching anything as the Qt event loop is about to block
+void QSnapdMainContextPump::update ()
+{
+    if (!g_main_context_acquire (context))
+        return;
+
+    gint priority;
+    bool ready = g_main_context_prepare (context, &priority);
+    gint timeout;
+    gint n_fds;
+    while ((n_fds = g_main_context_query (context, priority, &timeout, fds.data (), fds.size ())) > fds.size ())
+        fds.resize (n_fds);
+    g_poll (fds.data (), n_fds, 0);
+    if (g_main_context_check (context, priority, fds.data (), n_fds))
+        ready = true;
+    g_main_context_release (context);
+
+    // Reuse the notifiers for file descriptors still being polled
+    QHash<qint64, QSocketNotifier *> oldNotifiers;
+    oldNotifiers.swap (notifiers);
+    for (int i = 0; i < n_fds; i++) {
+        if ((fds[i].events & (G_IO_IN | G_IO_HUP | G_IO_ERR)) != 0)
+            watch (oldNotifiers, fds[i].fd, QSocketNotifier::Read);
+        if ((fds[i].events & G_IO_OUT) != 0)
+            watch (oldNotifiers, fds[i].fd, QSocketNotifier::Write);
+    }
+    qDeleteAll (oldNotifiers);
+
+    if (ready)
+        timer.start (0);
+    else if (timeout >= 0)
+        timer.start (timeout);
+    else
+        timer.stop ();
+}
+
+void QSnapdMainContextPump::watch (QHash<qint64, QSocketNotifier *> &oldNotifiers, int fd, QSocketNotifier::Type type)
+{
+    qint64 key = ((qint64) fd << 2) | type;
+    QSocketNotifier *notifier = oldNotifiers.take (key);
+    if (notifier == NULL) {
+        notifier = new QSocketNotifier (fd, type, this);
+        connect (notifier, SIGNAL (activated (int)), this, SLOT (iterate ()));
+    }
+    notifiers.insert (key, notifier);
+}
+
+void QSnapdMainContextPump::iterate ()
+{
+    g_main_context_iteration (context, FALSE);
+
+    // Stop watching file descriptors that have been closed before Qt next polls
+    update ();
+}
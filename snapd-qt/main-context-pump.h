@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef MAIN_CONTEXT_PUMP_H
+#define MAIN_CONTEXT_PUMP_H
+
+#include <glib.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+// Runs the GLib main context of a thread from the Qt event loop, for when Qt isn't using the GLib
+// event dispatcher (e.g. QT_NO_GLIB=1 or a Qt built without GLib support).
+// The context file descriptors are watched with QSocketNotifier and timeouts with a QTimer, and
+// are updated each time the Qt event loop is about to block.
+class QSnapdMainContextPump : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Start running the GLib context for the current thread, if required
+    static void ensure ();
+
+    ~QSnapdMainContextPump ();
+
+private Q_SLOTS:
+    void update ();
+    void iterate ();
+
+private:
+    explicit QSnapdMainContextPump (GMainContext *context, QObject *parent = 0);
+    void watch (QHash<qint64, QSocketNotifier *> &oldNotifiers, int fd, QSocketNotifier::Type type);
+
+    GMainContext *context;
+    QVector<GPollFD> fds;
+    QHash<qint64, QSocketNotifier *> notifiers;
+    QTimer timer;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/markdown-document.h"
+
+QSnapdMarkdownDocument::QSnapdMarkdownDocument (void *snapd_object, QObject *parent) : QSnapdWrappedObject (snapd_object, g_object_unref, parent) {}
+
+static const SnapdMarkdownFlatNode *
+get_node (void *document, int index)
+{
+    guint n_nodes;
+    const SnapdMarkdownFlatNode *nodes = snapd_markdown_document_get_nodes (SNAPD_MARKDOWN_DOCUMENT (document), &n_nodes);
+    if (index < 0 || (guint) index >= n_nodes)
+        return NULL;
+    return &nodes[index];
+}
+
+int QSnapdMarkdownDocument::nodeCount () const
+{
+    guint n_nodes;
+    snapd_markdown_document_get_nodes (SNAPD_MARKDOWN_DOCUMENT (wrapped_object), &n_nodes);
+    return n_nodes;
+}
+
+QSnapdMarkdownNode::NodeType QSnapdMarkdownDocument::nodeType (int index) const
+{
+    const SnapdMarkdownFlatNode *node = get_node (wrapped_object, index);
+    if (node == NULL)
+        return QSnapdMarkdownNode::NodeTypeText;
+
+    switch (node->node_type)
+    {
+    default:
+    case SNAPD_MARKDOWN_NODE_TYPE_TEXT:
+        return QSnapdMarkdownNode::NodeTypeText;
+    case SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH:
+        return QSnapdMarkdownNode::NodeTypeParagraph;
+    case SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST:
+        return QSnapdMarkdownNode::NodeTypeUnorderedList;
+    case SNAPD_MARKDOWN_NODE_TYPE_LIST_ITEM:
+        return QSnapdMarkdownNode::NodeTypeListItem;
+    case SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK:
+        return QSnapdMarkdownNode::NodeTypeCodeBlock;
+    case SNAPD_MARKDOWN_NODE_TYPE_CODE_SPAN:
+        return QSnapdMarkdownNode::NodeTypeCodeSpan;
+    case SNAPD_MARKDOWN_NODE_TYPE_EMPHASIS:
+        return QSnapdMarkdownNode::NodeTypeEmphasis;
+    case SNAPD_MARKDOWN_NODE_TYPE_STRONG_EMPHASIS:
+        return QSnapdMarkdownNode::NodeTypeStrongEmphasis;
+    case SNAPD_MARKDOWN_NODE_TYPE_URL:
+        return QSnapdMarkdownNode::NodeTypeUrl;
+    }
+}
+
+QString QSnapdMarkdownDocument::nodeText (int index) const
+{
+    const SnapdMarkdownFlatNode *node = get_node (wrapped_object, index);
+    if (node == NULL || node->node_type != SNAPD_MARKDOWN_NODE_TYPE_TEXT)
+        return QString ();
+
+    const gchar *text = snapd_markdown_document_get_text (SNAPD_MARKDOWN_DOCUMENT (wrapped_object));
+    return QString::fromUtf8 (text + node->text_offset, node->text_length);
+}
+
+int QSnapdMarkdownDocument::firstChild (int index) const
+{
+    const SnapdMarkdownFlatNode *node = get_node (wrapped_object, index);
+    return node != NULL ? node->first_child : -1;
+}
+
+int QSnapdMarkdownDocument::nextSibling (int index) const
+{
+    const SnapdMarkdownFlatNode *node = get_node (wrapped_object, index);
+    return node != NULL ? node->next_sibling : -1;
+}
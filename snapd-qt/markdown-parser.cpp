@@ -9,7 +9,11 @@
 
 #include <snapd-glib/snapd-glib.h>
 
+#include <QtCore/QPointer>
+
 #include "Snapd/markdown-parser.h"
+#include "main-context-pump.h"
+#include "strv.h"
 
 class QSnapdMarkdownParserPrivate
 {
@@ -24,16 +28,50 @@ public:
             break;
         }
         parser = snapd_markdown_parser_new (v);
+        cancellable = g_cancellable_new ();
     }
 
     ~QSnapdMarkdownParserPrivate ()
     {
+        g_cancellable_cancel (cancellable);
+        g_object_unref (cancellable);
         g_object_unref (parser);
     }
 
     SnapdMarkdownParser *parser;
+    GCancellable *cancellable;
+};
+
+static QList<QSnapdMarkdownNode> make_node_list (GPtrArray *nodes)
+{
+    QList<QSnapdMarkdownNode> nodes_list;
+    for (uint i = 0; i < nodes->len; i++) {
+        SnapdMarkdownNode *node = (SnapdMarkdownNode *) g_ptr_array_index (nodes, i);
+        nodes_list.append (QSnapdMarkdownNode (node));
+    }
+    return nodes_list;
+}
+
+// Texts being parsed, the parser may be destroyed before they complete
+struct ParseCallbackData
+{
+    QPointer<QSnapdMarkdownParser> parser;
+    QStringList texts;
 };
 
+static void parse_ready_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    ParseCallbackData *data = (ParseCallbackData *) user_data;
+
+    g_autoptr(GPtrArray) results = snapd_markdown_parser_parse_many_finish (SNAPD_MARKDOWN_PARSER (object), result, NULL);
+    if (results != NULL && !data->parser.isNull ()) {
+        for (uint i = 0; i < results->len; i++)
+            Q_EMIT data->parser->parsed (data->texts[i], make_node_list ((GPtrArray *) g_ptr_array_index (results, i)));
+    }
+
+    delete data;
+}
+
 QSnapdMarkdownParser::QSnapdMarkdownParser (QSnapdMarkdownParser::MarkdownVersion version, QObject *parent) :
      QObject (parent),
      d_ptr (new QSnapdMarkdownParserPrivate (version)) {}
@@ -57,10 +95,38 @@ QList<QSnapdMarkdownNode> QSnapdMarkdownParser::parse (const QString &text) cons
 {
     Q_D(const QSnapdMarkdownParser);
     g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (d->parser, text.toStdString ().c_str ());
-    QList<QSnapdMarkdownNode> nodes_list;
-    for (uint i = 0; i < nodes->len; i++) {
-        SnapdMarkdownNode *node = (SnapdMarkdownNode *) g_ptr_array_index (nodes, i);
-        nodes_list.append (QSnapdMarkdownNode (node));
-    }
-    return nodes_list;
+    return make_node_list (nodes);
+}
+
+QSnapdMarkdownDocument *QSnapdMarkdownParser::parseFlat (const QString &text) const
+{
+    Q_D(const QSnapdMarkdownParser);
+    return new QSnapdMarkdownDocument (snapd_markdown_parser_parse_flat (d->parser, text.toStdString ().c_str ()));
+}
+
+void QSnapdMarkdownParser::parseAsync (const QString &text)
+{
+    parseManyAsync (QStringList (text));
+}
+
+void QSnapdMarkdownParser::parseManyAsync (const QStringList &texts)
+{
+    Q_D(QSnapdMarkdownParser);
+
+    // Results are returned in the GLib context of this thread, so make sure it is being run
+    QSnapdMainContextPump::ensure ();
+
+    ParseCallbackData *data = new ParseCallbackData;
+    data->parser = this;
+    data->texts = texts;
+    g_autofree gchar **strv = string_list_to_strv (texts);
+    snapd_markdown_parser_parse_many_async (d->parser, strv, d->cancellable, parse_ready_cb, data);
+}
+
+void QSnapdMarkdownParser::cancelParsing ()
+{
+    Q_D(QSnapdMarkdownParser);
+    g_cancellable_cancel (d->cancellable);
+    g_object_unref (d->cancellable);
+    d->cancellable = g_cancellable_new ();
 }
@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/plug.h"
+#include "strv.h"
 #include "variant.h"
 
 QSnapdPlug::QSnapdPlug (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
@@ -32,10 +33,7 @@ QString QSnapdPlug::interface () const
 QStringList QSnapdPlug::attributeNames () const
 {
     g_auto(GStrv) names = snapd_plug_get_attribute_names (SNAPD_PLUG (wrapped_object), NULL);
-    QStringList result;
-    for (int i = 0; names[i] != NULL; i++)
-        result.append (names[i]);
-    return result;
+    return strv_to_string_list (names);
 }
 
 bool QSnapdPlug::hasAttribute (const QString &name) const
@@ -8,7 +8,11 @@
  */
 
 #include <QtQml/QtQml>
+#include <Snapd/AppListModel>
+#include <Snapd/ChangeListModel>
 #include <Snapd/Client>
+#include <Snapd/SnapListModel>
+#include "icon-provider.h"
 #include "qml-plugin.h"
 
 void SnapdQmlPlugin::registerTypes(const char *uri)
@@ -16,6 +20,9 @@ void SnapdQmlPlugin::registerTypes(const char *uri)
     Q_ASSERT(uri == QLatin1String("Snapd"));
     qmlRegisterType<QSnapdClient>(uri, 1, 0, "SnapdClient");
     qmlRegisterType<QSnapdAuthData>(uri, 1, 0, "SnapdAuthData");
+    qmlRegisterType<QSnapdSnapListModel>(uri, 1, 0, "SnapdSnapListModel");
+    qmlRegisterType<QSnapdAppListModel>(uri, 1, 0, "SnapdAppListModel");
+    qmlRegisterType<QSnapdChangeListModel>(uri, 1, 0, "SnapdChangeListModel");
     qmlRegisterUncreatableType<QSnapdIcon>(uri, 1, 0, "SnapdIcon", "Can't create");
     qmlRegisterUncreatableType<QSnapdConnection>(uri, 1, 0, "SnapdConnection", "Can't create");
     qmlRegisterUncreatableType<QSnapdSnap>(uri, 1, 0, "SnapdSnap", "Can't create");
@@ -39,3 +46,9 @@ void SnapdQmlPlugin::registerTypes(const char *uri)
     qmlRegisterUncreatableType<QSnapdCheckBuyRequest>(uri, 1, 0, "SnapdCheckBuyRequest", "Can't create");
     qmlRegisterUncreatableType<QSnapdBuyRequest>(uri, 1, 0, "SnapdBuyRequest", "Can't create");
 }
+
+void SnapdQmlPlugin::initializeEngine(QQmlEngine *engine, const char *uri)
+{
+    Q_UNUSED(uri);
+    engine->addImageProvider("snapd-icon", new SnapdIconProvider ());
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef REQUEST_TEMPLATE_H
+#define REQUEST_TEMPLATE_H
+
+#include <snapd-glib/snapd-glib.h>
+
+#include <QtCore/QtGlobal>
+
+G_DECLARE_FINAL_TYPE (CallbackData, callback_data, SNAPD, CALLBACK_DATA, GObject)
+
+struct _CallbackData
+{
+    GObject parent_instance;
+    gpointer request;
+};
+
+CallbackData *callback_data_new (gpointer request);
+
+// Private data shared by all requests. GLib callbacks hold a reference to callback_data,
+// which is detached when the request is deleted so late callbacks are ignored.
+class QSnapdRequestPrivateBase
+{
+public:
+    explicit QSnapdRequestPrivateBase (gpointer request) :
+        callback_data (callback_data_new (request)) {}
+    ~QSnapdRequestPrivateBase ()
+    {
+        callback_data->request = NULL;
+        g_object_unref (callback_data);
+    }
+    CallbackData *callback_data;
+
+private:
+    Q_DISABLE_COPY (QSnapdRequestPrivateBase)
+};
+
+// GAsyncReadyCallback passing the result to Request::handleResult (), used with g_object_ref (d->callback_data) as the user data
+template <class Request>
+static void request_ready_cb (GObject *object, GAsyncResult *result, gpointer data)
+{
+    g_autoptr(CallbackData) callback_data = (CallbackData *) data;
+    if (callback_data->request != NULL) {
+        Request *request = static_cast<Request*>(callback_data->request);
+        request->handleResult (object, result);
+    }
+}
+
+#endif
@@ -9,7 +9,13 @@
 
 #include <snapd-glib/snapd-glib.h>
 
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+
 #include "Snapd/request.h"
+#include "main-context-pump.h"
+#include "request-private.h"
 
 class QSnapdRequestPrivate
 {
@@ -18,6 +24,9 @@ public:
     {
         client = SNAPD_CLIENT (g_object_ref (snapd_client));
         cancellable = g_cancellable_new ();
+
+        // Results are returned in the GLib context of this thread, so make sure it is being run
+        QSnapdMainContextPump::ensure ();
     }
 
     ~QSnapdRequestPrivate ()
@@ -32,11 +41,113 @@ public:
     SnapdClient *client;
     GCancellable *cancellable;
     bool finished = false;
+    // TRUE while runSync () is running in the request thread pool
+    bool inThreadPool = false;
     QSnapdRequest::QSnapdError error = QSnapdRequest::NoError;
     QString errorString;
     SnapdChange *change = NULL;
 };
 
+QSnapdRequest::QSnapdError convertError (void *error)
+{
+    GError *e = (GError *) error;
+    if (e->domain == SNAPD_ERROR) {
+        switch ((SnapdError) e->code)
+        {
+        case SNAPD_ERROR_CONNECTION_FAILED:
+            return QSnapdRequest::QSnapdError::ConnectionFailed;
+        case SNAPD_ERROR_WRITE_FAILED:
+            return QSnapdRequest::QSnapdError::WriteFailed;
+        case SNAPD_ERROR_READ_FAILED:
+            return QSnapdRequest::QSnapdError::ReadFailed;
+        case SNAPD_ERROR_BAD_REQUEST:
+            return QSnapdRequest::QSnapdError::BadRequest;
+        case SNAPD_ERROR_BAD_RESPONSE:
+            return QSnapdRequest::QSnapdError::BadResponse;
+        case SNAPD_ERROR_AUTH_DATA_REQUIRED:
+            return QSnapdRequest::QSnapdError::AuthDataRequired;
+        case SNAPD_ERROR_AUTH_DATA_INVALID:
+            return QSnapdRequest::QSnapdError::AuthDataInvalid;
+        case SNAPD_ERROR_TWO_FACTOR_REQUIRED:
+            return QSnapdRequest::QSnapdError::TwoFactorRequired;
+        case SNAPD_ERROR_TWO_FACTOR_INVALID:
+            return QSnapdRequest::QSnapdError::TwoFactorInvalid;
+        case SNAPD_ERROR_PERMISSION_DENIED:
+            return QSnapdRequest::QSnapdError::PermissionDenied;
+        case SNAPD_ERROR_FAILED:
+            return QSnapdRequest::QSnapdError::Failed;
+        case SNAPD_ERROR_TERMS_NOT_ACCEPTED:
+            return QSnapdRequest::QSnapdError::TermsNotAccepted;
+        case SNAPD_ERROR_PAYMENT_NOT_SETUP:
+            return QSnapdRequest::QSnapdError::PaymentNotSetup;
+        case SNAPD_ERROR_PAYMENT_DECLINED:
+            return QSnapdRequest::QSnapdError::PaymentDeclined;
+        case SNAPD_ERROR_ALREADY_INSTALLED:
+            return QSnapdRequest::QSnapdError::AlreadyInstalled;
+        case SNAPD_ERROR_NOT_INSTALLED:
+            return QSnapdRequest::QSnapdError::NotInstalled;
+        case SNAPD_ERROR_NO_UPDATE_AVAILABLE:
+            return QSnapdRequest::QSnapdError::NoUpdateAvailable;
+        case SNAPD_ERROR_PASSWORD_POLICY_ERROR:
+            return QSnapdRequest::QSnapdError::PasswordPolicyError;
+        case SNAPD_ERROR_NEEDS_DEVMODE:
+            return QSnapdRequest::QSnapdError::NeedsDevmode;
+        case SNAPD_ERROR_NEEDS_CLASSIC:
+            return QSnapdRequest::QSnapdError::NeedsClassic;
+        case SNAPD_ERROR_NEEDS_CLASSIC_SYSTEM:
+            return QSnapdRequest::QSnapdError::NeedsClassicSystem;
+        case SNAPD_ERROR_BAD_QUERY:
+            return QSnapdRequest::QSnapdError::BadQuery;
+        case SNAPD_ERROR_NETWORK_TIMEOUT:
+            return QSnapdRequest::QSnapdError::NetworkTimeout;
+        case SNAPD_ERROR_NOT_FOUND:
+            return QSnapdRequest::QSnapdError::NotFound;
+        case SNAPD_ERROR_NOT_IN_STORE:
+            return QSnapdRequest::QSnapdError::NotInStore;
+        case SNAPD_ERROR_AUTH_CANCELLED:
+            return QSnapdRequest::QSnapdError::AuthCancelled;
+        case SNAPD_ERROR_NOT_CLASSIC:
+            return QSnapdRequest::QSnapdError::NotClassic;
+        case SNAPD_ERROR_REVISION_NOT_AVAILABLE:
+            return QSnapdRequest::QSnapdError::RevisionNotAvailable;
+        case SNAPD_ERROR_CHANNEL_NOT_AVAILABLE:
+            return QSnapdRequest::QSnapdError::ChannelNotAvailable;
+        case SNAPD_ERROR_NOT_A_SNAP:
+            return QSnapdRequest::QSnapdError::NotASnap;
+        case SNAPD_ERROR_DNS_FAILURE:
+            return QSnapdRequest::QSnapdError::DNSFailure;
+        case SNAPD_ERROR_OPTION_NOT_FOUND:
+            return QSnapdRequest::QSnapdError::OptionNotFound;
+        case SNAPD_ERROR_RESPONSE_TOO_LARGE:
+            return QSnapdRequest::QSnapdError::ResponseTooLarge;
+        default:
+            /* This indicates we should add a new entry here... */
+            return QSnapdRequest::QSnapdError::UnknownError;
+        }
+    }
+    else if (g_error_matches (e, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return QSnapdRequest::QSnapdError::Cancelled;
+    else
+        return QSnapdRequest::QSnapdError::UnknownError;
+}
+
+// Threads for runInThreadPool (), kept separate from the global pool as they spend most of their time waiting for snapd
+Q_GLOBAL_STATIC (QThreadPool, requestPool)
+
+class QSnapdRequestRunnable : public QRunnable
+{
+public:
+    explicit QSnapdRequestRunnable (QSnapdRequest *request) : request (request) {}
+
+    void run () override
+    {
+        request->runSync ();
+    }
+
+private:
+    QSnapdRequest *request;
+};
+
 QSnapdRequest::QSnapdRequest (void *snapd_client, QObject *parent) :
     QObject (parent),
     d_ptr (new QSnapdRequestPrivate (snapd_client)) {}
@@ -60,127 +171,35 @@ void QSnapdRequest::finish (void *error)
 {
     Q_D(QSnapdRequest);
 
-    d->finished = true;
-    if (error == NULL) {
-        d->error = NoError;
-        d->errorString = "";
-    }
-    else {
-        GError *e = (GError *) error;
-        if (e->domain == SNAPD_ERROR) {
-            switch ((SnapdError) e->code)
-            {
-            case SNAPD_ERROR_CONNECTION_FAILED:
-                d->error = QSnapdRequest::QSnapdError::ConnectionFailed;
-                break;
-            case SNAPD_ERROR_WRITE_FAILED:
-                d->error = QSnapdRequest::QSnapdError::WriteFailed;
-                break;
-            case SNAPD_ERROR_READ_FAILED:
-                d->error = QSnapdRequest::QSnapdError::ReadFailed;
-                break;
-            case SNAPD_ERROR_BAD_REQUEST:
-                d->error = QSnapdRequest::QSnapdError::BadRequest;
-                break;
-            case SNAPD_ERROR_BAD_RESPONSE:
-                d->error = QSnapdRequest::QSnapdError::BadResponse;
-                break;
-            case SNAPD_ERROR_AUTH_DATA_REQUIRED:
-                d->error = QSnapdRequest::QSnapdError::AuthDataRequired;
-                break;
-            case SNAPD_ERROR_AUTH_DATA_INVALID:
-                d->error = QSnapdRequest::QSnapdError::AuthDataInvalid;
-                break;
-            case SNAPD_ERROR_TWO_FACTOR_REQUIRED:
-                d->error = QSnapdRequest::QSnapdError::TwoFactorRequired;
-                break;
-            case SNAPD_ERROR_TWO_FACTOR_INVALID:
-                d->error = QSnapdRequest::QSnapdError::TwoFactorInvalid;
-                break;
-            case SNAPD_ERROR_PERMISSION_DENIED:
-                d->error = QSnapdRequest::QSnapdError::PermissionDenied;
-                break;
-            case SNAPD_ERROR_FAILED:
-                d->error = QSnapdRequest::QSnapdError::Failed;
-                break;
-            case SNAPD_ERROR_TERMS_NOT_ACCEPTED:
-                d->error = QSnapdRequest::QSnapdError::TermsNotAccepted;
-                break;
-            case SNAPD_ERROR_PAYMENT_NOT_SETUP:
-                d->error = QSnapdRequest::QSnapdError::PaymentNotSetup;
-                break;
-            case SNAPD_ERROR_PAYMENT_DECLINED:
-                d->error = QSnapdRequest::QSnapdError::PaymentDeclined;
-                break;
-            case SNAPD_ERROR_ALREADY_INSTALLED:
-                d->error = QSnapdRequest::QSnapdError::AlreadyInstalled;
-                break;
-            case SNAPD_ERROR_NOT_INSTALLED:
-                d->error = QSnapdRequest::QSnapdError::NotInstalled;
-                break;
-            case SNAPD_ERROR_NO_UPDATE_AVAILABLE:
-                d->error = QSnapdRequest::QSnapdError::NoUpdateAvailable;
-                break;
-            case SNAPD_ERROR_PASSWORD_POLICY_ERROR:
-                d->error = QSnapdRequest::QSnapdError::PasswordPolicyError;
-                break;
-            case SNAPD_ERROR_NEEDS_DEVMODE:
-                d->error = QSnapdRequest::QSnapdError::NeedsDevmode;
-                break;
-            case SNAPD_ERROR_NEEDS_CLASSIC:
-                d->error = QSnapdRequest::QSnapdError::NeedsClassic;
-                break;
-            case SNAPD_ERROR_NEEDS_CLASSIC_SYSTEM:
-                d->error = QSnapdRequest::QSnapdError::NeedsClassicSystem;
-                break;
-            case SNAPD_ERROR_BAD_QUERY:
-                d->error = QSnapdRequest::QSnapdError::BadQuery;
-                break;
-            case SNAPD_ERROR_NETWORK_TIMEOUT:
-                d->error = QSnapdRequest::QSnapdError::NetworkTimeout;
-                break;
-            case SNAPD_ERROR_NOT_FOUND:
-                d->error = QSnapdRequest::QSnapdError::NotFound;
-                break;
-            case SNAPD_ERROR_NOT_IN_STORE:
-                d->error = QSnapdRequest::QSnapdError::NotInStore;
-                break;
-            case SNAPD_ERROR_AUTH_CANCELLED:
-                d->error = QSnapdRequest::QSnapdError::AuthCancelled;
-                break;
-            case SNAPD_ERROR_NOT_CLASSIC:
-                d->error = QSnapdRequest::QSnapdError::NotClassic;
-                break;
-            case SNAPD_ERROR_REVISION_NOT_AVAILABLE:
-                d->error = QSnapdRequest::QSnapdError::RevisionNotAvailable;
-                break;
-            case SNAPD_ERROR_CHANNEL_NOT_AVAILABLE:
-                d->error = QSnapdRequest::QSnapdError::ChannelNotAvailable;
-                break;
-            case SNAPD_ERROR_NOT_A_SNAP:
-                d->error = QSnapdRequest::QSnapdError::NotASnap;
-                break;
-            case SNAPD_ERROR_DNS_FAILURE:
-                d->error = QSnapdRequest::QSnapdError::DNSFailure;
-                break;
-            case SNAPD_ERROR_OPTION_NOT_FOUND:
-                d->error = QSnapdRequest::QSnapdError::OptionNotFound;
-                break;
-            default:
-                /* This indicates we should add a new entry here... */
-                d->error = QSnapdRequest::QSnapdError::UnknownError;
-                break;
-            }
-        }
-        else if (g_error_matches (e, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-            d->error = QSnapdRequest::QSnapdError::Cancelled;
-        else
-            d->error = QSnapdRequest::QSnapdError::UnknownError;
-        d->errorString = e->message;
+    QSnapdError code = error != NULL ? convertError (error) : NoError;
+    QString message = error != NULL ? ((GError *) error)->message : "";
+
+    // Complete requests from the thread pool in the thread they were started from
+    if (d->inThreadPool) {
+        QMetaObject::invokeMethod (this, [this, code, message] () {
+            Q_D(QSnapdRequest);
+            d->inThreadPool = false;
+            d->finished = true;
+            d->error = code;
+            d->errorString = message;
+            emit complete ();
+        }, Qt::QueuedConnection);
+        return;
     }
+
+    d->finished = true;
+    d->error = code;
+    d->errorString = message;
     emit complete ();
 }
 
+void QSnapdRequest::runInThreadPool ()
+{
+    Q_D(QSnapdRequest);
+    d->inThreadPool = true;
+    requestPool ()->start (new QSnapdRequestRunnable (this));
+}
+
 bool QSnapdRequest::isFinished () const
 {
     Q_D(const QSnapdRequest);
@@ -208,6 +227,21 @@ void QSnapdRequest::cancel ()
 void QSnapdRequest::handleProgress (void *change)
 {
     Q_D(QSnapdRequest);
+
+    if (d->inThreadPool) {
+        QSharedPointer<SnapdChange> ref (SNAPD_CHANGE (g_object_ref (change)), g_object_unref);
+        QMetaObject::invokeMethod (this, [this, ref] () {
+            Q_D(QSnapdRequest);
+            if (d->change != NULL)
+                g_object_unref (d->change);
+            d->change = SNAPD_CHANGE (g_object_ref (ref.data ()));
+            emit progress ();
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    if (d->change != NULL)
+        g_object_unref (d->change);
     d->change = SNAPD_CHANGE (g_object_ref (change));
     emit progress ();
 }
@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/slot.h"
+#include "strv.h"
 #include "variant.h"
 
 QSnapdSlot::QSnapdSlot (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
@@ -32,10 +33,7 @@ QString QSnapdSlot::interface () const
 QStringList QSnapdSlot::attributeNames () const
 {
     g_auto(GStrv) names = snapd_slot_get_attribute_names (SNAPD_SLOT (wrapped_object), NULL);
-    QStringList result;
-    for (int i = 0; names[i] != NULL; i++)
-        result.append (names[i]);
-    return result;
+    return strv_to_string_list (names);
 }
 
 bool QSnapdSlot::hasAttribute (const QString &name) const
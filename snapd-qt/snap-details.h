@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef SNAPD_SNAP_DETAILS_H
+#define SNAPD_SNAP_DETAILS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <Snapd/Client>
+
+// Fetches the full details of the QSnapdSnap it is a child of
+class QSnapdSnapDetails : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QSnapdSnapDetails (QSnapdClient *client, QSnapdSnap *snap) : QObject (snap), client (client) {}
+
+    // Start fetching the details, unless already in progress
+    void load ();
+
+private:
+    void finish (void *snapd_object);
+
+    QPointer<QSnapdClient> client;
+    QSnapdRequest *request = NULL;
+};
+
+#endif
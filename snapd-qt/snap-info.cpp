@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/snap-info.h"
+#include "string-cache.h"
+
+static QSnapdEnums::SnapConfinement convertConfinement (SnapdConfinement confinement)
+{
+    switch (confinement)
+    {
+    case SNAPD_CONFINEMENT_STRICT:
+        return QSnapdEnums::SnapConfinementStrict;
+    case SNAPD_CONFINEMENT_CLASSIC:
+        return QSnapdEnums::SnapConfinementClassic;
+    case SNAPD_CONFINEMENT_DEVMODE:
+        return QSnapdEnums::SnapConfinementDevmode;
+    case SNAPD_CONFINEMENT_UNKNOWN:
+    default:
+        return QSnapdEnums::SnapConfinementUnknown;
+    }
+}
+
+static QSnapdEnums::SnapStatus convertStatus (SnapdSnapStatus status)
+{
+    switch (status)
+    {
+    case SNAPD_SNAP_STATUS_AVAILABLE:
+        return QSnapdEnums::SnapStatusAvailable;
+    case SNAPD_SNAP_STATUS_PRICED:
+        return QSnapdEnums::SnapStatusPriced;
+    case SNAPD_SNAP_STATUS_INSTALLED:
+        return QSnapdEnums::SnapStatusInstalled;
+    case SNAPD_SNAP_STATUS_ACTIVE:
+        return QSnapdEnums::SnapStatusActive;
+    case SNAPD_SNAP_STATUS_UNKNOWN:
+    default:
+        return QSnapdEnums::SnapStatusUnknown;
+    }
+}
+
+QSnapdSnapInfo::QSnapdSnapInfo () : snapd_object (NULL) {}
+
+QSnapdSnapInfo::QSnapdSnapInfo (void *object) : snapd_object (object != NULL ? g_object_ref (object) : NULL) {}
+
+QSnapdSnapInfo::QSnapdSnapInfo (const QSnapdSnapInfo& other) : snapd_object (other.snapd_object != NULL ? g_object_ref (other.snapd_object) : NULL) {}
+
+QSnapdSnapInfo::QSnapdSnapInfo (QSnapdSnapInfo&& other) noexcept : snapd_object (other.snapd_object)
+{
+    other.snapd_object = NULL;
+}
+
+QSnapdSnapInfo::~QSnapdSnapInfo ()
+{
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+}
+
+QSnapdSnapInfo& QSnapdSnapInfo::operator= (const QSnapdSnapInfo& other)
+{
+    if (other.snapd_object != NULL)
+        g_object_ref (other.snapd_object);
+    if (snapd_object != NULL)
+        g_object_unref (snapd_object);
+    snapd_object = other.snapd_object;
+    return *this;
+}
+
+QSnapdSnapInfo& QSnapdSnapInfo::operator= (QSnapdSnapInfo&& other) noexcept
+{
+    if (this != &other) {
+        if (snapd_object != NULL)
+            g_object_unref (snapd_object);
+        snapd_object = other.snapd_object;
+        other.snapd_object = NULL;
+    }
+    return *this;
+}
+
+bool QSnapdSnapInfo::isNull () const
+{
+    return snapd_object == NULL;
+}
+
+QSnapdSnap *QSnapdSnapInfo::toObject (QObject *parent) const
+{
+    if (snapd_object == NULL)
+        return NULL;
+    return new QSnapdSnap (snapd_object, parent);
+}
+
+QVector<QSnapdAppInfo> QSnapdSnapInfo::apps () const
+{
+    QVector<QSnapdAppInfo> result;
+
+    GPtrArray *apps = snapd_snap_get_apps (SNAPD_SNAP (snapd_object));
+    if (apps == NULL)
+        return result;
+    result.reserve (apps->len);
+    for (guint i = 0; i < apps->len; i++)
+        result.append (QSnapdAppInfo (apps->pdata[i]));
+    return result;
+}
+
+QString QSnapdSnapInfo::base () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-base");
+    return cached_string (snapd_object, quark, snapd_snap_get_base (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::channel () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-channel");
+    return cached_string (snapd_object, quark, snapd_snap_get_channel (SNAPD_SNAP (snapd_object)));
+}
+
+QVector<QSnapdChannelInfo> QSnapdSnapInfo::channels () const
+{
+    QVector<QSnapdChannelInfo> result;
+
+    GPtrArray *channels = snapd_snap_get_channels (SNAPD_SNAP (snapd_object));
+    if (channels == NULL)
+        return result;
+    result.reserve (channels->len);
+    for (guint i = 0; i < channels->len; i++)
+        result.append (QSnapdChannelInfo (channels->pdata[i]));
+    return result;
+}
+
+QSnapdChannelInfo QSnapdSnapInfo::matchChannel (const QString& name) const
+{
+    return QSnapdChannelInfo (snapd_snap_match_channel (SNAPD_SNAP (snapd_object), name.toStdString ().c_str ()));
+}
+
+QSnapdEnums::SnapConfinement QSnapdSnapInfo::confinement () const
+{
+    return convertConfinement (snapd_snap_get_confinement (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::description () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-description");
+    return cached_string (snapd_object, quark, snapd_snap_get_description (SNAPD_SNAP (snapd_object)));
+}
+
+qint64 QSnapdSnapInfo::downloadSize () const
+{
+    return snapd_snap_get_download_size (SNAPD_SNAP (snapd_object));
+}
+
+QString QSnapdSnapInfo::icon () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-icon");
+    return cached_string (snapd_object, quark, snapd_snap_get_icon (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::id () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-id");
+    return cached_string (snapd_object, quark, snapd_snap_get_id (SNAPD_SNAP (snapd_object)));
+}
+
+qint64 QSnapdSnapInfo::installedSize () const
+{
+    return snapd_snap_get_installed_size (SNAPD_SNAP (snapd_object));
+}
+
+QString QSnapdSnapInfo::name () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-name");
+    return cached_string (snapd_object, quark, snapd_snap_get_name (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::publisherDisplayName () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-publisher-display-name");
+    return cached_string (snapd_object, quark, snapd_snap_get_publisher_display_name (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::publisherUsername () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-publisher-username");
+    return cached_string (snapd_object, quark, snapd_snap_get_publisher_username (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::revision () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-revision");
+    return cached_string (snapd_object, quark, snapd_snap_get_revision (SNAPD_SNAP (snapd_object)));
+}
+
+QSnapdEnums::SnapStatus QSnapdSnapInfo::status () const
+{
+    return convertStatus (snapd_snap_get_status (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::summary () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-summary");
+    return cached_string (snapd_object, quark, snapd_snap_get_summary (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::title () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-title");
+    return cached_string (snapd_object, quark, snapd_snap_get_title (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::trackingChannel () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-tracking-channel");
+    return cached_string (snapd_object, quark, snapd_snap_get_tracking_channel (SNAPD_SNAP (snapd_object)));
+}
+
+QString QSnapdSnapInfo::version () const
+{
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-version");
+    return cached_string (snapd_object, quark, snapd_snap_get_version (SNAPD_SNAP (snapd_object)));
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "Snapd/snap-list-model.h"
+
+QSnapdSnapListModel::QSnapdSnapListModel (QObject *parent) :
+    QAbstractListModel (parent) {}
+
+int QSnapdSnapListModel::rowCount (const QModelIndex &parent) const
+{
+    return parent.isValid () ? 0 : loaded;
+}
+
+QVariant QSnapdSnapListModel::data (const QModelIndex &index, int role) const
+{
+    if (!index.isValid () || index.row () < 0 || index.row () >= loaded)
+        return QVariant ();
+
+    const QSnapdSnapInfo &snap = snaps[index.row ()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return snap.title ().isEmpty () ? snap.name () : snap.title ();
+    case NameRole:
+        return snap.name ();
+    case TitleRole:
+        return snap.title ();
+    case SummaryRole:
+        return snap.summary ();
+    case DescriptionRole:
+        return snap.description ();
+    case VersionRole:
+        return snap.version ();
+    case RevisionRole:
+        return snap.revision ();
+    case ChannelRole:
+        return snap.channel ();
+    case TrackingChannelRole:
+        return snap.trackingChannel ();
+    case IconRole:
+        return snap.icon ();
+    case StatusRole:
+        return snap.status ();
+    case ConfinementRole:
+        return snap.confinement ();
+    case PublisherDisplayNameRole:
+        return snap.publisherDisplayName ();
+    case InstalledSizeRole:
+        return snap.installedSize ();
+    case DownloadSizeRole:
+        return snap.downloadSize ();
+    default:
+        return QVariant ();
+    }
+}
+
+QHash<int, QByteArray> QSnapdSnapListModel::roleNames () const
+{
+    QHash<int, QByteArray> names;
+    names[NameRole] = "name";
+    names[TitleRole] = "title";
+    names[SummaryRole] = "summary";
+    names[DescriptionRole] = "description";
+    names[VersionRole] = "version";
+    names[RevisionRole] = "revision";
+    names[ChannelRole] = "channel";
+    names[TrackingChannelRole] = "trackingChannel";
+    names[IconRole] = "icon";
+    names[StatusRole] = "status";
+    names[ConfinementRole] = "confinement";
+    names[PublisherDisplayNameRole] = "publisherDisplayName";
+    names[InstalledSizeRole] = "installedSize";
+    names[DownloadSizeRole] = "downloadSize";
+    return names;
+}
+
+bool QSnapdSnapListModel::canFetchMore (const QModelIndex &parent) const
+{
+    return !parent.isValid () && loaded < snaps.size ();
+}
+
+void QSnapdSnapListModel::fetchMore (const QModelIndex &parent)
+{
+    if (parent.isValid ())
+        return;
+
+    int n = snaps.size () - loaded;
+    if (batch_size > 0 && n > batch_size)
+        n = batch_size;
+    if (n <= 0)
+        return;
+
+    beginInsertRows (QModelIndex (), loaded, loaded + n - 1);
+    loaded += n;
+    endInsertRows ();
+}
+
+int QSnapdSnapListModel::count () const
+{
+    return snaps.size ();
+}
+
+int QSnapdSnapListModel::batchSize () const
+{
+    return batch_size;
+}
+
+void QSnapdSnapListModel::setBatchSize (int batchSize)
+{
+    batch_size = batchSize;
+}
+
+static bool snapChanged (const QSnapdSnapInfo &a, const QSnapdSnapInfo &b)
+{
+    return a.revision () != b.revision () ||
+           a.status () != b.status () ||
+           a.version () != b.version () ||
+           a.channel () != b.channel () ||
+           a.trackingChannel () != b.trackingChannel () ||
+           a.title () != b.title () ||
+           a.summary () != b.summary () ||
+           a.description () != b.description () ||
+           a.icon () != b.icon () ||
+           a.installedSize () != b.installedSize () ||
+           a.downloadSize () != b.downloadSize ();
+}
+
+void QSnapdSnapListModel::setSnaps (const QVector<QSnapdSnapInfo> &newSnaps)
+{
+    int oldCount = snaps.size ();
+
+    QHash<QString, int> newRows;
+    newRows.reserve (newSnaps.size ());
+    for (int i = 0; i < newSnaps.size (); i++)
+        newRows.insert (newSnaps[i].name (), i);
+
+    // Remove snaps that have gone, from the end so the remaining rows don't move until removed
+    for (int row = snaps.size () - 1; row >= 0; row--) {
+        if (newRows.contains (snaps[row].name ()))
+            continue;
+
+        if (row < loaded) {
+            beginRemoveRows (QModelIndex (), row, row);
+            snaps.remove (row);
+            loaded--;
+            endRemoveRows ();
+        }
+        else
+            snaps.remove (row);
+    }
+
+    // Update snaps that remain, keeping the old values if nothing visible has changed
+    QVector<bool> existing (newSnaps.size (), false);
+    for (int row = 0; row < snaps.size (); row++) {
+        int i = newRows.value (snaps[row].name ());
+        existing[i] = true;
+        if (!snapChanged (snaps[row], newSnaps[i]))
+            continue;
+
+        snaps[row] = newSnaps[i];
+        if (row < loaded)
+            Q_EMIT dataChanged (index (row), index (row));
+    }
+
+    // Add new snaps to the end
+    int start = snaps.size ();
+    for (int i = 0; i < newSnaps.size (); i++) {
+        if (!existing[i])
+            snaps.append (newSnaps[i]);
+    }
+    if (batch_size <= 0 && snaps.size () > start) {
+        beginInsertRows (QModelIndex (), start, snaps.size () - 1);
+        loaded = snaps.size ();
+        endInsertRows ();
+    }
+
+    if (snaps.size () != oldCount)
+        Q_EMIT countChanged ();
+}
+
+void QSnapdSnapListModel::setSnaps (QSnapdGetSnapsRequest *request)
+{
+    setSnaps (request != NULL ? request->snapInfos () : QVector<QSnapdSnapInfo> ());
+}
+
+void QSnapdSnapListModel::setSnaps (QSnapdFindRequest *request)
+{
+    setSnaps (request != NULL ? request->snapInfos () : QVector<QSnapdSnapInfo> ());
+}
+
+QSnapdSnapInfo QSnapdSnapListModel::snapInfo (int row) const
+{
+    if (row < 0 || row >= snaps.size ())
+        return QSnapdSnapInfo ();
+    return snaps[row];
+}
+
+int QSnapdSnapListModel::indexOf (const QString &name) const
+{
+    for (int row = 0; row < snaps.size (); row++) {
+        if (snaps[row].name () == name)
+            return row;
+    }
+    return -1;
+}
+
+QSnapdSnap *QSnapdSnapListModel::snap (int row) const
+{
+    if (row < 0 || row >= snaps.size ())
+        return NULL;
+    return snaps[row].toObject ();
+}
+
+void QSnapdSnapListModel::clear ()
+{
+    if (snaps.isEmpty ())
+        return;
+
+    beginResetModel ();
+    snaps.clear ();
+    loaded = 0;
+    endResetModel ();
+    Q_EMIT countChanged ();
+}
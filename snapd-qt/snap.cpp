@@ -10,6 +10,9 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/snap.h"
+#include "snap-details.h"
+#include "string-cache.h"
+#include "strv.h"
 
 QSnapdSnap::QSnapdSnap (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
 
@@ -33,17 +36,20 @@ QSnapdApp *QSnapdSnap::app (int n) const
 
 QString QSnapdSnap::base () const
 {
-    return snapd_snap_get_base (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-base");
+    return cached_string (wrapped_object, quark, snapd_snap_get_base (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::broken () const
 {
-    return snapd_snap_get_broken (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-broken");
+    return cached_string (wrapped_object, quark, snapd_snap_get_broken (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::channel () const
 {
-    return snapd_snap_get_channel (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-channel");
+    return cached_string (wrapped_object, quark, snapd_snap_get_channel (SNAPD_SNAP (wrapped_object)));
 }
 
 int QSnapdSnap::channelCount () const
@@ -74,11 +80,7 @@ QSnapdChannel *QSnapdSnap::matchChannel (const QString& name) const
 
 QStringList QSnapdSnap::commonIds () const
 {
-    GStrv common_ids = snapd_snap_get_common_ids (SNAPD_SNAP (wrapped_object));
-    QStringList result;
-    for (int i = 0; common_ids[i] != NULL; i++)
-        result.append (common_ids[i]);
-    return result;
+    return strv_to_string_list (snapd_snap_get_common_ids (SNAPD_SNAP (wrapped_object)));
 }
 
 QSnapdEnums::SnapConfinement QSnapdSnap::confinement () const
@@ -99,12 +101,14 @@ QSnapdEnums::SnapConfinement QSnapdSnap::confinement () const
 
 QString QSnapdSnap::contact () const
 {
-    return snapd_snap_get_contact (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-contact");
+    return cached_string (wrapped_object, quark, snapd_snap_get_contact (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::description () const
 {
-    return snapd_snap_get_description (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-description");
+    return cached_string (wrapped_object, quark, snapd_snap_get_description (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::developer () const
@@ -126,12 +130,14 @@ qint64 QSnapdSnap::downloadSize () const
 
 QString QSnapdSnap::icon () const
 {
-    return snapd_snap_get_icon (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-icon");
+    return cached_string (wrapped_object, quark, snapd_snap_get_icon (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::id () const
 {
-    return snapd_snap_get_id (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-id");
+    return cached_string (wrapped_object, quark, snapd_snap_get_id (SNAPD_SNAP (wrapped_object)));
 }
 
 static QDateTime convertDateTime (GDateTime *datetime)
@@ -166,7 +172,8 @@ bool QSnapdSnap::jailmode () const
 
 QString QSnapdSnap::license () const
 {
-    return snapd_snap_get_license (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-license");
+    return cached_string (wrapped_object, quark, snapd_snap_get_license (SNAPD_SNAP (wrapped_object)));
 }
 
 int QSnapdSnap::mediaCount () const
@@ -189,12 +196,14 @@ QSnapdMedia *QSnapdSnap::media (int n) const
 
 QString QSnapdSnap::mountedFrom () const
 {
-    return snapd_snap_get_mounted_from (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-mounted-from");
+    return cached_string (wrapped_object, quark, snapd_snap_get_mounted_from (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::name () const
 {
-    return snapd_snap_get_name (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-name");
+    return cached_string (wrapped_object, quark, snapd_snap_get_name (SNAPD_SNAP (wrapped_object)));
 }
 
 int QSnapdSnap::priceCount () const
@@ -222,17 +231,20 @@ bool QSnapdSnap::isPrivate () const
 
 QString QSnapdSnap::publisherDisplayName () const
 {
-    return snapd_snap_get_publisher_display_name (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-publisher-display-name");
+    return cached_string (wrapped_object, quark, snapd_snap_get_publisher_display_name (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::publisherId () const
 {
-    return snapd_snap_get_publisher_id (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-publisher-id");
+    return cached_string (wrapped_object, quark, snapd_snap_get_publisher_id (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::publisherUsername () const
 {
-    return snapd_snap_get_publisher_username (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-publisher-username");
+    return cached_string (wrapped_object, quark, snapd_snap_get_publisher_username (SNAPD_SNAP (wrapped_object)));
 }
 
 QSnapdEnums::PublisherValidation QSnapdSnap::publisherValidation () const
@@ -253,7 +265,8 @@ QSnapdEnums::PublisherValidation QSnapdSnap::publisherValidation () const
 
 QString QSnapdSnap::revision () const
 {
-    return snapd_snap_get_revision (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-revision");
+    return cached_string (wrapped_object, quark, snapd_snap_get_revision (SNAPD_SNAP (wrapped_object)));
 }
 
 int QSnapdSnap::screenshotCount () const
@@ -322,31 +335,31 @@ QSnapdEnums::SnapStatus QSnapdSnap::status () const
 
 QString QSnapdSnap::storeUrl () const
 {
-    return snapd_snap_get_store_url (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-store-url");
+    return cached_string (wrapped_object, quark, snapd_snap_get_store_url (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::summary () const
 {
-    return snapd_snap_get_summary (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-summary");
+    return cached_string (wrapped_object, quark, snapd_snap_get_summary (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::title () const
 {
-    return snapd_snap_get_title (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-title");
+    return cached_string (wrapped_object, quark, snapd_snap_get_title (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::trackingChannel () const
 {
-    return snapd_snap_get_tracking_channel (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-tracking-channel");
+    return cached_string (wrapped_object, quark, snapd_snap_get_tracking_channel (SNAPD_SNAP (wrapped_object)));
 }
 
 QStringList QSnapdSnap::tracks () const
 {
-    GStrv tracks = snapd_snap_get_tracks (SNAPD_SNAP (wrapped_object));
-    QStringList result;
-    for (int i = 0; tracks[i] != NULL; i++)
-        result.append (tracks[i]);
-    return result;
+    return strv_to_string_list (snapd_snap_get_tracks (SNAPD_SNAP (wrapped_object)));
 }
 
 bool QSnapdSnap::trymode () const
@@ -356,10 +369,155 @@ bool QSnapdSnap::trymode () const
 
 QString QSnapdSnap::version () const
 {
-    return snapd_snap_get_version (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-version");
+    return cached_string (wrapped_object, quark, snapd_snap_get_version (SNAPD_SNAP (wrapped_object)));
 }
 
 QString QSnapdSnap::website () const
 {
-    return snapd_snap_get_website (SNAPD_SNAP (wrapped_object));
+    static GQuark quark = g_quark_from_static_string ("snapd-qt-snap-website");
+    return cached_string (wrapped_object, quark, snapd_snap_get_website (SNAPD_SNAP (wrapped_object)));
+}
+
+void QSnapdSnap::setDetailsClient (QSnapdClient *client)
+{
+    delete findChild<QSnapdSnapDetails *> (QString (), Qt::FindDirectChildrenOnly);
+    if (client != NULL)
+        new QSnapdSnapDetails (client, this);
+}
+
+void QSnapdSnap::loadDetails ()
+{
+    QSnapdSnapDetails *details = findChild<QSnapdSnapDetails *> (QString (), Qt::FindDirectChildrenOnly);
+    if (details != NULL)
+        details->load ();
+}
+
+static guint
+array_length (GPtrArray *array)
+{
+    return array != NULL ? array->len : 0;
+}
+
+static bool
+channels_equal (GPtrArray *a, GPtrArray *b)
+{
+    if (array_length (a) != array_length (b))
+        return false;
+
+    for (guint i = 0; i < array_length (a); i++) {
+        SnapdChannel *ca = SNAPD_CHANNEL (g_ptr_array_index (a, i));
+        SnapdChannel *cb = SNAPD_CHANNEL (g_ptr_array_index (b, i));
+        if (g_strcmp0 (snapd_channel_get_name (ca), snapd_channel_get_name (cb)) != 0 ||
+            g_strcmp0 (snapd_channel_get_revision (ca), snapd_channel_get_revision (cb)) != 0 ||
+            g_strcmp0 (snapd_channel_get_version (ca), snapd_channel_get_version (cb)) != 0 ||
+            g_strcmp0 (snapd_channel_get_epoch (ca), snapd_channel_get_epoch (cb)) != 0 ||
+            snapd_channel_get_confinement (ca) != snapd_channel_get_confinement (cb) ||
+            snapd_channel_get_size (ca) != snapd_channel_get_size (cb) ||
+            snapd_channel_get_released_at_usec (ca) != snapd_channel_get_released_at_usec (cb))
+            return false;
+    }
+
+    return true;
+}
+
+static bool
+media_equal (GPtrArray *a, GPtrArray *b)
+{
+    if (array_length (a) != array_length (b))
+        return false;
+
+    for (guint i = 0; i < array_length (a); i++) {
+        SnapdMedia *ma = SNAPD_MEDIA (g_ptr_array_index (a, i));
+        SnapdMedia *mb = SNAPD_MEDIA (g_ptr_array_index (b, i));
+        if (g_strcmp0 (snapd_media_get_media_type (ma), snapd_media_get_media_type (mb)) != 0 ||
+            g_strcmp0 (snapd_media_get_url (ma), snapd_media_get_url (mb)) != 0 ||
+            snapd_media_get_width (ma) != snapd_media_get_width (mb) ||
+            snapd_media_get_height (ma) != snapd_media_get_height (mb))
+            return false;
+    }
+
+    return true;
+}
+
+void QSnapdSnap::upgrade (void *snapd_object)
+{
+    SnapdSnap *old_snap = SNAPD_SNAP (wrapped_object);
+    SnapdSnap *new_snap = SNAPD_SNAP (snapd_object);
+
+    if (new_snap == old_snap) {
+        Q_EMIT detailsLoaded ();
+        return;
+    }
+
+    bool channels_changed = !channels_equal (snapd_snap_get_channels (old_snap), snapd_snap_get_channels (new_snap)) ||
+                            strv_to_string_list (snapd_snap_get_tracks (old_snap)) != strv_to_string_list (snapd_snap_get_tracks (new_snap));
+    bool contact_changed = g_strcmp0 (snapd_snap_get_contact (old_snap), snapd_snap_get_contact (new_snap)) != 0;
+    bool description_changed = g_strcmp0 (snapd_snap_get_description (old_snap), snapd_snap_get_description (new_snap)) != 0;
+    bool license_changed = g_strcmp0 (snapd_snap_get_license (old_snap), snapd_snap_get_license (new_snap)) != 0;
+    bool media_changed = !media_equal (snapd_snap_get_media (old_snap), snapd_snap_get_media (new_snap));
+    bool website_changed = g_strcmp0 (snapd_snap_get_website (old_snap), snapd_snap_get_website (new_snap)) != 0;
+
+    // Existing child wrappers hold their own references, so remain valid
+    wrapped_object = g_object_ref (new_snap);
+    g_object_unref (old_snap);
+
+    if (channels_changed)
+        Q_EMIT channelsChanged ();
+    if (contact_changed)
+        Q_EMIT contactChanged ();
+    if (description_changed)
+        Q_EMIT descriptionChanged ();
+    if (license_changed)
+        Q_EMIT licenseChanged ();
+    if (media_changed)
+        Q_EMIT mediaChanged ();
+    if (website_changed)
+        Q_EMIT websiteChanged ();
+    Q_EMIT detailsLoaded ();
+}
+
+void QSnapdSnapDetails::load ()
+{
+    if (request != NULL || client.isNull ())
+        return;
+
+    // Installed snaps are refreshed from snapd, others from the store
+    QSnapdSnap *snap = static_cast<QSnapdSnap *> (parent ());
+    SnapdSnapStatus status = snapd_snap_get_status (SNAPD_SNAP (snap->wrappedObject ()));
+    if (status == SNAPD_SNAP_STATUS_INSTALLED || status == SNAPD_SNAP_STATUS_ACTIVE) {
+        QSnapdGetSnapRequest *r = client->getSnap (snap->name ());
+        connect (r, &QSnapdRequest::complete, this, [this, r] () {
+            if (r->error () != QSnapdRequest::NoError) {
+                finish (NULL);
+                return;
+            }
+            QScopedPointer<QSnapdSnap> result (r->snap ());
+            finish (result->wrappedObject ());
+        });
+        request = r;
+    }
+    else {
+        QSnapdFindRequest *r = client->find (QSnapdClient::MatchName, snap->name ());
+        connect (r, &QSnapdRequest::complete, this, [this, r] () {
+            if (r->error () != QSnapdRequest::NoError || r->snapCount () == 0) {
+                finish (NULL);
+                return;
+            }
+            QScopedPointer<QSnapdSnap> result (r->snap (0));
+            finish (result->wrappedObject ());
+        });
+        request = r;
+    }
+    request->setParent (this);
+    request->runAsync ();
+}
+
+void QSnapdSnapDetails::finish (void *snapd_object)
+{
+    request->deleteLater ();
+    request = NULL;
+
+    if (snapd_object != NULL)
+        static_cast<QSnapdSnap *> (parent ())->upgrade (snapd_object);
 }
@@ -10,9 +10,27 @@
 #include "stream-wrapper.h"
 
 #include <QIODevice>
+#include <QNetworkReply>
+#include <QThread>
 
 G_DEFINE_TYPE (StreamWrapper, stream_wrapper, G_TYPE_INPUT_STREAM)
 
+/* Check if a sequential device will never have more data */
+static bool
+at_end (StreamWrapper *wrapper)
+{
+    QIODevice *ioDevice = wrapper->ioDevice;
+
+    if (wrapper->read_finished || !ioDevice->isOpen ())
+        return true;
+
+    QNetworkReply *reply = qobject_cast<QNetworkReply *> (ioDevice);
+    if (reply != NULL)
+        return reply->isFinished ();
+
+    return false;
+}
+
 static gssize
 stream_wrapper_read_fn (GInputStream *stream, void *buffer, gsize count, GCancellable *cancellable, GError **error)
 {
@@ -22,6 +40,10 @@ stream_wrapper_read_fn (GInputStream *stream, void *buffer, gsize count, GCancel
     if (wrapper->ioDevice == NULL)
         return 0;
 
+    /* Block until data is available, rather than returning 0 which means end of stream */
+    if (wrapper->ioDevice->isSequential () && wrapper->ioDevice->bytesAvailable () <= 0 && !at_end (wrapper))
+        wrapper->ioDevice->waitForReadyRead (-1);
+
     nRead = wrapper->ioDevice->read ((char *) buffer, count);
     if (nRead >= 0)
         return nRead;
@@ -30,6 +52,123 @@ stream_wrapper_read_fn (GInputStream *stream, void *buffer, gsize count, GCancel
     return -1;
 }
 
+static void
+return_pending (StreamWrapper *wrapper, gssize n_read, GError *error)
+{
+    g_autoptr(GTask) task = wrapper->pending_task;
+    wrapper->pending_task = NULL;
+    wrapper->pending_buffer = NULL;
+    wrapper->pending_count = 0;
+    if (wrapper->cancelled_id != 0) {
+        g_cancellable_disconnect (g_task_get_cancellable (task), wrapper->cancelled_id);
+        wrapper->cancelled_id = 0;
+    }
+    g_clear_pointer (&wrapper->pending_context, g_main_context_unref);
+
+    if (error != NULL)
+        g_task_return_error (task, error);
+    else
+        g_task_return_int (task, n_read);
+}
+
+/* Complete a pending read if the device has data, called in the thread the device belongs to */
+static void
+read_pending (StreamWrapper *wrapper)
+{
+    if (wrapper->pending_task == NULL)
+        return;
+
+    GCancellable *cancellable = g_task_get_cancellable (wrapper->pending_task);
+    GError *error = NULL;
+    if (g_cancellable_set_error_if_cancelled (cancellable, &error)) {
+        return_pending (wrapper, -1, error);
+        return;
+    }
+
+    QIODevice *ioDevice = wrapper->ioDevice;
+    if (ioDevice == NULL) {
+        return_pending (wrapper, 0, NULL);
+        return;
+    }
+
+    /* Wait for readyRead or readChannelFinished */
+    if (ioDevice->isSequential () && ioDevice->bytesAvailable () <= 0 && !at_end (wrapper))
+        return;
+
+    gssize n_read = stream_wrapper_read_fn (G_INPUT_STREAM (wrapper), wrapper->pending_buffer, wrapper->pending_count, cancellable, &error);
+    return_pending (wrapper, n_read, error);
+}
+
+/* Run read_pending() in the thread of the device, as QIODevice is not thread safe */
+static void
+schedule_read_pending (StreamWrapper *wrapper)
+{
+    if (wrapper->ioDevice == NULL) {
+        read_pending (wrapper);
+        return;
+    }
+
+    g_object_ref (wrapper);
+    QMetaObject::invokeMethod (wrapper->ioDevice, [wrapper] () {
+        read_pending (wrapper);
+        g_object_unref (wrapper);
+    }, Qt::AutoConnection);
+}
+
+static gboolean
+cancelled_idle_cb (gpointer user_data)
+{
+    schedule_read_pending (SNAPD_STREAM_WRAPPER (user_data));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+cancelled_cb (GCancellable *cancellable, StreamWrapper *wrapper)
+{
+    /* Complete from an idle, as the handler can't be disconnected from inside it */
+    g_autoptr(GSource) source = g_idle_source_new ();
+    g_source_set_callback (source, cancelled_idle_cb, g_object_ref (wrapper), g_object_unref);
+    g_source_attach (source, wrapper->pending_context);
+}
+
+static void
+stream_wrapper_read_async (GInputStream *stream, void *buffer, gsize count, int io_priority, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    StreamWrapper *wrapper = SNAPD_STREAM_WRAPPER (stream);
+
+    g_autoptr(GTask) task = g_task_new (stream, cancellable, callback, user_data);
+    g_task_set_priority (task, io_priority);
+
+    /* GInputStream only allows one outstanding read */
+    wrapper->pending_task = (GTask *) g_object_ref (task);
+    wrapper->pending_context = g_main_context_ref_thread_default ();
+    wrapper->pending_buffer = buffer;
+    wrapper->pending_count = count;
+
+    QIODevice *ioDevice = wrapper->ioDevice;
+    if (ioDevice != NULL && !wrapper->ready_read_connection) {
+        wrapper->ready_read_connection = QObject::connect (ioDevice, &QIODevice::readyRead, [wrapper] () {
+            read_pending (wrapper);
+        });
+        wrapper->read_finished_connection = QObject::connect (ioDevice, &QIODevice::readChannelFinished, [wrapper] () {
+            wrapper->read_finished = true;
+            read_pending (wrapper);
+        });
+    }
+
+    if (cancellable != NULL)
+        wrapper->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (cancelled_cb), wrapper, NULL);
+
+    if (wrapper->pending_task != NULL)
+        schedule_read_pending (wrapper);
+}
+
+static gssize
+stream_wrapper_read_finish (GInputStream *stream, GAsyncResult *result, GError **error)
+{
+    return g_task_propagate_int (G_TASK (result), error);
+}
+
 static gboolean
 stream_wrapper_close_fn (GInputStream *stream, GCancellable *cancellable, GError **error)
 {
@@ -42,16 +181,99 @@ stream_wrapper_close_fn (GInputStream *stream, GCancellable *cancellable, GError
     return TRUE;
 }
 
+static void
+stream_wrapper_finalize (GObject *object)
+{
+    StreamWrapper *wrapper = SNAPD_STREAM_WRAPPER (object);
+
+    QObject::disconnect (wrapper->ready_read_connection);
+    QObject::disconnect (wrapper->read_finished_connection);
+    wrapper->ioDevice.~QPointer ();
+    wrapper->ready_read_connection.~Connection ();
+    wrapper->read_finished_connection.~Connection ();
+
+    G_OBJECT_CLASS (stream_wrapper_parent_class)->finalize (object);
+}
+
 static void
 stream_wrapper_init (StreamWrapper *wrapper)
 {
+    new (&wrapper->ioDevice) QPointer<QIODevice> ();
+    new (&wrapper->ready_read_connection) QMetaObject::Connection ();
+    new (&wrapper->read_finished_connection) QMetaObject::Connection ();
 }
 
 static void
 stream_wrapper_class_init (StreamWrapperClass *klass)
 {
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
     GInputStreamClass *input_stream_class = G_INPUT_STREAM_CLASS (klass);
 
+    gobject_class->finalize = stream_wrapper_finalize;
     input_stream_class->read_fn = stream_wrapper_read_fn;
+    input_stream_class->read_async = stream_wrapper_read_async;
+    input_stream_class->read_finish = stream_wrapper_read_finish;
     input_stream_class->close_fn = stream_wrapper_close_fn;
 }
+
+G_DEFINE_TYPE (OutputStreamWrapper, output_stream_wrapper, G_TYPE_OUTPUT_STREAM)
+
+static gssize
+output_stream_wrapper_write_fn (GOutputStream *stream, const void *buffer, gsize count, GCancellable *cancellable, GError **error)
+{
+    OutputStreamWrapper *wrapper = SNAPD_OUTPUT_STREAM_WRAPPER (stream);
+    QIODevice *ioDevice = wrapper->ioDevice;
+
+    if (ioDevice == NULL) {
+        g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_CLOSED, "Device was destroyed");
+        return -1;
+    }
+
+    /* Responses may be read in the client I/O thread, but QIODevice is not thread safe.
+     * This blocks until the device thread runs its event loop, so a synchronous request
+     * made from that thread must not use an I/O thread */
+    qint64 nWritten = -1;
+    QString errorString;
+    auto write = [&] () {
+        nWritten = ioDevice->write ((const char *) buffer, count);
+        if (nWritten < 0)
+            errorString = ioDevice->errorString ();
+    };
+    if (QThread::currentThread () == ioDevice->thread ())
+        write ();
+    else
+        QMetaObject::invokeMethod (ioDevice, write, Qt::BlockingQueuedConnection);
+
+    if (nWritten >= 0)
+        return nWritten;
+
+    g_set_error_literal (error, G_FILE_ERROR, G_FILE_ERROR_FAILED, errorString.toStdString ().c_str ());
+    return -1;
+}
+
+static void
+output_stream_wrapper_finalize (GObject *object)
+{
+    OutputStreamWrapper *wrapper = SNAPD_OUTPUT_STREAM_WRAPPER (object);
+
+    wrapper->ioDevice.~QPointer ();
+
+    G_OBJECT_CLASS (output_stream_wrapper_parent_class)->finalize (object);
+}
+
+static void
+output_stream_wrapper_init (OutputStreamWrapper *wrapper)
+{
+    new (&wrapper->ioDevice) QPointer<QIODevice> ();
+}
+
+static void
+output_stream_wrapper_class_init (OutputStreamWrapperClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+    GOutputStreamClass *output_stream_class = G_OUTPUT_STREAM_CLASS (klass);
+
+    /* The device belongs to the caller so it is left open */
+    gobject_class->finalize = output_stream_wrapper_finalize;
+    output_stream_class->write_fn = output_stream_wrapper_write_fn;
+}
@@ -24,6 +24,16 @@ struct _StreamWrapper
 {
     GInputStream parent_instance;
     QPointer<QIODevice> ioDevice;
+
+    /* Asynchronous read waiting for the device to have data */
+    GTask *pending_task;
+    GMainContext *pending_context;
+    void *pending_buffer;
+    gsize pending_count;
+    gulong cancelled_id;
+    bool read_finished;
+    QMetaObject::Connection ready_read_connection;
+    QMetaObject::Connection read_finished_connection;
 };
 
 struct _StreamWrapperClass
@@ -31,6 +41,19 @@ struct _StreamWrapperClass
     GInputStreamClass parent_class;
 };
 
+G_DECLARE_FINAL_TYPE (OutputStreamWrapper, output_stream_wrapper, SNAPD, OUTPUT_STREAM_WRAPPER, GOutputStream)
+
+struct _OutputStreamWrapper
+{
+    GOutputStream parent_instance;
+    QPointer<QIODevice> ioDevice;
+};
+
+struct _OutputStreamWrapperClass
+{
+    GOutputStreamClass parent_class;
+};
+
 G_END_DECLS
 
 #endif
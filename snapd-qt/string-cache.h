@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef STRING_CACHE_H
+#define STRING_CACHE_H
+
+static void
+free_cached_string (gpointer data)
+{
+    delete static_cast<QString *> (data);
+}
+
+/* Get a string property of an object as a QString, only converting from UTF-8 the first time.
+ * The QString is attached to the object so it is shared by all wrappers and freed with it */
+static QString
+cached_string (void *object, GQuark quark, const gchar *value)
+{
+    QString *string = static_cast<QString *> (g_object_get_qdata (G_OBJECT (object), quark));
+    if (string != NULL)
+        return *string;
+
+    string = new QString (QString::fromUtf8 (value));
+    if (!g_object_replace_qdata (G_OBJECT (object), quark, NULL, string, free_cached_string, NULL)) {
+        /* Another thread got there first */
+        delete string;
+        string = static_cast<QString *> (g_object_get_qdata (G_OBJECT (object), quark));
+    }
+
+    return *string;
+}
+
+#endif
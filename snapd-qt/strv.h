@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#ifndef STRV_H
+#define STRV_H
+
+/* Write @length UTF-16 code units from @data to @out as NUL terminated UTF-8, returning the number of bytes written.
+ * @out must have space for at least 3 bytes per code unit plus the terminator */
+static inline gsize
+utf16_to_utf8 (const QChar *data, int length, gchar *out)
+{
+    gchar *start = out;
+
+    for (int i = 0; i < length; i++) {
+        gunichar c = data[i].unicode ();
+        if (QChar::isHighSurrogate (c) && i + 1 < length && data[i + 1].isLowSurrogate ()) {
+            c = QChar::surrogateToUcs4 (c, data[i + 1].unicode ());
+            i++;
+        }
+        else if (QChar::isSurrogate (c))
+            c = 0xFFFD;
+        out += g_unichar_to_utf8 (c, out);
+    }
+    *out++ = '\0';
+
+    return out - start;
+}
+
+/* Convert a QStringList to a NULL terminated array of UTF-8 strings.
+ * The array and the strings are stored in a single allocation, so free it with g_free() not g_strfreev() */
+static inline gchar **
+string_list_to_strv (const QStringList& list)
+{
+    gsize array_size = sizeof (gchar *) * (list.size () + 1);
+    gsize size = array_size;
+    for (const QString &s : list)
+        size += s.size () * 3 + 1;
+
+    gchar **value = (gchar **) g_malloc (size);
+    gchar *data = (gchar *) value + array_size;
+    int i = 0;
+    for (const QString &s : list) {
+        value[i++] = data;
+        data += utf16_to_utf8 (s.constData (), s.size (), data);
+    }
+    value[i] = NULL;
+
+    return value;
+}
+
+/* Convert a NULL terminated array of UTF-8 strings to a QStringList */
+static inline QStringList
+strv_to_string_list (const gchar * const *strv)
+{
+    QStringList result;
+
+    if (strv == NULL)
+        return result;
+
+    int length = 0;
+    while (strv[length] != NULL)
+        length++;
+    result.reserve (length);
+    for (int i = 0; i < length; i++)
+        result.append (QString::fromUtf8 (strv[i]));
+
+    return result;
+}
+
+#endif
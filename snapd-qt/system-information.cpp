@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/system-information.h"
+#include "strv.h"
 
 QSnapdSystemInformation::QSnapdSystemInformation (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
 
@@ -107,11 +108,7 @@ QHash<QString, QStringList> QSnapdSystemInformation::sandboxFeatures () const
     gpointer key, value;
     while (g_hash_table_iter_next (&iter, &key, &value)) {
         const gchar *backend = (const gchar *) key;
-        GStrv features = (GStrv) value;
-        int i;
-
-        for (i = 0; features[i] != NULL; i++)
-            sandboxFeatures[backend] << features[i];
+        sandboxFeatures.insert (backend, strv_to_string_list ((GStrv) value));
     }
 
     return sandboxFeatures;
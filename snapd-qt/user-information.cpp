@@ -10,6 +10,7 @@
 #include <snapd-glib/snapd-glib.h>
 
 #include "Snapd/user-information.h"
+#include "strv.h"
 
 QSnapdUserInformation::QSnapdUserInformation (void *snapd_object, QObject *parent) : QSnapdWrappedObject (g_object_ref (snapd_object), g_object_unref, parent) {}
 
@@ -30,11 +31,7 @@ QString QSnapdUserInformation::email () const
 
 QStringList QSnapdUserInformation::sshKeys () const
 {
-    GStrv ssh_keys = snapd_user_information_get_ssh_keys (SNAPD_USER_INFORMATION (wrapped_object));
-    QStringList result;
-    for (int i = 0; ssh_keys[i] != NULL; i++)
-        result.append (ssh_keys[i]);
-    return result;
+    return strv_to_string_list (snapd_user_information_get_ssh_keys (SNAPD_USER_INFORMATION (wrapped_object)));
 }
 
 QSnapdAuthData *QSnapdUserInformation::authData () const
@@ -39,12 +39,22 @@ struct _MockSnapd
 
     gchar *dir_path;
     gchar *socket_path;
+    gboolean listen_tcp;
+    guint16 tcp_port;
+    GHashTable *media_files;
+    guint media_downloads;
     gboolean close_on_request;
+    gboolean close_mid_response;
+    gboolean progress_listed_changes;
+    gboolean supports_notices;
     gboolean decline_auth;
+    GList *endpoints;
+    GHashTable *captured_responses;
     GList *accounts;
     GList *users;
     GList *interfaces;
     GList *snaps;
+    GHashTable *snaps_by_name;
     GList *snapshots;
     gchar *build_id;
     gchar *confinement;
@@ -61,15 +71,22 @@ struct _MockSnapd
     gchar *refresh_timer;
     GList *store_sections;
     GList *store_snaps;
+    GHashTable *store_snaps_by_name;
     GList *established_connections;
     GList *undesired_connections;
     GList *assertions;
+    GList *logs;
+    GHashTable *snapshot_archives;
     int change_index;
     GList *changes;
+    int notice_index;
+    GList *notices;
     gchar *suggested_currency;
     gchar *spawn_time;
     gchar *ready_time;
+    int progress_total;
     SoupMessageHeaders *last_request_headers;
+    guint request_count;
     GHashTable *gtk_theme_status;
     GHashTable *icon_theme_status;
     GHashTable *sound_theme_status;
@@ -77,6 +94,14 @@ struct _MockSnapd
 
 G_DEFINE_TYPE (MockSnapd, mock_snapd, G_TYPE_OBJECT)
 
+typedef struct
+{
+    gchar *path;
+    guint latency;
+    gsize bandwidth;
+    gboolean chunked;
+} MockEndpoint;
+
 struct _MockAccount
 {
     gint64 id;
@@ -112,6 +137,16 @@ struct _MockApp
     GList *aliases;
 };
 
+struct _MockNotice
+{
+    gchar *id;
+    gchar *type;
+    gchar *key;
+    gchar *last_repeated;
+    int occurrences;
+    GHashTable *last_data;
+};
+
 struct _MockChange
 {
     gchar *id;
@@ -408,13 +443,220 @@ mock_snapd_get_socket_path (MockSnapd *self)
     return self->socket_path;
 }
 
+void
+mock_snapd_set_listen_tcp (MockSnapd *self, gboolean listen_tcp)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+    self->listen_tcp = listen_tcp;
+}
+
+guint16
+mock_snapd_get_tcp_port (MockSnapd *self)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), 0);
+    return self->tcp_port;
+}
+
+void
+mock_snapd_add_media_file (MockSnapd *self, const gchar *path, const gchar *content)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    g_hash_table_insert (self->media_files, g_strdup (path), g_strdup (content));
+}
+
+guint
+mock_snapd_get_media_downloads (MockSnapd *self)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->media_downloads;
+}
+
 void
 mock_snapd_set_close_on_request (MockSnapd *self, gboolean close_on_request)
 {
     g_return_if_fail (MOCK_IS_SNAPD (self));
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
     self->close_on_request = close_on_request;
 }
 
+void
+mock_snapd_set_close_mid_response (MockSnapd *self, gboolean close_mid_response)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    self->close_mid_response = close_mid_response;
+}
+
+/* A response read from a file written by snapd_client_start_capture () */
+typedef struct
+{
+    guint latency;
+    gsize bandwidth;
+    guint status_code;
+    gchar *content_type;
+    GBytes *body;
+} MockCapturedResponse;
+
+static void
+mock_captured_response_free (MockCapturedResponse *response)
+{
+    g_free (response->content_type);
+    g_bytes_unref (response->body);
+    g_slice_free (MockCapturedResponse, response);
+}
+
+static void
+captured_responses_free (GQueue *responses)
+{
+    g_queue_free_full (responses, (GDestroyNotify) mock_captured_response_free);
+}
+
+static void
+mock_endpoint_free (MockEndpoint *endpoint)
+{
+    g_free (endpoint->path);
+    g_slice_free (MockEndpoint, endpoint);
+}
+
+static MockEndpoint *
+get_endpoint (MockSnapd *self, const gchar *path)
+{
+    for (GList *link = self->endpoints; link; link = link->next) {
+        MockEndpoint *endpoint = link->data;
+        if (strcmp (endpoint->path, path) == 0)
+            return endpoint;
+    }
+
+    MockEndpoint *endpoint = g_slice_new0 (MockEndpoint);
+    endpoint->path = g_strdup (path);
+    self->endpoints = g_list_append (self->endpoints, endpoint);
+
+    return endpoint;
+}
+
+static MockEndpoint *
+find_endpoint (MockSnapd *self, const gchar *path)
+{
+    /* Use the most specific path prefix that matches */
+    MockEndpoint *best_endpoint = NULL;
+    for (GList *link = self->endpoints; link; link = link->next) {
+        MockEndpoint *endpoint = link->data;
+        if (g_str_has_prefix (path, endpoint->path) &&
+            (best_endpoint == NULL || strlen (endpoint->path) > strlen (best_endpoint->path)))
+            best_endpoint = endpoint;
+    }
+
+    return best_endpoint;
+}
+
+gboolean
+mock_snapd_load_capture (MockSnapd *self, const gchar *path, GError **error)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), FALSE);
+
+    g_autofree gchar *contents = NULL;
+    gsize length;
+    if (!g_file_get_contents (path, &contents, &length, error))
+        return FALSE;
+
+    const gchar *header = "snapd-glib-capture 1\n";
+    if (!g_str_has_prefix (contents, header)) {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Not a capture file");
+        return FALSE;
+    }
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    if (self->captured_responses == NULL)
+        self->captured_responses = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) captured_responses_free);
+
+    gsize offset = strlen (header);
+    while (offset < length) {
+        const gchar *line_end = memchr (contents + offset, '\n', length - offset);
+        if (line_end == NULL) {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Truncated capture record");
+            return FALSE;
+        }
+        g_autofree gchar *line = g_strndup (contents + offset, line_end - (contents + offset));
+        g_auto(GStrv) fields = g_strsplit (line, " ", 8);
+        if (g_strv_length (fields) != 8) {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid capture record: %s", line);
+            return FALSE;
+        }
+        guint64 latency = g_ascii_strtoull (fields[1], NULL, 10);
+        guint64 duration = g_ascii_strtoull (fields[2], NULL, 10);
+        gsize body_length = g_ascii_strtoull (fields[4], NULL, 10);
+        offset = line_end - contents + 1;
+        if (body_length > length - offset || length - offset - body_length < 1 || contents[offset + body_length] != '\n') {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Truncated capture body for %s %s", fields[5], fields[6]);
+            return FALSE;
+        }
+
+        /* Reproduce the original time to the first byte and the rate the body arrived at */
+        MockCapturedResponse *response = g_slice_new0 (MockCapturedResponse);
+        response->latency = latency / 1000;
+        response->bandwidth = duration > 0 ? MAX (body_length * G_USEC_PER_SEC / duration, 1) : 0;
+        response->status_code = g_ascii_strtoull (fields[3], NULL, 10);
+        response->content_type = strcmp (fields[7], "-") != 0 ? g_strdup (fields[7]) : NULL;
+        response->body = g_bytes_new (contents + offset, body_length);
+        offset += body_length + 1;
+
+        g_autofree gchar *key = g_strdup_printf ("%s %s", fields[5], fields[6]);
+        GQueue *responses = g_hash_table_lookup (self->captured_responses, key);
+        if (responses == NULL) {
+            responses = g_queue_new ();
+            g_hash_table_insert (self->captured_responses, g_steal_pointer (&key), responses);
+        }
+        g_queue_push_tail (responses, response);
+    }
+
+    return TRUE;
+}
+
+void
+mock_snapd_set_endpoint_latency (MockSnapd *self, const gchar *path, guint latency)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    get_endpoint (self, path)->latency = latency;
+}
+
+void
+mock_snapd_set_endpoint_bandwidth (MockSnapd *self, const gchar *path, gsize bandwidth)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    get_endpoint (self, path)->bandwidth = bandwidth;
+}
+
+void
+mock_snapd_set_endpoint_chunked (MockSnapd *self, const gchar *path, gboolean chunked)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    get_endpoint (self, path)->chunked = chunked;
+}
+
+void
+mock_snapd_set_progress_listed_changes (MockSnapd *self, gboolean progress_listed_changes)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+    self->progress_listed_changes = progress_listed_changes;
+}
+
+void
+mock_snapd_set_supports_notices (MockSnapd *self, gboolean supports_notices)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+    self->supports_notices = supports_notices;
+}
+
 void
 mock_snapd_set_decline_auth (MockSnapd *self, gboolean decline_auth)
 {
@@ -564,6 +806,15 @@ mock_snapd_set_spawn_time (MockSnapd *self, const gchar *spawn_time)
     self->spawn_time = g_strdup (spawn_time);
 }
 
+void
+mock_snapd_set_progress_total (MockSnapd *self, int progress_total)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    self->progress_total = progress_total;
+}
+
 void
 mock_snapd_set_ready_time (MockSnapd *self, const gchar *ready_time)
 {
@@ -749,6 +1000,38 @@ mock_snapd_add_change (MockSnapd *self)
     return add_change (self);
 }
 
+MockNotice *
+mock_snapd_add_notice (MockSnapd *self, const gchar *type, const gchar *key, const gchar *last_repeated)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    MockNotice *notice = g_slice_new0 (MockNotice);
+    self->notice_index++;
+    notice->id = g_strdup_printf ("%d", self->notice_index);
+    notice->type = g_strdup (type);
+    notice->key = g_strdup (key);
+    notice->last_repeated = g_strdup (last_repeated);
+    notice->occurrences = 1;
+    notice->last_data = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    self->notices = g_list_append (self->notices, notice);
+
+    return notice;
+}
+
+void
+mock_notice_set_occurrences (MockNotice *notice, int occurrences)
+{
+    notice->occurrences = occurrences;
+}
+
+void
+mock_notice_add_last_data (MockNotice *notice, const gchar *name, const gchar *value)
+{
+    g_hash_table_insert (notice->last_data, g_strdup (name), g_strdup (value));
+}
+
 MockTask *
 mock_change_add_task (MockChange *change, const gchar *kind)
 {
@@ -938,6 +1221,38 @@ mock_interface_set_doc_url (MockInterface *interface, const gchar *url)
     interface->doc_url = g_strdup (url);
 }
 
+static void
+index_snap (MockSnapd *self, MockSnap *snap)
+{
+    /* Lookups return the first snap added with a given name */
+    if (!g_hash_table_contains (self->snaps_by_name, snap->name))
+        g_hash_table_insert (self->snaps_by_name, snap->name, snap);
+}
+
+static void
+add_snap (MockSnapd *self, MockSnap *snap)
+{
+    self->snaps = g_list_append (self->snaps, snap);
+    index_snap (self, snap);
+}
+
+static void
+remove_snap (MockSnapd *self, MockSnap *snap)
+{
+    self->snaps = g_list_remove (self->snaps, snap);
+
+    if (g_hash_table_lookup (self->snaps_by_name, snap->name) != snap)
+        return;
+    g_hash_table_remove (self->snaps_by_name, snap->name);
+    for (GList *link = self->snaps; link; link = link->next) {
+        MockSnap *s = link->data;
+        if (strcmp (s->name, snap->name) == 0) {
+            g_hash_table_insert (self->snaps_by_name, s->name, s);
+            break;
+        }
+    }
+}
+
 MockSnap *
 mock_snapd_add_snap (MockSnapd *self, const gchar *name)
 {
@@ -946,7 +1261,7 @@ mock_snapd_add_snap (MockSnapd *self, const gchar *name)
     g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
 
     MockSnap *snap = mock_snap_new (name);
-    self->snaps = g_list_append (self->snaps, snap);
+    add_snap (self, snap);
 
     return snap;
 }
@@ -954,13 +1269,7 @@ mock_snapd_add_snap (MockSnapd *self, const gchar *name)
 static MockSnap *
 find_snap (MockSnapd *self, const gchar *name)
 {
-    for (GList *link = self->snaps; link; link = link->next) {
-        MockSnap *snap = link->data;
-        if (strcmp (snap->name, name) == 0)
-            return snap;
-    }
-
-    return NULL;
+    return g_hash_table_lookup (self->snaps_by_name, name);
 }
 
 MockSnap *
@@ -972,6 +1281,19 @@ mock_snapd_find_snap (MockSnapd *self, const gchar *name)
     return find_snap (self, name);
 }
 
+void
+mock_snapd_remove_snap (MockSnapd *self, const gchar *name)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    MockSnap *snap = find_snap (self, name);
+    if (snap == NULL)
+        return;
+    remove_snap (self, snap);
+    mock_snap_free (snap);
+}
+
 static MockSnapshot *
 find_snapshot (MockSnapd *self, const gchar *name)
 {
@@ -1002,6 +1324,37 @@ mock_snapd_add_store_section (MockSnapd *self, const gchar *name)
     self->store_sections = g_list_append (self->store_sections, g_strdup (name));
 }
 
+static void
+index_store_snap (MockSnapd *self, MockSnap *snap)
+{
+    /* Store snaps can share a name when they are in different channels */
+    GPtrArray *snaps = g_hash_table_lookup (self->store_snaps_by_name, snap->name);
+    if (snaps == NULL) {
+        snaps = g_ptr_array_new ();
+        g_hash_table_insert (self->store_snaps_by_name, snap->name, snaps);
+    }
+    g_ptr_array_add (snaps, snap);
+}
+
+static MockSnap *
+new_store_snap (const gchar *name)
+{
+    MockSnap *snap = mock_snap_new (name);
+    snap->download_size = 65535;
+
+    return snap;
+}
+
+static MockSnap *
+add_store_snap (MockSnapd *self, const gchar *name)
+{
+    MockSnap *snap = new_store_snap (name);
+    self->store_snaps = g_list_append (self->store_snaps, snap);
+    index_store_snap (self, snap);
+
+    return snap;
+}
+
 MockSnap *
 mock_snapd_add_store_snap (MockSnapd *self, const gchar *name)
 {
@@ -1009,22 +1362,108 @@ mock_snapd_add_store_snap (MockSnapd *self, const gchar *name)
 
     g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
 
-    MockSnap *snap = mock_snap_new (name);
-    snap->download_size = 65535;
-    self->store_snaps = g_list_append (self->store_snaps, snap);
-
+    MockSnap *snap = add_store_snap (self, name);
     mock_snap_add_track (snap, "latest");
 
     return snap;
 }
 
+void
+mock_snapd_add_generated_snaps (MockSnapd *self, guint n_snaps, guint n_channels, guint n_apps, guint n_media, guint n_plugs)
+{
+    g_return_if_fail (MOCK_IS_SNAPD (self));
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    MockInterface *interface = mock_interface_new ("generated");
+    self->interfaces = g_list_append (self->interfaces, interface);
+
+    /* Build the lists separately so adding each snap doesn't have to walk the existing ones */
+    GList *snaps = NULL, *store_snaps = NULL;
+    const gchar *risks[] = { "stable", "candidate", "beta", "edge" };
+    for (guint i = 0; i < n_snaps; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%u", i);
+        g_autofree gchar *id = g_strdup_printf ("ID%u", i);
+        g_autofree gchar *summary = g_strdup_printf ("Summary of %s", name);
+        g_autofree gchar *description = g_strdup_printf ("Description of %s.\n\nThis snap was generated to make a large response.", name);
+
+        MockSnap *snap = mock_snap_new (name);
+        mock_snap_set_id (snap, id);
+        mock_snap_set_summary (snap, summary);
+        mock_snap_set_description (snap, description);
+        for (guint j = 0; j < n_apps; j++) {
+            g_autofree gchar *app_name = g_strdup_printf ("app%u", j);
+            mock_snap_add_app (snap, app_name);
+        }
+        for (guint j = 0; j < n_plugs; j++) {
+            g_autofree gchar *plug_name = g_strdup_printf ("plug%u", j);
+            g_autofree gchar *slot_name = g_strdup_printf ("slot%u", j);
+            mock_snap_add_plug (snap, interface, plug_name);
+            mock_snap_add_slot (snap, interface, slot_name);
+        }
+        snaps = g_list_prepend (snaps, snap);
+        index_snap (self, snap);
+
+        MockSnap *store_snap = new_store_snap (name);
+        mock_snap_set_id (store_snap, id);
+        mock_snap_set_summary (store_snap, summary);
+        mock_snap_set_description (store_snap, description);
+        MockTrack *track = mock_snap_add_track (store_snap, "latest");
+        for (guint j = 0; j < n_channels; j++) {
+            g_autofree gchar *branch = j < G_N_ELEMENTS (risks) ? NULL : g_strdup_printf ("branch%u", (guint) (j / G_N_ELEMENTS (risks)));
+            g_autofree gchar *revision = g_strdup_printf ("%u", j + 1);
+            MockChannel *channel = mock_track_add_channel (track, risks[j % G_N_ELEMENTS (risks)], branch);
+            mock_channel_set_revision (channel, revision);
+        }
+        for (guint j = 0; j < n_media; j++) {
+            g_autofree gchar *url = g_strdup_printf ("http://example.com/%s/screenshot%u.png", name, j);
+            mock_snap_add_media (store_snap, "screenshot", url, 1024, 768);
+        }
+        store_snaps = g_list_prepend (store_snaps, store_snap);
+        index_store_snap (self, store_snap);
+    }
+
+    self->snaps = g_list_concat (self->snaps, g_list_reverse (snaps));
+    self->store_snaps = g_list_concat (self->store_snaps, g_list_reverse (store_snaps));
+}
+
+MockChange *
+mock_snapd_add_generated_change (MockSnapd *self, guint n_tasks)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    MockChange *change = add_change (self);
+    GList *tasks = NULL;
+    for (guint i = 0; i < n_tasks; i++) {
+        MockTask *task = g_slice_new0 (MockTask);
+        task->id = g_strdup_printf ("%d", change->task_index);
+        change->task_index++;
+        task->kind = g_strdup ("generated");
+        task->summary = g_strdup_printf ("Task %u of %u", i + 1, n_tasks);
+        task->status = g_strdup ("Do");
+        task->progress_label = g_strdup ("LABEL");
+        task->progress_done = 0;
+        task->progress_total = 1;
+        task->spawn_time = g_strdup ("2017-01-02T11:23:58Z");
+        tasks = g_list_prepend (tasks, task);
+    }
+    change->tasks = g_list_concat (change->tasks, g_list_reverse (tasks));
+
+    return change;
+}
+
 static MockSnap *
 find_store_snap_by_name (MockSnapd *self, const gchar *name, const gchar *channel, const gchar *revision)
 {
-    for (GList *link = self->store_snaps; link; link = link->next) {
-        MockSnap *snap = link->data;
-        if (strcmp (snap->name, name) == 0 &&
-            (channel == NULL || g_strcmp0 (snap->channel, channel) == 0) &&
+    GPtrArray *snaps = g_hash_table_lookup (self->store_snaps_by_name, name);
+    if (snaps == NULL)
+        return NULL;
+
+    for (guint i = 0; i < snaps->len; i++) {
+        MockSnap *snap = g_ptr_array_index (snaps, i);
+        if ((channel == NULL || g_strcmp0 (snap->channel, channel) == 0) &&
             (revision == NULL || g_strcmp0 (snap->revision, revision) == 0))
             return snap;
     }
@@ -1503,6 +1942,13 @@ mock_snap_add_media (MockSnap *snap, const gchar *type, const gchar *url, int wi
     return media;
 }
 
+void
+mock_media_set_url (MockMedia *media, const gchar *url)
+{
+    g_free (media->url);
+    media->url = g_strdup (url);
+}
+
 void
 mock_snap_set_status (MockSnap *snap, const gchar *status)
 {
@@ -1751,6 +2197,50 @@ mock_snapd_get_assertions (MockSnapd *self)
     return self->assertions;
 }
 
+void
+mock_snapd_add_log (MockSnapd *self, const gchar *timestamp, const gchar *sid, const gchar *pid, const gchar *message)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    g_autoptr(JsonBuilder) builder = json_builder_new ();
+    json_builder_begin_object (builder);
+    json_builder_set_member_name (builder, "timestamp");
+    json_builder_add_string_value (builder, timestamp);
+    json_builder_set_member_name (builder, "message");
+    json_builder_add_string_value (builder, message);
+    json_builder_set_member_name (builder, "sid");
+    json_builder_add_string_value (builder, sid);
+    json_builder_set_member_name (builder, "pid");
+    json_builder_add_string_value (builder, pid);
+    json_builder_end_object (builder);
+    self->logs = g_list_append (self->logs, json_builder_get_root (builder));
+}
+
+void
+mock_snapd_add_snapshot_archive (MockSnapd *self, gint64 set_id, GBytes *data)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    gint64 *key = g_new (gint64, 1);
+    *key = set_id;
+    g_hash_table_insert (self->snapshot_archives, key, g_bytes_ref (data));
+}
+
+GBytes *
+mock_snapd_get_snapshot_archive (MockSnapd *self, gint64 set_id)
+{
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return g_hash_table_lookup (self->snapshot_archives, &set_id);
+}
+
+guint
+mock_snapd_get_request_count (MockSnapd *self)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), 0);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+    return self->request_count;
+}
+
 const gchar *
 mock_snapd_get_last_user_agent (MockSnapd *self)
 {
@@ -1790,6 +2280,19 @@ mock_snapd_get_last_allow_interaction (MockSnapd *self)
     return soup_message_headers_get_one (self->last_request_headers, "X-Allow-Interaction");
 }
 
+const gchar *
+mock_snapd_get_last_authorization (MockSnapd *self)
+{
+    g_return_val_if_fail (MOCK_IS_SNAPD (self), NULL);
+
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new (&self->mutex);
+
+    if (self->last_request_headers == NULL)
+        return NULL;
+
+    return soup_message_headers_get_one (self->last_request_headers, "Authorization");
+}
+
 void
 mock_snapd_set_gtk_theme_status (MockSnapd *self, const gchar *name, const gchar *status)
 {
@@ -1837,6 +2340,17 @@ mock_task_free (MockTask *task)
     g_slice_free (MockTask, task);
 }
 
+static void
+mock_notice_free (MockNotice *notice)
+{
+    g_free (notice->id);
+    g_free (notice->type);
+    g_free (notice->key);
+    g_free (notice->last_repeated);
+    g_hash_table_unref (notice->last_data);
+    g_slice_free (MockNotice, notice);
+}
+
 static void
 mock_change_free (MockChange *change)
 {
@@ -2615,19 +3129,24 @@ get_refreshable_snaps (MockSnapd *self)
     return g_steal_pointer (&refreshable_snaps);
 }
 
-static gboolean
-filter_snaps (GStrv selected_snaps, MockSnap *snap)
+static GHashTable *
+make_snap_filter (GStrv selected_snaps)
 {
     /* If no filter selected, then return all snaps */
     if (selected_snaps == NULL || selected_snaps[0] == NULL)
-        return TRUE;
+        return NULL;
 
-    for (int i = 0; selected_snaps[i] != NULL; i++) {
-        if (strcmp (selected_snaps[i], snap->name) == 0)
-            return TRUE;
-    }
+    GHashTable *filter = g_hash_table_new (g_str_hash, g_str_equal);
+    for (int i = 0; selected_snaps[i] != NULL; i++)
+        g_hash_table_add (filter, selected_snaps[i]);
 
-    return FALSE;
+    return filter;
+}
+
+static gboolean
+filter_snaps (GHashTable *filter, MockSnap *snap)
+{
+    return filter == NULL || g_hash_table_contains (filter, snap->name);
 }
 
 static void
@@ -2656,12 +3175,13 @@ handle_snaps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
                 selected_snaps = g_strsplit (snaps_param, ",", -1);
         }
 
+        g_autoptr(GHashTable) filter = make_snap_filter (selected_snaps);
         g_autoptr(JsonBuilder) builder = json_builder_new ();
         json_builder_begin_array (builder);
         for (GList *link = self->snaps; link; link = link->next) {
             MockSnap *snap = link->data;
 
-            if (!filter_snaps (selected_snaps, snap))
+            if (!filter_snaps (filter, snap))
                 continue;
 
             if ((select_param == NULL || strcmp (select_param, "enabled") == 0) && strcmp (snap->status, "active") != 0)
@@ -2682,8 +3202,18 @@ handle_snaps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
 
         JsonObject *o = json_node_get_object (request);
         const gchar *action = json_object_get_string_member (o, "action");
+        g_autoptr(GPtrArray) snaps = g_ptr_array_new ();
+        if (json_object_has_member (o, "snaps")) {
+            JsonArray *a = json_object_get_array_member (o, "snaps");
+            for (guint i = 0; i < json_array_get_length (a); i++)
+                g_ptr_array_add (snaps, (gpointer) json_array_get_string_element (a, i));
+        }
+        g_ptr_array_add (snaps, NULL);
+        GStrv snap_names = (GStrv) snaps->pdata;
+
         if (strcmp (action, "refresh") == 0) {
             g_autoptr(GList) refreshable_snaps = get_refreshable_snaps (self);
+            g_autoptr(GHashTable) filter = make_snap_filter (snap_names);
 
             g_autoptr(JsonBuilder) builder = json_builder_new ();
             json_builder_begin_object (builder);
@@ -2691,14 +3221,80 @@ handle_snaps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
             json_builder_begin_array (builder);
             for (GList *link = refreshable_snaps; link; link = link->next) {
                 MockSnap *snap = link->data;
-                json_builder_add_string_value (builder, snap->name);
+                if (filter_snaps (filter, snap))
+                    json_builder_add_string_value (builder, snap->name);
+            }
+            json_builder_end_array (builder);
+            json_builder_end_object (builder);
+
+            MockChange *change = add_change (self);
+            change->data = json_builder_get_root (builder);
+            for (GList *link = refreshable_snaps; link; link = link->next) {
+                if (filter_snaps (filter, link->data))
+                    mock_change_add_task (change, "refresh");
+            }
+            send_async_response (self, message, 202, change->id);
+        }
+        else if (strcmp (action, "install") == 0 && snap_names[0] != NULL) {
+            for (int i = 0; snap_names[i] != NULL; i++) {
+                if (find_snap (self, snap_names[i]) != NULL) {
+                    send_error_bad_request (self, message, "snap is already installed", "snap-already-installed");
+                    return;
+                }
+                if (find_store_snap_by_name (self, snap_names[i], NULL, NULL) == NULL) {
+                    send_error_not_found (self, message, "cannot install, snap not found", "snap-not-found");
+                    return;
+                }
+            }
+
+            g_autoptr(JsonBuilder) builder = json_builder_new ();
+            json_builder_begin_object (builder);
+            json_builder_set_member_name (builder, "snap-names");
+            json_builder_begin_array (builder);
+            for (int i = 0; snap_names[i] != NULL; i++)
+                json_builder_add_string_value (builder, snap_names[i]);
+            json_builder_end_array (builder);
+            json_builder_end_object (builder);
+
+            MockChange *change = add_change (self);
+            change->data = json_builder_get_root (builder);
+            for (int i = 0; snap_names[i] != NULL; i++) {
+                MockSnap *store_snap = find_store_snap_by_name (self, snap_names[i], NULL, NULL);
+                MockTask *task = mock_change_add_task (change, "install");
+                if (self->progress_total > 0)
+                    mock_task_set_progress (task, 0, self->progress_total);
+                task->snap = mock_snap_new (snap_names[i]);
+                mock_snap_set_confinement (task->snap, store_snap->confinement);
+                mock_snap_set_channel (task->snap, store_snap->channel);
+                mock_snap_set_revision (task->snap, store_snap->revision);
+                if (store_snap->error != NULL)
+                    task->error = g_strdup (store_snap->error);
+            }
+            send_async_response (self, message, 202, change->id);
+        }
+        else if (strcmp (action, "remove") == 0 && snap_names[0] != NULL) {
+            for (int i = 0; snap_names[i] != NULL; i++) {
+                if (find_snap (self, snap_names[i]) == NULL) {
+                    send_error_bad_request (self, message, "snap is not installed", "snap-not-installed");
+                    return;
+                }
             }
+
+            g_autoptr(JsonBuilder) builder = json_builder_new ();
+            json_builder_begin_object (builder);
+            json_builder_set_member_name (builder, "snap-names");
+            json_builder_begin_array (builder);
+            for (int i = 0; snap_names[i] != NULL; i++)
+                json_builder_add_string_value (builder, snap_names[i]);
             json_builder_end_array (builder);
             json_builder_end_object (builder);
 
             MockChange *change = add_change (self);
             change->data = json_builder_get_root (builder);
-            mock_change_add_task (change, "refresh");
+            for (int i = 0; snap_names[i] != NULL; i++) {
+                MockTask *task = mock_change_add_task (change, "remove");
+                mock_task_set_snap_name (task, snap_names[i]);
+            }
             send_async_response (self, message, 202, change->id);
         }
         else {
@@ -2904,6 +3500,8 @@ handle_snap (MockSnapd *self, SoupServerMessage *message, const gchar *name)
             mock_change_set_spawn_time (change, self->spawn_time);
             mock_change_set_ready_time (change, self->ready_time);
             MockTask *task = mock_change_add_task (change, "install");
+            if (self->progress_total > 0)
+                mock_task_set_progress (task, 0, self->progress_total);
             task->snap = mock_snap_new (name);
             mock_snap_set_confinement (task->snap, snap->confinement);
             mock_snap_set_channel (task->snap, snap->channel);
@@ -3119,6 +3717,71 @@ handle_snap_conf (MockSnapd *self, SoupServerMessage *message, const gchar *name
         send_error_method_not_allowed (self, message, "method not allowed");
 }
 
+/* Find the services in an installed snap, or a single service if @name is in the form snap.app */
+static GList *
+find_services (MockSnapd *self, const gchar *name)
+{
+    g_auto(GStrv) tokens = g_strsplit (name, ".", 2);
+    MockSnap *snap = find_snap (self, tokens[0]);
+    if (snap == NULL)
+        return NULL;
+
+    GList *services = NULL;
+    for (GList *link = snap->apps; link; link = link->next) {
+        MockApp *app = link->data;
+        if (app->daemon != NULL && (tokens[1] == NULL || strcmp (tokens[1], app->name) == 0))
+            services = g_list_append (services, app);
+    }
+
+    return services;
+}
+
+static void
+control_services (MockSnapd *self, SoupServerMessage *message)
+{
+    g_autoptr(JsonNode) request = get_json (message);
+    if (request == NULL) {
+        send_error_bad_request (self, message, "unknown content type", NULL);
+        return;
+    }
+
+    JsonObject *o = json_node_get_object (request);
+    const gchar *action = json_object_get_string_member (o, "action");
+    if (g_strcmp0 (action, "start") != 0 && g_strcmp0 (action, "stop") != 0 && g_strcmp0 (action, "restart") != 0) {
+        send_error_bad_request (self, message, "unknown action", NULL);
+        return;
+    }
+    gboolean enable = json_object_has_member (o, "enable") && json_object_get_boolean_member (o, "enable");
+    gboolean disable = json_object_has_member (o, "disable") && json_object_get_boolean_member (o, "disable");
+
+    /* Check all the names before changing anything, as snapd does */
+    g_autoptr(GList) services = NULL;
+    JsonArray *names = json_object_get_array_member (o, "names");
+    for (guint i = 0; names != NULL && i < json_array_get_length (names); i++) {
+        GList *s = find_services (self, json_array_get_string_element (names, i));
+        if (s == NULL) {
+            send_error_not_found (self, message, "snap or service not found", "app-not-found");
+            return;
+        }
+        services = g_list_concat (services, s);
+    }
+
+    for (GList *link = services; link; link = link->next) {
+        MockApp *app = link->data;
+        app->active = strcmp (action, "stop") != 0;
+        if (enable)
+            app->enabled = TRUE;
+        if (disable)
+            app->enabled = FALSE;
+    }
+
+    MockChange *change = add_change (self);
+    mock_change_set_spawn_time (change, self->spawn_time);
+    mock_change_set_ready_time (change, self->ready_time);
+    mock_change_add_task (change, action);
+    send_async_response (self, message, 202, change->id);
+}
+
 static void
 handle_apps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
 {
@@ -3128,6 +3791,10 @@ handle_apps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
     const gchar *method = message->method;
 #endif
 
+    if (strcmp (method, "POST") == 0) {
+        control_services (self, message);
+        return;
+    }
     if (strcmp (method, "GET") != 0) {
         send_error_method_not_allowed (self, message, "method not allowed");
         return;
@@ -3144,18 +3811,21 @@ handle_apps (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
             selected_snaps = g_strsplit (snaps_param, ",", -1);
     }
 
+    g_autoptr(GHashTable) filter = make_snap_filter (selected_snaps);
     g_autoptr(JsonBuilder) builder = json_builder_new ();
     json_builder_begin_array (builder);
     for (GList *link = self->snaps; link; link = link->next) {
         MockSnap *snap = link->data;
         GList *app_link;
 
-        if (!filter_snaps (selected_snaps, snap))
-            continue;
-
         for (app_link = snap->apps; app_link; app_link = app_link->next) {
             MockApp *app = app_link->data;
 
+            /* Names can be for a whole snap or for a single app */
+            g_autofree gchar *app_name = g_strdup_printf ("%s.%s", snap->name, app->name);
+            if (!filter_snaps (filter, snap) && !g_hash_table_contains (filter, app_name))
+                continue;
+
             if (g_strcmp0 (select_param, "service") == 0 && app->daemon == NULL)
                 continue;
 
@@ -3199,49 +3869,185 @@ handle_icon (MockSnapd *self, SoupServerMessage *message, const gchar *path)
 }
 
 static void
-handle_assertions (MockSnapd *self, SoupServerMessage *message, const gchar *type)
+handle_assertions (MockSnapd *self, SoupServerMessage *message, const gchar *type)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    const gchar *method = soup_server_message_get_method (message);
+    SoupMessageBody *request_body = soup_server_message_get_request_body (message);
+#else
+    const gchar *method = message->method;
+    SoupMessageBody *request_body = message->request_body;
+#endif
+
+    if (strcmp (method, "GET") == 0) {
+        g_autoptr(GString) response_content = g_string_new (NULL);
+        g_autofree gchar *type_header = g_strdup_printf ("type: %s\n", type);
+        int count = 0;
+        for (GList *link = self->assertions; link; link = link->next) {
+            const gchar *assertion = link->data;
+
+            if (!g_str_has_prefix (assertion, type_header))
+                continue;
+
+            count++;
+            if (count != 1)
+                g_string_append (response_content, "\n\n");
+            g_string_append (response_content, assertion);
+        }
+
+        if (count == 0) {
+            send_error_bad_request (self, message, "invalid assert type", NULL);
+            return;
+        }
+
+        // FIXME: X-Ubuntu-Assertions-Count header
+        send_response (message, 200, "application/x.ubuntu.assertion; bundle=y", (guint8*) response_content->str, response_content->len);
+    }
+    else if (strcmp (method, "POST") == 0) {
+        g_autofree gchar *assertion = g_strndup (request_body->data, request_body->length);
+        add_assertion (self, assertion);
+        send_sync_response (self, message, 200, NULL, NULL);
+    }
+    else {
+        send_error_method_not_allowed (self, message, "method not allowed");
+        return;
+    }
+}
+
+static gboolean
+log_matches (JsonNode *log, GStrv names)
+{
+    if (names == NULL)
+        return TRUE;
+
+    const gchar *sid = json_object_get_string_member (json_node_get_object (log), "sid");
+    for (int i = 0; names[i] != NULL; i++) {
+        g_autofree gchar *service = g_strdup_printf ("snap.%s", names[i]);
+        g_autofree gchar *prefix = g_strdup_printf ("snap.%s.", names[i]);
+        if (strcmp (sid, service) == 0 || g_str_has_prefix (sid, prefix))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void
+handle_logs (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    const gchar *method = soup_server_message_get_method (message);
+#else
+    const gchar *method = message->method;
+#endif
+
+    if (strcmp (method, "GET") != 0) {
+        send_error_method_not_allowed (self, message, "method not allowed");
+        return;
+    }
+
+    g_auto(GStrv) names = NULL;
+    int n = 10;
+    if (query != NULL) {
+        const gchar *names_param = g_hash_table_lookup (query, "names");
+        if (names_param != NULL)
+            names = g_strsplit (names_param, ",", -1);
+        const gchar *n_param = g_hash_table_lookup (query, "n");
+        if (n_param != NULL)
+            n = g_ascii_strtoll (n_param, NULL, 10);
+    }
+
+    g_autoptr(GPtrArray) logs = g_ptr_array_new ();
+    for (GList *link = self->logs; link; link = link->next) {
+        JsonNode *log = link->data;
+        if (log_matches (log, names))
+            g_ptr_array_add (logs, log);
+    }
+
+    if (logs->len == 0) {
+        send_error_not_found (self, message, "no matching services", NULL);
+        return;
+    }
+
+    /* Records are sent as application/json-seq, and the stream ends when there are no more logs to follow */
+    g_autoptr(GString) response_content = g_string_new (NULL);
+    guint start = n >= 0 && (guint) n < logs->len ? logs->len - n : 0;
+    for (guint i = start; i < logs->len; i++) {
+        g_autofree gchar *record = json_to_string (g_ptr_array_index (logs, i), FALSE);
+        g_string_append_printf (response_content, "\x1e%s\n", record);
+    }
+    send_response (message, 200, "application/json-seq", (guint8 *) response_content->str, response_content->len);
+}
+
+/* Snapshot archives are opaque to the mock, so imports don't report any snaps */
+static void
+handle_snapshots (MockSnapd *self, SoupServerMessage *message)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    const gchar *method = soup_server_message_get_method (message);
+    SoupMessageHeaders *request_headers = soup_server_message_get_request_headers (message);
+    SoupMessageBody *request_body = soup_server_message_get_request_body (message);
+#else
+    const gchar *method = message->method;
+    SoupMessageHeaders *request_headers = message->request_headers;
+    SoupMessageBody *request_body = message->request_body;
+#endif
+
+    if (strcmp (method, "POST") != 0) {
+        send_error_method_not_allowed (self, message, "method not allowed");
+        return;
+    }
+
+    if (g_strcmp0 (soup_message_headers_get_content_type (request_headers, NULL), "application/x.snapd.snapshot") != 0) {
+        send_error_bad_request (self, message, "unknown content type", NULL);
+        return;
+    }
+    if (soup_message_headers_get_encoding (request_headers) != SOUP_ENCODING_CONTENT_LENGTH) {
+        send_error_bad_request (self, message, "cannot parse Content-Length", NULL);
+        return;
+    }
+
+    gint64 *set_id = g_new (gint64, 1);
+    *set_id = 1;
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init (&iter, self->snapshot_archives);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        *set_id = MAX (*set_id, *((gint64 *) key) + 1);
+    g_hash_table_insert (self->snapshot_archives, set_id, g_bytes_new (request_body->data, request_body->length));
+
+    g_autoptr(JsonBuilder) builder = json_builder_new ();
+    json_builder_begin_object (builder);
+    json_builder_set_member_name (builder, "set-id");
+    json_builder_add_int_value (builder, *set_id);
+    json_builder_set_member_name (builder, "snaps");
+    json_builder_begin_array (builder);
+    json_builder_end_array (builder);
+    json_builder_end_object (builder);
+    send_sync_response (self, message, 200, json_builder_get_root (builder), NULL);
+}
+
+static void
+handle_snapshot_export (MockSnapd *self, SoupServerMessage *message, const gchar *id)
 {
 #if SOUP_CHECK_VERSION (2, 99, 2)
     const gchar *method = soup_server_message_get_method (message);
-    SoupMessageBody *request_body = soup_server_message_get_request_body (message);
 #else
     const gchar *method = message->method;
-    SoupMessageBody *request_body = message->request_body;
 #endif
 
-    if (strcmp (method, "GET") == 0) {
-        g_autoptr(GString) response_content = g_string_new (NULL);
-        g_autofree gchar *type_header = g_strdup_printf ("type: %s\n", type);
-        int count = 0;
-        for (GList *link = self->assertions; link; link = link->next) {
-            const gchar *assertion = link->data;
-
-            if (!g_str_has_prefix (assertion, type_header))
-                continue;
-
-            count++;
-            if (count != 1)
-                g_string_append (response_content, "\n\n");
-            g_string_append (response_content, assertion);
-        }
-
-        if (count == 0) {
-            send_error_bad_request (self, message, "invalid assert type", NULL);
-            return;
-        }
-
-        // FIXME: X-Ubuntu-Assertions-Count header
-        send_response (message, 200, "application/x.ubuntu.assertion; bundle=y", (guint8*) response_content->str, response_content->len);
-    }
-    else if (strcmp (method, "POST") == 0) {
-        g_autofree gchar *assertion = g_strndup (request_body->data, request_body->length);
-        add_assertion (self, assertion);
-        send_sync_response (self, message, 200, NULL, NULL);
-    }
-    else {
+    if (strcmp (method, "GET") != 0) {
         send_error_method_not_allowed (self, message, "method not allowed");
         return;
     }
+
+    gint64 set_id = g_ascii_strtoll (id, NULL, 10);
+    GBytes *data = g_hash_table_lookup (self->snapshot_archives, &set_id);
+    if (data == NULL) {
+        send_error_not_found (self, message, "cannot find snapshot set", NULL);
+        return;
+    }
+
+    send_response (message, 200, "application/x.snapd.snapshot", g_bytes_get_data (data, NULL), g_bytes_get_size (data));
 }
 
 static void
@@ -3956,6 +4762,8 @@ change_relates_to_snap (MockChange *change, const gchar *snap_name)
     return FALSE;
 }
 
+static void mock_change_progress (MockSnapd *self, MockChange *change);
+
 static void
 handle_changes (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
 {
@@ -3987,6 +4795,8 @@ handle_changes (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
         if (for_param != NULL && !change_relates_to_snap (change, for_param))
             continue;
 
+        if (self->progress_listed_changes)
+            mock_change_progress (self, change);
         json_builder_add_value (builder, make_change_node (change));
     }
     json_builder_end_array (builder);
@@ -3998,10 +4808,10 @@ static void
 mock_task_complete (MockSnapd *self, MockTask *task)
 {
     if (strcmp (task->kind, "install") == 0 || strcmp (task->kind, "try") == 0)
-        self->snaps = g_list_append (self->snaps, g_steal_pointer (&task->snap));
+        add_snap (self, g_steal_pointer (&task->snap));
     else if (strcmp (task->kind, "remove") == 0) {
         MockSnap *snap = find_snap (self, task->snap_name);
-        self->snaps = g_list_remove (self->snaps, snap);
+        remove_snap (self, snap);
         mock_snap_free (snap);
 
         /* Add a snapshot */
@@ -4032,6 +4842,103 @@ mock_change_progress (MockSnapd *self, MockChange *change)
     }
 }
 
+static void
+add_notice_node (JsonBuilder *builder, const gchar *id, const gchar *type, const gchar *key, const gchar *last_repeated, int occurrences, GHashTable *last_data)
+{
+    json_builder_begin_object (builder);
+    json_builder_set_member_name (builder, "id");
+    json_builder_add_string_value (builder, id);
+    json_builder_set_member_name (builder, "type");
+    json_builder_add_string_value (builder, type);
+    json_builder_set_member_name (builder, "key");
+    json_builder_add_string_value (builder, key);
+    json_builder_set_member_name (builder, "first-occurred");
+    json_builder_add_string_value (builder, last_repeated);
+    json_builder_set_member_name (builder, "last-occurred");
+    json_builder_add_string_value (builder, last_repeated);
+    json_builder_set_member_name (builder, "last-repeated");
+    json_builder_add_string_value (builder, last_repeated);
+    json_builder_set_member_name (builder, "occurrences");
+    json_builder_add_int_value (builder, occurrences);
+    if (last_data != NULL && g_hash_table_size (last_data) > 0) {
+        json_builder_set_member_name (builder, "last-data");
+        json_builder_begin_object (builder);
+        GHashTableIter iter;
+        g_hash_table_iter_init (&iter, last_data);
+        gpointer name, value;
+        while (g_hash_table_iter_next (&iter, &name, &value)) {
+            json_builder_set_member_name (builder, name);
+            json_builder_add_string_value (builder, value);
+        }
+        json_builder_end_object (builder);
+    }
+    json_builder_end_object (builder);
+}
+
+static gboolean
+notice_type_matches (const gchar *types_param, const gchar *type)
+{
+    if (types_param == NULL)
+        return TRUE;
+
+    g_auto(GStrv) types = g_strsplit (types_param, ",", -1);
+    return g_strv_contains ((const gchar * const *) types, type);
+}
+
+static void
+handle_notices (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    const gchar *method = soup_server_message_get_method (message);
+#else
+    const gchar *method = message->method;
+#endif
+
+    if (!self->supports_notices && self->notices == NULL) {
+        send_error_not_found (self, message, "not found", NULL);
+        return;
+    }
+
+    if (strcmp (method, "GET") != 0) {
+        send_error_method_not_allowed (self, message, "method not allowed");
+        return;
+    }
+
+    const gchar *types_param = NULL, *after_param = NULL;
+    if (query != NULL) {
+        types_param = g_hash_table_lookup (query, "types");
+        after_param = g_hash_table_lookup (query, "after");
+    }
+
+    g_autoptr(JsonBuilder) builder = json_builder_new ();
+    json_builder_begin_array (builder);
+    for (GList *link = self->notices; link; link = link->next) {
+        MockNotice *notice = link->data;
+
+        if (!notice_type_matches (types_param, notice->type))
+            continue;
+        if (after_param != NULL && g_strcmp0 (notice->last_repeated, after_param) <= 0)
+            continue;
+
+        add_notice_node (builder, notice->id, notice->type, notice->key, notice->last_repeated, notice->occurrences, notice->last_data);
+    }
+
+    /* Every change in progress is treated as just having been updated */
+    if (self->supports_notices && notice_type_matches (types_param, "change-update")) {
+        for (GList *link = self->changes; link; link = link->next) {
+            MockChange *change = link->data;
+
+            if (change_get_ready (change))
+                continue;
+
+            add_notice_node (builder, change->id, "change-update", change->id, "2017-01-02T11:23:58Z", 1, NULL);
+        }
+    }
+    json_builder_end_array (builder);
+
+    send_sync_response (self, message, 200, json_builder_get_root (builder), NULL);
+}
+
 static void
 handle_change (MockSnapd *self, SoupServerMessage *message, const gchar *change_id)
 {
@@ -4225,6 +5132,16 @@ handle_find (MockSnapd *self, SoupServerMessage *message, GHashTable *query)
         }
     }
 
+    /* Only look at the snaps with the requested name */
+    g_autoptr(GList) named_snaps = NULL;
+    if (name_param != NULL && snaps == self->store_snaps) {
+        GPtrArray *store_snaps = g_hash_table_lookup (self->store_snaps_by_name, name_param);
+        for (guint i = 0; store_snaps != NULL && i < store_snaps->len; i++)
+            named_snaps = g_list_prepend (named_snaps, g_ptr_array_index (store_snaps, i));
+        named_snaps = g_list_reverse (named_snaps);
+        snaps = named_snaps;
+    }
+
     g_autoptr(JsonBuilder) builder = json_builder_new ();
     json_builder_begin_array (builder);
     for (GList *link = snaps; link; link = link->next) {
@@ -4730,6 +5647,13 @@ handle_download (MockSnapd *self, SoupServerMessage *message)
     if (json_object_has_member (o, "revision"))
         revision = json_object_get_string_member (o, "revision");
 
+    gboolean header_peek = FALSE;
+    if (json_object_has_member (o, "header-peek"))
+        header_peek = json_object_get_boolean_member (o, "header-peek");
+    const gchar *resume_token = NULL;
+    if (json_object_has_member (o, "resume-token"))
+        resume_token = json_object_get_string_member (o, "resume-token");
+
     g_autoptr(GString) contents = g_string_new ("SNAP");
     g_string_append_printf (contents, ":name=%s", snap_name);
     if (channel != NULL)
@@ -4737,7 +5661,49 @@ handle_download (MockSnapd *self, SoupServerMessage *message)
     if (revision != NULL)
         g_string_append_printf (contents, ":revision=%s", revision);
 
-    send_response (message, 200, "application/octet-stream", (const guint8 *) contents->str, contents->len);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    SoupMessageHeaders *request_headers = soup_server_message_get_request_headers (message);
+    SoupMessageHeaders *response_headers = soup_server_message_get_response_headers (message);
+#else
+    SoupMessageHeaders *request_headers = message->request_headers;
+    SoupMessageHeaders *response_headers = message->response_headers;
+#endif
+
+    gsize offset = 0;
+    const gchar *range = soup_message_headers_get_one (request_headers, "Range");
+    if (range != NULL) {
+        if (g_strcmp0 (resume_token, "RESUME-TOKEN") != 0) {
+            send_error_bad_request (self, message, "cannot resume without a token", NULL);
+            return;
+        }
+        if (!g_str_has_prefix (range, "bytes=")) {
+            send_error_bad_request (self, message, "invalid range", NULL);
+            return;
+        }
+        offset = g_ascii_strtoull (range + strlen ("bytes="), NULL, 10);
+        if (offset > contents->len) {
+            send_error_bad_request (self, message, "invalid range", NULL);
+            return;
+        }
+    }
+
+    g_autofree gchar *disposition = g_strdup_printf ("attachment; filename=%s", snap_name);
+    soup_message_headers_append (response_headers, "Content-Disposition", disposition);
+    g_autofree gchar *sha3_384 = g_strdup_printf ("SHA3-384:%s", snap_name);
+    soup_message_headers_append (response_headers, "Snap-Sha3-384", sha3_384);
+    g_autofree gchar *snap_length = g_strdup_printf ("%" G_GSIZE_FORMAT, contents->len);
+    soup_message_headers_append (response_headers, "Snap-Length", snap_length);
+    soup_message_headers_append (response_headers, "Snap-Download-Token", "RESUME-TOKEN");
+
+    if (header_peek)
+        send_response (message, 200, "application/octet-stream", NULL, 0);
+    else if (offset > 0) {
+        g_autofree gchar *content_range = g_strdup_printf ("bytes %" G_GSIZE_FORMAT "-%" G_GSIZE_FORMAT "/%" G_GSIZE_FORMAT, offset, contents->len - 1, contents->len);
+        soup_message_headers_append (response_headers, "Content-Range", content_range);
+        send_response (message, 206, "application/octet-stream", (const guint8 *) contents->str + offset, contents->len - offset);
+    }
+    else
+        send_response (message, 200, "application/octet-stream", (const guint8 *) contents->str, contents->len);
 }
 
 static int
@@ -4854,6 +5820,210 @@ handle_themes (MockSnapd *self, SoupServerMessage *message)
     }
 }
 
+/* Interval between writes when limiting bandwidth, in milliseconds */
+#define SHAPED_RESPONSE_INTERVAL 10
+
+typedef struct
+{
+    SoupServer *server;
+    SoupServerMessage *message;
+    GMainContext *context;
+    GBytes *content;
+    gsize offset;
+    gsize bandwidth;
+    gboolean finished;
+    gulong finished_handler;
+} ShapedResponse;
+
+static void
+shaped_response_free (ShapedResponse *response)
+{
+    g_signal_handler_disconnect (response->message, response->finished_handler);
+    g_object_unref (response->server);
+    g_object_unref (response->message);
+    g_main_context_unref (response->context);
+    g_bytes_unref (response->content);
+    g_slice_free (ShapedResponse, response);
+}
+
+static void
+message_finished_cb (ShapedResponse *response)
+{
+    response->finished = TRUE;
+}
+
+static void
+pause_message (SoupServer *server, SoupServerMessage *message)
+{
+#if SOUP_CHECK_VERSION (3, 2, 0)
+    soup_server_message_pause (message);
+#else
+    soup_server_pause_message (server, message);
+#endif
+}
+
+static void
+unpause_message (SoupServer *server, SoupServerMessage *message)
+{
+#if SOUP_CHECK_VERSION (3, 2, 0)
+    soup_server_message_unpause (message);
+#else
+    soup_server_unpause_message (server, message);
+#endif
+}
+
+static gboolean write_shaped_response (gpointer user_data);
+
+static void
+schedule_shaped_response (ShapedResponse *response, guint delay)
+{
+    g_autoptr(GSource) source = g_timeout_source_new (delay);
+    g_source_set_callback (source, write_shaped_response, response, NULL);
+    g_source_attach (source, response->context);
+}
+
+static gboolean
+write_shaped_response (gpointer user_data)
+{
+    ShapedResponse *response = user_data;
+
+    /* Client went away */
+    if (response->finished) {
+        shaped_response_free (response);
+        return G_SOURCE_REMOVE;
+    }
+
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    SoupMessageBody *response_body = soup_server_message_get_response_body (response->message);
+#else
+    SoupMessageBody *response_body = response->message->response_body;
+#endif
+
+    gsize content_length;
+    const guint8 *content = g_bytes_get_data (response->content, &content_length);
+    gsize length = content_length - response->offset;
+    if (response->bandwidth > 0)
+        length = MIN (length, MAX (response->bandwidth * SHAPED_RESPONSE_INTERVAL / 1000, 1));
+    if (length > 0)
+        soup_message_body_append (response_body, SOUP_MEMORY_COPY, content + response->offset, length);
+    response->offset += length;
+    gboolean complete = response->offset >= content_length;
+    if (complete)
+        soup_message_body_complete (response_body);
+    unpause_message (response->server, response->message);
+
+    if (complete)
+        shaped_response_free (response);
+    else
+        schedule_shaped_response (response, SHAPED_RESPONSE_INTERVAL);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Apply the configured latency, bandwidth and encoding to a response that has been generated */
+static void
+shape_response (MockSnapd *self, SoupServer *server, SoupServerMessage *message, MockEndpoint *endpoint)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    guint status_code = soup_server_message_get_status (message);
+    SoupMessageHeaders *response_headers = soup_server_message_get_response_headers (message);
+    SoupMessageBody *response_body = soup_server_message_get_response_body (message);
+#else
+    guint status_code = message->status_code;
+    SoupMessageHeaders *response_headers = message->response_headers;
+    SoupMessageBody *response_body = message->response_body;
+#endif
+
+    /* Some requests deliberately never get a response */
+    if (status_code == 0)
+        return;
+
+    if (endpoint->chunked)
+        soup_message_headers_set_encoding (response_headers, SOUP_ENCODING_CHUNKED);
+
+    if (endpoint->latency == 0 && endpoint->bandwidth == 0) {
+        soup_message_body_complete (response_body);
+        return;
+    }
+
+    /* Take the generated content back and feed it out from the main loop */
+    ShapedResponse *response = g_slice_new0 (ShapedResponse);
+    response->server = g_object_ref (server);
+    response->message = g_object_ref (message);
+    response->context = g_main_context_ref (self->context);
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    response->content = soup_message_body_flatten (response_body);
+#else
+    SoupBuffer *buffer = soup_message_body_flatten (response_body);
+    response->content = soup_buffer_get_as_bytes (buffer);
+    soup_buffer_free (buffer);
+#endif
+    soup_message_body_truncate (response_body);
+    response->bandwidth = endpoint->bandwidth;
+    response->finished_handler = g_signal_connect_swapped (message, "finished", G_CALLBACK (message_finished_cb), response);
+
+    pause_message (server, message);
+    schedule_shaped_response (response, endpoint->latency);
+}
+
+static void
+handle_media_file (MockSnapd *self, SoupServerMessage *message, const gchar *path)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    SoupMessageHeaders *request_headers = soup_server_message_get_request_headers (message);
+    SoupMessageHeaders *response_headers = soup_server_message_get_response_headers (message);
+#else
+    SoupMessageHeaders *request_headers = message->request_headers;
+    SoupMessageHeaders *response_headers = message->response_headers;
+#endif
+
+    const gchar *content = g_hash_table_lookup (self->media_files, path);
+    if (content == NULL) {
+        send_response (message, 404, "text/plain", (const guint8 *) "", 0);
+        return;
+    }
+
+    g_autofree gchar *checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, content, -1);
+    g_autofree gchar *etag = g_strdup_printf ("\"%s\"", checksum);
+    soup_message_headers_replace (response_headers, "ETag", etag);
+    if (g_strcmp0 (soup_message_headers_get_one (request_headers, "If-None-Match"), etag) == 0) {
+        send_response (message, 304, "image/png", (const guint8 *) "", 0);
+        return;
+    }
+
+    self->media_downloads++;
+    send_response (message, 200, "image/png", (const guint8 *) content, strlen (content));
+}
+
+/* Serve the next captured response to this request, repeating the last one once they run out */
+static gboolean
+send_captured_response (MockSnapd *self, SoupServer *server, SoupServerMessage *message, const gchar *path)
+{
+#if SOUP_CHECK_VERSION (2, 99, 2)
+    const gchar *method = soup_server_message_get_method (message);
+    const gchar *query = g_uri_get_query (soup_server_message_get_uri (message));
+#else
+    const gchar *method = message->method;
+    const gchar *query = soup_message_get_uri (message)->query;
+#endif
+
+    g_autofree gchar *key = g_strdup_printf ("%s %s%s%s", method, path, query != NULL ? "?" : "", query != NULL ? query : "");
+    GQueue *responses = g_hash_table_lookup (self->captured_responses, key);
+    if (responses == NULL)
+        return FALSE;
+    MockCapturedResponse *response = g_queue_get_length (responses) > 1 ? g_queue_pop_head (responses) : g_queue_peek_head (responses);
+
+    gsize body_length;
+    const guint8 *body = g_bytes_get_data (response->body, &body_length);
+    send_response (message, response->status_code, response->content_type != NULL ? response->content_type : "text/plain", body, body_length);
+    MockEndpoint endpoint = { NULL, response->latency, response->bandwidth, FALSE };
+    shape_response (self, server, message, &endpoint);
+    if (g_queue_peek_head (responses) != response)
+        mock_captured_response_free (response);
+
+    return TRUE;
+}
+
 static void
 handle_request (SoupServer        *server,
                 SoupServerMessage *message,
@@ -4880,6 +6050,24 @@ handle_request (SoupServer        *server,
         return;
     }
 
+    self->request_count++;
+
+    /* Start a response then reset the connection before it is complete */
+    if (self->close_mid_response) {
+#if SOUP_CHECK_VERSION (2, 99, 2)
+        g_autoptr(GIOStream) stream = soup_server_message_steal_connection (message);
+#else
+        g_autoptr(GIOStream) stream = soup_client_context_steal_connection (client);
+#endif
+        g_autoptr(GError) error = NULL;
+
+        const gchar *partial_response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n";
+        if (!g_output_stream_write_all (g_io_stream_get_output_stream (stream), partial_response, strlen (partial_response), NULL, NULL, &error) ||
+            !g_io_stream_close (stream, NULL, &error))
+            g_warning("Failed to reset stream: %s", error->message);
+        return;
+    }
+
 #if SOUP_CHECK_VERSION (2, 99, 2)
     SoupMessageHeaders *request_headers = soup_server_message_get_request_headers (message);
     g_clear_pointer (&self->last_request_headers, soup_message_headers_unref);
@@ -4890,7 +6078,12 @@ handle_request (SoupServer        *server,
     self->last_request_headers = g_boxed_copy (SOUP_TYPE_MESSAGE_HEADERS, request_headers);
 #endif
 
-    if (strcmp (path, "/v2/system-info") == 0)
+    if (self->captured_responses != NULL && send_captured_response (self, server, message, path))
+        return;
+
+    if (g_str_has_prefix (path, "/media/"))
+        handle_media_file (self, message, path);
+    else if (strcmp (path, "/v2/system-info") == 0)
         handle_system_info (self, message);
     else if (strcmp (path, "/v2/login") == 0)
         handle_login (self, message);
@@ -4914,6 +6107,14 @@ handle_request (SoupServer        *server,
         handle_assertions (self, message, NULL);
     else if (g_str_has_prefix (path, "/v2/assertions/"))
         handle_assertions (self, message, path + strlen ("/v2/assertions/"));
+    else if (strcmp (path, "/v2/logs") == 0)
+        handle_logs (self, message, query);
+    else if (strcmp (path, "/v2/snapshots") == 0)
+        handle_snapshots (self, message);
+    else if (g_str_has_prefix (path, "/v2/snapshots/") && g_str_has_suffix (path, "/export")) {
+        g_autofree gchar *id = g_strndup (path + strlen ("/v2/snapshots/"), strlen (path) - strlen ("/v2/snapshots/") - strlen ("/export"));
+        handle_snapshot_export (self, message, id);
+    }
     else if (strcmp (path, "/v2/interfaces") == 0)
         handle_interfaces (self, message, query);
     else if (strcmp (path, "/v2/connections") == 0)
@@ -4922,6 +6123,8 @@ handle_request (SoupServer        *server,
         handle_changes (self, message, query);
     else if (g_str_has_prefix (path, "/v2/changes/"))
         handle_change (self, message, path + strlen ("/v2/changes/"));
+    else if (strcmp (path, "/v2/notices") == 0)
+        handle_notices (self, message, query);
     else if (strcmp (path, "/v2/find") == 0)
         handle_find (self, message, query);
     else if (strcmp (path, "/v2/buy/ready") == 0)
@@ -4946,6 +6149,10 @@ handle_request (SoupServer        *server,
         handle_change (self, message, path + strlen ("/v2/accessories/changes/"));
     else
         send_error_not_found (self, message, "not found", NULL);
+
+    MockEndpoint *endpoint = find_endpoint (self, path);
+    if (endpoint != NULL)
+        shape_response (self, server, message, endpoint);
 }
 
 static gboolean
@@ -4973,10 +6180,14 @@ mock_snapd_finalize (GObject *object)
 
     g_clear_pointer (&self->dir_path, g_free);
     g_clear_pointer (&self->socket_path, g_free);
+    g_list_free_full (self->endpoints, (GDestroyNotify) mock_endpoint_free);
+    self->endpoints = NULL;
+    g_clear_pointer (&self->captured_responses, g_hash_table_unref);
     g_list_free_full (self->accounts, (GDestroyNotify) mock_account_free);
     self->accounts = NULL;
     g_list_free_full (self->interfaces, (GDestroyNotify) mock_interface_free);
     self->interfaces = NULL;
+    g_clear_pointer (&self->snaps_by_name, g_hash_table_unref);
     g_list_free_full (self->snaps, (GDestroyNotify) mock_snap_free);
     self->snaps = NULL;
     g_list_free_full (self->snapshots, (GDestroyNotify) mock_snapshot_free);
@@ -4984,6 +6195,7 @@ mock_snapd_finalize (GObject *object)
     g_free (self->build_id);
     g_free (self->confinement);
     g_clear_pointer (&self->sandbox_features, g_hash_table_unref);
+    g_clear_pointer (&self->media_files, g_hash_table_unref);
     g_free (self->store);
     g_free (self->maintenance_kind);
     g_free (self->maintenance_message);
@@ -4994,6 +6206,7 @@ mock_snapd_finalize (GObject *object)
     g_free (self->refresh_timer);
     g_list_free_full (self->store_sections, g_free);
     self->store_sections = NULL;
+    g_clear_pointer (&self->store_snaps_by_name, g_hash_table_unref);
     g_list_free_full (self->store_snaps, (GDestroyNotify) mock_snap_free);
     self->store_snaps = NULL;
     g_list_free_full (self->established_connections, (GDestroyNotify) mock_connection_free);
@@ -5002,8 +6215,13 @@ mock_snapd_finalize (GObject *object)
     self->undesired_connections = NULL;
     g_list_free_full (self->assertions, g_free);
     self->assertions = NULL;
+    g_list_free_full (self->logs, (GDestroyNotify) json_node_unref);
+    self->logs = NULL;
+    g_clear_pointer (&self->snapshot_archives, g_hash_table_unref);
     g_list_free_full (self->changes, (GDestroyNotify) mock_change_free);
     self->changes = NULL;
+    g_list_free_full (self->notices, (GDestroyNotify) mock_notice_free);
+    self->notices = NULL;
     g_clear_pointer (&self->suggested_currency, g_free);
     g_clear_pointer (&self->spawn_time, g_free);
     g_clear_pointer (&self->ready_time, g_free);
@@ -5050,6 +6268,40 @@ open_listening_socket (SoupServer *server, const gchar *socket_path, GError **er
     return g_steal_pointer (&socket);
 }
 
+static GSocket *
+open_listening_tcp_socket (SoupServer *server, guint16 *port, GError **error)
+{
+    g_autoptr(GSocket) socket = NULL;
+    g_autoptr(GInetAddress) inet_address = NULL;
+    g_autoptr(GSocketAddress) address = NULL;
+    g_autoptr(GSocketAddress) local_address = NULL;
+
+    socket = g_socket_new (G_SOCKET_FAMILY_IPV4,
+                           G_SOCKET_TYPE_STREAM,
+                           G_SOCKET_PROTOCOL_DEFAULT,
+                           error);
+    if (socket == NULL)
+        return NULL;
+
+    inet_address = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+    address = g_inet_socket_address_new (inet_address, 0);
+    if (!g_socket_bind (socket, address, TRUE, error))
+        return NULL;
+
+    if (!g_socket_listen (socket, error))
+        return NULL;
+
+    local_address = g_socket_get_local_address (socket, error);
+    if (local_address == NULL)
+        return NULL;
+    *port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (local_address));
+
+    if (!soup_server_listen_socket (server, socket, 0, error))
+        return NULL;
+
+    return g_steal_pointer (&socket);
+}
+
 gpointer
 mock_snapd_init_thread (gpointer user_data)
 {
@@ -5067,6 +6319,12 @@ mock_snapd_init_thread (gpointer user_data)
 
     g_autoptr(GError) error = NULL;
     g_autoptr(GSocket) socket = open_listening_socket (server, self->socket_path, &error);
+    g_autoptr(GSocket) tcp_socket = NULL;
+    if (socket != NULL && self->listen_tcp) {
+        tcp_socket = open_listening_tcp_socket (server, &self->tcp_port, &error);
+        if (tcp_socket == NULL)
+            g_clear_object (&socket);
+    }
 
     g_cond_signal (&self->condition);
     if (socket == NULL)
@@ -5150,10 +6408,14 @@ mock_snapd_init (MockSnapd *self)
     g_mutex_init (&self->mutex);
     g_cond_init (&self->condition);
 
+    self->snaps_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+    self->store_snaps_by_name = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
     self->sandbox_features = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+    self->media_files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
     self->gtk_theme_status = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
     self->icon_theme_status = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
     self->sound_theme_status = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    self->snapshot_archives = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, (GDestroyNotify) g_bytes_unref);
     g_autoptr(GError) error = NULL;
     self->dir_path = g_dir_make_tmp ("mock-snapd-XXXXXX", &error);
     if (self->dir_path == NULL)
@@ -33,6 +33,7 @@ typedef struct _MockChannel MockChannel;
 typedef struct _MockConnection MockConnection;
 typedef struct _MockInterface MockInterface;
 typedef struct _MockMedia MockMedia;
+typedef struct _MockNotice MockNotice;
 typedef struct _MockPlug MockPlug;
 typedef struct _MockPrice MockPrice;
 typedef struct _MockSlot MockSlot;
@@ -45,9 +46,45 @@ MockSnapd      *mock_snapd_new                    (void);
 
 const gchar    *mock_snapd_get_socket_path        (MockSnapd     *snapd);
 
+void            mock_snapd_set_listen_tcp         (MockSnapd     *snapd,
+                                                   gboolean       listen_tcp);
+
+guint16         mock_snapd_get_tcp_port           (MockSnapd     *snapd);
+
+void            mock_snapd_add_media_file         (MockSnapd     *snapd,
+                                                   const gchar   *path,
+                                                   const gchar   *content);
+
+guint           mock_snapd_get_media_downloads    (MockSnapd     *snapd);
+
 void            mock_snapd_set_close_on_request   (MockSnapd     *snapd,
                                                    gboolean       close_on_request);
 
+void            mock_snapd_set_close_mid_response (MockSnapd     *snapd,
+                                                   gboolean       close_mid_response);
+
+gboolean        mock_snapd_load_capture           (MockSnapd     *snapd,
+                                                   const gchar   *path,
+                                                   GError       **error);
+
+void            mock_snapd_set_endpoint_latency   (MockSnapd     *snapd,
+                                                   const gchar   *path,
+                                                   guint          latency);
+
+void            mock_snapd_set_endpoint_bandwidth (MockSnapd     *snapd,
+                                                   const gchar   *path,
+                                                   gsize          bandwidth);
+
+void            mock_snapd_set_endpoint_chunked   (MockSnapd     *snapd,
+                                                   const gchar   *path,
+                                                   gboolean       chunked);
+
+void            mock_snapd_set_progress_listed_changes (MockSnapd     *snapd,
+                                                        gboolean       progress_listed_changes);
+
+void            mock_snapd_set_supports_notices        (MockSnapd     *snapd,
+                                                        gboolean       supports_notices);
+
 void            mock_snapd_set_decline_auth       (MockSnapd     *snapd,
                                                    gboolean       decline_auth);
 
@@ -106,6 +143,9 @@ void            mock_snapd_set_spawn_time         (MockSnapd     *snapd,
 void            mock_snapd_set_ready_time         (MockSnapd     *snapd,
                                                    const gchar   *ready_time);
 
+void            mock_snapd_set_progress_total     (MockSnapd     *snapd,
+                                                   int            progress_total);
+
 MockAccount    *mock_snapd_add_account            (MockSnapd     *snapd,
                                                    const gchar   *email,
                                                    const gchar   *username,
@@ -144,9 +184,24 @@ MockAccount    *mock_snapd_find_account_by_email  (MockSnapd     *snapd,
 
 MockChange     *mock_snapd_add_change             (MockSnapd     *snapd);
 
+MockChange     *mock_snapd_add_generated_change   (MockSnapd     *snapd,
+                                                   guint          n_tasks);
+
 MockTask       *mock_change_add_task              (MockChange    *change,
                                                    const gchar   *kind);
 
+MockNotice     *mock_snapd_add_notice             (MockSnapd     *snapd,
+                                                   const gchar   *type,
+                                                   const gchar   *key,
+                                                   const gchar   *last_repeated);
+
+void            mock_notice_set_occurrences       (MockNotice    *notice,
+                                                   int            occurrences);
+
+void            mock_notice_add_last_data         (MockNotice    *notice,
+                                                   const gchar   *name,
+                                                   const gchar   *value);
+
 void            mock_task_set_snap_name           (MockTask      *task,
                                                    const gchar   *snap_name);
 
@@ -187,6 +242,9 @@ MockSnap       *mock_snapd_add_snap               (MockSnapd     *snapd,
 MockSnap       *mock_snapd_find_snap              (MockSnapd     *snapd,
                                                    const gchar   *name);
 
+void            mock_snapd_remove_snap            (MockSnapd     *snapd,
+                                                   const gchar   *name);
+
 MockSnapshot   *mock_snapd_find_snapshot          (MockSnapd     *snapd,
                                                    const gchar   *name);
 
@@ -196,6 +254,13 @@ void            mock_snapd_add_store_section      (MockSnapd     *snapd,
 MockSnap       *mock_snapd_add_store_snap         (MockSnapd     *snapd,
                                                    const gchar   *name);
 
+void            mock_snapd_add_generated_snaps    (MockSnapd     *snapd,
+                                                   guint          n_snaps,
+                                                   guint          n_channels,
+                                                   guint          n_apps,
+                                                   guint          n_media,
+                                                   guint          n_plugs);
+
 MockApp        *mock_snap_add_app                 (MockSnap      *snap,
                                                    const gchar   *name);
 
@@ -370,6 +435,9 @@ MockMedia      *mock_snap_add_media               (MockSnap      *snap,
                                                    int            width,
                                                    int            height);
 
+void            mock_media_set_url                (MockMedia     *media,
+                                                   const gchar   *url);
+
 void            mock_snap_set_status              (MockSnap      *snap,
                                                    const gchar   *status);
 
@@ -441,12 +509,29 @@ void            mock_snapd_add_assertion          (MockSnapd     *snapd,
 
 GList          *mock_snapd_get_assertions         (MockSnapd     *snapd);
 
+void            mock_snapd_add_log                (MockSnapd     *snapd,
+                                                   const gchar   *timestamp,
+                                                   const gchar   *sid,
+                                                   const gchar   *pid,
+                                                   const gchar   *message);
+
+void            mock_snapd_add_snapshot_archive   (MockSnapd     *snapd,
+                                                   gint64         set_id,
+                                                   GBytes        *data);
+
+GBytes         *mock_snapd_get_snapshot_archive   (MockSnapd     *snapd,
+                                                   gint64         set_id);
+
+guint           mock_snapd_get_request_count      (MockSnapd     *snapd);
+
 const gchar    *mock_snapd_get_last_user_agent    (MockSnapd     *snapd);
 
 const gchar    *mock_snapd_get_last_accept_language (MockSnapd     *snapd);
 
 const gchar    *mock_snapd_get_last_allow_interaction (MockSnapd *snapd);
 
+const gchar    *mock_snapd_get_last_authorization (MockSnapd     *snapd);
+
 void            mock_snapd_set_gtk_theme_status   (MockSnapd     *snapd,
                                                    const gchar   *name,
                                                    const gchar   *status);
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <snapd-cpp/snapd-cpp.h>
+
+#include "mock-snapd.h"
+
+static void
+test_get_system_information_sync ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_managed (snapd, TRUE);
+    mock_snapd_set_on_classic (snapd, TRUE);
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Result<snapd::SystemInformation> result = client.get_system_information ();
+    g_assert_true (result.ok ());
+    const snapd::SystemInformation &info = result.value ();
+    g_assert_true (info.build_id () == "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    g_assert_true (info.kernel_version () == "KERNEL-VERSION");
+    g_assert_true (info.series () == "SERIES");
+    g_assert_true (info.version () == "VERSION");
+    g_assert_true (info.managed ());
+    g_assert_true (info.on_classic ());
+}
+
+static void
+test_get_snaps_sync ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Result<std::vector<snapd::Snap>> result = client.get_snaps ();
+    g_assert_true (result.ok ());
+    const std::vector<snapd::Snap> &snaps = result.value ();
+    g_assert_cmpint (snaps.size (), ==, 3);
+    g_assert_true (snaps[0].name () == "snap1");
+    g_assert_true (snaps[1].name () == "snap2");
+    g_assert_true (snaps[2].name () == "snap3");
+    std::vector<snapd::App> apps = snaps[0].apps ();
+    g_assert_cmpint (apps.size (), ==, 1);
+    g_assert_true (apps[0].name () == "app1");
+}
+
+static void
+test_get_snaps_filter ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Result<std::vector<snapd::Snap>> result = client.get_snaps (SNAPD_GET_SNAPS_FLAGS_NONE, { "snap1", "snap3" });
+    g_assert_true (result.ok ());
+    const std::vector<snapd::Snap> &snaps = result.value ();
+    g_assert_cmpint (snaps.size (), ==, 2);
+    g_assert_true (snaps[0].name () == "snap1");
+    g_assert_true (snaps[1].name () == "snap3");
+}
+
+static void
+test_get_snaps_async ()
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Request request = client.get_snaps_async ([loop] (snapd::Result<std::vector<snapd::Snap>> result) {
+        g_assert_true (result.ok ());
+        g_assert_cmpint (result.value ().size (), ==, 3);
+        g_assert_true (result.value ()[0].name () == "snap1");
+        g_main_loop_quit (loop);
+    });
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snaps_future ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    std::future<snapd::Result<std::vector<snapd::Snap>>> future = client.get_snaps_future ();
+    while (future.wait_for (std::chrono::seconds (0)) != std::future_status::ready)
+        g_main_context_iteration (NULL, TRUE);
+    snapd::Result<std::vector<snapd::Snap>> result = future.get ();
+    g_assert_true (result.ok ());
+    g_assert_cmpint (result.value ().size (), ==, 2);
+    g_assert_true (result.value ()[1].name () == "snap2");
+}
+
+static void
+test_get_snaps_cancel ()
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    {
+        // Dropping the request cancels it
+        snapd::Request request = client.get_snaps_async ([loop] (snapd::Result<std::vector<snapd::Snap>> result) {
+            g_assert_false (result.ok ());
+            g_assert_true (result.error ().matches (G_IO_ERROR, G_IO_ERROR_CANCELLED));
+            g_main_loop_quit (loop);
+        });
+    }
+    g_main_loop_run (loop);
+}
+
+static void
+test_icon_sync ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Result<snapd::Icon> result = client.get_icon ("snap");
+    g_assert_true (result.ok ());
+    g_assert_true (result.value ().mime_type () == "image/png");
+    g_assert_true (result.value ().data () == "ICON-DATA");
+}
+
+static void
+test_icon_not_installed ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    snapd::Client client;
+    client.set_socket_path (mock_snapd_get_socket_path (snapd));
+
+    snapd::Result<snapd::Icon> result = client.get_icon ("snap");
+    g_assert_false (result.ok ());
+    g_assert_true (result.error ().matches (SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND));
+}
+
+int
+main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/get-system-information/sync", test_get_system_information_sync);
+    g_test_add_func ("/get-snaps/sync", test_get_snaps_sync);
+    g_test_add_func ("/get-snaps/filter", test_get_snaps_filter);
+    g_test_add_func ("/get-snaps/async", test_get_snaps_async);
+    g_test_add_func ("/get-snaps/future", test_get_snaps_future);
+    g_test_add_func ("/get-snaps/cancel", test_get_snaps_cancel);
+    g_test_add_func ("/icon/sync", test_icon_sync);
+    g_test_add_func ("/icon/not-installed", test_icon_not_installed);
+
+    return g_test_run ();
+}
@@ -7,7 +7,11 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <fcntl.h>
 #include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include <gio/gunixsocketaddress.h>
 #include <snapd-glib/snapd-glib.h>
 
 #include "mock-snapd.h"
@@ -130,61 +134,113 @@ test_socket_closed_reconnect_after_failure (void)
     g_clear_object (&info);
 }
 
-static void
-test_client_set_socket_path (void)
+static guint64
+get_statistic (SnapdClient *client, const gchar *name)
 {
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    g_autofree gchar *default_path = g_strdup (snapd_client_get_socket_path (client));
-
-    snapd_client_set_socket_path (client, "first.sock");
-    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, "first.sock");
-
-    snapd_client_set_socket_path (client, "second.sock");
-    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, "second.sock");
-
-    snapd_client_set_socket_path (client, NULL);
-    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, default_path);
+    g_autoptr(GVariant) statistics = snapd_client_get_statistics (client);
+    guint64 value = 0;
+    g_assert_true (g_variant_lookup (statistics, name, "t", &value));
+    return value;
 }
 
 static void
-test_user_agent_default (void)
+test_socket_tcp (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_listen_tcp (snapd, TRUE);
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(GInetAddress) inet_address = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+    g_autoptr(GSocketAddress) address = g_inet_socket_address_new (inet_address, mock_snapd_get_tcp_port (snapd));
+    g_assert_null (snapd_client_get_address (client));
+    snapd_client_set_address (client, address);
+    g_assert_true (snapd_client_get_address (client) == address);
 
-    g_assert_cmpstr (snapd_client_get_user_agent (client), ==, "snapd-glib/" VERSION);
+    for (int i = 0; i < 3; i++) {
+        g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (info);
+        g_assert_cmpstr (snapd_system_information_get_build_id (info), ==, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    }
+    g_assert_cmpint (get_statistic (client, "reconnects"), ==, 0);
 
+    /* Macaroons aren't sent in plain text over TCP */
+    g_autoptr(SnapdAuthData) auth_data = snapd_auth_data_new ("macaroon", NULL);
+    g_test_expect_message ("Snapd", G_LOG_LEVEL_WARNING, "Authorization data will not be sent*");
+    snapd_client_set_auth_data (client, auth_data);
+    g_test_assert_expected_messages ();
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "snapd-glib/" VERSION);
+    g_assert_null (mock_snapd_get_last_authorization (snapd));
+
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_null (snapd_client_get_address (client));
+
+    /* But are over the Unix socket */
+    g_autoptr(SnapdClient) unix_client = snapd_client_new ();
+    snapd_client_set_socket_path (unix_client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_auth_data (unix_client, auth_data);
+    g_autoptr(SnapdSystemInformation) unix_info = snapd_client_get_system_information_sync (unix_client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (unix_info);
+    g_assert_cmpstr (mock_snapd_get_last_authorization (snapd), ==, "Macaroon root=\"macaroon\"");
 }
 
 static void
-test_user_agent_custom (void)
+test_socket_connect_timeout (void)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    g_autofree gchar *dir = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_autofree gchar *path = g_build_filename (dir, "snapd.socket", NULL);
+
+    /* A socket like one snapd is being activated on, that doesn't accept connections yet */
+    g_autoptr(GSocketAddress) address = g_unix_socket_address_new (path);
+    g_autoptr(GSocket) listener = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+    g_assert_no_error (error);
+    g_assert_true (g_socket_bind (listener, address, TRUE, &error));
+    g_socket_set_listen_backlog (listener, 0);
+    g_assert_true (g_socket_listen (listener, &error));
+
+    /* Fill its listen queue */
+    g_autoptr(GPtrArray) queued = g_ptr_array_new_with_free_func (g_object_unref);
+    while (TRUE) {
+        g_autoptr(GSocket) socket = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+        g_assert_no_error (error);
+        g_socket_set_blocking (socket, FALSE);
+        if (!g_socket_connect (socket, address, NULL, &error)) {
+            g_assert_error (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK);
+            g_clear_error (&error);
+            break;
+        }
+        g_ptr_array_add (queued, g_steal_pointer (&socket));
+    }
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_socket_path (client, path);
+    g_assert_cmpint (snapd_client_get_connect_timeout (client), ==, 30000);
+    snapd_client_set_connect_timeout (client, 100);
+    g_assert_cmpint (snapd_client_get_connect_timeout (client), ==, 100);
 
-    snapd_client_set_user_agent (client, "Foo/1.0");
+    /* The connection keeps being attempted until the timeout */
+    gint64 start_time = g_get_monotonic_time ();
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Foo/1.0");
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED);
+    g_assert_null (info);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 100000);
+
+    g_socket_close (listener, NULL);
+    g_assert_cmpint (g_unlink (path), ==, 0);
+    g_assert_cmpint (g_rmdir (dir), ==, 0);
 }
 
 static void
-test_user_agent_null (void)
+test_socket_prepare (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -194,21 +250,18 @@ test_user_agent_null (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_set_user_agent (client, NULL);
+    g_assert_true (snapd_client_prepare_sync (client, NULL, &error));
+    g_assert_no_error (error);
+
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, NULL);
+    g_assert_cmpint (get_statistic (client, "reconnects"), ==, 0);
 }
 
 static void
-test_accept_language (void)
+test_socket_prepare_failure (void)
 {
-    g_setenv ("LANG", "en_US.UTF-8", TRUE);
-    g_setenv ("LANGUAGE", "en_US:fr", TRUE);
-    g_setenv ("LC_ALL", "", TRUE);
-    g_setenv ("LC_MESSAGES", "", TRUE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
@@ -217,66 +270,108 @@ test_accept_language (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "en-us, en;q=0.9, fr;q=0.8");
+    mock_snapd_stop (snapd);
+
+    g_assert_false (snapd_client_prepare_sync (client, NULL, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED);
 }
 
-static void
-test_accept_language_empty (void)
+typedef struct
 {
-    g_setenv ("LANG", "", TRUE);
-    g_setenv ("LANGUAGE", "", TRUE);
-    g_setenv ("LC_ALL", "", TRUE);
-    g_setenv ("LC_MESSAGES", "", TRUE);
+    GMainLoop *loop;
+    int n_ticks;
+    gboolean prepared;
+} PrepareStalledData;
 
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+static gboolean
+prepare_stalled_tick_cb (gpointer user_data)
+{
+    PrepareStalledData *data = user_data;
+    data->n_ticks++;
+    return G_SOURCE_CONTINUE;
+}
 
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+static void
+prepare_stalled_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    PrepareStalledData *data = user_data;
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(GError) error = NULL;
+    g_assert_false (snapd_client_prepare_finish (SNAPD_CLIENT (object), result, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED);
 
-    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "en");
+    data->prepared = TRUE;
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_allow_interaction (void)
+test_socket_prepare_stalled (void)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    g_autofree gchar *dir = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_autofree gchar *path = g_build_filename (dir, "snapd.socket", NULL);
+
+    /* A socket that doesn't accept connections, with its listen queue full */
+    g_autoptr(GSocketAddress) address = g_unix_socket_address_new (path);
+    g_autoptr(GSocket) listener = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+    g_assert_no_error (error);
+    g_assert_true (g_socket_bind (listener, address, TRUE, &error));
+    g_socket_set_listen_backlog (listener, 0);
+    g_assert_true (g_socket_listen (listener, &error));
+    g_autoptr(GPtrArray) queued = g_ptr_array_new_with_free_func (g_object_unref);
+    while (TRUE) {
+        g_autoptr(GSocket) socket = g_socket_new (G_SOCKET_FAMILY_UNIX, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, &error);
+        g_assert_no_error (error);
+        g_socket_set_blocking (socket, FALSE);
+        if (!g_socket_connect (socket, address, NULL, &error)) {
+            g_assert_error (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK);
+            g_clear_error (&error);
+            break;
+        }
+        g_ptr_array_add (queued, g_steal_pointer (&socket));
+    }
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_socket_path (client, path);
+    snapd_client_set_connect_timeout (client, 200);
 
-    /* By default, interaction is allowed */
-    g_assert_true (snapd_client_get_allow_interaction (client));
+    /* Preparing returns at once, and the main loop keeps running while the connection is attempted */
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    PrepareStalledData data = { loop, 0, FALSE };
+    guint tick_id = g_timeout_add (10, prepare_stalled_tick_cb, &data);
+    gint64 start_time = g_get_monotonic_time ();
+    snapd_client_prepare_async (client, NULL, prepare_stalled_cb, &data);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, <, 100000);
+    g_assert_false (data.prepared);
+    g_main_loop_run (loop);
+    g_source_remove (tick_id);
+    g_assert_true (data.prepared);
+    g_assert_cmpint (data.n_ticks, >, 5);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 200000);
 
-    /* ... which sends the X-Allow-Interaction header with requests */
-    g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info1);
-    g_assert_cmpstr (mock_snapd_get_last_allow_interaction (snapd), ==, "true");
+    g_socket_close (listener, NULL);
+    g_assert_cmpint (g_unlink (path), ==, 0);
+    g_assert_cmpint (g_rmdir (dir), ==, 0);
+}
 
-    /* If interaction is not allowed, the header is not sent */
-    snapd_client_set_allow_interaction (client, FALSE);
-    g_assert_false (snapd_client_get_allow_interaction (client));
-    g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client, NULL, &error);
+static void
+prepare_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_client_prepare_finish (SNAPD_CLIENT (object), result, &error));
     g_assert_no_error (error);
-    g_assert_nonnull (info2);
-    g_assert_cmpstr (mock_snapd_get_last_allow_interaction (snapd), ==, NULL);
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_maintenance_none (void)
+test_socket_prepare_idle_close (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
@@ -285,138 +380,120 @@ test_maintenance_none (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    snapd_client_prepare_async (client, NULL, prepare_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+
+    /* The unused connection is dropped when snapd closes it */
+    mock_snapd_stop (snapd);
+    while (get_statistic (client, "idle-closes") == 0)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    /* So the next request uses a new connection rather than failing to write to the old one */
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-
-    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
-    g_assert_null (maintenance);
+    g_assert_cmpint (get_statistic (client, "reconnects"), ==, 0);
 }
 
 static void
-test_maintenance_daemon_restart (void)
+test_retry_closed (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_maintenance (snapd, "daemon-restart", "daemon is restarting");
+    mock_snapd_set_close_on_request (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_max_retries (client), ==, 0);
+    g_assert_cmpint (snapd_client_get_retry_interval (client), ==, 100);
+    g_assert_cmpint (snapd_client_get_max_retry_interval (client), ==, 5000);
+    snapd_client_set_max_retries (client, 2);
+    snapd_client_set_retry_interval (client, 1);
+    snapd_client_set_max_retry_interval (client, 2);
 
+    /* Gives up once the retries have been used */
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-
-    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
-    g_assert_nonnull (maintenance);
-    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_DAEMON_RESTART);
-    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "daemon is restarting");
+    g_assert_null (info);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED);
+    g_assert_cmpint (get_statistic (client, "retries"), ==, 2);
 }
 
 static void
-test_maintenance_system_restart (void)
+test_retry_mid_response (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_maintenance (snapd, "system-restart", "system is restarting");
+    mock_snapd_set_close_mid_response (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_retries (client, 2);
+    snapd_client_set_retry_interval (client, 1);
+    snapd_client_set_max_retry_interval (client, 2);
 
+    /* Not sent again once snapd has started responding */
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-
-    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
-    g_assert_nonnull (maintenance);
-    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_SYSTEM_RESTART);
-    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "system is restarting");
+    g_assert_null (info);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_READ_FAILED);
+    g_assert_cmpint (get_statistic (client, "retries"), ==, 0);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
 }
 
-static void
-test_maintenance_unknown (void)
+static gboolean
+retry_restart_cb (gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_maintenance (snapd, "no-such-kind", "MESSAGE");
+    MockSnapd *snapd = user_data;
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    return G_SOURCE_REMOVE;
+}
 
-    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+static void
+retry_restart_system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
+    g_assert_cmpint (get_statistic (SNAPD_CLIENT (object), "retries"), >, 0);
 
-    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
-    g_assert_nonnull (maintenance);
-    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_UNKNOWN);
-    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "MESSAGE");
-}
-
-static gboolean
-date_matches (GDateTime *date, int year, int month, int day, int hour, int minute, int second)
-{
-    g_autoptr(GDateTime) d = g_date_time_new_utc (year, month, day, hour, minute, second);
-    if (date == NULL)
-        return FALSE;
-    return g_date_time_compare (date, d) == 0;
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_system_information_sync (void)
+test_retry_restart (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_managed (snapd, TRUE);
-    mock_snapd_set_on_classic (snapd, TRUE);
-    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
-    mock_snapd_add_sandbox_feature (snapd, "backend", "feature1");
-    mock_snapd_add_sandbox_feature (snapd, "backend", "feature2");
-    mock_snapd_set_refresh_timer (snapd, "00:00~24:00/4");
-    mock_snapd_set_refresh_next (snapd, "2018-01-19T13:14:15Z");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_retries (client, 20);
+    snapd_client_set_retry_interval (client, 5);
+    snapd_client_set_max_retry_interval (client, 20);
 
-    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (snapd_system_information_get_build_id (info), ==, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
-    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
-    g_assert_cmpstr (snapd_system_information_get_kernel_version (info), ==, "KERNEL-VERSION");
-    g_assert_cmpstr (snapd_system_information_get_os_id (info), ==, "OS-ID");
-    g_assert_cmpstr (snapd_system_information_get_os_version (info), ==, "OS-VERSION");
-    g_assert_cmpstr (snapd_system_information_get_series (info), ==, "SERIES");
-    g_assert_cmpstr (snapd_system_information_get_version (info), ==, "VERSION");
-    g_assert_true (snapd_system_information_get_managed (info));
-    g_assert_true (snapd_system_information_get_on_classic (info));
-    g_assert_cmpstr (snapd_system_information_get_mount_directory (info), ==, "/snap");
-    g_assert_cmpstr (snapd_system_information_get_binaries_directory (info), ==, "/snap/bin");
-    g_assert_null (snapd_system_information_get_refresh_schedule (info));
-    g_assert_cmpstr (snapd_system_information_get_refresh_timer (info), ==, "00:00~24:00/4");
-    g_assert_null (snapd_system_information_get_refresh_hold (info));
-    g_assert_null (snapd_system_information_get_refresh_last (info));
-    g_assert_true (date_matches (snapd_system_information_get_refresh_next (info), 2018, 1, 19, 13, 14, 15));
-    g_assert_null (snapd_system_information_get_store (info));
-    GHashTable *sandbox_features = snapd_system_information_get_sandbox_features (info);
-    g_assert_nonnull (sandbox_features);
-    GStrv backend_features = g_hash_table_lookup (sandbox_features, "backend");
-    g_assert_nonnull (backend_features);
-    g_assert_cmpint (g_strv_length (backend_features), ==, 2);
-    g_assert_cmpstr (backend_features[0], ==, "feature1");
-    g_assert_cmpstr (backend_features[1], ==, "feature2");
+    /* Requests made while snapd is down complete once it is back */
+    mock_snapd_stop (snapd);
+    g_timeout_add (50, retry_restart_cb, snapd);
+    snapd_client_get_system_information_async (client, NULL, retry_restart_system_information_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
 }
 
 static void
-system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+retry_watch_socket_system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
@@ -424,107 +501,178 @@ system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
-    g_assert_cmpstr (snapd_system_information_get_kernel_version (info), ==, "KERNEL-VERSION");
-    g_assert_cmpstr (snapd_system_information_get_os_id (info), ==, "OS-ID");
-    g_assert_cmpstr (snapd_system_information_get_os_version (info), ==, "OS-VERSION");
-    g_assert_cmpstr (snapd_system_information_get_series (info), ==, "SERIES");
-    g_assert_cmpstr (snapd_system_information_get_version (info), ==, "VERSION");
-    g_assert_true (snapd_system_information_get_managed (info));
-    g_assert_true (snapd_system_information_get_on_classic (info));
-    g_assert_cmpstr (snapd_system_information_get_mount_directory (info), ==, "/snap");
-    g_assert_cmpstr (snapd_system_information_get_binaries_directory (info), ==, "/snap/bin");
-    g_assert_null (snapd_system_information_get_store (info));
+    g_assert_cmpint (get_statistic (SNAPD_CLIENT (object), "retries"), ==, 1);
+    g_assert_cmpint (get_statistic (SNAPD_CLIENT (object), "parked"), ==, 1);
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_system_information_async (void)
+test_retry_watch_socket (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_managed (snapd, TRUE);
-    mock_snapd_set_on_classic (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_watch_socket (client));
+    snapd_client_set_watch_socket (client, TRUE);
+    g_assert_true (snapd_client_get_watch_socket (client));
+    snapd_client_set_max_retries (client, 1);
+    snapd_client_set_retry_interval (client, 60000);
+    snapd_client_set_max_retry_interval (client, 60000);
 
-    snapd_client_get_system_information_async (client, NULL, system_information_cb, async_data_new (loop, snapd));
+    /* The retry waits for the socket rather than the retry interval */
+    mock_snapd_stop (snapd);
+    g_timeout_add (50, retry_restart_cb, snapd);
+    gint64 start_time = g_get_monotonic_time ();
+    snapd_client_get_system_information_async (client, NULL, retry_watch_socket_system_information_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, <, 30000000);
 }
 
 static void
-test_get_system_information_store (void)
+test_request_timeout (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_store (snapd, "store");
+    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/system-info", 5000);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_request_timeout (client), ==, 0);
+    snapd_client_set_request_timeout (client, 50);
+    g_assert_cmpint (snapd_client_get_request_timeout (client), ==, 50);
 
+    gint64 start_time = g_get_monotonic_time ();
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert_null (info);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, <, 5000000);
+    g_clear_error (&error);
+
+    /* The connection waiting for the response was dropped, so later requests aren't stuck behind it */
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (snapd_system_information_get_store (info), ==, "store");
+    g_assert_nonnull (snap);
 }
 
 static void
-test_get_system_information_refresh (void)
+test_request_deadline (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_refresh_timer (snapd, "00:00~24:00/4");
-    mock_snapd_set_refresh_hold (snapd, "2018-01-20T01:02:03Z");
-    mock_snapd_set_refresh_last (snapd, "2018-01-19T01:02:03Z");
-    mock_snapd_set_refresh_next (snapd, "2018-01-19T13:14:15Z");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/system-info", 5000);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_request_deadline (client), ==, 0);
+    gint64 deadline = g_get_monotonic_time () + 50000;
+    snapd_client_set_request_deadline (client, deadline);
+    g_assert_cmpint (snapd_client_get_request_deadline (client), ==, deadline);
 
+    /* The earlier of the timeout and the deadline applies */
+    snapd_client_set_request_timeout (client, 60000);
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+    g_assert_null (info);
+    g_assert_cmpint (g_get_monotonic_time (), <, deadline + 5000000);
+}
+
+typedef struct
+{
+    GMainLoop *loop;
+    int n_slow;
+} SlowRequestData;
+
+static void
+slow_request_cb (SnapdClient *client, SnapdPendingRequest *request, gpointer user_data)
+{
+    SlowRequestData *data = user_data;
+
+    data->n_slow++;
+    g_assert_cmpstr (snapd_pending_request_get_method (request), ==, "GET");
+    g_assert_cmpstr (snapd_pending_request_get_path (request), ==, "/v2/system-info");
+    g_assert_cmpint (snapd_pending_request_get_state (request), ==, SNAPD_PENDING_REQUEST_STATE_WAITING);
+    g_assert_null (snapd_pending_request_get_change_id (request));
+    g_assert_cmpint (snapd_pending_request_get_age (request), >=, 50000);
+    g_assert_cmpint (snapd_pending_request_get_bytes_sent (request), >, 0);
+    g_assert_cmpint (snapd_pending_request_get_bytes_received (request), ==, 0);
+
+    g_autoptr(GPtrArray) pending_requests = snapd_client_get_pending_requests (client);
+    g_assert_cmpint (pending_requests->len, ==, 1);
+    g_assert_cmpstr (snapd_pending_request_get_path (pending_requests->pdata[0]), ==, "/v2/system-info");
+}
+
+static void
+slow_system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    SlowRequestData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_null (snapd_system_information_get_refresh_schedule (info));
-    g_assert_cmpstr (snapd_system_information_get_refresh_timer (info), ==, "00:00~24:00/4");
-    g_assert_true (date_matches (snapd_system_information_get_refresh_hold (info), 2018, 1, 20, 1, 2, 3));
-    g_assert_true (date_matches (snapd_system_information_get_refresh_last (info), 2018, 1, 19, 1, 2, 3));
-    g_assert_true (date_matches (snapd_system_information_get_refresh_next (info), 2018, 1, 19, 13, 14, 15));
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_system_information_refresh_schedule (void)
+test_slow_request (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_refresh_schedule (snapd, "00:00-04:59/5:00-10:59/11:00-16:59/17:00-23:59");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/system-info", 300);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_slow_request_threshold (client), ==, 0);
+    snapd_client_set_slow_request_threshold (client, 50);
+    g_assert_cmpint (snapd_client_get_slow_request_threshold (client), ==, 50);
 
-    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (snapd_system_information_get_refresh_schedule (info), ==, "00:00-04:59/5:00-10:59/11:00-16:59/17:00-23:59");
-    g_assert_null (snapd_system_information_get_refresh_timer (info));
+    SlowRequestData data = { loop, 0 };
+    g_signal_connect (client, "slow-request", G_CALLBACK (slow_request_cb), &data);
+    snapd_client_get_system_information_async (client, NULL, slow_system_information_cb, &data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data.n_slow, ==, 1);
+
+    g_autoptr(GPtrArray) pending_requests = snapd_client_get_pending_requests (client);
+    g_assert_cmpint (pending_requests->len, ==, 0);
 }
 
 static void
-test_get_system_information_confinement_strict (void)
+test_client_set_socket_path (void)
+{
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    g_autofree gchar *default_path = g_strdup (snapd_client_get_socket_path (client));
+
+    snapd_client_set_socket_path (client, "first.sock");
+    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, "first.sock");
+
+    snapd_client_set_socket_path (client, "second.sock");
+    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, "second.sock");
+
+    snapd_client_set_socket_path (client, NULL);
+    g_assert_cmpstr (snapd_client_get_socket_path (client), ==, default_path);
+}
+
+static void
+test_user_agent_default (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_confinement (snapd, "strict");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -532,17 +680,18 @@ test_get_system_information_confinement_strict (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    g_assert_cmpstr (snapd_client_get_user_agent (client), ==, "snapd-glib/" VERSION);
+
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_STRICT);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "snapd-glib/" VERSION);
 }
 
 static void
-test_get_system_information_confinement_none (void)
+test_user_agent_custom (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_confinement (snapd, "partial");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -550,17 +699,17 @@ test_get_system_information_confinement_none (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    snapd_client_set_user_agent (client, "Foo/1.0");
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_PARTIAL);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Foo/1.0");
 }
 
 static void
-test_get_system_information_confinement_unknown (void)
+test_user_agent_null (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_confinement (snapd, "NOT_DEFINED");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -568,19 +717,17 @@ test_get_system_information_confinement_unknown (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    snapd_client_set_user_agent (client, NULL);
     g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (info);
-    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, NULL);
 }
 
 static void
-test_login_sync (void)
+test_user_agent_changed (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    g_auto(GStrv) keys = g_strsplit ("KEY1;KEY2", ";", -1);
-    mock_account_set_ssh_keys (a, keys);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -588,59 +735,24 @@ test_login_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    g_assert_cmpint (snapd_user_information_get_id (user_information), ==, 1);
-    g_assert_cmpstr (snapd_user_information_get_email (user_information), ==, "test@example.com");
-    g_assert_cmpstr (snapd_user_information_get_username (user_information), ==, "test");
-    GStrv ssh_keys = snapd_user_information_get_ssh_keys (user_information);
-    g_assert_nonnull (ssh_keys);
-    g_assert_cmpint (g_strv_length (ssh_keys), ==, 0);
-    SnapdAuthData *auth_data = snapd_user_information_get_auth_data (user_information);
-    g_assert_nonnull (auth_data);
-    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
-    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
-    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
-        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
-}
-
-static void
-login_cb (GObject *object, GAsyncResult *result, gpointer user_data)
-{
-    g_autoptr(AsyncData) data = user_data;
-
-    MockAccount *a = mock_snapd_find_account_by_username (data->snapd, "test");
+    g_assert_nonnull (info1);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "snapd-glib/" VERSION);
 
-    g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_finish (SNAPD_CLIENT (object), result, &error);
+    snapd_client_set_user_agent (client, "Foo/1.0");
+    g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    g_assert_cmpint (snapd_user_information_get_id (user_information), ==, 1);
-    g_assert_cmpstr (snapd_user_information_get_email (user_information), ==, "test@example.com");
-    g_assert_cmpstr (snapd_user_information_get_username (user_information), ==, "test");
-    GStrv ssh_keys = snapd_user_information_get_ssh_keys (user_information);
-    g_assert_nonnull (ssh_keys);
-    g_assert_cmpint (g_strv_length (ssh_keys), ==, 0);
-    SnapdAuthData *auth_data = snapd_user_information_get_auth_data (user_information);
-    g_assert_nonnull (auth_data);
-    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
-    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
-    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
-        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
-
-    g_main_loop_quit (data->loop);
+    g_assert_nonnull (info2);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Foo/1.0");
 }
 
 static void
-test_login_async (void)
+test_user_agent_prepared_requests (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    g_auto(GStrv) keys = g_strsplit ("KEY1;KEY2", ";", -1);
-    mock_account_set_ssh_keys (a, keys);
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -648,31 +760,65 @@ test_login_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_login2_async (client, "test@example.com", "secret", NULL, NULL, login_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    // Repeated requests reuse their serialized form, but only for the same path
+    for (int i = 0; i < 3; i++) {
+        g_autoptr(SnapdSnap) snap1 = snapd_client_get_snap_sync (client, "snap1", NULL, &error);
+        g_assert_no_error (error);
+        g_assert_cmpstr (snapd_snap_get_name (snap1), ==, "snap1");
+        g_autoptr(SnapdSnap) snap2 = snapd_client_get_snap_sync (client, "snap2", NULL, &error);
+        g_assert_no_error (error);
+        g_assert_cmpstr (snapd_snap_get_name (snap2), ==, "snap2");
+    }
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "snapd-glib/" VERSION);
+
+    // Changing the common headers replaces the reused requests
+    snapd_client_set_user_agent (client, "Foo/1.0");
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap1", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap1");
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Foo/1.0");
 }
 
 static void
-test_login_invalid_email (void)
+test_user_agent_shared_transport (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(SnapdTransport) transport = snapd_transport_new ();
+    snapd_transport_set_socket_path (transport, mock_snapd_get_socket_path (snapd));
+    g_autoptr(SnapdClient) client1 = snapd_client_new ();
+    snapd_client_set_transport (client1, transport);
+    snapd_client_set_user_agent (client1, "Foo/1.0");
+    g_autoptr(SnapdClient) client2 = snapd_client_new ();
+    snapd_client_set_transport (client2, transport);
+    snapd_client_set_user_agent (client2, "Bar/1.0");
+    g_assert_true (snapd_client_get_transport (client1) == transport);
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "not-an-email", "secret", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_INVALID);
-    g_assert_null (user_information);
+    // Each client sends its own headers on the shared connection and counts its own requests
+    g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client1, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info1);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Foo/1.0");
+    g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client2, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info2);
+    g_assert_cmpstr (mock_snapd_get_last_user_agent (snapd), ==, "Bar/1.0");
+    g_assert_cmpint (get_statistic (client1, "requests"), ==, 1);
+    g_assert_cmpint (get_statistic (client2, "requests"), ==, 1);
 }
 
 static void
-test_login_invalid_password (void)
+test_accept_language (void)
 {
+    g_setenv ("LANG", "en_US.UTF-8", TRUE);
+    g_setenv ("LANGUAGE", "en_US:fr", TRUE);
+    g_setenv ("LC_ALL", "", TRUE);
+    g_setenv ("LC_MESSAGES", "", TRUE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -680,17 +826,21 @@ test_login_invalid_password (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "invalid", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
-    g_assert_null (user_information);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "en-us, en;q=0.9, fr;q=0.8");
 }
 
 static void
-test_login_otp_missing (void)
+test_accept_language_changed (void)
 {
+    g_setenv ("LANG", "en_US.UTF-8", TRUE);
+    g_setenv ("LANGUAGE", "en_US:fr", TRUE);
+    g_setenv ("LC_ALL", "", TRUE);
+    g_setenv ("LC_MESSAGES", "", TRUE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_otp (a, "1234");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -698,17 +848,27 @@ test_login_otp_missing (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TWO_FACTOR_REQUIRED);
-    g_assert_null (user_information);
+    g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info1);
+    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "en-us, en;q=0.9, fr;q=0.8");
+
+    g_setenv ("LANGUAGE", "fr", TRUE);
+    g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info2);
+    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "fr");
 }
 
 static void
-test_login_otp_invalid (void)
+test_accept_language_empty (void)
 {
+    g_setenv ("LANG", "", TRUE);
+    g_setenv ("LANGUAGE", "", TRUE);
+    g_setenv ("LC_ALL", "", TRUE);
+    g_setenv ("LC_MESSAGES", "", TRUE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_otp (a, "1234");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -716,16 +876,16 @@ test_login_otp_invalid (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", "0000", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TWO_FACTOR_INVALID);
-    g_assert_null (user_information);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpstr (mock_snapd_get_last_accept_language (snapd), ==, "en");
 }
 
 static void
-test_login_legacy (void)
+test_allow_interaction (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -733,25 +893,32 @@ test_login_legacy (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_autoptr(SnapdAuthData) auth_data = snapd_client_login_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    /* By default, interaction is allowed */
+    g_assert_true (snapd_client_get_allow_interaction (client));
+
+    /* ... which sends the X-Allow-Interaction header with requests */
+    g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (auth_data);
-    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
-    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
-    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
-        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
+    g_assert_nonnull (info1);
+    g_assert_cmpstr (mock_snapd_get_last_allow_interaction (snapd), ==, "true");
+
+    /* If interaction is not allowed, the header is not sent */
+    snapd_client_set_allow_interaction (client, FALSE);
+    g_assert_false (snapd_client_get_allow_interaction (client));
+    g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info2);
+    g_assert_cmpstr (mock_snapd_get_last_allow_interaction (snapd), ==, NULL);
 }
 
 static void
-test_logout_sync (void)
+test_max_read_size (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
-    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
-    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
-    gint64 id = mock_account_get_id (a);
+    for (int i = 0; i < 100; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%d", i);
+        mock_snapd_add_snap (snapd, name);
+    }
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -759,40 +926,70 @@ test_logout_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdAuthData) auth_data = snapd_auth_data_new (mock_account_get_macaroon (a), mock_account_get_discharges (a));
-    snapd_client_set_auth_data (client, auth_data);
+    /* Reads are limited to 64kB by default */
+    g_assert_cmpint (snapd_client_get_max_read_size (client), ==, 65536);
+    g_autoptr(GPtrArray) snaps1 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps1);
+    g_assert_cmpint (snaps1->len, ==, 100);
 
-    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
-    gboolean result = snapd_client_logout_sync (client, id, NULL, &error);
+    /* Responses larger than the read size are read in multiple blocks */
+    snapd_client_set_max_read_size (client, 1024);
+    g_assert_cmpint (snapd_client_get_max_read_size (client), ==, 1024);
+    g_autoptr(GPtrArray) snaps2 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_null (mock_snapd_find_account_by_id (snapd, id));
+    g_assert_nonnull (snaps2);
+    g_assert_cmpint (snaps2->len, ==, 100);
+
+    /* Zero restores the default */
+    snapd_client_set_max_read_size (client, 0);
+    g_assert_cmpint (snapd_client_get_max_read_size (client), ==, 65536);
 }
 
 static void
-logout_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_buffer_pool (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    for (int i = 0; i < 1000; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%d", i);
+        mock_snapd_add_snap (snapd, name);
+    }
 
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_logout_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_null (mock_snapd_find_account_by_id (data->snapd, data->id));
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_main_loop_quit (data->loop);
-}
+    g_autoptr(SnapdClient) client1 = snapd_client_new ();
+    snapd_client_set_socket_path (client1, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_use_buffer_pool (client1));
+    snapd_client_set_use_buffer_pool (client1, TRUE);
+    g_assert_true (snapd_client_get_use_buffer_pool (client1));
+    g_autoptr(SnapdClient) client2 = snapd_client_new ();
+    snapd_client_set_socket_path (client2, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_use_buffer_pool (client2, TRUE);
 
-static void
-test_logout_async (void)
-{
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    /* Clients take turns using the pooled buffers, with large responses in between that aren't kept */
+    for (int i = 0; i < 3; i++) {
+        g_autoptr(SnapdSystemInformation) info1 = snapd_client_get_system_information_sync (client1, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (info1);
+        g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client2, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_cmpint (snaps->len, ==, 1000);
+        g_autoptr(SnapdSystemInformation) info2 = snapd_client_get_system_information_sync (client2, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (info2);
+        g_autoptr(GPtrArray) snaps2 = snapd_client_get_snaps_sync (client1, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_cmpint (snaps2->len, ==, 1000);
+        g_assert_cmpstr (snapd_snap_get_name (snaps2->pdata[999]), ==, "snap999");
+    }
+}
 
+static void
+test_poll_interval (void)
+{
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
-    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
-    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
-    gint64 id = mock_account_get_id (a);
+    mock_snapd_add_store_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -800,24 +997,29 @@ test_logout_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdAuthData) auth_data = snapd_auth_data_new (mock_account_get_macaroon (a), mock_account_get_discharges (a));
-    snapd_client_set_auth_data (client, auth_data);
+    g_assert_cmpint (snapd_client_get_poll_interval (client), ==, 100);
+    g_assert_cmpint (snapd_client_get_max_poll_interval (client), ==, 1000);
+    snapd_client_set_poll_interval (client, 10);
+    snapd_client_set_max_poll_interval (client, 50);
+    g_assert_cmpint (snapd_client_get_poll_interval (client), ==, 10);
+    g_assert_cmpint (snapd_client_get_max_poll_interval (client), ==, 50);
 
-    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
-    AsyncData *data = async_data_new (loop, snapd);
-    data->id = id;
-    snapd_client_logout_async (client, id, NULL, logout_cb, data);
-    g_main_loop_run (loop);
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap"));
+
+    /* Zero restores the default */
+    snapd_client_set_poll_interval (client, 0);
+    snapd_client_set_max_poll_interval (client, 0);
+    g_assert_cmpint (snapd_client_get_poll_interval (client), ==, 100);
+    g_assert_cmpint (snapd_client_get_max_poll_interval (client), ==, 1000);
 }
 
 static void
-test_logout_no_auth (void)
+test_maintenance_none (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
-    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
-    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
-    gint64 id = mock_account_get_id (a);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -825,37 +1027,19 @@ test_logout_no_auth (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
-    gboolean result = snapd_client_logout_sync (client, id, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
-    g_assert_false (result);
-    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+
+    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
+    g_assert_null (maintenance);
 }
 
 static void
-test_get_changes_sync (void)
+test_maintenance_daemon_restart (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
-    MockTask *t = mock_change_add_task (c, "download");
-    mock_task_set_progress (t, 65535, 65535);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
-    t = mock_change_add_task (c, "install");
-    mock_task_set_progress (t, 1, 1);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
-    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
-
-    c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
-    t = mock_change_add_task (c, "remove");
-    mock_task_set_progress (t, 0, 1);
-    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+    mock_snapd_set_maintenance (snapd, "daemon-restart", "daemon is restarting");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -863,156 +1047,43 @@ test_get_changes_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_ALL, NULL, NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 2);
-
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "1");
-    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[0]), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (changes->pdata[0]), ==, "Done");
-    g_assert_true (snapd_change_get_ready (changes->pdata[0]));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_change_get_ready_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 30));
-    g_assert_null (snapd_change_get_error (changes->pdata[0]));
-    GPtrArray *tasks = snapd_change_get_tasks (changes->pdata[0]);
-    g_assert_cmpint (tasks->len, ==, 2);
-
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
-
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[1]), ==, "101");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[1]), ==, "install");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[1]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[1]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[1]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[1]), ==, 1);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[1]), ==, 1);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 10));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 30));
-
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[1]), ==, "2");
-    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[1]), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[1]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (changes->pdata[1]), ==, "Do");
-    g_assert_false (snapd_change_get_ready (changes->pdata[1]));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[1]), 2017, 1, 2, 11, 15, 0));
-    g_assert_null (snapd_change_get_ready_time (changes->pdata[1]));
-    g_assert_null (snapd_change_get_error (changes->pdata[1]));
-    tasks = snapd_change_get_tasks (changes->pdata[1]);
-    g_assert_cmpint (tasks->len, ==, 1);
+    g_assert_nonnull (info);
 
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "200");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "remove");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Do");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 0);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 1);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 15, 0));
-    g_assert_null (snapd_task_get_ready_time (tasks->pdata[0]));
+    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
+    g_assert_nonnull (maintenance);
+    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_DAEMON_RESTART);
+    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "daemon is restarting");
 }
 
 static void
-get_changes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_maintenance_system_restart (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_maintenance (snapd, "system-restart", "system is restarting");
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 2);
-
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "1");
-    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[0]), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (changes->pdata[0]), ==, "Done");
-    g_assert_true (snapd_change_get_ready (changes->pdata[0]));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_change_get_ready_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 30));
-    g_assert_null (snapd_change_get_error (changes->pdata[0]));
-    GPtrArray *tasks = snapd_change_get_tasks (changes->pdata[0]);
-    g_assert_cmpint (tasks->len, ==, 2);
-
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
-
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[1]), ==, "101");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[1]), ==, "install");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[1]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[1]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[1]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[1]), ==, 1);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[1]), ==, 1);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 10));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 30));
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[1]), ==, "2");
-    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[1]), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[1]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (changes->pdata[1]), ==, "Do");
-    g_assert_false (snapd_change_get_ready (changes->pdata[1]));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[1]), 2017, 1, 2, 11, 15, 0));
-    g_assert_null (snapd_change_get_ready_time (changes->pdata[1]));
-    g_assert_null (snapd_change_get_error (changes->pdata[1]));
-    tasks = snapd_change_get_tasks (changes->pdata[1]);
-    g_assert_cmpint (tasks->len, ==, 1);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "200");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "remove");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Do");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 0);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 1);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 15, 0));
-    g_assert_null (snapd_task_get_ready_time (tasks->pdata[0]));
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
 
-    g_main_loop_quit (data->loop);
+    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
+    g_assert_nonnull (maintenance);
+    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_SYSTEM_RESTART);
+    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "system is restarting");
 }
 
 static void
-test_get_changes_async (void)
+test_maintenance_unknown (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
-    MockTask *t = mock_change_add_task (c, "download");
-    mock_task_set_progress (t, 65535, 65535);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
-    t = mock_change_add_task (c, "install");
-    mock_task_set_progress (t, 1, 1);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
-    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
-
-    c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
-    t = mock_change_add_task (c, "remove");
-    mock_task_set_progress (t, 0, 1);
-    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+    mock_snapd_set_maintenance (snapd, "no-such-kind", "MESSAGE");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1020,83 +1091,104 @@ test_get_changes_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_changes_async (client, SNAPD_CHANGE_FILTER_ALL, NULL, NULL, get_changes_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+
+    SnapdMaintenance *maintenance = snapd_client_get_maintenance (client);
+    g_assert_nonnull (maintenance);
+    g_assert_cmpint (snapd_maintenance_get_kind (maintenance), ==, SNAPD_MAINTENANCE_KIND_UNKNOWN);
+    g_assert_cmpstr (snapd_maintenance_get_message (maintenance), ==, "MESSAGE");
+}
+
+static gboolean
+date_matches (GDateTime *date, int year, int month, int day, int hour, int minute, int second)
+{
+    g_autoptr(GDateTime) d = g_date_time_new_utc (year, month, day, hour, minute, second);
+    if (date == NULL)
+        return FALSE;
+    return g_date_time_compare (date, d) == 0;
 }
 
 static void
-test_get_changes_filter_in_progress (void)
+test_get_system_information_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_managed (snapd, TRUE);
+    mock_snapd_set_on_classic (snapd, TRUE);
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    mock_snapd_add_sandbox_feature (snapd, "backend", "feature1");
+    mock_snapd_add_sandbox_feature (snapd, "backend", "feature2");
+    mock_snapd_set_refresh_timer (snapd, "00:00~24:00/4");
+    mock_snapd_set_refresh_next (snapd, "2018-01-19T13:14:15Z");
 
-    MockChange *c = mock_snapd_add_change (snapd);
-    MockTask *t = mock_change_add_task (c, "foo");
-    mock_task_set_status (t, "Done");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "foo");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "foo");
-    mock_task_set_status (t, "Done");
-
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_IN_PROGRESS, NULL, NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 1);
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+    g_assert_nonnull (info);
+    g_assert_cmpstr (snapd_system_information_get_build_id (info), ==, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
+    g_assert_cmpstr (snapd_system_information_get_kernel_version (info), ==, "KERNEL-VERSION");
+    g_assert_cmpstr (snapd_system_information_get_os_id (info), ==, "OS-ID");
+    g_assert_cmpstr (snapd_system_information_get_os_version (info), ==, "OS-VERSION");
+    g_assert_cmpstr (snapd_system_information_get_series (info), ==, "SERIES");
+    g_assert_cmpstr (snapd_system_information_get_version (info), ==, "VERSION");
+    g_assert_true (snapd_system_information_get_managed (info));
+    g_assert_true (snapd_system_information_get_on_classic (info));
+    g_assert_cmpstr (snapd_system_information_get_mount_directory (info), ==, "/snap");
+    g_assert_cmpstr (snapd_system_information_get_binaries_directory (info), ==, "/snap/bin");
+    g_assert_null (snapd_system_information_get_refresh_schedule (info));
+    g_assert_cmpstr (snapd_system_information_get_refresh_timer (info), ==, "00:00~24:00/4");
+    g_assert_null (snapd_system_information_get_refresh_hold (info));
+    g_assert_null (snapd_system_information_get_refresh_last (info));
+    g_assert_true (date_matches (snapd_system_information_get_refresh_next (info), 2018, 1, 19, 13, 14, 15));
+    g_assert_null (snapd_system_information_get_store (info));
+    GHashTable *sandbox_features = snapd_system_information_get_sandbox_features (info);
+    g_assert_nonnull (sandbox_features);
+    GStrv backend_features = g_hash_table_lookup (sandbox_features, "backend");
+    g_assert_nonnull (backend_features);
+    g_assert_cmpint (g_strv_length (backend_features), ==, 2);
+    g_assert_cmpstr (backend_features[0], ==, "feature1");
+    g_assert_cmpstr (backend_features[1], ==, "feature2");
 }
 
 static void
-test_get_changes_filter_ready (void)
+system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    MockTask *t = mock_change_add_task (c, "foo");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "foo");
-    mock_task_set_status (t, "Done");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "foo");
+    g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_READY, NULL, NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 1);
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+    g_assert_nonnull (info);
+    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
+    g_assert_cmpstr (snapd_system_information_get_kernel_version (info), ==, "KERNEL-VERSION");
+    g_assert_cmpstr (snapd_system_information_get_os_id (info), ==, "OS-ID");
+    g_assert_cmpstr (snapd_system_information_get_os_version (info), ==, "OS-VERSION");
+    g_assert_cmpstr (snapd_system_information_get_series (info), ==, "SERIES");
+    g_assert_cmpstr (snapd_system_information_get_version (info), ==, "VERSION");
+    g_assert_true (snapd_system_information_get_managed (info));
+    g_assert_true (snapd_system_information_get_on_classic (info));
+    g_assert_cmpstr (snapd_system_information_get_mount_directory (info), ==, "/snap");
+    g_assert_cmpstr (snapd_system_information_get_binaries_directory (info), ==, "/snap/bin");
+    g_assert_null (snapd_system_information_get_store (info));
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_changes_filter_snap (void)
+test_get_system_information_async (void)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    MockTask *t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap1");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap2");
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap3");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_managed (snapd, TRUE);
+    mock_snapd_set_on_classic (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1104,179 +1196,125 @@ test_get_changes_filter_snap (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_ALL, "snap2", NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 1);
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+    snapd_client_get_system_information_async (client, NULL, system_information_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
 }
 
 static void
-test_get_changes_filter_ready_snap (void)
+system_information_coalesce_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    MockTask *t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap1");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap2");
-    mock_task_set_status (t, "Done");
-
-    c = mock_snapd_add_change (snapd);
-    t = mock_change_add_task (c, "install");
-    mock_task_set_snap_name (t, "snap2");
+    AsyncData *data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_READY, "snap2", NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (changes);
-    g_assert_cmpint (changes->len, ==, 1);
-    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+    g_assert_nonnull (info);
+    g_assert_true (snapd_system_information_get_managed (info));
+
+    data->counter--;
+    if (data->counter == 0) {
+        g_assert_cmpint (mock_snapd_get_request_count (data->snapd), ==, 1);
+        g_main_loop_quit (data->loop);
+        async_data_free (data);
+    }
 }
 
 static void
-test_get_change_sync (void)
+system_information_coalesce_cancelled_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (info);
+}
 
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
-    MockTask *t = mock_change_add_task (c, "download");
-    mock_task_set_progress (t, 65535, 65535);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
-    t = mock_change_add_task (c, "install");
-    mock_task_set_progress (t, 1, 1);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
-    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+static void
+test_get_system_information_coalesce (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
-    t = mock_change_add_task (c, "remove");
-    mock_task_set_progress (t, 0, 1);
-    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_managed (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_coalesce_requests (client));
+    snapd_client_set_coalesce_requests (client, TRUE);
+    g_assert_true (snapd_client_get_coalesce_requests (client));
 
-    g_autoptr(SnapdChange) change = snapd_client_get_change_sync (client, "1", NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (change);
-
-    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
-    g_assert_cmpstr (snapd_change_get_kind (change), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (change), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (change), ==, "Done");
-    g_assert_true (snapd_change_get_ready (change));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (change), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_change_get_ready_time (change), 2017, 1, 2, 11, 0, 30));
-    g_assert_null (snapd_change_get_error (change));
-    GPtrArray *tasks = snapd_change_get_tasks (change);
-    g_assert_cmpint (tasks->len, ==, 2);
-
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+    // Cancelling one caller doesn't affect the others
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_get_system_information_async (client, NULL, system_information_coalesce_cb, data);
+    snapd_client_get_system_information_async (client, cancellable, system_information_coalesce_cancelled_cb, NULL);
+    snapd_client_get_system_information_async (client, NULL, system_information_coalesce_cb, data);
+    snapd_client_get_system_information_async (client, NULL, system_information_coalesce_cb, data);
+    g_cancellable_cancel (cancellable);
+    g_main_loop_run (loop);
 }
 
 static void
-get_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+system_information_timings_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(AsyncData) data = user_data;
+    AsyncData *data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdChange) change = snapd_client_get_change_finish (SNAPD_CLIENT (object), result, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (change);
+    g_assert_nonnull (info);
 
-    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
-    g_assert_cmpstr (snapd_change_get_kind (change), ==, "KIND");
-    g_assert_cmpstr (snapd_change_get_summary (change), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_change_get_status (change), ==, "Done");
-    g_assert_true (snapd_change_get_ready (change));
-    g_assert_true (date_matches (snapd_change_get_spawn_time (change), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_change_get_ready_time (change), 2017, 1, 2, 11, 0, 30));
-    g_assert_null (snapd_change_get_error (change));
-    GPtrArray *tasks = snapd_change_get_tasks (change);
-    g_assert_cmpint (tasks->len, ==, 2);
+    g_autoptr(SnapdRequestTimings) timings = snapd_client_get_request_timings (SNAPD_CLIENT (object), result);
+    g_assert_nonnull (timings);
+    g_assert_cmpstr (snapd_request_timings_get_method (timings), ==, "GET");
+    g_assert_cmpstr (snapd_request_timings_get_path (timings), ==, "/v2/system-info");
+    g_assert_cmpint (snapd_request_timings_get_status_code (timings), ==, 200);
+    g_assert_cmpint (snapd_request_timings_get_bytes_sent (timings), >, 0);
+    g_assert_cmpint (snapd_request_timings_get_bytes_received (timings), >, 0);
 
-    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
-    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
-    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
-    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
-    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
-    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
-    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
-    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+    /* Every phase is reached, in order */
+    for (SnapdRequestPhase phase = SNAPD_REQUEST_PHASE_STARTED; phase < SNAPD_REQUEST_PHASE_COMPLETED; phase++)
+        g_assert_cmpint (snapd_request_timings_get_duration (timings, phase, phase + 1), >=, 0);
 
-    g_main_loop_quit (data->loop);
+    async_data_free (data);
 }
 
 static void
-test_get_change_async (void)
+request_finished_cb (SnapdClient *client, SnapdRequestTimings *timings, gpointer user_data)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    GMainLoop *loop = user_data;
 
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_assert_cmpstr (snapd_request_timings_get_path (timings), ==, "/v2/system-info");
+    g_assert_cmpint (snapd_request_timings_get_duration (timings, SNAPD_REQUEST_PHASE_STARTED, SNAPD_REQUEST_PHASE_COMPLETED), >=, 0);
+    g_main_loop_quit (loop);
+}
 
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
-    MockTask *t = mock_change_add_task (c, "download");
-    mock_task_set_progress (t, 65535, 65535);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
-    t = mock_change_add_task (c, "install");
-    mock_task_set_progress (t, 1, 1);
-    mock_task_set_status (t, "Done");
-    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
-    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
-    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+static void
+test_get_system_information_timings (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    c = mock_snapd_add_change (snapd);
-    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
-    t = mock_change_add_task (c, "remove");
-    mock_task_set_progress (t, 0, 1);
-    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_signal_connect (client, "request-finished", G_CALLBACK (request_finished_cb), loop);
 
-    snapd_client_get_change_async (client, "1", NULL, get_change_cb, async_data_new (loop, snapd));
+    snapd_client_get_system_information_async (client, NULL, system_information_timings_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_abort_change_sync (void)
+test_get_system_information_statistics (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_add_task (c, "foo");
+    mock_snapd_add_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1284,45 +1322,144 @@ test_abort_change_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdChange) change = snapd_client_abort_change_sync (client, "1", NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (change);
-    g_assert_true (snapd_change_get_ready (change));
-    g_assert_cmpstr (snapd_change_get_status (change), ==, "Error");
-    g_assert_cmpstr (snapd_change_get_error (change), ==, "cancelled");
-    GPtrArray *tasks = snapd_change_get_tasks (change);
-    g_assert_cmpint (tasks->len, ==, 1);
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Error");
+    g_assert_nonnull (info);
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_autoptr(SnapdSnap) missing_snap = snapd_client_get_snap_sync (client, "missing", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (missing_snap);
+
+    g_autoptr(GVariant) statistics = snapd_client_get_statistics (client);
+    g_assert_true (g_variant_is_of_type (statistics, G_VARIANT_TYPE_VARDICT));
+    guint64 value;
+    g_assert_true (g_variant_lookup (statistics, "requests", "t", &value));
+    g_assert_cmpint (value, ==, 3);
+    g_assert_true (g_variant_lookup (statistics, "errors", "t", &value));
+    g_assert_cmpint (value, ==, 1);
+    g_assert_true (g_variant_lookup (statistics, "bytes-sent", "t", &value));
+    g_assert_cmpint (value, >, 0);
+    g_assert_true (g_variant_lookup (statistics, "bytes-received", "t", &value));
+    g_assert_cmpint (value, >, 0);
+
+    g_autoptr(GVariant) endpoints = g_variant_lookup_value (statistics, "endpoints", G_VARIANT_TYPE ("a{sa{sv}}"));
+    g_assert_nonnull (endpoints);
+    g_assert_cmpint (g_variant_n_children (endpoints), ==, 2);
+    g_autoptr(GVariant) snap_statistics = g_variant_lookup_value (endpoints, "/v2/snaps/{name}", G_VARIANT_TYPE_VARDICT);
+    g_assert_nonnull (snap_statistics);
+    g_assert_true (g_variant_lookup (snap_statistics, "requests", "t", &value));
+    g_assert_cmpint (value, ==, 2);
+    g_assert_true (g_variant_lookup (snap_statistics, "errors", "t", &value));
+    g_assert_cmpint (value, ==, 1);
+    g_autoptr(GVariant) histogram = g_variant_lookup_value (snap_statistics, "latency-histogram", G_VARIANT_TYPE ("at"));
+    gsize n_buckets;
+    const guint64 *counts = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+    guint64 total = 0;
+    for (gsize i = 0; i < n_buckets; i++)
+        total += counts[i];
+    g_assert_cmpint (total, ==, 2);
+    g_autoptr(GVariant) system_info_statistics = g_variant_lookup_value (endpoints, "/v2/system-info", G_VARIANT_TYPE_VARDICT);
+    g_assert_nonnull (system_info_statistics);
+}
+
+static void
+test_get_system_information_capture (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/snaps", 50);
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *path = NULL;
+    int fd = g_file_open_tmp ("snapd-glib-capture-XXXXXX", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    g_assert_cmpint (g_chmod (path, 0644), ==, 0);
+    g_assert_true (snapd_client_start_capture (client, path, &error));
+    g_assert_no_error (error);
+
+    // Only the user can read the capture
+    GStatBuf stat_buf;
+    g_assert_cmpint (g_stat (path, &stat_buf), ==, 0);
+    g_assert_cmpint (stat_buf.st_mode & 0777, ==, 0600);
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdSnap) missing_snap = snapd_client_get_snap_sync (client, "missing", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_clear_error (&error);
+    snapd_client_stop_capture (client);
+
+    // The credentials returned by login aren't recorded
+    g_autofree gchar *contents = NULL;
+    g_assert_true (g_file_get_contents (path, &contents, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_nonnull (strstr (contents, " POST /v2/login "));
+    g_assert_null (strstr (contents, mock_account_get_macaroon (a)));
+
+    // A server with no data gives the same responses, with their original latency
+    g_autoptr(MockSnapd) replay_snapd = mock_snapd_new ();
+    g_assert_true (mock_snapd_load_capture (replay_snapd, path, &error));
+    g_assert_no_error (error);
+    g_assert_true (mock_snapd_start (replay_snapd, &error));
+    g_autoptr(SnapdClient) replay_client = snapd_client_new ();
+    snapd_client_set_socket_path (replay_client, mock_snapd_get_socket_path (replay_snapd));
+    g_autoptr(SnapdSystemInformation) replay_info = snapd_client_get_system_information_sync (replay_client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_system_information_get_build_id (replay_info), ==, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    gint64 start_time = g_get_monotonic_time ();
+    g_autoptr(SnapdSnap) replay_snap = snapd_client_get_snap_sync (replay_client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_snap_get_name (replay_snap), ==, "snap");
+    g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 50000);
+    g_autoptr(SnapdSnap) replay_missing_snap = snapd_client_get_snap_sync (replay_client, "missing", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (replay_missing_snap);
+
+    g_unlink (path);
+    g_free (path);
 }
 
 static void
-abort_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_get_system_information_store (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_store (snapd, "store");
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdChange) change = snapd_client_abort_change_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (change);
-    g_assert_true (snapd_change_get_ready (change));
-    g_assert_cmpstr (snapd_change_get_status (change), ==, "Error");
-    g_assert_cmpstr (snapd_change_get_error (change), ==, "cancelled");
-    GPtrArray *tasks = snapd_change_get_tasks (change);
-    g_assert_cmpint (tasks->len, ==, 1);
-    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Error");
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_main_loop_quit (data->loop);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpstr (snapd_system_information_get_store (info), ==, "store");
 }
 
 static void
-test_abort_change_async (void)
+test_get_system_information_refresh (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockChange *c = mock_snapd_add_change (snapd);
-    mock_change_add_task (c, "foo");
+    mock_snapd_set_refresh_timer (snapd, "00:00~24:00/4");
+    mock_snapd_set_refresh_hold (snapd, "2018-01-20T01:02:03Z");
+    mock_snapd_set_refresh_last (snapd, "2018-01-19T01:02:03Z");
+    mock_snapd_set_refresh_next (snapd, "2018-01-19T13:14:15Z");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1330,17 +1467,21 @@ test_abort_change_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_abort_change_async (client, "1", NULL, abort_change_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_null (snapd_system_information_get_refresh_schedule (info));
+    g_assert_cmpstr (snapd_system_information_get_refresh_timer (info), ==, "00:00~24:00/4");
+    g_assert_true (date_matches (snapd_system_information_get_refresh_hold (info), 2018, 1, 20, 1, 2, 3));
+    g_assert_true (date_matches (snapd_system_information_get_refresh_last (info), 2018, 1, 19, 1, 2, 3));
+    g_assert_true (date_matches (snapd_system_information_get_refresh_next (info), 2018, 1, 19, 13, 14, 15));
 }
 
 static void
-test_list_sync (void)
+test_get_system_information_refresh_schedule (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap1");
-    mock_snapd_add_snap (snapd, "snap2");
-    mock_snapd_add_snap (snapd, "snap3");
+    mock_snapd_set_refresh_schedule (snapd, "00:00-04:59/5:00-10:59/11:00-16:59/17:00-23:59");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1348,45 +1489,54 @@ test_list_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_autoptr(GPtrArray) snaps = snapd_client_list_sync (client, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 3);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+    g_assert_nonnull (info);
+    g_assert_cmpstr (snapd_system_information_get_refresh_schedule (info), ==, "00:00-04:59/5:00-10:59/11:00-16:59/17:00-23:59");
+    g_assert_null (snapd_system_information_get_refresh_timer (info));
 }
 
 static void
-list_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_get_system_information_confinement_strict (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_confinement (snapd, "strict");
 
     g_autoptr(GError) error = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_autoptr(GPtrArray) snaps = snapd_client_list_finish (SNAPD_CLIENT (object), result, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 3);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_main_loop_quit (data->loop);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_STRICT);
 }
 
 static void
-test_list_async (void)
+test_get_system_information_confinement_none (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_confinement (snapd, "partial");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_PARTIAL);
+}
 
+static void
+test_get_system_information_confinement_unknown (void)
+{
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap1");
-    mock_snapd_add_snap (snapd, "snap2");
-    mock_snapd_add_snap (snapd, "snap3");
+    mock_snapd_set_confinement (snapd, "NOT_DEFINED");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1394,21 +1544,19 @@ test_list_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    snapd_client_list_async (client, NULL, list_cb, async_data_new (loop, snapd));
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_main_loop_run (loop);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    g_assert_cmpint (snapd_system_information_get_confinement (info), ==, SNAPD_SYSTEM_CONFINEMENT_UNKNOWN);
 }
 
 static void
-test_get_snaps_sync (void)
+test_login_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_set_status (s, "installed");
-    mock_snapd_add_snap (snapd, "snap1");
-    mock_snapd_add_snap (snapd, "snap2");
-    mock_snapd_add_snap (snapd, "snap3");
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    g_auto(GStrv) keys = g_strsplit ("KEY1;KEY2", ";", -1);
+    mock_account_set_ssh_keys (a, keys);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1416,43 +1564,59 @@ test_get_snaps_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 3);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+    g_assert_nonnull (user_information);
+    g_assert_cmpint (snapd_user_information_get_id (user_information), ==, 1);
+    g_assert_cmpstr (snapd_user_information_get_email (user_information), ==, "test@example.com");
+    g_assert_cmpstr (snapd_user_information_get_username (user_information), ==, "test");
+    GStrv ssh_keys = snapd_user_information_get_ssh_keys (user_information);
+    g_assert_nonnull (ssh_keys);
+    g_assert_cmpint (g_strv_length (ssh_keys), ==, 0);
+    SnapdAuthData *auth_data = snapd_user_information_get_auth_data (user_information);
+    g_assert_nonnull (auth_data);
+    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
+    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
+    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
+        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
 }
 
 static void
-get_snaps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+login_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
+    MockAccount *a = mock_snapd_find_account_by_username (data->snapd, "test");
+
     g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 3);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+    g_assert_nonnull (user_information);
+    g_assert_cmpint (snapd_user_information_get_id (user_information), ==, 1);
+    g_assert_cmpstr (snapd_user_information_get_email (user_information), ==, "test@example.com");
+    g_assert_cmpstr (snapd_user_information_get_username (user_information), ==, "test");
+    GStrv ssh_keys = snapd_user_information_get_ssh_keys (user_information);
+    g_assert_nonnull (ssh_keys);
+    g_assert_cmpint (g_strv_length (ssh_keys), ==, 0);
+    SnapdAuthData *auth_data = snapd_user_information_get_auth_data (user_information);
+    g_assert_nonnull (auth_data);
+    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
+    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
+    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
+        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_snaps_async (void)
+test_login_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_set_status (s, "installed");
-    mock_snapd_add_snap (snapd, "snap1");
-    mock_snapd_add_snap (snapd, "snap2");
-    mock_snapd_add_snap (snapd, "snap3");
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    g_auto(GStrv) keys = g_strsplit ("KEY1;KEY2", ";", -1);
+    mock_account_set_ssh_keys (a, keys);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1460,19 +1624,14 @@ test_get_snaps_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_snaps_async (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, get_snaps_cb, async_data_new (loop, snapd));
+    snapd_client_login2_async (client, "test@example.com", "secret", NULL, NULL, login_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_get_snaps_filter (void)
+test_login_invalid_email (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_set_status (s, "installed");
-    mock_snapd_add_snap (snapd, "snap1");
-    mock_snapd_add_snap (snapd, "snap2");
-    mock_snapd_add_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1480,22 +1639,16 @@ test_get_snaps_filter (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gchar *filter_snaps[] = { "snap1", NULL };
-    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE, filter_snaps, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpint (snapd_snap_get_status (snaps->pdata[0]), ==, SNAPD_SNAP_STATUS_INSTALLED);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap1");
-    g_assert_cmpint (snapd_snap_get_status (snaps->pdata[1]), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "not-an-email", "secret", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_INVALID);
+    g_assert_null (user_information);
 }
 
 static void
-test_list_one_sync (void)
+test_login_invalid_password (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1503,107 +1656,52 @@ test_list_one_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_autoptr(SnapdSnap) snap = snapd_client_list_one_sync (client, "snap", NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_tracks (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_channels (snap)->len, ==, 0);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_false (snapd_snap_get_devmode (snap));
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_null (snapd_snap_get_install_date (snap));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
-    g_assert_false (snapd_snap_get_jailmode (snap));
-    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
-    g_assert_false (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "invalid", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
+    g_assert_null (user_information);
 }
 
 static void
-list_one_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_login_otp_missing (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_otp (a, "1234");
 
     g_autoptr(GError) error = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_autoptr(SnapdSnap) snap = snapd_client_list_one_finish (SNAPD_CLIENT (object), result, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_base (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_false (snapd_snap_get_devmode (snap));
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_null (snapd_snap_get_install_date (snap));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
-    g_assert_false (snapd_snap_get_jailmode (snap));
-    g_assert_null (snapd_snap_get_license (snap));
-    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
-    g_assert_null (snapd_snap_get_mounted_from (snap));
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
-    g_assert_false (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_main_loop_quit (data->loop);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TWO_FACTOR_REQUIRED);
+    g_assert_null (user_information);
 }
 
 static void
-test_list_one_async (void)
+test_login_otp_invalid (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_otp (a, "1234");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", "0000", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TWO_FACTOR_INVALID);
+    g_assert_null (user_information);
+}
 
+static void
+test_login_legacy (void)
+{
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap");
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1612,16 +1710,24 @@ test_list_one_async (void)
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    snapd_client_list_one_async (client, "snap", NULL, list_one_cb, async_data_new (loop, snapd));
+    g_autoptr(SnapdAuthData) auth_data = snapd_client_login_sync (client, "test@example.com", "secret", NULL, NULL, &error);
 G_GNUC_END_IGNORE_DEPRECATIONS
-    g_main_loop_run (loop);
+    g_assert_no_error (error);
+    g_assert_nonnull (auth_data);
+    g_assert_cmpstr (snapd_auth_data_get_macaroon (auth_data), ==, mock_account_get_macaroon (a));
+    g_assert_true (g_strv_length (snapd_auth_data_get_discharges (auth_data)) == g_strv_length (mock_account_get_discharges (a)));
+    for (int i = 0; mock_account_get_discharges (a)[i]; i++)
+        g_assert_cmpstr (snapd_auth_data_get_discharges (auth_data)[i], ==, mock_account_get_discharges (a)[i]);
 }
 
 static void
-test_get_snap_sync (void)
+test_logout_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
+    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
+    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
+    gint64 id = mock_account_get_id (a);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1629,103 +1735,40 @@ test_get_snap_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_autoptr(SnapdAuthData) auth_data = snapd_auth_data_new (mock_account_get_macaroon (a), mock_account_get_discharges (a));
+    snapd_client_set_auth_data (client, auth_data);
+
+    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
+    gboolean result = snapd_client_logout_sync (client, id, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_tracks (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_channels (snap)->len, ==, 0);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_false (snapd_snap_get_devmode (snap));
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_null (snapd_snap_get_install_date (snap));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
-    g_assert_false (snapd_snap_get_jailmode (snap));
-    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
-    g_assert_false (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+    g_assert_true (result);
+    g_assert_null (mock_snapd_find_account_by_id (snapd, id));
 }
 
 static void
-get_snap_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+logout_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_finish (SNAPD_CLIENT (object), result, &error);
+    gboolean r = snapd_client_logout_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_base (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
-    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_false (snapd_snap_get_devmode (snap));
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_null (snapd_snap_get_install_date (snap));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
-    g_assert_false (snapd_snap_get_jailmode (snap));
-    g_assert_null (snapd_snap_get_license (snap));
-    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
-    g_assert_null (snapd_snap_get_mounted_from (snap));
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
-    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
-    g_assert_false (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+    g_assert_true (r);
+    g_assert_null (mock_snapd_find_account_by_id (data->snapd, data->id));
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_snap_async (void)
+test_logout_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
+    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
+    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
+    gint64 id = mock_account_get_id (a);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1733,28 +1776,24 @@ test_get_snap_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_snap_async (client, "snap", NULL, get_snap_cb, async_data_new (loop, snapd));
+    g_autoptr(SnapdAuthData) auth_data = snapd_auth_data_new (mock_account_get_macaroon (a), mock_account_get_discharges (a));
+    snapd_client_set_auth_data (client, auth_data);
+
+    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
+    AsyncData *data = async_data_new (loop, snapd);
+    data->id = id;
+    snapd_client_logout_async (client, id, NULL, logout_cb, data);
     g_main_loop_run (loop);
 }
 
 static void
-test_get_snap_types (void)
+test_logout_no_auth (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "kernel");
-    mock_snap_set_type (s, "kernel");
-    s = mock_snapd_add_snap (snapd, "gadget");
-    mock_snap_set_type (s, "gadget");
-    s = mock_snapd_add_snap (snapd, "os");
-    mock_snap_set_type (s, "os");
-    s = mock_snapd_add_snap (snapd, "core");
-    mock_snap_set_type (s, "core");
-    s = mock_snapd_add_snap (snapd, "base");
-    mock_snap_set_type (s, "base");
-    s = mock_snapd_add_snap (snapd, "snapd");
-    mock_snap_set_type (s, "snapd");
-    s = mock_snapd_add_snap (snapd, "app");
-    mock_snap_set_type (s, "app");
+    mock_snapd_add_account (snapd, "test1@example.com", "test1", "secret");
+    MockAccount *a = mock_snapd_add_account (snapd, "test2@example.com", "test2", "secret");
+    mock_snapd_add_account (snapd, "test3@example.com", "test3", "secret");
+    gint64 id = mock_account_get_id (a);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1762,62 +1801,3832 @@ test_get_snap_types (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) kernel_snap = snapd_client_get_snap_sync (client, "kernel", NULL, &error);
+    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
+    gboolean result = snapd_client_logout_sync (client, id, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_false (result);
+    g_assert_nonnull (mock_snapd_find_account_by_id (snapd, id));
+}
+
+static void
+test_get_changes_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "download");
+    mock_task_set_progress (t, 65535, 65535);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
+    t = mock_change_add_task (c, "install");
+    mock_task_set_progress (t, 1, 1);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
+    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
+    t = mock_change_add_task (c, "remove");
+    mock_task_set_progress (t, 0, 1);
+    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_ALL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 2);
+
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[0]), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (changes->pdata[0]), ==, "Done");
+    g_assert_true (snapd_change_get_ready (changes->pdata[0]));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_change_get_ready_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 30));
+    g_assert_cmpint (snapd_change_get_spawn_time_usec (changes->pdata[0]), ==, g_date_time_to_unix (snapd_change_get_spawn_time (changes->pdata[0])) * G_USEC_PER_SEC);
+    g_assert_null (snapd_change_get_error (changes->pdata[0]));
+    GPtrArray *tasks = snapd_change_get_tasks (changes->pdata[0]);
+    g_assert_cmpint (tasks->len, ==, 2);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[1]), ==, "101");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[1]), ==, "install");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[1]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[1]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[1]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[1]), ==, 1);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[1]), ==, 1);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 10));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 30));
+
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[1]), ==, "2");
+    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[1]), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[1]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (changes->pdata[1]), ==, "Do");
+    g_assert_false (snapd_change_get_ready (changes->pdata[1]));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[1]), 2017, 1, 2, 11, 15, 0));
+    g_assert_null (snapd_change_get_ready_time (changes->pdata[1]));
+    g_assert_null (snapd_change_get_error (changes->pdata[1]));
+    tasks = snapd_change_get_tasks (changes->pdata[1]);
+    g_assert_cmpint (tasks->len, ==, 1);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "200");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "remove");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Do");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 0);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 1);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 15, 0));
+    g_assert_null (snapd_task_get_ready_time (tasks->pdata[0]));
+}
+
+static void
+get_changes_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 2);
+
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[0]), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (changes->pdata[0]), ==, "Done");
+    g_assert_true (snapd_change_get_ready (changes->pdata[0]));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_change_get_ready_time (changes->pdata[0]), 2017, 1, 2, 11, 0, 30));
+    g_assert_null (snapd_change_get_error (changes->pdata[0]));
+    GPtrArray *tasks = snapd_change_get_tasks (changes->pdata[0]);
+    g_assert_cmpint (tasks->len, ==, 2);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[1]), ==, "101");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[1]), ==, "install");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[1]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[1]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[1]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[1]), ==, 1);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[1]), ==, 1);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 10));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[1]), 2017, 1, 2, 11, 0, 30));
+
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[1]), ==, "2");
+    g_assert_cmpstr (snapd_change_get_kind (changes->pdata[1]), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (changes->pdata[1]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (changes->pdata[1]), ==, "Do");
+    g_assert_false (snapd_change_get_ready (changes->pdata[1]));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (changes->pdata[1]), 2017, 1, 2, 11, 15, 0));
+    g_assert_null (snapd_change_get_ready_time (changes->pdata[1]));
+    g_assert_null (snapd_change_get_error (changes->pdata[1]));
+    tasks = snapd_change_get_tasks (changes->pdata[1]);
+    g_assert_cmpint (tasks->len, ==, 1);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "200");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "remove");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Do");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 0);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 1);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 15, 0));
+    g_assert_null (snapd_task_get_ready_time (tasks->pdata[0]));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_changes_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "download");
+    mock_task_set_progress (t, 65535, 65535);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
+    t = mock_change_add_task (c, "install");
+    mock_task_set_progress (t, 1, 1);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
+    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
+    t = mock_change_add_task (c, "remove");
+    mock_task_set_progress (t, 0, 1);
+    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_changes_async (client, SNAPD_CHANGE_FILTER_ALL, NULL, NULL, get_changes_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_changes_filter_in_progress (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_IN_PROGRESS, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 1);
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+}
+
+static void
+test_get_changes_filter_ready (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "foo");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_READY, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 1);
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+}
+
+static void
+test_get_changes_filter_snap (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap1");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap2");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_ALL, "snap2", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 1);
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+}
+
+static void
+test_get_changes_filter_ready_snap (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap1");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap2");
+    mock_task_set_status (t, "Done");
+
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "install");
+    mock_task_set_snap_name (t, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) changes = snapd_client_get_changes_sync (client, SNAPD_CHANGE_FILTER_READY, "snap2", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (changes);
+    g_assert_cmpint (changes->len, ==, 1);
+    g_assert_cmpstr (snapd_change_get_id (changes->pdata[0]), ==, "2");
+}
+
+static void
+test_get_change_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "download");
+    mock_task_set_progress (t, 65535, 65535);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
+    t = mock_change_add_task (c, "install");
+    mock_task_set_progress (t, 1, 1);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
+    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
+    t = mock_change_add_task (c, "remove");
+    mock_task_set_progress (t, 0, 1);
+    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdChange) change = snapd_client_get_change_sync (client, "1", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
+    g_assert_cmpstr (snapd_change_get_kind (change), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (change), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (change), ==, "Done");
+    g_assert_true (snapd_change_get_ready (change));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (change), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_change_get_ready_time (change), 2017, 1, 2, 11, 0, 30));
+    g_assert_null (snapd_change_get_error (change));
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    g_assert_cmpint (tasks->len, ==, 2);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+}
+
+static void
+get_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_get_change_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
+    g_assert_cmpstr (snapd_change_get_kind (change), ==, "KIND");
+    g_assert_cmpstr (snapd_change_get_summary (change), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_change_get_status (change), ==, "Done");
+    g_assert_true (snapd_change_get_ready (change));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (change), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_change_get_ready_time (change), 2017, 1, 2, 11, 0, 30));
+    g_assert_null (snapd_change_get_error (change));
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    g_assert_cmpint (tasks->len, ==, 2);
+
+    g_assert_cmpstr (snapd_task_get_id (tasks->pdata[0]), ==, "100");
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
+    g_assert_cmpstr (snapd_task_get_summary (tasks->pdata[0]), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Done");
+    g_assert_cmpstr (snapd_task_get_progress_label (tasks->pdata[0]), ==, "LABEL");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 65535);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_task_get_ready_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 10));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_change_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "download");
+    mock_task_set_progress (t, 65535, 65535);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:10Z");
+    t = mock_change_add_task (c, "install");
+    mock_task_set_progress (t, 1, 1);
+    mock_task_set_status (t, "Done");
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:10Z");
+    mock_task_set_ready_time (t, "2017-01-02T11:00:30Z");
+    mock_change_set_ready_time (c, "2017-01-02T11:00:30Z");
+
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:15:00Z");
+    t = mock_change_add_task (c, "remove");
+    mock_task_set_progress (t, 0, 1);
+    mock_task_set_spawn_time (t, "2017-01-02T11:15:00Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_change_async (client, "1", NULL, get_change_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_abort_change_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_add_task (c, "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdChange) change = snapd_client_abort_change_sync (client, "1", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+    g_assert_true (snapd_change_get_ready (change));
+    g_assert_cmpstr (snapd_change_get_status (change), ==, "Error");
+    g_assert_cmpstr (snapd_change_get_error (change), ==, "cancelled");
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    g_assert_cmpint (tasks->len, ==, 1);
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Error");
+}
+
+static void
+abort_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_abort_change_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+    g_assert_true (snapd_change_get_ready (change));
+    g_assert_cmpstr (snapd_change_get_status (change), ==, "Error");
+    g_assert_cmpstr (snapd_change_get_error (change), ==, "cancelled");
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    g_assert_cmpint (tasks->len, ==, 1);
+    g_assert_cmpstr (snapd_task_get_status (tasks->pdata[0]), ==, "Error");
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_abort_change_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_add_task (c, "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_abort_change_async (client, "1", NULL, abort_change_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_notices_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    MockNotice *n = mock_snapd_add_notice (snapd, "change-update", "1", "2017-01-02T11:00:00.000000Z");
+    mock_notice_set_occurrences (n, 3);
+    mock_notice_add_last_data (n, "kind", "install-snap");
+    mock_snapd_add_notice (snapd, "refresh-inhibit", "-", "2017-01-02T11:15:00.000000Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) notices = snapd_client_get_notices_sync (client, NULL, 0, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (notices);
+    g_assert_cmpint (notices->len, ==, 2);
+
+    g_assert_cmpstr (snapd_notice_get_id (notices->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_notice_get_notice_type (notices->pdata[0]), ==, "change-update");
+    g_assert_cmpstr (snapd_notice_get_key (notices->pdata[0]), ==, "1");
+    g_assert_true (date_matches (snapd_notice_get_first_occurred (notices->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_notice_get_last_occurred (notices->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_true (date_matches (snapd_notice_get_last_repeated (notices->pdata[0]), 2017, 1, 2, 11, 0, 0));
+    g_assert_cmpint (snapd_notice_get_occurrences (notices->pdata[0]), ==, 3);
+    GHashTable *last_data = snapd_notice_get_last_data (notices->pdata[0]);
+    g_assert_cmpint (g_hash_table_size (last_data), ==, 1);
+    g_assert_cmpstr (g_hash_table_lookup (last_data, "kind"), ==, "install-snap");
+
+    g_assert_cmpstr (snapd_notice_get_id (notices->pdata[1]), ==, "2");
+    g_assert_cmpstr (snapd_notice_get_notice_type (notices->pdata[1]), ==, "refresh-inhibit");
+    g_assert_cmpstr (snapd_notice_get_key (notices->pdata[1]), ==, "-");
+    g_assert_cmpint (snapd_notice_get_occurrences (notices->pdata[1]), ==, 1);
+    g_assert_cmpint (g_hash_table_size (snapd_notice_get_last_data (notices->pdata[1])), ==, 0);
+}
+
+static void
+get_notices_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) notices = snapd_client_get_notices_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (notices);
+    g_assert_cmpint (notices->len, ==, 2);
+    g_assert_cmpstr (snapd_notice_get_id (notices->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_notice_get_id (notices->pdata[1]), ==, "2");
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_notices_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_notice (snapd, "change-update", "1", "2017-01-02T11:00:00.000000Z");
+    mock_snapd_add_notice (snapd, "refresh-inhibit", "-", "2017-01-02T11:15:00.000000Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_notices_async (client, NULL, 0, NULL, get_notices_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_notices_since (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_notice (snapd, "change-update", "1", "2017-01-02T11:00:00.000000Z");
+    mock_snapd_add_notice (snapd, "change-update", "2", "2017-01-02T11:15:00.000000Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GDateTime) since = g_date_time_new_utc (2017, 1, 2, 11, 10, 0);
+    g_autoptr(GPtrArray) notices = snapd_client_get_notices_sync (client, since, 0, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (notices);
+    g_assert_cmpint (notices->len, ==, 1);
+    g_assert_cmpstr (snapd_notice_get_key (notices->pdata[0]), ==, "2");
+}
+
+static void
+notice_event_cb (SnapdNoticesMonitor *monitor, SnapdNotice *notice, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    data->counter++;
+    if (data->counter == 3) {
+        snapd_notices_monitor_stop (monitor);
+        g_main_loop_quit (data->loop);
+    }
+}
+
+static void
+change_notice_event_cb (SnapdNoticesMonitor *monitor, SnapdNotice *notice, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_assert_cmpstr (snapd_notice_get_notice_type (notice), ==, "change-update");
+    data->id++;
+}
+
+static void
+test_notices_monitor (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_notice (snapd, "change-update", "1", "2016-12-31T12:00:00.000000Z");
+    mock_snapd_add_notice (snapd, "change-update", "2", "2017-01-02T11:00:00.000000Z");
+    mock_snapd_add_notice (snapd, "refresh-inhibit", "-", "2017-01-02T11:15:00.000000Z");
+    mock_snapd_add_notice (snapd, "change-update", "3", "2017-01-02T11:30:00.000000Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdNoticesMonitor) monitor = snapd_notices_monitor_new (client);
+    g_autoptr(GDateTime) since = g_date_time_new_utc (2017, 1, 1, 0, 0, 0);
+    snapd_notices_monitor_set_since_date_time (monitor, since);
+    g_signal_connect (monitor, "notice-event", G_CALLBACK (notice_event_cb), data);
+    g_signal_connect (monitor, "notice-event::change-update", G_CALLBACK (change_notice_event_cb), data);
+    g_assert_false (snapd_notices_monitor_get_running (monitor));
+    snapd_notices_monitor_start (monitor);
+    g_assert_true (snapd_notices_monitor_get_running (monitor));
+    g_main_loop_run (loop);
+
+    g_assert_false (snapd_notices_monitor_get_running (monitor));
+    g_assert_cmpint (data->counter, ==, 3);
+    g_assert_cmpint (data->id, ==, 2);
+    g_assert_true (date_matches (snapd_notices_monitor_get_since_date_time (monitor), 2017, 1, 2, 11, 30, 0));
+}
+
+static void
+snap_list_refresh_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_snap_list_refresh_finish (SNAPD_SNAP_LIST (object), result, &error));
+    g_assert_no_error (error);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+snap_added_cb (SnapdSnapList *list, SnapdSnap *snap, gpointer user_data)
+{
+    AsyncData *data = user_data;
+    g_assert_true (snapd_snap_list_get_snap (list, snapd_snap_get_name (snap)) == snap);
+    data->counter++;
+}
+
+static void
+snap_removed_cb (SnapdSnapList *list, SnapdSnap *snap, gpointer user_data)
+{
+    AsyncData *data = user_data;
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap2");
+    g_assert_null (snapd_snap_list_get_snap (list, "snap2"));
+    data->counter += 10;
+}
+
+static void
+snap_changed_cb (SnapdSnapList *list, SnapdSnap *snap, gpointer user_data)
+{
+    AsyncData *data = user_data;
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "2");
+    data->counter += 100;
+}
+
+static void
+test_snap_list (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdSnapList) list = snapd_snap_list_new (client);
+    g_signal_connect (list, "snap-added", G_CALLBACK (snap_added_cb), data);
+    g_signal_connect (list, "snap-removed", G_CALLBACK (snap_removed_cb), data);
+    g_signal_connect (list, "snap-changed", G_CALLBACK (snap_changed_cb), data);
+    g_assert_cmpint (snapd_snap_list_get_snaps (list)->len, ==, 0);
+
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 3);
+    g_assert_cmpint (snapd_snap_list_get_snaps (list)->len, ==, 3);
+    SnapdSnap *snap3 = snapd_snap_list_get_snap (list, "snap3");
+    g_assert_nonnull (snap3);
+
+    // Nothing changed
+    data->counter = 0;
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 0);
+    g_assert_true (snapd_snap_list_get_snap (list, "snap3") == snap3);
+
+    mock_snap_set_revision (s, "2");
+    mock_snapd_remove_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap4");
+    data->counter = 0;
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 111);
+    g_assert_cmpint (snapd_snap_list_get_snaps (list)->len, ==, 3);
+    g_assert_true (snapd_snap_list_get_snap (list, "snap3") == snap3);
+    g_assert_nonnull (snapd_snap_list_get_snap (list, "snap4"));
+}
+
+static void
+list_model_items_changed_cb (GListModel *model, guint position, guint removed, guint added, gpointer user_data)
+{
+    GString *changes = user_data;
+    g_string_append_printf (changes, "%u,%u,%u;", position, removed, added);
+}
+
+static void
+test_snap_list_model (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdSnapList) list = snapd_snap_list_new (client);
+    g_autoptr(SnapdSnapListModel) model = snapd_snap_list_model_new (list);
+    g_assert_true (snapd_snap_list_model_get_list (model) == list);
+    g_assert_true (g_list_model_get_item_type (G_LIST_MODEL (model)) == SNAPD_TYPE_SNAP);
+    g_autoptr(GString) changes = g_string_new ("");
+    g_signal_connect (model, "items-changed", G_CALLBACK (list_model_items_changed_cb), changes);
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 0);
+
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpstr (changes->str, ==, "0,0,3;");
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+
+    // Nothing changed
+    g_string_truncate (changes, 0);
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpstr (changes->str, ==, "");
+
+    // Only the snaps that changed are replaced
+    mock_snap_set_revision (s, "2");
+    mock_snapd_remove_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap4");
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpstr (changes->str, ==, "0,2,1;2,0,1;");
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+    for (guint i = 0; i < 3; i++) {
+        g_autoptr(SnapdSnap) snap = g_list_model_get_item (G_LIST_MODEL (model), i);
+        g_assert_true (snap == g_ptr_array_index (snapd_snap_list_get_snaps (list), i));
+    }
+}
+
+static void
+test_sorted_snap_model (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap-b");
+    mock_snap_set_title (s, "Carrot");
+    mock_snap_set_installed_size (s, 300);
+    s = mock_snapd_add_snap (snapd, "snap-a");
+    mock_snap_set_title (s, "Banana");
+    mock_snap_set_installed_size (s, 100);
+    s = mock_snapd_add_snap (snapd, "snap-c");
+    mock_snap_set_title (s, "Apple");
+    mock_snap_set_installed_size (s, 200);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdSnapList) list = snapd_snap_list_new (client);
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+
+    g_autoptr(SnapdSnapListModel) list_model = snapd_snap_list_model_new (list);
+    g_autoptr(SnapdSortedSnapModel) model = snapd_sorted_snap_model_new (G_LIST_MODEL (list_model));
+    g_assert_true (snapd_sorted_snap_model_get_source (model) == G_LIST_MODEL (list_model));
+    g_assert_cmpint (snapd_sorted_snap_model_get_sort_key (model), ==, SNAPD_SNAP_SORT_KEY_NAME);
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+    const gchar *names[3];
+    for (guint i = 0; i < 3; i++) {
+        g_autoptr(SnapdSnap) snap = g_list_model_get_item (G_LIST_MODEL (model), i);
+        names[i] = snapd_snap_get_name (snap);
+    }
+    g_assert_cmpstr (names[0], ==, "snap-a");
+    g_assert_cmpstr (names[1], ==, "snap-b");
+    g_assert_cmpstr (names[2], ==, "snap-c");
+
+    snapd_sorted_snap_model_set_sort_key (model, SNAPD_SNAP_SORT_KEY_TITLE, FALSE);
+    g_autoptr(SnapdSnap) first = g_list_model_get_item (G_LIST_MODEL (model), 0);
+    g_assert_cmpstr (snapd_snap_get_name (first), ==, "snap-c");
+
+    snapd_sorted_snap_model_set_sort_key (model, SNAPD_SNAP_SORT_KEY_INSTALLED_SIZE, TRUE);
+    g_assert_true (snapd_sorted_snap_model_get_descending (model));
+    g_autoptr(SnapdSnap) largest = g_list_model_get_item (G_LIST_MODEL (model), 0);
+    g_assert_cmpstr (snapd_snap_get_name (largest), ==, "snap-b");
+
+    // New snaps are inserted in place
+    g_autoptr(GString) changes = g_string_new ("");
+    g_signal_connect (model, "items-changed", G_CALLBACK (list_model_items_changed_cb), changes);
+    s = mock_snapd_add_snap (snapd, "snap-d");
+    mock_snap_set_installed_size (s, 150);
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpstr (changes->str, ==, "2,0,1;");
+
+    // Filtering matches name and title, ignoring case
+    snapd_sorted_snap_model_set_filter_text (model, "BAN");
+    g_assert_cmpstr (snapd_sorted_snap_model_get_filter_text (model), ==, "BAN");
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 1);
+    snapd_sorted_snap_model_set_filter_text (model, "snap-");
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 4);
+    snapd_sorted_snap_model_set_filter_text (model, NULL);
+    g_assert_null (snapd_sorted_snap_model_get_filter_text (model));
+}
+
+static void
+test_app_list_model (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    mock_snap_add_app (s, "app2");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_add_app (s, "app3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdSnapList) list = snapd_snap_list_new (client);
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+
+    // Apps of snaps already in the list are in the model
+    g_autoptr(SnapdAppListModel) model = snapd_app_list_model_new (list);
+    g_assert_true (g_list_model_get_item_type (G_LIST_MODEL (model)) == SNAPD_TYPE_APP);
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+    g_autoptr(SnapdApp) app = g_list_model_get_item (G_LIST_MODEL (model), 2);
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app3");
+    g_autoptr(GString) changes = g_string_new ("");
+    g_signal_connect (model, "items-changed", G_CALLBACK (list_model_items_changed_cb), changes);
+
+    mock_snapd_remove_snap (snapd, "snap2");
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpstr (changes->str, ==, "2,1,0;");
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 2);
+}
+
+static void
+change_list_refresh_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_change_list_refresh_finish (SNAPD_CHANGE_LIST (object), result, &error));
+    g_assert_no_error (error);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+change_added_cb (SnapdChangeList *list, SnapdChange *change, gpointer user_data)
+{
+    AsyncData *data = user_data;
+    g_assert_true (snapd_change_list_get_change (list, snapd_change_get_id (change)) == change);
+    data->counter++;
+}
+
+static void
+change_changed_cb (SnapdChangeList *list, SnapdChange *change, gpointer user_data)
+{
+    AsyncData *data = user_data;
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "2");
+    g_assert_true (snapd_change_get_ready (change));
+    data->counter += 100;
+}
+
+static void
+test_change_list (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:10:00Z");
+    MockTask *t2 = mock_change_add_task (c, "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdChangeList) list = snapd_change_list_new (client);
+    g_signal_connect (list, "change-added", G_CALLBACK (change_added_cb), data);
+    g_signal_connect (list, "change-changed", G_CALLBACK (change_changed_cb), data);
+    g_assert_cmpint (snapd_change_list_get_changes (list)->len, ==, 0);
+    g_assert_null (snapd_change_list_get_last_spawn_time (list));
+
+    snapd_change_list_refresh_async (list, NULL, change_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 2);
+    g_assert_cmpint (snapd_change_list_get_changes (list)->len, ==, 2);
+    g_assert_true (date_matches (snapd_change_list_get_last_spawn_time (list), 2017, 1, 2, 11, 10, 0));
+    SnapdChange *change1 = snapd_change_list_get_change (list, "1");
+    g_assert_nonnull (change1);
+
+    // Change 2 completes, change 3 starts and completes and change 4 starts between refreshes
+    mock_task_set_status (t2, "Done");
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+    c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:30:00Z");
+    mock_change_add_task (c, "foo");
+    data->counter = 0;
+    snapd_change_list_refresh_async (list, NULL, change_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 102);
+    GPtrArray *changes = snapd_change_list_get_changes (list);
+    g_assert_cmpint (changes->len, ==, 4);
+    for (guint i = 0; i < changes->len; i++) {
+        g_autofree gchar *id = g_strdup_printf ("%u", i + 1);
+        g_assert_cmpstr (snapd_change_get_id (changes->pdata[i]), ==, id);
+    }
+    g_assert_true (snapd_change_list_get_change (list, "1") == change1);
+    g_assert_true (snapd_change_get_ready (snapd_change_list_get_change (list, "3")));
+    g_assert_false (snapd_change_get_ready (snapd_change_list_get_change (list, "4")));
+    g_assert_true (date_matches (snapd_change_list_get_last_spawn_time (list), 2017, 1, 2, 11, 30, 0));
+
+    // A change that starts and completes after the last one seen is found
+    c = mock_snapd_add_change (snapd);
+    t = mock_change_add_task (c, "foo");
+    mock_task_set_status (t, "Done");
+    data->counter = 0;
+    snapd_change_list_refresh_async (list, NULL, change_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 1);
+    g_assert_nonnull (snapd_change_list_get_change (list, "5"));
+}
+
+static SnapdTask *
+make_task (const gchar *id, const gchar *summary, const gchar *status, gint64 done, gint64 total)
+{
+    return g_object_new (SNAPD_TYPE_TASK,
+                         "id", id,
+                         "kind", "kind",
+                         "summary", summary,
+                         "status", status,
+                         "progress-done", done,
+                         "progress-total", total,
+                         NULL);
+}
+
+static void
+change_summary_snap_changed_cb (SnapdChangeSummary *summary, const gchar *snap, gpointer user_data)
+{
+    GPtrArray *changed = user_data;
+    g_ptr_array_add (changed, g_strdup (snap));
+}
+
+static void
+test_change_summary (void)
+{
+    g_autoptr(SnapdChangeSummary) summary = snapd_change_summary_new ();
+    g_autoptr(GPtrArray) changed = g_ptr_array_new_with_free_func (g_free);
+    g_signal_connect (summary, "snap-changed", G_CALLBACK (change_summary_snap_changed_cb), changed);
+
+    g_autoptr(GPtrArray) tasks = g_ptr_array_new_with_free_func (g_object_unref);
+    g_ptr_array_add (tasks, make_task ("1", "Download snap \"snap1\" (2) from channel \"stable\"", "Doing", 50, 200));
+    g_ptr_array_add (tasks, make_task ("2", "Mount snap \"snap1\" (2)", "Do", 0, 1));
+    g_ptr_array_add (tasks, make_task ("3", "Download snap \"snap2\" (5) from channel \"stable\"", "Do", 0, 100));
+    g_ptr_array_add (tasks, make_task ("4", "Connect \"snap2:plug\" to \"core:slot\"", "Do", 0, 1));
+    g_ptr_array_add (tasks, make_task ("5", "Run hooks", "Do", 0, 1));
+    snapd_change_summary_update (summary, tasks);
+
+    g_auto(GStrv) names = snapd_change_summary_get_snap_names (summary);
+    g_assert_cmpint (g_strv_length (names), ==, 2);
+    g_assert_cmpstr (names[0], ==, "snap1");
+    g_assert_cmpstr (names[1], ==, "snap2");
+    g_assert_cmpint (changed->len, ==, 2);
+    g_assert_cmpint (snapd_change_summary_get_progress_done (summary, "snap1"), ==, 50);
+    g_assert_cmpint (snapd_change_summary_get_progress_total (summary, "snap1"), ==, 201);
+    g_assert_cmpint (snapd_change_summary_get_progress_done (summary, "snap2"), ==, 0);
+    g_assert_cmpint (snapd_change_summary_get_progress_total (summary, "snap2"), ==, 101);
+    g_assert_cmpint (snapd_change_summary_get_progress_total (summary, NULL), ==, 303);
+    g_assert_cmpstr (snapd_task_get_id (snapd_change_summary_get_current_task (summary, "snap1")), ==, "1");
+    g_assert_null (snapd_change_summary_get_current_task (summary, "snap2"));
+    g_assert_null (snapd_change_summary_get_estimated_ready_time (summary, "snap1"));
+    g_assert_cmpint (snapd_change_summary_get_progress_total (summary, "unknown"), ==, 0);
+
+    /* Only the tasks that changed are passed, and only their snap is updated */
+    g_ptr_array_set_size (changed, 0);
+    g_usleep (10000);
+    g_autoptr(GPtrArray) delta = g_ptr_array_new_with_free_func (g_object_unref);
+    g_ptr_array_add (delta, make_task ("1", "Download snap \"snap1\" (2) from channel \"stable\"", "Done", 200, 200));
+    g_ptr_array_add (delta, make_task ("2", "Mount snap \"snap1\" (2)", "Doing", 0, 1));
+    snapd_change_summary_update (summary, delta);
+
+    g_assert_cmpint (changed->len, ==, 1);
+    g_assert_cmpstr (changed->pdata[0], ==, "snap1");
+    g_assert_cmpint (snapd_change_summary_get_progress_done (summary, "snap1"), ==, 200);
+    g_assert_cmpint (snapd_change_summary_get_progress_total (summary, "snap1"), ==, 201);
+    g_assert_cmpint (snapd_change_summary_get_progress_done (summary, NULL), ==, 200);
+    g_assert_cmpstr (snapd_task_get_id (snapd_change_summary_get_current_task (summary, "snap1")), ==, "2");
+    g_assert_nonnull (snapd_change_summary_get_estimated_ready_time (summary, "snap1"));
+}
+static void
+change_monitor_cb (SnapdChangeMonitor *monitor, SnapdChange *change, GError *error, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
+    if (snapd_change_get_ready (change))
+        data->counter += 100;
+    else
+        data->counter++;
+}
+
+static void
+change_monitor_watch_done_cb (gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    data->id++;
+    if (data->id == 2)
+        g_main_loop_quit (data->loop);
+}
+
+static void
+test_change_monitor (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "foo");
+    mock_task_set_progress (t, 0, 3);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client1 = snapd_client_new ();
+    snapd_client_set_socket_path (client1, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_poll_interval (client1, 10);
+    g_autoptr(SnapdClient) client2 = snapd_client_new ();
+    snapd_client_set_socket_path (client2, mock_snapd_get_socket_path (snapd));
+
+    // Both clients watching the same change share one set of polls
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    SnapdChangeMonitor *monitor = snapd_change_monitor_get_default ();
+    g_assert_true (monitor == snapd_change_monitor_get_default ());
+    snapd_change_monitor_watch (monitor, client1, "1", change_monitor_cb, data, change_monitor_watch_done_cb);
+    snapd_change_monitor_watch (monitor, client2, "1", change_monitor_cb, data, change_monitor_watch_done_cb);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 1);
+    g_main_loop_run (loop);
+
+    g_assert_cmpint (data->counter, ==, 204);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 3);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 0);
+}
+
+static void
+test_change_monitor_unwatch (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_change_add_task (mock_snapd_add_change (snapd), "foo");
+    mock_change_add_task (mock_snapd_add_change (snapd), "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    SnapdChangeMonitor *monitor = snapd_change_monitor_get_default ();
+    guint watch1 = snapd_change_monitor_watch (monitor, client, "1", change_monitor_cb, data, NULL);
+    guint watch2 = snapd_change_monitor_watch (monitor, client, "1", change_monitor_cb, data, NULL);
+    guint watch3 = snapd_change_monitor_watch (monitor, client, "2", change_monitor_cb, data, NULL);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 2);
+
+    // Polling only stops once the last watch on a change is removed
+    snapd_change_monitor_unwatch (monitor, watch1);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 2);
+    snapd_change_monitor_unwatch (monitor, watch2);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 1);
+    snapd_change_monitor_unwatch (monitor, watch3);
+    snapd_change_monitor_unwatch (monitor, watch3);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (monitor), ==, 0);
+    g_assert_cmpint (data->counter, ==, 0);
+}
+
+static void
+wait_change_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_assert_false (snapd_change_get_ready (change));
+    data->counter++;
+}
+
+static void
+wait_change_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_wait_change_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
+    g_assert_true (snapd_change_get_ready (change));
+    g_assert_cmpint (data->counter, ==, 2);
+    g_assert_cmpint (mock_snapd_get_request_count (data->snapd), ==, 3);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_wait_change (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockChange *c = mock_snapd_add_change (snapd);
+    MockTask *t = mock_change_add_task (c, "foo");
+    mock_task_set_progress (t, 0, 3);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_poll_interval (client, 10);
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    snapd_client_wait_change_async (client, "1", wait_change_progress_cb, data, NULL, wait_change_cb, data);
+    g_main_loop_run (loop);
+}
+
+static void
+wait_change_cancelled_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdChange) change = snapd_client_wait_change_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (change);
+    g_assert_cmpint (snapd_change_monitor_get_n_changes (snapd_change_monitor_get_default ()), ==, 0);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_wait_change_cancel (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_change_add_task (mock_snapd_add_change (snapd), "foo");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    // Cancelling stops waiting and removes the watch
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    snapd_client_wait_change_async (client, "1", NULL, NULL, cancellable, wait_change_cancelled_cb, data);
+    g_cancellable_cancel (cancellable);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 0);
+}
+
+static void
+media_fetched_cb (SnapdMediaPrefetcher *prefetcher, SnapdSnap *snap, SnapdMedia *media, const gchar *path, GError *error, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_media_get_media_type (media), ==, "screenshot");
+    g_assert_cmpint (snapd_media_get_width (media), ==, 800);
+
+    g_autofree gchar *contents = NULL;
+    g_assert_true (g_file_get_contents (path, &contents, NULL, NULL));
+    g_autofree gchar *expected_contents = g_strdup_printf ("%s-SCREENSHOT", snapd_snap_get_name (snap));
+    g_assert_cmpstr (contents, ==, expected_contents);
+    data->counter++;
+}
+
+static void
+media_prefetch_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_media_prefetcher_fetch_finish (SNAPD_MEDIA_PREFETCHER (object), result, &error));
+    g_assert_no_error (error);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_media_prefetcher (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_listen_tcp (snapd, TRUE);
+    mock_snapd_add_media_file (snapd, "/media/snap1-small.png", "snap1-SMALL");
+    mock_snapd_add_media_file (snapd, "/media/snap1.png", "snap1-SCREENSHOT");
+    mock_snapd_add_media_file (snapd, "/media/snap2.png", "snap2-SCREENSHOT");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autofree gchar *base_url = g_strdup_printf ("http://127.0.0.1:%u/media", mock_snapd_get_tcp_port (snapd));
+    g_autofree gchar *small_url = g_strdup_printf ("%s/snap1-small.png", base_url);
+    g_autofree gchar *url1 = g_strdup_printf ("%s/snap1.png", base_url);
+    g_autofree gchar *url2 = g_strdup_printf ("%s/snap2.png", base_url);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_add_media (s, "icon", url1, 256, 256);
+    mock_snap_add_media (s, "screenshot", small_url, 320, 200);
+    mock_snap_add_media (s, "screenshot", url1, 800, 600);
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_add_media (s, "screenshot", url2, 800, 600);
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 2);
+
+    g_autofree gchar *cache_path = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdMediaPrefetcher) prefetcher = snapd_media_prefetcher_new (cache_path);
+    g_assert_cmpstr (snapd_media_prefetcher_get_cache_dir (prefetcher), ==, cache_path);
+    snapd_media_prefetcher_set_max_concurrent (prefetcher, 2);
+    g_assert_cmpint (snapd_media_prefetcher_get_max_concurrent (prefetcher), ==, 2);
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_signal_connect (prefetcher, "media-fetched", G_CALLBACK (media_fetched_cb), data);
+    snapd_media_prefetcher_fetch_async (prefetcher, snaps, "screenshot", 1024, 768, 1, NULL, media_prefetch_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 2);
+    g_assert_cmpint (mock_snapd_get_media_downloads (snapd), ==, 2);
+
+    SnapdSnap *snap1 = snaps->pdata[0];
+    GPtrArray *media = snapd_snap_get_media (snap1);
+    g_assert_null (snapd_media_prefetcher_lookup (prefetcher, media->pdata[1]));
+    g_autofree gchar *path = snapd_media_prefetcher_lookup (prefetcher, media->pdata[2]);
+    g_assert_nonnull (path);
+
+    // Cached files are revalidated, not downloaded again
+    data->counter = 0;
+    snapd_media_prefetcher_fetch_async (prefetcher, snaps, "screenshot", 1024, 768, 1, NULL, media_prefetch_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 2);
+    g_assert_cmpint (mock_snapd_get_media_downloads (snapd), ==, 2);
+
+    g_autoptr(GDir) dir = g_dir_open (cache_path, 0, &error);
+    g_assert_no_error (error);
+    const gchar *name;
+    while ((name = g_dir_read_name (dir)) != NULL) {
+        g_autofree gchar *file_path = g_build_filename (cache_path, name, NULL);
+        g_assert_cmpint (g_unlink (file_path), ==, 0);
+    }
+    g_assert_cmpint (g_rmdir (cache_path), ==, 0);
+}
+
+static void
+refreshable_cache_get_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_refreshable_cache_get_finish (SNAPD_REFRESHABLE_CACHE (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap3");
+
+    data->counter--;
+    if (data->counter == 0)
+        g_main_loop_quit (data->loop);
+}
+
+static guint
+refreshable_cache_get (GMainLoop *loop, AsyncData *data, SnapdRefreshableCache *cache)
+{
+    guint request_count = mock_snapd_get_request_count (data->snapd);
+    data->counter = 1;
+    snapd_refreshable_cache_get_async (cache, NULL, refreshable_cache_get_cb, data);
+    g_main_loop_run (loop);
+    return mock_snapd_get_request_count (data->snapd) - request_count;
+}
+
+static void
+test_refreshable_cache (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_refresh_last (snapd, "2018-01-19T01:02:03Z");
+    mock_snapd_set_refresh_next (snapd, "2100-01-01T00:00:00Z");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdRefreshableCache) cache = snapd_refreshable_cache_new (client);
+    g_assert_null (snapd_refreshable_cache_get_snaps (cache));
+
+    // First check asks the store, later ones only check the local state
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+    g_assert_nonnull (snapd_refreshable_cache_get_snaps (cache));
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 2);
+
+    // Concurrent calls share the one check
+    guint request_count = mock_snapd_get_request_count (snapd);
+    data->counter = 2;
+    snapd_refreshable_cache_get_async (cache, NULL, refreshable_cache_get_cb, data);
+    snapd_refreshable_cache_get_async (cache, NULL, refreshable_cache_get_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd) - request_count, ==, 2);
+
+    // snapd refreshed
+    mock_snapd_set_refresh_last (snapd, "2018-01-20T01:02:03Z");
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 2);
+
+    // A snap was installed
+    mock_snapd_add_snap (snapd, "snap4");
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 2);
+
+    snapd_refreshable_cache_invalidate (cache);
+    g_assert_null (snapd_refreshable_cache_get_snaps (cache));
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+
+    // Refresh timer has fired
+    mock_snapd_set_refresh_next (snapd, "2018-01-21T01:02:03Z");
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+    g_assert_cmpint (refreshable_cache_get (loop, data, cache), ==, 3);
+}
+
+static void
+test_local_index (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "firefox");
+    mock_snap_set_title (s, "Firefox");
+    mock_snap_set_summary (s, "Mozilla Firefox web browser");
+    MockApp *a = mock_snap_add_app (s, "firefox");
+    mock_app_set_common_id (a, "org.mozilla.firefox");
+    mock_app_set_desktop_file (a, "/var/lib/snapd/desktop/applications/firefox_firefox.desktop");
+    mock_app_add_auto_alias (a, "ff");
+    s = mock_snapd_add_snap (snapd, "gnome-calculator");
+    mock_snap_set_title (s, "GNOME Calculator");
+    mock_snap_set_summary (s, "Perform arithmetic, scientific or financial calculations");
+    mock_snap_add_app (s, "gnome-calculator");
+    s = mock_snapd_add_snap (snapd, "fireplace");
+    mock_snap_set_summary (s, "A warm place");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_sync (client, NULL, &error);
+    g_assert_no_error (error);
+
+    g_autoptr(SnapdLocalIndex) index = snapd_local_index_new ();
+    for (guint i = 0; i < snaps->len; i++)
+        snapd_local_index_add_snap (index, snaps->pdata[i]);
+    snapd_local_index_set_aliases (index, aliases);
+    g_assert_cmpint (snapd_local_index_get_n_snaps (index), ==, 3);
+
+    /* Names rank above summaries, and case is ignored */
+    g_autoptr(GPtrArray) fire = snapd_local_index_find_prefix (index, "FiRe");
+    g_assert_cmpint (fire->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (fire->pdata[0]), ==, "firefox");
+    g_assert_cmpstr (snapd_snap_get_name (fire->pdata[1]), ==, "fireplace");
+    g_autoptr(GPtrArray) calc = snapd_local_index_find_prefix (index, "calc");
+    g_assert_cmpint (calc->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (calc->pdata[0]), ==, "gnome-calculator");
+    g_autoptr(GPtrArray) browser = snapd_local_index_find_prefix (index, "browser");
+    g_assert_cmpint (browser->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (browser->pdata[0]), ==, "firefox");
+    g_autoptr(GPtrArray) none = snapd_local_index_find_prefix (index, "xyz");
+    g_assert_cmpint (none->len, ==, 0);
+
+    /* Typing errors */
+    g_autoptr(GPtrArray) typo = snapd_local_index_find_fuzzy (index, "calculatr", 1);
+    g_assert_cmpint (typo->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (typo->pdata[0]), ==, "gnome-calculator");
+    g_autoptr(GPtrArray) transposed = snapd_local_index_find_fuzzy (index, "frifox", 2);
+    g_assert_cmpint (transposed->len, >=, 1);
+    g_assert_cmpstr (snapd_snap_get_name (transposed->pdata[0]), ==, "firefox");
+    g_autoptr(GPtrArray) too_far = snapd_local_index_find_fuzzy (index, "calculatr", 0);
+    g_assert_cmpint (too_far->len, ==, 0);
+
+    SnapdApp *app = snapd_local_index_lookup_common_id (index, "org.mozilla.firefox");
+    g_assert_nonnull (app);
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "firefox");
+    g_assert_true (snapd_local_index_lookup_desktop_file (index, "firefox_firefox.desktop") == app);
+    g_assert_true (snapd_local_index_lookup_desktop_file (index, "/var/lib/snapd/desktop/applications/firefox_firefox.desktop") == app);
+    g_assert_true (snapd_local_index_lookup_alias (index, "ff") == app);
+    g_assert_null (snapd_local_index_lookup_common_id (index, "org.example.missing"));
+
+    snapd_local_index_remove_snap (index, "firefox");
+    g_assert_cmpint (snapd_local_index_get_n_snaps (index), ==, 2);
+    g_assert_null (snapd_local_index_lookup_common_id (index, "org.mozilla.firefox"));
+    g_assert_null (snapd_local_index_lookup_alias (index, "ff"));
+    g_autoptr(GPtrArray) fire2 = snapd_local_index_find_prefix (index, "fire");
+    g_assert_cmpint (fire2->len, ==, 1);
+}
+
+static void
+test_local_index_snap_list (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdSnapList) list = snapd_snap_list_new (client);
+    g_autoptr(SnapdLocalIndex) index = snapd_local_index_new ();
+    snapd_local_index_track_snap_list (index, list);
+    g_assert_cmpint (snapd_local_index_get_n_snaps (index), ==, 0);
+
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_assert_cmpint (snapd_local_index_get_n_snaps (index), ==, 2);
+    g_autoptr(GPtrArray) snaps = snapd_local_index_find_prefix (index, "snap");
+    g_assert_cmpint (snaps->len, ==, 2);
+
+    mock_snapd_remove_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+    snapd_snap_list_refresh_async (list, NULL, snap_list_refresh_cb, data);
+    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) snap2 = snapd_local_index_find_prefix (index, "snap2");
+    g_assert_cmpint (snap2->len, ==, 0);
+    g_autoptr(GPtrArray) snap3 = snapd_local_index_find_prefix (index, "snap3");
+    g_assert_cmpint (snap3->len, ==, 1);
+
+    /* Changes are no longer followed once tracking stops */
+    snapd_local_index_track_snap_list (index, NULL);
+    g_assert_cmpint (snapd_local_index_get_n_snaps (index), ==, 0);
+}
+
+static void
+request_batch_completed_cb (SnapdRequestBatch *batch, guint index, gpointer user_data)
+{
+    guint *n_completed = user_data;
+    (*n_completed)++;
+}
+
+static void
+request_batch_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_false (snapd_request_batch_run_finish (SNAPD_REQUEST_BATCH (object), result, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_serialize_snaps (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_summary (s, "SUMMARY");
+    mock_snap_set_publisher_display_name (s, "PUBLISHER");
+    mock_snap_set_devmode (s, TRUE);
+    mock_snap_add_price (s, 1.25, "NZD");
+    mock_snap_add_media (s, "screenshot", "http://example.com/screenshot.png", 640, 480);
+    MockChannel *c = mock_track_add_channel (mock_snap_add_track (s, "latest"), "stable", NULL);
+    mock_channel_set_released_at (c, "2018-01-19T13:14:15+13:00");
+    mock_snapd_add_store_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 2);
+
+    g_autoptr(GBytes) data = snapd_snap_serialize (snaps->pdata[0]);
+    g_autoptr(SnapdSnap) snap = snapd_snap_deserialize (data, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER");
+    g_assert_null (snapd_snap_get_title (snap));
+    g_assert_true (snapd_snap_get_devmode (snap));
+    g_assert_false (snapd_snap_get_jailmode (snap));
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, snapd_snap_get_snap_type (snaps->pdata[0]));
+    GPtrArray *prices = snapd_snap_get_prices (snap);
+    g_assert_cmpint (prices->len, ==, 1);
+    g_assert_cmpfloat (snapd_price_get_amount (prices->pdata[0]), ==, 1.25);
+    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[0]), ==, "NZD");
+    GPtrArray *media = snapd_snap_get_media (snap);
+    g_assert_cmpint (media->len, ==, 1);
+    g_assert_cmpstr (snapd_media_get_url (media->pdata[0]), ==, "http://example.com/screenshot.png");
+    g_assert_cmpint (snapd_media_get_width (media->pdata[0]), ==, 640);
+    GPtrArray *channels = snapd_snap_get_channels (snap);
+    g_assert_cmpint (channels->len, ==, 1);
+    g_assert_cmpstr (snapd_channel_get_name (channels->pdata[0]), ==, "stable");
+    GDateTime *released_at = snapd_channel_get_released_at (channels->pdata[0]);
+    g_assert_true (g_date_time_equal (released_at, snapd_channel_get_released_at (snapd_snap_get_channels (snaps->pdata[0])->pdata[0])));
+    g_assert_cmpint (g_date_time_get_utc_offset (released_at), ==, 13 * G_TIME_SPAN_HOUR);
+
+    // Strings are used from the serialized data
+    gsize length;
+    const gchar *serialized = g_bytes_get_data (data, &length);
+    const gchar *summary = snapd_snap_get_summary (snap);
+    g_assert_true (summary >= serialized && summary < serialized + length);
+
+    g_autoptr(GBytes) array_data = snapd_snap_serialize_array (snaps);
+    g_autoptr(GPtrArray) deserialized_snaps = snapd_snap_deserialize_array (array_data, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (deserialized_snaps);
+    g_assert_cmpint (deserialized_snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (deserialized_snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (deserialized_snaps->pdata[1]), ==, "snap2");
+
+    // Data of the wrong kind or damaged is rejected
+    g_autoptr(SnapdSnap) wrong_snap = snapd_snap_deserialize (array_data, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_assert_null (wrong_snap);
+    g_clear_error (&error);
+    g_autoptr(GBytes) truncated = g_bytes_new_from_bytes (data, 0, g_bytes_get_size (data) / 2);
+    g_autoptr(SnapdSnap) truncated_snap = snapd_snap_deserialize (truncated, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_assert_null (truncated_snap);
+    g_clear_error (&error);
+}
+
+static void
+test_serialize_change (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockChange *c = mock_snapd_add_change (snapd);
+    mock_change_set_spawn_time (c, "2017-01-02T11:00:00Z");
+    MockTask *t = mock_change_add_task (c, "download");
+    mock_task_set_progress (t, 32768, 65535);
+    mock_task_set_spawn_time (t, "2017-01-02T11:00:00Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdChange) original = snapd_client_get_change_sync (client, "1", NULL, &error);
+    g_assert_no_error (error);
+
+    g_autoptr(GBytes) data = snapd_change_serialize (original);
+    g_autoptr(SnapdChange) change = snapd_change_deserialize (data, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (change);
+    g_assert_cmpstr (snapd_change_get_id (change), ==, "1");
+    g_assert_cmpstr (snapd_change_get_kind (change), ==, "KIND");
+    g_assert_false (snapd_change_get_ready (change));
+    g_assert_true (date_matches (snapd_change_get_spawn_time (change), 2017, 1, 2, 11, 0, 0));
+    g_assert_null (snapd_change_get_ready_time (change));
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    g_assert_cmpint (tasks->len, ==, 1);
+    g_assert_cmpstr (snapd_task_get_kind (tasks->pdata[0]), ==, "download");
+    g_assert_cmpint (snapd_task_get_progress_done (tasks->pdata[0]), ==, 32768);
+    g_assert_cmpint (snapd_task_get_progress_total (tasks->pdata[0]), ==, 65535);
+    g_assert_true (date_matches (snapd_task_get_spawn_time (tasks->pdata[0]), 2017, 1, 2, 11, 0, 0));
+}
+
+static void
+test_serialize_connection (void)
+{
+    g_autoptr(SnapdSlotRef) slot = g_object_new (SNAPD_TYPE_SLOT_REF, "snap", "snap1", "slot", "slot1", NULL);
+    g_autoptr(GHashTable) slot_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (slot_attributes, g_strdup ("slot-string"), g_variant_ref_sink (g_variant_new_string ("value")));
+    g_hash_table_insert (slot_attributes, g_strdup ("slot-int"), g_variant_ref_sink (g_variant_new_int64 (42)));
+    g_autoptr(GHashTable) plug_attributes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+    g_autoptr(SnapdConnection) original = g_object_new (SNAPD_TYPE_CONNECTION,
+                                                        "slot", slot,
+                                                        "interface", "interface",
+                                                        "manual", TRUE,
+                                                        "slot-attrs", slot_attributes,
+                                                        "plug-attrs", plug_attributes,
+                                                        NULL);
+
+    g_autoptr(GBytes) data = snapd_connection_serialize (original);
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdConnection) connection = snapd_connection_deserialize (data, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (connection);
+    g_assert_cmpstr (snapd_slot_ref_get_snap (snapd_connection_get_slot (connection)), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (snapd_connection_get_slot (connection)), ==, "slot1");
+    g_assert_null (snapd_connection_get_plug (connection));
+    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+    g_assert_true (snapd_connection_get_manual (connection));
+    g_assert_false (snapd_connection_get_gadget (connection));
+    g_assert_cmpstr (g_variant_get_string (snapd_connection_get_slot_attribute (connection, "slot-string"), NULL), ==, "value");
+    g_assert_cmpint (g_variant_get_int64 (snapd_connection_get_slot_attribute (connection, "slot-int")), ==, 42);
+    guint length;
+    g_auto(GStrv) plug_attribute_names = snapd_connection_get_plug_attribute_names (connection, &length);
+    g_assert_cmpint (g_strv_length (plug_attribute_names), ==, 0);
+    g_assert_cmpint (length, ==, 0);
+}
+
+static void
+test_request_batch (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    mock_snap_set_conf (s, "key", "\"value\"");
+    mock_snapd_add_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdRequestBatch) batch = snapd_request_batch_new (client);
+    guint n_completed = 0;
+    g_signal_connect (batch, "request-completed", G_CALLBACK (request_batch_completed_cb), &n_completed);
+    guint snap1_index = snapd_request_batch_add_get_snap (batch, "snap1");
+    guint snap2_index = snapd_request_batch_add_get_snap (batch, "snap2");
+    guint missing_index = snapd_request_batch_add_get_snap (batch, "snap3");
+    guint conf_index = snapd_request_batch_add_get_snap_conf (batch, "snap1", NULL);
+    guint apps_index = snapd_request_batch_add_get_apps (batch, SNAPD_GET_APPS_FLAGS_NONE, NULL);
+    guint connections_index = snapd_request_batch_add_get_connections (batch, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL);
+    g_assert_cmpint (snapd_request_batch_get_n_requests (batch), ==, 6);
+    g_assert_null (snapd_request_batch_get_snap (batch, snap1_index));
+
+    snapd_request_batch_run_async (batch, NULL, request_batch_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+
+    g_assert_cmpint (n_completed, ==, 6);
+    g_assert_true (snapd_request_batch_get_error (batch, snap1_index, NULL));
+    g_assert_cmpstr (snapd_snap_get_name (snapd_request_batch_get_snap (batch, snap1_index)), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snapd_request_batch_get_snap (batch, snap2_index)), ==, "snap2");
+    g_assert_false (snapd_request_batch_get_error (batch, missing_index, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (snapd_request_batch_get_snap (batch, missing_index));
+    GHashTable *conf = snapd_request_batch_get_snap_conf (batch, conf_index);
+    g_assert_nonnull (conf);
+    g_assert_cmpstr (g_variant_get_string (g_hash_table_lookup (conf, "key"), NULL), ==, "value");
+    GPtrArray *apps = snapd_request_batch_get_apps (batch, apps_index);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 1);
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app1");
+    GPtrArray *established = NULL;
+    g_assert_true (snapd_request_batch_get_connections (batch, connections_index, &established, NULL, NULL, NULL));
+    g_assert_nonnull (established);
+    g_assert_null (snapd_request_batch_get_snap (batch, conf_index));
+}
+
+static void
+request_batch_snapctl_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_request_batch_run_finish (SNAPD_REQUEST_BATCH (object), result, &error));
+    g_assert_no_error (error);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_request_batch_snapctl (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdRequestBatch) batch = snapd_request_batch_new (client);
+    guint indexes[100];
+    for (guint i = 0; i < G_N_ELEMENTS (indexes); i++) {
+        g_autofree gchar *key = g_strdup_printf ("key%u", i);
+        gchar *args[] = { "get", key, NULL };
+        indexes[i] = snapd_request_batch_add_run_snapctl (batch, "ABC", args);
+    }
+    gchar *error_args[] = { "arg1", NULL };
+    guint error_index = snapd_request_batch_add_run_snapctl (batch, "return-error", error_args);
+
+    snapd_request_batch_run_async (batch, NULL, request_batch_snapctl_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+
+    for (guint i = 0; i < G_N_ELEMENTS (indexes); i++) {
+        g_autofree gchar *expected_stdout = g_strdup_printf ("STDOUT:ABC:get:key%u", i);
+        const gchar *stdout_output = NULL, *stderr_output = NULL;
+        int exit_code = -1;
+        g_assert_true (snapd_request_batch_get_snapctl_output (batch, indexes[i], &stdout_output, &stderr_output, &exit_code));
+        g_assert_cmpstr (stdout_output, ==, expected_stdout);
+        g_assert_cmpstr (stderr_output, ==, "STDERR");
+        g_assert_cmpint (exit_code, ==, 0);
+    }
+    int exit_code = 0;
+    const gchar *stdout_output = NULL;
+    g_assert_true (snapd_request_batch_get_snapctl_output (batch, error_index, &stdout_output, NULL, &exit_code));
+    g_assert_cmpstr (stdout_output, ==, "STDOUT:return-error:arg1");
+    g_assert_cmpint (exit_code, ==, 1);
+    g_assert_null (snapd_request_batch_get_snap (batch, error_index));
+}
+
+static void
+fleet_start_cb (SnapdClient *client, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer callback_data, gpointer user_data)
+{
+    snapd_client_get_system_information_async (client, cancellable, callback, callback_data);
+}
+
+static void
+fleet_device_completed_cb (SnapdFleetClient *fleet, const gchar *name, SnapdClient *client, GAsyncResult *result, GHashTable *results)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (client, result, &error);
+    if (info != NULL)
+        g_hash_table_insert (results, g_strdup (name), g_strdup (snapd_system_information_get_build_id (info)));
+    else
+        g_hash_table_insert (results, g_strdup (name), g_strdup_printf ("%s:%d", g_quark_to_string (error->domain), error->code));
+}
+
+static void
+fleet_run_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_fleet_client_run_finish (SNAPD_FLEET_CLIENT (object), result, &error));
+    g_assert_no_error (error);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_fleet_client (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd1 = mock_snapd_new ();
+    mock_snapd_set_build_id (snapd1, "BUILD-ID1");
+    g_autoptr(MockSnapd) snapd2 = mock_snapd_new ();
+    mock_snapd_set_build_id (snapd2, "BUILD-ID2");
+    g_autoptr(MockSnapd) slow_snapd = mock_snapd_new ();
+    mock_snapd_set_endpoint_latency (slow_snapd, "/v2/system-info", 1000);
+    g_autoptr(MockSnapd) stopped_snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd1, &error));
+    g_assert_true (mock_snapd_start (snapd2, &error));
+    g_assert_true (mock_snapd_start (slow_snapd, &error));
+    g_assert_true (mock_snapd_start (stopped_snapd, &error));
+    mock_snapd_stop (stopped_snapd);
+
+    g_autoptr(SnapdFleetClient) fleet = snapd_fleet_client_new ();
+    snapd_fleet_client_set_max_concurrent (fleet, 2);
+    g_assert_cmpint (snapd_fleet_client_get_max_concurrent (fleet), ==, 2);
+    snapd_fleet_client_set_timeout (fleet, 100);
+    g_assert_cmpint (snapd_fleet_client_get_timeout (fleet), ==, 100);
+    snapd_fleet_client_add_device (fleet, "device1", mock_snapd_get_socket_path (snapd1));
+    snapd_fleet_client_add_device (fleet, "slow", mock_snapd_get_socket_path (slow_snapd));
+    snapd_fleet_client_add_device (fleet, "stopped", mock_snapd_get_socket_path (stopped_snapd));
+    SnapdClient *client2 = snapd_fleet_client_add_device (fleet, NULL, mock_snapd_get_socket_path (snapd2));
+    g_assert_cmpint (snapd_fleet_client_get_n_devices (fleet), ==, 4);
+    g_assert_true (snapd_fleet_client_get_device (fleet, mock_snapd_get_socket_path (snapd2)) == client2);
+    g_assert_cmpint (snapd_client_get_request_timeout (client2), ==, 100);
+    g_assert_null (snapd_fleet_client_get_device (fleet, "unknown"));
+
+    g_autoptr(GHashTable) results = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_signal_connect (fleet, "device-completed", G_CALLBACK (fleet_device_completed_cb), results);
+    snapd_fleet_client_run_async (fleet, fleet_start_cb, NULL, NULL, fleet_run_cb, async_data_new (loop, snapd1));
+    g_main_loop_run (loop);
+
+    g_autofree gchar *timed_out = g_strdup_printf ("%s:%d", g_quark_to_string (G_IO_ERROR), G_IO_ERROR_TIMED_OUT);
+    g_autofree gchar *connection_failed = g_strdup_printf ("%s:%d", g_quark_to_string (SNAPD_ERROR), SNAPD_ERROR_CONNECTION_FAILED);
+    g_assert_cmpint (g_hash_table_size (results), ==, 4);
+    g_assert_cmpstr (g_hash_table_lookup (results, "device1"), ==, "BUILD-ID1");
+    g_assert_cmpstr (g_hash_table_lookup (results, mock_snapd_get_socket_path (snapd2)), ==, "BUILD-ID2");
+    g_assert_cmpstr (g_hash_table_lookup (results, "slow"), ==, timed_out);
+    g_assert_cmpstr (g_hash_table_lookup (results, "stopped"), ==, connection_failed);
+}
+
+static void
+test_list_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_autoptr(GPtrArray) snaps = snapd_client_list_sync (client, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 3);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+}
+
+static void
+list_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_autoptr(GPtrArray) snaps = snapd_client_list_finish (SNAPD_CLIENT (object), result, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 3);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_list_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    snapd_client_list_async (client, NULL, list_cb, async_data_new (loop, snapd));
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snaps_max_response_size (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    for (int i = 0; i < 40; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%d", i);
+        mock_snapd_add_snap (snapd, name);
+    }
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_max_response_size (client), ==, 0);
+
+    /* Too big to keep */
+    snapd_client_set_max_response_size (client, 4096);
+    g_assert_cmpint (snapd_client_get_max_response_size (client), ==, 4096);
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_RESPONSE_TOO_LARGE);
+    g_assert_null (snaps);
+    g_clear_error (&error);
+
+    /* Small responses are unaffected, and the connection is still usable */
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap0", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+
+    /* Only requests made after a change use the new limit */
+    snapd_client_set_max_response_size (client, 0);
+    snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 40);
+    g_clear_pointer (&snaps, g_ptr_array_unref);
+
+    /* Chunked responses are limited by the size of the content, not the chunk framing */
+    mock_snapd_set_endpoint_chunked (snapd, "/v2/snaps", TRUE);
+    snapd_client_set_max_response_size (client, 4096);
+    snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_RESPONSE_TOO_LARGE);
+    g_assert_null (snaps);
+    g_clear_error (&error);
+    g_autoptr(SnapdSnap) snap2 = snapd_client_get_snap_sync (client, "snap0", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap2);
+}
+
+static void
+test_get_snaps_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_status (s, "installed");
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 3);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+}
+
+static void
+test_get_snaps_model (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdResultList) snaps = snapd_client_get_snaps_model_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_true (g_list_model_get_item_type (G_LIST_MODEL (snaps)) == SNAPD_TYPE_SNAP);
+    g_assert_cmpint (g_list_model_get_n_items (G_LIST_MODEL (snaps)), ==, 3);
+    g_autoptr(SnapdSnap) snap = g_list_model_get_item (G_LIST_MODEL (snaps), 1);
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap2");
+    g_assert_true (snap == g_ptr_array_index (snapd_result_list_get_array (snaps), 1));
+    g_assert_null (g_list_model_get_item (G_LIST_MODEL (snaps), 3));
+}
+
+static void
+get_snaps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 3);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[2]), ==, "snap3");
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_snaps_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_status (s, "installed");
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_snaps_async (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, get_snaps_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snaps_filter (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_status (s, "installed");
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *filter_snaps[] = { "snap1", NULL };
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_INCLUDE_INACTIVE, filter_snaps, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpint (snapd_snap_get_status (snaps->pdata[0]), ==, SNAPD_SNAP_STATUS_INSTALLED);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap1");
+    g_assert_cmpint (snapd_snap_get_status (snaps->pdata[1]), ==, SNAPD_SNAP_STATUS_ACTIVE);
+}
+
+static void
+test_get_snaps_dates (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    const gchar *dates[] = { "2017-01-02T11:23:58Z", "2017-01-02T23:23:58+12:00", "2017-01-02T05:53:58-05:30" };
+    int n_snaps = g_test_perf () ? 3000 : 3;
+    for (int i = 0; i < n_snaps; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%04d", i);
+        MockSnap *s = mock_snapd_add_snap (snapd, name);
+        mock_snap_set_install_date (s, dates[i % 3]);
+    }
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_test_timer_start ();
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    gdouble elapsed = g_test_timer_elapsed ();
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, n_snaps);
+    for (guint i = 0; i < snaps->len; i++) {
+        GDateTime *install_date = snapd_snap_get_install_date (snaps->pdata[i]);
+        g_assert_true (date_matches (install_date, 2017, 1, 2, 11, 23, 58));
+    }
+    g_assert_cmpint (g_date_time_get_utc_offset (snapd_snap_get_install_date (snaps->pdata[1])), ==, 12 * G_TIME_SPAN_HOUR);
+    g_assert_cmpint (g_date_time_get_utc_offset (snapd_snap_get_install_date (snaps->pdata[2])), ==, -(5 * G_TIME_SPAN_HOUR + 30 * G_TIME_SPAN_MINUTE));
+
+    if (g_test_perf ())
+        g_test_minimized_result (elapsed, "Parsed %d snaps with install dates in %f seconds", n_snaps, elapsed);
+}
+
+static void
+test_get_snaps_lazy (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    mock_snap_set_install_date (s, "2017-01-02T11:23:58Z");
+    mock_snapd_add_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_lazy_parsing (client));
+    snapd_client_set_lazy_parsing (client, TRUE);
+    g_assert_true (snapd_client_get_lazy_parsing (client));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    GPtrArray *apps = snapd_snap_get_apps (snaps->pdata[0]);
+    g_assert_cmpint (apps->len, ==, 1);
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app1");
+    g_assert_cmpstr (snapd_app_get_snap (apps->pdata[0]), ==, "snap1");
+    g_assert_true (date_matches (snapd_snap_get_install_date (snaps->pdata[0]), 2017, 1, 2, 11, 23, 58));
+    g_assert_cmpint (snapd_snap_get_install_date_usec (snaps->pdata[0]), ==, g_date_time_to_unix (snapd_snap_get_install_date (snaps->pdata[0])) * G_USEC_PER_SEC);
+
+    // Loaded through properties too
+    g_autoptr(GPtrArray) apps2 = NULL;
+    g_object_get (snaps->pdata[1], "apps", &apps2, NULL);
+    g_assert_nonnull (apps2);
+    g_assert_cmpint (apps2->len, ==, 0);
+    g_assert_nonnull (snapd_snap_get_tracks (snaps->pdata[1]));
+    g_assert_nonnull (snapd_snap_get_channels (snaps->pdata[1]));
+}
+
+static void
+test_get_snaps_shared (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_share_snaps (client));
+
+    // Not shared by default
+    g_autoptr(GPtrArray) snaps1 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(GPtrArray) snaps2 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (snaps1->pdata[0] != snaps2->pdata[0]);
+
+    snapd_client_set_share_snaps (client, TRUE);
+    g_assert_true (snapd_client_get_share_snaps (client));
+    g_autoptr(GPtrArray) snaps3 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(GPtrArray) snaps4 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps4->len, ==, 2);
+    g_assert_true (snaps3->pdata[0] == snaps4->pdata[0]);
+    g_assert_true (snaps3->pdata[1] == snaps4->pdata[1]);
+    g_assert_cmpstr (snapd_snap_get_name (snaps4->pdata[1]), ==, "snap2");
+
+    // Snaps that have changed are not shared
+    mock_snap_set_revision (mock_snapd_find_snap (snapd, "snap2"), "2");
+    g_autoptr(GPtrArray) snaps5 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (snaps5->pdata[0] == snaps3->pdata[0]);
+    g_assert_true (snaps5->pdata[1] != snaps3->pdata[1]);
+    g_assert_cmpstr (snapd_snap_get_revision (snaps5->pdata[1]), ==, "2");
+
+    // Snaps are only shared while they are alive
+    SnapdSnap *snap = snaps5->pdata[1];
+    g_object_add_weak_pointer (G_OBJECT (snap), (gpointer *) &snap);
+    g_clear_pointer (&snaps5, g_ptr_array_unref);
+    g_assert_null (snap);
+    g_autoptr(GPtrArray) snaps6 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_snap_get_revision (snaps6->pdata[1]), ==, "2");
+}
+
+static void
+test_get_snaps_shaped (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_generated_snaps (snapd, 100, 4, 2, 2, 2);
+    mock_snapd_set_endpoint_latency (snapd, "/v2/snaps", 50);
+    mock_snapd_set_endpoint_bandwidth (snapd, "/v2/snaps", 1000000);
+    mock_snapd_set_endpoint_chunked (snapd, "/v2/snaps", TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gint64 start_time = g_get_monotonic_time ();
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (g_get_monotonic_time () - start_time, >=, 50000);
+    g_assert_cmpint (snaps->len, ==, 100);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap0");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[99]), ==, "snap99");
+    g_assert_cmpint (snapd_snap_get_apps (snaps->pdata[99])->len, ==, 2);
+
+    /* Other endpoints are not affected */
+    g_autoptr(GPtrArray) store_snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap50", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (store_snaps);
+    g_assert_cmpint (store_snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_summary (store_snaps->pdata[0]), ==, "Summary of snap50");
+    g_assert_cmpint (snapd_snap_get_media (store_snaps->pdata[0])->len, ==, 2);
+}
+
+static void
+test_get_snaps_memory (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_generated_snaps (snapd, 10, 4, 2, 2, 2);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_track_memory (client));
+    snapd_client_set_track_memory (client, TRUE);
+    g_assert_true (snapd_client_get_track_memory (client));
+    g_assert_cmpint (snapd_client_get_live_parsed_bytes (client), ==, 0);
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 10);
+    gsize total = 0;
+    for (guint i = 0; i < snaps->len; i++) {
+        gsize size = snapd_snap_get_memory_size (snaps->pdata[i]);
+        g_assert_cmpint (size, >, strlen (snapd_snap_get_description (snaps->pdata[i])));
+        total += size;
+    }
+    g_assert_cmpint (snapd_client_get_live_parsed_bytes (client), ==, total);
+
+    /* Store snaps have channels and media, so are bigger */
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap0", NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(GPtrArray) store_snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap0", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (store_snaps->len, ==, 1);
+    g_assert_cmpint (snapd_snap_get_memory_size (store_snaps->pdata[0]), >, snapd_snap_get_memory_size (snap));
+
+    g_clear_pointer (&snaps, g_ptr_array_unref);
+    g_clear_pointer (&store_snaps, g_ptr_array_unref);
+    g_assert_cmpint (snapd_client_get_live_parsed_bytes (client), ==, snapd_snap_get_memory_size (snap));
+    g_clear_object (&snap);
+    g_assert_cmpint (snapd_client_get_live_parsed_bytes (client), ==, 0);
+}
+
+static void
+test_get_snaps_fields (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "42");
+    mock_snap_set_version (s, "1.2");
+    mock_snap_set_description (s, "DESCRIPTION");
+    mock_snap_add_app (s, "app1");
+    mock_snap_set_install_date (s, "2017-01-02T11:23:58Z");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_cache_ttl (client, "/v2/snaps", 60000);
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_with_fields_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, SNAPD_SNAP_FIELDS_NONE, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[0]), ==, "42");
+    g_assert_cmpstr (snapd_snap_get_version (snaps->pdata[0]), ==, "1.2");
+    g_assert_cmpint (snapd_snap_get_status (snaps->pdata[0]), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_null (snapd_snap_get_description (snaps->pdata[0]));
+    g_assert_null (snapd_snap_get_apps (snaps->pdata[0]));
+    g_assert_null (snapd_snap_get_install_date (snaps->pdata[0]));
+
+    g_autoptr(GPtrArray) snaps2 = snapd_client_get_snaps_with_fields_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, SNAPD_SNAP_FIELDS_DESCRIPTION | SNAPD_SNAP_FIELDS_APPS, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps2);
+    g_assert_cmpint (snaps2->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_description (snaps2->pdata[0]), ==, "DESCRIPTION");
+    g_assert_cmpint (snapd_snap_get_apps (snaps2->pdata[0])->len, ==, 1);
+    g_assert_null (snapd_snap_get_install_date (snaps2->pdata[0]));
+
+    // Partial responses are not cached for full requests
+    g_autoptr(GPtrArray) snaps3 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps3);
+    g_assert_cmpstr (snapd_snap_get_description (snaps3->pdata[0]), ==, "DESCRIPTION");
+    g_assert_true (date_matches (snapd_snap_get_install_date (snaps3->pdata[0]), 2017, 1, 2, 11, 23, 58));
+}
+
+static void
+test_list_one_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_autoptr(SnapdSnap) snap = snapd_client_list_one_sync (client, "snap", NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_tracks (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_channels (snap)->len, ==, 0);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_false (snapd_snap_get_devmode (snap));
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_null (snapd_snap_get_install_date (snap));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
+    g_assert_false (snapd_snap_get_jailmode (snap));
+    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
+    g_assert_false (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+}
+
+static void
+list_one_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_autoptr(SnapdSnap) snap = snapd_client_list_one_finish (SNAPD_CLIENT (object), result, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_base (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_false (snapd_snap_get_devmode (snap));
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_null (snapd_snap_get_install_date (snap));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
+    g_assert_false (snapd_snap_get_jailmode (snap));
+    g_assert_null (snapd_snap_get_license (snap));
+    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
+    g_assert_null (snapd_snap_get_mounted_from (snap));
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
+    g_assert_false (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_list_one_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    snapd_client_list_one_async (client, "snap", NULL, list_one_cb, async_data_new (loop, snapd));
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snap_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_tracks (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_channels (snap)->len, ==, 0);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_false (snapd_snap_get_devmode (snap));
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_null (snapd_snap_get_install_date (snap));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
+    g_assert_false (snapd_snap_get_jailmode (snap));
+    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
+    g_assert_false (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+}
+
+static void
+get_snap_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_base (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, NULL);
+    g_assert_cmpint (g_strv_length (snapd_snap_get_common_ids (snap)), ==, 0);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_false (snapd_snap_get_devmode (snap));
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_null (snapd_snap_get_install_date (snap));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
+    g_assert_false (snapd_snap_get_jailmode (snap));
+    g_assert_null (snapd_snap_get_license (snap));
+    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
+    g_assert_null (snapd_snap_get_mounted_from (snap));
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, NULL);
+    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, NULL);
+    g_assert_false (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, NULL);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_snap_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_snap_async (client, "snap", NULL, get_snap_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snap_types (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "kernel");
+    mock_snap_set_type (s, "kernel");
+    s = mock_snapd_add_snap (snapd, "gadget");
+    mock_snap_set_type (s, "gadget");
+    s = mock_snapd_add_snap (snapd, "os");
+    mock_snap_set_type (s, "os");
+    s = mock_snapd_add_snap (snapd, "core");
+    mock_snap_set_type (s, "core");
+    s = mock_snapd_add_snap (snapd, "base");
+    mock_snap_set_type (s, "base");
+    s = mock_snapd_add_snap (snapd, "snapd");
+    mock_snap_set_type (s, "snapd");
+    s = mock_snapd_add_snap (snapd, "app");
+    mock_snap_set_type (s, "app");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) kernel_snap = snapd_client_get_snap_sync (client, "kernel", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (kernel_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (kernel_snap), ==, SNAPD_SNAP_TYPE_KERNEL);
+    g_autoptr(SnapdSnap) gadget_snap = snapd_client_get_snap_sync (client, "gadget", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (gadget_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (gadget_snap), ==, SNAPD_SNAP_TYPE_GADGET);
+    g_autoptr(SnapdSnap) os_snap = snapd_client_get_snap_sync (client, "os", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (os_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (os_snap), ==, SNAPD_SNAP_TYPE_OS);
+    g_autoptr(SnapdSnap) core_snap = snapd_client_get_snap_sync (client, "core", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (core_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (core_snap), ==, SNAPD_SNAP_TYPE_CORE);
+    g_autoptr(SnapdSnap) base_snap = snapd_client_get_snap_sync (client, "base", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (base_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (base_snap), ==, SNAPD_SNAP_TYPE_BASE);
+    g_autoptr(SnapdSnap) snapd_snap = snapd_client_get_snap_sync (client, "snapd", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snapd_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (snapd_snap), ==, SNAPD_SNAP_TYPE_SNAPD);
+    g_autoptr(SnapdSnap) app_snap = snapd_client_get_snap_sync (client, "app", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (app_snap);
+    g_assert_cmpint (snapd_snap_get_snap_type (app_snap), ==, SNAPD_SNAP_TYPE_APP);
+}
+
+static void
+test_get_snap_optional_fields (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
+    mock_app_add_auto_alias (a, "app2");
+    mock_app_add_auto_alias (a, "app3");
+    mock_app_set_desktop_file (a, "/var/lib/snapd/desktop/applications/app.desktop");
+    mock_snap_set_base (s, "BASE");
+    mock_snap_set_broken (s, "BROKEN");
+    mock_snap_set_confinement (s, "classic");
+    mock_snap_set_devmode (s, TRUE);
+    mock_snap_set_install_date (s, "2017-01-02T11:23:58Z");
+    mock_snap_set_installed_size (s, 1024);
+    mock_snap_set_jailmode (s, TRUE);
+    mock_snap_set_trymode (s, TRUE);
+    mock_snap_set_contact (s, "CONTACT");
+    mock_snap_set_website (s, "WEBSITE");
+    mock_snap_set_channel (s, "CHANNEL");
+    mock_snap_set_description (s, "DESCRIPTION");
+    mock_snap_set_license (s, "LICENSE");
+    mock_snap_set_mounted_from (s, "MOUNTED-FROM");
+    mock_snap_set_store_url (s, "https://snapcraft.io/snap");
+    mock_snap_set_summary (s, "SUMMARY");
+    mock_snap_set_tracking_channel (s, "CHANNEL");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 1);
+    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app");
+    g_assert_null (snapd_app_get_common_id (app));
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_false (snapd_app_get_active (app));
+    g_assert_false (snapd_app_get_enabled (app));
+    g_assert_cmpstr (snapd_app_get_desktop_file (app), ==, "/var/lib/snapd/desktop/applications/app.desktop");
+    g_assert_cmpstr (snapd_snap_get_base (snap), ==, "BASE");
+    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, "BROKEN");
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, "CHANNEL");
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_CLASSIC);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, "CONTACT");
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, "DESCRIPTION");
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_true (snapd_snap_get_devmode (snap));
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_true (date_matches (snapd_snap_get_install_date (snap), 2017, 1, 2, 11, 23, 58));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 1024);
+    g_assert_true (snapd_snap_get_jailmode (snap));
+    g_assert_cmpstr (snapd_snap_get_license (snap), ==, "LICENSE");
+    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
+    g_assert_cmpstr (snapd_snap_get_mounted_from (snap), ==, "MOUNTED-FROM");
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, "https://snapcraft.io/snap");
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, "SUMMARY");
+    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, "CHANNEL");
+    g_assert_true (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, "WEBSITE");
+}
+
+static void
+test_get_snap_deprecated_fields (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    g_assert_cmpstr (snapd_snap_get_developer (snap), ==, "PUBLISHER-USERNAME");
+G_GNUC_END_IGNORE_DEPRECATIONS
+}
+
+static void
+test_get_snap_common_ids (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app1");
+    mock_app_set_common_id (a, "ID1");
+    a = mock_snap_add_app (s, "app2");
+    mock_app_set_common_id (a, "ID2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    GStrv common_ids = snapd_snap_get_common_ids (snap);
+    g_assert_cmpint (g_strv_length (common_ids), ==, 2);
+    g_assert_cmpstr (common_ids[0], ==, "ID1");
+    g_assert_cmpstr (common_ids[1], ==, "ID2");
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 2);
+    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
+    g_assert_cmpstr (snapd_app_get_common_id (app), ==, "ID1");
+    app = snapd_snap_get_apps (snap)->pdata[1];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
+    g_assert_cmpstr (snapd_app_get_common_id (app), ==, "ID2");
+}
+
+static void
+test_get_snap_not_installed (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (snap);
+}
+
+static void
+test_get_snap_cache (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_summary (s, "STORE-SUMMARY");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_snap_cache_ttl (client), ==, 0);
+    snapd_client_set_snap_cache_ttl (client, 60000);
+    g_assert_cmpint (snapd_client_get_snap_cache_ttl (client), ==, 60000);
+
+    /* Snaps from a list are used for single snaps */
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 2);
+    guint n_requests = mock_snapd_get_request_count (snapd);
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap2", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (snap == g_ptr_array_index (snaps, 1));
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, n_requests);
+    g_assert_cmpint (snapd_client_get_cache_hits (client), ==, 1);
+
+    /* Store snaps are kept separately */
+    g_assert_null (snapd_client_get_cached_store_snap (client, "snap1"));
+    g_autoptr(GPtrArray) store_snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap1", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (store_snaps->len, ==, 1);
+    g_autoptr(SnapdSnap) store_snap = snapd_client_get_cached_store_snap (client, "snap1");
+    g_assert_nonnull (store_snap);
+    g_assert_cmpstr (snapd_snap_get_summary (store_snap), ==, "STORE-SUMMARY");
+
+    /* Changes clear the cache */
+    g_assert_true (snapd_client_remove2_sync (client, SNAPD_REMOVE_FLAGS_NONE, "snap2", NULL, NULL, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_null (snapd_client_get_cached_store_snap (client, "snap1"));
+    g_clear_object (&snap);
+    snap = snapd_client_get_snap_sync (client, "snap2", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (snap);
+}
+
+static void
+test_get_snap_classic_confinement (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_confinement (s, "classic");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_CLASSIC);
+}
+
+static void
+test_get_snap_devmode_confinement (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_confinement (s, "devmode");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_DEVMODE);
+}
+
+static void
+test_get_snap_daemons (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app1");
+    mock_app_set_daemon (a, "simple");
+    a = mock_snap_add_app (s, "app2");
+    mock_app_set_daemon (a, "forking");
+    a = mock_snap_add_app (s, "app3");
+    mock_app_set_daemon (a, "oneshot");
+    a = mock_snap_add_app (s, "app4");
+    mock_app_set_daemon (a, "notify");
+    a = mock_snap_add_app (s, "app5");
+    mock_app_set_daemon (a, "dbus");
+    a = mock_snap_add_app (s, "app6");
+    mock_app_set_daemon (a, "INVALID");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 6);
+    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
+    app = snapd_snap_get_apps (snap)->pdata[1];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_FORKING);
+    app = snapd_snap_get_apps (snap)->pdata[2];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_ONESHOT);
+    app = snapd_snap_get_apps (snap)->pdata[3];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NOTIFY);
+    app = snapd_snap_get_apps (snap)->pdata[4];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_DBUS);
+    app = snapd_snap_get_apps (snap)->pdata[5];
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_UNKNOWN);
+}
+
+static void
+test_get_snap_publisher_starred (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_publisher_validation (s, "starred");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_STARRED);
+}
+
+static void
+test_get_snap_publisher_verified (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_publisher_validation (s, "verified");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_VERIFIED);
+}
+
+static void
+test_get_snap_publisher_unproven (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_publisher_validation (s, "unproven");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNPROVEN);
+}
+
+static void
+test_get_snap_publisher_unknown_validation (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_publisher_validation (s, "NOT-A-VALIDIATION");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap);
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+}
+
+static void
+setup_get_snap_conf (MockSnapd *snapd)
+{
+    MockSnap *s = mock_snapd_add_snap (snapd, "core");
+    mock_snap_set_conf (s, "string-key", "\"value\"");
+    mock_snap_set_conf (s, "int-key", "42");
+    mock_snap_set_conf (s, "bool-key", "true");
+    mock_snap_set_conf (s, "number-key", "1.25");
+    mock_snap_set_conf (s, "array-key", "[ 1, \"two\", 3.25 ]");
+    mock_snap_set_conf (s, "object-key", "{\"name\": \"foo\", \"value\": 42}");
+}
+
+static void
+check_get_snap_conf_result (GHashTable *conf)
+{
+    g_assert_cmpint (g_hash_table_size (conf), ==, 6);
+    GVariant *value = g_hash_table_lookup (conf, "string-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    value = g_hash_table_lookup (conf, "int-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    value = g_hash_table_lookup (conf, "bool-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = g_hash_table_lookup (conf, "number-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
+    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+}
+
+static void
+test_get_snap_conf_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    setup_get_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (conf);
+
+    check_get_snap_conf_result (conf);
+}
+
+static void
+get_snap_conf_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (conf);
+
+    check_get_snap_conf_result (conf);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_snap_conf_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    setup_get_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_snap_conf_async (client, "system", NULL, NULL, get_snap_conf_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_snap_conf_key_filter (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "core");
+    mock_snap_set_conf (s, "string-key", "\"value\"");
+    mock_snap_set_conf (s, "int-key", "42");
+    mock_snap_set_conf (s, "bool-key", "true");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *filter_keys[] = { "int-key", NULL };
+    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", filter_keys, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (conf);
+    g_assert_cmpint (g_hash_table_size (conf), ==, 1);
+    GVariant *value = g_hash_table_lookup (conf, "int-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+}
+
+static void
+test_get_snap_conf_invalid_key (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "core");
+    mock_snap_set_conf (s, "string-key", "\"value\"");
+    mock_snap_set_conf (s, "int-key", "42");
+    mock_snap_set_conf (s, "bool-key", "true");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *filter_keys[] = { "invalid-key", NULL };
+    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", filter_keys, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_OPTION_NOT_FOUND);
+    g_assert_null (conf);
+}
+
+static GHashTable *
+setup_set_snap_conf (MockSnapd *snapd)
+{
+    mock_snapd_add_snap (snapd, "core");
+
+    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values, "string-key", g_variant_new_string ("value"));
+    g_hash_table_insert (key_values, "int-key", g_variant_new_int64 (42));
+    g_hash_table_insert (key_values, "bool-key", g_variant_new_boolean (TRUE));
+    g_hash_table_insert (key_values, "number-key", g_variant_new_double (1.25));
+    g_autoptr(GVariantBuilder) array_builder = g_variant_builder_new (G_VARIANT_TYPE ("av"));
+    g_variant_builder_add (array_builder, "v", g_variant_new_int64 (1));
+    g_variant_builder_add (array_builder, "v", g_variant_new_string ("two"));
+    g_variant_builder_add (array_builder, "v", g_variant_new_double (3.25));
+    g_hash_table_insert (key_values, "array-key", g_variant_builder_end (array_builder));
+    g_autoptr(GVariantBuilder) object_builder = g_variant_builder_new (G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (object_builder, "{sv}", "name", g_variant_new_string ("foo"));
+    g_variant_builder_add (object_builder, "{sv}", "value", g_variant_new_int64 (42));
+    g_hash_table_insert (key_values, "object-key", g_variant_builder_end (object_builder));
+
+    return g_steal_pointer (&key_values);
+}
+
+static void
+check_set_snap_conf_result (MockSnapd *snapd)
+{
+    MockSnap *snap = mock_snapd_find_snap (snapd, "core");
+    g_assert_cmpint (mock_snap_get_conf_count (snap), ==, 6);
+    g_assert_cmpstr (mock_snap_get_conf (snap, "string-key"), ==, "\"value\"");
+    g_assert_cmpstr (mock_snap_get_conf (snap, "int-key"), ==, "42");
+    g_assert_cmpstr (mock_snap_get_conf (snap, "bool-key"), ==, "true");
+    g_assert_cmpstr (mock_snap_get_conf (snap, "number-key"), ==, "1.25");
+    g_assert_cmpstr (mock_snap_get_conf (snap, "array-key"), ==, "[1,\"two\",3.25]");
+    g_assert_cmpstr (mock_snap_get_conf (snap, "object-key"), ==, "{\"name\":\"foo\",\"value\":42}");
+}
+
+static void
+test_get_snap_conf_cache (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    setup_get_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_cache_ttl (client, "/v2/snaps/*/conf"), ==, 0);
+    snapd_client_set_cache_ttl (client, "/v2/snaps/*/conf", 60000);
+    g_assert_cmpint (snapd_client_get_cache_ttl (client, "/v2/snaps/*/conf"), ==, 60000);
+
+    g_autoptr(GHashTable) conf1 = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    check_get_snap_conf_result (conf1);
+    g_autoptr(GHashTable) conf2 = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    check_get_snap_conf_result (conf2);
+    g_assert_true (conf1 != conf2);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+    g_assert_cmpint (snapd_client_get_cache_hits (client), ==, 1);
+    g_assert_cmpint (snapd_client_get_cache_misses (client), ==, 1);
+
+    // Changing the configuration clears the cache
+    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values, "string-key", g_variant_ref_sink (g_variant_new_string ("value")));
+    g_assert_true (snapd_client_set_snap_conf_sync (client, "system", key_values, NULL, &error));
+    g_assert_no_error (error);
+    guint request_count = mock_snapd_get_request_count (snapd);
+    g_autoptr(GHashTable) conf3 = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (conf3);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count + 1);
+    g_assert_cmpint (snapd_client_get_cache_misses (client), ==, 2);
+
+    snapd_client_clear_cache (client);
+    g_autoptr(GHashTable) conf4 = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (conf4);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count + 2);
+    g_assert_cmpint (snapd_client_get_cache_hits (client), ==, 1);
+}
+
+static void
+test_get_snap_conf_cache_shared_transport (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    setup_get_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdTransport) transport = snapd_transport_new ();
+    snapd_transport_set_socket_path (transport, mock_snapd_get_socket_path (snapd));
+    g_autoptr(SnapdClient) client1 = snapd_client_new ();
+    snapd_client_set_transport (client1, transport);
+    snapd_client_set_cache_ttl (client1, "/v2/snaps/*/conf", 60000);
+    g_autoptr(SnapdClient) client2 = snapd_client_new ();
+    snapd_client_set_transport (client2, transport);
+
+    // The cache settings of the client making the request are used
+    g_autoptr(GHashTable) conf1 = snapd_client_get_snap_conf_sync (client1, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    check_get_snap_conf_result (conf1);
+    g_autoptr(GHashTable) conf2 = snapd_client_get_snap_conf_sync (client1, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    check_get_snap_conf_result (conf2);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+    g_assert_cmpint (snapd_client_get_cache_hits (client1), ==, 1);
+
+    // Clients don't share cached responses, as they may be authorized differently
+    g_autoptr(GHashTable) conf3 = snapd_client_get_snap_conf_sync (client2, "system", NULL, NULL, &error);
+    g_assert_no_error (error);
+    check_get_snap_conf_result (conf3);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+    g_assert_cmpint (snapd_client_get_cache_hits (client2), ==, 0);
+}
+
+static void
+test_set_snap_conf_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GHashTable) key_values = setup_set_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean r = snapd_client_set_snap_conf_sync (client, "system", key_values, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+
+    check_set_snap_conf_result (snapd);
+}
+
+static void
+set_snap_conf_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_set_snap_conf_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+
+    check_set_snap_conf_result (data->snapd);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_set_snap_conf_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GHashTable) key_values = setup_set_snap_conf (snapd);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_set_snap_conf_async (client, "system", key_values, NULL, set_snap_conf_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_set_snap_conf_invalid (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "core");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values, "string-value", g_variant_new_string ("value"));
+    gboolean r = snapd_client_set_snap_conf_sync (client, "invalid", key_values, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_false (r);
+}
+
+static void
+test_get_snap_config (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_conf (s, "string-key", "\"value\"");
+    mock_snap_set_conf (s, "int-key", "42");
+    mock_snap_set_conf (s, "bool-key", "true");
+    mock_snap_set_conf (s, "number-key", "1.25");
+    mock_snap_set_conf (s, "object-key", "{\"name\": \"foo\", \"inner\": {\"value\": 42}}");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_conf (s, "string-key", "\"value2\"");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdSnapConfig) config = snapd_client_get_snap_config_sync (client, "snap1", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (config);
+    g_auto(GStrv) keys = snapd_snap_config_get_keys (config);
+    g_assert_cmpint (g_strv_length (keys), ==, 5);
+    g_assert_cmpstr (snapd_snap_config_get_string (config, "string-key", NULL), ==, "value");
+    g_assert_cmpint (snapd_snap_config_get_int (config, "int-key", 0), ==, 42);
+    g_assert_true (snapd_snap_config_get_boolean (config, "bool-key", FALSE));
+    g_assert_cmpfloat (snapd_snap_config_get_double (config, "number-key", 0), ==, 1.25);
+    g_assert_cmpfloat (snapd_snap_config_get_double (config, "int-key", 0), ==, 42);
+    g_assert_cmpstr (snapd_snap_config_get_string (config, "object-key.name", NULL), ==, "foo");
+    g_assert_cmpint (snapd_snap_config_get_int (config, "object-key.inner.value", 0), ==, 42);
+    g_assert_cmpint (snapd_snap_config_get_int (config, "string-key", -1), ==, -1);
+    g_assert_cmpstr (snapd_snap_config_get_string (config, "missing-key", "default"), ==, "default");
+    g_assert_true (snapd_snap_config_has_key (config, "object-key.inner"));
+    g_assert_false (snapd_snap_config_has_key (config, "object-key.missing"));
+    g_autoptr(GVariant) value = snapd_snap_config_get_value (config, "object-key.inner");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE ("a{sv}")));
+
+    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values, "string-key", g_variant_ref_sink (g_variant_new_string ("value")));
+    g_hash_table_insert (key_values, "int-key", g_variant_ref_sink (g_variant_new_int64 (43)));
+    g_hash_table_insert (key_values, "new-key", g_variant_ref_sink (g_variant_new_boolean (TRUE)));
+    g_autoptr(GHashTable) changes = snapd_snap_config_get_changes (config, key_values);
+    g_assert_cmpint (g_hash_table_size (changes), ==, 2);
+    g_assert_true (g_hash_table_contains (changes, "int-key"));
+    g_assert_true (g_hash_table_contains (changes, "new-key"));
+
+    gchar *names[] = { "snap1", "snap2", NULL };
+    gchar *filter_keys[] = { "string-key", NULL };
+    g_autoptr(GHashTable) configs = snapd_client_get_snap_configs_sync (client, names, filter_keys, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (configs);
+    g_assert_cmpint (g_hash_table_size (configs), ==, 2);
+    g_assert_cmpstr (snapd_snap_config_get_string (g_hash_table_lookup (configs, "snap1"), "string-key", NULL), ==, "value");
+    g_assert_cmpstr (snapd_snap_config_get_string (g_hash_table_lookup (configs, "snap2"), "string-key", NULL), ==, "value2");
+}
+
+static void
+test_update_snap_conf (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
+    /* Values are stored as sent, so unchanged values keep their spacing */
+    mock_snap_set_conf (snap1, "string-key", "  \"value\"");
+    mock_snap_set_conf (snap1, "int-key", "  42");
+    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_conf (snap2, "int-key", "  1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GHashTable) key_values1 = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values1, "string-key", g_variant_ref_sink (g_variant_new_string ("value")));
+    g_hash_table_insert (key_values1, "int-key", g_variant_ref_sink (g_variant_new_int64 (43)));
+    gboolean r = snapd_client_update_snap_conf_sync (client, "snap1", key_values1, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_cmpstr (mock_snap_get_conf (snap1, "string-key"), ==, "  \"value\"");
+    g_assert_cmpstr (mock_snap_get_conf (snap1, "int-key"), ==, "43");
+
+    /* Keys that aren't set yet are compared against the whole configuration */
+    g_autoptr(GHashTable) key_values2 = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+    g_hash_table_insert (key_values2, "int-key", g_variant_ref_sink (g_variant_new_int64 (1)));
+    g_hash_table_insert (key_values2, "new-key", g_variant_ref_sink (g_variant_new_string ("new")));
+    g_autoptr(GHashTable) confs = g_hash_table_new (g_str_hash, g_str_equal);
+    g_hash_table_insert (confs, "snap1", key_values1);
+    g_hash_table_insert (confs, "snap2", key_values2);
+    r = snapd_client_update_snap_confs_sync (client, confs, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_cmpstr (mock_snap_get_conf (snap1, "string-key"), ==, "  \"value\"");
+    g_assert_cmpstr (mock_snap_get_conf (snap2, "int-key"), ==, "  1");
+    g_assert_cmpstr (mock_snap_get_conf (snap2, "new-key"), ==, "\"new\"");
+}
+
+static void
+test_get_apps_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app1");
+    a = mock_snap_add_app (s, "app2");
+    mock_app_set_desktop_file (a, "foo.desktop");
+    a = mock_snap_add_app (s, "app3");
+    mock_app_set_daemon (a, "simple");
+    mock_app_set_active (a, TRUE);
+    mock_app_set_enabled (a, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 3);
+    SnapdApp *app = apps->pdata[0];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
+    g_assert_false (snapd_app_get_active (app));
+    g_assert_false (snapd_app_get_enabled (app));
+    app = apps->pdata[1];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
+    g_assert_false (snapd_app_get_active (app));
+    g_assert_false (snapd_app_get_enabled (app));
+    app = apps->pdata[2];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app3");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
+    g_assert_true (snapd_app_get_active (app));
+    g_assert_true (snapd_app_get_enabled (app));
+}
+
+static void
+get_apps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 3);
+    SnapdApp *app = apps->pdata[0];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
+    g_assert_false (snapd_app_get_active (app));
+    g_assert_false (snapd_app_get_enabled (app));
+    app = apps->pdata[1];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
+    g_assert_false (snapd_app_get_active (app));
+    g_assert_false (snapd_app_get_enabled (app));
+    app = apps->pdata[2];
+    g_assert_cmpstr (snapd_app_get_name (app), ==, "app3");
+    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
+    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
+    g_assert_true (snapd_app_get_active (app));
+    g_assert_true (snapd_app_get_enabled (app));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_get_apps_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app1");
+    a = mock_snap_add_app (s, "app2");
+    mock_app_set_desktop_file (a, "foo.desktop");
+    a = mock_snap_add_app (s, "app3");
+    mock_app_set_daemon (a, "simple");
+    mock_app_set_active (a, TRUE);
+    mock_app_set_enabled (a, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    snapd_client_get_apps2_async (client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, get_apps_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_get_apps_services (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_add_app (s, "app1");
+    MockApp *a = mock_snap_add_app (s, "app2");
+    mock_app_set_daemon (a, "simple");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_SELECT_SERVICES, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 1);
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app2");
+}
+
+static void
+test_get_apps_filter (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_add_app (s, "app2");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *filter_snaps[] = { "snap1", NULL };
+    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_NONE, filter_snaps, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 1);
+    g_assert_cmpstr (snapd_app_get_snap (apps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app1");
+}
+
+static void
+test_control_services_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockApp *a = mock_snap_add_app (s, "service1");
+    mock_app_set_daemon (a, "simple");
+    a = mock_snap_add_app (s, "service2");
+    mock_app_set_daemon (a, "simple");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    a = mock_snap_add_app (s, "service3");
+    mock_app_set_daemon (a, "simple");
+    a = mock_snap_add_app (s, "service4");
+    mock_app_set_daemon (a, "simple");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *names[] = { "snap1", "snap2.service3", NULL };
+    g_autoptr(GPtrArray) apps = snapd_client_control_services_sync (client, SNAPD_SERVICE_ACTION_START, SNAPD_CONTROL_SERVICES_FLAGS_ENABLE, names, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (apps);
+    g_assert_cmpint (apps->len, ==, 3);
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "service1");
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[1]), ==, "service2");
+    g_assert_cmpstr (snapd_app_get_name (apps->pdata[2]), ==, "service3");
+    for (guint i = 0; i < apps->len; i++) {
+        g_assert_true (snapd_app_get_active (apps->pdata[i]));
+        g_assert_true (snapd_app_get_enabled (apps->pdata[i]));
+    }
+
+    gchar *other_names[] = { "snap2.service4", NULL };
+    g_autoptr(GPtrArray) other_apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_SELECT_SERVICES, other_names, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (other_apps);
+    g_assert_cmpint (other_apps->len, ==, 1);
+    g_assert_false (snapd_app_get_active (other_apps->pdata[0]));
+}
+
+static void
+test_control_services_not_found (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "service");
+    mock_app_set_daemon (a, "simple");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *names[] = { "snap.service", "snap.missing", NULL };
+    g_autoptr(GPtrArray) apps = snapd_client_control_services_sync (client, SNAPD_SERVICE_ACTION_STOP, SNAPD_CONTROL_SERVICES_FLAGS_NONE, names, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (apps);
+}
+
+static void
+test_icon_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (kernel_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (kernel_snap), ==, SNAPD_SNAP_TYPE_KERNEL);
-    g_autoptr(SnapdSnap) gadget_snap = snapd_client_get_snap_sync (client, "gadget", NULL, &error);
+    g_assert_nonnull (icon);
+    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
+    GBytes *data = snapd_icon_get_data (icon);
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "ICON-DATA", 9);
+}
+
+static void
+test_icon_cache (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autofree gchar *cache_path = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
     g_assert_no_error (error);
-    g_assert_nonnull (gadget_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (gadget_snap), ==, SNAPD_SNAP_TYPE_GADGET);
-    g_autoptr(SnapdSnap) os_snap = snapd_client_get_snap_sync (client, "os", NULL, &error);
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_null (snapd_client_get_icon_cache_path (client));
+    snapd_client_set_icon_cache_path (client, cache_path);
+    g_assert_cmpstr (snapd_client_get_icon_cache_path (client), ==, cache_path);
+
+    g_autoptr(SnapdIcon) icon1 = snapd_client_get_icon2_sync (client, "snap", "1", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (os_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (os_snap), ==, SNAPD_SNAP_TYPE_OS);
-    g_autoptr(SnapdSnap) core_snap = snapd_client_get_snap_sync (client, "core", NULL, &error);
+    g_assert_nonnull (icon1);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+
+    // Second request is read from disk
+    g_autoptr(SnapdIcon) icon2 = snapd_client_get_icon2_sync (client, "snap", "1", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (core_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (core_snap), ==, SNAPD_SNAP_TYPE_CORE);
-    g_autoptr(SnapdSnap) base_snap = snapd_client_get_snap_sync (client, "base", NULL, &error);
+    g_assert_nonnull (icon2);
+    g_assert_cmpstr (snapd_icon_get_mime_type (icon2), ==, "image/png");
+    GBytes *data = snapd_icon_get_data (icon2);
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "ICON-DATA", 9);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+
+    // A new revision replaces the stored icon
+    g_autoptr(SnapdIcon) icon3 = snapd_client_get_icon2_sync (client, "snap", "2", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (base_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (base_snap), ==, SNAPD_SNAP_TYPE_BASE);
-    g_autoptr(SnapdSnap) snapd_snap = snapd_client_get_snap_sync (client, "snapd", NULL, &error);
+    g_assert_nonnull (icon3);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+    g_autofree gchar *old_path = g_build_filename (cache_path, "snap", "1.icon", NULL);
+    g_assert_false (g_file_test (old_path, G_FILE_TEST_EXISTS));
+
+    // Only cached icons are removed from the directory
+    g_autofree gchar *other_path = g_build_filename (cache_path, "snap", "notes.txt", NULL);
+    g_assert_true (g_file_set_contents (other_path, "NOTES", -1, &error));
+    g_autoptr(SnapdIcon) icon4 = snapd_client_get_icon2_sync (client, "snap", "3", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snapd_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (snapd_snap), ==, SNAPD_SNAP_TYPE_SNAPD);
-    g_autoptr(SnapdSnap) app_snap = snapd_client_get_snap_sync (client, "app", NULL, &error);
+    g_assert_nonnull (icon4);
+    g_assert_true (g_file_test (other_path, G_FILE_TEST_EXISTS));
+
+    // Names that would leave the cache directory aren't cached
+    g_autoptr(SnapdIcon) icon5 = snapd_client_get_icon2_sync (client, "snap", "../4", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (app_snap);
-    g_assert_cmpint (snapd_snap_get_snap_type (app_snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_nonnull (icon5);
+    g_autofree gchar *outside_path = g_build_filename (cache_path, "4.icon", NULL);
+    g_assert_false (g_file_test (outside_path, G_FILE_TEST_EXISTS));
+    g_autoptr(SnapdIcon) icon6 = snapd_client_get_icon2_sync (client, "snap", ".hidden", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (icon6);
+    g_autofree gchar *new_path = g_build_filename (cache_path, "snap", "3.icon", NULL);
+    g_assert_true (g_file_test (new_path, G_FILE_TEST_EXISTS));
+
+    g_autofree gchar *snap_path = g_build_filename (cache_path, "snap", NULL);
+    g_assert_cmpint (g_unlink (new_path), ==, 0);
+    g_assert_cmpint (g_unlink (other_path), ==, 0);
+    g_assert_cmpint (g_rmdir (snap_path), ==, 0);
+    g_assert_cmpint (g_rmdir (cache_path), ==, 0);
 }
 
 static void
-test_get_snap_optional_fields (void)
+icons_cb (SnapdClient *client, const gchar *name, SnapdIcon *icon, GError *error, gpointer user_data)
+{
+    int *counter = user_data;
+
+    if (g_strcmp0 (name, "snap3") == 0) {
+        g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+        g_assert_null (icon);
+    }
+    else {
+        g_assert_no_error (error);
+        g_assert_nonnull (icon);
+        g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
+    }
+    (*counter)++;
+}
+
+static void
+test_icon_multiple (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *names[] = { "snap1", "snap2", NULL };
+    int counter = 0;
+    g_assert_true (snapd_client_get_icons_sync (client, names, 1, icons_cb, &counter, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_cmpint (counter, ==, 2);
+
+    gchar *names_missing[] = { "snap1", "snap2", "snap3", NULL };
+    counter = 0;
+    g_assert_false (snapd_client_get_icons_sync (client, names_missing, 0, icons_cb, &counter, NULL, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_cmpint (counter, ==, 3);
+}
+
+static void
+icon_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (icon);
+    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
+    GBytes *icon_data = snapd_icon_get_data (icon);
+    g_assert_cmpmem (g_bytes_get_data (icon_data, NULL), g_bytes_get_size (icon_data), "ICON-DATA", 9);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_icon_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
-    mock_app_add_auto_alias (a, "app2");
-    mock_app_add_auto_alias (a, "app3");
-    mock_app_set_desktop_file (a, "/var/lib/snapd/desktop/applications/app.desktop");
-    mock_snap_set_base (s, "BASE");
-    mock_snap_set_broken (s, "BROKEN");
-    mock_snap_set_confinement (s, "classic");
-    mock_snap_set_devmode (s, TRUE);
-    mock_snap_set_install_date (s, "2017-01-02T11:23:58Z");
-    mock_snap_set_installed_size (s, 1024);
-    mock_snap_set_jailmode (s, TRUE);
-    mock_snap_set_trymode (s, TRUE);
-    mock_snap_set_contact (s, "CONTACT");
-    mock_snap_set_website (s, "WEBSITE");
-    mock_snap_set_channel (s, "CHANNEL");
-    mock_snap_set_description (s, "DESCRIPTION");
-    mock_snap_set_license (s, "LICENSE");
-    mock_snap_set_mounted_from (s, "MOUNTED-FROM");
-    mock_snap_set_store_url (s, "https://snapcraft.io/snap");
-    mock_snap_set_summary (s, "SUMMARY");
-    mock_snap_set_tracking_channel (s, "CHANNEL");
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1825,60 +5634,95 @@ test_get_snap_optional_fields (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    snapd_client_get_icon_async (client, "snap", NULL, icon_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_icon_not_installed (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (icon);
+}
+
+static void
+test_icon_large (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    gsize icon_buffer_length = 1048576;
+    g_autofree gchar *icon_buffer = g_malloc (icon_buffer_length);
+    for (gsize i = 0; i < icon_buffer_length; i++)
+        icon_buffer[i] = i % 255;
+    g_autoptr(GBytes) icon_data = g_bytes_new (icon_buffer, icon_buffer_length);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 1);
-    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app");
-    g_assert_null (snapd_app_get_common_id (app));
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_false (snapd_app_get_active (app));
-    g_assert_false (snapd_app_get_enabled (app));
-    g_assert_cmpstr (snapd_app_get_desktop_file (app), ==, "/var/lib/snapd/desktop/applications/app.desktop");
-    g_assert_cmpstr (snapd_snap_get_base (snap), ==, "BASE");
-    g_assert_cmpstr (snapd_snap_get_broken (snap), ==, "BROKEN");
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, "CHANNEL");
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_CLASSIC);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, "CONTACT");
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, "DESCRIPTION");
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_true (snapd_snap_get_devmode (snap));
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 0);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_true (date_matches (snapd_snap_get_install_date (snap), 2017, 1, 2, 11, 23, 58));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 1024);
-    g_assert_true (snapd_snap_get_jailmode (snap));
-    g_assert_cmpstr (snapd_snap_get_license (snap), ==, "LICENSE");
-    g_assert_cmpint (snapd_snap_get_media (snap)->len, ==, 0);
-    g_assert_cmpstr (snapd_snap_get_mounted_from (snap), ==, "MOUNTED-FROM");
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    g_assert_cmpint (snapd_snap_get_prices (snap)->len, ==, 0);
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, "https://snapcraft.io/snap");
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, "SUMMARY");
-    g_assert_cmpstr (snapd_snap_get_tracking_channel (snap), ==, "CHANNEL");
-    g_assert_true (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, "WEBSITE");
+    g_assert_nonnull (icon);
+    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
+    GBytes *data = snapd_icon_get_data (icon);
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), icon_buffer, icon_buffer_length);
+}
+
+static void
+test_get_assertions_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_assertion (snapd,
+                              "type: account\n"
+                              "list-header:\n"
+                              "  - list-value\n"
+                              "map-header:\n"
+                              "  map-value: foo\n"
+                              "\n"
+                              "SIGNATURE");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (assertions);
+    g_assert_cmpint (g_strv_length (assertions), ==, 1);
+    g_assert_cmpstr (assertions[0], ==, "type: account\n"
+                                        "list-header:\n"
+                                        "  - list-value\n"
+                                        "map-header:\n"
+                                        "  map-value: foo\n"
+                                        "\n"
+                                        "SIGNATURE");
 }
 
 static void
-test_get_snap_deprecated_fields (void)
+test_get_assertions_body (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_add_assertion (snapd,
+                              "type: account\n"
+                              "body-length: 4\n"
+                              "\n"
+                              "BODY\n"
+                              "\n"
+                              "SIGNATURE");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1886,23 +5730,37 @@ test_get_snap_deprecated_fields (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpstr (snapd_snap_get_developer (snap), ==, "PUBLISHER-USERNAME");
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_nonnull (assertions);
+    g_assert_cmpint (g_strv_length (assertions), ==, 1);
+    g_assert_cmpstr (assertions[0], ==, "type: account\n"
+                                        "body-length: 4\n"
+                                        "\n"
+                                        "BODY\n"
+                                        "\n"
+                                        "SIGNATURE");
 }
 
 static void
-test_get_snap_common_ids (void)
+test_get_assertions_multiple (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app1");
-    mock_app_set_common_id (a, "ID1");
-    a = mock_snap_add_app (s, "app2");
-    mock_app_set_common_id (a, "ID2");
+    mock_snapd_add_assertion (snapd,
+                              "type: account\n"
+                              "\n"
+                              "SIGNATURE1\n"
+                              "\n"
+                              "type: account\n"
+                              "body-length: 4\n"
+                              "\n"
+                              "BODY\n"
+                              "\n"
+                              "SIGNATURE2\n"
+                              "\n"
+                              "type: account\n"
+                              "\n"
+                              "SIGNATURE3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1910,26 +5768,39 @@ test_get_snap_common_ids (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    GStrv common_ids = snapd_snap_get_common_ids (snap);
-    g_assert_cmpint (g_strv_length (common_ids), ==, 2);
-    g_assert_cmpstr (common_ids[0], ==, "ID1");
-    g_assert_cmpstr (common_ids[1], ==, "ID2");
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 2);
-    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
-    g_assert_cmpstr (snapd_app_get_common_id (app), ==, "ID1");
-    app = snapd_snap_get_apps (snap)->pdata[1];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
-    g_assert_cmpstr (snapd_app_get_common_id (app), ==, "ID2");
+    g_assert_nonnull (assertions);
+    g_assert_cmpint (g_strv_length (assertions), ==, 3);
+    g_assert_cmpstr (assertions[0], ==, "type: account\n"
+                                        "\n"
+                                        "SIGNATURE1");
+    g_assert_cmpstr (assertions[1], ==, "type: account\n"
+                                        "body-length: 4\n"
+                                        "\n"
+                                        "BODY\n"
+                                        "\n"
+                                        "SIGNATURE2");
+    g_assert_cmpstr (assertions[2], ==, "type: account\n"
+                                        "\n"
+                                        "SIGNATURE3");
 }
 
 static void
-test_get_snap_not_installed (void)
+test_get_assertions_bytes (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_assertion (snapd,
+                              "type: account\n"
+                              "\n"
+                              "SIGNATURE1\n"
+                              "\n"
+                              "type: account\n"
+                              "body-length: 4\n"
+                              "\n"
+                              "BODY\n"
+                              "\n"
+                              "SIGNATURE2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1937,17 +5808,52 @@ test_get_snap_not_installed (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
-    g_assert_null (snap);
+    g_autoptr(GPtrArray) assertions = snapd_client_get_assertions_bytes_sync (client, "account", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (assertions);
+    g_assert_cmpint (assertions->len, ==, 2);
+    gsize length;
+    const gchar *data = g_bytes_get_data (g_ptr_array_index (assertions, 0), &length);
+    g_autofree gchar *assertion0 = g_strndup (data, length);
+    g_assert_cmpstr (assertion0, ==, "type: account\n"
+                                     "\n"
+                                     "SIGNATURE1");
+    data = g_bytes_get_data (g_ptr_array_index (assertions, 1), &length);
+    g_autofree gchar *assertion1 = g_strndup (data, length);
+    g_assert_cmpstr (assertion1, ==, "type: account\n"
+                                     "body-length: 4\n"
+                                     "\n"
+                                     "BODY\n"
+                                     "\n"
+                                     "SIGNATURE2");
 }
 
 static void
-test_get_snap_classic_confinement (void)
+get_assertions_stream_cb (SnapdClient *client, SnapdAssertion *assertion, gpointer user_data)
+{
+    GPtrArray *assertions = user_data;
+    g_ptr_array_add (assertions, g_object_ref (assertion));
+}
+
+static void
+test_get_assertions_stream (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_confinement (s, "classic");
+    mock_snapd_add_assertion (snapd,
+                              "type: account\n"
+                              "\n"
+                              "SIGNATURE1\n"
+                              "\n"
+                              "type: account\n"
+                              "body-length: 4\n"
+                              "\n"
+                              "BODY\n"
+                              "\n"
+                              "SIGNATURE2\n"
+                              "\n"
+                              "type: account\n"
+                              "\n"
+                              "SIGNATURE3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1955,18 +5861,34 @@ test_get_snap_classic_confinement (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_autoptr(GPtrArray) assertions = g_ptr_array_new_with_free_func (g_object_unref);
+    g_assert_true (snapd_client_get_assertions_stream_sync (client, "account", get_assertions_stream_cb, assertions, NULL, &error));
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_CLASSIC);
+    g_assert_cmpint (assertions->len, ==, 3);
+    g_autofree gchar *signature0 = snapd_assertion_get_signature (g_ptr_array_index (assertions, 0));
+    g_assert_cmpstr (signature0, ==, "SIGNATURE1");
+    g_autofree gchar *body1 = snapd_assertion_get_body (g_ptr_array_index (assertions, 1));
+    g_assert_cmpstr (body1, ==, "BODY");
+    g_autofree gchar *signature1 = snapd_assertion_get_signature (g_ptr_array_index (assertions, 1));
+    g_assert_cmpstr (signature1, ==, "SIGNATURE2");
+    g_autofree gchar *signature2 = snapd_assertion_get_signature (g_ptr_array_index (assertions, 2));
+    g_assert_cmpstr (signature2, ==, "SIGNATURE3");
 }
 
 static void
-test_get_snap_devmode_confinement (void)
+add_logs (MockSnapd *snapd)
+{
+    mock_snapd_add_log (snapd, "2026-01-02T03:04:05Z", "snap.snap1.app1", "101", "one");
+    mock_snapd_add_log (snapd, "2026-01-02T03:04:06Z", "snap.snap2.app1", "201", "two");
+    mock_snapd_add_log (snapd, "2026-01-02T03:04:07Z", "snap.snap1.app2", "102", "three");
+    mock_snapd_add_log (snapd, "2026-01-02T03:04:08Z", "snap.snap1.app1", "101", "four");
+}
+
+static void
+test_get_logs_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_confinement (s, "devmode");
+    add_logs (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -1974,60 +5896,64 @@ test_get_snap_devmode_confinement (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    char *names[] = { "snap1", NULL };
+    g_autoptr(GPtrArray) logs = snapd_client_get_logs_sync (client, names, 2, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_DEVMODE);
+    g_assert_nonnull (logs);
+    g_assert_cmpint (logs->len, ==, 2);
+    SnapdLog *log = logs->pdata[0];
+    g_assert_true (date_matches (snapd_log_get_timestamp (log), 2026, 1, 2, 3, 4, 7));
+    g_assert_cmpstr (snapd_log_get_sid (log), ==, "snap.snap1.app2");
+    g_assert_cmpstr (snapd_log_get_pid (log), ==, "102");
+    g_assert_cmpstr (snapd_log_get_message (log), ==, "three");
+    g_assert_cmpstr (snapd_log_get_message (logs->pdata[1]), ==, "four");
+
+    char *unknown_names[] = { "snap3", NULL };
+    g_autoptr(GPtrArray) unknown_logs = snapd_client_get_logs_sync (client, unknown_names, 0, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (unknown_logs);
 }
 
 static void
-test_get_snap_daemons (void)
+follow_logs_cb (SnapdClient *client, SnapdLog *log, gpointer user_data)
+{
+    GPtrArray *logs = user_data;
+    g_ptr_array_add (logs, g_object_ref (log));
+}
+
+static void
+test_follow_logs (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app1");
-    mock_app_set_daemon (a, "simple");
-    a = mock_snap_add_app (s, "app2");
-    mock_app_set_daemon (a, "forking");
-    a = mock_snap_add_app (s, "app3");
-    mock_app_set_daemon (a, "oneshot");
-    a = mock_snap_add_app (s, "app4");
-    mock_app_set_daemon (a, "notify");
-    a = mock_snap_add_app (s, "app5");
-    mock_app_set_daemon (a, "dbus");
-    a = mock_snap_add_app (s, "app6");
-    mock_app_set_daemon (a, "INVALID");
+    add_logs (snapd);
+    for (int i = 0; i < 1000; i++)
+        mock_snapd_add_log (snapd, "2026-01-02T03:05:00Z", "snap.snap2.app1", "201", "repeated");
+
+    /* Records arrive split across chunks */
+    mock_snapd_set_endpoint_bandwidth (snapd, "/v2/logs", 1000000);
+    mock_snapd_set_endpoint_chunked (snapd, "/v2/logs", TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_use_io_thread (client, TRUE);
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_autoptr(GPtrArray) logs = g_ptr_array_new_with_free_func (g_object_unref);
+    g_assert_true (snapd_client_follow_logs_sync (client, NULL, -1, follow_logs_cb, logs, NULL, &error));
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_apps (snap)->len, ==, 6);
-    SnapdApp *app = snapd_snap_get_apps (snap)->pdata[0];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
-    app = snapd_snap_get_apps (snap)->pdata[1];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_FORKING);
-    app = snapd_snap_get_apps (snap)->pdata[2];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_ONESHOT);
-    app = snapd_snap_get_apps (snap)->pdata[3];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NOTIFY);
-    app = snapd_snap_get_apps (snap)->pdata[4];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_DBUS);
-    app = snapd_snap_get_apps (snap)->pdata[5];
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_UNKNOWN);
+    g_assert_cmpint (logs->len, ==, 1004);
+    g_assert_cmpstr (snapd_log_get_message (logs->pdata[0]), ==, "one");
+    g_assert_cmpstr (snapd_log_get_sid (logs->pdata[1]), ==, "snap.snap2.app1");
+    g_assert_cmpstr (snapd_log_get_message (logs->pdata[3]), ==, "four");
+    g_assert_cmpstr (snapd_log_get_message (logs->pdata[1003]), ==, "repeated");
 }
 
 static void
-test_get_snap_publisher_starred (void)
+test_get_assertions_invalid (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_publisher_validation (s, "starred");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2035,18 +5961,15 @@ test_get_snap_publisher_starred (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_STARRED);
+    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_null (assertions);
 }
 
 static void
-test_get_snap_publisher_verified (void)
+test_add_assertions_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_publisher_validation (s, "verified");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2054,18 +5977,23 @@ test_get_snap_publisher_verified (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_null (mock_snapd_get_assertions (snapd));
+    gchar *assertions[2];
+    assertions[0] = "type: account\n"
+                    "\n"
+                    "SIGNATURE";
+    assertions[1] = NULL;
+    gboolean result = snapd_client_add_assertions_sync (client, assertions, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_VERIFIED);
+    g_assert_true (result);
+    g_assert_cmpint (g_list_length (mock_snapd_get_assertions (snapd)), == , 1);
+    g_assert_cmpstr (mock_snapd_get_assertions (snapd)->data, == , "type: account\n\nSIGNATURE");
 }
 
 static void
-test_get_snap_publisher_unproven (void)
+test_add_assertions_stream (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_publisher_validation (s, "unproven");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2073,205 +6001,439 @@ test_get_snap_publisher_unproven (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_null (mock_snapd_get_assertions (snapd));
+    const gchar *assertion = "type: account\n"
+                             "\n"
+                             "SIGNATURE";
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data (assertion, strlen (assertion), NULL);
+    gboolean result = snapd_client_add_assertions_stream_sync (client, stream, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNPROVEN);
+    g_assert_true (result);
+    g_assert_cmpint (g_list_length (mock_snapd_get_assertions (snapd)), == , 1);
+    g_assert_cmpstr (mock_snapd_get_assertions (snapd)->data, == , "type: account\n\nSIGNATURE");
+}
+
+static void
+test_assertions_sync (void)
+{
+    g_autoptr(SnapdAssertion) assertion = snapd_assertion_new ("type: account\n"
+                                                               "authority-id: canonical\n"
+                                                               "\n"
+                                                               "SIGNATURE");
+    g_auto(GStrv) headers = snapd_assertion_get_headers (assertion);
+    g_assert_cmpint (g_strv_length (headers), ==, 2);
+    g_assert_cmpstr (headers[0], ==, "type");
+    g_autofree gchar *type = snapd_assertion_get_header (assertion, "type");
+    g_assert_cmpstr (type, ==, "account");
+    g_assert_cmpstr (headers[1], ==, "authority-id");
+    g_autofree gchar *authority_id = snapd_assertion_get_header (assertion, "authority-id");
+    g_assert_cmpstr (authority_id, ==, "canonical");
+    g_autofree gchar *invalid_header = snapd_assertion_get_header (assertion, "invalid");
+    g_assert_cmpstr (invalid_header, ==, NULL);
+    g_autofree gchar *body = snapd_assertion_get_body (assertion);
+    g_assert_cmpstr (body, ==, NULL);
+    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
+    g_assert_cmpstr (signature, ==, "SIGNATURE");
+}
+
+static void
+test_assertions_body (void)
+{
+    g_autoptr(SnapdAssertion) assertion = snapd_assertion_new ("type: account\n"
+                                                               "body-length: 4\n"
+                                                               "\n"
+                                                               "BODY\n"
+                                                               "\n"
+                                                               "SIGNATURE");
+    g_auto(GStrv) headers = snapd_assertion_get_headers (assertion);
+    g_assert_cmpint (g_strv_length (headers), ==, 2);
+    g_assert_cmpstr (headers[0], ==, "type");
+    g_autofree gchar *type = snapd_assertion_get_header (assertion, "type");
+    g_assert_cmpstr (type, ==, "account");
+    g_assert_cmpstr (headers[1], ==, "body-length");
+    g_autofree gchar *body_length = snapd_assertion_get_header (assertion, "body-length");
+    g_assert_cmpstr (body_length, ==, "4");
+    g_autofree gchar *invalid_header = snapd_assertion_get_header (assertion, "invalid");
+    g_assert_cmpstr (invalid_header, ==, NULL);
+    g_autofree gchar *body = snapd_assertion_get_body (assertion);
+    g_assert_cmpstr (body, ==, "BODY");
+    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
+    g_assert_cmpstr (signature, ==, "SIGNATURE");
 }
 
 static void
-test_get_snap_publisher_unknown_validation (void)
+test_assertions_header_span (void)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_set_publisher_validation (s, "NOT-A-VALIDIATION");
+    g_autoptr(SnapdAssertion) assertion = snapd_assertion_new ("type: account\n"
+                                                               "authority: canonical\n"
+                                                               "authority-id: other\n"
+                                                               "multiline: line1\n"
+                                                               "  line2\n"
+                                                               "\n"
+                                                               "SIGNATURE");
+    gsize length;
+    const gchar *type = snapd_assertion_get_header_span (assertion, "type", &length);
+    g_assert_nonnull (type);
+    g_assert_cmpint (length, ==, 7);
+    g_assert_true (strncmp (type, "account", length) == 0);
+    g_autofree gchar *authority = snapd_assertion_get_header (assertion, "authority");
+    g_assert_cmpstr (authority, ==, "canonical");
+    g_autofree gchar *authority_id = snapd_assertion_get_header (assertion, "authority-id");
+    g_assert_cmpstr (authority_id, ==, "other");
+    g_autofree gchar *multiline = snapd_assertion_get_header (assertion, "multiline");
+    g_assert_cmpstr (multiline, ==, "line1\n  line2");
+    g_assert_null (snapd_assertion_get_header_span (assertion, "auth", &length));
+    g_assert_cmpint (length, ==, 0);
+    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
+    g_assert_cmpstr (signature, ==, "SIGNATURE");
+}
 
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+static void
+test_assertion_store (void)
+{
+    g_autoptr(SnapdAssertionStore) store = snapd_assertion_store_new ();
+    gchar *assertions[3];
+    assertions[0] = "type: account-key\n"
+                    "public-key-sha3-384: KEY1\n"
+                    "name: one\n"
+                    "\n"
+                    "SIGNATURE1";
+    assertions[1] = "type: snap-declaration\n"
+                    "snap-id: ID\n"
+                    "\n"
+                    "SIGNATURE2";
+    assertions[2] = NULL;
+    snapd_assertion_store_add_assertions (store, assertions);
+    g_assert_cmpint (snapd_assertion_store_get_n_assertions (store), ==, 2);
+
+    g_autoptr(SnapdAssertion) key1 = snapd_assertion_store_lookup (store, "account-key", "public-key-sha3-384", "KEY1");
+    g_assert_nonnull (key1);
+    g_autofree gchar *name1 = snapd_assertion_get_header (key1, "name");
+    g_assert_cmpstr (name1, ==, "one");
+    g_assert_null (snapd_assertion_store_lookup (store, "account-key", "public-key-sha3-384", "KEY2"));
+    g_assert_null (snapd_assertion_store_lookup (store, "snap-declaration", "public-key-sha3-384", "KEY1"));
+
+    gchar *path = NULL;
+    int fd = g_file_open_tmp ("snapd-glib-test-XXXXXX", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    g_autoptr(GError) error = NULL;
+    g_assert_true (snapd_assertion_store_save (store, path, &error));
+    g_assert_no_error (error);
+
+    g_autoptr(SnapdAssertionStore) loaded_store = snapd_assertion_store_new_from_file (path, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (loaded_store);
+    g_assert_cmpint (snapd_assertion_store_get_n_assertions (loaded_store), ==, 2);
+    g_autoptr(SnapdAssertion) declaration = snapd_assertion_store_lookup (loaded_store, "snap-declaration", "snap-id", "ID");
+    g_assert_nonnull (declaration);
+    g_autofree gchar *signature = snapd_assertion_get_signature (declaration);
+    g_assert_cmpstr (signature, ==, "SIGNATURE2");
+
+    // Most recently added assertion is returned, including after saving again
+    snapd_assertion_store_add (loaded_store, "type: account-key\n"
+                                             "public-key-sha3-384: KEY1\n"
+                                             "name: two\n"
+                                             "\n"
+                                             "SIGNATURE3");
+    g_autoptr(SnapdAssertion) key2 = snapd_assertion_store_lookup (loaded_store, "account-key", "public-key-sha3-384", "KEY1");
+    g_autofree gchar *name2 = snapd_assertion_get_header (key2, "name");
+    g_assert_cmpstr (name2, ==, "two");
+    g_assert_true (snapd_assertion_store_save (loaded_store, path, &error));
+    g_assert_no_error (error);
+    g_clear_object (&loaded_store);
+    loaded_store = snapd_assertion_store_new_from_file (path, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snapd_assertion_store_get_n_assertions (loaded_store), ==, 3);
+    g_autoptr(SnapdAssertion) key3 = snapd_assertion_store_lookup (loaded_store, "account-key", "public-key-sha3-384", "KEY1");
+    g_autofree gchar *name3 = snapd_assertion_get_header (key3, "name");
+    g_assert_cmpstr (name3, ==, "two");
+    g_clear_object (&loaded_store);
+
+    unlink (path);
+    g_free (path);
+}
+/* Assertions signed with a 2048 bit RSA key */
+#define TEST_ACCOUNT_KEY \
+    "type: account-key\n" \
+    "authority-id: test-account\n" \
+    "public-key-sha3-384: FbHacIJYX7zWH4vYzq7UGGubiY-mDRK9wN16Kfo5cZLzTPuKPLagPV3bC7yDCvlb\n" \
+    "account-id: test-account\n" \
+    "name: test\n" \
+    "since: 2026-01-01T00:00:00Z\n" \
+    "body-length: 364\n" \
+    "sign-key-sha3-384: FbHacIJYX7zWH4vYzq7UGGubiY-mDRK9wN16Kfo5cZLzTPuKPLagPV3bC7yDCvlb\n" \
+    "\n" \
+    "AZkBDQRqz1D1AQgAwSRFIs6S/InEaDljVHW1hVKCOXC1bQauYN9IydnLMq9bOAAuB/ZBi3G1xbZKSeA2vYrOyA5loTBn+iB0uSmdmCHt+4Fjb/5UZSHE7mUaSV2zXl5l2O5BAzF8jsV7SbEmLV3yv0f/27QIvm1HLKzqNnbE9tl9Q0LQsqP75Av9chp4HZ00A+JjupxJYabxfG3VLHYs1eO2OFDybIPO76Ta5T3arnt/RkIVnPXFsbvo6OUbKxni+LuW+Go87yw4CYqnsbWHQU4Lpl+jHcMhK8Uee7xoriBUk4jS8Z17qwjDVaHEPMuMhodxYbSSFvvMeCtQ3KoFfgYHpAm0ZdCNguEMjwARAQAB\n" \
+    "\n" \
+    "AYkBMwQAAQoAHRYhBOlKwHy2ytihkS5jeqrFI9LQnvEYBQJqz1EFAAoJEKrFI9LQnvEYOJ4IAKQIO3kxfeFzkTzXbQu1905sf2CuD7vb4m/rfKLkWPODmkySxdOqTKrbhc0+R6X7r+/NXmq1xXVwPAgv7iDhsU5QiF18qbGwqUX+BF/x23/T912D1XJouqv/vEqVK/rFZNVdnHQ67zKb7w/ePcdqcWcFRgNgkPlGyIdnv6/62nhH1oCm75C25Br9FKtZzTV8mY7LtTNnst1dZNbftEDeL7LB/nZAaj03A1rtO2Eyh3su2dPXUKGWH3jW/DGz840oo9Ah1clkFxPJMWnZx/eFxMj8chbpoBaRMP8e5yffjl932JvH/h7h56S1dz6Va0I+EAt37DAS2Df/jRp/gB7PNqc="
+
+#define TEST_ACCOUNT_HEADERS(display_name) \
+    "type: account\n" \
+    "authority-id: test-account\n" \
+    "account-id: test-account\n" \
+    "display-name: " display_name "\n" \
+    "timestamp: 2026-06-01T00:00:00Z\n" \
+    "username: test\n" \
+    "validation: unproven\n" \
+    "sign-key-sha3-384: FbHacIJYX7zWH4vYzq7UGGubiY-mDRK9wN16Kfo5cZLzTPuKPLagPV3bC7yDCvlb"
+
+#define TEST_ACCOUNT_SIGNATURE \
+    "AYkBMwQAAQoAHRYhBOlKwHy2ytihkS5jeqrFI9LQnvEYBQJqz1EFAAoJEKrFI9LQnvEYOJ4IAKQIO3kxfeFzkTzXbQu1905sf2CuD7vb4m/rfKLkWPODmkySxdOqTKrbhc0+R6X7r+/NXmq1xXVwPAgv7iDhsU5QiF18qbGwqUX+BF/x23/T912D1XJouqv/vEqVK/rFZNVdnHQ67zKb7w/ePcdqcWcFRgNgkPlGyIdnv6/62nhH1oCm75C25Br9FKtZzTV8mY7LtTNnst1dZNbftEDeL7LB/nZAaj03A1rtO2Eyh3su2dPXUKGWH3jW/DGz840oo9Ah1clkFxPJMWnZx/eFxMj8chbpoBaRMP8e5yffjl932JvH/h7h56S1dz6Va0I+EAt37DAS2Df/jRp/gB7PNqc="
+
+static void
+test_assertion_store_verify (void)
+{
+    g_autoptr(SnapdAssertionStore) store = snapd_assertion_store_new ();
+    g_autoptr(SnapdAssertion) account = snapd_assertion_new (TEST_ACCOUNT_HEADERS ("Test") "\n\n" TEST_ACCOUNT_SIGNATURE);
+    g_autoptr(SnapdAssertion) modified_account = snapd_assertion_new (TEST_ACCOUNT_HEADERS ("Modified") "\n\n" TEST_ACCOUNT_SIGNATURE);
+
+    // Key is not known
+    g_autoptr(GError) error = NULL;
+    g_assert_false (snapd_assertion_store_verify (store, account, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+    g_clear_error (&error);
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_assertion_store_add (store, TEST_ACCOUNT_KEY);
+    gboolean result = snapd_assertion_store_verify (store, account, &error);
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED)) {
+        g_test_skip ("Built without signature verification");
+        return;
+    }
+    g_assert_no_error (error);
+    g_assert_true (result);
 
-    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (client, "snap", NULL, &error);
+    g_assert_false (snapd_assertion_store_verify (store, modified_account, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_clear_error (&error);
+
+    // The first invalid assertion is reported
+    g_autoptr(GPtrArray) assertions = g_ptr_array_new ();
+    for (int i = 0; i < 32; i++)
+        g_ptr_array_add (assertions, i == 20 || i == 30 ? modified_account : account);
+    g_assert_false (snapd_assertion_store_verify_all (store, assertions, NULL, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+    g_assert_true (g_str_has_prefix (error->message, "Assertion 20: "));
+    g_clear_error (&error);
+
+    g_ptr_array_remove_range (assertions, 20, 12);
+    g_assert_true (snapd_assertion_store_verify_all (store, assertions, NULL, &error));
     g_assert_no_error (error);
-    g_assert_nonnull (snap);
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
 }
 
 static void
-setup_get_snap_conf (MockSnapd *snapd)
+setup_get_connections (MockSnapd *snapd)
 {
-    MockSnap *s = mock_snapd_add_snap (snapd, "core");
-    mock_snap_set_conf (s, "string-key", "\"value\"");
-    mock_snap_set_conf (s, "int-key", "42");
-    mock_snap_set_conf (s, "bool-key", "true");
-    mock_snap_set_conf (s, "number-key", "1.25");
-    mock_snap_set_conf (s, "array-key", "[ 1, \"two\", 3.25 ]");
-    mock_snap_set_conf (s, "object-key", "{\"name\": \"foo\", \"value\": 42}");
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot1 = mock_snap_add_slot (snap1, i, "slot1");
+    mock_snap_add_slot (snap1, i, "slot2");
+    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (snap2, i, "auto-plug");
+    mock_snapd_connect (snapd, plug, slot1, FALSE, FALSE);
+    plug = mock_snap_add_plug (snap2, i, "manual-plug");
+    mock_snapd_connect (snapd, plug, slot1, TRUE, FALSE);
+    plug = mock_snap_add_plug (snap2, i, "gadget-plug");
+    mock_snapd_connect (snapd, plug, slot1, FALSE, TRUE);
+    plug = mock_snap_add_plug (snap2, i, "undesired-plug");
+    mock_snapd_connect (snapd, plug, slot1, FALSE, FALSE);
+    mock_snapd_connect (snapd, plug, NULL, TRUE, FALSE);
 }
 
 static void
-check_get_snap_conf_result (GHashTable *conf)
+check_plug_no_attributes (SnapdPlug *plug)
 {
-    g_assert_cmpint (g_hash_table_size (conf), ==, 6);
-    GVariant *value = g_hash_table_lookup (conf, "string-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    value = g_hash_table_lookup (conf, "int-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    value = g_hash_table_lookup (conf, "bool-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = g_hash_table_lookup (conf, "number-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
-    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+    guint length;
+    g_auto(GStrv) attribute_names = snapd_plug_get_attribute_names (plug, &length);
+    g_assert_cmpint (length, ==, 0);
+    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
 }
 
 static void
-test_get_snap_conf_sync (void)
+check_slot_no_attributes (SnapdSlot *slot)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_snap_conf (snapd);
-
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (conf);
-
-    check_get_snap_conf_result (conf);
+    guint length;
+    g_auto(GStrv) attribute_names = snapd_slot_get_attribute_names (slot, &length);
+    g_assert_cmpint (length, ==, 0);
+    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
 }
 
 static void
-get_snap_conf_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+check_connection_no_plug_attributes (SnapdConnection *connection)
 {
-    g_autoptr(AsyncData) data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (conf);
-
-    check_get_snap_conf_result (conf);
-
-    g_main_loop_quit (data->loop);
+    guint length;
+    g_auto(GStrv) attribute_names = snapd_connection_get_plug_attribute_names (connection, &length);
+    g_assert_cmpint (length, ==, 0);
+    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
 }
 
 static void
-test_get_snap_conf_async (void)
+check_connection_no_slot_attributes (SnapdConnection *connection)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_snap_conf (snapd);
-
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    snapd_client_get_snap_conf_async (client, "system", NULL, NULL, get_snap_conf_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    guint length;
+    g_auto(GStrv) attribute_names = snapd_connection_get_slot_attribute_names (connection, &length);
+    g_assert_cmpint (length, ==, 0);
+    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
 }
 
 static void
-test_get_snap_conf_key_filter (void)
+check_get_connections_result (GPtrArray *established, GPtrArray *undesired, GPtrArray *plugs, GPtrArray *slots, gboolean select_all)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "core");
-    mock_snap_set_conf (s, "string-key", "\"value\"");
-    mock_snap_set_conf (s, "int-key", "42");
-    mock_snap_set_conf (s, "bool-key", "true");
+    g_assert_nonnull (established);
+    g_assert_cmpint (established->len, ==, 3);
 
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    SnapdConnection *connection = established->pdata[0];
+    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+    SnapdSlotRef *slot_ref = snapd_connection_get_slot (connection);
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    SnapdPlugRef *plug_ref = snapd_connection_get_plug (connection);
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "auto-plug");
+    check_connection_no_slot_attributes (connection);
+    check_connection_no_plug_attributes (connection);
+    g_assert_false (snapd_connection_get_manual (connection));
+    g_assert_false (snapd_connection_get_gadget (connection));
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    connection = established->pdata[1];
+    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+    slot_ref = snapd_connection_get_slot (connection);
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    plug_ref = snapd_connection_get_plug (connection);
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "manual-plug");
+    check_connection_no_slot_attributes (connection);
+    check_connection_no_plug_attributes (connection);
+    g_assert_true (snapd_connection_get_manual (connection));
+    g_assert_false (snapd_connection_get_gadget (connection));
 
-    gchar *filter_keys[] = { "int-key", NULL };
-    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", filter_keys, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (conf);
-    g_assert_cmpint (g_hash_table_size (conf), ==, 1);
-    GVariant *value = g_hash_table_lookup (conf, "int-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-}
+    connection = established->pdata[2];
+    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+    slot_ref = snapd_connection_get_slot (connection);
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    plug_ref = snapd_connection_get_plug (connection);
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "gadget-plug");
+    check_connection_no_slot_attributes (connection);
+    check_connection_no_plug_attributes (connection);
+    g_assert_false (snapd_connection_get_manual (connection));
+    g_assert_true (snapd_connection_get_gadget (connection));
 
-static void
-test_get_snap_conf_invalid_key (void)
-{
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "core");
-    mock_snap_set_conf (s, "string-key", "\"value\"");
-    mock_snap_set_conf (s, "int-key", "42");
-    mock_snap_set_conf (s, "bool-key", "true");
+    g_assert_nonnull (undesired);
 
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    if (select_all) {
+        g_assert_cmpint (undesired->len, ==, 1);
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+        connection = undesired->pdata[0];
+        g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+        slot_ref = snapd_connection_get_slot (connection);
+        g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+        g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+        plug_ref = snapd_connection_get_plug (connection);
+        g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+        g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "undesired-plug");
+        check_connection_no_slot_attributes (connection);
+        check_connection_no_plug_attributes (connection);
+        g_assert_true (snapd_connection_get_manual (connection));
+        g_assert_false (snapd_connection_get_gadget (connection));
+    }
+    else
+        g_assert_cmpint (undesired->len, ==, 0);
 
-    gchar *filter_keys[] = { "invalid-key", NULL };
-    g_autoptr(GHashTable) conf = snapd_client_get_snap_conf_sync (client, "system", filter_keys, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_OPTION_NOT_FOUND);
-    g_assert_null (conf);
-}
+    g_assert_nonnull (plugs);
+    if (select_all)
+        g_assert_cmpint (plugs->len, ==, 4);
+    else
+        g_assert_cmpint (plugs->len, ==, 3);
+
+    SnapdPlug *plug = plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "auto-plug");
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
+    check_plug_no_attributes (plug);
+    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
+    GPtrArray *connected_slots = snapd_plug_get_connected_slots (plug);
+    g_assert_cmpint (connected_slots->len, ==, 1);
+    slot_ref = connected_slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+
+    plug = plugs->pdata[1];
+    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "manual-plug");
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
+    check_plug_no_attributes (plug);
+    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
+    connected_slots = snapd_plug_get_connected_slots (plug);
+    g_assert_cmpint (connected_slots->len, ==, 1);
+    slot_ref = connected_slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
 
-static GHashTable *
-setup_set_snap_conf (MockSnapd *snapd)
-{
-    mock_snapd_add_snap (snapd, "core");
+    plug = plugs->pdata[2];
+    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "gadget-plug");
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
+    check_plug_no_attributes (plug);
+    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
+    connected_slots = snapd_plug_get_connected_slots (plug);
+    g_assert_cmpint (connected_slots->len, ==, 1);
+    slot_ref = connected_slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
 
-    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
-    g_hash_table_insert (key_values, "string-key", g_variant_new_string ("value"));
-    g_hash_table_insert (key_values, "int-key", g_variant_new_int64 (42));
-    g_hash_table_insert (key_values, "bool-key", g_variant_new_boolean (TRUE));
-    g_hash_table_insert (key_values, "number-key", g_variant_new_double (1.25));
-    g_autoptr(GVariantBuilder) array_builder = g_variant_builder_new (G_VARIANT_TYPE ("av"));
-    g_variant_builder_add (array_builder, "v", g_variant_new_int64 (1));
-    g_variant_builder_add (array_builder, "v", g_variant_new_string ("two"));
-    g_variant_builder_add (array_builder, "v", g_variant_new_double (3.25));
-    g_hash_table_insert (key_values, "array-key", g_variant_builder_end (array_builder));
-    g_autoptr(GVariantBuilder) object_builder = g_variant_builder_new (G_VARIANT_TYPE ("a{sv}"));
-    g_variant_builder_add (object_builder, "{sv}", "name", g_variant_new_string ("foo"));
-    g_variant_builder_add (object_builder, "{sv}", "value", g_variant_new_int64 (42));
-    g_hash_table_insert (key_values, "object-key", g_variant_builder_end (object_builder));
+    if (select_all) {
+        plug = plugs->pdata[3];
+        g_assert_cmpstr (snapd_plug_get_name (plug), ==, "undesired-plug");
+        g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
+        g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
+        check_plug_no_attributes (plug);
+        g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
+        connected_slots = snapd_plug_get_connected_slots (plug);
+        g_assert_cmpint (connected_slots->len, ==, 0);
+    }
 
-    return g_steal_pointer (&key_values);
-}
+    g_assert_nonnull (slots);
+    if (select_all)
+        g_assert_cmpint (slots->len, ==, 2);
+    else
+        g_assert_cmpint (slots->len, ==, 1);
 
-static void
-check_set_snap_conf_result (MockSnapd *snapd)
-{
-    MockSnap *snap = mock_snapd_find_snap (snapd, "core");
-    g_assert_cmpint (mock_snap_get_conf_count (snap), ==, 6);
-    g_assert_cmpstr (mock_snap_get_conf (snap, "string-key"), ==, "\"value\"");
-    g_assert_cmpstr (mock_snap_get_conf (snap, "int-key"), ==, "42");
-    g_assert_cmpstr (mock_snap_get_conf (snap, "bool-key"), ==, "true");
-    g_assert_cmpstr (mock_snap_get_conf (snap, "number-key"), ==, "1.25");
-    g_assert_cmpstr (mock_snap_get_conf (snap, "array-key"), ==, "[1,\"two\",3.25]");
-    g_assert_cmpstr (mock_snap_get_conf (snap, "object-key"), ==, "{\"name\":\"foo\",\"value\":42}");
+    SnapdSlot *slot = slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot1");
+    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface");
+    check_slot_no_attributes (slot);
+    g_assert_cmpstr (snapd_slot_get_label (slot), ==, "LABEL");
+    GPtrArray *connected_plugs = snapd_slot_get_connected_plugs (slot);
+    g_assert_cmpint (connected_plugs->len, ==, 3);
+    plug_ref = connected_plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "auto-plug");
+    plug_ref = connected_plugs->pdata[1];
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "manual-plug");
+    plug_ref = connected_plugs->pdata[2];
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "gadget-plug");
+
+    if (select_all) {
+        slot = slots->pdata[1];
+        g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot2");
+        g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
+        check_slot_no_attributes (slot);
+        connected_plugs = snapd_slot_get_connected_plugs (slot);
+        g_assert_cmpint (connected_plugs->len, ==, 0);
+    }
 }
 
 static void
-test_set_snap_conf_sync (void)
+test_get_connections_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    g_autoptr(GHashTable) key_values = setup_set_snap_conf (snapd);
+    setup_get_connections (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2279,51 +6441,57 @@ test_set_snap_conf_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean r = snapd_client_set_snap_conf_sync (client, "system", key_values, NULL, &error);
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) undesired = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
+    g_assert_true (result);
 
-    check_set_snap_conf_result (snapd);
+    check_get_connections_result (established, undesired, plugs, slots, FALSE);
 }
 
 static void
-set_snap_conf_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+get_connections_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) undesired = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_set_snap_conf_finish (SNAPD_CLIENT (object), result, &error);
+    gboolean r = snapd_client_get_connections2_finish (SNAPD_CLIENT (object), result, &established, &undesired, &plugs, &slots, &error);
     g_assert_no_error (error);
     g_assert_true (r);
 
-    check_set_snap_conf_result (data->snapd);
+    check_get_connections_result (established, undesired, plugs, slots, FALSE);
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_set_snap_conf_async (void)
+test_get_connections_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    g_autoptr(GHashTable) key_values = setup_set_snap_conf (snapd);
-
+    setup_get_connections (snapd);
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_set_snap_conf_async (client, "system", key_values, NULL, set_snap_conf_cb, async_data_new (loop, snapd));
+    snapd_client_get_connections2_async (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, NULL, get_connections_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_set_snap_conf_invalid (void)
+test_get_connections_empty (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_snap (snapd, "core");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2331,25 +6499,32 @@ test_set_snap_conf_invalid (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GHashTable) key_values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
-    g_hash_table_insert (key_values, "string-value", g_variant_new_string ("value"));
-    gboolean r = snapd_client_set_snap_conf_sync (client, "invalid", key_values, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
-    g_assert_false (r);
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) undesired = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+
+    g_assert_nonnull (established);
+    g_assert_cmpint (established->len, ==, 0);
+
+    g_assert_nonnull (undesired);
+    g_assert_cmpint (undesired->len, ==, 0);
+
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
 }
 
 static void
-test_get_apps_sync (void)
+test_get_connections_filter_all (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app1");
-    a = mock_snap_add_app (s, "app2");
-    mock_app_set_desktop_file (a, "foo.desktop");
-    a = mock_snap_add_app (s, "app3");
-    mock_app_set_daemon (a, "simple");
-    mock_app_set_active (a, TRUE);
-    mock_app_set_enabled (a, TRUE);
+    setup_get_connections (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2357,76 +6532,30 @@ test_get_apps_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (apps);
-    g_assert_cmpint (apps->len, ==, 3);
-    SnapdApp *app = apps->pdata[0];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
-    g_assert_false (snapd_app_get_active (app));
-    g_assert_false (snapd_app_get_enabled (app));
-    app = apps->pdata[1];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
-    g_assert_false (snapd_app_get_active (app));
-    g_assert_false (snapd_app_get_enabled (app));
-    app = apps->pdata[2];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app3");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
-    g_assert_true (snapd_app_get_active (app));
-    g_assert_true (snapd_app_get_enabled (app));
-}
-
-static void
-get_apps_cb (GObject *object, GAsyncResult *result, gpointer user_data)
-{
-    g_autoptr(AsyncData) data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_finish (SNAPD_CLIENT (object), result, &error);
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) undesired = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_SELECT_ALL, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (apps);
-    g_assert_cmpint (apps->len, ==, 3);
-    SnapdApp *app = apps->pdata[0];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app1");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
-    g_assert_false (snapd_app_get_active (app));
-    g_assert_false (snapd_app_get_enabled (app));
-    app = apps->pdata[1];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app2");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_NONE);
-    g_assert_false (snapd_app_get_active (app));
-    g_assert_false (snapd_app_get_enabled (app));
-    app = apps->pdata[2];
-    g_assert_cmpstr (snapd_app_get_name (app), ==, "app3");
-    g_assert_cmpstr (snapd_app_get_snap (app), ==, "snap");
-    g_assert_cmpint (snapd_app_get_daemon_type (app), ==, SNAPD_DAEMON_TYPE_SIMPLE);
-    g_assert_true (snapd_app_get_active (app));
-    g_assert_true (snapd_app_get_enabled (app));
+    g_assert_true (result);
 
-    g_main_loop_quit (data->loop);
+    check_get_connections_result (established, undesired, plugs, slots, TRUE);
 }
 
 static void
-test_get_apps_async (void)
+test_get_connections_filter_snap (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app1");
-    a = mock_snap_add_app (s, "app2");
-    mock_app_set_desktop_file (a, "foo.desktop");
-    a = mock_snap_add_app (s, "app3");
-    mock_app_set_daemon (a, "simple");
-    mock_app_set_active (a, TRUE);
-    mock_app_set_enabled (a, TRUE);
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *core = mock_snapd_add_snap (snapd, "core");
+    MockSlot *s = mock_snap_add_slot (core, i, "slot");
+    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
+    MockPlug *plug1 = mock_snap_add_plug (snap1, i, "plug1");
+    mock_snapd_connect (snapd, plug1, s, FALSE, FALSE);
+    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug2 = mock_snap_add_plug (snap2, i, "plug2");
+    mock_snapd_connect (snapd, plug2, s, FALSE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2434,18 +6563,34 @@ test_get_apps_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_apps2_async (client, SNAPD_GET_APPS_FLAGS_NONE, NULL, NULL, get_apps_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, "snap1", NULL, NULL, NULL, &plugs, &slots, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+
+    g_assert_cmpint (plugs->len, ==, 1);
+    SnapdPlug *plug = plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap1");
+    g_assert_cmpint (slots->len, ==, 1);
+    SnapdSlot *slot = slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "core");
 }
 
 static void
-test_get_apps_services (void)
+test_get_connections_filter_interface (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_add_app (s, "app1");
-    MockApp *a = mock_snap_add_app (s, "app2");
-    mock_app_set_daemon (a, "simple");
+    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
+    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
+    MockSnap *core = mock_snapd_add_snap (snapd, "core");
+    MockSlot *slot1 = mock_snap_add_slot (core, i1, "slot1");
+    MockSlot *slot2 = mock_snap_add_slot (core, i2, "slot2");
+    MockSnap *snap = mock_snapd_add_snap (snapd, "snap");
+    MockPlug *plug1 = mock_snap_add_plug (snap, i1, "plug1");
+    MockPlug *plug2 = mock_snap_add_plug (snap, i2, "plug2");
+    mock_snapd_connect (snapd, plug1, slot1, FALSE, FALSE);
+    mock_snapd_connect (snapd, plug2, slot2, FALSE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2453,21 +6598,72 @@ test_get_apps_services (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_SELECT_SERVICES, NULL, NULL, &error);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, "interface1", NULL, NULL, &plugs, &slots, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (apps);
-    g_assert_cmpint (apps->len, ==, 1);
-    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app2");
+    g_assert_true (result);
+
+    g_assert_cmpint (plugs->len, ==, 1);
+    SnapdPlug *plug = plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap");
+    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface1");
+    g_assert_cmpint (slots->len, ==, 1);
+    SnapdSlot *slot = slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "core");
+    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface1");
+}
+
+static gint
+compare_name (gconstpointer a, gconstpointer b)
+{
+    gchar *name_a = *((gchar **) a);
+    gchar *name_b = *((gchar **) b);
+    return strcmp (name_a, name_b);
+}
+
+static GStrv
+sort_names (GStrv value)
+{
+    g_autoptr(GPtrArray) result = g_ptr_array_new ();
+    for (int i = 0; value[i] != NULL; i++)
+        g_ptr_array_add (result, g_strdup (value[i]));
+    g_ptr_array_sort (result, compare_name);
+    g_ptr_array_add (result, NULL);
+
+    return g_steal_pointer ((GStrv *) &result->pdata);
 }
 
 static void
-test_get_apps_filter (void)
+check_names_match (GStrv names, guint names_length, const gchar *expected)
+{
+    g_assert_cmpint (g_strv_length (names), ==, names_length);
+    g_auto(GStrv) expected_names = g_strsplit (expected, ",", -1);
+    g_auto(GStrv) sorted_expected_names = sort_names (expected_names);
+    g_assert_cmpint (g_strv_length (expected_names), ==, names_length);
+    g_auto(GStrv) sorted_names = sort_names (names);
+    for (guint i = 0; i < names_length; i++)
+        g_assert_cmpstr (sorted_names[i], ==, sorted_expected_names[i]);
+}
+
+static void
+test_get_connections_attributes (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
     MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_app (s, "app1");
+    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
+    mock_slot_add_attribute (sl, "slot-string-key", "\"value\"");
+    mock_slot_add_attribute (sl, "slot-int-key", "42");
+    mock_slot_add_attribute (sl, "slot-bool-key", "true");
+    mock_slot_add_attribute (sl, "slot-number-key", "1.25");
     s = mock_snapd_add_snap (snapd, "snap2");
-    mock_snap_add_app (s, "app2");
+    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
+    mock_plug_add_attribute (p, "plug-string-key", "\"value\"");
+    mock_plug_add_attribute (p, "plug-int-key", "42");
+    mock_plug_add_attribute (p, "plug-bool-key", "true");
+    mock_plug_add_attribute (p, "plug-number-key", "1.25");
+    mock_snapd_connect (snapd, p, sl, FALSE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2475,22 +6671,118 @@ test_get_apps_filter (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gchar *filter_snaps[] = { "snap1", NULL };
-    g_autoptr(GPtrArray) apps = snapd_client_get_apps2_sync (client, SNAPD_GET_APPS_FLAGS_NONE, filter_snaps, NULL, &error);
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) undesired = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (apps);
-    g_assert_cmpint (apps->len, ==, 1);
-    g_assert_cmpstr (snapd_app_get_snap (apps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_app_get_name (apps->pdata[0]), ==, "app1");
+    g_assert_true (result);
+
+    g_assert_nonnull (established);
+    g_assert_cmpint (established->len, ==, 1);
+
+    SnapdConnection *connection = established->pdata[0];
+    guint names_length;
+    g_auto(GStrv) plug_attribute_names = snapd_connection_get_plug_attribute_names (connection, &names_length);
+    check_names_match (plug_attribute_names, names_length, "plug-string-key,plug-int-key,plug-bool-key,plug-number-key");
+    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-string-key"));
+    GVariant *value = snapd_connection_get_plug_attribute (connection, "plug-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-int-key"));
+    value = snapd_connection_get_plug_attribute (connection, "plug-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-bool-key"));
+    value = snapd_connection_get_plug_attribute (connection, "plug-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = snapd_connection_get_plug_attribute (connection, "plug-number-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
+    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+    g_assert_false (snapd_connection_has_plug_attribute (connection, "plug-invalid-key"));
+    g_assert_null (snapd_connection_get_plug_attribute (connection, "plug-invalid-key"));
+
+    g_auto(GStrv) slot_attribute_names = snapd_connection_get_slot_attribute_names (connection, &names_length);
+    check_names_match (slot_attribute_names, names_length, "slot-string-key,slot-int-key,slot-bool-key,slot-number-key");
+    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-string-key"));
+    value = snapd_connection_get_slot_attribute (connection, "slot-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-int-key"));
+    value = snapd_connection_get_slot_attribute (connection, "slot-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-bool-key"));
+    value = snapd_connection_get_slot_attribute (connection, "slot-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    value = snapd_connection_get_slot_attribute (connection, "slot-number-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
+    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+    g_assert_false (snapd_connection_has_slot_attribute (connection, "slot-invalid-key"));
+    g_assert_null (snapd_connection_get_slot_attribute (connection, "slot-invalid-key"));
+
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 1);
+
+    SnapdPlug *plug = plugs->pdata[0];
+    g_auto(GStrv) plug_names = snapd_plug_get_attribute_names (plug, &names_length);
+    check_names_match (plug_names, names_length, "plug-string-key,plug-int-key,plug-bool-key,plug-number-key");
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-string-key"));
+    value = snapd_plug_get_attribute (plug, "plug-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-int-key"));
+    value = snapd_plug_get_attribute (plug, "plug-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-bool-key"));
+    value = snapd_plug_get_attribute (plug, "plug-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = snapd_plug_get_attribute (plug, "plug-number-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
+    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+    value = snapd_plug_get_attribute (plug, "plug-invalid-key");
+    g_assert_false (snapd_plug_has_attribute (plug, "plug-invalid-key"));
+    g_assert_null (snapd_plug_get_attribute (plug, "plug-invalid-key"));
+
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 1);
+
+    SnapdSlot *slot = slots->pdata[0];
+    g_auto(GStrv) slot_names = snapd_slot_get_attribute_names (slot, &names_length);
+    check_names_match (slot_names, names_length, "slot-string-key,slot-int-key,slot-bool-key,slot-number-key");
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-string-key"));
+    value = snapd_slot_get_attribute (slot, "slot-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-int-key"));
+    value = snapd_slot_get_attribute (slot, "slot-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-bool-key"));
+    value = snapd_slot_get_attribute (slot, "slot-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = snapd_slot_get_attribute (slot, "slot-number-key");
+    g_assert_nonnull (value);
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
+    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
+    value = snapd_slot_get_attribute (slot, "slot-invalid-key");
+    g_assert_false (snapd_slot_has_attribute (slot, "slot-invalid-key"));
+    g_assert_null (snapd_slot_get_attribute (slot, "slot-invalid-key"));
 }
 
 static void
-test_icon_sync (void)
+test_get_connections_graph (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
-    mock_snap_set_icon_data (s, "image/png", icon_data);
+    setup_get_connections (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2498,39 +6790,106 @@ test_icon_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
+    g_autoptr(GPtrArray) established = NULL;
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, NULL, &plugs, &slots, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (icon);
-    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
-    GBytes *data = snapd_icon_get_data (icon);
-    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "ICON-DATA", 9);
+    g_assert_true (result);
+
+    g_autoptr(SnapdConnectionGraph) graph = snapd_connection_graph_new ();
+    snapd_connection_graph_update (graph, established, plugs, slots);
+    g_assert_cmpint (snapd_connection_graph_get_n_connections (graph), ==, 3);
+    g_assert_nonnull (snapd_connection_graph_lookup_plug (graph, "snap2", "auto-plug"));
+    g_assert_null (snapd_connection_graph_lookup_plug (graph, "snap2", "no-such-plug"));
+    g_assert_nonnull (snapd_connection_graph_lookup_slot (graph, "snap1", "slot2"));
+    g_assert_cmpint (snapd_connection_graph_get_slot_connections (graph, "snap1", "slot1")->len, ==, 3);
+    g_assert_cmpint (snapd_connection_graph_get_slot_connections (graph, "snap1", "slot2")->len, ==, 0);
+    g_assert_cmpint (snapd_connection_graph_get_plug_connections (graph, "snap2", "auto-plug")->len, ==, 1);
+    g_assert_cmpint (snapd_connection_graph_get_snap_connections (graph, "snap1")->len, ==, 3);
+    g_assert_cmpint (snapd_connection_graph_get_interface_connections (graph, "interface")->len, ==, 3);
+    g_assert_cmpint (snapd_connection_graph_get_interface_connections (graph, "no-such-interface")->len, ==, 0);
+    g_assert_cmpint (snapd_connection_graph_get_interface_plugs (graph, "interface")->len, ==, 4);
+    g_assert_cmpint (snapd_connection_graph_get_interface_slots (graph, "interface")->len, ==, 2);
+
+    snapd_connection_graph_connect (graph, "snap2", "auto-plug", "snap1", "slot2");
+    g_assert_cmpint (snapd_connection_graph_get_n_connections (graph), ==, 4);
+    GPtrArray *connections = snapd_connection_graph_get_slot_connections (graph, "snap1", "slot2");
+    g_assert_cmpint (connections->len, ==, 1);
+    SnapdConnection *connection = connections->pdata[0];
+    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
+    g_assert_true (snapd_connection_get_manual (connection));
+    check_connection_no_plug_attributes (connection);
+    g_assert_cmpint (snapd_connection_graph_get_plug_connections (graph, "snap2", "auto-plug")->len, ==, 2);
+
+    snapd_connection_graph_disconnect (graph, "snap2", "manual-plug", "snap1", "slot1");
+    g_assert_cmpint (snapd_connection_graph_get_n_connections (graph), ==, 3);
+    g_assert_cmpint (snapd_connection_graph_get_slot_connections (graph, "snap1", "slot1")->len, ==, 2);
+
+    snapd_connection_graph_disconnect (graph, "snap2", "auto-plug", NULL, NULL);
+    g_assert_cmpint (snapd_connection_graph_get_n_connections (graph), ==, 1);
+    g_assert_cmpint (snapd_connection_graph_get_plug_connections (graph, "snap2", "auto-plug")->len, ==, 0);
+    g_assert_cmpint (snapd_connection_graph_get_snap_connections (graph, "snap2")->len, ==, 1);
 }
 
 static void
-icon_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+setup_get_interfaces (MockSnapd *snapd)
 {
-    g_autoptr(AsyncData) data = user_data;
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot1 = mock_snap_add_slot (snap1, i, "slot1");
+    mock_snap_add_slot (snap1, i, "slot2");
+    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug1 = mock_snap_add_plug (snap2, i, "plug1");
+    mock_snapd_connect (snapd, plug1, slot1, TRUE, FALSE);
+}
 
-    g_autoptr(GError) error = NULL;
-    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (icon);
-    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
-    GBytes *icon_data = snapd_icon_get_data (icon);
-    g_assert_cmpmem (g_bytes_get_data (icon_data, NULL), g_bytes_get_size (icon_data), "ICON-DATA", 9);
+static void
+check_get_interfaces_result (GPtrArray *plugs, GPtrArray *slots)
+{
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 1);
 
-    g_main_loop_quit (data->loop);
+    SnapdPlug *plug = plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "plug1");
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
+    check_plug_no_attributes (plug);
+    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
+    GPtrArray *connected_slots = snapd_plug_get_connected_slots (plug);
+    g_assert_cmpint (connected_slots->len, ==, 1);
+    SnapdSlotRef *slot_ref = connected_slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 2);
+
+    SnapdSlot *slot = slots->pdata[0];
+    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot1");
+    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
+    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface");
+    check_slot_no_attributes (slot);
+    g_assert_cmpstr (snapd_slot_get_label (slot), ==, "LABEL");
+    GPtrArray *connected_plugs = snapd_slot_get_connected_plugs (slot);
+    g_assert_cmpint (connected_plugs->len, ==, 1);
+    SnapdPlugRef *plug_ref = connected_plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
+    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "plug1");
+
+    slot = slots->pdata[1];
+    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot2");
+    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
+    check_slot_no_attributes (slot);
+    connected_plugs = snapd_slot_get_connected_plugs (slot);
+    g_assert_cmpint (connected_plugs->len, ==, 0);
 }
 
 static void
-test_icon_async (void)
+test_get_interfaces_sync (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
-    mock_snap_set_icon_data (s, "image/png", icon_data);
+    setup_get_interfaces (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2538,37 +6897,44 @@ test_icon_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_icon_async (client, "snap", NULL, icon_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_no_error (error);
+    g_assert_true (result);
+
+    check_get_interfaces_result (plugs, slots);
 }
 
 static void
-test_icon_not_installed (void)
+get_interfaces_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(AsyncData) data = user_data;
 
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean r = snapd_client_get_interfaces_finish (SNAPD_CLIENT (object), result, &plugs, &slots, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_no_error (error);
+    g_assert_true (r);
 
-    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
-    g_assert_null (icon);
+    check_get_interfaces_result (plugs, slots);
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_icon_large (void)
+test_get_interfaces_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    gsize icon_buffer_length = 1048576;
-    g_autofree gchar *icon_buffer = g_malloc (icon_buffer_length);
-    for (gsize i = 0; i < icon_buffer_length; i++)
-        icon_buffer[i] = i % 255;
-    g_autoptr(GBytes) icon_data = g_bytes_new (icon_buffer, icon_buffer_length);
-    mock_snap_set_icon_data (s, "image/png", icon_data);
+    setup_get_interfaces (snapd);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2576,26 +6942,16 @@ test_icon_large (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdIcon) icon = snapd_client_get_icon_sync (client, "snap", NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (icon);
-    g_assert_cmpstr (snapd_icon_get_mime_type (icon), ==, "image/png");
-    GBytes *data = snapd_icon_get_data (icon);
-    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), icon_buffer, icon_buffer_length);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    snapd_client_get_interfaces_async (client, NULL, get_interfaces_cb, async_data_new (loop, snapd));
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_main_loop_run (loop);
 }
 
 static void
-test_get_assertions_sync (void)
+test_get_interfaces_no_snaps (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_assertion (snapd,
-                              "type: account\n"
-                              "list-header:\n"
-                              "  - list-value\n"
-                              "map-header:\n"
-                              "  map-value: foo\n"
-                              "\n"
-                              "SIGNATURE");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2603,30 +6959,34 @@ test_get_assertions_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
     g_assert_no_error (error);
-    g_assert_nonnull (assertions);
-    g_assert_cmpint (g_strv_length (assertions), ==, 1);
-    g_assert_cmpstr (assertions[0], ==, "type: account\n"
-                                        "list-header:\n"
-                                        "  - list-value\n"
-                                        "map-header:\n"
-                                        "  map-value: foo\n"
-                                        "\n"
-                                        "SIGNATURE");
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
+    g_assert_true (result);
 }
 
 static void
-test_get_assertions_body (void)
+test_get_interfaces_attributes (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_assertion (snapd,
-                              "type: account\n"
-                              "body-length: 4\n"
-                              "\n"
-                              "BODY\n"
-                              "\n"
-                              "SIGNATURE");
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
+    mock_slot_add_attribute (sl, "slot-string-key", "\"value\"");
+    mock_slot_add_attribute (sl, "slot-int-key", "42");
+    mock_slot_add_attribute (sl, "slot-bool-key", "true");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
+    mock_plug_add_attribute (p, "plug-string-key", "\"value\"");
+    mock_plug_add_attribute (p, "plug-int-key", "42");
+    mock_plug_add_attribute (p, "plug-bool-key", "true");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2634,37 +6994,71 @@ test_get_assertions_body (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
     g_assert_no_error (error);
-    g_assert_nonnull (assertions);
-    g_assert_cmpint (g_strv_length (assertions), ==, 1);
-    g_assert_cmpstr (assertions[0], ==, "type: account\n"
-                                        "body-length: 4\n"
-                                        "\n"
-                                        "BODY\n"
-                                        "\n"
-                                        "SIGNATURE");
+    g_assert_true (result);
+
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 1);
+
+    SnapdPlug *plug = plugs->pdata[0];
+    guint names_length;
+    g_auto(GStrv) plug_names = snapd_plug_get_attribute_names (plug, &names_length);
+    check_names_match (plug_names, names_length, "plug-string-key,plug-int-key,plug-bool-key");
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-string-key"));
+    GVariant *value = snapd_plug_get_attribute (plug, "plug-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-int-key"));
+    value = snapd_plug_get_attribute (plug, "plug-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_plug_has_attribute (plug, "plug-bool-key"));
+    value = snapd_plug_get_attribute (plug, "plug-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = snapd_plug_get_attribute (plug, "plug-invalid-key");
+    g_assert_false (snapd_plug_has_attribute (plug, "plug-invalid-key"));
+    g_assert_null (snapd_plug_get_attribute (plug, "plug-invalid-key"));
+
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 1);
+
+    SnapdSlot *slot = slots->pdata[0];
+    g_auto(GStrv) slot_names = snapd_slot_get_attribute_names (slot, &names_length);
+    check_names_match (slot_names, names_length, "slot-string-key,slot-int-key,slot-bool-key");
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-string-key"));
+    value = snapd_slot_get_attribute (slot, "slot-string-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
+    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-int-key"));
+    value = snapd_slot_get_attribute (slot, "slot-int-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
+    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
+    g_assert_true (snapd_slot_has_attribute (slot, "slot-bool-key"));
+    value = snapd_slot_get_attribute (slot, "slot-bool-key");
+    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
+    g_assert_true (g_variant_get_boolean (value));
+    value = snapd_slot_get_attribute (slot, "slot-invalid-key");
+    g_assert_false (snapd_slot_has_attribute (slot, "slot-invalid-key"));
+    g_assert_null (snapd_slot_get_attribute (slot, "slot-invalid-key"));
 }
 
 static void
-test_get_assertions_multiple (void)
+test_get_interfaces_legacy (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_assertion (snapd,
-                              "type: account\n"
-                              "\n"
-                              "SIGNATURE1\n"
-                              "\n"
-                              "type: account\n"
-                              "body-length: 4\n"
-                              "\n"
-                              "BODY\n"
-                              "\n"
-                              "SIGNATURE2\n"
-                              "\n"
-                              "type: account\n"
-                              "\n"
-                              "SIGNATURE3");
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
+    mock_snap_add_slot (s, i, "slot2");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
+    mock_snapd_connect (snapd, p, sl, TRUE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2672,44 +7066,58 @@ test_get_assertions_multiple (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
+    g_autoptr(GPtrArray) plugs = NULL;
+    g_autoptr(GPtrArray) slots = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
     g_assert_no_error (error);
-    g_assert_nonnull (assertions);
-    g_assert_cmpint (g_strv_length (assertions), ==, 3);
-    g_assert_cmpstr (assertions[0], ==, "type: account\n"
-                                        "\n"
-                                        "SIGNATURE1");
-    g_assert_cmpstr (assertions[1], ==, "type: account\n"
-                                        "body-length: 4\n"
-                                        "\n"
-                                        "BODY\n"
-                                        "\n"
-                                        "SIGNATURE2");
-    g_assert_cmpstr (assertions[2], ==, "type: account\n"
-                                        "\n"
-                                        "SIGNATURE3");
-}
+    g_assert_true (result);
 
-static void
-test_get_assertions_invalid (void)
-{
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 1);
 
-    g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    SnapdPlug *plug = plugs->pdata[0];
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    GPtrArray *connections = snapd_plug_get_connections (plug);
+    g_assert_cmpint (connections->len, ==, 1);
+    SnapdConnection *connection = connections->pdata[0];
+    g_assert_cmpstr (snapd_connection_get_snap (connection), ==, "snap1");
+    g_assert_cmpstr (snapd_connection_get_name (connection), ==, "slot1");
+G_GNUC_END_IGNORE_DEPRECATIONS
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 2);
 
-    g_auto(GStrv) assertions = snapd_client_get_assertions_sync (client, "account", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
-    g_assert_null (assertions);
+    SnapdSlot *slot = slots->pdata[0];
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    connections = snapd_slot_get_connections (slot);
+    g_assert_cmpint (connections->len, ==, 1);
+    connection = connections->pdata[0];
+    g_assert_cmpstr (snapd_connection_get_snap (connection), ==, "snap2");
+    g_assert_cmpstr (snapd_connection_get_name (connection), ==, "plug1");
+G_GNUC_END_IGNORE_DEPRECATIONS
+
+    slot = slots->pdata[1];
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    connections = snapd_slot_get_connections (slot);
+    g_assert_cmpint (connections->len, ==, 0);
+G_GNUC_END_IGNORE_DEPRECATIONS
 }
 
 static void
-test_add_assertions_sync (void)
+test_get_interfaces2_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
+    mock_interface_set_summary (i1, "summary1");
+    mock_interface_set_doc_url (i1, "url1");
+    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
+    mock_interface_set_summary (i2, "summary2");
+    mock_interface_set_doc_url (i2, "url2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_plug (s, i1, "plug1");
+    mock_snap_add_slot (s, i2, "slot1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2717,280 +7125,174 @@ test_add_assertions_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_get_assertions (snapd));
-    gchar *assertions[2];
-    assertions[0] = "type: account\n"
-                    "\n"
-                    "SIGNATURE";
-    assertions[1] = NULL;
-    gboolean result = snapd_client_add_assertions_sync (client, assertions, NULL, &error);
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_cmpint (g_list_length (mock_snapd_get_assertions (snapd)), == , 1);
-    g_assert_cmpstr (mock_snapd_get_assertions (snapd)->data, == , "type: account\n\nSIGNATURE");
-}
 
-static void
-test_assertions_sync (void)
-{
-    g_autoptr(SnapdAssertion) assertion = snapd_assertion_new ("type: account\n"
-                                                               "authority-id: canonical\n"
-                                                               "\n"
-                                                               "SIGNATURE");
-    g_auto(GStrv) headers = snapd_assertion_get_headers (assertion);
-    g_assert_cmpint (g_strv_length (headers), ==, 2);
-    g_assert_cmpstr (headers[0], ==, "type");
-    g_autofree gchar *type = snapd_assertion_get_header (assertion, "type");
-    g_assert_cmpstr (type, ==, "account");
-    g_assert_cmpstr (headers[1], ==, "authority-id");
-    g_autofree gchar *authority_id = snapd_assertion_get_header (assertion, "authority-id");
-    g_assert_cmpstr (authority_id, ==, "canonical");
-    g_autofree gchar *invalid_header = snapd_assertion_get_header (assertion, "invalid");
-    g_assert_cmpstr (invalid_header, ==, NULL);
-    g_autofree gchar *body = snapd_assertion_get_body (assertion);
-    g_assert_cmpstr (body, ==, NULL);
-    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
-    g_assert_cmpstr (signature, ==, "SIGNATURE");
-}
+    g_assert_nonnull (ifaces);
+    g_assert_cmpint (ifaces->len, ==, 2);
 
-static void
-test_assertions_body (void)
-{
-    g_autoptr(SnapdAssertion) assertion = snapd_assertion_new ("type: account\n"
-                                                               "body-length: 4\n"
-                                                               "\n"
-                                                               "BODY\n"
-                                                               "\n"
-                                                               "SIGNATURE");
-    g_auto(GStrv) headers = snapd_assertion_get_headers (assertion);
-    g_assert_cmpint (g_strv_length (headers), ==, 2);
-    g_assert_cmpstr (headers[0], ==, "type");
-    g_autofree gchar *type = snapd_assertion_get_header (assertion, "type");
-    g_assert_cmpstr (type, ==, "account");
-    g_assert_cmpstr (headers[1], ==, "body-length");
-    g_autofree gchar *body_length = snapd_assertion_get_header (assertion, "body-length");
-    g_assert_cmpstr (body_length, ==, "4");
-    g_autofree gchar *invalid_header = snapd_assertion_get_header (assertion, "invalid");
-    g_assert_cmpstr (invalid_header, ==, NULL);
-    g_autofree gchar *body = snapd_assertion_get_body (assertion);
-    g_assert_cmpstr (body, ==, "BODY");
-    g_autofree gchar *signature = snapd_assertion_get_signature (assertion);
-    g_assert_cmpstr (signature, ==, "SIGNATURE");
-}
+    SnapdInterface *iface = ifaces->pdata[0];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
+    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary1");
+    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url1");
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
 
-static void
-setup_get_connections (MockSnapd *snapd)
-{
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot1 = mock_snap_add_slot (snap1, i, "slot1");
-    mock_snap_add_slot (snap1, i, "slot2");
-    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (snap2, i, "auto-plug");
-    mock_snapd_connect (snapd, plug, slot1, FALSE, FALSE);
-    plug = mock_snap_add_plug (snap2, i, "manual-plug");
-    mock_snapd_connect (snapd, plug, slot1, TRUE, FALSE);
-    plug = mock_snap_add_plug (snap2, i, "gadget-plug");
-    mock_snapd_connect (snapd, plug, slot1, FALSE, TRUE);
-    plug = mock_snap_add_plug (snap2, i, "undesired-plug");
-    mock_snapd_connect (snapd, plug, slot1, FALSE, FALSE);
-    mock_snapd_connect (snapd, plug, NULL, TRUE, FALSE);
+    iface = ifaces->pdata[1];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
+    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary2");
+    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url2");
+    plugs = snapd_interface_get_plugs (iface);
+    slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
 }
 
 static void
-check_plug_no_attributes (SnapdPlug *plug)
+get_interfaces2_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    guint length;
-    g_auto(GStrv) attribute_names = snapd_plug_get_attribute_names (plug, &length);
-    g_assert_cmpint (length, ==, 0);
-    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
-}
+    g_autoptr(AsyncData) data = user_data;
 
-static void
-check_slot_no_attributes (SnapdSlot *slot)
-{
-    guint length;
-    g_auto(GStrv) attribute_names = snapd_slot_get_attribute_names (slot, &length);
-    g_assert_cmpint (length, ==, 0);
-    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
-}
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_finish (SNAPD_CLIENT (object), result, &error);
 
-static void
-check_connection_no_plug_attributes (SnapdConnection *connection)
-{
-    guint length;
-    g_auto(GStrv) attribute_names = snapd_connection_get_plug_attribute_names (connection, &length);
-    g_assert_cmpint (length, ==, 0);
-    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
-}
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces);
 
-static void
-check_connection_no_slot_attributes (SnapdConnection *connection)
-{
-    guint length;
-    g_auto(GStrv) attribute_names = snapd_connection_get_slot_attribute_names (connection, &length);
-    g_assert_cmpint (length, ==, 0);
-    g_assert_cmpint (g_strv_length (attribute_names), ==, 0);
+    g_assert_cmpint (ifaces->len, ==, 2);
+
+    SnapdInterface *iface = ifaces->pdata[0];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
+    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary1");
+    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url1");
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
+
+    iface = ifaces->pdata[1];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
+    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary2");
+    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url2");
+    plugs = snapd_interface_get_plugs (iface);
+    slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-check_get_connections_result (GPtrArray *established, GPtrArray *undesired, GPtrArray *plugs, GPtrArray *slots, gboolean select_all)
+test_get_interfaces2_async (void)
 {
-    g_assert_nonnull (established);
-    g_assert_cmpint (established->len, ==, 3);
-
-    SnapdConnection *connection = established->pdata[0];
-    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
-    SnapdSlotRef *slot_ref = snapd_connection_get_slot (connection);
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
-    SnapdPlugRef *plug_ref = snapd_connection_get_plug (connection);
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "auto-plug");
-    check_connection_no_slot_attributes (connection);
-    check_connection_no_plug_attributes (connection);
-    g_assert_false (snapd_connection_get_manual (connection));
-    g_assert_false (snapd_connection_get_gadget (connection));
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    connection = established->pdata[1];
-    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
-    slot_ref = snapd_connection_get_slot (connection);
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
-    plug_ref = snapd_connection_get_plug (connection);
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "manual-plug");
-    check_connection_no_slot_attributes (connection);
-    check_connection_no_plug_attributes (connection);
-    g_assert_true (snapd_connection_get_manual (connection));
-    g_assert_false (snapd_connection_get_gadget (connection));
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
+    mock_interface_set_summary (i1, "summary1");
+    mock_interface_set_doc_url (i1, "url1");
+    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
+    mock_interface_set_summary (i2, "summary2");
+    mock_interface_set_doc_url (i2, "url2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_plug (s, i1, "plug1");
+    mock_snap_add_slot (s, i2, "slot1");
 
-    connection = established->pdata[2];
-    g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
-    slot_ref = snapd_connection_get_slot (connection);
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
-    plug_ref = snapd_connection_get_plug (connection);
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "gadget-plug");
-    check_connection_no_slot_attributes (connection);
-    check_connection_no_plug_attributes (connection);
-    g_assert_false (snapd_connection_get_manual (connection));
-    g_assert_true (snapd_connection_get_gadget (connection));
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_assert_nonnull (undesired);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    if (select_all) {
-        g_assert_cmpint (undesired->len, ==, 1);
+    snapd_client_get_interfaces2_async (client, SNAPD_GET_INTERFACES_FLAGS_NONE, NULL, NULL, get_interfaces2_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
 
-        connection = undesired->pdata[0];
-        g_assert_cmpstr (snapd_connection_get_interface (connection), ==, "interface");
-        slot_ref = snapd_connection_get_slot (connection);
-        g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-        g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
-        plug_ref = snapd_connection_get_plug (connection);
-        g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-        g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "undesired-plug");
-        check_connection_no_slot_attributes (connection);
-        check_connection_no_plug_attributes (connection);
-        g_assert_true (snapd_connection_get_manual (connection));
-        g_assert_false (snapd_connection_get_gadget (connection));
-    }
-    else
-        g_assert_cmpint (undesired->len, ==, 0);
+static void
+test_get_interfaces2_only_connected (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface1");
+    mock_snapd_add_interface (snapd, "interface2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *p = mock_snap_add_plug (s, i, "plug2");
+    mock_snapd_connect (snapd, p, sl, TRUE, FALSE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_ONLY_CONNECTED, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces);
+
+    g_assert_cmpint (ifaces->len, ==, 1);
+
+    SnapdInterface *iface = ifaces->pdata[0];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
     g_assert_nonnull (plugs);
-    if (select_all)
-        g_assert_cmpint (plugs->len, ==, 4);
-    else
-        g_assert_cmpint (plugs->len, ==, 3);
+    g_assert_cmpint (plugs->len, ==, 0);
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
+}
 
-    SnapdPlug *plug = plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "auto-plug");
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
-    check_plug_no_attributes (plug);
-    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
-    GPtrArray *connected_slots = snapd_plug_get_connected_slots (plug);
-    g_assert_cmpint (connected_slots->len, ==, 1);
-    slot_ref = connected_slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+static void
+test_get_interfaces2_slots (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_slot (s, i, "slot1");
+    mock_snap_add_plug (s, i, "plug1");
 
-    plug = plugs->pdata[1];
-    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "manual-plug");
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
-    check_plug_no_attributes (plug);
-    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
-    connected_slots = snapd_plug_get_connected_slots (plug);
-    g_assert_cmpint (connected_slots->len, ==, 1);
-    slot_ref = connected_slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    plug = plugs->pdata[2];
-    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "gadget-plug");
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
-    check_plug_no_attributes (plug);
-    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
-    connected_slots = snapd_plug_get_connected_slots (plug);
-    g_assert_cmpint (connected_slots->len, ==, 1);
-    slot_ref = connected_slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    if (select_all) {
-        plug = plugs->pdata[3];
-        g_assert_cmpstr (snapd_plug_get_name (plug), ==, "undesired-plug");
-        g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
-        g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
-        check_plug_no_attributes (plug);
-        g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
-        connected_slots = snapd_plug_get_connected_slots (plug);
-        g_assert_cmpint (connected_slots->len, ==, 0);
-    }
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_INCLUDE_SLOTS, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces);
 
-    g_assert_nonnull (slots);
-    if (select_all)
-        g_assert_cmpint (slots->len, ==, 2);
-    else
-        g_assert_cmpint (slots->len, ==, 1);
+    g_assert_cmpint (ifaces->len, ==, 1);
 
+    SnapdInterface *iface = ifaces->pdata[0];
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 1);
     SnapdSlot *slot = slots->pdata[0];
     g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot1");
     g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface");
-    check_slot_no_attributes (slot);
-    g_assert_cmpstr (snapd_slot_get_label (slot), ==, "LABEL");
-    GPtrArray *connected_plugs = snapd_slot_get_connected_plugs (slot);
-    g_assert_cmpint (connected_plugs->len, ==, 3);
-    plug_ref = connected_plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "auto-plug");
-    plug_ref = connected_plugs->pdata[1];
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "manual-plug");
-    plug_ref = connected_plugs->pdata[2];
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "gadget-plug");
-
-    if (select_all) {
-        slot = slots->pdata[1];
-        g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot2");
-        g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
-        check_slot_no_attributes (slot);
-        connected_plugs = snapd_slot_get_connected_plugs (slot);
-        g_assert_cmpint (connected_plugs->len, ==, 0);
-    }
 }
 
 static void
-test_get_connections_sync (void)
+test_get_interfaces2_plugs (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_connections (snapd);
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_slot (s, i, "slot1");
+    mock_snap_add_plug (s, i, "plug1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -2998,57 +7300,110 @@ test_get_connections_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) established = NULL;
-    g_autoptr(GPtrArray) undesired = NULL;
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_INCLUDE_PLUGS, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
+    g_assert_nonnull (ifaces);
 
-    check_get_connections_result (established, undesired, plugs, slots, FALSE);
+    g_assert_cmpint (ifaces->len, ==, 1);
+
+    SnapdInterface *iface = ifaces->pdata[0];
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 1);
+    SnapdPlug *plug = plugs->pdata[0];
+    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "plug1");
+    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap1");
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
 }
 
 static void
-get_connections_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_get_interfaces2_filter (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_interface (snapd, "interface1");
+    mock_snapd_add_interface (snapd, "interface2");
 
-    g_autoptr(GPtrArray) established = NULL;
-    g_autoptr(GPtrArray) undesired = NULL;
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_get_connections2_finish (SNAPD_CLIENT (object), result, &established, &undesired, &plugs, &slots, &error);
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gchar *filter_names[] = { "interface2", NULL };
+    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter_names, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
+    g_assert_nonnull (ifaces);
 
-    check_get_connections_result (established, undesired, plugs, slots, FALSE);
+    g_assert_cmpint (ifaces->len, ==, 1);
 
-    g_main_loop_quit (data->loop);
+    SnapdInterface *iface = ifaces->pdata[0];
+    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
+    GPtrArray *plugs = snapd_interface_get_plugs (iface);
+    g_assert_nonnull (plugs);
+    g_assert_cmpint (plugs->len, ==, 0);
+    GPtrArray *slots = snapd_interface_get_slots (iface);
+    g_assert_nonnull (slots);
+    g_assert_cmpint (slots->len, ==, 0);
 }
 
 static void
-test_get_connections_async (void)
+test_get_interfaces2_cache_docs (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_connections (snapd);
+    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
+    mock_interface_set_summary (i1, "summary1");
+    mock_interface_set_doc_url (i1, "url1");
+    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
+    mock_interface_set_summary (i2, "summary2");
+    mock_interface_set_doc_url (i2, "url2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_plug (s, i1, "plug1");
+
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_cache_interface_docs (client, TRUE);
+    g_assert_true (snapd_client_get_cache_interface_docs (client));
 
-    snapd_client_get_connections2_async (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, NULL, get_connections_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    SnapdGetInterfacesFlags flags = SNAPD_GET_INTERFACES_FLAGS_INCLUDE_DOCS | SNAPD_GET_INTERFACES_FLAGS_INCLUDE_PLUGS;
+    g_autoptr(GPtrArray) ifaces1 = snapd_client_get_interfaces2_sync (client, flags, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces1);
+    g_assert_cmpint (ifaces1->len, ==, 2);
+    g_assert_cmpstr (snapd_interface_get_summary (ifaces1->pdata[0]), ==, "summary1");
+    g_assert_cmpint (snapd_interface_get_plugs (ifaces1->pdata[0])->len, ==, 1);
+
+    /* Documentation comes from the cache, plugs from snapd */
+    mock_interface_set_summary (i1, "changed-summary");
+    mock_snap_add_plug (s, i1, "plug2");
+    g_autoptr(GPtrArray) ifaces2 = snapd_client_get_interfaces2_sync (client, flags, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces2);
+    g_assert_cmpint (ifaces2->len, ==, 2);
+    g_assert_cmpstr (snapd_interface_get_summary (ifaces2->pdata[0]), ==, "summary1");
+    g_assert_cmpstr (snapd_interface_get_doc_url (ifaces2->pdata[0]), ==, "url1");
+    g_assert_cmpint (snapd_interface_get_plugs (ifaces2->pdata[0])->len, ==, 2);
+    g_assert_cmpstr (snapd_interface_get_summary (ifaces2->pdata[1]), ==, "summary2");
+
+    snapd_client_clear_cache (client);
+    g_autoptr(GPtrArray) ifaces3 = snapd_client_get_interfaces2_sync (client, flags, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces3);
+    g_assert_cmpstr (snapd_interface_get_summary (ifaces3->pdata[0]), ==, "changed-summary");
 }
 
 static void
-test_get_connections_empty (void)
+test_get_interfaces2_make_label (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_interface (snapd, "camera");
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface-without-translation");
+    mock_interface_set_summary (i, "SUMMARY");
+    mock_snapd_add_interface (snapd, "interface-without-summary");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3056,32 +7411,86 @@ test_get_connections_empty (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) established = NULL;
-    g_autoptr(GPtrArray) undesired = NULL;
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
+    gchar *filter1[] = { "camera", NULL };
+    g_autoptr(GPtrArray) ifaces1 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter1, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces1);
+    g_assert_cmpint (ifaces1->len, ==, 1);
+    SnapdInterface *iface1 = ifaces1->pdata[0];
+    g_autofree gchar *label1 = snapd_interface_make_label (iface1);
+    g_assert_cmpstr (label1, ==, "Use your camera"); // FIXME: Won't work if translated
+
+    gchar *filter2[] = { "interface-without-translation", NULL };
+    g_autoptr(GPtrArray) ifaces2 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter2, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces2);
+    g_assert_cmpint (ifaces2->len, ==, 1);
+    SnapdInterface *iface2 = ifaces2->pdata[0];
+    g_autofree gchar *label2 = snapd_interface_make_label (iface2);
+    g_assert_cmpstr (label2, ==, "interface-without-translation: SUMMARY");
+
+    gchar *filter3[] = { "interface-without-summary", NULL };
+    g_autoptr(GPtrArray) ifaces3 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter3, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (ifaces3);
+    g_assert_cmpint (ifaces3->len, ==, 1);
+    SnapdInterface *iface3 = ifaces3->pdata[0];
+    g_autofree gchar *label3 = snapd_interface_make_label (iface3);
+    g_assert_cmpstr (label3, ==, "interface-without-summary");
+}
+
+static void
+test_connect_interface_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug) == slot);
+}
 
-    g_assert_nonnull (established);
-    g_assert_cmpint (established->len, ==, 0);
+static void
+connect_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
 
-    g_assert_nonnull (undesired);
-    g_assert_cmpint (undesired->len, ==, 0);
+    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap1");
+    MockSlot *slot = mock_snap_find_slot (s, "slot");
+    s = mock_snapd_find_snap (data->snapd, "snap2");
+    MockPlug *plug = mock_snap_find_plug (s, "plug");
 
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_connect_interface_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_true (mock_snapd_find_plug_connection (data->snapd, plug) == slot);
 
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_connections_filter_all (void)
+test_connect_interface_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_connections (snapd);
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_add_plug (s, i, "plug");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3089,30 +7498,31 @@ test_get_connections_filter_all (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) established = NULL;
-    g_autoptr(GPtrArray) undesired = NULL;
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_SELECT_ALL, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
+    snapd_client_connect_interface_async (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, connect_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
 
-    check_get_connections_result (established, undesired, plugs, slots, TRUE);
+typedef struct
+{
+    int progress_done;
+} ConnectInterfaceProgressData;
+
+static void
+connect_interface_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    ConnectInterfaceProgressData *data = user_data;
+    data->progress_done++;
 }
 
 static void
-test_get_connections_filter_snap (void)
+test_connect_interface_progress (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *core = mock_snapd_add_snap (snapd, "core");
-    MockSlot *s = mock_snap_add_slot (core, i, "slot");
-    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
-    MockPlug *plug1 = mock_snap_add_plug (snap1, i, "plug1");
-    mock_snapd_connect (snapd, plug1, s, FALSE, FALSE);
-    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug2 = mock_snap_add_plug (snap2, i, "plug2");
-    mock_snapd_connect (snapd, plug2, s, FALSE, FALSE);
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3120,34 +7530,19 @@ test_get_connections_filter_snap (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, "snap1", NULL, NULL, NULL, &plugs, &slots, NULL, &error);
+    ConnectInterfaceProgressData connect_interface_progress_data;
+    connect_interface_progress_data.progress_done = 0;
+    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", connect_interface_progress_cb, &connect_interface_progress_data, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
-
-    g_assert_cmpint (plugs->len, ==, 1);
-    SnapdPlug *plug = plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap1");
-    g_assert_cmpint (slots->len, ==, 1);
-    SnapdSlot *slot = slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "core");
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug) == slot);
+    g_assert_cmpint (connect_interface_progress_data.progress_done, >, 0);
 }
 
 static void
-test_get_connections_filter_interface (void)
+test_connect_interface_invalid (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
-    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
-    MockSnap *core = mock_snapd_add_snap (snapd, "core");
-    MockSlot *slot1 = mock_snap_add_slot (core, i1, "slot1");
-    MockSlot *slot2 = mock_snap_add_slot (core, i2, "slot2");
-    MockSnap *snap = mock_snapd_add_snap (snapd, "snap");
-    MockPlug *plug1 = mock_snap_add_plug (snap, i1, "plug1");
-    MockPlug *plug2 = mock_snap_add_plug (snap, i2, "plug2");
-    mock_snapd_connect (snapd, plug1, slot1, FALSE, FALSE);
-    mock_snapd_connect (snapd, plug2, slot2, FALSE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3155,72 +7550,41 @@ test_get_connections_filter_interface (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, "interface1", NULL, NULL, &plugs, &slots, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-
-    g_assert_cmpint (plugs->len, ==, 1);
-    SnapdPlug *plug = plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap");
-    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface1");
-    g_assert_cmpint (slots->len, ==, 1);
-    SnapdSlot *slot = slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "core");
-    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface1");
-}
-
-static gint
-compare_name (gconstpointer a, gconstpointer b)
-{
-    gchar *name_a = *((gchar **) a);
-    gchar *name_b = *((gchar **) b);
-    return strcmp (name_a, name_b);
+    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_false (result);
 }
 
-static GStrv
-sort_names (GStrv value)
+static void
+add_plug_slot_pair (GPtrArray *plugs, GPtrArray *slots, const gchar *plug_snap, const gchar *plug_name, const gchar *slot_snap, const gchar *slot_name)
 {
-    g_autoptr(GPtrArray) result = g_ptr_array_new ();
-    for (int i = 0; value[i] != NULL; i++)
-        g_ptr_array_add (result, g_strdup (value[i]));
-    g_ptr_array_sort (result, compare_name);
-    g_ptr_array_add (result, NULL);
-
-    return g_steal_pointer ((GStrv *) &result->pdata);
+    g_ptr_array_add (plugs, g_object_new (SNAPD_TYPE_PLUG_REF, "snap", plug_snap, "plug", plug_name, NULL));
+    g_ptr_array_add (slots, g_object_new (SNAPD_TYPE_SLOT_REF, "snap", slot_snap, "slot", slot_name, NULL));
 }
 
 static void
-check_names_match (GStrv names, guint names_length, const gchar *expected)
+connect_interfaces_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
 {
-    g_assert_cmpint (g_strv_length (names), ==, names_length);
-    g_auto(GStrv) expected_names = g_strsplit (expected, ",", -1);
-    g_auto(GStrv) sorted_expected_names = sort_names (expected_names);
-    g_assert_cmpint (g_strv_length (expected_names), ==, names_length);
-    g_auto(GStrv) sorted_names = sort_names (names);
-    for (guint i = 0; i < names_length; i++)
-        g_assert_cmpstr (sorted_names[i], ==, sorted_expected_names[i]);
+    int *progress_done = user_data;
+    g_assert_cmpstr (snapd_change_get_kind (change), ==, "connect");
+    g_assert_cmpint (snapd_change_get_tasks (change)->len, >, 0);
+    (*progress_done)++;
 }
 
 static void
-test_get_connections_attributes (void)
+test_connect_interfaces_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockInterface *i = mock_snapd_add_interface (snapd, "interface");
     MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
-    mock_slot_add_attribute (sl, "slot-string-key", "\"value\"");
-    mock_slot_add_attribute (sl, "slot-int-key", "42");
-    mock_slot_add_attribute (sl, "slot-bool-key", "true");
-    mock_slot_add_attribute (sl, "slot-number-key", "1.25");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
     s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
-    mock_plug_add_attribute (p, "plug-string-key", "\"value\"");
-    mock_plug_add_attribute (p, "plug-int-key", "42");
-    mock_plug_add_attribute (p, "plug-bool-key", "true");
-    mock_plug_add_attribute (p, "plug-number-key", "1.25");
-    mock_snapd_connect (snapd, p, sl, FALSE, FALSE);
+    MockPlug *plug1 = mock_snap_add_plug (s, i, "plug1");
+    MockPlug *plug2 = mock_snap_add_plug (s, i, "plug2");
+    s = mock_snapd_add_snap (snapd, "snap3");
+    MockSlot *slot3 = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap4");
+    MockPlug *plug4 = mock_snap_add_plug (s, i, "plug");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3228,171 +7592,139 @@ test_get_connections_attributes (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) established = NULL;
-    g_autoptr(GPtrArray) undesired = NULL;
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-    gboolean result = snapd_client_get_connections2_sync (client, SNAPD_GET_CONNECTIONS_FLAGS_NONE, NULL, NULL, &established, &undesired, &plugs, &slots, NULL, &error);
+    g_autoptr(GPtrArray) plugs = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GPtrArray) slots = g_ptr_array_new_with_free_func (g_object_unref);
+    add_plug_slot_pair (plugs, slots, "snap2", "plug1", "snap1", "slot");
+    add_plug_slot_pair (plugs, slots, "snap2", "plug2", "snap1", "slot");
+    add_plug_slot_pair (plugs, slots, "snap4", "plug", "snap3", "slot");
+    int progress_done = 0;
+    gboolean result = snapd_client_connect_interfaces_sync (client, plugs, slots, connect_interfaces_progress_cb, &progress_done, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug1) == slot);
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug2) == slot);
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug4) == slot3);
+    g_assert_cmpint (progress_done, >, 0);
 
-    g_assert_nonnull (established);
-    g_assert_cmpint (established->len, ==, 1);
+    result = snapd_client_disconnect_interfaces_sync (client, plugs, slots, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_null (mock_snapd_find_plug_connection (snapd, plug1));
+    g_assert_null (mock_snapd_find_plug_connection (snapd, plug2));
+    g_assert_null (mock_snapd_find_plug_connection (snapd, plug4));
+}
 
-    SnapdConnection *connection = established->pdata[0];
-    guint names_length;
-    g_auto(GStrv) plug_attribute_names = snapd_connection_get_plug_attribute_names (connection, &names_length);
-    check_names_match (plug_attribute_names, names_length, "plug-string-key,plug-int-key,plug-bool-key,plug-number-key");
-    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-string-key"));
-    GVariant *value = snapd_connection_get_plug_attribute (connection, "plug-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-int-key"));
-    value = snapd_connection_get_plug_attribute (connection, "plug-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_connection_has_plug_attribute (connection, "plug-bool-key"));
-    value = snapd_connection_get_plug_attribute (connection, "plug-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = snapd_connection_get_plug_attribute (connection, "plug-number-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
-    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
-    g_assert_false (snapd_connection_has_plug_attribute (connection, "plug-invalid-key"));
-    g_assert_null (snapd_connection_get_plug_attribute (connection, "plug-invalid-key"));
+static void
+test_connect_interfaces_invalid (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
 
-    g_auto(GStrv) slot_attribute_names = snapd_connection_get_slot_attribute_names (connection, &names_length);
-    check_names_match (slot_attribute_names, names_length, "slot-string-key,slot-int-key,slot-bool-key,slot-number-key");
-    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-string-key"));
-    value = snapd_connection_get_slot_attribute (connection, "slot-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-int-key"));
-    value = snapd_connection_get_slot_attribute (connection, "slot-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_connection_has_slot_attribute (connection, "slot-bool-key"));
-    value = snapd_connection_get_slot_attribute (connection, "slot-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    value = snapd_connection_get_slot_attribute (connection, "slot-number-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
-    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
-    g_assert_false (snapd_connection_has_slot_attribute (connection, "slot-invalid-key"));
-    g_assert_null (snapd_connection_get_slot_attribute (connection, "slot-invalid-key"));
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 1);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    SnapdPlug *plug = plugs->pdata[0];
-    g_auto(GStrv) plug_names = snapd_plug_get_attribute_names (plug, &names_length);
-    check_names_match (plug_names, names_length, "plug-string-key,plug-int-key,plug-bool-key,plug-number-key");
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-string-key"));
-    value = snapd_plug_get_attribute (plug, "plug-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-int-key"));
-    value = snapd_plug_get_attribute (plug, "plug-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-bool-key"));
-    value = snapd_plug_get_attribute (plug, "plug-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = snapd_plug_get_attribute (plug, "plug-number-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
-    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
-    value = snapd_plug_get_attribute (plug, "plug-invalid-key");
-    g_assert_false (snapd_plug_has_attribute (plug, "plug-invalid-key"));
-    g_assert_null (snapd_plug_get_attribute (plug, "plug-invalid-key"));
+    g_autoptr(GPtrArray) plugs = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GPtrArray) slots = g_ptr_array_new_with_free_func (g_object_unref);
+    add_plug_slot_pair (plugs, slots, "snap2", "no-such-plug", "snap1", "slot");
+    add_plug_slot_pair (plugs, slots, "snap2", "plug", "snap1", "slot");
+    gboolean result = snapd_client_connect_interfaces_sync (client, plugs, slots, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_false (result);
+    g_assert_true (mock_snapd_find_plug_connection (snapd, plug) == slot);
+}
+
+static void
+test_disconnect_interface_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
+    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
 
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 1);
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    SnapdSlot *slot = slots->pdata[0];
-    g_auto(GStrv) slot_names = snapd_slot_get_attribute_names (slot, &names_length);
-    check_names_match (slot_names, names_length, "slot-string-key,slot-int-key,slot-bool-key,slot-number-key");
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-string-key"));
-    value = snapd_slot_get_attribute (slot, "slot-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-int-key"));
-    value = snapd_slot_get_attribute (slot, "slot-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-bool-key"));
-    value = snapd_slot_get_attribute (slot, "slot-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = snapd_slot_get_attribute (slot, "slot-number-key");
-    g_assert_nonnull (value);
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_DOUBLE));
-    g_assert_cmpfloat (g_variant_get_double (value), ==, 1.25);
-    value = snapd_slot_get_attribute (slot, "slot-invalid-key");
-    g_assert_false (snapd_slot_has_attribute (slot, "slot-invalid-key"));
-    g_assert_null (snapd_slot_get_attribute (slot, "slot-invalid-key"));
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_null (mock_snapd_find_plug_connection (snapd, plug));
 }
 
 static void
-setup_get_interfaces (MockSnapd *snapd)
+disconnect_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *snap1 = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot1 = mock_snap_add_slot (snap1, i, "slot1");
-    mock_snap_add_slot (snap1, i, "slot2");
-    MockSnap *snap2 = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug1 = mock_snap_add_plug (snap2, i, "plug1");
-    mock_snapd_connect (snapd, plug1, slot1, TRUE, FALSE);
+    g_autoptr(AsyncData) data = user_data;
+
+    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap2");
+    MockPlug *plug = mock_snap_find_plug (s, "plug");
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_connect_interface_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_null (mock_snapd_find_plug_connection (data->snapd, plug));
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-check_get_interfaces_result (GPtrArray *plugs, GPtrArray *slots)
+test_disconnect_interface_async (void)
 {
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 1);
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    SnapdPlug *plug = plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "plug1");
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_get_interface (plug), ==, "interface");
-    check_plug_no_attributes (plug);
-    g_assert_cmpstr (snapd_plug_get_label (plug), ==, "LABEL");
-    GPtrArray *connected_slots = snapd_plug_get_connected_slots (plug);
-    g_assert_cmpint (connected_slots->len, ==, 1);
-    SnapdSlotRef *slot_ref = connected_slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_ref_get_snap (slot_ref), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_ref_get_slot (slot_ref), ==, "slot1");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
+    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
 
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 2);
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    SnapdSlot *slot = slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot1");
-    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
-    g_assert_cmpstr (snapd_slot_get_interface (slot), ==, "interface");
-    check_slot_no_attributes (slot);
-    g_assert_cmpstr (snapd_slot_get_label (slot), ==, "LABEL");
-    GPtrArray *connected_plugs = snapd_slot_get_connected_plugs (slot);
-    g_assert_cmpint (connected_plugs->len, ==, 1);
-    SnapdPlugRef *plug_ref = connected_plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_ref_get_snap (plug_ref), ==, "snap2");
-    g_assert_cmpstr (snapd_plug_ref_get_plug (plug_ref), ==, "plug1");
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    slot = slots->pdata[1];
-    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot2");
-    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
-    check_slot_no_attributes (slot);
-    connected_plugs = snapd_slot_get_connected_plugs (slot);
-    g_assert_cmpint (connected_plugs->len, ==, 0);
+    snapd_client_disconnect_interface_async (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, disconnect_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
 }
 
+typedef struct
+{
+    int progress_done;
+} DisconnectInterfaceProgressData;
+
 static void
-test_get_interfaces_sync (void)
+disconnect_interface_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    DisconnectInterfaceProgressData *data = user_data;
+    data->progress_done++;
+}
+
+static void
+test_disconnect_interface_progress (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_interfaces (snapd);
+    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
+    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3400,96 +7732,226 @@ test_get_interfaces_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    DisconnectInterfaceProgressData disconnect_interface_progress_data;
+    disconnect_interface_progress_data.progress_done = 0;
+    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", disconnect_interface_progress_cb, &disconnect_interface_progress_data, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
+    g_assert_null (mock_snapd_find_plug_connection (snapd, plug));
+    g_assert_cmpint (disconnect_interface_progress_data.progress_done, >, 0);
+}
 
-    check_get_interfaces_result (plugs, slots);
+static void
+test_disconnect_interface_invalid (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_false (result);
 }
 
 static void
-get_interfaces_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_find_query (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_suggested_currency (snapd, "NZD");
+    mock_snapd_add_store_snap (snapd, "apple");
+    mock_snapd_add_store_snap (snapd, "banana");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "carrot1");
+    mock_track_add_channel (mock_snap_add_track (s, "latest"), "stable", NULL);
+    s = mock_snapd_add_store_snap (snapd, "carrot2");
+    mock_track_add_channel (mock_snap_add_track (s, "latest"), "stable", NULL);
+    mock_snap_set_channel (s, "CHANNEL");
+    mock_snap_set_contact (s, "CONTACT");
+    mock_snap_set_website (s, "WEBSITE");
+    mock_snap_set_description (s, "DESCRIPTION");
+    mock_snap_set_store_url (s, "https://snapcraft.io/snap");
+    mock_snap_set_summary (s, "SUMMARY");
+    mock_snap_set_download_size (s, 1024);
+    mock_snap_add_price (s, 1.25, "NZD");
+    mock_snap_add_price (s, 0.75, "USD");
+    mock_snap_add_media (s, "screenshot", "screenshot0.png", 0, 0);
+    mock_snap_add_media (s, "screenshot", "screenshot1.png", 1024, 1024);
+    mock_snap_add_media (s, "banner", "banner.png", 0, 0);
+    mock_snap_set_trymode (s, TRUE);
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
     g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autofree gchar *suggested_currency = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "carrot", &suggested_currency, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (suggested_currency, ==, "NZD");
+    SnapdSnap *snap = snaps->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "carrot1");
+    g_assert_null (snapd_snap_get_channel (snap));
+    GStrv tracks = snapd_snap_get_tracks (snap);
+    g_assert_cmpint (g_strv_length (tracks), ==, 1);
+    g_assert_cmpstr (tracks[0], ==, "latest");
+    GPtrArray *channels = snapd_snap_get_channels (snap);
+    g_assert_cmpint (channels->len, ==, 1);
+    SnapdChannel *channel = channels->pdata[0];
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "REVISION");
+    g_assert_cmpstr (snapd_channel_get_version (channel), ==, "VERSION");
+    g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "0");
+    g_assert_cmpint (snapd_channel_get_size (channel), ==, 65535);
+    g_assert_null (snapd_snap_get_contact (snap));
+    g_assert_null (snapd_snap_get_description (snap));
+    g_assert_null (snapd_snap_get_store_url (snap));
+    g_assert_null (snapd_snap_get_summary (snap));
+    snap = snaps->pdata[1];
+    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, "CHANNEL");
+    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
+    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, "CONTACT");
+    g_assert_cmpstr (snapd_snap_get_description (snap), ==, "DESCRIPTION");
+    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
+    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
+    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
+    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
+    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 1024);
+    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
+    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
+    g_assert_null (snapd_snap_get_install_date (snap));
+    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
+    GPtrArray *media = snapd_snap_get_media (snap);
+    g_assert_cmpint (media->len, ==, 3);
+    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[0]), ==, "screenshot");
+    g_assert_cmpstr (snapd_media_get_url (media->pdata[0]), ==, "screenshot0.png");
+    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[1]), ==, "screenshot");
+    g_assert_cmpstr (snapd_media_get_url (media->pdata[1]), ==, "screenshot1.png");
+    g_assert_cmpint (snapd_media_get_width (media->pdata[1]), ==, 1024);
+    g_assert_cmpint (snapd_media_get_height (media->pdata[1]), ==, 1024);
+    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[2]), ==, "banner");
+    g_assert_cmpstr (snapd_media_get_url (media->pdata[2]), ==, "banner.png");
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "carrot2");
+    GPtrArray *prices = snapd_snap_get_prices (snap);
+    g_assert_cmpint (prices->len, ==, 2);
+    g_assert_cmpfloat (snapd_price_get_amount (prices->pdata[0]), ==, 1.25);
+    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[0]), ==, "NZD");
+    g_assert_cmpfloat (snapd_price_get_amount (prices->pdata[1]), ==, 0.75);
+    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[1]), ==, "USD");
+    g_assert_false (snapd_snap_get_private (snap));
+    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
 G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean r = snapd_client_get_interfaces_finish (SNAPD_CLIENT (object), result, &plugs, &slots, &error);
+    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
 G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
+    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
+    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, "https://snapcraft.io/snap");
+    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, "SUMMARY");
+    g_assert_true (snapd_snap_get_trymode (snap));
+    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
+    g_assert_cmpstr (snapd_snap_get_website (snap), ==, "WEBSITE");
+}
 
+static void
+find_coalesce_check (GObject *object, GAsyncResult *result, AsyncData *data, const gchar *name)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (SNAPD_CLIENT (object), result, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, name);
 
-    check_get_interfaces_result (plugs, slots);
+    data->counter--;
+    if (data->counter == 0) {
+        g_assert_cmpint (mock_snapd_get_request_count (data->snapd), ==, 2);
+        g_main_loop_quit (data->loop);
+        async_data_free (data);
+    }
+}
 
-    g_main_loop_quit (data->loop);
+static void
+find_coalesce_apple_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    find_coalesce_check (object, result, user_data, "apple");
 }
 
 static void
-test_get_interfaces_async (void)
+find_coalesce_banana_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    find_coalesce_check (object, result, user_data, "banana");
+}
+
+static void
+test_find_query_coalesce (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    setup_get_interfaces (snapd);
+    mock_snapd_add_store_snap (snapd, "apple");
+    mock_snapd_add_store_snap (snapd, "banana");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_coalesce_requests (client, TRUE);
 
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    snapd_client_get_interfaces_async (client, NULL, get_interfaces_cb, async_data_new (loop, snapd));
-G_GNUC_END_IGNORE_DEPRECATIONS
+    // Requests that only differ in their query are not combined
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 2;
+    snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, "apple", NULL, find_coalesce_apple_cb, data);
+    snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, "banana", NULL, find_coalesce_banana_cb, data);
     g_main_loop_run (loop);
 }
 
 static void
-test_get_interfaces_no_snaps (void)
+test_find_query_cache (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "apple");
+    mock_snapd_add_store_snap (snapd, "banana");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_cache_ttl (client, "/v2/find", 60000);
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    // Responses are cached per query
+    g_autoptr(GPtrArray) snaps1 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "apple", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
-    g_assert_true (result);
+    g_assert_cmpint (snaps1->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps1->pdata[0]), ==, "apple");
+    g_autoptr(GPtrArray) snaps2 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "banana", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps2->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps2->pdata[0]), ==, "banana");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+
+    g_autoptr(GPtrArray) snaps3 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "apple", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps3->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps3->pdata[0]), ==, "apple");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+    g_assert_cmpint (snapd_client_get_cache_hits (client), ==, 1);
 }
 
 static void
-test_get_interfaces_attributes (void)
+test_find_query_private (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
-    mock_slot_add_attribute (sl, "slot-string-key", "\"value\"");
-    mock_slot_add_attribute (sl, "slot-int-key", "42");
-    mock_slot_add_attribute (sl, "slot-bool-key", "true");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
-    mock_plug_add_attribute (p, "plug-string-key", "\"value\"");
-    mock_plug_add_attribute (p, "plug-int-key", "42");
-    mock_plug_add_attribute (p, "plug-bool-key", "true");
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_account_add_private_snap (a, "snap2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3497,71 +7959,23 @@ test_get_interfaces_attributes (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 1);
-
-    SnapdPlug *plug = plugs->pdata[0];
-    guint names_length;
-    g_auto(GStrv) plug_names = snapd_plug_get_attribute_names (plug, &names_length);
-    check_names_match (plug_names, names_length, "plug-string-key,plug-int-key,plug-bool-key");
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-string-key"));
-    GVariant *value = snapd_plug_get_attribute (plug, "plug-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-int-key"));
-    value = snapd_plug_get_attribute (plug, "plug-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_plug_has_attribute (plug, "plug-bool-key"));
-    value = snapd_plug_get_attribute (plug, "plug-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = snapd_plug_get_attribute (plug, "plug-invalid-key");
-    g_assert_false (snapd_plug_has_attribute (plug, "plug-invalid-key"));
-    g_assert_null (snapd_plug_get_attribute (plug, "plug-invalid-key"));
-
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 1);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-    SnapdSlot *slot = slots->pdata[0];
-    g_auto(GStrv) slot_names = snapd_slot_get_attribute_names (slot, &names_length);
-    check_names_match (slot_names, names_length, "slot-string-key,slot-int-key,slot-bool-key");
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-string-key"));
-    value = snapd_slot_get_attribute (slot, "slot-string-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_STRING));
-    g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "value");
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-int-key"));
-    value = snapd_slot_get_attribute (slot, "slot-int-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_INT64));
-    g_assert_cmpint (g_variant_get_int64 (value), ==, 42);
-    g_assert_true (snapd_slot_has_attribute (slot, "slot-bool-key"));
-    value = snapd_slot_get_attribute (slot, "slot-bool-key");
-    g_assert_true (g_variant_is_of_type (value, G_VARIANT_TYPE_BOOLEAN));
-    g_assert_true (g_variant_get_boolean (value));
-    value = snapd_slot_get_attribute (slot, "slot-invalid-key");
-    g_assert_false (snapd_slot_has_attribute (slot, "slot-invalid-key"));
-    g_assert_null (snapd_slot_get_attribute (slot, "slot-invalid-key"));
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap2");
+    g_assert_true (snapd_snap_get_private (snaps->pdata[0]));
 }
 
 static void
-test_get_interfaces_legacy (void)
+test_find_query_private_not_logged_in (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
-    mock_snap_add_slot (s, i, "slot2");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *p = mock_snap_add_plug (s, i, "plug1");
-    mock_snapd_connect (snapd, p, sl, TRUE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3569,147 +7983,118 @@ test_get_interfaces_legacy (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) plugs = NULL;
-    g_autoptr(GPtrArray) slots = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean result = snapd_client_get_interfaces_sync (client, &plugs, &slots, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_no_error (error);
-    g_assert_true (result);
-
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 1);
-
-    SnapdPlug *plug = plugs->pdata[0];
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    GPtrArray *connections = snapd_plug_get_connections (plug);
-    g_assert_cmpint (connections->len, ==, 1);
-    SnapdConnection *connection = connections->pdata[0];
-    g_assert_cmpstr (snapd_connection_get_snap (connection), ==, "snap1");
-    g_assert_cmpstr (snapd_connection_get_name (connection), ==, "slot1");
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
+    g_assert_null (snaps);
+}
 
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 2);
+static void
+find_parse_thread_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
 
-    SnapdSlot *slot = slots->pdata[0];
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    connections = snapd_slot_get_connections (slot);
-    g_assert_cmpint (connections->len, ==, 1);
-    connection = connections->pdata[0];
-    g_assert_cmpstr (snapd_connection_get_snap (connection), ==, "snap2");
-    g_assert_cmpstr (snapd_connection_get_name (connection), ==, "plug1");
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 100);
 
-    slot = slots->pdata[1];
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    connections = snapd_slot_get_connections (slot);
-    g_assert_cmpint (connections->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    data->counter--;
+    if (data->counter == 0) {
+        g_main_loop_quit (data->loop);
+        async_data_free (data);
+    }
 }
 
 static void
-test_get_interfaces2_sync (void)
+test_find_parse_thread (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
-    mock_interface_set_summary (i1, "summary1");
-    mock_interface_set_doc_url (i1, "url1");
-    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
-    mock_interface_set_summary (i2, "summary2");
-    mock_interface_set_doc_url (i2, "url2");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_plug (s, i1, "plug1");
-    mock_snap_add_slot (s, i2, "slot1");
+    for (int i = 0; i < 100; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%03d", i);
+        mock_snapd_add_store_snap (snapd, name);
+    }
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_parse_thread_threshold (client), ==, 0);
+    snapd_client_set_parse_thread_threshold (client, 1);
+    g_assert_cmpint (snapd_client_get_parse_thread_threshold (client), ==, 1);
 
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, NULL, NULL, &error);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
     g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 100);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap000");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[99]), ==, "snap099");
 
-    g_assert_nonnull (ifaces);
-    g_assert_cmpint (ifaces->len, ==, 2);
+    // Errors are parsed in the worker thread too
+    g_autoptr(GPtrArray) bad_snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap?", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_QUERY);
+    g_assert_null (bad_snaps);
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
-    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary1");
-    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url1");
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    for (int i = 0; i < 3; i++)
+        snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, find_parse_thread_cb, data);
+    g_main_loop_run (loop);
+}
 
-    iface = ifaces->pdata[1];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
-    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary2");
-    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url2");
-    plugs = snapd_interface_get_plugs (iface);
-    slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+static void
+find_stream_snap_cb (SnapdClient *client, SnapdSnap *snap, gpointer user_data)
+{
+    GPtrArray *snaps = user_data;
+    g_ptr_array_add (snaps, g_object_ref (snap));
 }
 
 static void
-get_interfaces2_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_find_stream (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    for (int i = 0; i < 100; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%03d", i);
+        mock_snapd_add_store_snap (snapd, name);
+    }
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_finish (SNAPD_CLIENT (object), result, &error);
-
-    g_assert_no_error (error);
-    g_assert_nonnull (ifaces);
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_assert_cmpint (ifaces->len, ==, 2);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
-    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary1");
-    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url1");
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    g_autoptr(GPtrArray) snaps = g_ptr_array_new_with_free_func (g_object_unref);
+    g_assert_true (snapd_client_find_stream_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap", find_stream_snap_cb, snaps, NULL, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 100);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap000");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[99]), ==, "snap099");
 
-    iface = ifaces->pdata[1];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
-    g_assert_cmpstr (snapd_interface_get_summary (iface), ==, "summary2");
-    g_assert_cmpstr (snapd_interface_get_doc_url (iface), ==, "url2");
-    plugs = snapd_interface_get_plugs (iface);
-    slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    // Snaps parsed in a worker thread are delivered before the call completes
+    snapd_client_set_parse_thread_threshold (client, 1);
+    g_ptr_array_set_size (snaps, 0);
+    g_assert_true (snapd_client_find_stream_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap", find_stream_snap_cb, snaps, NULL, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_cmpint (snaps->len, ==, 100);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[99]), ==, "snap099");
 
-    g_main_loop_quit (data->loop);
+    g_ptr_array_set_size (snaps, 0);
+    g_assert_false (snapd_client_find_stream_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap?", find_stream_snap_cb, snaps, NULL, NULL, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_QUERY);
+    g_assert_cmpint (snaps->len, ==, 0);
 }
 
 static void
-test_get_interfaces2_async (void)
+test_find_fields (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i1 = mock_snapd_add_interface (snapd, "interface1");
-    mock_interface_set_summary (i1, "summary1");
-    mock_interface_set_doc_url (i1, "url1");
-    MockInterface *i2 = mock_snapd_add_interface (snapd, "interface2");
-    mock_interface_set_summary (i2, "summary2");
-    mock_interface_set_doc_url (i2, "url2");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_plug (s, i1, "plug1");
-    mock_snap_add_slot (s, i2, "slot1");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_summary (s, "SUMMARY");
+    mock_snap_add_price (s, 1.25, "NZD");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3717,85 +8102,137 @@ test_get_interfaces2_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_interfaces2_async (client, SNAPD_GET_INTERFACES_FLAGS_NONE, NULL, NULL, get_interfaces2_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_with_fields_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, NULL, "snap", SNAPD_SNAP_FIELDS_PRICES, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap");
+    g_assert_null (snapd_snap_get_summary (snaps->pdata[0]));
+    GPtrArray *prices = snapd_snap_get_prices (snaps->pdata[0]);
+    g_assert_cmpint (prices->len, ==, 1);
+    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[0]), ==, "NZD");
+    g_assert_null (snapd_snap_get_channels (snaps->pdata[0]));
 }
 
 static void
-test_get_interfaces2_only_connected (void)
+test_find_page (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface1");
-    mock_snapd_add_interface (snapd, "interface2");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *sl = mock_snap_add_slot (s, i, "slot1");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *p = mock_snap_add_plug (s, i, "plug2");
-    mock_snapd_connect (snapd, p, sl, TRUE, FALSE);
+    mock_snapd_set_suggested_currency (snapd, "NZD");
+    for (int i = 0; i < 50; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%02d", i);
+        mock_snapd_add_store_snap (snapd, name);
+    }
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_cache_ttl (client, "/v2/find", 60000);
 
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_ONLY_CONNECTED, NULL, NULL, &error);
+    guint total = 0;
+    g_autofree gchar *suggested_currency = NULL;
+    g_autoptr(GPtrArray) page1 = snapd_client_find_page_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap", 0, 20, &total, &suggested_currency, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (ifaces);
+    g_assert_nonnull (page1);
+    g_assert_cmpint (page1->len, ==, 20);
+    g_assert_cmpint (total, ==, 50);
+    g_assert_cmpstr (suggested_currency, ==, "NZD");
+    g_assert_cmpstr (snapd_snap_get_name (page1->pdata[0]), ==, "snap00");
+    g_assert_cmpstr (snapd_snap_get_name (page1->pdata[19]), ==, "snap19");
 
-    g_assert_cmpint (ifaces->len, ==, 1);
+    /* Later pages are parsed from the cached response */
+    g_autoptr(GPtrArray) page3 = snapd_client_find_page_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap", 40, 20, &total, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (page3);
+    g_assert_cmpint (page3->len, ==, 10);
+    g_assert_cmpint (total, ==, 50);
+    g_assert_cmpstr (snapd_snap_get_name (page3->pdata[0]), ==, "snap40");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface1");
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    /* Past the end */
+    g_autoptr(GPtrArray) empty = snapd_client_find_page_sync (client, SNAPD_FIND_FLAGS_NONE, NULL, "snap", 60, 20, &total, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (empty);
+    g_assert_cmpint (empty->len, ==, 0);
+    g_assert_cmpint (total, ==, 50);
+
+    /* A full find shares the same response */
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 50);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
 }
 
 static void
-test_get_interfaces2_slots (void)
+test_cache_manager (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_slot (s, i, "slot1");
-    mock_snap_add_plug (s, i, "plug1");
+    mock_snapd_add_snap (snapd, "snap1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_cache_ttl (client, "/v2/snaps", 60000);
 
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_INCLUDE_SLOTS, NULL, NULL, &error);
+    SnapdCacheManager *manager = snapd_client_get_cache_manager (client);
+    g_assert_nonnull (manager);
+    g_assert_cmpint (snapd_cache_manager_get_memory_used (manager), ==, 0);
+    g_assert_cmpint (snapd_cache_manager_get_hits (manager, "responses"), ==, 0);
+
+    g_autoptr(GPtrArray) snaps = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (ifaces);
+    g_assert_nonnull (snaps);
+    guint misses = snapd_cache_manager_get_misses (manager, "responses");
+    g_assert_cmpint (misses, >, 0);
+    g_assert_cmpint (snapd_cache_manager_get_memory_used (manager), >, 0);
 
-    g_assert_cmpint (ifaces->len, ==, 1);
+    g_autoptr(GPtrArray) snaps2 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps2);
+    g_assert_cmpint (snapd_cache_manager_get_hits (manager, "responses"), ==, 1);
+    g_assert_cmpint (snapd_cache_manager_get_misses (manager, "responses"), ==, misses);
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 1);
-    SnapdSlot *slot = slots->pdata[0];
-    g_assert_cmpstr (snapd_slot_get_name (slot), ==, "slot1");
-    g_assert_cmpstr (snapd_slot_get_snap (slot), ==, "snap1");
+    // Trimming empties the caches, so the next request goes to snapd
+    snapd_cache_manager_trim (manager);
+    g_assert_cmpint (snapd_cache_manager_get_memory_used (manager), ==, 0);
+    g_assert_cmpint (snapd_cache_manager_get_evictions (manager, "responses"), >, 0);
+    g_autoptr(GPtrArray) snaps3 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps3);
+    g_assert_cmpint (snapd_cache_manager_get_hits (manager, "responses"), ==, 1);
+    g_assert_cmpint (snapd_cache_manager_get_misses (manager, "responses"), >, misses);
+
+    // Nothing fits in a tiny budget
+    snapd_cache_manager_trim (manager);
+    snapd_cache_manager_set_memory_budget (manager, 1);
+    g_assert_cmpint (snapd_cache_manager_get_memory_budget (manager), ==, 1);
+    g_autoptr(GPtrArray) snaps4 = snapd_client_get_snaps_sync (client, SNAPD_GET_SNAPS_FLAGS_NONE, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps4);
+    g_assert_cmpint (snapd_cache_manager_get_memory_used (manager), ==, 0);
+
+    // Managers can be shared between clients
+    g_autoptr(SnapdCacheManager) shared = snapd_cache_manager_new ();
+    snapd_client_set_cache_manager (client, shared);
+    g_assert_true (snapd_client_get_cache_manager (client) == shared);
+    g_auto(GStrv) names = snapd_cache_manager_get_cache_names (shared);
+    g_assert_true (g_strv_contains ((const gchar * const *) names, "responses"));
 }
 
 static void
-test_get_interfaces2_plugs (void)
+test_catalog_cache (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_slot (s, i, "slot1");
-    mock_snap_add_plug (s, i, "plug1");
+    mock_snapd_set_suggested_currency (snapd, "NZD");
+    mock_snapd_add_store_snap (snapd, "apple");
+    mock_snapd_add_store_snap (snapd, "carrot1");
+    mock_snapd_add_store_section (snapd, "SECTION1");
+    mock_snapd_add_store_section (snapd, "SECTION2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3803,62 +8240,118 @@ test_get_interfaces2_plugs (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_INCLUDE_PLUGS, NULL, NULL, &error);
+    // Nothing cached yet
+    g_autoptr(SnapdCatalogCache) cache = snapd_catalog_cache_new ();
+    snapd_client_set_catalog_cache (client, cache);
+    g_assert_true (snapd_client_get_catalog_cache (client) == cache);
+    g_autoptr(GPtrArray) uncached = snapd_client_find_cached (client, SNAPD_FIND_FLAGS_NONE, NULL, "carrot", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (uncached);
+    g_clear_error (&error);
+
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "carrot", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (ifaces);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_auto(GStrv) sections = snapd_client_get_sections_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (sections);
+    g_assert_cmpint (snapd_catalog_cache_get_n_entries (cache), ==, 2);
 
-    g_assert_cmpint (ifaces->len, ==, 1);
+    gchar *path = NULL;
+    int fd = g_file_open_tmp ("snapd-glib-test-XXXXXX", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    g_assert_true (snapd_catalog_cache_save (cache, path, &error));
+    g_assert_no_error (error);
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 1);
-    SnapdPlug *plug = plugs->pdata[0];
-    g_assert_cmpstr (snapd_plug_get_name (plug), ==, "plug1");
-    g_assert_cmpstr (snapd_plug_get_snap (plug), ==, "snap1");
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    // Results are available from the saved cache without contacting snapd
+    g_autoptr(SnapdCatalogCache) loaded_cache = snapd_catalog_cache_new_from_file (path, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (loaded_cache);
+    g_assert_cmpint (snapd_catalog_cache_get_n_entries (loaded_cache), ==, 2);
+    g_autoptr(SnapdClient) offline_client = snapd_client_new ();
+    snapd_client_set_socket_path (offline_client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_catalog_cache (offline_client, loaded_cache);
+    guint request_count = mock_snapd_get_request_count (snapd);
+    g_autofree gchar *suggested_currency = NULL;
+    g_autoptr(GPtrArray) cached_snaps = snapd_client_find_cached (offline_client, SNAPD_FIND_FLAGS_NONE, NULL, "carrot", &suggested_currency, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (cached_snaps);
+    g_assert_cmpint (cached_snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (cached_snaps->pdata[0]), ==, "carrot1");
+    g_assert_cmpstr (suggested_currency, ==, "NZD");
+    g_auto(GStrv) cached_sections = snapd_client_get_sections_cached (offline_client, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (cached_sections), ==, 2);
+    g_assert_cmpstr (cached_sections[0], ==, "SECTION1");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count);
+
+    // Requests fall back to the cache when snapd can't be reached
+    mock_snapd_stop (snapd);
+    g_autoptr(GPtrArray) offline_snaps = snapd_client_find_sync (offline_client, SNAPD_FIND_FLAGS_NONE, "carrot", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (offline_snaps);
+    g_assert_cmpint (offline_snaps->len, ==, 1);
+    g_autoptr(GPtrArray) missing_snaps = snapd_client_find_sync (offline_client, SNAPD_FIND_FLAGS_NONE, "apple", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED);
+    g_assert_null (missing_snaps);
+    g_clear_error (&error);
+
+    // Without a cache the error is returned
+    snapd_client_set_catalog_cache (offline_client, NULL);
+    g_autoptr(GPtrArray) failed_snaps = snapd_client_find_sync (offline_client, SNAPD_FIND_FLAGS_NONE, "carrot", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_CONNECTION_FAILED);
+    g_assert_null (failed_snaps);
+    g_clear_error (&error);
+
+    g_clear_object (&loaded_cache);
+    unlink (path);
+    g_free (path);
 }
 
 static void
-test_get_interfaces2_filter (void)
+test_catalog_cache_system_information (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_interface (snapd, "interface1");
-    mock_snapd_add_interface (snapd, "interface2");
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(SnapdCatalogCache) cache = snapd_catalog_cache_new ();
+    snapd_client_set_catalog_cache (client, cache);
+    g_autoptr(SnapdSystemInformation) uncached = snapd_client_get_system_information_cached (client, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (uncached);
+    g_clear_error (&error);
 
-    gchar *filter_names[] = { "interface2", NULL };
-    g_autoptr(GPtrArray) ifaces = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter_names, NULL, &error);
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (ifaces);
+    g_assert_nonnull (info);
 
-    g_assert_cmpint (ifaces->len, ==, 1);
+    // The last information is available on the next start without a request to snapd
+    guint request_count = mock_snapd_get_request_count (snapd);
+    g_autoptr(SnapdSystemInformation) cached = snapd_client_get_system_information_cached (client, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (cached);
+    g_assert_cmpstr (snapd_system_information_get_build_id (cached), ==, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count);
 
-    SnapdInterface *iface = ifaces->pdata[0];
-    g_assert_cmpstr (snapd_interface_get_name (iface), ==, "interface2");
-    GPtrArray *plugs = snapd_interface_get_plugs (iface);
-    g_assert_nonnull (plugs);
-    g_assert_cmpint (plugs->len, ==, 0);
-    GPtrArray *slots = snapd_interface_get_slots (iface);
-    g_assert_nonnull (slots);
-    g_assert_cmpint (slots->len, ==, 0);
+    // A new build replaces it once revalidated
+    mock_snapd_set_build_id (snapd, "0123456789abcdef0123456789abcdef01234567");
+    g_autoptr(SnapdSystemInformation) new_info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdSystemInformation) new_cached = snapd_client_get_system_information_cached (client, &error);
+    g_assert_no_error (error);
+    g_assert_cmpstr (snapd_system_information_get_build_id (new_cached), ==, "0123456789abcdef0123456789abcdef01234567");
 }
 
 static void
-test_get_interfaces2_make_label (void)
+test_find_bad_query (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_interface (snapd, "camera");
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface-without-translation");
-    mock_interface_set_summary (i, "SUMMARY");
-    mock_snapd_add_interface (snapd, "interface-without-summary");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3866,43 +8359,16 @@ test_get_interfaces2_make_label (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gchar *filter1[] = { "camera", NULL };
-    g_autoptr(GPtrArray) ifaces1 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter1, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (ifaces1);
-    g_assert_cmpint (ifaces1->len, ==, 1);
-    SnapdInterface *iface1 = ifaces1->pdata[0];
-    g_autofree gchar *label1 = snapd_interface_make_label (iface1);
-    g_assert_cmpstr (label1, ==, "Use your camera"); // FIXME: Won't work if translated
-
-    gchar *filter2[] = { "interface-without-translation", NULL };
-    g_autoptr(GPtrArray) ifaces2 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter2, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (ifaces2);
-    g_assert_cmpint (ifaces2->len, ==, 1);
-    SnapdInterface *iface2 = ifaces2->pdata[0];
-    g_autofree gchar *label2 = snapd_interface_make_label (iface2);
-    g_assert_cmpstr (label2, ==, "interface-without-translation: SUMMARY");
-
-    gchar *filter3[] = { "interface-without-summary", NULL };
-    g_autoptr(GPtrArray) ifaces3 = snapd_client_get_interfaces2_sync (client, SNAPD_GET_INTERFACES_FLAGS_NONE, filter3, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (ifaces3);
-    g_assert_cmpint (ifaces3->len, ==, 1);
-    SnapdInterface *iface3 = ifaces3->pdata[0];
-    g_autofree gchar *label3 = snapd_interface_make_label (iface3);
-    g_assert_cmpstr (label3, ==, "interface-without-summary");
+    // '?' is not allowed in queries
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap?", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_QUERY);
+    g_assert_null (snaps);
 }
 
 static void
-test_connect_interface_sync (void)
+test_find_network_timeout (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3910,42 +8376,34 @@ test_connect_interface_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_true (mock_snapd_find_plug_connection (snapd, plug) == slot);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "network-timeout", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NETWORK_TIMEOUT);
+    g_assert_null (snaps);
 }
 
 static void
-connect_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_find_dns_failure (void)
 {
-    g_autoptr(AsyncData) data = user_data;
-
-    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap1");
-    MockSlot *slot = mock_snap_find_slot (s, "slot");
-    s = mock_snapd_find_snap (data->snapd, "snap2");
-    MockPlug *plug = mock_snap_find_plug (s, "plug");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_connect_interface_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_true (mock_snapd_find_plug_connection (data->snapd, plug) == slot);
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_main_loop_quit (data->loop);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "dns-failure", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_DNS_FAILURE);
+    g_assert_null (snaps);
 }
 
 static void
-test_connect_interface_async (void)
+test_find_name (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    mock_snap_add_plug (s, i, "plug");
+    mock_snapd_add_store_snap (snapd, "snap");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3953,31 +8411,43 @@ test_connect_interface_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_connect_interface_async (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, connect_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap");
 }
 
-typedef struct
+static void
+test_find_name_private (void)
 {
-    int progress_done;
-} ConnectInterfaceProgressData;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_add_private_snap (a, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-static void
-connect_interface_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
-{
-    ConnectInterfaceProgressData *data = user_data;
-    data->progress_done++;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME | SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap");
+    g_assert_true (snapd_snap_get_private (snaps->pdata[0]));
 }
 
 static void
-test_connect_interface_progress (void)
+test_find_name_private_not_logged_in (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -3985,19 +8455,29 @@ test_connect_interface_progress (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    ConnectInterfaceProgressData connect_interface_progress_data;
-    connect_interface_progress_data.progress_done = 0;
-    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", connect_interface_progress_cb, &connect_interface_progress_data, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_true (mock_snapd_find_plug_connection (snapd, plug) == slot);
-    g_assert_cmpint (connect_interface_progress_data.progress_done, >, 0);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME | SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
+    g_assert_null (snaps);
 }
 
 static void
-test_connect_interface_invalid (void)
+test_find_channels (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+
+    MockTrack *t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "stable", NULL);
+    MockChannel *c = mock_track_add_channel (t, "beta", NULL);
+    mock_channel_set_revision (c, "BETA-REVISION");
+    mock_channel_set_version (c, "BETA-VERSION");
+    mock_channel_set_epoch (c, "1");
+    mock_channel_set_confinement (c, "classic");
+    mock_channel_set_size (c, 10000);
+    mock_channel_set_released_at (c, "2018-01-19T13:14:15Z");
+    c = mock_track_add_channel (t, "stable", "branch");
+    t = mock_snap_add_track (s, "insider");
+    mock_track_add_channel (t, "stable", NULL);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4005,21 +8485,98 @@ test_connect_interface_invalid (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_connect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
-    g_assert_false (result);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    SnapdSnap *snap = snaps->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
+    GStrv tracks = snapd_snap_get_tracks (snap);
+    g_assert_cmpint (g_strv_length (tracks), ==, 2);
+    g_assert_cmpstr (tracks[0], ==, "latest");
+    g_assert_cmpstr (tracks[1], ==, "insider");
+    GPtrArray *channels = snapd_snap_get_channels (snap);
+    g_assert_cmpint (channels->len, ==, 4);
+
+    gboolean matched_stable = FALSE, matched_beta = FALSE, matched_branch = FALSE, matched_track = FALSE;
+    for (guint i = 0; i < channels->len; i++) {
+        SnapdChannel *channel = channels->pdata[i];
+
+        if (strcmp (snapd_channel_get_name (channel), "stable") == 0) {
+            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
+            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+            g_assert_null (snapd_channel_get_branch (channel));
+            g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "REVISION");
+            g_assert_cmpstr (snapd_channel_get_version (channel), ==, "VERSION");
+            g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "0");
+            g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_STRICT);
+            g_assert_cmpint (snapd_channel_get_size (channel), ==, 65535);
+            g_assert_null (snapd_channel_get_released_at (channel));
+            matched_stable = TRUE;
+        }
+        if (strcmp (snapd_channel_get_name (channel), "beta") == 0) {
+            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
+            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "beta");
+            g_assert_null (snapd_channel_get_branch (channel));
+            g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "BETA-REVISION");
+            g_assert_cmpstr (snapd_channel_get_version (channel), ==, "BETA-VERSION");
+            g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "1");
+            g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_CLASSIC);
+            g_assert_cmpint (snapd_channel_get_size (channel), ==, 10000);
+            g_assert_true (date_matches (snapd_channel_get_released_at (channel), 2018, 1, 19, 13, 14, 15));
+            matched_beta = TRUE;
+        }
+        if (strcmp (snapd_channel_get_name (channel), "stable/branch") == 0) {
+            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
+            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+            g_assert_cmpstr (snapd_channel_get_branch (channel), ==, "branch");
+            g_assert_null (snapd_channel_get_released_at (channel));
+            matched_branch = TRUE;
+        }
+        if (strcmp (snapd_channel_get_name (channel), "insider/stable") == 0) {
+            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "insider");
+            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+            g_assert_null (snapd_channel_get_branch (channel));
+            g_assert_null (snapd_channel_get_released_at (channel));
+            matched_track = TRUE;
+        }
+    }
+    g_assert_true (matched_stable);
+    g_assert_true (matched_beta);
+    g_assert_true (matched_branch);
+    g_assert_true (matched_track);
 }
 
 static void
-test_disconnect_interface_sync (void)
+test_find_channels_match (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
-    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
+
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "stable-snap");
+    MockTrack *t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "stable", NULL);
+
+    s = mock_snapd_add_store_snap (snapd, "full-snap");
+    t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "stable", NULL);
+    mock_track_add_channel (t, "candidate", NULL);
+    mock_track_add_channel (t, "beta", NULL);
+    mock_track_add_channel (t, "edge", NULL);
+
+    s = mock_snapd_add_store_snap (snapd, "beta-snap");
+    t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "beta", NULL);
+
+    s = mock_snapd_add_store_snap (snapd, "branch-snap");
+    t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "stable", NULL);
+    mock_track_add_channel (t, "stable", "branch");
+
+    s = mock_snapd_add_store_snap (snapd, "track-snap");
+    t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "stable", NULL);
+    t = mock_snap_add_track (s, "insider");
+    mock_track_add_channel (t, "stable", NULL);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4027,41 +8584,133 @@ test_disconnect_interface_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
+    /* All channels match to stable if only stable defined */
+    g_autoptr(GPtrArray) snaps1 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "stable-snap", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_null (mock_snapd_find_plug_connection (snapd, plug));
-}
+    g_assert_nonnull (snaps1);
+    g_assert_cmpint (snaps1->len, ==, 1);
+    SnapdSnap *snap = snaps1->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "stable-snap");
+    SnapdChannel *channel = snapd_snap_match_channel (snap, "stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "candidate");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "beta");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "edge");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "UNDEFINED");
+    g_assert_null (channel);
 
-static void
-disconnect_cb (GObject *object, GAsyncResult *result, gpointer user_data)
-{
-    g_autoptr(AsyncData) data = user_data;
+    /* All channels match if all defined */
+    g_autoptr(GPtrArray) snaps2 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "full-snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps2);
+    g_assert_cmpint (snaps2->len, ==, 1);
+    snap = snaps2->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "full-snap");
+    channel = snapd_snap_match_channel (snap, "stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "candidate");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "candidate");
+    channel = snapd_snap_match_channel (snap, "beta");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
+    channel = snapd_snap_match_channel (snap, "edge");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "edge");
+    channel = snapd_snap_match_channel (snap, "UNDEFINED");
+    g_assert_null (channel);
 
-    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap2");
-    MockPlug *plug = mock_snap_find_plug (s, "plug");
+    /* Only match with more stable channels */
+    g_autoptr(GPtrArray) snaps3 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "beta-snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps3);
+    g_assert_cmpint (snaps3->len, ==, 1);
+    snap = snaps3->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "beta-snap");
+    channel = snapd_snap_match_channel (snap, "stable");
+    g_assert_null (channel);
+    channel = snapd_snap_match_channel (snap, "candidate");
+    g_assert_null (channel);
+    channel = snapd_snap_match_channel (snap, "beta");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
+    channel = snapd_snap_match_channel (snap, "edge");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
+    channel = snapd_snap_match_channel (snap, "UNDEFINED");
+    g_assert_null (channel);
 
-    g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_connect_interface_finish (SNAPD_CLIENT (object), result, &error);
+    /* Match branches */
+    g_autoptr(GPtrArray) snaps4 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "branch-snap", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_null (mock_snapd_find_plug_connection (data->snapd, plug));
+    g_assert_nonnull (snaps4);
+    g_assert_cmpint (snaps4->len, ==, 1);
+    snap = snaps4->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "branch-snap");
+    channel = snapd_snap_match_channel (snap, "stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "stable/branch");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable/branch");
+    channel = snapd_snap_match_channel (snap, "candidate");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "beta");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "edge");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "UNDEFINED");
+    g_assert_null (channel);
 
-    g_main_loop_quit (data->loop);
+    /* Match correct tracks */
+    g_autoptr(GPtrArray) snaps5 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "track-snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps5);
+    g_assert_cmpint (snaps5->len, ==, 1);
+    snap = snaps5->pdata[0];
+    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "track-snap");
+    channel = snapd_snap_match_channel (snap, "stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
+    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "latest/stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
+    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
+    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+    channel = snapd_snap_match_channel (snap, "insider/stable");
+    g_assert_nonnull (channel);
+    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "insider/stable");
+    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "insider");
+    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
 }
 
 static void
-test_disconnect_interface_async (void)
+test_find_track_channels (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
-    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
+
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    MockTrack *t = mock_snap_add_track (s, "latest");
+    mock_track_add_channel (t, "edge", NULL);
+    mock_track_add_channel (t, "beta", NULL);
+    t = mock_snap_add_track (s, "insider");
+    mock_track_add_channel (t, "candidate", "branch");
+    mock_track_add_channel (t, "candidate", NULL);
+    mock_track_add_channel (t, "stable", NULL);
+    mock_snap_add_track (s, "empty");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4069,32 +8718,43 @@ test_disconnect_interface_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_disconnect_interface_async (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, disconnect_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_autoptr(GPtrArray) channels = snapd_snap_get_track_channels (snaps->pdata[0]);
+    g_assert_cmpint (channels->len, ==, 2);
+    g_assert_cmpstr (snapd_channel_get_name (channels->pdata[0]), ==, "beta");
+    g_assert_cmpstr (snapd_channel_get_name (channels->pdata[1]), ==, "insider/stable");
 }
 
-typedef struct
+static gboolean
+cancel_cb (gpointer user_data)
 {
-    int progress_done;
-} DisconnectInterfaceProgressData;
+    GCancellable *cancellable = user_data;
+    g_cancellable_cancel (cancellable);
+    return G_SOURCE_REMOVE;
+}
 
 static void
-disconnect_interface_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+find_cancel_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    DisconnectInterfaceProgressData *data = user_data;
-    data->progress_done++;
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (snaps);
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_disconnect_interface_progress (void)
+test_find_cancel (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockInterface *i = mock_snapd_add_interface (snapd, "interface");
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    MockSlot *slot = mock_snap_add_slot (s, i, "slot");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    MockPlug *plug = mock_snap_add_plug (s, i, "plug");
-    mock_snapd_connect (snapd, plug, slot, TRUE, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4102,55 +8762,37 @@ test_disconnect_interface_progress (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    DisconnectInterfaceProgressData disconnect_interface_progress_data;
-    disconnect_interface_progress_data.progress_done = 0;
-    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", disconnect_interface_progress_cb, &disconnect_interface_progress_data, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_null (mock_snapd_find_plug_connection (snapd, plug));
-    g_assert_cmpint (disconnect_interface_progress_data.progress_done, >, 0);
+    /* Use a special query that never responds */
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, "do-not-respond", cancellable, find_cancel_cb, async_data_new (loop, snapd));
+    g_idle_add (cancel_cb, cancellable);
+
+    g_main_loop_run (loop);
 }
 
 static void
-test_disconnect_interface_invalid (void)
+find_cancel_many_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    AsyncData *data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (snaps);
 
-    gboolean result = snapd_client_disconnect_interface_sync (client, "snap2", "plug", "snap1", "slot", NULL, NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
-    g_assert_false (result);
+    data->counter++;
+    if (data->counter == 20)
+        g_main_loop_quit (data->loop);
 }
 
 static void
-test_find_query (void)
+test_find_cancel_many (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_set_suggested_currency (snapd, "NZD");
-    mock_snapd_add_store_snap (snapd, "apple");
-    mock_snapd_add_store_snap (snapd, "banana");
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "carrot1");
-    mock_track_add_channel (mock_snap_add_track (s, "latest"), "stable", NULL);
-    s = mock_snapd_add_store_snap (snapd, "carrot2");
-    mock_track_add_channel (mock_snap_add_track (s, "latest"), "stable", NULL);
-    mock_snap_set_channel (s, "CHANNEL");
-    mock_snap_set_contact (s, "CONTACT");
-    mock_snap_set_website (s, "WEBSITE");
-    mock_snap_set_description (s, "DESCRIPTION");
-    mock_snap_set_store_url (s, "https://snapcraft.io/snap");
-    mock_snap_set_summary (s, "SUMMARY");
-    mock_snap_set_download_size (s, 1024);
-    mock_snap_add_price (s, 1.25, "NZD");
-    mock_snap_add_price (s, 0.75, "USD");
-    mock_snap_add_media (s, "screenshot", "screenshot0.png", 0, 0);
-    mock_snap_add_media (s, "screenshot", "screenshot1.png", 1024, 1024);
-    mock_snap_add_media (s, "banner", "banner.png", 0, 0);
-    mock_snap_set_trymode (s, TRUE);
+    mock_snapd_add_store_snap (snapd, "snap");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/find", 50);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4158,140 +8800,93 @@ test_find_query (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autofree gchar *suggested_currency = NULL;
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "carrot", &suggested_currency, NULL, &error);
+    /* Requests cancelled together complete together */
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    for (int i = 0; i < 20; i++) {
+        g_autofree gchar *query = g_strdup_printf ("query%d", i);
+        snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, query, cancellable, find_cancel_many_cb, data);
+    }
+    g_idle_add (cancel_cb, cancellable);
+    g_main_loop_run (loop);
+    g_assert_cmpint (data->counter, ==, 20);
+
+    /* The responses to the cancelled requests are skipped over */
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (suggested_currency, ==, "NZD");
-    SnapdSnap *snap = snaps->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "carrot1");
-    g_assert_null (snapd_snap_get_channel (snap));
-    GStrv tracks = snapd_snap_get_tracks (snap);
-    g_assert_cmpint (g_strv_length (tracks), ==, 1);
-    g_assert_cmpstr (tracks[0], ==, "latest");
-    GPtrArray *channels = snapd_snap_get_channels (snap);
-    g_assert_cmpint (channels->len, ==, 1);
-    SnapdChannel *channel = channels->pdata[0];
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "REVISION");
-    g_assert_cmpstr (snapd_channel_get_version (channel), ==, "VERSION");
-    g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "0");
-    g_assert_cmpint (snapd_channel_get_size (channel), ==, 65535);
-    g_assert_null (snapd_snap_get_contact (snap));
-    g_assert_null (snapd_snap_get_description (snap));
-    g_assert_null (snapd_snap_get_store_url (snap));
-    g_assert_null (snapd_snap_get_summary (snap));
-    snap = snaps->pdata[1];
-    g_assert_cmpstr (snapd_snap_get_channel (snap), ==, "CHANNEL");
-    g_assert_cmpint (snapd_snap_get_confinement (snap), ==, SNAPD_CONFINEMENT_STRICT);
-    g_assert_cmpstr (snapd_snap_get_contact (snap), ==, "CONTACT");
-    g_assert_cmpstr (snapd_snap_get_description (snap), ==, "DESCRIPTION");
-    g_assert_cmpstr (snapd_snap_get_publisher_display_name (snap), ==, "PUBLISHER-DISPLAY-NAME");
-    g_assert_cmpstr (snapd_snap_get_publisher_id (snap), ==, "PUBLISHER-ID");
-    g_assert_cmpstr (snapd_snap_get_publisher_username (snap), ==, "PUBLISHER-USERNAME");
-    g_assert_cmpint (snapd_snap_get_publisher_validation (snap), ==, SNAPD_PUBLISHER_VALIDATION_UNKNOWN);
-    g_assert_cmpint (snapd_snap_get_download_size (snap), ==, 1024);
-    g_assert_cmpstr (snapd_snap_get_icon (snap), ==, "ICON");
-    g_assert_cmpstr (snapd_snap_get_id (snap), ==, "ID");
-    g_assert_null (snapd_snap_get_install_date (snap));
-    g_assert_cmpint (snapd_snap_get_installed_size (snap), ==, 0);
-    GPtrArray *media = snapd_snap_get_media (snap);
-    g_assert_cmpint (media->len, ==, 3);
-    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[0]), ==, "screenshot");
-    g_assert_cmpstr (snapd_media_get_url (media->pdata[0]), ==, "screenshot0.png");
-    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[1]), ==, "screenshot");
-    g_assert_cmpstr (snapd_media_get_url (media->pdata[1]), ==, "screenshot1.png");
-    g_assert_cmpint (snapd_media_get_width (media->pdata[1]), ==, 1024);
-    g_assert_cmpint (snapd_media_get_height (media->pdata[1]), ==, 1024);
-    g_assert_cmpstr (snapd_media_get_media_type (media->pdata[2]), ==, "banner");
-    g_assert_cmpstr (snapd_media_get_url (media->pdata[2]), ==, "banner.png");
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "carrot2");
-    GPtrArray *prices = snapd_snap_get_prices (snap);
-    g_assert_cmpint (prices->len, ==, 2);
-    g_assert_cmpfloat (snapd_price_get_amount (prices->pdata[0]), ==, 1.25);
-    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[0]), ==, "NZD");
-    g_assert_cmpfloat (snapd_price_get_amount (prices->pdata[1]), ==, 0.75);
-    g_assert_cmpstr (snapd_price_get_currency (prices->pdata[1]), ==, "USD");
-    g_assert_false (snapd_snap_get_private (snap));
-    g_assert_cmpstr (snapd_snap_get_revision (snap), ==, "REVISION");
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_screenshots (snap)->len, ==, 0);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_cmpint (snapd_snap_get_snap_type (snap), ==, SNAPD_SNAP_TYPE_APP);
-    g_assert_cmpint (snapd_snap_get_status (snap), ==, SNAPD_SNAP_STATUS_ACTIVE);
-    g_assert_cmpstr (snapd_snap_get_store_url (snap), ==, "https://snapcraft.io/snap");
-    g_assert_cmpstr (snapd_snap_get_summary (snap), ==, "SUMMARY");
-    g_assert_true (snapd_snap_get_trymode (snap));
-    g_assert_cmpstr (snapd_snap_get_version (snap), ==, "VERSION");
-    g_assert_cmpstr (snapd_snap_get_website (snap), ==, "WEBSITE");
+    g_assert_cmpint (snaps->len, ==, 1);
 }
 
 static void
-test_find_query_private (void)
+find_superseded_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_snapd_add_store_snap (snapd, "snap1");
-    mock_account_add_private_snap (a, "snap2");
+    AsyncData *data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_autoptr(GPtrArray) snaps = snapd_client_find_superseding_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (snaps);
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap2");
-    g_assert_true (snapd_snap_get_private (snaps->pdata[0]));
+    data->counter++;
 }
 
 static void
-test_find_query_private_not_logged_in (void)
+find_superseding_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
+    g_autoptr(GPtrArray) snaps = snapd_client_find_superseding_finish (SNAPD_CLIENT (object), result, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "apple");
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    /* Both earlier requests were completed first; the unwritten one was never sent */
+    g_assert_cmpint (data->counter, ==, 2);
+    g_assert_cmpint (mock_snapd_get_request_count (data->snapd), ==, 2);
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
-    g_assert_null (snaps);
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_find_bad_query (void)
+test_find_superseding (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "apple");
+    mock_snapd_add_store_snap (snapd, "banana");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/find", 100);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_connections (client, 1);
+    snapd_client_set_max_pipeline_depth (client, 1);
 
-    // '?' is not allowed in queries
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap?", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_QUERY);
-    g_assert_null (snaps);
+    /* The first request is sent, the second waits for it and the third replaces both */
+    AsyncData *data = async_data_new (loop, snapd);
+    snapd_client_find_superseding_async (client, SNAPD_FIND_FLAGS_NONE, NULL, "a", "search", NULL, find_superseded_cb, data);
+    snapd_client_find_superseding_async (client, SNAPD_FIND_FLAGS_NONE, NULL, "ap", "search", NULL, find_superseded_cb, data);
+    snapd_client_find_superseding_async (client, SNAPD_FIND_FLAGS_NONE, NULL, "app", "search", NULL, find_superseding_cb, data);
+
+    g_main_loop_run (loop);
 }
 
 static void
-test_find_network_timeout (void)
+test_find_section (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
+    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "banana");
+    s = mock_snapd_add_store_snap (snapd, "carrot1");
+    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "carrot2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4299,15 +8894,24 @@ test_find_network_timeout (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "network-timeout", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NETWORK_TIMEOUT);
-    g_assert_null (snaps);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_NONE, "section", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "apple");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "carrot1");
 }
 
 static void
-test_find_dns_failure (void)
+test_find_section_query (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
+    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "banana");
+    s = mock_snapd_add_store_snap (snapd, "carrot1");
+    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "carrot2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4315,18 +8919,24 @@ test_find_dns_failure (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "dns-failure", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_DNS_FAILURE);
-    g_assert_null (snaps);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_NONE, "section", "carrot", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "carrot1");
 }
 
 static void
-test_find_name (void)
+test_find_section_name (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
-    mock_snapd_add_store_snap (snapd, "snap2");
-    mock_snapd_add_store_snap (snapd, "snap3");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
+    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "banana");
+    s = mock_snapd_add_store_snap (snapd, "carrot1");
+    mock_snap_add_store_section (s, "section");
+    s = mock_snapd_add_store_snap (snapd, "carrot2");
+    mock_snap_add_store_section (s, "section");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4334,19 +8944,20 @@ test_find_name (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap", NULL, NULL, &error);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "section", "carrot1", NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (snaps);
     g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "carrot1");
 }
 
 static void
-test_find_name_private (void)
+test_find_scope_narrow (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_add_private_snap (a, "snap");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_set_scope_is_wide (s, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4354,23 +8965,20 @@ test_find_name_private (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
-
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME | SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (snaps);
     g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap");
-    g_assert_true (snapd_snap_get_private (snaps->pdata[0]));
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
 }
 
 static void
-test_find_name_private_not_logged_in (void)
+test_find_scope_wide (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_set_scope_is_wide (s, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4378,29 +8986,24 @@ test_find_name_private_not_logged_in (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME | SNAPD_FIND_FLAGS_SELECT_PRIVATE, "snap", NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
-    g_assert_null (snaps);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SCOPE_WIDE, "snap", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
 }
 
 static void
-test_find_channels (void)
+test_find_common_id (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-
-    MockTrack *t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "stable", NULL);
-    MockChannel *c = mock_track_add_channel (t, "beta", NULL);
-    mock_channel_set_revision (c, "BETA-REVISION");
-    mock_channel_set_version (c, "BETA-VERSION");
-    mock_channel_set_epoch (c, "1");
-    mock_channel_set_confinement (c, "classic");
-    mock_channel_set_size (c, 10000);
-    mock_channel_set_released_at (c, "2018-01-19T13:14:15Z");
-    c = mock_track_add_channel (t, "stable", "branch");
-    t = mock_snap_add_track (s, "insider");
-    mock_track_add_channel (t, "stable", NULL);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    MockApp *a = mock_snap_add_app (s, "snap1");
+    mock_app_set_common_id (a, "com.example.snap1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    a = mock_snap_add_app (s, "snap2");
+    mock_app_set_common_id (a, "com.example.snap2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4408,98 +9011,20 @@ test_find_channels (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "snap", NULL, NULL, &error);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_COMMON_ID, "com.example.snap2", NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (snaps);
     g_assert_cmpint (snaps->len, ==, 1);
-    SnapdSnap *snap = snaps->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "snap");
-    GStrv tracks = snapd_snap_get_tracks (snap);
-    g_assert_cmpint (g_strv_length (tracks), ==, 2);
-    g_assert_cmpstr (tracks[0], ==, "latest");
-    g_assert_cmpstr (tracks[1], ==, "insider");
-    GPtrArray *channels = snapd_snap_get_channels (snap);
-    g_assert_cmpint (channels->len, ==, 4);
-
-    gboolean matched_stable = FALSE, matched_beta = FALSE, matched_branch = FALSE, matched_track = FALSE;
-    for (guint i = 0; i < channels->len; i++) {
-        SnapdChannel *channel = channels->pdata[i];
-
-        if (strcmp (snapd_channel_get_name (channel), "stable") == 0) {
-            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
-            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
-            g_assert_null (snapd_channel_get_branch (channel));
-            g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "REVISION");
-            g_assert_cmpstr (snapd_channel_get_version (channel), ==, "VERSION");
-            g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "0");
-            g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_STRICT);
-            g_assert_cmpint (snapd_channel_get_size (channel), ==, 65535);
-            g_assert_null (snapd_channel_get_released_at (channel));
-            matched_stable = TRUE;
-        }
-        if (strcmp (snapd_channel_get_name (channel), "beta") == 0) {
-            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
-            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "beta");
-            g_assert_null (snapd_channel_get_branch (channel));
-            g_assert_cmpstr (snapd_channel_get_revision (channel), ==, "BETA-REVISION");
-            g_assert_cmpstr (snapd_channel_get_version (channel), ==, "BETA-VERSION");
-            g_assert_cmpstr (snapd_channel_get_epoch (channel), ==, "1");
-            g_assert_cmpint (snapd_channel_get_confinement (channel), ==, SNAPD_CONFINEMENT_CLASSIC);
-            g_assert_cmpint (snapd_channel_get_size (channel), ==, 10000);
-            g_assert_true (date_matches (snapd_channel_get_released_at (channel), 2018, 1, 19, 13, 14, 15));
-            matched_beta = TRUE;
-        }
-        if (strcmp (snapd_channel_get_name (channel), "stable/branch") == 0) {
-            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
-            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
-            g_assert_cmpstr (snapd_channel_get_branch (channel), ==, "branch");
-            g_assert_null (snapd_channel_get_released_at (channel));
-            matched_branch = TRUE;
-        }
-        if (strcmp (snapd_channel_get_name (channel), "insider/stable") == 0) {
-            g_assert_cmpstr (snapd_channel_get_track (channel), ==, "insider");
-            g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
-            g_assert_null (snapd_channel_get_branch (channel));
-            g_assert_null (snapd_channel_get_released_at (channel));
-            matched_track = TRUE;
-        }
-    }
-    g_assert_true (matched_stable);
-    g_assert_true (matched_beta);
-    g_assert_true (matched_branch);
-    g_assert_true (matched_track);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap2");
 }
 
 static void
-test_find_channels_match (void)
+test_find_parse_descriptions (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "stable-snap");
-    MockTrack *t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "stable", NULL);
-
-    s = mock_snapd_add_store_snap (snapd, "full-snap");
-    t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "stable", NULL);
-    mock_track_add_channel (t, "candidate", NULL);
-    mock_track_add_channel (t, "beta", NULL);
-    mock_track_add_channel (t, "edge", NULL);
-
-    s = mock_snapd_add_store_snap (snapd, "beta-snap");
-    t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "beta", NULL);
-
-    s = mock_snapd_add_store_snap (snapd, "branch-snap");
-    t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "stable", NULL);
-    mock_track_add_channel (t, "stable", "branch");
-
-    s = mock_snapd_add_store_snap (snapd, "track-snap");
-    t = mock_snap_add_track (s, "latest");
-    mock_track_add_channel (t, "stable", NULL);
-    t = mock_snap_add_track (s, "insider");
-    mock_track_add_channel (t, "stable", NULL);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_description (s, "First paragraph\n\n* One\n* Two");
+    mock_snapd_add_store_snap (snapd, "snap2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4507,146 +9032,145 @@ test_find_channels_match (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    /* All channels match to stable if only stable defined */
-    g_autoptr(GPtrArray) snaps1 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "stable-snap", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps1);
-    g_assert_cmpint (snaps1->len, ==, 1);
-    SnapdSnap *snap = snaps1->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "stable-snap");
-    SnapdChannel *channel = snapd_snap_match_channel (snap, "stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "candidate");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "beta");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "edge");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "UNDEFINED");
-    g_assert_null (channel);
-
-    /* All channels match if all defined */
-    g_autoptr(GPtrArray) snaps2 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "full-snap", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps2);
-    g_assert_cmpint (snaps2->len, ==, 1);
-    snap = snaps2->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "full-snap");
-    channel = snapd_snap_match_channel (snap, "stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "candidate");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "candidate");
-    channel = snapd_snap_match_channel (snap, "beta");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
-    channel = snapd_snap_match_channel (snap, "edge");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "edge");
-    channel = snapd_snap_match_channel (snap, "UNDEFINED");
-    g_assert_null (channel);
-
-    /* Only match with more stable channels */
-    g_autoptr(GPtrArray) snaps3 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "beta-snap", NULL, NULL, &error);
+    /* Descriptions are only parsed when asked for */
+    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps3);
-    g_assert_cmpint (snaps3->len, ==, 1);
-    snap = snaps3->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "beta-snap");
-    channel = snapd_snap_match_channel (snap, "stable");
-    g_assert_null (channel);
-    channel = snapd_snap_match_channel (snap, "candidate");
-    g_assert_null (channel);
-    channel = snapd_snap_match_channel (snap, "beta");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
-    channel = snapd_snap_match_channel (snap, "edge");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "beta");
-    channel = snapd_snap_match_channel (snap, "UNDEFINED");
-    g_assert_null (channel);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_null (snapd_snap_get_description_nodes (snaps->pdata[0]));
 
-    /* Match branches */
-    g_autoptr(GPtrArray) snaps4 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "branch-snap", NULL, NULL, &error);
+    g_autoptr(GPtrArray) parsed_snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_PARSE_DESCRIPTIONS, "snap", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps4);
-    g_assert_cmpint (snaps4->len, ==, 1);
-    snap = snaps4->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "branch-snap");
-    channel = snapd_snap_match_channel (snap, "stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "stable/branch");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable/branch");
-    channel = snapd_snap_match_channel (snap, "candidate");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "beta");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "edge");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "UNDEFINED");
-    g_assert_null (channel);
+    g_assert_cmpint (parsed_snaps->len, ==, 2);
+    GPtrArray *nodes = snapd_snap_get_description_nodes (parsed_snaps->pdata[0]);
+    g_assert_nonnull (nodes);
+    g_assert_cmpint (nodes->len, ==, 2);
+    g_assert_cmpint (snapd_markdown_node_get_node_type (nodes->pdata[0]), ==, SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH);
+    g_assert_cmpint (snapd_markdown_node_get_node_type (nodes->pdata[1]), ==, SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST);
+    g_assert_nonnull (snapd_snap_get_description_nodes (parsed_snaps->pdata[1]));
+}
 
-    /* Match correct tracks */
-    g_autoptr(GPtrArray) snaps5 = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "track-snap", NULL, NULL, &error);
+static void
+test_resolve_snaps (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    for (int i = 0; i < 10; i++) {
+        g_autofree gchar *name = g_strdup_printf ("snap%d", i);
+        g_autofree gchar *common_id = g_strdup_printf ("com.example.snap%d", i);
+        MockSnap *s = mock_snapd_add_store_snap (snapd, name);
+        MockApp *a = mock_snap_add_app (s, name);
+        mock_app_set_common_id (a, common_id);
+    }
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_resolve_cache_ttl (client), ==, 300000);
+
+    /* Repeated IDs are only looked up once, and unknown ones are left out */
+    const gchar *common_ids[] = { "com.example.snap1", "com.example.snap5", "com.example.snap1", "com.example.unknown", "com.example.snap9", NULL };
+    guint n_requests = mock_snapd_get_request_count (snapd);
+    g_autoptr(GHashTable) snaps = snapd_client_resolve_snaps_sync (client, SNAPD_FIND_FLAGS_MATCH_COMMON_ID, (GStrv) common_ids, 2, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps5);
-    g_assert_cmpint (snaps5->len, ==, 1);
-    snap = snaps5->pdata[0];
-    g_assert_cmpstr (snapd_snap_get_name (snap), ==, "track-snap");
-    channel = snapd_snap_match_channel (snap, "stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
-    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "latest/stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "stable");
-    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "latest");
-    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
-    channel = snapd_snap_match_channel (snap, "insider/stable");
-    g_assert_nonnull (channel);
-    g_assert_cmpstr (snapd_channel_get_name (channel), ==, "insider/stable");
-    g_assert_cmpstr (snapd_channel_get_track (channel), ==, "insider");
-    g_assert_cmpstr (snapd_channel_get_risk (channel), ==, "stable");
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (g_hash_table_size (snaps), ==, 3);
+    g_assert_cmpstr (snapd_snap_get_name (g_hash_table_lookup (snaps, "com.example.snap1")), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_name (g_hash_table_lookup (snaps, "com.example.snap5")), ==, "snap5");
+    g_assert_cmpstr (snapd_snap_get_name (g_hash_table_lookup (snaps, "com.example.snap9")), ==, "snap9");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd) - n_requests, ==, 4);
+
+    /* IDs already resolved, including ones that didn't match, come from the cache */
+    const gchar *more_common_ids[] = { "com.example.snap5", "com.example.unknown", "com.example.snap2", NULL };
+    n_requests = mock_snapd_get_request_count (snapd);
+    g_autoptr(GHashTable) more_snaps = snapd_client_resolve_snaps_sync (client, SNAPD_FIND_FLAGS_MATCH_COMMON_ID, (GStrv) more_common_ids, 0, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_hash_table_size (more_snaps), ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (g_hash_table_lookup (more_snaps, "com.example.snap2")), ==, "snap2");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd) - n_requests, ==, 1);
+
+    /* Names are cached separately from common IDs */
+    const gchar *names[] = { "snap3", "snap4", NULL };
+    g_autoptr(GHashTable) named_snaps = snapd_client_resolve_snaps_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, (GStrv) names, 0, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_hash_table_size (named_snaps), ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (g_hash_table_lookup (named_snaps, "snap4")), ==, "snap4");
+
+    /* Clearing the cache looks them up again */
+    snapd_client_set_resolve_cache_ttl (client, 0);
+    n_requests = mock_snapd_get_request_count (snapd);
+    g_clear_pointer (&more_snaps, g_hash_table_unref);
+    more_snaps = snapd_client_resolve_snaps_sync (client, SNAPD_FIND_FLAGS_MATCH_COMMON_ID, (GStrv) more_common_ids, 0, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_hash_table_size (more_snaps), ==, 2);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd) - n_requests, ==, 3);
 }
 
-static gboolean
-cancel_cb (gpointer user_data)
+static void
+test_find_refreshable_sync (void)
 {
-    GCancellable *cancellable = user_data;
-    g_cancellable_cancel (cancellable);
-    return G_SOURCE_REMOVE;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap3");
+    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[1]), ==, "1");
 }
 
 static void
-find_cancel_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+find_refreshable_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) snaps = snapd_client_find_finish (SNAPD_CLIENT (object), result, NULL, &error);
-    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
-    g_assert_null (snaps);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (snaps->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[0]), ==, "1");
+    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap3");
+    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[1]), ==, "1");
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_find_cancel (void)
+test_find_refreshable_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "1");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4654,24 +9178,15 @@ test_find_cancel (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    /* Use a special query that never responds */
-    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
-    snapd_client_find_async (client, SNAPD_FIND_FLAGS_NONE, "do-not-respond", cancellable, find_cancel_cb, async_data_new (loop, snapd));
-    g_idle_add (cancel_cb, cancellable);
+    snapd_client_find_refreshable_async (client, NULL, find_refreshable_cb, async_data_new (loop, snapd));
 
     g_main_loop_run (loop);
 }
 
 static void
-test_find_section (void)
+test_find_refreshable_no_updates (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
-    mock_snap_add_store_section (s, "section");
-    mock_snapd_add_store_snap (snapd, "banana");
-    s = mock_snapd_add_store_snap (snapd, "carrot1");
-    mock_snap_add_store_section (s, "section");
-    mock_snapd_add_store_snap (snapd, "carrot2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4679,24 +9194,17 @@ test_find_section (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_NONE, "section", NULL, NULL, NULL, &error);
+    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_sync (client, NULL, &error);
     g_assert_no_error (error);
     g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "apple");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "carrot1");
+    g_assert_cmpint (snaps->len, ==, 0);
 }
 
 static void
-test_find_section_query (void)
+test_install_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
-    mock_snap_add_store_section (s, "section");
-    mock_snapd_add_store_snap (snapd, "banana");
-    s = mock_snapd_add_store_snap (snapd, "carrot1");
-    mock_snap_add_store_section (s, "section");
-    mock_snapd_add_store_snap (snapd, "carrot2");
+    mock_snapd_add_store_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4704,24 +9212,24 @@ test_find_section_query (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_NONE, "section", "carrot", NULL, NULL, &error);
+    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "carrot1");
+    g_assert_true (result);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap"));
+    g_assert_cmpstr (mock_snap_get_confinement (mock_snapd_find_snap (snapd, "snap")), ==, "strict");
+    g_assert_false (mock_snap_get_devmode (mock_snapd_find_snap (snapd, "snap")));
+    g_assert_false (mock_snap_get_dangerous (mock_snapd_find_snap (snapd, "snap")));
+    g_assert_false (mock_snap_get_jailmode (mock_snapd_find_snap (snapd, "snap")));
 }
 
 static void
-test_find_section_name (void)
+test_install_sync_multiple (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
-    mock_snap_add_store_section (s, "section");
-    mock_snapd_add_store_snap (snapd, "banana");
-    s = mock_snapd_add_store_snap (snapd, "carrot1");
-    mock_snap_add_store_section (s, "section");
-    s = mock_snapd_add_store_snap (snapd, "carrot2");
-    mock_snap_add_store_section (s, "section");
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -4729,200 +9237,360 @@ test_find_section_name (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_section_sync (client, SNAPD_FIND_FLAGS_MATCH_NAME, "section", "carrot1", NULL, NULL, &error);
+    g_assert_null (mock_snapd_find_snap (snapd, "snap1"));
+    g_assert_null (mock_snapd_find_snap (snapd, "snap2"));
+    g_assert_null (mock_snapd_find_snap (snapd, "snap3"));
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "carrot1");
+    g_assert_true (result);
+    result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap1"));
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap2"));
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap3"));
 }
 
 static void
-test_find_scope_narrow (void)
+install_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_install2_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap"));
+    g_assert_cmpstr (mock_snap_get_confinement (mock_snapd_find_snap (data->snapd, "snap")), ==, "strict");
+    g_assert_false (mock_snap_get_devmode (mock_snapd_find_snap (data->snapd, "snap")));
+    g_assert_false (mock_snap_get_dangerous (mock_snapd_find_snap (data->snapd, "snap")));
+    g_assert_false (mock_snap_get_jailmode (mock_snapd_find_snap (data->snapd, "snap")));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_install_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, install_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+install_multiple_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_install2_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+
+    data->counter--;
+    if (data->counter == 0) {
+        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap1"));
+        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap2"));
+        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap3"));
+
+        g_main_loop_quit (data->loop);
+
+        async_data_free (data);
+    }
+}
+
+static void
+test_install_async_multiple (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_snap (snapd, "snap1"));
+    g_assert_null (mock_snapd_find_snap (snapd, "snap2"));
+    g_assert_null (mock_snapd_find_snap (snapd, "snap3"));
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
+}
+
+static void
+test_install_async_multiple_connections (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
-    s = mock_snapd_add_store_snap (snapd, "snap2");
-    mock_snap_set_scope_is_wide (s, TRUE);
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_max_connections (client), ==, 1);
+    snapd_client_set_max_connections (client, 2);
+    g_assert_cmpint (snapd_client_get_max_connections (client), ==, 2);
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_NONE, "snap", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
+
+    /* Zero restores the default */
+    snapd_client_set_max_connections (client, 0);
+    g_assert_cmpint (snapd_client_get_max_connections (client), ==, 1);
 }
 
 static void
-test_find_scope_wide (void)
+test_install_async_multiple_pipelined (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
-    s = mock_snapd_add_store_snap (snapd, "snap2");
-    mock_snap_set_scope_is_wide (s, TRUE);
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_max_pipeline_depth (client), ==, 16);
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_SCOPE_WIDE, "snap", NULL, NULL, &error);
+    /* Only one request is sent at a time, the others wait for it to complete */
+    snapd_client_set_max_pipeline_depth (client, 1);
+    g_assert_cmpint (snapd_client_get_max_pipeline_depth (client), ==, 1);
+
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
+
+    /* Zero restores the default */
+    snapd_client_set_max_pipeline_depth (client, 0);
+    g_assert_cmpint (snapd_client_get_max_pipeline_depth (client), ==, 16);
+}
+
+typedef struct
+{
+    GMainLoop *loop;
+    GString *order;
+    int counter;
+} RequestPriorityData;
+
+static void
+request_priority_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    RequestPriorityData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap2");
+    g_assert_nonnull (snap);
+
+    if (data->order->len > 0)
+        g_string_append_c (data->order, ' ');
+    g_string_append (data->order, snapd_snap_get_name (snap));
+
+    data->counter--;
+    if (data->counter == 0)
+        g_main_loop_quit (data->loop);
 }
 
 static void
-test_find_common_id (void)
+test_request_priority (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap1");
-    MockApp *a = mock_snap_add_app (s, "snap1");
-    mock_app_set_common_id (a, "com.example.snap1");
-    s = mock_snapd_add_store_snap (snapd, "snap2");
-    a = mock_snap_add_app (s, "snap2");
-    mock_app_set_common_id (a, "com.example.snap2");
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
+    mock_snapd_add_snap (snapd, "snap4");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_pipeline_depth (client, 1);
+    g_assert_cmpint (snapd_client_get_request_priority (client), ==, SNAPD_REQUEST_PRIORITY_NORMAL);
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_sync (client, SNAPD_FIND_FLAGS_MATCH_COMMON_ID, "com.example.snap2", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 1);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap2");
+    /* The first request is sent straight away, the others wait and the high priority one jumps the queue */
+    g_autoptr(GString) order = g_string_new ("");
+    RequestPriorityData data = { loop, order, 4 };
+    snapd_client_get_snap_async (client, "snap1", NULL, request_priority_cb, &data);
+    snapd_client_set_request_priority (client, SNAPD_REQUEST_PRIORITY_LOW);
+    snapd_client_get_snap_async (client, "snap2", NULL, request_priority_cb, &data);
+    snapd_client_get_snap_async (client, "snap3", NULL, request_priority_cb, &data);
+    snapd_client_set_request_priority (client, SNAPD_REQUEST_PRIORITY_HIGH);
+    g_assert_cmpint (snapd_client_get_request_priority (client), ==, SNAPD_REQUEST_PRIORITY_HIGH);
+    snapd_client_get_snap_async (client, "snap4", NULL, request_priority_cb, &data);
+    g_main_loop_run (loop);
+
+    g_assert_cmpstr (order->str, ==, "snap1 snap4 snap2 snap3");
 }
 
 static void
-test_find_refreshable_sync (void)
+test_install_async_multiple_batched (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_snap (snapd, "snap3");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_store_snap (snapd, "snap1");
-    mock_snap_set_revision (s, "1");
-    s = mock_snapd_add_store_snap (snapd, "snap3");
-    mock_snap_set_revision (s, "1");
+    mock_snapd_set_progress_listed_changes (snapd, TRUE);
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_batch_polls (client));
+    snapd_client_set_batch_polls (client, TRUE);
+    g_assert_true (snapd_client_get_batch_polls (client));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[0]), ==, "1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap3");
-    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[1]), ==, "1");
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
 }
 
-static void
-find_refreshable_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+static gboolean
+leave_background_cb (gpointer user_data)
 {
-    g_autoptr(AsyncData) data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 2);
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[0]), ==, "snap1");
-    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[0]), ==, "1");
-    g_assert_cmpstr (snapd_snap_get_name (snaps->pdata[1]), ==, "snap3");
-    g_assert_cmpstr (snapd_snap_get_revision (snaps->pdata[1]), ==, "1");
-
-    g_main_loop_quit (data->loop);
+    SnapdClient *client = user_data;
+    snapd_client_set_background (client, FALSE);
+    return G_SOURCE_REMOVE;
 }
 
 static void
-test_find_refreshable_async (void)
+test_install_async_multiple_background (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_snap (snapd, "snap2");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_snap (snapd, "snap3");
-    mock_snap_set_revision (s, "0");
-    s = mock_snapd_add_store_snap (snapd, "snap1");
-    mock_snap_set_revision (s, "1");
-    s = mock_snapd_add_store_snap (snapd, "snap3");
-    mock_snap_set_revision (s, "1");
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
+    /* Start polling slowly, then speed up when returning from the background */
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_background (client));
+    snapd_client_set_background (client, TRUE);
+    g_assert_true (snapd_client_get_background (client));
 
-    snapd_client_find_refreshable_async (client, NULL, find_refreshable_cb, async_data_new (loop, snapd));
-
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_timeout_add (100, leave_background_cb, client);
     g_main_loop_run (loop);
+    g_assert_false (snapd_client_get_background (client));
 }
 
 static void
-test_find_refreshable_no_updates (void)
+test_install_async_multiple_notices (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_supports_notices (snapd, TRUE);
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
+    /* Poll so slowly that the operations can only complete in time using notices */
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_poll_interval (client, 600000);
+    snapd_client_set_max_poll_interval (client, 600000);
+    g_assert_false (snapd_client_get_use_notices (client));
+    snapd_client_set_use_notices (client, TRUE);
+    g_assert_true (snapd_client_get_use_notices (client));
 
-    g_autoptr(GPtrArray) snaps = snapd_client_find_refreshable_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snaps);
-    g_assert_cmpint (snaps->len, ==, 0);
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
 }
 
 static void
-test_install_sync (void)
+test_install_async_notices_unsupported (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_use_notices (client, TRUE);
 
-    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
-    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap"));
-    g_assert_cmpstr (mock_snap_get_confinement (mock_snapd_find_snap (snapd, "snap")), ==, "strict");
-    g_assert_false (mock_snap_get_devmode (mock_snapd_find_snap (snapd, "snap")));
-    g_assert_false (mock_snap_get_dangerous (mock_snapd_find_snap (snapd, "snap")));
-    g_assert_false (mock_snap_get_jailmode (mock_snapd_find_snap (snapd, "snap")));
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
 }
 
 static void
-test_install_sync_multiple (void)
+test_install_async_io_thread (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     mock_snapd_add_store_snap (snapd, "snap1");
     mock_snapd_add_store_snap (snapd, "snap2");
@@ -4933,108 +9601,107 @@ test_install_sync_multiple (void)
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_false (snapd_client_get_use_io_thread (client));
+    snapd_client_set_use_io_thread (client, TRUE);
+    g_assert_true (snapd_client_get_use_io_thread (client));
 
-    g_assert_null (mock_snapd_find_snap (snapd, "snap1"));
-    g_assert_null (mock_snapd_find_snap (snapd, "snap2"));
-    g_assert_null (mock_snapd_find_snap (snapd, "snap3"));
-    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap1"));
-    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap2"));
-    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap3"));
+    AsyncData *data = async_data_new (loop, snapd);
+    data->counter = 3;
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
+    g_main_loop_run (loop);
 }
 
-static void
-install_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+static gpointer
+submit_thread_func (gpointer user_data)
 {
-    g_autoptr(AsyncData) data = user_data;
+    SnapdClient *client = user_data;
 
-    g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_install2_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap"));
-    g_assert_cmpstr (mock_snap_get_confinement (mock_snapd_find_snap (data->snapd, "snap")), ==, "strict");
-    g_assert_false (mock_snap_get_devmode (mock_snapd_find_snap (data->snapd, "snap")));
-    g_assert_false (mock_snap_get_dangerous (mock_snapd_find_snap (data->snapd, "snap")));
-    g_assert_false (mock_snap_get_jailmode (mock_snapd_find_snap (data->snapd, "snap")));
+    for (int i = 0; i < 50; i++) {
+        g_autoptr(GError) error = NULL;
+        g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_cmpstr (snapd_system_information_get_version (info), ==, "VERSION");
+    }
 
-    g_main_loop_quit (data->loop);
+    return NULL;
 }
 
 static void
-test_install_async (void)
+test_io_thread_many_submitters (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_use_io_thread (client, TRUE);
 
-    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
-    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, install_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    // Requests from many threads at once are all picked up by the I/O thread
+    GThread *threads[8];
+    for (guint i = 0; i < G_N_ELEMENTS (threads); i++)
+        threads[i] = g_thread_new ("submitter", submit_thread_func, client);
+    for (guint i = 0; i < G_N_ELEMENTS (threads); i++)
+        g_thread_join (threads[i]);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 8 * 50);
 }
 
-static void
-install_multiple_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+typedef struct
 {
-    AsyncData *data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_install2_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
+    GMainContext *context;
+    GMainLoop *loop;
+} SharedIoData;
 
-    data->counter--;
-    if (data->counter == 0) {
-        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap1"));
-        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap2"));
-        g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap3"));
+static gpointer
+shared_io_thread_func (gpointer user_data)
+{
+    SharedIoData *data = user_data;
 
-        g_main_loop_quit (data->loop);
+    g_main_context_push_thread_default (data->context);
+    g_main_loop_run (data->loop);
+    g_main_context_pop_thread_default (data->context);
 
-        async_data_free (data);
-    }
+    return NULL;
 }
 
 static void
-test_install_async_multiple (void)
+test_install_sync_shared_io_context (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     mock_snapd_add_store_snap (snapd, "snap1");
     mock_snapd_add_store_snap (snapd, "snap2");
-    mock_snapd_add_store_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(GMainContext) io_context = g_main_context_new ();
+    g_autoptr(GMainLoop) io_loop = g_main_loop_new (io_context, FALSE);
+    SharedIoData io_data = { io_context, io_loop };
+    GThread *io_thread = g_thread_new ("shared-io", shared_io_thread_func, &io_data);
+
+    g_autoptr(SnapdClient) client1 = snapd_client_new ();
+    snapd_client_set_socket_path (client1, mock_snapd_get_socket_path (snapd));
+    g_assert_null (snapd_client_get_io_context (client1));
+    snapd_client_set_io_context (client1, io_context);
+    g_assert_true (snapd_client_get_io_context (client1) == io_context);
+    g_autoptr(SnapdClient) client2 = snapd_client_new ();
+    snapd_client_set_socket_path (client2, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_io_context (client2, io_context);
+
+    g_assert_true (snapd_client_install2_sync (client1, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_true (snapd_client_install2_sync (client2, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, &error));
+    g_assert_no_error (error);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap1"));
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap2"));
 
-    g_assert_null (mock_snapd_find_snap (snapd, "snap1"));
-    g_assert_null (mock_snapd_find_snap (snapd, "snap2"));
-    g_assert_null (mock_snapd_find_snap (snapd, "snap3"));
-    AsyncData *data = async_data_new (loop, snapd);
-    data->counter = 3;
-    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap1", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
-    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap2", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
-    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap3", NULL, NULL, NULL, NULL, NULL, install_multiple_cb, data);
-    g_main_loop_run (loop);
+    g_clear_object (&client1);
+    g_clear_object (&client2);
+    g_main_loop_quit (io_loop);
+    g_thread_join (io_thread);
 }
 
 static void
@@ -5327,6 +9994,129 @@ test_install_progress (void)
     g_assert_cmpint (install_progress_data.progress_done, >, 0);
 }
 
+typedef struct
+{
+    int n_calls;
+    int n_estimates;
+} InstallEstimateData;
+
+static void
+install_estimate_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    InstallEstimateData *data = user_data;
+
+    data->n_calls++;
+
+    SnapdTask *task = snapd_change_get_tasks (change)->pdata[0];
+    if (snapd_task_get_progress_rate (task) > 0 && snapd_task_get_estimated_ready_time (task) != NULL) {
+        g_autoptr(GDateTime) now = g_date_time_new_now_utc ();
+        g_assert_cmpint (g_date_time_compare (snapd_task_get_estimated_ready_time (task), now), >=, 0);
+        data->n_estimates++;
+    }
+    if (snapd_task_get_progress_done (task) >= snapd_task_get_progress_total (task))
+        g_assert_null (snapd_task_get_estimated_ready_time (task));
+}
+
+static void
+test_install_progress_estimate (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_progress_total (snapd, 5);
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_poll_interval (client, 10);
+
+    /* The rate is known once progress has been seen in two polls */
+    InstallEstimateData data = { 0, 0 };
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, install_estimate_progress_cb, &data, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (data.n_calls, >, 1);
+    g_assert_cmpint (data.n_estimates, >, 0);
+}
+
+typedef struct
+{
+    InstallProgressData install_progress_data;
+    GThread *thread;
+} InstallProgressThreadData;
+
+static void
+install_progress_thread_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    InstallProgressThreadData *data = user_data;
+
+    g_assert_true (g_thread_self () == data->thread);
+    install_progress_cb (client, change, deprecated, &data->install_progress_data);
+}
+
+static void
+test_install_progress_io_thread (void)
+{
+    InstallProgressThreadData data;
+    data.install_progress_data.progress_done = 0;
+    data.install_progress_data.spawn_time = "2017-01-02T11:23:58Z";
+    data.install_progress_data.ready_time = "2017-01-03T00:00:00Z";
+    data.thread = g_thread_self ();
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_spawn_time (snapd, data.install_progress_data.spawn_time);
+    mock_snapd_set_ready_time (snapd, data.install_progress_data.ready_time);
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_use_io_thread (client, TRUE);
+
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, install_progress_thread_cb, &data, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (data.install_progress_data.progress_done, >, 0);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap"));
+}
+
+static void
+install_progress_nested_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    int *n_calls = user_data;
+
+    /* Sync calls can be made while another one is in progress */
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+
+    (*n_calls)++;
+}
+
+static void
+test_install_progress_nested_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    int n_calls = 0;
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, install_progress_nested_cb, &n_calls, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (n_calls, >, 0);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap"));
+}
+
 static void
 test_install_needs_classic (void)
 {
@@ -5600,13 +10390,225 @@ test_install_snapd_restart (void)
 }
 
 static void
-test_install_async_snapd_restart (void)
+test_install_async_snapd_restart (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_restart_required (s, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
+    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, install_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_install_auth_cancelled (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap");
+    mock_snapd_set_decline_auth (snapd, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_CANCELLED);
+    g_assert_false (result);
+}
+
+static void
+test_install_stream_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_snap (snapd, "sideload"));
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
+    gboolean result = snapd_client_install_stream_sync (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
+    g_assert_cmpstr (mock_snap_get_confinement (snap), ==, "strict");
+    g_assert_false (mock_snap_get_dangerous (snap));
+    g_assert_false (mock_snap_get_devmode (snap));
+    g_assert_false (mock_snap_get_jailmode (snap));
+}
+
+static void
+install_stream_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_install_stream_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    MockSnap *snap = mock_snapd_find_snap (data->snapd, "sideload");
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
+    g_assert_cmpstr (mock_snap_get_confinement (snap), ==, "strict");
+    g_assert_false (mock_snap_get_dangerous (snap));
+    g_assert_false (mock_snap_get_devmode (snap));
+    g_assert_false (mock_snap_get_jailmode (snap));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_install_stream_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_snap (snapd, "sideload"));
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
+    snapd_client_install_stream_async (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, install_stream_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_install_stream_large (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    /* Larger than the blocks the stream is sent in */
+    gsize length = 200000;
+    g_autofree gchar *data = g_malloc (length + 1);
+    memset (data, 'S', length);
+    data[length] = '\0';
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data (data, length, NULL);
+    gboolean result = snapd_client_install_stream_sync (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (mock_snap_get_data (snap), ==, data);
+}
+
+static void
+test_install_stream_expect_continue (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_assert_cmpint (snapd_client_get_expect_continue_size (client), ==, 1048576);
+
+    /* The body is sent once snapd accepts the request, then straight away when disabled */
+    for (int i = 0; i < 2; i++) {
+        snapd_client_set_expect_continue_size (client, i == 0 ? 1 : 0);
+        g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
+        gboolean result = snapd_client_install_stream_sync (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, &error);
+        g_assert_no_error (error);
+        g_assert_true (result);
+        MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
+        g_assert_nonnull (snap);
+        g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
+    }
+}
+
+typedef struct
+{
+    goffset sent;
+    goffset total;
+    int n_reports;
+} UploadProgressData;
+
+static void
+upload_progress_cb (SnapdClient *client, goffset sent, goffset total, goffset bytes_per_second, gpointer user_data)
+{
+    UploadProgressData *data = user_data;
+
+    g_assert_cmpint (sent, >=, data->sent);
+    g_assert_cmpint (bytes_per_second, >=, 0);
+    data->sent = sent;
+    data->total = total;
+    data->n_reports++;
+}
+
+static void
+test_install_stream_upload_progress (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    UploadProgressData progress = { 0 };
+    snapd_client_set_upload_progress_callback (client, upload_progress_cb, &progress, NULL);
+
+    /* Sent in several blocks, the total isn't known until the end of the stream */
+    gsize length = 200000;
+    g_autofree gchar *data = g_malloc (length + 1);
+    memset (data, 'S', length);
+    data[length] = '\0';
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data (data, length, NULL);
+    gboolean result = snapd_client_install_stream_sync (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (progress.sent, ==, length);
+    g_assert_cmpint (progress.total, ==, length);
+    g_assert_cmpint (progress.n_reports, >, 1);
+}
+
+typedef struct
+{
+    int progress_done;
+} InstallStreamProgressData;
+
+static gchar *
+make_snap_file (const gchar *contents)
+{
+    gchar *path = NULL;
+    int fd = g_file_open_tmp ("snapd-glib-test-XXXXXX.snap", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    g_assert_true (g_file_set_contents (path, contents, -1, NULL));
+    return path;
+}
+
+static void
+test_install_fd_sync (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_restart_required (s, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -5614,34 +10616,47 @@ test_install_async_snapd_restart (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_snap (snapd, "snap"));
-    snapd_client_install2_async (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, install_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autofree gchar *path = make_snap_file ("SNAP");
+    int fd = open (path, O_RDONLY);
+    g_assert_cmpint (fd, >=, 0);
+    gboolean result = snapd_client_install_fd_sync (client, SNAPD_INSTALL_FLAGS_DANGEROUS, fd, NULL, NULL, NULL, &error);
+    close (fd);
+    unlink (path);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
+    g_assert_true (mock_snap_get_dangerous (snap));
 }
 
 static void
-test_install_auth_cancelled (void)
+test_install_fd_upload_progress (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
-    mock_snapd_set_decline_auth (snapd, TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    UploadProgressData progress = { 0 };
+    snapd_client_set_upload_progress_callback (client, upload_progress_cb, &progress, NULL);
 
-    gboolean result = snapd_client_install2_sync (client, SNAPD_INSTALL_FLAGS_NONE, "snap", NULL, NULL, NULL, NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_CANCELLED);
-    g_assert_false (result);
+    g_autofree gchar *path = make_snap_file ("SNAP");
+    gboolean result = snapd_client_install_path_sync (client, SNAPD_INSTALL_FLAGS_NONE, path, NULL, NULL, NULL, &error);
+    unlink (path);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (progress.sent, ==, 4);
+    g_assert_cmpint (progress.total, ==, 4);
+    g_assert_cmpint (progress.n_reports, ==, 1);
 }
 
 static void
-test_install_stream_sync (void)
+test_install_fd_pipe (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -5649,47 +10664,42 @@ test_install_stream_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_snap (snapd, "sideload"));
-    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
-    gboolean result = snapd_client_install_stream_sync (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, &error);
+    /* Non-regular files are read until the end */
+    int fds[2];
+    g_assert_cmpint (pipe (fds), ==, 0);
+    g_assert_cmpint (write (fds[1], "SNAP", 4), ==, 4);
+    close (fds[1]);
+    gboolean result = snapd_client_install_fd_sync (client, SNAPD_INSTALL_FLAGS_NONE, fds[0], NULL, NULL, NULL, &error);
+    close (fds[0]);
     g_assert_no_error (error);
     g_assert_true (result);
     MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
     g_assert_nonnull (snap);
     g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
-    g_assert_cmpstr (mock_snap_get_confinement (snap), ==, "strict");
-    g_assert_false (mock_snap_get_dangerous (snap));
-    g_assert_false (mock_snap_get_devmode (snap));
-    g_assert_false (mock_snap_get_jailmode (snap));
 }
 
 static void
-install_stream_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+install_path_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_install_stream_finish (SNAPD_CLIENT (object), result, &error);
+    gboolean r = snapd_client_install_path_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
     g_assert_true (r);
     MockSnap *snap = mock_snapd_find_snap (data->snapd, "sideload");
     g_assert_nonnull (snap);
     g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
-    g_assert_cmpstr (mock_snap_get_confinement (snap), ==, "strict");
-    g_assert_false (mock_snap_get_dangerous (snap));
-    g_assert_false (mock_snap_get_devmode (snap));
-    g_assert_false (mock_snap_get_jailmode (snap));
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_install_stream_async (void)
+test_install_path_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -5697,16 +10707,28 @@ test_install_stream_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_snap (snapd, "sideload"));
-    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
-    snapd_client_install_stream_async (client, SNAPD_INSTALL_FLAGS_NONE, stream, NULL, NULL, NULL, install_stream_cb, async_data_new (loop, snapd));
+    g_autofree gchar *path = make_snap_file ("SNAP");
+    snapd_client_install_path_async (client, SNAPD_INSTALL_FLAGS_NONE, path, NULL, NULL, NULL, install_path_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
+    unlink (path);
 }
 
-typedef struct
+static void
+test_install_path_missing (void)
 {
-    int progress_done;
-} InstallStreamProgressData;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_install_path_sync (client, SNAPD_INSTALL_FLAGS_NONE, "/nonexistent/file.snap", NULL, NULL, NULL, &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+    g_assert_false (result);
+    g_assert_null (mock_snapd_find_snap (snapd, "sideload"));
+}
 
 static void
 install_stream_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
@@ -5740,6 +10762,37 @@ test_install_stream_progress (void)
     g_assert_cmpint (install_stream_progress_data.progress_done, >, 0);
 }
 
+static void
+install_stream_release_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    GInputStream **stream = user_data;
+
+    // Stream has been freed once sent, while the change is still being polled
+    g_assert_null (*stream);
+}
+
+static void
+test_install_stream_release_body (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    GInputStream *stream = g_memory_input_stream_new_from_data ("SNAP", 4, NULL);
+    g_object_add_weak_pointer (G_OBJECT (stream), (gpointer *) &stream);
+    snapd_client_install_stream_async (client, SNAPD_INSTALL_FLAGS_NONE, stream, install_stream_release_progress_cb, &stream, NULL, install_stream_cb, async_data_new (loop, snapd));
+    g_object_unref (stream);
+    g_assert_nonnull (stream);
+    g_main_loop_run (loop);
+    g_assert_null (stream);
+}
+
 static void
 test_install_stream_classic (void)
 {
@@ -6217,20 +11270,297 @@ test_refresh_all_progress (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    RefreshAllProgressData refresh_all_progress_data;
-    refresh_all_progress_data.progress_done = 0;
-    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, refresh_all_progress_cb, &refresh_all_progress_data, NULL, &error);
+    RefreshAllProgressData refresh_all_progress_data;
+    refresh_all_progress_data.progress_done = 0;
+    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, refresh_all_progress_cb, &refresh_all_progress_data, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 2);
+    g_assert_cmpstr (snap_names[0], ==, "snap1");
+    g_assert_cmpstr (snap_names[1], ==, "snap3");
+    g_assert_cmpint (refresh_all_progress_data.progress_done, >, 0);
+}
+
+typedef struct
+{
+    SnapdChange *change;
+    int n_reused;
+} RefreshAllReuseData;
+
+static void
+refresh_all_reuse_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    RefreshAllReuseData *data = user_data;
+
+    /* Tasks that haven't moved since the last poll are the same objects */
+    GPtrArray *tasks = snapd_change_get_tasks (change);
+    GPtrArray *previous_tasks = data->change != NULL ? snapd_change_get_tasks (data->change) : NULL;
+    for (guint i = 0; previous_tasks != NULL && i < tasks->len && i < previous_tasks->len; i++) {
+        SnapdTask *task = tasks->pdata[i], *previous_task = previous_tasks->pdata[i];
+        g_assert_cmpstr (snapd_task_get_id (task), ==, snapd_task_get_id (previous_task));
+        if (g_strcmp0 (snapd_task_get_status (task), snapd_task_get_status (previous_task)) == 0 &&
+            snapd_task_get_progress_done (task) == snapd_task_get_progress_done (previous_task)) {
+            g_assert_true (task == previous_task);
+            data->n_reused++;
+        }
+        else
+            g_assert_true (task != previous_task);
+    }
+
+    g_set_object (&data->change, change);
+}
+
+static void
+test_refresh_all_progress_reuse (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    RefreshAllReuseData data = { NULL, 0 };
+    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, refresh_all_reuse_progress_cb, &data, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 2);
+    g_assert_cmpint (data.n_reused, >, 0);
+    g_clear_object (&data.change);
+}
+
+typedef struct
+{
+    int n_calls;
+    int n_changed;
+} RefreshAllDeltaData;
+
+static void
+refresh_all_delta_cb (SnapdClient *client, SnapdChange *change, GPtrArray *changed_tasks, gpointer user_data)
+{
+    RefreshAllDeltaData *data = user_data;
+
+    g_assert_cmpint (changed_tasks->len, >, 0);
+    for (guint i = 0; i < changed_tasks->len; i++) {
+        SnapdTask *task = changed_tasks->pdata[i];
+        gboolean in_change = FALSE;
+        GPtrArray *tasks = snapd_change_get_tasks (change);
+        for (guint j = 0; j < tasks->len; j++) {
+            if (tasks->pdata[j] == task)
+                in_change = TRUE;
+        }
+        g_assert_true (in_change);
+    }
+
+    data->n_calls++;
+    data->n_changed += changed_tasks->len;
+}
+
+static void
+test_refresh_all_progress_delta (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    /* Only the tasks that moved are reported, not both every time */
+    RefreshAllDeltaData data = { 0, 0 };
+    snapd_client_set_progress_delta_callback (client, refresh_all_delta_cb, &data, NULL);
+    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 2);
+    g_assert_cmpint (data.n_calls, >, 1);
+    g_assert_cmpint (data.n_changed, <, data.n_calls * 2);
+}
+
+typedef struct
+{
+    int n_calls;
+    gboolean ready;
+} RefreshAllRateLimitData;
+
+static void
+refresh_all_rate_limit_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    RefreshAllRateLimitData *data = user_data;
+    data->n_calls++;
+    data->ready = snapd_change_get_ready (change);
+}
+
+static void
+test_refresh_all_progress_rate_limit (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    const gchar *names[] = { "snap1", "snap2", "snap3", NULL };
+    for (int i = 0; names[i] != NULL; i++) {
+        MockSnap *s = mock_snapd_add_snap (snapd, names[i]);
+        mock_snap_set_revision (s, "0");
+        s = mock_snapd_add_store_snap (snapd, names[i]);
+        mock_snap_set_revision (s, "1");
+    }
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_poll_interval (client, 1);
+    snapd_client_set_min_progress_interval (client, 60000);
+    g_assert_cmpint (snapd_client_get_min_progress_interval (client), ==, 60000);
+
+    /* Only the first report and the final state get through */
+    RefreshAllRateLimitData data = { 0, FALSE };
+    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, refresh_all_rate_limit_progress_cb, &data, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 3);
+    g_assert_cmpint (data.n_calls, ==, 2);
+    g_assert_true (data.ready);
+}
+
+static void
+test_refresh_all_no_updates (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 0);
+}
+
+static void
+count_tasks_progress_cb (SnapdClient *client, SnapdChange *change, gpointer deprecated, gpointer user_data)
+{
+    guint *n_tasks = user_data;
+    *n_tasks = snapd_change_get_tasks (change)->len;
+}
+
+static void
+test_install_many_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snapd_add_store_snap (snapd, "snap3");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    const gchar *names[] = { "snap1", "snap3", NULL };
+    guint n_tasks = 0;
+    g_auto(GStrv) snap_names = snapd_client_install_many_sync (client, (GStrv) names, count_tasks_progress_cb, &n_tasks, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 2);
+    g_assert_cmpstr (snap_names[0], ==, "snap1");
+    g_assert_cmpstr (snap_names[1], ==, "snap3");
+    g_assert_cmpint (n_tasks, ==, 2);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap1"));
+    g_assert_null (mock_snapd_find_snap (snapd, "snap2"));
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap3"));
+}
+
+static void
+test_install_many_not_available (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_snap (snapd, "snap1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    const gchar *names[] = { "snap1", "snap2", NULL };
+    g_auto(GStrv) snap_names = snapd_client_install_many_sync (client, (GStrv) names, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_null (snap_names);
+    g_assert_null (mock_snapd_find_snap (snapd, "snap1"));
+}
+
+static void
+test_refresh_many_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "0");
+    s = mock_snapd_add_store_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "1");
+    s = mock_snapd_add_store_snap (snapd, "snap3");
+    mock_snap_set_revision (s, "1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    const gchar *names[] = { "snap2", "snap3", NULL };
+    g_auto(GStrv) snap_names = snapd_client_refresh_many_sync (client, (GStrv) names, NULL, NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_cmpint (g_strv_length (snap_names), ==, 2);
-    g_assert_cmpstr (snap_names[0], ==, "snap1");
+    g_assert_cmpstr (snap_names[0], ==, "snap2");
     g_assert_cmpstr (snap_names[1], ==, "snap3");
-    g_assert_cmpint (refresh_all_progress_data.progress_done, >, 0);
 }
 
 static void
-test_refresh_all_no_updates (void)
+remove_many_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_auto(GStrv) snap_names = snapd_client_remove_many_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (g_strv_length (snap_names), ==, 2);
+    g_assert_null (mock_snapd_find_snap (data->snapd, "snap1"));
+    g_assert_nonnull (mock_snapd_find_snap (data->snapd, "snap2"));
+    g_assert_null (mock_snapd_find_snap (data->snapd, "snap3"));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_remove_many_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    mock_snapd_add_snap (snapd, "snap3");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6238,9 +11568,28 @@ test_refresh_all_no_updates (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) snap_names = snapd_client_refresh_all_sync (client, NULL, NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_cmpint (g_strv_length (snap_names), ==, 0);
+    const gchar *names[] = { "snap1", "snap3", NULL };
+    snapd_client_remove_many_async (client, (GStrv) names, NULL, NULL, NULL, remove_many_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_remove_many_not_installed (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    const gchar *names[] = { "snap1", "snap2", NULL };
+    g_auto(GStrv) snap_names = snapd_client_remove_many_sync (client, (GStrv) names, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_INSTALLED);
+    g_assert_null (snap_names);
+    g_assert_nonnull (mock_snapd_find_snap (snapd, "snap1"));
 }
 
 static void
@@ -6773,13 +12122,226 @@ test_switch_not_installed (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_switch_sync (client, "snap", "beta", NULL, NULL, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_INSTALLED);
+    gboolean result = snapd_client_switch_sync (client, "snap", "beta", NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_INSTALLED);
+    g_assert_false (result);
+}
+
+static void
+test_check_buy_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, TRUE);
+    mock_account_set_has_payment_methods (a, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+}
+
+static void
+check_buy_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_check_buy_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_check_buy_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, TRUE);
+    mock_account_set_has_payment_methods (a, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    snapd_client_check_buy_async (client, NULL, check_buy_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_check_buy_terms_not_accepted (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, FALSE);
+    mock_account_set_has_payment_methods (a, TRUE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TERMS_NOT_ACCEPTED);
+    g_assert_false (result);
+}
+
+static void
+test_check_buy_no_payment_methods (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, TRUE);
+    mock_account_set_has_payment_methods (a, FALSE);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_NOT_SETUP);
+    g_assert_false (result);
+}
+
+static void
+test_check_buy_not_logged_in (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
+    g_assert_false (result);
+}
+
+static void
+test_buy_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, TRUE);
+    mock_account_set_has_payment_methods (a, TRUE);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+}
+
+static void
+buy_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_buy_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_buy_async (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, TRUE);
+    mock_account_set_has_payment_methods (a, TRUE);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+
+    snapd_client_buy_async (client, "ABCDEF", 1.25, "NZD", NULL, buy_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_buy_not_logged_in (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
     g_assert_false (result);
 }
 
 static void
-test_check_buy_sync (void)
+test_buy_not_available (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
@@ -6797,33 +12359,48 @@ test_check_buy_sync (void)
     g_assert_nonnull (user_information);
     snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_true (result);
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_false (result);
 }
 
 static void
-check_buy_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_buy_terms_not_accepted (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
+    mock_account_set_terms_accepted (a, FALSE);
+    mock_account_set_has_payment_methods (a, FALSE);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
 
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_check_buy_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
+    g_assert_nonnull (user_information);
+    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-    g_main_loop_quit (data->loop);
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TERMS_NOT_ACCEPTED);
+    g_assert_false (result);
 }
 
 static void
-test_check_buy_async (void)
+test_buy_no_payment_methods (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
     mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, TRUE);
+    mock_account_set_has_payment_methods (a, FALSE);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6836,17 +12413,21 @@ test_check_buy_async (void)
     g_assert_nonnull (user_information);
     snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-    snapd_client_check_buy_async (client, NULL, check_buy_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_NOT_SETUP);
+    g_assert_false (result);
 }
 
 static void
-test_check_buy_terms_not_accepted (void)
+test_buy_invalid_price (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, FALSE);
+    mock_account_set_terms_accepted (a, TRUE);
     mock_account_set_has_payment_methods (a, TRUE);
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
+    mock_snap_set_id (s, "ABCDEF");
+    mock_snap_add_price (s, 1.25, "NZD");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6859,18 +12440,15 @@ test_check_buy_terms_not_accepted (void)
     g_assert_nonnull (user_information);
     snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
 
-    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TERMS_NOT_ACCEPTED);
+    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 0.75, "NZD", NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_DECLINED);
     g_assert_false (result);
 }
 
 static void
-test_check_buy_no_payment_methods (void)
+test_create_user_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6878,18 +12456,44 @@ test_check_buy_no_payment_methods (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
+    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_NONE, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_assert_nonnull (info);
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "user");
+    GStrv ssh_keys = snapd_user_information_get_ssh_keys (info);
+    g_assert_nonnull (ssh_keys);
+    g_assert_cmpint (g_strv_length (ssh_keys), ==, 2);
+    g_assert_cmpstr (ssh_keys[0], ==, "KEY1");
+    g_assert_cmpstr (ssh_keys[1], ==, "KEY2");
+    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
+    g_assert_nonnull (account);
+    g_assert_false (mock_account_get_sudoer (account));
+    g_assert_false (mock_account_get_known (account));
+}
 
-    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_NOT_SETUP);
-    g_assert_false (result);
+static void
+test_create_user_sudo (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
+    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_SUDO, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
+    g_assert_nonnull (account);
+    g_assert_true (mock_account_get_sudoer (account));
 }
 
 static void
-test_check_buy_not_logged_in (void)
+test_create_user_known (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -6899,21 +12503,19 @@ test_check_buy_not_logged_in (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_check_buy_sync (client, NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
-    g_assert_false (result);
+    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
+    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_KNOWN, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
+    g_assert_nonnull (account);
+    g_assert_true (mock_account_get_known (account));
 }
 
 static void
-test_buy_sync (void)
+test_create_users_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, TRUE);
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6921,41 +12523,83 @@ test_buy_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_autoptr(GPtrArray) users_info = snapd_client_create_users_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_assert_nonnull (users_info);
+    g_assert_cmpint (users_info->len, ==, 3);
+    SnapdUserInformation *info = users_info->pdata[0];
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "admin");
+    GStrv ssh_keys = snapd_user_information_get_ssh_keys (info);
+    g_assert_nonnull (ssh_keys);
+    g_assert_cmpint (g_strv_length (ssh_keys), ==, 2);
+    g_assert_cmpstr (ssh_keys[0], ==, "KEY1");
+    g_assert_cmpstr (ssh_keys[1], ==, "KEY2");
+    info = users_info->pdata[1];
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
+    info = users_info->pdata[2];
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
+    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "admin"));
+    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "alice"));
+    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "bob"));
+}
 
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
+static void
+test_get_users_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_account (snapd, "alice@example.com", "alice", "secret");
+    mock_snapd_add_account (snapd, "bob@example.com", "bob", "secret");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(GPtrArray) users_info = snapd_client_get_users_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
+    g_assert_nonnull (users_info);
+    g_assert_cmpint (users_info->len, ==, 2);
+    SnapdUserInformation *info = users_info->pdata[0];
+    g_assert_cmpint (snapd_user_information_get_id (info), ==, 1);
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
+    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "alice@example.com");
+    info = users_info->pdata[1];
+    g_assert_cmpint (snapd_user_information_get_id (info), ==, 2);
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
+    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "bob@example.com");
 }
 
 static void
-buy_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+get_users_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_buy_finish (SNAPD_CLIENT (object), result, &error);
+    g_autoptr(GPtrArray) users_info = snapd_client_get_users_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
+    g_assert_nonnull (users_info);
+    g_assert_cmpint (users_info->len, ==, 2);
+    SnapdUserInformation *info = users_info->pdata[0];
+    g_assert_cmpint (snapd_user_information_get_id (info), ==, 1);
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
+    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "alice@example.com");
+    info = users_info->pdata[1];
+    g_assert_cmpint (snapd_user_information_get_id (info), ==, 2);
+    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
+    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "bob@example.com");
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_buy_async (void)
+test_get_users_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, TRUE);
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
+    mock_snapd_add_account (snapd, "alice@example.com", "alice", "secret");
+    mock_snapd_add_account (snapd, "bob@example.com", "bob", "secret");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6963,22 +12607,16 @@ test_buy_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
-
-    snapd_client_buy_async (client, "ABCDEF", 1.25, "NZD", NULL, buy_cb, async_data_new (loop, snapd));
+    snapd_client_get_users_async (client, NULL, get_users_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_buy_not_logged_in (void)
+test_get_sections_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
+    mock_snapd_add_store_section (snapd, "SECTION1");
+    mock_snapd_add_store_section (snapd, "SECTION2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -6986,45 +12624,38 @@ test_buy_not_logged_in (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_AUTH_DATA_REQUIRED);
-    g_assert_false (result);
+    g_auto(GStrv) sections = snapd_client_get_sections_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (sections);
+    g_assert_cmpint (g_strv_length (sections), ==, 2);
+    g_assert_cmpstr (sections[0], ==, "SECTION1");
+    g_assert_cmpstr (sections[1], ==, "SECTION2");
 }
 
 static void
-test_buy_not_available (void)
+get_sections_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, TRUE);
+    g_autoptr(AsyncData) data = user_data;
 
     g_autoptr(GError) error = NULL;
-    g_assert_true (mock_snapd_start (snapd, &error));
-
-    g_autoptr(SnapdClient) client = snapd_client_new ();
-    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
-
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_auto(GStrv) sections = snapd_client_get_sections_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_assert_nonnull (sections);
+    g_assert_cmpint (g_strv_length (sections), ==, 2);
+    g_assert_cmpstr (sections[0], ==, "SECTION1");
+    g_assert_cmpstr (sections[1], ==, "SECTION2");
 
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
-    g_assert_false (result);
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_buy_terms_not_accepted (void)
+test_get_sections_async (void)
 {
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, FALSE);
-    mock_account_set_has_payment_methods (a, FALSE);
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_store_section (snapd, "SECTION1");
+    mock_snapd_add_store_section (snapd, "SECTION2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7032,53 +12663,77 @@ test_buy_terms_not_accepted (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
-
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_TERMS_NOT_ACCEPTED);
-    g_assert_false (result);
+    snapd_client_get_sections_async (client, NULL, get_sections_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
 }
 
 static void
-test_buy_no_payment_methods (void)
+test_get_sections_prefetch (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, FALSE);
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
+    mock_snapd_add_store_section (snapd, "SECTION1");
+    mock_snapd_add_store_section (snapd, "SECTION2");
+    MockSnap *s = mock_snapd_add_store_snap (snapd, "apple");
+    mock_snap_add_store_section (s, "SECTION1");
+    s = mock_snapd_add_store_snap (snapd, "banana");
+    mock_snap_add_store_section (s, "SECTION2");
+    s = mock_snapd_add_store_snap (snapd, "carrot");
+    mock_snap_add_store_section (s, "SECTION2");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    g_autoptr(SnapdCatalogCache) cache = snapd_catalog_cache_new ();
+    snapd_client_set_catalog_cache (client, cache);
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    /* Each section is only fetched once */
+    g_auto(GStrv) sections = g_strsplit ("SECTION1,SECTION2,SECTION1", ",", -1);
+    g_autoptr(GHashTable) snaps = snapd_client_prefetch_sections_sync (client, SNAPD_FIND_FLAGS_NONE, sections, 1, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_assert_nonnull (snaps);
+    g_assert_cmpint (g_hash_table_size (snaps), ==, 2);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+    GPtrArray *section1 = g_hash_table_lookup (snaps, "SECTION1");
+    g_assert_nonnull (section1);
+    g_assert_cmpint (section1->len, ==, 1);
+    g_assert_cmpstr (snapd_snap_get_name (section1->pdata[0]), ==, "apple");
+    GPtrArray *section2 = g_hash_table_lookup (snaps, "SECTION2");
+    g_assert_nonnull (section2);
+    g_assert_cmpint (section2->len, ==, 2);
+
+    /* The results are available from the cache without contacting snapd */
+    g_autoptr(GPtrArray) cached = snapd_client_find_cached (client, SNAPD_FIND_FLAGS_NONE, "SECTION2", NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (cached);
+    g_assert_cmpint (cached->len, ==, 2);
+    g_assert_cmpstr (snapd_snap_get_name (cached->pdata[0]), ==, "banana");
+    g_assert_cmpstr (snapd_snap_get_name (cached->pdata[1]), ==, "carrot");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+}
 
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 1.25, "NZD", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_NOT_SETUP);
-    g_assert_false (result);
+static gint
+compare_alias_name (gconstpointer a, gconstpointer b)
+{
+    SnapdAlias *alias_a = *((SnapdAlias **) a);
+    SnapdAlias *alias_b = *((SnapdAlias **) b);
+    return strcmp (snapd_alias_get_name (alias_a), snapd_alias_get_name (alias_b));
 }
 
 static void
-test_buy_invalid_price (void)
+test_aliases_get_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockAccount *a = mock_snapd_add_account (snapd, "test@example.com", "test", "secret");
-    mock_account_set_terms_accepted (a, TRUE);
-    mock_account_set_has_payment_methods (a, TRUE);
-    MockSnap *s = mock_snapd_add_store_snap (snapd, "snap");
-    mock_snap_set_id (s, "ABCDEF");
-    mock_snap_add_price (s, 1.25, "NZD");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
+
+    mock_app_add_auto_alias (a, "alias1");
+
+    mock_app_add_manual_alias (a, "alias2", TRUE);
+
+    mock_app_add_auto_alias (a, "alias3");
+    mock_app_add_manual_alias (a, "alias3", FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7086,20 +12741,85 @@ test_buy_invalid_price (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(SnapdUserInformation) user_information = snapd_client_login2_sync (client, "test@example.com", "secret", NULL, NULL, &error);
+    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (user_information);
-    snapd_client_set_auth_data (client, snapd_user_information_get_auth_data (user_information));
+    g_assert_nonnull (aliases);
+    g_assert_cmpint (aliases->len, ==, 3);
+    g_ptr_array_sort (aliases, compare_alias_name);
+    SnapdAlias *alias = aliases->pdata[0];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias1");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_AUTO);
+    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
+    g_assert_null (snapd_alias_get_app_manual (alias));
+    alias = aliases->pdata[1];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias2");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_MANUAL);
+    g_assert_null (snapd_alias_get_app_auto (alias));
+    g_assert_cmpstr (snapd_alias_get_app_manual (alias), ==, "app");
+    alias = aliases->pdata[2];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias3");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_DISABLED);
+    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
+    g_assert_null (snapd_alias_get_app_manual (alias));
+}
 
-    gboolean result = snapd_client_buy_sync (client, "ABCDEF", 0.75, "NZD", NULL, &error);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_PAYMENT_DECLINED);
-    g_assert_false (result);
+static void
+get_aliases_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (aliases);
+    g_assert_cmpint (aliases->len, ==, 3);
+    g_ptr_array_sort (aliases, compare_alias_name);
+    SnapdAlias *alias = aliases->pdata[0];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias1");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_AUTO);
+    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
+    g_assert_null (snapd_alias_get_app_manual (alias));
+    alias = aliases->pdata[1];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias2");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_MANUAL);
+    g_assert_null (snapd_alias_get_app_auto (alias));
+    g_assert_cmpstr (snapd_alias_get_app_manual (alias), ==, "app");
+    alias = aliases->pdata[2];
+    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias3");
+    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
+    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
+    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_DISABLED);
+    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
+    g_assert_null (snapd_alias_get_app_manual (alias));
+
+    g_main_loop_quit (data->loop);
 }
 
 static void
-test_create_user_sync (void)
+test_aliases_get_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
+
+    mock_app_add_auto_alias (a, "alias1");
+
+    mock_app_add_manual_alias (a, "alias2", TRUE);
+
+    mock_app_add_auto_alias (a, "alias3");
+    mock_app_add_manual_alias (a, "alias3", FALSE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7107,24 +12827,11 @@ test_create_user_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
-    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_NONE, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (info);
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "user");
-    GStrv ssh_keys = snapd_user_information_get_ssh_keys (info);
-    g_assert_nonnull (ssh_keys);
-    g_assert_cmpint (g_strv_length (ssh_keys), ==, 2);
-    g_assert_cmpstr (ssh_keys[0], ==, "KEY1");
-    g_assert_cmpstr (ssh_keys[1], ==, "KEY2");
-    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
-    g_assert_nonnull (account);
-    g_assert_false (mock_account_get_sudoer (account));
-    g_assert_false (mock_account_get_known (account));
+    snapd_client_get_aliases_async (client, NULL, get_aliases_cb, async_data_new (loop, snapd));
 }
 
 static void
-test_create_user_sudo (void)
+test_aliases_get_empty (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -7134,19 +12841,18 @@ test_create_user_sudo (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
-    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_SUDO, NULL, &error);
+    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_sync (client, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (info);
-    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
-    g_assert_nonnull (account);
-    g_assert_true (mock_account_get_sudoer (account));
+    g_assert_nonnull (aliases);
+    g_assert_cmpint (aliases->len, ==, 0);
 }
 
 static void
-test_create_user_known (void)
+test_aliases_alias_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7154,19 +12860,38 @@ test_create_user_known (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_snapd_find_account_by_username (snapd, "user"));
-    g_autoptr(SnapdUserInformation) info = snapd_client_create_user_sync (client, "user@example.com", SNAPD_CREATE_USER_FLAGS_KNOWN, NULL, &error);
+    g_assert_null (mock_app_find_alias (a, "foo"));
+    gboolean result = snapd_client_alias_sync (client, "snap", "app", "foo", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (info);
-    MockAccount *account = mock_snapd_find_account_by_username (snapd, "user");
-    g_assert_nonnull (account);
-    g_assert_true (mock_account_get_known (account));
+    g_assert_true (result);
+    g_assert_nonnull (mock_app_find_alias (a, "foo"));
 }
 
 static void
-test_create_users_sync (void)
+alias_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
+    MockApp *a = mock_snap_find_app (s, "app");
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_alias_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_nonnull (mock_app_find_alias (a, "foo"));
+
+    g_main_loop_quit (data->loop);
+}
+
+static void
+test_aliases_alias_async (void)
 {
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7174,32 +12899,18 @@ test_create_users_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) users_info = snapd_client_create_users_sync (client, NULL, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (users_info);
-    g_assert_cmpint (users_info->len, ==, 3);
-    SnapdUserInformation *info = users_info->pdata[0];
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "admin");
-    GStrv ssh_keys = snapd_user_information_get_ssh_keys (info);
-    g_assert_nonnull (ssh_keys);
-    g_assert_cmpint (g_strv_length (ssh_keys), ==, 2);
-    g_assert_cmpstr (ssh_keys[0], ==, "KEY1");
-    g_assert_cmpstr (ssh_keys[1], ==, "KEY2");
-    info = users_info->pdata[1];
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
-    info = users_info->pdata[2];
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
-    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "admin"));
-    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "alice"));
-    g_assert_nonnull (mock_snapd_find_account_by_username (snapd, "bob"));
+    g_assert_null (mock_app_find_alias (a, "foo"));
+    snapd_client_alias_async (client, "snap", "app", "foo", NULL, NULL, NULL, alias_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
 }
 
 static void
-test_get_users_sync (void)
+test_aliases_unalias_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "alice@example.com", "alice", "secret");
-    mock_snapd_add_account (snapd, "bob@example.com", "bob", "secret");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
+    mock_app_add_manual_alias (a, "foo", TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7207,50 +12918,37 @@ test_get_users_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) users_info = snapd_client_get_users_sync (client, NULL, &error);
+    gboolean result = snapd_client_unalias_sync (client, "snap", "foo", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (users_info);
-    g_assert_cmpint (users_info->len, ==, 2);
-    SnapdUserInformation *info = users_info->pdata[0];
-    g_assert_cmpint (snapd_user_information_get_id (info), ==, 1);
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
-    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "alice@example.com");
-    info = users_info->pdata[1];
-    g_assert_cmpint (snapd_user_information_get_id (info), ==, 2);
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
-    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "bob@example.com");
+    g_assert_true (result);
+    g_assert_null (mock_app_find_alias (a, "foo"));
 }
 
 static void
-get_users_cb (GObject *object, GAsyncResult *result, gpointer user_data)
-{
-    g_autoptr(AsyncData) data = user_data;
-
-    g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) users_info = snapd_client_get_users_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (users_info);
-    g_assert_cmpint (users_info->len, ==, 2);
-    SnapdUserInformation *info = users_info->pdata[0];
-    g_assert_cmpint (snapd_user_information_get_id (info), ==, 1);
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "alice");
-    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "alice@example.com");
-    info = users_info->pdata[1];
-    g_assert_cmpint (snapd_user_information_get_id (info), ==, 2);
-    g_assert_cmpstr (snapd_user_information_get_username (info), ==, "bob");
-    g_assert_cmpstr (snapd_user_information_get_email (info), ==, "bob@example.com");
+unalias_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    g_autoptr(AsyncData) data = user_data;
+
+    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
+    MockApp *a = mock_snap_find_app (s, "app");
+
+    g_autoptr(GError) error = NULL;
+    gboolean r = snapd_client_unalias_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_no_error (error);
+    g_assert_true (r);
+    g_assert_null (mock_app_find_alias (a, "foo"));
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_users_async (void)
+test_aliases_unalias_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_account (snapd, "alice@example.com", "alice", "secret");
-    mock_snapd_add_account (snapd, "bob@example.com", "bob", "secret");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_add_app (s, "app");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7258,16 +12956,17 @@ test_get_users_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_users_async (client, NULL, get_users_cb, async_data_new (loop, snapd));
+    snapd_client_unalias_async (client, "snap", "foo", NULL, NULL, NULL, unalias_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_get_sections_sync (void)
+test_aliases_unalias_no_snap_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_section (snapd, "SECTION1");
-    mock_snapd_add_store_section (snapd, "SECTION2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    MockApp *a = mock_snap_add_app (s, "app");
+    mock_app_add_manual_alias (a, "foo", TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7275,38 +12974,54 @@ test_get_sections_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) sections = snapd_client_get_sections_sync (client, NULL, &error);
+    gboolean result = snapd_client_unalias_sync (client, NULL, "foo", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (sections);
-    g_assert_cmpint (g_strv_length (sections), ==, 2);
-    g_assert_cmpstr (sections[0], ==, "SECTION1");
-    g_assert_cmpstr (sections[1], ==, "SECTION2");
+    g_assert_true (result);
+    g_assert_null (mock_app_find_alias (a, "foo"));
 }
 
 static void
-get_sections_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_aliases_prefer_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_assert_false (mock_snap_get_preferred (s));
+    gboolean result = snapd_client_prefer_sync (client, "snap", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_true (mock_snap_get_preferred (s));
+}
+
+static void
+prefer_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
+    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
+
     g_autoptr(GError) error = NULL;
-    g_auto(GStrv) sections = snapd_client_get_sections_finish (SNAPD_CLIENT (object), result, &error);
+    gboolean r = snapd_client_prefer_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (sections);
-    g_assert_cmpint (g_strv_length (sections), ==, 2);
-    g_assert_cmpstr (sections[0], ==, "SECTION1");
-    g_assert_cmpstr (sections[1], ==, "SECTION2");
+    g_assert_true (r);
+    g_assert_true (mock_snap_get_preferred (s));
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_get_sections_async (void)
+test_aliases_prefer_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    mock_snapd_add_store_section (snapd, "SECTION1");
-    mock_snapd_add_store_section (snapd, "SECTION2");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7314,31 +13029,49 @@ test_get_sections_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_sections_async (client, NULL, get_sections_cb, async_data_new (loop, snapd));
+    g_assert_false (mock_snap_get_preferred (s));
+    snapd_client_prefer_async (client, "snap", NULL, NULL, NULL, prefer_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
-static gint
-compare_alias_name (gconstpointer a, gconstpointer b)
-{
-    SnapdAlias *alias_a = *((SnapdAlias **) a);
-    SnapdAlias *alias_b = *((SnapdAlias **) b);
-    return strcmp (snapd_alias_get_name (alias_a), snapd_alias_get_name (alias_b));
-}
-
 static void
-test_aliases_get_sync (void)
+test_aliases_set_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
     MockSnap *s = mock_snapd_add_snap (snapd, "snap");
     MockApp *a = mock_snap_add_app (s, "app");
+    mock_app_add_manual_alias (a, "baz", TRUE);
 
-    mock_app_add_auto_alias (a, "alias1");
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    mock_app_add_manual_alias (a, "alias2", TRUE);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    mock_app_add_auto_alias (a, "alias3");
-    mock_app_add_manual_alias (a, "alias3", FALSE);
+    const SnapdAliasChange changes[] = {
+        { SNAPD_ALIAS_ACTION_ALIAS, "snap", "app", "foo" },
+        { SNAPD_ALIAS_ACTION_ALIAS, "snap", "app", "bar" },
+        { SNAPD_ALIAS_ACTION_UNALIAS, "snap", NULL, "baz" },
+        { SNAPD_ALIAS_ACTION_PREFER, "snap", NULL, NULL }
+    };
+    gboolean result = snapd_client_set_aliases_sync (client, changes, G_N_ELEMENTS (changes), NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_nonnull (mock_app_find_alias (a, "foo"));
+    g_assert_nonnull (mock_app_find_alias (a, "bar"));
+    g_assert_null (mock_app_find_alias (a, "baz"));
+    g_assert_true (mock_snap_get_preferred (s));
+
+    /* Nothing to do completes without contacting snapd */
+    result = snapd_client_set_aliases_sync (client, NULL, 0, NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+}
+
+static void
+test_run_snapctl_sync (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7346,85 +13079,59 @@ test_aliases_get_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_sync (client, NULL, &error);
+    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
+    g_autofree gchar *stdout_output = NULL;
+    g_autofree gchar *stderr_output = NULL;
+    int exit_code = 0;
+    gboolean result = snapd_client_run_snapctl2_sync (client, "ABC", args, &stdout_output, &stderr_output, &exit_code, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (aliases);
-    g_assert_cmpint (aliases->len, ==, 3);
-    g_ptr_array_sort (aliases, compare_alias_name);
-    SnapdAlias *alias = aliases->pdata[0];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias1");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_AUTO);
-    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
-    g_assert_null (snapd_alias_get_app_manual (alias));
-    alias = aliases->pdata[1];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias2");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_MANUAL);
-    g_assert_null (snapd_alias_get_app_auto (alias));
-    g_assert_cmpstr (snapd_alias_get_app_manual (alias), ==, "app");
-    alias = aliases->pdata[2];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias3");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_DISABLED);
-    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
-    g_assert_null (snapd_alias_get_app_manual (alias));
+    g_assert_true (result);
+    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
+    g_assert_cmpstr (stderr_output, ==, "STDERR");
+    g_assert_cmpint (exit_code, ==, 0);
 }
 
 static void
-get_aliases_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+snapctl_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
+    g_autofree gchar *stdout_output = NULL;
+    g_autofree gchar *stderr_output = NULL;
+    int exit_code = 0;
     g_autoptr(GError) error = NULL;
-    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_finish (SNAPD_CLIENT (object), result, &error);
+    gboolean r = snapd_client_run_snapctl2_finish (SNAPD_CLIENT (object), result, &stdout_output, &stderr_output, &exit_code, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (aliases);
-    g_assert_cmpint (aliases->len, ==, 3);
-    g_ptr_array_sort (aliases, compare_alias_name);
-    SnapdAlias *alias = aliases->pdata[0];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias1");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_AUTO);
-    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
-    g_assert_null (snapd_alias_get_app_manual (alias));
-    alias = aliases->pdata[1];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias2");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_MANUAL);
-    g_assert_null (snapd_alias_get_app_auto (alias));
-    g_assert_cmpstr (snapd_alias_get_app_manual (alias), ==, "app");
-    alias = aliases->pdata[2];
-    g_assert_cmpstr (snapd_alias_get_name (alias), ==, "alias3");
-    g_assert_cmpstr (snapd_alias_get_snap (alias), ==, "snap");
-    g_assert_cmpstr (snapd_alias_get_command (alias), ==, "snap.app");
-    g_assert_cmpint (snapd_alias_get_status (alias), ==, SNAPD_ALIAS_STATUS_DISABLED);
-    g_assert_cmpstr (snapd_alias_get_app_auto (alias), ==, "app");
-    g_assert_null (snapd_alias_get_app_manual (alias));
+    g_assert_true (r);
+    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
+    g_assert_cmpstr (stderr_output, ==, "STDERR");
+    g_assert_cmpint (exit_code, ==, 0);
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_aliases_get_async (void)
+test_run_snapctl_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
 
-    mock_app_add_auto_alias (a, "alias1");
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    mock_app_add_manual_alias (a, "alias2", TRUE);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    mock_app_add_auto_alias (a, "alias3");
-    mock_app_add_manual_alias (a, "alias3", FALSE);
+    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
+    snapd_client_run_snapctl2_async (client, "ABC", args, NULL, snapctl_cb, async_data_new (loop, snapd));
+    g_main_loop_run (loop);
+}
+
+static void
+test_run_snapctl_unsuccessful (void)
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7432,11 +13139,20 @@ test_aliases_get_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_get_aliases_async (client, NULL, get_aliases_cb, async_data_new (loop, snapd));
+    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
+    g_autofree gchar *stdout_output = NULL;
+    g_autofree gchar *stderr_output = NULL;
+    int exit_code = 0;
+    gboolean result = snapd_client_run_snapctl2_sync (client, "return-error", args, &stdout_output, &stderr_output, &exit_code, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpstr (stdout_output, ==, "STDOUT:return-error:arg1:arg2");
+    g_assert_cmpstr (stderr_output, ==, "STDERR");
+    g_assert_cmpint (exit_code, ==, 1);
 }
 
 static void
-test_aliases_get_empty (void)
+test_run_snapctl_legacy (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -7446,18 +13162,31 @@ test_aliases_get_empty (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GPtrArray) aliases = snapd_client_get_aliases_sync (client, NULL, &error);
+    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
+    g_autofree gchar *stdout_output = NULL;
+    g_autofree gchar *stderr_output = NULL;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    gboolean result = snapd_client_run_snapctl_sync (client, "ABC", args, &stdout_output, &stderr_output, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
     g_assert_no_error (error);
-    g_assert_nonnull (aliases);
-    g_assert_cmpint (aliases->len, ==, 0);
+    g_assert_true (result);
+    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
+    g_assert_cmpstr (stderr_output, ==, "STDERR");
+
+    /* Unsuccessful exit codes are still reported as errors by the old API */
+    g_clear_pointer (&stdout_output, g_free);
+    g_clear_pointer (&stderr_output, g_free);
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    result = snapd_client_run_snapctl_sync (client, "return-error", args, &stdout_output, &stderr_output, NULL, &error);
+G_GNUC_END_IGNORE_DEPRECATIONS
+    g_assert_false (result);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_UNSUCCESSFUL);
 }
 
 static void
-test_aliases_alias_sync (void)
+test_download_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7465,38 +13194,34 @@ test_aliases_alias_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_app_find_alias (a, "foo"));
-    gboolean result = snapd_client_alias_sync (client, "snap", "app", "foo", NULL, NULL, NULL, &error);
+    g_autoptr(GBytes) snap_data = snapd_client_download_sync (client, "test", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_nonnull (mock_app_find_alias (a, "foo"));
+    g_assert_nonnull (snap_data);
+
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
 }
 
 static void
-alias_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+download_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
     g_autoptr(AsyncData) data = user_data;
 
-    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
-    MockApp *a = mock_snap_find_app (s, "app");
-
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_alias_finish (SNAPD_CLIENT (object), result, &error);
+    g_autoptr(GBytes) snap_data = snapd_client_download_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_nonnull (mock_app_find_alias (a, "foo"));
+    g_assert_nonnull (snap_data);
+
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
 
     g_main_loop_quit (data->loop);
 }
 
 static void
-test_aliases_alias_async (void)
+test_download_async (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
-    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7504,18 +13229,14 @@ test_aliases_alias_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_null (mock_app_find_alias (a, "foo"));
-    snapd_client_alias_async (client, "snap", "app", "foo", NULL, NULL, NULL, alias_cb, async_data_new (loop, snapd));
+    snapd_client_download_async (client, "test", NULL, NULL, NULL, download_cb, async_data_new (loop, snapd));
     g_main_loop_run (loop);
 }
 
 static void
-test_aliases_unalias_sync (void)
+test_download_channel_revision (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
-    mock_app_add_manual_alias (a, "foo", TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7523,37 +13244,25 @@ test_aliases_unalias_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_unalias_sync (client, "snap", "foo", NULL, NULL, NULL, &error);
+    g_autoptr(GBytes) snap_data = snapd_client_download_sync (client, "test", "CHANNEL", "REVISION", NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_null (mock_app_find_alias (a, "foo"));
+    g_assert_nonnull (snap_data);
+
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test:channel=CHANNEL:revision=REVISION", 48);
 }
 
 static void
-unalias_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+download_progress_cb (goffset current_num_bytes, goffset total_num_bytes, gpointer user_data)
 {
-    g_autoptr(AsyncData) data = user_data;
-
-    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
-    MockApp *a = mock_snap_find_app (s, "app");
-
-    g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_unalias_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_null (mock_app_find_alias (a, "foo"));
-
-    g_main_loop_quit (data->loop);
+    goffset *last_num_bytes = user_data;
+    g_assert_cmpint (current_num_bytes, >, *last_num_bytes);
+    *last_num_bytes = current_num_bytes;
 }
 
 static void
-test_aliases_unalias_async (void)
+test_download_to_stream_sync (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    mock_snap_add_app (s, "app");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7561,17 +13270,27 @@ test_aliases_unalias_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_unalias_async (client, "snap", "foo", NULL, NULL, NULL, unalias_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    goffset num_bytes = 0;
+    gboolean result = snapd_client_download_to_stream_sync (client, "test", NULL, NULL, stream, download_progress_cb, &num_bytes, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (num_bytes, ==, 14);
+
+    g_assert_true (g_output_stream_close (stream, NULL, NULL));
+    g_autoptr(GBytes) snap_data = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
+
+    /* Connection can be reused after streaming */
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
 }
 
 static void
-test_aliases_unalias_no_snap_sync (void)
+test_download_peek (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
-    MockApp *a = mock_snap_add_app (s, "app");
-    mock_app_add_manual_alias (a, "foo", TRUE);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7579,17 +13298,21 @@ test_aliases_unalias_no_snap_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    gboolean result = snapd_client_unalias_sync (client, NULL, "foo", NULL, NULL, NULL, &error);
+    goffset size;
+    g_autofree gchar *sha3_384 = NULL;
+    g_autofree gchar *resume_token = NULL;
+    gboolean result = snapd_client_download_peek_sync (client, "test", NULL, NULL, &size, &sha3_384, &resume_token, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
-    g_assert_null (mock_app_find_alias (a, "foo"));
+    g_assert_cmpint (size, ==, 14);
+    g_assert_cmpstr (sha3_384, ==, "SHA3-384:test");
+    g_assert_cmpstr (resume_token, ==, "RESUME-TOKEN");
 }
 
 static void
-test_aliases_prefer_sync (void)
+test_download_resume (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7597,36 +13320,20 @@ test_aliases_prefer_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_false (mock_snap_get_preferred (s));
-    gboolean result = snapd_client_prefer_sync (client, "snap", NULL, NULL, NULL, &error);
+    g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    gboolean result = snapd_client_download_resume_sync (client, "test", NULL, NULL, "RESUME-TOKEN", 5, stream, NULL, NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
-    g_assert_true (mock_snap_get_preferred (s));
-}
-
-static void
-prefer_cb (GObject *object, GAsyncResult *result, gpointer user_data)
-{
-    g_autoptr(AsyncData) data = user_data;
-
-    MockSnap *s = mock_snapd_find_snap (data->snapd, "snap");
-
-    g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_prefer_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_true (mock_snap_get_preferred (s));
 
-    g_main_loop_quit (data->loop);
+    g_assert_true (g_output_stream_close (stream, NULL, NULL));
+    g_autoptr(GBytes) snap_data = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "name=test", 9);
 }
 
 static void
-test_aliases_prefer_async (void)
+test_download_resume_invalid_token (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
-
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
-    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7634,55 +13341,102 @@ test_aliases_prefer_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_assert_false (mock_snap_get_preferred (s));
-    snapd_client_prefer_async (client, "snap", NULL, NULL, NULL, prefer_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    gboolean result = snapd_client_download_resume_sync (client, "test", NULL, NULL, "INVALID", 5, stream, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_REQUEST);
+    g_assert_false (result);
 }
 
 static void
-test_run_snapctl_sync (void)
+remove_download_cache (const gchar *cache_path)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GDir) dir = g_dir_open (cache_path, 0, &error);
+    g_assert_no_error (error);
+    const gchar *name;
+    while ((name = g_dir_read_name (dir)) != NULL) {
+        g_autofree gchar *file_path = g_build_filename (cache_path, name, NULL);
+        g_assert_cmpint (g_unlink (file_path), ==, 0);
+    }
+    g_assert_cmpint (g_rmdir (cache_path), ==, 0);
+}
+
+static void
+test_download_cache_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
+    g_autofree gchar *cache_path = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdDownloadCache) cache = snapd_download_cache_new (cache_path);
+    g_assert_cmpstr (snapd_download_cache_get_cache_dir (cache), ==, cache_path);
+    g_assert_null (snapd_download_cache_lookup (cache, "SHA3-384:test"));
+
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_download_cache (client, cache);
+    g_assert_true (snapd_client_get_download_cache (client) == cache);
 
-    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
-    g_autofree gchar *stdout_output = NULL;
-    g_autofree gchar *stderr_output = NULL;
-    int exit_code = 0;
-    gboolean result = snapd_client_run_snapctl2_sync (client, "ABC", args, &stdout_output, &stderr_output, &exit_code, NULL, &error);
+    // First download peeks at the digest then downloads into the cache
+    g_autoptr(GBytes) snap_data1 = snapd_client_download_sync (client, "test", NULL, NULL, NULL, &error);
     g_assert_no_error (error);
-    g_assert_true (result);
-    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
-    g_assert_cmpstr (stderr_output, ==, "STDERR");
-    g_assert_cmpint (exit_code, ==, 0);
+    g_assert_nonnull (snap_data1);
+    g_assert_cmpmem (g_bytes_get_data (snap_data1, NULL), g_bytes_get_size (snap_data1), "SNAP:name=test", 14);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 2);
+    g_assert_cmpint (snapd_download_cache_get_hits (cache), ==, 0);
+    g_assert_cmpint (snapd_download_cache_get_misses (cache), ==, 1);
+    g_autofree gchar *path = snapd_download_cache_lookup (cache, "SHA3-384:test");
+    g_assert_nonnull (path);
+
+    // Second download only needs the peek
+    g_autoptr(GBytes) snap_data2 = snapd_client_download_sync (client, "test", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (snap_data2);
+    g_assert_cmpmem (g_bytes_get_data (snap_data2, NULL), g_bytes_get_size (snap_data2), "SNAP:name=test", 14);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 3);
+    g_assert_cmpint (snapd_download_cache_get_hits (cache), ==, 1);
+    g_assert_cmpint (snapd_download_cache_get_misses (cache), ==, 1);
+
+    // A different snap is downloaded
+    g_autoptr(GBytes) snap_data3 = snapd_client_download_sync (client, "test2", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpmem (g_bytes_get_data (snap_data3, NULL), g_bytes_get_size (snap_data3), "SNAP:name=test2", 15);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 5);
+    g_assert_cmpint (snapd_download_cache_get_misses (cache), ==, 2);
+
+    // The cache persists on disk
+    g_autoptr(SnapdDownloadCache) cache2 = snapd_download_cache_new (cache_path);
+    snapd_client_set_download_cache (client, cache2);
+    g_autoptr(GBytes) snap_data4 = snapd_client_download_sync (client, "test", NULL, NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpmem (g_bytes_get_data (snap_data4, NULL), g_bytes_get_size (snap_data4), "SNAP:name=test", 14);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 6);
+    g_assert_cmpint (snapd_download_cache_get_hits (cache2), ==, 1);
+
+    remove_download_cache (cache_path);
 }
 
 static void
-snapctl_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+download_cache_cb (GObject *object, GAsyncResult *result, gpointer user_data)
 {
-    g_autoptr(AsyncData) data = user_data;
+    AsyncData *data = user_data;
 
-    g_autofree gchar *stdout_output = NULL;
-    g_autofree gchar *stderr_output = NULL;
-    int exit_code = 0;
     g_autoptr(GError) error = NULL;
-    gboolean r = snapd_client_run_snapctl2_finish (SNAPD_CLIENT (object), result, &stdout_output, &stderr_output, &exit_code, &error);
+    g_autoptr(GBytes) snap_data = snapd_client_download_finish (SNAPD_CLIENT (object), result, &error);
     g_assert_no_error (error);
-    g_assert_true (r);
-    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
-    g_assert_cmpstr (stderr_output, ==, "STDERR");
-    g_assert_cmpint (exit_code, ==, 0);
+    g_assert_nonnull (snap_data);
+    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
 
-    g_main_loop_quit (data->loop);
+    data->counter++;
+    if (data->counter == 2)
+        g_main_loop_quit (data->loop);
 }
 
 static void
-test_run_snapctl_async (void)
+test_download_cache_concurrent (void)
 {
     g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
 
@@ -7691,16 +13445,49 @@ test_run_snapctl_async (void)
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
 
+    g_autofree gchar *cache_path = g_dir_make_tmp ("snapd-glib-test-XXXXXX", &error);
+    g_assert_no_error (error);
+    g_autoptr(SnapdDownloadCache) cache = snapd_download_cache_new (cache_path);
+
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_download_cache (client, cache);
 
-    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
-    snapd_client_run_snapctl2_async (client, "ABC", args, NULL, snapctl_cb, async_data_new (loop, snapd));
+    // Both requests peek, but only one downloads
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    snapd_client_download_async (client, "test", NULL, NULL, NULL, download_cache_cb, data);
+    snapd_client_download_async (client, "test", NULL, NULL, NULL, download_cache_cb, data);
     g_main_loop_run (loop);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 3);
+    g_assert_cmpint (snapd_download_cache_get_hits (cache), ==, 0);
+    g_assert_cmpint (snapd_download_cache_get_misses (cache), ==, 2);
+
+    remove_download_cache (cache_path);
+}
+
+typedef struct
+{
+    goffset downloaded;
+    goffset total;
+    int n_calls;
+} DownloadManyProgress;
+
+static void
+download_many_progress_cb (SnapdClient *client, SnapdDownload *download, goffset downloaded, goffset total, gint64 eta, gpointer user_data)
+{
+    DownloadManyProgress *progress = user_data;
+
+    g_assert_cmpint (downloaded, >, progress->downloaded);
+    g_assert_cmpint (downloaded, <=, total);
+    g_assert_cmpint (snapd_download_get_downloaded (download), <=, snapd_download_get_size (download));
+    g_assert_cmpint (eta, >=, 0);
+    progress->downloaded = downloaded;
+    progress->total = total;
+    progress->n_calls++;
 }
 
 static void
-test_run_snapctl_unsuccessful (void)
+test_download_many_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -7709,21 +13496,37 @@ test_run_snapctl_unsuccessful (void)
 
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_connections (client, 2);
 
-    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
-    g_autofree gchar *stdout_output = NULL;
-    g_autofree gchar *stderr_output = NULL;
-    int exit_code = 0;
-    gboolean result = snapd_client_run_snapctl2_sync (client, "return-error", args, &stdout_output, &stderr_output, &exit_code, NULL, &error);
+    g_autoptr(GPtrArray) downloads = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GOutputStream) stream1 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap1", NULL, NULL, stream1));
+    g_autoptr(GOutputStream) stream2 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap2", "beta", NULL, stream2));
+    g_autoptr(GOutputStream) stream3 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap3", NULL, "42", stream3));
+    g_assert_cmpint (snapd_download_get_size (downloads->pdata[0]), ==, -1);
+
+    DownloadManyProgress progress = { 0 };
+    gboolean result = snapd_client_download_many_sync (client, downloads, 0, 0, download_many_progress_cb, &progress, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
-    g_assert_cmpstr (stdout_output, ==, "STDOUT:return-error:arg1:arg2");
-    g_assert_cmpstr (stderr_output, ==, "STDERR");
-    g_assert_cmpint (exit_code, ==, 1);
+
+    g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream1)), g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream1)), "SNAP:name=snap1", 15);
+    g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream2)), g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream2)), "SNAP:name=snap2:channel=beta", 28);
+    g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream3)), g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream3)), "SNAP:name=snap3:revision=42", 27);
+    g_assert_cmpint (snapd_download_get_size (downloads->pdata[1]), ==, 28);
+    g_assert_cmpint (snapd_download_get_downloaded (downloads->pdata[1]), ==, 28);
+    g_assert_cmpint (progress.total, ==, 15 + 28 + 27);
+    g_assert_cmpint (progress.downloaded, ==, progress.total);
+    g_assert_cmpint (progress.n_calls, >=, 3);
+
+    // Each snap is peeked then downloaded
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 6);
 }
 
 static void
-test_run_snapctl_legacy (void)
+test_download_many_bandwidth_limit (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
@@ -7733,31 +13536,30 @@ test_run_snapctl_legacy (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_auto(GStrv) args = g_strsplit ("arg1;arg2", ";", -1);
-    g_autofree gchar *stdout_output = NULL;
-    g_autofree gchar *stderr_output = NULL;
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    gboolean result = snapd_client_run_snapctl_sync (client, "ABC", args, &stdout_output, &stderr_output, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
+    g_autoptr(GPtrArray) downloads = g_ptr_array_new_with_free_func (g_object_unref);
+    g_autoptr(GOutputStream) stream1 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap1", NULL, NULL, stream1));
+    g_autoptr(GOutputStream) stream2 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap2", NULL, NULL, stream2));
+    g_autoptr(GOutputStream) stream3 = g_memory_output_stream_new_resizable ();
+    g_ptr_array_add (downloads, snapd_download_new ("snap3", NULL, NULL, stream3));
+
+    // 45 bytes at 15 bytes per second can't complete until the first second of data has been used and more has been allowed
+    gint64 start_time = g_get_monotonic_time ();
+    gboolean result = snapd_client_download_many_sync (client, downloads, 1, 15, NULL, NULL, NULL, &error);
     g_assert_no_error (error);
     g_assert_true (result);
-    g_assert_cmpstr (stdout_output, ==, "STDOUT:ABC:arg1:arg2");
-    g_assert_cmpstr (stderr_output, ==, "STDERR");
+    g_assert_cmpint (g_get_monotonic_time () - start_time, >=, G_USEC_PER_SEC / 2);
 
-    /* Unsuccessful exit codes are still reported as errors by the old API */
-    g_clear_pointer (&stdout_output, g_free);
-    g_clear_pointer (&stderr_output, g_free);
-G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-    result = snapd_client_run_snapctl_sync (client, "return-error", args, &stdout_output, &stderr_output, NULL, &error);
-G_GNUC_END_IGNORE_DEPRECATIONS
-    g_assert_false (result);
-    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_UNSUCCESSFUL);
+    g_assert_cmpmem (g_memory_output_stream_get_data (G_MEMORY_OUTPUT_STREAM (stream3)), g_memory_output_stream_get_data_size (G_MEMORY_OUTPUT_STREAM (stream3)), "SNAP:name=snap3", 15);
 }
 
 static void
-test_download_sync (void)
+test_export_snapshot_sync (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GBytes) archive = g_bytes_new_static ("SNAPSHOT-ARCHIVE", 16);
+    mock_snapd_add_snapshot_archive (snapd, 1, archive);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7765,33 +13567,68 @@ test_download_sync (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GBytes) snap_data = snapd_client_download_sync (client, "test", NULL, NULL, NULL, &error);
+    g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    goffset num_bytes = 0;
+    gboolean result = snapd_client_export_snapshot_sync (client, 1, stream, download_progress_cb, &num_bytes, NULL, &error);
     g_assert_no_error (error);
-    g_assert_nonnull (snap_data);
+    g_assert_true (result);
+    g_assert_cmpint (num_bytes, ==, 16);
 
-    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
+    g_assert_true (g_output_stream_close (stream, NULL, NULL));
+    g_autoptr(GBytes) data = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "SNAPSHOT-ARCHIVE", 16);
 }
 
 static void
-download_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+test_export_snapshot_not_found (void)
 {
-    g_autoptr(AsyncData) data = user_data;
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
-    g_autoptr(GBytes) snap_data = snapd_client_download_finish (SNAPD_CLIENT (object), result, &error);
-    g_assert_no_error (error);
-    g_assert_nonnull (snap_data);
+    g_assert_true (mock_snapd_start (snapd, &error));
 
-    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test", 14);
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_main_loop_quit (data->loop);
+    g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable ();
+    gboolean result = snapd_client_export_snapshot_sync (client, 1, stream, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_NOT_FOUND);
+    g_assert_false (result);
 }
 
 static void
-test_download_async (void)
+test_import_snapshot_sync (void)
 {
-    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
+    /* Only the given size is sent, even if the stream has more */
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAPSHOT-ARCHIVE-EXTRA", 22, NULL);
+    gint64 set_id = 0;
+    g_auto(GStrv) snaps = NULL;
+    gboolean result = snapd_client_import_snapshot_sync (client, stream, 16, &set_id, &snaps, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_true (result);
+    g_assert_cmpint (set_id, ==, 1);
+    g_assert_nonnull (snaps);
+    GBytes *data = mock_snapd_get_snapshot_archive (snapd, 1);
+    g_assert_nonnull (data);
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "SNAPSHOT-ARCHIVE", 16);
+
+    /* Connection can be reused after the upload */
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_sync (client, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_nonnull (info);
+}
+
+static void
+test_import_snapshot_short_stream (void)
+{
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
 
     g_autoptr(GError) error = NULL;
@@ -7800,14 +13637,19 @@ test_download_async (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    snapd_client_download_async (client, "test", NULL, NULL, NULL, download_cb, async_data_new (loop, snapd));
-    g_main_loop_run (loop);
+    g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data ("SNAPSHOT", 8, NULL);
+    gboolean result = snapd_client_import_snapshot_sync (client, stream, 16, NULL, NULL, NULL, &error);
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_WRITE_FAILED);
+    g_assert_false (result);
+    g_assert_null (mock_snapd_get_snapshot_archive (snapd, 1));
 }
 
 static void
-test_download_channel_revision (void)
+test_import_snapshot_fd (void)
 {
     g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_autoptr(GBytes) archive = g_bytes_new_static ("OTHER", 5);
+    mock_snapd_add_snapshot_archive (snapd, 4, archive);
 
     g_autoptr(GError) error = NULL;
     g_assert_true (mock_snapd_start (snapd, &error));
@@ -7815,11 +13657,19 @@ test_download_channel_revision (void)
     g_autoptr(SnapdClient) client = snapd_client_new ();
     snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
 
-    g_autoptr(GBytes) snap_data = snapd_client_download_sync (client, "test", "CHANNEL", "REVISION", NULL, &error);
+    g_autofree gchar *path = make_snap_file ("SNAPSHOT-ARCHIVE");
+    int fd = open (path, O_RDONLY);
+    g_assert_cmpint (fd, >=, 0);
+    gint64 set_id = 0;
+    gboolean result = snapd_client_import_snapshot_fd_sync (client, fd, &set_id, NULL, NULL, &error);
+    close (fd);
+    unlink (path);
     g_assert_no_error (error);
-    g_assert_nonnull (snap_data);
-
-    g_assert_cmpmem (g_bytes_get_data (snap_data, NULL), g_bytes_get_size (snap_data), "SNAP:name=test:channel=CHANNEL:revision=REVISION", 48);
+    g_assert_true (result);
+    g_assert_cmpint (set_id, ==, 5);
+    GBytes *data = mock_snapd_get_snapshot_archive (snapd, 5);
+    g_assert_nonnull (data);
+    g_assert_cmpmem (g_bytes_get_data (data, NULL), g_bytes_get_size (data), "SNAPSHOT-ARCHIVE", 16);
 }
 
 static void
@@ -7937,6 +13787,95 @@ test_themes_check_async (void)
     g_main_loop_run (loop);
 }
 
+static void
+theme_status_cache_check_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    AsyncData *data = user_data;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GHashTable) gtk_status = NULL;
+    g_autoptr(GHashTable) icon_status = NULL;
+    g_autoptr(GHashTable) sound_status = NULL;
+    gboolean res = snapd_theme_status_cache_check_finish (SNAPD_THEME_STATUS_CACHE (object), result, &gtk_status, &icon_status, &sound_status, &error);
+    g_assert_no_error (error);
+    g_assert_true (res);
+    g_assert_cmpint (g_hash_table_size (gtk_status), ==, 2);
+    g_assert_cmpint (g_hash_table_size (icon_status), ==, 1);
+    g_assert_cmpint (g_hash_table_size (sound_status), ==, 0);
+    g_assert_cmpint (GPOINTER_TO_INT (g_hash_table_lookup (gtk_status, "gtktheme2")), ==, SNAPD_THEME_STATUS_UNAVAILABLE);
+    g_assert_cmpint (GPOINTER_TO_INT (g_hash_table_lookup (icon_status, "icontheme1")), ==, SNAPD_THEME_STATUS_AVAILABLE);
+    data->counter = GPOINTER_TO_INT (g_hash_table_lookup (gtk_status, "gtktheme1"));
+
+    g_main_loop_quit (data->loop);
+}
+
+static guint
+theme_status_cache_check (GMainLoop *loop, AsyncData *data, SnapdThemeStatusCache *cache, SnapdThemeStatus *gtk_theme1_status)
+{
+    char *gtk_themes[] = { "gtktheme2", "gtktheme1", NULL };
+    char *icon_themes[] = { "icontheme1", NULL };
+    guint request_count = mock_snapd_get_request_count (data->snapd);
+    snapd_theme_status_cache_check_async (cache, gtk_themes, icon_themes, NULL, NULL, theme_status_cache_check_cb, data);
+    g_main_loop_run (loop);
+    *gtk_theme1_status = data->counter;
+    return mock_snapd_get_request_count (data->snapd) - request_count;
+}
+
+static void
+test_themes_check_cached (void)
+{
+    g_autoptr(GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "1");
+    mock_snapd_set_gtk_theme_status (snapd, "gtktheme1", "available");
+    mock_snapd_set_gtk_theme_status (snapd, "gtktheme2", "unavailable");
+    mock_snapd_set_icon_theme_status (snapd, "icontheme1", "available");
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+
+    g_autoptr(AsyncData) data = async_data_new (loop, snapd);
+    g_autoptr(SnapdThemeStatusCache) cache = snapd_theme_status_cache_new (client);
+    g_assert_cmpint (snapd_theme_status_cache_get_max_age (cache), ==, 24 * 60 * 60);
+
+    // First check asks the store, later ones only get the installed snaps
+    SnapdThemeStatus status;
+    g_assert_cmpint (theme_status_cache_check (loop, data, cache, &status), ==, 2);
+    g_assert_cmpint (status, ==, SNAPD_THEME_STATUS_AVAILABLE);
+    mock_snapd_set_gtk_theme_status (snapd, "gtktheme1", "installed");
+    g_assert_cmpint (theme_status_cache_check (loop, data, cache, &status), ==, 1);
+    g_assert_cmpint (status, ==, SNAPD_THEME_STATUS_AVAILABLE);
+
+    // A snap changed revision
+    s = mock_snapd_find_snap (snapd, "snap1");
+    mock_snap_set_revision (s, "2");
+    g_assert_cmpint (theme_status_cache_check (loop, data, cache, &status), ==, 2);
+    g_assert_cmpint (status, ==, SNAPD_THEME_STATUS_INSTALLED);
+
+    // Results are kept across sessions
+    gchar *path = NULL;
+    int fd = g_file_open_tmp ("snapd-glib-test-XXXXXX", &path, NULL);
+    g_assert_cmpint (fd, >=, 0);
+    close (fd);
+    g_assert_true (snapd_theme_status_cache_save (cache, path, &error));
+    g_assert_no_error (error);
+    g_autoptr(SnapdThemeStatusCache) loaded_cache = snapd_theme_status_cache_new (client);
+    g_assert_true (snapd_theme_status_cache_load (loaded_cache, path, &error));
+    g_assert_no_error (error);
+    g_assert_cmpint (theme_status_cache_check (loop, data, loaded_cache, &status), ==, 1);
+    g_assert_cmpint (status, ==, SNAPD_THEME_STATUS_INSTALLED);
+    g_assert_cmpint (g_unlink (path), ==, 0);
+    g_free (path);
+
+    snapd_theme_status_cache_invalidate (cache);
+    g_assert_cmpint (theme_status_cache_check (loop, data, cache, &status), ==, 2);
+}
+
 static void
 test_themes_install_sync (void)
 {
@@ -8076,19 +14015,43 @@ main (int argc, char **argv)
     g_test_add_func ("/socket-closed/after-request", test_socket_closed_after_request);
     g_test_add_func ("/socket-closed/reconnect", test_socket_closed_reconnect);
     g_test_add_func ("/socket-closed/reconnect-after-failure", test_socket_closed_reconnect_after_failure);
+    g_test_add_func ("/socket-tcp/basic", test_socket_tcp);
+    g_test_add_func ("/socket-connect/timeout", test_socket_connect_timeout);
+    g_test_add_func ("/socket-prepare/sync", test_socket_prepare);
+    g_test_add_func ("/socket-prepare/failure", test_socket_prepare_failure);
+    g_test_add_func ("/socket-prepare/stalled", test_socket_prepare_stalled);
+    g_test_add_func ("/socket-prepare/idle-close", test_socket_prepare_idle_close);
+    g_test_add_func ("/retry/closed", test_retry_closed);
+    g_test_add_func ("/retry/mid-response", test_retry_mid_response);
+    g_test_add_func ("/retry/restart", test_retry_restart);
+    g_test_add_func ("/retry/watch-socket", test_retry_watch_socket);
+    g_test_add_func ("/request-timeout/timeout", test_request_timeout);
+    g_test_add_func ("/request-timeout/deadline", test_request_deadline);
+    g_test_add_func ("/request-timeout/slow-request", test_slow_request);
     g_test_add_func ("/client/set-socket-path", test_client_set_socket_path);
     g_test_add_func ("/user-agent/default", test_user_agent_default);
     g_test_add_func ("/user-agent/custom", test_user_agent_custom);
     g_test_add_func ("/user-agent/null", test_user_agent_null);
+    g_test_add_func ("/user-agent/changed", test_user_agent_changed);
+    g_test_add_func ("/user-agent/prepared-requests", test_user_agent_prepared_requests);
+    g_test_add_func ("/user-agent/shared-transport", test_user_agent_shared_transport);
     g_test_add_func ("/accept-language/basic", test_accept_language);
+    g_test_add_func ("/accept-language/changed", test_accept_language_changed);
     g_test_add_func ("/accept-language/empty", test_accept_language_empty);
     g_test_add_func ("/allow-interaction/basic", test_allow_interaction);
+    g_test_add_func ("/max-read-size/basic", test_max_read_size);
+    g_test_add_func ("/buffer-pool/basic", test_buffer_pool);
+    g_test_add_func ("/poll-interval/basic", test_poll_interval);
     g_test_add_func ("/maintenance/none", test_maintenance_none);
     g_test_add_func ("/maintenance/daemon-restart", test_maintenance_daemon_restart);
     g_test_add_func ("/maintenance/system-restart", test_maintenance_system_restart);
     g_test_add_func ("/maintenance/unknown", test_maintenance_unknown);
     g_test_add_func ("/get-system-information/sync", test_get_system_information_sync);
     g_test_add_func ("/get-system-information/async", test_get_system_information_async);
+    g_test_add_func ("/get-system-information/coalesce", test_get_system_information_coalesce);
+    g_test_add_func ("/get-system-information/timings", test_get_system_information_timings);
+    g_test_add_func ("/get-system-information/statistics", test_get_system_information_statistics);
+    g_test_add_func ("/get-system-information/capture", test_get_system_information_capture);
     g_test_add_func ("/get-system-information/store", test_get_system_information_store);
     g_test_add_func ("/get-system-information/refresh", test_get_system_information_refresh);
     g_test_add_func ("/get-system-information/refresh_schedule", test_get_system_information_refresh_schedule);
@@ -8115,11 +14078,43 @@ main (int argc, char **argv)
     g_test_add_func ("/get-change/async", test_get_change_async);
     g_test_add_func ("/abort-change/sync", test_abort_change_sync);
     g_test_add_func ("/abort-change/async", test_abort_change_async);
+    g_test_add_func ("/get-notices/sync", test_get_notices_sync);
+    g_test_add_func ("/get-notices/async", test_get_notices_async);
+    g_test_add_func ("/get-notices/since", test_get_notices_since);
+    g_test_add_func ("/notices-monitor/basic", test_notices_monitor);
+    g_test_add_func ("/snap-list/basic", test_snap_list);
+    g_test_add_func ("/snap-list-model/basic", test_snap_list_model);
+    g_test_add_func ("/app-list-model/basic", test_app_list_model);
+    g_test_add_func ("/sorted-snap-model/basic", test_sorted_snap_model);
+    g_test_add_func ("/change-list/basic", test_change_list);
+    g_test_add_func ("/change-summary/basic", test_change_summary);
+    g_test_add_func ("/change-monitor/basic", test_change_monitor);
+    g_test_add_func ("/change-monitor/unwatch", test_change_monitor_unwatch);
+    g_test_add_func ("/wait-change/basic", test_wait_change);
+    g_test_add_func ("/wait-change/cancel", test_wait_change_cancel);
+    g_test_add_func ("/media-prefetcher/basic", test_media_prefetcher);
+    g_test_add_func ("/refreshable-cache/basic", test_refreshable_cache);
+    g_test_add_func ("/local-index/basic", test_local_index);
+    g_test_add_func ("/local-index/snap-list", test_local_index_snap_list);
+    g_test_add_func ("/serialize/snaps", test_serialize_snaps);
+    g_test_add_func ("/serialize/change", test_serialize_change);
+    g_test_add_func ("/serialize/connection", test_serialize_connection);
+    g_test_add_func ("/request-batch/basic", test_request_batch);
+    g_test_add_func ("/request-batch/snapctl", test_request_batch_snapctl);
+    g_test_add_func ("/fleet-client/basic", test_fleet_client);
     g_test_add_func ("/list/sync", test_list_sync);
     g_test_add_func ("/list/async", test_list_async);
     g_test_add_func ("/get-snaps/sync", test_get_snaps_sync);
+    g_test_add_func ("/get-snaps/max-response-size", test_get_snaps_max_response_size);
+    g_test_add_func ("/get-snaps/model", test_get_snaps_model);
     g_test_add_func ("/get-snaps/async", test_get_snaps_async);
     g_test_add_func ("/get-snaps/filter", test_get_snaps_filter);
+    g_test_add_func ("/get-snaps/dates", test_get_snaps_dates);
+    g_test_add_func ("/get-snaps/lazy", test_get_snaps_lazy);
+    g_test_add_func ("/get-snaps/shared", test_get_snaps_shared);
+    g_test_add_func ("/get-snaps/fields", test_get_snaps_fields);
+    g_test_add_func ("/get-snaps/shaped", test_get_snaps_shaped);
+    g_test_add_func ("/get-snaps/memory", test_get_snaps_memory);
     g_test_add_func ("/list-one/sync", test_list_one_sync);
     g_test_add_func ("/list-one/async", test_list_one_async);
     g_test_add_func ("/get-snap/sync", test_get_snap_sync);
@@ -8129,6 +14124,7 @@ main (int argc, char **argv)
     g_test_add_func ("/get-snap/deprecated-fields", test_get_snap_deprecated_fields);
     g_test_add_func ("/get-snap/common-ids", test_get_snap_common_ids);
     g_test_add_func ("/get-snap/not-installed", test_get_snap_not_installed);
+    g_test_add_func ("/get-snap/cache", test_get_snap_cache);
     g_test_add_func ("/get-snap/classic-confinement", test_get_snap_classic_confinement);
     g_test_add_func ("/get-snap/devmode-confinement", test_get_snap_devmode_confinement);
     g_test_add_func ("/get-snap/daemons", test_get_snap_daemons);
@@ -8137,30 +14133,46 @@ main (int argc, char **argv)
     g_test_add_func ("/get-snap/publisher-unproven", test_get_snap_publisher_unproven);
     g_test_add_func ("/get-snap/publisher-unknown-validation", test_get_snap_publisher_unknown_validation);
     g_test_add_func ("/get-snap-conf/sync", test_get_snap_conf_sync);
+    g_test_add_func ("/get-snap-conf/cache", test_get_snap_conf_cache);
+    g_test_add_func ("/get-snap-conf/cache-shared-transport", test_get_snap_conf_cache_shared_transport);
     g_test_add_func ("/get-snap-conf/async", test_get_snap_conf_async);
     g_test_add_func ("/get-snap-conf/key-filter", test_get_snap_conf_key_filter);
     g_test_add_func ("/get-snap-conf/invalid-key", test_get_snap_conf_invalid_key);
     g_test_add_func ("/set-snap-conf/sync", test_set_snap_conf_sync);
     g_test_add_func ("/set-snap-conf/async", test_set_snap_conf_async);
     g_test_add_func ("/set-snap-conf/invalid", test_set_snap_conf_invalid);
+    g_test_add_func ("/get-snap-config/sync", test_get_snap_config);
+    g_test_add_func ("/update-snap-conf/sync", test_update_snap_conf);
     g_test_add_func ("/get-apps/sync", test_get_apps_sync);
     g_test_add_func ("/get-apps/async", test_get_apps_async);
     g_test_add_func ("/get-apps/services", test_get_apps_services);
     g_test_add_func ("/get-apps/filter", test_get_apps_filter);
+    g_test_add_func ("/control-services/sync", test_control_services_sync);
+    g_test_add_func ("/control-services/not-found", test_control_services_not_found);
     g_test_add_func ("/icon/sync", test_icon_sync);
     g_test_add_func ("/icon/async", test_icon_async);
+    g_test_add_func ("/icon/cache", test_icon_cache);
+    g_test_add_func ("/icon/multiple", test_icon_multiple);
     g_test_add_func ("/icon/not-installed", test_icon_not_installed);
     g_test_add_func ("/icon/large", test_icon_large);
     g_test_add_func ("/get-assertions/sync", test_get_assertions_sync);
     //g_test_add_func ("/get-assertions/async", test_get_assertions_async);
     g_test_add_func ("/get-assertions/body", test_get_assertions_body);
     g_test_add_func ("/get-assertions/multiple", test_get_assertions_multiple);
+    g_test_add_func ("/get-assertions/bytes", test_get_assertions_bytes);
+    g_test_add_func ("/get-assertions/stream", test_get_assertions_stream);
     g_test_add_func ("/get-assertions/invalid", test_get_assertions_invalid);
+    g_test_add_func ("/get-logs/sync", test_get_logs_sync);
+    g_test_add_func ("/follow-logs/basic", test_follow_logs);
     g_test_add_func ("/add-assertions/sync", test_add_assertions_sync);
     //g_test_add_func ("/add-assertions/async", test_add_assertions_async);
+    g_test_add_func ("/add-assertions/stream", test_add_assertions_stream);
     g_test_add_func ("/assertions/sync", test_assertions_sync);
     //g_test_add_func ("/assertions/async", test_assertions_async);
     g_test_add_func ("/assertions/body", test_assertions_body);
+    g_test_add_func ("/assertions/header-span", test_assertions_header_span);
+    g_test_add_func ("/assertions/store", test_assertion_store);
+    g_test_add_func ("/assertions/store-verify", test_assertion_store_verify);
     g_test_add_func ("/get-connections/sync", test_get_connections_sync);
     g_test_add_func ("/get-connections/async", test_get_connections_async);
     g_test_add_func ("/get-connections/empty", test_get_connections_empty);
@@ -8168,6 +14180,7 @@ main (int argc, char **argv)
     g_test_add_func ("/get-connections/filter-snap", test_get_connections_filter_snap);
     g_test_add_func ("/get-connections/filter-interface", test_get_connections_filter_interface);
     g_test_add_func ("/get-connections/attributes", test_get_connections_attributes);
+    g_test_add_func ("/get-connections/graph", test_get_connections_graph);
     g_test_add_func ("/get-interfaces/sync", test_get_interfaces_sync);
     g_test_add_func ("/get-interfaces/async", test_get_interfaces_async);
     g_test_add_func ("/get-interfaces/no-snaps", test_get_interfaces_no_snaps);
@@ -8179,18 +14192,30 @@ main (int argc, char **argv)
     g_test_add_func ("/get-interfaces2/slots", test_get_interfaces2_slots);
     g_test_add_func ("/get-interfaces2/plugs", test_get_interfaces2_plugs);
     g_test_add_func ("/get-interfaces2/filter", test_get_interfaces2_filter);
+    g_test_add_func ("/get-interfaces2/cache-docs", test_get_interfaces2_cache_docs);
     g_test_add_func ("/get-interfaces2/make-label", test_get_interfaces2_make_label);
     g_test_add_func ("/connect-interface/sync", test_connect_interface_sync);
     g_test_add_func ("/connect-interface/async", test_connect_interface_async);
     g_test_add_func ("/connect-interface/progress", test_connect_interface_progress);
     g_test_add_func ("/connect-interface/invalid", test_connect_interface_invalid);
+    g_test_add_func ("/connect-interfaces/sync", test_connect_interfaces_sync);
+    g_test_add_func ("/connect-interfaces/invalid", test_connect_interfaces_invalid);
     g_test_add_func ("/disconnect-interface/sync", test_disconnect_interface_sync);
     g_test_add_func ("/disconnect-interface/async", test_disconnect_interface_async);
     g_test_add_func ("/disconnect-interface/progress", test_disconnect_interface_progress);
     g_test_add_func ("/disconnect-interface/invalid", test_disconnect_interface_invalid);
     g_test_add_func ("/find/query", test_find_query);
+    g_test_add_func ("/find/query-coalesce", test_find_query_coalesce);
+    g_test_add_func ("/find/query-cache", test_find_query_cache);
     g_test_add_func ("/find/query-private", test_find_query_private);
     g_test_add_func ("/find/query-private/not-logged-in", test_find_query_private_not_logged_in);
+    g_test_add_func ("/find/parse-thread", test_find_parse_thread);
+    g_test_add_func ("/find/stream", test_find_stream);
+    g_test_add_func ("/find/fields", test_find_fields);
+    g_test_add_func ("/find/page", test_find_page);
+    g_test_add_func ("/cache-manager/basic", test_cache_manager);
+    g_test_add_func ("/catalog-cache/basic", test_catalog_cache);
+    g_test_add_func ("/catalog-cache/system-information", test_catalog_cache_system_information);
     g_test_add_func ("/find/bad-query", test_find_bad_query);
     g_test_add_func ("/find/network-timeout", test_find_network_timeout);
     g_test_add_func ("/find/dns-failure", test_find_dns_failure);
@@ -8199,13 +14224,18 @@ main (int argc, char **argv)
     g_test_add_func ("/find/name-private/not-logged-in", test_find_name_private_not_logged_in);
     g_test_add_func ("/find/channels", test_find_channels);
     g_test_add_func ("/find/channels-match", test_find_channels_match);
+    g_test_add_func ("/find/track-channels", test_find_track_channels);
     g_test_add_func ("/find/cancel", test_find_cancel);
+    g_test_add_func ("/find/cancel-many", test_find_cancel_many);
+    g_test_add_func ("/find/superseding", test_find_superseding);
     g_test_add_func ("/find/section", test_find_section);
     g_test_add_func ("/find/section-query", test_find_section_query);
     g_test_add_func ("/find/section-name", test_find_section_name);
     g_test_add_func ("/find/scope-narrow", test_find_scope_narrow);
     g_test_add_func ("/find/scope-wide", test_find_scope_wide);
     g_test_add_func ("/find/common-id", test_find_common_id);
+    g_test_add_func ("/find/parse-descriptions", test_find_parse_descriptions);
+    g_test_add_func ("/resolve-snaps/basic", test_resolve_snaps);
     g_test_add_func ("/find-refreshable/sync", test_find_refreshable_sync);
     g_test_add_func ("/find-refreshable/async", test_find_refreshable_async);
     g_test_add_func ("/find-refreshable/no-updates", test_find_refreshable_no_updates);
@@ -8213,11 +14243,24 @@ main (int argc, char **argv)
     g_test_add_func ("/install/sync-multiple", test_install_sync_multiple);
     g_test_add_func ("/install/async", test_install_async);
     g_test_add_func ("/install/async-multiple", test_install_async_multiple);
+    g_test_add_func ("/install/async-multiple-connections", test_install_async_multiple_connections);
+    g_test_add_func ("/install/async-multiple-pipelined", test_install_async_multiple_pipelined);
+    g_test_add_func ("/install/request-priority", test_request_priority);
+    g_test_add_func ("/install/async-multiple-batched", test_install_async_multiple_batched);
+    g_test_add_func ("/install/async-multiple-background", test_install_async_multiple_background);
+    g_test_add_func ("/install/async-multiple-notices", test_install_async_multiple_notices);
+    g_test_add_func ("/install/async-notices-unsupported", test_install_async_notices_unsupported);
+    g_test_add_func ("/install/async-io-thread", test_install_async_io_thread);
+    g_test_add_func ("/install/sync-shared-io-context", test_install_sync_shared_io_context);
+    g_test_add_func ("/io-thread/many-submitters", test_io_thread_many_submitters);
     g_test_add_func ("/install/async-failure", test_install_async_failure);
     g_test_add_func ("/install/async-cancel", test_install_async_cancel);
     g_test_add_func ("/install/async-multiple-cancel-first", test_install_async_multiple_cancel_first);
     g_test_add_func ("/install/async-multiple-cancel-last", test_install_async_multiple_cancel_last);
     g_test_add_func ("/install/progress", test_install_progress);
+    g_test_add_func ("/install/progress-estimate", test_install_progress_estimate);
+    g_test_add_func ("/install/progress-io-thread", test_install_progress_io_thread);
+    g_test_add_func ("/install/progress-nested-sync", test_install_progress_nested_sync);
     g_test_add_func ("/install/needs-classic", test_install_needs_classic);
     g_test_add_func ("/install/classic", test_install_classic);
     g_test_add_func ("/install/not-classic", test_install_not_classic);
@@ -8236,11 +14279,20 @@ main (int argc, char **argv)
     g_test_add_func ("/install/auth-cancelled", test_install_auth_cancelled);
     g_test_add_func ("/install-stream/sync", test_install_stream_sync);
     g_test_add_func ("/install-stream/async", test_install_stream_async);
+    g_test_add_func ("/install-stream/large", test_install_stream_large);
+    g_test_add_func ("/install-stream/expect-continue", test_install_stream_expect_continue);
+    g_test_add_func ("/install-stream/upload-progress", test_install_stream_upload_progress);
     g_test_add_func ("/install-stream/progress", test_install_stream_progress);
+    g_test_add_func ("/install-stream/release-body", test_install_stream_release_body);
     g_test_add_func ("/install-stream/classic", test_install_stream_classic);
     g_test_add_func ("/install-stream/dangerous", test_install_stream_dangerous);
     g_test_add_func ("/install-stream/devmode", test_install_stream_devmode);
     g_test_add_func ("/install-stream/jailmode", test_install_stream_jailmode);
+    g_test_add_func ("/install-fd/sync", test_install_fd_sync);
+    g_test_add_func ("/install-fd/pipe", test_install_fd_pipe);
+    g_test_add_func ("/install-fd/upload-progress", test_install_fd_upload_progress);
+    g_test_add_func ("/install-path/async", test_install_path_async);
+    g_test_add_func ("/install-path/missing", test_install_path_missing);
     g_test_add_func ("/try/sync", test_try_sync);
     g_test_add_func ("/try/async", test_try_async);
     g_test_add_func ("/try/progress", test_try_progress);
@@ -8255,7 +14307,15 @@ main (int argc, char **argv)
     g_test_add_func ("/refresh-all/sync", test_refresh_all_sync);
     g_test_add_func ("/refresh-all/async", test_refresh_all_async);
     g_test_add_func ("/refresh-all/progress", test_refresh_all_progress);
+    g_test_add_func ("/refresh-all/progress-reuse", test_refresh_all_progress_reuse);
+    g_test_add_func ("/refresh-all/progress-delta", test_refresh_all_progress_delta);
+    g_test_add_func ("/refresh-all/progress-rate-limit", test_refresh_all_progress_rate_limit);
     g_test_add_func ("/refresh-all/no-updates", test_refresh_all_no_updates);
+    g_test_add_func ("/install-many/sync", test_install_many_sync);
+    g_test_add_func ("/install-many/not-available", test_install_many_not_available);
+    g_test_add_func ("/refresh-many/sync", test_refresh_many_sync);
+    g_test_add_func ("/remove-many/async", test_remove_many_async);
+    g_test_add_func ("/remove-many/not-installed", test_remove_many_not_installed);
     g_test_add_func ("/remove/sync", test_remove_sync);
     g_test_add_func ("/remove/async", test_remove_async);
     g_test_add_func ("/remove/async-failure", test_remove_async_failure);
@@ -8299,6 +14359,7 @@ main (int argc, char **argv)
     g_test_add_func ("/get-users/async", test_get_users_async);
     g_test_add_func ("/get-sections/sync", test_get_sections_sync);
     g_test_add_func ("/get-sections/async", test_get_sections_async);
+    g_test_add_func ("/get-sections/prefetch", test_get_sections_prefetch);
     g_test_add_func ("/aliases/get-sync", test_aliases_get_sync);
     g_test_add_func ("/aliases/get-async", test_aliases_get_async);
     g_test_add_func ("/aliases/get-empty", test_aliases_get_empty);
@@ -8309,6 +14370,7 @@ main (int argc, char **argv)
     g_test_add_func ("/aliases/unalias-no-snap-sync", test_aliases_unalias_no_snap_sync);
     g_test_add_func ("/aliases/prefer-sync", test_aliases_prefer_sync);
     g_test_add_func ("/aliases/prefer-async", test_aliases_prefer_async);
+    g_test_add_func ("/aliases/set-sync", test_aliases_set_sync);
     g_test_add_func ("/run-snapctl/sync", test_run_snapctl_sync);
     g_test_add_func ("/run-snapctl/async", test_run_snapctl_async);
     g_test_add_func ("/run-snapctl/unsuccessful", test_run_snapctl_unsuccessful);
@@ -8316,8 +14378,22 @@ main (int argc, char **argv)
     g_test_add_func ("/download/sync", test_download_sync);
     g_test_add_func ("/download/async", test_download_async);
     g_test_add_func ("/download/channel-revision", test_download_channel_revision);
+    g_test_add_func ("/download/to-stream", test_download_to_stream_sync);
+    g_test_add_func ("/download/peek", test_download_peek);
+    g_test_add_func ("/download/resume", test_download_resume);
+    g_test_add_func ("/download/resume-invalid-token", test_download_resume_invalid_token);
+    g_test_add_func ("/download/cache", test_download_cache_sync);
+    g_test_add_func ("/download/cache-concurrent", test_download_cache_concurrent);
+    g_test_add_func ("/download/many", test_download_many_sync);
+    g_test_add_func ("/download/many-bandwidth-limit", test_download_many_bandwidth_limit);
+    g_test_add_func ("/export-snapshot/sync", test_export_snapshot_sync);
+    g_test_add_func ("/export-snapshot/not-found", test_export_snapshot_not_found);
+    g_test_add_func ("/import-snapshot/sync", test_import_snapshot_sync);
+    g_test_add_func ("/import-snapshot/short-stream", test_import_snapshot_short_stream);
+    g_test_add_func ("/import-snapshot/fd", test_import_snapshot_fd);
     g_test_add_func ("/themes/check/sync", test_themes_check_sync);
     g_test_add_func ("/themes/check/async", test_themes_check_async);
+    g_test_add_func ("/themes/check/cached", test_themes_check_cached);
     g_test_add_func ("/themes/install/sync", test_themes_install_sync);
     g_test_add_func ("/themes/install/async", test_themes_install_async);
     g_test_add_func ("/themes/install/no-snaps", test_themes_install_no_snaps);
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+#include <string.h>
+#include <json-glib/json-glib.h>
+#include <snapd-glib/snapd-glib.h>
+
+#include "snapd-json-simd.h"
+
+/* Result arrays in the form snapd returns them */
+static const gchar *fixtures[] = {
+    "[]",
+    "[1,-2,3.5,true,false,null,\"text\"]",
+    "[{\"id\":\"ID\",\"name\":\"snap\",\"version\":\"1.0\",\"revision\":\"1\",\"channel\":\"stable\",\"confinement\":\"strict\",\"devmode\":false,"
+    "\"installed-size\":1024,\"install-date\":\"2017-01-02T11:23:58Z\",\"status\":\"active\",\"type\":\"app\","
+    "\"apps\":[{\"snap\":\"snap\",\"name\":\"app\",\"daemon\":\"simple\",\"aliases\":[\"a1\",\"a2\"]}],"
+    "\"publisher\":{\"id\":\"PUBLISHER-ID\",\"username\":\"publisher\",\"display-name\":\"PUBLISHER\",\"validation\":\"verified\"},"
+    "\"tracks\":[\"latest\"],\"channels\":{\"latest/stable\":{\"revision\":\"1\",\"version\":\"1.0\",\"size\":65535}}},"
+    "{\"id\":\"ID2\",\"name\":\"snap2\",\"summary\":\"Unicode \\u00e9\\u2603 and \\\"escapes\\\"\\n\",\"media\":[]}]",
+    "[{\"id\":\"1\",\"kind\":\"install-snap\",\"summary\":\"Install snap\",\"status\":\"Doing\",\"ready\":false,\"spawn-time\":\"2017-01-02T11:23:58Z\","
+    "\"tasks\":[{\"id\":\"100\",\"kind\":\"download\",\"progress\":{\"label\":\"\",\"done\":65535,\"total\":65536}}],"
+    "\"data\":{\"snap-names\":[\"snap\"]}}]",
+    "[[[[1]]],{\"a\":{\"b\":{\"c\":[]}}},{}]",
+};
+
+static gboolean
+collect_element_cb (JsonNode *element, gpointer user_data, GError **error)
+{
+    GPtrArray *elements = user_data;
+    g_ptr_array_add (elements, json_to_string (element, FALSE));
+    return TRUE;
+}
+
+static GPtrArray *
+parse_json_glib (const gchar *data)
+{
+    g_autoptr(JsonParser) parser = json_parser_new ();
+    g_autoptr(GError) error = NULL;
+    g_assert_true (json_parser_load_from_data (parser, data, -1, &error));
+    g_assert_no_error (error);
+
+    JsonArray *array = json_node_get_array (json_parser_get_root (parser));
+    GPtrArray *elements = g_ptr_array_new_with_free_func (g_free);
+    for (guint i = 0; i < json_array_get_length (array); i++)
+        g_ptr_array_add (elements, json_to_string (json_array_get_element (array, i), FALSE));
+    return elements;
+}
+
+static void
+test_json_simd_compare (void)
+{
+    for (gsize i = 0; i < G_N_ELEMENTS (fixtures); i++) {
+        g_autoptr(GPtrArray) expected = parse_json_glib (fixtures[i]);
+
+        g_autoptr(GPtrArray) elements = g_ptr_array_new_with_free_func (g_free);
+        guint n_elements = 0;
+        g_autoptr(GError) error = NULL;
+        g_assert_true (_snapd_json_simd_parse_array (fixtures[i], strlen (fixtures[i]), 0, G_MAXUINT, &n_elements, collect_element_cb, elements, &error));
+        g_assert_no_error (error);
+
+        g_assert_cmpint (n_elements, ==, expected->len);
+        g_assert_cmpint (elements->len, ==, expected->len);
+        for (guint j = 0; j < expected->len; j++)
+            g_assert_cmpstr (g_ptr_array_index (elements, j), ==, g_ptr_array_index (expected, j));
+    }
+}
+
+static void
+test_json_simd_range (void)
+{
+    const gchar *data = "[1,2,3,4,5]";
+    g_autoptr(GPtrArray) elements = g_ptr_array_new_with_free_func (g_free);
+    guint n_elements = 0;
+    g_autoptr(GError) error = NULL;
+    g_assert_true (_snapd_json_simd_parse_array (data, strlen (data), 1, 2, &n_elements, collect_element_cb, elements, &error));
+    g_assert_no_error (error);
+
+    /* Elements outside the range are counted but not returned */
+    g_assert_cmpint (n_elements, ==, 5);
+    g_assert_cmpint (elements->len, ==, 2);
+    g_assert_cmpstr (g_ptr_array_index (elements, 0), ==, "2");
+    g_assert_cmpstr (g_ptr_array_index (elements, 1), ==, "3");
+}
+
+static void
+test_json_simd_invalid (void)
+{
+    const gchar *invalid[] = { "", "[", "[1,]", "{\"a\":1}", "[\"unterminated]" };
+
+    for (gsize i = 0; i < G_N_ELEMENTS (invalid); i++) {
+        g_autoptr(GPtrArray) elements = g_ptr_array_new_with_free_func (g_free);
+        g_autoptr(GError) error = NULL;
+        g_assert_false (_snapd_json_simd_parse_array (invalid[i], strlen (invalid[i]), 0, G_MAXUINT, NULL, collect_element_cb, elements, &error));
+        g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE);
+    }
+}
+
+static gchar *
+make_nested (guint depth)
+{
+    g_autoptr(GString) data = g_string_new ("[");
+    for (guint i = 0; i < depth; i++)
+        g_string_append_c (data, '[');
+    for (guint i = 0; i < depth; i++)
+        g_string_append_c (data, ']');
+    g_string_append_c (data, ']');
+    return g_string_free (g_steal_pointer (&data), FALSE);
+}
+
+static void
+test_json_simd_depth (void)
+{
+    /* Elements can be nested up to the limit */
+    g_autofree gchar *data = make_nested (64);
+    g_autoptr(GPtrArray) elements = g_ptr_array_new_with_free_func (g_free);
+    g_autoptr(GError) error = NULL;
+    g_assert_true (_snapd_json_simd_parse_array (data, strlen (data), 0, G_MAXUINT, NULL, collect_element_cb, elements, &error));
+    g_assert_no_error (error);
+    g_assert_cmpint (elements->len, ==, 1);
+
+    /* But not beyond it */
+    g_autofree gchar *deep_data = make_nested (65);
+    g_autoptr(GPtrArray) deep_elements = g_ptr_array_new_with_free_func (g_free);
+    g_assert_false (_snapd_json_simd_parse_array (deep_data, strlen (deep_data), 0, G_MAXUINT, NULL, collect_element_cb, deep_elements, &error));
+    g_assert_error (error, SNAPD_ERROR, SNAPD_ERROR_BAD_RESPONSE);
+    g_assert_cmpint (deep_elements->len, ==, 0);
+}
+
+int
+main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/json-simd/compare", test_json_simd_compare);
+    g_test_add_func ("/json-simd/range", test_json_simd_range);
+    g_test_add_func ("/json-simd/invalid", test_json_simd_invalid);
+    g_test_add_func ("/json-simd/depth", test_json_simd_depth);
+
+    return g_test_run ();
+}
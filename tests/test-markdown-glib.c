@@ -880,6 +880,348 @@ test_markdown_whitespace (void)
     g_assert_cmpstr (whitespace4, ==, "<p>A <em>very emphasised</em> line</p>\n");
 }
 
+static gchar *serialize_flat_node (const SnapdMarkdownFlatNode *nodes, const gchar *text, gint index);
+
+static gchar *
+serialize_flat_nodes (const SnapdMarkdownFlatNode *nodes, const gchar *text, gint first_index)
+{
+    g_autoptr(GString) result = g_string_new ("");
+
+    for (gint i = first_index; i >= 0; i = nodes[i].next_sibling) {
+        g_autofree gchar *node_text = serialize_flat_node (nodes, text, i);
+        g_string_append (result, node_text);
+    }
+
+    return g_steal_pointer (&result->str);
+}
+
+static gchar *
+serialize_flat_node (const SnapdMarkdownFlatNode *nodes, const gchar *text, gint index)
+{
+   const SnapdMarkdownFlatNode *node = &nodes[index];
+
+   g_autofree gchar *contents = NULL;
+   switch (node->node_type) {
+   case SNAPD_MARKDOWN_NODE_TYPE_TEXT:
+       g_assert_cmpint (node->first_child, ==, -1);
+       g_assert_cmpint (strlen (text + node->text_offset), ==, node->text_length);
+       return escape_text (text + node->text_offset);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<p>%s</p>\n", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_UNORDERED_LIST:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<ul>\n%s</ul>\n", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_LIST_ITEM:
+       if (node->first_child < 0)
+           return g_strdup ("<li></li>\n");
+       if (nodes[node->first_child].next_sibling < 0 &&
+           nodes[node->first_child].node_type == SNAPD_MARKDOWN_NODE_TYPE_PARAGRAPH) {
+           contents = serialize_flat_nodes (nodes, text, nodes[node->first_child].first_child);
+           return g_strdup_printf ("<li>%s</li>\n", contents);
+       }
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<li>\n%s</li>\n", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_CODE_BLOCK:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<pre><code>%s</code></pre>\n", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_CODE_SPAN:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<code>%s</code>", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_EMPHASIS:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<em>%s</em>", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_STRONG_EMPHASIS:
+       contents = serialize_flat_nodes (nodes, text, node->first_child);
+       return g_strdup_printf ("<strong>%s</strong>", contents);
+
+   case SNAPD_MARKDOWN_NODE_TYPE_URL:
+       return serialize_flat_nodes (nodes, text, node->first_child);
+
+   default:
+       g_assert_not_reached ();
+       return g_strdup ("");
+   }
+}
+
+static gchar *
+parse_flat (const gchar *text)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    snapd_markdown_parser_set_preserve_whitespace (parser, TRUE);
+    g_autoptr(SnapdMarkdownDocument) document = snapd_markdown_parser_parse_flat (parser, text);
+    guint n_nodes;
+    const SnapdMarkdownFlatNode *nodes = snapd_markdown_document_get_nodes (document, &n_nodes);
+    return serialize_flat_nodes (nodes, snapd_markdown_document_get_text (document), n_nodes > 0 ? 0 : -1);
+}
+
+static void
+test_markdown_flat (void)
+{
+    g_autofree gchar *flat0 = parse_flat ("");
+    g_assert_cmpstr (flat0, ==, "");
+
+    g_autofree gchar *flat1 = parse_flat ("a");
+    g_assert_cmpstr (flat1, ==, "<p>a</p>\n");
+
+    g_autofree gchar *flat2 = parse_flat ("aaa\n\nbbb\n");
+    g_assert_cmpstr (flat2, ==, "<p>aaa</p>\n<p>bbb</p>\n");
+
+    g_autofree gchar *flat3 = parse_flat ("- a\n  - b\n\n    c\n- d\n");
+    g_assert_cmpstr (flat3, ==, "<ul>\n<li>\n<p>a</p>\n<ul>\n<li>\n<p>b</p>\n<p>c</p>\n</li>\n</ul>\n</li>\n<li>d</li>\n</ul>\n");
+
+    g_autofree gchar *flat4 = parse_flat ("    code\n\n*foo* **bar** `baz` http://localhost\n");
+    g_assert_cmpstr (flat4, ==, "<pre><code>code\n</code></pre>\n<p><em>foo</em> <strong>bar</strong> <code>baz</code> http://localhost</p>\n");
+}
+
+static void
+test_markdown_render_html (void)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+
+    g_autofree gchar *html0 = snapd_markdown_parser_render_html (parser, "");
+    g_assert_cmpstr (html0, ==, "");
+
+    g_autofree gchar *html1 = snapd_markdown_parser_render_html (parser, "Some *emphasis* & **strong** `code <x>`\nsee https://example.com/a?b=1&c=2.\n");
+    g_assert_cmpstr (html1, ==, "<p>Some <em>emphasis</em> &amp; <strong>strong</strong> <code>code &lt;x&gt;</code> see <a href=\"https://example.com/a?b=1&amp;c=2\">https://example.com/a?b=1&amp;c=2</a>.</p>\n");
+
+    g_autofree gchar *html2 = snapd_markdown_parser_render_html (parser, "- a\n\n  b\n- c\n\ntext\n");
+    g_assert_cmpstr (html2, ==, "<ul>\n<li>\n<p>a</p>\n<p>b</p>\n</li>\n<li>c</li>\n</ul>\n<p>text</p>\n");
+}
+
+static void
+test_markdown_render_pango (void)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+
+    g_autofree gchar *pango0 = snapd_markdown_parser_render_pango (parser, "");
+    g_assert_cmpstr (pango0, ==, "");
+
+    g_autofree gchar *pango1 = snapd_markdown_parser_render_pango (parser, "Some *emphasis* & **strong** `code <x>`\nsee https://example.com.\n");
+    g_assert_cmpstr (pango1, ==, "Some <i>emphasis</i> &amp; <b>strong</b> <tt>code &lt;x&gt;</tt> see <a href=\"https://example.com\">https://example.com</a>.");
+
+    g_autofree gchar *pango2 = snapd_markdown_parser_render_pango (parser, "- a\n\n  b\n- c\n  - d\n\ntext\n\n    code\n");
+    g_assert_cmpstr (pango2, ==, "\xe2\x80\xa2 a\n  b\n\xe2\x80\xa2 c\n  \xe2\x80\xa2 d\n\ntext\n\n<tt>code</tt>");
+}
+
+static void
+test_markdown_cache (void)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    g_assert_cmpint (snapd_markdown_parser_get_cache_size (parser), ==, 0);
+
+    /* Not cached by default */
+    g_autoptr(GPtrArray) nodes0 = snapd_markdown_parser_parse (parser, "aaa");
+    g_autoptr(GPtrArray) nodes1 = snapd_markdown_parser_parse (parser, "aaa");
+    g_assert_true (g_ptr_array_index (nodes0, 0) != g_ptr_array_index (nodes1, 0));
+
+    /* Same text returns the same nodes */
+    snapd_markdown_parser_set_cache_size (parser, 2);
+    g_assert_cmpint (snapd_markdown_parser_get_cache_size (parser), ==, 2);
+    g_autoptr(GPtrArray) nodes2 = snapd_markdown_parser_parse (parser, "aaa");
+    g_autoptr(GPtrArray) nodes3 = snapd_markdown_parser_parse (parser, "aaa");
+    g_assert_true (nodes2 != nodes3);
+    g_assert_true (g_ptr_array_index (nodes2, 0) == g_ptr_array_index (nodes3, 0));
+
+    /* Different settings are parsed separately */
+    snapd_markdown_parser_set_preserve_whitespace (parser, TRUE);
+    g_autoptr(GPtrArray) nodes4 = snapd_markdown_parser_parse (parser, "aaa");
+    g_assert_true (g_ptr_array_index (nodes2, 0) != g_ptr_array_index (nodes4, 0));
+    snapd_markdown_parser_set_preserve_whitespace (parser, FALSE);
+
+    /* Least recently used results are removed */
+    g_autoptr(GPtrArray) nodes5 = snapd_markdown_parser_parse (parser, "aaa");
+    g_autoptr(GPtrArray) nodes6 = snapd_markdown_parser_parse (parser, "bbb");
+    g_autoptr(GPtrArray) nodes7 = snapd_markdown_parser_parse (parser, "aaa");
+    g_assert_true (g_ptr_array_index (nodes2, 0) == g_ptr_array_index (nodes5, 0));
+    g_assert_true (g_ptr_array_index (nodes2, 0) == g_ptr_array_index (nodes7, 0));
+    g_autoptr(GPtrArray) nodes8 = snapd_markdown_parser_parse (parser, "ccc");
+    g_autoptr(GPtrArray) nodes9 = snapd_markdown_parser_parse (parser, "bbb");
+    g_assert_true (g_ptr_array_index (nodes6, 0) != g_ptr_array_index (nodes9, 0));
+    g_autoptr(GPtrArray) nodes10 = snapd_markdown_parser_parse (parser, "ccc");
+    g_assert_true (g_ptr_array_index (nodes8, 0) == g_ptr_array_index (nodes10, 0));
+}
+
+static void
+check_buffer (SnapdMarkdownParser *parser, SnapdMarkdownBuffer *buffer)
+{
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (parser, snapd_markdown_buffer_get_text (buffer));
+    g_autofree gchar *expected = serialize_nodes (nodes);
+    g_autofree gchar *result = serialize_nodes (snapd_markdown_buffer_get_nodes (buffer));
+    g_assert_cmpstr (result, ==, expected);
+}
+
+static void
+test_markdown_buffer (void)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    snapd_markdown_parser_set_preserve_whitespace (parser, TRUE);
+    g_autoptr(SnapdMarkdownBuffer) buffer = snapd_markdown_buffer_new (parser, "Paragraph 1\n\nParagraph 2\n\nParagraph 3\n");
+    GPtrArray *nodes = snapd_markdown_buffer_get_nodes (buffer);
+    g_assert_cmpint (nodes->len, ==, 3);
+    g_autoptr(SnapdMarkdownNode) first = g_object_ref (g_ptr_array_index (nodes, 0));
+    g_autoptr(SnapdMarkdownNode) last = g_object_ref (g_ptr_array_index (nodes, 2));
+
+    /* Editing a paragraph only replaces that paragraph */
+    guint position, n_removed, n_added;
+    snapd_markdown_buffer_replace (buffer, 24, 0, "!", &position, &n_removed, &n_added);
+    g_assert_cmpstr (snapd_markdown_buffer_get_text (buffer), ==, "Paragraph 1\n\nParagraph 2!\n\nParagraph 3\n");
+    g_assert_cmpint (position, ==, 1);
+    g_assert_cmpint (n_removed, ==, 1);
+    g_assert_cmpint (n_added, ==, 1);
+    nodes = snapd_markdown_buffer_get_nodes (buffer);
+    g_assert_true (g_ptr_array_index (nodes, 0) == first);
+    g_assert_true (g_ptr_array_index (nodes, 2) == last);
+    check_buffer (parser, buffer);
+
+    /* Removing the line between paragraphs joins them */
+    snapd_markdown_buffer_replace (buffer, 12, 1, "", &position, &n_removed, &n_added);
+    g_assert_cmpint (position, ==, 0);
+    g_assert_cmpint (n_removed, ==, 2);
+    g_assert_cmpint (n_added, ==, 1);
+    nodes = snapd_markdown_buffer_get_nodes (buffer);
+    g_assert_cmpint (nodes->len, ==, 2);
+    g_assert_true (g_ptr_array_index (nodes, 1) == last);
+    check_buffer (parser, buffer);
+
+    /* Blocks that continue past the edit are parsed to their end */
+    snapd_markdown_buffer_replace (buffer, 0, 0, " - item\n    code\n", &position, &n_removed, &n_added);
+    check_buffer (parser, buffer);
+    snapd_markdown_buffer_replace (buffer, 8, 0, "\n", NULL, NULL, NULL);
+    check_buffer (parser, buffer);
+
+    /* Changing the parser settings parses everything again */
+    snapd_markdown_parser_set_preserve_whitespace (parser, FALSE);
+    guint n_nodes = snapd_markdown_buffer_get_nodes (buffer)->len;
+    snapd_markdown_buffer_replace (buffer, 0, 0, "", &position, &n_removed, &n_added);
+    g_assert_cmpint (position, ==, 0);
+    g_assert_cmpint (n_removed, ==, n_nodes);
+    check_buffer (parser, buffer);
+
+    /* Random edits give the same result as parsing the whole text */
+    const gchar *fragments[] = { "a", "b c", " ", "\n", "\n\n", "\r\n", " - ", " * ", "    ", "*", "**", "`", "https://example.com" };
+    g_autoptr(GRand) rand = g_rand_new_with_seed (0);
+    for (int i = 0; i < 500; i++) {
+        gsize text_length = strlen (snapd_markdown_buffer_get_text (buffer));
+        gsize offset = g_rand_int_range (rand, 0, text_length + 1);
+        gsize length = 0;
+        const gchar *fragment = "";
+        if (g_rand_boolean (rand) || text_length < 8)
+            fragment = fragments[g_rand_int_range (rand, 0, G_N_ELEMENTS (fragments))];
+        else
+            length = g_rand_int_range (rand, 0, MIN (text_length - offset, 8) + 1);
+        snapd_markdown_buffer_replace (buffer, offset, length, fragment, NULL, NULL, NULL);
+        check_buffer (parser, buffer);
+    }
+}
+
+static void
+async_result_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    GAsyncResult **r = user_data;
+    *r = g_object_ref (result);
+}
+
+static GAsyncResult *
+wait_for_result (GAsyncResult **result)
+{
+    while (*result == NULL)
+        g_main_context_iteration (NULL, TRUE);
+    return *result;
+}
+
+static void
+test_markdown_async (void)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+    snapd_markdown_parser_set_cache_size (parser, 10);
+
+    g_autoptr(GAsyncResult) result = NULL;
+    snapd_markdown_parser_parse_async (parser, "*a*\n\n - b", NULL, async_result_cb, &result);
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse_finish (parser, wait_for_result (&result), &error);
+    g_assert_no_error (error);
+    g_autofree gchar *serialized = serialize_nodes (nodes);
+    g_assert_cmpstr (serialized, ==, "<p><em>a</em></p>\n<ul>\n<li>b</li>\n</ul>\n");
+
+    /* Async results are added to the cache */
+    g_autoptr(GPtrArray) cached_nodes = snapd_markdown_parser_parse (parser, "*a*\n\n - b");
+    g_assert_true (g_ptr_array_index (cached_nodes, 0) == g_ptr_array_index (nodes, 0));
+
+    /* Several texts are returned in order */
+    g_autoptr(GAsyncResult) many_result = NULL;
+    const gchar *texts[] = { "*a*\n\n - b", "`c`", "", NULL };
+    snapd_markdown_parser_parse_many_async (parser, (GStrv) texts, NULL, async_result_cb, &many_result);
+    g_autoptr(GPtrArray) results = snapd_markdown_parser_parse_many_finish (parser, wait_for_result (&many_result), &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (results->len, ==, 3);
+    g_assert_true (g_ptr_array_index (g_ptr_array_index (results, 0), 0) == g_ptr_array_index (nodes, 0));
+    g_autofree gchar *serialized1 = serialize_nodes (g_ptr_array_index (results, 1));
+    g_assert_cmpstr (serialized1, ==, "<p><code>c</code></p>\n");
+    g_assert_cmpint (((GPtrArray *) g_ptr_array_index (results, 2))->len, ==, 0);
+
+    /* Cancelled requests fail */
+    g_autoptr(GCancellable) cancellable = g_cancellable_new ();
+    g_cancellable_cancel (cancellable);
+    g_autoptr(GAsyncResult) cancelled_result = NULL;
+    snapd_markdown_parser_parse_async (parser, "d", cancellable, async_result_cb, &cancelled_result);
+    g_autoptr(GPtrArray) cancelled_nodes = snapd_markdown_parser_parse_finish (parser, wait_for_result (&cancelled_result), &error);
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    g_assert_null (cancelled_nodes);
+}
+
+static void
+benchmark_parse (const gchar *name, const gchar *text)
+{
+    g_autoptr(SnapdMarkdownParser) parser = snapd_markdown_parser_new (SNAPD_MARKDOWN_VERSION_0);
+
+    g_test_timer_start ();
+    for (int i = 0; i < 1000; i++) {
+        g_autoptr(GPtrArray) nodes = snapd_markdown_parser_parse (parser, text);
+    }
+    g_test_minimized_result (g_test_timer_elapsed (), "Parsed %s 1000 times", name);
+}
+
+static void
+test_markdown_benchmark (void)
+{
+    if (!g_test_perf ()) {
+        g_test_skip ("Only run in performance mode");
+        return;
+    }
+
+    /* A typical description of a few kilobytes */
+    g_autoptr(GString) plain_text = g_string_new ("");
+    g_autoptr(GString) formatted_text = g_string_new ("");
+    for (int i = 0; i < 10; i++) {
+        g_string_append (plain_text,
+                         "This snap provides a set of tools for editing images on the desktop.\n"
+                         "It supports layers, filters and a wide range of file formats.\n"
+                         "\n"
+                         "Visit the project website for more information and documentation.\n"
+                         "\n");
+        g_string_append (formatted_text,
+                         "This snap provides a set of *tools* for editing images on the **desktop**.\n"
+                         "Run `editor --help` to see the available options.\n"
+                         "\n"
+                         " - Layers and filters\n"
+                         " - A wide range of file formats\n"
+                         "\n"
+                         "Visit https://example.com for more information.\n"
+                         "\n");
+    }
+
+    benchmark_parse ("plain text", plain_text->str);
+    benchmark_parse ("formatted text", formatted_text->str);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -898,6 +1240,13 @@ main (int argc, char **argv)
     g_test_add_func ("/markdown/textual-content", test_markdown_textual_content);
     g_test_add_func ("/markdown/urls", test_markdown_urls);
     g_test_add_func ("/markdown/whitespace", test_markdown_whitespace);
+    g_test_add_func ("/markdown/flat", test_markdown_flat);
+    g_test_add_func ("/markdown/render-html", test_markdown_render_html);
+    g_test_add_func ("/markdown/render-pango", test_markdown_render_pango);
+    g_test_add_func ("/markdown/cache", test_markdown_cache);
+    g_test_add_func ("/markdown/buffer", test_markdown_buffer);
+    g_test_add_func ("/markdown/async", test_markdown_async);
+    g_test_add_func ("/markdown/benchmark", test_markdown_benchmark);
 
     return g_test_run ();
 }
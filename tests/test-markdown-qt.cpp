@@ -10,7 +10,9 @@
 #include <glib-object.h>
 
 #include <Snapd/MarkdownParser>
+#include <Snapd/MarkdownTextRenderer>
 #include <QDebug>
+#include <QGuiApplication>
 
 static QString
 escape_text (const QString &text)
@@ -869,11 +871,261 @@ test_markdown_whitespace ()
     g_assert_true (whitespace4 == "<p>A <em>very emphasised</em> line</p>\n");
 }
 
+static QString serialize_flat_node (QSnapdMarkdownDocument &document, int index);
+
+static QString
+serialize_flat_nodes (QSnapdMarkdownDocument &document, int first_index)
+{
+    QString result;
+    for (int i = first_index; i >= 0; i = document.nextSibling (i))
+        result += serialize_flat_node (document, i);
+    return result;
+}
+
+static QString
+serialize_flat_node (QSnapdMarkdownDocument &document, int index)
+{
+   int first_child = document.firstChild (index);
+
+   switch (document.nodeType (index)) {
+   case QSnapdMarkdownNode::NodeTypeText:
+       return escape_text (document.nodeText (index));
+
+   case QSnapdMarkdownNode::NodeTypeParagraph:
+       return "<p>" + serialize_flat_nodes (document, first_child) + "</p>\n";
+
+   case QSnapdMarkdownNode::NodeTypeUnorderedList:
+       return "<ul>\n" + serialize_flat_nodes (document, first_child) + "</ul>\n";
+
+   case QSnapdMarkdownNode::NodeTypeListItem:
+       if (first_child < 0)
+           return "<li></li>\n";
+       if (document.nextSibling (first_child) < 0 && document.nodeType (first_child) == QSnapdMarkdownNode::NodeTypeParagraph)
+           return "<li>" + serialize_flat_nodes (document, document.firstChild (first_child)) + "</li>\n";
+       return "<li>\n" + serialize_flat_nodes (document, first_child) + "</li>\n";
+
+   case QSnapdMarkdownNode::NodeTypeCodeBlock:
+       return "<pre><code>" + serialize_flat_nodes (document, first_child) + "</code></pre>\n";
+
+   case QSnapdMarkdownNode::NodeTypeCodeSpan:
+       return "<code>" + serialize_flat_nodes (document, first_child) + "</code>";
+
+   case QSnapdMarkdownNode::NodeTypeEmphasis:
+       return "<em>" + serialize_flat_nodes (document, first_child) + "</em>";
+
+   case QSnapdMarkdownNode::NodeTypeStrongEmphasis:
+       return "<strong>" + serialize_flat_nodes (document, first_child) + "</strong>";
+
+   case QSnapdMarkdownNode::NodeTypeUrl:
+       return serialize_flat_nodes (document, first_child);
+
+   default:
+       g_assert_not_reached ();
+       return "";
+   }
+}
+
+static QString
+parse_flat (const QString &text)
+{
+    QSnapdMarkdownParser parser (QSnapdMarkdownParser::MarkdownVersion0);
+    parser.setPreserveWhitespace (true);
+    QScopedPointer<QSnapdMarkdownDocument> document (parser.parseFlat (text));
+    return serialize_flat_nodes (*document, document->nodeCount () > 0 ? 0 : -1);
+}
+
+static void
+test_markdown_flat ()
+{
+    QString flat0 = parse_flat ("");
+    g_assert_true (flat0 == "");
+
+    QString flat1 = parse_flat ("a");
+    g_assert_true (flat1 == "<p>a</p>\n");
+
+    QString flat2 = parse_flat ("aaa\n\nbbb\n");
+    g_assert_true (flat2 == "<p>aaa</p>\n<p>bbb</p>\n");
+
+    QString flat3 = parse_flat ("- a\n  - b\n\n    c\n- d\n");
+    g_assert_true (flat3 == "<ul>\n<li>\n<p>a</p>\n<ul>\n<li>\n<p>b</p>\n<p>c</p>\n</li>\n</ul>\n</li>\n<li>d</li>\n</ul>\n");
+
+    QString flat4 = parse_flat ("    code\n\n*foo* **bar** `baz` http://localhost\n");
+    g_assert_true (flat4 == "<pre><code>code\n</code></pre>\n<p><em>foo</em> <strong>bar</strong> <code>baz</code> http://localhost</p>\n");
+}
+
+static void
+test_markdown_async ()
+{
+    QSnapdMarkdownParser parser (QSnapdMarkdownParser::MarkdownVersion0);
+    QStringList texts;
+    QStringList results;
+    QObject::connect (&parser, &QSnapdMarkdownParser::parsed, [&texts, &results] (const QString &text, const QList<QSnapdMarkdownNode> &nodes) {
+        texts.append (text);
+        QString result;
+        for (int i = 0; i < nodes.size (); i++) {
+            QSnapdMarkdownNode node = nodes[i];
+            result += serialize_node (node);
+        }
+        results.append (result);
+    });
+
+    parser.parseAsync ("*a*");
+    parser.parseManyAsync (QStringList () << "b" << "`c`");
+    while (results.size () < 3)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_true (texts == QStringList () << "*a*" << "b" << "`c`");
+    g_assert_true (results == QStringList () << "<p><em>a</em></p>\n" << "<p>b</p>\n" << "<p><code>c</code></p>\n");
+
+    /* Cancelled texts are not returned */
+    parser.parseAsync ("d");
+    parser.cancelParsing ();
+    parser.parseAsync ("e");
+    while (results.size () < 4)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_true (texts.last () == "e");
+}
+
+static QTextDocument *
+render (const QString &text)
+{
+    QSnapdMarkdownParser parser (QSnapdMarkdownParser::MarkdownVersion0);
+    QScopedPointer<QSnapdMarkdownDocument> document (parser.parseFlat (text));
+    return QSnapdMarkdownTextRenderer::toTextDocument (*document);
+}
+
+static QTextCharFormat
+fragment_format (const QTextBlock &block, int index)
+{
+    QTextBlock::iterator it = block.begin ();
+    for (int i = 0; i < index; i++)
+        it++;
+    g_assert_false (it.atEnd ());
+    return it.fragment ().charFormat ();
+}
+
+static QString
+fragment_text (const QTextBlock &block, int index)
+{
+    QTextBlock::iterator it = block.begin ();
+    for (int i = 0; i < index; i++)
+        it++;
+    g_assert_false (it.atEnd ());
+    return it.fragment ().text ();
+}
+
+static void
+test_markdown_render_empty ()
+{
+    QScopedPointer<QTextDocument> document (render (""));
+    g_assert_cmpint (document->blockCount (), ==, 1);
+    g_assert_true (document->toPlainText () == "");
+}
+
+static void
+test_markdown_render_paragraphs ()
+{
+    QScopedPointer<QTextDocument> document (render ("aaa\n\nbbb\nccc\n"));
+    g_assert_cmpint (document->blockCount (), ==, 2);
+    QTextBlock block0 = document->firstBlock ();
+    g_assert_true (block0.text () == "aaa");
+    g_assert_null (block0.textList ());
+    QTextBlock block1 = block0.next ();
+    g_assert_true (block1.text () == QString ("bbb") + QChar (QChar::LineSeparator) + "ccc");
+    g_assert_null (block1.textList ());
+}
+
+static void
+test_markdown_render_code ()
+{
+    QScopedPointer<QTextDocument> document (render ("    code\n    more\n\ntext\n"));
+    g_assert_cmpint (document->blockCount (), ==, 2);
+
+    /* Lines of code are kept in one block */
+    QTextBlock block0 = document->firstBlock ();
+    g_assert_true (block0.text () == QString ("code") + QChar (QChar::LineSeparator) + "more");
+    QString fixed_family = QFontDatabase::systemFont (QFontDatabase::FixedFont).family ();
+    g_assert_true (fragment_format (block0, 0).fontFamily () == fixed_family);
+
+    QTextBlock block1 = block0.next ();
+    g_assert_true (block1.text () == "text");
+    g_assert_true (fragment_format (block1, 0).fontFamily () != fixed_family);
+}
+
+static void
+test_markdown_render_lists ()
+{
+    QScopedPointer<QTextDocument> document (render ("- a\n  - b\n- c\n\nd\n"));
+    g_assert_cmpint (document->blockCount (), ==, 4);
+
+    QTextBlock block0 = document->firstBlock ();
+    g_assert_true (block0.text () == "a");
+    g_assert_nonnull (block0.textList ());
+    g_assert_cmpint (block0.textList ()->format ().style (), ==, QTextListFormat::ListDisc);
+    g_assert_cmpint (block0.textList ()->count (), ==, 2);
+
+    /* Nested lists use a different bullet */
+    QTextBlock block1 = block0.next ();
+    g_assert_true (block1.text () == "b");
+    g_assert_nonnull (block1.textList ());
+    g_assert_true (block1.textList () != block0.textList ());
+    g_assert_cmpint (block1.textList ()->format ().style (), ==, QTextListFormat::ListCircle);
+
+    QTextBlock block2 = block1.next ();
+    g_assert_true (block2.text () == "c");
+    g_assert_true (block2.textList () == block0.textList ());
+
+    /* Blocks after a list aren't in it */
+    QTextBlock block3 = block2.next ();
+    g_assert_true (block3.text () == "d");
+    g_assert_null (block3.textList ());
+}
+
+static void
+test_markdown_render_inlines ()
+{
+    QScopedPointer<QTextDocument> document (render ("*foo* **bar** `baz`\n"));
+    g_assert_cmpint (document->blockCount (), ==, 1);
+    QTextBlock block = document->firstBlock ();
+    g_assert_true (block.text () == "foo bar baz");
+
+    g_assert_true (fragment_text (block, 0) == "foo");
+    g_assert_true (fragment_format (block, 0).fontItalic ());
+    g_assert_true (fragment_text (block, 2) == "bar");
+    g_assert_cmpint (fragment_format (block, 2).fontWeight (), ==, QFont::Bold);
+    g_assert_true (fragment_text (block, 4) == "baz");
+    g_assert_true (fragment_format (block, 4).fontFamily () == QFontDatabase::systemFont (QFontDatabase::FixedFont).family ());
+
+    g_assert_false (fragment_format (block, 1).fontItalic ());
+    g_assert_cmpint (fragment_format (block, 3).fontWeight (), !=, QFont::Bold);
+}
+
+static void
+test_markdown_render_urls ()
+{
+    QScopedPointer<QTextDocument> document (render ("see https://snapcraft.io\n"));
+    g_assert_cmpint (document->blockCount (), ==, 1);
+    QTextBlock block = document->firstBlock ();
+    g_assert_true (block.text () == "see https://snapcraft.io");
+
+    QTextCharFormat text_format = fragment_format (block, 0);
+    g_assert_true (fragment_text (block, 0) == "see ");
+    g_assert_false (text_format.isAnchor ());
+
+    QTextCharFormat url_format = fragment_format (block, 1);
+    g_assert_true (fragment_text (block, 1) == "https://snapcraft.io");
+    g_assert_true (url_format.isAnchor ());
+    g_assert_true (url_format.anchorHref () == "https://snapcraft.io");
+    g_assert_true (url_format.fontUnderline ());
+}
+
 int
 main (int argc, char **argv)
 {
     g_test_init (&argc, &argv, NULL);
 
+    /* Fonts used by the text renderer need a GUI application */
+    QGuiApplication app (argc, argv);
+
     g_test_add_func ("/markdown/empty", test_markdown_empty);
     g_test_add_func ("/markdown/single-character", test_markdown_single_character);
     g_test_add_func ("/markdown/precedence", test_markdown_precedence);
@@ -887,6 +1139,14 @@ main (int argc, char **argv)
     g_test_add_func ("/markdown/textual-content", test_markdown_textual_content);
     g_test_add_func ("/markdown/urls", test_markdown_urls);
     g_test_add_func ("/markdown/whitespace", test_markdown_whitespace);
+    g_test_add_func ("/markdown/flat", test_markdown_flat);
+    g_test_add_func ("/markdown/async", test_markdown_async);
+    g_test_add_func ("/markdown/render/empty", test_markdown_render_empty);
+    g_test_add_func ("/markdown/render/paragraphs", test_markdown_render_paragraphs);
+    g_test_add_func ("/markdown/render/code", test_markdown_render_code);
+    g_test_add_func ("/markdown/render/lists", test_markdown_render_lists);
+    g_test_add_func ("/markdown/render/inlines", test_markdown_render_inlines);
+    g_test_add_func ("/markdown/render/urls", test_markdown_render_urls);
 
     return g_test_run ();
 }
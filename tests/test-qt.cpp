@@ -7,11 +7,20 @@
  * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
  */
 
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <glib/gstdio.h>
+
 #include "mock-snapd.h"
 
 #include <QBuffer>
+#include <QCoreApplication>
+#include <QTemporaryFile>
+#include <QThread>
 #include <Snapd/Client>
 #include <Snapd/Assertion>
+#include <Snapd/SnapListModel>
 
 #include "test-qt.h"
 
@@ -62,6 +71,15 @@ test_client_set_socket_path (void)
     g_assert_true (client.socketPath () == default_path);
 }
 
+static void
+test_auth_data_discharges ()
+{
+    QStringList discharges;
+    discharges << "" << "discharge" << QString::fromUtf8 ("\xc3\xbcnic\xc3\xb6de") << QString::fromUtf8 ("\xf0\x9f\x98\x80");
+    QSnapdAuthData authData ("macaroon", discharges);
+    g_assert_true (authData.discharges () == discharges);
+}
+
 static void
 test_user_agent_default ()
 {
@@ -255,6 +273,37 @@ test_maintenance_unknown ()
     g_assert_true (maintenance->message () == "MESSAGE");
 }
 
+static void
+test_shared_client ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_build_id (snapd, "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient *client = QSnapdClient::shared ();
+    g_assert_true (client == QSnapdClient::shared ());
+    g_assert_true (client->useIOThread ());
+    client->setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    // Requests can be made from multiple threads at once
+    std::atomic<int> n_succeeded (0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.push_back (std::thread ([client, &n_succeeded] () {
+            for (int j = 0; j < 10; j++) {
+                QScopedPointer<QSnapdGetSystemInformationRequest> infoRequest (client->getSystemInformation ());
+                infoRequest->runSync ();
+                QScopedPointer<QSnapdSystemInformation> systemInformation (infoRequest->systemInformation ());
+                if (infoRequest->error () == QSnapdRequest::NoError && systemInformation->buildId () == "efdd0b5e69b0742fa5e5bad0771df4d1df2459d1")
+                    n_succeeded++;
+            }
+        }));
+    }
+    for (auto &thread : threads)
+        thread.join ();
+    g_assert_cmpint (n_succeeded, ==, 40);
+}
+
 static void
 test_get_system_information_sync ()
 {
@@ -338,6 +387,36 @@ test_get_system_information_async ()
     g_main_loop_run (loop);
 }
 
+static void
+test_get_system_information_thread_pool ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_set_managed (snapd, TRUE);
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSystemInformationRequest> infoRequest (client.getSystemInformation ());
+    QThread *thread = QThread::currentThread ();
+    int n_complete = 0;
+    QObject::connect (infoRequest.data (), &QSnapdRequest::complete, [thread, &n_complete] () {
+        g_assert_true (QThread::currentThread () == thread);
+        n_complete++;
+    });
+    infoRequest->runInThreadPool ();
+
+    // Completion is posted to this thread
+    while (!infoRequest->isFinished ()) {
+        g_usleep (1000);
+        QCoreApplication::sendPostedEvents ();
+    }
+    g_assert_cmpint (n_complete, ==, 1);
+    g_assert_cmpint (infoRequest->error (), ==, QSnapdRequest::NoError);
+    QScopedPointer<QSnapdSystemInformation> systemInformation (infoRequest->systemInformation ());
+    g_assert_true (systemInformation->managed ());
+}
+
 static void
 test_get_system_information_store ()
 {
@@ -1280,6 +1359,130 @@ test_get_snaps_sync ()
     g_assert_true (snap2->name () == "snap3");
 }
 
+static void
+test_get_snaps_snap_infos ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap1");
+    mock_snap_add_app (s, "app1");
+    mock_snapd_add_snap (snapd, "snap2");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSnapsRequest> getSnapsRequest (client.getSnaps ());
+    getSnapsRequest->runSync ();
+    g_assert_cmpint (getSnapsRequest->error (), ==, QSnapdRequest::NoError);
+    QVector<QSnapdSnapInfo> snaps = getSnapsRequest->snapInfos ();
+    g_assert_cmpint (snaps.count (), ==, 2);
+    g_assert_true (snaps[0].name () == "snap1");
+    g_assert_true (snaps[1].name () == "snap2");
+
+    // Copies share the same snap
+    QSnapdSnapInfo copy = snaps[0];
+    snaps.clear ();
+    g_assert_false (copy.isNull ());
+    QVector<QSnapdAppInfo> apps = copy.apps ();
+    g_assert_cmpint (apps.count (), ==, 1);
+    g_assert_true (apps[0].name () == "app1");
+    g_assert_true (apps[0].snap () == "snap1");
+
+    QScopedPointer<QSnapdSnap> snap (copy.toObject ());
+    g_assert_true (snap->name () == "snap1");
+
+    g_assert_true (QSnapdSnapInfo ().isNull ());
+}
+
+static void
+test_get_snaps_future ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    mock_snapd_add_snap (snapd, "snap2");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    // Requests can run in parallel without a QSnapdRequest each
+    QFuture<QSnapdResult<QVector<QSnapdSnapInfo>>> snapsFuture = client.getSnapsAsync ();
+    QFuture<QSnapdResult<QByteArray>> iconFuture = client.getIconAsync ("snap1");
+    while (!snapsFuture.isFinished () || !iconFuture.isFinished ())
+        g_main_context_iteration (NULL, TRUE);
+
+    QSnapdResult<QVector<QSnapdSnapInfo>> snaps = snapsFuture.result ();
+    g_assert_true (snaps.isOk ());
+    g_assert_cmpint (snaps.value ().count (), ==, 2);
+    g_assert_true (snaps.value ()[0].name () == "snap1");
+    g_assert_true (snaps.value ()[1].name () == "snap2");
+
+    // Errors are returned in the result
+    QSnapdResult<QByteArray> icon = iconFuture.result ();
+    g_assert_false (icon.isOk ());
+    g_assert_cmpint (icon.error (), ==, QSnapdRequest::NotFound);
+}
+
+static void
+test_get_snaps_list_model ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap1");
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap2");
+    mock_snap_set_revision (s, "1");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QSnapdSnapListModel model;
+    int inserted = 0, removed = 0, changed = 0;
+    QObject::connect (&model, &QSnapdSnapListModel::rowsInserted, [&inserted] (const QModelIndex &, int first, int last) { inserted += last - first + 1; });
+    QObject::connect (&model, &QSnapdSnapListModel::rowsRemoved, [&removed] (const QModelIndex &, int first, int last) { removed += last - first + 1; });
+    QObject::connect (&model, &QSnapdSnapListModel::dataChanged, [&changed] (const QModelIndex &topLeft, const QModelIndex &bottomRight) { changed += bottomRight.row () - topLeft.row () + 1; });
+
+    QScopedPointer<QSnapdGetSnapsRequest> getSnapsRequest (client.getSnaps ());
+    getSnapsRequest->runSync ();
+    g_assert_cmpint (getSnapsRequest->error (), ==, QSnapdRequest::NoError);
+    model.setSnaps (getSnapsRequest.data ());
+    g_assert_cmpint (inserted, ==, 2);
+    g_assert_cmpint (model.rowCount (), ==, 2);
+    g_assert_true (model.data (model.index (0), QSnapdSnapListModel::NameRole).toString () == "snap1");
+    g_assert_true (model.data (model.index (1), QSnapdSnapListModel::NameRole).toString () == "snap2");
+    g_assert_true (model.roleNames ()[QSnapdSnapListModel::NameRole] == "name");
+
+    // Refreshing only reports the differences
+    mock_snapd_remove_snap (snapd, "snap1");
+    mock_snap_set_revision (mock_snapd_find_snap (snapd, "snap2"), "2");
+    mock_snapd_add_snap (snapd, "snap3");
+    inserted = 0;
+    getSnapsRequest.reset (client.getSnaps ());
+    getSnapsRequest->runSync ();
+    g_assert_cmpint (getSnapsRequest->error (), ==, QSnapdRequest::NoError);
+    model.setSnaps (getSnapsRequest.data ());
+    g_assert_cmpint (removed, ==, 1);
+    g_assert_cmpint (changed, ==, 1);
+    g_assert_cmpint (inserted, ==, 1);
+    g_assert_cmpint (model.rowCount (), ==, 2);
+    g_assert_true (model.data (model.index (0), QSnapdSnapListModel::NameRole).toString () == "snap2");
+    g_assert_true (model.data (model.index (0), QSnapdSnapListModel::RevisionRole).toString () == "2");
+    g_assert_true (model.data (model.index (1), QSnapdSnapListModel::NameRole).toString () == "snap3");
+    g_assert_cmpint (model.indexOf ("snap3"), ==, 1);
+
+    // Rows are only exposed as requested when batched
+    QSnapdSnapListModel batchedModel;
+    batchedModel.setBatchSize (1);
+    batchedModel.setSnaps (getSnapsRequest.data ());
+    g_assert_cmpint (batchedModel.count (), ==, 2);
+    g_assert_cmpint (batchedModel.rowCount (), ==, 0);
+    g_assert_true (batchedModel.canFetchMore (QModelIndex ()));
+    batchedModel.fetchMore (QModelIndex ());
+    g_assert_cmpint (batchedModel.rowCount (), ==, 1);
+    batchedModel.fetchMore (QModelIndex ());
+    g_assert_cmpint (batchedModel.rowCount (), ==, 2);
+    g_assert_false (batchedModel.canFetchMore (QModelIndex ()));
+}
+
 void
 GetSnapsHandler::onComplete ()
 {
@@ -1570,6 +1773,71 @@ QT_WARNING_POP
     g_main_loop_quit (loop);
 }
 
+static void
+test_get_snap_details ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSnapRequest> getSnapRequest (client.getSnap ("snap"));
+    getSnapRequest->runSync ();
+    g_assert_cmpint (getSnapRequest->error (), ==, QSnapdRequest::NoError);
+    QScopedPointer<QSnapdSnap> snap (getSnapRequest->snap ());
+
+    snap->setDetailsClient (&client);
+    mock_snap_set_description (s, "DESCRIPTION");
+    MockMedia *m = mock_snap_add_media (s, "screenshot", "http://example.com/screenshot.png", 1024, 1024);
+    int descriptionChanged = 0, websiteChanged = 0, mediaChanged = 0;
+    bool loaded = false;
+    QObject::connect (snap.data (), &QSnapdSnap::descriptionChanged, [&descriptionChanged] () { descriptionChanged++; });
+    QObject::connect (snap.data (), &QSnapdSnap::websiteChanged, [&websiteChanged] () { websiteChanged++; });
+    QObject::connect (snap.data (), &QSnapdSnap::mediaChanged, [&mediaChanged] () { mediaChanged++; });
+    QObject::connect (snap.data (), &QSnapdSnap::detailsLoaded, [&loaded] () { loaded = true; });
+
+    // Reading missing details doesn't fetch them
+    guint request_count = mock_snapd_get_request_count (snapd);
+    g_assert_null (snap->description ());
+    g_assert_null (snap->website ());
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_false (loaded);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count);
+
+    // Loading them updates the same object
+    snap->loadDetails ();
+    while (!loaded)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_true (snap->description () == "DESCRIPTION");
+    g_assert_cmpint (descriptionChanged, ==, 1);
+    g_assert_cmpint (websiteChanged, ==, 0);
+    g_assert_cmpint (mediaChanged, ==, 1);
+    g_assert_true (snap->name () == "snap");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, request_count + 1);
+
+    // Loading again fetches them again
+    loaded = false;
+    mock_snap_set_description (s, "DESCRIPTION2");
+    snap->loadDetails ();
+    while (!loaded)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_true (snap->description () == "DESCRIPTION2");
+    g_assert_cmpint (descriptionChanged, ==, 2);
+    g_assert_cmpint (mediaChanged, ==, 1);
+
+    // Media that is replaced is reported even if there is the same number of them
+    loaded = false;
+    mock_media_set_url (m, "http://example.com/screenshot2.png");
+    snap->loadDetails ();
+    while (!loaded)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_cmpint (mediaChanged, ==, 2);
+    QScopedPointer<QSnapdMedia> media (snap->media (0));
+    g_assert_true (media->url () == "http://example.com/screenshot2.png");
+}
+
 static void
 test_get_snap_async ()
 {
@@ -1775,6 +2043,59 @@ test_get_snap_common_ids ()
     g_assert_true (app2->commonId () == "ID2");
 }
 
+static void
+test_get_snap_wrapper_ownership ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_add_app (s, "app1");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSnapRequest> getSnapRequest (client.getSnap ("snap"));
+    getSnapRequest->runSync ();
+    g_assert_cmpint (getSnapRequest->error (), ==, QSnapdRequest::NoError);
+    QScopedPointer<QSnapdSnap> snap (getSnapRequest->snap ());
+
+    // Each call returns a new wrapper owned by the caller
+    QScopedPointer<QSnapdApp> app1 (snap->app (0));
+    QScopedPointer<QSnapdApp> app2 (snap->app (0));
+    g_assert_true (app1.data () != app2.data ());
+    g_assert_null (app1->parent ());
+
+    // Which remains valid after the snap is deleted
+    snap.reset ();
+    g_assert_true (app1->name () == "app1");
+}
+
+static void
+test_get_snap_cached_strings ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    mock_snap_set_description (s, "DESCRIPTION");
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSnapRequest> getSnapRequest (client.getSnap ("snap"));
+    getSnapRequest->runSync ();
+    g_assert_cmpint (getSnapRequest->error (), ==, QSnapdRequest::NoError);
+    QScopedPointer<QSnapdSnap> snap (getSnapRequest->snap ());
+
+    // Strings are only converted once, and shared between wrappers
+    QString description1 = snap->description ();
+    g_assert_true (description1 == "DESCRIPTION");
+    QString description2 = snap->description ();
+    g_assert_true (description1.constData () == description2.constData ());
+    QScopedPointer<QSnapdSnap> snap2 (getSnapRequest->snap ());
+    QString description3 = snap2->description ();
+    g_assert_true (description1.constData () == description3.constData ());
+}
+
 static void
 test_get_snap_not_installed ()
 {
@@ -2046,6 +2367,43 @@ test_get_snap_conf_invalid_key ()
     g_assert_cmpint (getSnapConfRequest->error (), ==, QSnapdRequest::OptionNotFound);
 }
 
+static void
+test_get_snap_conf_value ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    setup_get_snap_conf (snapd);
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdGetSnapConfRequest> getSnapConfRequest (client.getSnapConf ("system"));
+    getSnapConfRequest->runSync ();
+    g_assert_cmpint (getSnapConfRequest->error (), ==, QSnapdRequest::NoError);
+
+    g_assert_cmpint (getSnapConfRequest->keys ().size (), ==, 6);
+    g_assert_true (getSnapConfRequest->value ("string-key") == "value");
+    g_assert_true (getSnapConfRequest->value ("int-key") == 42);
+    g_assert_false (getSnapConfRequest->value ("missing-key").isValid ());
+
+    QSnapdConfigValue array = getSnapConfRequest->configValue ("array-key");
+    g_assert_cmpint (array.type (), ==, QSnapdConfigValue::List);
+    g_assert_cmpint (array.size (), ==, 3);
+    g_assert_cmpint (array.at (0).toLongLong (), ==, 1);
+    g_assert_true (array.at (1).toString () == "two");
+    g_assert_cmpfloat (array.at (2).toDouble (), ==, 3.25);
+    g_assert_true (array.at (3).isNull ());
+
+    QSnapdConfigValue object = getSnapConfRequest->configValue ("object-key");
+    g_assert_cmpint (object.type (), ==, QSnapdConfigValue::Object);
+    g_assert_cmpint (object.size (), ==, 2);
+    g_assert_true (object.contains ("name"));
+    g_assert_false (object.contains ("missing"));
+    g_assert_true (object["name"].toString () == "foo");
+    g_assert_cmpint (object.value ("value").toLongLong (), ==, 42);
+    g_assert_true (object.toVariant ().toHash ().value ("name") == "foo");
+}
+
 static QHash<QString, QVariant>
 setup_set_snap_conf (MockSnapd *snapd)
 {
@@ -2338,6 +2696,44 @@ test_icon_not_installed ()
     g_assert_cmpint (getIconRequest->error (), ==, QSnapdRequest::NotFound);
 }
 
+static void
+test_icon_cache ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    MockSnap *s = mock_snapd_add_snap (snapd, "snap");
+    g_autoptr(GBytes) icon_data = g_bytes_new ("ICON-DATA", 9);
+    mock_snap_set_icon_data (s, "image/png", icon_data);
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    g_autoptr(GError) error = NULL;
+    g_autofree gchar *cache_path = g_dir_make_tmp ("snapd-qt-test-XXXXXX", &error);
+    g_assert_no_error (error);
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+    client.setIconCachePath (cache_path);
+    g_assert_true (client.iconCachePath () == cache_path);
+
+    QScopedPointer<QSnapdGetIconRequest> getIconRequest (client.getIcon ("snap", "1"));
+    getIconRequest->runSync ();
+    g_assert_cmpint (getIconRequest->error (), ==, QSnapdRequest::NoError);
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+
+    // Second request is read from disk
+    getIconRequest.reset (client.getIcon ("snap", "1"));
+    getIconRequest->runSync ();
+    g_assert_cmpint (getIconRequest->error (), ==, QSnapdRequest::NoError);
+    QScopedPointer<QSnapdIcon> icon (getIconRequest->icon ());
+    g_assert_true (icon->data () == "ICON-DATA");
+    g_assert_cmpint (mock_snapd_get_request_count (snapd), ==, 1);
+
+    g_autofree gchar *icon_path = g_build_filename (cache_path, "snap", "1", NULL);
+    g_autofree gchar *snap_path = g_build_filename (cache_path, "snap", NULL);
+    g_assert_cmpint (g_unlink (icon_path), ==, 0);
+    g_assert_cmpint (g_rmdir (snap_path), ==, 0);
+    g_assert_cmpint (g_rmdir (cache_path), ==, 0);
+}
+
 static void
 test_icon_large ()
 {
@@ -5032,6 +5428,29 @@ test_install_stream_sync ()
     g_assert_false (mock_snap_get_jailmode (snap));
 }
 
+static void
+test_install_stream_file ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    // Files are sent using their file descriptor
+    QTemporaryFile file;
+    g_assert_true (file.open ());
+    file.write ("SNAP");
+    file.flush ();
+    file.seek (0);
+    QScopedPointer<QSnapdInstallRequest> installRequest (client.install (&file));
+    installRequest->runSync ();
+    g_assert_cmpint (installRequest->error (), ==, QSnapdRequest::NoError);
+    MockSnap *snap = mock_snapd_find_snap (snapd, "sideload");
+    g_assert_nonnull (snap);
+    g_assert_cmpstr (mock_snap_get_data (snap), ==, "SNAP");
+}
+
 void
 InstallStreamHandler::onComplete ()
 {
@@ -6862,6 +7281,43 @@ test_download_channel_revision ()
     g_assert_cmpmem (data.data (), data.size (), "SNAP:name=test:channel=CHANNEL:revision=REVISION", 48);
 }
 
+static void
+test_download_bytes ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QScopedPointer<QSnapdDownloadRequest> downloadRequest (client.download ("test"));
+    downloadRequest->runSync ();
+    g_assert_cmpint (downloadRequest->error (), ==, QSnapdRequest::NoError);
+    QSnapdBytes bytes = downloadRequest->bytes ();
+    downloadRequest.reset ();
+    QByteArray data = bytes.data ();
+    g_assert_cmpmem (data.data (), data.size (), "SNAP:name=test", 14);
+}
+
+static void
+test_download_device ()
+{
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    g_assert_true (mock_snapd_start (snapd, NULL));
+
+    QSnapdClient client;
+    client.setSocketPath (mock_snapd_get_socket_path (snapd));
+
+    QBuffer buffer;
+    buffer.open (QBuffer::WriteOnly);
+    QScopedPointer<QSnapdDownloadRequest> downloadRequest (client.download ("test", NULL, NULL, &buffer));
+    downloadRequest->runSync ();
+    g_assert_cmpint (downloadRequest->error (), ==, QSnapdRequest::NoError);
+    g_assert_true (downloadRequest->bytes ().isNull ());
+    g_assert_cmpint (downloadRequest->bytesDownloaded (), ==, 14);
+    g_assert_cmpmem (buffer.data ().data (), buffer.data ().size (), "SNAP:name=test", 14);
+}
+
 static void
 test_themes_check_sync (void)
 {
@@ -7065,6 +7521,7 @@ main (int argc, char **argv)
     g_test_add_func ("/socket-closed/before-request", test_socket_closed_before_request);
     g_test_add_func ("/socket-closed/after-request", test_socket_closed_after_request);
     g_test_add_func ("/client/set-socket-path", test_client_set_socket_path);
+    g_test_add_func ("/auth-data/discharges", test_auth_data_discharges);
     g_test_add_func ("/user-agent/default", test_user_agent_default);
     g_test_add_func ("/user-agent/custom", test_user_agent_custom);
     g_test_add_func ("/user-agent/null", test_user_agent_null);
@@ -7075,8 +7532,10 @@ main (int argc, char **argv)
     g_test_add_func ("/maintenance/daemon-restart", test_maintenance_daemon_restart);
     g_test_add_func ("/maintenance/system-restart", test_maintenance_system_restart);
     g_test_add_func ("/maintenance/unknown", test_maintenance_unknown);
+    g_test_add_func ("/shared-client/threads", test_shared_client);
     g_test_add_func ("/get-system-information/sync", test_get_system_information_sync);
     g_test_add_func ("/get-system-information/async", test_get_system_information_async);
+    g_test_add_func ("/get-system-information/thread-pool", test_get_system_information_thread_pool);
     g_test_add_func ("/get-system-information/store", test_get_system_information_store);
     g_test_add_func ("/get-system-information/refresh", test_get_system_information_refresh);
     g_test_add_func ("/get-system-information/refresh_schedule", test_get_system_information_refresh_schedule);
@@ -7107,14 +7566,20 @@ main (int argc, char **argv)
     g_test_add_func ("/get-snaps/sync", test_get_snaps_sync);
     g_test_add_func ("/get-snaps/async", test_get_snaps_async);
     g_test_add_func ("/get-snaps/filter", test_get_snaps_filter);
+    g_test_add_func ("/get-snaps/snap-infos", test_get_snaps_snap_infos);
+    g_test_add_func ("/get-snaps/list-model", test_get_snaps_list_model);
+    g_test_add_func ("/get-snaps/future", test_get_snaps_future);
     g_test_add_func ("/list-one/sync", test_list_one_sync);
     g_test_add_func ("/list-one/async", test_list_one_async);
     g_test_add_func ("/get-snap/sync", test_get_snap_sync);
     g_test_add_func ("/get-snap/async", test_get_snap_async);
+    g_test_add_func ("/get-snap/details", test_get_snap_details);
     g_test_add_func ("/get-snap/types", test_get_snap_types);
     g_test_add_func ("/get-snap/optional-fields", test_get_snap_optional_fields);
     g_test_add_func ("/get-snap/deprecated-fields", test_get_snap_deprecated_fields);
     g_test_add_func ("/get-snap/common-ids", test_get_snap_common_ids);
+    g_test_add_func ("/get-snap/wrapper-ownership", test_get_snap_wrapper_ownership);
+    g_test_add_func ("/get-snap/cached-strings", test_get_snap_cached_strings);
     g_test_add_func ("/get-snap/not-installed", test_get_snap_not_installed);
     g_test_add_func ("/get-snap/classic-confinement", test_get_snap_classic_confinement);
     g_test_add_func ("/get-snap/devmode-confinement", test_get_snap_devmode_confinement);
@@ -7127,6 +7592,7 @@ main (int argc, char **argv)
     g_test_add_func ("/get-snap-conf/async", test_get_snap_conf_async);
     g_test_add_func ("/get-snap-conf/key-filter", test_get_snap_conf_key_filter);
     g_test_add_func ("/get-snap-conf/invalid-key", test_get_snap_conf_invalid_key);
+    g_test_add_func ("/get-snap-conf/value", test_get_snap_conf_value);
     g_test_add_func ("/set-snap-conf/sync", test_set_snap_conf_sync);
     g_test_add_func ("/set-snap-conf/async", test_set_snap_conf_async);
     g_test_add_func ("/set-snap-conf/invalid", test_set_snap_conf_invalid);
@@ -7137,6 +7603,7 @@ main (int argc, char **argv)
     g_test_add_func ("/icon/sync", test_icon_sync);
     g_test_add_func ("/icon/async", test_icon_async);
     g_test_add_func ("/icon/not-installed", test_icon_not_installed);
+    g_test_add_func ("/icon/cache", test_icon_cache);
     g_test_add_func ("/icon/large", test_icon_large);
     g_test_add_func ("/get-assertions/sync", test_get_assertions_sync);
     //g_test_add_func ("/get-assertions/async", test_get_assertions_async);
@@ -7223,6 +7690,7 @@ main (int argc, char **argv)
     g_test_add_func ("/install/auth-cancelled", test_install_auth_cancelled);
     g_test_add_func ("/install-stream/sync", test_install_stream_sync);
     g_test_add_func ("/install-stream/async", test_install_stream_async);
+    g_test_add_func ("/install-stream/file", test_install_stream_file);
     g_test_add_func ("/install-stream/progress", test_install_stream_progress);
     g_test_add_func ("/install-stream/classic", test_install_stream_classic);
     g_test_add_func ("/install-stream/dangerous", test_install_stream_dangerous);
@@ -7302,6 +7770,8 @@ main (int argc, char **argv)
     g_test_add_func ("/download/sync", test_download_sync);
     g_test_add_func ("/download/async", test_download_async);
     g_test_add_func ("/download/channel-revision", test_download_channel_revision);
+    g_test_add_func ("/download/bytes", test_download_bytes);
+    g_test_add_func ("/download/device", test_download_device);
     g_test_add_func ("/themes/check/sync", test_themes_check_sync);
     g_test_add_func ("/themes/check/async", test_themes_check_async);
     g_test_add_func ("/themes/install/sync", test_themes_install_sync);
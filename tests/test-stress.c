@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 Canonical Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2 or version 3 of the License.
+ * See http://www.gnu.org/copyleft/lgpl.html the full text of the license.
+ */
+
+/* Sends requests to one client from many threads while the mock snapd drops
+ * connections and restarts, checking every request completes once, in order and
+ * in time. The duration and number of threads can be changed with the
+ * SNAPD_STRESS_DURATION (seconds) and SNAPD_STRESS_THREADS environment variables,
+ * and the throughput is shown when run with --verbose. Build with
+ * -Db_sanitize=thread to check for data races. */
+
+#include <glib.h>
+
+#include <snapd-glib/snapd-glib.h>
+
+#include "mock-snapd.h"
+
+/* Milliseconds requests have to complete in, and how late a completion can be
+ * allowed for the thread getting to run */
+#define REQUEST_TIMEOUT 2000
+#define DEADLINE_SLACK 500
+
+#define DEFAULT_DURATION 2
+#define DEFAULT_THREADS 8
+
+/* Asynchronous requests each thread keeps waiting */
+#define MAX_IN_FLIGHT 16
+
+typedef struct
+{
+    MockSnapd *snapd;
+    SnapdClient *client;
+    gint64 end_time;
+
+    /* TRUE if requests on the same connection have to complete in the order they were sent */
+    gboolean check_order;
+
+    /* Totals across all threads */
+    gint n_requests;
+    gint n_errors;
+    gint n_cancelled;
+} StressData;
+
+typedef struct
+{
+    StressData *stress;
+    GThread *thread;
+    GMainContext *context;
+    GMainLoop *loop;
+    GRand *rand;
+
+    /* Requests waiting for their callback keyed by sequence number */
+    GHashTable *pending;
+    guint64 next_sequence;
+    guint64 last_sequence;
+    gboolean refill_scheduled;
+} ThreadData;
+
+typedef struct
+{
+    ThreadData *thread;
+    guint64 sequence;
+    gint64 deadline;
+} StressRequest;
+
+static guint
+get_setting (const gchar *name, guint default_value)
+{
+    const gchar *value = g_getenv (name);
+    return value != NULL && value[0] != '\0' ? (guint) g_ascii_strtoull (value, NULL, 10) : default_value;
+}
+
+static void
+check_deadline (gint64 deadline)
+{
+    g_assert_cmpint (g_get_monotonic_time (), <=, deadline + DEADLINE_SLACK * 1000);
+}
+
+/* Errors expected from cancellations, timeouts and the dropped connections */
+static void
+count_result (StressData *stress, GError *error)
+{
+    g_atomic_int_inc (&stress->n_requests);
+    if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        g_atomic_int_inc (&stress->n_cancelled);
+    else if (error != NULL) {
+        g_assert_true (error->domain == SNAPD_ERROR || error->domain == G_IO_ERROR);
+        g_atomic_int_inc (&stress->n_errors);
+    }
+}
+
+static void send_requests (ThreadData *thread);
+
+static gboolean
+refill_cb (gpointer user_data)
+{
+    ThreadData *thread = user_data;
+
+    thread->refill_scheduled = FALSE;
+    send_requests (thread);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_refill (ThreadData *thread)
+{
+    if (thread->refill_scheduled)
+        return;
+
+    thread->refill_scheduled = TRUE;
+    g_autoptr(GSource) source = g_idle_source_new ();
+    g_source_set_callback (source, refill_cb, thread, NULL);
+    g_source_attach (source, thread->context);
+}
+
+static void
+system_information_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    StressRequest *request = user_data;
+    ThreadData *thread = request->thread;
+
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSystemInformation) info = snapd_client_get_system_information_finish (SNAPD_CLIENT (object), result, &error);
+    g_assert_true ((info != NULL) == (error == NULL));
+
+    /* Every request completes once, in the context it was made in */
+    g_assert_true (g_main_context_is_owner (thread->context));
+    g_assert_true (g_hash_table_steal (thread->pending, &request->sequence));
+    check_deadline (request->deadline);
+
+    /* Responses come back in the order requests were sent */
+    if (error == NULL && thread->stress->check_order) {
+        g_assert_cmpint (request->sequence, >, thread->last_sequence);
+        thread->last_sequence = request->sequence;
+    }
+
+    count_result (thread->stress, error);
+    g_slice_free (StressRequest, request);
+    schedule_refill (thread);
+}
+
+static gboolean
+cancel_cb (gpointer user_data)
+{
+    g_cancellable_cancel (G_CANCELLABLE (user_data));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+send_sync_request (ThreadData *thread)
+{
+    StressData *stress = thread->stress;
+
+    gint64 deadline = g_get_monotonic_time () + REQUEST_TIMEOUT * 1000;
+    g_autoptr(GError) error = NULL;
+    g_autoptr(SnapdSnap) snap = snapd_client_get_snap_sync (stress->client, "snap", NULL, &error);
+    g_assert_true ((snap != NULL) == (error == NULL));
+    check_deadline (deadline);
+    count_result (stress, error);
+}
+
+static void
+send_async_request (ThreadData *thread)
+{
+    StressData *stress = thread->stress;
+
+    StressRequest *request = g_slice_new0 (StressRequest);
+    request->thread = thread;
+    request->sequence = ++thread->next_sequence;
+    request->deadline = g_get_monotonic_time () + REQUEST_TIMEOUT * 1000;
+    g_hash_table_insert (thread->pending, &request->sequence, request);
+
+    /* Cancel some requests before they are sent and some while waiting for a response */
+    g_autoptr(GCancellable) cancellable = NULL;
+    switch (g_rand_int_range (thread->rand, 0, 8)) {
+    case 0:
+        cancellable = g_cancellable_new ();
+        g_cancellable_cancel (cancellable);
+        break;
+    case 1: {
+        cancellable = g_cancellable_new ();
+        g_autoptr(GSource) source = g_timeout_source_new (g_rand_int_range (thread->rand, 0, 5));
+        g_source_set_callback (source, cancel_cb, g_object_ref (cancellable), g_object_unref);
+        g_source_attach (source, thread->context);
+        break;
+    }
+    default:
+        break;
+    }
+
+    snapd_client_get_system_information_async (stress->client, cancellable, system_information_cb, request);
+}
+
+static void
+send_requests (ThreadData *thread)
+{
+    StressData *stress = thread->stress;
+
+    while (g_hash_table_size (thread->pending) < MAX_IN_FLIGHT && g_get_monotonic_time () < stress->end_time) {
+        if (g_rand_int_range (thread->rand, 0, 8) == 0)
+            send_sync_request (thread);
+        else
+            send_async_request (thread);
+    }
+
+    if (g_hash_table_size (thread->pending) == 0 && g_get_monotonic_time () >= stress->end_time)
+        g_main_loop_quit (thread->loop);
+}
+
+static gpointer
+stress_thread (gpointer user_data)
+{
+    ThreadData *thread = user_data;
+
+    g_main_context_push_thread_default (thread->context);
+    schedule_refill (thread);
+    g_main_loop_run (thread->loop);
+    g_main_context_pop_thread_default (thread->context);
+
+    return NULL;
+}
+
+/* Drop connections part way through requests and restart snapd until the threads stop sending */
+static void
+disrupt_snapd (StressData *stress, GRand *rand)
+{
+    while (g_get_monotonic_time () < stress->end_time) {
+        g_usleep (g_rand_int_range (rand, 20, 100) * 1000);
+
+        if (g_rand_boolean (rand)) {
+            mock_snapd_set_close_on_request (stress->snapd, TRUE);
+            g_usleep (g_rand_int_range (rand, 1, 10) * 1000);
+            mock_snapd_set_close_on_request (stress->snapd, FALSE);
+        }
+        else {
+            mock_snapd_stop (stress->snapd);
+            g_usleep (g_rand_int_range (rand, 1, 10) * 1000);
+            g_autoptr(GError) error = NULL;
+            g_assert_true (mock_snapd_start (stress->snapd, &error));
+            g_assert_no_error (error);
+        }
+    }
+}
+
+static void
+run_stress (guint max_connections, gboolean use_io_thread)
+{
+    guint duration = get_setting ("SNAPD_STRESS_DURATION", DEFAULT_DURATION);
+    guint n_threads = MAX (get_setting ("SNAPD_STRESS_THREADS", DEFAULT_THREADS), 1);
+
+    g_autoptr(MockSnapd) snapd = mock_snapd_new ();
+    mock_snapd_add_snap (snapd, "snap");
+    mock_snapd_set_endpoint_latency (snapd, "/v2/snaps", 1);
+
+    g_autoptr(GError) error = NULL;
+    g_assert_true (mock_snapd_start (snapd, &error));
+
+    g_autoptr(SnapdClient) client = snapd_client_new ();
+    snapd_client_set_socket_path (client, mock_snapd_get_socket_path (snapd));
+    snapd_client_set_max_connections (client, max_connections);
+    snapd_client_set_use_io_thread (client, use_io_thread);
+    snapd_client_set_request_timeout (client, REQUEST_TIMEOUT);
+
+    StressData stress = { 0 };
+    stress.snapd = snapd;
+    stress.client = client;
+    stress.check_order = max_connections == 1;
+    gint64 start_time = g_get_monotonic_time ();
+    stress.end_time = start_time + (gint64) duration * G_USEC_PER_SEC;
+
+    /* Seeded from the test seed so failures can be repeated with --seed */
+    g_autoptr(GRand) rand = g_rand_new_with_seed (g_test_rand_int ());
+    g_autofree ThreadData *threads = g_new0 (ThreadData, n_threads);
+    for (guint i = 0; i < n_threads; i++) {
+        ThreadData *thread = &threads[i];
+        thread->stress = &stress;
+        thread->context = g_main_context_new ();
+        thread->loop = g_main_loop_new (thread->context, FALSE);
+        thread->rand = g_rand_new_with_seed (g_rand_int (rand));
+        thread->pending = g_hash_table_new (g_int64_hash, g_int64_equal);
+        thread->thread = g_thread_new ("stress", stress_thread, thread);
+    }
+
+    disrupt_snapd (&stress, rand);
+
+    for (guint i = 0; i < n_threads; i++) {
+        ThreadData *thread = &threads[i];
+        g_thread_join (thread->thread);
+        g_assert_cmpint (g_hash_table_size (thread->pending), ==, 0);
+        g_hash_table_unref (thread->pending);
+        g_rand_free (thread->rand);
+        g_main_loop_unref (thread->loop);
+        g_main_context_unref (thread->context);
+    }
+
+    gdouble elapsed = (g_get_monotonic_time () - start_time) / (gdouble) G_USEC_PER_SEC;
+    g_test_message ("%d requests in %.1fs (%.0f/s), %d failed, %d cancelled",
+                    stress.n_requests, elapsed, stress.n_requests / elapsed, stress.n_errors, stress.n_cancelled);
+    g_assert_cmpint (stress.n_requests, >, 0);
+}
+
+static void
+test_pipelined (void)
+{
+    run_stress (1, FALSE);
+}
+
+static void
+test_pooled_io_thread (void)
+{
+    run_stress (4, TRUE);
+}
+
+int
+main (int argc, char **argv)
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/stress/pipelined", test_pipelined);
+    g_test_add_func ("/stress/pooled-io-thread", test_pooled_io_thread);
+
+    return g_test_run ();
+}